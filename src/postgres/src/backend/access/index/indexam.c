@@ -635,12 +635,13 @@ index_fetch_heap(IndexScanDesc scan)
 {
 	/*
 	 * For YugaByte secondary indexes, we need to select from the base table using
-	 * ybctid. For primary keys, the row is already prepared in "xs_hitup" that can
-	 * be returned directly.
+	 * ybctid. For primary keys, and for secondary indexes that fetched the rows of a
+	 * batch of index tuples together, the row is already prepared in "xs_hitup" that
+	 * can be returned directly.
 	 */
 	if (IsYugaByteEnabled())
 	{
-		if (scan->indexRelation->rd_index->indisprimary)
+		if (scan->indexRelation->rd_index->indisprimary || scan->xs_hitup != NULL)
 		{
 			Assert(scan->xs_hitup != 0);
 			return scan->xs_hitup;
@@ -42,6 +42,7 @@
 #include "utils/datum.h"
 #include "utils/rel.h"
 #include "utils/lsyscache.h"
+#include "utils/memutils.h"
 #include "utils/resowner_private.h"
 #include "utils/syscache.h"
 #include "utils/snapmgr.h"
@@ -541,6 +542,63 @@ IndexTuple ybc_index_getnext(IndexScanDesc scan_desc)
 	return ybc_getnext_indextuple(ybscan, &scan_desc->xs_recheck);
 }
 
+/*
+ * Read ahead a batch of index tuples and fetch their rows of the base table together, instead of
+ * selecting each row when its index tuple is returned. The batch starts small, so that scans
+ * stopped early by a LIMIT don't read much ahead, and doubles up to YBC_MAX_HEAP_FETCH_BATCH.
+ */
+#define YBC_MIN_HEAP_FETCH_BATCH 8
+#define YBC_MAX_HEAP_FETCH_BATCH 1024
+
+HeapTuple ybc_index_getnext_heaptuple(IndexScanDesc scan_desc)
+{
+	YbScanDesc ybscan = (YbScanDesc) scan_desc->opaque;
+	Assert(PointerIsValid(ybscan));
+
+	if (ybscan->next_hitup < ybscan->nhitups)
+		return ybscan->hitups[ybscan->next_hitup++];
+
+	/*
+	 * The rows are kept in the memory of the scan, the executor is done with the previous batch
+	 * when it asks for the next row.
+	 */
+	MemoryContext oldcontext = MemoryContextSwitchTo(GetMemoryChunkContext(ybscan));
+	for (int i = 0; i < ybscan->nhitups; i++)
+		heap_freetuple(ybscan->hitups[i]);
+	ybscan->nhitups = 0;
+	ybscan->next_hitup = 0;
+
+	if (ybscan->hitups == NULL)
+	{
+		ybscan->hitup_batch_size = YBC_MIN_HEAP_FETCH_BATCH;
+		ybscan->hitups = (HeapTuple *) palloc(YBC_MAX_HEAP_FETCH_BATCH * sizeof(HeapTuple));
+	}
+
+	/* The rows of a batch have to be rechecked if any of its index tuples has to. */
+	Datum *ybctids   = (Datum *) palloc(ybscan->hitup_batch_size * sizeof(Datum));
+	int    nybctids  = 0;
+	bool   recheck   = false;
+	IndexTuple itup;
+	while (nybctids < ybscan->hitup_batch_size &&
+		   PointerIsValid(itup = ybc_getnext_indextuple(ybscan, &scan_desc->xs_recheck)))
+	{
+		recheck = recheck || scan_desc->xs_recheck;
+		ybctids[nybctids++] = itup->t_ybctid;
+	}
+	scan_desc->xs_recheck = recheck;
+
+	ybscan->nhitups = YBCFetchTuples(scan_desc->heapRelation, ybctids, nybctids, ybscan->hitups);
+	pfree(ybctids);
+	ybscan->hitup_batch_size = Min(ybscan->hitup_batch_size * 2, YBC_MAX_HEAP_FETCH_BATCH);
+	MemoryContextSwitchTo(oldcontext);
+
+	/* The index could still have tuples if none of the rows of this batch were found. */
+	if (ybscan->nhitups == 0)
+		return nybctids == 0 ? NULL : ybc_index_getnext_heaptuple(scan_desc);
+
+	return ybscan->hitups[ybscan->next_hitup++];
+}
+
 void ybc_heap_endscan(HeapScanDesc scan_desc)
 {
 	Assert(PointerIsValid(scan_desc->ybscan));
@@ -572,36 +630,24 @@ void ybc_index_endscan(IndexScanDesc scan_desc)
 	YbScanDesc ybscan = (YbScanDesc) scan_desc->opaque;
 	Assert(PointerIsValid(ybscan));
 	ybcEndScan(ybscan->state);
+	if (ybscan->hitups != NULL)
+	{
+		for (int i = 0; i < ybscan->nhitups; i++)
+			heap_freetuple(ybscan->hitups[i]);
+		pfree(ybscan->hitups);
+	}
 	pfree(ybscan);
 }
 
 /* --------------------------------------------------------------------------------------------- */
 
-HeapTuple YBCFetchTuple(Relation relation, Datum ybctid)
+/*
+ * Set up the targets of a select by ybctid. For index-based scan we need to return all "real"
+ * columns.
+ */
+static void ybcSetupFetchTargets(YBCPgStatement ybc_stmt, TupleDesc tupdesc, bool hasoids)
 {
-	YBCPgStatement ybc_stmt;
-	TupleDesc      tupdesc = RelationGetDescr(relation);
-
-	HandleYBStatus(YBCPgNewSelect(ybc_pg_session,
-								  YBCGetDatabaseOid(relation),
-								  RelationGetRelid(relation),
-								  InvalidOid,
-								  &ybc_stmt,
-								  NULL /* read_time */));
-
-	/* Bind ybctid to identify the current row. */
-	YBCPgExpr ybctid_expr = YBCNewConstant(ybc_stmt,
-										   BYTEAOID,
-										   ybctid,
-										   false);
-	HandleYBStmtStatus(YBCPgDmlBindColumn(ybc_stmt,
-										  YBTupleIdAttributeNumber,
-										  ybctid_expr), ybc_stmt);
-
-	/*
-	 * Set up the scan targets. For index-based scan we need to return all "real" columns.
-	 */
-	if (RelationGetForm(relation)->relhasoids)
+	if (hasoids)
 	{
 		YBCPgTypeAttrs type_attrs = { 0 };
 		YBCPgExpr   expr = YBCNewColumnRef(ybc_stmt, ObjectIdAttributeNumber, InvalidOid,
@@ -619,10 +665,13 @@ HeapTuple YBCFetchTuple(Relation relation, Datum ybctid)
 	YBCPgExpr   expr = YBCNewColumnRef(ybc_stmt, YBTupleIdAttributeNumber, InvalidOid,
 									   &type_attrs);
 	HandleYBStmtStatus(YBCPgDmlAppendTarget(ybc_stmt, expr), ybc_stmt);
+}
 
-	/* Execute the select statement. */
-	HandleYBStmtStatus(YBCPgExecSelect(ybc_stmt), ybc_stmt);
-
+/*
+ * Fetch the next row of an executed select by ybctid, or NULL if there are no more rows.
+ */
+static HeapTuple ybcFetchNextRow(YBCPgStatement ybc_stmt, TupleDesc tupdesc)
+{
 	HeapTuple tuple    = NULL;
 	bool      has_data = false;
 
@@ -655,8 +704,82 @@ HeapTuple YBCFetchTuple(Relation relation, Datum ybctid)
 	pfree(values);
 	pfree(nulls);
 
+	return tuple;
+}
+
+HeapTuple YBCFetchTuple(Relation relation, Datum ybctid)
+{
+	YBCPgStatement ybc_stmt;
+	TupleDesc      tupdesc = RelationGetDescr(relation);
+
+	HandleYBStatus(YBCPgNewSelect(ybc_pg_session,
+								  YBCGetDatabaseOid(relation),
+								  RelationGetRelid(relation),
+								  InvalidOid,
+								  &ybc_stmt,
+								  NULL /* read_time */));
+
+	/* Bind ybctid to identify the current row. */
+	YBCPgExpr ybctid_expr = YBCNewConstant(ybc_stmt,
+										   BYTEAOID,
+										   ybctid,
+										   false);
+	HandleYBStmtStatus(YBCPgDmlBindColumn(ybc_stmt,
+										  YBTupleIdAttributeNumber,
+										  ybctid_expr), ybc_stmt);
+
+	ybcSetupFetchTargets(ybc_stmt, tupdesc, RelationGetForm(relation)->relhasoids);
+
+	/* Execute the select statement. */
+	HandleYBStmtStatus(YBCPgExecSelect(ybc_stmt), ybc_stmt);
+
+	HeapTuple tuple = ybcFetchNextRow(ybc_stmt, tupdesc);
+
 	/* Complete execution */
 	HandleYBStatus(YBCPgDeleteStatement(ybc_stmt));
 
 	return tuple;
 }
+
+int YBCFetchTuples(Relation relation, Datum *ybctids, int n, HeapTuple *tuples)
+{
+	YBCPgStatement ybc_stmt;
+	TupleDesc      tupdesc = RelationGetDescr(relation);
+
+	if (n == 0)
+		return 0;
+
+	HandleYBStatus(YBCPgNewSelect(ybc_pg_session,
+								  YBCGetDatabaseOid(relation),
+								  RelationGetRelid(relation),
+								  InvalidOid,
+								  &ybc_stmt,
+								  NULL /* read_time */));
+
+	/* Bind all ybctids, the rows are read together. */
+	YBCPgExpr *ybctid_exprs = (YBCPgExpr *) palloc(n * sizeof(YBCPgExpr));
+	for (int i = 0; i < n; i++)
+	{
+		ybctid_exprs[i] = YBCNewConstant(ybc_stmt, BYTEAOID, ybctids[i], false);
+	}
+	HandleYBStmtStatus(YBCPgDmlBindYBCtids(ybc_stmt, n, ybctid_exprs), ybc_stmt);
+	pfree(ybctid_exprs);
+
+	ybcSetupFetchTargets(ybc_stmt, tupdesc, RelationGetForm(relation)->relhasoids);
+
+	/* Execute the select statement. */
+	HandleYBStmtStatus(YBCPgExecSelect(ybc_stmt), ybc_stmt);
+
+	/* Rows that were deleted since the ybctids were read are not returned. */
+	int ntuples = 0;
+	HeapTuple tuple;
+	while (ntuples < n && HeapTupleIsValid(tuple = ybcFetchNextRow(ybc_stmt, tupdesc)))
+	{
+		tuples[ntuples++] = tuple;
+	}
+
+	/* Complete execution */
+	HandleYBStatus(YBCPgDeleteStatement(ybc_stmt));
+
+	return ntuples;
+}
@@ -203,12 +203,24 @@ bool
 ybcingettuple(IndexScanDesc scan, ScanDirection dir)
 {
 	scan->xs_ctup.t_ybctid = 0;
+	scan->xs_hitup = NULL;
 
 	/* 
-	 * If IndexTuple is requested or it is a secondary index, return the result as IndexTuple.
-	 * Otherwise, return the result as a HeapTuple of the base table.
+	 * If IndexTuple is requested, return the result as IndexTuple. Otherwise, return the result
+	 * as a HeapTuple of the base table, those of a secondary index are fetched in batches.
 	 */
-	if (scan->xs_want_itup || !scan->indexRelation->rd_index->indisprimary)
+	if (!scan->xs_want_itup && !scan->indexRelation->rd_index->indisprimary)
+	{
+		HeapTuple tuple = ybc_index_getnext_heaptuple(scan);
+
+		if (tuple)
+		{
+			scan->xs_ctup.t_ybctid = tuple->t_ybctid;
+			scan->xs_hitup = tuple;
+			scan->xs_hitupdesc = RelationGetDescr(scan->heapRelation);
+		}
+	}
+	else if (scan->xs_want_itup)
 	{
 		IndexTuple tuple = ybc_index_getnext(scan);
 
@@ -960,12 +960,16 @@ estimate_rel_size(Relation rel, int32 *attr_widths,
 	/*
 	 * TODO We don't support forwarding size estimates to postgres yet.
 	 * Use whatever is in pg_class.
+	 *
+	 * YugaByte index tuples are always visible, so an index-only scan never
+	 * visits the table to check visibility and should not be costed as if it
+	 * did.
 	 */
 	if (IsYugaByteEnabled())
 	{
 		*pages = rel->rd_rel->relpages;
 		*tuples = rel->rd_rel->reltuples;
-		*allvisfrac = 0;
+		*allvisfrac = 1;
 		return;
 	}
 
@@ -44,6 +44,12 @@ typedef struct YbScanDescData
 	ScanKey key;
 	AttrNumber sk_attno[INDEX_MAX_KEYS * 2];
 	Relation index;
+
+	/* Rows of the base table fetched for a batch of index tuples of a secondary index scan. */
+	HeapTuple *hitups;
+	int nhitups;
+	int next_hitup;
+	int hitup_batch_size;
 } YbScanDescData;
 
 typedef struct YbScanDescData *YbScanDesc;
@@ -92,6 +98,7 @@ extern void ybc_index_beginscan(Relation index,
 								int nkeys,
 								ScanKey key);
 extern IndexTuple ybc_index_getnext(IndexScanDesc scan_desc);
+extern HeapTuple ybc_index_getnext_heaptuple(IndexScanDesc scan_desc);
 extern void ybc_index_endscan(IndexScanDesc scan_desc);
 
 /*
@@ -99,5 +106,10 @@ extern void ybc_index_endscan(IndexScanDesc scan_desc);
  */
 extern HeapTuple YBCFetchTuple(Relation relation, Datum ybctid);
 
+/*
+ * Fetch the tuples with the n given ybctids together, returns the number of tuples found.
+ */
+extern int YBCFetchTuples(Relation relation, Datum *ybctids, int n, HeapTuple *tuples);
+
 
 #endif							/* YBCAM_H */
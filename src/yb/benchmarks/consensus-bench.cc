@@ -0,0 +1,514 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+// Micro-benchmarks of the replication hot path: appends to the Log, reads and evictions of the
+// LogCache, request assembly and response handling of the PeerMessageQueue for simulated
+// followers, and replication by RaftConsensus between in-process peers.
+//
+// Each benchmark reports its throughput and latency percentiles as a JSON object, written to
+// <consensus_bench_output_dir>/<benchmark>.json, or logged when the directory is not set. The
+// durability of the log is controlled by the usual flags, e.g. --durable_wal_write, and is
+// reported with the results.
+
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <gflags/gflags.h>
+#include <gtest/gtest.h>
+
+#include "yb/common/wire_protocol-test-util.h"
+#include "yb/consensus/consensus-test-util.h"
+#include "yb/consensus/consensus_queue.h"
+#include "yb/consensus/log.h"
+#include "yb/consensus/log_cache.h"
+#include "yb/consensus/peer_manager.h"
+#include "yb/consensus/quorum_util.h"
+#include "yb/consensus/raft_consensus.h"
+#include "yb/consensus/replicate_msgs_holder.h"
+#include "yb/fs/fs_manager.h"
+#include "yb/gutil/stl_util.h"
+#include "yb/gutil/strings/substitute.h"
+#include "yb/server/hybrid_clock.h"
+#include "yb/server/logical_clock.h"
+#include "yb/util/countdown_latch.h"
+#include "yb/util/hdr_histogram.h"
+#include "yb/util/jsonwriter.h"
+#include "yb/util/mem_tracker.h"
+#include "yb/util/metrics.h"
+#include "yb/util/path_util.h"
+#include "yb/util/restart_safe_clock.h"
+#include "yb/util/test_macros.h"
+#include "yb/util/test_util.h"
+#include "yb/util/threadpool.h"
+
+DEFINE_int32(consensus_bench_iterations, 1000,
+             "Number of batches appended, read or replicated by each benchmark.");
+DEFINE_int32(consensus_bench_batch_size, 8, "Number of operations in each batch.");
+DEFINE_int32(consensus_bench_payload_bytes, 128, "Payload size of each operation.");
+DEFINE_int32(consensus_bench_followers, 2,
+             "Number of followers of the leader in the queue and replication benchmarks.");
+DEFINE_string(consensus_bench_output_dir, "",
+              "Directory to write the results of each benchmark to, as <benchmark>.json. The "
+              "results are logged when empty.");
+
+DECLARE_bool(durable_wal_write);
+DECLARE_bool(durable_wal_write_group_sync);
+DECLARE_bool(enable_leader_failure_detection);
+
+METRIC_DECLARE_entity(tablet);
+
+namespace yb {
+namespace consensus {
+
+using strings::Substitute;
+
+namespace {
+
+const char* kTestTable = "bench-table";
+const char* kTestTablet = "bench-tablet";
+const char* kLeaderUuid = "peer-0";
+
+// Latencies are tracked in microseconds, up to a minute.
+constexpr uint64_t kMaxLatencyUs = 60 * 1000 * 1000;
+
+void FatalOnError(const Status& s) {
+  CHECK_OK(s);
+}
+
+void DoNothing(std::shared_ptr<StateChangeContext> context) {
+}
+
+// Throughput and latency distribution of one benchmark.
+class BenchmarkResult {
+ public:
+  explicit BenchmarkResult(std::string name)
+      : name_(std::move(name)), latency_us_(kMaxLatencyUs, 3), start_(MonoTime::Now()) {}
+
+  // Thread safe.
+  void RecordLatency(MonoDelta latency) {
+    latency_us_.Increment(
+        std::min<uint64_t>(std::max<int64_t>(latency.ToMicroseconds(), 0), kMaxLatencyUs));
+  }
+
+  void AddOps(int64_t ops, int64_t bytes) {
+    ops_ += ops;
+    bytes_ += bytes;
+  }
+
+  CHECKED_STATUS Finish() {
+    const auto elapsed = MonoTime::Now() - start_;
+    std::stringstream out;
+    {
+      JsonWriter writer(&out, JsonWriter::PRETTY);
+      writer.StartObject();
+      writer.String("benchmark");
+      writer.String(name_);
+
+      writer.String("params");
+      writer.StartObject();
+      writer.String("iterations");
+      writer.Int(FLAGS_consensus_bench_iterations);
+      writer.String("batch_size");
+      writer.Int(FLAGS_consensus_bench_batch_size);
+      writer.String("payload_bytes");
+      writer.Int(FLAGS_consensus_bench_payload_bytes);
+      writer.String("followers");
+      writer.Int(FLAGS_consensus_bench_followers);
+      writer.String("durable_wal_write");
+      writer.Bool(FLAGS_durable_wal_write);
+      writer.String("durable_wal_write_group_sync");
+      writer.Bool(FLAGS_durable_wal_write_group_sync);
+      writer.EndObject();
+
+      writer.String("ops");
+      writer.Int64(ops_);
+      writer.String("bytes");
+      writer.Int64(bytes_);
+      writer.String("elapsed_us");
+      writer.Int64(elapsed.ToMicroseconds());
+      writer.String("ops_per_sec");
+      writer.Double(elapsed.ToSeconds() > 0 ? ops_ / elapsed.ToSeconds() : 0);
+
+      writer.String("latency_us");
+      writer.StartObject();
+      writer.String("count");
+      writer.Uint64(latency_us_.TotalCount());
+      if (latency_us_.TotalCount() > 0) {
+        writer.String("min");
+        writer.Uint64(latency_us_.MinValue());
+        writer.String("mean");
+        writer.Double(latency_us_.MeanValue());
+        for (const auto& percentile : {50.0, 90.0, 99.0, 99.9, 99.99}) {
+          writer.String(Substitute("p$0", percentile));
+          writer.Uint64(latency_us_.ValueAtPercentile(percentile));
+        }
+        writer.String("max");
+        writer.Uint64(latency_us_.MaxValue());
+      }
+      writer.EndObject();
+      writer.EndObject();
+    }
+
+    if (FLAGS_consensus_bench_output_dir.empty()) {
+      LOG(INFO) << "Benchmark results: " << out.str();
+      return Status::OK();
+    }
+    const auto path = JoinPathSegments(FLAGS_consensus_bench_output_dir, name_ + ".json");
+    RETURN_NOT_OK_PREPEND(WriteStringToFile(Env::Default(), out.str(), path),
+                          "Unable to write benchmark results to " + path);
+    LOG(INFO) << "Benchmark results written to " << path;
+    return Status::OK();
+  }
+
+ private:
+  const std::string name_;
+  HdrHistogram latency_us_;
+  const MonoTime start_;
+  int64_t ops_ = 0;
+  int64_t bytes_ = 0;
+};
+
+} // namespace
+
+class ConsensusBench : public YBTest {
+ public:
+  ConsensusBench()
+      : schema_(GetSimpleTestSchema()),
+        metric_entity_(METRIC_ENTITY_tablet.Instantiate(&metric_registry_, "consensus-bench")) {
+  }
+
+  void SetUp() override {
+    YBTest::SetUp();
+    fs_manager_.reset(new FsManager(env_.get(), GetTestPath("fs_root"), "tserver_test"));
+    ASSERT_OK(fs_manager_->CreateInitialFileSystemLayout());
+    ASSERT_OK(fs_manager_->Open());
+    ASSERT_OK(ThreadPoolBuilder("append").Build(&append_pool_));
+    ASSERT_OK(ThreadPoolBuilder("raft").Build(&raft_pool_));
+    ASSERT_OK(log::Log::Open(log::LogOptions(),
+                             fs_manager_.get(),
+                             kTestTablet,
+                             fs_manager_->GetFirstTabletWalDirOrDie(kTestTable, kTestTablet),
+                             schema_,
+                             0, // schema_version
+                             metric_entity_.get(),
+                             append_pool_.get(),
+                             &log_));
+    clock_.reset(new server::HybridClock());
+    ASSERT_OK(clock_->Init());
+  }
+
+  void TearDown() override {
+    ASSERT_OK(log_->WaitUntilAllFlushed());
+    YBTest::TearDown();
+  }
+
+ protected:
+  // Returns the next batch of operations, starting at next_index_.
+  ReplicateMsgs NextBatch(int64_t* bytes) {
+    ReplicateMsgs msgs;
+    for (int i = 0; i < FLAGS_consensus_bench_batch_size; ++i) {
+      msgs.push_back(CreateDummyReplicate(
+          1 /* term */, next_index_++, clock_->Now(), FLAGS_consensus_bench_payload_bytes));
+      *bytes += msgs.back()->ByteSize();
+    }
+    return msgs;
+  }
+
+  const Schema schema_;
+  MetricRegistry metric_registry_;
+  scoped_refptr<MetricEntity> metric_entity_;
+  gscoped_ptr<FsManager> fs_manager_;
+  std::unique_ptr<ThreadPool> append_pool_;
+  std::unique_ptr<ThreadPool> raft_pool_;
+  scoped_refptr<log::Log> log_;
+  scoped_refptr<server::Clock> clock_;
+  RestartSafeCoarseMonoClock restart_safe_clock_;
+  int next_index_ = 1;
+};
+
+// Latency of appending a batch to the log, until it is flushed, or synced with durable writes.
+TEST_F(ConsensusBench, LogAppend) {
+  BenchmarkResult result("log_append");
+  for (int i = 0; i < FLAGS_consensus_bench_iterations; ++i) {
+    int64_t bytes = 0;
+    auto msgs = NextBatch(&bytes);
+    const auto start = MonoTime::Now();
+    Synchronizer s;
+    ASSERT_OK(log_->AsyncAppendReplicates(
+        msgs, yb::OpId() /* committed_op_id */, restart_safe_clock_.Now(),
+        s.AsStatusCallback()));
+    ASSERT_OK(s.Wait());
+    result.RecordLatency(MonoTime::Now() - start);
+    result.AddOps(msgs.size(), bytes);
+  }
+  ASSERT_OK(result.Finish());
+}
+
+// Latency of reading a batch from the log cache, as done for a peer, and of evicting it once it
+// was read.
+TEST_F(ConsensusBench, LogCacheReadEvict) {
+  LogCache cache(metric_entity_, log_.get(), nullptr /* server_tracker */, kLeaderUuid,
+                 kTestTablet);
+  cache.Init(MinimumOpId());
+
+  int64_t total_bytes = 0;
+  for (int i = 0; i < FLAGS_consensus_bench_iterations; ++i) {
+    ASSERT_OK(cache.AppendOperations(
+        NextBatch(&total_bytes), yb::OpId() /* committed_op_id */, restart_safe_clock_.Now(),
+        Bind(&FatalOnError)));
+  }
+  ASSERT_OK(log_->WaitUntilAllFlushed());
+
+  const int64_t last_index = next_index_ - 1;
+  const int max_batch_bytes = std::max<int64_t>(
+      total_bytes / std::max(FLAGS_consensus_bench_iterations, 1), 1);
+  BenchmarkResult read_result("log_cache_read");
+  BenchmarkResult evict_result("log_cache_evict");
+  int64_t after_index = 0;
+  while (after_index < last_index) {
+    ReplicateMsgs msgs;
+    OpId preceding_op;
+    auto start = MonoTime::Now();
+    ASSERT_OK(cache.ReadOps(after_index, max_batch_bytes, &msgs, &preceding_op));
+    read_result.RecordLatency(MonoTime::Now() - start);
+    ASSERT_FALSE(msgs.empty());
+    int64_t bytes = 0;
+    for (const auto& msg : msgs) {
+      bytes += msg->ByteSize();
+    }
+    read_result.AddOps(msgs.size(), bytes);
+    after_index = msgs.back()->id().index();
+
+    start = MonoTime::Now();
+    cache.EvictThroughOp(after_index);
+    evict_result.RecordLatency(MonoTime::Now() - start);
+    evict_result.AddOps(msgs.size(), bytes);
+  }
+  ASSERT_OK(read_result.Finish());
+  ASSERT_OK(evict_result.Finish());
+}
+
+// Latency of assembling a request for a follower and processing its response, when each of the
+// simulated followers acknowledges all operations it receives.
+TEST_F(ConsensusBench, PeerMessageQueue) {
+  TestRaftConsensusQueueIface observer;
+  PeerMessageQueue queue(metric_entity_,
+                         log_.get(),
+                         nullptr /* server_tracker */,
+                         FakeRaftPeerPB(kLeaderUuid),
+                         kTestTablet,
+                         clock_,
+                         raft_pool_->NewToken(ThreadPool::ExecutionMode::SERIAL));
+  queue.RegisterObserver(&observer);
+  queue.Init(MinimumOpId());
+  queue.SetLeaderMode(MinimumOpId(), MinimumOpId().term(),
+                      BuildRaftConfigPBForTests(FLAGS_consensus_bench_followers + 1));
+  std::vector<std::string> followers;
+  for (int i = 1; i <= FLAGS_consensus_bench_followers; ++i) {
+    followers.push_back(Substitute("peer-$0", i));
+    queue.TrackPeer(followers.back());
+  }
+
+  BenchmarkResult result("peer_message_queue");
+  ConsensusRequestPB request;
+  ConsensusResponsePB response;
+  for (int i = 0; i < FLAGS_consensus_bench_iterations; ++i) {
+    int64_t bytes = 0;
+    ASSERT_OK(queue.AppendOperations(
+        NextBatch(&bytes), yb::OpId() /* committed_op_id */, restart_safe_clock_.Now(),
+        Bind(&FatalOnError)));
+    for (const auto& follower : followers) {
+      bool more_pending = true;
+      while (more_pending) {
+        const auto start = MonoTime::Now();
+        ReplicateMsgsHolder holder;
+        bool needs_remote_bootstrap = false;
+        ASSERT_OK(queue.RequestForPeer(follower, &request, &holder, &needs_remote_bootstrap));
+        ASSERT_FALSE(needs_remote_bootstrap);
+        if (request.ops_size() == 0) {
+          break;
+        }
+        const auto& last_received = request.ops(request.ops_size() - 1).id();
+        response.set_responder_uuid(follower);
+        auto* status = response.mutable_status();
+        *status->mutable_last_received() = last_received;
+        *status->mutable_last_received_current_leader() = last_received;
+        status->set_last_committed_idx(request.committed_index().index());
+        queue.ResponseFromPeer(follower, response, &more_pending);
+        result.RecordLatency(MonoTime::Now() - start);
+        for (const auto& op : request.ops()) {
+          result.AddOps(1, op.ByteSize());
+        }
+      }
+    }
+  }
+  ASSERT_OK(log_->WaitUntilAllFlushed());
+  queue.Close();
+  ASSERT_OK(result.Finish());
+}
+
+// Replication of operations by a RaftConsensus leader to its followers, each with its own log,
+// that are called in process through LocalTestPeerProxy, i.e. without RPC serialization.
+class RaftReplicationBench : public ConsensusBench {
+ public:
+  RaftReplicationBench() {
+    options_.tablet_id = kTestTablet;
+    FLAGS_enable_leader_failure_detection = false;
+  }
+
+  void SetUp() override {
+    ConsensusBench::SetUp();
+    config_ = BuildRaftConfigPBForTests(FLAGS_consensus_bench_followers + 1);
+    config_.set_opid_index(kInvalidOpIdIndex);
+    peers_.reset(new TestPeerMapManager(config_));
+    raft_clock_ = server::LogicalClock::CreateStartingAt(HybridTime(0));
+    for (int i = 0; i < config_.peers_size(); ++i) {
+      ASSERT_NO_FATALS(BuildPeer(i));
+    }
+    ConsensusBootstrapInfo boot_info;
+    for (const auto& entry : peers_->GetPeerMapCopy()) {
+      ASSERT_OK(entry.second->Start(boot_info));
+    }
+    ASSERT_OK(peers_->GetPeerByIdx(0, &leader_));
+    ASSERT_OK(leader_->EmulateElection());
+    ASSERT_OK(leader_->WaitUntilLeaderForTests(MonoDelta::FromSeconds(10)));
+  }
+
+  void TearDown() override {
+    for (const auto& entry : peers_->GetPeerMapCopy()) {
+      entry.second->Shutdown();
+    }
+    leader_.reset();
+    peers_->Clear();
+    operation_factories_.clear();
+    // The logs must be closed before their fs managers are destroyed.
+    logs_.clear();
+    peer_fs_managers_.clear();
+    ConsensusBench::TearDown();
+  }
+
+ protected:
+  void BuildPeer(int idx) {
+    const std::string& peer_uuid = config_.peers(idx).permanent_uuid();
+    auto parent_mem_tracker = MemTracker::CreateTracker(peer_uuid);
+    parent_mem_trackers_.push_back(parent_mem_tracker);
+    const std::string root = GetTestPath(Substitute("$0-root", peer_uuid));
+    FsManagerOpts opts;
+    opts.parent_mem_tracker = parent_mem_tracker;
+    opts.wal_paths = { root };
+    opts.data_paths = { root };
+    opts.server_type = "tserver_test";
+    std::unique_ptr<FsManager> fs_manager(new FsManager(env_.get(), opts));
+    ASSERT_OK(fs_manager->CreateInitialFileSystemLayout());
+    ASSERT_OK(fs_manager->Open());
+
+    scoped_refptr<log::Log> log;
+    ASSERT_OK(log::Log::Open(log::LogOptions(),
+                             fs_manager.get(),
+                             kTestTablet,
+                             fs_manager->GetFirstTabletWalDirOrDie(kTestTable, kTestTablet),
+                             schema_,
+                             0, // schema_version
+                             nullptr, // metric_entity
+                             append_pool_.get(),
+                             &log));
+
+    std::unique_ptr<ConsensusMetadata> cmeta;
+    ASSERT_OK(ConsensusMetadata::Create(fs_manager.get(), kTestTablet, peer_uuid, config_,
+                                        kMinimumTerm, &cmeta));
+    RaftPeerPB local_peer_pb;
+    ASSERT_OK(GetRaftConfigMember(config_, peer_uuid, &local_peer_pb));
+    gscoped_ptr<PeerMessageQueue> queue(
+        new PeerMessageQueue(metric_entity_,
+                             log,
+                             MemTracker::FindOrCreateTracker(peer_uuid),
+                             local_peer_pb,
+                             kTestTablet,
+                             raft_clock_,
+                             raft_pool_->NewToken(ThreadPool::ExecutionMode::SERIAL)));
+    std::unique_ptr<ThreadPoolToken> pool_token(
+        raft_pool_->NewToken(ThreadPool::ExecutionMode::CONCURRENT));
+    auto proxy_factory = new LocalTestPeerProxyFactory(peers_.get());
+    gscoped_ptr<PeerManager> peer_manager(
+        new PeerManager(kTestTablet, peer_uuid, proxy_factory, queue.get(), pool_token.get(),
+                        log));
+    auto operation_factory = std::make_unique<TestOperationFactory>();
+
+    std::shared_ptr<RaftConsensus> peer(
+        new RaftConsensus(options_,
+                          std::move(cmeta),
+                          gscoped_ptr<PeerProxyFactory>(proxy_factory).Pass(),
+                          queue.Pass(),
+                          peer_manager.Pass(),
+                          std::move(pool_token),
+                          metric_entity_,
+                          peer_uuid,
+                          raft_clock_,
+                          operation_factory.get(),
+                          log,
+                          parent_mem_tracker,
+                          Bind(&DoNothing),
+                          DEFAULT_TABLE_TYPE,
+                          nullptr /* retryable_requests */));
+    operation_factory->SetConsensus(peer.get());
+    operation_factories_.push_back(std::move(operation_factory));
+    peers_->AddPeer(peer_uuid, peer);
+    logs_.push_back(log);
+    peer_fs_managers_.push_back(std::move(fs_manager));
+  }
+
+  ConsensusOptions options_;
+  RaftConfigPB config_;
+  scoped_refptr<server::Clock> raft_clock_;
+  std::vector<std::shared_ptr<MemTracker>> parent_mem_trackers_;
+  std::vector<std::unique_ptr<FsManager>> peer_fs_managers_;
+  std::vector<scoped_refptr<log::Log>> logs_;
+  std::vector<std::unique_ptr<TestOperationFactory>> operation_factories_;
+  gscoped_ptr<TestPeerMapManager> peers_;
+  std::shared_ptr<RaftConsensus> leader_;
+};
+
+// Latency from submitting an operation to the leader until it is replicated to a majority, with
+// a batch of operations in flight at a time.
+TEST_F(RaftReplicationBench, Replication) {
+  BenchmarkResult result("raft_replication");
+  for (int i = 0; i < FLAGS_consensus_bench_iterations; ++i) {
+    CountDownLatch latch(FLAGS_consensus_bench_batch_size);
+    std::vector<ConsensusRoundPtr> rounds;
+    int64_t bytes = 0;
+    for (int j = 0; j < FLAGS_consensus_bench_batch_size; ++j) {
+      auto msg = std::make_shared<ReplicateMsg>();
+      msg->set_op_type(NO_OP);
+      msg->mutable_noop_request()->mutable_payload_for_tests()->resize(
+          FLAGS_consensus_bench_payload_bytes);
+      msg->set_hybrid_time(raft_clock_->Now().ToUint64());
+      bytes += msg->ByteSize();
+      const auto start = MonoTime::Now();
+      rounds.push_back(leader_->NewRound(
+          std::move(msg), [&result, &latch, start](const Status& status, int64_t leader_term) {
+            CHECK_OK(status);
+            result.RecordLatency(MonoTime::Now() - start);
+            latch.CountDown();
+          }));
+      ASSERT_OK(leader_->TEST_Replicate(rounds.back()));
+    }
+    latch.Wait();
+    result.AddOps(rounds.size(), bytes);
+  }
+  ASSERT_OK(result.Finish());
+}
+
+} // namespace consensus
+} // namespace yb
@@ -22,6 +22,7 @@
 #include "yb/client/client.h"
 #include "yb/client/meta_cache.h"
 #include "yb/client/table_handle.h"
+#include "yb/client/transaction_manager.h"
 #include "yb/common/partition.h"
 #include "yb/yql/redis/redisserver/redis_constants.h"
 #include "yb/yql/redis/redisserver/redis_parser.h"
@@ -31,6 +32,7 @@
 #include "yb/gutil/strings/substitute.h"
 #include "yb/master/master.h"
 #include "yb/master/master.pb.h"
+#include "yb/server/hybrid_clock.h"
 #include "yb/util/atomic.h"
 #include "yb/util/env.h"
 #include "yb/util/flags.h"
@@ -40,6 +42,7 @@
 #include "yb/util/threadpool.h"
 
 #include "yb/integration-tests/load_generator.h"
+#include "yb/integration-tests/ycsb_workload.h"
 
 DEFINE_int32(rpc_timeout_sec, 30, "Timeout for RPC calls, in seconds");
 
@@ -96,10 +99,62 @@ DEFINE_bool(
 
 DEFINE_int64(value_size_bytes, 16, "Size of each value in a row being inserted");
 
+DEFINE_int32(bulk_write_batch_size, 0,
+             "If positive, rows are inserted through the bulk writer, that sends batches of up to "
+             "this number of rows to each tablet.");
+
 DEFINE_bool(
     stop_on_empty_read, true,
     "Stop reading if we get an empty set of rows on a read operation");
 
+DEFINE_bool(create_transactional_table, false,
+            "Whether the created table is transactional, required for multi-key updates.");
+
+DEFINE_string(ycsb_workload, "",
+              "If set, num_rows keys are loaded and then the YCSB core workload with this name "
+              "(a-f) is run instead of the writer and the reader. 'custom' runs the mix given by "
+              "the ycsb_*_proportion flags.");
+
+DEFINE_double(ycsb_read_proportion, 0, "Share of reads for the custom YCSB workload.");
+DEFINE_double(ycsb_update_proportion, 0, "Share of updates for the custom YCSB workload.");
+DEFINE_double(ycsb_insert_proportion, 0, "Share of inserts for the custom YCSB workload.");
+DEFINE_double(ycsb_scan_proportion, 0, "Share of scans for the custom YCSB workload.");
+DEFINE_double(ycsb_read_modify_write_proportion, 0,
+              "Share of read-modify-writes for the custom YCSB workload.");
+DEFINE_double(ycsb_multi_key_update_proportion, 0,
+              "Share of transactional multi-key updates for the custom YCSB workload.");
+
+DEFINE_string(ycsb_key_distribution, "",
+              "Overrides the key distribution of the YCSB workload: uniform, zipfian, latest or "
+              "hotspot.");
+
+DEFINE_double(ycsb_hotspot_data_fraction, 0.2, "Share of hot keys for the hotspot distribution.");
+
+DEFINE_double(ycsb_hotspot_ops_fraction, 0.8,
+              "Share of operations that go to hot keys for the hotspot distribution.");
+
+DEFINE_int32(ycsb_max_scan_length, 100, "Maximum number of rows read by a YCSB scan.");
+
+DEFINE_int32(ycsb_multi_key_update_size, 4,
+             "Number of keys updated by a single transaction of a multi-key update.");
+
+DEFINE_int32(ycsb_num_threads, 16, "Number of threads issuing YCSB operations.");
+
+DEFINE_double(ycsb_target_ops_per_sec, 0,
+              "If positive, YCSB operations are issued open loop at this total rate and latencies "
+              "include the time operations waited to be issued. Otherwise each thread issues the "
+              "next operation after the previous one completes.");
+
+DEFINE_int64(ycsb_num_ops, 0, "If positive, the YCSB workload stops after this number of ops.");
+
+DEFINE_int32(ycsb_duration_sec, 60, "Maximum time the YCSB workload runs, in seconds.");
+
+DEFINE_bool(ycsb_skip_load, false, "Run the YCSB workload against keys loaded by a previous run.");
+
+DEFINE_string(ycsb_stats_json_path, "",
+              "If set, latency percentiles of each YCSB operation type are written to this file "
+              "as JSON, otherwise they are logged.");
+
 using strings::Substitute;
 using std::atomic_long;
 using std::atomic_bool;
@@ -132,6 +187,7 @@ using strings::Substitute;
 using yb::load_generator::KeyIndexSet;
 using yb::load_generator::SessionFactory;
 using yb::load_generator::NoopSessionFactory;
+using yb::load_generator::YBBulkSessionFactory;
 using yb::load_generator::YBSessionFactory;
 using yb::load_generator::RedisNoopSessionFactory;
 using yb::load_generator::RedisSessionFactory;
@@ -148,6 +204,8 @@ void CreateYBTable(const YBTableName &table_name, const shared_ptr<YBClient> &cl
 
 void LaunchYBLoadTest(SessionFactory *session_factory);
 
+void RunYcsbWorkload(const shared_ptr<YBClient> &client, yb::client::TableHandle* table);
+
 shared_ptr<YBClient> CreateYBClient();
 
 void SetupYBTable(const shared_ptr<YBClient> &client);
@@ -187,7 +245,9 @@ int main(int argc, char *argv[]) {
 
       yb::client::TableHandle table;
       CHECK_OK(table.Open(table_name, client.get()));
-      if (FLAGS_reads_only) {
+      if (!FLAGS_ycsb_workload.empty()) {
+        RunYcsbWorkload(client, &table);
+      } else if (FLAGS_reads_only) {
         SingleThreadedScanner scanner(&table);
         scanner.CountRows();
       } else if (FLAGS_noop_only) {
@@ -195,6 +255,9 @@ int main(int argc, char *argv[]) {
         // Noop operations are done as write operations.
         FLAGS_writes_only = true;
         LaunchYBLoadTest(&session_factory);
+      } else if (FLAGS_bulk_write_batch_size > 0) {
+        YBBulkSessionFactory session_factory(client.get(), &table, FLAGS_bulk_write_batch_size);
+        LaunchYBLoadTest(&session_factory);
       } else {
         YBSessionFactory session_factory(client.get(), &table);
         LaunchYBLoadTest(&session_factory);
@@ -303,6 +366,11 @@ void CreateYBTable(const YBTableName &table_name, const shared_ptr<YBClient> &cl
   YBSchemaBuilder schemaBuilder;
   schemaBuilder.AddColumn("k")->PrimaryKey()->Type(yb::BINARY)->NotNull();
   schemaBuilder.AddColumn("v")->Type(yb::BINARY)->NotNull();
+  if (FLAGS_create_transactional_table) {
+    yb::TableProperties table_properties;
+    table_properties.SetTransactional(true);
+    schemaBuilder.SetTableProperties(table_properties);
+  }
   YBSchema schema;
   CHECK_OK(schemaBuilder.Build(&schema));
 
@@ -381,3 +449,59 @@ void LaunchYBLoadTest(SessionFactory *session_factory) {
     reader.WaitForCompletion();
   }
 }
+
+void RunYcsbWorkload(const shared_ptr<YBClient> &client, yb::client::TableHandle* table) {
+  using yb::load_generator::YcsbOperation;
+
+  yb::load_generator::YcsbWorkloadOptions options;
+  if (FLAGS_ycsb_workload == "custom") {
+    auto set = [&options](YcsbOperation op, double proportion) {
+      options.proportions[yb::to_underlying(op)] = proportion;
+    };
+    set(YcsbOperation::kRead, FLAGS_ycsb_read_proportion);
+    set(YcsbOperation::kUpdate, FLAGS_ycsb_update_proportion);
+    set(YcsbOperation::kInsert, FLAGS_ycsb_insert_proportion);
+    set(YcsbOperation::kScan, FLAGS_ycsb_scan_proportion);
+    set(YcsbOperation::kReadModifyWrite, FLAGS_ycsb_read_modify_write_proportion);
+    set(YcsbOperation::kMultiKeyUpdate, FLAGS_ycsb_multi_key_update_proportion);
+  } else {
+    CHECK_OK(options.ApplyPreset(FLAGS_ycsb_workload));
+  }
+  if (!FLAGS_ycsb_key_distribution.empty()) {
+    options.distribution = CHECK_RESULT(
+        yb::load_generator::ParseKeyDistribution(FLAGS_ycsb_key_distribution));
+  }
+  options.record_count = FLAGS_num_rows;
+  options.value_size = FLAGS_value_size_bytes;
+  options.max_scan_length = FLAGS_ycsb_max_scan_length;
+  options.multi_key_update_size = FLAGS_ycsb_multi_key_update_size;
+  options.hotspot_data_fraction = FLAGS_ycsb_hotspot_data_fraction;
+  options.hotspot_ops_fraction = FLAGS_ycsb_hotspot_ops_fraction;
+  options.num_threads = FLAGS_ycsb_num_threads;
+  options.target_ops_per_second = FLAGS_ycsb_target_ops_per_sec;
+  options.num_operations = FLAGS_ycsb_num_ops;
+  options.duration = MonoDelta::FromSeconds(FLAGS_ycsb_duration_sec);
+
+  boost::optional<yb::client::TransactionManager> txn_manager;
+  if (table->table()->schema().table_properties().is_transactional()) {
+    yb::server::ClockPtr clock(new yb::server::HybridClock(yb::WallClock()));
+    CHECK_OK(clock->Init());
+    txn_manager.emplace(client, clock, yb::client::LocalTabletFilter());
+  }
+
+  yb::load_generator::YcsbWorkload workload(options, table, txn_manager.get_ptr());
+  if (!FLAGS_ycsb_skip_load) {
+    CHECK_OK(workload.Load());
+  }
+  atomic_bool stop_flag(false);
+  CHECK_OK(workload.Run(&stop_flag));
+
+  const auto json = workload.stats().ToJson(workload.elapsed());
+  if (FLAGS_ycsb_stats_json_path.empty()) {
+    LOG(INFO) << "YCSB workload " << FLAGS_ycsb_workload << " stats: " << json;
+  } else {
+    CHECK_OK(yb::WriteStringToFile(yb::Env::Default(), json, FLAGS_ycsb_stats_json_path));
+    LOG(INFO) << "YCSB workload " << FLAGS_ycsb_workload << " stats written to "
+              << FLAGS_ycsb_stats_json_path;
+  }
+}
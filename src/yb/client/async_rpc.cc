@@ -17,6 +17,7 @@
 #include "yb/client/client-internal.h"
 #include "yb/client/in_flight_op.h"
 #include "yb/client/meta_cache.h"
+#include "yb/client/write_coalescer.h"
 #include "yb/client/yb_op.h"
 
 #include "yb/common/wire_protocol.h"
@@ -44,6 +45,13 @@ METRIC_DEFINE_histogram(
     server, handler_latency_yb_client_time_to_send,
     "Time taken for a Write/Read rpc to be sent to the server", yb::MetricUnit::kMicroseconds,
     "Microseconds spent before sending the request to the server", 60000000LU, 2);
+METRIC_DEFINE_histogram(
+    server, yb_client_write_rpc_ops, "Number of operations in a Write rpc",
+    yb::MetricUnit::kOperations, "Number of operations sent in a single Write rpc", 100000LU, 2);
+METRIC_DEFINE_histogram(
+    server, yb_client_write_rpc_batchers, "Number of batchers coalesced into a Write rpc",
+    yb::MetricUnit::kUnits, "Number of batchers whose operations were sent in a single Write rpc",
+    10000LU, 2);
 DECLARE_bool(rpc_dump_all_traces);
 DECLARE_bool(collect_end_to_end_traces);
 
@@ -96,7 +104,9 @@ AsyncRpcMetrics::AsyncRpcMetrics(const scoped_refptr<yb::MetricEntity>& entity)
       remote_read_rpc_time(METRIC_handler_latency_yb_client_read_remote.Instantiate(entity)),
       local_write_rpc_time(METRIC_handler_latency_yb_client_write_local.Instantiate(entity)),
       local_read_rpc_time(METRIC_handler_latency_yb_client_read_local.Instantiate(entity)),
-      time_to_send(METRIC_handler_latency_yb_client_time_to_send.Instantiate(entity)) {
+      time_to_send(METRIC_handler_latency_yb_client_time_to_send.Instantiate(entity)),
+      write_rpc_ops(METRIC_yb_client_write_rpc_ops.Instantiate(entity)),
+      write_rpc_batchers(METRIC_yb_client_write_rpc_batchers.Instantiate(entity)) {
 }
 
 AsyncRpc::AsyncRpc(AsyncRpcData* data, YBConsistencyLevel yb_consistency_level)
@@ -112,6 +122,8 @@ AsyncRpc::AsyncRpc(AsyncRpcData* data, YBConsistencyLevel yb_consistency_level)
                       mutable_retrier(),
                       trace_.get()),
       ops_(std::move(data->ops)),
+      coalescer_(std::move(data->coalescer)),
+      coalesced_batchers_(std::move(data->coalesced_batchers)),
       start_(MonoTime::Now()),
       async_rpc_metrics_(data->batcher->async_rpc_metrics()) {
   mutable_retrier()->mutable_controller()->set_allow_local_calls_in_curr_thread(
@@ -155,12 +167,40 @@ const YBTable* AsyncRpc::table() const {
   return ops_[0]->yb_op->table();
 }
 
+template <class F>
+void AsyncRpc::ForEachBatcher(const F& f) {
+  if (coalesced_batchers_.empty()) {
+    f(batcher_.get(), ops_);
+    return;
+  }
+
+  auto it = ops_.begin();
+  auto process = [this, &f, &it](Batcher* batcher) {
+    auto begin = it;
+    while (it != ops_.end() && (**it).batcher == batcher) {
+      ++it;
+    }
+    f(batcher, InFlightOps(begin, it));
+  };
+  process(batcher_.get());
+  for (const auto& batcher : coalesced_batchers_) {
+    process(batcher.get());
+  }
+  DCHECK(it == ops_.end());
+}
+
 void AsyncRpc::Finished(const Status& status) {
   Status new_status = status;
   if (tablet_invoker_.Done(&new_status)) {
     ProcessResponseFromTserver(new_status);
-    batcher_->RemoveInFlightOpsAfterFlushing(ops_, new_status, MakeFlushExtraResult());
-    batcher_->CheckForFinishedFlush();
+    auto flush_extra_result = MakeFlushExtraResult();
+    ForEachBatcher([&new_status, &flush_extra_result](Batcher* batcher, const InFlightOps& ops) {
+      batcher->RemoveInFlightOpsAfterFlushing(ops, new_status, flush_extra_result);
+      batcher->CheckForFinishedFlush();
+    });
+    if (coalescer_) {
+      coalescer_->WriteFinished(tablet().tablet_id());
+    }
     retained_self_.reset();
   }
 }
@@ -252,7 +292,7 @@ template <class Req, class Resp>
 AsyncRpcBase<Req, Resp>::AsyncRpcBase(AsyncRpcData* data, YBConsistencyLevel consistency_level)
     : AsyncRpc(data, consistency_level) {
   req_.set_tablet_id(tablet_invoker_.tablet()->tablet_id());
-  req_.set_include_trace(IsTracingEnabled());
+  req_.set_include_trace(IsTracingEnabled() || trace_->sampled());
   const ConsistentReadPoint* read_point = batcher_->read_point();
   if (read_point) {
     req_.set_propagated_hybrid_time(read_point->Now().ToUint64());
@@ -389,6 +429,11 @@ WriteRpc::WriteRpc(AsyncRpcData* data)
             << req_.ShortDebugString();
   }
 
+  if (async_rpc_metrics_) {
+    async_rpc_metrics_->write_rpc_ops->Increment(ops_.size());
+    async_rpc_metrics_->write_rpc_batchers->Increment(coalesced_batchers_.size() + 1);
+  }
+
   const auto& client_id = batcher_->client_id();
   if (!client_id.IsNil() && FLAGS_detect_duplicates_for_retryable_requests) {
     auto temp = client_id.ToUInt64Pair();
@@ -561,7 +606,9 @@ void WriteRpc::ProcessResponseFromTserver(const Status& status) {
   if (resp_.has_trace_buffer()) {
     TRACE_TO(trace_, "Received from server: $0", resp_.trace_buffer());
   }
-  batcher_->ProcessWriteResponse(*this, status);
+  ForEachBatcher([this, &status](Batcher* batcher, const InFlightOps& ops) {
+    batcher->ProcessWriteResponse(*this, status);
+  });
   if (!CommonResponseCheck(status)) {
     SwapRequestsAndResponses(true);
     return;
@@ -787,6 +834,9 @@ void ReadRpc::ProcessResponseFromTserver(const Status& status) {
     return;
   }
   SwapRequestsAndResponses(false);
+  if (resp_.has_used_read_time()) {
+    batcher_->CacheReadResults(ops_, ReadHybridTime::FromPB(resp_.used_read_time()));
+  }
 }
 
 }  // namespace internal
@@ -34,6 +34,7 @@ class Batcher;
 struct InFlightOp;
 class RemoteTablet;
 class RemoteTabletServer;
+class WriteCoalescer;
 
 // Container for async rpc metrics
 struct AsyncRpcMetrics {
@@ -44,6 +45,8 @@ struct AsyncRpcMetrics {
   scoped_refptr<Histogram> local_write_rpc_time;
   scoped_refptr<Histogram> local_read_rpc_time;
   scoped_refptr<Histogram> time_to_send;
+  scoped_refptr<Histogram> write_rpc_ops;
+  scoped_refptr<Histogram> write_rpc_batchers;
 };
 
 typedef std::shared_ptr<AsyncRpcMetrics> AsyncRpcMetricsPtr;
@@ -54,6 +57,11 @@ struct AsyncRpcData {
   bool allow_local_calls_in_curr_thread = false;
   bool need_consistent_read = false;
   InFlightOps ops;
+  // Set when ops of several batchers are coalesced into a single RPC, see WriteCoalescer.
+  // Ops of each batcher form a contiguous range, ordered as batcher followed by
+  // coalesced_batchers.
+  std::shared_ptr<WriteCoalescer> coalescer;
+  std::vector<scoped_refptr<Batcher>> coalesced_batchers;
 };
 
 struct FlushExtraResult {
@@ -104,6 +112,10 @@ class AsyncRpc : public rpc::Rpc, public TabletRpc {
   // Is this a local call?
   bool IsLocalCall() const;
 
+  // Invokes f(batcher, ops) for each batcher whose ops are sent in this RPC.
+  template <class F>
+  void ForEachBatcher(const F& f);
+
   // Pointer back to the batcher. Processes the write response when it
   // completes, regardless of success or failure.
   scoped_refptr<Batcher> batcher_;
@@ -117,6 +129,9 @@ class AsyncRpc : public rpc::Rpc, public TabletRpc {
   // These operations are in kRequestSent state.
   InFlightOps ops_;
 
+  std::shared_ptr<WriteCoalescer> coalescer_;
+  std::vector<scoped_refptr<Batcher>> coalesced_batchers_;
+
   MonoTime start_;
   std::shared_ptr<AsyncRpcMetrics> async_rpc_metrics_;
   rpc::RpcCommandPtr retained_self_;
@@ -50,8 +50,10 @@
 #include "yb/client/error_collector.h"
 #include "yb/client/in_flight_op.h"
 #include "yb/client/meta_cache.h"
+#include "yb/client/read_cache.h"
 #include "yb/client/session-internal.h"
 #include "yb/client/transaction.h"
+#include "yb/client/write_coalescer.h"
 #include "yb/client/yb_op.h"
 
 #include "yb/common/wire_protocol.h"
@@ -61,6 +63,7 @@
 #include "yb/util/debug-util.h"
 #include "yb/util/flag_tags.h"
 #include "yb/util/logging.h"
+#include "yb/util/memory/arena.h"
 
 DEFINE_bool(redis_allow_reads_from_followers, false,
             "If true, the read will be served from the closest replica in the same AZ, which can "
@@ -97,6 +100,51 @@ namespace internal {
 const std::string Batcher::kErrorReachingOutToTServersMsg(
     "Errors occured while reaching out to the tablet servers");
 
+namespace {
+
+// Allocates objects from an arena, that is kept alive while there are objects allocated by it.
+// So in flight ops of a batch are allocated together and released at once, even when some of
+// them outlive their batcher.
+template <class T>
+class SharedArenaAllocator {
+ public:
+  typedef T value_type;
+
+  explicit SharedArenaAllocator(std::shared_ptr<ThreadSafeArena> arena)
+      : arena_(std::move(arena)) {}
+
+  template <class U>
+  SharedArenaAllocator(const SharedArenaAllocator<U>& other) // NOLINT
+      : arena_(other.arena()) {}
+
+  T* allocate(size_t n) {
+    auto* result = arena_->AllocateBytesAligned(n * sizeof(T), alignof(T));
+    if (!result) {
+      throw std::bad_alloc();
+    }
+    return static_cast<T*>(result);
+  }
+
+  void deallocate(T* p, size_t n) {}
+
+  const std::shared_ptr<ThreadSafeArena>& arena() const { return arena_; }
+
+ private:
+  std::shared_ptr<ThreadSafeArena> arena_;
+};
+
+template <class T, class U>
+bool operator==(const SharedArenaAllocator<T>& lhs, const SharedArenaAllocator<U>& rhs) {
+  return lhs.arena() == rhs.arena();
+}
+
+template <class T, class U>
+bool operator!=(const SharedArenaAllocator<T>& lhs, const SharedArenaAllocator<U>& rhs) {
+  return !(lhs == rhs);
+}
+
+} // namespace
+
 // About lock ordering in this file:
 // ------------------------------
 // The locks must be acquired in the following order:
@@ -131,8 +179,10 @@ Batcher::Batcher(YBClient* client,
 
 void Batcher::Abort(const Status& status) {
   bool run_callback;
+  bool was_flushing;
   {
     std::lock_guard<simple_spinlock> lock(mutex_);
+    was_flushing = state_ == kFlushing;
     state_ = kAborted;
 
     InFlightOps to_abort;
@@ -151,6 +201,11 @@ void Batcher::Abort(const Status& status) {
     run_callback = flush_callback_;
   }
 
+  // Flushing batcher is aborted only before its ops are sent, so the flush is finished.
+  if (was_flushing && transaction_) {
+    transaction_->FlushFinished();
+  }
+
   if (run_callback) {
     RunCallback(status);
   }
@@ -207,6 +262,10 @@ void Batcher::CheckForFinishedFlush() {
     session_data->FlushFinished(this);
   }
 
+  if (transaction_) {
+    transaction_->FlushFinished();
+  }
+
   Status s;
   if (!combined_error_.ok()) {
     s = combined_error_;
@@ -241,6 +300,10 @@ MonoTime Batcher::ComputeDeadlineUnlocked() const {
 }
 
 void Batcher::FlushAsync(StatusFunctor callback) {
+  if (transaction_) {
+    transaction_->FlushStarted();
+  }
+
   {
     std::lock_guard<simple_spinlock> l(mutex_);
     CHECK_EQ(state_, kGatheringOps);
@@ -264,10 +327,23 @@ void Batcher::FlushAsync(StatusFunctor callback) {
 }
 
 Status Batcher::Add(shared_ptr<YBOperation> yb_op) {
+  std::string partition_key;
+  RETURN_NOT_OK(yb_op->GetPartitionKey(&partition_key));
+
+  // Read served from the cache is completed right away, so it does not need an in flight op.
+  if (yb_op->type() == YBOperation::Type::QL_READ && !transaction_ &&
+      client_->data_->read_cache_->Lookup(down_cast<YBqlReadOp*>(yb_op.get()))) {
+    VLOG(3) << "Read from cache: " << yb_op->ToString();
+    return Status::OK();
+  }
+
   // As soon as we get the op, start looking up where it belongs,
   // so that when the user calls Flush, we are ready to go.
-  auto in_flight_op = std::make_shared<InFlightOp>();
-  RETURN_NOT_OK(yb_op->GetPartitionKey(&in_flight_op->partition_key));
+  if (!arena_) {
+    arena_ = std::make_shared<ThreadSafeArena>();
+  }
+  auto in_flight_op = std::allocate_shared<InFlightOp>(SharedArenaAllocator<InFlightOp>(arena_));
+  in_flight_op->partition_key = std::move(partition_key);
   in_flight_op->yb_op = yb_op;
   in_flight_op->state = InFlightOpState::kLookingUpTablet;
 
@@ -326,6 +402,7 @@ void Batcher::AddInFlightOp(const InFlightOpPtr& op) {
   std::lock_guard<simple_spinlock> l(mutex_);
   CHECK_EQ(state_, kGatheringOps);
   CHECK(ops_.insert(op).second);
+  op->batcher = this;
   op->sequence_number_ = next_op_sequence_number_++;
   ++outstanding_lookups_;
 }
@@ -568,6 +645,13 @@ void Batcher::FlushBuffer(
   InFlightOps ops(begin, end);
   std::shared_ptr<AsyncRpc> rpc;
   auto op_group = GetOpGroup(*begin);
+  // Writes of different sessions could be coalesced only when they don't have to carry
+  // session specific data, like transaction metadata or read time.
+  if (op_group == OpGroup::kWrite && !need_consistent_read && !transaction_ &&
+      WriteCoalescer::Enabled()) {
+    client_->data_->write_coalescer_->Write(tablet, this, std::move(ops));
+    return;
+  }
   AsyncRpcData data{this, tablet, allow_local_calls_in_curr_thread, need_consistent_read,
                     std::move(ops)};
   switch (op_group) {
@@ -626,7 +710,9 @@ void Batcher::ProcessRpcStatus(const AsyncRpc &rpc, const Status &s) {
     // Mark each of the ops as failed, since the whole RPC failed.
     std::lock_guard<simple_spinlock> lock(mutex_);
     for (auto& in_flight_op : rpc.ops()) {
-      CombineErrorUnlocked(in_flight_op, s);
+      if (in_flight_op->batcher == this) {
+        CombineErrorUnlocked(in_flight_op, s);
+      }
     }
   }
 }
@@ -635,6 +721,18 @@ void Batcher::ProcessReadResponse(const ReadRpc &rpc, const Status &s) {
   ProcessRpcStatus(rpc, s);
 }
 
+void Batcher::CacheReadResults(const InFlightOps& ops, const ReadHybridTime& read_time) {
+  if (transaction_) {
+    return;
+  }
+  auto& read_cache = *client_->data_->read_cache_;
+  for (const auto& op : ops) {
+    if (op->yb_op->type() == YBOperation::Type::QL_READ) {
+      read_cache.Insert(*down_cast<YBqlReadOp*>(op->yb_op.get()), read_time);
+    }
+  }
+}
+
 void Batcher::ProcessWriteResponse(const WriteRpc &rpc, const Status &s) {
   ProcessRpcStatus(rpc, s);
 
@@ -655,10 +753,14 @@ void Batcher::ProcessWriteResponse(const WriteRpc &rpc, const Status &s) {
                  << rpc.resp().DebugString();
       continue;
     }
-    shared_ptr<YBOperation> yb_op = rpc.ops()[err_pb.row_index()]->yb_op;
+    const auto& op = rpc.ops()[err_pb.row_index()];
+    if (op->batcher != this) {
+      continue;
+    }
+    shared_ptr<YBOperation> yb_op = op->yb_op;
     VLOG(1) << "Error on op " << yb_op->ToString() << ": " << err_pb.error().ShortDebugString();
     std::lock_guard<simple_spinlock> lock(mutex_);
-    CombineErrorUnlocked(rpc.ops()[err_pb.row_index()], StatusFromPB(err_pb.error()));
+    CombineErrorUnlocked(op, StatusFromPB(err_pb.error()));
   }
 }
 
@@ -50,6 +50,7 @@
 #include "yb/util/atomic.h"
 #include "yb/util/debug-util.h"
 #include "yb/util/locks.h"
+#include "yb/util/memory/arena_fwd.h"
 #include "yb/util/status.h"
 
 namespace yb {
@@ -218,6 +219,9 @@ class Batcher : public RefCountedThreadSafe<Batcher> {
   void ProcessReadResponse(const ReadRpc &rpc, const Status &s);
   void ProcessWriteResponse(const WriteRpc &rpc, const Status &s);
 
+  // Stores results of successful reads done at read_time in the client read cache.
+  void CacheReadResults(const InFlightOps& ops, const ReadHybridTime& read_time);
+
   // Process RPC status.
   void ProcessRpcStatus(const AsyncRpc &rpc, const Status &s);
 
@@ -262,6 +266,10 @@ class Batcher : public RefCountedThreadSafe<Batcher> {
   std::unordered_set<InFlightOpPtr> ops_;
   InFlightOps ops_queue_;
 
+  // In flight ops are allocated from this arena, so a batch does not allocate each of them on
+  // the heap separately. Created by the first Add.
+  std::shared_ptr<ThreadSafeArena> arena_;
+
   // When each operation is added to the batcher, it is assigned a sequence number
   // which preserves the user's intended order. Preserving order is critical when
   // a batch contains multiple operations against the same row key. This member
@@ -0,0 +1,223 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/client/bulk_writer.h"
+
+#include <unordered_set>
+
+#include "yb/client/client.h"
+#include "yb/client/yb_op.h"
+
+#include "yb/gutil/casts.h"
+
+using namespace std::placeholders;
+
+namespace yb {
+namespace client {
+
+struct YBBulkWriter::Batch {
+  std::string partition_start;
+  std::vector<YBqlWriteOpPtr> ops;
+  YBSessionPtr session;
+};
+
+YBBulkWriter::YBBulkWriter(YBClient* client, YBTablePtr table, const Options& options,
+                           ErrorCallback error_callback)
+    : client_(client), table_(std::move(table)), options_(options),
+      error_callback_(std::move(error_callback)) {
+  CHECK_GT(options_.batch_size, 0);
+  CHECK_GT(options_.max_in_flight_batches_per_tablet, 0);
+}
+
+YBBulkWriter::~YBBulkWriter() {
+  auto status = Flush();
+  LOG_IF(WARNING, !status.ok()) << "Bulk write to " << table_->name().ToString() << " failed: "
+                                << status;
+}
+
+Status YBBulkWriter::Write(const std::vector<YBqlWriteOpPtr>& ops) {
+  // Route all rows before taking the lock, so concurrent writers do not wait for each other
+  // while encoding partition keys.
+  std::vector<std::string> partition_starts;
+  partition_starts.reserve(ops.size());
+  std::string partition_key;
+  for (const auto& op : ops) {
+    RETURN_NOT_OK(op->GetPartitionKey(&partition_key));
+    partition_starts.push_back(table_->FindPartitionStart(partition_key));
+  }
+
+  std::unique_lock<std::mutex> lock(mutex_);
+  for (size_t i = 0; i != ops.size(); ++i) {
+    auto& tablet = tablets_[partition_starts[i]];
+    tablet.buffer.push_back(ops[i]);
+    if (tablet.buffer.size() < options_.batch_size) {
+      continue;
+    }
+    auto batch = TakeBuffer(partition_starts[i], &lock);
+    if (batch) {
+      lock.unlock();
+      Send(batch);
+      lock.lock();
+    }
+  }
+  return Status::OK();
+}
+
+Status YBBulkWriter::WriteColumns(
+    const std::vector<std::vector<QLValuePB>>& columns, QLWriteRequestPB::QLStmtType type) {
+  const auto& schema = table_->schema();
+  if (columns.size() != schema.num_columns()) {
+    return STATUS_FORMAT(InvalidArgument, "Wrong number of columns: $0, while table has $1",
+                         columns.size(), schema.num_columns());
+  }
+  const size_t num_rows = columns.empty() ? 0 : columns.front().size();
+  for (const auto& column : columns) {
+    if (column.size() != num_rows) {
+      return STATUS_FORMAT(InvalidArgument, "Columns have different number of rows: $0 and $1",
+                           column.size(), num_rows);
+    }
+  }
+
+  const size_t num_hash_key_columns = schema.num_hash_key_columns();
+  const size_t num_key_columns = schema.num_key_columns();
+  std::vector<YBqlWriteOpPtr> ops;
+  ops.reserve(num_rows);
+  for (size_t row = 0; row != num_rows; ++row) {
+    auto op = std::make_shared<YBqlWriteOp>(table_);
+    auto* req = op->mutable_request();
+    req->set_type(type);
+    req->set_client(YQL_CLIENT_CQL);
+    req->set_request_id(0);
+    req->set_query_id(reinterpret_cast<int64_t>(op.get()));
+    req->set_schema_version(schema.version());
+    for (size_t idx = 0; idx != columns.size(); ++idx) {
+      const auto& value = columns[idx][row];
+      if (idx < num_hash_key_columns) {
+        *req->add_hashed_column_values()->mutable_value() = value;
+      } else if (idx < num_key_columns) {
+        *req->add_range_column_values()->mutable_value() = value;
+      } else if (value.value_case() != QLValuePB::VALUE_NOT_SET) {
+        auto* column_value = req->add_column_values();
+        column_value->set_column_id(schema.ColumnId(idx));
+        *column_value->mutable_expr()->mutable_value() = value;
+      }
+    }
+    ops.push_back(std::move(op));
+  }
+
+  return Write(ops);
+}
+
+Status YBBulkWriter::Flush() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  // Tablets could be added while the lock is released to send a batch, so iterate over a copy.
+  std::vector<std::string> partition_starts;
+  partition_starts.reserve(tablets_.size());
+  for (const auto& p : tablets_) {
+    if (!p.second.buffer.empty()) {
+      partition_starts.push_back(p.first);
+    }
+  }
+  for (const auto& partition_start : partition_starts) {
+    auto batch = TakeBuffer(partition_start, &lock);
+    if (batch) {
+      lock.unlock();
+      Send(batch);
+      lock.lock();
+    }
+  }
+  cond_.wait(lock, [this] { return batches_in_flight_ == 0; });
+
+  auto rows_failed = rows_failed_since_flush_;
+  rows_failed_since_flush_ = 0;
+  if (rows_failed != 0) {
+    return STATUS_FORMAT(IOError, "Failed to write $0 rows", rows_failed);
+  }
+  return Status::OK();
+}
+
+size_t YBBulkWriter::rows_written() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return rows_written_;
+}
+
+size_t YBBulkWriter::rows_failed() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return rows_failed_;
+}
+
+YBBulkWriter::BatchPtr YBBulkWriter::TakeBuffer(
+    const std::string& partition_start, std::unique_lock<std::mutex>* lock) {
+  auto& tablet = tablets_[partition_start];
+  cond_.wait(*lock, [this, &tablet] {
+    return tablet.in_flight < options_.max_in_flight_batches_per_tablet;
+  });
+  // Rows could be sent by a concurrent writer while we were waiting.
+  if (tablet.buffer.empty()) {
+    return nullptr;
+  }
+
+  auto batch = std::make_shared<Batch>();
+  batch->partition_start = partition_start;
+  batch->ops.swap(tablet.buffer);
+  tablet.buffer.reserve(options_.batch_size);
+  ++tablet.in_flight;
+  ++batches_in_flight_;
+  return batch;
+}
+
+void YBBulkWriter::Send(const BatchPtr& batch) {
+  batch->session = client_->NewSession();
+  batch->session->SetTimeout(options_.timeout);
+  for (const auto& op : batch->ops) {
+    // Failed operation is stored in the session errors, so it is reported after flush.
+    WARN_NOT_OK(batch->session->Apply(op), "Apply failed");
+  }
+  batch->session->FlushAsync(std::bind(&YBBulkWriter::Flushed, this, batch, _1));
+}
+
+void YBBulkWriter::Flushed(const BatchPtr& batch, const Status& status) {
+  std::unordered_set<const YBOperation*> failed;
+  for (const auto& error : batch->session->GetPendingErrors()) {
+    const auto& op = error->failed_op();
+    if (failed.insert(&op).second) {
+      Failed(*down_cast<const YBqlWriteOp*>(&op), error->status());
+    }
+  }
+  for (const auto& op : batch->ops) {
+    if (!op->succeeded() && !failed.count(op.get())) {
+      failed.insert(op.get());
+      Failed(*op, STATUS(RuntimeError, op->response().error_message()));
+    }
+  }
+  VLOG_IF(1, !status.ok()) << "Batch of " << batch->ops.size() << " rows failed: " << status;
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  --tablets_[batch->partition_start].in_flight;
+  --batches_in_flight_;
+  rows_written_ += batch->ops.size() - failed.size();
+  rows_failed_ += failed.size();
+  rows_failed_since_flush_ += failed.size();
+  // Notify under the lock, since the writer could be destroyed as soon as the last batch is
+  // finished.
+  cond_.notify_all();
+}
+
+void YBBulkWriter::Failed(const YBqlWriteOp& op, const Status& status) {
+  if (error_callback_) {
+    error_callback_(op, status);
+  }
+}
+
+} // namespace client
+} // namespace yb
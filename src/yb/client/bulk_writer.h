@@ -0,0 +1,132 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#ifndef YB_CLIENT_BULK_WRITER_H
+#define YB_CLIENT_BULK_WRITER_H
+
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "yb/client/client_fwd.h"
+
+#include "yb/common/ql_protocol.pb.h"
+
+#include "yb/util/monotime.h"
+#include "yb/util/status.h"
+
+namespace yb {
+namespace client {
+
+// Writes large amounts of rows to a single table.
+//
+// Rows are routed to tablets as soon as they are added and accumulated in per tablet buffers.
+// A full buffer is sent as a separate batch, so no tablet waits for rows of other tablets and
+// each batch contains rows of one tablet only. The number of batches in flight to a tablet is
+// bounded, Write blocks while the tablet of a full buffer has all of them in flight.
+//
+// Rows that failed are reported to the error callback, that could be invoked from the IO or
+// callback threads of the client, and from several threads concurrently.
+//
+// Write, WriteColumns and Flush are thread safe, but could block, so must not be invoked from
+// the IO threads.
+class YBBulkWriter {
+ public:
+  struct Options {
+    // Max number of rows sent to a tablet in a single batch.
+    size_t batch_size = 1024;
+
+    // Max number of batches in flight to a single tablet.
+    size_t max_in_flight_batches_per_tablet = 2;
+
+    // Timeout of each batch.
+    MonoDelta timeout = MonoDelta::FromSeconds(60);
+  };
+
+  typedef std::function<void(const YBqlWriteOp& op, const Status& status)> ErrorCallback;
+
+  YBBulkWriter(YBClient* client, YBTablePtr table, const Options& options,
+               ErrorCallback error_callback);
+
+  // Flushes rows that were not sent yet.
+  ~YBBulkWriter();
+
+  YBBulkWriter(const YBBulkWriter&) = delete;
+  void operator=(const YBBulkWriter&) = delete;
+
+  // Adds rows in pre-encoded form, i.e. write operations of the table.
+  CHECKED_STATUS Write(const std::vector<YBqlWriteOpPtr>& ops);
+
+  CHECKED_STATUS Write(YBqlWriteOpPtr op) {
+    return Write(std::vector<YBqlWriteOpPtr>{std::move(op)});
+  }
+
+  // Adds rows in columnar form. columns[i][j] is the value of i-th column of the table schema in
+  // j-th row, so all columns should have the same number of values. Values of non key columns
+  // that are not set are not written.
+  CHECKED_STATUS WriteColumns(
+      const std::vector<std::vector<QLValuePB>>& columns,
+      QLWriteRequestPB::QLStmtType type = QLWriteRequestPB::QL_STMT_INSERT);
+
+  // Sends all buffered rows and waits until all batches are finished.
+  // Returns error if some rows added after the previous flush failed.
+  CHECKED_STATUS Flush();
+
+  // Number of rows that were successfully written.
+  size_t rows_written() const;
+
+  // Number of rows that failed.
+  size_t rows_failed() const;
+
+ private:
+  struct Tablet {
+    std::vector<YBqlWriteOpPtr> buffer;
+    size_t in_flight = 0;
+  };
+
+  struct Batch;
+  typedef std::shared_ptr<Batch> BatchPtr;
+
+  // Takes buffered rows of tablet if they could be sent now, otherwise waits while tablet has
+  // max allowed number of batches in flight.
+  BatchPtr TakeBuffer(const std::string& partition_start, std::unique_lock<std::mutex>* lock);
+
+  void Send(const BatchPtr& batch);
+
+  void Flushed(const BatchPtr& batch, const Status& status);
+
+  void Failed(const YBqlWriteOp& op, const Status& status);
+
+  YBClient* const client_;
+  const YBTablePtr table_;
+  const Options options_;
+  const ErrorCallback error_callback_;
+
+  mutable std::mutex mutex_;
+  std::condition_variable cond_;
+  // Tablets are identified by their partition starts.
+  std::unordered_map<std::string, Tablet> tablets_;
+  size_t batches_in_flight_ = 0;
+  size_t rows_written_ = 0;
+  size_t rows_failed_ = 0;
+  size_t rows_failed_since_flush_ = 0;
+};
+
+} // namespace client
+} // namespace yb
+
+#endif // YB_CLIENT_BULK_WRITER_H
@@ -45,6 +45,7 @@
 #include <boost/preprocessor/seq/for_each.hpp>
 
 #include "yb/client/meta_cache.h"
+#include "yb/client/read_cache.h"
 #include "yb/client/table-internal.h"
 #include "yb/common/index.h"
 #include "yb/common/schema.h"
@@ -80,6 +81,19 @@ DEFINE_test_flag(bool, assert_local_tablet_server_selected, false, "Verify that
 DEFINE_test_flag(string, assert_tablet_server_select_is_in_zone, "", "Verify that SelectTServer "
                  "selected a talet server in the AZ specified by this flag.");
 
+DEFINE_bool(client_latency_aware_replica_selection, false,
+            "When selecting the closest replica of a tablet, e.g. for follower reads, prefer a "
+            "replica whose observed latency is much lower than the latency of the closest one.");
+TAG_FLAG(client_latency_aware_replica_selection, advanced);
+TAG_FLAG(client_latency_aware_replica_selection, runtime);
+
+DEFINE_double(client_replica_latency_switch_ratio, 2.0,
+              "A replica other than the closest one is selected when latency aware replica "
+              "selection is enabled and the expected latency of the closest replica is this many "
+              "times higher than its own.");
+TAG_FLAG(client_replica_latency_switch_ratio, advanced);
+TAG_FLAG(client_replica_latency_switch_ratio, runtime);
+
 DECLARE_string(flagfile);
 
 namespace yb {
@@ -273,6 +287,7 @@ YB_CLIENT_SPECIALIZE_SIMPLE(DeleteRole);
 YB_CLIENT_SPECIALIZE_SIMPLE(GrantRevokeRole);
 YB_CLIENT_SPECIALIZE_SIMPLE(GrantRevokePermission);
 YB_CLIENT_SPECIALIZE_SIMPLE(GetPermissions);
+YB_CLIENT_SPECIALIZE_SIMPLE(WatchMetadataChanges);
 YB_CLIENT_SPECIALIZE_SIMPLE(RedisConfigSet);
 YB_CLIENT_SPECIALIZE_SIMPLE(RedisConfigGet);
 // These are not actually exposed outside, but it's nice to auto-add using directive.
@@ -374,6 +389,10 @@ RemoteTabletServer* YBClient::Data::SelectTServer(RemoteTablet* rt,
         if (ret == nullptr && !filtered.empty()) {
           ret = filtered[rand() % filtered.size()];
         }
+
+        if (FLAGS_client_latency_aware_replica_selection && ret != nullptr) {
+          ret = SelectLowLatencyTServer(ret, filtered);
+        }
       }
       break;
     }
@@ -402,6 +421,34 @@ RemoteTabletServer* YBClient::Data::SelectTServer(RemoteTablet* rt,
   return ret;
 }
 
+RemoteTabletServer* YBClient::Data::SelectLowLatencyTServer(
+    RemoteTabletServer* closest, const vector<RemoteTabletServer*>& candidates) {
+  auto closest_latency = closest->ExpectedLatency();
+  if (!closest_latency.Initialized()) {
+    return closest;
+  }
+  // Replicas that were not used yet are not selected, since there is nothing telling that they are
+  // faster than the closest one, and they could be in a remote region.
+  RemoteTabletServer* best = closest;
+  auto best_latency = closest_latency;
+  for (RemoteTabletServer* rts : candidates) {
+    auto latency = rts->ExpectedLatency();
+    if (latency.Initialized() && latency < best_latency) {
+      best = rts;
+      best_latency = latency;
+    }
+  }
+  if (best != closest &&
+      closest_latency.ToNanoseconds() >
+          best_latency.ToNanoseconds() * FLAGS_client_replica_latency_switch_ratio) {
+    VLOG(2) << "Selected " << best->ToString() << " with expected latency " << best_latency
+            << " instead of closest " << closest->ToString() << " with expected latency "
+            << closest_latency;
+    return best;
+  }
+  return closest;
+}
+
 Status YBClient::Data::GetTabletServer(YBClient* client,
                                        const scoped_refptr<RemoteTablet>& rt,
                                        ReplicaSelection selection,
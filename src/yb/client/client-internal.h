@@ -177,6 +177,12 @@ class YBClient::Data {
       const std::set<std::string>& blacklist,
       std::vector<internal::RemoteTabletServer*>* candidates);
 
+  // Returns a candidate whose expected latency is FLAGS_client_replica_latency_switch_ratio times
+  // lower than the latency of closest, or closest if there is no such candidate.
+  internal::RemoteTabletServer* SelectLowLatencyTServer(
+      internal::RemoteTabletServer* closest,
+      const std::vector<internal::RemoteTabletServer*>& candidates);
+
   // Sets 'master_proxy_' from the address specified by
   // 'leader_master_hostport_'.  Called by
   // GetLeaderMasterRpc::Finished() upon successful completion.
@@ -257,6 +263,8 @@ class YBClient::Data {
   std::unique_ptr<rpc::ProxyCache> proxy_cache_;
   gscoped_ptr<DnsResolver> dns_resolver_;
   scoped_refptr<internal::MetaCache> meta_cache_;
+  std::shared_ptr<internal::WriteCoalescer> write_coalescer_;
+  std::unique_ptr<internal::ReadCache> read_cache_;
   scoped_refptr<MetricEntity> metric_entity_;
 
   // Set of hostnames and IPs on the local host.
@@ -40,12 +40,14 @@
 #include <gflags/gflags.h>
 #include <glog/stl_logging.h>
 
+#include "yb/client/bulk_writer.h"
 #include "yb/client/callbacks.h"
 #include "yb/client/client.h"
 #include "yb/client/client-internal.h"
 #include "yb/client/client-test-util.h"
 #include "yb/client/client_utils.h"
 #include "yb/client/meta_cache.h"
+#include "yb/client/read_cache.h"
 #include "yb/client/table_handle.h"
 #include "yb/client/value.h"
 #include "yb/client/yb_op.h"
@@ -86,6 +88,8 @@ DECLARE_bool(enable_data_block_fsync);
 DECLARE_bool(log_inject_latency);
 DECLARE_double(leader_failure_max_missed_heartbeat_periods);
 DECLARE_int32(heartbeat_interval_ms);
+DECLARE_int32(client_table_locations_page_size);
+DECLARE_int32(client_write_linger_us);
 DECLARE_int32(log_inject_latency_ms_mean);
 DECLARE_int32(log_inject_latency_ms_stddev);
 DECLARE_int32(master_inject_latency_on_tablet_lookups_ms);
@@ -984,6 +988,143 @@ TEST_F(ClientTest, TestMultipleMultiRowManualBatches) {
   ASSERT_EQ("{ int32:0, int32:0, string:\"hello world\", null }", rows[0]);
 }
 
+// Test that single row writes of concurrent sessions, coalesced into shared RPCs, are all applied
+// and each session gets its own callback.
+TEST_F(ClientTest, TestCoalescedWrites) {
+  FLAGS_client_write_linger_us = 20000;
+
+  constexpr int kNumSessions = 100;
+  std::vector<YBSessionPtr> sessions;
+  std::vector<Synchronizer> synchronizers(kNumSessions);
+  for (int i = 0; i != kNumSessions; ++i) {
+    sessions.push_back(CreateSession());
+    ASSERT_OK(ApplyInsertToSession(sessions.back().get(), client_table_, i, i, "coalesced"));
+  }
+  for (int i = 0; i != kNumSessions; ++i) {
+    sessions[i]->FlushAsync(synchronizers[i].AsStatusFunctor());
+  }
+  for (auto& synchronizer : synchronizers) {
+    ASSERT_OK(synchronizer.Wait());
+  }
+
+  ASSERT_EQ(kNumSessions, CountRowsFromClient(client_table_));
+}
+
+TEST_F(ClientTest, TestBulkWriter) {
+  constexpr int kNumRows = 5000;
+  constexpr int kRowsPerWrite = 100;
+
+  std::atomic<int> errors(0);
+  YBBulkWriter::Options options;
+  options.batch_size = 64;
+  options.max_in_flight_batches_per_tablet = 2;
+  YBBulkWriter writer(
+      client_.get(), client_table_.table(), options,
+      [&errors](const YBqlWriteOp& op, const Status& status) {
+        LOG(WARNING) << "Failed " << op.ToString() << ": " << status;
+        ++errors;
+      });
+
+  // Pre-encoded rows.
+  for (int i = 0; i < kNumRows / 2; i += kRowsPerWrite) {
+    std::vector<YBqlWriteOpPtr> ops;
+    for (int j = i; j != i + kRowsPerWrite; ++j) {
+      ops.push_back(BuildTestRow(client_table_, j));
+    }
+    ASSERT_OK(writer.Write(ops));
+  }
+
+  // Columnar rows.
+  std::vector<std::vector<QLValuePB>> columns(client_table_.schema().num_columns());
+  for (int i = kNumRows / 2; i != kNumRows; ++i) {
+    columns[0].emplace_back();
+    columns[0].back().set_int32_value(i);
+    columns[1].emplace_back();
+    columns[1].back().set_int32_value(i * 2);
+    columns[2].emplace_back();
+    columns[2].back().set_string_value(StringPrintf("hello %d", i));
+    columns[3].emplace_back();
+    columns[3].back().set_int32_value(i * 3);
+  }
+  ASSERT_OK(writer.WriteColumns(columns));
+  ASSERT_OK(writer.Flush());
+
+  ASSERT_EQ(0, errors.load());
+  ASSERT_EQ(kNumRows, writer.rows_written());
+  ASSERT_EQ(0, writer.rows_failed());
+  ASSERT_EQ(kNumRows, CountRowsFromClient(client_table_));
+
+  columns.pop_back();
+  auto status = writer.WriteColumns(columns);
+  ASSERT_TRUE(status.IsInvalidArgument()) << status;
+}
+
+TEST_F(ClientTest, ReadCache) {
+  constexpr int kKey = 1;
+
+  auto session = CreateSession();
+  ASSERT_OK(session->ApplyAndFlush(BuildTestRow(client_table_, kKey)));
+
+  auto read_value = [this, session](YBConsistencyLevel consistency_level) -> Result<int32_t> {
+    auto op = client_table_.NewReadOp();
+    auto* req = op->mutable_request();
+    QLAddInt32HashValue(req, kKey);
+    client_table_.AddColumns({client_table_.schema().columns()[1].name()}, req);
+    op->set_yb_consistency_level(consistency_level);
+    RETURN_NOT_OK(session->ApplyAndFlush(op));
+    if (op->response().status() != QLResponsePB::YQL_STATUS_OK) {
+      return STATUS_FORMAT(RuntimeError, "Read failed: $0", op->response().ShortDebugString());
+    }
+    auto rowblock = ql::RowsResult(op.get()).GetRowBlock();
+    // Row could be missing on a lagging follower.
+    return rowblock->row_count() == 0 ? -1 : rowblock->row(0).column(0).int32_value();
+  };
+
+  // Consistent prefix read could be served by a lagging follower, so wait for the written value
+  // with a staleness bound that does not allow reusing results.
+  client_table_->SetReadCacheStaleness(1ms);
+  ASSERT_OK(WaitFor([&read_value]() -> Result<bool> {
+    return VERIFY_RESULT(read_value(YBConsistencyLevel::CONSISTENT_PREFIX)) == kKey * 2;
+  }, 10s, "Read written value"));
+  client_table_->SetReadCacheStaleness(60s);
+
+  ASSERT_OK(session->ApplyAndFlush(UpdateTestRow(client_table_, kKey)));
+  ASSERT_EQ(kKey * 2 + 1, ASSERT_RESULT(read_value(YBConsistencyLevel::STRONG)));
+  // Consistent prefix read returns cached value, while it is not older than staleness bound.
+  ASSERT_EQ(kKey * 2, ASSERT_RESULT(read_value(YBConsistencyLevel::CONSISTENT_PREFIX)));
+  ASSERT_GT(client_->data_->read_cache_->bytes(), 0);
+
+  client_table_->SetReadCacheStaleness(1ms);
+  ASSERT_OK(WaitFor([&read_value]() -> Result<bool> {
+    return VERIFY_RESULT(read_value(YBConsistencyLevel::CONSISTENT_PREFIX)) == kKey * 2 + 1;
+  }, 10s, "Read updated value"));
+}
+
+// Measures CPU time spent by the calling thread to build, apply and flush a write operation,
+// i.e. the client side cost of an operation in the CQL proxy.
+TEST_F(ClientTest, WriteOpCpuCost) {
+  const int kBatches = AllowSlowTests() ? 1000 : 50;
+  constexpr int kOpsPerBatch = 100;
+
+  auto session = CreateSession();
+  Stopwatch stopwatch;
+  stopwatch.start();
+  for (int batch = 0; batch != kBatches; ++batch) {
+    for (int i = 0; i != kOpsPerBatch; ++i) {
+      ASSERT_OK(session->Apply(BuildTestRow(client_table_, batch * kOpsPerBatch + i)));
+    }
+    ASSERT_OK(session->Flush());
+  }
+  stopwatch.stop();
+
+  const auto times = stopwatch.elapsed();
+  const int num_ops = kBatches * kOpsPerBatch;
+  LOG(INFO) << "Ops: " << num_ops << ", " << times.ToString() << ", user CPU per op: "
+            << times.user_cpu_seconds() * 1e6 / num_ops << "us, system CPU per op: "
+            << times.system_cpu_seconds() * 1e6 / num_ops << "us";
+  ASSERT_EQ(num_ops, CountRowsFromClient(client_table_));
+}
+
 // Test a batch where one of the inserted rows succeeds and duplicates succeed too.
 TEST_F(ClientTest, TestBatchWithDuplicates) {
   auto session = CreateSession();
@@ -1654,6 +1795,69 @@ TEST_F(ClientTest, TestMasterLookupPermits) {
             client_->data_->meta_cache_->master_lookup_sem_.GetValue());
 }
 
+// Tests that locations of all tablets are cached while the table is opened, so lookups don't need
+// the master.
+TEST_F(ClientTest, TabletLocationsPrefetchedOnOpen) {
+  // Fetch locations one tablet per page.
+  FLAGS_client_table_locations_page_size = 1;
+
+  shared_ptr<YBClient> client;
+  ASSERT_OK(YBClientBuilder()
+                .add_master_server_addr(ToString(cluster_->mini_master()->bound_rpc_addr()))
+                .Build(&client));
+  TableHandle table;
+  ASSERT_OK(table.Open(kTableName, client.get()));
+  ASSERT_EQ(kNumTablets, table->GetPartitions().size());
+
+  FLAGS_master_inject_latency_on_tablet_lookups_ms = 10000;
+  const auto deadline = MonoTime::Now() + MonoDelta::FromSeconds(1);
+  for (const auto& partition : table->GetPartitions()) {
+    auto tablet = client->data_->meta_cache_->LookupTabletByKeyFuture(
+        table.get(), partition, deadline).get();
+    ASSERT_OK(tablet);
+    ASSERT_EQ(partition, (**tablet).partition().partition_key_start());
+  }
+}
+
+// Measures throughput of cached tablet lookups depending on the number of lookup threads.
+TEST_F(ClientTest, MetaCacheLookupThroughput) {
+  constexpr auto kDuration = 2s;
+  constexpr int kMaxThreads = 16;
+
+  auto& meta_cache = *client_->data_->meta_cache_;
+  const auto& partitions = client_table_->GetPartitions();
+  const auto deadline = MonoTime::Now() + MonoDelta::FromSeconds(30);
+  for (const auto& partition : partitions) {
+    ASSERT_OK(meta_cache.LookupTabletByKeyFuture(client_table_.get(), partition, deadline).get());
+  }
+
+  for (int num_threads = 1; num_threads <= kMaxThreads; num_threads *= 2) {
+    std::atomic<bool> stop(false);
+    std::atomic<uint64_t> lookups(0);
+    std::vector<std::thread> threads;
+    for (int i = 0; i != num_threads; ++i) {
+      threads.emplace_back([&, i] {
+        uint64_t thread_lookups = 0;
+        size_t idx = i;
+        while (!stop.load(std::memory_order_acquire)) {
+          meta_cache.LookupTabletByKey(
+              client_table_.get(), partitions[idx++ % partitions.size()], deadline,
+              [](const Result<internal::RemoteTabletPtr>& result) { CHECK_OK(result); });
+          ++thread_lookups;
+        }
+        lookups += thread_lookups;
+      });
+    }
+    std::this_thread::sleep_for(kDuration);
+    stop = true;
+    for (auto& thread : threads) {
+      thread.join();
+    }
+    LOG(INFO) << num_threads << " threads: "
+              << lookups.load() * 1000 / ToMilliseconds(kDuration) << " lookups/s";
+  }
+}
+
 // Define callback for deadlock simulation, as well as various helper methods.
 namespace {
 
@@ -46,12 +46,15 @@
 #include "yb/client/error-internal.h"
 #include "yb/client/error_collector.h"
 #include "yb/client/meta_cache.h"
+#include "yb/client/metadata_change_watcher.h"
+#include "yb/client/read_cache.h"
 #include "yb/client/schema-internal.h"
 #include "yb/client/session-internal.h"
 #include "yb/client/table-internal.h"
 #include "yb/client/table_alterer-internal.h"
 #include "yb/client/table_creator-internal.h"
 #include "yb/client/tablet_server-internal.h"
+#include "yb/client/write_coalescer.h"
 #include "yb/client/yb_op.h"
 #include "yb/common/common.pb.h"
 #include "yb/common/entity_ids.h"
@@ -135,6 +138,8 @@ using yb::master::RedisConfigSetRequestPB;
 using yb::master::RedisConfigSetResponsePB;
 using yb::master::RedisConfigGetRequestPB;
 using yb::master::RedisConfigGetResponsePB;
+using yb::master::WatchMetadataChangesRequestPB;
+using yb::master::WatchMetadataChangesResponsePB;
 using yb::rpc::Messenger;
 using yb::rpc::MessengerBuilder;
 using yb::rpc::RpcController;
@@ -168,7 +173,9 @@ namespace client {
 using internal::Batcher;
 using internal::ErrorCollector;
 using internal::MetaCache;
+using internal::ReadCache;
 using internal::RemoteTabletServer;
+using internal::WriteCoalescer;
 using ql::ObjectType;
 using std::shared_ptr;
 
@@ -421,6 +428,9 @@ Status YBClientBuilder::Build(shared_ptr<YBClient>* client) {
       "Could not locate the leader master");
 
   c->data_->meta_cache_.reset(new MetaCache(c.get()));
+  c->data_->write_coalescer_ = std::make_shared<WriteCoalescer>(
+      &c->data_->messenger_->scheduler());
+  c->data_->read_cache_ = std::make_unique<ReadCache>(c->data_->metric_entity_);
   c->data_->dns_resolver_.reset(new DnsResolver());
 
   // Init local host names used for locality decisions.
@@ -445,6 +455,9 @@ YBClient::YBClient() : data_(new YBClient::Data()) {
 }
 
 YBClient::~YBClient() {
+  if (data_->write_coalescer_) {
+    data_->write_coalescer_->Shutdown();
+  }
   if (data_->meta_cache_) {
     data_->meta_cache_->Shutdown();
   }
@@ -897,6 +910,30 @@ Status YBClient::GetPermissions(client::internal::PermissionsCache* permissions_
   return Status::OK();
 }
 
+Status YBClient::WatchMetadataChanges(const boost::optional<int64_t>& epoch,
+                                      uint64_t last_version,
+                                      MonoDelta max_wait,
+                                      WatchMetadataChangesResponsePB* response) {
+  WatchMetadataChangesRequestPB req;
+  if (epoch) {
+    req.set_epoch(*epoch);
+    req.set_last_version(last_version);
+  }
+  // The master should respond before the RPC times out, even if there are no changes.
+  req.set_max_wait_ms(std::max<int64_t>(
+      std::min(max_wait.ToMilliseconds(), default_rpc_timeout().ToMilliseconds() / 2), 0));
+
+  auto& resp = *response;
+  CALL_SYNC_LEADER_MASTER_RPC(req, resp, WatchMetadataChanges);
+
+  for (const auto& change : resp.changes()) {
+    if (change.type() == master::MetadataChangePB::TABLET_LEADER) {
+      data_->meta_cache_->UpdateTabletLeader(change.tablet_id(), change.leader_uuid());
+    }
+  }
+  return Status::OK();
+}
+
 CHECKED_STATUS YBClient::CreateUDType(const std::string& namespace_name,
                                       const std::string& type_name,
                                       const std::vector<std::string>& field_names,
@@ -1046,6 +1083,10 @@ const ClientId& YBClient::id() const {
   return data_->id_;
 }
 
+const CloudInfoPB& YBClient::cloud_info() const {
+  return data_->cloud_info_pb_;
+}
+
 std::pair<RetryableRequestId, RetryableRequestId> YBClient::NextRequestIdAndMinRunningRequestId(
     const TabletId& tablet_id) {
   std::lock_guard<simple_spinlock> lock(data_->tablet_requests_mutex_);
@@ -1191,6 +1232,50 @@ Result<bool> YBClient::TableExists(const YBTableName& table_name) {
   return false;
 }
 
+YBMetaDataCache::YBMetaDataCache(std::shared_ptr<YBClient> client,
+                                 bool create_roles_permissions_cache) : client_(client) {
+  if (create_roles_permissions_cache) {
+    permissions_cache_ = std::make_shared<client::internal::PermissionsCache>(client);
+  } else {
+    LOG(INFO) << "Creating a metadata cache without a permissions cache";
+  }
+  if (internal::MetadataChangeWatcher::Enabled()) {
+    metadata_change_watcher_ = std::make_unique<internal::MetadataChangeWatcher>(
+        client, [this](const master::WatchMetadataChangesResponsePB& resp) {
+          HandleMetadataChanges(resp);
+        });
+  }
+}
+
+YBMetaDataCache::~YBMetaDataCache() {
+}
+
+void YBMetaDataCache::HandleMetadataChanges(const master::WatchMetadataChangesResponsePB& resp) {
+  // Nothing is known about the changes missed, so everything cached could be stale.
+  bool permissions_changed = resp.truncated();
+  if (resp.truncated()) {
+    std::lock_guard<std::mutex> lock(cached_tables_mutex_);
+    cached_tables_by_name_.clear();
+    cached_tables_by_id_.clear();
+  }
+  for (const auto& change : resp.changes()) {
+    switch (change.type()) {
+      case master::MetadataChangePB::TABLE_SCHEMA: FALLTHROUGH_INTENDED;
+      case master::MetadataChangePB::TABLE_DELETED:
+        RemoveCachedTable(change.table_id());
+        break;
+      case master::MetadataChangePB::PERMISSIONS:
+        permissions_changed = true;
+        break;
+      default:
+        break;
+    }
+  }
+  if (permissions_changed && permissions_cache_) {
+    permissions_cache_->Refresh();
+  }
+}
+
 Status YBMetaDataCache::GetTable(const YBTableName& table_name,
                                  shared_ptr<YBTable>* table,
                                  bool* cache_used) {
@@ -1787,6 +1872,15 @@ const std::string& YBTable::FindPartitionStart(
   return data_->partitions_[idx];
 }
 
+void YBTable::SetReadCacheStaleness(MonoDelta staleness) {
+  data_->read_cache_staleness_us_.store(staleness.ToMicroseconds(), std::memory_order_release);
+}
+
+MonoDelta YBTable::read_cache_staleness() const {
+  return MonoDelta::FromMicroseconds(
+      data_->read_cache_staleness_us_.load(std::memory_order_acquire));
+}
+
 //--------------------------------------------------------------------------------------------------
 
 YBPgsqlWriteOp* YBTable::NewPgsqlWrite() {
@@ -114,6 +114,7 @@ class Batcher;
 class GetTableSchemaRpc;
 class LookupRpc;
 class MetaCache;
+class MetadataChangeWatcher;
 class RemoteTablet;
 class RemoteTabletServer;
 class AsyncRpc;
@@ -407,6 +408,14 @@ class YBClient : public std::enable_shared_from_this<YBClient> {
   // greater than permissions_cache->version().s
   CHECKED_STATUS GetPermissions(client::internal::PermissionsCache* permissions_cache);
 
+  // Waits for up to max_wait for the changes of cached metadata after last_version of epoch, see
+  // WatchMetadataChanges in master.proto. Tablet leaders cached by this client are updated from
+  // the changes received. Epoch is not set on the first call.
+  CHECKED_STATUS WatchMetadataChanges(const boost::optional<int64_t>& epoch,
+                                      uint64_t last_version,
+                                      MonoDelta max_wait,
+                                      master::WatchMetadataChangesResponsePB* resp);
+
   // (User-defined) type related methods.
 
   // Create a new (user-defined) type.
@@ -557,6 +566,9 @@ class YBClient : public std::enable_shared_from_this<YBClient> {
   // Id of this client instance.
   const ClientId& id() const;
 
+  // Placement of this client, set by YBClientBuilder::set_cloud_info_pb.
+  const CloudInfoPB& cloud_info() const;
+
   std::pair<RetryableRequestId, RetryableRequestId> NextRequestIdAndMinRunningRequestId(
       const TabletId& tablet_id);
   void RequestFinished(const TabletId& tablet_id, RetryableRequestId request_id);
@@ -603,13 +615,9 @@ class YBClient : public std::enable_shared_from_this<YBClient> {
 class YBMetaDataCache {
  public:
   YBMetaDataCache(std::shared_ptr<YBClient> client,
-                  bool create_roles_permissions_cache = false) : client_(client)  {
-    if (create_roles_permissions_cache) {
-      permissions_cache_ = std::make_shared<client::internal::PermissionsCache>(client);
-    } else {
-      LOG(INFO) << "Creating a metadata cache without a permissions cache";
-    }
-  }
+                  bool create_roles_permissions_cache = false);
+
+  ~YBMetaDataCache();
 
   // Opens the table with the given name or id. If the table has been opened before, returns the
   // previously opened table from cached_tables_. If the table has not been opened before
@@ -662,6 +670,8 @@ class YBMetaDataCache {
       const internal::CacheCheckMode check_mode =  internal::CacheCheckMode::RETRY);
 
  private:
+  // Drops the cached metadata made stale by the changes watched at the master.
+  void HandleMetadataChanges(const master::WatchMetadataChangesResponsePB& resp);
 
   std::shared_ptr<YBClient> client_;
 
@@ -687,6 +697,9 @@ class YBMetaDataCache {
                              boost::hash<std::pair<string, string>>> YBTypeMap;
   YBTypeMap cached_types_;
   std::mutex cached_types_mutex_;
+
+  // Declared last, so the watcher is stopped before the caches it updates are destroyed.
+  std::unique_ptr<internal::MetadataChangeWatcher> metadata_change_watcher_;
 };
 
 // Creates a new table with the desired options.
@@ -858,6 +871,13 @@ class YBTable : public std::enable_shared_from_this<YBTable> {
   const std::string& FindPartitionStart(
       const std::string& partition_key, size_t group_by = 1) const;
 
+  // Enables client side cache of consistent prefix reads of this table. A read is served without
+  // RPC by the result of the same read, while that result was read not earlier than staleness ago.
+  // Zero staleness disables the cache, that is the default.
+  void SetReadCacheStaleness(MonoDelta staleness);
+
+  MonoDelta read_cache_staleness() const;
+
   //------------------------------------------------------------------------------------------------
   // Postgres support
   // Create a new QL operation for this table.
@@ -64,6 +64,7 @@ typedef std::shared_ptr<YBOperation> YBOperationPtr;
 class TableHandle;
 class TransactionManager;
 class TransactionPool;
+class YBBulkWriter;
 class YBMetaDataCache;
 class YBSchema;
 class YBTableAlterer;
@@ -89,6 +90,9 @@ class RemoteTabletServer;
 class Batcher;
 typedef scoped_refptr<Batcher> BatcherPtr;
 
+class WriteCoalescer;
+class ReadCache;
+
 } // namespace internal
 
 typedef std::function<void(const Result<internal::RemoteTabletPtr>&)> LookupTabletCallback;
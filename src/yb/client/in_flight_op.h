@@ -26,6 +26,7 @@ class YBOperation;
 
 namespace internal {
 
+class Batcher;
 class RemoteTablet;
 
 YB_DEFINE_ENUM(InFlightOpState,
@@ -105,6 +106,10 @@ struct InFlightOp {
 
   std::string partition_key;
 
+  // The batcher that owns this operation. An RPC could contain operations of several batchers,
+  // when they are coalesced by WriteCoalescer.
+  Batcher* batcher = nullptr;
+
   // The tablet the operation is destined for.
   // This is only filled in after passing through the kLookingUpTablet state.
   scoped_refptr<RemoteTablet> tablet;
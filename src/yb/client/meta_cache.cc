@@ -48,6 +48,7 @@
 #include "yb/master/master.proxy.h"
 #include "yb/rpc/messenger.h"
 #include "yb/rpc/rpc.h"
+#include "yb/rpc/tcp_stream.h"
 #include "yb/tserver/tserver_service.proxy.h"
 #include "yb/util/flag_tags.h"
 #include "yb/util/net/dns_resolver.h"
@@ -106,6 +107,9 @@ const size_t kPartitionGroupSize = 64;
 const size_t kPartitionGroupSize = 4;
 #endif
 
+// Weight of the latest request in the latency average of a tablet server.
+const double kLatencyEwmaWeight = 0.2;
+
 } // namespace
 
 ////////////////////////////////////////////////////////////
@@ -147,7 +151,10 @@ Status RemoteTabletServer::InitProxy(YBClient* client) {
       client->data_->cloud_info_pb_));
   CHECK(!hostport.host().empty());
   ScopedDnsTracker dns_tracker(dns_resolve_histogram_.get());
-  proxy_.reset(new TabletServerServiceProxy(client->data_->proxy_cache_.get(), hostport));
+  auto protocol = UseRpcCompression(cloud_info_pb_, client->data_->cloud_info_pb_)
+      ? rpc::TcpStream::CompressedProtocol() : nullptr;
+  proxy_.reset(new TabletServerServiceProxy(
+      client->data_->proxy_cache_.get(), hostport, protocol));
 
   return Status::OK();
 }
@@ -195,6 +202,39 @@ string RemoteTabletServer::ToString() const {
   return ret;
 }
 
+void RemoteTabletServer::RequestStarted() {
+  outstanding_requests_.fetch_add(1, std::memory_order_acq_rel);
+}
+
+void RemoteTabletServer::RequestFinished(MonoDelta latency, bool success) {
+  outstanding_requests_.fetch_sub(1, std::memory_order_acq_rel);
+  if (!success) {
+    return;
+  }
+  std::lock_guard<simple_spinlock> l(lock_);
+  if (!latency_ewma_.Initialized()) {
+    latency_ewma_ = latency;
+  } else {
+    latency_ewma_ = MonoDelta::FromNanoseconds(
+        latency_ewma_.ToNanoseconds() * (1 - kLatencyEwmaWeight) +
+        latency.ToNanoseconds() * kLatencyEwmaWeight);
+  }
+}
+
+MonoDelta RemoteTabletServer::LatencyEwma() const {
+  std::lock_guard<simple_spinlock> l(lock_);
+  return latency_ewma_;
+}
+
+MonoDelta RemoteTabletServer::ExpectedLatency() const {
+  auto latency = LatencyEwma();
+  if (!latency.Initialized()) {
+    return latency;
+  }
+  return MonoDelta::FromNanoseconds(
+      latency.ToNanoseconds() * (1 + std::max<int64_t>(outstanding_requests(), 0)));
+}
+
 bool RemoteTabletServer::HasHostFrom(const std::unordered_set<std::string>& hosts) const {
   std::lock_guard<simple_spinlock> l(lock_);
   for (const auto& hp : private_rpc_hostports_) {
@@ -626,6 +666,8 @@ RemoteTabletPtr MetaCache::ProcessTabletLocations(
 
   {
     std::lock_guard<decltype(mutex_)> l(mutex_);
+    // Tables that got new tablets, so their partitions snapshot should be republished.
+    std::vector<std::pair<const TableId*, TableData*>> updated_tables;
     for (const TabletLocationsPB& loc : locations) {
       for (const std::string& table_id : loc.table_ids()) {
         auto& table_data = tables_[table_id];
@@ -655,6 +697,9 @@ RemoteTabletPtr MetaCache::ProcessTabletLocations(
 
           CHECK(tablets_by_id_.emplace(tablet_id, remote).second);
           CHECK(tablets_by_key.emplace(partition.partition_key_start(), remote).second);
+          if (updated_tables.empty() || updated_tables.back().second != &table_data) {
+            updated_tables.emplace_back(&table_id, &table_data);
+          }
         }
         remote->Refresh(ts_cache_, loc.replicas());
 
@@ -683,6 +728,14 @@ RemoteTabletPtr MetaCache::ProcessTabletLocations(
         }
       }
     }
+
+    // Publish after processing all locations, so the new tablets of a table are published at once.
+    std::sort(updated_tables.begin(), updated_tables.end());
+    updated_tables.erase(std::unique(updated_tables.begin(), updated_tables.end()),
+                         updated_tables.end());
+    for (const auto& table : updated_tables) {
+      PublishPartitionsUnlocked(*table.first, table.second);
+    }
   }
 
   for (const auto& callback_and_remote_tablet : to_notify) {
@@ -693,6 +746,28 @@ RemoteTabletPtr MetaCache::ProcessTabletLocations(
   return result;
 }
 
+void MetaCache::PublishPartitionsUnlocked(const TableId& table_id, TableData* table_data) {
+  auto partitions = std::make_shared<PartitionsSnapshot>(
+      table_data->tablets_by_partition.begin(), table_data->tablets_by_partition.end());
+  std::sort(partitions->begin(), partitions->end(), [](const auto& lhs, const auto& rhs) {
+    return lhs.first < rhs.first;
+  });
+  snapshots_.push_back(partitions);
+  auto* old_partitions = table_data->partitions.exchange(
+      partitions.get(), std::memory_order_acq_rel);
+  if (old_partitions) {
+    return;
+  }
+
+  // First snapshot of this table, so the table should be added to the tables snapshot.
+  auto* old_tables = tables_snapshot_.load(std::memory_order_acquire);
+  auto tables = old_tables ? std::make_shared<TablesSnapshot>(*old_tables)
+                           : std::make_shared<TablesSnapshot>();
+  tables->emplace(table_id, table_data);
+  snapshots_.push_back(tables);
+  tables_snapshot_.store(tables.get(), std::memory_order_release);
+}
+
 void MetaCache::LookupFailed(
     const YBTable* table, const std::string& partition_group_start, const Status& status) {
   VLOG(1) << "Lookup for table " << table->id() << " and partition "
@@ -762,13 +837,11 @@ void MetaCache::LookupFailed(
 class LookupByIdRpc : public LookupRpc {
  public:
   LookupByIdRpc(const scoped_refptr<MetaCache>& meta_cache,
-                LookupTabletCallback user_cb,
                 TabletId tablet_id,
                 const MonoTime& deadline,
                 const shared_ptr<Messenger>& messenger,
                 rpc::ProxyCache* proxy_cache)
       : LookupRpc(meta_cache, deadline, messenger, proxy_cache),
-        user_cb_(std::move(user_cb)),
         tablet_id_(std::move(tablet_id)) {}
 
   std::string ToString() const override {
@@ -790,19 +863,9 @@ class LookupByIdRpc : public LookupRpc {
   }
 
   void Notify(const Status& status, const RemoteTabletPtr& remote_tablet) override {
-    if (status.ok()) {
-      user_cb_(remote_tablet);
-    } else {
-      user_cb_(status);
-    }
+    meta_cache()->LookupByIdFinished(tablet_id_, status, remote_tablet);
   }
 
-
-  // User-specified callback to invoke when the lookup finishes.
-  //
-  // Always invoked, regardless of success or failure.
-  LookupTabletCallback user_cb_;
-
   // Tablet to lookup.
   TabletId tablet_id_;
 
@@ -858,7 +921,7 @@ class LookupByKeyRpc : public LookupRpc {
 
   void Notify(const Status& status, const RemoteTabletPtr& result) override {
     if (status.ok()) {
-      return; // This case is handled by LookupTabletByKeyFastPathUnlocked.
+      return; // This case is handled by LookupTabletByKeyFastPath.
     }
     meta_cache()->LookupFailed(table_.get(), partition_group_start_, status);
   }
@@ -876,17 +939,24 @@ class LookupByKeyRpc : public LookupRpc {
   GetTableLocationsResponsePB resp_;
 };
 
-RemoteTabletPtr MetaCache::LookupTabletByKeyFastPathUnlocked(const YBTable* table,
-                                                             const std::string& partition_key) {
-  auto it = tables_.find(table->id());
-  if (PREDICT_FALSE(it == tables_.end())) {
+RemoteTabletPtr MetaCache::LookupTabletByKeyFastPath(const YBTable* table,
+                                                     const std::string& partition_key) {
+  const auto* tables = tables_snapshot_.load(std::memory_order_acquire);
+  if (PREDICT_FALSE(!tables)) {
+    return nullptr;
+  }
+  auto it = tables->find(table->id());
+  if (PREDICT_FALSE(it == tables->end())) {
     // No cache available for this table.
     return nullptr;
   }
 
   DCHECK_EQ(partition_key, table->FindPartitionStart(partition_key));
-  auto tablet_it = it->second.tablets_by_partition.find(partition_key);
-  if (PREDICT_FALSE(tablet_it == it->second.tablets_by_partition.end())) {
+  const auto& partitions = *it->second->partitions.load(std::memory_order_acquire);
+  auto tablet_it = std::lower_bound(
+      partitions.begin(), partitions.end(), partition_key,
+      [](const auto& entry, const std::string& key) { return entry.first < key; });
+  if (PREDICT_FALSE(tablet_it == partitions.end() || tablet_it->first != partition_key)) {
     // No tablets with a start partition key lower than 'partition_key'.
     return nullptr;
   }
@@ -907,22 +977,16 @@ RemoteTabletPtr MetaCache::LookupTabletByKeyFastPathUnlocked(const YBTable* tabl
   return nullptr;
 }
 
-template <class Lock>
-bool MetaCache::FastLookupTabletByKeyUnlocked(
-    const YBTable* table,
-    const std::string& partition_start,
-    const LookupTabletCallback& callback,
-    Lock* lock) {
+RemoteTabletPtr MetaCache::FastLookupTabletByKey(
+    const YBTable* table, const std::string& partition_start) {
   // Fast path: lookup in the cache.
-  auto result = LookupTabletByKeyFastPathUnlocked(table, partition_start);
+  auto result = LookupTabletByKeyFastPath(table, partition_start);
   if (result && result->HasLeader()) {
-    lock->unlock();
     VLOG(3) << "Fast lookup: found tablet " << result->tablet_id();
-    callback(result);
-    return true;
+    return result;
   }
 
-  return false;
+  return nullptr;
 }
 
 void MetaCache::LookupTabletByKey(const YBTable* table,
@@ -932,18 +996,22 @@ void MetaCache::LookupTabletByKey(const YBTable* table,
   const auto& partition_start = table->FindPartitionStart(partition_key);
 
   rpc::Rpcs::Handle rpc;
-  {
-    boost::shared_lock<boost::shared_mutex> lock(mutex_);
-    if (FastLookupTabletByKeyUnlocked(table, partition_start, callback, &lock)) {
-      return;
-    }
+  auto result = FastLookupTabletByKey(table, partition_start);
+  if (result) {
+    callback(result);
+    return;
   }
 
   const std::string& partition_group_start =
       table->FindPartitionStart(partition_start, kPartitionGroupSize);
   {
     std::unique_lock<boost::shared_mutex> lock(mutex_);
-    if (FastLookupTabletByKeyUnlocked(table, partition_start, callback, &lock)) {
+    // Snapshots are published under mutex_, so this check could not miss tablets cached by
+    // a concurrent master response.
+    result = FastLookupTabletByKey(table, partition_start);
+    if (result) {
+      lock.unlock();
+      callback(result);
       return;
     }
 
@@ -984,9 +1052,73 @@ void MetaCache::LookupTabletById(const TabletId& tablet_id,
     }
   }
 
+  {
+    std::lock_guard<decltype(mutex_)> lock(mutex_);
+    auto& lookups = tablet_lookups_by_id_[tablet_id];
+    bool was_empty = lookups.empty();
+    lookups.push_back({std::move(callback), deadline});
+    if (!was_empty) {
+      // Lookup of this tablet is already in progress, join it instead of sending another RPC to
+      // the master.
+      return;
+    }
+  }
+
   rpc::StartRpc<LookupByIdRpc>(
-      this, std::move(callback), tablet_id, deadline, client_->data_->messenger_,
-      client_->data_->proxy_cache_.get());
+      this, tablet_id, deadline, client_->data_->messenger_, client_->data_->proxy_cache_.get());
+}
+
+void MetaCache::LookupByIdFinished(
+    const TabletId& tablet_id, const Status& status, const RemoteTabletPtr& remote_tablet) {
+  std::vector<LookupTabletCallback> to_notify;
+  MonoTime max_deadline;
+  {
+    std::lock_guard<decltype(mutex_)> lock(mutex_);
+    auto it = tablet_lookups_by_id_.find(tablet_id);
+    if (it == tablet_lookups_by_id_.end()) {
+      return;
+    }
+    auto& lookups = it->second;
+    if (!status.IsTimedOut()) {
+      for (auto& lookup : lookups) {
+        to_notify.push_back(std::move(lookup.callback));
+      }
+      lookups.clear();
+    } else {
+      // Lookups with later deadline should not fail because of the deadline of the first one.
+      auto now = MonoTime::Now();
+      auto w = lookups.begin();
+      for (auto i = lookups.begin(); i != lookups.end(); ++i) {
+        if (i->deadline <= now) {
+          to_notify.push_back(std::move(i->callback));
+        } else {
+          max_deadline.MakeAtLeast(i->deadline);
+          if (i != w) {
+            *w = std::move(*i);
+          }
+          ++w;
+        }
+      }
+      lookups.erase(w, lookups.end());
+    }
+    if (lookups.empty()) {
+      tablet_lookups_by_id_.erase(it);
+    }
+  }
+
+  for (const auto& callback : to_notify) {
+    if (status.ok()) {
+      callback(remote_tablet);
+    } else {
+      callback(status);
+    }
+  }
+
+  if (max_deadline) {
+    rpc::StartRpc<LookupByIdRpc>(
+        this, tablet_id, max_deadline, client_->data_->messenger_,
+        client_->data_->proxy_cache_.get());
+  }
 }
 
 void MetaCache::MarkTSFailed(RemoteTabletServer* ts,
@@ -1004,6 +1136,24 @@ void MetaCache::MarkTSFailed(RemoteTabletServer* ts,
   }
 }
 
+void MetaCache::UpdateTabletLeader(const TabletId& tablet_id, const std::string& leader_uuid) {
+  auto tablet = LookupTabletByIdFastPath(tablet_id);
+  if (!tablet) {
+    return;
+  }
+  RemoteTabletServer* ts = nullptr;
+  {
+    boost::shared_lock<decltype(mutex_)> lock(mutex_);
+    auto it = ts_cache_.find(leader_uuid);
+    if (it != ts_cache_.end()) {
+      ts = it->second.get();
+    }
+  }
+  if (!ts || !tablet->MarkTServerAsLeader(ts)) {
+    tablet->MarkStale();
+  }
+}
+
 bool MetaCache::AcquireMasterLookupPermit() {
   return master_lookup_sem_.TryAcquire();
 }
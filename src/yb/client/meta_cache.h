@@ -33,6 +33,7 @@
 #ifndef YB_CLIENT_META_CACHE_H
 #define YB_CLIENT_META_CACHE_H
 
+#include <atomic>
 #include <map>
 #include <string>
 #include <memory>
@@ -149,6 +150,23 @@ class RemoteTabletServer {
 
   bool HasCapability(CapabilityId capability) const;
 
+  // Tracks requests sent to this server, so that replicas could be selected by observed latency.
+  // Latency is only recorded for successful requests.
+  void RequestStarted();
+  void RequestFinished(MonoDelta latency, bool success);
+
+  // Exponentially weighted moving average of the latency of requests to this server, or an
+  // uninitialized MonoDelta if none has completed yet.
+  MonoDelta LatencyEwma() const;
+
+  int64_t outstanding_requests() const {
+    return outstanding_requests_.load(std::memory_order_acquire);
+  }
+
+  // Latency expected for a new request, taking requests already queued at the server into account.
+  // Uninitialized if the latency of the server is not known yet.
+  MonoDelta ExpectedLatency() const;
+
  private:
   mutable simple_spinlock lock_;
   const std::string uuid_;
@@ -160,6 +178,8 @@ class RemoteTabletServer {
   const tserver::LocalTabletServer* local_tserver_ = nullptr;
   scoped_refptr<Histogram> dns_resolve_histogram_;
   std::vector<CapabilityId> capabilities_;
+  MonoDelta latency_ewma_;
+  std::atomic<int64_t> outstanding_requests_{0};
 
   DISALLOW_COPY_AND_ASSIGN(RemoteTabletServer);
 };
@@ -358,6 +378,10 @@ class MetaCache : public RefCountedThreadSafe<MetaCache> {
   // not be returned in future cache lookups.
   void MarkTSFailed(RemoteTabletServer* ts, const Status& status);
 
+  // Updates the leader of the cached tablet, as reported by the master. The tablet is marked
+  // stale if the new leader is not among its known replicas.
+  void UpdateTabletLeader(const TabletId& tablet_id, const std::string& leader_uuid);
+
   // Acquire or release a permit to perform a (slow) master lookup.
   //
   // If acquisition fails, caller may still do the lookup, but is first
@@ -379,9 +403,9 @@ class MetaCache : public RefCountedThreadSafe<MetaCache> {
   FRIEND_TEST(client::ClientTest, TestMasterLookupPermits);
 
   // Lookup the given tablet by key, only consulting local information.
-  // Returns true and sets *remote_tablet if successful.
-  RemoteTabletPtr LookupTabletByKeyFastPathUnlocked(const YBTable* table,
-                                                    const std::string& partition_key);
+  // Does not require mutex_, since it uses only published snapshots.
+  RemoteTabletPtr LookupTabletByKeyFastPath(const YBTable* table,
+                                            const std::string& partition_key);
 
   RemoteTabletPtr LookupTabletByIdFastPath(const TabletId& tablet_id);
 
@@ -393,17 +417,18 @@ class MetaCache : public RefCountedThreadSafe<MetaCache> {
   // NOTE: Must be called with lock_ held.
   void UpdateTabletServerUnlocked(const master::TSInfoPB& pb);
 
+  // Notify callbacks of all lookups of the tablet that were waiting for the finished master RPC.
+  void LookupByIdFinished(
+      const TabletId& tablet_id, const Status& status, const RemoteTabletPtr& remote_tablet);
+
   // Notify appropriate callbacks that lookup of specified partition group of specified table
   // was failed because of specified status.
   void LookupFailed(
       const YBTable* table, const std::string& partition_group_start, const Status& status);
 
-  template <class Lock>
-  bool FastLookupTabletByKeyUnlocked(
-      const YBTable* table,
-      const std::string& partition_start,
-      const LookupTabletCallback& callback,
-      Lock* lock);
+  // Returns tablet for partition_start, if it is cached and has a leader.
+  RemoteTabletPtr FastLookupTabletByKey(
+      const YBTable* table, const std::string& partition_start);
 
   YBClient* client_;
 
@@ -437,18 +462,47 @@ class MetaCache : public RefCountedThreadSafe<MetaCache> {
   typedef std::string PartitionKey;
   typedef std::string PartitionGroupKey;
 
+  // Immutable copy of TableData::tablets_by_partition, sorted by partition key, so lookups
+  // could use binary search without any locks.
+  typedef std::vector<std::pair<PartitionKey, RemoteTabletPtr>> PartitionsSnapshot;
+
   struct TableData {
     std::unordered_map<PartitionKey, RemoteTabletPtr> tablets_by_partition;
     std::unordered_map<PartitionGroupKey, PartitionToLookupData> tablet_lookups_by_group;
+
+    // Latest snapshot of tablets_by_partition, readers access it without locking.
+    std::atomic<const PartitionsSnapshot*> partitions{nullptr};
   };
 
+  // Tables that have a published partitions snapshot.
+  typedef std::unordered_map<TableId, const TableData*> TablesSnapshot;
+
+  // Publishes new partitions snapshot of table_data, must be called with mutex_ held.
+  void PublishPartitionsUnlocked(const TableId& table_id, TableData* table_data);
+
   std::unordered_map<TableId, TableData> tables_;
 
+  // Snapshots are updated in RCU style: writers build a new snapshot under mutex_ and publish it
+  // with a single atomic store. Replaced snapshots could still be used by concurrent readers and
+  // there is no cheap way to know when they are done, so snapshots are kept until MetaCache is
+  // destroyed. Tablets are never removed from the cache, so a snapshot is replaced only when new
+  // tablets of a table are cached, and the number of retired snapshots stays small.
+  std::atomic<const TablesSnapshot*> tables_snapshot_{nullptr};
+
+  // Owns all published snapshots, including replaced ones. Protected by mutex_.
+  std::vector<std::shared_ptr<const void>> snapshots_;
+
   // Cache of tablets, keyed by tablet ID.
   //
   // Protected by lock_
   std::unordered_map<std::string, RemoteTabletPtr> tablets_by_id_;
 
+  // Lookups waiting for the master response, keyed by tablet ID. Concurrent lookups of the same
+  // tablet share a single master RPC.
+  //
+  // Protected by mutex_.
+  std::unordered_map<TabletId, std::vector<LookupData>> tablet_lookups_by_id_;
+
   // Prevents master lookup "storms" by delaying master lookups when all
   // permits have been acquired.
   Semaphore master_lookup_sem_;
@@ -0,0 +1,91 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/client/metadata_change_watcher.h"
+
+#include <gflags/gflags.h>
+
+#include "yb/client/client.h"
+#include "yb/util/flag_tags.h"
+
+DEFINE_bool(client_watch_metadata_changes, false,
+            "Whether metadata caches of the client watch the leader master for changes of tablet "
+            "leaders, table schemas and permissions, instead of only finding out about them on "
+            "failed requests and periodic refreshes.");
+TAG_FLAG(client_watch_metadata_changes, advanced);
+
+DEFINE_int32(client_metadata_watch_wait_ms, 10000,
+             "Time in milliseconds a watch of metadata changes waits at the master for a change.");
+TAG_FLAG(client_metadata_watch_wait_ms, advanced);
+TAG_FLAG(client_metadata_watch_wait_ms, runtime);
+
+DEFINE_int32(client_metadata_watch_retry_delay_ms, 1000,
+             "Delay in milliseconds before a failed watch of metadata changes is retried.");
+TAG_FLAG(client_metadata_watch_retry_delay_ms, advanced);
+TAG_FLAG(client_metadata_watch_retry_delay_ms, runtime);
+
+namespace yb {
+
+namespace client {
+
+namespace internal {
+
+MetadataChangeWatcher::MetadataChangeWatcher(std::shared_ptr<YBClient> client, Handler handler)
+    : client_(std::move(client)), handler_(std::move(handler)) {
+  pool_ = std::make_unique<rpc::IoThreadPool>("metadata_change_watcher", 1);
+  scheduler_ = std::make_unique<rpc::Scheduler>(&pool_->io_service());
+  Schedule(MonoDelta::kZero);
+}
+
+MetadataChangeWatcher::~MetadataChangeWatcher() {
+  scheduler_->Shutdown();
+  pool_->Shutdown();
+  pool_->Join();
+}
+
+bool MetadataChangeWatcher::Enabled() {
+  return FLAGS_client_watch_metadata_changes;
+}
+
+void MetadataChangeWatcher::Schedule(MonoDelta delay) {
+  scheduler_->Schedule([this](const Status& s) {
+    if (!s.ok()) {
+      LOG(INFO) << "Metadata change watcher scheduler was shutdown: " << s.ToString();
+      return;
+    }
+    Watch();
+  }, delay.ToSteadyDuration());
+}
+
+void MetadataChangeWatcher::Watch() {
+  master::WatchMetadataChangesResponsePB resp;
+  Status s = client_->WatchMetadataChanges(
+      epoch_, version_, MonoDelta::FromMilliseconds(FLAGS_client_metadata_watch_wait_ms), &resp);
+  if (!s.ok()) {
+    YB_LOG_EVERY_N_SECS(WARNING, 10) << "Unable to watch metadata changes: " << s.ToString();
+    Schedule(MonoDelta::FromMilliseconds(FLAGS_client_metadata_watch_retry_delay_ms));
+    return;
+  }
+
+  // The first response only tells the current version, there is nothing to catch up with yet.
+  if (epoch_ && (resp.truncated() || resp.changes_size() != 0)) {
+    handler_(resp);
+  }
+  epoch_ = resp.epoch();
+  version_ = resp.version();
+  Schedule(MonoDelta::kZero);
+}
+
+} // namespace internal
+} // namespace client
+} // namespace yb
@@ -0,0 +1,73 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#ifndef YB_CLIENT_METADATA_CHANGE_WATCHER_H
+#define YB_CLIENT_METADATA_CHANGE_WATCHER_H
+
+#include <functional>
+#include <memory>
+
+#include <boost/optional.hpp>
+
+#include "yb/master/master.pb.h"
+#include "yb/rpc/io_thread_pool.h"
+#include "yb/rpc/scheduler.h"
+#include "yb/util/monotime.h"
+
+namespace yb {
+
+namespace client {
+
+class YBClient;
+
+namespace internal {
+
+// Long polls the leader master for changes of the cached metadata, so caches are updated soon
+// after a change instead of on the first request that fails because of it. Every response that
+// could make cached metadata stale is passed to the handler, which is invoked on the thread of the
+// watcher.
+//
+// The watcher is only a hint: caches still handle stale metadata as before, since changes could be
+// missed, e.g. when the leader master changes.
+class MetadataChangeWatcher {
+ public:
+  typedef std::function<void(const master::WatchMetadataChangesResponsePB&)> Handler;
+
+  MetadataChangeWatcher(std::shared_ptr<YBClient> client, Handler handler);
+
+  ~MetadataChangeWatcher();
+
+  // Whether metadata caches should watch the changes.
+  static bool Enabled();
+
+ private:
+  void Schedule(MonoDelta delay);
+
+  void Watch();
+
+  std::shared_ptr<YBClient> client_;
+  Handler handler_;
+
+  // Epoch and version of the last change received, epoch is not set until the first response.
+  boost::optional<int64_t> epoch_;
+  uint64_t version_ = 0;
+
+  std::unique_ptr<rpc::IoThreadPool> pool_;
+  std::unique_ptr<rpc::Scheduler> scheduler_;
+};
+
+} // namespace internal
+} // namespace client
+} // namespace yb
+
+#endif // YB_CLIENT_METADATA_CHANGE_WATCHER_H
@@ -106,6 +106,12 @@ void PermissionsCache::ScheduleGetPermissionsFromMaster(bool now) {
   }, std::chrono::milliseconds(now ? 0 : FLAGS_update_permissions_cache_msecs));
 }
 
+void PermissionsCache::Refresh() {
+  if (pool_) {
+    ScheduleGetPermissionsFromMaster(true);
+  }
+}
+
 void PermissionsCache::UpdateRolesPermissions(const GetPermissionsResponsePB& resp) {
   auto new_roles_permissions_map = std::make_shared<RolesPermissionsMap>();
 
@@ -106,6 +106,10 @@ class PermissionsCache {
                                       const RoleName &role_name,
                                       const PermissionType &permission);
 
+  // Schedules an update of the cache right away, e.g. when the permissions are known to have
+  // changed. Does nothing if the cache is not updated automatically.
+  void Refresh();
+
  private:
   void ScheduleGetPermissionsFromMaster(bool now);
 
@@ -407,6 +407,46 @@ TEST_F(QLTransactionTest, Heartbeat) {
   CheckNoRunningTransactions();
 }
 
+TEST_F(QLTransactionTest, SingleShardCommit) {
+  DisableApplyingIntents();
+
+  auto txn = CreateTransaction();
+  txn->EnableSingleShardCommit();
+  ASSERT_OK(WriteRow(CreateSession(txn), 1 /* key */, 2 /* value */));
+  // Row was written by a single non-transactional write, so it is visible before commit.
+  ASSERT_EQ(0, CountIntents());
+  ASSERT_OK(txn->CommitFuture().get());
+  ASSERT_EQ(2, ASSERT_RESULT(SelectRow(CreateSession(), 1 /* key */)));
+
+  // Writes to multiple tablets fall back to regular transaction.
+  txn = CreateTransaction();
+  txn->EnableSingleShardCommit();
+  ASSERT_NO_FATALS(WriteRows(CreateSession(txn)));
+  ASSERT_GT(CountIntents(), 0);
+  ASSERT_OK(txn->CommitFuture().get());
+  ASSERT_NO_FATALS(VerifyData());
+}
+
+// Commit requested while writes of the transaction are being flushed should be sent after them.
+TEST_F(QLTransactionTest, CommitWithFlush) {
+  constexpr int kNumRows = 10;
+
+  auto txn = CreateTransaction();
+  auto session = CreateSession(txn);
+  for (int key = 0; key != kNumRows; ++key) {
+    ASSERT_OK(WriteRow(session, key, key * 2, WriteOpType::INSERT, Flush::kFalse));
+  }
+  auto flush_future = session->FlushFuture();
+  ASSERT_OK(txn->CommitFuture().get());
+  ASSERT_OK(flush_future.get());
+
+  session = CreateSession();
+  for (int key = 0; key != kNumRows; ++key) {
+    ASSERT_EQ(key * 2, ASSERT_RESULT(SelectRow(session, key)));
+  }
+  CheckNoRunningTransactions();
+}
+
 TEST_F(QLTransactionTest, Expire) {
   SetDisableHeartbeatInTests(true);
   auto txn = CreateTransaction();
@@ -1021,29 +1061,31 @@ struct TransactionState {
     ASSERT_EQ(status_future.wait_for(NonTsanVsTsan(3s, 10s)), std::future_status::ready);
     auto resp = status_future.get();
     ASSERT_OK(resp);
+    ASSERT_EQ(1, resp->status().size());
+    ASSERT_EQ(1, resp->status_hybrid_time().size());
 
-    if (resp->status() == TransactionStatus::ABORTED) {
+    if (resp->status(0) == TransactionStatus::ABORTED) {
       ASSERT_TRUE(commit_future.valid());
       transaction = nullptr;
       return;
     }
 
-    auto new_time = HybridTime(resp->status_hybrid_time());
+    auto new_time = HybridTime(resp->status_hybrid_time(0));
     if (last_status == TransactionStatus::PENDING) {
-      if (resp->status() == TransactionStatus::PENDING) {
+      if (resp->status(0) == TransactionStatus::PENDING) {
         ASSERT_GE(new_time, status_time);
       } else {
-        ASSERT_EQ(TransactionStatus::COMMITTED, resp->status());
+        ASSERT_EQ(TransactionStatus::COMMITTED, resp->status(0));
         ASSERT_GT(new_time, status_time);
       }
     } else {
       ASSERT_EQ(last_status, TransactionStatus::COMMITTED);
-      ASSERT_EQ(resp->status(), TransactionStatus::COMMITTED)
-          << "Bad transaction status: " << TransactionStatus_Name(resp->status());
+      ASSERT_EQ(resp->status(0), TransactionStatus::COMMITTED)
+          << "Bad transaction status: " << TransactionStatus_Name(resp->status(0));
       ASSERT_EQ(status_time, new_time);
     }
     status_time = new_time;
-    last_status = resp->status();
+    last_status = resp->status(0);
   }
 };
 
@@ -1105,7 +1147,7 @@ TEST_F(QLTransactionTest, StatusEvolution) {
       }
       tserver::GetTransactionStatusRequestPB req;
       req.set_tablet_id(state.metadata.status_tablet);
-      req.set_transaction_id(state.metadata.transaction_id.data,
+      req.add_transaction_id(state.metadata.transaction_id.data,
                              state.metadata.transaction_id.size());
       state.status_future = rpc::WrapRpcFuture<tserver::GetTransactionStatusResponsePB>(
           GetTransactionStatus, &rpcs)(
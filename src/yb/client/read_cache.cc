@@ -0,0 +1,151 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/client/read_cache.h"
+
+#include "yb/client/client.h"
+#include "yb/client/yb_op.h"
+
+#include "yb/gutil/walltime.h"
+
+#include "yb/util/flag_tags.h"
+#include "yb/util/size_literals.h"
+
+using namespace yb::size_literals;
+
+DEFINE_int64(client_read_cache_max_bytes, 64_MB,
+             "Max total size of the results of consistent prefix reads cached by the client.");
+TAG_FLAG(client_read_cache_max_bytes, runtime);
+TAG_FLAG(client_read_cache_max_bytes, advanced);
+
+METRIC_DEFINE_counter(server, yb_client_read_cache_hits,
+                      "Client read cache hits", yb::MetricUnit::kRequests,
+                      "Number of consistent prefix reads served from the client read cache.");
+
+METRIC_DEFINE_counter(server, yb_client_read_cache_misses,
+                      "Client read cache misses", yb::MetricUnit::kRequests,
+                      "Number of cacheable consistent prefix reads sent to the tablet servers.");
+
+namespace yb {
+namespace client {
+namespace internal {
+
+ReadCache::ReadCache(const scoped_refptr<MetricEntity>& metric_entity) {
+  if (metric_entity) {
+    hits_ = METRIC_yb_client_read_cache_hits.Instantiate(metric_entity);
+    misses_ = METRIC_yb_client_read_cache_misses.Instantiate(metric_entity);
+  }
+}
+
+ReadCache::~ReadCache() {
+}
+
+bool ReadCache::MakeKey(const YBqlReadOp& op, std::string* key) {
+  if (op.yb_consistency_level() != YBConsistencyLevel::CONSISTENT_PREFIX ||
+      !op.table()->read_cache_staleness()) {
+    return false;
+  }
+
+  // Request and query ids are unique for each op, so they should not be part of the key.
+  QLReadRequestPB request(op.request());
+  request.clear_request_id();
+  request.clear_query_id();
+  *key = op.table()->id();
+  return request.AppendToString(key);
+}
+
+bool ReadCache::Lookup(YBqlReadOp* op) {
+  std::string key;
+  if (!MakeKey(*op, &key)) {
+    return false;
+  }
+
+  const auto now_us = GetCurrentTimeMicros();
+  const auto staleness_us = op->table()->read_cache_staleness().ToMicroseconds();
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = map_.find(key);
+    if (it != map_.end()) {
+      auto entry = it->second;
+      if (now_us - static_cast<int64_t>(entry->read_time.read.GetPhysicalValueMicros()) <=
+              staleness_us) {
+        lru_.splice(lru_.begin(), lru_, entry);
+        *op->mutable_response() = entry->response;
+        *op->mutable_rows_data() = entry->rows_data;
+        op->SetReadTime(entry->read_time);
+        if (hits_) {
+          hits_->Increment();
+        }
+        return true;
+      }
+      EraseUnlocked(entry);
+    }
+  }
+
+  if (misses_) {
+    misses_->Increment();
+  }
+  return false;
+}
+
+void ReadCache::Insert(const YBqlReadOp& op, const ReadHybridTime& read_time) {
+  if (op.response().status() != QLResponsePB::YQL_STATUS_OK) {
+    return;
+  }
+  std::string key;
+  if (!MakeKey(op, &key)) {
+    return;
+  }
+
+  const size_t bytes = sizeof(Entry) + 2 * key.size() + op.response().SpaceUsed() +
+                       op.rows_data().size();
+  const auto max_bytes = static_cast<size_t>(
+      std::max<int64_t>(FLAGS_client_read_cache_max_bytes, 0));
+  if (bytes > max_bytes) {
+    return;
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = map_.find(key);
+  if (it != map_.end()) {
+    // Keep the newest result, reads of the same key could finish out of order.
+    if (it->second->read_time.read >= read_time.read) {
+      return;
+    }
+    EraseUnlocked(it->second);
+  }
+
+  it = map_.emplace(std::move(key), lru_.end()).first;
+  lru_.push_front(Entry{&it->first, op.response(), op.rows_data(), read_time, bytes});
+  it->second = lru_.begin();
+  bytes_ += bytes;
+
+  while (bytes_ > max_bytes) {
+    EraseUnlocked(std::prev(lru_.end()));
+  }
+}
+
+size_t ReadCache::bytes() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return bytes_;
+}
+
+void ReadCache::EraseUnlocked(Entries::iterator it) {
+  bytes_ -= it->bytes;
+  map_.erase(*it->key);
+  lru_.erase(it);
+}
+
+} // namespace internal
+} // namespace client
+} // namespace yb
@@ -0,0 +1,89 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#ifndef YB_CLIENT_READ_CACHE_H
+#define YB_CLIENT_READ_CACHE_H
+
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include "yb/client/client_fwd.h"
+
+#include "yb/common/ql_protocol.pb.h"
+#include "yb/common/read_hybrid_time.h"
+
+#include "yb/gutil/ref_counted.h"
+
+#include "yb/util/metrics.h"
+
+namespace yb {
+namespace client {
+namespace internal {
+
+// Caches results of consistent prefix QL reads of the tables that enabled it, see
+// YBTable::SetReadCacheStaleness.
+//
+// Entries are keyed by table and read request, and tagged with the hybrid time the read was done
+// at. An entry serves the same read while its read time is not older than the staleness bound of
+// the table. Least recently used entries are evicted when the total size of the cache exceeds
+// client_read_cache_max_bytes.
+//
+// This class is thread safe.
+class ReadCache {
+ public:
+  explicit ReadCache(const scoped_refptr<MetricEntity>& metric_entity);
+  ~ReadCache();
+
+  // Fills response and rows data of op from the cache. Returns false when op is not cacheable or
+  // there is no fresh enough entry for it.
+  bool Lookup(YBqlReadOp* op);
+
+  // Remembers result of op, that was read at read_time, if op is cacheable.
+  void Insert(const YBqlReadOp& op, const ReadHybridTime& read_time);
+
+  size_t bytes() const;
+
+ private:
+  struct Entry {
+    // Points to the key of entry in map_.
+    const std::string* key;
+    QLResponsePB response;
+    std::string rows_data;
+    ReadHybridTime read_time;
+    size_t bytes;
+  };
+
+  typedef std::list<Entry> Entries;
+
+  // Sets key of cacheable op and returns true, returns false when op is not cacheable.
+  static bool MakeKey(const YBqlReadOp& op, std::string* key);
+
+  void EraseUnlocked(Entries::iterator it);
+
+  scoped_refptr<Counter> hits_;
+  scoped_refptr<Counter> misses_;
+
+  mutable std::mutex mutex_;
+  // Most recently used entries first.
+  Entries lru_;
+  std::unordered_map<std::string, Entries::iterator> map_;
+  size_t bytes_ = 0;
+};
+
+} // namespace internal
+} // namespace client
+} // namespace yb
+
+#endif // YB_CLIENT_READ_CACHE_H
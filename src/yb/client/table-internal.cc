@@ -35,6 +35,7 @@
 #include <string>
 
 #include "yb/client/client-internal.h"
+#include "yb/client/meta_cache.h"
 #include "yb/common/wire_protocol.h"
 #include "yb/gutil/strings/substitute.h"
 #include "yb/gutil/sysinfo.h"
@@ -42,8 +43,19 @@
 #include "yb/master/master.proxy.h"
 #include "yb/rpc/rpc_controller.h"
 #include "yb/util/backoff_waiter.h"
+#include "yb/util/flag_tags.h"
 #include "yb/util/monotime.h"
 
+DEFINE_bool(client_prefetch_tablet_locations, true,
+            "Whether the tablet locations received while opening a table should be put into the "
+            "meta cache, so the first operations on the table don't have to look them up.");
+TAG_FLAG(client_prefetch_tablet_locations, runtime);
+
+DEFINE_int32(client_table_locations_page_size, 1000,
+             "Max number of tablet locations requested from the master by a single RPC while "
+             "opening a table.");
+TAG_FLAG(client_table_locations_page_size, advanced);
+
 namespace yb {
 
 using master::GetTableLocationsRequestPB;
@@ -91,7 +103,7 @@ YBTable::Data::~Data() {
 Status YBTable::Data::Open() {
   // TODO: fetch the schema from the master here once catalog is available.
   GetTableLocationsRequestPB req;
-  req.set_max_returned_locations(std::numeric_limits<int32_t>::max());
+  req.set_max_returned_locations(std::max(FLAGS_client_table_locations_page_size, 1));
   GetTableLocationsResponsePB resp;
 
   MonoTime deadline = MonoTime::Now();
@@ -168,14 +180,22 @@ Status YBTable::Data::Open() {
     if (!s.ok()) {
       YB_LOG_EVERY_N_SECS(WARNING, 10) << "Error getting table locations: " << s << ", retrying.";
     } else if (resp.tablet_locations_size() > 0) {
-      DCHECK(partitions_.empty());
-      partitions_.clear();
-      partitions_.reserve(resp.tablet_locations().size());
       for (const auto& tablet_location : resp.tablet_locations()) {
         partitions_.push_back(tablet_location.partition().partition_key_start());
       }
-      std::sort(partitions_.begin(), partitions_.end());
-      break;
+      if (FLAGS_client_prefetch_tablet_locations) {
+        client_->data_->meta_cache_->ProcessTabletLocations(
+            resp.tablet_locations(), nullptr /* partition_group_start */);
+      }
+      // Locations are returned in partition order, so continue from the end of the last one.
+      const auto& last_partition = resp.tablet_locations().rbegin()->partition();
+      if (resp.tablet_locations_size() < req.max_returned_locations() ||
+          last_partition.partition_key_end().empty()) {
+        std::sort(partitions_.begin(), partitions_.end());
+        break;
+      }
+      req.set_partition_key_start(last_partition.partition_key_end());
+      continue;
     }
 
     if (!waiter.Wait()) {
@@ -190,7 +210,7 @@ Status YBTable::Data::Open() {
     strings::Substitute("Invalid table type for table '$0'", info_.table_name.ToString()));
 
   VLOG(1) << "Open Table " << info_.table_name.ToString() << ", found "
-          << resp.tablet_locations_size() << " tablets";
+          << partitions_.size() << " tablets";
   return Status::OK();
 }
 
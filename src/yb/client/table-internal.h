@@ -32,6 +32,7 @@
 #ifndef YB_CLIENT_TABLE_INTERNAL_H_
 #define YB_CLIENT_TABLE_INTERNAL_H_
 
+#include <atomic>
 #include <string>
 
 #include "yb/common/index.h"
@@ -62,6 +63,7 @@ class YBTable::Data {
   YBTableType table_type_;
   const Info info_;
   std::vector<std::string> partitions_;
+  std::atomic<int64_t> read_cache_staleness_us_{0};
 
  private:
   DISALLOW_COPY_AND_ASSIGN(Data);
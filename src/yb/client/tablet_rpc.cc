@@ -199,9 +199,35 @@ void TabletInvoker::Execute(const std::string& tablet_id, bool leader_only) {
   VLOG(2) << "Tablet " << tablet_id_ << ": Writing batch to replica "
           << current_ts_->ToString();
 
+  rpc_ts_ = current_ts_;
+  rpc_start_time_ = MonoTime::Now();
+  rpc_ts_->RequestStarted();
   rpc_->SendRpcToTserver();
 }
 
+bool TabletInvoker::FollowLeaderHint(const tserver::TabletServerErrorPB* error) {
+  if (!tablet_ || ErrorCode(error) != tserver::TabletServerErrorPB::NOT_THE_LEADER ||
+      error->leader_uuid().empty()) {
+    return false;
+  }
+
+  std::vector<RemoteTabletServer*> replicas;
+  tablet_->GetRemoteTabletServers(&replicas);
+  for (auto* ts : replicas) {
+    if (ts->permanent_uuid() == error->leader_uuid()) {
+      if (ContainsKey(followers_, ts) || !tablet_->MarkTServerAsLeader(ts)) {
+        return false;
+      }
+      VLOG(1) << "Tablet " << tablet_id_ << ": " << current_ts_->ToString()
+              << " is not the leader, following hint to " << ts->ToString();
+      return true;
+    }
+  }
+
+  // Hinted leader is not among known replicas, i.e. the config changed, so ask the master.
+  return false;
+}
+
 void TabletInvoker::FailToNewReplica(const Status& reason,
                                      const tserver::TabletServerErrorPB* error_code) {
   VLOG(1) << "Failing " << command_->ToString() << " to a new replica: " << reason.ToString();
@@ -224,6 +250,12 @@ bool TabletInvoker::Done(Status* status) {
   TRACE_TO(trace_, "Done($0)", status->ToString(false));
   ADOPT_TRACE(trace_);
 
+  if (rpc_ts_ != nullptr) {
+    rpc_ts_->RequestFinished(MonoTime::Now().GetDeltaSince(rpc_start_time_),
+                             status->ok() && rpc_->response_error() == nullptr);
+    rpc_ts_ = nullptr;
+  }
+
   if (status->IsAborted() || retrier_->finished()) {
     return true;
   }
@@ -270,6 +302,13 @@ bool TabletInvoker::Done(Status* status) {
     // Else the leader became a follower and must be reset on retry.
     if (!leader_is_not_ready) {
       followers_.insert(current_ts_);
+      if (FollowLeaderHint(rpc_->response_error())) {
+        auto retry_status = retrier_->DelayedRetry(command_, *status);
+        if (!retry_status.ok()) {
+          command_->Finished(retry_status);
+        }
+        return false;
+      }
     }
 
     if (PREDICT_FALSE(FLAGS_assert_local_op) && current_ts_->IsLocal() &&
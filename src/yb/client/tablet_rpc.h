@@ -89,6 +89,11 @@ class TabletInvoker {
   // is not the leader, a MOVED response will be returned.
   void SelectLocalTabletServer();
 
+  // Marks the leader reported by the tablet server that rejected the request as the leader of
+  // the tablet. Returns true if the hint could be used, so the request could be retried right
+  // away without a master lookup.
+  bool FollowLeaderHint(const tserver::TabletServerErrorPB* error);
+
   // Marks all replicas on current_ts_ as failed and retries the write on a
   // new replica.
   void FailToNewReplica(const Status& reason,
@@ -139,6 +144,10 @@ class TabletInvoker {
   // RemoteTabletServer is taken from YBClient cache, so it is guaranteed that those objects are
   // alive while YBClient is alive. Because we don't delete them, but only add and update.
   RemoteTabletServer* current_ts_ = nullptr;
+
+  // The TS the RPC in flight was sent to, and when it was sent. Used to track its latency.
+  RemoteTabletServer* rpc_ts_ = nullptr;
+  MonoTime rpc_start_time_;
 };
 
 CHECKED_STATUS ErrorStatus(const tserver::TabletServerErrorPB* error);
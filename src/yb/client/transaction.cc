@@ -32,6 +32,7 @@
 #include "yb/rpc/rpc.h"
 #include "yb/rpc/scheduler.h"
 
+#include "yb/util/flag_tags.h"
 #include "yb/util/logging.h"
 #include "yb/util/random_util.h"
 #include "yb/util/result.h"
@@ -44,6 +45,11 @@ DEFINE_uint64(transaction_heartbeat_usec, 500000, "Interval of transaction heart
 DEFINE_bool(transaction_disable_heartbeat_in_tests, false, "Disable heartbeat during test.");
 DEFINE_bool(transaction_disable_proactive_cleanup_in_tests, false,
             "Disable cleanup of intents in abort path.");
+DEFINE_bool(transaction_single_shard_commit, true,
+            "Write transactions, whose writes are flushed together and go to a single tablet, "
+            "as one non-transactional write request, when the caller allows it.");
+TAG_FLAG(transaction_single_shard_commit, advanced);
+TAG_FLAG(transaction_single_shard_commit, runtime);
 DECLARE_uint64(max_clock_skew_usec);
 
 namespace yb {
@@ -134,6 +140,7 @@ class YBTransaction::Impl final {
   CHECKED_STATUS FillRestartedTransaction(Impl* other) {
     VLOG_WITH_PREFIX(1) << "Setup restart to " << other->ToString();
     auto transaction = transaction_->shared_from_this();
+    bool single_shard;
     {
       std::lock_guard<std::mutex> lock(mutex_);
       auto state = state_.load(std::memory_order_acquire);
@@ -147,6 +154,7 @@ class YBTransaction::Impl final {
             IllegalState, "Restart of transaction that does not require restart: $0",
             metadata_.transaction_id);
       }
+      single_shard = single_shard_;
       other->read_point_ = std::move(read_point_);
       other->read_point_.Restart();
       other->metadata_.isolation = metadata_.isolation;
@@ -157,11 +165,19 @@ class YBTransaction::Impl final {
       }
       state_.store(TransactionState::kAborted, std::memory_order_release);
     }
-    DoAbort(Status::OK(), transaction);
+    if (!single_shard) {
+      DoAbort(Status::OK(), transaction);
+    }
 
     return Status::OK();
   }
 
+  void EnableSingleShardCommit() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    single_shard_allowed_ = !child_ && tablets_.empty() &&
+                            GetAtomicFlag(&FLAGS_transaction_single_shard_commit);
+  }
+
   bool Prepare(const std::unordered_set<internal::InFlightOpPtr>& ops,
                ForceConsistentRead force_consistent_read,
                Waiter waiter,
@@ -172,6 +188,19 @@ class YBTransaction::Impl final {
     bool has_tablets_without_metadata = false;
     {
       std::unique_lock<std::mutex> lock(mutex_);
+      if (single_shard_allowed_) {
+        single_shard_allowed_ = false;
+        if (CanWriteSingleShardUnlocked(ops)) {
+          // Ops are sent without transaction metadata, so they are written as a single
+          // non-transactional write request.
+          single_shard_ = true;
+          VLOG_WITH_PREFIX(2) << "Prepare, single shard";
+          return true;
+        }
+      } else if (single_shard_) {
+        LOG_WITH_PREFIX(DFATAL) << "Prepare after single shard write";
+        single_shard_ = false;
+      }
       if (!ready_) {
         if (waiter) {
           waiters_.push_back(std::move(waiter));
@@ -250,8 +279,8 @@ class YBTransaction::Impl final {
         << "Flushed: " << yb::ToString(ops) << ", used_read_time: " << used_read_time
         << ", status: " << status;
 
+    std::unique_lock<std::mutex> lock(mutex_);
     if (status.ok()) {
-      std::lock_guard<std::mutex> lock(mutex_);
       if (used_read_time && metadata_.isolation == IsolationLevel::SNAPSHOT_ISOLATION) {
         LOG_IF_WITH_PREFIX(DFATAL, read_point_.GetReadTime())
             << "Read time already picked (" << read_point_.GetReadTime()
@@ -271,10 +300,45 @@ class YBTransaction::Impl final {
         }
       }
     } else if (status.IsTryAgain()) {
-      SetError(status);
+      SetError(status, &lock);
     }
     // We should not handle other errors, because it is just notification that batch was failed.
     // And they are handled during processing of that batch.
+    // But commit could be requested before the caller sees results of running flushes, so the
+    // first failure is remembered until all running flushes finish.
+    if (write_error_.ok()) {
+      if (!status.ok()) {
+        write_error_ = status;
+      } else {
+        for (const auto& op : ops) {
+          if (!op->yb_op->read_only() && !op->yb_op->succeeded()) {
+            write_error_ = STATUS_FORMAT(Aborted, "Write failed: $0", op->yb_op->ToString());
+            break;
+          }
+        }
+      }
+    }
+  }
+
+  void FlushStarted() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    ++running_flushes_;
+  }
+
+  void FlushFinished() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    DCHECK_GT(running_flushes_, 0);
+    if (--running_flushes_ != 0) {
+      return;
+    }
+    if (!commit_waits_for_flush_) {
+      // The caller sees results of all flushes before it requests the commit.
+      write_error_ = Status::OK();
+      return;
+    }
+    commit_waits_for_flush_ = false;
+    VLOG_WITH_PREFIX(1) << "All flushes finished, committing";
+    StartCommit(&lock, transaction_->shared_from_this());
   }
 
   void Commit(CommitCallback callback) {
@@ -290,21 +354,21 @@ class YBTransaction::Impl final {
         callback(STATUS(IllegalState, "Commit of child transaction is not allowed"));
         return;
       }
-      if (IsRestartRequired()) {
-        callback(STATUS(
-            IllegalState, "Commit of transaction that requires restart is not allowed"));
+      if (commit_callback_) {
+        lock.unlock();
+        callback(STATUS(IllegalState, "Commit already requested"));
         return;
       }
-      state_.store(TransactionState::kCommitted, std::memory_order_release);
       commit_callback_ = std::move(callback);
-      if (!ready_) {
-        waiters_.emplace_back(std::bind(&Impl::DoCommit, this, _1, transaction));
-        lock.unlock();
-        RequestStatusTablet();
+      if (running_flushes_ != 0) {
+        // The commit is sent as soon as the last running flush finishes, so the caller does not
+        // have to wait for its writes before committing.
+        VLOG_WITH_PREFIX(1) << "Commit waits for " << running_flushes_ << " running flushes";
+        commit_waits_for_flush_ = true;
         return;
       }
+      StartCommit(&lock, transaction);
     }
-    DoCommit(Status::OK(), transaction);
   }
 
   void Abort() {
@@ -321,6 +385,10 @@ class YBTransaction::Impl final {
         return;
       }
       state_.store(TransactionState::kAborted, std::memory_order_release);
+      if (single_shard_) {
+        // There are no intents and no status record to clean up.
+        return;
+      }
       if (!ready_) {
         waiters_.emplace_back(std::bind(&Impl::DoAbort, this, _1, transaction));
         lock.unlock();
@@ -375,6 +443,9 @@ class YBTransaction::Impl final {
     }
 
     SetReadTimeIfNeeded(force_consistent_read);
+    // Writes of the child are done by other servers, so they could not be part of a single shard
+    // write.
+    single_shard_allowed_ = false;
 
     if (!ready_) {
       waiters_.emplace_back(std::bind(
@@ -446,6 +517,29 @@ class YBTransaction::Impl final {
     abort_handle_ = manager_->rpcs().InvalidHandle();
   }
 
+  // Checks whether ops are all writes, that the batcher sends to a single tablet by one RPC.
+  bool CanWriteSingleShardUnlocked(const std::unordered_set<internal::InFlightOpPtr>& ops) {
+    if (ops.empty() || !tablets_.empty()) {
+      return false;
+    }
+    internal::RemoteTablet* tablet = nullptr;
+    size_t num_sidecars = 0;
+    for (const auto& op : ops) {
+      if (op->yb_op->read_only()) {
+        return false;
+      }
+      if (tablet == nullptr) {
+        tablet = op->tablet.get();
+      } else if (tablet != op->tablet.get()) {
+        return false;
+      }
+      if (op->yb_op->returns_sidecar()) {
+        ++num_sidecars;
+      }
+    }
+    return num_sidecars < rpc::CallResponse::kMaxSidecarSlices;
+  }
+
   void SetReadTimeIfNeeded(bool do_it) {
     if (!read_point_.GetReadTime() && do_it &&
         metadata_.isolation == IsolationLevel::SNAPSHOT_ISOLATION) {
@@ -453,6 +547,50 @@ class YBTransaction::Impl final {
     }
   }
 
+  // Sends commit request, all flushes of the transaction should be already finished.
+  // Unlocks the lock.
+  void StartCommit(std::unique_lock<std::mutex>* lock, const YBTransactionPtr& transaction) {
+    if (state_.load(std::memory_order_acquire) != TransactionState::kRunning) {
+      // Transaction was aborted while its ops were running.
+      auto status = error_.ok() ? STATUS(Aborted, "Transaction aborted") : error_;
+      auto callback = std::move(commit_callback_);
+      lock->unlock();
+      callback(status);
+      return;
+    }
+    if (!write_error_.ok()) {
+      auto status = write_error_;
+      auto callback = std::move(commit_callback_);
+      lock->unlock();
+      Abort();
+      callback(status);
+      return;
+    }
+    if (IsRestartRequired()) {
+      auto callback = std::move(commit_callback_);
+      lock->unlock();
+      callback(STATUS(IllegalState, "Commit of transaction that requires restart is not allowed"));
+      return;
+    }
+    state_.store(TransactionState::kCommitted, std::memory_order_release);
+    if (single_shard_) {
+      // All writes were already done by a single write request.
+      auto callback = std::move(commit_callback_);
+      lock->unlock();
+      VLOG_WITH_PREFIX(1) << "Committed single shard";
+      callback(Status::OK());
+      return;
+    }
+    if (!ready_) {
+      waiters_.emplace_back(std::bind(&Impl::DoCommit, this, _1, transaction));
+      lock->unlock();
+      RequestStatusTablet();
+      return;
+    }
+    lock->unlock();
+    DoCommit(Status::OK(), transaction);
+  }
+
   CHECKED_STATUS CheckRunning(std::unique_lock<std::mutex>* lock) {
     if (state_.load(std::memory_order_acquire) != TransactionState::kRunning) {
       auto status = error_;
@@ -666,7 +804,7 @@ class YBTransaction::Impl final {
   void NotifyWaiters(const Status& status) {
     std::vector<Waiter> waiters;
     {
-      std::lock_guard<std::mutex> lock(mutex_);
+      std::unique_lock<std::mutex> lock(mutex_);
       SetError(status, &lock);
       waiters_.swap(waiters);
     }
@@ -749,10 +887,10 @@ class YBTransaction::Impl final {
     }
   }
 
-  void SetError(const Status& status, std::lock_guard<std::mutex>* lock = nullptr) {
+  void SetError(const Status& status, std::unique_lock<std::mutex>* lock = nullptr) {
     VLOG_WITH_PREFIX(1) << "Failed: " << status;
     if (!lock) {
-      std::lock_guard<std::mutex> new_lock(mutex_);
+      std::unique_lock<std::mutex> new_lock(mutex_);
       SetError(status, &new_lock);
       return;
     }
@@ -798,7 +936,18 @@ class YBTransaction::Impl final {
   const bool child_;
   bool child_had_read_time_ = false;
   bool ready_ = false;
+  // Set by EnableSingleShardCommit until the first Prepare.
+  bool single_shard_allowed_ = false;
+  // All writes of this transaction were sent by the first Prepare as a single write request, so
+  // there is no status record and no intents.
+  bool single_shard_ = false;
   CommitCallback commit_callback_;
+  // Number of batchers of this transaction, that started flush and did not finish it yet.
+  size_t running_flushes_ = 0;
+  // Commit was requested while there were running flushes, so it is sent after they finish.
+  bool commit_waits_for_flush_ = false;
+  // First failure of the running flushes.
+  Status write_error_;
   Status error_;
   rpc::Rpcs::Handle heartbeat_handle_;
   rpc::Rpcs::Handle commit_handle_;
@@ -873,6 +1022,14 @@ bool YBTransaction::Prepare(const std::unordered_set<internal::InFlightOpPtr>& o
       ops, force_consistent_read, std::move(waiter), metadata, may_have_metadata);
 }
 
+void YBTransaction::FlushStarted() {
+  impl_->FlushStarted();
+}
+
+void YBTransaction::FlushFinished() {
+  impl_->FlushFinished();
+}
+
 void YBTransaction::Flushed(
     const internal::InFlightOps& ops, const ReadHybridTime& used_read_time, const Status& status) {
   impl_->Flushed(ops, used_read_time, status);
@@ -902,6 +1059,10 @@ void YBTransaction::Abort() {
   impl_->Abort();
 }
 
+void YBTransaction::EnableSingleShardCommit() {
+  impl_->EnableSingleShardCommit();
+}
+
 bool YBTransaction::IsRestartRequired() const {
   return impl_->IsRestartRequired();
 }
@@ -85,7 +85,16 @@ class YBTransaction : public std::enable_shared_from_this<YBTransaction> {
   void Flushed(
       const internal::InFlightOps& ops, const ReadHybridTime& used_read_time, const Status& status);
 
+  // Notifies transaction that batcher of this transaction started flush.
+  void FlushStarted();
+
+  // Notifies transaction that flush started by FlushStarted is finished, i.e. all its ops were
+  // flushed or aborted.
+  void FlushFinished();
+
   // Commits this transaction.
+  // Could be invoked while flushes of this transaction are running, then commit is sent right
+  // after they finish, and fails if some of them failed.
   void Commit(CommitCallback callback);
 
   // Utility function for Commit.
@@ -94,6 +103,14 @@ class YBTransaction : public std::enable_shared_from_this<YBTransaction> {
   // Aborts this transaction.
   void Abort();
 
+  // Should be invoked before the first flush, when all writes of this transaction are flushed
+  // together and the transaction is committed right after that flush.
+  // If those writes go to a single tablet, they are sent as one non-transactional write request.
+  // Such request is applied atomically by a single Raft operation and resolves conflicts with
+  // other transactions, so the transaction does not need a status record or intents, and the
+  // commit completes without RPCs.
+  void EnableSingleShardCommit();
+
   // Returns transaction ID.
   const TransactionId& id() const;
 
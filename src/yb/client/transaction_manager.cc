@@ -15,10 +15,13 @@
 
 #include "yb/client/transaction_manager.h"
 
+#include <gflags/gflags.h>
+
 #include "yb/rpc/rpc.h"
 #include "yb/rpc/thread_pool.h"
 #include "yb/rpc/tasks_pool.h"
 
+#include "yb/util/flag_tags.h"
 #include "yb/util/random_util.h"
 #include "yb/util/thread_restrictions.h"
 
@@ -28,6 +31,13 @@
 
 #include "yb/master/master_defaults.h"
 
+DEFINE_bool(transaction_prefer_region_local_status_tablets, false,
+            "When there is no transaction status tablet led by the local tablet server, pick one "
+            "led in the region of the client, so that commits, heartbeats and status checks of "
+            "transactions of a single region do not cross regions.");
+TAG_FLAG(transaction_prefer_region_local_status_tablets, advanced);
+TAG_FLAG(transaction_prefer_region_local_status_tablets, runtime);
+
 namespace yb {
 namespace client {
 
@@ -40,12 +50,32 @@ const YBTableName kTransactionTableName(master::kSystemNamespaceName, kTransacti
 // Resolved - final state, when all tablets are resolved and written to cache.
 YB_DEFINE_ENUM(TransactionTableStatus, (kExists)(kUpdating)(kResolved));
 
-void InvokeCallback(const LocalTabletFilter& filter, const std::vector<TabletId>& tablets,
+struct StatusTablets {
+  std::vector<TabletId> all;
+  // Tablets whose leader was in the region of the client when the tablets were resolved.
+  std::vector<TabletId> region_local;
+};
+
+bool IsRegionLocalLeader(const master::TabletLocationsPB& location, const CloudInfoPB& cloud_info) {
+  if (!cloud_info.has_placement_region()) {
+    return false;
+  }
+  for (const auto& replica : location.replicas()) {
+    if (replica.role() == consensus::RaftPeerPB::LEADER) {
+      const auto& leader_cloud_info = replica.ts_info().cloud_info();
+      return leader_cloud_info.placement_cloud() == cloud_info.placement_cloud() &&
+             leader_cloud_info.placement_region() == cloud_info.placement_region();
+    }
+  }
+  return false;
+}
+
+void InvokeCallback(const LocalTabletFilter& filter, const StatusTablets& tablets,
                     const PickStatusTabletCallback& callback) {
   if (filter) {
     std::vector<const TabletId*> ids;
-    ids.reserve(tablets.size());
-    for (const auto& id : tablets) {
+    ids.reserve(tablets.all.size());
+    for (const auto& id : tablets.all) {
       ids.push_back(&id);
     }
     filter(&ids);
@@ -55,13 +85,17 @@ void InvokeCallback(const LocalTabletFilter& filter, const std::vector<TabletId>
     }
     LOG(WARNING) << "No local transaction status tablet";
   }
-  callback(RandomElement(tablets));
+  if (FLAGS_transaction_prefer_region_local_status_tablets && !tablets.region_local.empty()) {
+    callback(RandomElement(tablets.region_local));
+    return;
+  }
+  callback(RandomElement(tablets.all));
 }
 
 struct TransactionTableState {
   LocalTabletFilter local_tablet_filter;
   std::atomic<TransactionTableStatus> status{TransactionTableStatus::kExists};
-  std::vector<TabletId> tablets;
+  StatusTablets tablets;
 };
 
 // Picks status tablet for transaction.
@@ -76,16 +110,23 @@ class PickStatusTabletTask {
 
   void Run() {
     // TODO(dtxn) async
-    std::vector<TabletId> tablets;
-    auto status = client_->GetTablets(kTransactionTableName, 0, &tablets, /* ranges */ nullptr);
+    StatusTablets tablets;
+    std::vector<master::TabletLocationsPB> locations;
+    auto status = client_->GetTablets(
+        kTransactionTableName, 0, &tablets.all, /* ranges */ nullptr, &locations);
     if (!status.ok()) {
       callback_(status);
       return;
     }
-    if (tablets.empty()) {
+    if (tablets.all.empty()) {
       callback_(STATUS_FORMAT(IllegalState, "No tablets in table $0", kTransactionTableName));
       return;
     }
+    for (const auto& location : locations) {
+      if (IsRegionLocalLeader(location, client_->cloud_info())) {
+        tablets.region_local.push_back(location.tablet_id());
+      }
+    }
     auto expected = TransactionTableStatus::kExists;
     if (table_state_->status.compare_exchange_strong(
         expected, TransactionTableStatus::kUpdating, std::memory_order_acq_rel)) {
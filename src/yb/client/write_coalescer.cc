@@ -0,0 +1,214 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/client/write_coalescer.h"
+
+#include <algorithm>
+
+#include <boost/optional.hpp>
+
+#include "yb/client/async_rpc.h"
+#include "yb/client/batcher.h"
+#include "yb/client/in_flight_op.h"
+#include "yb/client/meta_cache.h"
+#include "yb/client/yb_op.h"
+
+#include "yb/rpc/outbound_call.h"
+#include "yb/rpc/scheduler.h"
+
+#include "yb/util/flag_tags.h"
+#include "yb/util/size_literals.h"
+
+using namespace std::literals;
+using namespace std::placeholders;
+using namespace yb::size_literals;
+
+DEFINE_int32(client_write_linger_us, 0,
+             "Max time in microseconds write operations could wait for the in flight write RPC "
+             "to the same tablet, so operations of different sessions could be sent in a single "
+             "RPC. 0 disables coalescing.");
+TAG_FLAG(client_write_linger_us, runtime);
+TAG_FLAG(client_write_linger_us, advanced);
+
+DEFINE_int32(client_write_linger_max_bytes, 256_KB,
+             "Lingering write operations of a tablet are sent as soon as their total size reaches "
+             "this limit.");
+TAG_FLAG(client_write_linger_max_bytes, runtime);
+TAG_FLAG(client_write_linger_max_bytes, advanced);
+
+namespace yb {
+namespace client {
+namespace internal {
+
+namespace {
+
+size_t OpSize(const InFlightOp& op) {
+  const auto* yb_op = op.yb_op.get();
+  switch (yb_op->type()) {
+    case YBOperation::Type::QL_WRITE:
+      return down_cast<const YBqlWriteOp*>(yb_op)->request().ByteSize();
+    case YBOperation::Type::PGSQL_WRITE:
+      return down_cast<const YBPgsqlWriteOp*>(yb_op)->request().ByteSize();
+    case YBOperation::Type::REDIS_WRITE:
+      return down_cast<const YBRedisWriteOp*>(yb_op)->space_used_by_request();
+    default:
+      LOG(DFATAL) << "Not a write operation " << yb_op->type();
+      return 0;
+  }
+}
+
+} // namespace
+
+WriteCoalescer::WriteCoalescer(rpc::Scheduler* scheduler) : scheduler_(*scheduler) {
+}
+
+WriteCoalescer::~WriteCoalescer() {
+}
+
+bool WriteCoalescer::Enabled() {
+  return FLAGS_client_write_linger_us > 0;
+}
+
+void WriteCoalescer::Write(RemoteTablet* tablet, const BatcherPtr& batcher, InFlightOps ops) {
+  size_t bytes = 0;
+  size_t sidecars = 0;
+  for (const auto& op : ops) {
+    bytes += OpSize(*op);
+    if (op->yb_op->returns_sidecar()) {
+      ++sidecars;
+    }
+    // From now on the op belongs to the coalescer, so the batcher should not abort it.
+    std::lock_guard<simple_spinlock> lock(op->lock_);
+    op->state = InFlightOpState::kRequestSent;
+  }
+
+  boost::optional<AsyncRpcData> full, ready;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto& queue = queues_[tablet->tablet_id()];
+    if (!queue.tablet) {
+      queue.tablet = tablet;
+    }
+    // Each batcher should have at most one contiguous range of ops in RPC.
+    auto same_batcher = [&batcher](const BatcherPtr& queued) {
+      return queued.get() == batcher.get();
+    };
+    if (!queue.ops.empty() &&
+        (queue.sidecars + sidecars > rpc::CallResponse::kMaxSidecarSlices ||
+         std::any_of(queue.batchers.begin(), queue.batchers.end(), same_batcher))) {
+      full = TakeQueueUnlocked(&queue);
+    }
+    queue.ops.insert(queue.ops.end(), ops.begin(), ops.end());
+    queue.batchers.push_back(batcher);
+    queue.bytes += bytes;
+    queue.sidecars += sidecars;
+    auto linger_us = FLAGS_client_write_linger_us;
+    if (queue.in_flight == 0 || closing_ || linger_us <= 0 ||
+        queue.bytes >= implicit_cast<size_t>(FLAGS_client_write_linger_max_bytes)) {
+      ready = TakeQueueUnlocked(&queue);
+    } else if (!queue.lingering) {
+      queue.lingering = true;
+      scheduler_.Schedule(
+          std::bind(&WriteCoalescer::LingerDone, shared_from_this(), tablet->tablet_id(),
+                    queue.generation, _1),
+          linger_us * 1us);
+    }
+  }
+
+  if (full) {
+    Send(full.get_ptr());
+  }
+  if (ready) {
+    Send(ready.get_ptr());
+  }
+}
+
+void WriteCoalescer::WriteFinished(const TabletId& tablet_id) {
+  boost::optional<AsyncRpcData> ready;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = queues_.find(tablet_id);
+    CHECK(it != queues_.end()) << "Unknown tablet: " << tablet_id;
+    auto& queue = it->second;
+    --queue.in_flight;
+    if (!queue.ops.empty()) {
+      ready = TakeQueueUnlocked(&queue);
+    } else if (queue.in_flight == 0) {
+      queues_.erase(it);
+    }
+  }
+
+  if (ready) {
+    Send(ready.get_ptr());
+  }
+}
+
+void WriteCoalescer::LingerDone(
+    const TabletId& tablet_id, uint64_t generation, const Status& status) {
+  boost::optional<AsyncRpcData> ready;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = queues_.find(tablet_id);
+    // Ops that were waiting for this task were already sent.
+    if (it == queues_.end() || it->second.generation != generation) {
+      return;
+    }
+    ready = TakeQueueUnlocked(&it->second);
+  }
+
+  Send(ready.get_ptr());
+}
+
+void WriteCoalescer::Shutdown() {
+  std::vector<AsyncRpcData> ready;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    closing_ = true;
+    for (auto& p : queues_) {
+      if (!p.second.ops.empty()) {
+        ready.push_back(TakeQueueUnlocked(&p.second));
+      }
+    }
+  }
+
+  for (auto& data : ready) {
+    Send(&data);
+  }
+}
+
+AsyncRpcData WriteCoalescer::TakeQueueUnlocked(Queue* queue) {
+  DCHECK(!queue->ops.empty());
+
+  AsyncRpcData result;
+  result.batcher = queue->batchers.front();
+  result.tablet = queue->tablet.get();
+  result.ops.swap(queue->ops);
+  result.coalescer = shared_from_this();
+  result.coalesced_batchers.assign(queue->batchers.begin() + 1, queue->batchers.end());
+
+  queue->batchers.clear();
+  queue->bytes = 0;
+  queue->sidecars = 0;
+  ++queue->in_flight;
+  ++queue->generation;
+  queue->lingering = false;
+  return result;
+}
+
+void WriteCoalescer::Send(AsyncRpcData* data) {
+  std::make_shared<WriteRpc>(data)->SendRpc();
+}
+
+} // namespace internal
+} // namespace client
+} // namespace yb
@@ -0,0 +1,97 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#ifndef YB_CLIENT_WRITE_COALESCER_H
+#define YB_CLIENT_WRITE_COALESCER_H
+
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "yb/client/client_fwd.h"
+
+#include "yb/common/entity_ids.h"
+
+#include "yb/gutil/ref_counted.h"
+
+#include "yb/rpc/rpc_fwd.h"
+
+#include "yb/util/status.h"
+
+namespace yb {
+namespace client {
+namespace internal {
+
+struct AsyncRpcData;
+
+// Merges write operations of different batchers, that target the same tablet, into a single
+// write RPC.
+//
+// Operations are sent immediately while there is no write RPC from this client to their tablet
+// in flight. Otherwise they linger until the in flight RPC finishes, client_write_linger_us
+// elapses or client_write_linger_max_bytes are accumulated, whatever happens first. So idle
+// tablets see no extra latency, while a busy tablet receives one big RPC instead of many small
+// ones, and the more load the tablet has the larger batches become.
+class WriteCoalescer : public std::enable_shared_from_this<WriteCoalescer> {
+ public:
+  explicit WriteCoalescer(rpc::Scheduler* scheduler);
+  ~WriteCoalescer();
+
+  // Whether batchers should pass their writes to the coalescer.
+  static bool Enabled();
+
+  // Sends ops of batcher to tablet, possibly together with ops of other batchers.
+  void Write(RemoteTablet* tablet, const BatcherPtr& batcher, InFlightOps ops);
+
+  // Invoked when write RPC created by this coalescer finished.
+  void WriteFinished(const TabletId& tablet_id);
+
+  // Sends all lingering operations.
+  void Shutdown();
+
+ private:
+  struct Queue {
+    RemoteTabletPtr tablet;
+    InFlightOps ops;
+    // Distinct batchers of ops, in order of their first op.
+    std::vector<BatcherPtr> batchers;
+    size_t bytes = 0;
+    size_t sidecars = 0;
+    // Number of write RPCs to this tablet, sent by coalescer and not yet finished.
+    size_t in_flight = 0;
+    // Incremented each time queued ops are taken, so a stale linger task could be recognized.
+    uint64_t generation = 0;
+    bool lingering = false;
+  };
+
+  // Takes operations queued for tablet, the write RPC for them should be sent by the caller
+  // outside of the lock.
+  AsyncRpcData TakeQueueUnlocked(Queue* queue);
+
+  void Send(AsyncRpcData* data);
+
+  void LingerDone(const TabletId& tablet_id, uint64_t generation, const Status& status);
+
+  rpc::Scheduler& scheduler_;
+
+  std::mutex mutex_;
+  std::unordered_map<TabletId, Queue> queues_;
+  bool closing_ = false;
+};
+
+} // namespace internal
+} // namespace client
+} // namespace yb
+
+#endif // YB_CLIENT_WRITE_COALESCER_H
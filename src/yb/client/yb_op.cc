@@ -171,7 +171,7 @@ Status YBRedisReadOp::GetPartitionKey(std::string *partition_key) const {
 //--------------------------------------------------------------------------------------------------
 
 YBqlOp::YBqlOp(const shared_ptr<YBTable>& table)
-      : YBOperation(table) , ql_response_(new QLResponsePB()) {
+      : YBOperation(table) {
 }
 
 YBqlOp::~YBqlOp() {
@@ -180,7 +180,7 @@ YBqlOp::~YBqlOp() {
 // YBqlWriteOp -----------------------------------------------------------------
 
 YBqlWriteOp::YBqlWriteOp(const shared_ptr<YBTable>& table)
-    : YBqlOp(table), ql_write_request_(new QLWriteRequestPB()) {
+    : YBqlOp(table) {
 }
 
 YBqlWriteOp::~YBqlWriteOp() {}
@@ -213,36 +213,36 @@ YBqlWriteOp *YBqlWriteOp::NewDelete(const std::shared_ptr<YBTable>& table) {
 }
 
 std::string YBqlWriteOp::ToString() const {
-  return "QL_WRITE " + ql_write_request_->ShortDebugString();
+  return "QL_WRITE " + ql_write_request_.ShortDebugString();
 }
 
 Status YBqlWriteOp::GetPartitionKey(string* partition_key) const {
-  return table_->partition_schema().EncodeKey(ql_write_request_->hashed_column_values(),
+  return table_->partition_schema().EncodeKey(ql_write_request_.hashed_column_values(),
                                               partition_key);
 }
 
 void YBqlWriteOp::SetHashCode(const uint16_t hash_code) {
-  ql_write_request_->set_hash_code(hash_code);
+  ql_write_request_.set_hash_code(hash_code);
 }
 
 uint16_t YBqlWriteOp::GetHashCode() const {
-  return ql_write_request_->hash_code();
+  return ql_write_request_.hash_code();
 }
 
 bool YBqlWriteOp::ReadsStaticRow() const {
   // A QL write op reads the static row if it reads a static column, or it writes to the static row
   // and has a user-defined timestamp (which DocDB requires a read-modify-write by the timestamp).
-  return !ql_write_request_->column_refs().static_ids().empty() ||
-         (writes_static_row_ && ql_write_request_->has_user_timestamp_usec());
+  return !ql_write_request_.column_refs().static_ids().empty() ||
+         (writes_static_row_ && ql_write_request_.has_user_timestamp_usec());
 }
 
 bool YBqlWriteOp::ReadsPrimaryRow() const {
   // A QL write op reads the primary row reads a non-static column, it writes to the primary row
   // and has a user-defined timestamp (which DocDB requires a read-modify-write by the timestamp),
   // or if there is an IF clause.
-  return !ql_write_request_->column_refs().ids().empty() ||
-         (writes_primary_row_ && ql_write_request_->has_user_timestamp_usec()) ||
-         ql_write_request_->has_if_expr();
+  return !ql_write_request_.column_refs().ids().empty() ||
+         (writes_primary_row_ && ql_write_request_.has_user_timestamp_usec()) ||
+         ql_write_request_.has_if_expr();
 }
 
 bool YBqlWriteOp::WritesStaticRow() const {
@@ -329,7 +329,6 @@ bool YBqlWriteOp::PrimaryKeyComparator::operator() (const YBqlWriteOpPtr& op1,
 
 YBqlReadOp::YBqlReadOp(const shared_ptr<YBTable>& table)
     : YBqlOp(table),
-      ql_read_request_(new QLReadRequestPB()),
       yb_consistency_level_(YBConsistencyLevel::STRONG) {
 }
 
@@ -349,17 +348,17 @@ YBqlReadOp *YBqlReadOp::NewSelect(const shared_ptr<YBTable>& table) {
 }
 
 std::string YBqlReadOp::ToString() const {
-  return "QL_READ " + ql_read_request_->DebugString();
+  return "QL_READ " + ql_read_request_.DebugString();
 }
 
 void YBqlReadOp::SetHashCode(const uint16_t hash_code) {
-  ql_read_request_->set_hash_code(hash_code);
+  ql_read_request_.set_hash_code(hash_code);
 }
 
 Status YBqlReadOp::GetPartitionKey(string* partition_key) const {
-  if (!ql_read_request_->hashed_column_values().empty()) {
+  if (!ql_read_request_.hashed_column_values().empty()) {
     // If hashed columns are set, use them to compute the exact key and set the bounds
-    RETURN_NOT_OK(table_->partition_schema().EncodeKey(ql_read_request_->hashed_column_values(),
+    RETURN_NOT_OK(table_->partition_schema().EncodeKey(ql_read_request_.hashed_column_values(),
         partition_key));
 
     // TODO: If user specified token range doesn't contain the hash columns specified then the query
@@ -368,28 +367,28 @@ Status YBqlReadOp::GetPartitionKey(string* partition_key) const {
     // Which will return no result.
 
     // Make sure given key is not smaller than lower bound (if any)
-    if (ql_read_request_->has_hash_code()) {
-      uint16 hash_code = static_cast<uint16>(ql_read_request_->hash_code());
+    if (ql_read_request_.has_hash_code()) {
+      uint16 hash_code = static_cast<uint16>(ql_read_request_.hash_code());
       auto lower_bound = PartitionSchema::EncodeMultiColumnHashValue(hash_code);
       if (*partition_key < lower_bound) *partition_key = std::move(lower_bound);
     }
 
     // Make sure given key is not bigger than upper bound (if any)
-    if (ql_read_request_->has_max_hash_code()) {
-      uint16 hash_code = static_cast<uint16>(ql_read_request_->max_hash_code());
+    if (ql_read_request_.has_max_hash_code()) {
+      uint16 hash_code = static_cast<uint16>(ql_read_request_.max_hash_code());
       auto upper_bound = PartitionSchema::EncodeMultiColumnHashValue(hash_code);
       if (*partition_key > upper_bound) *partition_key = std::move(upper_bound);
     }
 
     // Set both bounds to equal partition key now, because this is a point get
-    ql_read_request_->set_hash_code(
+    ql_read_request_.set_hash_code(
           PartitionSchema::DecodeMultiColumnHashValue(*partition_key));
-    ql_read_request_->set_max_hash_code(
+    ql_read_request_.set_max_hash_code(
           PartitionSchema::DecodeMultiColumnHashValue(*partition_key));
   } else {
     // Otherwise, set the partition key to the hash_code (lower bound of the token range).
-    if (ql_read_request_->has_hash_code()) {
-      uint16 hash_code = static_cast<uint16>(ql_read_request_->hash_code());
+    if (ql_read_request_.has_hash_code()) {
+      uint16 hash_code = static_cast<uint16>(ql_read_request_.hash_code());
       *partition_key = PartitionSchema::EncodeMultiColumnHashValue(hash_code);
     } else {
       // Default to empty key, this will start a scan from the beginning.
@@ -400,11 +399,11 @@ Status YBqlReadOp::GetPartitionKey(string* partition_key) const {
   // If this is a continued query use the partition key from the paging state
   // If paging state is there, set hash_code = paging state. This is only supported for forward
   // scans.
-  if (ql_read_request_->has_paging_state() &&
-      ql_read_request_->paging_state().has_next_partition_key() &&
-      !ql_read_request_->paging_state().next_partition_key().empty()) {
-    *partition_key = ql_read_request_->paging_state().next_partition_key();
-    ql_read_request_->set_hash_code(
+  if (ql_read_request_.has_paging_state() &&
+      ql_read_request_.paging_state().has_next_partition_key() &&
+      !ql_read_request_.paging_state().next_partition_key().empty()) {
+    *partition_key = ql_read_request_.paging_state().next_partition_key();
+    ql_read_request_.set_hash_code(
         PartitionSchema::DecodeMultiColumnHashValue(*partition_key));
   }
 
@@ -236,11 +236,11 @@ class YBqlOp : public YBOperation {
  public:
   virtual ~YBqlOp();
 
-  const QLResponsePB& response() const { return *ql_response_; }
+  const QLResponsePB& response() const { return ql_response_; }
 
-  QLResponsePB* mutable_response() { return ql_response_.get(); }
+  QLResponsePB* mutable_response() { return &ql_response_; }
 
-  const std::string& rows_data() { return rows_data_; }
+  const std::string& rows_data() const { return rows_data_; }
 
   std::string* mutable_rows_data() { return &rows_data_; }
 
@@ -251,7 +251,9 @@ class YBqlOp : public YBOperation {
 
  protected:
   explicit YBqlOp(const std::shared_ptr<YBTable>& table);
-  std::unique_ptr<QLResponsePB> ql_response_;
+  // Request and response are embedded into the operation, so creating an operation does not
+  // allocate them separately.
+  QLResponsePB ql_response_;
   std::string rows_data_;
 };
 
@@ -263,16 +265,16 @@ class YBqlWriteOp : public YBqlOp {
   // Note: to avoid memory copy, this QLWriteRequestPB is moved into tserver WriteRequestPB
   // when the request is sent to tserver. It is restored after response is received from tserver
   // (see WriteRpc's constructor).
-  const QLWriteRequestPB& request() const { return *ql_write_request_; }
+  const QLWriteRequestPB& request() const { return ql_write_request_; }
 
-  QLWriteRequestPB* mutable_request() { return ql_write_request_.get(); }
+  QLWriteRequestPB* mutable_request() { return &ql_write_request_; }
 
   std::string ToString() const override;
 
   bool read_only() override { return false; };
 
   bool returns_sidecar() override {
-    return ql_write_request_->has_if_expr() || ql_write_request_->returns_status();
+    return ql_write_request_.has_if_expr() || ql_write_request_.returns_status();
   }
 
   virtual void SetHashCode(uint16_t hash_code) override;
@@ -313,7 +315,7 @@ class YBqlWriteOp : public YBqlOp {
   static YBqlWriteOp *NewInsert(const std::shared_ptr<YBTable>& table);
   static YBqlWriteOp *NewUpdate(const std::shared_ptr<YBTable>& table);
   static YBqlWriteOp *NewDelete(const std::shared_ptr<YBTable>& table);
-  std::unique_ptr<QLWriteRequestPB> ql_write_request_;
+  QLWriteRequestPB ql_write_request_;
 
   // Does this operation write to the static or primary row?
   bool writes_static_row_ = false;
@@ -329,9 +331,9 @@ class YBqlReadOp : public YBqlOp {
   // Note: to avoid memory copy, this QLReadRequestPB is moved into tserver ReadRequestPB
   // when the request is sent to tserver. It is restored after response is received from tserver
   // (see ReadRpc's constructor).
-  const QLReadRequestPB& request() const { return *ql_read_request_; }
+  const QLReadRequestPB& request() const { return ql_read_request_; }
 
-  QLReadRequestPB* mutable_request() { return ql_read_request_.get(); }
+  QLReadRequestPB* mutable_request() { return &ql_read_request_; }
 
   virtual std::string ToString() const override;
 
@@ -345,7 +347,7 @@ class YBqlReadOp : public YBqlOp {
   // Also sets the hash_code and max_hash_code in the request.
   virtual CHECKED_STATUS GetPartitionKey(std::string* partition_key) const override;
 
-  const YBConsistencyLevel yb_consistency_level() {
+  const YBConsistencyLevel yb_consistency_level() const {
     return yb_consistency_level_;
   }
 
@@ -365,7 +367,8 @@ class YBqlReadOp : public YBqlOp {
  private:
   friend class YBTable;
   explicit YBqlReadOp(const std::shared_ptr<YBTable>& table);
-  std::unique_ptr<QLReadRequestPB> ql_read_request_;
+  // Mutable because GetPartitionKey sets hash codes of the request.
+  mutable QLReadRequestPB ql_read_request_;
   YBConsistencyLevel yb_consistency_level_;
   ReadHybridTime read_time_;
 };
@@ -16,6 +16,7 @@
 
 #include "yb/common/jsonb.h"
 #include "yb/util/test_macros.h"
+#include "yb/util/varint.h"
 #include "yb/util/test_util.h"
 
 using std::to_string;
@@ -151,5 +152,64 @@ TEST(JsonbTest, TestArrays) {
   VerifyArray(document);
 }
 
+void AddObjectOperator(const std::string& key, JsonOperatorPB json_operator,
+                       QLJsonColumnOperationsPB* json_ops) {
+  auto* op = json_ops->add_json_operations();
+  op->set_json_operator(json_operator);
+  op->mutable_operand()->mutable_value()->set_string_value(key);
+}
+
+void AddArrayOperator(int64_t index, JsonOperatorPB json_operator,
+                      QLJsonColumnOperationsPB* json_ops) {
+  auto* op = json_ops->add_json_operations();
+  op->set_json_operator(json_operator);
+  op->mutable_operand()->mutable_value()->set_varint_value(
+      util::VarInt(index).EncodeToComparable());
+}
+
+TEST(JsonbTest, TestApplyJsonbOperators) {
+  Jsonb jsonb;
+  ASSERT_OK(jsonb.FromString(R"#(
+      {
+        "b" : 1,
+        "a1" : [1, 2, 3.0, false, true, { "k1" : 1, "k2" : [100, 200, 300], "k3" : true}],
+        "a" : { "f" : "hello" }
+      }
+      )#"));
+
+  // a1->5->k2->>1
+  QLJsonColumnOperationsPB json_ops;
+  AddObjectOperator("a1", JsonOperatorPB::JSON_OBJECT, &json_ops);
+  AddArrayOperator(5, JsonOperatorPB::JSON_OBJECT, &json_ops);
+  AddObjectOperator("k2", JsonOperatorPB::JSON_OBJECT, &json_ops);
+  AddArrayOperator(1, JsonOperatorPB::JSON_TEXT, &json_ops);
+  QLValue result;
+  ASSERT_OK(Jsonb::ApplyJsonbOperators(jsonb.SerializedJsonb(), json_ops, &result));
+  ASSERT_EQ("200", result.string_value());
+
+  // a->f returns a jsonb scalar.
+  json_ops.Clear();
+  AddObjectOperator("a", JsonOperatorPB::JSON_OBJECT, &json_ops);
+  AddObjectOperator("f", JsonOperatorPB::JSON_OBJECT, &json_ops);
+  ASSERT_OK(jsonb.ApplyJsonbOperators(json_ops, &result));
+  std::string json;
+  ASSERT_OK(Jsonb(result.jsonb_value()).ToJsonString(&json));
+  ASSERT_EQ("\"hello\"", json);
+
+  // Missing keys, out of bounds indexes and operators applied to scalars result in null.
+  for (const auto& missing : {"c", "a0", "b"}) {
+    json_ops.Clear();
+    AddObjectOperator(missing, JsonOperatorPB::JSON_OBJECT, &json_ops);
+    AddObjectOperator("x", JsonOperatorPB::JSON_TEXT, &json_ops);
+    ASSERT_OK(jsonb.ApplyJsonbOperators(json_ops, &result));
+    ASSERT_TRUE(result.IsNull()) << missing;
+  }
+  json_ops.Clear();
+  AddObjectOperator("a1", JsonOperatorPB::JSON_OBJECT, &json_ops);
+  AddArrayOperator(6, JsonOperatorPB::JSON_TEXT, &json_ops);
+  ASSERT_OK(jsonb.ApplyJsonbOperators(json_ops, &result));
+  ASSERT_TRUE(result.IsNull());
+}
+
 }  // namespace common
 }  // namespace yb
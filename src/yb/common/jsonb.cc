@@ -682,12 +682,13 @@ Status Jsonb::ApplyJsonbOperatorToObject(const Slice& jsonb, const QLJsonOperati
     Slice mid_key;
     RETURN_NOT_OK(GetObjectKey(mid, jsonb, metadata_begin_offset, data_begin_offset, &mid_key));
 
-    if (mid_key == search_key_slice) {
+    const int cmp = mid_key.compare(search_key_slice);
+    if (cmp == 0) {
       RETURN_NOT_OK(GetObjectValue(mid, jsonb, sizeof(jsonb_header),
                                    ComputeDataOffset(num_kv_pairs, kJBObject), num_kv_pairs,
                                    result, element_metadata));
       return Status::OK();
-    } else if (mid_key.ToBuffer() > search_key) {
+    } else if (cmp > 0) {
       high = mid - 1;
     } else {
       low = mid + 1;
@@ -697,11 +698,16 @@ Status Jsonb::ApplyJsonbOperatorToObject(const Slice& jsonb, const QLJsonOperati
 }
 
 Status Jsonb::ApplyJsonbOperators(const QLJsonColumnOperationsPB& json_ops, QLValue* result) const {
+  return ApplyJsonbOperators(serialized_jsonb_, json_ops, result);
+}
+
+Status Jsonb::ApplyJsonbOperators(const Slice& jsonb, const QLJsonColumnOperationsPB& json_ops,
+                                  QLValue* result) {
   const int num_ops = json_ops.json_operations().size();
 
-  Slice jsonop_result;
-  Slice operand(serialized_jsonb_);
-  JEntry element_metadata;
+  Slice jsonop_result = jsonb;
+  Slice operand = jsonb;
+  JEntry element_metadata = 0;
   for (int i = 0; i < num_ops; i++) {
     const QLJsonOperationPB &op = json_ops.json_operations().Get(i);
     const Status s = ApplyJsonbOperator(operand, op, &jsonop_result,
@@ -736,12 +742,14 @@ Status Jsonb::ApplyJsonbOperators(const QLJsonColumnOperationsPB& json_ops, QLVa
     return Status::OK();
   }
 
-  string jsonb_result = jsonop_result.ToBuffer();
-  if (IsScalar(element_metadata)) {
+  string jsonb_result;
+  if (num_ops > 0 && IsScalar(element_metadata)) {
     // In case of a scalar that is received from an operation, convert it to a jsonb scalar.
     RETURN_NOT_OK(CreateScalar(jsonop_result,
                                element_metadata,
                                &jsonb_result));
+  } else {
+    jsonb_result = jsonop_result.ToBuffer();
   }
   result->set_jsonb_value(std::move(jsonb_result));
   return Status::OK();
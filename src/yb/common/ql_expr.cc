@@ -31,11 +31,14 @@ CHECKED_STATUS QLExprExecutor::EvalExpr(const QLExpressionPB& ql_expr,
       break;
 
     case QLExpressionPB::ExprCase::kJsonColumn: {
-      QLValue ql_value;
+      // Navigate the stored jsonb in place, instead of copying the whole column value.
       const QLJsonColumnOperationsPB& json_ops = ql_expr.json_column();
-      RETURN_NOT_OK(table_row.ReadColumn(json_ops.column_id(), &ql_value));
-      common::Jsonb jsonb(std::move(ql_value.jsonb_value()));
-      RETURN_NOT_OK(jsonb.ApplyJsonbOperators(json_ops, result));
+      auto column = table_row.GetValue(json_ops.column_id());
+      if (!column || !column->has_jsonb_value()) {
+        result->SetNull();
+        break;
+      }
+      RETURN_NOT_OK(common::Jsonb::ApplyJsonbOperators(column->jsonb_value(), json_ops, result));
       break;
     }
 
@@ -141,6 +144,30 @@ CHECKED_STATUS QLExprExecutor::ReadTSCallValue(const QLBCallPB& ql_expr,
 
 //--------------------------------------------------------------------------------------------------
 
+CHECKED_STATUS QLExprExecutor::EvalOperand(const QLExpressionPB& ql_expr,
+                                           const QLTableRow& table_row,
+                                           QLValue *temp,
+                                           const QLValuePB **result) {
+  switch (ql_expr.expr_case()) {
+    case QLExpressionPB::ExprCase::kValue:
+      *result = &ql_expr.value();
+      return Status::OK();
+
+    case QLExpressionPB::ExprCase::kColumnId: {
+      auto column = table_row.GetValue(ql_expr.column_id());
+      *result = column ? &*column : &QLValuePB::default_instance();
+      return Status::OK();
+    }
+
+    default:
+      RETURN_NOT_OK(EvalExpr(ql_expr, table_row, temp));
+      *result = &temp->value();
+      return Status::OK();
+  }
+}
+
+//--------------------------------------------------------------------------------------------------
+
 CHECKED_STATUS QLExprExecutor::EvalCondition(const QLConditionPB& condition,
                                              const QLTableRow& table_row,
                                              bool* result) {
@@ -156,26 +183,31 @@ CHECKED_STATUS QLExprExecutor::EvalCondition(const QLConditionPB& condition,
 #define QL_EVALUATE_RELATIONAL_OP(op)                                                              \
   do {                                                                                             \
     CHECK_EQ(operands.size(), 2);                                                                  \
-    QLValue left, right;                                                                           \
-    RETURN_NOT_OK(EvalExpr(operands.Get(0), table_row, &left));                                    \
-    RETURN_NOT_OK(EvalExpr(operands.Get(1), table_row, &right));                                   \
-    if (!left.Comparable(right))                                                                   \
+    QLValue left_temp, right_temp;                                                                 \
+    const QLValuePB* left;                                                                         \
+    const QLValuePB* right;                                                                        \
+    RETURN_NOT_OK(EvalOperand(operands.Get(0), table_row, &left_temp, &left));                     \
+    RETURN_NOT_OK(EvalOperand(operands.Get(1), table_row, &right_temp, &right));                   \
+    if (!Comparable(*left, *right))                                                                \
       return STATUS(RuntimeError, "values not comparable");                                        \
-    result->set_bool_value(left.value() op right.value());                                         \
+    result->set_bool_value(*left op *right);                                                       \
     return Status::OK();                                                                           \
   } while (false)
 
 #define QL_EVALUATE_BETWEEN(op1, op2, rel_op)                                                      \
   do {                                                                                             \
       CHECK_EQ(operands.size(), 3);                                                                \
-      QLValue lower, upper;                                                                        \
-      RETURN_NOT_OK(EvalExpr(operands.Get(0), table_row, &temp));                                  \
-      RETURN_NOT_OK(EvalExpr(operands.Get(1), table_row, &lower));                                 \
-      RETURN_NOT_OK(EvalExpr(operands.Get(2), table_row, &upper));                                 \
-      if (!temp.Comparable(lower) || !temp.Comparable(upper)) {                                    \
+      QLValue lower_temp, upper_temp;                                                              \
+      const QLValuePB* value;                                                                      \
+      const QLValuePB* lower;                                                                      \
+      const QLValuePB* upper;                                                                      \
+      RETURN_NOT_OK(EvalOperand(operands.Get(0), table_row, &temp, &value));                       \
+      RETURN_NOT_OK(EvalOperand(operands.Get(1), table_row, &lower_temp, &lower));                 \
+      RETURN_NOT_OK(EvalOperand(operands.Get(2), table_row, &upper_temp, &upper));                 \
+      if (!Comparable(*value, *lower) || !Comparable(*value, *upper)) {                            \
         return STATUS(RuntimeError, "values not comparable");                                      \
       }                                                                                            \
-      result->set_bool_value(temp.value() op1 lower.value() rel_op temp.value() op2 upper.value());\
+      result->set_bool_value(*value op1 *lower rel_op *value op2 *upper);                          \
       return Status::OK();                                                                         \
   } while (false)
 
@@ -189,17 +221,21 @@ CHECKED_STATUS QLExprExecutor::EvalCondition(const QLConditionPB& condition,
       result->set_bool_value(!temp.bool_value());
       return Status::OK();
 
-    case QL_OP_IS_NULL:
+    case QL_OP_IS_NULL: {
       CHECK_EQ(operands.size(), 1);
-      RETURN_NOT_OK(EvalExpr(operands.Get(0), table_row, &temp));
-      result->set_bool_value(temp.IsNull());
+      const QLValuePB* value;
+      RETURN_NOT_OK(EvalOperand(operands.Get(0), table_row, &temp, &value));
+      result->set_bool_value(IsNull(*value));
       return Status::OK();
+    }
 
-    case QL_OP_IS_NOT_NULL:
+    case QL_OP_IS_NOT_NULL: {
       CHECK_EQ(operands.size(), 1);
-      RETURN_NOT_OK(EvalExpr(operands.Get(0), table_row, &temp));
-      result->set_bool_value(!temp.IsNull());
+      const QLValuePB* value;
+      RETURN_NOT_OK(EvalOperand(operands.Get(0), table_row, &temp, &value));
+      result->set_bool_value(!IsNull(*value));
       return Status::OK();
+    }
 
     case QL_OP_IS_TRUE:
       CHECK_EQ(operands.size(), 1);
@@ -277,16 +313,18 @@ CHECKED_STATUS QLExprExecutor::EvalCondition(const QLConditionPB& condition,
 
     case QL_OP_IN: {
       CHECK_EQ(operands.size(), 2);
-      QLValue left, right;
-      RETURN_NOT_OK(EvalExpr(operands.Get(0), table_row, &left));
-      RETURN_NOT_OK(EvalExpr(operands.Get(1), table_row, &right));
+      QLValue left_temp, right_temp;
+      const QLValuePB* left;
+      const QLValuePB* right;
+      RETURN_NOT_OK(EvalOperand(operands.Get(0), table_row, &left_temp, &left));
+      RETURN_NOT_OK(EvalOperand(operands.Get(1), table_row, &right_temp, &right));
 
       result->set_bool_value(false);
-      for (const QLValuePB& elem : right.list_value().elems()) {
-        if (!Comparable(elem, left)) {
+      for (const QLValuePB& elem : right->list_value().elems()) {
+        if (!Comparable(elem, *left)) {
            return STATUS(RuntimeError, "values not comparable");
         }
-        if (elem == left) {
+        if (elem == *left) {
           result->set_bool_value(true);
           break;
         }
@@ -296,16 +334,18 @@ CHECKED_STATUS QLExprExecutor::EvalCondition(const QLConditionPB& condition,
 
     case QL_OP_NOT_IN: {
       CHECK_EQ(operands.size(), 2);
-      QLValue left, right;
-      RETURN_NOT_OK(EvalExpr(operands.Get(0), table_row, &left));
-      RETURN_NOT_OK(EvalExpr(operands.Get(1), table_row, &right));
+      QLValue left_temp, right_temp;
+      const QLValuePB* left;
+      const QLValuePB* right;
+      RETURN_NOT_OK(EvalOperand(operands.Get(0), table_row, &left_temp, &left));
+      RETURN_NOT_OK(EvalOperand(operands.Get(1), table_row, &right_temp, &right));
 
       result->set_bool_value(true);
-      for (const QLValuePB& elem : right.list_value().elems()) {
-        if (!Comparable(elem, left)) {
+      for (const QLValuePB& elem : right->list_value().elems()) {
+        if (!Comparable(elem, *left)) {
           return STATUS(RuntimeError, "values not comparable");
         }
-        if (elem == left) {
+        if (elem == *left) {
           result->set_bool_value(false);
           break;
         }
@@ -441,7 +481,8 @@ CHECKED_STATUS QLExprExecutor::EvalCondition(const PgsqlConditionPB& condition,
                                              bool* result) {
   QLValue result_pb;
   RETURN_NOT_OK(EvalCondition(condition, table_row, &result_pb));
-  *result = result_pb.bool_value();
+  // A condition that is unknown because of NULL operands does not match.
+  *result = !result_pb.IsNull() && result_pb.bool_value();
   return Status::OK();
 }
 
@@ -454,6 +495,10 @@ CHECKED_STATUS QLExprExecutor::EvalCondition(const PgsqlConditionPB& condition,
     QLValue left, right;                                                                           \
     RETURN_NOT_OK(EvalExpr(operands.Get(0), table_row, &left));                                    \
     RETURN_NOT_OK(EvalExpr(operands.Get(1), table_row, &right));                                   \
+    if (!left.BothNotNull(right)) {                                                                \
+      result->SetNull();                                                                           \
+      return Status::OK();                                                                         \
+    }                                                                                              \
     if (!left.Comparable(right))                                                                   \
       return STATUS(RuntimeError, "values not comparable");                                        \
     result->set_bool_value(left.value() op right.value());                                         \
@@ -467,6 +512,10 @@ CHECKED_STATUS QLExprExecutor::EvalCondition(const PgsqlConditionPB& condition,
       RETURN_NOT_OK(EvalExpr(operands.Get(0), table_row, &temp));                                  \
       RETURN_NOT_OK(EvalExpr(operands.Get(1), table_row, &lower));                                 \
       RETURN_NOT_OK(EvalExpr(operands.Get(2), table_row, &upper));                                 \
+      if (!temp.BothNotNull(lower) || !temp.BothNotNull(upper)) {                                  \
+        result->SetNull();                                                                         \
+        return Status::OK();                                                                       \
+      }                                                                                            \
       if (!temp.Comparable(lower) || !temp.Comparable(upper)) {                                    \
         return STATUS(RuntimeError, "values not comparable");                                      \
       }                                                                                            \
@@ -481,7 +530,11 @@ CHECKED_STATUS QLExprExecutor::EvalCondition(const PgsqlConditionPB& condition,
       CHECK_EQ(operands.size(), 1);
       CHECK_EQ(operands.Get(0).expr_case(), PgsqlExpressionPB::ExprCase::kCondition);
       RETURN_NOT_OK(EvalCondition(operands.Get(0).condition(), table_row, &temp));
-      result->set_bool_value(!temp.bool_value());
+      if (temp.IsNull()) {
+        result->SetNull();
+      } else {
+        result->set_bool_value(!temp.bool_value());
+      }
       return Status::OK();
 
     case QL_OP_IS_NULL:
@@ -531,27 +584,30 @@ CHECKED_STATUS QLExprExecutor::EvalCondition(const PgsqlConditionPB& condition,
     case QL_OP_NOT_EQUAL:
       QL_EVALUATE_RELATIONAL_OP(!=);
 
-    case QL_OP_AND:
+    // AND and OR follow SQL three-valued logic: an unknown (NULL) operand makes the result unknown
+    // unless another operand decides it.
+    case QL_OP_AND: FALLTHROUGH_INTENDED;
+    case QL_OP_OR: {
       CHECK_GT(operands.size(), 0);
+      const bool is_and = condition.op() == QL_OP_AND;
+      bool has_null = false;
       for (const auto &operand : operands) {
         CHECK_EQ(operand.expr_case(), PgsqlExpressionPB::ExprCase::kCondition);
-        RETURN_NOT_OK(EvalCondition(operand.condition(), table_row, result));
-        if (!result->bool_value()) {
-          break;
+        RETURN_NOT_OK(EvalCondition(operand.condition(), table_row, &temp));
+        if (temp.IsNull()) {
+          has_null = true;
+        } else if (temp.bool_value() != is_and) {
+          result->set_bool_value(!is_and);
+          return Status::OK();
         }
       }
-      return Status::OK();
-
-    case QL_OP_OR:
-      CHECK_GT(operands.size(), 0);
-      for (const auto &operand : operands) {
-        CHECK_EQ(operand.expr_case(), PgsqlExpressionPB::ExprCase::kCondition);
-        RETURN_NOT_OK(EvalCondition(operand.condition(), table_row, result));
-        if (result->bool_value()) {
-          break;
-        }
+      if (has_null) {
+        result->SetNull();
+      } else {
+        result->set_bool_value(is_and);
       }
       return Status::OK();
+    }
 
     case QL_OP_BETWEEN:
       QL_EVALUATE_BETWEEN(>=, <=, &&);
@@ -575,6 +631,10 @@ CHECKED_STATUS QLExprExecutor::EvalCondition(const PgsqlConditionPB& condition,
       QLValue left, right;
       RETURN_NOT_OK(EvalExpr(operands.Get(0), table_row, &left));
       RETURN_NOT_OK(EvalExpr(operands.Get(1), table_row, &right));
+      if (left.IsNull()) {
+        result->SetNull();
+        return Status::OK();
+      }
 
       result->set_bool_value(false);
       for (const QLValuePB& elem : right.list_value().elems()) {
@@ -594,6 +654,10 @@ CHECKED_STATUS QLExprExecutor::EvalCondition(const PgsqlConditionPB& condition,
       QLValue left, right;
       RETURN_NOT_OK(EvalExpr(operands.Get(0), table_row, &left));
       RETURN_NOT_OK(EvalExpr(operands.Get(1), table_row, &right));
+      if (left.IsNull()) {
+        result->SetNull();
+        return Status::OK();
+      }
 
       result->set_bool_value(true);
       for (const QLValuePB& elem : right.list_value().elems()) {
@@ -214,6 +214,13 @@ class QLExprExecutor {
                                        const QLTableRow& table_row,
                                        QLValue *result);
 
+  // Evaluate an operand of a condition. Constants and columns are referred in place, so filters
+  // do not copy values of every row they check. Other expressions are evaluated into temp.
+  CHECKED_STATUS EvalOperand(const QLExpressionPB& ql_expr,
+                             const QLTableRow& table_row,
+                             QLValue *temp,
+                             const QLValuePB **result);
+
   //------------------------------------------------------------------------------------------------
   // PGSQL Support.
 
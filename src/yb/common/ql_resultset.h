@@ -77,6 +77,9 @@ class QLResultSet {
   // Row count
   size_t rsrow_count() const;
 
+  // Memory allocated for the serialized rows.
+  size_t memory_usage() const { return rows_data_->capacity(); }
+
  private:
   const QLRSRowDesc* rsrow_desc_ = nullptr;
   faststring* rows_data_ = nullptr;
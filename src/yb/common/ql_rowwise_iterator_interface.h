@@ -16,6 +16,7 @@
 
 #include <memory>
 
+#include "yb/util/monotime.h"
 #include "yb/util/result.h"
 #include "yb/util/status.h"
 
@@ -84,6 +85,9 @@ class YQLRowwiseIteratorIf {
     return STATUS(NotSupported, "This iterator cannot seek by row key");
   }
 
+  // Sets the deadline of the reads that continue on this iterator.
+  virtual void SetDeadline(CoarseTimePoint deadline) {}
+
   //------------------------------------------------------------------------------------------------
   // Common API methods.
   //------------------------------------------------------------------------------------------------
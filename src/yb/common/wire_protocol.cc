@@ -41,6 +41,7 @@
 #include "yb/gutil/strings/fastmem.h"
 #include "yb/gutil/strings/substitute.h"
 #include "yb/util/faststring.h"
+#include "yb/util/flag_tags.h"
 #include "yb/util/logging.h"
 #include "yb/util/net/net_util.h"
 #include "yb/util/net/sockaddr.h"
@@ -60,6 +61,18 @@ DEFINE_string(use_private_ip, "never",
                   "region and zone."
               "never - would never use private IP if broadcast address is specified.");
 
+DEFINE_string(rpc_compression, "never",
+              "When to compress messages of RPC connections between servers. "
+              "cloud - would compress if destination node is located in a different cloud. "
+              "region - would compress if destination node is located in a different cloud or "
+                  "region. "
+              "zone - would compress if destination node is located in a different cloud, region "
+                  "or zone. "
+              "always - would compress all connections. "
+              "never - would never compress. "
+              "All nodes should support compressed connections before this is enabled.");
+TAG_FLAG(rpc_compression, advanced);
+
 namespace yb {
 
 namespace {
@@ -406,6 +419,40 @@ bool UsePublicIp(const CloudInfoPB& connect_to,
   return mode != UsePrivateIpMode::zone;
 }
 
+bool UseRpcCompression(const CloudInfoPB& connect_to, const CloudInfoPB& connect_from) {
+  RpcCompressionMode mode = RpcCompressionMode::never;
+  bool found = false;
+  for (auto i : kRpcCompressionModeList) {
+    if (FLAGS_rpc_compression == ToCString(i)) {
+      mode = i;
+      found = true;
+      break;
+    }
+  }
+  if (!found) {
+    YB_LOG_EVERY_N_SECS(WARNING, 300)
+        << "Invalid value of FLAGS_rpc_compression: " << FLAGS_rpc_compression
+        << ", not compressing";
+  }
+
+  switch (mode) {
+    case RpcCompressionMode::never:
+      return false;
+    case RpcCompressionMode::always:
+      return true;
+    case RpcCompressionMode::cloud:
+      return connect_to.placement_cloud() != connect_from.placement_cloud();
+    case RpcCompressionMode::region:
+      return connect_to.placement_cloud() != connect_from.placement_cloud() ||
+             connect_to.placement_region() != connect_from.placement_region();
+    case RpcCompressionMode::zone:
+      return connect_to.placement_cloud() != connect_from.placement_cloud() ||
+             connect_to.placement_region() != connect_from.placement_region() ||
+             connect_to.placement_zone() != connect_from.placement_zone();
+  }
+  FATAL_INVALID_ENUM_VALUE(RpcCompressionMode, mode);
+}
+
 const HostPortPB& DesiredHostPort(
     const google::protobuf::RepeatedPtrField<HostPortPB>& broadcast_addresses,
     const google::protobuf::RepeatedPtrField<HostPortPB>& private_host_ports,
@@ -130,6 +130,12 @@ YB_DEFINE_ENUM(UsePrivateIpMode, (cloud)(region)(zone)(never));
 // Returns mode for selecting between private and public IP.
 Result<UsePrivateIpMode> GetPrivateIpMode();
 
+YB_DEFINE_ENUM(RpcCompressionMode, (never)(cloud)(region)(zone)(always));
+
+// Returns whether messages of connections from connect_from to connect_to should be compressed,
+// according to FLAGS_rpc_compression.
+bool UseRpcCompression(const CloudInfoPB& connect_to, const CloudInfoPB& connect_from);
+
 // Pick host and port that should be used to connect node
 // broadcast_addresses - node public host ports
 // private_host_ports - node private host ports
@@ -55,6 +55,7 @@
 #include "yb/gutil/strings/substitute.h"
 #include "yb/rpc/messenger.h"
 #include "yb/rpc/periodic.h"
+#include "yb/rpc/tcp_stream.h"
 #include "yb/tserver/tserver.pb.h"
 
 #include "yb/util/backoff_waiter.h"
@@ -88,6 +89,24 @@ DEFINE_test_flag(bool, enable_remote_bootstrap, true,
                  "replica.");
 
 DECLARE_int32(log_change_config_every_n);
+DECLARE_int32(consensus_max_in_flight_requests);
+
+DEFINE_bool(consensus_heartbeat_batching, true,
+            "Whether heartbeats that carry no operations, sent by leaders of different tablets to "
+            "the same follower, are coalesced into a single MultiRaftUpdateConsensus RPC.");
+TAG_FLAG(consensus_heartbeat_batching, advanced);
+TAG_FLAG(consensus_heartbeat_batching, runtime);
+
+DEFINE_int32(consensus_heartbeat_batch_window_ms, 2,
+             "How long a heartbeat waits for heartbeats of other tablets to the same follower "
+             "before the batch is sent.");
+TAG_FLAG(consensus_heartbeat_batch_window_ms, advanced);
+TAG_FLAG(consensus_heartbeat_batch_window_ms, runtime);
+
+DEFINE_int32(consensus_heartbeat_max_batch_size, 256,
+             "Maximum number of heartbeats coalesced into a single MultiRaftUpdateConsensus RPC.");
+TAG_FLAG(consensus_heartbeat_max_batch_size, advanced);
+TAG_FLAG(consensus_heartbeat_max_batch_size, runtime);
 
 namespace yb {
 namespace consensus {
@@ -156,6 +175,10 @@ Status Peer::SignalRequest(RequestTriggerMode trigger_mode) {
   // If there are new requests in the queue we'll get them on ProcessResponse().
   auto performing_lock = LockPerforming(std::try_to_lock);
   if (!performing_lock.owns_lock()) {
+    if (trigger_mode == RequestTriggerMode::kNonEmptyOnly) {
+      // New operations could still be sent before the response to the current request.
+      MaybeSendPipelinedRequest();
+    }
     return Status::OK();
   }
 
@@ -305,9 +328,146 @@ void Peer::SendNextRequest(RequestTriggerMode trigger_mode) {
   // We will cleanup ops from request in ProcessResponse, because otherwise there could be race
   // condition. When rest of this function is running in parallel to ProcessResponse.
   msgs_holder.ReleaseOps();
+  controller_.set_request_tail(msgs_holder.serialized_ops());
 
   proxy_->UpdateAsync(&request_, trigger_mode, &response_, &controller_,
                       std::bind(&Peer::ProcessResponse, retain_self));
+
+  if (req_has_ops) {
+    MaybeSendPipelinedRequest();
+  }
+}
+
+void Peer::MaybeSendPipelinedRequest() {
+  {
+    std::lock_guard<simple_spinlock> lock(peer_lock_);
+    const auto max_in_flight = std::max(GetAtomicFlag(&FLAGS_consensus_max_in_flight_requests), 1);
+    if (state_ != kPeerRunning || failed_attempts_ > 0 || building_pipelined_request_ ||
+        num_pipelined_requests_ + 1 >= std::min<size_t>(pipeline_window_, max_in_flight)) {
+      return;
+    }
+    building_pipelined_request_ = true;
+  }
+
+  auto status = raft_pool_token_->SubmitFunc(
+      std::bind(&Peer::SendPipelinedRequest, shared_from_this()));
+  if (!status.ok()) {
+    std::lock_guard<simple_spinlock> lock(peer_lock_);
+    building_pipelined_request_ = false;
+  }
+}
+
+void Peer::SendPipelinedRequest() {
+  auto pipelined = std::make_shared<PipelinedRequest>();
+  ReplicateMsgsHolder msgs_holder;
+  Status s = queue_->PipelinedRequestForPeer(
+      peer_pb_.permanent_uuid(), &pipelined->request, &msgs_holder);
+  {
+    std::lock_guard<simple_spinlock> lock(peer_lock_);
+    building_pipelined_request_ = false;
+    if (!s.ok() || pipelined->request.ops_size() == 0 || state_ == kPeerClosed) {
+      return;
+    }
+    ++num_pipelined_requests_;
+  }
+
+  pipelined->request.set_tablet_id(tablet_id_);
+  pipelined->request.set_caller_uuid(leader_uuid_);
+  pipelined->request.set_dest_uuid(peer_pb_.permanent_uuid());
+  heartbeater_->Snooze();
+
+  // Ops are removed from the request in ProcessPipelinedResponse, as for the main request.
+  msgs_holder.ReleaseOps();
+  pipelined->controller.set_request_tail(msgs_holder.serialized_ops());
+
+  auto* request = pipelined.get();
+  proxy_->UpdateAsync(&request->request, RequestTriggerMode::kNonEmptyOnly, &request->response,
+                      &request->controller,
+                      std::bind(&Peer::ProcessPipelinedResponse, shared_from_this(), pipelined));
+
+  // Keep filling the window while there are operations to send.
+  MaybeSendPipelinedRequest();
+}
+
+void Peer::ProcessPipelinedResponse(const std::shared_ptr<PipelinedRequest>& pipelined) {
+  // Note: This method runs on the reactor thread.
+  pipelined->request.mutable_ops()->ExtractSubrange(
+      0, pipelined->request.ops().size(), nullptr /* elements */);
+
+  Status status = pipelined->controller.status();
+  const auto& response = pipelined->response;
+  if (status.ok() && response.has_error()) {
+    status = StatusFromPB(response.error().status());
+  }
+  if (status.ok() && response.status().has_error() &&
+      response.status().error().code() == consensus::ConsensusErrorPB::CANNOT_PREPARE) {
+    status = StatusFromPB(response.status().error().status());
+  }
+
+  auto processing_lock = StartProcessingUnlocked();
+  if (!processing_lock.owns_lock()) {
+    return;
+  }
+  --num_pipelined_requests_;
+
+  if (!status.ok()) {
+    // The operations of this request did not reach the peer, so the requests sent after it will
+    // be rejected as well. Errors that need special handling, like a missing tablet, are left to
+    // the main request.
+    YB_LOG_WITH_PREFIX_EVERY_N_SECS(WARNING, 5) << "Pipelined request failed: " << status;
+    ShrinkPipelineWindowUnlocked();
+    queue_->ResetPipelineForPeer(peer_pb_.permanent_uuid());
+    return;
+  }
+
+  processing_lock.unlock();
+  Status s = raft_pool_token_->SubmitFunc(
+      std::bind(&Peer::DoProcessPipelinedResponse, shared_from_this(), pipelined));
+  if (PREDICT_FALSE(!s.ok())) {
+    LOG_WITH_PREFIX(WARNING) << "Unable to process pipelined peer response: " << s;
+  }
+}
+
+void Peer::DoProcessPipelinedResponse(const std::shared_ptr<PipelinedRequest>& pipelined) {
+  {
+    auto processing_lock = StartProcessingUnlocked();
+    if (!processing_lock.owns_lock()) {
+      return;
+    }
+  }
+
+  // Consensus errors, like a LMP mismatch of a request that arrived before the preceding one,
+  // are handled by the queue, which restarts replication from the proper index.
+  bool more_pending = false;
+  queue_->ResponseFromPeer(
+      peer_pb_.permanent_uuid(), pipelined->response, &more_pending, true /* pipelined */);
+
+  {
+    auto processing_lock = StartProcessingUnlocked();
+    if (!processing_lock.owns_lock()) {
+      return;
+    }
+    if (pipelined->response.status().has_error()) {
+      ShrinkPipelineWindowUnlocked();
+    } else if (more_pending) {
+      GrowPipelineWindowUnlocked();
+    }
+  }
+
+  if (more_pending) {
+    WARN_NOT_OK(SignalRequest(RequestTriggerMode::kNonEmptyOnly),
+                LogPrefix() + "Unable to send request");
+  }
+}
+
+void Peer::GrowPipelineWindowUnlocked() {
+  const size_t max_in_flight = std::max(
+      GetAtomicFlag(&FLAGS_consensus_max_in_flight_requests), 1);
+  pipeline_window_ = std::min(pipeline_window_, max_in_flight - 1) + 1;
+}
+
+void Peer::ShrinkPipelineWindowUnlocked() {
+  pipeline_window_ = std::max<size_t>(pipeline_window_ / 2, 1);
 }
 
 std::unique_lock<simple_spinlock> Peer::StartProcessingUnlocked() {
@@ -399,6 +559,11 @@ void Peer::DoProcessResponse() {
   failed_attempts_ = 0;
   bool more_pending = false;
   queue_->ResponseFromPeer(peer_pb_.permanent_uuid(), response_, &more_pending);
+  if (response_.status().has_error()) {
+    ShrinkPipelineWindowUnlocked();
+  } else if (more_pending) {
+    GrowPipelineWindowUnlocked();
+  }
 
   if (more_pending) {
     processing_lock.unlock();
@@ -446,6 +611,9 @@ void Peer::ProcessRemoteBootstrapResponse() {
 void Peer::ProcessResponseError(const Status& status) {
   DCHECK(performing_mutex_.is_locked());
   failed_attempts_++;
+  ShrinkPipelineWindowUnlocked();
+  // Requests sent after the failed one cannot be appended by the peer.
+  queue_->ResetPipelineForPeer(peer_pb_.permanent_uuid());
   YB_LOG_WITH_PREFIX_EVERY_N_SECS(WARNING, 5) << "Couldn't send request. "
       << " Status: " << status.ToString() << ". Retrying in the next heartbeat period."
       << " Already tried " << failed_attempts_ << " times. State: " << state_;
@@ -484,8 +652,129 @@ Peer::~Peer() {
   CHECK_EQ(state_, kPeerClosed) << "Peer cannot be implicitly closed";
 }
 
-RpcPeerProxy::RpcPeerProxy(HostPort hostport, ConsensusServiceProxyPtr consensus_proxy)
-    : hostport_(std::move(hostport)), consensus_proxy_(std::move(consensus_proxy)) {
+// Coalesces heartbeats of different tablets to the same follower into MultiRaftUpdateConsensus
+// RPCs. A heartbeat waits at most FLAGS_consensus_heartbeat_batch_window_ms, which is safe for
+// leader leases and safe time, since both are computed by the leader when the request is built,
+// so a delay only makes the follower see them later.
+//
+// If a batch RPC fails, e.g. because the follower does not support MultiRaftUpdateConsensus yet,
+// its heartbeats are resent separately, so that each peer gets the status of its own call.
+class HeartbeatBatcher : public std::enable_shared_from_this<HeartbeatBatcher> {
+ public:
+  HeartbeatBatcher(rpc::Messenger* messenger, rpc::ProxyCache* proxy_cache, HostPort hostport)
+      : messenger_(messenger), hostport_(std::move(hostport)),
+        proxy_(std::make_unique<ConsensusServiceProxy>(proxy_cache, hostport_)) {}
+
+  void Add(const ConsensusRequestPB* request, ConsensusResponsePB* response,
+           rpc::RpcController* controller, const rpc::ResponseCallback& callback) {
+    bool flush_now = false;
+    bool schedule_flush = false;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      pending_.push_back(Entry{request, response, controller, callback});
+      if (pending_.size() >= std::max<size_t>(FLAGS_consensus_heartbeat_max_batch_size, 1)) {
+        flush_now = true;
+      } else if (!flush_scheduled_) {
+        flush_scheduled_ = true;
+        schedule_flush = true;
+      }
+    }
+    if (flush_now) {
+      Flush();
+    } else if (schedule_flush) {
+      auto self = shared_from_this();
+      messenger_->scheduler().Schedule(
+          [self](const Status& status) {
+            self->Flush();
+          },
+          FLAGS_consensus_heartbeat_batch_window_ms * 1ms);
+    }
+  }
+
+ private:
+  struct Entry {
+    const ConsensusRequestPB* request;
+    ConsensusResponsePB* response;
+    rpc::RpcController* controller;
+    rpc::ResponseCallback callback;
+  };
+
+  struct Batch {
+    std::vector<Entry> entries;
+    MultiRaftConsensusRequestPB request;
+    MultiRaftConsensusResponsePB response;
+    rpc::RpcController controller;
+  };
+
+  // Sends the pending heartbeats. Also called when the scheduled flush is aborted on shutdown,
+  // in which case the RPC fails and so do the separately resent heartbeats.
+  void Flush() {
+    auto batch = std::make_shared<Batch>();
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      batch->entries.swap(pending_);
+      flush_scheduled_ = false;
+    }
+    if (batch->entries.empty()) {
+      return;
+    }
+    if (batch->entries.size() == 1) {
+      SendSeparately(batch->entries.front());
+      return;
+    }
+    batch->request.mutable_consensus_request()->Reserve(batch->entries.size());
+    for (const auto& entry : batch->entries) {
+      batch->request.add_consensus_request()->CopyFrom(*entry.request);
+    }
+    batch->controller.set_timeout(MonoDelta::FromMilliseconds(FLAGS_consensus_rpc_timeout_ms));
+    proxy_->MultiRaftUpdateConsensusAsync(
+        batch->request, &batch->response, &batch->controller,
+        std::bind(&HeartbeatBatcher::BatchDone, shared_from_this(), batch));
+  }
+
+  void BatchDone(const std::shared_ptr<Batch>& batch) {
+    auto status = batch->controller.status();
+    if (status.ok() &&
+        static_cast<size_t>(batch->response.consensus_response_size()) !=
+            batch->entries.size()) {
+      status = STATUS_FORMAT(
+          IllegalState, "Wrong number of responses in batch: $0, expected: $1",
+          batch->response.consensus_response_size(), batch->entries.size());
+    }
+    if (!status.ok()) {
+      YB_LOG_EVERY_N(WARNING, 100) << "Heartbeat batch to " << hostport_
+                                   << " failed, sending separately: " << status;
+      for (const auto& entry : batch->entries) {
+        SendSeparately(entry);
+      }
+      return;
+    }
+    for (size_t i = 0; i != batch->entries.size(); ++i) {
+      const auto& entry = batch->entries[i];
+      entry.response->Swap(batch->response.mutable_consensus_response(i));
+      entry.callback();
+    }
+  }
+
+  void SendSeparately(const Entry& entry) {
+    proxy_->UpdateConsensusAsync(
+        *entry.request, entry.response, entry.controller, entry.callback);
+  }
+
+  rpc::Messenger* const messenger_;
+  const HostPort hostport_;
+  // Owned by the batcher, since a batch could outlive the peer proxies that added heartbeats to it.
+  ConsensusServiceProxyPtr proxy_;
+
+  std::mutex mutex_;
+  std::vector<Entry> pending_;
+  bool flush_scheduled_ = false;
+};
+
+RpcPeerProxy::RpcPeerProxy(HostPort hostport, ConsensusServiceProxyPtr consensus_proxy,
+                           std::shared_ptr<HeartbeatBatcher> heartbeat_batcher)
+    : hostport_(std::move(hostport)), consensus_proxy_(std::move(consensus_proxy)),
+      heartbeat_batcher_(std::move(heartbeat_batcher)) {
 }
 
 void RpcPeerProxy::UpdateAsync(const ConsensusRequestPB* request,
@@ -494,6 +783,27 @@ void RpcPeerProxy::UpdateAsync(const ConsensusRequestPB* request,
                                rpc::RpcController* controller,
                                const rpc::ResponseCallback& callback) {
   controller->set_timeout(MonoDelta::FromMilliseconds(FLAGS_consensus_rpc_timeout_ms));
+  // Requests with operations are latency sensitive, so only idle heartbeats are batched.
+  if (heartbeat_batcher_ && trigger_mode == RequestTriggerMode::kAlwaysSend &&
+      request->ops_size() == 0 && FLAGS_consensus_heartbeat_batching) {
+    heartbeat_batcher_->Add(request, response, controller, callback);
+    return;
+  }
+  if (!controller->request_tail().empty()) {
+    if (!consensus_proxy_->proxy().IsServiceLocal()) {
+      // The ops are sent from their shared serialized form, so the request itself is serialized
+      // without them. The request is not visible to anything else until the call is issued.
+      auto* ops = const_cast<ConsensusRequestPB*>(request)->mutable_ops();
+      google::protobuf::RepeatedPtrField<ReplicateMsg> detached_ops;
+      detached_ops.Swap(ops);
+      ConsensusRequestPB request_without_ops;
+      request_without_ops.CopyFrom(*request);
+      ops->Swap(&detached_ops);
+      consensus_proxy_->UpdateConsensusAsync(request_without_ops, response, controller, callback);
+      return;
+    }
+    controller->set_request_tail(std::vector<RefCntBuffer>());
+  }
   consensus_proxy_->UpdateConsensusAsync(*request, response, controller, callback);
 }
 
@@ -534,8 +844,25 @@ RpcPeerProxyFactory::RpcPeerProxyFactory(
 
 PeerProxyPtr RpcPeerProxyFactory::NewProxy(const RaftPeerPB& peer_pb) {
   auto hostport = HostPortFromPB(DesiredHostPort(peer_pb, from_));
-  auto proxy = std::make_unique<ConsensusServiceProxy>(proxy_cache_, hostport);
-  return std::make_unique<RpcPeerProxy>(std::move(hostport), std::move(proxy));
+  auto protocol = UseRpcCompression(peer_pb.cloud_info(), from_)
+      ? rpc::TcpStream::CompressedProtocol() : nullptr;
+  auto proxy = std::make_unique<ConsensusServiceProxy>(proxy_cache_, hostport, protocol);
+  auto heartbeat_batcher = GetHeartbeatBatcher(hostport);
+  return std::make_unique<RpcPeerProxy>(
+      std::move(hostport), std::move(proxy), std::move(heartbeat_batcher));
+}
+
+std::shared_ptr<HeartbeatBatcher> RpcPeerProxyFactory::GetHeartbeatBatcher(
+    const HostPort& hostport) {
+  if (!messenger_) {
+    return nullptr;
+  }
+  std::lock_guard<std::mutex> lock(heartbeat_batchers_mutex_);
+  auto& result = heartbeat_batchers_[hostport];
+  if (!result) {
+    result = std::make_shared<HeartbeatBatcher>(messenger_.get(), proxy_cache_, hostport);
+  }
+  return result;
 }
 
 RpcPeerProxyFactory::~RpcPeerProxyFactory() {}
@@ -34,7 +34,9 @@
 #define YB_CONSENSUS_CONSENSUS_PEERS_H_
 
 #include <memory>
+#include <mutex>
 #include <string>
+#include <unordered_map>
 #include <vector>
 #include <atomic>
 
@@ -68,6 +70,8 @@ class Log;
 
 namespace consensus {
 
+class HeartbeatBatcher;
+
 // A peer in consensus (local or remote).
 //
 // Leaders use peers to update the local Log and remote replicas.
@@ -200,6 +204,33 @@ class Peer : public std::enable_shared_from_this<Peer> {
   // Signals there was an error sending the request to the peer.
   void ProcessResponseError(const Status& status);
 
+  // A request with operations that is sent while the main request, i.e. request_, or other
+  // pipelined requests are still in flight. See FLAGS_consensus_max_in_flight_requests.
+  struct PipelinedRequest {
+    ConsensusRequestPB request;
+    ConsensusResponsePB response;
+    rpc::RpcController controller;
+  };
+
+  // Sends a pipelined request on 'raft_pool_token' if the window allows it.
+  void MaybeSendPipelinedRequest();
+
+  // Run on 'raft_pool_token'. Fetches the operations following those in flight from the queue and
+  // sends them to the peer.
+  void SendPipelinedRequest();
+
+  // Handles the response to a pipelined request on the reactor thread, the rest of the handling
+  // is done by DoProcessPipelinedResponse() on 'raft_pool_token'.
+  void ProcessPipelinedResponse(const std::shared_ptr<PipelinedRequest>& pipelined);
+  void DoProcessPipelinedResponse(const std::shared_ptr<PipelinedRequest>& pipelined);
+
+  // Adapt the window of requests in flight, like TCP congestion control does: the window grows
+  // by one while responses show that the peer still has operations pending, i.e. the window does
+  // not cover the bandwidth-delay product of the link yet, and halves on failures.
+  // Require peer_lock_.
+  void GrowPipelineWindowUnlocked();
+  void ShrinkPipelineWindowUnlocked();
+
   // Returns true if the peer is closed and the calling function should return.
   std::unique_lock<simple_spinlock> StartProcessingUnlocked();
 
@@ -232,6 +263,11 @@ class Peer : public std::enable_shared_from_this<Peer> {
 
   rpc::RpcController controller_;
 
+  // Protected by peer_lock_. The window counts the main request as well.
+  size_t pipeline_window_ = 1;
+  size_t num_pipelined_requests_ = 0;
+  bool building_pipelined_request_ = false;
+
   // Held if there is an outstanding request.  This is used in order to ensure that we only have a
   // single request outstanding at a time, and to wait for the outstanding requests at Close().
   AtomicTryMutex performing_mutex_;
@@ -320,7 +356,9 @@ class PeerProxyFactory {
 // PeerProxy implementation that does RPC calls
 class RpcPeerProxy : public PeerProxy {
  public:
-  RpcPeerProxy(HostPort hostport, ConsensusServiceProxyPtr consensus_proxy);
+  // heartbeat_batcher could be null, in which case all requests are sent separately.
+  RpcPeerProxy(HostPort hostport, ConsensusServiceProxyPtr consensus_proxy,
+               std::shared_ptr<HeartbeatBatcher> heartbeat_batcher = nullptr);
 
   virtual void UpdateAsync(const ConsensusRequestPB* request,
                            RequestTriggerMode trigger_mode,
@@ -353,6 +391,7 @@ class RpcPeerProxy : public PeerProxy {
  private:
   HostPort hostport_;
   ConsensusServiceProxyPtr consensus_proxy_;
+  std::shared_ptr<HeartbeatBatcher> heartbeat_batcher_;
 };
 
 // PeerProxyFactory implementation that generates RPCPeerProxies
@@ -368,9 +407,17 @@ class RpcPeerProxyFactory : public PeerProxyFactory {
   std::shared_ptr<rpc::Messenger> messenger() const override;
 
  private:
+  std::shared_ptr<HeartbeatBatcher> GetHeartbeatBatcher(const HostPort& hostport);
+
   std::shared_ptr<rpc::Messenger> messenger_;
   rpc::ProxyCache* const proxy_cache_;
   const CloudInfoPB from_;
+
+  // Heartbeats of all tablets led by this server to the same follower are coalesced by
+  // a single batcher.
+  std::mutex heartbeat_batchers_mutex_;
+  std::unordered_map<HostPort, std::shared_ptr<HeartbeatBatcher>, HostPortHash>
+      heartbeat_batchers_;
 };
 
 // Query the consensus service at last known host/port that is specified in 'remote_peer' and set
@@ -56,6 +56,8 @@
 
 DECLARE_bool(enable_data_block_fsync);
 DECLARE_int32(consensus_max_batch_size_bytes);
+DECLARE_int32(consensus_max_in_flight_requests);
+DECLARE_bool(remote_bootstrap_from_followers);
 
 METRIC_DECLARE_entity(tablet);
 
@@ -347,6 +349,82 @@ TEST_F(ConsensusQueueTest, TestGetPagedMessages) {
   ASSERT_FALSE(more_pending);
 }
 
+// Tests that pipelined requests continue after the operations in flight, that out of order
+// responses do not move the peer back, and that a failed pipelined request restarts replication
+// from the peer's next index.
+TEST_F(ConsensusQueueTest, TestPipelinedRequests) {
+  google::FlagSaver saver;
+  FLAGS_consensus_max_in_flight_requests = 4;
+
+  queue_->Init(MinimumOpId());
+  queue_->SetLeaderMode(MinimumOpId(), MinimumOpId().term(), BuildRaftConfigPBForTests(2));
+
+  ConsensusRequestPB request;
+  ConsensusResponsePB response;
+  response.set_responder_uuid(kPeerUuid);
+  bool more_pending = false;
+  bool needs_remote_bootstrap = false;
+  UpdatePeerWatermarkToOp(&request, &response, MinimumOpId(), MinimumOpId(), &more_pending);
+
+  // Nothing is pipelined until an exchange with the peer succeeds.
+  AppendReplicateMessagesToQueue(queue_.get(), clock_, 1, 20);
+  {
+    ConsensusRequestPB pipelined;
+    ReplicateMsgsHolder refs;
+    ASSERT_OK(queue_->PipelinedRequestForPeer(kPeerUuid, &pipelined, &refs));
+    ASSERT_EQ(0, pipelined.ops_size());
+  }
+  {
+    ReplicateMsgsHolder refs;
+    ASSERT_OK(queue_->RequestForPeer(kPeerUuid, &request, &refs, &needs_remote_bootstrap));
+    ASSERT_EQ(20, request.ops_size());
+    SetLastReceivedAndLastCommitted(&response, request.ops(19).id());
+    queue_->ResponseFromPeer(kPeerUuid, response, &more_pending);
+  }
+
+  AppendReplicateMessagesToQueue(queue_.get(), clock_, 21, 20);
+  ConsensusRequestPB first;
+  ReplicateMsgsHolder first_refs;
+  ASSERT_OK(queue_->RequestForPeer(kPeerUuid, &first, &first_refs, &needs_remote_bootstrap));
+  ASSERT_EQ(20, first.ops_size());
+  ASSERT_EQ(21, first.ops(0).id().index());
+
+  AppendReplicateMessagesToQueue(queue_.get(), clock_, 41, 20);
+  ConsensusRequestPB second;
+  ReplicateMsgsHolder second_refs;
+  ASSERT_OK(queue_->PipelinedRequestForPeer(kPeerUuid, &second, &second_refs));
+  ASSERT_EQ(20, second.ops_size());
+  ASSERT_EQ(41, second.ops(0).id().index());
+  ASSERT_FALSE(second.has_leader_lease_duration_ms());
+  ASSERT_EQ(40, second.preceding_id().index());
+
+  // The response to the second request is processed first.
+  SetLastReceivedAndLastCommitted(&response, second.ops(19).id());
+  queue_->ResponseFromPeer(kPeerUuid, response, &more_pending, true /* pipelined */);
+  ASSERT_FALSE(more_pending);
+  SetLastReceivedAndLastCommitted(&response, first.ops(19).id());
+  queue_->ResponseFromPeer(kPeerUuid, response, &more_pending);
+  auto peer = queue_->GetTrackedPeerForTests(kPeerUuid);
+  ASSERT_EQ(60, peer.last_received.index());
+  ASSERT_EQ(61, peer.next_index);
+
+  // A pipelined request that is rejected makes the next request resend its operations.
+  AppendReplicateMessagesToQueue(queue_.get(), clock_, 61, 20);
+  ConsensusRequestPB third;
+  ReplicateMsgsHolder third_refs;
+  ASSERT_OK(queue_->PipelinedRequestForPeer(kPeerUuid, &third, &third_refs));
+  ASSERT_EQ(61, third.ops(0).id().index());
+  ConsensusRequestPB fourth;
+  ReplicateMsgsHolder fourth_refs;
+  ASSERT_OK(queue_->PipelinedRequestForPeer(kPeerUuid, &fourth, &fourth_refs));
+  ASSERT_EQ(0, fourth.ops_size());
+  queue_->ResetPipelineForPeer(kPeerUuid);
+  fourth_refs.Reset();
+  ASSERT_OK(queue_->PipelinedRequestForPeer(kPeerUuid, &fourth, &fourth_refs));
+  ASSERT_EQ(20, fourth.ops_size());
+  ASSERT_EQ(61, fourth.ops(0).id().index());
+}
+
 TEST_F(ConsensusQueueTest, TestPeersDontAckBeyondWatermarks) {
   queue_->Init(MinimumOpId());
   queue_->SetLeaderMode(MinimumOpId(), MinimumOpId().term(), BuildRaftConfigPBForTests(3));
@@ -850,5 +928,60 @@ TEST_F(ConsensusQueueTest, TestTriggerRemoteBootstrapIfTabletNotFound) {
             rb_req.source_private_addr()[0].ShortDebugString());
 }
 
+// Test that a peer is remote bootstrapped from an up to date follower in its zone when allowed.
+TEST_F(ConsensusQueueTest, TestRemoteBootstrapFromFollower) {
+  FLAGS_remote_bootstrap_from_followers = true;
+  const std::string kFollowerUuid = "peer-2";
+
+  queue_->Init(MinimumOpId());
+  auto config = BuildRaftConfigPBForTests(3);
+  for (int i = 1; i != 3; ++i) {
+    auto* cloud_info = config.mutable_peers(i)->mutable_cloud_info();
+    cloud_info->set_placement_cloud("cloud");
+    cloud_info->set_placement_region("region");
+    cloud_info->set_placement_zone("zone");
+  }
+  queue_->SetLeaderMode(MinimumOpId(), MinimumOpId().term(), config);
+  AppendReplicateMessagesToQueue(queue_.get(), clock_, 1, 100);
+  WaitForLocalPeerToAckIndex(100);
+
+  ConsensusRequestPB request;
+  ConsensusResponsePB response;
+  ReplicateMsgsHolder refs;
+  bool needs_remote_bootstrap;
+  bool more_pending = false;
+
+  // The follower has all operations.
+  queue_->TrackPeer(kFollowerUuid);
+  ASSERT_OK(queue_->RequestForPeer(kFollowerUuid, &request, &refs, &needs_remote_bootstrap));
+  response.set_responder_uuid(kFollowerUuid);
+  response.set_responder_term(14);
+  SetLastReceivedAndLastCommitted(&response, MakeOpId(14, 100), 100);
+  queue_->ResponseFromPeer(kFollowerUuid, response, &more_pending);
+
+  // The other peer does not have the tablet.
+  queue_->TrackPeer(kPeerUuid);
+  request.Clear();
+  refs.Reset();
+  ASSERT_OK(queue_->RequestForPeer(kPeerUuid, &request, &refs, &needs_remote_bootstrap));
+  response.Clear();
+  response.set_responder_uuid(kPeerUuid);
+  response.mutable_error()->set_code(tserver::TabletServerErrorPB::TABLET_NOT_FOUND);
+  StatusToPB(STATUS(NotFound, "No such tablet"), response.mutable_error()->mutable_status());
+  queue_->ResponseFromPeer(kPeerUuid, response, &more_pending);
+
+  request.Clear();
+  refs.Reset();
+  ASSERT_OK(queue_->RequestForPeer(kPeerUuid, &request, &refs, &needs_remote_bootstrap));
+  ASSERT_TRUE(needs_remote_bootstrap);
+
+  StartRemoteBootstrapRequestPB rb_req;
+  ASSERT_OK(queue_->GetRemoteBootstrapRequestForPeer(kPeerUuid, &rb_req));
+  ASSERT_EQ(kFollowerUuid, rb_req.bootstrap_peer_uuid());
+  ASSERT_EQ(config.peers(2).last_known_private_addr(0).ShortDebugString(),
+            rb_req.source_private_addr(0).ShortDebugString());
+  ASSERT_EQ("zone", rb_req.source_cloud_info().placement_zone());
+}
+
 }  // namespace consensus
 }  // namespace yb
@@ -82,6 +82,13 @@ DEFINE_int32(consensus_max_batch_size_bytes, 254_MB,
              "The maximum per-tablet RPC batch size when updating peers.");
 TAG_FLAG(consensus_max_batch_size_bytes, advanced);
 
+DEFINE_int32(consensus_max_in_flight_requests, 1,
+             "Maximum number of UpdateConsensus requests with operations that a leader keeps in "
+             "flight to a follower. The actual window adapts between 1 and this value depending "
+             "on whether the follower keeps up. 1 disables pipelining.");
+TAG_FLAG(consensus_max_in_flight_requests, advanced);
+TAG_FLAG(consensus_max_in_flight_requests, runtime);
+
 DEFINE_int32(follower_unavailable_considered_failed_sec, 300,
              "Seconds that a leader is unable to successfully heartbeat to a "
              "follower after which the follower is considered to be failed and "
@@ -99,6 +106,19 @@ DECLARE_int32(rpc_max_message_size);
 
 DEFINE_bool(propagate_safe_time, true, "Propagate safe time to read from leader to followers");
 
+DEFINE_bool(consensus_share_serialized_ops, true,
+            "Serialize each operation sent to followers once, keep it in the log cache and send "
+            "it to all followers as is, instead of serializing it again for every request.");
+TAG_FLAG(consensus_share_serialized_ops, advanced);
+TAG_FLAG(consensus_share_serialized_ops, runtime);
+
+DEFINE_bool(remote_bootstrap_from_followers, false,
+            "Let a peer remote bootstrap from an up to date follower placed at least as close to "
+            "it as the leader, preferring the same zone and then the same region, instead of from "
+            "the leader. The peer then catches up with the leader through regular replication.");
+TAG_FLAG(remote_bootstrap_from_followers, advanced);
+TAG_FLAG(remote_bootstrap_from_followers, runtime);
+
 namespace yb {
 namespace consensus {
 
@@ -117,6 +137,19 @@ METRIC_DEFINE_gauge_int64(tablet, in_progress_ops, "Leader Operations in Progres
                           "Number of operations in the leader queue ack'd by a minority of "
                           "peers.");
 
+namespace {
+
+// How close two placements are: 2 for the same zone, 1 for the same region, 0 otherwise.
+int PlacementAffinity(const CloudInfoPB& lhs, const CloudInfoPB& rhs) {
+  if (lhs.placement_cloud() != rhs.placement_cloud() ||
+      lhs.placement_region() != rhs.placement_region()) {
+    return 0;
+  }
+  return lhs.placement_zone() == rhs.placement_zone() ? 2 : 1;
+}
+
+} // namespace
+
 std::string PeerMessageQueue::TrackedPeer::ToString() const {
   return Substitute("Peer: $0, Is new: $1, Last received: $2, Next index: $3, "
                     "Last known committed idx: $4, Last exchange result: $5, "
@@ -338,6 +371,34 @@ Status PeerMessageQueue::RequestForPeer(const string& uuid,
                                         bool* needs_remote_bootstrap,
                                         RaftPeerPB::MemberType* member_type,
                                         bool* last_exchange_successful) {
+  return DoRequestForPeer(uuid, false /* pipelined */, request, msgs_holder,
+                          needs_remote_bootstrap, member_type, last_exchange_successful);
+}
+
+Status PeerMessageQueue::PipelinedRequestForPeer(const string& uuid,
+                                                 ConsensusRequestPB* request,
+                                                 ReplicateMsgsHolder* msgs_holder) {
+  bool needs_remote_bootstrap = false;
+  return DoRequestForPeer(uuid, true /* pipelined */, request, msgs_holder,
+                          &needs_remote_bootstrap, nullptr /* member_type */,
+                          nullptr /* last_exchange_successful */);
+}
+
+void PeerMessageQueue::ResetPipelineForPeer(const string& uuid) {
+  LockGuard lock(queue_lock_);
+  TrackedPeer* peer = FindPtrOrNull(peers_map_, uuid);
+  if (peer) {
+    peer->pipelined_next_index = kInvalidOpIdIndex;
+  }
+}
+
+Status PeerMessageQueue::DoRequestForPeer(const string& uuid,
+                                          bool pipelined,
+                                          ConsensusRequestPB* request,
+                                          ReplicateMsgsHolder* msgs_holder,
+                                          bool* needs_remote_bootstrap,
+                                          RaftPeerPB::MemberType* member_type,
+                                          bool* last_exchange_successful) {
   DCHECK(request->ops().empty());
 
   OpId preceding_id;
@@ -356,10 +417,22 @@ Status PeerMessageQueue::RequestForPeer(const string& uuid,
       return STATUS(NotFound, "Peer not tracked or queue not in leader mode.");
     }
 
+    // Only steady state replication is pipelined, the rest waits for the requests in flight.
+    if (pipelined && (peer->is_new || peer->needs_remote_bootstrap ||
+                      !peer->is_last_exchange_successful)) {
+      *needs_remote_bootstrap = false;
+      return Status::OK();
+    }
+
     const HybridTime now_ht = clock_->Now();
 
     is_new = peer->is_new;
-    if (!is_new) {
+    if (pipelined) {
+      // Leases are only extended by requests that are sent one at a time, so that a response is
+      // never credited with a lease sent in a request that the follower has not processed yet.
+      request->clear_leader_lease_duration_ms();
+      request->clear_ht_lease_expiration();
+    } else if (!is_new) {
       auto ht_lease_expiration_micros = now_ht.GetPhysicalValueMicros() +
                                         FLAGS_ht_lease_duration_ms * 1000;
       auto leader_lease_duration_ms = GetAtomicFlag(&FLAGS_leader_lease_duration_ms);
@@ -403,7 +476,7 @@ Status PeerMessageQueue::RequestForPeer(const string& uuid,
     if (member_type) *member_type = peer->member_type;
     if (last_exchange_successful) *last_exchange_successful = peer->is_last_exchange_successful;
     *needs_remote_bootstrap = peer->needs_remote_bootstrap;
-    next_index = peer->next_index;
+    next_index = std::max(peer->next_index, peer->pipelined_next_index);
     if (peer->member_type == RaftPeerPB::VOTER) {
       is_voter = true;
     }
@@ -438,6 +511,7 @@ Status PeerMessageQueue::RequestForPeer(const string& uuid,
     DCHECK_LT(FLAGS_consensus_max_batch_size_bytes + 1_KB, FLAGS_rpc_max_message_size);
     // The batch of messages to send to the peer.
     ReplicateMsgs messages;
+    std::vector<RefCntBuffer> serialized_ops;
     int max_batch_size = FLAGS_consensus_max_batch_size_bytes - request->ByteSize();
     bool have_more_messages = false;
 
@@ -446,7 +520,9 @@ Status PeerMessageQueue::RequestForPeer(const string& uuid,
                                   max_batch_size,
                                   &messages,
                                   &preceding_id,
-                                  &have_more_messages);
+                                  &have_more_messages,
+                                  GetAtomicFlag(&FLAGS_consensus_share_serialized_ops)
+                                      ? &serialized_ops : nullptr);
     if (PREDICT_FALSE(!s.ok())) {
       if (PREDICT_TRUE(s.IsNotFound())) {
         // It's normal to have a NotFound() here if a follower falls behind where the leader has
@@ -478,7 +554,16 @@ Status PeerMessageQueue::RequestForPeer(const string& uuid,
     for (const auto& msg : messages) {
       request->mutable_ops()->AddAllocated(msg.get());
     }
-    *msgs_holder = ReplicateMsgsHolder(request->mutable_ops(), std::move(messages));
+    if (!messages.empty() && GetAtomicFlag(&FLAGS_consensus_max_in_flight_requests) > 1) {
+      LockGuard lock(queue_lock_);
+      auto peer = FindPtrOrNull(peers_map_, uuid);
+      if (peer) {
+        peer->pipelined_next_index = std::max(
+            peer->pipelined_next_index, messages.back()->id().index() + 1);
+      }
+    }
+    *msgs_holder = ReplicateMsgsHolder(
+        request->mutable_ops(), std::move(messages), std::move(serialized_ops));
 
     if (propagated_safe_time && !have_more_messages) {
       // Get the current local safe time on the leader and propagate it to the follower.
@@ -513,6 +598,8 @@ Status PeerMessageQueue::RequestForPeer(const string& uuid,
 Status PeerMessageQueue::GetRemoteBootstrapRequestForPeer(const string& uuid,
                                                           StartRemoteBootstrapRequestPB* req) {
   TrackedPeer* peer = nullptr;
+  const RaftPeerPB* source = &local_peer_pb_;
+  RaftPeerPB follower_source;
   {
     LockGuard lock(queue_lock_);
     DCHECK_EQ(queue_state_.state, State::kQueueOpen);
@@ -521,6 +608,10 @@ Status PeerMessageQueue::GetRemoteBootstrapRequestForPeer(const string& uuid,
     if (PREDICT_FALSE(peer == nullptr || queue_state_.mode == Mode::NON_LEADER)) {
       return STATUS(NotFound, "Peer not tracked or queue not in leader mode.");
     }
+    if (FLAGS_remote_bootstrap_from_followers &&
+        SelectRemoteBootstrapSourceUnlocked(uuid, &follower_source)) {
+      source = &follower_source;
+    }
   }
 
   if (PREDICT_FALSE(!peer->needs_remote_bootstrap)) {
@@ -535,15 +626,63 @@ Status PeerMessageQueue::GetRemoteBootstrapRequestForPeer(const string& uuid,
   req->Clear();
   req->set_dest_uuid(uuid);
   req->set_tablet_id(tablet_id_);
-  req->set_bootstrap_peer_uuid(local_peer_uuid_);
-  *req->mutable_source_private_addr() = local_peer_pb_.last_known_private_addr();
-  *req->mutable_source_broadcast_addr() = local_peer_pb_.last_known_broadcast_addr();
-  *req->mutable_source_cloud_info() = local_peer_pb_.cloud_info();
+  req->set_bootstrap_peer_uuid(source->permanent_uuid());
+  *req->mutable_source_private_addr() = source->last_known_private_addr();
+  *req->mutable_source_broadcast_addr() = source->last_known_broadcast_addr();
+  *req->mutable_source_cloud_info() = source->cloud_info();
   req->set_caller_term(queue_state_.current_term);
   peer->needs_remote_bootstrap = false; // Now reset the flag.
   return Status::OK();
 }
 
+bool PeerMessageQueue::SelectRemoteBootstrapSourceUnlocked(
+    const std::string& uuid, RaftPeerPB* source) const {
+  RaftPeerPB target;
+  if (!queue_state_.active_config ||
+      !GetRaftConfigMember(*queue_state_.active_config, uuid, &target).ok()) {
+    return false;
+  }
+
+  // A follower placed at least as close to the target as the leader is preferred, to take the load
+  // of the copy off the leader, the closest and then the most up to date one.
+  const int leader_affinity = PlacementAffinity(local_peer_pb_.cloud_info(), target.cloud_info());
+  const RaftPeerPB* best = nullptr;
+  int best_affinity = 0;
+  int64_t best_last_received = 0;
+  for (const RaftPeerPB& peer_pb : queue_state_.active_config->peers()) {
+    if (peer_pb.permanent_uuid() == uuid || peer_pb.permanent_uuid() == local_peer_uuid_ ||
+        (peer_pb.member_type() != RaftPeerPB::VOTER &&
+         peer_pb.member_type() != RaftPeerPB::OBSERVER)) {
+      continue;
+    }
+    const TrackedPeer* candidate = FindPtrOrNull(peers_map_, peer_pb.permanent_uuid());
+    // The follower should be healthy and have all operations replicated to a majority, so that the
+    // target could catch up from the leader's log after copying the follower's checkpoint.
+    if (candidate == nullptr || !candidate->is_last_exchange_successful ||
+        candidate->needs_remote_bootstrap ||
+        candidate->last_received.index() < queue_state_.majority_replicated_opid.index()) {
+      continue;
+    }
+    const int affinity = PlacementAffinity(peer_pb.cloud_info(), target.cloud_info());
+    if (affinity < leader_affinity) {
+      continue;
+    }
+    if (best == nullptr || affinity > best_affinity ||
+        (affinity == best_affinity && candidate->last_received.index() > best_last_received)) {
+      best_affinity = affinity;
+      best = &peer_pb;
+      best_last_received = candidate->last_received.index();
+    }
+  }
+  if (best == nullptr) {
+    return false;
+  }
+  LOG_WITH_PREFIX_UNLOCKED(INFO) << "Remote bootstrapping peer " << uuid << " from follower "
+                                 << best->permanent_uuid();
+  *source = *best;
+  return true;
+}
+
 void PeerMessageQueue::UpdateAllReplicatedOpId(OpId* result) {
   OpId new_op_id = MaximumOpId();
 
@@ -751,7 +890,8 @@ void PeerMessageQueue::NotifyPeerIsResponsiveDespiteError(const std::string& pee
 
 void PeerMessageQueue::ResponseFromPeer(const std::string& peer_uuid,
                                         const ConsensusResponsePB& response,
-                                        bool* more_pending) {
+                                        bool* more_pending,
+                                        bool pipelined) {
   DCHECK(response.IsInitialized()) << "Error: Uninitialized: "
       << response.InitializationErrorString() << ". Response: " << response.ShortDebugString();
 
@@ -851,8 +991,18 @@ void PeerMessageQueue::ResponseFromPeer(const std::string& peer_uuid,
       peer->next_index = peer->last_known_committed_idx + 1;
     }
 
+    // With pipelining, responses could be processed out of order, so a response to an earlier
+    // request must not move the peer back.
+    if (peer->pipelined_next_index != kInvalidOpIdIndex && !status.has_error() &&
+        OpIdLessThan(peer->last_received, previous.last_received)) {
+      peer->last_received = previous.last_received;
+      peer->next_index = previous.next_index;
+    }
+
     if (PREDICT_FALSE(status.has_error())) {
       peer->is_last_exchange_successful = false;
+      // Operations in flight could not be appended by the peer, resend them from next_index.
+      peer->pipelined_next_index = kInvalidOpIdIndex;
       switch (status.error().code()) {
         case ConsensusErrorPB::PRECEDING_ENTRY_DIDNT_MATCH: {
           DCHECK(status.has_last_received());
@@ -916,11 +1066,14 @@ void PeerMessageQueue::ResponseFromPeer(const std::string& peer_uuid,
       }
       majority_replicated.op_id = queue_state_.majority_replicated_opid;
 
-      peer->last_leader_lease_expiration_received_by_follower =
-          peer->last_leader_lease_expiration_sent_to_follower;
+      // Pipelined requests do not carry leases, see DoRequestForPeer.
+      if (!pipelined) {
+        peer->last_leader_lease_expiration_received_by_follower =
+            peer->last_leader_lease_expiration_sent_to_follower;
 
-      peer->last_ht_lease_expiration_received_by_follower =
-          peer->last_ht_lease_expiration_sent_to_follower;
+        peer->last_ht_lease_expiration_received_by_follower =
+            peer->last_ht_lease_expiration_sent_to_follower;
+      }
 
       majority_replicated.leader_lease_expiration = LeaderLeaseExpirationWatermark();
 
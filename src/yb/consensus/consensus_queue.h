@@ -113,6 +113,12 @@ class PeerMessageQueue {
     // Next index to send to the peer.  This corresponds to "nextIndex" as specified in Raft.
     int64_t next_index = kInvalidOpIdIndex;
 
+    // Index following the last operation sent to the peer, when several requests could be in
+    // flight, see FLAGS_consensus_max_in_flight_requests. Requests start from it when it is ahead
+    // of next_index, so that operations in flight are not sent again. Reset after a failed
+    // exchange, so that replication restarts from next_index.
+    int64_t pipelined_next_index = kInvalidOpIdIndex;
+
     // The last operation that we've sent to this peer and that it acked. Used for watermark
     // movement.
     OpId last_received;
@@ -244,6 +250,20 @@ class PeerMessageQueue {
       RaftPeerPB::MemberType* member_type = nullptr,
       bool* last_exchange_successful = nullptr);
 
+  // Fills 'request' with the operations that follow those sent to the peer in requests that are
+  // still in flight, so that it could be sent before their responses are received. Leaves
+  // 'request' without operations if there is nothing to send or the peer is not in a steady
+  // state, i.e. it is new, needs remote bootstrap or the last exchange with it failed. Unlike
+  // requests returned by RequestForPeer() it does not extend leader leases.
+  CHECKED_STATUS PipelinedRequestForPeer(
+      const std::string& uuid,
+      ConsensusRequestPB* request,
+      ReplicateMsgsHolder* msgs_holder);
+
+  // Makes the next requests to the peer start from its next index, after a request to it failed
+  // while other requests could be in flight.
+  void ResetPipelineForPeer(const std::string& uuid);
+
   // Fill in a StartRemoteBootstrapRequest for the specified peer.  If that peer should not remotely
   // bootstrap, returns a non-OK status.  On success, also internally resets
   // peer->needs_remote_bootstrap to false.
@@ -257,10 +277,12 @@ class PeerMessageQueue {
   void NotifyPeerIsResponsiveDespiteError(const std::string& peer_uuid);
 
   // Updates the request queue with the latest response of a peer, returns whether this peer has
-  // more requests pending.
+  // more requests pending. 'pipelined' should be true if the response is to a request returned
+  // by PipelinedRequestForPeer().
   virtual void ResponseFromPeer(const std::string& peer_uuid,
                                 const ConsensusResponsePB& response,
-                                bool* more_pending);
+                                bool* more_pending,
+                                bool pipelined = false);
 
   // Closes the queue, peers are still allowed to call UntrackPeer() and ResponseFromPeer() but no
   // additional peers can be tracked or messages queued.
@@ -316,6 +338,15 @@ class PeerMessageQueue {
  private:
   FRIEND_TEST(ConsensusQueueTest, TestQueueAdvancesCommittedIndex);
 
+  CHECKED_STATUS DoRequestForPeer(
+      const std::string& uuid,
+      bool pipelined,
+      ConsensusRequestPB* request,
+      ReplicateMsgsHolder* msgs_holder,
+      bool* needs_remote_bootstrap,
+      RaftPeerPB::MemberType* member_type,
+      bool* last_exchange_successful);
+
   // Mode specifies how the queue currently behaves:
   //
   // LEADER - Means the queue tracks remote peers and replicates whatever messages are appended.
@@ -413,6 +444,10 @@ class PeerMessageQueue {
 
   TrackedPeer* TrackPeerUnlocked(const std::string& uuid);
 
+  // Picks an up to date follower placed at least as close to the peer with the given uuid as the
+  // local peer, to remote bootstrap it from. Returns false when there is none.
+  bool SelectRemoteBootstrapSourceUnlocked(const std::string& uuid, RaftPeerPB* source) const;
+
   // Checks that if the queue is in LEADER mode then all registered peers are in the active config.
   // Crashes with a FATAL log message if this invariant does not hold. If the queue is in NON_LEADER
   // mode, does nothing.
@@ -53,6 +53,11 @@ class ReplicaOperationFactory {
       const ConsensusRoundPtr& context, HybridTime propagated_safe_time) = 0;
   virtual void SetPropagatedSafeTime(HybridTime ht) = 0;
 
+  // Called before and after consecutive replicated write operations are applied by the current
+  // thread, so that their changes could be written to storage together.
+  virtual void StartApplyGroup() {}
+  virtual void FinishApplyGroup() {}
+
   virtual ~ReplicaOperationFactory() {}
 };
 
@@ -56,6 +56,10 @@ DECLARE_bool(never_fsync);
 DECLARE_bool(writable_file_use_fsync);
 DECLARE_int32(o_direct_block_alignment_bytes);
 DECLARE_int32(o_direct_block_size_bytes);
+DECLARE_bool(log_compress_entry_batches);
+DECLARE_int32(log_compress_entry_batches_min_bytes);
+DECLARE_bool(log_prezero_preallocated_segments);
+DECLARE_bool(log_mmap_closed_segments);
 
 namespace yb {
 namespace log {
@@ -207,6 +211,85 @@ TEST_F(LogTest, TestMultipleEntriesInABatch) {
   ASSERT_OK(log_->Close());
 }
 
+TEST_F(LogTest, TestPrezeroedSegments) {
+  FLAGS_log_prezero_preallocated_segments = true;
+  options_.preallocate_segments = true;
+  BuildLog();
+
+  OpId opid;
+  opid.set_term(1);
+  opid.set_index(1);
+  ASSERT_OK(AppendNoOpsToLogSync(clock_, log_.get(), &opid, 10));
+  ASSERT_OK(log_->AllocateSegmentAndRollOver());
+  ASSERT_OK(AppendNoOpsToLogSync(clock_, log_.get(), &opid, 10));
+  ASSERT_OK(log_->Close());
+
+  SegmentSequence segments;
+  ASSERT_OK(log_->GetLogReader()->GetSegmentsSnapshot(&segments));
+  ASSERT_EQ(2, segments.size());
+  for (const auto& segment : segments) {
+    auto read_entries = segment->ReadEntries();
+    ASSERT_OK(read_entries.status);
+    ASSERT_EQ(10, read_entries.entries.size());
+  }
+}
+
+TEST_F(LogTest, TestReadMappedSegments) {
+  FLAGS_log_mmap_closed_segments = true;
+  BuildLog();
+
+  OpId opid;
+  opid.set_term(1);
+  opid.set_index(1);
+  ASSERT_OK(AppendNoOpsToLogSync(clock_, log_.get(), &opid, 10));
+  ASSERT_OK(log_->AllocateSegmentAndRollOver());
+  ASSERT_OK(AppendNoOpsToLogSync(clock_, log_.get(), &opid, 10));
+
+  SegmentSequence segments;
+  ASSERT_OK(log_->GetLogReader()->GetSegmentsSnapshot(&segments));
+  ASSERT_EQ(2, segments.size());
+  // Only the closed segment is mapped.
+  ASSERT_NE(nullptr, segments[0]->mapped_data_);
+  ASSERT_EQ(nullptr, segments[1]->mapped_data_);
+
+  ReplicateMsgs replicates;
+  ASSERT_OK(log_->GetLogReader()->ReadReplicatesInRange(
+      1, 20, LogReader::kNoSizeLimit, &replicates));
+  ASSERT_EQ(20, replicates.size());
+  for (int i = 0; i != 20; ++i) {
+    ASSERT_EQ(i + 1, replicates[i]->id().index());
+  }
+  ASSERT_OK(log_->Close());
+}
+
+TEST_F(LogTest, TestCompressedEntryBatches) {
+  FLAGS_log_compress_entry_batches = true;
+  FLAGS_log_compress_entry_batches_min_bytes = 0;
+  BuildLog();
+
+  OpId opid;
+  opid.set_term(1);
+  opid.set_index(1);
+
+  const int kNumEntries = 100;
+  int uncompressed_size = 0;
+  ASSERT_OK(AppendNoOpsToLogSync(clock_, log_.get(), &opid, kNumEntries, &uncompressed_size));
+  ASSERT_OK(log_->AllocateSegmentAndRollOver());
+
+  SegmentSequence segments;
+  ASSERT_OK(log_->GetLogReader()->GetSegmentsSnapshot(&segments));
+  ASSERT_LT(segments[0]->readable_up_to() - segments[0]->first_entry_offset(), uncompressed_size);
+
+  auto read_entries = segments[0]->ReadEntries();
+  ASSERT_OK(read_entries.status);
+  ASSERT_EQ(kNumEntries, read_entries.entries.size());
+  for (int i = 0; i != kNumEntries; ++i) {
+    ASSERT_EQ(i + 1, read_entries.entries[i]->replicate().id().index());
+  }
+
+  ASSERT_OK(log_->Close());
+}
+
 // Tests that everything works properly with fsync enabled:
 // This also tests SyncDir() (see KUDU-261), which is called whenever
 // a new log segment is initialized.
@@ -42,12 +42,14 @@
 #include "yb/consensus/log_index.h"
 #include "yb/consensus/log_metrics.h"
 #include "yb/consensus/log_reader.h"
+#include "yb/consensus/log_syncer.h"
 #include "yb/consensus/log_util.h"
 #include "yb/fs/fs_manager.h"
 #include "yb/gutil/map-util.h"
 #include "yb/gutil/ref_counted.h"
 #include "yb/gutil/stl_util.h"
 #include "yb/gutil/strings/substitute.h"
+#include "yb/gutil/strings/util.h"
 #include "yb/gutil/walltime.h"
 #include "yb/util/coding.h"
 #include "yb/util/countdown_latch.h"
@@ -73,6 +75,8 @@ using namespace yb::size_literals;  // NOLINT.
 using namespace std::literals;  // NOLINT.
 using namespace std::placeholders;
 
+DECLARE_bool(durable_wal_write_group_sync);
+
 // Log retention configuration.
 // -----------------------------
 DEFINE_int32(log_min_segments_to_retain, 2,
@@ -124,6 +128,12 @@ TAG_FLAG(log_inject_latency_ms_stddev, unsafe);
 DEFINE_int32(log_inject_append_latency_ms_max, 0,
              "The maximum latency to inject before the log append operation.");
 
+DEFINE_bool(log_prezero_preallocated_segments, false,
+            "Whether preallocated WAL segments are filled with zeros before they are used. "
+            "Appends to such segments overwrite space that is already written, so that durable "
+            "WAL writes do not update file system metadata for each batch.");
+TAG_FLAG(log_prezero_preallocated_segments, advanced);
+
 DEFINE_test_flag(bool, log_consider_all_ops_safe, false,
             "If true, we consider all operations to be safe and will not wait"
             "for the opId to apply to the local log. i.e. WaitForSafeOpIdToApply "
@@ -397,6 +407,9 @@ Status Log::Init() {
 
   if (durable_wal_write_) {
     YB_LOG_FIRST_N(INFO, 1) << "durable_wal_write is turned on.";
+    if (FLAGS_durable_wal_write_group_sync) {
+      syncer_ = LogSyncer::ForWalRoot(WalRootDir());
+    }
   } else if (interval_durable_wal_write_) {
     YB_LOG_FIRST_N(INFO, 1) << "interval_durable_wal_write_ms is turned on to sync every "
                             << interval_durable_wal_write_.ToMilliseconds() << " ms.";
@@ -679,7 +692,11 @@ Status Log::Sync() {
       periodic_sync_needed_.store(false);
       periodic_sync_unsynced_bytes_ = 0;
       LOG_SLOW_EXECUTION(WARNING, 50, "Fsync log took a long time") {
-        RETURN_NOT_OK(active_segment_->Sync());
+        if (durable_wal_write_ && syncer_) {
+          RETURN_NOT_OK(syncer_->Sync([this] { return active_segment_->Sync(); }));
+        } else {
+          RETURN_NOT_OK(active_segment_->Sync());
+        }
       }
     }
   }
@@ -696,6 +713,15 @@ Status Log::Sync() {
   return Status::OK();
 }
 
+std::string Log::WalRootDir() const {
+  for (const auto& wal_root : fs_manager_->GetWalRootDirs()) {
+    if (HasPrefixString(log_dir_, wal_root)) {
+      return wal_root;
+    }
+  }
+  return DirName(DirName(log_dir_));
+}
+
 Status Log::GetSegmentsToGCUnlocked(int64_t min_op_idx, SegmentSequence* segments_to_gc) const {
   // Find the prefix of segments in the segment sequence that is guaranteed not to include
   // 'min_op_idx'.
@@ -977,9 +1003,10 @@ Status Log::PreAllocateNewSegment() {
   if (options_.preallocate_segments) {
     uint64_t next_segment_size = NextSegmentDesiredSize();
     TRACE("Preallocating $0 byte segment in $1", next_segment_size, next_segment_path_);
-    // TODO (perf) zero the new segments -- this could result in additional performance
-    // improvements.
     RETURN_NOT_OK(next_segment_file_->PreAllocate(next_segment_size));
+    if (FLAGS_log_prezero_preallocated_segments) {
+      RETURN_NOT_OK(ZeroPlaceholderSegment(next_segment_path_, next_segment_size));
+    }
   }
 
   {
@@ -1087,6 +1114,22 @@ Status Log::CreatePlaceholderSegment(const WritableFileOptions& opts,
   return Status::OK();
 }
 
+Status Log::ZeroPlaceholderSegment(const std::string& path, uint64_t size) {
+  TRACE_EVENT1("log", "ZeroPlaceholderSegment", "file", path);
+  RWFileOptions opts;
+  opts.mode = Env::OPEN_EXISTING;
+  gscoped_ptr<RWFile> file;
+  RETURN_NOT_OK(fs_manager_->env()->NewRWFile(opts, path, &file));
+
+  const std::string zeros(1_MB, '\0');
+  for (uint64_t offset = 0; offset < size; offset += zeros.size()) {
+    RETURN_NOT_OK(file->Write(offset, Slice(zeros.data(), std::min<uint64_t>(
+        zeros.size(), size - offset))));
+  }
+  RETURN_NOT_OK(file->Sync());
+  return file->Close();
+}
+
 Status Log::TEST_SubmitFuncToAppendToken(const std::function<void()>& func) {
   return appender_->TEST_SubmitFunc(func);
 }
@@ -68,6 +68,7 @@ struct LogMetrics;
 class LogEntryBatch;
 class LogIndex;
 class LogReader;
+class LogSyncer;
 
 // Log interface, inspired by Raft's (logcabin) Log. Provides durability to YugaByte as a normal
 // Write Ahead Log and also plays the role of persistent storage for the consensus state machine.
@@ -302,6 +303,10 @@ class Log : public RefCountedThreadSafe<Log> {
   // Preallocates the space for a new segment.
   CHECKED_STATUS PreAllocateNewSegment();
 
+  // Overwrites the first size bytes of the placeholder segment at path with zeros and syncs them,
+  // so that appends to the segment do not have to convert unwritten extents.
+  CHECKED_STATUS ZeroPlaceholderSegment(const std::string& path, uint64_t size);
+
   // Returns the desired size for the next log segment to be created.
   uint64_t NextSegmentDesiredSize();
 
@@ -326,6 +331,9 @@ class Log : public RefCountedThreadSafe<Log> {
 
   CHECKED_STATUS Sync();
 
+  // Returns the WAL root directory containing this log, which identifies its disk.
+  std::string WalRootDir() const;
+
   // Helper method to get the segment sequence to GC based on the provided min_op_idx.
   CHECKED_STATUS GetSegmentsToGCUnlocked(int64_t min_op_idx, SegmentSequence* segments_to_gc) const;
 
@@ -409,6 +417,10 @@ class Log : public RefCountedThreadSafe<Log> {
   // If true, sync on all appends.
   bool durable_wal_write_;
 
+  // If not null, syncs on appends are group-committed with the logs of the other tablets having
+  // their WAL on the same disk.
+  LogSyncer* syncer_ = nullptr;
+
   // If non-zero, sync every interval of time.
   MonoDelta interval_durable_wal_write_;
 
@@ -51,6 +51,7 @@
 #include "yb/util/mem_tracker.h"
 #include "yb/util/metrics.h"
 #include "yb/util/monotime.h"
+#include "yb/util/size_literals.h"
 #include "yb/util/test_util.h"
 
 using std::atomic;
@@ -66,6 +67,7 @@ using std::atomic;
 using std::vector;
 using std::thread;
 using namespace std::chrono_literals;
+using namespace yb::size_literals;
 
 namespace yb {
 namespace consensus {
@@ -123,13 +125,17 @@ class LogCacheTest : public YBTest {
   Status AppendReplicateMessagesToCache(
       int first,
       int count,
-      int payload_size = 0) {
+      int payload_size = 0,
+      LogCache* cache = nullptr) {
+    if (!cache) {
+      cache = cache_.get();
+    }
 
     for (int i = first; i < first + count; i++) {
       int term = i / 7;
       int index = i;
       ReplicateMsgs msgs = { CreateDummyReplicate(term, index, clock_->Now(), payload_size) };
-      RETURN_NOT_OK(cache_->AppendOperations(
+      RETURN_NOT_OK(cache->AppendOperations(
           msgs, yb::OpId() /* committed_op_id */, RestartSafeCoarseMonoClock().Now(),
           Bind(&FatalOnError)));
     }
@@ -186,6 +192,40 @@ TEST_F(LogCacheTest, TestAppendAndGetMessages) {
   EXPECT_EQ("3.21", OpIdToString(messages[0]->id()));
 }
 
+TEST_F(LogCacheTest, TestSerializedOps) {
+  ASSERT_OK(AppendReplicateMessagesToCache(1, 10));
+  ASSERT_OK(log_->WaitUntilAllFlushed());
+  auto size_before_read = cache_->metrics_.log_cache_size->value();
+
+  ReplicateMsgs messages;
+  std::vector<RefCntBuffer> serialized_ops;
+  OpId preceding;
+  ASSERT_OK(cache_->ReadOps(0, 8_MB, &messages, &preceding, nullptr, &serialized_ops));
+  ASSERT_EQ(10, messages.size());
+  ASSERT_EQ(10, serialized_ops.size());
+  ASSERT_GT(cache_->metrics_.log_cache_size->value(), size_before_read);
+
+  // The concatenated ops are a valid encoding of a request holding them.
+  std::string encoded;
+  for (const auto& op : serialized_ops) {
+    encoded.append(op.data(), op.size());
+  }
+  ConsensusRequestPB request;
+  ASSERT_TRUE(request.ParsePartialFromString(encoded));
+  ASSERT_EQ(10, request.ops_size());
+  for (int i = 0; i != 10; ++i) {
+    ASSERT_EQ(messages[i]->SerializeAsString(), request.ops(i).SerializeAsString());
+  }
+
+  // Later reads share the same encoding.
+  ReplicateMsgs other_messages;
+  std::vector<RefCntBuffer> other_serialized_ops;
+  ASSERT_OK(cache_->ReadOps(5, 8_MB, &other_messages, &preceding, nullptr, &other_serialized_ops));
+  ASSERT_EQ(5, other_serialized_ops.size());
+  for (int i = 0; i != 5; ++i) {
+    ASSERT_EQ(serialized_ops[i + 5].data(), other_serialized_ops[i].data());
+  }
+}
 
 // Ensure that the cache always yields at least one message,
 // even if that message is larger than the batch size. This ensures
@@ -319,6 +359,51 @@ TEST_F(LogCacheTest, TestGlobalMemoryLimit) {
   ASSERT_LE(cache_->BytesUsed(), 1024 * 1024);
 }
 
+// Test that the cache of another tablet that was not read recently is evicted when the global
+// limit is reached.
+TEST_F(LogCacheTest, TestGlobalEvictionAcrossTablets) {
+  FLAGS_global_log_cache_size_limit_mb = 4;
+  const int kPayloadSize = 768 * 1024;
+  const std::string kOtherTablet = "other-tablet";
+
+  scoped_refptr<log::Log> other_log;
+  ASSERT_OK(log::Log::Open(log::LogOptions(),
+                           fs_manager_.get(),
+                           kOtherTablet,
+                           fs_manager_->GetFirstTabletWalDirOrDie(kTestTable, kOtherTablet),
+                           schema_,
+                           0, // schema_version
+                           nullptr,
+                           append_pool_.get(),
+                           &other_log));
+  LogCache other_cache(METRIC_ENTITY_tablet.Instantiate(&metric_registry_, "OtherTablet"),
+                       other_log.get(), nullptr /* mem_tracker */, kPeerUuid, kOtherTablet);
+  other_cache.Init(MinimumOpId());
+  ASSERT_OK(AppendReplicateMessagesToCache(1, 3, kPayloadSize, &other_cache));
+  ASSERT_OK(other_log->WaitUntilAllFlushed());
+  ASSERT_EQ(3, other_cache.num_cached_ops());
+
+  CloseAndReopenCache(MinimumOpId());
+  ReplicateMsgs messages;
+  OpId preceding;
+  ASSERT_OK(cache_->ReadOps(0, 8_MB, &messages, &preceding));
+
+  // Appending to this tablet goes over the global limit, so the idle cache is evicted.
+  ASSERT_OK(AppendReplicateMessagesToCache(1, 3, kPayloadSize));
+  ASSERT_OK(log_->WaitUntilAllFlushed());
+  ASSERT_EQ(3, cache_->num_cached_ops());
+  ASSERT_LT(other_cache.num_cached_ops(), 3);
+
+  // The evicted operations are read from disk.
+  messages.clear();
+  ASSERT_OK(other_cache.ReadOps(0, 8_MB, &messages, &preceding));
+  ASSERT_EQ(3, messages.size());
+  ASSERT_EQ(3 - other_cache.num_cached_ops(),
+            other_cache.metrics_.log_cache_op_misses_evicted->value());
+  ASSERT_EQ(other_cache.num_cached_ops(), other_cache.metrics_.log_cache_op_hits->value());
+  ASSERT_EQ(0, other_cache.metrics_.log_cache_op_misses_not_cached->value());
+}
+
 // Test that the log cache properly replaces messages when an index
 // is reused. This is a regression test for a bug where the memtracker's
 // consumption wasn't properly managed when messages were replaced.
@@ -35,6 +35,8 @@
 #include <algorithm>
 #include <map>
 #include <mutex>
+#include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 #include <gflags/gflags.h>
@@ -67,7 +69,8 @@ TAG_FLAG(log_cache_size_limit_mb, advanced);
 
 DEFINE_int32(global_log_cache_size_limit_mb, 1024,
              "Server-wide version of 'log_cache_size_limit_mb'. The total memory used for "
-             "caching log entries across all tablets is kept under this threshold.");
+             "caching log entries across all tablets is kept under this threshold, evicting "
+             "first from the tablets whose log cache was not read recently.");
 TAG_FLAG(global_log_cache_size_limit_mb, advanced);
 
 using strings::Substitute;
@@ -81,6 +84,21 @@ METRIC_DEFINE_gauge_int64(tablet, log_cache_num_ops, "Log Cache Operation Count"
 METRIC_DEFINE_gauge_int64(tablet, log_cache_size, "Log Cache Memory Usage",
                           MetricUnit::kBytes,
                           "Amount of memory in use for caching the local log.");
+METRIC_DEFINE_counter(tablet, log_cache_op_hits, "Log Cache Hits",
+                      MetricUnit::kOperations,
+                      "Number of operations read from the log cache.");
+METRIC_DEFINE_counter(tablet, log_cache_op_misses_not_cached, "Log Cache Misses Not Cached",
+                      MetricUnit::kOperations,
+                      "Number of operations read from disk because they were logged before the "
+                      "log cache was initialized, e.g. before a restart.");
+METRIC_DEFINE_counter(tablet, log_cache_op_misses_replicated, "Log Cache Misses Replicated",
+                      MetricUnit::kOperations,
+                      "Number of operations read from disk because they were evicted after "
+                      "being replicated to all peers, e.g. for a new peer.");
+METRIC_DEFINE_counter(tablet, log_cache_op_misses_evicted, "Log Cache Misses Evicted",
+                      MetricUnit::kOperations,
+                      "Number of operations read from disk because they were evicted under "
+                      "memory pressure.");
 
 namespace {
 
@@ -88,6 +106,68 @@ const std::string kParentMemTrackerId = "log_cache"s;
 
 }
 
+// Frees memory from the log caches of all the tablets, when the global log cache limit or the
+// server memory limit is reached. The caches that were not read recently are evicted first: their
+// followers are either caught up, so the entries will not be read again, or lag too much to be
+// served from memory soon.
+class LogCache::GlobalCollector : public GarbageCollector {
+ public:
+  // Returns the collector of the log caches under parent_tracker, creating it if needed.
+  static std::shared_ptr<GlobalCollector> Get(const MemTrackerPtr& parent_tracker) {
+    static std::mutex mutex;
+    static auto* collectors =
+        new std::unordered_map<MemTracker*, std::weak_ptr<GlobalCollector>>();
+
+    std::lock_guard<std::mutex> lock(mutex);
+    auto& weak_collector = (*collectors)[parent_tracker.get()];
+    auto result = weak_collector.lock();
+    if (!result) {
+      result = std::make_shared<GlobalCollector>();
+      weak_collector = result;
+      parent_tracker->AddGarbageCollector(result);
+      if (parent_tracker->parent()) {
+        // Also give memory back when the server is under memory pressure.
+        parent_tracker->parent()->AddGarbageCollector(result);
+      }
+    }
+    return result;
+  }
+
+  void Register(LogCache* cache) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    caches_.insert(cache);
+  }
+
+  void Unregister(LogCache* cache) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    caches_.erase(cache);
+  }
+
+  void CollectGarbage(size_t required) override {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::vector<std::pair<CoarseTimePoint, LogCache*>> caches;
+    caches.reserve(caches_.size());
+    for (auto* cache : caches_) {
+      caches.emplace_back(cache->last_read_time_.load(std::memory_order_acquire), cache);
+    }
+    std::sort(caches.begin(), caches.end());
+
+    size_t evicted = 0;
+    for (const auto& time_and_cache : caches) {
+      if (evicted >= required) {
+        break;
+      }
+      evicted += time_and_cache.second->TryEvictForMemoryPressure(
+          std::min<size_t>(required - evicted, std::numeric_limits<int64_t>::max()));
+    }
+    VLOG(1) << "Evicted " << evicted << " bytes from " << caches.size() << " log caches";
+  }
+
+ private:
+  std::mutex mutex_;
+  std::unordered_set<LogCache*> caches_;
+};
+
 typedef vector<const ReplicateMsg*>::const_iterator MsgIter;
 
 LogCache::LogCache(const scoped_refptr<MetricEntity>& metric_entity,
@@ -100,6 +180,7 @@ LogCache::LogCache(const scoped_refptr<MetricEntity>& metric_entity,
     tablet_id_(tablet_id),
     next_sequential_op_index_(0),
     min_pinned_op_index_(0),
+    last_read_time_(CoarseMonoClock::Now()),
     metrics_(metric_entity) {
 
   const int64_t max_ops_size_bytes = FLAGS_log_cache_size_limit_mb * 1_MB;
@@ -117,6 +198,9 @@ LogCache::LogCache(const scoped_refptr<MetricEntity>& metric_entity,
       AddToParent::kTrue, CreateMetrics::kFalse);
   tracker_->SetMetricEntity(metric_entity, kParentMemTrackerId);
 
+  global_collector_ = GlobalCollector::Get(parent_tracker_);
+  global_collector_->Register(this);
+
   // Put a fake message at index 0, since this simplifies a lot of our code paths elsewhere.
   auto zero_op = std::make_shared<ReplicateMsg>();
   *zero_op->mutable_id() = MinimumOpId();
@@ -124,6 +208,7 @@ LogCache::LogCache(const scoped_refptr<MetricEntity>& metric_entity,
 }
 
 LogCache::~LogCache() {
+  global_collector_->Unregister(this);
   tracker_->Release(tracker_->consumption());
   cache_.clear();
 
@@ -135,6 +220,7 @@ void LogCache::Init(const OpId& preceding_op) {
   CHECK_EQ(cache_.size(), 1) << "Cache should have only our special '0' op";
   next_sequential_op_index_ = preceding_op.index() + 1;
   min_pinned_op_index_ = next_sequential_op_index_;
+  init_op_index_ = next_sequential_op_index_;
 }
 
 Result<LogCache::PrepareAppendResult> LogCache::PrepareAppendOperations(const ReplicateMsgs& msgs) {
@@ -169,7 +255,8 @@ Result<LogCache::PrepareAppendResult> LogCache::PrepareAppendOperations(const Re
     }
   }
 
-  // Try to consume the memory. If it can't be consumed, we may need to evict.
+  // Try to consume the memory. If it can't be consumed, we may need to evict. When the global limit
+  // is reached, TryConsume first evicts from the caches of other tablets.
   if (!tracker_->TryConsume(result.mem_required)) {
     int spare = tracker_->SpareCapacity();
     int need_to_free = result.mem_required - spare;
@@ -179,13 +266,10 @@ Result<LogCache::PrepareAppendResult> LogCache::PrepareAppendOperations(const Re
                         << HumanReadableNumBytes::ToString(spare)
                         << "): attempting to evict some operations...";
 
-    // TODO: we should also try to evict from other tablets - probably better to evict really old
-    // ops from another tablet than evict recent ops from this one.
     EvictSomeUnlocked(min_pinned_op_index_, need_to_free);
 
     // Force consuming, so that we don't refuse appending data. We might blow past our limit a
-    // little bit (as much as the number of tablets times the amount of in-flight data in the log),
-    // but until implementing the above TODO, it's difficult to solve this issue.
+    // little bit, as much as the amount of pinned and in-use data in the caches.
     tracker_->Consume(result.mem_required);
 
     result.borrowed_memory = parent_tracker_->LimitExceeded();
@@ -287,13 +371,31 @@ int64_t TotalByteSizeForMessage(const ReplicateMsg& msg) {
   return msg_size;
 }
 
+// Encodes msg as an element of ConsensusRequestPB::ops, i.e. prefixed by the field tag and length.
+RefCntBuffer SerializeAsRequestOp(const ReplicateMsg& msg) {
+  using google::protobuf::internal::WireFormatLite;
+  using google::protobuf::io::CodedOutputStream;
+
+  const uint32_t tag = WireFormatLite::MakeTag(
+      ConsensusRequestPB::kOpsFieldNumber, WireFormatLite::WIRETYPE_LENGTH_DELIMITED);
+  const int size = msg.ByteSize();
+  RefCntBuffer result(
+      CodedOutputStream::VarintSize32(tag) + CodedOutputStream::VarintSize32(size) + size);
+  uint8_t* dst = CodedOutputStream::WriteTagToArray(tag, result.udata());
+  dst = CodedOutputStream::WriteVarint32ToArray(size, dst);
+  dst = msg.SerializeWithCachedSizesToArray(dst);
+  DCHECK_EQ(dst, result.uend());
+  return result;
+}
+
 } // anonymous namespace
 
 Status LogCache::ReadOps(int64_t after_op_index,
                          int max_size_bytes,
                          ReplicateMsgs* messages,
                          OpId* preceding_op,
-                         bool* have_more_messages) {
+                         bool* have_more_messages,
+                         std::vector<RefCntBuffer>* serialized_ops) {
   DCHECK_ONLY_NOTNULL(messages);
   DCHECK_ONLY_NOTNULL(preceding_op);
   DCHECK_GE(after_op_index, 0);
@@ -302,6 +404,7 @@ Status LogCache::ReadOps(int64_t after_op_index,
     *have_more_messages = false;
   }
 
+  last_read_time_.store(CoarseMonoClock::Now(), std::memory_order_release);
   std::unique_lock<simple_spinlock> l(lock_);
   int64_t next_index = after_op_index + 1;
 
@@ -337,7 +440,17 @@ Status LogCache::ReadOps(int64_t after_op_index,
 
         remaining_space -= TotalByteSizeForMessage(*msg);
         if (remaining_space > 0 || messages->empty()) {
+          if (next_index < init_op_index_) {
+            metrics_.log_cache_op_misses_not_cached->Increment();
+          } else if (next_index <= evicted_through_op_index_) {
+            metrics_.log_cache_op_misses_replicated->Increment();
+          } else {
+            metrics_.log_cache_op_misses_evicted->Increment();
+          }
           messages->push_back(msg);
+          if (serialized_ops) {
+            serialized_ops->emplace_back();
+          }
           next_index++;
         } else if (have_more_messages) {
           *have_more_messages = true;
@@ -361,22 +474,73 @@ Status LogCache::ReadOps(int64_t after_op_index,
           break;
         }
 
+        metrics_.log_cache_op_hits->Increment();
         messages->push_back(msg);
+        if (serialized_ops) {
+          serialized_ops->push_back(iter->second.serialized);
+        }
         next_index++;
       }
     }
   }
+
+  if (serialized_ops) {
+    l.unlock();
+    FillSerializedOps(*messages, serialized_ops);
+  }
   return Status::OK();
 }
 
+void LogCache::FillSerializedOps(
+    const ReplicateMsgs& messages, std::vector<RefCntBuffer>* serialized_ops) {
+  DCHECK_EQ(messages.size(), serialized_ops->size());
+  // Encode the ops outside of the lock, then keep the encoding of those that are still cached.
+  std::vector<size_t> serialized_now;
+  for (size_t i = 0; i != messages.size(); ++i) {
+    if (!(*serialized_ops)[i]) {
+      (*serialized_ops)[i] = SerializeAsRequestOp(*messages[i]);
+      serialized_now.push_back(i);
+    }
+  }
+  if (serialized_now.empty()) {
+    return;
+  }
+
+  int64_t mem_added = 0;
+  {
+    std::lock_guard<simple_spinlock> lock(lock_);
+    for (auto i : serialized_now) {
+      auto it = cache_.find(messages[i]->id().index());
+      if (it == cache_.end() || it->second.msg != messages[i] || it->second.serialized) {
+        continue;
+      }
+      it->second.serialized = (*serialized_ops)[i];
+      it->second.mem_usage += it->second.serialized.size();
+      mem_added += it->second.serialized.size();
+    }
+    tracker_->Consume(mem_added);
+  }
+  metrics_.log_cache_size->IncrementBy(mem_added);
+}
+
 
 void LogCache::EvictThroughOp(int64_t index) {
   std::lock_guard<simple_spinlock> lock(lock_);
 
+  evicted_through_op_index_ = std::max(evicted_through_op_index_, index);
   EvictSomeUnlocked(index, MathLimits<int64_t>::kMax);
 }
 
-void LogCache::EvictSomeUnlocked(int64_t stop_after_index, int64_t bytes_to_evict) {
+int64_t LogCache::TryEvictForMemoryPressure(int64_t bytes_to_evict) {
+  std::unique_lock<simple_spinlock> lock(lock_, std::try_to_lock);
+  if (!lock.owns_lock()) {
+    // The cache could be locked by the append that requires the memory.
+    return 0;
+  }
+  return EvictSomeUnlocked(min_pinned_op_index_, bytes_to_evict);
+}
+
+int64_t LogCache::EvictSomeUnlocked(int64_t stop_after_index, int64_t bytes_to_evict) {
   DCHECK(lock_.is_locked());
   VLOG_WITH_PREFIX_UNLOCKED(2) << "Evicting log cache index <= "
                       << stop_after_index
@@ -416,6 +580,7 @@ void LogCache::EvictSomeUnlocked(int64_t stop_after_index, int64_t bytes_to_evic
     }
   }
   VLOG_WITH_PREFIX_UNLOCKED(1) << "Evicting log cache: after state: " << ToStringUnlocked();
+  return bytes_evicted;
 }
 
 void LogCache::AccountForMessageRemovalUnlocked(const CacheEntry& entry) {
@@ -501,10 +666,17 @@ void LogCache::DumpToHtml(std::ostream& out) const {
 
 #define INSTANTIATE_METRIC(x) \
   x.Instantiate(metric_entity, 0)
+#define INSTANTIATE_COUNTER(x) \
+  x.Instantiate(metric_entity)
 LogCache::Metrics::Metrics(const scoped_refptr<MetricEntity>& metric_entity)
   : log_cache_num_ops(INSTANTIATE_METRIC(METRIC_log_cache_num_ops)),
-    log_cache_size(INSTANTIATE_METRIC(METRIC_log_cache_size)) {
+    log_cache_size(INSTANTIATE_METRIC(METRIC_log_cache_size)),
+    log_cache_op_hits(INSTANTIATE_COUNTER(METRIC_log_cache_op_hits)),
+    log_cache_op_misses_not_cached(INSTANTIATE_COUNTER(METRIC_log_cache_op_misses_not_cached)),
+    log_cache_op_misses_replicated(INSTANTIATE_COUNTER(METRIC_log_cache_op_misses_replicated)),
+    log_cache_op_misses_evicted(INSTANTIATE_COUNTER(METRIC_log_cache_op_misses_evicted)) {
 }
+#undef INSTANTIATE_COUNTER
 #undef INSTANTIATE_METRIC
 
 } // namespace consensus
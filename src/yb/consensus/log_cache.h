@@ -32,6 +32,7 @@
 #ifndef YB_CONSENSUS_LOG_CACHE_H
 #define YB_CONSENSUS_LOG_CACHE_H
 
+#include <atomic>
 #include <map>
 #include <memory>
 #include <string>
@@ -46,7 +47,9 @@
 #include "yb/util/async_util.h"
 #include "yb/util/locks.h"
 #include "yb/util/metrics.h"
+#include "yb/util/monotime.h"
 #include "yb/util/opid.h"
+#include "yb/util/ref_cnt_buffer.h"
 #include "yb/util/restart_safe_clock.h"
 #include "yb/util/result.h"
 
@@ -98,11 +101,16 @@ class LogCache {
   // If the ops being requested are not available in the log, this will synchronously read these ops
   // from disk. Therefore, this function may take a substantial amount of time and should not be
   // called with important locks held, etc.
+  //
+  // If serialized_ops is not null, it is filled with each of the returned ops encoded as an element
+  // of ConsensusRequestPB::ops. The encoding of a cached op is done once and kept with it, so that
+  // requests to all peers share it.
   CHECKED_STATUS ReadOps(int64_t after_op_index,
                  int max_size_bytes,
                  ReplicateMsgs* messages,
                  OpId* preceding_op,
-                 bool* have_more_messages = nullptr);
+                 bool* have_more_messages = nullptr,
+                 std::vector<RefCntBuffer>* serialized_ops = nullptr);
 
   // Append the operations into the log and the cache.  When the messages have completed writing
   // into the on-disk log, fires 'callback'.
@@ -152,21 +160,37 @@ class LogCache {
  private:
   FRIEND_TEST(LogCacheTest, TestAppendAndGetMessages);
   FRIEND_TEST(LogCacheTest, TestGlobalMemoryLimit);
+  FRIEND_TEST(LogCacheTest, TestGlobalEvictionAcrossTablets);
   FRIEND_TEST(LogCacheTest, TestReplaceMessages);
   friend class LogCacheTest;
 
+  // Evicts from the log caches of all tablets under memory pressure, see log_cache.cc.
+  class GlobalCollector;
+
   // An entry in the cache.
   struct CacheEntry {
     ReplicateMsgPtr msg;
     // The cached value of msg->SpaceUsedLong(). This method is expensive
     // to compute, so we compute it only once upon insertion.
     int64_t mem_usage;
+    // msg encoded as an element of ConsensusRequestPB::ops, created when it is first read. Its size
+    // is included into mem_usage.
+    RefCntBuffer serialized;
   };
 
+  // Fills the missing entries of serialized_ops with the encoding of the corresponding messages,
+  // and keeps it with the messages that are still in the cache.
+  void FillSerializedOps(const ReplicateMsgs& messages, std::vector<RefCntBuffer>* serialized_ops);
+
   // Try to evict the oldest operations from the queue, stopping either when
   // 'bytes_to_evict' bytes have been evicted, or the op with index
   // 'stop_after_index' has been evicted, whichever comes first.
-  void EvictSomeUnlocked(int64_t stop_after_index, int64_t bytes_to_evict);
+  // Returns the number of bytes evicted.
+  int64_t EvictSomeUnlocked(int64_t stop_after_index, int64_t bytes_to_evict);
+
+  // Evicts up to bytes_to_evict bytes of unpinned operations, unless the cache is locked, e.g.
+  // because it is being appended to. Returns the number of bytes evicted.
+  int64_t TryEvictForMemoryPressure(int64_t bytes_to_evict);
 
   // Update metrics and MemTracker to account for the removal of the
   // given message.
@@ -221,6 +245,18 @@ class LogCache {
   // log.  Protected by lock_.
   int64_t min_pinned_op_index_;
 
+  // Operations with lower indexes were logged before this cache was initialized, so they could be
+  // read only from disk.
+  int64_t init_op_index_ = 0;
+
+  // The highest index passed to EvictThroughOp, i.e. operations through it were replicated to all
+  // the peers known at the time.
+  int64_t evicted_through_op_index_ = 0;
+
+  // The last time ReadOps was called. Caches that were not read recently are evicted first under
+  // memory pressure.
+  std::atomic<CoarseTimePoint> last_read_time_;
+
   // Pointer to a parent memtracker for all log caches. This exists to compute server-wide cache
   // size and enforce a server-wide memory limit.  When the first instance of a log cache is
   // created, a new entry is added to MemTracker's static map; subsequent entries merely increment
@@ -231,6 +267,8 @@ class LogCache {
   // A MemTracker for this instance.
   std::shared_ptr<MemTracker> tracker_;
 
+  std::shared_ptr<GlobalCollector> global_collector_;
+
   struct Metrics {
     explicit Metrics(const scoped_refptr<MetricEntity>& metric_entity);
 
@@ -239,6 +277,12 @@ class LogCache {
 
     // Keeps track of the memory consumed by the cache, in bytes.
     scoped_refptr<AtomicGauge<int64_t> > log_cache_size;
+
+    // Operations read from the cache, and read from disk by reason of the miss.
+    scoped_refptr<Counter> log_cache_op_hits;
+    scoped_refptr<Counter> log_cache_op_misses_not_cached;
+    scoped_refptr<Counter> log_cache_op_misses_replicated;
+    scoped_refptr<Counter> log_cache_op_misses_evicted;
   };
   Metrics metrics_;
 
@@ -0,0 +1,78 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include <atomic>
+#include <thread>
+
+#include <gflags/gflags.h>
+#include <gtest/gtest.h>
+
+#include "yb/consensus/log_syncer.h"
+
+#include "yb/util/test_macros.h"
+#include "yb/util/test_util.h"
+
+DECLARE_int32(durable_wal_write_group_sync_window_us);
+DECLARE_int32(durable_wal_write_group_sync_max_size);
+
+namespace yb {
+namespace log {
+
+class LogSyncerTest : public YBTest {
+};
+
+TEST_F(LogSyncerTest, GroupsConcurrentSyncs) {
+  constexpr int kNumThreads = 8;
+  // A long window, so that all the syncs join the same group once it is full.
+  FLAGS_durable_wal_write_group_sync_window_us = 10000000;
+  FLAGS_durable_wal_write_group_sync_max_size = kNumThreads;
+
+  LogSyncer syncer("wal_root");
+  std::atomic<int> num_syncs(0);
+  std::atomic<int> num_done(0);
+  std::vector<std::thread> threads;
+  for (int i = 0; i != kNumThreads; ++i) {
+    threads.emplace_back([&syncer, &num_syncs, &num_done, i] {
+      auto status = syncer.Sync([&num_syncs, &num_done, i]() -> Status {
+        // No sync is done before the whole group is formed.
+        EXPECT_EQ(0, num_done.load());
+        ++num_syncs;
+        if (i == 0) {
+          return STATUS(IOError, "Sync failed");
+        }
+        return Status::OK();
+      });
+      // Each sync gets its own status.
+      if (i == 0) {
+        EXPECT_TRUE(status.IsIOError()) << status;
+      } else {
+        EXPECT_OK(status);
+      }
+      ++num_done;
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  ASSERT_EQ(kNumThreads, num_syncs.load());
+}
+
+TEST_F(LogSyncerTest, SameSyncerPerWalRoot) {
+  auto* syncer = LogSyncer::ForWalRoot("/wal1");
+  ASSERT_EQ(syncer, LogSyncer::ForWalRoot("/wal1"));
+  ASSERT_NE(syncer, LogSyncer::ForWalRoot("/wal2"));
+  ASSERT_EQ("/wal1", syncer->wal_root());
+}
+
+} // namespace log
+} // namespace yb
@@ -0,0 +1,104 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/consensus/log_syncer.h"
+
+#include <algorithm>
+#include <chrono>
+#include <unordered_map>
+
+#include <gflags/gflags.h>
+
+#include "yb/util/flag_tags.h"
+
+DEFINE_bool(durable_wal_write_group_sync, false,
+            "Whether the fsyncs of durable WAL writes of all the tablets whose WAL is on the same "
+            "disk are group-committed, so that a tablet issues at most one fsync per group.");
+TAG_FLAG(durable_wal_write_group_sync, advanced);
+
+DEFINE_int32(durable_wal_write_group_sync_window_us, 200,
+             "How long the first WAL sync of a group waits for the WAL syncs of other tablets "
+             "to join it, when durable_wal_write_group_sync is enabled.");
+TAG_FLAG(durable_wal_write_group_sync_window_us, advanced);
+TAG_FLAG(durable_wal_write_group_sync_window_us, runtime);
+
+DEFINE_int32(durable_wal_write_group_sync_max_size, 256,
+             "Maximal number of WAL syncs of a group, the group is synced right away when it "
+             "has that many.");
+TAG_FLAG(durable_wal_write_group_sync_max_size, advanced);
+TAG_FLAG(durable_wal_write_group_sync_max_size, runtime);
+
+namespace yb {
+namespace log {
+
+LogSyncer* LogSyncer::ForWalRoot(const std::string& wal_root) {
+  static std::mutex mutex;
+  static auto* syncers = new std::unordered_map<std::string, std::unique_ptr<LogSyncer>>();
+
+  std::lock_guard<std::mutex> lock(mutex);
+  auto& result = (*syncers)[wal_root];
+  if (!result) {
+    result.reset(new LogSyncer(wal_root));
+  }
+  return result.get();
+}
+
+LogSyncer::LogSyncer(std::string wal_root) : wal_root_(std::move(wal_root)) {
+}
+
+Status LogSyncer::Sync(const SyncFunction& sync) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  if (!forming_group_) {
+    forming_group_ = std::make_shared<Group>();
+  }
+  auto group = forming_group_;
+  const size_t index = group->syncs.size();
+  group->syncs.push_back(&sync);
+  const size_t max_size = std::max(FLAGS_durable_wal_write_group_sync_max_size, 1);
+
+  if (index != 0) {
+    if (group->syncs.size() >= max_size) {
+      cond_.notify_all();
+    }
+    cond_.wait(lock, [&group] { return group->done; });
+    return group->statuses[index];
+  }
+
+  // This sync is the leader of the group.
+  auto deadline = std::chrono::steady_clock::now() +
+                  std::chrono::microseconds(FLAGS_durable_wal_write_group_sync_window_us);
+  cond_.wait(lock, [this] { return !sync_in_progress_; });
+  cond_.wait_until(lock, deadline, [&group, max_size] {
+    return group->syncs.size() >= max_size;
+  });
+  sync_in_progress_ = true;
+  forming_group_ = nullptr;
+  lock.unlock();
+
+  // The syncs stay valid while their callers are waiting for the group to be done.
+  std::vector<Status> statuses;
+  statuses.reserve(group->syncs.size());
+  for (const auto* group_sync : group->syncs) {
+    statuses.push_back((*group_sync)());
+  }
+
+  lock.lock();
+  group->statuses = std::move(statuses);
+  group->done = true;
+  sync_in_progress_ = false;
+  cond_.notify_all();
+  return group->statuses[0];
+}
+
+} // namespace log
+} // namespace yb
@@ -0,0 +1,75 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#ifndef YB_CONSENSUS_LOG_SYNCER_H
+#define YB_CONSENSUS_LOG_SYNCER_H
+
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "yb/util/status.h"
+
+namespace yb {
+namespace log {
+
+// Group-commits the fsyncs of the logs of all tablets whose WAL is on the same disk.
+//
+// A log that needs its active segment to be durable calls Sync with a function doing the fsync,
+// and is blocked until that function has been executed. The first caller of a group is its
+// leader: it waits for the sync of the previous group to finish, plus up to
+// FLAGS_durable_wal_write_group_sync_window_us, while the logs of other tablets join the group.
+// Then it executes the syncs of all the logs of the group back to back and wakes them up. So a
+// tablet issues at most one fsync per group, however many batches it appended meanwhile.
+class LogSyncer {
+ public:
+  typedef std::function<Status()> SyncFunction;
+
+  // Returns the syncer shared by the logs having their WAL under wal_root. It is never destroyed.
+  static LogSyncer* ForWalRoot(const std::string& wal_root);
+
+  explicit LogSyncer(std::string wal_root);
+
+  // Executes sync as part of a group and returns its status.
+  CHECKED_STATUS Sync(const SyncFunction& sync);
+
+  const std::string& wal_root() const {
+    return wal_root_;
+  }
+
+ private:
+  struct Group {
+    std::vector<const SyncFunction*> syncs;
+    std::vector<Status> statuses;
+    bool done = false;
+  };
+
+  const std::string wal_root_;
+
+  std::mutex mutex_;
+  std::condition_variable cond_;
+
+  // Group that new syncs join, nullptr when no group is being formed.
+  std::shared_ptr<Group> forming_group_;
+
+  // Whether the leader of a group is executing its syncs.
+  bool sync_in_progress_ = false;
+};
+
+} // namespace log
+} // namespace yb
+
+#endif // YB_CONSENSUS_LOG_SYNCER_H
@@ -32,6 +32,10 @@
 
 #include "yb/consensus/log_util.h"
 
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
 #include <algorithm>
 #include <iostream>
 #include <limits>
@@ -39,6 +43,7 @@
 
 #include <gflags/gflags.h>
 #include <glog/logging.h>
+#include <lz4.h>
 
 #include "yb/consensus/opid_util.h"
 #include "yb/fs/fs_manager.h"
@@ -48,11 +53,13 @@
 #include "yb/gutil/strings/substitute.h"
 #include "yb/gutil/strings/util.h"
 
+#include "yb/util/atomic.h"
 #include "yb/util/coding-inl.h"
 #include "yb/util/coding.h"
 #include "yb/util/crc.h"
 #include "yb/util/debug/trace_event.h"
 #include "yb/util/env_util.h"
+#include "yb/util/errno.h"
 #include "yb/util/flag_tags.h"
 #include "yb/util/pb_util.h"
 #include "yb/util/size_literals.h"
@@ -87,6 +94,24 @@ DEFINE_bool(log_async_preallocate_segments, true,
             "Whether the WAL segments preallocation should happen asynchronously");
 TAG_FLAG(log_async_preallocate_segments, advanced);
 
+DEFINE_bool(log_compress_entry_batches, false,
+            "Whether WAL entry batches are LZ4 compressed. WAL segments with compressed entries "
+            "could not be read by versions not supporting it.");
+TAG_FLAG(log_compress_entry_batches, advanced);
+TAG_FLAG(log_compress_entry_batches, runtime);
+
+DEFINE_int32(log_compress_entry_batches_min_bytes, 512,
+             "Entry batches smaller than this are not compressed, even when "
+             "log_compress_entry_batches is enabled.");
+TAG_FLAG(log_compress_entry_batches_min_bytes, advanced);
+TAG_FLAG(log_compress_entry_batches_min_bytes, runtime);
+
+DEFINE_bool(log_mmap_closed_segments, false,
+            "Whether closed WAL segments are memory-mapped, so that entries read e.g. for "
+            "lagging followers are parsed in place rather than read with a pread each. "
+            "An IO error while reading a mapped segment crashes the process.");
+TAG_FLAG(log_mmap_closed_segments, advanced);
+
 DECLARE_string(fs_data_dirs);
 
 DEFINE_bool(require_durable_wal_write, false, "Whether durable WAL write is required."
@@ -121,6 +146,8 @@ const size_t kLogSegmentFooterMagicAndFooterLength  = 12;
 
 const size_t kEntryHeaderSize = 12;
 
+const uint32_t kEntryCompressedFlag = 1u << 31;
+
 const int kLogMajorVersion = 1;
 const int kLogMinorVersion = 0;
 
@@ -175,6 +202,7 @@ Status ReadableLogSegment::Init(const LogSegmentHeaderPB& header,
   first_entry_offset_ = first_entry_offset;
   is_initialized_ = true;
   readable_to_offset_.Store(file_size());
+  MaybeMapFile();
 
   return Status::OK();
 }
@@ -213,9 +241,41 @@ Status ReadableLogSegment::Init() {
 
   readable_to_offset_.Store(file_size());
 
+  if (s.ok()) {
+    MaybeMapFile();
+  }
+
   return Status::OK();
 }
 
+ReadableLogSegment::~ReadableLogSegment() {
+  if (mapped_data_) {
+    munmap(const_cast<uint8_t*>(mapped_data_), mapped_size_);
+  }
+}
+
+void ReadableLogSegment::MaybeMapFile() {
+  if (!FLAGS_log_mmap_closed_segments || file_size() <= 0) {
+    return;
+  }
+  int fd = open(path_.c_str(), O_RDONLY);
+  if (fd < 0) {
+    VLOG(1) << "Could not open " << path_ << " for mapping: " << ErrnoToString(errno);
+    return;
+  }
+  void* data = mmap(nullptr, file_size(), PROT_READ, MAP_SHARED, fd, 0);
+  int mmap_errno = errno;
+  close(fd);
+  if (data == MAP_FAILED) {
+    LOG(WARNING) << "Could not map " << path_ << ": " << ErrnoToString(mmap_errno);
+    return;
+  }
+  // Segments are mostly read sequentially, when followers catch up or during bootstrap.
+  madvise(data, file_size(), MADV_SEQUENTIAL);
+  mapped_data_ = static_cast<const uint8_t*>(data);
+  mapped_size_ = file_size();
+}
+
 const int64_t ReadableLogSegment::readable_up_to() const {
   return readable_to_offset_.Load();
 }
@@ -650,9 +710,13 @@ Status ReadableLogSegment::ReadEntryHeaderAndBatch(int64_t* offset, faststring*
 Status ReadableLogSegment::ReadEntryHeader(int64_t *offset, EntryHeader* header) {
   uint8_t scratch[kEntryHeaderSize];
   Slice slice;
-  RETURN_NOT_OK_PREPEND(ReadFully(readable_file().get(), *offset, kEntryHeaderSize,
-                                  &slice, scratch),
-                        "Could not read log entry header");
+  if (mapped_data_ && static_cast<size_t>(*offset) + kEntryHeaderSize <= mapped_size_) {
+    slice = Slice(mapped_data_ + *offset, kEntryHeaderSize);
+  } else {
+    RETURN_NOT_OK_PREPEND(ReadFully(readable_file().get(), *offset, kEntryHeaderSize,
+                                    &slice, scratch),
+                          "Could not read log entry header");
+  }
 
   RETURN_NOT_OK(DecodeEntryHeader(slice, header));
   *offset += slice.size();
@@ -662,6 +726,8 @@ Status ReadableLogSegment::ReadEntryHeader(int64_t *offset, EntryHeader* header)
 Status ReadableLogSegment::DecodeEntryHeader(const Slice& data, EntryHeader* header) {
   DCHECK_EQ(kEntryHeaderSize, data.size());
   header->msg_length = DecodeFixed32(data.data());
+  header->compressed = (header->msg_length & kEntryCompressedFlag) != 0;
+  header->msg_length &= ~kEntryCompressedFlag;
   header->msg_crc    = DecodeFixed32(data.data() + 4);
   header->header_crc = DecodeFixed32(data.data() + 8);
 
@@ -697,17 +763,22 @@ Status ReadableLogSegment::ReadEntryBatch(int64_t *offset,
                    header.msg_length, *offset, path_, limit));
   }
 
-  tmp_buf->clear();
-  tmp_buf->resize(header.msg_length);
   Slice entry_batch_slice;
-
-  Status s =  readable_file()->Read(*offset,
-                                    header.msg_length,
-                                    &entry_batch_slice,
-                                    tmp_buf->data());
-
-  if (!s.ok()) return STATUS(IOError, Substitute("Could not read entry. Cause: $0",
-                                                 s.ToString()));
+  Status s;
+  if (mapped_data_ && static_cast<size_t>(*offset) + header.msg_length <= mapped_size_) {
+    entry_batch_slice = Slice(mapped_data_ + *offset, header.msg_length);
+  } else {
+    tmp_buf->clear();
+    tmp_buf->resize(header.msg_length);
+
+    s = readable_file()->Read(*offset,
+                              header.msg_length,
+                              &entry_batch_slice,
+                              tmp_buf->data());
+
+    if (!s.ok()) return STATUS(IOError, Substitute("Could not read entry. Cause: $0",
+                                                   s.ToString()));
+  }
 
   // Verify the CRC.
   uint32_t read_crc = crc::Crc32c(entry_batch_slice.data(), entry_batch_slice.size());
@@ -719,10 +790,27 @@ Status ReadableLogSegment::ReadEntryBatch(int64_t *offset,
   }
 
 
+  Slice entry_batch_pb_slice = entry_batch_slice;
+  faststring uncompressed_buf;
+  if (header.compressed) {
+    if (PREDICT_FALSE(entry_batch_slice.size() < 4)) {
+      return STATUS_FORMAT(Corruption, "Too short compressed entry at offset $0", *offset);
+    }
+    const uint32_t uncompressed_length = DecodeFixed32(entry_batch_slice.data());
+    uncompressed_buf.resize(uncompressed_length);
+    const int size = LZ4_decompress_safe(
+        entry_batch_slice.cdata() + 4, reinterpret_cast<char*>(uncompressed_buf.data()),
+        entry_batch_slice.size() - 4, uncompressed_length);
+    if (PREDICT_FALSE(size < 0 || static_cast<uint32_t>(size) != uncompressed_length)) {
+      return STATUS_FORMAT(Corruption, "Could not decompress entry at offset $0", *offset);
+    }
+    entry_batch_pb_slice = Slice(uncompressed_buf.data(), uncompressed_length);
+  }
+
   LogEntryBatchPB read_entry_batch;
   s = pb_util::ParseFromArray(&read_entry_batch,
-                              entry_batch_slice.data(),
-                              header.msg_length);
+                              entry_batch_pb_slice.data(),
+                              entry_batch_pb_slice.size());
 
   if (!s.ok()) return STATUS(Corruption, Substitute("Could parse PB. Cause: $0",
                                                     s.ToString()));
@@ -793,13 +881,34 @@ Status WritableLogSegment::WriteFooterAndClose(const LogSegmentFooterPB& footer)
 }
 
 
-Status WritableLogSegment::WriteEntryBatch(const Slice& data) {
+Status WritableLogSegment::WriteEntryBatch(const Slice& entry_batch_data) {
   DCHECK(is_header_written_);
   DCHECK(!is_footer_written_);
   uint8_t header_buf[kEntryHeaderSize];
 
+  Slice data = entry_batch_data;
+  bool compressed = false;
+  if (GetAtomicFlag(&FLAGS_log_compress_entry_batches) &&
+      entry_batch_data.size() >=
+          static_cast<size_t>(GetAtomicFlag(&FLAGS_log_compress_entry_batches_min_bytes))) {
+    const int max_size = LZ4_compressBound(entry_batch_data.size());
+    compression_buffer_.resize(4 + max_size);
+    InlineEncodeFixed32(compression_buffer_.data(), entry_batch_data.size());
+    const int size = LZ4_compress_default(
+        entry_batch_data.cdata(), reinterpret_cast<char*>(compression_buffer_.data()) + 4,
+        entry_batch_data.size(), max_size);
+    // Keep the data uncompressed when it does not shrink.
+    if (size > 0 && 4 + static_cast<size_t>(size) < entry_batch_data.size()) {
+      data = Slice(compression_buffer_.data(), 4 + size);
+      compressed = true;
+    }
+  }
+
   // First encode the length of the message.
   uint32_t len = data.size();
+  if (compressed) {
+    len |= kEntryCompressedFlag;
+  }
   InlineEncodeFixed32(&header_buf[0], len);
 
   // Then the CRC of the message.
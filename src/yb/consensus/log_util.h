@@ -74,6 +74,10 @@ extern const char kTmpSuffix[];
 // and checksum of the other two fields (see EntryHeader struct below).
 extern const size_t kEntryHeaderSize;
 
+// Set in the length of an entry whose batch data is LZ4 compressed. Such data is prefixed by the
+// length of the uncompressed batch (4 bytes).
+extern const uint32_t kEntryCompressedFlag;
+
 extern const int kLogMajorVersion;
 extern const int kLogMinorVersion;
 
@@ -231,11 +235,15 @@ class ReadableLogSegment : public RefCountedThreadSafe<ReadableLogSegment> {
   friend class RefCountedThreadSafe<ReadableLogSegment>;
   friend class LogReader;
   FRIEND_TEST(LogTest, TestWriteAndReadToAndFromInProgressSegment);
+  FRIEND_TEST(LogTest, TestReadMappedSegments);
 
   struct EntryHeader {
     // The length of the batch data.
     uint32_t msg_length;
 
+    // Whether the batch data is compressed.
+    bool compressed;
+
     // The CRC32C of the batch data.
     uint32_t msg_crc;
 
@@ -243,7 +251,11 @@ class ReadableLogSegment : public RefCountedThreadSafe<ReadableLogSegment> {
     uint32_t header_crc;
   };
 
-  ~ReadableLogSegment() {}
+  ~ReadableLogSegment();
+
+  // Maps the file of a closed segment, so that entries are read in place from the mapping instead
+  // of with a pread and a copy each. Reads keep using the file if the mapping fails.
+  void MaybeMapFile();
 
   // Helper functions called by Init().
 
@@ -329,6 +341,10 @@ class ReadableLogSegment : public RefCountedThreadSafe<ReadableLogSegment> {
   // the offset of the first entry in the log
   int64_t first_entry_offset_;
 
+  // The read-only mapping of the file of a closed segment, or nullptr if it is not mapped.
+  const uint8_t* mapped_data_ = nullptr;
+  size_t mapped_size_ = 0;
+
   DISALLOW_COPY_AND_ASSIGN(ReadableLogSegment);
 };
 
@@ -421,6 +437,9 @@ class WritableLogSegment {
   // The offset where the last written entry ends.
   int64_t written_offset_;
 
+  // Reused to compress entry batches.
+  faststring compression_buffer_;
+
   DISALLOW_COPY_AND_ASSIGN(WritableLogSegment);
 };
 
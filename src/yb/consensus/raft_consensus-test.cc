@@ -50,8 +50,11 @@
 #include "yb/tablet/preparer.h"
 
 DECLARE_bool(enable_leader_failure_detection);
+DECLARE_int32(leader_lease_renewal_window_ms);
 
 METRIC_DECLARE_entity(tablet);
+METRIC_DECLARE_counter(leader_lease_read_waits);
+METRIC_DECLARE_counter(leader_lease_early_renewals);
 
 using std::shared_ptr;
 using std::string;
@@ -432,6 +435,61 @@ TEST_F(RaftConsensusTest, TestCommittedIndexWhenInSameTerm) {
   }
 }
 
+// Tests that reads waiting for the hybrid time leader lease make the leader send requests to
+// followers ahead of the next heartbeat, once per lease value.
+TEST_F(RaftConsensusTest, TestRenewLeaderLeaseForWaitingReads) {
+  FLAGS_leader_lease_renewal_window_ms = 500;
+  SetUpConsensus();
+  SetUpGeneralExpectations();
+  EXPECT_CALL(*peer_manager_, UpdateRaftConfig(_))
+      .Times(1);
+  EXPECT_CALL(*queue_, Init(_))
+      .Times(1);
+  EXPECT_CALL(*queue_, SetLeaderMode(_, _, _))
+      .Times(1);
+  EXPECT_CALL(*consensus_.get(), AppendNewRoundsToQueueUnlocked(_))
+      .Times(1);
+  EXPECT_CALL(*queue_, AppendOperationsMock(_, _, _, _))
+      .WillRepeatedly(Return(Status::OK()));
+
+  ConsensusBootstrapInfo info;
+  ASSERT_OK(consensus_->Start(info));
+  ASSERT_OK(consensus_->EmulateElection());
+
+  auto read_waits = metric_entity_->FindOrCreateCounter(&METRIC_leader_lease_read_waits);
+  auto early_renewals = metric_entity_->FindOrCreateCounter(&METRIC_leader_lease_early_renewals);
+  const MicrosTime kLease = 10000000;
+
+  // The lease is not replicated yet, so reads time out, but followers are only asked once.
+  EXPECT_CALL(*peer_manager_, SignalRequest(RequestTriggerMode::kAlwaysSend))
+      .Times(1);
+  for (int i = 0; i < 2; ++i) {
+    ASSERT_EQ(0, consensus_->MajorityReplicatedHtLeaseExpiration(
+        kLease, CoarseMonoClock::Now() + std::chrono::milliseconds(10)));
+  }
+  ASSERT_EQ(2, read_waits->value());
+  ASSERT_EQ(1, early_renewals->value());
+
+  OpId committed_index;
+  consensus_->UpdateMajorityReplicated(
+      { rounds_[0]->id(), CoarseTimePoint::min(), kLease }, &committed_index);
+
+  // A lease far enough past the read time is returned right away.
+  ASSERT_EQ(kLease, consensus_->MajorityReplicatedHtLeaseExpiration(
+      kLease - 1000000, CoarseTimePoint::max()));
+  ASSERT_EQ(1, early_renewals->value());
+
+  // A lease about to expire is returned right away as well, but gets extended.
+  EXPECT_CALL(*peer_manager_, SignalRequest(RequestTriggerMode::kAlwaysSend))
+      .Times(1);
+  ASSERT_EQ(kLease, consensus_->MajorityReplicatedHtLeaseExpiration(
+      kLease - 1000, CoarseTimePoint::max()));
+  ASSERT_EQ(kLease, consensus_->MajorityReplicatedHtLeaseExpiration(
+      kLease - 1000, CoarseTimePoint::max()));
+  ASSERT_EQ(2, read_waits->value());
+  ASSERT_EQ(2, early_renewals->value());
+}
+
 // Tests that, when terms change, the commit index only advances when the majority
 // replicated index is in the current term.
 TEST_F(RaftConsensusTest, TestCommittedIndexWhenTermsChange) {
@@ -154,6 +154,24 @@ METRIC_DEFINE_histogram(
   "Microseconds spent resolving DNS requests during RaftConsensus::UpdateRaftConfig",
   60000000LU, 2);
 
+METRIC_DEFINE_counter(tablet, leader_lease_read_waits,
+                      "Leader Lease Read Waits",
+                      yb::MetricUnit::kRequests,
+                      "Number of requests that had to wait for the majority-replicated hybrid time "
+                      "leader lease to reach their read time.");
+METRIC_DEFINE_histogram(
+  tablet, leader_lease_read_wait_time,
+  "Leader Lease Read Wait Time",
+  yb::MetricUnit::kMicroseconds,
+  "Microseconds spent waiting for the majority-replicated hybrid time leader lease to reach the "
+  "read time of a request.",
+  60000000LU, 2);
+METRIC_DEFINE_counter(tablet, leader_lease_early_renewals,
+                      "Leader Lease Early Renewals",
+                      yb::MetricUnit::kRequests,
+                      "Number of times the leader sent requests to followers ahead of the next "
+                      "heartbeat to extend a hybrid time leader lease that is about to expire.");
+
 DEFINE_int32(leader_lease_duration_ms, yb::consensus::kDefaultLeaderLeaseDurationMs,
              "Leader lease duration. A leader keeps establishing a new lease or extending the "
              "existing one with every UpdateConsensus. A new server is not allowed to serve as a "
@@ -166,6 +184,13 @@ DEFINE_int32(ht_lease_duration_ms, 2000,
              "to add entries to RAFT log until a lease of the old leader is expired. 0 to disable."
              );
 
+DEFINE_int32(leader_lease_renewal_window_ms, 500,
+             "When the hybrid time leader lease expires within this time of the time a request "
+             "needs it to cover, the leader sends requests to followers right away to extend the "
+             "lease instead of waiting for the next heartbeat. 0 to disable.");
+TAG_FLAG(leader_lease_renewal_window_ms, advanced);
+TAG_FLAG(leader_lease_renewal_window_ms, runtime);
+
 DEFINE_int32(min_leader_stepdown_retry_interval_ms,
              20 * 1000,
              "Minimum amount of time between successive attempts to perform the leader stepdown "
@@ -298,7 +323,12 @@ RaftConsensus::RaftConsensus(
       parent_mem_tracker_(std::move(parent_mem_tracker)),
       table_type_(table_type),
       update_raft_config_dns_latency_(
-          METRIC_dns_resolve_latency_during_update_raft_config.Instantiate(metric_entity)) {
+          METRIC_dns_resolve_latency_during_update_raft_config.Instantiate(metric_entity)),
+      leader_lease_read_waits_(metric_entity->FindOrCreateCounter(
+          &METRIC_leader_lease_read_waits)),
+      leader_lease_read_wait_time_(METRIC_leader_lease_read_wait_time.Instantiate(metric_entity)),
+      leader_lease_early_renewals_(metric_entity->FindOrCreateCounter(
+          &METRIC_leader_lease_early_renewals)) {
   DCHECK_NOTNULL(log_.get());
 
   if (PREDICT_FALSE(FLAGS_follower_reject_update_consensus_requests_seconds > 0)) {
@@ -2374,7 +2404,39 @@ Status RaftConsensus::CheckIsActiveLeaderAndHasLease() const {
 
 MicrosTime RaftConsensus::MajorityReplicatedHtLeaseExpiration(
     MicrosTime min_allowed, CoarseTimePoint deadline) const {
-  return state_->MajorityReplicatedHtLeaseExpiration(min_allowed, deadline);
+  // Callers that just want the current value pass 0, and should not cause any requests to be sent.
+  if (FLAGS_ht_lease_duration_ms == 0 || min_allowed == 0) {
+    return state_->MajorityReplicatedHtLeaseExpiration(min_allowed, deadline);
+  }
+
+  auto lease = state_->majority_replicated_ht_lease_expiration();
+  if (lease >= min_allowed) {
+    const auto window_us = static_cast<MicrosTime>(FLAGS_leader_lease_renewal_window_ms) * 1000;
+    if (window_us > 0 && lease < min_allowed + window_us) {
+      RenewLeaderLease(lease);
+    }
+    return lease;
+  }
+
+  // Every request sent to followers extends the lease, so don't let the read wait for the next
+  // heartbeat.
+  RenewLeaderLease(lease);
+  auto start = CoarseMonoClock::Now();
+  auto result = state_->MajorityReplicatedHtLeaseExpiration(min_allowed, deadline);
+  leader_lease_read_waits_->Increment();
+  leader_lease_read_wait_time_->Increment(
+      ToMicroseconds(CoarseMonoClock::Now() - start));
+  return result;
+}
+
+void RaftConsensus::RenewLeaderLease(MicrosTime lease) const {
+  // Requests sent for a lease that is not replicated yet would extend it past this value, so
+  // there is no need to send more of them.
+  if (lease_renewal_requested_for_.exchange(lease, std::memory_order_acq_rel) == lease) {
+    return;
+  }
+  leader_lease_early_renewals_->Increment();
+  peer_manager_->SignalRequest(RequestTriggerMode::kAlwaysSend);
 }
 
 std::string RaftConsensus::GetRequestVoteLogPrefix(const VoteRequestPB& request) const {
@@ -279,6 +279,10 @@ class RaftConsensus : public std::enable_shared_from_this<RaftConsensus>,
   }
 
  private:
+  // Asks followers to extend the majority-replicated hybrid time leader lease, which currently
+  // expires at lease, without waiting for the next heartbeat.
+  void RenewLeaderLease(MicrosTime lease) const;
+
   CHECKED_STATUS DoStartElection(const LeaderElectionData& data, PreElected preelected);
 
   Result<LeaderElectionPtr> CreateElectionUnlocked(
@@ -643,6 +647,14 @@ class RaftConsensus : public std::enable_shared_from_this<RaftConsensus>,
 
   scoped_refptr<Histogram> update_raft_config_dns_latency_;
 
+  scoped_refptr<Counter> leader_lease_read_waits_;
+  scoped_refptr<Histogram> leader_lease_read_wait_time_;
+  scoped_refptr<Counter> leader_lease_early_renewals_;
+
+  // The majority-replicated hybrid time leader lease for which requests to extend it were last
+  // sent ahead of heartbeats. Starts with a value that no replicated lease has.
+  mutable std::atomic<MicrosTime> lease_renewal_requested_for_{kMaxHybridTimePhysicalMicros};
+
   // Used only when follower_reject_update_consensus_requests_seconds is greater than 0.
   // Any requests to update the replica will be rejected until this time. For testing only.
   MonoTime withold_replica_updates_until_ = MonoTime::kUninitialized;
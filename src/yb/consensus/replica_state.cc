@@ -850,6 +850,7 @@ Status ReplicaState::ApplyPendingOperationsUnlocked(IndexToRoundMap::iterator it
     max_allowed_op_id.index = std::numeric_limits<int64_t>::max();
   }
   auto leader_term = GetLeaderStateUnlocked().term;
+  bool apply_group_started = false;
 
   while (iter != end_iter) {
     scoped_refptr<ConsensusRound> round = (*iter).second; // Make a copy.
@@ -872,6 +873,17 @@ Status ReplicaState::ApplyPendingOperationsUnlocked(IndexToRoundMap::iterator it
       DCHECK_GE(max_allowed_op_id.term, current_id.term());
     }
 
+    if (type == OperationType::WRITE_OP) {
+      if (!apply_group_started) {
+        operation_factory_->StartApplyGroup();
+        apply_group_started = true;
+      }
+    } else if (apply_group_started) {
+      // Writes preceding this operation should be visible when it is applied.
+      operation_factory_->FinishApplyGroup();
+      apply_group_started = false;
+    }
+
     pending_operations_.erase(iter++);
     // Set committed configuration.
     if (PREDICT_FALSE(type == OperationType::CHANGE_CONFIG_OP)) {
@@ -882,6 +894,10 @@ Status ReplicaState::ApplyPendingOperationsUnlocked(IndexToRoundMap::iterator it
     NotifyReplicationFinishedUnlocked(round, Status::OK(), leader_term);
   }
 
+  if (apply_group_started) {
+    operation_factory_->FinishApplyGroup();
+  }
+
   SetLastCommittedIndexUnlocked(committed_index);
 
   return Status::OK();
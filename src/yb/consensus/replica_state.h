@@ -405,6 +405,11 @@ class ReplicaState {
   MicrosTime MajorityReplicatedHtLeaseExpiration(
       MicrosTime min_allowed, CoarseTimePoint deadline) const;
 
+  // Returns the current majority-replicated hybrid time leader lease expiration without waiting.
+  MicrosTime majority_replicated_ht_lease_expiration() const {
+    return majority_replicated_ht_lease_expiration_.load(std::memory_order_acquire);
+  }
+
   // The on-disk size of the consensus metadata.
   uint64_t OnDiskSize() const;
 
@@ -14,10 +14,14 @@
 #ifndef YB_CONSENSUS_REPLICATE_MSGS_HOLDER_H
 #define YB_CONSENSUS_REPLICATE_MSGS_HOLDER_H
 
+#include <vector>
+
 #include <google/protobuf/repeated_field.h>
 
 #include "yb/consensus/consensus_fwd.h"
 
+#include "yb/util/ref_cnt_buffer.h"
+
 namespace yb {
 namespace consensus {
 
@@ -25,8 +29,11 @@ class ReplicateMsgsHolder {
  public:
   ReplicateMsgsHolder() : ops_(nullptr) {}
 
+  // serialized_ops, when not empty, holds each of the messages encoded as an element of
+  // ConsensusRequestPB::ops, see LogCache::ReadOps.
   explicit ReplicateMsgsHolder(
-      google::protobuf::RepeatedPtrField<ReplicateMsg>* ops, ReplicateMsgs messages);
+      google::protobuf::RepeatedPtrField<ReplicateMsg>* ops, ReplicateMsgs messages,
+      std::vector<RefCntBuffer> serialized_ops = std::vector<RefCntBuffer>());
 
   ReplicateMsgsHolder(ReplicateMsgsHolder&& rhs);
   void operator=(ReplicateMsgsHolder&& rhs);
@@ -43,6 +50,10 @@ class ReplicateMsgsHolder {
     ops_ = nullptr;
   }
 
+  const std::vector<RefCntBuffer>& serialized_ops() const {
+    return serialized_ops_;
+  }
+
  private:
   google::protobuf::RepeatedPtrField<ReplicateMsg>* ops_;
 
@@ -51,6 +62,8 @@ class ReplicateMsgsHolder {
   // object as other peers. Since the PB request_ itself can't hold reference counts, this holds
   // them.
   ReplicateMsgs messages_;
+
+  std::vector<RefCntBuffer> serialized_ops_;
 };
 
 }  // namespace consensus
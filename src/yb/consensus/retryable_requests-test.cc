@@ -0,0 +1,122 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include <gflags/gflags.h>
+#include <gtest/gtest.h>
+
+#include "yb/consensus/consensus.h"
+#include "yb/consensus/retryable_requests.h"
+
+#include "yb/util/mem_tracker.h"
+#include "yb/util/opid.h"
+#include "yb/util/test_macros.h"
+#include "yb/util/test_util.h"
+
+DECLARE_int32(retryable_request_timeout_secs);
+
+namespace yb {
+namespace consensus {
+
+namespace {
+
+ConsensusRoundPtr MakeRound(
+    int64_t index, int64_t request_id, int64_t min_running_request_id = 0) {
+  auto msg = std::make_shared<ReplicateMsg>();
+  msg->set_op_type(WRITE_OP);
+  msg->mutable_id()->set_term(1);
+  msg->mutable_id()->set_index(index);
+  auto* write_request = msg->mutable_write_request();
+  write_request->set_client_id1(1);
+  write_request->set_client_id2(2);
+  write_request->set_request_id(request_id);
+  write_request->set_min_running_request_id(min_running_request_id);
+  return make_scoped_refptr(new ConsensusRound(nullptr /* consensus */, std::move(msg)));
+}
+
+} // namespace
+
+class RetryableRequestsTest : public YBTest {
+ protected:
+  void Replicate(const ConsensusRoundPtr& round) {
+    retryable_requests_.ReplicationFinished(*round->replicate_msg(), Status::OK(), 1);
+  }
+
+  RetryableRequests retryable_requests_;
+};
+
+TEST_F(RetryableRequestsTest, Ranges) {
+  std::vector<ConsensusRoundPtr> rounds;
+  for (int i = 1; i <= 5; ++i) {
+    rounds.push_back(MakeRound(i, i));
+    ASSERT_TRUE(retryable_requests_.Register(rounds.back()));
+  }
+  ASSERT_FALSE(retryable_requests_.Register(MakeRound(6, 3)));
+  ASSERT_EQ(5, retryable_requests_.TEST_Counts().running);
+
+  // Replicated out of order, the requests still form a single range.
+  for (int i : {1, 3, 2, 5, 4}) {
+    Replicate(rounds[i - 1]);
+  }
+  auto counts = retryable_requests_.TEST_Counts();
+  ASSERT_EQ(0, counts.running);
+  ASSERT_EQ(1, counts.replicated);
+  ASSERT_FALSE(retryable_requests_.Register(MakeRound(7, 2)));
+
+  // A request that was not replicated splits the ranges.
+  auto aborted = MakeRound(8, 6);
+  ASSERT_TRUE(retryable_requests_.Register(aborted));
+  retryable_requests_.ReplicationFinished(
+      *aborted->replicate_msg(), STATUS(Aborted, "Aborted"), 1);
+  auto round = MakeRound(9, 7);
+  ASSERT_TRUE(retryable_requests_.Register(round));
+  Replicate(round);
+  ASSERT_EQ(2, retryable_requests_.TEST_Counts().replicated);
+  ASSERT_EQ(yb::OpId(1, 1), retryable_requests_.CleanExpiredReplicatedAndGetMinOpId());
+
+  // Ranges below the min running request id of the client are dropped.
+  round = MakeRound(10, 8, 7 /* min_running_request_id */);
+  ASSERT_TRUE(retryable_requests_.Register(round));
+  Replicate(round);
+  ASSERT_EQ(1, retryable_requests_.TEST_Counts().replicated);
+  ASSERT_FALSE(retryable_requests_.Register(MakeRound(11, 5)));
+  ASSERT_EQ(yb::OpId(1, 9), retryable_requests_.CleanExpiredReplicatedAndGetMinOpId());
+}
+
+TEST_F(RetryableRequestsTest, MemTracking) {
+  auto mem_tracker = MemTracker::CreateTracker("RetryableRequestsTest");
+  retryable_requests_.SetMemTracker(mem_tracker);
+  ASSERT_EQ(0, mem_tracker->consumption());
+
+  for (int i = 1; i <= 10; ++i) {
+    auto round = MakeRound(i, i * 2);
+    ASSERT_TRUE(retryable_requests_.Register(round));
+    Replicate(round);
+  }
+  ASSERT_EQ(10, retryable_requests_.TEST_Counts().replicated);
+  retryable_requests_.CleanExpiredReplicatedAndGetMinOpId();
+  ASSERT_GT(mem_tracker->consumption(), 0);
+
+  FLAGS_retryable_request_timeout_secs = 0;
+  SleepFor(MonoDelta::FromMilliseconds(10));
+  retryable_requests_.CleanExpiredReplicatedAndGetMinOpId();
+  ASSERT_EQ(0, retryable_requests_.TEST_Counts().replicated);
+  // The client itself is kept for a while, to filter requests with too small ids.
+  auto client_consumption = mem_tracker->consumption();
+  ASSERT_GT(client_consumption, 0);
+  SleepFor(MonoDelta::FromMilliseconds(10));
+  retryable_requests_.CleanExpiredReplicatedAndGetMinOpId();
+  ASSERT_EQ(0, mem_tracker->consumption());
+}
+
+} // namespace consensus
+} // namespace yb
@@ -13,6 +13,9 @@
 
 #include "yb/consensus/retryable_requests.h"
 
+#include <algorithm>
+#include <vector>
+
 #include <boost/multi_index_container.hpp>
 #include <boost/multi_index/member.hpp>
 #include <boost/multi_index/hashed_index.hpp>
@@ -22,6 +25,7 @@
 #include "yb/consensus/consensus.h"
 
 #include "yb/util/atomic.h"
+#include "yb/util/mem_tracker.h"
 #include "yb/util/metrics.h"
 #include "yb/util/opid.h"
 
@@ -65,23 +69,23 @@ struct RunningRetryableRequest {
 };
 
 struct ReplicatedRetryableRequestRange {
-  mutable RetryableRequestId first_id;
+  RetryableRequestId first_id;
   RetryableRequestId last_id;
   yb::OpId min_op_id;
-  mutable RestartSafeCoarseTimePoint min_time;
-  mutable RestartSafeCoarseTimePoint max_time;
+  RestartSafeCoarseTimePoint min_time;
+  RestartSafeCoarseTimePoint max_time;
 
   ReplicatedRetryableRequestRange(RetryableRequestId id, const yb::OpId& op_id,
                               RestartSafeCoarseTimePoint time)
       : first_id(id), last_id(id), min_op_id(op_id), min_time(time),
         max_time(time) {}
 
-  void InsertTime(const RestartSafeCoarseTimePoint& time) const {
+  void InsertTime(const RestartSafeCoarseTimePoint& time) {
     min_time = std::min(min_time, time);
     max_time = std::max(max_time, time);
   }
 
-  void PrepareJoinWithPrev(const ReplicatedRetryableRequestRange& prev) const {
+  void PrepareJoinWithPrev(const ReplicatedRetryableRequestRange& prev) {
     min_time = std::min(min_time, prev.min_time);
     max_time = std::max(max_time, prev.max_time);
     first_id = prev.first_id;
@@ -93,7 +97,6 @@ struct ReplicatedRetryableRequestRange {
   }
 };
 
-struct LastIdIndex;
 struct OpIdIndex;
 struct RequestIdIndex;
 
@@ -115,34 +118,43 @@ typedef boost::multi_index_container <
     >
 > RunningRetryableRequests;
 
-typedef boost::multi_index_container <
-    ReplicatedRetryableRequestRange,
-    boost::multi_index::indexed_by <
-        boost::multi_index::ordered_unique <
-            boost::multi_index::tag<LastIdIndex>,
-            boost::multi_index::member <
-                ReplicatedRetryableRequestRange, RetryableRequestId,
-                &ReplicatedRetryableRequestRange::last_id
-            >
-        >,
-        boost::multi_index::ordered_unique <
-            boost::multi_index::tag<OpIdIndex>,
-            boost::multi_index::member <
-                ReplicatedRetryableRequestRange, yb::OpId,
-                &ReplicatedRetryableRequestRange::min_op_id
-            >
-        >
-    >
-> ReplicatedRetryableRequestRanges;
+// Ranges do not overlap and are sorted by id. There are few of them per client, since a range is
+// only split by the time limit of a range or by requests that are not replicated, so a vector is
+// both smaller and faster to search than a tree.
+typedef std::vector<ReplicatedRetryableRequestRange> ReplicatedRetryableRequestRanges;
+
+// Returns the first range with last_id >= id.
+ReplicatedRetryableRequestRanges::iterator LowerBoundByLastId(
+    RetryableRequestId id, ReplicatedRetryableRequestRanges* ranges) {
+  return std::lower_bound(
+      ranges->begin(), ranges->end(), id,
+      [](const ReplicatedRetryableRequestRange& range, RetryableRequestId id) {
+    return range.last_id < id;
+  });
+}
 
-typedef ReplicatedRetryableRequestRanges::index<LastIdIndex>::type
-    ReplicatedRetryableRequestRangesByLastId;
+// Releases memory of ranges vectors that shrank a lot, e.g. after the client became idle.
+void MaybeShrink(ReplicatedRetryableRequestRanges* ranges) {
+  constexpr size_t kMinCapacityToShrink = 16;
+  if (ranges->capacity() >= kMinCapacityToShrink && ranges->size() * 4 < ranges->capacity()) {
+    ranges->shrink_to_fit();
+  }
+}
 
 struct ClientRetryableRequests {
   RunningRetryableRequests running;
   ReplicatedRetryableRequestRanges replicated;
   RetryableRequestId min_running_request_id = 0;
   RestartSafeCoarseTimePoint empty_since;
+
+  // Approximate memory used to track the requests of the client, including the map node.
+  size_t MemoryUsage() const {
+    // Running requests are linked into a hashed and an ordered index.
+    constexpr size_t kRunningNodeOverhead = 4 * sizeof(void*);
+    return sizeof(std::pair<ClientId, ClientRetryableRequests>) + 2 * sizeof(void*) +
+           running.size() * (sizeof(RunningRetryableRequest) + kRunningNodeOverhead) +
+           replicated.capacity() * sizeof(ReplicatedRetryableRequestRange);
+  }
 };
 
 std::chrono::seconds RangeTimeLimit() {
@@ -231,9 +243,9 @@ class RetryableRequests::Impl {
       return false;
     }
 
-    auto& replicated_indexed_by_last_id = client_retryable_requests.replicated.get<LastIdIndex>();
-    auto it = replicated_indexed_by_last_id.lower_bound(data.request_id());
-    if (it != replicated_indexed_by_last_id.end() && it->first_id <= data.request_id()) {
+    auto& replicated = client_retryable_requests.replicated;
+    auto it = LowerBoundByLastId(data.request_id(), &replicated);
+    if (it != replicated.end() && it->first_id <= data.request_id()) {
       round->NotifyReplicationFinished(
           STATUS(AlreadyPresent, "Duplicate request"), round->bound_term());
       return false;
@@ -260,25 +272,24 @@ class RetryableRequests::Impl {
     auto now = clock_.Now();
     auto clean_start =
         now - std::chrono::seconds(GetAtomicFlag(&FLAGS_retryable_request_timeout_secs));
+    size_t memory_usage = 0;
     for (auto ci = clients_.begin(); ci != clients_.end();) {
       ClientRetryableRequests& client_retryable_requests = ci->second;
-      auto& op_id_index = client_retryable_requests.replicated.get<OpIdIndex>();
-      auto it = op_id_index.begin();
-      int64_t count = 0;
-      while (it != op_id_index.end() && it->max_time < clean_start) {
-        ++it;
-        ++count;
-      }
+      auto& replicated = client_retryable_requests.replicated;
+      auto expired_begin = std::remove_if(
+          replicated.begin(), replicated.end(),
+          [clean_start](const ReplicatedRetryableRequestRange& range) {
+        return range.max_time < clean_start;
+      });
       if (replicated_request_ranges_gauge_) {
-        replicated_request_ranges_gauge_->DecrementBy(count);
+        replicated_request_ranges_gauge_->DecrementBy(replicated.end() - expired_begin);
       }
-      if (it != op_id_index.end()) {
-        result = std::min(result, it->min_op_id);
-        op_id_index.erase(op_id_index.begin(), it);
-      } else {
-        op_id_index.clear();
+      replicated.erase(expired_begin, replicated.end());
+      MaybeShrink(&replicated);
+      for (const auto& range : replicated) {
+        result = std::min(result, range.min_op_id);
       }
-      if (op_id_index.empty() && client_retryable_requests.running.empty()) {
+      if (replicated.empty() && client_retryable_requests.running.empty()) {
         // We delay deleting client with empty requests, to be able to filter requests with too
         // small request id.
         if (client_retryable_requests.empty_since == RestartSafeCoarseTimePoint()) {
@@ -288,8 +299,10 @@ class RetryableRequests::Impl {
           continue;
         }
       }
+      memory_usage += client_retryable_requests.MemoryUsage();
       ++ci;
     }
+    mem_consumption_.Reset(memory_usage);
 
     return result;
   }
@@ -368,6 +381,15 @@ class RetryableRequests::Impl {
         metric_entity, 0);
   }
 
+  void SetMemTracker(const std::shared_ptr<MemTracker>& parent_mem_tracker) {
+    size_t memory_usage = 0;
+    for (const auto& p : clients_) {
+      memory_usage += p.second.MemoryUsage();
+    }
+    mem_consumption_ = ScopedTrackedConsumption(
+        MemTracker::FindOrCreateTracker("RetryableRequests", parent_mem_tracker), memory_usage);
+  }
+
   RetryableRequestsCounts TEST_Counts() {
     RetryableRequestsCounts result;
     for (const auto& p : clients_) {
@@ -382,24 +404,22 @@ class RetryableRequests::Impl {
   void CleanupReplicatedRequests(
       RetryableRequestId new_min_running_request_id,
       ClientRetryableRequests* client_retryable_requests) {
-    auto& replicated_indexed_by_last_id = client_retryable_requests->replicated.get<LastIdIndex>();
+    auto& replicated = client_retryable_requests->replicated;
     if (new_min_running_request_id > client_retryable_requests->min_running_request_id) {
       // We are not interested in ids below write_request.min_running_request_id() anymore.
       //
       // Request id intervals are ordered by last id of interval, and does not overlap.
       // So we are trying to find interval with last_id >= min_running_request_id
       // and trim it if necessary.
-      auto it = replicated_indexed_by_last_id.lower_bound(new_min_running_request_id);
-      if (it != replicated_indexed_by_last_id.end() &&
-          it->first_id < new_min_running_request_id) {
+      auto it = LowerBoundByLastId(new_min_running_request_id, &replicated);
+      if (it != replicated.end() && it->first_id < new_min_running_request_id) {
         it->first_id = new_min_running_request_id;
       }
       if (replicated_request_ranges_gauge_) {
-        replicated_request_ranges_gauge_->DecrementBy(
-            std::distance(replicated_indexed_by_last_id.begin(), it));
+        replicated_request_ranges_gauge_->DecrementBy(it - replicated.begin());
       }
       // Remove all intervals that has ids below write_request.min_running_request_id().
-      replicated_indexed_by_last_id.erase(replicated_indexed_by_last_id.begin(), it);
+      replicated.erase(replicated.begin(), it);
       client_retryable_requests->min_running_request_id = new_min_running_request_id;
     }
   }
@@ -407,9 +427,9 @@ class RetryableRequests::Impl {
   void AddReplicated(yb::OpId op_id, const ReplicateData& data, RestartSafeCoarseTimePoint time,
                      ClientRetryableRequests* client) {
     auto request_id = data.request_id();
-    auto& replicated_indexed_by_last_id = client->replicated.get<LastIdIndex>();
-    auto request_it = replicated_indexed_by_last_id.lower_bound(request_id);
-    if (request_it != replicated_indexed_by_last_id.end() && request_it->first_id <= request_id) {
+    auto& replicated = client->replicated;
+    auto request_it = LowerBoundByLastId(request_id, &replicated);
+    if (request_it != replicated.end() && request_it->first_id <= request_id) {
 #ifndef NDEBUG
       LOG_WITH_PREFIX(ERROR)
           << "Replicated requests: " << yb::ToString(client->replicated);
@@ -422,44 +442,32 @@ class RetryableRequests::Impl {
     // Check that we have range right after this id, and we could extend it.
     // Requests rarely attaches to begin of interval, so we could don't check for
     // RangeTimeLimit() here.
-    if (request_it != replicated_indexed_by_last_id.end() &&
-        request_it->first_id == request_id + 1) {
+    if (request_it != replicated.end() && request_it->first_id == request_id + 1) {
       op_id = std::min(request_it->min_op_id, op_id);
       request_it->InsertTime(time);
       // If previous range is right before this id, then we could just join those ranges.
-      if (!TryJoinRanges(request_it, op_id, &replicated_indexed_by_last_id)) {
+      if (!TryJoinRanges(request_it, op_id, &replicated)) {
         --(request_it->first_id);
-        UpdateMinOpId(request_it, op_id, &replicated_indexed_by_last_id);
+        request_it->min_op_id = op_id;
       }
       return;
     }
 
-    if (TryJoinToEndOfRange(request_it, op_id, request_id, time, &replicated_indexed_by_last_id)) {
+    if (TryJoinToEndOfRange(request_it, op_id, request_id, time, &replicated)) {
       return;
     }
 
-    client->replicated.emplace(request_id, op_id, time);
+    replicated.emplace(request_it, request_id, op_id, time);
     if (replicated_request_ranges_gauge_) {
       replicated_request_ranges_gauge_->Increment();
     }
   }
 
-  void UpdateMinOpId(
-      ReplicatedRetryableRequestRangesByLastId::iterator request_it,
-      yb::OpId min_op_id,
-      ReplicatedRetryableRequestRangesByLastId* replicated_indexed_by_last_id) {
-    if (min_op_id < request_it->min_op_id) {
-      replicated_indexed_by_last_id->modify(request_it, [min_op_id](auto& entry) { // NOLINT
-        entry.min_op_id = min_op_id;
-      });
-    }
-  }
-
   bool TryJoinRanges(
-      ReplicatedRetryableRequestRangesByLastId::iterator request_it,
+      ReplicatedRetryableRequestRanges::iterator request_it,
       yb::OpId min_op_id,
-      ReplicatedRetryableRequestRangesByLastId* replicated_indexed_by_last_id) {
-    if (request_it == replicated_indexed_by_last_id->begin()) {
+      ReplicatedRetryableRequestRanges* replicated) {
+    if (request_it == replicated->begin()) {
       return false;
     }
 
@@ -477,22 +485,21 @@ class RetryableRequests::Impl {
       return false;
     }
 
-    min_op_id = std::min(min_op_id, request_prev_it->min_op_id);
     request_it->PrepareJoinWithPrev(*request_prev_it);
-    replicated_indexed_by_last_id->erase(request_prev_it);
+    request_it->min_op_id = std::min(min_op_id, request_prev_it->min_op_id);
+    replicated->erase(request_prev_it);
     if (replicated_request_ranges_gauge_) {
       replicated_request_ranges_gauge_->Decrement();
     }
-    UpdateMinOpId(request_it, min_op_id, replicated_indexed_by_last_id);
 
     return true;
   }
 
   bool TryJoinToEndOfRange(
-      ReplicatedRetryableRequestRangesByLastId::iterator request_it,
+      ReplicatedRetryableRequestRanges::iterator request_it,
       yb::OpId op_id, RetryableRequestId request_id, RestartSafeCoarseTimePoint time,
-      ReplicatedRetryableRequestRangesByLastId* replicated_indexed_by_last_id) {
-    if (request_it == replicated_indexed_by_last_id->begin()) {
+      ReplicatedRetryableRequestRanges* replicated) {
+    if (request_it == replicated->begin()) {
       return false;
     }
 
@@ -509,13 +516,9 @@ class RetryableRequests::Impl {
       return false;
     }
 
-    op_id = std::min(request_it->min_op_id, op_id);
+    request_it->min_op_id = std::min(request_it->min_op_id, op_id);
     request_it->InsertTime(time);
-    // Actually we should use the modify function on client.replicated, but since the order of
-    // ranges should not be changed, we could update last_id directly.
-    ++const_cast<ReplicatedRetryableRequestRange&>(*request_it).last_id;
-
-    UpdateMinOpId(request_it, op_id, replicated_indexed_by_last_id);
+    ++request_it->last_id;
 
     return true;
   }
@@ -529,6 +532,8 @@ class RetryableRequests::Impl {
   RestartSafeCoarseMonoClock clock_;
   scoped_refptr<AtomicGauge<int64_t>> running_requests_gauge_;
   scoped_refptr<AtomicGauge<int64_t>> replicated_request_ranges_gauge_;
+  // Updated when expired requests are cleaned.
+  ScopedTrackedConsumption mem_consumption_;
 };
 
 RetryableRequests::RetryableRequests(std::string log_prefix)
@@ -575,5 +580,9 @@ void RetryableRequests::SetMetricEntity(const scoped_refptr<MetricEntity>& metri
   impl_->SetMetricEntity(metric_entity);
 }
 
+void RetryableRequests::SetMemTracker(const std::shared_ptr<MemTracker>& parent_mem_tracker) {
+  impl_->SetMemTracker(parent_mem_tracker);
+}
+
 } // namespace consensus
 } // namespace yb
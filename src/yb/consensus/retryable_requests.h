@@ -20,6 +20,7 @@
 
 namespace yb {
 
+class MemTracker;
 class MetricEntity;
 struct OpId;
 
@@ -62,6 +63,9 @@ class RetryableRequests {
 
   void SetMetricEntity(const scoped_refptr<MetricEntity>& metric_entity);
 
+  // Reports the memory used to track requests to a child of parent_mem_tracker.
+  void SetMemTracker(const std::shared_ptr<MemTracker>& parent_mem_tracker);
+
  private:
   class Impl;
   std::unique_ptr<Impl> impl_;
@@ -22,6 +22,7 @@
 #include "yb/docdb/docdb.pb.h"
 #include "yb/docdb/docdb_rocksdb_util.h"
 #include "yb/docdb/intent.h"
+#include "yb/docdb/intent_index.h"
 #include "yb/docdb/shared_lock_manager.h"
 
 #include "yb/util/countdown_latch.h"
@@ -117,12 +118,24 @@ class ConflictResolver {
     return ResolveConflicts();
   }
 
-  // Reads conflicts for specified intent from DB.
+  // Reads conflicts for specified intent from the intent index, or from DB when the index is
+  // disabled or incomplete.
   CHECKED_STATUS ReadIntentConflicts(IntentTypeSet type, KeyBytes* intent_key_prefix) {
-    EnsureIntentIteratorCreated();
-
     const auto conflicting_intent_types = kIntentTypeSetConflicts[type.ToUIntPtr()];
 
+    if (doc_db_.intent_index &&
+        doc_db_.intent_index->Find(intent_key_prefix->AsSlice(), &indexed_intents_)) {
+      for (const auto& intent : indexed_intents_) {
+        if ((conflicting_intent_types & kIntentTypeSetMask[intent.types.ToUIntPtr()]) != 0 &&
+            !context_.IgnoreConflictsWith(intent.transaction_id)) {
+          conflicts_.insert(intent.transaction_id);
+        }
+      }
+      return Status::OK();
+    }
+
+    EnsureIntentIteratorCreated();
+
     KeyBytes upperbound_key(*intent_key_prefix);
     upperbound_key.AppendValueType(ValueType::kMaxByte);
     intent_key_upperbound_ = upperbound_key.AsSlice();
@@ -342,6 +355,7 @@ class ConflictResolver {
   DocDB doc_db_;
   std::unique_ptr<rocksdb::Iterator> intent_iter_;
   Slice intent_key_upperbound_;
+  IntentIndex::Intents indexed_intents_;
   TransactionStatusManager& status_manager_;
   RequestScope request_scope_;
   ConflictResolverContext& context_;
@@ -13,6 +13,8 @@
 
 #include "yb/docdb/cql_operation.h"
 
+#include <boost/optional.hpp>
+
 #include "yb/common/index.h"
 #include "yb/common/jsonb.h"
 #include "yb/common/ql_protocol_util.h"
@@ -22,14 +24,51 @@
 #include "yb/docdb/doc_ql_scanspec.h"
 #include "yb/docdb/doc_rowwise_iterator.h"
 #include "yb/docdb/docdb_util.h"
+#include "yb/docdb/packed_row.h"
+#include "yb/docdb/ql_scan_cursors.h"
+#include "yb/docdb/query_mem_tracker.h"
 
 #include "yb/util/bfpg/tserver_opcodes.h"
+#include "yb/util/bfql/bfql.h"
 #include "yb/util/flag_tags.h"
+#include "yb/util/random_util.h"
 #include "yb/util/trace.h"
 
 DEFINE_test_flag(bool, pause_write_apply_after_if, false,
                  "Pause application of QLWriteOperation after evaluating if condition.");
 
+DEFINE_bool(ycql_enable_packed_row, false,
+            "Write the columns of a YCQL INSERT into a table without collection columns as a "
+            "single RocksDB entry per row, instead of one entry per column. Rows written this way "
+            "are readable regardless of the value of this flag.");
+TAG_FLAG(ycql_enable_packed_row, advanced);
+TAG_FLAG(ycql_enable_packed_row, runtime);
+
+DEFINE_int32(ycql_counter_blind_increments_between_totals, 0,
+             "When positive, YCQL counter updates are written as increments without reading the "
+             "current values of the counters, and reads add the increments up. About once per "
+             "this number of updates the counters are read and their totals written instead, so "
+             "compactions can drop the increments that the totals overwrite. 0 to always write "
+             "totals.");
+TAG_FLAG(ycql_counter_blind_increments_between_totals, advanced);
+TAG_FLAG(ycql_counter_blind_increments_between_totals, runtime);
+
+DEFINE_bool(ycql_range_delete_tombstones, false,
+            "Write a non-transactional YCQL delete of a whole partition, or of a range of the "
+            "first clustering column of a partition, as a single range tombstone, instead of "
+            "reading the rows and deleting each of them. Rows deleted this way stay deleted "
+            "regardless of the value of this flag.");
+TAG_FLAG(ycql_range_delete_tombstones, advanced);
+TAG_FLAG(ycql_range_delete_tombstones, runtime);
+
+DEFINE_int32(ycql_scan_page_time_budget_ms, 0,
+             "When positive, a paged YCQL scan that has run for this long returns the rows read so "
+             "far with a paging state, so that its RPC thread is released and the scan is "
+             "continued by the next page, queued behind the requests that arrived meanwhile. "
+             "0 to fill pages regardless of time.");
+TAG_FLAG(ycql_scan_page_time_budget_ms, advanced);
+TAG_FLAG(ycql_scan_page_time_budget_ms, runtime);
+
 DECLARE_bool(trace_docdb_calls);
 
 namespace yb {
@@ -189,6 +228,93 @@ CHECKED_STATUS FindMemberForIndex(const QLColumnValuePB& column_value,
   return Status::OK();
 }
 
+// Adds the bound set by a comparison of the first range column with a constant to the range
+// tombstone. Returns false for other conditions, and for a second bound on the same side.
+bool AddRangeTombstoneBound(
+    const Schema& schema, const QLConditionPB& condition, RangeTombstone* tombstone) {
+  const size_t column_idx = schema.num_hash_key_columns();
+  if (condition.operands_size() != 2 ||
+      condition.operands(0).expr_case() != QLExpressionPB::kColumnId ||
+      ColumnId(condition.operands(0).column_id()) != schema.column_id(column_idx) ||
+      condition.operands(1).expr_case() != QLExpressionPB::kValue ||
+      IsNull(condition.operands(1).value())) {
+    return false;
+  }
+  bool lower = false;
+  bool upper = false;
+  bool inclusive = true;
+  switch (condition.op()) {
+    case QL_OP_EQUAL:
+      lower = upper = true;
+      break;
+    case QL_OP_LESS_THAN:
+      inclusive = false;
+      FALLTHROUGH_INTENDED;
+    case QL_OP_LESS_THAN_EQUAL:
+      upper = true;
+      break;
+    case QL_OP_GREATER_THAN:
+      inclusive = false;
+      FALLTHROUGH_INTENDED;
+    case QL_OP_GREATER_THAN_EQUAL:
+      lower = true;
+      break;
+    default:
+      return false;
+  }
+  const auto& column = schema.column(column_idx);
+  if (column.sorting_type() == ColumnSchema::SortingType::kDescending) {
+    // Bounds are on the key encoding, which is in the reverse order for descending columns.
+    std::swap(lower, upper);
+  }
+  if ((lower && tombstone->has_lower_bound()) || (upper && tombstone->has_upper_bound())) {
+    return false;
+  }
+  KeyBytes component;
+  PrimitiveValue::FromQLValuePB(condition.operands(1).value(), column.sorting_type())
+      .AppendToKey(&component);
+  if (lower) {
+    tombstone->SetLowerBound(component.data(), inclusive);
+  }
+  if (upper) {
+    tombstone->SetUpperBound(component.data(), inclusive);
+  }
+  return true;
+}
+
+// Returns the increment of a counter column set to "c = c + <constant>" or "c = c - <constant>",
+// or none for other expressions.
+boost::optional<int64_t> CounterIncrement(
+    const Schema& schema, const QLColumnValuePB& column_value) {
+  if (!column_value.has_column_id() || !column_value.json_args().empty() ||
+      !column_value.subscript_args().empty() ||
+      column_value.expr().expr_case() != QLExpressionPB::kBfcall) {
+    return boost::none;
+  }
+  const auto column = schema.column_by_id(ColumnId(column_value.column_id()));
+  if (!column.ok() || !column->is_counter()) {
+    return boost::none;
+  }
+  const QLBCallPB& bfcall = column_value.expr().bfcall();
+  if (bfcall.opcode() < 0 || static_cast<size_t>(bfcall.opcode()) >= bfql::kBFOperators.size() ||
+      bfcall.operands_size() != 2 ||
+      bfcall.operands(0).expr_case() != QLExpressionPB::kColumnId ||
+      bfcall.operands(0).column_id() != column_value.column_id() ||
+      bfcall.operands(1).expr_case() != QLExpressionPB::kValue ||
+      bfcall.operands(1).value().value_case() != QLValuePB::kInt64Value) {
+    return boost::none;
+  }
+  const std::string name = bfql::kBFOperators[bfcall.opcode()]->op_decl()->cpp_name();
+  const int64_t operand = bfcall.operands(1).value().int64_value();
+  if (name == "IncCounter") {
+    return operand;
+  }
+  if (name == "DecCounter") {
+    return -operand;
+  }
+  return boost::none;
+}
+
 CHECKED_STATUS CheckUserTimestampForCollections(const UserTimeMicros user_timestamp) {
   if (user_timestamp != Value::kInvalidUserTimestamp) {
     return STATUS(InvalidArgument, "User supplied timestamp is only allowed for "
@@ -204,7 +330,17 @@ Status QLWriteOperation::Init(QLWriteRequestPB* request, QLResponsePB* response)
   response_ = response;
   insert_into_unique_index_ = request_.type() == QLWriteRequestPB::QL_STMT_INSERT &&
                               unique_index_key_schema_ != nullptr;
-  require_read_ = RequireRead(request_, schema_) || insert_into_unique_index_;
+  // The only columns an INSERT without IF clause reads are the indexed ones, to delete old index
+  // entries. There are none when the row is new.
+  insert_new_row_ = request_.row_is_new() &&
+                    request_.type() == QLWriteRequestPB::QL_STMT_INSERT &&
+                    !request_.has_if_expr() && !request_.returns_status() &&
+                    !request_.has_user_timestamp_usec();
+  const int32_t increments_between_totals = FLAGS_ycql_counter_blind_increments_between_totals;
+  blind_increments_ = increments_between_totals > 0 && CanIncrementBlindly() &&
+                      !RandomWithChance(increments_between_totals);
+  require_read_ = (!insert_new_row_ && !blind_increments_ && RequireRead(request_, schema_)) ||
+                  insert_into_unique_index_;
   update_indexes_ = !request_.update_index_ids().empty();
 
   // Determine if static / non-static columns are being written.
@@ -642,6 +778,97 @@ Status QLWriteOperation::ApplyForRegularColumns(const QLColumnValuePB& column_va
   return Status::OK();
 }
 
+bool QLWriteOperation::CanIncrementBlindly() const {
+  if (request_.type() != QLWriteRequestPB::QL_STMT_UPDATE || request_.has_if_expr() ||
+      request_.returns_status() || request_.has_user_timestamp_usec() || request_.has_ttl() ||
+      !request_.update_index_ids().empty() || request_.column_values().empty()) {
+    return false;
+  }
+  for (const auto& column_value : request_.column_values()) {
+    if (!CounterIncrement(schema_, column_value)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+boost::optional<RangeTombstone> QLWriteOperation::RangeDeleteTombstone() const {
+  // Transactions do not lock the partition document, so they would not conflict with the rows the
+  // tombstone deletes. Static columns are not range components, so a partition delete would have
+  // to delete them separately.
+  if (!FLAGS_ycql_range_delete_tombstones || txn_op_context_ || !encoded_hashed_doc_key_ ||
+      !SupportsRangeTombstones(schema_) || schema_.has_statics() ||
+      request_.has_user_timestamp_usec() || update_indexes_) {
+    return boost::none;
+  }
+  RangeTombstone tombstone;
+  if (request_.has_where_expr()) {
+    const QLConditionPB& condition = request_.where_expr().condition();
+    if (condition.op() != QL_OP_AND) {
+      if (!AddRangeTombstoneBound(schema_, condition, &tombstone)) {
+        return boost::none;
+      }
+    } else {
+      for (const auto& operand : condition.operands()) {
+        if (operand.expr_case() != QLExpressionPB::kCondition ||
+            !AddRangeTombstoneBound(schema_, operand.condition(), &tombstone)) {
+          return boost::none;
+        }
+      }
+    }
+  }
+  return tombstone;
+}
+
+bool QLWriteOperation::CanPackRow(
+    const MonoDelta& ttl, const UserTimeMicros& user_timestamp) const {
+  if (!FLAGS_ycql_enable_packed_row || !encoded_pk_doc_key_ || ttl != Value::kMaxTtl ||
+      user_timestamp != Value::kInvalidUserTimestamp) {
+    return false;
+  }
+  // Collections are not packed, since they are updated element by element.
+  for (size_t i = schema_.num_key_columns(); i < schema_.num_columns(); i++) {
+    if (schema_.column(i).type()->IsCollection()) {
+      return false;
+    }
+  }
+  for (const auto& column_value : request_.column_values()) {
+    if (!column_value.has_column_id() || !column_value.json_args().empty() ||
+        !column_value.subscript_args().empty() ||
+        GetTSWriteInstruction(column_value.expr()) != bfql::TSOpcode::kScalarInsert) {
+      return false;
+    }
+    const auto column = schema_.column_by_id(ColumnId(column_value.column_id()));
+    if (!column.ok() || column->is_static()) {
+      return false;
+    }
+  }
+  return true;
+}
+
+Status QLWriteOperation::ApplyPackedRow(const QLTableRow& existing_row,
+                                        const DocOperationApplyData& data,
+                                        QLTableRow* new_row) {
+  PackedRow packed_row(request_.schema_version());
+  for (const auto& column_value : request_.column_values()) {
+    const ColumnId column_id(column_value.column_id());
+    const auto column = VERIFY_RESULT(schema_.column_by_id(column_id));
+    QLValue expr_result;
+    RETURN_NOT_OK(EvalExpr(column_value.expr(), existing_row, &expr_result));
+    // Null values are packed as tombstones, so they still hide the older values of their columns.
+    packed_row.AddColumn(
+        column_id, PrimitiveValue::FromQLValuePB(expr_result.value(), column.sorting_type()));
+    if (update_indexes_) {
+      new_row->AllocColumn(column_id, expr_result);
+    }
+  }
+  const DocPath sub_path(encoded_pk_doc_key_.as_slice(),
+                         PrimitiveValue::SystemColumnId(SystemColumnIds::kPackedRow));
+  return data.doc_write_batch->SetPrimitive(
+      sub_path, Value(PrimitiveValue(packed_row.Encode())), data.read_time, data.deadline,
+      request_.query_id());
+}
+
 Status QLWriteOperation::Apply(const DocOperationApplyData& data) {
   QLTableRow existing_row;
   if (request_.has_if_expr()) {
@@ -672,7 +899,8 @@ Status QLWriteOperation::Apply(const DocOperationApplyData& data) {
     }
 
     TEST_PAUSE_IF_FLAG(pause_write_apply_after_if);
-  } else if (RequireReadForExpressions(request_) || request_.returns_status()) {
+  } else if (!insert_new_row_ && !blind_increments_ &&
+             (RequireReadForExpressions(request_) || request_.returns_status())) {
     RETURN_NOT_OK(ReadColumns(data, nullptr, nullptr, &existing_row));
     if (request_.returns_status()) {
       RETURN_NOT_OK(PopulateStatusRow(data, /* should_apply = */ true, existing_row, &rowblock_));
@@ -715,6 +943,14 @@ Status QLWriteOperation::Apply(const DocOperationApplyData& data) {
     // primary key at least.
     case QLWriteRequestPB::QL_STMT_INSERT:
     case QLWriteRequestPB::QL_STMT_UPDATE: {
+      if (request_.type() == QLWriteRequestPB::QL_STMT_INSERT && CanPackRow(ttl, user_timestamp)) {
+        RETURN_NOT_OK(ApplyPackedRow(existing_row, data, &new_row));
+        if (update_indexes_) {
+          RETURN_NOT_OK(UpdateIndexes(existing_row, new_row));
+        }
+        break;
+      }
+
       // Add the appropriate liveness column only for inserts.
       // We never use init markers for QL to ensure we perform writes without any reads to
       // ensure our write path is fast while complicating the read path a bit.
@@ -742,7 +978,13 @@ Status QLWriteOperation::Apply(const DocOperationApplyData& data) {
             PrimitiveValue(column_id));
 
         QLValue expr_result;
-        if (!column_value.json_args().empty()) {
+        if (blind_increments_) {
+          const auto increment = Value(
+              PrimitiveValue(*CounterIncrement(schema_, column_value)), Value::kMaxTtl,
+              Value::kInvalidUserTimestamp, Value::kIncrementFlag);
+          RETURN_NOT_OK(data.doc_write_batch->SetPrimitive(
+              sub_path, increment, data.read_time, data.deadline, request_.query_id()));
+        } else if (!column_value.json_args().empty()) {
           RETURN_NOT_OK(ApplyForJsonOperators(column_value, data, sub_path, ttl,
                                               user_timestamp, column, &new_row));
         } else if (!column_value.subscript_args().empty()) {
@@ -787,6 +1029,19 @@ Status QLWriteOperation::Apply(const DocOperationApplyData& data) {
           RETURN_NOT_OK(UpdateIndexes(existing_row, new_row));
         }
       } else if (IsRangeOperation(request_, schema_)) {
+        const auto range_tombstone = RangeDeleteTombstone();
+        if (range_tombstone) {
+          // The rows the where condition matches are deleted by a single range tombstone,
+          // without reading them.
+          const DocPath sub_path(
+              encoded_hashed_doc_key_.as_slice(),
+              PrimitiveValue::SystemColumnId(SystemColumnIds::kRangeTombstone),
+              PrimitiveValue(range_tombstone->Encode()));
+          RETURN_NOT_OK(data.doc_write_batch->DeleteSubDoc(
+              sub_path, data.read_time, data.deadline, request_.query_id()));
+          break;
+        }
+
         // If the range columns are not specified, we read everything and delete all rows for
         // which the where condition matches.
 
@@ -882,6 +1137,16 @@ Status QLWriteOperation::DeleteRow(const DocPath& row_path, DocWriteBatch* doc_w
                                                 deadline,
                                                 request_.query_id(),
                                                 request_.user_timestamp_usec()));
+
+    // And the packed row, if the row was written as one.
+    const DocPath packed_row(
+        row_path.encoded_doc_key(),
+        PrimitiveValue::SystemColumnId(SystemColumnIds::kPackedRow));
+    RETURN_NOT_OK(doc_write_batch->DeleteSubDoc(packed_row,
+                                                read_ht,
+                                                deadline,
+                                                request_.query_id(),
+                                                request_.user_timestamp_usec()));
   } else {
     RETURN_NOT_OK(doc_write_batch->DeleteSubDoc(row_path, read_ht, deadline));
   }
@@ -1019,6 +1284,28 @@ Status QLWriteOperation::UpdateIndexes(const QLTableRow& existing_row, const QLT
   return Status::OK();
 }
 
+void PrepareIndexBackfillRequest(const IndexInfo& index, const QLTableRow& row,
+                                 UserTimeMicros user_timestamp, QLWriteRequestPB* request) {
+  request->set_type(QLWriteRequestPB::QL_STMT_INSERT);
+  request->set_user_timestamp_usec(user_timestamp);
+  for (size_t idx = 0; idx < index.key_column_count(); idx++) {
+    QLExpressionPB *key_column = NewKeyColumn(request, index, idx);
+    auto result = row.GetValue(index.column(idx).indexed_column_id);
+    if (result) {
+      key_column->mutable_value()->CopyFrom(*result);
+    }
+  }
+  for (size_t idx = index.key_column_count(); idx < index.columns().size(); idx++) {
+    const IndexInfo::IndexColumn& index_column = index.column(idx);
+    auto result = row.GetValue(index_column.indexed_column_id);
+    if (result) {
+      QLColumnValuePB* covering_column = request->add_column_values();
+      covering_column->set_column_id(index_column.column_id);
+      covering_column->mutable_expr()->mutable_value()->CopyFrom(*result);
+    }
+  }
+}
+
 Status QLReadOperation::Execute(const common::YQLStorageIf& ql_storage,
                                 CoarseTimePoint deadline,
                                 const ReadHybridTime& read_time,
@@ -1050,16 +1337,51 @@ Status QLReadOperation::Execute(const common::YQLStorageIf& ql_storage,
   const bool read_static_columns = !static_projection.columns().empty();
   const bool read_distinct_columns = request_.distinct();
 
+  if (request_.is_aggregate() && request_.group_by_hash_key()) {
+    // Groups are not split between pages, so all groups of the tablet are returned at once.
+    row_count_limit = std::numeric_limits<std::size_t>::max();
+    for (size_t i = 0; i < schema.num_hash_key_columns(); ++i) {
+      hash_column_ids_.push_back(schema.column_id(i));
+    }
+  }
+
+  // The scan of a paged read is kept open for the next page when the tablet keeps scan cursors.
+  // Transactional reads are not continued, since the intents iterator could wait for the status of
+  // a transaction until the deadline of the page that opened the scan.
+  std::unique_ptr<QLScanCursor> cursor;
+  if (scan_cursors_ != nullptr && QLScanCursors::Enabled() && !txn_op_context_ &&
+      request_.return_paging_state() && !request_.has_offset() && !request_.is_aggregate() &&
+      !read_static_columns && !read_distinct_columns) {
+    cursor = scan_cursors_->Take(request_);
+    if (!cursor) {
+      cursor = std::make_unique<QLScanCursor>(request_, projection);
+    }
+  }
+
   std::unique_ptr<common::YQLRowwiseIteratorIf> iter;
   std::unique_ptr<common::QLScanSpec> spec, static_row_spec;
   ReadHybridTime req_read_time;
-  RETURN_NOT_OK(ql_storage.BuildYQLScanSpec(
-      request_, read_time, schema, read_static_columns, static_projection, &spec,
-      &static_row_spec, &req_read_time));
-  RETURN_NOT_OK(ql_storage.GetIterator(request_, projection, schema, txn_op_context_,
-                                       deadline, req_read_time, *spec, &iter));
-  if (FLAGS_trace_docdb_calls) {
-    TRACE("Initialized iterator");
+  if (cursor && cursor->iter) {
+    iter = std::move(cursor->iter);
+    spec = std::move(cursor->spec);
+    req_read_time = cursor->read_time;
+    iter->SetDeadline(deadline);
+    if (FLAGS_trace_docdb_calls) {
+      TRACE("Continued iterator");
+    }
+  } else {
+    // The spec and iterator of a scan that could be continued refer to the copies of the request
+    // and projection kept by its cursor.
+    const auto& scan_request = cursor ? cursor->request : request_;
+    RETURN_NOT_OK(ql_storage.BuildYQLScanSpec(
+        scan_request, read_time, schema, read_static_columns, static_projection, &spec,
+        &static_row_spec, &req_read_time));
+    RETURN_NOT_OK(ql_storage.GetIterator(scan_request, cursor ? cursor->projection : projection,
+                                         schema, txn_op_context_, deadline, req_read_time, *spec,
+                                         &iter));
+    if (FLAGS_trace_docdb_calls) {
+      TRACE("Initialized iterator");
+    }
   }
 
   QLTableRow static_row;
@@ -1082,7 +1404,36 @@ Status QLReadOperation::Execute(const common::YQLStorageIf& ql_storage,
   // Begin the normal fetch.
   int match_count = 0;
   bool static_dealt_with = true;
+  // Whether the read stopped before the row count limit because its rows take too much memory.
+  bool memory_limited = false;
+  const bool may_page_early = mem_tracker_ != nullptr && request_.return_paging_state() &&
+                              !request_.is_aggregate();
+  // Whether the read stopped before the row count limit because it ran out of its time budget.
+  bool time_limited = false;
+  const auto time_budget_ms = FLAGS_ycql_scan_page_time_budget_ms;
+  const auto yield_time =
+      time_budget_ms > 0 && request_.return_paging_state() && !request_.is_aggregate()
+          ? CoarseMonoClock::now() + std::chrono::milliseconds(time_budget_ms)
+          : CoarseTimePoint::max();
   while (resultset->rsrow_count() < row_count_limit && iter->HasNext()) {
+    // Like with the memory limit, the page is not stopped before its first row or between a
+    // pending static row and the row that follows it.
+    if (yield_time != CoarseTimePoint::max() && static_dealt_with &&
+        resultset->rsrow_count() > 0 && CoarseMonoClock::now() >= yield_time) {
+      time_limited = true;
+      break;
+    }
+    if (mem_tracker_ != nullptr) {
+      mem_tracker_->SetCurrentResultSize(resultset->memory_usage());
+      RETURN_NOT_OK(mem_tracker_->CheckHardLimit());
+      // A pending static row is returned together with the row that follows it, so the page is
+      // not stopped between them. At least one row is returned, so the scan makes progress.
+      if (may_page_early && static_dealt_with && resultset->rsrow_count() > 0 &&
+          mem_tracker_->SoftLimitExceeded()) {
+        memory_limited = true;
+        break;
+      }
+    }
     const bool last_read_static = iter->IsNextStaticColumn();
 
     // Note that static columns are sorted before non-static columns in DocDB as follows. This is
@@ -1164,16 +1515,37 @@ Status QLReadOperation::Execute(const common::YQLStorageIf& ql_storage,
     RETURN_NOT_OK(PopulateAggregate(selected_row, resultset));
   }
 
+  if (mem_tracker_ != nullptr) {
+    mem_tracker_->SetCurrentResultSize(resultset->memory_usage());
+    RETURN_NOT_OK(mem_tracker_->CheckHardLimit());
+  }
+
   if (FLAGS_trace_docdb_calls) {
     TRACE("Fetched $0 rows.", resultset->rsrow_count());
   }
+  if (memory_limited) {
+    TRACE("Paging early at $0 bytes of rows", resultset->memory_usage());
+  }
+  if (time_limited) {
+    TRACE("Paging early after $0 ms with $1 rows", time_budget_ms, resultset->rsrow_count());
+  }
   *restart_read_ht = iter->RestartReadHt();
 
-  if ((resultset->rsrow_count() >= row_count_limit || request_.has_offset()) &&
-      !request_.is_aggregate()) {
+  if ((resultset->rsrow_count() >= row_count_limit || request_.has_offset() || memory_limited ||
+       time_limited) && !request_.is_aggregate()) {
     RETURN_NOT_OK(iter->SetPagingStateIfNecessary(request_, num_rows_skipped, &response_));
   }
 
+  if (cursor && response_.has_paging_state() &&
+      !response_.paging_state().next_row_key().empty()) {
+    cursor->iter = std::move(iter);
+    cursor->spec = std::move(spec);
+    cursor->read_time = req_read_time;
+    const auto& next_row_key = response_.paging_state().next_row_key();
+    response_.mutable_paging_state()->set_cursor_id(
+        scan_cursors_->Put(std::move(cursor), next_row_key));
+  }
+
   return Status::OK();
 }
 
@@ -1232,6 +1604,18 @@ Status QLReadOperation::PopulateAggregate(const QLTableRow& table_row, QLResultS
   return Status::OK();
 }
 
+Result<bool> QLReadOperation::StartGroup(const QLTableRow& row) {
+  bool same_group = !group_hash_key_.empty();
+  group_hash_key_.resize(hash_column_ids_.size());
+  for (size_t i = 0; i < hash_column_ids_.size(); ++i) {
+    QLValue value;
+    RETURN_NOT_OK(row.GetValue(hash_column_ids_[i], &value));
+    same_group = same_group && value == group_hash_key_[i];
+    group_hash_key_[i] = std::move(value);
+  }
+  return !same_group;
+}
+
 Status QLReadOperation::AddRowToResult(const std::unique_ptr<common::QLScanSpec>& spec,
                                        const QLTableRow& row,
                                        const size_t row_count_limit,
@@ -1246,6 +1630,12 @@ Status QLReadOperation::AddRowToResult(const std::unique_ptr<common::QLScanSpec>
       if (*num_rows_skipped >= offset) {
         (*match_count)++;
         if (request_.is_aggregate()) {
+          // Rows of a hash key are adjacent, so its group is finished when a row of another hash
+          // key is read.
+          if (!hash_column_ids_.empty() && VERIFY_RESULT(StartGroup(row)) && *match_count > 1) {
+            RETURN_NOT_OK(PopulateAggregate(row, resultset));
+            aggr_result_.clear();
+          }
           RETURN_NOT_OK(EvalAggregate(row));
         } else {
           RETURN_NOT_OK(PopulateResultSet(row, resultset));
@@ -14,12 +14,15 @@
 #ifndef YB_DOCDB_CQL_OPERATION_H
 #define YB_DOCDB_CQL_OPERATION_H
 
+#include <boost/optional.hpp>
+
 #include "yb/common/ql_protocol.pb.h"
 #include "yb/common/typedefs.h"
 
 #include "yb/docdb/doc_expr.h"
 #include "yb/docdb/doc_key.h"
 #include "yb/docdb/doc_operation.h"
+#include "yb/docdb/range_tombstone.h"
 
 namespace yb {
 
@@ -37,6 +40,9 @@ class YQLStorageIf;
 
 namespace docdb {
 
+class QLScanCursors;
+class QueryMemTracker;
+
 class QLWriteOperation :
     public DocOperationBase<DocOperationType::QL_WRITE_OPERATION, QLWriteRequestPB>,
     public DocExprExecutor {
@@ -85,6 +91,23 @@ class QLWriteOperation :
                                         const ColumnId& column_id,
                                         QLTableRow* new_row);
 
+  // Whether the row of an INSERT can be written as a single packed row entry, i.e. when all its
+  // non-key columns are plain scalar values without TTL or user timestamp, see PackedRow.
+  bool CanPackRow(const MonoDelta& ttl, const UserTimeMicros& user_timestamp) const;
+
+  // Whether all the columns of an UPDATE are counter increments that can be written without
+  // reading the current values of the counters.
+  bool CanIncrementBlindly() const;
+
+  // Returns the range tombstone that deletes the rows of a range DELETE, or none if the DELETE has
+  // to be applied row by row, see RangeTombstone.
+  boost::optional<RangeTombstone> RangeDeleteTombstone() const;
+
+  // Writes the columns of an INSERT and the liveness of its row as a single packed row entry.
+  CHECKED_STATUS ApplyPackedRow(const QLTableRow& current_row,
+                                const DocOperationApplyData& data,
+                                QLTableRow* new_row);
+
   const QLWriteRequestPB& request() const { return request_; }
   QLResponsePB* response() const { return response_; }
 
@@ -164,9 +187,16 @@ class QLWriteOperation :
   // Does this write operation require a read?
   bool require_read_ = false;
 
+  // Is this an update of counters written as increments, without reading their current values?
+  bool blind_increments_ = false;
+
   // Any indexes that may need update?
   bool update_indexes_ = false;
 
+  // Is this an insert of a row that the client guarantees to be new, so the existing row does not
+  // have to be read?
+  bool insert_new_row_ = false;
+
   // Is this an insert into a unique index?
   bool insert_into_unique_index_ = false;
 
@@ -204,14 +234,36 @@ class QLReadOperation : public DocExprExecutor {
 
   CHECKED_STATUS GetIntents(const Schema& schema, KeyValueWriteBatchPB* out);
 
+  // Remembers the hash key of the row when the request groups aggregates by hash key. Returns true
+  // when the row starts a new group.
+  Result<bool> StartGroup(const QLTableRow& row);
+
   QLResponsePB& response() { return response_; }
 
+  // Scan cursors of the tablet, that are used to continue paged reads when set.
+  void set_scan_cursors(QLScanCursors* scan_cursors) { scan_cursors_ = scan_cursors; }
+
+  // Tracker of the read request the result rows are charged to, if any.
+  void set_mem_tracker(QueryMemTracker* mem_tracker) { mem_tracker_ = mem_tracker; }
+
  private:
   const QLReadRequestPB& request_;
   const TransactionOperationContextOpt txn_op_context_;
+  QLScanCursors* scan_cursors_ = nullptr;
+  QueryMemTracker* mem_tracker_ = nullptr;
   QLResponsePB response_;
+  // Hash key columns and values of the current group when aggregates are grouped by hash key.
+  std::vector<ColumnId> hash_column_ids_;
+  std::vector<QLValue> group_hash_key_;
 };
 
+// Fills request with the insert of the entry of the existing row of the indexed table into the
+// index, with the given user timestamp. Used by index backfill, whose entries are older than the
+// read time of the backfill scan, so they do not overwrite entries of later writes of the row that
+// the index maintenance of the indexed table has already written.
+void PrepareIndexBackfillRequest(const IndexInfo& index, const QLTableRow& row,
+                                 UserTimeMicros user_timestamp, QLWriteRequestPB* request);
+
 }  // namespace docdb
 }  // namespace yb
 
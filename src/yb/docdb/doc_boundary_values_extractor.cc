@@ -13,10 +13,15 @@
 //
 //
 
+#include "yb/rocksdb/db/compaction.h"
 #include "yb/rocksdb/db/dbformat.h"
+#include "yb/rocksdb/db/version_edit.h"
+#include "yb/rocksdb/table/data_block_boundaries.h"
 
 #include "yb/docdb/consensus_frontier.h"
 #include "yb/docdb/doc_key.h"
+#include "yb/docdb/doc_kv_util.h"
+#include "yb/docdb/value.h"
 
 namespace yb {
 namespace docdb {
@@ -30,6 +35,8 @@ Status GetPrimitiveValue(const rocksdb::UserBoundaryValues& values,
 namespace {
 
 constexpr rocksdb::UserBoundaryTag kDocHybridTimeTag = 1;
+// Largest explicit value level TTL, present only in files that have values with TTL.
+constexpr rocksdb::UserBoundaryTag kValueTtlTag = 2;
 // Here we reserve some tags for future use.
 // Because Tag is persistent.
 constexpr rocksdb::UserBoundaryTag kRangeComponentsStart = 10;
@@ -80,6 +87,45 @@ class DocHybridTimeValue : public rocksdb::UserBoundaryValue {
   Slice encoded_;
 };
 
+// Wrapper for UserBoundaryValue that stores value level TTL in milliseconds, big endian encoded
+// so that values are compared bytewise. TTL that never expires is stored as the max value.
+class ValueTtlBoundaryValue : public rocksdb::UserBoundaryValue {
+ public:
+  static constexpr uint64_t kNeverExpires = std::numeric_limits<uint64_t>::max();
+
+  explicit ValueTtlBoundaryValue(uint64_t ttl_ms) {
+    BigEndian::Store64(buffer_, ttl_ms);
+  }
+
+  static CHECKED_STATUS Create(Slice data, rocksdb::UserBoundaryValuePtr* value) {
+    CHECK_NOTNULL(value);
+    if (data.size() != sizeof(uint64_t)) {
+      return STATUS_SUBSTITUTE(Corruption, "Wrong encoded value TTL size: $0", data.size());
+    }
+
+    *value = std::make_shared<ValueTtlBoundaryValue>(BigEndian::Load64(data.data()));
+    return Status::OK();
+  }
+
+  virtual ~ValueTtlBoundaryValue() {}
+
+  rocksdb::UserBoundaryTag Tag() override {
+    return kValueTtlTag;
+  }
+
+  Slice Encode() override {
+    return Slice(buffer_, sizeof(buffer_));
+  }
+
+  int CompareTo(const UserBoundaryValue& pre_rhs) override {
+    const auto* rhs = down_cast<const ValueTtlBoundaryValue*>(&pre_rhs);
+    return Slice(buffer_, sizeof(buffer_)).compare(Slice(rhs->buffer_, sizeof(rhs->buffer_)));
+  }
+
+ private:
+  char buffer_[sizeof(uint64_t)];
+};
+
 // Wrapper for UserBoundaryValue that stores PrimitiveValue with index.
 class PrimitiveBoundaryValue : public rocksdb::UserBoundaryValue {
  public:
@@ -147,6 +193,9 @@ class DocBoundaryValuesExtractor : public rocksdb::BoundaryValuesExtractor {
     if (tag == kDocHybridTimeTag) {
       return DocHybridTimeValue::Create(data, value);
     }
+    if (tag == kValueTtlTag) {
+      return ValueTtlBoundaryValue::Create(data, value);
+    }
     if (tag >= kRangeComponentsStart) {
       return PrimitiveBoundaryValue::Create(tag - kRangeComponentsStart, data, value);
     }
@@ -182,6 +231,14 @@ class DocBoundaryValuesExtractor : public rocksdb::BoundaryValuesExtractor {
       values->push_back(std::move(temp));
     }
 
+    MonoDelta ttl;
+    RETURN_NOT_OK(Value::DecodeTTL(value, &ttl));
+    if (!ttl.Equals(Value::kMaxTtl)) {
+      values->push_back(std::make_shared<ValueTtlBoundaryValue>(
+          ttl.Equals(Value::kResetTtl) ? ValueTtlBoundaryValue::kNeverExpires
+                                       : static_cast<uint64_t>(ttl.ToMilliseconds())));
+    }
+
     DCHECK(PerformSanityCheck(user_key, slices, *values));
 
     return Status::OK();
@@ -256,5 +313,68 @@ rocksdb::UserBoundaryTag TagForRangeComponent(size_t index) {
   return PrimitiveBoundaryValue::TagForIndex(index);
 }
 
+namespace {
+
+bool IsFileExpired(
+    const Slice* largest_doc_ht, const Slice* largest_value_ttl, MonoDelta table_ttl,
+    HybridTime cutoff) {
+  if (largest_doc_ht == nullptr || table_ttl.Equals(Value::kMaxTtl) || !cutoff.is_valid()) {
+    return false;
+  }
+  DocHybridTime doc_ht;
+  if (!doc_ht.FullyDecodeFrom(*largest_doc_ht).ok()) {
+    return false;
+  }
+  // Values without explicit TTL expire according to the table TTL, so the file expires once both
+  // the table TTL and the largest value TTL have passed since its newest record.
+  auto ttl = table_ttl;
+  if (largest_value_ttl != nullptr) {
+    if (largest_value_ttl->size() != sizeof(uint64_t)) {
+      return false;
+    }
+    const auto value_ttl_ms = BigEndian::Load64(largest_value_ttl->data());
+    if (value_ttl_ms > static_cast<uint64_t>(std::numeric_limits<int64_t>::max())) {
+      return false;
+    }
+    ttl = std::max(ttl, MonoDelta::FromMilliseconds(value_ttl_ms));
+  }
+  bool has_expired = false;
+  return HasExpiredTTL(doc_ht.hybrid_time(), ttl, cutoff, &has_expired).ok() && has_expired;
+}
+
+Slice* AsSlice(const rocksdb::UserBoundaryValuePtr& value, Slice* buffer) {
+  if (!value) {
+    return nullptr;
+  }
+  *buffer = value->Encode();
+  return buffer;
+}
+
+} // namespace
+
+bool IsFileExpired(const rocksdb::FdWithBoundaries& file, MonoDelta table_ttl, HybridTime cutoff) {
+  return IsFileExpired(file.largest.user_value_with_tag(kDocHybridTimeTag),
+                       file.largest.user_value_with_tag(kValueTtlTag), table_ttl, cutoff);
+}
+
+bool IsBlockWrittenAfter(const rocksdb::DataBlockBoundaries& block, HybridTime limit) {
+  const auto* smallest_doc_ht = block.smallest.user_value_with_tag(kDocHybridTimeTag);
+  if (smallest_doc_ht == nullptr || !limit.is_valid()) {
+    return false;
+  }
+  DocHybridTime doc_ht;
+  return doc_ht.FullyDecodeFrom(*smallest_doc_ht).ok() && doc_ht.hybrid_time() > limit;
+}
+
+bool IsFileExpired(const rocksdb::FileMetaData& file, MonoDelta table_ttl, HybridTime cutoff) {
+  Slice doc_ht_buffer, value_ttl_buffer;
+  return IsFileExpired(
+      AsSlice(rocksdb::UserValueWithTag(file.largest.user_values, kDocHybridTimeTag),
+              &doc_ht_buffer),
+      AsSlice(rocksdb::UserValueWithTag(file.largest.user_values, kValueTtlTag),
+              &value_ttl_buffer),
+      table_ttl, cutoff);
+}
+
 } // namespace docdb
 } // namespace yb
@@ -156,6 +156,65 @@ CHECKED_STATUS DocExprExecutor::EvalTSCall(const QLBCallPB& tscall,
 
 //--------------------------------------------------------------------------------------------------
 
+CHECKED_STATUS DocExprExecutor::EvalTSCall(const PgsqlBCallPB& tscall,
+                                           const QLTableRow::SharedPtrConst& table_row,
+                                           QLValue *result) {
+  bfpg::TSOpcode tsopcode = static_cast<bfpg::TSOpcode>(tscall.opcode());
+  switch (tsopcode) {
+    case bfpg::TSOpcode::kCount:
+      if (tscall.operands_size() > 0 && tscall.operands(0).has_column_id()) {
+        // Check if column value is NULL. SQL does not count NULL value of a column.
+        QLValue arg_result;
+        RETURN_NOT_OK(EvalExpr(tscall.operands(0), table_row, &arg_result));
+        if (arg_result.IsNull()) {
+          return Status::OK();
+        }
+      }
+      return EvalCount(result);
+
+    case bfpg::TSOpcode::kSum: {
+      QLValue arg_result;
+      RETURN_NOT_OK(EvalExpr(tscall.operands(0), table_row, &arg_result));
+      // Postgres sums smaller integers as bigint, so accumulate them as int64 to avoid overflow.
+      switch (arg_result.type()) {
+        case InternalType::kInt8Value:
+          arg_result.set_int64_value(arg_result.int8_value());
+          break;
+        case InternalType::kInt16Value:
+          arg_result.set_int64_value(arg_result.int16_value());
+          break;
+        case InternalType::kInt32Value:
+          arg_result.set_int64_value(arg_result.int32_value());
+          break;
+        default:
+          break;
+      }
+      return EvalSum(arg_result, result);
+    }
+
+    case bfpg::TSOpcode::kMin: {
+      QLValue arg_result;
+      RETURN_NOT_OK(EvalExpr(tscall.operands(0), table_row, &arg_result));
+      return EvalMin(arg_result, result);
+    }
+
+    case bfpg::TSOpcode::kMax: {
+      QLValue arg_result;
+      RETURN_NOT_OK(EvalExpr(tscall.operands(0), table_row, &arg_result));
+      return EvalMax(arg_result, result);
+    }
+
+    default:
+      break;
+  }
+
+  result->SetNull();
+  return STATUS_FORMAT(NotSupported, "Tablet server operator $0 is not supported for YSQL",
+                       static_cast<int>(tsopcode));
+}
+
+//--------------------------------------------------------------------------------------------------
+
 CHECKED_STATUS DocExprExecutor::EvalCount(QLValue *aggr_count) {
   if (aggr_count->IsNull()) {
     aggr_count->set_int64_value(1);
@@ -95,6 +95,25 @@ void TestRoundTripDocOrSubDocKeyEncodingDecoding() {
   }
 }
 
+// Decodes keys of different shapes into the same object, as the read path does, and checks that
+// there are no leftovers from previously decoded keys.
+template <typename DocOrSubDocKey>
+void TestDecodingIntoReusedDocOrSubDocKey() {
+  RandomNumberGenerator rng;  // Use the default seed to keep it deterministic.
+  std::vector<DocOrSubDocKey> keys;
+  for (auto use_hash : UseHash::kValues) {
+    auto batch = GenRandomDocOrSubDocKeys<DocOrSubDocKey>(
+        &rng, use_hash, kNumDocOrSubDocKeysPerBatch);
+    keys.insert(keys.end(), batch.begin(), batch.end());
+  }
+  DocOrSubDocKey decoded_key;
+  for (int k = 0; k < kNumTestDocOrSubDocKeyComparisons; ++k) {
+    const auto& key = keys[rng() % keys.size()];
+    ASSERT_OK(decoded_key.FullyDecodeFrom(key.Encode().AsSlice()));
+    ASSERT_EQ(key, decoded_key);
+  }
+}
+
 template <typename DocOrSubDocKey>
 void TestDocOrSubDocKeyComparison() {
   RandomNumberGenerator rng;  // Use the default seed to keep it deterministic.
@@ -277,6 +296,14 @@ TEST(DocKeyTest, TestRandomizedSubDocKeyRoundTripEncodingDecoding) {
   TestRoundTripDocOrSubDocKeyEncodingDecoding<SubDocKey>();
 }
 
+TEST(DocKeyTest, TestDecodingIntoReusedDocKey) {
+  TestDecodingIntoReusedDocOrSubDocKey<DocKey>();
+}
+
+TEST(DocKeyTest, TestDecodingIntoReusedSubDocKey) {
+  TestDecodingIntoReusedDocOrSubDocKey<SubDocKey>();
+}
+
 TEST(DocKeyTest, TestDocKeyComparison) {
   TestDocOrSubDocKeyComparison<DocKey>();
 }
@@ -373,6 +400,99 @@ TEST(DocKeyTest, TestKeyMatching) {
   ASSERT_FALSE(may_match(EncodeSimpleSubDocKey(absent_key))) << "Key: " << absent_key;
 }
 
+TEST(DocKeyTest, TestRangeComponentsKeyMatching) {
+  DocDbAwareFilterPolicy policy(
+      rocksdb::FilterPolicy::kDefaultFixedSizeFilterBits, nullptr, 1 /* num_range_components */);
+  ASSERT_STRNE(
+      DocDbAwareFilterPolicy(rocksdb::FilterPolicy::kDefaultFixedSizeFilterBits, nullptr).Name(),
+      policy.Name());
+  const auto* transformer = policy.GetKeyTransformer();
+  auto encode = [](const std::string& first, int second) {
+    return SubDocKey(DocKey(PrimitiveValues(first, second)), PrimitiveValue("sub_key"),
+                     HybridTime::FromMicros(1000)).Encode().AsStringRef();
+  };
+
+  std::unique_ptr<FilterBitsBuilder> builder(policy.GetFilterBitsBuilder());
+  for (const auto& key : { "foo", "bar", "test" }) {
+    builder->AddKey(transformer->Transform(encode(key, 1)));
+  }
+  std::unique_ptr<const char[]> buf;
+  rocksdb::Slice filter = builder->Finish(&buf);
+  std::unique_ptr<FilterBitsReader> reader(policy.GetFilterBitsReader(filter));
+
+  auto may_match = [&](const std::string& key) {
+    return reader->MayMatch(transformer->Transform(key));
+  };
+
+  // Only the first range component is taken into account.
+  ASSERT_TRUE(may_match(encode("foo", 1)));
+  ASSERT_TRUE(may_match(encode("bar", 2)));
+  ASSERT_FALSE(may_match(encode("fake", 1)));
+
+  // Bounds of reads that could match any value of the first range component are not filtered.
+  const auto prefix_key = DocKey(PrimitiveValues("foo")).Encode();
+  ASSERT_TRUE(transformer->InDomain(prefix_key.AsSlice()));
+  ASSERT_FALSE(transformer->InDomain(DocKey().Encode().AsSlice()));
+  ASSERT_EQ(transformer->Transform(prefix_key.AsSlice()).ToBuffer(),
+            transformer->Transform(encode("foo", 3)).ToBuffer());
+}
+
+TEST(DocKeyTest, TestPrefixTransform) {
+  DocKeyPrefixTransform transform;
+
+  // Keys of the same hashed components share a prefix regardless of the rest of the key.
+  const auto hashed_prefix = transform.Transform(EncodeSimpleSubDocKey("foo")).ToBuffer();
+  ASSERT_EQ(hashed_prefix,
+            transform.Transform(EncodeSimpleSubDocKeyWithDifferentNonHashPart("foo")).ToBuffer());
+  const auto doc_key_encoded =
+      DocKey(0, PrimitiveValues("foo"), PrimitiveValues("x")).Encode().AsSlice().ToBuffer();
+  ASSERT_LT(hashed_prefix.size(), doc_key_encoded.size());
+  ASSERT_EQ(hashed_prefix, doc_key_encoded.substr(0, hashed_prefix.size()));
+  ASSERT_NE(hashed_prefix, transform.Transform(EncodeSimpleSubDocKey("bar")).ToBuffer());
+
+  // Without hashed components the whole DocKey is used.
+  const DocKey range_doc_key(PrimitiveValues("range_key", 10));
+  const auto range_prefix = transform.Transform(
+      SubDocKey(range_doc_key, PrimitiveValue("sub_key"), HybridTime::FromMicros(1000))
+          .Encode().AsSlice()).ToBuffer();
+  ASSERT_EQ(range_doc_key.Encode().AsSlice().ToBuffer(), range_prefix);
+}
+
+TEST(DocKeyTest, TestSubDocKeyWithoutHybridTimeTransform) {
+  SubDocKeyWithoutHybridTimeTransform transform;
+
+  const SubDocKey key(DocKey(PrimitiveValues("a", 1)), DocHybridTime(1000000, 4091, 5),
+                      {PrimitiveValue("sub_key")});
+  const auto encoded = key.Encode();
+  ASSERT_TRUE(transform.InDomain(encoded.AsSlice()));
+  ASSERT_EQ(key.EncodeWithoutHt().AsSlice().ToBuffer(),
+            transform.Transform(encoded.AsSlice()).ToBuffer());
+
+  // Versions of the same key have the same prefix.
+  const SubDocKey other_version(key.doc_key(), PrimitiveValue("sub_key"),
+                                HybridTime::FromMicros(2000));
+  ASSERT_EQ(transform.Transform(encoded.AsSlice()).ToBuffer(),
+            transform.Transform(other_version.Encode().AsSlice()).ToBuffer());
+
+  ASSERT_FALSE(transform.InDomain(key.EncodeWithoutHt().AsSlice()));
+  ASSERT_FALSE(transform.InDomain(Slice()));
+}
+
+TEST(DocKeyTest, TestSubDocKeyAppendTo) {
+  const SubDocKey key(DocKey(PrimitiveValues("a", 1)), DocHybridTime(1000000, 4091, 5),
+                      {PrimitiveValue("sub_key")});
+  KeyBytes buffer;
+  key.AppendTo(&buffer);
+  ASSERT_EQ(key.Encode().data(), buffer.data());
+
+  // The buffer is reused, the encoded key is appended to its current content.
+  buffer.Clear();
+  buffer.AppendValueType(ValueType::kMaxByte);
+  key.AppendToWithoutHt(&buffer);
+  ASSERT_EQ(std::string(1, ValueTypeAsChar::kMaxByte) + key.EncodeWithoutHt().data(),
+            buffer.data());
+}
+
 TEST(DocKeyTest, TestWriteId) {
   SubDocKey subdoc_key(DocKey({PrimitiveValue("a"), PrimitiveValue(135)}),
                        DocHybridTime(1000000, 4091, 135));
@@ -86,6 +86,25 @@ Status ConsumePrimitiveValuesFromKey(rocksdb::Slice* slice,
   });
 }
 
+// Decodes a group of primitive values into the existing elements of values, so the storage of
+// previously decoded components (including string buffers) is reused. values is resized to the
+// number of decoded components.
+struct ReusedPrimitiveValues {
+  std::vector<PrimitiveValue>* values;
+};
+
+Status ConsumePrimitiveValuesFromKey(rocksdb::Slice* slice, ReusedPrimitiveValues out) {
+  size_t size = 0;
+  auto status = ConsumePrimitiveValuesFromKey(slice, [slice, &out, &size] {
+    if (size == out.values->size()) {
+      out.values->emplace_back();
+    }
+    return (*out.values)[size++].DecodeFromKey(slice);
+  });
+  out.values->resize(size);
+  return status;
+}
+
 void AppendDocKeyItems(const vector<PrimitiveValue>& doc_key_items, KeyBytes* result) {
   for (const PrimitiveValue& item : doc_key_items) {
     item.AppendToKey(result);
@@ -279,12 +298,12 @@ class DocKey::DecodeFromCallback {
   explicit DecodeFromCallback(DocKey* key) : key_(key) {
   }
 
-  std::vector<PrimitiveValue>* hashed_group() const {
-    return &key_->hashed_group_;
+  ReusedPrimitiveValues hashed_group() const {
+    return ReusedPrimitiveValues{&key_->hashed_group_};
   }
 
-  std::vector<PrimitiveValue>* range_group() const {
-    return &key_->range_group_;
+  ReusedPrimitiveValues range_group() const {
+    return ReusedPrimitiveValues{&key_->range_group_};
   }
 
   void SetHash(bool present, DocKeyHash hash = 0) const {
@@ -302,9 +321,23 @@ class DocKey::DecodeFromCallback {
 };
 
 yb::Status DocKey::DecodeFrom(rocksdb::Slice *slice, DocKeyPart part_to_decode) {
-  Clear();
+  // Component vectors are not cleared here, so that the same DocKey could be used to decode a
+  // sequence of keys without reallocating its components.
+  hash_present_ = false;
+  hash_ = 0xdead;
 
-  return DoDecode(slice, part_to_decode, DecodeFromCallback(this));
+  auto status = DoDecode(slice, part_to_decode, DecodeFromCallback(this));
+  if (!status.ok()) {
+    Clear();
+    return status;
+  }
+  if (!hash_present_) {
+    hashed_group_.clear();
+  }
+  if (part_to_decode == DocKeyPart::HASHED_PART_ONLY) {
+    range_group_.clear();
+  }
+  return Status::OK();
 }
 
 Result<size_t> DocKey::DecodeFrom(const rocksdb::Slice& slice, DocKeyPart part_to_decode) {
@@ -470,14 +503,19 @@ KeyBytes DocKey::EncodedFromRedisKey(uint16_t hash, const std::string &key) {
 // ------------------------------------------------------------------------------------------------
 
 KeyBytes SubDocKey::DoEncode(bool include_hybrid_time) const {
-  KeyBytes key_bytes = doc_key_.Encode();
+  KeyBytes key_bytes;
+  DoAppendTo(include_hybrid_time, &key_bytes);
+  return key_bytes;
+}
+
+void SubDocKey::DoAppendTo(bool include_hybrid_time, KeyBytes* out) const {
+  doc_key_.AppendTo(out);
   for (const auto& subkey : subkeys_) {
-    subkey.AppendToKey(&key_bytes);
+    subkey.AppendToKey(out);
   }
   if (has_hybrid_time() && include_hybrid_time) {
-    AppendDocHybridTime(doc_ht_, &key_bytes);
+    AppendDocHybridTime(doc_ht_, out);
   }
-  return key_bytes;
 }
 
 namespace {
@@ -522,9 +560,16 @@ class SubDocKey::DecodeCallback {
     return key_->doc_key_.DecodeFrom(slice);
   }
 
+  // Reuses subkeys left from the previously decoded key, see Finish.
   PrimitiveValue* AddSubkey() const {
-    key_->subkeys_.emplace_back();
-    return &key_->subkeys_.back();
+    if (num_subkeys_ == key_->subkeys_.size()) {
+      key_->subkeys_.emplace_back();
+    }
+    return &key_->subkeys_[num_subkeys_++];
+  }
+
+  void Finish() const {
+    key_->subkeys_.resize(num_subkeys_);
   }
 
   DocHybridTime& doc_hybrid_time() const {
@@ -535,11 +580,19 @@ class SubDocKey::DecodeCallback {
   }
  private:
   SubDocKey* key_;
+  mutable size_t num_subkeys_ = 0;
 };
 
 Status SubDocKey::DecodeFrom(rocksdb::Slice* slice, HybridTimeRequired require_hybrid_time) {
-  Clear();
-  return DoDecode(slice, require_hybrid_time, DecodeCallback(this));
+  doc_ht_ = DocHybridTime::kInvalid;
+  DecodeCallback callback(this);
+  auto status = DoDecode(slice, require_hybrid_time, callback);
+  if (!status.ok()) {
+    Clear();
+    return status;
+  }
+  callback.Finish();
+  return Status::OK();
 }
 
 Result<bool> SubDocKey::DecodeSubkey(Slice* slice) {
@@ -815,8 +868,57 @@ class HashedComponentsExtractor : public rocksdb::FilterPolicy::KeyTransformer {
   }
 };
 
+// Returns the size of the hashed part of the encoded DocKey followed by at most
+// num_range_components of its range components, and whether the key has that many range
+// components. When it has less, the size also covers the end of the range group.
+Result<std::pair<size_t, bool>> EncodedRangePrefixSize(Slice key, size_t num_range_components) {
+  auto slice = key;
+  slice.remove_prefix(VERIFY_RESULT(DocKey::EncodedSize(key, DocKeyPart::HASHED_PART_ONLY)));
+  for (size_t i = 0; i != num_range_components; ++i) {
+    if (!VERIFY_RESULT(HasPrimitiveValue(&slice))) {
+      return std::make_pair(static_cast<size_t>(slice.data() - key.data()), false);
+    }
+    RETURN_NOT_OK(PrimitiveValue::DecodeKey(&slice, nullptr /* out */));
+  }
+  return std::make_pair(static_cast<size_t>(slice.data() - key.data()), true);
+}
+
+class RangeComponentsExtractor : public rocksdb::FilterPolicy::KeyTransformer {
+ public:
+  explicit RangeComponentsExtractor(size_t num_range_components)
+      : num_range_components_(num_range_components) {}
+
+  Slice Transform(Slice key) const override {
+    auto size = CHECK_RESULT(EncodedRangePrefixSize(key, num_range_components_)).first;
+    return Slice(key.data(), size);
+  }
+
+  // Reads of keys with less range components could look for records with any value of the
+  // missing components.
+  bool InDomain(Slice key) const override {
+    auto size = EncodedRangePrefixSize(key, num_range_components_);
+    return size.ok() && size->second;
+  }
+
+ private:
+  const size_t num_range_components_;
+};
+
 } // namespace
 
+DocDbAwareFilterPolicy::DocDbAwareFilterPolicy(
+    size_t filter_block_size_bits, rocksdb::Logger* logger, size_t num_range_components)
+    : builtin_policy_(rocksdb::NewFixedSizeFilterPolicy(
+          filter_block_size_bits, rocksdb::FilterPolicy::kDefaultFixedSizeFilterErrorRate, logger)),
+      name_("DocKeyHashedComponentsFilter") {
+  if (num_range_components != 0) {
+    range_components_extractor_ = std::make_unique<RangeComponentsExtractor>(num_range_components);
+    name_ += Format("+$0RangeComponents", num_range_components);
+  }
+}
+
+DocDbAwareFilterPolicy::~DocDbAwareFilterPolicy() = default;
+
 
 void DocDbAwareFilterPolicy::CreateFilter(
     const rocksdb::Slice* keys, int n, std::string* dst) const {
@@ -843,9 +945,47 @@ rocksdb::FilterPolicy::FilterType DocDbAwareFilterPolicy::GetFilterType() const
 }
 
 const rocksdb::FilterPolicy::KeyTransformer* DocDbAwareFilterPolicy::GetKeyTransformer() const {
+  if (range_components_extractor_) {
+    return range_components_extractor_.get();
+  }
   return &HashedComponentsExtractor::GetInstance();
 }
 
+// ------------------------------------------------------------------------------------------------
+// DocKeyPrefixTransform
+// ------------------------------------------------------------------------------------------------
+
+Slice DocKeyPrefixTransform::Transform(const Slice& key) const {
+  auto hashed_part_size = DocKey::EncodedSize(key, DocKeyPart::HASHED_PART_ONLY);
+  if (!hashed_part_size.ok()) {
+    return Slice();
+  }
+  if (*hashed_part_size != 0) {
+    return Slice(key.data(), *hashed_part_size);
+  }
+  auto doc_key_size = DocKey::EncodedSize(key, DocKeyPart::WHOLE_DOC_KEY);
+  return doc_key_size.ok() ? Slice(key.data(), *doc_key_size) : Slice();
+}
+
+// ------------------------------------------------------------------------------------------------
+// SubDocKeyWithoutHybridTimeTransform
+// ------------------------------------------------------------------------------------------------
+
+Slice SubDocKeyWithoutHybridTimeTransform::Transform(const Slice& key) const {
+  int encoded_ht_size = 0;
+  CHECK_OK(DocHybridTime::CheckAndGetEncodedSize(key, &encoded_ht_size));
+  return Slice(key.data(), key.size() - encoded_ht_size - 1);
+}
+
+bool SubDocKeyWithoutHybridTimeTransform::InDomain(const Slice& key) const {
+  int encoded_ht_size = 0;
+  if (!DocHybridTime::CheckAndGetEncodedSize(key, &encoded_ht_size).ok() ||
+      key.size() <= static_cast<size_t>(encoded_ht_size)) {
+    return false;
+  }
+  return key[key.size() - encoded_ht_size - 1] == ValueTypeAsChar::kHybridTime;
+}
+
 }  // namespace docdb
 
 }  // namespace yb
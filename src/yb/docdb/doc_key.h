@@ -21,6 +21,7 @@
 
 #include "yb/rocksdb/env.h"
 #include "yb/rocksdb/filter_policy.h"
+#include "yb/rocksdb/slice_transform.h"
 
 #include "yb/common/schema.h"
 
@@ -337,6 +338,12 @@ class SubDocKey {
   KeyBytes Encode() const { return DoEncode(true /* include_hybrid_time */); }
   KeyBytes EncodeWithoutHt() const { return DoEncode(false /* include_hybrid_time */); }
 
+  // Append the encoded key to out, so callers encoding many keys could reuse one buffer.
+  void AppendTo(KeyBytes* out) const { DoAppendTo(true /* include_hybrid_time */, out); }
+  void AppendToWithoutHt(KeyBytes* out) const {
+    DoAppendTo(false /* include_hybrid_time */, out);
+  }
+
   // Decodes a SubDocKey from the given slice, typically retrieved from a RocksDB key.
   // @param slice
   //     A pointer to the slice containing the bytes to decode the SubDocKey from. This slice is
@@ -529,6 +536,7 @@ class SubDocKey {
                          const Callback& callback);
 
   KeyBytes DoEncode(bool include_hybrid_time) const;
+  void DoAppendTo(bool include_hybrid_time, KeyBytes* out) const;
 
   DocKey doc_key_;
   DocHybridTime doc_ht_;
@@ -547,15 +555,18 @@ inline std::ostream& operator <<(std::ostream& out, const SubDocKey& subdoc_key)
 std::string BestEffortDocDBKeyToStr(const KeyBytes &key_bytes);
 std::string BestEffortDocDBKeyToStr(const rocksdb::Slice &slice);
 
-// This filter policy only takes into account hashed components of keys for filtering.
+// This filter policy only takes into account hashed components of keys for filtering, followed by
+// the first num_range_components range components when num_range_components is not zero. The
+// number of range components is a part of the policy name, so filters written with a different
+// number of range components are not used.
 class DocDbAwareFilterPolicy : public rocksdb::FilterPolicy {
  public:
-  explicit DocDbAwareFilterPolicy(size_t filter_block_size_bits, rocksdb::Logger* logger) {
-    builtin_policy_.reset(rocksdb::NewFixedSizeFilterPolicy(
-        filter_block_size_bits, rocksdb::FilterPolicy::kDefaultFixedSizeFilterErrorRate, logger));
-  }
+  DocDbAwareFilterPolicy(
+      size_t filter_block_size_bits, rocksdb::Logger* logger, size_t num_range_components = 0);
 
-  const char* Name() const override { return "DocKeyHashedComponentsFilter"; }
+  ~DocDbAwareFilterPolicy();
+
+  const char* Name() const override { return name_.c_str(); }
 
   void CreateFilter(const rocksdb::Slice* keys, int n, std::string* dst) const override;
 
@@ -571,12 +582,50 @@ class DocDbAwareFilterPolicy : public rocksdb::FilterPolicy {
 
  private:
   std::unique_ptr<const rocksdb::FilterPolicy> builtin_policy_;
+  std::unique_ptr<const KeyTransformer> range_components_extractor_;
+  std::string name_;
 };
 
+// Maps a RocksDB user key to the prefix identifying its document: the hash code and hashed
+// components of the encoded DocKey, or the whole DocKey when there are no hashed components.
+// Keys that could not be decoded as a DocKey are mapped to an empty prefix.
+class DocKeyPrefixTransform : public rocksdb::SliceTransform {
+ public:
+  const char* Name() const override { return "DocKeyPrefixTransform"; }
+
+  Slice Transform(const Slice& key) const override;
+
+  bool InDomain(const Slice& key) const override { return true; }
+
+  bool InRange(const Slice& prefix) const override { return false; }
+};
+
+// Maps a RocksDB user key to the key without its encoded hybrid time, i.e. to the encoded
+// SubDocKey, used as the key of the data block hash index. Keys without a hybrid time at the end
+// are not in the domain. No key starts with the SubDocKey of another key followed by
+// ValueType::kHybridTime, so the keys of a SubDocKey are contiguous as the index requires.
+class SubDocKeyWithoutHybridTimeTransform : public rocksdb::SliceTransform {
+ public:
+  const char* Name() const override { return "SubDocKeyWithoutHybridTimeTransform"; }
+
+  Slice Transform(const Slice& key) const override;
+
+  bool InDomain(const Slice& key) const override;
+
+  bool InRange(const Slice& prefix) const override { return false; }
+};
+
+class DocRowCache;
+class IntentIndex;
+
 // Combined DB to store regular records and intents.
 struct DocDB {
   rocksdb::DB* regular;
   rocksdb::DB* intents;
+  // Cache of rows read by point reads of the regular DB, if enabled.
+  DocRowCache* row_cache = nullptr;
+  // Index of the intents DB used by conflict resolution, if enabled.
+  IntentIndex* intent_index = nullptr;
 
   static DocDB FromRegular(rocksdb::DB* regular) {
     return {regular, nullptr /* intents */};
@@ -121,8 +121,27 @@ Status DecodeEncodedStr(rocksdb::Slice* slice, string* result) {
   const char* p = slice->cdata();
   const char* end = p + slice->size();
 
+  if (result != nullptr) {
+    result->clear();
+  }
   while (p != end) {
-    if (*p == END_OF_STRING) {
+    if (*p != END_OF_STRING) {
+      // Copy the whole run of regular characters at once instead of byte by byte.
+      const char* run_end = p;
+      while (run_end != end && *run_end != END_OF_STRING) {
+        ++run_end;
+      }
+      if (result != nullptr) {
+        const size_t run_start = result->size();
+        result->append(p, run_end);
+        if (END_OF_STRING != '\0') {
+          for (auto it = result->begin() + run_start; it != result->end(); ++it) {
+            *it ^= END_OF_STRING;
+          }
+        }
+      }
+      p = run_end;
+    } else {
       ++p;
       if (p == end) {
         return STATUS(Corruption, StringPrintf("Encoded string ends with only one \\0x%02x ",
@@ -145,16 +164,8 @@ Status DecodeEncodedStr(rocksdb::Slice* slice, string* result) {
             R"#(\0x%02x\0x%02x (must be either \0x%02x\0x%02x or \0x%02x\0x%02x))#",
             END_OF_STRING, *p, END_OF_STRING, END_OF_STRING, END_OF_STRING, END_OF_STRING_ESCAPE));
       }
-    } else {
-      if (result != nullptr) {
-        result->push_back((*p) ^ END_OF_STRING);
-      }
-      ++p;
     }
   }
-  if (result != nullptr) {
-    result->shrink_to_fit();
-  }
   slice->remove_prefix(p - slice->cdata());
   return Status::OK();
 }
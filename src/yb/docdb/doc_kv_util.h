@@ -112,7 +112,8 @@ inline std::string ZeroEncodeStr(std::string s) {
 //   slice - a slice containing an encoded string, optionally terminated by \x00\x00. A prefix of
 //           this slice is consumed.
 // Output (undefined in case of an error):
-//   result - the resulting decoded string
+//   result - the resulting decoded string. Previous contents are replaced, but the allocated
+//            capacity is reused.
 yb::Status DecodeZeroEncodedStr(rocksdb::Slice* slice, std::string* result);
 
 // A version of the above function that ensures the encoding is correct and all characters are
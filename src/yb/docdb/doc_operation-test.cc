@@ -17,6 +17,7 @@
 #include "yb/rocksdb/db/column_family.h"
 #include "yb/rocksdb/db/internal_stats.h"
 
+#include "yb/common/index.h"
 #include "yb/common/partial_row.h"
 #include "yb/common/ql_resultset.h"
 #include "yb/common/transaction-test-util.h"
@@ -285,6 +286,26 @@ TEST_F(DocOperationTest, TestQLUpdateWithoutTTL) {
   RunTestQLInsertUpdate(QLWriteRequestPB_QLStmtType_QL_STMT_UPDATE);
 }
 
+TEST_F(DocOperationTest, TestQLInsertNewRowSkipsRead) {
+  Schema schema = CreateSchema();
+  for (bool row_is_new : {false, true}) {
+    QLWriteRequestPB ql_writereq_pb;
+    QLResponsePB ql_writeresp_pb;
+    ql_writereq_pb.set_type(QLWriteRequestPB::QL_STMT_INSERT);
+    AddPrimaryKeyColumn(&ql_writereq_pb, 1);
+    ql_writereq_pb.set_hash_code(0);
+    AddColumnValues(schema, {2, 3, 4}, &ql_writereq_pb);
+    // Indexed columns are referenced to delete old index entries.
+    ql_writereq_pb.mutable_column_refs()->add_ids(schema.num_key_columns());
+    ql_writereq_pb.set_row_is_new(row_is_new);
+
+    QLWriteOperation ql_write_op(schema, IndexMap(), nullptr /* unique_index_key_schema */,
+                                 kNonTransactionalOperationContext);
+    ASSERT_OK(ql_write_op.Init(&ql_writereq_pb, &ql_writeresp_pb));
+    ASSERT_EQ(!row_is_new, ql_write_op.RequireReadSnapshot());
+  }
+}
+
 TEST_F(DocOperationTest, TestQLWriteNulls) {
   yb::QLWriteRequestPB ql_writereq_pb;
   yb::QLResponsePB ql_writeresp_pb;
@@ -1026,5 +1047,39 @@ TEST_F(DocOperationTest, MaxFileSizeWithWritesTrigger) {
   ASSERT_EQ(0, stats->GetCFStats(rocksdb::InternalStats::LEVEL0_SLOWDOWN_TOTAL));
 }
 
+TEST_F(DocOperationTest, IndexBackfillRequest) {
+  // Index on column 2 of the indexed table, with its key column 0 and covering column 3.
+  IndexInfoPB index_pb;
+  index_pb.set_table_id("index");
+  index_pb.set_indexed_table_id("table");
+  index_pb.set_hash_column_count(1);
+  index_pb.set_range_column_count(1);
+  for (auto column : {std::make_pair(10, 2), std::make_pair(11, 0), std::make_pair(12, 3)}) {
+    auto* column_pb = index_pb.add_columns();
+    column_pb->set_column_id(column.first);
+    column_pb->set_indexed_column_id(column.second);
+  }
+  IndexInfo index(index_pb);
+
+  QLTableRow row;
+  QLValue value;
+  for (int column_id : {0, 2, 3}) {
+    value.set_int32_value(column_id * 100);
+    row.AllocColumn(ColumnId(column_id), value);
+  }
+
+  QLWriteRequestPB request;
+  PrepareIndexBackfillRequest(index, row, 1000 /* user_timestamp */, &request);
+  ASSERT_EQ(QLWriteRequestPB::QL_STMT_INSERT, request.type());
+  ASSERT_EQ(1000, request.user_timestamp_usec());
+  ASSERT_EQ(1, request.hashed_column_values_size());
+  ASSERT_EQ(200, request.hashed_column_values(0).value().int32_value());
+  ASSERT_EQ(1, request.range_column_values_size());
+  ASSERT_EQ(0, request.range_column_values(0).value().int32_value());
+  ASSERT_EQ(1, request.column_values_size());
+  ASSERT_EQ(12, request.column_values(0).column_id());
+  ASSERT_EQ(300, request.column_values(0).expr().value().int32_value());
+}
+
 }  // namespace docdb
 }  // namespace yb
@@ -15,6 +15,7 @@
 
 #include "yb/docdb/doc_expr.h"
 #include "yb/rocksdb/db/compaction.h"
+#include "yb/rocksdb/table/data_block_boundaries.h"
 
 namespace yb {
 namespace docdb {
@@ -24,7 +25,8 @@ extern rocksdb::UserBoundaryTag TagForRangeComponent(size_t index);
 
 // TODO(neil) The following implementation is just a prototype. Need to complete the implementation
 // and test accordingly.
-class PgsqlRangeBasedFileFilter : public rocksdb::ReadFileFilter {
+class PgsqlRangeBasedFileFilter : public rocksdb::ReadFileFilter,
+                                  public rocksdb::ReadBlockFilter {
  public:
   PgsqlRangeBasedFileFilter(const std::vector<PrimitiveValue>& lower_bounds,
                             const std::vector<PrimitiveValue>& upper_bounds)
@@ -45,13 +47,22 @@ class PgsqlRangeBasedFileFilter : public rocksdb::ReadFileFilter {
   }
 
   bool Filter(const rocksdb::FdWithBoundaries& file) const override {
+    return Matches(file.smallest, file.largest);
+  }
+
+  bool Filter(const rocksdb::DataBlockBoundaries& block) const override {
+    return Matches(block.smallest, block.largest);
+  }
+
+  template <class Boundaries>
+  bool Matches(const Boundaries& smallest_values, const Boundaries& largest_values) const {
     for (size_t i = 0; i != lower_bounds_.size(); ++i) {
       const Slice lower_bound = lower_bounds_[i].AsSlice();
       const Slice upper_bound = upper_bounds_[i].AsSlice();
 
       rocksdb::UserBoundaryTag tag = TagForRangeComponent(i);
-      const Slice *smallest = file.smallest.user_value_with_tag(tag);
-      const Slice *largest = file.largest.user_value_with_tag(tag);
+      const Slice *smallest = smallest_values.user_value_with_tag(tag);
+      const Slice *largest = largest_values.user_value_with_tag(tag);
 
       if (!GreaterOrEquals(&upper_bound, smallest) || !GreaterOrEquals(largest, &lower_bound)) {
         return false;
@@ -191,5 +202,16 @@ std::shared_ptr<rocksdb::ReadFileFilter> DocPgsqlScanSpec::CreateFileFilter() co
   }
 }
 
+std::shared_ptr<rocksdb::ReadBlockFilter> DocPgsqlScanSpec::CreateBlockFilter() const {
+  auto lower_bound = range_components(true);
+  auto upper_bound = range_components(false);
+  if (lower_bound.empty() && upper_bound.empty()) {
+    return std::shared_ptr<rocksdb::ReadBlockFilter>();
+  } else {
+    return std::make_shared<PgsqlRangeBasedFileFilter>(std::move(lower_bound),
+                                                       std::move(upper_bound));
+  }
+}
+
 }  // namespace docdb
 }  // namespace yb
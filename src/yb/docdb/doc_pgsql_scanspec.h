@@ -55,6 +55,7 @@ class DocPgsqlScanSpec : public common::PgsqlScanSpec {
   //------------------------------------------------------------------------------------------------
   // Filters.
   std::shared_ptr<rocksdb::ReadFileFilter> CreateFileFilter() const;
+  std::shared_ptr<rocksdb::ReadBlockFilter> CreateBlockFilter() const;
 
   CHECKED_STATUS lower_bound(DocKey* key) const {
     return GetBoundKey(true /* lower_bound */, key);
@@ -14,6 +14,7 @@
 #include "yb/docdb/doc_expr.h"
 #include "yb/docdb/doc_ql_scanspec.h"
 #include "yb/rocksdb/db/compaction.h"
+#include "yb/rocksdb/table/data_block_boundaries.h"
 
 using std::vector;
 
@@ -284,7 +285,9 @@ bool GreaterOrEquals(const Slice& lhs, const Slice& rhs) {
   return lhs.compare(rhs) >= 0;
 }
 
-class RangeBasedFileFilter : public rocksdb::ReadFileFilter {
+// Also filters data blocks by the same boundaries, stored for them by SST files with
+// BlockBasedTableOptions::store_data_block_boundaries.
+class RangeBasedFileFilter : public rocksdb::ReadFileFilter, public rocksdb::ReadBlockFilter {
  public:
   RangeBasedFileFilter(const std::vector<PrimitiveValue>& lower_bounds,
       const std::vector<PrimitiveValue>& upper_bounds)
@@ -293,19 +296,29 @@ class RangeBasedFileFilter : public rocksdb::ReadFileFilter {
   }
 
   bool Filter(const rocksdb::FdWithBoundaries& file) const override {
+    return Matches(file.smallest, file.largest);
+  }
+
+  bool Filter(const rocksdb::DataBlockBoundaries& block) const override {
+    return Matches(block.smallest, block.largest);
+  }
+
+ private:
+  template <class Boundaries>
+  bool Matches(const Boundaries& smallest_values, const Boundaries& largest_values) const {
     for (size_t i = 0; i != lower_bounds_.size(); ++i) {
       auto lower_bound = lower_bounds_[i].AsSlice();
       auto upper_bound = upper_bounds_[i].AsSlice();
       rocksdb::UserBoundaryTag tag = TagForRangeComponent(i);
-      auto smallest = ValueOrEmpty(file.smallest.user_value_with_tag(tag));
-      auto largest = ValueOrEmpty(file.largest.user_value_with_tag(tag));
+      auto smallest = ValueOrEmpty(smallest_values.user_value_with_tag(tag));
+      auto largest = ValueOrEmpty(largest_values.user_value_with_tag(tag));
       if (!GreaterOrEquals(upper_bound, smallest) || !GreaterOrEquals(largest, lower_bound)) {
         return false;
       }
     }
     return true;
   }
- private:
+
   std::vector<KeyBytes> lower_bounds_;
   std::vector<KeyBytes> upper_bounds_;
 };
@@ -322,5 +335,15 @@ std::shared_ptr<rocksdb::ReadFileFilter> DocQLScanSpec::CreateFileFilter() const
   }
 }
 
+std::shared_ptr<rocksdb::ReadBlockFilter> DocQLScanSpec::CreateBlockFilter() const {
+  auto lower_bound = range_components(true);
+  auto upper_bound = range_components(false);
+  if (lower_bound.empty() && upper_bound.empty()) {
+    return std::shared_ptr<rocksdb::ReadBlockFilter>();
+  } else {
+    return std::make_shared<RangeBasedFileFilter>(std::move(lower_bound), std::move(upper_bound));
+  }
+}
+
 }  // namespace docdb
 }  // namespace yb
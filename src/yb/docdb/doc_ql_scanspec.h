@@ -54,6 +54,9 @@ class DocQLScanSpec : public common::QLScanSpec {
   // Create file filter based on range components.
   std::shared_ptr<rocksdb::ReadFileFilter> CreateFileFilter() const;
 
+  // Create data block filter based on range components.
+  std::shared_ptr<rocksdb::ReadBlockFilter> CreateBlockFilter() const;
+
   // Gets the query id.
   const rocksdb::QueryId QueryId() const {
     return query_id_;
@@ -0,0 +1,159 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/docdb/doc_row_cache.h"
+
+#include <gflags/gflags.h>
+
+#include "yb/docdb/doc_key.h"
+
+#include "yb/util/size_literals.h"
+#include "yb/util/test_macros.h"
+#include "yb/util/test_util.h"
+
+DECLARE_int64(docdb_row_cache_size_bytes);
+
+namespace yb {
+namespace docdb {
+
+namespace {
+
+std::string EncodedDocKey(int key) {
+  return DocKey({PrimitiveValue(key)}).Encode().data();
+}
+
+SubDocument MakeRow(const std::string& value) {
+  SubDocument row;
+  row.SetChildPrimitive(PrimitiveValue(ColumnId(1)), PrimitiveValue(value));
+  return row;
+}
+
+std::vector<PrimitiveValue> Projection() {
+  return {PrimitiveValue(ColumnId(1))};
+}
+
+class DocRowCacheTest : public YBTest {
+ protected:
+  void SetUp() override {
+    YBTest::SetUp();
+    FLAGS_docdb_row_cache_size_bytes = 1_MB;
+    mem_tracker_ = MemTracker::CreateTracker("DocRowCacheTest");
+    cache_ = std::make_unique<DocRowCache>(mem_tracker_, HybridTime(10));
+  }
+
+  void Put(int key, const std::string& value, HybridTime read_time) {
+    auto doc_key = EncodedDocKey(key);
+    auto generation = cache_->StartRead(doc_key);
+    cache_->Put(doc_key, Projection(), MakeRow(value), read_time, generation);
+  }
+
+  bool Get(int key, HybridTime read_time, SubDocument* row) {
+    return cache_->Get(EncodedDocKey(key), Projection(), read_time, row);
+  }
+
+  std::shared_ptr<MemTracker> mem_tracker_;
+  std::unique_ptr<DocRowCache> cache_;
+};
+
+} // namespace
+
+TEST_F(DocRowCacheTest, GetAndPut) {
+  SubDocument row;
+  ASSERT_FALSE(Get(1, HybridTime(20), &row));
+
+  Put(1, "a", HybridTime(20));
+  ASSERT_EQ(1, cache_->size());
+  ASSERT_TRUE(Get(1, HybridTime(20), &row));
+  ASSERT_EQ(MakeRow("a"), row);
+  ASSERT_TRUE(Get(1, HybridTime(30), &row));
+  // The row could have been different before it was read.
+  ASSERT_FALSE(Get(1, HybridTime(15), &row));
+  ASSERT_FALSE(Get(2, HybridTime(20), &row));
+
+  // Rows read before the cache was created are not stored.
+  Put(2, "b", HybridTime(5));
+  ASSERT_FALSE(Get(2, HybridTime(20), &row));
+
+  // A different projection does not hit the cached row.
+  std::vector<PrimitiveValue> projection = {PrimitiveValue(ColumnId(1)),
+                                            PrimitiveValue(ColumnId(2))};
+  ASSERT_FALSE(cache_->Get(EncodedDocKey(1), projection, HybridTime(20), &row));
+
+  ASSERT_GT(mem_tracker_->consumption(), 0);
+  cache_->Clear(HybridTime(40));
+  ASSERT_EQ(0, cache_->size());
+  ASSERT_EQ(0, mem_tracker_->consumption());
+  ASSERT_FALSE(Get(1, HybridTime(50), &row));
+
+  Put(1, "a", HybridTime(30));
+  ASSERT_FALSE(Get(1, HybridTime(50), &row));
+}
+
+TEST_F(DocRowCacheTest, Invalidate) {
+  SubDocument row;
+  Put(1, "a", HybridTime(20));
+  Put(2, "b", HybridTime(20));
+
+  cache_->Invalidate(EncodedDocKey(1), HybridTime(25));
+  ASSERT_FALSE(Get(1, HybridTime(30), &row));
+  ASSERT_TRUE(Get(2, HybridTime(30), &row));
+
+  // A read that could not see the write is not stored.
+  Put(1, "a", HybridTime(22));
+  ASSERT_FALSE(Get(1, HybridTime(30), &row));
+
+  Put(1, "c", HybridTime(30));
+  ASSERT_TRUE(Get(1, HybridTime(30), &row));
+  ASSERT_EQ(MakeRow("c"), row);
+
+  // A write applied while a row is being read prevents storing it.
+  auto doc_key = EncodedDocKey(3);
+  auto generation = cache_->StartRead(doc_key);
+  cache_->Invalidate(doc_key, HybridTime(15));
+  cache_->Put(doc_key, Projection(), MakeRow("d"), HybridTime(30), generation);
+  ASSERT_FALSE(Get(3, HybridTime(30), &row));
+}
+
+TEST_F(DocRowCacheTest, InvalidateWriteBatch) {
+  SubDocument row;
+  Put(1, "a", HybridTime(20));
+  Put(2, "b", HybridTime(20));
+
+  rocksdb::WriteBatch write_batch;
+  SubDocKey sub_doc_key(DocKey({PrimitiveValue(1)}), PrimitiveValue(ColumnId(1)),
+                        HybridTime(25));
+  write_batch.Put(sub_doc_key.Encode().AsSlice(), Slice("value"));
+  cache_->Invalidate(write_batch, HybridTime(25));
+
+  ASSERT_FALSE(Get(1, HybridTime(30), &row));
+  ASSERT_TRUE(Get(2, HybridTime(30), &row));
+}
+
+TEST_F(DocRowCacheTest, Eviction) {
+  Put(1, "a", HybridTime(20));
+  auto entry_size = mem_tracker_->consumption();
+  FLAGS_docdb_row_cache_size_bytes = entry_size * 2;
+
+  SubDocument row;
+  Put(2, "b", HybridTime(20));
+  ASSERT_TRUE(Get(1, HybridTime(20), &row));
+  Put(3, "c", HybridTime(20));
+  ASSERT_EQ(2, cache_->size());
+  ASSERT_TRUE(Get(1, HybridTime(20), &row));
+  ASSERT_FALSE(Get(2, HybridTime(20), &row));
+  ASSERT_TRUE(Get(3, HybridTime(20), &row));
+  ASSERT_LE(mem_tracker_->consumption(), FLAGS_docdb_row_cache_size_bytes);
+}
+
+} // namespace docdb
+} // namespace yb
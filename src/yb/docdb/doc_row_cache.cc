@@ -0,0 +1,221 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/docdb/doc_row_cache.h"
+
+#include <gflags/gflags.h>
+
+#include "yb/docdb/doc_key.h"
+#include "yb/docdb/range_tombstone.h"
+
+#include "yb/util/flag_tags.h"
+#include "yb/util/hash_util.h"
+
+DEFINE_int64(docdb_row_cache_size_bytes, 0,
+             "Maximum memory used by the cache of rows decoded by primary key point reads of a "
+             "tablet. 0 to disable.");
+TAG_FLAG(docdb_row_cache_size_bytes, advanced);
+TAG_FLAG(docdb_row_cache_size_bytes, runtime);
+
+namespace yb {
+namespace docdb {
+
+namespace {
+
+size_t ApproximateMemoryUsage(const PrimitiveValue& value) {
+  return sizeof(value) + (value.IsString() ? value.GetStringAsSlice().size() : 0);
+}
+
+size_t ApproximateMemoryUsage(const SubDocument& doc) {
+  size_t result = ApproximateMemoryUsage(static_cast<const PrimitiveValue&>(doc));
+  if (IsObjectType(doc.value_type()) && doc.object_num_keys() != 0) {
+    for (const auto& child : doc.object_container()) {
+      result += ApproximateMemoryUsage(child.first) + ApproximateMemoryUsage(child.second);
+    }
+  }
+  return result;
+}
+
+class InvalidatingHandler : public rocksdb::WriteBatch::Handler {
+ public:
+  InvalidatingHandler(DocRowCache* cache, HybridTime write_ht)
+      : cache_(cache), write_ht_(write_ht) {}
+
+  void Put(const Slice& key, const Slice& value) override {
+    Invalidate(key);
+  }
+
+  void Delete(const Slice& key) override {
+    Invalidate(key);
+  }
+
+  void SingleDelete(const Slice& key) override {
+    Invalidate(key);
+  }
+
+  void Merge(const Slice& key, const Slice& value) override {
+    Invalidate(key);
+  }
+
+ private:
+  void Invalidate(const Slice& key) {
+    auto doc_key_size = DocKey::EncodedSize(key, DocKeyPart::WHOLE_DOC_KEY);
+    if (!doc_key_size.ok()) {
+      // Not a document record, so nothing we could have cached depends on it.
+      return;
+    }
+    if (IsRangeTombstone(key, *doc_key_size)) {
+      // Could delete any number of cached rows of the partition.
+      cache_->Clear(write_ht_);
+      return;
+    }
+    cache_->Invalidate(Slice(key.data(), *doc_key_size), write_ht_);
+  }
+
+  DocRowCache* const cache_;
+  const HybridTime write_ht_;
+};
+
+} // namespace
+
+DocRowCache::DocRowCache(
+    const std::shared_ptr<MemTracker>& parent_mem_tracker, HybridTime min_read_time)
+    : mem_tracker_(MemTracker::FindOrCreateTracker("RowCache", parent_mem_tracker)) {
+  for (auto& stripe : stripes_) {
+    stripe.max_write_ht = min_read_time;
+  }
+}
+
+DocRowCache::~DocRowCache() {
+  mem_tracker_->Release(consumption_);
+}
+
+bool DocRowCache::Enabled() {
+  return FLAGS_docdb_row_cache_size_bytes > 0;
+}
+
+size_t DocRowCache::StripeIndex(const Slice& doc_key) {
+  return HashUtil::MurmurHash2_64(doc_key.data(), doc_key.size(), 0 /* seed */) % kNumStripes;
+}
+
+uint64_t DocRowCache::StartRead(const Slice& doc_key) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return stripes_[StripeIndex(doc_key)].generation;
+}
+
+bool DocRowCache::Get(const Slice& doc_key, const std::vector<PrimitiveValue>& projection,
+                      HybridTime read_time, SubDocument* row) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = index_.find(doc_key.ToBuffer());
+  if (it == index_.end()) {
+    return false;
+  }
+  auto entry = it->second;
+  if (entry->read_time > read_time || entry->projection != projection) {
+    return false;
+  }
+  *row = entry->row;
+  lru_.splice(lru_.begin(), lru_, entry);
+  return true;
+}
+
+void DocRowCache::Put(const Slice& doc_key, const std::vector<PrimitiveValue>& projection,
+                      const SubDocument& row, HybridTime read_time, uint64_t generation) {
+  const auto capacity = FLAGS_docdb_row_cache_size_bytes;
+  if (capacity <= 0) {
+    return;
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  // Checked under the lock, so that an invalidation either precedes this check or removes the
+  // entry stored here.
+  const auto& stripe = stripes_[StripeIndex(doc_key)];
+  if (stripe.generation != generation || stripe.max_write_ht > read_time) {
+    return;
+  }
+  auto key = doc_key.ToBuffer();
+  auto it = index_.find(key);
+  if (it != index_.end()) {
+    if (it->second->read_time >= read_time) {
+      return;
+    }
+    EraseUnlocked(it->second);
+  }
+  size_t charge = sizeof(Entry) + 2 * key.size() + ApproximateMemoryUsage(row);
+  for (const auto& subkey : projection) {
+    charge += ApproximateMemoryUsage(subkey);
+  }
+  if (charge > static_cast<size_t>(capacity)) {
+    return;
+  }
+  while (!lru_.empty() && consumption_ + charge > static_cast<size_t>(capacity)) {
+    EraseUnlocked(std::prev(lru_.end()));
+  }
+  lru_.push_front(Entry{key, projection, row, read_time, charge});
+  index_.emplace(std::move(key), lru_.begin());
+  consumption_ += charge;
+  mem_tracker_->Consume(charge);
+}
+
+void DocRowCache::Invalidate(const rocksdb::WriteBatch& write_batch, HybridTime write_ht) {
+  InvalidatingHandler handler(this, write_ht);
+  auto status = write_batch.Iterate(&handler);
+  if (!status.ok()) {
+    LOG(DFATAL) << "Failed to iterate write batch: " << status;
+    Clear(write_ht);
+  }
+}
+
+void DocRowCache::Invalidate(const Slice& doc_key, HybridTime write_ht) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  InvalidateUnlocked(doc_key, write_ht);
+}
+
+void DocRowCache::InvalidateUnlocked(const Slice& doc_key, HybridTime write_ht) {
+  auto& stripe = stripes_[StripeIndex(doc_key)];
+  ++stripe.generation;
+  stripe.max_write_ht = std::max(stripe.max_write_ht, write_ht);
+  if (index_.empty()) {
+    return;
+  }
+  auto it = index_.find(doc_key.ToBuffer());
+  if (it != index_.end()) {
+    EraseUnlocked(it->second);
+  }
+}
+
+void DocRowCache::Clear(HybridTime min_read_time) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (auto& stripe : stripes_) {
+    ++stripe.generation;
+    stripe.max_write_ht = std::max(stripe.max_write_ht, min_read_time);
+  }
+  index_.clear();
+  lru_.clear();
+  mem_tracker_->Release(consumption_);
+  consumption_ = 0;
+}
+
+size_t DocRowCache::size() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return lru_.size();
+}
+
+void DocRowCache::EraseUnlocked(EntryList::iterator it) {
+  consumption_ -= it->charge;
+  mem_tracker_->Release(it->charge);
+  index_.erase(it->key);
+  lru_.erase(it);
+}
+
+} // namespace docdb
+} // namespace yb
@@ -0,0 +1,117 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#ifndef YB_DOCDB_DOC_ROW_CACHE_H
+#define YB_DOCDB_DOC_ROW_CACHE_H
+
+#include <array>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "yb/common/hybrid_time.h"
+
+#include "yb/docdb/primitive_value.h"
+#include "yb/docdb/subdocument.h"
+
+#include "yb/rocksdb/write_batch.h"
+
+#include "yb/util/mem_tracker.h"
+#include "yb/util/slice.h"
+
+namespace yb {
+namespace docdb {
+
+// Per-tablet cache of rows decoded by primary key point reads, keyed by encoded DocKey.
+//
+// An entry holds the row as of the read time of the read that produced it, and is served to reads
+// with the same projection at that read time or later, until a write to the document is applied.
+// Each write invalidates the documents it touches before it is written to RocksDB, so an entry
+// that is in the cache reflects all applied writes to its document. Rows whose provisional writes
+// could be pending, i.e. when there are intents for them, must not be read from or stored to the
+// cache, see DocRowwiseIterator. The cache is disabled when FLAGS_docdb_row_cache_size_bytes is 0.
+class DocRowCache {
+ public:
+  // min_read_time should be not earlier than the hybrid time of any write already present in
+  // RocksDB. Rows read at earlier times are not stored.
+  DocRowCache(const std::shared_ptr<MemTracker>& parent_mem_tracker, HybridTime min_read_time);
+  ~DocRowCache();
+
+  static bool Enabled();
+
+  // Returns the generation to pass to Put for a read of doc_key that is about to be started.
+  uint64_t StartRead(const Slice& doc_key) const;
+
+  // Fills row if there is an entry for doc_key read with the same projection at or before
+  // read_time. Returns true in that case.
+  bool Get(const Slice& doc_key, const std::vector<PrimitiveValue>& projection,
+           HybridTime read_time, SubDocument* row);
+
+  // Stores the row read at read_time. The row is dropped if a write to a document with the same
+  // stripe of the cache was applied since generation was obtained, or if such a write is later
+  // than read_time.
+  void Put(const Slice& doc_key, const std::vector<PrimitiveValue>& projection,
+           const SubDocument& row, HybridTime read_time, uint64_t generation);
+
+  // Invalidates documents written by a batch of regular RocksDB records applied at write_ht.
+  void Invalidate(const rocksdb::WriteBatch& write_batch, HybridTime write_ht);
+
+  void Invalidate(const Slice& doc_key, HybridTime write_ht);
+
+  // Drops all entries, e.g. when data is added to RocksDB bypassing the write path. Rows read
+  // before min_read_time are not stored afterwards.
+  void Clear(HybridTime min_read_time);
+
+  size_t size();
+
+ private:
+  struct Entry {
+    std::string key;
+    std::vector<PrimitiveValue> projection;
+    SubDocument row;
+    HybridTime read_time;
+    size_t charge;
+  };
+
+  typedef std::list<Entry> EntryList;
+
+  // Writes are tracked per stripe of documents, so that a write of one document does not prevent
+  // caching of most of the others.
+  struct Stripe {
+    uint64_t generation = 0;
+    HybridTime max_write_ht;
+  };
+
+  static constexpr size_t kNumStripes = 256;
+
+  static size_t StripeIndex(const Slice& doc_key);
+
+  void InvalidateUnlocked(const Slice& doc_key, HybridTime write_ht);
+  void EraseUnlocked(EntryList::iterator it);
+
+  mutable std::mutex mutex_;
+  EntryList lru_;
+  std::unordered_map<std::string, EntryList::iterator> index_;
+  std::array<Stripe, kNumStripes> stripes_;
+  size_t consumption_ = 0;
+
+  std::shared_ptr<MemTracker> mem_tracker_;
+};
+
+} // namespace docdb
+} // namespace yb
+
+#endif // YB_DOCDB_DOC_ROW_CACHE_H
@@ -21,6 +21,7 @@
 #include "yb/docdb/docdb_rocksdb_util.h"
 #include "yb/docdb/doc_key.h"
 #include "yb/docdb/doc_ql_scanspec.h"
+#include "yb/docdb/doc_row_cache.h"
 #include "yb/docdb/intent_aware_iterator.h"
 #include "yb/docdb/subdocument.h"
 #include "yb/gutil/strings/substitute.h"
@@ -29,6 +30,20 @@
 
 #include "yb/yql/pggate/util/pg_doc_data.h"
 
+DEFINE_int64(docdb_bulk_scan_min_row_limit, 10000,
+             "Scans with no row limit, or with at least this row limit, over a key range that is "
+             "not restricted to a single hash key do not add the blocks they read to the block "
+             "cache. 0 disables this.");
+
+DEFINE_int32(docdb_prefetch_point_keys_limit, 1024,
+             "Scans over a list of point keys, e.g. with IN conditions on primary key columns, that "
+             "select at most this number of keys, read data blocks needed for all the keys in one "
+             "batch before reading the rows. 0 disables this.");
+
+DEFINE_bool(docdb_scan_adaptive_readahead, true,
+            "Forward scans over a key range that is not restricted to a single hash key prefetch "
+            "upcoming SST data blocks once they detect sequential reads.");
+
 using std::string;
 
 using yb::FormatRocksDBSliceAsStr;
@@ -41,7 +56,7 @@ class ScanChoices {
  public:
   explicit ScanChoices(bool is_forward_scan) : is_forward_scan_(is_forward_scan) {}
   virtual ~ScanChoices() {}
-  virtual bool CurrentIteratorPositionMatchesCurrentTarget(DocKey curr) {
+  virtual bool CurrentIteratorPositionMatchesCurrentTarget(const DocKey& curr) {
     VLOG(3) << __PRETTY_FUNCTION__ << " checking if acceptable ? "
             << (curr == current_scan_target_ ? "YES" : "NOPE");
     return curr == current_scan_target_;
@@ -68,6 +83,113 @@ class ScanChoices {
   bool finished_ = false;
 };
 
+namespace {
+
+// Fills keys with encoded doc keys of all targets of a scan with the given range options, for the
+// hash key of lower_doc_key. Returns false if there are more than max_keys of them.
+bool GetRangeOptionsDocKeys(const DocKey& lower_doc_key,
+                            const std::vector<std::vector<PrimitiveValue>>& range_options,
+                            size_t max_keys, std::vector<KeyBytes>* keys) {
+  size_t num_keys = 1;
+  for (const auto& column_options : range_options) {
+    num_keys *= column_options.size();
+    if (num_keys == 0 || num_keys > max_keys) {
+      return false;
+    }
+  }
+
+  DocKey target = lower_doc_key;
+  target.ClearRangeComponents();
+  std::vector<size_t> option_idxs(range_options.size());
+  keys->reserve(num_keys);
+  for (size_t i = 0; i != num_keys; ++i) {
+    DocKey doc_key = target;
+    for (size_t col_idx = 0; col_idx != range_options.size(); ++col_idx) {
+      doc_key.AddRangeComponent(range_options[col_idx][option_idxs[col_idx]]);
+    }
+    keys->push_back(doc_key.Encode());
+    for (size_t col_idx = range_options.size(); col_idx-- > 0;) {
+      if (++option_idxs[col_idx] < range_options[col_idx].size()) {
+        break;
+      }
+      option_idxs[col_idx] = 0;
+    }
+  }
+  return true;
+}
+
+// Returns the key to check bloom filters with for a scan between the given bounds: their hashed
+// components followed by the leading range components that both bounds have in common. Filters
+// that also take into account further range components are not checked for this key.
+KeyBytes BloomFilterKey(const DocKey& lower_doc_key, const DocKey& upper_doc_key) {
+  const auto& lower_range = lower_doc_key.range_group();
+  const auto& upper_range = upper_doc_key.range_group();
+  size_t num_common = 0;
+  while (num_common < lower_range.size() && num_common < upper_range.size() &&
+         lower_range[num_common] == upper_range[num_common]) {
+    ++num_common;
+  }
+  if (num_common == lower_range.size()) {
+    return lower_doc_key.Encode();
+  }
+  DocKey filter_key = lower_doc_key;
+  filter_key.ResizeRangeComponents(num_common);
+  return filter_key.Encode();
+}
+
+// Returns true if the scan between the given bounds reads just the row with the full primary key
+// lower_doc_key.
+bool IsPointRead(const Schema& schema, const DocKey& lower_doc_key, const DocKey& upper_doc_key) {
+  const auto& lower_range = lower_doc_key.range_group();
+  const auto& upper_range = upper_doc_key.range_group();
+  if (!lower_doc_key.HashedComponentsEqual(upper_doc_key) ||
+      lower_doc_key.hashed_group().size() != schema.num_hash_key_columns() ||
+      lower_range.size() != schema.num_range_key_columns() ||
+      upper_range.size() != lower_range.size() + 1 ||
+      upper_range.back().value_type() != ValueType::kHighest) {
+    return false;
+  }
+  for (const auto& component : lower_range) {
+    if (component.value_type() == ValueType::kLowest ||
+        component.value_type() == ValueType::kHighest) {
+      return false;
+    }
+  }
+  return std::equal(lower_range.begin(), lower_range.end(), upper_range.begin());
+}
+
+// Checks whether there are intents that could affect the document with the given encoded key, i.e.
+// intents of any document with the same hashed components.
+bool HasIntents(rocksdb::DB* intents_db, const Slice& doc_key) {
+  auto hashed_part_size = DocKey::EncodedSize(doc_key, DocKeyPart::HASHED_PART_ONLY);
+  if (!hashed_part_size.ok()) {
+    return true;
+  }
+  const Slice prefix(doc_key.data(), *hashed_part_size);
+  auto iter = CreateRocksDBIterator(
+      intents_db, BloomFilterMode::DONT_USE_BLOOM_FILTER, boost::none /* user_key_for_filter */,
+      rocksdb::kDefaultQueryId);
+  iter->Seek(prefix);
+  return iter->Valid() && iter->key().starts_with(prefix);
+}
+
+// The remaining TTL of expiring values changes over time, so rows that have them are not cached.
+bool HasExpiringValues(const SubDocument& doc) {
+  if (doc.GetTtl() != -1) {
+    return true;
+  }
+  if (IsObjectType(doc.value_type()) && doc.object_num_keys() != 0) {
+    for (const auto& child : doc.object_container()) {
+      if (HasExpiringValues(child.second)) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+} // namespace
+
 class DiscreteScanChoices : public ScanChoices {
  public:
   DiscreteScanChoices(const DocQLScanSpec& doc_spec, DocKey lower_doc_key, DocKey upper_doc_key)
@@ -395,14 +517,90 @@ DocRowwiseIterator::DocRowwiseIterator(
 DocRowwiseIterator::~DocRowwiseIterator() {
 }
 
+void DocRowwiseIterator::SetDeadline(CoarseTimePoint deadline) {
+  deadline_info_.emplace(deadline);
+}
+
+bool DocRowwiseIterator::StartCachedRowRead(
+    const DocKey& lower_doc_key, const DocKey& upper_doc_key) {
+  auto* row_cache = doc_db_.row_cache;
+  if (row_cache == nullptr || !DocRowCache::Enabled() || schema_.has_statics() ||
+      TableTTL(schema_) != Value::kMaxTtl ||
+      !IsPointRead(schema_, lower_doc_key, upper_doc_key)) {
+    return false;
+  }
+  KeyBytes row_key = lower_doc_key.Encode();
+  // Intents could be provisional writes of the row that are committed but not applied yet, or
+  // writes of the transaction of this read.
+  if (doc_db_.intents != nullptr && HasIntents(doc_db_.intents, row_key.AsSlice())) {
+    return false;
+  }
+  row_cache_generation_ = row_cache->StartRead(row_key.AsSlice());
+  if (!row_cache->Get(row_key.AsSlice(), projection_subkeys_, read_time_.read, &row_)) {
+    cached_row_key_ = std::move(row_key);
+    return false;
+  }
+  VLOG(4) << "Read cached row " << lower_doc_key;
+  row_key_ = lower_doc_key;
+  row_from_cache_ = true;
+  row_ready_ = true;
+  return true;
+}
+
+void DocRowwiseIterator::CacheRow() const {
+  const auto max_seen_ht = db_iter_->max_seen_ht();
+  if ((max_seen_ht.is_valid() && max_seen_ht > read_time_.read) || HasExpiringValues(row_)) {
+    return;
+  }
+  doc_db_.row_cache->Put(
+      cached_row_key_.AsSlice(), projection_subkeys_, row_, read_time_.read, row_cache_generation_);
+  cached_row_key_.Clear();
+}
+
+bool DocRowwiseIterator::IsBulkScan(const DocKey& lower_doc_key, bool is_fixed_point_get) const {
+  if (FLAGS_docdb_bulk_scan_min_row_limit <= 0 ||
+      row_limit_ < static_cast<uint64_t>(FLAGS_docdb_bulk_scan_min_row_limit)) {
+    return false;
+  }
+  // Scans within one hash key are expected to be short, and are considered part of the working set.
+  return !is_fixed_point_get && lower_doc_key.hashed_group().empty();
+}
+
+ReadaheadMode DocRowwiseIterator::GetReadaheadMode(
+    const DocKey& lower_doc_key, bool is_fixed_point_get) const {
+  // Readahead only prefetches forward, and scans within one hash key are expected to be short.
+  if (!FLAGS_docdb_scan_adaptive_readahead || !is_forward_scan_ || is_fixed_point_get ||
+      !lower_doc_key.hashed_group().empty()) {
+    return ReadaheadMode::NO_READAHEAD;
+  }
+  return ReadaheadMode::ADAPTIVE_READAHEAD;
+}
+
+std::shared_ptr<rocksdb::ReadFileFilter> DocRowwiseIterator::CreateFileFilter(
+    std::shared_ptr<rocksdb::ReadFileFilter> file_filter) const {
+  return CreateExpirationAwareFileFilter(
+      std::move(file_filter), TableTTL(schema_), read_time_.read);
+}
+
+std::shared_ptr<rocksdb::ReadBlockFilter> DocRowwiseIterator::CreateBlockFilter(
+    std::shared_ptr<rocksdb::ReadBlockFilter> block_filter) const {
+  return CreateReadTimeAwareBlockFilter(std::move(block_filter), read_time_);
+}
+
 Status DocRowwiseIterator::Init() {
   auto query_id = rocksdb::kDefaultQueryId;
 
+  is_bulk_scan_ = IsBulkScan(DocKey(), false /* is_fixed_point_get */);
   db_iter_ = CreateIntentAwareIterator(
       doc_db_, BloomFilterMode::DONT_USE_BLOOM_FILTER,
-      boost::none /* user_key_for_filter */, query_id, txn_op_context_, deadline_, read_time_);
+      boost::none /* user_key_for_filter */, query_id, txn_op_context_, deadline_, read_time_,
+      CreateFileFilter(nullptr /* file_filter */), nullptr /* iterate_upper_bound */,
+      is_bulk_scan_ ? BlockCacheFillMode::DONT_FILL_CACHE : BlockCacheFillMode::FILL_CACHE,
+      GetReadaheadMode(DocKey(), false /* is_fixed_point_get */),
+      CreateBlockFilter(nullptr /* block_filter */));
 
   row_key_ = DocKey(schema_);
+  read_range_tombstones_ = SupportsRangeTombstones(schema_);
   VLOG(3) << __PRETTY_FUNCTION__ << " Seeking to " << row_key_;
   db_iter_->Seek(row_key_);
   row_ready_ = false;
@@ -414,6 +612,7 @@ Status DocRowwiseIterator::Init() {
 Status DocRowwiseIterator::Init(const common::QLScanSpec& spec) {
   const DocQLScanSpec& doc_spec = dynamic_cast<const DocQLScanSpec&>(spec);
   is_forward_scan_ = doc_spec.is_forward_scan();
+  read_range_tombstones_ = SupportsRangeTombstones(schema_);
 
   VLOG(4) << "Initializing iterator direction: " << (is_forward_scan_ ? "FORWARD" : "BACKWARD");
 
@@ -423,18 +622,28 @@ Status DocRowwiseIterator::Init(const common::QLScanSpec& spec) {
   RETURN_NOT_OK(doc_spec.upper_bound(&upper_doc_key));
   VLOG(4) << "DocKey Bounds " << lower_doc_key.ToString() << ", " << upper_doc_key.ToString();
 
+  if (!doc_spec.range_options() && StartCachedRowRead(lower_doc_key, upper_doc_key)) {
+    return Status::OK();
+  }
+
   // TODO(bogdan): decide if this is a good enough heuristic for using blooms for scans.
   const bool is_fixed_point_get = !lower_doc_key.empty() &&
       upper_doc_key.HashedComponentsEqual(lower_doc_key);
   const auto mode = is_fixed_point_get ? BloomFilterMode::USE_BLOOM_FILTER :
       BloomFilterMode::DONT_USE_BLOOM_FILTER;
 
-  const KeyBytes row_key_encoded = lower_doc_key.Encode();
-  const Slice row_key_encoded_as_slice = row_key_encoded.AsSlice();
+  const KeyBytes filter_key = BloomFilterKey(lower_doc_key, upper_doc_key);
 
+  // Scans for the listed range options only read the requested rows.
+  is_bulk_scan_ = !doc_spec.range_options() && IsBulkScan(lower_doc_key, is_fixed_point_get);
   db_iter_ = CreateIntentAwareIterator(
-      doc_db_, mode, row_key_encoded_as_slice, doc_spec.QueryId(), txn_op_context_,
-      deadline_, read_time_, doc_spec.CreateFileFilter());
+      doc_db_, mode, filter_key.AsSlice(), doc_spec.QueryId(), txn_op_context_,
+      deadline_, read_time_, CreateFileFilter(doc_spec.CreateFileFilter()),
+      nullptr /* iterate_upper_bound */,
+      is_bulk_scan_ ? BlockCacheFillMode::DONT_FILL_CACHE : BlockCacheFillMode::FILL_CACHE,
+      doc_spec.range_options() ? ReadaheadMode::NO_READAHEAD
+                               : GetReadaheadMode(lower_doc_key, is_fixed_point_get),
+      CreateBlockFilter(doc_spec.CreateBlockFilter()));
 
   row_ready_ = false;
 
@@ -451,6 +660,14 @@ Status DocRowwiseIterator::Init(const common::QLScanSpec& spec) {
   }
 
   if (doc_spec.range_options()) {
+    std::vector<KeyBytes> point_keys;
+    if (FLAGS_docdb_prefetch_point_keys_limit > 1 &&
+        GetRangeOptionsDocKeys(lower_doc_key, *doc_spec.range_options(),
+                               FLAGS_docdb_prefetch_point_keys_limit, &point_keys) &&
+        point_keys.size() > 1) {
+      PrefetchDocKeys(doc_db_.regular, point_keys, doc_spec.QueryId(),
+                      CreateFileFilter(doc_spec.CreateFileFilter()));
+    }
     scan_choices_.reset(new DiscreteScanChoices(doc_spec, lower_doc_key, upper_doc_key));
     // Let's not seek to the lower doc key or upper doc key. We know exactly what we want.
     return AdvanceIteratorToNextDesiredRow();
@@ -486,18 +703,26 @@ Status DocRowwiseIterator::Init(const common::PgsqlScanSpec& spec) {
   RETURN_NOT_OK(doc_spec.upper_bound(&upper_doc_key));
   VLOG(4) << "DocKey Bounds " << lower_doc_key.ToString() << ", " << upper_doc_key.ToString();
 
+  if (StartCachedRowRead(lower_doc_key, upper_doc_key)) {
+    return Status::OK();
+  }
+
   // TODO(bogdan): decide if this is a good enough heuristic for using blooms for scans.
   const bool is_fixed_point_get = !lower_doc_key.empty() &&
       upper_doc_key.HashedComponentsEqual(lower_doc_key);
   const auto mode = is_fixed_point_get ? BloomFilterMode::USE_BLOOM_FILTER :
       BloomFilterMode::DONT_USE_BLOOM_FILTER;
 
-  const KeyBytes row_key_encoded = lower_doc_key.Encode();
-  const Slice row_key_encoded_as_slice = row_key_encoded.AsSlice();
+  const KeyBytes filter_key = BloomFilterKey(lower_doc_key, upper_doc_key);
 
+  is_bulk_scan_ = IsBulkScan(lower_doc_key, is_fixed_point_get);
   db_iter_ = CreateIntentAwareIterator(
-      doc_db_, mode, row_key_encoded_as_slice, doc_spec.QueryId(), txn_op_context_,
-      deadline_, read_time_, doc_spec.CreateFileFilter());
+      doc_db_, mode, filter_key.AsSlice(), doc_spec.QueryId(), txn_op_context_,
+      deadline_, read_time_, CreateFileFilter(doc_spec.CreateFileFilter()),
+      nullptr /* iterate_upper_bound */,
+      is_bulk_scan_ ? BlockCacheFillMode::DONT_FILL_CACHE : BlockCacheFillMode::FILL_CACHE,
+      GetReadaheadMode(lower_doc_key, is_fixed_point_get),
+      CreateBlockFilter(doc_spec.CreateBlockFilter()));
 
   row_ready_ = false;
 
@@ -549,6 +774,11 @@ bool DocRowwiseIterator::HasNext() const {
     // eventually report the error. HasNext is unable to return an error status.
     return true;
   }
+  if (row_from_cache_) {
+    // The cached row was the only row to read.
+    done_ = true;
+    return false;
+  }
 
   bool doc_found = false;
   while (!doc_found) {
@@ -616,6 +846,23 @@ bool DocRowwiseIterator::HasNext() const {
 
     GetSubDocumentData data = { sub_doc_key, &row_, &doc_found, TableTTL(schema_) };
     data.deadline_info = deadline_info_.get_ptr();
+    if (read_range_tombstones_ && !row_key_.range_group().empty()) {
+      if (!range_tombstones_.IsLoadedFor(sub_doc_key)) {
+        // The first row of a partition, its range tombstones are stored before it.
+        status_ = range_tombstones_.Load(db_iter_.get(), sub_doc_key);
+        if (!status_.ok()) {
+          // Defer error reporting to NextRow().
+          return true;
+        }
+        db_iter_->Seek(sub_doc_key);
+      }
+      auto range_tombstone_ht = range_tombstones_.CoveringWriteTime(sub_doc_key);
+      if (!range_tombstone_ht.ok()) {
+        status_ = range_tombstone_ht.status();
+        return true;
+      }
+      data.range_tombstone_ht = *range_tombstone_ht;
+    }
     status_ = GetSubDocument(db_iter_.get(), data, &projection_subkeys_);
     // After this, the iter should be positioned right after the subdocument.
     if (!status_.ok()) {
@@ -623,18 +870,27 @@ bool DocRowwiseIterator::HasNext() const {
       return true;
     }
 
+    if (doc_found && !cached_row_key_.data().empty() && sub_doc_key == cached_row_key_.AsSlice()) {
+      CacheRow();
+    }
+
     if (!doc_found) {
       SubDocument full_row;
-      // If doc is not found, decide if some non-projection column exists.
-      // Currently we read the whole doc here,
-      // may be optimized by exiting on the first column in future.
+      // None of the projected columns exist, decide if some non-projection column exists. It is
+      // enough to read the first columns of the doc for that, so stop after the first one found.
       db_iter_->Seek(row_key_);  // Position it for GetSubDocument.
       data.result = &full_row;
+      data.limit = 1;
       status_ = GetSubDocument(db_iter_.get(), data);
       if (!status_.ok()) {
         // Defer error reporting to NextRow().
         return true;
       }
+      // The limited read could stop inside the doc, so move the iterator past it, where the full
+      // read would have left it.
+      row_key_buffer_.Clear();
+      row_key_.AppendTo(&row_key_buffer_);
+      db_iter_->SeekOutOfSubDoc(&row_key_buffer_);
     }
     if (scan_choices_ && !is_static_column) {
       scan_choices_->DoneWithCurrentTarget();
@@ -687,6 +943,10 @@ void DocRowwiseIterator::SkipRow() {
 }
 
 HybridTime DocRowwiseIterator::RestartReadHt() {
+  if (row_from_cache_) {
+    // All writes of the cached row are not later than the read time, see DocRowCache.
+    return HybridTime::kInvalid;
+  }
   auto max_seen_ht = db_iter_->max_seen_ht();
   if (max_seen_ht.is_valid() && max_seen_ht > db_iter_->read_time().read) {
     VLOG(4) << "Restart read: " << max_seen_ht << ", original: " << db_iter_->read_time();
@@ -753,7 +1013,7 @@ bool DocRowwiseIterator::LivenessColumnExists() const {
 }
 
 CHECKED_STATUS DocRowwiseIterator::GetNextReadSubDocKey(SubDocKey* sub_doc_key) const {
-  if (db_iter_ == nullptr) {
+  if (db_iter_ == nullptr && !row_from_cache_) {
     return STATUS(Corruption, "Iterator not initialized.");
   }
 
@@ -821,6 +1081,9 @@ Result<string> DocRowwiseIterator::GetRowKey() const {
 }
 
 Status DocRowwiseIterator::Seek(const std::string& row_key) {
+  if (db_iter_ == nullptr) {
+    return STATUS(IllegalState, "Seek is not supported by reads of cached rows");
+  }
   DocKey doc_key;
   RETURN_NOT_OK(doc_key.DecodeFrom(Slice(row_key)));
   db_iter_->Seek(doc_key);
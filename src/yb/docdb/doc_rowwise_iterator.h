@@ -16,6 +16,7 @@
 
 #include <string>
 #include <atomic>
+#include <limits>
 
 #include "yb/rocksdb/db.h"
 
@@ -27,6 +28,8 @@
 #include "yb/docdb/subdocument.h"
 #include "yb/docdb/doc_ql_scanspec.h"
 #include "yb/docdb/doc_pgsql_scanspec.h"
+#include "yb/docdb/docdb_rocksdb_util.h"
+#include "yb/docdb/range_tombstone.h"
 #include "yb/docdb/value.h"
 #include "yb/docdb/deadline_info.h"
 #include "yb/util/status.h"
@@ -64,6 +67,15 @@ class DocRowwiseIterator : public common::YQLRowwiseIteratorIf {
 
   virtual ~DocRowwiseIterator();
 
+  static constexpr uint64_t kNoRowLimit = std::numeric_limits<uint64_t>::max();
+
+  // Sets the number of rows the caller is going to read, should be called before Init.
+  // A scan with no row limit, or a large one, over a key range that is not restricted to a single
+  // hash key is a bulk scan, and blocks read by it are not added to the block cache.
+  void set_row_limit(uint64_t row_limit) {
+    row_limit_ = row_limit;
+  }
+
   // Init scan iterator.
   CHECKED_STATUS Init();
 
@@ -108,11 +120,40 @@ class DocRowwiseIterator : public common::YQLRowwiseIteratorIf {
 
   virtual Result<std::string> GetRowKey() const override;
 
+  void SetDeadline(CoarseTimePoint deadline) override;
+
+  bool is_bulk_scan() const {
+    return is_bulk_scan_;
+  }
+
   // Seek to the given key.
   virtual CHECKED_STATUS Seek(const std::string& row_key) override;
 
  private:
 
+  // Checks whether a scan starting at lower_doc_key should be treated as a bulk scan, see
+  // set_row_limit.
+  bool IsBulkScan(const DocKey& lower_doc_key, bool is_fixed_point_get) const;
+
+  // Forward scans starting at lower_doc_key that are not restricted to a single hash key read
+  // long sequential ranges of SST files, so they prefetch data blocks.
+  ReadaheadMode GetReadaheadMode(const DocKey& lower_doc_key, bool is_fixed_point_get) const;
+
+  // Starts a point read of the row between the given bounds that could use the row cache. Returns
+  // true if the row was found in the cache, in which case it is the only row to read.
+  bool StartCachedRowRead(const DocKey& lower_doc_key, const DocKey& upper_doc_key);
+
+  // Stores the row just read by a point read started by StartCachedRowRead in the row cache.
+  void CacheRow() const;
+
+  // Adds skipping of SST files that only contain records expired according to the table TTL.
+  std::shared_ptr<rocksdb::ReadFileFilter> CreateFileFilter(
+      std::shared_ptr<rocksdb::ReadFileFilter> file_filter) const;
+
+  // Adds skipping of data blocks that only contain records written after the read time.
+  std::shared_ptr<rocksdb::ReadBlockFilter> CreateBlockFilter(
+      std::shared_ptr<rocksdb::ReadBlockFilter> block_filter) const;
+
   // Retrieves the next key to read after the iterator finishes for the given page.
   CHECKED_STATUS GetNextReadSubDocKey(SubDocKey* sub_doc_key) const;
 
@@ -164,6 +205,11 @@ class DocRowwiseIterator : public common::YQLRowwiseIteratorIf {
 
   bool is_forward_scan_ = true;
 
+  // Number of rows the caller is going to read, see set_row_limit.
+  uint64_t row_limit_ = 0;
+
+  bool is_bulk_scan_ = false;
+
   const CoarseTimePoint deadline_;
 
   const ReadHybridTime read_time_;
@@ -197,6 +243,9 @@ class DocRowwiseIterator : public common::YQLRowwiseIteratorIf {
   // The current row's iterator key.
   mutable KeyBytes iter_key_;
 
+  // Reusable buffer to encode row_key_ for seeks.
+  mutable KeyBytes row_key_buffer_;
+
   // When HasNext constructs a row, row_ready_ is set to true.
   // When NextRow consumes the row, this variable is set to false.
   // It is initialized to false, to make sure first HasNext constructs a new row.
@@ -204,6 +253,20 @@ class DocRowwiseIterator : public common::YQLRowwiseIteratorIf {
 
   mutable std::vector<PrimitiveValue> projection_subkeys_;
 
+  // Whether row_ was read from the row cache.
+  bool row_from_cache_ = false;
+
+  // Encoded key of the row read by a point read that should be stored to the row cache, if any.
+  mutable KeyBytes cached_row_key_;
+  uint64_t row_cache_generation_ = 0;
+
+  // Whether rows could be deleted by range tombstones, which are only written to QL tables with
+  // both hash and range columns.
+  bool read_range_tombstones_ = false;
+
+  // The range tombstones of the partition of the current row.
+  mutable RangeTombstones range_tombstones_;
+
   // Used for keeping track of errors that happen in HasNext. Returned
   mutable Status status_;
 
@@ -471,7 +471,8 @@ Status DocWriteBatch::ReplaceInList(
     bool is_cql) {
   SubDocKey sub_doc_key;
   RETURN_NOT_OK(sub_doc_key.FromDocPath(doc_path));
-  key_prefix_ = sub_doc_key.Encode();
+  key_prefix_.Clear();
+  sub_doc_key.AppendTo(&key_prefix_);
 
   auto iter = yb::docdb::CreateIntentAwareIterator(
       doc_db_,
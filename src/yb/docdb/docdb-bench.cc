@@ -0,0 +1,366 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+// Micro-benchmarks of DocDB: DocKey and SubDocKey encoding and decoding, DocRowwiseIterator scans
+// and point gets over synthetic SSTs with a configurable number of versions per column and share
+// of rows with committed intents, and the throughput of the compaction filter during a major
+// compaction.
+//
+// Each benchmark reports its throughput and latency percentiles as a JSON object, written to
+// <docdb_bench_output_dir>/<benchmark>.json, or logged when the directory is not set.
+
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <gflags/gflags.h>
+
+#include "yb/common/transaction-test-util.h"
+
+#include "yb/docdb/doc_key.h"
+#include "yb/docdb/doc_ql_scanspec.h"
+#include "yb/docdb/doc_rowwise_iterator.h"
+#include "yb/docdb/docdb_test_base.h"
+
+#include "yb/util/env.h"
+#include "yb/util/hdr_histogram.h"
+#include "yb/util/jsonwriter.h"
+#include "yb/util/path_util.h"
+#include "yb/util/random_util.h"
+#include "yb/util/test_macros.h"
+#include "yb/util/test_util.h"
+
+DEFINE_int32(docdb_bench_iterations, 1000000,
+             "Number of keys encoded or decoded by the key benchmarks.");
+DEFINE_int32(docdb_bench_rows, 10000, "Number of rows written for the iterator benchmarks.");
+DEFINE_int32(docdb_bench_versions, 4, "Number of versions written for each column of a row.");
+DEFINE_int32(docdb_bench_intents_percent, 10,
+             "Percent of rows that get one more version through a committed transaction, so it "
+             "is read from the intents DB, in the benchmarks with intents.");
+DEFINE_int32(docdb_bench_scans, 5, "Number of full scans done by the scan benchmarks.");
+DEFINE_int32(docdb_bench_point_gets, 10000, "Number of point gets done by the get benchmarks.");
+DEFINE_string(docdb_bench_output_dir, "",
+              "Directory to write the results of each benchmark to, as <benchmark>.json. The "
+              "results are logged when empty.");
+
+namespace yb {
+namespace docdb {
+
+namespace {
+
+// Latencies are tracked in microseconds, up to a minute.
+constexpr uint64_t kMaxLatencyUs = 60 * 1000 * 1000;
+
+// Rows are written in write batches of this number of rows.
+constexpr int kRowsPerWriteBatch = 100;
+
+const std::pair<const char*, double> kPercentiles[] = {
+    {"p50", 50}, {"p90", 90}, {"p99", 99}, {"p99.9", 99.9}, {"p99.99", 99.99}};
+
+// Throughput and latency distribution of one benchmark.
+class BenchmarkResult {
+ public:
+  explicit BenchmarkResult(std::string name)
+      : name_(std::move(name)), latency_us_(kMaxLatencyUs, 3) {}
+
+  void RecordLatency(MonoDelta latency) {
+    latency_us_.Increment(
+        std::min<uint64_t>(std::max<int64_t>(latency.ToMicroseconds(), 0), kMaxLatencyUs));
+  }
+
+  void AddOps(int64_t ops) {
+    ops_ += ops;
+  }
+
+  CHECKED_STATUS Finish() {
+    const auto elapsed = MonoTime::Now() - start_;
+    std::stringstream out;
+    {
+      JsonWriter writer(&out, JsonWriter::PRETTY);
+      writer.StartObject();
+      writer.String("benchmark");
+      writer.String(name_);
+
+      writer.String("params");
+      writer.StartObject();
+      writer.String("iterations");
+      writer.Int(FLAGS_docdb_bench_iterations);
+      writer.String("rows");
+      writer.Int(FLAGS_docdb_bench_rows);
+      writer.String("versions");
+      writer.Int(FLAGS_docdb_bench_versions);
+      writer.String("intents_percent");
+      writer.Int(FLAGS_docdb_bench_intents_percent);
+      writer.EndObject();
+
+      writer.String("ops");
+      writer.Int64(ops_);
+      writer.String("elapsed_us");
+      writer.Int64(elapsed.ToMicroseconds());
+      writer.String("ops_per_sec");
+      writer.Double(elapsed.ToSeconds() > 0 ? ops_ / elapsed.ToSeconds() : 0);
+
+      writer.String("latency_us");
+      writer.StartObject();
+      writer.String("count");
+      writer.Uint64(latency_us_.TotalCount());
+      if (latency_us_.TotalCount() > 0) {
+        writer.String("min");
+        writer.Uint64(latency_us_.MinValue());
+        writer.String("mean");
+        writer.Double(latency_us_.MeanValue());
+        for (const auto& percentile : kPercentiles) {
+          writer.String(percentile.first);
+          writer.Uint64(latency_us_.ValueAtPercentile(percentile.second));
+        }
+        writer.String("max");
+        writer.Uint64(latency_us_.MaxValue());
+      }
+      writer.EndObject();
+      writer.EndObject();
+    }
+
+    if (FLAGS_docdb_bench_output_dir.empty()) {
+      LOG(INFO) << "Benchmark results: " << out.str();
+      return Status::OK();
+    }
+    const auto path = JoinPathSegments(FLAGS_docdb_bench_output_dir, name_ + ".json");
+    RETURN_NOT_OK_PREPEND(WriteStringToFile(Env::Default(), out.str(), path),
+                          "Unable to write benchmark results to " + path);
+    LOG(INFO) << "Benchmark results written to " << path;
+    return Status::OK();
+  }
+
+ private:
+  const std::string name_;
+  HdrHistogram latency_us_;
+  // Throughput is measured from the construction to Finish.
+  const MonoTime start_ = MonoTime::Now();
+  int64_t ops_ = 0;
+};
+
+DocKey RowKey(int64_t row) {
+  return DocKey({PrimitiveValue(Format("row$0", row)), PrimitiveValue(row)});
+}
+
+} // namespace
+
+class DocDBBench : public DocDBTestBase {
+ protected:
+  DocDBBench()
+      : schema_({ ColumnSchema("k", DataType::STRING, /* is_nullable = */ false),
+                  ColumnSchema("r", DataType::INT64, false),
+                  // Non-key columns
+                  ColumnSchema("v1", DataType::STRING, true),
+                  ColumnSchema("v2", DataType::INT64, true) },
+                { 10_ColId, 20_ColId, 30_ColId, 40_ColId }, 2) {
+    CHECK_OK(schema_.CreateProjectionByNames({"v1", "v2"}, &projection_));
+  }
+
+  // Writes FLAGS_docdb_bench_versions versions of each column of FLAGS_docdb_bench_rows rows, each
+  // version flushed to its own SST, and when with_intents is true one more version of
+  // FLAGS_docdb_bench_intents_percent of rows through a committed transaction. Returns the number
+  // of written entries.
+  int64_t WriteRows(bool with_intents) {
+    auto write_batch = MakeDocWriteBatch();
+    int64_t entries = 0;
+    for (int version = 0; version != FLAGS_docdb_bench_versions; ++version) {
+      for (int row = 0; row != FLAGS_docdb_bench_rows; ++row) {
+        WriteRow(row, version, &write_batch);
+        entries += 2;
+        if ((row + 1) % kRowsPerWriteBatch == 0) {
+          CHECK_OK(WriteToRocksDBAndClear(&write_batch, VersionTime(version)));
+        }
+      }
+      CHECK_OK(WriteToRocksDBAndClear(&write_batch, VersionTime(version)));
+      CHECK_OK(FlushRocksDbAndWait());
+    }
+    if (!with_intents) {
+      return entries;
+    }
+
+    SetTransactionIsolationLevel(IsolationLevel::SNAPSHOT_ISOLATION);
+    const auto intents_time = VersionTime(FLAGS_docdb_bench_versions);
+    const auto txn_id = GenerateTransactionId();
+    SetCurrentTransactionId(txn_id);
+    for (int row = 0; row != FLAGS_docdb_bench_rows; ++row) {
+      if (row % 100 < FLAGS_docdb_bench_intents_percent) {
+        WriteRow(row, FLAGS_docdb_bench_versions, &write_batch);
+        entries += 2;
+      }
+    }
+    CHECK_OK(WriteToRocksDBAndClear(&write_batch, intents_time));
+    ResetCurrentTransactionId();
+    txn_status_manager_.Commit(txn_id, intents_time);
+    return entries;
+  }
+
+  // Context of a read by another transaction, that resolves the committed intents.
+  TransactionOperationContextOpt ReadContext(bool with_intents) {
+    if (!with_intents) {
+      return kNonTransactionalOperationContext;
+    }
+    return TransactionOperationContext(GenerateTransactionId(), &txn_status_manager_);
+  }
+
+  // Reads at a time after all versions and intents were written.
+  ReadHybridTime ReadTime() {
+    return ReadHybridTime::SingleTime(VersionTime(FLAGS_docdb_bench_versions + 1));
+  }
+
+  void Scan(bool with_intents, const std::string& name) {
+    WriteRows(with_intents);
+    BenchmarkResult result(name);
+    const auto txn_context = ReadContext(with_intents);
+    for (int i = 0; i != FLAGS_docdb_bench_scans; ++i) {
+      const auto start = MonoTime::Now();
+      DocRowwiseIterator iter(
+          projection_, schema_, txn_context, doc_db(), CoarseTimePoint::max() /* deadline */,
+          ReadTime());
+      ASSERT_OK(iter.Init());
+      QLTableRow row;
+      int64_t rows = 0;
+      while (iter.HasNext()) {
+        ASSERT_OK(iter.NextRow(&row));
+        ++rows;
+      }
+      ASSERT_EQ(FLAGS_docdb_bench_rows, rows);
+      result.RecordLatency(MonoTime::Now() - start);
+      result.AddOps(rows);
+    }
+    ASSERT_OK(result.Finish());
+  }
+
+  void PointGet(bool with_intents, const std::string& name) {
+    WriteRows(with_intents);
+    std::mt19937_64 rng(123456);
+    BenchmarkResult result(name);
+    const auto txn_context = ReadContext(with_intents);
+    for (int i = 0; i != FLAGS_docdb_bench_point_gets; ++i) {
+      const auto key = RowKey(RandomUniformInt(0, FLAGS_docdb_bench_rows - 1, &rng));
+      const auto start = MonoTime::Now();
+      DocQLScanSpec spec(schema_, key, rocksdb::kDefaultQueryId);
+      DocRowwiseIterator iter(
+          projection_, schema_, txn_context, doc_db(), CoarseTimePoint::max() /* deadline */,
+          ReadTime());
+      ASSERT_OK(iter.Init(spec));
+      ASSERT_TRUE(iter.HasNext());
+      QLTableRow row;
+      ASSERT_OK(iter.NextRow(&row));
+      result.RecordLatency(MonoTime::Now() - start);
+      result.AddOps(1);
+    }
+    ASSERT_OK(result.Finish());
+  }
+
+  const Schema schema_;
+  Schema projection_;
+  TransactionStatusManagerMock txn_status_manager_;
+
+ private:
+  void WriteRow(int64_t row, int version, DocWriteBatch* write_batch) {
+    const auto key = RowKey(row).Encode();
+    CHECK_OK(write_batch->SetPrimitive(
+        DocPath(key, PrimitiveValue(30_ColId)),
+        PrimitiveValue(Format("value_$0_$1", row, version))));
+    CHECK_OK(write_batch->SetPrimitive(
+        DocPath(key, PrimitiveValue(40_ColId)), PrimitiveValue(row * version)));
+  }
+
+  static HybridTime VersionTime(int version) {
+    return HybridTime::FromMicros(1000 * (version + 1));
+  }
+};
+
+TEST_F(DocDBBench, DocKeyEncode) {
+  const DocKey key(0x1234, {PrimitiveValue("hash_component")},
+                   {PrimitiveValue("range_component"), PrimitiveValue(12345)});
+  BenchmarkResult result("doc_key_encode");
+  size_t total_size = 0;
+  for (int i = 0; i != FLAGS_docdb_bench_iterations; ++i) {
+    total_size += key.Encode().size();
+  }
+  result.AddOps(FLAGS_docdb_bench_iterations);
+  ASSERT_OK(result.Finish());
+  ASSERT_GT(total_size, 0);
+}
+
+TEST_F(DocDBBench, DocKeyDecode) {
+  const auto encoded = DocKey(
+      0x1234, {PrimitiveValue("hash_component")},
+      {PrimitiveValue("range_component"), PrimitiveValue(12345)}).Encode();
+  BenchmarkResult result("doc_key_decode");
+  DocKey key;
+  for (int i = 0; i != FLAGS_docdb_bench_iterations; ++i) {
+    ASSERT_OK_FAST(key.DecodeFrom(encoded.AsSlice()));
+  }
+  result.AddOps(FLAGS_docdb_bench_iterations);
+  ASSERT_OK(result.Finish());
+}
+
+TEST_F(DocDBBench, SubDocKeyEncode) {
+  const SubDocKey key(RowKey(12345), PrimitiveValue(30_ColId), HybridTime::FromMicros(1000));
+  BenchmarkResult result("sub_doc_key_encode");
+  size_t total_size = 0;
+  for (int i = 0; i != FLAGS_docdb_bench_iterations; ++i) {
+    total_size += key.Encode().size();
+  }
+  result.AddOps(FLAGS_docdb_bench_iterations);
+  ASSERT_OK(result.Finish());
+  ASSERT_GT(total_size, 0);
+}
+
+TEST_F(DocDBBench, SubDocKeyDecode) {
+  const auto encoded = SubDocKey(
+      RowKey(12345), PrimitiveValue(30_ColId), HybridTime::FromMicros(1000)).Encode();
+  BenchmarkResult result("sub_doc_key_decode");
+  SubDocKey key;
+  for (int i = 0; i != FLAGS_docdb_bench_iterations; ++i) {
+    ASSERT_OK_FAST(key.FullyDecodeFrom(encoded.AsSlice()));
+  }
+  result.AddOps(FLAGS_docdb_bench_iterations);
+  ASSERT_OK(result.Finish());
+}
+
+TEST_F(DocDBBench, Scan) {
+  Scan(false /* with_intents */, "scan");
+}
+
+TEST_F(DocDBBench, ScanWithIntents) {
+  Scan(true /* with_intents */, "scan_with_intents");
+}
+
+TEST_F(DocDBBench, PointGet) {
+  PointGet(false /* with_intents */, "point_get");
+}
+
+TEST_F(DocDBBench, PointGetWithIntents) {
+  PointGet(true /* with_intents */, "point_get_with_intents");
+}
+
+// Throughput of a major compaction that drops all versions but the latest one, in entries read by
+// the compaction filter per second.
+TEST_F(DocDBBench, CompactionFilter) {
+  const auto entries = WriteRows(false /* with_intents */);
+  BenchmarkResult result("compaction_filter");
+  const auto start = MonoTime::Now();
+  FullyCompactHistoryBefore(HybridTime::FromMicros(1000 * FLAGS_docdb_bench_versions));
+  result.RecordLatency(MonoTime::Now() - start);
+  result.AddOps(entries);
+  ASSERT_OK(result.Finish());
+  ASSERT_EQ(1, NumSSTableFiles());
+}
+
+} // namespace docdb
+} // namespace yb
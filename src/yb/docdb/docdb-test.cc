@@ -58,6 +58,8 @@ using namespace std::chrono_literals;
 
 DECLARE_bool(use_docdb_aware_bloom_filter);
 DECLARE_int32(max_nexts_to_avoid_seek);
+DECLARE_bool(docdb_ttl_file_expiration);
+DECLARE_bool(docdb_single_delete_intents);
 
 #define ASSERT_DOC_DB_DEBUG_DUMP_STR_EQ(str) ASSERT_NO_FATALS(AssertDocDbDebugDumpStrEq(str))
 
@@ -473,6 +475,20 @@ void DocDBTest::CheckExpectedLatestDBState() {
 
 // ------------------------------------------------------------------------------------------------
 
+TEST_F(DocDBTest, NonTransactionWriteBatchSizeUpperBound) {
+  KeyValueWriteBatchPB put_batch;
+  for (int i = 0; i != 100; ++i) {
+    auto* pair = put_batch.add_write_pairs();
+    pair->set_key(DocKey(PrimitiveValues(Format("key_$0", i), i)).Encode().data());
+    pair->set_value(Value(PrimitiveValue(std::string(i, 'x'))).Encode());
+  }
+  rocksdb::WriteBatch write_batch;
+  PrepareNonTransactionWriteBatch(
+      put_batch, HybridTime::FromMicros(1000000), &write_batch);
+  ASSERT_EQ(put_batch.write_pairs_size(), write_batch.Count());
+  ASSERT_LE(write_batch.GetDataSize(), NonTransactionWriteBatchSizeUpperBound(put_batch));
+}
+
 TEST_F(DocDBTest, DocPathTest) {
   DocKey doc_key(PrimitiveValues("mydockey", 10, "mydockey", 20));
   DocPath doc_path(doc_key.Encode(), "first_subkey", 123);
@@ -1775,6 +1791,45 @@ SubDocKey(DocKey([], ["k6"]), [HT{ physical: 9000 }]) -> "v6"; ttl: 0.009s
       )#");
 }
 
+TEST_F(DocDBTest, BlindIncrements) {
+  const DocKey doc_key(PrimitiveValues("k1"));
+  KeyBytes encoded_doc_key(doc_key.Encode());
+  const DocPath path0(encoded_doc_key, PrimitiveValue(ColumnId(0)));
+  const DocPath path1(encoded_doc_key, PrimitiveValue(ColumnId(1)));
+  auto increment = [](int64_t delta) {
+    return Value(PrimitiveValue(delta), Value::kMaxTtl, Value::kInvalidUserTimestamp,
+                 Value::kIncrementFlag);
+  };
+  ASSERT_OK(SetPrimitive(path0, Value(PrimitiveValue(10)), 1000_usec_ht));
+  ASSERT_OK(SetPrimitive(path1, increment(3), 1000_usec_ht));
+  ASSERT_OK(SetPrimitive(path0, increment(5), 2000_usec_ht));
+  ASSERT_OK(SetPrimitive(path1, increment(4), 2000_usec_ht));
+  ASSERT_OK(SetPrimitive(path0, increment(-2), 3000_usec_ht));
+  ASSERT_OK(SetPrimitive(path0, Value(PrimitiveValue::kTombstone), 4000_usec_ht));
+  ASSERT_OK(SetPrimitive(path0, increment(1), 5000_usec_ht));
+
+  const SubDocKey key0(doc_key, PrimitiveValue(ColumnId(0)));
+  const SubDocKey key1(doc_key, PrimitiveValue(ColumnId(1)));
+  VerifySubDocument(key0, 1500_usec_ht, "10");
+  VerifySubDocument(key0, 2500_usec_ht, "15");
+  VerifySubDocument(key0, 3500_usec_ht, "13");
+  VerifySubDocument(key0, 4500_usec_ht, "");
+  VerifySubDocument(key0, 5500_usec_ht, "1");
+  VerifySubDocument(key1, 1500_usec_ht, "3");
+  VerifySubDocument(key1, 2500_usec_ht, "7");
+
+  // Increments do not overwrite older values, so compactions only drop what the tombstone hides.
+  FullyCompactHistoryBefore(6000_usec_ht);
+  ASSERT_DOC_DB_DEBUG_DUMP_STR_EQ(
+      R"#(
+SubDocKey(DocKey([], ["k1"]), [ColumnId(0); HT{ physical: 5000 }]) -> 1; merge flags: 2
+SubDocKey(DocKey([], ["k1"]), [ColumnId(1); HT{ physical: 2000 }]) -> 4; merge flags: 2
+SubDocKey(DocKey([], ["k1"]), [ColumnId(1); HT{ physical: 1000 }]) -> 3; merge flags: 2
+      )#");
+  VerifySubDocument(key0, 6500_usec_ht, "1");
+  VerifySubDocument(key1, 6500_usec_ht, "7");
+}
+
 TEST_F(DocDBTest, TTLCompactionTest) {
   const DocKey doc_key(PrimitiveValues("k1"));
   const MonoDelta one_ms = 1ms;
@@ -1934,6 +1989,95 @@ SubDocKey(DocKey([], ["k1"]), ["s3"; HT{ physical: 2000 }]) -> "v3"; ttl: 0.000s
       )#");
 }
 
+TEST_F(DocDBTest, TableTTLFileExpirationTest) {
+  FLAGS_docdb_ttl_file_expiration = true;
+  SetTableTTL(1);
+
+  // Expires at 2000 according to table TTL.
+  ASSERT_OK(SetPrimitive(DocPath(DocKey(PrimitiveValues("k1")).Encode(), PrimitiveValue("s")),
+      Value(PrimitiveValue("v1")), 1000_usec_ht));
+  ASSERT_OK(FlushRocksDbAndWait());
+  // Explicit value TTL keeps this file until 13000.
+  ASSERT_OK(SetPrimitive(DocPath(DocKey(PrimitiveValues("k2")).Encode(), PrimitiveValue("s")),
+      Value(PrimitiveValue("v2"), 10ms), 3000_usec_ht));
+  ASSERT_OK(FlushRocksDbAndWait());
+  // Expires at 6000 according to table TTL.
+  ASSERT_OK(SetPrimitive(DocPath(DocKey(PrimitiveValues("k3")).Encode(), PrimitiveValue("s")),
+      Value(PrimitiveValue("v3")), 5000_usec_ht));
+  ASSERT_OK(FlushRocksDbAndWait());
+  ASSERT_EQ(3, NumSSTableFiles());
+
+  FullyCompactHistoryBefore(5500_usec_ht);
+
+  // The first file is dropped without passing its records through the compaction filter.
+  ASSERT_EQ(0, options().statistics->getTickerCount(rocksdb::COMPACTION_KEY_DROP_USER));
+  ASSERT_DOC_DB_DEBUG_DUMP_STR_EQ(R"#(
+      SubDocKey(DocKey([], ["k2"]), ["s"; HT{ physical: 3000 }]) -> "v2"; ttl: 0.010s
+      SubDocKey(DocKey([], ["k3"]), ["s"; HT{ physical: 5000 }]) -> "v3"
+      )#");
+}
+
+TEST_F(DocDBTest, GarbageEstimate) {
+  ASSERT_OK(DisableCompactions());
+  SetHistoryCutoffHybridTime(5000_usec_ht);
+  auto path = [](const char* key) {
+    return DocPath(DocKey(PrimitiveValues(key)).Encode(), PrimitiveValue("s"));
+  };
+
+  // Two overwritten versions.
+  ASSERT_OK(SetPrimitive(path("k1"), Value(PrimitiveValue("v1")), 1000_usec_ht));
+  ASSERT_OK(SetPrimitive(path("k1"), Value(PrimitiveValue("v2")), 2000_usec_ht));
+  ASSERT_OK(SetPrimitive(path("k1"), Value(PrimitiveValue("v3")), 3000_usec_ht));
+  // A tombstone and the value it deletes.
+  ASSERT_OK(SetPrimitive(path("k2"), Value(PrimitiveValue("v1")), 1000_usec_ht));
+  ASSERT_OK(DeleteSubDoc(path("k2"), 2000_usec_ht));
+  // Expires at 2000.
+  ASSERT_OK(SetPrimitive(path("k3"), Value(PrimitiveValue("v1"), 1ms), 1000_usec_ht));
+  // Written after the history cutoff.
+  ASSERT_OK(SetPrimitive(path("k4"), Value(PrimitiveValue("v1")), 6000_usec_ht));
+  ASSERT_OK(FlushRocksDbAndWait());
+
+  auto estimate = ASSERT_RESULT(GetGarbageEstimate(rocksdb()));
+  LOG(INFO) << "Garbage estimate: " << estimate.ToString();
+  ASSERT_GE(estimate.total_entries, 7);
+  ASSERT_EQ(3, estimate.overwritten_entries);
+  ASSERT_EQ(1, estimate.expired_entries);
+  ASSERT_EQ(1, estimate.deleted_entries);
+
+  FullyCompactHistoryBefore(5000_usec_ht);
+  estimate = ASSERT_RESULT(GetGarbageEstimate(rocksdb()));
+  ASSERT_EQ(0, estimate.reclaimable_entries());
+  ASSERT_EQ(0, estimate.ReclaimableRatio());
+}
+
+TEST_F(DocDBTest, CompactionFilterKeyBounds) {
+  auto key = [](DocKeyHash hash) {
+    return SubDocKey(DocKey(hash, PrimitiveValues("k")), PrimitiveValue(ColumnId(1)),
+                     HybridTime::FromMicros(1000)).Encode();
+  };
+  KeyBounds key_bounds;
+  key_bounds.lower.AppendValueType(ValueType::kUInt16Hash);
+  key_bounds.lower.AppendUInt16(0x4000);
+  key_bounds.upper.AppendValueType(ValueType::kUInt16Hash);
+  key_bounds.upper.AppendUInt16(0x8000);
+
+  HistoryRetentionDirective retention{
+      HybridTime::kMin, std::make_shared<ColumnIds>(), MonoDelta()};
+  DocDBCompactionFilter filter(retention, IsMajorCompaction::kFalse, key_bounds);
+  filter.DisableUsageLogging();
+  std::string new_value;
+  bool value_changed = false;
+  auto filtered = [&](DocKeyHash hash) {
+    return filter.Filter(0, key(hash).AsSlice(), Value(PrimitiveValue("v")).Encode(), &new_value,
+                         &value_changed);
+  };
+  ASSERT_TRUE(filtered(0x1000));
+  ASSERT_FALSE(filtered(0x4000));
+  ASSERT_FALSE(filtered(0x7fff));
+  ASSERT_TRUE(filtered(0x8000));
+  ASSERT_TRUE(filtered(0xffff));
+}
+
 TEST_F(DocDBTest, MinorCompactionNoDeletions) {
   ASSERT_OK(DisableCompactions());
   const DocKey doc_key(PrimitiveValues("k"));
@@ -3190,6 +3334,35 @@ TXN REV 30303030-3030-3030-3030-303030303032 HT{ physical: 5000 w: 2 } -> \
       )#");
 }
 
+// Intents removed before the intents DB is flushed should not reach SST files.
+TEST_F(DocDBTest, SingleDeleteIntents) {
+  FLAGS_docdb_single_delete_intents = true;
+  const DocKey doc_key(PrimitiveValues("mydockey", 123456));
+  KeyBytes encoded_doc_key(doc_key.Encode());
+
+  SetTransactionIsolationLevel(IsolationLevel::SNAPSHOT_ISOLATION);
+  const auto txn = ASSERT_RESULT(FullyDecodeTransactionId("0000000000000001"));
+  SetCurrentTransactionId(txn);
+  ASSERT_OK(SetPrimitive(
+      DocPath(encoded_doc_key, "subkey1"), PrimitiveValue("value1"), 1000_usec_ht));
+  ASSERT_OK(SetPrimitive(
+      DocPath(encoded_doc_key, "subkey2"), PrimitiveValue("value2"), 1000_usec_ht));
+  ResetCurrentTransactionId();
+
+  rocksdb::WriteBatch regular_batch;
+  rocksdb::WriteBatch intents_batch;
+  ASSERT_OK(PrepareApplyIntentsBatch(
+      txn, 2000_usec_ht, &regular_batch, intents_db(), &intents_batch));
+  ASSERT_EQ(2, regular_batch.Count());
+  ASSERT_OK(rocksdb()->Write(write_options(), &regular_batch));
+  ASSERT_OK(intents_db()->Write(write_options(), &intents_batch));
+
+  rocksdb::FlushOptions flush_options;
+  flush_options.wait = true;
+  ASSERT_OK(intents_db()->Flush(flush_options));
+  ASSERT_EQ(0U, intents_db()->GetLiveFilesMetaData().size());
+}
+
 TEST_F(DocDBTest, ForceFlushedFrontier) {
   // We run with compactions disabled, because they may interefere with force-setting the OpId.
   ASSERT_OK(DisableCompactions());
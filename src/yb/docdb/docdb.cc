@@ -32,6 +32,7 @@
 #include "yb/docdb/docdb_util.h"
 #include "yb/docdb/intent.h"
 #include "yb/docdb/intent_aware_iterator.h"
+#include "yb/docdb/packed_row.h"
 #include "yb/docdb/pgsql_operation.h"
 #include "yb/docdb/shared_lock_manager.h"
 #include "yb/docdb/subdocument.h"
@@ -46,6 +47,7 @@
 #include "yb/util/bytes_formatter.h"
 #include "yb/util/date_time.h"
 #include "yb/util/enums.h"
+#include "yb/util/flag_tags.h"
 #include "yb/util/logging.h"
 #include "yb/util/status.h"
 #include "yb/util/metrics.h"
@@ -65,12 +67,69 @@ using yb::util::FormatBytesAsStr;
 using yb::FormatRocksDBSliceAsStr;
 using strings::Substitute;
 
+DEFINE_bool(docdb_prefetch_read_before_write_keys, true,
+            "When a write batch contains several operations that read before writing, seek a "
+            "single RocksDB iterator over their sorted keys before applying them, so that the "
+            "per-operation reads are served from the block cache.");
+TAG_FLAG(docdb_prefetch_read_before_write_keys, advanced);
+
+DEFINE_bool(docdb_single_delete_intents, false,
+            "Remove applied and aborted intents with single deletes, so that the intents of "
+            "transactions that finish before the intents DB memtable is flushed are dropped by "
+            "the flush together with their removals, instead of being written to SST files.");
+TAG_FLAG(docdb_single_delete_intents, advanced);
+TAG_FLAG(docdb_single_delete_intents, runtime);
 
 namespace yb {
 namespace docdb {
 
 namespace {
 
+// Warms up the block cache for the rows that doc_write_ops are going to read. Operations are still
+// applied in their original order, but instead of each of them doing a random access on a cold
+// cache, the blocks are brought in by one forward pass over the sorted, deduplicated keys.
+void PrefetchReadBeforeWriteKeys(const vector<unique_ptr<DocOperation>>& doc_write_ops,
+                                 const DocDB& doc_db) {
+  boost::container::small_vector<RefCntPrefix, 16> paths;
+  size_t num_reading_ops = 0;
+  for (const auto& doc_op : doc_write_ops) {
+    if (!doc_op->RequireReadSnapshot()) {
+      continue;
+    }
+    ++num_reading_ops;
+    IsolationLevel ignored_isolation_level;
+    if (!doc_op->GetDocPaths(GetDocPathsMode::kLock, &paths, &ignored_isolation_level).ok()) {
+      // Prefetch is only an optimization, the operation itself will report the failure.
+      return;
+    }
+  }
+  if (num_reading_ops < 2 || paths.size() < 2) {
+    return;
+  }
+
+  std::sort(paths.begin(), paths.end(), [](const RefCntPrefix& lhs, const RefCntPrefix& rhs) {
+    return lhs.as_slice().compare(rhs.as_slice()) < 0;
+  });
+  auto iter = CreateRocksDBIterator(
+      doc_db.regular, BloomFilterMode::DONT_USE_BLOOM_FILTER, boost::none,
+      rocksdb::kDefaultQueryId);
+  Slice prev;
+  for (const auto& path : paths) {
+    auto key = path.as_slice();
+    if (key == prev) {
+      continue;
+    }
+    prev = key;
+    // Skip the seek when the iterator already stands inside the requested prefix.
+    if (!iter->Valid() || !iter->key().starts_with(key)) {
+      iter->Seek(key);
+    }
+    if (!iter->Valid()) {
+      break;
+    }
+  }
+}
+
 constexpr size_t kMaxWordsPerEncodedHybridTimeWithValueType =
     ((kMaxBytesPerEncodedHybridTime + 1) + sizeof(size_t) - 1) / sizeof(size_t);
 
@@ -307,6 +366,9 @@ Status ExecuteDocWriteOperation(const vector<unique_ptr<DocOperation>>& doc_writ
   DCHECK_ONLY_NOTNULL(restart_read_ht);
   DocWriteBatch doc_write_batch(doc_db, init_marker_behavior, monotonic_counter);
   DocOperationApplyData data = {&doc_write_batch, deadline, read_time, restart_read_ht};
+  if (FLAGS_docdb_prefetch_read_before_write_keys && doc_write_ops.size() > 1) {
+    PrefetchReadBeforeWriteKeys(doc_write_ops, doc_db);
+  }
   for (const unique_ptr<DocOperation>& doc_op : doc_write_ops) {
     Status s = doc_op->Apply(data);
     if (s.IsQLError()) {
@@ -364,6 +426,21 @@ void PrepareNonTransactionWriteBatch(
   }
 }
 
+size_t NonTransactionWriteBatchSizeUpperBound(const KeyValueWriteBatchPB& put_batch) {
+  // Write batch header: sequence number and count.
+  constexpr size_t kWriteBatchHeaderSize = 12;
+  // Record type and two varint32 lengths.
+  constexpr size_t kRecordOverhead = 1 + 2 * 5;
+  // ValueType::kHybridTime followed by the encoded DocHybridTime.
+  constexpr size_t kHybridTimeSize = 1 + kMaxBytesPerEncodedHybridTime;
+
+  size_t result = kWriteBatchHeaderSize;
+  for (const auto& kv_pair : put_batch.write_pairs()) {
+    result += kRecordOverhead + kv_pair.key().size() + kHybridTimeSize + kv_pair.value().size();
+  }
+  return result;
+}
+
 Status EnumerateIntents(
     Slice key, const Slice& value, const EnumerateIntentsCallback& functor,
     KeyBytes* encoded_key_buffer) {
@@ -552,6 +629,32 @@ void SeekToLowerBound(const SliceKeyBound& lower_bound, IntentAwareIterator* ite
   }
 }
 
+// Sets the remaining TTL and the write time of a primitive value written at write_time, as
+// returned to CQL.
+void SetTtlAndWriteTime(
+    const Expiration& exp, const ReadHybridTime& read_time, const DocHybridTime& write_time,
+    UserTimeMicros user_timestamp, PrimitiveValue* value) {
+  // TODO: the ttl_seconds in primitive value is currently only in use for CQL. At some
+  // point streamline by refactoring CQL to use the mutable Expiration in GetSubDocumentData.
+  if (exp.ttl == Value::kMaxTtl) {
+    value->SetTtl(-1);
+  } else {
+    int64_t time_since_write_seconds = (
+        server::HybridClock::GetPhysicalValueMicros(read_time.read) -
+        server::HybridClock::GetPhysicalValueMicros(write_time.hybrid_time())) /
+        MonoTime::kMicrosecondsPerSecond;
+    int64_t ttl_seconds = std::max(static_cast<int64_t>(0),
+        exp.ttl.ToMilliseconds() /
+        MonoTime::kMillisecondsPerSecond - time_since_write_seconds);
+    value->SetTtl(ttl_seconds);
+  }
+  // Choose the user supplied timestamp if present.
+  value->SetWriteTime(
+      user_timestamp == Value::kInvalidUserTimestamp
+      ? write_time.hybrid_time().GetPhysicalValueMicros()
+      : user_timestamp);
+}
+
 // This function does not assume that object init_markers are present. If no init marker is present,
 // or if a tombstone is found at some level, it still looks for subkeys inside it if they have
 // larger timestamps.
@@ -574,6 +677,8 @@ CHECKED_STATUS BuildSubDocument(
     int64* num_values_observed) {
   VLOG(3) << "BuildSubDocument data: " << data << " read_time: " << iter->read_time()
           << " low_ts: " << low_ts;
+  // Reused by the iterations, so the keys of the subdocument are copied into one buffer.
+  KeyBytes key_copy;
   while (iter->valid()) {
     if (data.deadline_info && data.deadline_info->CheckAndSetDeadlinePassed()) {
       return STATUS(Expired, "Deadline for query passed.");
@@ -589,7 +694,7 @@ CHECKED_STATUS BuildSubDocument(
         << ", key: " << SubDocKey::DebugSliceToString(data.subdocument_key);
 
     // Key could be invalidated because we could move iterator, so back it up.
-    KeyBytes key_copy(key);
+    key_copy.Reset(key);
     key = key_copy.AsSlice();
     rocksdb::Slice value = iter->value();
     // Checking that IntentAwareIterator returns an entry with correct time.
@@ -663,26 +768,13 @@ CHECKED_STATUS BuildSubDocument(
               "Expected primitive value type, got $0", value_type);
         }
         DCHECK_GE(iter->read_time().global_limit, write_time.hybrid_time());
-        // TODO: the ttl_seconds in primitive value is currently only in use for CQL. At some
-        // point streamline by refactoring CQL to use the mutable Expiration in GetSubDocumentData.
-        if (data.exp.ttl == Value::kMaxTtl) {
-          doc_value.mutable_primitive_value()->SetTtl(-1);
-        } else {
-          int64_t time_since_write_seconds = (
-              server::HybridClock::GetPhysicalValueMicros(iter->read_time().read) -
-              server::HybridClock::GetPhysicalValueMicros(write_time.hybrid_time())) /
-              MonoTime::kMicrosecondsPerSecond;
-          int64_t ttl_seconds = std::max(static_cast<int64_t>(0),
-              data.exp.ttl.ToMilliseconds() /
-              MonoTime::kMillisecondsPerSecond - time_since_write_seconds);
-          doc_value.mutable_primitive_value()->SetTtl(ttl_seconds);
+        if (doc_value.merge_flags() == Value::kIncrementFlag) {
+          int64_t total = doc_value.primitive_value().GetInt64();
+          RETURN_NOT_OK(iter->FoldIncrements(low_ts, &total));
+          *doc_value.mutable_primitive_value() = PrimitiveValue(total);
         }
-        // Choose the user supplied timestamp if present.
-        const UserTimeMicros user_timestamp = doc_value.user_timestamp();
-        doc_value.mutable_primitive_value()->SetWriteTime(
-            user_timestamp == Value::kInvalidUserTimestamp
-            ? write_time.hybrid_time().GetPhysicalValueMicros()
-            : doc_value.user_timestamp());
+        SetTtlAndWriteTime(data.exp, iter->read_time(), write_time, doc_value.user_timestamp(),
+                           doc_value.mutable_primitive_value());
         if (!data.high_index->CanInclude(current_values_observed)) {
           iter->SeekOutOfSubDoc(&key_copy);
           return Status::OK();
@@ -696,6 +788,16 @@ CHECKED_STATUS BuildSubDocument(
         return Status::OK();
       }
     }
+    // Stop before reading the next child once the limit is reached, instead of building it and
+    // discarding it below. For a large nested child this saves reading its whole subtree.
+    if (data.limit != 0 && IsObjectType(data.result->value_type())) {
+      size_t num_children;
+      RETURN_NOT_OK(data.result->NumChildren(&num_children));
+      if (num_children >= data.limit) {
+        return Status::OK();
+      }
+    }
+
     SubDocument descendant{PrimitiveValue(ValueType::kInvalid)};
     // TODO: what if the key we found is the same as before?
     //       We'll get into an infinite recursion then.
@@ -769,6 +871,63 @@ CHECKED_STATUS BuildSubDocument(
   return Status::OK();
 }
 
+// The packed row of a document read by GetSubDocument with a projection, see PackedRow.
+struct PackedRowState {
+  bool loaded = false;
+  // Write time of the packed row, kMin if there is no packed row written after the latest
+  // overwrite of the whole document.
+  DocHybridTime write_time = DocHybridTime::kMin;
+  // An expired packed row still hides the older values of its columns, like a tombstone.
+  bool expired = false;
+  Expiration exp;
+  PackedRow row;
+};
+
+// Reads the packed row of the document whose encoded DocKey is in key_bytes, key_bytes is
+// restored before returning.
+CHECKED_STATUS LoadPackedRow(
+    IntentAwareIterator* iter, const GetSubDocumentData& data, DocHybridTime max_overwrite_ht,
+    KeyBytes* key_bytes, PackedRowState* packed_row) {
+  packed_row->loaded = true;
+  const size_t doc_key_size = key_bytes->size();
+  PrimitiveValue::SystemColumnId(SystemColumnIds::kPackedRow).AppendToKey(key_bytes);
+  key_bytes->Reserve(key_bytes->size() + kMaxBytesPerEncodedHybridTime + 1);
+  IntentAwareIteratorPrefixScope prefix_scope(*key_bytes, iter);
+  iter->SeekForward(key_bytes);
+  DocHybridTime write_time = max_overwrite_ht;
+  Slice encoded_value;
+  RETURN_NOT_OK(iter->FindLatestRecord(key_bytes->AsSlice(), &write_time, &encoded_value));
+  key_bytes->Truncate(doc_key_size);
+  if (write_time <= max_overwrite_ht) {
+    return Status::OK();
+  }
+
+  Value value;
+  RETURN_NOT_OK(value.Decode(encoded_value));
+  Expiration exp = data.exp;
+  if (write_time.hybrid_time() >= exp.write_ht) {
+    if (value.ttl() != Value::kMaxTtl) {
+      exp.write_ht = write_time.hybrid_time();
+      exp.ttl = value.ttl();
+    } else if (exp.ttl.IsNegative()) {
+      exp.ttl = -exp.ttl;
+    }
+  }
+  if (exp.write_ht == HybridTime::kMin) {
+    exp.write_ht = write_time.hybrid_time();
+  }
+  bool has_expired;
+  RETURN_NOT_OK(HasExpiredTTL(exp.write_ht, exp.ttl, iter->read_time().read, &has_expired));
+
+  packed_row->write_time = write_time;
+  packed_row->exp = exp;
+  packed_row->expired = has_expired || value.value_type() != ValueType::kString;
+  if (value.value_type() == ValueType::kString) {
+    RETURN_NOT_OK(packed_row->row.Decode(value.primitive_value().GetStringAsSlice()));
+  }
+  return Status::OK();
+}
+
 }  // namespace
 
 yb::Status FindLastWriteTime(
@@ -878,7 +1037,7 @@ yb::Status GetSubDocument(
                   db_iter->read_time().ToString());
 
   // The latest time at which any prefix of the given key was overwritten.
-  DocHybridTime max_overwrite_ht(DocHybridTime::kMin);
+  DocHybridTime max_overwrite_ht(data.range_tombstone_ht);
   VLOG(4) << "GetSubDocument(" << data << ")";
 
   SubDocKey found_subdoc_key;
@@ -958,7 +1117,16 @@ yb::Status GetSubDocument(
   *data.result = SubDocument();
   KeyBytes key_bytes(data.subdocument_key);
   const size_t subdocument_key_size = key_bytes.size();
+  // Only whole rows are packed. The packed row subkey sorts after the liveness column and before
+  // regular columns, so it is read before the first of them to keep seeking forward.
+  const PrimitiveValue packed_row_subkey =
+      PrimitiveValue::SystemColumnId(SystemColumnIds::kPackedRow);
+  PackedRowState packed_row;
+  packed_row.loaded = subdocument_key_size != dockey_size;
   for (const PrimitiveValue& subkey : *projection) {
+    if (!packed_row.loaded && !(subkey < packed_row_subkey)) {
+      RETURN_NOT_OK(LoadPackedRow(db_iter, data, max_overwrite_ht, &key_bytes, &packed_row));
+    }
     // Append subkey to subdocument key. Reserve extra kMaxBytesPerEncodedHybridTime + 1 bytes in
     // key_bytes to avoid the internal buffer from getting reallocated and moved by SeekForward()
     // appending the hybrid time, thereby invalidating the buffer pointer saved by prefix_scope.
@@ -968,16 +1136,55 @@ yb::Status GetSubDocument(
     IntentAwareIteratorPrefixScope prefix_scope(key_bytes, db_iter);
     db_iter->SeekForward(&key_bytes);
     SubDocument descendant(ValueType::kInvalid);
-    int64 num_values_observed = 0;
-    RETURN_NOT_OK(BuildSubDocument(
-        db_iter, data.Adjusted(key_bytes, &descendant), max_overwrite_ht,
-        &num_values_observed));
-    *data.doc_found = descendant.value_type() != ValueType::kInvalid;
+    const PrimitiveValue* packed_value =
+        packed_row.write_time != DocHybridTime::kMin && subkey.value_type() == ValueType::kColumnId
+            ? packed_row.row.GetColumn(subkey.GetColumnId()) : nullptr;
+    DocHybridTime low_ts = max_overwrite_ht;
+    bool use_packed_value = false;
+    if (packed_value) {
+      // The packed value is overwritten by any later write to the column, a tombstone included.
+      DocHybridTime latest_ht = packed_row.write_time;
+      RETURN_NOT_OK(db_iter->FindLatestRecord(key_bytes.AsSlice(), &latest_ht));
+      use_packed_value = latest_ht == packed_row.write_time;
+      if (!use_packed_value) {
+        low_ts = packed_row.write_time;
+        db_iter->Seek(key_bytes.AsSlice());
+      }
+    }
+    if (use_packed_value) {
+      if (!packed_row.expired && packed_value->value_type() != ValueType::kTombstone) {
+        descendant = SubDocument(*packed_value);
+        SetTtlAndWriteTime(packed_row.exp, db_iter->read_time(), packed_row.write_time,
+                           Value::kInvalidUserTimestamp, &descendant);
+      }
+    } else {
+      int64 num_values_observed = 0;
+      RETURN_NOT_OK(BuildSubDocument(
+          db_iter, data.Adjusted(key_bytes, &descendant), low_ts, &num_values_observed));
+    }
+    // The document is found if any of the projected subkeys is found.
+    if (descendant.value_type() != ValueType::kInvalid) {
+      *data.doc_found = true;
+    }
     data.result->SetChild(subkey, std::move(descendant));
 
     // Restore subdocument key by truncating the appended subkey.
     key_bytes.Truncate(subdocument_key_size);
   }
+  if (!packed_row.loaded) {
+    RETURN_NOT_OK(LoadPackedRow(db_iter, data, max_overwrite_ht, &key_bytes, &packed_row));
+  }
+  // A packed row marks the row as live at its write time, like the liveness column.
+  if (packed_row.write_time != DocHybridTime::kMin && !packed_row.expired) {
+    *data.doc_found = true;
+    SubDocument* liveness = data.result->GetChild(
+        PrimitiveValue::SystemColumnId(SystemColumnIds::kLivenessColumn));
+    if (liveness != nullptr && liveness->value_type() == ValueType::kInvalid) {
+      *liveness = SubDocument(PrimitiveValue());
+      SetTtlAndWriteTime(packed_row.exp, db_iter->read_time(), packed_row.write_time,
+                         Value::kInvalidUserTimestamp, liveness);
+    }
+  }
   // Make sure the iterator is placed outside the whole document in the end.
   key_bytes.Truncate(dockey_size);
   key_bytes.AppendValueType(ValueType::kMaxByte);
@@ -1246,10 +1453,16 @@ CHECKED_STATUS IntentToWriteRequest(
   return Status::OK();
 }
 
+std::string ApplyTransactionState::ToString() const {
+  return Format("{ key: $0 write_id: $1 }", Slice(key).ToDebugString(), write_id);
+}
+
 Status PrepareApplyIntentsBatch(
     const TransactionId &transaction_id, HybridTime commit_ht,
     rocksdb::WriteBatch *regular_batch,
-    rocksdb::DB *intents_db, rocksdb::WriteBatch *intents_batch) {
+    rocksdb::DB *intents_db, rocksdb::WriteBatch *intents_batch,
+    ApplyTransactionState* apply_state, size_t max_records) {
+  DCHECK(apply_state || max_records == std::numeric_limits<size_t>::max());
   Slice reverse_index_upperbound;
   auto reverse_index_iter = CreateRocksDBIterator(
       intents_db, BloomFilterMode::DONT_USE_BLOOM_FILTER, boost::none, rocksdb::kDefaultQueryId,
@@ -1271,11 +1484,21 @@ Status PrepareApplyIntentsBatch(
   txn_reverse_index_upperbound.AppendValueType(ValueType::kMaxByte);
   reverse_index_upperbound = txn_reverse_index_upperbound.AsSlice();
 
-  reverse_index_iter->Seek(txn_reverse_index_prefix.data());
+  if (apply_state && apply_state->active()) {
+    reverse_index_iter->Seek(apply_state->key);
+  } else {
+    reverse_index_iter->Seek(txn_reverse_index_prefix.data());
+  }
 
   DocHybridTimeBuffer doc_ht_buffer;
 
-  IntraTxnWriteId write_id = 0;
+  // Intent and reverse index keys contain the hybrid time and write id, so each of them is written
+  // only once and a single delete removes it. The transaction metadata record could be written
+  // again, so it is always deleted.
+  const bool single_delete = FLAGS_docdb_single_delete_intents;
+
+  IntraTxnWriteId write_id = apply_state ? apply_state->write_id : 0;
+  size_t num_records = 0;
   while (reverse_index_iter->Valid()) {
     rocksdb::Slice key_slice(reverse_index_iter->key());
 
@@ -1283,6 +1506,13 @@ Status PrepareApplyIntentsBatch(
       break;
     }
 
+    if (num_records >= max_records) {
+      apply_state->key = key_slice.ToBuffer();
+      apply_state->write_id = write_id;
+      return Status::OK();
+    }
+    ++num_records;
+
     VLOG(4) << "Apply reverse index record: "
             << EntryToString(*reverse_index_iter, StorageDbType::kIntents);
 
@@ -1296,14 +1526,25 @@ Status PrepareApplyIntentsBatch(
             regular_batch, &write_id));
       }
 
-      intents_batch->Delete(reverse_index_iter->value());
+      if (intents_batch) {
+        if (single_delete) {
+          intents_batch->SingleDelete(reverse_index_iter->value());
+          intents_batch->SingleDelete(reverse_index_iter->key());
+        } else {
+          intents_batch->Delete(reverse_index_iter->value());
+          intents_batch->Delete(reverse_index_iter->key());
+        }
+      }
+    } else if (intents_batch) {
+      intents_batch->Delete(reverse_index_iter->key());
     }
 
-    intents_batch->Delete(reverse_index_iter->key());
-
     reverse_index_iter->Next();
   }
 
+  if (apply_state) {
+    *apply_state = ApplyTransactionState();
+  }
   return Status::OK();
 }
 
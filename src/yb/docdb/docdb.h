@@ -15,6 +15,7 @@
 #define YB_DOCDB_DOCDB_H_
 
 #include <cstdint>
+#include <limits>
 #include <ostream>
 #include <string>
 #include <vector>
@@ -142,6 +143,11 @@ void PrepareNonTransactionWriteBatch(
     HybridTime hybrid_time,
     rocksdb::WriteBatch* rocksdb_write_batch);
 
+// Returns an upper bound on the size of the RocksDB write batch that PrepareNonTransactionWriteBatch
+// produces for put_batch. It is used to allocate the write batch at once, instead of growing it
+// while the entries are appended.
+size_t NonTransactionWriteBatchSizeUpperBound(const docdb::KeyValueWriteBatchPB& put_batch);
+
 // Enumerates intents corresponding to provided key value pairs.
 // For each key it generates a strong intent and for each parent of each it generates a weak one.
 // functor should accept 3 arguments:
@@ -174,10 +180,31 @@ void PrepareTransactionWriteBatch(
     IsolationLevel isolation_level,
     IntraTxnWriteId* write_id);
 
+// Position to continue applying or removing intents of a transaction from.
+struct ApplyTransactionState {
+  // Reverse index key of the next intent to process, empty when all intents were processed.
+  std::string key;
+
+  // Write id of the next record written to the regular DB.
+  IntraTxnWriteId write_id = 0;
+
+  bool active() const {
+    return !key.empty();
+  }
+
+  std::string ToString() const;
+};
+
+// Adds records of the transaction intents to regular_batch and deletions of them to
+// intents_batch. Either batch could be null, when only removing or only applying intents.
+// When apply_state is specified, processing continues from it, stops after max_records intents,
+// and apply_state is updated to the position to continue from.
 CHECKED_STATUS PrepareApplyIntentsBatch(
     const TransactionId& transaction_id, HybridTime commit_ht,
     rocksdb::WriteBatch* regular_batch,
-    rocksdb::DB* intents_db, rocksdb::WriteBatch* intents_batch);
+    rocksdb::DB* intents_db, rocksdb::WriteBatch* intents_batch,
+    ApplyTransactionState* apply_state = nullptr,
+    size_t max_records = std::numeric_limits<size_t>::max());
 
 // A visitor class that could be overridden to consume results of scanning SubDocuments.
 // See e.g. SubDocumentBuildingVisitor (used in implementing GetSubDocument) as example usage.
@@ -369,6 +396,9 @@ struct GetSubDocumentData {
   bool count_only = false;
   // Stores the count of records found, if count_only option is set.
   mutable size_t record_count = 0;
+  // Latest write time of the range tombstones covering the document, records not later than it
+  // are treated as deleted, see RangeTombstone.
+  DocHybridTime range_tombstone_ht = DocHybridTime::kMin;
 
   GetSubDocumentData Adjusted(
       const Slice& subdoc_key, SubDocument* result_, bool* doc_found_ = nullptr) const {
@@ -18,10 +18,14 @@
 #include <glog/logging.h>
 
 #include "yb/rocksdb/compaction_filter.h"
+#include "yb/rocksdb/db.h"
+#include "yb/rocksdb/util/coding.h"
+#include "yb/util/flag_tags.h"
 #include "yb/util/string_util.h"
 
 #include "yb/docdb/doc_key.h"
 #include "yb/docdb/docdb-internal.h"
+#include "yb/docdb/range_tombstone.h"
 #include "yb/docdb/value.h"
 #include "yb/docdb/consensus_frontier.h"
 #include "yb/rocksutil/yb_rocksdb.h"
@@ -32,16 +36,41 @@ using std::unordered_set;
 using rocksdb::CompactionFilter;
 using rocksdb::VectorToString;
 
+DECLARE_bool(docdb_ttl_file_expiration);
+
+DEFINE_double(docdb_garbage_compaction_ratio_threshold, 0.5,
+              "Regular DB SST files in which at least this ratio of entries would be removed or "
+              "turned into tombstones by a compaction are marked for compaction. Values not in "
+              "(0, 1] disable garbage-triggered compactions.");
+TAG_FLAG(docdb_garbage_compaction_ratio_threshold, advanced);
+TAG_FLAG(docdb_garbage_compaction_ratio_threshold, runtime);
+
+DEFINE_int64(docdb_garbage_compaction_min_entries, 10000,
+             "Minimum number of entries in a regular DB SST file for it to be marked for "
+             "compaction because of its garbage ratio.");
+TAG_FLAG(docdb_garbage_compaction_min_entries, advanced);
+TAG_FLAG(docdb_garbage_compaction_min_entries, runtime);
+
 namespace yb {
 namespace docdb {
 
 // ------------------------------------------------------------------------------------------------
 
+const KeyBounds KeyBounds::kNoBounds;
+
+std::string KeyBounds::ToString() const {
+  return Format("{ lower: $0 upper: $1 }", lower.ToString(), upper.ToString());
+}
+
+// ------------------------------------------------------------------------------------------------
+
 DocDBCompactionFilter::DocDBCompactionFilter(
     HistoryRetentionDirective retention,
-    IsMajorCompaction is_major_compaction)
+    IsMajorCompaction is_major_compaction,
+    const KeyBounds& key_bounds)
     : retention_(std::move(retention)),
-      is_major_compaction_(is_major_compaction) {
+      is_major_compaction_(is_major_compaction),
+      key_bounds_(key_bounds) {
 }
 
 DocDBCompactionFilter::~DocDBCompactionFilter() {
@@ -80,6 +109,12 @@ bool DocDBCompactionFilter::Filter(int level,
     DISCARD_KEY_AND_RETURN();
   }
 
+  // Bounds are at document boundaries, so whole documents are dropped and the history of the
+  // documents that are kept is not affected.
+  if (!key_bounds_.IsWithinBounds(key)) {
+    DISCARD_KEY_AND_RETURN();
+  }
+
   SubDocKey subdoc_key;
 
   // TODO: Find a better way for handling of data corruption encountered during compactions.
@@ -122,8 +157,12 @@ bool DocDBCompactionFilter::Filter(int level,
   // k1 col2 T9   Truncating the stack to [T10], setting prev_overwrite_ht to 10, and therefore
   //              deciding to remove this entry because 9 < 10.
   //
-  const DocHybridTime prev_overwrite_ht =
+  DocHybridTime prev_overwrite_ht =
       overwrite_ht_.empty() ? DocHybridTime::kMin : overwrite_ht_.back();
+  if (overwrite_ht_.empty()) {
+    // A new document, which was fully overwritten by the range tombstones covering it, if any.
+    prev_overwrite_ht = CHECK_RESULT(range_tombstones_.CoveringWriteTime(key));
+  }
   const Expiration prev_exp =
       expiration_.empty() ? Expiration() : expiration_.back();
 
@@ -141,8 +180,13 @@ bool DocDBCompactionFilter::Filter(int level,
   // hybrid_time stack, and we might as well do that while handling the next key/value pair that
   // does not get cleaned up the same way as this one.
   //
-  // TODO: When more merge records are supported, isTtlRow should be redefined appropriately.
-  bool isTtlRow = IsMergeRecord(existing_value);
+  uint64_t merge_flags = 0;
+  if (IsMergeRecord(existing_value)) {
+    CHECK_OK(Value::DecodeMergeFlags(existing_value, &merge_flags));
+  }
+  bool isTtlRow = merge_flags == Value::kTtlFlag;
+  // An increment does not overwrite the older records of its key, they are added to it on read.
+  const bool is_increment = merge_flags == Value::kIncrementFlag;
   if (ht < prev_overwrite_ht && !isTtlRow) {
     DISCARD_KEY_AND_RETURN();
   }
@@ -195,7 +239,13 @@ bool DocDBCompactionFilter::Filter(int level,
       DISCARD_KEY_AND_RETURN();
     }
   }
-  overwrite_ht_.push_back(isTtlRow ? prev_overwrite_ht : max(prev_overwrite_ht, ht));
+  if (IsRangeTombstone(subdoc_key)) {
+    RangeTombstone tombstone;
+    CHECK_OK(tombstone.Decode(subdoc_key.subkeys()[1].GetString()));
+    CHECK_OK(range_tombstones_.Add(key, tombstone, ht));
+  }
+  overwrite_ht_.push_back(
+      isTtlRow || is_increment ? prev_overwrite_ht : max(prev_overwrite_ht, ht));
   ValueType value_type;
   MonoDelta ttl;
   CHECK_OK(Value::DecodePrimitiveValueType(existing_value, &value_type, nullptr, &ttl));
@@ -292,8 +342,8 @@ const char* DocDBCompactionFilter::Name() const {
 // ------------------------------------------------------------------------------------------------
 
 DocDBCompactionFilterFactory::DocDBCompactionFilterFactory(
-    shared_ptr<HistoryRetentionPolicy> retention_policy)
-    : retention_policy_(retention_policy) {
+    shared_ptr<HistoryRetentionPolicy> retention_policy, const KeyBounds& key_bounds)
+    : retention_policy_(retention_policy), key_bounds_(key_bounds) {
 }
 
 DocDBCompactionFilterFactory::~DocDBCompactionFilterFactory() {
@@ -304,13 +354,232 @@ unique_ptr<CompactionFilter> DocDBCompactionFilterFactory::CreateCompactionFilte
   return unique_ptr<DocDBCompactionFilter>(
       new DocDBCompactionFilter(
           retention_policy_->GetRetentionDirective(),
-          IsMajorCompaction(context.is_full_compaction)));
+          IsMajorCompaction(context.is_full_compaction),
+          key_bounds_));
 }
 
 const char* DocDBCompactionFilterFactory::Name() const {
   return "DocDBCompactionFilterFactory";
 }
 
+Slice DocDBCompactionFilterFactory::SubcompactionBoundary(const Slice& user_key) const {
+  auto hashed_part_size = DocKey::EncodedSize(user_key, DocKeyPart::HASHED_PART_ONLY);
+  if (hashed_part_size.ok() && *hashed_part_size != 0) {
+    return Slice(user_key.data(), *hashed_part_size);
+  }
+  auto doc_key_size = DocKey::EncodedSize(user_key, DocKeyPart::WHOLE_DOC_KEY);
+  if (!doc_key_size.ok()) {
+    LOG(WARNING) << "Failed to decode DocKey of subcompaction boundary "
+                << user_key.ToDebugHexString() << ": " << doc_key_size.status();
+    return user_key;
+  }
+  return Slice(user_key.data(), *doc_key_size);
+}
+
+// ------------------------------------------------------------------------------------------------
+
+bool IsFileExpired(const rocksdb::FileMetaData& file, MonoDelta table_ttl, HybridTime cutoff);
+
+namespace {
+
+class DocDBCompactionFileFilter : public rocksdb::CompactionFileFilter {
+ public:
+  DocDBCompactionFileFilter(MonoDelta table_ttl, HybridTime history_cutoff)
+      : table_ttl_(table_ttl), history_cutoff_(history_cutoff) {}
+
+  bool ShouldDrop(const rocksdb::FileMetaData& file) const override {
+    // Reads are never done below the history cutoff, so files expired at it are not visible to
+    // any read.
+    return IsFileExpired(file, table_ttl_, history_cutoff_);
+  }
+
+ private:
+  const MonoDelta table_ttl_;
+  const HybridTime history_cutoff_;
+};
+
+} // namespace
+
+DocDBCompactionFileFilterFactory::DocDBCompactionFileFilterFactory(
+    shared_ptr<HistoryRetentionPolicy> retention_policy)
+    : retention_policy_(std::move(retention_policy)) {
+}
+
+DocDBCompactionFileFilterFactory::~DocDBCompactionFileFilterFactory() {
+}
+
+unique_ptr<rocksdb::CompactionFileFilter>
+DocDBCompactionFileFilterFactory::CreateCompactionFileFilter() {
+  if (!FLAGS_docdb_ttl_file_expiration) {
+    return nullptr;
+  }
+  auto directive = retention_policy_->GetRetentionDirective();
+  if (directive.table_ttl.Equals(Value::kMaxTtl)) {
+    return nullptr;
+  }
+  return std::make_unique<DocDBCompactionFileFilter>(
+      directive.table_ttl, directive.history_cutoff);
+}
+
+const char* DocDBCompactionFileFilterFactory::Name() const {
+  return "DocDBCompactionFileFilterFactory";
+}
+
+// ------------------------------------------------------------------------------------------------
+
+namespace {
+
+const char kTotalEntriesProperty[] = "yb.docdb.total_entries";
+const char kOverwrittenEntriesProperty[] = "yb.docdb.overwritten_entries";
+const char kExpiredEntriesProperty[] = "yb.docdb.expired_entries";
+const char kDeletedEntriesProperty[] = "yb.docdb.deleted_entries";
+
+void AddProperty(const rocksdb::UserCollectedProperties& properties, const char* name,
+                 uint64_t* out) {
+  auto it = properties.find(name);
+  if (it == properties.end()) {
+    return;
+  }
+  Slice encoded(it->second);
+  uint64_t value = 0;
+  if (rocksdb::GetVarint64(&encoded, &value)) {
+    *out += value;
+  }
+}
+
+// Runs a minor compaction filter over the entries of a new SST file to find out which of them
+// compactions could garbage collect.
+class DocDBTablePropertiesCollector : public rocksdb::TablePropertiesCollector {
+ public:
+  explicit DocDBTablePropertiesCollector(HistoryRetentionDirective retention)
+      : history_cutoff_(retention.history_cutoff),
+        filter_(std::move(retention), IsMajorCompaction::kFalse) {
+    filter_.DisableUsageLogging();
+  }
+
+  rocksdb::Status AddUserKey(const Slice& key, const Slice& value, rocksdb::EntryType type,
+                             rocksdb::SequenceNumber seq, uint64_t file_size) override {
+    if (type != rocksdb::kEntryPut) {
+      return rocksdb::Status::OK();
+    }
+    ++estimate_.total_entries;
+    new_value_.clear();
+    bool value_changed = false;
+    if (filter_.Filter(/* level */ 0, key, value, &new_value_, &value_changed)) {
+      ++estimate_.overwritten_entries;
+    } else if (value_changed && new_value_ == Value::EncodedTombstone()) {
+      ++estimate_.expired_entries;
+    } else {
+      ValueType value_type;
+      Slice key_without_ht = key;
+      if (Value::DecodePrimitiveValueType(value, &value_type).ok() &&
+          value_type == ValueType::kTombstone) {
+        auto doc_ht = DocHybridTime::DecodeFromEnd(&key_without_ht);
+        if (doc_ht.ok() && doc_ht->hybrid_time() <= history_cutoff_) {
+          ++estimate_.deleted_entries;
+        }
+      }
+    }
+    return rocksdb::Status::OK();
+  }
+
+  rocksdb::Status Finish(rocksdb::UserCollectedProperties* properties) override {
+    PutVarint64Property(kTotalEntriesProperty, estimate_.total_entries, properties);
+    PutVarint64Property(kOverwrittenEntriesProperty, estimate_.overwritten_entries, properties);
+    PutVarint64Property(kExpiredEntriesProperty, estimate_.expired_entries, properties);
+    PutVarint64Property(kDeletedEntriesProperty, estimate_.deleted_entries, properties);
+    return rocksdb::Status::OK();
+  }
+
+  rocksdb::UserCollectedProperties GetReadableProperties() const override {
+    return {
+      { kTotalEntriesProperty, std::to_string(estimate_.total_entries) },
+      { kOverwrittenEntriesProperty, std::to_string(estimate_.overwritten_entries) },
+      { kExpiredEntriesProperty, std::to_string(estimate_.expired_entries) },
+      { kDeletedEntriesProperty, std::to_string(estimate_.deleted_entries) },
+    };
+  }
+
+  const char* Name() const override {
+    return "DocDBTablePropertiesCollector";
+  }
+
+  // Tombstones are not counted: they are removed only by major compactions, while a compaction of
+  // the marked file alone is a minor one. Its output then has no overwritten or expired entries
+  // left and is not marked again.
+  bool NeedCompact() const override {
+    const double threshold = FLAGS_docdb_garbage_compaction_ratio_threshold;
+    if (threshold <= 0 || threshold > 1 ||
+        estimate_.total_entries == 0 ||
+        estimate_.total_entries < FLAGS_docdb_garbage_compaction_min_entries) {
+      return false;
+    }
+    return estimate_.overwritten_entries + estimate_.expired_entries >=
+           threshold * estimate_.total_entries;
+  }
+
+ private:
+  static void PutVarint64Property(
+      const char* name, uint64_t value, rocksdb::UserCollectedProperties* properties) {
+    std::string encoded;
+    rocksdb::PutVarint64(&encoded, value);
+    properties->emplace(name, std::move(encoded));
+  }
+
+  const HybridTime history_cutoff_;
+  DocDBCompactionFilter filter_;
+  DocDBGarbageEstimate estimate_;
+  std::string new_value_;
+};
+
+} // namespace
+
+double DocDBGarbageEstimate::ReclaimableRatio() const {
+  return total_entries == 0
+      ? 0 : static_cast<double>(reclaimable_entries()) / total_entries;
+}
+
+void DocDBGarbageEstimate::AddProperties(const rocksdb::UserCollectedProperties& properties) {
+  AddProperty(properties, kTotalEntriesProperty, &total_entries);
+  AddProperty(properties, kOverwrittenEntriesProperty, &overwritten_entries);
+  AddProperty(properties, kExpiredEntriesProperty, &expired_entries);
+  AddProperty(properties, kDeletedEntriesProperty, &deleted_entries);
+}
+
+std::string DocDBGarbageEstimate::ToString() const {
+  return Format("{ total_entries: $0 overwritten_entries: $1 expired_entries: $2 "
+                "deleted_entries: $3 }",
+                total_entries, overwritten_entries, expired_entries, deleted_entries);
+}
+
+Result<DocDBGarbageEstimate> GetGarbageEstimate(rocksdb::DB* db) {
+  rocksdb::TablePropertiesCollection collection;
+  RETURN_NOT_OK(db->GetPropertiesOfAllTables(&collection));
+  DocDBGarbageEstimate result;
+  for (const auto& file_and_properties : collection) {
+    result.AddProperties(file_and_properties.second->user_collected_properties);
+  }
+  return result;
+}
+
+DocDBTablePropertiesCollectorFactory::DocDBTablePropertiesCollectorFactory(
+    shared_ptr<HistoryRetentionPolicy> retention_policy)
+    : retention_policy_(std::move(retention_policy)) {
+}
+
+DocDBTablePropertiesCollectorFactory::~DocDBTablePropertiesCollectorFactory() {
+}
+
+rocksdb::TablePropertiesCollector*
+DocDBTablePropertiesCollectorFactory::CreateTablePropertiesCollector(
+    rocksdb::TablePropertiesCollectorFactory::Context context) {
+  return new DocDBTablePropertiesCollector(retention_policy_->GetRetentionDirective());
+}
+
+const char* DocDBTablePropertiesCollectorFactory::Name() const {
+  return "DocDBTablePropertiesCollectorFactory";
+}
+
 // ------------------------------------------------------------------------------------------------
 
 HistoryRetentionDirective ManualHistoryRetentionPolicy::GetRetentionDirective() {
@@ -23,10 +23,17 @@
 
 #include "yb/rocksdb/compaction_filter.h"
 #include "yb/rocksdb/metadata.h"
+#include "yb/rocksdb/table_properties.h"
 
 #include "yb/common/schema.h"
 #include "yb/common/hybrid_time.h"
 #include "yb/docdb/doc_key.h"
+#include "yb/docdb/range_tombstone.h"
+#include "yb/util/result.h"
+
+namespace rocksdb {
+class DB;
+}
 
 namespace yb {
 namespace docdb {
@@ -50,12 +57,30 @@ struct HistoryRetentionDirective {
   MonoDelta table_ttl;
 };
 
+// Range [lower, upper) of encoded DocKeys that belong to a tablet. An empty bound does not
+// restrict keys. A tablet created by splitting another one starts with a copy of the parent's data,
+// and compactions drop the records outside of its bounds.
+struct KeyBounds {
+  KeyBytes lower;
+  KeyBytes upper;
+
+  static const KeyBounds kNoBounds;
+
+  bool IsWithinBounds(const Slice& key) const {
+    return (lower.size() == 0 || key.compare(lower.AsSlice()) >= 0) &&
+           (upper.size() == 0 || key.compare(upper.AsSlice()) < 0);
+  }
+
+  std::string ToString() const;
+};
+
 // DocDB compaction filter. A new instance of this class is created for every compaction.
 class DocDBCompactionFilter : public rocksdb::CompactionFilter {
  public:
   DocDBCompactionFilter(
       HistoryRetentionDirective retention,
-      IsMajorCompaction is_major_compaction);
+      IsMajorCompaction is_major_compaction,
+      const KeyBounds& key_bounds = KeyBounds::kNoBounds);
 
   ~DocDBCompactionFilter() override;
   bool Filter(int level,
@@ -74,9 +99,16 @@ class DocDBCompactionFilter : public rocksdb::CompactionFilter {
   // ConsensusFrontier, so that it can be persisted in RocksDB metadata and recovered on bootstrap.
   rocksdb::UserFrontierPtr GetLargestUserFrontier() const override;
 
+  // Suppresses the log message about the filter being used, for filters that only classify
+  // records outside of compactions.
+  void DisableUsageLogging() {
+    filter_usage_logged_ = true;
+  }
+
  private:
   const HistoryRetentionDirective retention_;
   const IsMajorCompaction is_major_compaction_;
+  const KeyBounds key_bounds_;
 
   mutable bool is_first_key_value_ = true;
   mutable SubDocKey prev_subdoc_key_;
@@ -120,6 +152,11 @@ class DocDBCompactionFilter : public rocksdb::CompactionFilter {
   mutable std::vector<DocHybridTime> overwrite_ht_;
   mutable std::vector<Expiration> expiration_;
 
+  // Range tombstones at or below the history cutoff of the partition of the key that has just
+  // been processed. They are seen before the rows of the partition, and each covered row is
+  // treated as fully overwritten at the time of the latest tombstone covering it.
+  mutable RangeTombstones range_tombstones_;
+
   // We use this to only log a message that the filter is being used once on the first call to
   // the Filter function.
   mutable bool filter_usage_logged_ = false;
@@ -136,12 +173,79 @@ class HistoryRetentionPolicy {
 
 class DocDBCompactionFilterFactory : public rocksdb::CompactionFilterFactory {
  public:
-  explicit DocDBCompactionFilterFactory(std::shared_ptr<HistoryRetentionPolicy> retention_policy);
+  explicit DocDBCompactionFilterFactory(
+      std::shared_ptr<HistoryRetentionPolicy> retention_policy,
+      const KeyBounds& key_bounds = KeyBounds::kNoBounds);
   ~DocDBCompactionFilterFactory() override;
   std::unique_ptr<rocksdb::CompactionFilter> CreateCompactionFilter(
       const rocksdb::CompactionFilter::Context& context) override;
   const char* Name() const override;
 
+  // DocDBCompactionFilter has to see all versions of a document in order, as well as the range
+  // tombstones of a partition before its rows, so subcompactions are only split at partition
+  // boundaries, or DocKey boundaries for keys without hash.
+  Slice SubcompactionBoundary(const Slice& user_key) const override;
+
+ private:
+  std::shared_ptr<HistoryRetentionPolicy> retention_policy_;
+  const KeyBounds key_bounds_;
+};
+
+// Lets compactions delete SST files whose records have all expired according to the table TTL
+// before the history cutoff, without reading them. Enabled by --docdb_ttl_file_expiration.
+class DocDBCompactionFileFilterFactory : public rocksdb::CompactionFileFilterFactory {
+ public:
+  explicit DocDBCompactionFileFilterFactory(
+      std::shared_ptr<HistoryRetentionPolicy> retention_policy);
+  ~DocDBCompactionFileFilterFactory() override;
+  std::unique_ptr<rocksdb::CompactionFileFilter> CreateCompactionFileFilter() override;
+  const char* Name() const override;
+
+ private:
+  std::shared_ptr<HistoryRetentionPolicy> retention_policy_;
+};
+
+// Estimate of regular DB records that compactions could garbage-collect, relative to the history
+// retention policy at the time SST files were written. Only versions within the same file are
+// taken into account, so it is a lower bound.
+struct DocDBGarbageEstimate {
+  uint64_t total_entries = 0;
+  // Entries overwritten or deleted by a newer entry at or below the history cutoff. Removed by any
+  // compaction.
+  uint64_t overwritten_entries = 0;
+  // Entries that expired by the history cutoff. Minor compactions replace them with tombstones.
+  uint64_t expired_entries = 0;
+  // Tombstones at or below the history cutoff. Removed by major compactions.
+  uint64_t deleted_entries = 0;
+
+  uint64_t reclaimable_entries() const {
+    return overwritten_entries + expired_entries + deleted_entries;
+  }
+
+  // Ratio of reclaimable entries to all entries, 0 when there are no entries.
+  double ReclaimableRatio() const;
+
+  // Adds the estimate recorded in SST file properties by DocDBTablePropertiesCollectorFactory.
+  void AddProperties(const rocksdb::UserCollectedProperties& properties);
+
+  std::string ToString() const;
+};
+
+// Sums garbage estimates of all live SST files of db.
+Result<DocDBGarbageEstimate> GetGarbageEstimate(rocksdb::DB* db);
+
+// Records DocDBGarbageEstimate in properties of every regular DB SST file. A file is marked for
+// compaction when the ratio of its entries that a minor compaction would remove or turn into
+// tombstones exceeds --docdb_garbage_compaction_ratio_threshold.
+class DocDBTablePropertiesCollectorFactory : public rocksdb::TablePropertiesCollectorFactory {
+ public:
+  explicit DocDBTablePropertiesCollectorFactory(
+      std::shared_ptr<HistoryRetentionPolicy> retention_policy);
+  ~DocDBTablePropertiesCollectorFactory() override;
+  rocksdb::TablePropertiesCollector* CreateTablePropertiesCollector(
+      rocksdb::TablePropertiesCollectorFactory::Context context) override;
+  const char* Name() const override;
+
  private:
   std::shared_ptr<HistoryRetentionPolicy> retention_policy_;
 };
@@ -18,6 +18,7 @@
 
 #include "yb/common/transaction.h"
 
+#include "yb/rocksdb/memtablerep.h"
 #include "yb/rocksdb/rate_limiter.h"
 #include "yb/rocksdb/table.h"
 
@@ -25,6 +26,8 @@
 #include "yb/rocksutil/yb_rocksdb.h"
 #include "yb/rocksutil/yb_rocksdb_logger.h"
 #include "yb/server/hybrid_clock.h"
+#include "yb/util/flag_tags.h"
+#include "yb/util/memory/memory.h"
 #include "yb/util/size_literals.h"
 #include "yb/util/trace.h"
 #include "yb/gutil/sysinfo.h"
@@ -38,6 +41,9 @@ DEFINE_int32(rocksdb_base_background_compactions, -1,
 DEFINE_int32(rocksdb_max_background_compactions, -1,
              "Increased number of threads to do background compactions (used when compactions need "
              "to catch up.)");
+DEFINE_int32(rocksdb_max_subcompactions, -1,
+             "Maximum number of key range parts run in parallel a single compaction could be split "
+             "into. -1 to use rocksdb_max_background_compactions.");
 DEFINE_int32(rocksdb_level0_file_num_compaction_trigger, 5,
              "Number of files to trigger level-0 compaction. -1 if compaction should not be "
              "triggered by number of files at all.");
@@ -51,7 +57,8 @@ DEFINE_int32(rocksdb_universal_compaction_size_ratio, 20,
 DEFINE_int32(rocksdb_universal_compaction_min_merge_width, 4,
              "The minimum number of files in a single compaction run.");
 DEFINE_int64(rocksdb_compact_flush_rate_limit_bytes_per_sec, 256_MB,
-             "Use to control write rate of flush and compaction.");
+             "Use to control write rate of flush and compaction. The limit is shared by all "
+             "tablets of the server, each of them getting a fair share of it.");
 DEFINE_uint64(rocksdb_compaction_size_threshold_bytes, 2ULL * 1024 * 1024 * 1024,
              "Threshold beyond which compaction is considered large.");
 DEFINE_uint64(rocksdb_max_file_size_for_compaction, 0,
@@ -72,14 +79,61 @@ DEFINE_int64(db_min_keys_per_index_block, 100,
 DEFINE_int64(db_write_buffer_size, -1,
              "Size of RocksDB write buffer (in bytes). -1 to use default.");
 
+DEFINE_string(rocksdb_compression_type, "snappy",
+              "Compression used for RocksDB SST files: none, snappy, zlib, lz4 or zstd.");
+DEFINE_int32(rocksdb_zstd_max_dict_bytes, 16_KB,
+             "Maximum size of the per-file dictionary trained for zstd compression of data "
+             "blocks. 0 disables dictionary compression.");
+
 DEFINE_bool(use_docdb_aware_bloom_filter, true,
             "Whether to use the DocDbAwareFilterPolicy for both bloom storage and seeks.");
+DEFINE_int32(range_key_bloom_filter_components, 1,
+             "Number of leading range key components added to the bloom filter keys of tables "
+             "that have no hash key columns. 0 means that such tables only use the hashed "
+             "components, i.e. their bloom filters do not filter anything.");
 DEFINE_int32(max_nexts_to_avoid_seek, 1,
              "The number of next calls to try before doing resorting to do a rocksdb seek.");
 DEFINE_bool(trace_docdb_calls, false, "Whether we should trace calls into the docdb.");
 DEFINE_bool(use_multi_level_index, true, "Whether to use multi-level data index.");
+DEFINE_bool(use_docdb_aware_data_block_key_encoding, false,
+            "Encode keys in data blocks of new SST files sharing the hybrid time with the previous "
+            "key and delta encoding the internal key suffix. SST files written with this option "
+            "can't be read by versions that don't support it.");
+
+DEFINE_bool(use_docdb_data_block_hash_index, false,
+            "Add a hash index of the keys without hybrid time to data blocks of new SST files, "
+            "so seeks to a key present in a block find its restart interval without a binary "
+            "search. SST files written with this option can't be read by versions that don't "
+            "support it.");
+TAG_FLAG(use_docdb_data_block_hash_index, advanced);
+
+DEFINE_bool(use_docdb_data_block_boundaries, false,
+            "Store the smallest and largest range components and hybrid time of each data block "
+            "in new SST files, and skip data blocks that can't match the range bounds of a scan "
+            "or only contain records written after its read time.");
+TAG_FLAG(use_docdb_data_block_boundaries, advanced);
 
 DEFINE_uint64(initial_seqno, 1ULL << 50, "Initial seqno for new RocksDB instances.");
+DEFINE_bool(rocksdb_allow_concurrent_memtable_write, true,
+            "Let the writers of a RocksDB write group insert into the memtable in parallel.");
+DEFINE_bool(use_docdb_aware_memtable, false,
+            "Use a memtable that hashes keys by the hashed part of their DocKey, so that point "
+            "lookups only search the entries of one document prefix.");
+DEFINE_int32(docdb_memtable_hash_bucket_count, 64 * 1024,
+             "Number of hash buckets in the DocDB aware memtable.");
+DEFINE_bool(rocksdb_enable_write_thread_adaptive_yield, true,
+            "Let RocksDB writers spin briefly while waiting for the write group leader instead of "
+            "blocking on a mutex right away.");
+DEFINE_bool(docdb_ttl_file_expiration, false,
+            "Skip SST files whose records have all expired according to the table TTL on reads, "
+            "and delete such files in compactions without reading them. Only safe for tables "
+            "where rows are not overwritten by values with a shorter TTL than the previous one, "
+            "e.g. append-only time series.");
+TAG_FLAG(docdb_ttl_file_expiration, runtime);
+DEFINE_bool(memstore_arena_use_huge_pages, false,
+            "Back memtable arena blocks with 2MB huge pages, explicitly reserved ones if available "
+            "and transparent ones otherwise, to reduce TLB misses with large memstores. Falls "
+            "back to the heap when huge pages can't be mapped.");
 
 using std::shared_ptr;
 using std::string;
@@ -90,6 +144,8 @@ namespace yb {
 namespace docdb {
 
 std::shared_ptr<rocksdb::BoundaryValuesExtractor> DocBoundaryValuesExtractorInstance();
+bool IsFileExpired(const rocksdb::FdWithBoundaries& file, MonoDelta table_ttl, HybridTime cutoff);
+bool IsBlockWrittenAfter(const rocksdb::DataBlockBoundaries& block, HybridTime limit);
 
 Status SeekToValidKvAtTs(
     rocksdb::Iterator *iter,
@@ -191,7 +247,9 @@ void SeekForward(const KeyBytes& key_bytes, rocksdb::Iterator *iter) {
 }
 
 void SeekPastSubKey(const SubDocKey& sub_doc_key, rocksdb::Iterator* iter) {
-  KeyBytes key_bytes = sub_doc_key.EncodeWithoutHt();
+  KeyBytes key_bytes;
+  key_bytes.Reserve(kMaxBytesPerEncodedHybridTime + 1);
+  sub_doc_key.AppendToWithoutHt(&key_bytes);
   AppendDocHybridTime(DocHybridTime::kMin, &key_bytes);
   SeekForward(key_bytes, iter);
 }
@@ -328,9 +386,14 @@ rocksdb::ReadOptions PrepareReadOptions(
     const boost::optional<const Slice>& user_key_for_filter,
     const rocksdb::QueryId query_id,
     std::shared_ptr<rocksdb::ReadFileFilter> file_filter,
-    const Slice* iterate_upper_bound) {
+    const Slice* iterate_upper_bound,
+    BlockCacheFillMode block_cache_fill_mode,
+    ReadaheadMode readahead_mode,
+    std::shared_ptr<rocksdb::ReadBlockFilter> block_filter = nullptr) {
   rocksdb::ReadOptions read_opts;
   read_opts.query_id = query_id;
+  read_opts.fill_cache = block_cache_fill_mode == BlockCacheFillMode::FILL_CACHE;
+  read_opts.adaptive_readahead = readahead_mode == ReadaheadMode::ADAPTIVE_READAHEAD;
   if (FLAGS_use_docdb_aware_bloom_filter &&
     bloom_filter_mode == BloomFilterMode::USE_BLOOM_FILTER) {
     DCHECK(user_key_for_filter);
@@ -338,6 +401,7 @@ rocksdb::ReadOptions PrepareReadOptions(
         NewTableAwareReadFileFilter(read_opts, user_key_for_filter.get());
   }
   read_opts.file_filter = std::move(file_filter);
+  read_opts.block_filter = std::move(block_filter);
   read_opts.iterate_upper_bound = iterate_upper_bound;
   return read_opts;
 }
@@ -350,9 +414,12 @@ unique_ptr<rocksdb::Iterator> CreateRocksDBIterator(
     const boost::optional<const Slice>& user_key_for_filter,
     const rocksdb::QueryId query_id,
     std::shared_ptr<rocksdb::ReadFileFilter> file_filter,
-    const Slice* iterate_upper_bound) {
+    const Slice* iterate_upper_bound,
+    BlockCacheFillMode block_cache_fill_mode,
+    ReadaheadMode readahead_mode) {
   rocksdb::ReadOptions read_opts = PrepareReadOptions(rocksdb, bloom_filter_mode,
-      user_key_for_filter, query_id, std::move(file_filter), iterate_upper_bound);
+      user_key_for_filter, query_id, std::move(file_filter), iterate_upper_bound,
+      block_cache_fill_mode, readahead_mode);
   return unique_ptr<rocksdb::Iterator>(rocksdb->NewIterator(read_opts));
 }
 
@@ -365,16 +432,98 @@ unique_ptr<IntentAwareIterator> CreateIntentAwareIterator(
     CoarseTimePoint deadline,
     const ReadHybridTime& read_time,
     std::shared_ptr<rocksdb::ReadFileFilter> file_filter,
-    const Slice* iterate_upper_bound) {
+    const Slice* iterate_upper_bound,
+    BlockCacheFillMode block_cache_fill_mode,
+    ReadaheadMode readahead_mode,
+    std::shared_ptr<rocksdb::ReadBlockFilter> block_filter) {
   // TODO(dtxn) do we need separate options for intents db?
   rocksdb::ReadOptions read_opts = PrepareReadOptions(doc_db.regular, bloom_filter_mode,
-      user_key_for_filter, query_id, std::move(file_filter), iterate_upper_bound);
+      user_key_for_filter, query_id, std::move(file_filter), iterate_upper_bound,
+      block_cache_fill_mode, readahead_mode, std::move(block_filter));
   return std::make_unique<IntentAwareIterator>(
       doc_db, read_opts, deadline, read_time, txn_op_context);
 }
 
 namespace {
 
+class ExpirationAwareFileFilter : public rocksdb::ReadFileFilter {
+ public:
+  ExpirationAwareFileFilter(
+      std::shared_ptr<rocksdb::ReadFileFilter> file_filter, MonoDelta table_ttl,
+      HybridTime read_time)
+      : file_filter_(std::move(file_filter)), table_ttl_(table_ttl), read_time_(read_time) {}
+
+  bool Filter(const rocksdb::FdWithBoundaries& file) const override {
+    return !IsFileExpired(file, table_ttl_, read_time_) &&
+           (!file_filter_ || file_filter_->Filter(file));
+  }
+
+ private:
+  const std::shared_ptr<rocksdb::ReadFileFilter> file_filter_;
+  const MonoDelta table_ttl_;
+  const HybridTime read_time_;
+};
+
+} // namespace
+
+std::shared_ptr<rocksdb::ReadFileFilter> CreateExpirationAwareFileFilter(
+    std::shared_ptr<rocksdb::ReadFileFilter> file_filter, MonoDelta table_ttl,
+    HybridTime read_time) {
+  if (!FLAGS_docdb_ttl_file_expiration || table_ttl.Equals(Value::kMaxTtl)) {
+    return file_filter;
+  }
+  return std::make_shared<ExpirationAwareFileFilter>(std::move(file_filter), table_ttl, read_time);
+}
+
+namespace {
+
+class ReadTimeAwareBlockFilter : public rocksdb::ReadBlockFilter {
+ public:
+  ReadTimeAwareBlockFilter(
+      std::shared_ptr<rocksdb::ReadBlockFilter> block_filter, HybridTime read_limit)
+      : block_filter_(std::move(block_filter)), read_limit_(read_limit) {}
+
+  bool Filter(const rocksdb::DataBlockBoundaries& block) const override {
+    return !IsBlockWrittenAfter(block, read_limit_) &&
+           (!block_filter_ || block_filter_->Filter(block));
+  }
+
+ private:
+  const std::shared_ptr<rocksdb::ReadBlockFilter> block_filter_;
+  const HybridTime read_limit_;
+};
+
+} // namespace
+
+std::shared_ptr<rocksdb::ReadBlockFilter> CreateReadTimeAwareBlockFilter(
+    std::shared_ptr<rocksdb::ReadBlockFilter> block_filter, const ReadHybridTime& read_time) {
+  if (!FLAGS_use_docdb_data_block_boundaries) {
+    return nullptr;
+  }
+  // Records after the global limit are not visible to the read and can't cause a read restart.
+  return std::make_shared<ReadTimeAwareBlockFilter>(
+      std::move(block_filter), read_time.global_limit);
+}
+
+void PrefetchDocKeys(
+    rocksdb::DB* rocksdb,
+    const std::vector<KeyBytes>& encoded_doc_keys,
+    const rocksdb::QueryId query_id,
+    std::shared_ptr<rocksdb::ReadFileFilter> file_filter) {
+  rocksdb::ReadOptions read_opts;
+  read_opts.query_id = query_id;
+  read_opts.file_filter = std::move(file_filter);
+  std::vector<Slice> keys;
+  keys.reserve(encoded_doc_keys.size());
+  for (const auto& key : encoded_doc_keys) {
+    keys.push_back(key.AsSlice());
+  }
+  // Prefetching is an optimization, so read errors are reported by the reads themselves.
+  WARN_NOT_OK(rocksdb->PrefetchKeys(read_opts, keys), "Failed to prefetch doc keys");
+}
+
+namespace {
+
 std::mutex rocksdb_flags_mutex;
 
 // Auto initialize some of the RocksDB flags that are defaulted to -1.
@@ -411,6 +560,13 @@ void AutoInitRocksDBFlags(rocksdb::Options* options) {
   }
   options->max_background_compactions = FLAGS_rocksdb_max_background_compactions;
 
+  if (FLAGS_rocksdb_max_subcompactions == -1) {
+    FLAGS_rocksdb_max_subcompactions = FLAGS_rocksdb_max_background_compactions;
+    LOG(INFO) << "Auto setting FLAGS_rocksdb_max_subcompactions to "
+              << FLAGS_rocksdb_max_subcompactions;
+  }
+  options->max_subcompactions = std::max(FLAGS_rocksdb_max_subcompactions, 1);
+
   if (FLAGS_rocksdb_base_background_compactions == -1) {
     FLAGS_rocksdb_base_background_compactions = FLAGS_rocksdb_max_background_compactions;
     LOG(INFO) << "Auto setting FLAGS_rocksdb_base_background_compactions to "
@@ -419,29 +575,44 @@ void AutoInitRocksDBFlags(rocksdb::Options* options) {
   options->base_background_compactions = FLAGS_rocksdb_base_background_compactions;
 }
 
+rocksdb::CompressionType GetConfiguredCompressionType() {
+  static const std::unordered_map<std::string, rocksdb::CompressionType> kCompressionTypes = {
+      {"none", rocksdb::kNoCompression},
+      {"snappy", rocksdb::kSnappyCompression},
+      {"zlib", rocksdb::kZlibCompression},
+      {"lz4", rocksdb::kLZ4Compression},
+      {"zstd", rocksdb::kZSTD},
+  };
+  auto it = kCompressionTypes.find(FLAGS_rocksdb_compression_type);
+  if (it == kCompressionTypes.end()) {
+    LOG(DFATAL) << "Unknown compression type: " << FLAGS_rocksdb_compression_type
+                << ", using snappy";
+    return rocksdb::kSnappyCompression;
+  }
+  return it->second;
+}
+
 } // namespace
 
-void InitRocksDBOptions(
-    rocksdb::Options* options, const string& log_prefix,
-    const shared_ptr<rocksdb::Statistics>& statistics,
-    const tablet::TabletOptions& tablet_options) {
-  AutoInitRocksDBFlags(options);
-  options->create_if_missing = true;
-  options->disableDataSync = true;
-  options->statistics = statistics;
-  options->log_prefix = log_prefix;
-  options->info_log = std::make_shared<YBRocksDBLogger>(options->log_prefix);
-  options->info_log_level = YBRocksDBLogger::ConvertToRocksDBLogLevel(FLAGS_minloglevel);
-  options->initial_seqno = FLAGS_initial_seqno;
-  options->boundary_extractor = DocBoundaryValuesExtractorInstance();
-  options->memory_monitor = tablet_options.memory_monitor;
-  if (FLAGS_db_write_buffer_size != -1) {
-    options->write_buffer_size = FLAGS_db_write_buffer_size;
+rocksdb::RateLimiter* SharedCompactFlushRateLimiter() {
+  // Intentionally leaked, so it outlives the RocksDB instances using it.
+  static rocksdb::RateLimiter* rate_limiter =
+      FLAGS_rocksdb_compact_flush_rate_limit_bytes_per_sec > 0
+          ? rocksdb::NewGenericRateLimiter(FLAGS_rocksdb_compact_flush_rate_limit_bytes_per_sec)
+          : nullptr;
+  return rate_limiter;
+}
+
+size_t BloomFilterRangeComponents(const Schema& schema) {
+  if (schema.num_hash_key_columns() != 0 || FLAGS_range_key_bloom_filter_components <= 0) {
+    return 0;
   }
-  options->listeners.insert(
-      options->listeners.end(), tablet_options.listeners.begin(),
-      tablet_options.listeners.end()); // Append listeners
+  return std::min<size_t>(FLAGS_range_key_bloom_filter_components, schema.num_range_key_columns());
+}
 
+std::shared_ptr<rocksdb::TableFactory> NewDocDBTableFactory(
+    const tablet::TabletOptions& tablet_options, rocksdb::Logger* info_log,
+    size_t bloom_filter_range_components) {
   // Set block cache options.
   rocksdb::BlockBasedTableOptions table_options;
   if (tablet_options.block_cache) {
@@ -460,7 +631,7 @@ void InitRocksDBOptions(
   // Set our custom bloom filter that is docdb aware.
   if (FLAGS_use_docdb_aware_bloom_filter) {
     table_options.filter_policy.reset(new DocDbAwareFilterPolicy(
-        table_options.filter_block_size * 8, options->info_log.get()));
+        table_options.filter_block_size * 8, info_log, bloom_filter_range_components));
   }
 
   if (FLAGS_use_multi_level_index) {
@@ -469,7 +640,62 @@ void InitRocksDBOptions(
     table_options.index_type = rocksdb::IndexType::kBinarySearch;
   }
 
-  options->table_factory.reset(rocksdb::NewBlockBasedTableFactory(table_options));
+  if (FLAGS_use_docdb_aware_data_block_key_encoding) {
+    table_options.data_block_key_value_encoding_format =
+        rocksdb::KeyValueEncodingFormat::kKeyDeltaEncodingThreeSharedParts;
+  }
+
+  if (FLAGS_use_docdb_data_block_hash_index) {
+    table_options.data_block_hash_index_key_extractor =
+        std::make_shared<SubDocKeyWithoutHybridTimeTransform>();
+  }
+
+  table_options.store_data_block_boundaries = FLAGS_use_docdb_data_block_boundaries;
+
+  return std::shared_ptr<rocksdb::TableFactory>(
+      rocksdb::NewBlockBasedTableFactory(table_options));
+}
+
+void InitRocksDBOptions(
+    rocksdb::Options* options, const string& log_prefix,
+    const shared_ptr<rocksdb::Statistics>& statistics,
+    const tablet::TabletOptions& tablet_options) {
+  AutoInitRocksDBFlags(options);
+  options->create_if_missing = true;
+  options->disableDataSync = true;
+  options->statistics = statistics;
+  options->log_prefix = log_prefix;
+  options->info_log = std::make_shared<YBRocksDBLogger>(options->log_prefix);
+  options->info_log_level = YBRocksDBLogger::ConvertToRocksDBLogLevel(FLAGS_minloglevel);
+  options->initial_seqno = FLAGS_initial_seqno;
+  options->boundary_extractor = DocBoundaryValuesExtractorInstance();
+  options->memory_monitor = tablet_options.memory_monitor;
+  if (FLAGS_db_write_buffer_size != -1) {
+    options->write_buffer_size = FLAGS_db_write_buffer_size;
+  }
+  // Batches written to the same tablet by concurrent writers are grouped by the RocksDB write
+  // thread. Each batch in a group still gets its own contiguous range of sequence numbers in
+  // arrival order, and memtable frontiers are merged, so only the memtable inserts run in parallel.
+  if (FLAGS_use_docdb_aware_memtable) {
+    options->memtable_factory.reset(rocksdb::NewHashIndexedSkipListRepFactory(
+        std::make_shared<DocKeyPrefixTransform>(), FLAGS_docdb_memtable_hash_bucket_count));
+  }
+  options->allow_concurrent_memtable_write = FLAGS_rocksdb_allow_concurrent_memtable_write &&
+      options->memtable_factory->IsInsertConcurrentlySupported();
+  options->enable_write_thread_adaptive_yield = FLAGS_rocksdb_enable_write_thread_adaptive_yield;
+  if (FLAGS_memstore_arena_use_huge_pages) {
+    options->memtable_huge_page_size = kHugePageSize;
+  }
+  options->listeners.insert(
+      options->listeners.end(), tablet_options.listeners.begin(),
+      tablet_options.listeners.end()); // Append listeners
+
+  options->table_factory = NewDocDBTableFactory(tablet_options, options->info_log.get());
+
+  options->compression = GetConfiguredCompressionType();
+  if (options->compression == rocksdb::kZSTD) {
+    options->compression_opts.max_dict_bytes = FLAGS_rocksdb_zstd_max_dict_bytes;
+  }
 
   // Compaction related options.
 
@@ -495,9 +721,9 @@ void InitRocksDBOptions(
     options->compaction_options_universal.min_merge_width =
         FLAGS_rocksdb_universal_compaction_min_merge_width;
     options->compaction_size_threshold_bytes = FLAGS_rocksdb_compaction_size_threshold_bytes;
-    if (FLAGS_rocksdb_compact_flush_rate_limit_bytes_per_sec > 0) {
-      options->rate_limiter.reset(
-          rocksdb::NewGenericRateLimiter(FLAGS_rocksdb_compact_flush_rate_limit_bytes_per_sec));
+    auto* rate_limiter = SharedCompactFlushRateLimiter();
+    if (rate_limiter) {
+      options->rate_limiter = rate_limiter->NewTenant(1 /* weight */, statistics);
     }
   }
 
@@ -102,6 +102,20 @@ enum class BloomFilterMode {
   DONT_USE_BLOOM_FILTER,
 };
 
+// Bulk scans read a lot of blocks only once, so they should not add them to the block cache and
+// evict the working set of other reads. Blocks that are already cached are still used.
+enum class BlockCacheFillMode {
+  FILL_CACHE,
+  DONT_FILL_CACHE,
+};
+
+// Unbounded forward scans read data blocks of each SST file sequentially, so they could prefetch
+// upcoming blocks instead of waiting for every block read, see ReadOptions::adaptive_readahead.
+enum class ReadaheadMode {
+  NO_READAHEAD,
+  ADAPTIVE_READAHEAD,
+};
+
 // It is only allowed to use bloom filters on scans within the same hashed components of the key,
 // because BloomFilterAwareIterator relies on it and ignores SST file completely if there are no
 // keys with the same hashed components as key specified for seek operation.
@@ -114,7 +128,9 @@ std::unique_ptr<rocksdb::Iterator> CreateRocksDBIterator(
     const boost::optional<const Slice>& user_key_for_filter,
     const rocksdb::QueryId query_id,
     std::shared_ptr<rocksdb::ReadFileFilter> file_filter = nullptr,
-    const Slice* iterate_upper_bound = nullptr);
+    const Slice* iterate_upper_bound = nullptr,
+    BlockCacheFillMode block_cache_fill_mode = BlockCacheFillMode::FILL_CACHE,
+    ReadaheadMode readahead_mode = ReadaheadMode::NO_READAHEAD);
 
 // Values and transactions committed later than high_ht can be skipped, so we won't spend time
 // for re-requesting pending transaction status if we already know it wasn't committed at high_ht.
@@ -127,7 +143,46 @@ std::unique_ptr<IntentAwareIterator> CreateIntentAwareIterator(
     CoarseTimePoint deadline,
     const ReadHybridTime& read_time,
     std::shared_ptr<rocksdb::ReadFileFilter> file_filter = nullptr,
-    const Slice* iterate_upper_bound = nullptr);
+    const Slice* iterate_upper_bound = nullptr,
+    BlockCacheFillMode block_cache_fill_mode = BlockCacheFillMode::FILL_CACHE,
+    ReadaheadMode readahead_mode = ReadaheadMode::NO_READAHEAD,
+    std::shared_ptr<rocksdb::ReadBlockFilter> block_filter = nullptr);
+
+// Returns a file filter that also skips SST files whose records are all expired at read_time
+// according to table_ttl, when --docdb_ttl_file_expiration is enabled. Otherwise returns
+// file_filter as is.
+std::shared_ptr<rocksdb::ReadFileFilter> CreateExpirationAwareFileFilter(
+    std::shared_ptr<rocksdb::ReadFileFilter> file_filter, MonoDelta table_ttl,
+    HybridTime read_time);
+
+// Returns a data block filter that also skips data blocks whose records were all written after the
+// global limit of read_time, when --use_docdb_data_block_boundaries is enabled. Otherwise returns
+// nullptr, so data blocks are not filtered.
+std::shared_ptr<rocksdb::ReadBlockFilter> CreateReadTimeAwareBlockFilter(
+    std::shared_ptr<rocksdb::ReadBlockFilter> block_filter, const ReadHybridTime& read_time);
+
+// Loads to the block cache SST data blocks that reads of the specified encoded doc keys are going
+// to use, reading blocks of each SST file in one batch. See rocksdb::DB::PrefetchKeys.
+void PrefetchDocKeys(
+    rocksdb::DB* rocksdb,
+    const std::vector<KeyBytes>& encoded_doc_keys,
+    const rocksdb::QueryId query_id,
+    std::shared_ptr<rocksdb::ReadFileFilter> file_filter = nullptr);
+
+// Returns the rate limiter for flushes and compactions shared by all tablets of this process, or
+// nullptr if rate limiting is disabled. Each RocksDB instance uses its own tenant of this rate
+// limiter, so a single busy tablet cannot starve the others.
+rocksdb::RateLimiter* SharedCompactFlushRateLimiter();
+
+// Returns the number of leading range components to add to the bloom filter keys of a table with
+// the given schema, so point reads of tables without hash key columns could use bloom filters.
+size_t BloomFilterRangeComponents(const Schema& schema);
+
+// Returns the table factory for DocDB SST files. Bloom filter keys consist of the hashed components
+// of the DocKey followed by its first 'bloom_filter_range_components' range components.
+std::shared_ptr<rocksdb::TableFactory> NewDocDBTableFactory(
+    const tablet::TabletOptions& tablet_options, rocksdb::Logger* info_log,
+    size_t bloom_filter_range_components = 0);
 
 // Initialize the RocksDB 'options'.
 // The 'statistics' object provided by the caller will be used by RocksDB to maintain the stats for
@@ -255,6 +255,10 @@ Status DocDBRocksDBUtil::InitCommonRocksDBOptions() {
   InitRocksDBWriteOptions(&write_options_);
   rocksdb_options_.compaction_filter_factory =
       std::make_shared<docdb::DocDBCompactionFilterFactory>(retention_policy_);
+  rocksdb_options_.compaction_file_filter_factory =
+      std::make_shared<docdb::DocDBCompactionFileFilterFactory>(retention_policy_);
+  rocksdb_options_.table_properties_collector_factories.push_back(
+      std::make_shared<docdb::DocDBTablePropertiesCollectorFactory>(retention_policy_));
   return Status::OK();
 }
 
@@ -11,22 +11,30 @@
 // under the License.
 //
 
+#include <algorithm>
 #include <memory>
 #include <string>
 
 #include "yb/common/transaction-test-util.h"
 
+#include "yb/docdb/doc_ql_scanspec.h"
 #include "yb/docdb/doc_rowwise_iterator.h"
 #include "yb/docdb/docdb.h"
 #include "yb/docdb/docdb_test_base.h"
 #include "yb/docdb/docdb_test_util.h"
 #include "yb/docdb/intent.h"
+#include "yb/docdb/packed_row.h"
+#include "yb/docdb/range_tombstone.h"
 
 #include "yb/server/hybrid_clock.h"
 
 #include "yb/util/size_literals.h"
+#include "yb/util/stopwatch.h"
 #include "yb/util/test_macros.h"
 #include "yb/util/test_util.h"
+#include "yb/util/tsan_util.h"
+
+DECLARE_int32(reverse_scan_max_prev_steps);
 
 namespace yb {
 namespace docdb {
@@ -337,6 +345,72 @@ SubDocKey(DocKey([], ["row2", 22222]), [ColumnId(40); HT{ physical: 2800 w: 1 }]
   }
 }
 
+TEST_F(DocRowwiseIteratorTest, PackedRow) {
+  auto dwb = MakeDocWriteBatch();
+  const DocPath packed_row_path1(
+      kEncodedDocKey1, PrimitiveValue::SystemColumnId(SystemColumnIds::kPackedRow));
+  const DocPath packed_row_path2(
+      kEncodedDocKey2, PrimitiveValue::SystemColumnId(SystemColumnIds::kPackedRow));
+
+  // Hidden by the packed row, which sets the column to null.
+  ASSERT_OK(dwb.SetPrimitive(DocPath(kEncodedDocKey1, PrimitiveValue(50_ColId)),
+      PrimitiveValue("old_row1_e")));
+  PackedRow packed_row2;
+  packed_row2.AddColumn(30_ColId, PrimitiveValue("row2_c"));
+  ASSERT_OK(dwb.SetPrimitive(packed_row_path2, PrimitiveValue(packed_row2.Encode())));
+  ASSERT_OK(WriteToRocksDBAndClear(&dwb, HybridTime::FromMicros(500)));
+
+  PackedRow packed_row1;
+  packed_row1.AddColumn(40_ColId, PrimitiveValue(10000));
+  packed_row1.AddColumn(30_ColId, PrimitiveValue("row1_c"));
+  packed_row1.AddColumn(50_ColId, PrimitiveValue::kTombstone);
+  ASSERT_OK(dwb.SetPrimitive(packed_row_path1, PrimitiveValue(packed_row1.Encode())));
+  ASSERT_OK(WriteToRocksDBAndClear(&dwb, HybridTime::FromMicros(1000)));
+
+  ASSERT_OK(dwb.DeleteSubDoc(DocPath(kEncodedDocKey2)));
+  ASSERT_OK(WriteToRocksDBAndClear(&dwb, HybridTime::FromMicros(1500)));
+
+  // Partial updates of the packed row.
+  ASSERT_OK(dwb.SetPrimitive(DocPath(kEncodedDocKey1, PrimitiveValue(40_ColId)),
+      PrimitiveValue(20000)));
+  ASSERT_OK(WriteToRocksDBAndClear(&dwb, HybridTime::FromMicros(2000)));
+  ASSERT_OK(dwb.DeleteSubDoc(DocPath(kEncodedDocKey1, PrimitiveValue(30_ColId))));
+  ASSERT_OK(WriteToRocksDBAndClear(&dwb, HybridTime::FromMicros(3000)));
+
+  const Schema &schema = kSchemaForIteratorTests;
+  const Schema &projection = kProjectionForIteratorTests;
+
+  for (auto read_micros : {1600, 2500, 3500}) {
+    SCOPED_TRACE(Format("Read at $0", read_micros));
+    DocRowwiseIterator iter(
+        projection, schema, kNonTransactionalOperationContext, doc_db(),
+        CoarseTimePoint::max() /* deadline */, ReadHybridTime::FromMicros(read_micros));
+    ASSERT_OK(iter.Init());
+
+    QLTableRow row;
+    QLValue value;
+
+    ASSERT_TRUE(iter.HasNext());
+    ASSERT_OK(iter.NextRow(&row));
+
+    ASSERT_OK(row.GetValue(projection.column_id(0), &value));
+    if (read_micros < 3000) {
+      ASSERT_EQ("row1_c", value.string_value());
+    } else {
+      ASSERT_TRUE(value.IsNull());
+    }
+
+    ASSERT_OK(row.GetValue(projection.column_id(1), &value));
+    ASSERT_EQ(read_micros < 2000 ? 10000 : 20000, value.int64_value());
+
+    ASSERT_OK(row.GetValue(projection.column_id(2), &value));
+    ASSERT_TRUE(value.IsNull());
+
+    // The second row is deleted after it was packed.
+    ASSERT_FALSE(iter.HasNext());
+  }
+}
+
 TEST_F(DocRowwiseIteratorTest, DocRowwiseIteratorHasNextIdempotence) {
   ASSERT_OK(SetPrimitive(
       DocPath(kEncodedDocKey1, PrimitiveValue(40_ColId)),
@@ -939,6 +1013,55 @@ TXN REV 30303030-3030-3030-3030-303030303031 HT{ physical: 500 w: 2 } -> \
   ASSERT_EQ(doc_ht.ToString(), "HT{ physical: 1000 }");
 }
 
+TEST_F(DocRowwiseIteratorTest, IntentAwareIteratorWithoutIntents) {
+  SetTransactionIsolationLevel(IsolationLevel::SNAPSHOT_ISOLATION);
+
+  TransactionStatusManagerMock txn_status_manager;
+
+  Result<TransactionId> txn = FullyDecodeTransactionId("0000000000000001");
+  ASSERT_OK(txn);
+
+  ASSERT_OK(SetPrimitive(
+      DocPath(kEncodedDocKey1, PrimitiveValue(30_ColId)),
+      PrimitiveValue("row1_c"), HybridTime::FromMicros(1000)));
+
+  // There are no intents, so the transactional read should not use the intents DB.
+  {
+    IntentAwareIterator iter(
+        doc_db(), rocksdb::ReadOptions(), CoarseTimePoint::max() /* deadline */,
+        ReadHybridTime::FromMicros(2000), TransactionOperationContext(*txn, &txn_status_manager));
+    ASSERT_FALSE(iter.reads_intents());
+    iter.Seek(DocKey());
+    ASSERT_TRUE(iter.valid());
+    Result<Slice> key = iter.FetchKey();
+    ASSERT_OK(key);
+    SubDocKey subdoc_key;
+    ASSERT_OK(subdoc_key.FullyDecodeFrom(*key, HybridTimeRequired::kFalse));
+    ASSERT_EQ(R"#(SubDocKey(DocKey([], ["row1", 11111]), [ColumnId(30)]))#",
+              subdoc_key.ToString());
+  }
+
+  SetCurrentTransactionId(*txn);
+  ASSERT_OK(SetPrimitive(
+      DocPath(kEncodedDocKey2, PrimitiveValue(30_ColId)),
+      PrimitiveValue("row2_c_txn"), HybridTime::FromMicros(1500)));
+  ResetCurrentTransactionId();
+
+  // Once there is an intent, it should be visible to the transaction that wrote it.
+  IntentAwareIterator iter(
+      doc_db(), rocksdb::ReadOptions(), CoarseTimePoint::max() /* deadline */,
+      ReadHybridTime::FromMicros(2000), TransactionOperationContext(*txn, &txn_status_manager));
+  ASSERT_TRUE(iter.reads_intents());
+  iter.Seek(kEncodedDocKey2.AsSlice());
+  ASSERT_TRUE(iter.valid());
+  Result<Slice> key = iter.FetchKey();
+  ASSERT_OK(key);
+  SubDocKey subdoc_key;
+  ASSERT_OK(subdoc_key.FullyDecodeFrom(*key, HybridTimeRequired::kFalse));
+  ASSERT_EQ(R"#(SubDocKey(DocKey([], ["row2", 22222]), [ColumnId(30)]))#",
+            subdoc_key.ToString());
+}
+
 TEST_F(DocRowwiseIteratorTest, SeekTwiceWithinTheSameTxn) {
   SetTransactionIsolationLevel(IsolationLevel::SNAPSHOT_ISOLATION);
 
@@ -1037,5 +1160,269 @@ TEST_F(DocRowwiseIteratorTest, ScanWithinTheSameTxn) {
   ASSERT_FALSE(iter.HasNext());
 }
 
+TEST_F(DocRowwiseIteratorTest, BulkScanDetection) {
+  const Schema &schema = kSchemaForIteratorTests;
+  const Schema &projection = kProjectionForIteratorTests;
+
+  {
+    DocRowwiseIterator iter(
+        projection, schema, kNonTransactionalOperationContext, doc_db(),
+        CoarseTimePoint::max() /* deadline */, ReadHybridTime::FromMicros(2000));
+    ASSERT_OK(iter.Init());
+    ASSERT_FALSE(iter.is_bulk_scan());
+  }
+
+  {
+    DocRowwiseIterator iter(
+        projection, schema, kNonTransactionalOperationContext, doc_db(),
+        CoarseTimePoint::max() /* deadline */, ReadHybridTime::FromMicros(2000));
+    iter.set_row_limit(10);
+    ASSERT_OK(iter.Init());
+    ASSERT_FALSE(iter.is_bulk_scan());
+  }
+
+  {
+    DocRowwiseIterator iter(
+        projection, schema, kNonTransactionalOperationContext, doc_db(),
+        CoarseTimePoint::max() /* deadline */, ReadHybridTime::FromMicros(2000));
+    iter.set_row_limit(DocRowwiseIterator::kNoRowLimit);
+    ASSERT_OK(iter.Init());
+    ASSERT_TRUE(iter.is_bulk_scan());
+  }
+}
+
+TEST_F(DocRowwiseIteratorTest, WideTableNarrowProjection) {
+  constexpr int kNumValueColumns = 40;
+  constexpr int kNumRows = RegularBuildVsSanitizers(2000, 200);
+
+  std::vector<ColumnSchema> columns = {
+      ColumnSchema("k", DataType::INT64, /* is_nullable = */ false) };
+  std::vector<ColumnId> column_ids = { ColumnId(10) };
+  for (int i = 0; i < kNumValueColumns; ++i) {
+    columns.emplace_back(Format("v$0", i), DataType::INT64, /* is_nullable = */ true);
+    column_ids.emplace_back(20 + i);
+  }
+  const Schema schema(columns, column_ids, 1);
+
+  // The last column is only present in even rows, so odd rows are found only by non-projected
+  // columns.
+  auto dwb = MakeDocWriteBatch();
+  for (int row = 0; row < kNumRows; ++row) {
+    const KeyBytes encoded_doc_key(DocKey(PrimitiveValues(static_cast<int64_t>(row))).Encode());
+    for (int i = 0; i < kNumValueColumns; ++i) {
+      if (i == kNumValueColumns - 1 && row % 2 != 0) {
+        continue;
+      }
+      ASSERT_OK(dwb.SetPrimitive(
+          DocPath(encoded_doc_key, PrimitiveValue(ColumnId(20 + i))),
+          PrimitiveValue(static_cast<int64_t>(row * kNumValueColumns + i))));
+    }
+  }
+  ASSERT_OK(WriteToRocksDBAndClear(&dwb, HybridTime::FromMicros(1000)));
+
+  const auto last_column = Format("v$0", kNumValueColumns - 1);
+  std::vector<GStringPiece> all_column_names;
+  for (int i = 0; i < kNumValueColumns; ++i) {
+    all_column_names.emplace_back(schema.column(i + 1).name());
+  }
+
+  for (auto names : { std::vector<GStringPiece>{ last_column }, all_column_names }) {
+    Schema projection;
+    ASSERT_OK(schema.CreateProjectionByNames(names, &projection));
+    const auto& column_id = projection.column_id(projection.num_columns() - 1);
+
+    int num_rows = 0;
+    LOG_TIMING(INFO, Format("scanning $0 rows with $1 of $2 columns projected",
+                            kNumRows, projection.num_columns(), kNumValueColumns)) {
+      DocRowwiseIterator iter(
+          projection, schema, kNonTransactionalOperationContext, doc_db(),
+          CoarseTimePoint::max() /* deadline */, ReadHybridTime::FromMicros(2000));
+      ASSERT_OK(iter.Init());
+      while (iter.HasNext()) {
+        QLTableRow row;
+        QLValue value;
+        ASSERT_OK(iter.NextRow(&row));
+        ASSERT_OK(row.GetValue(column_id, &value));
+        if (num_rows % 2 == 0) {
+          ASSERT_EQ(num_rows * kNumValueColumns + kNumValueColumns - 1, value.int64_value());
+        } else {
+          ASSERT_TRUE(value.IsNull());
+        }
+        ++num_rows;
+      }
+    }
+    ASSERT_EQ(kNumRows, num_rows);
+  }
+}
+
+TEST_F(DocRowwiseIteratorTest, ReverseScan) {
+  constexpr int32_t kHashKey = 1;
+  constexpr int kNumRows = RegularBuildVsSanitizers(5000, 500);
+
+  const Schema schema({
+          ColumnSchema("h", DataType::INT32, /* is_nullable = */ false, /* is_hash_key = */ true),
+          ColumnSchema("r", DataType::INT32, false),
+          ColumnSchema("v", DataType::INT64, true)
+      }, {
+          10_ColId,
+          20_ColId,
+          30_ColId
+      }, 2);
+
+  // Each row has an older version of its value, some rows also have a version newer than the read
+  // time, and every tenth row is deleted, so the scan steps back over records of various kinds.
+  auto write_rows = [&](int micros, int64_t value_shift, bool delete_rows) -> Status {
+    auto dwb = MakeDocWriteBatch();
+    for (int row = 0; row < kNumRows; ++row) {
+      const KeyBytes encoded_doc_key(
+          DocKey(0, {PrimitiveValue::Int32(kHashKey)}, {PrimitiveValue::Int32(row)}).Encode());
+      if (delete_rows && row % 10 == 0) {
+        RETURN_NOT_OK(dwb.DeleteSubDoc(DocPath(encoded_doc_key)));
+      } else if (value_shift != 0 || row % 3 == 0) {
+        RETURN_NOT_OK(dwb.SetPrimitive(
+            DocPath(encoded_doc_key, PrimitiveValue(30_ColId)),
+            PrimitiveValue(static_cast<int64_t>(row + value_shift))));
+      }
+    }
+    return WriteToRocksDBAndClear(&dwb, HybridTime::FromMicros(micros));
+  };
+  ASSERT_OK(write_rows(1000, 1, /* delete_rows = */ false));
+  ASSERT_OK(write_rows(2000, 2, /* delete_rows = */ true));
+  ASSERT_OK(write_rows(4000, 0, /* delete_rows = */ false));
+
+  const std::vector<PrimitiveValue> hashed_components = {PrimitiveValue::Int32(kHashKey)};
+  // With no steps back, the reverse scan seeks to every previous document.
+  for (auto max_prev_steps : {0, 8}) {
+    FLAGS_reverse_scan_max_prev_steps = max_prev_steps;
+    int row = kNumRows;
+    LOG_TIMING(INFO, Format("reverse scan of $0 rows with $1 steps back before seek",
+                            kNumRows, max_prev_steps)) {
+      DocQLScanSpec spec(
+          schema, 0 /* hash_code */, 0 /* max_hash_code */, hashed_components,
+          nullptr /* req */, rocksdb::kDefaultQueryId, false /* is_forward_scan */);
+      DocRowwiseIterator iter(
+          schema, schema, kNonTransactionalOperationContext, doc_db(),
+          CoarseTimePoint::max() /* deadline */, ReadHybridTime::FromMicros(3000));
+      ASSERT_OK(iter.Init(spec));
+      while (iter.HasNext()) {
+        QLTableRow table_row;
+        QLValue value;
+        ASSERT_OK(iter.NextRow(&table_row));
+        --row;
+        if (row % 10 == 0) {
+          --row;
+        }
+        ASSERT_OK(table_row.GetValue(20_ColId, &value));
+        ASSERT_EQ(row, value.int32_value());
+        ASSERT_OK(table_row.GetValue(30_ColId, &value));
+        ASSERT_EQ(row + 2, value.int64_value());
+      }
+    }
+    ASSERT_EQ(1, row);
+  }
+}
+
+TEST_F(DocRowwiseIteratorTest, RangeTombstone) {
+  constexpr int kNumRows = 10;
+
+  const Schema schema({
+          ColumnSchema("h", DataType::INT32, /* is_nullable = */ false, /* is_hash_key = */ true),
+          ColumnSchema("r", DataType::INT32, false),
+          ColumnSchema("v", DataType::INT64, true)
+      }, {
+          10_ColId,
+          20_ColId,
+          30_ColId
+      }, 2);
+
+  auto encoded_doc_key = [](int32_t hash_key, int32_t row) {
+    return DocKey(0, {PrimitiveValue::Int32(hash_key)}, {PrimitiveValue::Int32(row)}).Encode();
+  };
+
+  auto dwb = MakeDocWriteBatch();
+  for (int32_t hash_key : {1, 2}) {
+    for (int32_t row = 0; row < kNumRows; ++row) {
+      ASSERT_OK(dwb.SetPrimitive(
+          DocPath(encoded_doc_key(hash_key, row), PrimitiveValue(30_ColId)),
+          PrimitiveValue(static_cast<int64_t>(row))));
+    }
+  }
+  ASSERT_OK(WriteToRocksDBAndClear(&dwb, HybridTime::FromMicros(1000)));
+
+  // Deletes the rows 3 <= r < 7 of the first partition.
+  RangeTombstone tombstone;
+  KeyBytes bound;
+  PrimitiveValue::Int32(3).AppendToKey(&bound);
+  tombstone.SetLowerBound(bound.data(), true /* inclusive */);
+  bound.Clear();
+  PrimitiveValue::Int32(7).AppendToKey(&bound);
+  tombstone.SetUpperBound(bound.data(), false /* inclusive */);
+  ASSERT_OK(dwb.DeleteSubDoc(DocPath(
+      DocKey(0, {PrimitiveValue::Int32(1)}, {}).Encode(),
+      PrimitiveValue::SystemColumnId(SystemColumnIds::kRangeTombstone),
+      PrimitiveValue(tombstone.Encode()))));
+  ASSERT_OK(WriteToRocksDBAndClear(&dwb, HybridTime::FromMicros(2000)));
+
+  // A row written after the tombstone is not deleted by it.
+  ASSERT_OK(dwb.SetPrimitive(
+      DocPath(encoded_doc_key(1, 5), PrimitiveValue(30_ColId)), PrimitiveValue(int64_t(55))));
+  ASSERT_OK(WriteToRocksDBAndClear(&dwb, HybridTime::FromMicros(3000)));
+
+  auto read_rows = [&](int read_micros, bool is_forward_scan) -> Result<std::vector<int32_t>> {
+    std::vector<int32_t> result;
+    DocRowwiseIterator iter(
+        schema, schema, kNonTransactionalOperationContext, doc_db(),
+        CoarseTimePoint::max() /* deadline */, ReadHybridTime::FromMicros(read_micros));
+    DocQLScanSpec spec(
+        schema, 0 /* hash_code */, 0 /* max_hash_code */, {PrimitiveValue::Int32(1)},
+        nullptr /* req */, rocksdb::kDefaultQueryId, is_forward_scan);
+    RETURN_NOT_OK(iter.Init(spec));
+    while (iter.HasNext()) {
+      QLTableRow table_row;
+      QLValue value;
+      RETURN_NOT_OK(iter.NextRow(&table_row));
+      RETURN_NOT_OK(table_row.GetValue(20_ColId, &value));
+      result.push_back(value.int32_value());
+    }
+    if (!is_forward_scan) {
+      std::reverse(result.begin(), result.end());
+    }
+    return result;
+  };
+
+  using Rows = std::vector<int32_t>;
+  for (bool is_forward_scan : {true, false}) {
+    SCOPED_TRACE(Format("Forward scan: $0", is_forward_scan));
+    ASSERT_EQ((Rows{0, 1, 2, 3, 4, 5, 6, 7, 8, 9}),
+              ASSERT_RESULT(read_rows(1500, is_forward_scan)));
+    ASSERT_EQ((Rows{0, 1, 2, 7, 8, 9}), ASSERT_RESULT(read_rows(2500, is_forward_scan)));
+    ASSERT_EQ((Rows{0, 1, 2, 5, 7, 8, 9}), ASSERT_RESULT(read_rows(3500, is_forward_scan)));
+  }
+
+  // The other partition is not affected.
+  auto count_rows = [&] {
+    DocRowwiseIterator iter(
+        schema, schema, kNonTransactionalOperationContext, doc_db(),
+        CoarseTimePoint::max() /* deadline */, ReadHybridTime::FromMicros(3500));
+    EXPECT_OK(iter.Init());
+    int result = 0;
+    while (iter.HasNext()) {
+      QLTableRow table_row;
+      EXPECT_OK(iter.NextRow(&table_row));
+      ++result;
+    }
+    return result;
+  };
+  ASSERT_EQ(kNumRows + 7, count_rows());
+
+  // The compaction drops the covered records, the older version of the row written after the
+  // tombstone, and the tombstone itself. One record per row is left.
+  FullyCompactHistoryBefore(HybridTime::FromMicros(2500));
+  const auto dump = DocDBDebugDumpToStr();
+  ASSERT_EQ(kNumRows + 7, std::count(dump.begin(), dump.end(), '\n')) << dump;
+  ASSERT_EQ((Rows{0, 1, 2, 5, 7, 8, 9}), ASSERT_RESULT(read_rows(3500, true)));
+  ASSERT_EQ(kNumRows + 7, count_rows());
+}
+
 }  // namespace docdb
 }  // namespace yb
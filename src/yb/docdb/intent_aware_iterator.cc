@@ -29,12 +29,18 @@
 
 #include "yb/server/hybrid_clock.h"
 #include "yb/util/backoff_waiter.h"
+#include "yb/util/flag_tags.h"
 
 using namespace std::literals;
 
 DEFINE_bool(transaction_allow_rerequest_status_in_tests, true,
             "Allow rerequest transaction status when try again is received.");
 
+DEFINE_int32(reverse_scan_max_prev_steps, 8,
+             "Maximum number of records a reverse scan steps back over to get to the previous "
+             "document, before seeking to it instead.");
+TAG_FLAG(reverse_scan_max_prev_steps, advanced);
+
 namespace yb {
 namespace docdb {
 
@@ -58,6 +64,28 @@ void AppendEncodedDocHt(const Slice& encoded_doc_ht, KeyBytes* key_bytes) {
   key_bytes->AppendRawBytes(encoded_doc_ht);
 }
 
+// Positions iter to the last record before key.
+// A reverse scan moves to the previous document right after reading the current one, so iter is
+// usually positioned just past the few records of key. Stepping back over them is cheaper than a
+// seek, that has to reposition the iterators of all memtables and SST files.
+void MoveBeforeKey(const Slice& key, rocksdb::Iterator* iter) {
+  if (iter->Valid() && iter->key().compare(key) >= 0) {
+    for (int i = 0; i < FLAGS_reverse_scan_max_prev_steps; ++i) {
+      iter->Prev();
+      if (!iter->Valid() || iter->key().compare(key) < 0) {
+        return;
+      }
+    }
+  }
+
+  ROCKSDB_SEEK(iter, key);
+  if (iter->Valid()) {
+    iter->Prev();
+  } else {
+    iter->SeekToLast();
+  }
+}
+
 } // namespace
 
 // For locally committed transactions returns commit time if committed at specified time or
@@ -249,12 +277,27 @@ IntentAwareIterator::IntentAwareIterator(
                                                 rocksdb::kDefaultQueryId,
                                                 nullptr /* file_filter */,
                                                 &intent_upperbound_);
+    // Usually there are no in-flight transactions, so check whether the intents DB has any intent
+    // at all. The intent iterator works over a snapshot, so if it is empty now, it will stay empty
+    // during the whole life of this iterator. In that case we drop it and work as a plain
+    // regular DB iterator, avoiding the intent seeks on every regular seek.
+    ResetIntentUpperbound();
+    intent_iter_->SeekToFirst();
+    if (!intent_iter_->Valid()) {
+      status_ = intent_iter_->status();
+      if (status_.ok()) {
+        VLOG(4) << "No intents found, reading regular DB only";
+        intent_iter_.reset();
+      }
+    }
   }
   iter_.reset(doc_db.regular->NewIterator(read_opts));
 }
 
 void IntentAwareIterator::Seek(const DocKey &doc_key) {
-  Seek(doc_key.Encode());
+  key_buffer_.Clear();
+  doc_key.AppendTo(&key_buffer_);
+  Seek(key_buffer_);
 }
 
 void IntentAwareIterator::Seek(const Slice& key) {
@@ -276,12 +319,11 @@ void IntentAwareIterator::Seek(const Slice& key) {
 }
 
 void IntentAwareIterator::SeekForward(const Slice& key) {
-  KeyBytes key_bytes;
   // Reserve space for key plus kMaxBytesPerEncodedHybridTime + 1 bytes for SeekForward() below to
   // avoid extra realloc while appending the read time.
-  key_bytes.Reserve(key.size() + kMaxBytesPerEncodedHybridTime + 1);
-  key_bytes.AppendRawBytes(key);
-  SeekForward(&key_bytes);
+  key_buffer_.Reserve(key.size() + kMaxBytesPerEncodedHybridTime + 1);
+  key_buffer_.Reset(key);
+  SeekForward(&key_buffer_);
 }
 
 void IntentAwareIterator::SeekForward(KeyBytes* key_bytes) {
@@ -339,12 +381,11 @@ void IntentAwareIterator::SeekOutOfSubDoc(KeyBytes* key_bytes) {
 }
 
 void IntentAwareIterator::SeekOutOfSubDoc(const Slice& key) {
-  KeyBytes key_bytes;
   // Reserve space for key + 1 byte for docdb::SeekOutOfSubKey() above to avoid extra realloc while
   // appending kMaxByte.
-  key_bytes.Reserve(key.size() + 1);
-  key_bytes.AppendRawBytes(key);
-  SeekOutOfSubDoc(&key_bytes);
+  key_buffer_.Reserve(key.size() + 1);
+  key_buffer_.Reset(key);
+  SeekOutOfSubDoc(&key_buffer_);
 }
 
 void IntentAwareIterator::SeekToLastDocKey() {
@@ -425,24 +466,46 @@ Status IntentAwareIterator::NextFullValue(
   return status_;
 }
 
-void IntentAwareIterator::PrevSubDocKey(const KeyBytes& key_bytes) {
-  ROCKSDB_SEEK(iter_.get(), key_bytes);
-
-  if (iter_->Valid()) {
-    iter_->Prev();
-  } else {
-    iter_->SeekToLast();
+Status IntentAwareIterator::FoldIncrements(const DocHybridTime& min_ht, int64_t* total) {
+  RETURN_NOT_OK(status_);
+  if (!valid() || !IsEntryRegular()) {
+    return STATUS(IllegalState, "Increments are only folded over regular records");
+  }
+  const KeyBytes key_without_ht(VERIFY_RESULT(FetchKey()));
+  const size_t key_size = key_without_ht.size();
+  for (iter_->Next(); iter_->Valid(); iter_->Next()) {
+    Slice key = iter_->key();
+    if (!key.starts_with(key_without_ht.AsSlice()) || key.size() <= key_size ||
+        key[key_size] != ValueTypeAsChar::kHybridTime) {
+      break;
+    }
+    if (VERIFY_RESULT(DocHybridTime::DecodeFromEnd(&key)) < min_ht) {
+      break;
+    }
+    Value value;
+    RETURN_NOT_OK(value.Decode(iter_->value()));
+    if (value.value_type() == ValueType::kTombstone) {
+      break;
+    }
+    if (value.value_type() != ValueType::kInt64) {
+      return STATUS_FORMAT(Corruption, "Increment of a non integer value: $0", value);
+    }
+    *total += value.primitive_value().GetInt64();
+    if (value.merge_flags() != Value::kIncrementFlag) {
+      break;
+    }
   }
+  return status_;
+}
+
+void IntentAwareIterator::PrevSubDocKey(const KeyBytes& key_bytes) {
+  MoveBeforeKey(key_bytes, iter_.get());
   SkipFutureRecords(Direction::kBackward);
 
   if (intent_iter_) {
     ResetIntentUpperbound();
-    ROCKSDB_SEEK(intent_iter_.get(), GetIntentPrefixForKeyWithoutHt(key_bytes));
-    if (intent_iter_->Valid()) {
-      intent_iter_->Prev();
-    } else {
-      intent_iter_->SeekToLast();
-    }
+    GetIntentPrefixForKeyWithoutHt(key_bytes, &seek_key_buffer_);
+    MoveBeforeKey(seek_key_buffer_, intent_iter_.get());
     SeekToSuitableIntent<Direction::kBackward>();
     seek_intent_iter_needed_ = SeekIntentIterNeeded::kNoNeed;
     skip_future_intents_needed_ = false;
@@ -455,24 +518,16 @@ void IntentAwareIterator::PrevSubDocKey(const KeyBytes& key_bytes) {
 }
 
 void IntentAwareIterator::PrevDocKey(const DocKey& doc_key) {
-  auto key_bytes = doc_key.Encode();
+  key_buffer_.Clear();
+  doc_key.AppendTo(&key_buffer_);
 
-  ROCKSDB_SEEK(iter_.get(), key_bytes);
-  if (iter_->Valid()) {
-    iter_->Prev();
-  } else {
-    iter_->SeekToLast();
-  }
+  MoveBeforeKey(key_buffer_, iter_.get());
   SkipFutureRecords(Direction::kBackward);
 
   if (intent_iter_) {
     ResetIntentUpperbound();
-    ROCKSDB_SEEK(intent_iter_.get(), GetIntentPrefixForKeyWithoutHt(key_bytes));
-    if (intent_iter_->Valid()) {
-      intent_iter_->Prev();
-    } else {
-      intent_iter_->SeekToLast();
-    }
+    GetIntentPrefixForKeyWithoutHt(key_buffer_, &seek_key_buffer_);
+    MoveBeforeKey(seek_key_buffer_, intent_iter_.get());
     SeekToSuitableIntent<Direction::kBackward>();
     seek_intent_iter_needed_ = SeekIntentIterNeeded::kNoNeed;
     skip_future_intents_needed_ = false;
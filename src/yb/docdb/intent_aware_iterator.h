@@ -143,6 +143,10 @@ class IntentAwareIterator {
   ReadHybridTime read_time() { return read_time_; }
   HybridTime max_seen_ht() { return max_seen_ht_; }
 
+  // Returns true if this iterator merges provisional records from the intents DB. It is false
+  // for non-transactional reads and when there were no intents at the time of creation.
+  bool reads_intents() const { return intent_iter_ != nullptr; }
+
   // Iterate through Next() until a row containing a full record (non merge record) is found.
   // The key is not guaranteed to stay the same. The key without hybrid time and value of the
   // merge record go in final_key (optionally), and result_value, while the write time of the
@@ -152,6 +156,13 @@ class IntentAwareIterator {
       Slice* result_value,
       Slice* final_key = nullptr);
 
+  // Adds the values of the records of the current key older than the current one to total, while
+  // they are increments, see Value::kIncrementFlag, including the first full value. Records older
+  // than min_ht are ignored, as well as everything older than a tombstone. The current record
+  // should be regular, increments are only written by non-transactional writes. The iterator is
+  // left inside the current key, the caller should seek out of it.
+  CHECKED_STATUS FoldIncrements(const DocHybridTime& min_ht, int64_t* total);
+
   // Finds the latest record for a particular key, returns the overwrite
   // time, and optionally also the result value. This latest record may not
   // be a full record, but instead a merge record (e.g. a TTL row).
@@ -280,6 +291,10 @@ class IntentAwareIterator {
 
   // Reusable buffer to prepare seek key to avoid reallocating temporary buffers in critical paths.
   KeyBytes seek_key_buffer_;
+
+  // Reusable buffer for the regular key of the methods that take a Slice or a DocKey but need a
+  // KeyBytes to seek, so the per-row seeks of a scan do not allocate.
+  KeyBytes key_buffer_;
 };
 
 // Utility class that controls stack of prefixes in IntentAwareIterator.
@@ -0,0 +1,145 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/docdb/intent_index.h"
+
+#include <gflags/gflags.h>
+
+#include "yb/docdb/doc_key.h"
+#include "yb/docdb/docdb.h"
+#include "yb/docdb/value.h"
+
+#include "yb/util/size_literals.h"
+#include "yb/util/test_macros.h"
+#include "yb/util/test_util.h"
+
+DECLARE_int64(docdb_intent_index_size_bytes);
+
+namespace yb {
+namespace docdb {
+
+namespace {
+
+DocKey MakeDocKey(int key) {
+  return DocKey({PrimitiveValue(key)});
+}
+
+std::string ColumnPath(int key) {
+  return SubDocKey(MakeDocKey(key), PrimitiveValue(ColumnId(1))).EncodeWithoutHt().data();
+}
+
+std::string RowPath(int key) {
+  return MakeDocKey(key).Encode().data();
+}
+
+class IntentIndexTest : public YBTest {
+ protected:
+  void SetUp() override {
+    YBTest::SetUp();
+    FLAGS_docdb_intent_index_size_bytes = 1_MB;
+    mem_tracker_ = MemTracker::CreateTracker("IntentIndexTest");
+    index_ = std::make_unique<IntentIndex>(mem_tracker_);
+  }
+
+  // Indexes the intents of a write of the column of each of the keys by the transaction.
+  void Write(const TransactionId& transaction_id, const std::vector<int>& keys) {
+    KeyValueWriteBatchPB put_batch;
+    for (auto key : keys) {
+      auto* pair = put_batch.add_write_pairs();
+      pair->set_key(ColumnPath(key));
+      pair->set_value(Value(PrimitiveValue("value")).Encode());
+    }
+    rocksdb::WriteBatch write_batch;
+    IntraTxnWriteId write_id = 0;
+    PrepareTransactionWriteBatch(
+        put_batch, HybridTime(1000), &write_batch, transaction_id,
+        IsolationLevel::SNAPSHOT_ISOLATION, &write_id);
+    index_->Add(write_batch);
+  }
+
+  IntentIndex::Intents Find(const std::string& doc_path) {
+    IntentIndex::Intents intents;
+    EXPECT_TRUE(index_->Find(doc_path, &intents));
+    return intents;
+  }
+
+  std::shared_ptr<MemTracker> mem_tracker_;
+  std::unique_ptr<IntentIndex> index_;
+};
+
+} // namespace
+
+TEST_F(IntentIndexTest, AddAndRemove) {
+  const auto txn1 = GenerateTransactionId();
+  const auto txn2 = GenerateTransactionId();
+
+  Write(txn1, {1, 2});
+  Write(txn2, {2});
+  ASSERT_EQ(2, index_->num_transactions());
+
+  auto intents = Find(ColumnPath(1));
+  ASSERT_EQ(1, intents.size());
+  ASSERT_EQ(txn1, intents[0].transaction_id);
+  ASSERT_TRUE(HasStrong(intents[0].types));
+
+  // The row gets weak intents of the column writes.
+  intents = Find(RowPath(2));
+  ASSERT_EQ(2, intents.size());
+  for (const auto& intent : intents) {
+    ASSERT_FALSE(HasStrong(intent.types));
+  }
+  ASSERT_TRUE(Find(ColumnPath(3)).empty());
+  ASSERT_GT(mem_tracker_->consumption(), 0);
+
+  index_->Remove(txn1);
+  ASSERT_TRUE(Find(ColumnPath(1)).empty());
+  ASSERT_TRUE(Find(RowPath(1)).empty());
+  intents = Find(ColumnPath(2));
+  ASSERT_EQ(1, intents.size());
+  ASSERT_EQ(txn2, intents[0].transaction_id);
+
+  index_->Remove(txn2);
+  ASSERT_EQ(0, index_->num_transactions());
+  ASSERT_EQ(0, mem_tracker_->consumption());
+}
+
+TEST_F(IntentIndexTest, Eviction) {
+  FLAGS_docdb_intent_index_size_bytes = 4_KB;
+  index_ = std::make_unique<IntentIndex>(mem_tracker_);
+
+  const auto small = GenerateTransactionId();
+  Write(small, {1});
+  ASSERT_TRUE(index_->complete());
+
+  // Does not fit, so conflict resolution has to read the intents DB until it is removed.
+  const auto big = GenerateTransactionId();
+  std::vector<int> keys;
+  for (int i = 100; i != 200; ++i) {
+    keys.push_back(i);
+  }
+  Write(big, keys);
+  ASSERT_FALSE(index_->complete());
+  IntentIndex::Intents intents;
+  ASSERT_FALSE(index_->Find(ColumnPath(1), &intents));
+
+  // Later writes of the evicted transaction are not indexed either.
+  Write(big, {1});
+  index_->Remove(big);
+  ASSERT_TRUE(index_->complete());
+  intents = Find(ColumnPath(1));
+  ASSERT_EQ(1, intents.size());
+  ASSERT_EQ(small, intents[0].transaction_id);
+}
+
+} // namespace docdb
+} // namespace yb
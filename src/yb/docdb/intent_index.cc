@@ -0,0 +1,217 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/docdb/intent_index.h"
+
+#include <algorithm>
+
+#include <gflags/gflags.h>
+
+#include "yb/docdb/conflict_resolution.h"
+#include "yb/docdb/value_type.h"
+
+#include "yb/util/flag_tags.h"
+
+DEFINE_int64(docdb_intent_index_size_bytes, 0,
+             "Maximum memory used by the in-memory index of the intents of a tablet, which is used "
+             "by conflict resolution instead of reading the intents DB. Transactions that do not "
+             "fit are evicted and conflict resolution reads the intents DB until they finish. "
+             "Read when a tablet is opened, 0 to disable.");
+TAG_FLAG(docdb_intent_index_size_bytes, advanced);
+
+namespace yb {
+namespace docdb {
+
+namespace {
+
+// Approximate per intent overhead of the hash tables, in addition to the DocPath stored in both.
+constexpr size_t kIntentOverhead = 64;
+
+} // namespace
+
+class IntentIndex::IndexingHandler : public rocksdb::WriteBatch::Handler {
+ public:
+  explicit IndexingHandler(IntentIndex* index) : index_(index) {}
+
+  void Put(const Slice& key, const Slice& value) override {
+    auto status = index_->AddRecordUnlocked(key, value);
+    if (!status.ok() && status_.ok()) {
+      status_ = status;
+    }
+  }
+
+  const Status& status() const {
+    return status_;
+  }
+
+ private:
+  IntentIndex* const index_;
+  Status status_;
+};
+
+IntentIndex::IntentIndex(const std::shared_ptr<MemTracker>& parent_mem_tracker)
+    : capacity_(std::max<int64_t>(FLAGS_docdb_intent_index_size_bytes, 0)),
+      mem_tracker_(MemTracker::FindOrCreateTracker("IntentIndex", parent_mem_tracker)) {
+}
+
+IntentIndex::~IntentIndex() {
+  mem_tracker_->Release(consumption_);
+}
+
+bool IntentIndex::Enabled() {
+  return FLAGS_docdb_intent_index_size_bytes > 0;
+}
+
+Status IntentIndex::Load(rocksdb::DB* intents_db) {
+  rocksdb::ReadOptions read_options;
+  read_options.fill_cache = false;
+  std::unique_ptr<rocksdb::Iterator> iter(intents_db->NewIterator(read_options));
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (iter->SeekToFirst(); iter->Valid(); iter->Next()) {
+    RETURN_NOT_OK(AddRecordUnlocked(iter->key(), iter->value()));
+  }
+  return iter->status();
+}
+
+void IntentIndex::Add(const rocksdb::WriteBatch& write_batch) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  IndexingHandler handler(this);
+  auto status = write_batch.Iterate(&handler);
+  if (status.ok()) {
+    status = handler.status();
+  }
+  if (!status.ok()) {
+    // Some intents of the batch could be missing, so the index could not be trusted anymore.
+    LOG(DFATAL) << "Failed to index intents: " << status;
+    ++num_evicted_;
+  }
+}
+
+Status IntentIndex::AddRecordUnlocked(const Slice& key, const Slice& value) {
+  // Transaction metadata and the reverse index are keyed by transaction id.
+  if (key.empty() || key[0] == ValueTypeAsChar::kTransactionId) {
+    return Status::OK();
+  }
+  if (value.empty() || value[0] != ValueTypeAsChar::kTransactionId) {
+    return STATUS_FORMAT(Corruption, "Transaction prefix expected in intent: $0 => $1",
+                         key.ToDebugHexString(), value.ToDebugHexString());
+  }
+  Slice transaction_id_slice(value.data() + 1, value.size() - 1);
+  auto intent = VERIFY_RESULT(ParseIntentKey(key, transaction_id_slice));
+  auto transaction_id = VERIFY_RESULT(FullyDecodeTransactionId(
+      Slice(transaction_id_slice.data(),
+            std::min(transaction_id_slice.size(), TransactionId::static_size()))));
+  AddIntentUnlocked(transaction_id, intent.doc_path, intent.types);
+  return Status::OK();
+}
+
+void IntentIndex::AddIntentUnlocked(
+    const TransactionId& transaction_id, const Slice& doc_path, IntentTypeSet types) {
+  auto transaction_it = transactions_.emplace(transaction_id, TransactionEntry()).first;
+  auto& transaction = transaction_it->second;
+  if (transaction.evicted) {
+    return;
+  }
+  auto& intents = intents_[doc_path.ToBuffer()];
+  for (auto& intent : intents) {
+    if (intent.transaction_id == transaction_id) {
+      intent.types |= types;
+      return;
+    }
+  }
+  const size_t charge = sizeof(Intent) + kIntentOverhead + 2 * doc_path.size();
+  if (consumption_ + charge > capacity_) {
+    if (intents.empty()) {
+      intents_.erase(doc_path.ToBuffer());
+    }
+    EvictUnlocked(transaction_it);
+    return;
+  }
+  intents.push_back(Intent{transaction_id, types});
+  transaction.doc_paths.push_back(doc_path.ToBuffer());
+  transaction.charge += charge;
+  consumption_ += charge;
+  mem_tracker_->Consume(charge);
+}
+
+void IntentIndex::EvictUnlocked(Transactions::iterator it) {
+  VLOG(2) << "Evicting intents of " << it->first << " from intent index";
+  EraseIntentsUnlocked(it->first, &it->second);
+  it->second.evicted = true;
+  ++num_evicted_;
+}
+
+void IntentIndex::EraseIntentsUnlocked(
+    const TransactionId& transaction_id, TransactionEntry* entry) {
+  for (const auto& doc_path : entry->doc_paths) {
+    auto it = intents_.find(doc_path);
+    if (it == intents_.end()) {
+      continue;
+    }
+    auto& intents = it->second;
+    for (auto intent_it = intents.begin(); intent_it != intents.end(); ++intent_it) {
+      if (intent_it->transaction_id == transaction_id) {
+        intents.erase(intent_it);
+        break;
+      }
+    }
+    if (intents.empty()) {
+      intents_.erase(it);
+    }
+  }
+  entry->doc_paths.clear();
+  entry->doc_paths.shrink_to_fit();
+  consumption_ -= entry->charge;
+  mem_tracker_->Release(entry->charge);
+  entry->charge = 0;
+}
+
+void IntentIndex::Remove(const TransactionId& transaction_id) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = transactions_.find(transaction_id);
+  if (it == transactions_.end()) {
+    return;
+  }
+  if (it->second.evicted) {
+    --num_evicted_;
+  } else {
+    EraseIntentsUnlocked(transaction_id, &it->second);
+  }
+  transactions_.erase(it);
+}
+
+bool IntentIndex::Find(const Slice& doc_path, Intents* intents) const {
+  intents->clear();
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (num_evicted_ != 0) {
+    return false;
+  }
+  auto it = intents_.find(doc_path.ToBuffer());
+  if (it != intents_.end()) {
+    *intents = it->second;
+  }
+  return true;
+}
+
+bool IntentIndex::complete() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return num_evicted_ == 0;
+}
+
+size_t IntentIndex::num_transactions() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return transactions_.size();
+}
+
+} // namespace docdb
+} // namespace yb
@@ -0,0 +1,117 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#ifndef YB_DOCDB_INTENT_INDEX_H
+#define YB_DOCDB_INTENT_INDEX_H
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <boost/container/small_vector.hpp>
+
+#include "yb/common/transaction.h"
+
+#include "yb/docdb/intent.h"
+
+#include "yb/rocksdb/db.h"
+#include "yb/rocksdb/write_batch.h"
+
+#include "yb/util/mem_tracker.h"
+#include "yb/util/slice.h"
+
+namespace yb {
+namespace docdb {
+
+// Per-tablet in-memory copy of the intents DB records used by conflict resolution, i.e. which
+// transactions hold which intent types on each DocPath. Conflict resolution looks up the DocPaths
+// of an operation here instead of seeking the intents DB for each of them.
+//
+// Intents are added before they are written to the intents DB and a transaction is dropped only
+// after all its intents are removed from it, so the index never misses an intent, while it could
+// report intents of a transaction that is already committed or aborted, which conflict resolution
+// handles like with intents read from RocksDB.
+//
+// A transaction whose intents do not fit into FLAGS_docdb_intent_index_size_bytes is evicted from
+// the index. While there are evicted transactions the index is incomplete, and conflict resolution
+// reads the intents DB as before. The index is disabled when the flag is 0.
+class IntentIndex {
+ public:
+  struct Intent {
+    TransactionId transaction_id;
+    IntentTypeSet types;
+  };
+
+  typedef boost::container::small_vector<Intent, 4> Intents;
+
+  explicit IntentIndex(const std::shared_ptr<MemTracker>& parent_mem_tracker);
+  ~IntentIndex();
+
+  static bool Enabled();
+
+  // Indexes the intents already present in the intents DB, e.g. of transactions that were pending
+  // when the tablet was restarted. Should be called before any write to the intents DB.
+  CHECKED_STATUS Load(rocksdb::DB* intents_db);
+
+  // Indexes the intents written by a batch of intents DB records. Should be called before the
+  // batch is written. Other records of the batch, including removals of intents, are ignored.
+  void Add(const rocksdb::WriteBatch& write_batch);
+
+  // Drops the intents of the transaction, should be called after all of them are removed from the
+  // intents DB.
+  void Remove(const TransactionId& transaction_id);
+
+  // Fills intents with the intents on doc_path, which is encoded like in intent keys, i.e. without
+  // the intent type and hybrid time. Returns false when the index is incomplete, so the intents DB
+  // should be read instead.
+  bool Find(const Slice& doc_path, Intents* intents) const;
+
+  bool complete() const;
+
+  size_t num_transactions() const;
+
+ private:
+  struct TransactionEntry {
+    std::vector<std::string> doc_paths;
+    size_t charge = 0;
+    bool evicted = false;
+  };
+
+  typedef std::unordered_map<TransactionId, TransactionEntry, TransactionIdHash> Transactions;
+
+  // Adds an intents DB record, ignoring everything but intents.
+  CHECKED_STATUS AddRecordUnlocked(const Slice& key, const Slice& value);
+  void AddIntentUnlocked(const TransactionId& transaction_id, const Slice& doc_path,
+                         IntentTypeSet types);
+  void EvictUnlocked(Transactions::iterator it);
+  void EraseIntentsUnlocked(const TransactionId& transaction_id, TransactionEntry* entry);
+
+  class IndexingHandler;
+
+  const size_t capacity_;
+
+  mutable std::mutex mutex_;
+  std::unordered_map<std::string, Intents> intents_;
+  Transactions transactions_;
+  size_t num_evicted_ = 0;
+  size_t consumption_ = 0;
+
+  std::shared_ptr<MemTracker> mem_tracker_;
+};
+
+} // namespace docdb
+} // namespace yb
+
+#endif // YB_DOCDB_INTENT_INDEX_H
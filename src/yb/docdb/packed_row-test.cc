@@ -0,0 +1,45 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/docdb/packed_row.h"
+
+#include "yb/util/test_macros.h"
+#include "yb/util/test_util.h"
+
+namespace yb {
+namespace docdb {
+
+TEST(PackedRowTest, EncodeDecode) {
+  PackedRow row(7);
+  row.AddColumn(ColumnId(12), PrimitiveValue("value"));
+  row.AddColumn(ColumnId(10), PrimitiveValue(-42));
+  row.AddColumn(ColumnId(300), PrimitiveValue::kTombstone);
+  const auto encoded = row.Encode();
+
+  PackedRow decoded;
+  ASSERT_OK(decoded.Decode(encoded));
+  ASSERT_EQ(7, decoded.schema_version());
+  ASSERT_EQ(3, decoded.num_columns());
+  ASSERT_EQ(PrimitiveValue(-42), *decoded.GetColumn(ColumnId(10)));
+  ASSERT_EQ(PrimitiveValue("value"), *decoded.GetColumn(ColumnId(12)));
+  ASSERT_EQ(ValueType::kTombstone, decoded.GetColumn(ColumnId(300))->value_type());
+  // Columns that the row was not written with, e.g. added later, are missing.
+  ASSERT_EQ(nullptr, decoded.GetColumn(ColumnId(11)));
+  ASSERT_EQ(nullptr, decoded.GetColumn(ColumnId(400)));
+
+  ASSERT_NOK(decoded.Decode(Slice(encoded.data(), encoded.size() - 1)));
+  ASSERT_NOK(decoded.Decode(encoded + "x"));
+}
+
+}  // namespace docdb
+}  // namespace yb
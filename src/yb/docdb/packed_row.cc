@@ -0,0 +1,86 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/docdb/packed_row.h"
+
+#include <algorithm>
+
+#include "yb/util/fast_varint.h"
+
+namespace yb {
+namespace docdb {
+
+namespace {
+
+bool ColumnIdLess(const std::pair<ColumnId, PrimitiveValue>& lhs, ColumnId rhs) {
+  return lhs.first < rhs;
+}
+
+} // namespace
+
+void PackedRow::AddColumn(ColumnId column_id, PrimitiveValue value) {
+  auto it = std::lower_bound(columns_.begin(), columns_.end(), column_id, &ColumnIdLess);
+  DCHECK(it == columns_.end() || it->first != column_id) << "Duplicate column: " << column_id;
+  columns_.emplace(it, column_id, std::move(value));
+}
+
+const PrimitiveValue* PackedRow::GetColumn(ColumnId column_id) const {
+  auto it = std::lower_bound(columns_.begin(), columns_.end(), column_id, &ColumnIdLess);
+  return it != columns_.end() && it->first == column_id ? &it->second : nullptr;
+}
+
+// Encoded as: schema version, number of columns, then for each column its id, the size of its
+// encoded value and the value itself, with all numbers as unsigned varints.
+std::string PackedRow::Encode() const {
+  std::string result;
+  util::FastAppendUnsignedVarIntToStr(schema_version_, &result);
+  util::FastAppendUnsignedVarIntToStr(columns_.size(), &result);
+  for (const auto& column : columns_) {
+    util::FastAppendUnsignedVarIntToStr(column.first.rep(), &result);
+    const auto value = column.second.ToValue();
+    util::FastAppendUnsignedVarIntToStr(value.size(), &result);
+    result.append(value);
+  }
+  return result;
+}
+
+Status PackedRow::Decode(Slice encoded) {
+  schema_version_ = static_cast<uint32_t>(VERIFY_RESULT(util::FastDecodeUnsignedVarInt(&encoded)));
+  const auto num_columns = VERIFY_RESULT(util::FastDecodeUnsignedVarInt(&encoded));
+  columns_.clear();
+  columns_.reserve(num_columns);
+  for (uint64_t i = 0; i != num_columns; ++i) {
+    const ColumnId column_id(
+        static_cast<ColumnIdRep>(VERIFY_RESULT(util::FastDecodeUnsignedVarInt(&encoded))));
+    if (!columns_.empty() && !(columns_.back().first < column_id)) {
+      return STATUS_FORMAT(Corruption, "Packed row columns out of order: $0 after $1",
+                           column_id, columns_.back().first);
+    }
+    const auto value_size = VERIFY_RESULT(util::FastDecodeUnsignedVarInt(&encoded));
+    if (value_size > encoded.size()) {
+      return STATUS_FORMAT(Corruption, "Packed row value of column $0 is truncated: $1 > $2",
+                           column_id, value_size, encoded.size());
+    }
+    PrimitiveValue value;
+    RETURN_NOT_OK(value.DecodeFromValue(Slice(encoded.data(), value_size)));
+    encoded.remove_prefix(value_size);
+    columns_.emplace_back(column_id, std::move(value));
+  }
+  if (!encoded.empty()) {
+    return STATUS_FORMAT(Corruption, "$0 extra bytes after packed row", encoded.size());
+  }
+  return Status::OK();
+}
+
+}  // namespace docdb
+}  // namespace yb
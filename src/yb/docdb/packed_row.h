@@ -0,0 +1,70 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#ifndef YB_DOCDB_PACKED_ROW_H
+#define YB_DOCDB_PACKED_ROW_H
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "yb/common/schema.h"
+
+#include "yb/docdb/primitive_value.h"
+
+#include "yb/util/slice.h"
+#include "yb/util/status.h"
+
+namespace yb {
+namespace docdb {
+
+// Values of the columns written by a single INSERT into a table without collections, stored as one
+// RocksDB entry under the SystemColumnIds::kPackedRow subkey of the row, instead of one entry per
+// column plus the liveness column.
+//
+// The encoding is self-describing: the schema version the row was written with, followed by
+// column id and value pairs. So readers of a later schema version ignore dropped columns and read
+// added ones as missing, without converting the stored rows. A packed row also marks the row as
+// live at its write time, like the liveness column.
+//
+// Later changes to individual columns are written as regular column entries, which override the
+// packed value of a column when their write time is later than the write time of the packed row.
+// A column entry older than the packed row is hidden for all columns the packed row contains.
+class PackedRow {
+ public:
+  PackedRow() = default;
+  explicit PackedRow(uint32_t schema_version) : schema_version_(schema_version) {}
+
+  // Adds the value of a column, a tombstone for a column set to null. Columns are expected to be
+  // added once each.
+  void AddColumn(ColumnId column_id, PrimitiveValue value);
+
+  // Returns the value of the column or nullptr if the row does not contain it.
+  const PrimitiveValue* GetColumn(ColumnId column_id) const;
+
+  std::string Encode() const;
+  CHECKED_STATUS Decode(Slice encoded);
+
+  uint32_t schema_version() const { return schema_version_; }
+  size_t num_columns() const { return columns_.size(); }
+
+ private:
+  uint32_t schema_version_ = 0;
+  // Sorted by column id.
+  std::vector<std::pair<ColumnId, PrimitiveValue>> columns_;
+};
+
+}  // namespace docdb
+}  // namespace yb
+
+#endif  // YB_DOCDB_PACKED_ROW_H
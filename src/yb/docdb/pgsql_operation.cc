@@ -20,6 +20,7 @@
 #include "yb/docdb/doc_pgsql_scanspec.h"
 #include "yb/docdb/doc_rowwise_iterator.h"
 #include "yb/docdb/docdb_util.h"
+#include "yb/docdb/query_mem_tracker.h"
 
 #include "yb/util/trace.h"
 
@@ -46,6 +47,15 @@ CHECKED_STATUS CreateProjection(const Schema& schema,
   return schema.CreateProjectionByIdsIgnoreMissing(column_ids, projection);
 }
 
+// Approximate memory taken by the row, before it is serialized.
+size_t MemoryUsage(const PgsqlRSRow& row) {
+  size_t result = sizeof(row);
+  for (const auto& value : row.rscols()) {
+    result += sizeof(value) + value.value().ByteSize();
+  }
+  return result;
+}
+
 } // namespace
 
 //--------------------------------------------------------------------------------------------------
@@ -218,7 +228,7 @@ Status PgsqlWriteOperation::ApplyUpdate(const DocOperationApplyData& data) {
     if (request_.has_where_expr()) {
       QLValue match;
       RETURN_NOT_OK(EvalExpr(request_.where_expr(), table_row, &match));
-      is_match = match.bool_value();
+      is_match = !match.IsNull() && match.bool_value();
     }
 
     if (is_match) {
@@ -394,7 +404,22 @@ Status PgsqlReadOperation::Execute(const common::YQLStorageIf& ql_storage,
   // Fetching data.
   int match_count = 0;
   QLTableRow::SharedPtr row = std::make_shared<QLTableRow>();
+  // Estimated memory taken by the rows of the result set.
+  size_t result_size = 0;
+  // Whether the read stopped before the row count limit because its rows take too much memory.
+  bool memory_limited = false;
+  const bool may_page_early = mem_tracker_ != nullptr && request_.return_paging_state() &&
+                              !request_.is_aggregate();
   while (resultset->rsrow_count() < row_count_limit && iter->HasNext()) {
+    if (mem_tracker_ != nullptr) {
+      mem_tracker_->SetCurrentResultSize(result_size);
+      RETURN_NOT_OK(mem_tracker_->CheckHardLimit());
+      // At least one row is returned, so the scan makes progress.
+      if (may_page_early && resultset->rsrow_count() > 0 && mem_tracker_->SoftLimitExceeded()) {
+        memory_limited = true;
+        break;
+      }
+    }
     // The filtering process runs in the following order.
     // <hash_code><hash_components><range_components><regular_column_id> -> value;
     row->Clear();
@@ -422,7 +447,7 @@ Status PgsqlReadOperation::Execute(const common::YQLStorageIf& ql_storage,
     if (request_.has_where_expr()) {
       QLValue match;
       RETURN_NOT_OK(EvalExpr(request_.where_expr(), row, &match));
-      is_match = match.bool_value();
+      is_match = !match.IsNull() && match.bool_value();
     }
     if (is_match) {
       match_count++;
@@ -430,6 +455,9 @@ Status PgsqlReadOperation::Execute(const common::YQLStorageIf& ql_storage,
         RETURN_NOT_OK(EvalAggregate(row));
       } else {
         RETURN_NOT_OK(PopulateResultSet(row, resultset));
+        if (mem_tracker_ != nullptr) {
+          result_size += MemoryUsage(resultset->rsrows().back());
+        }
       }
     }
   }
@@ -441,9 +469,13 @@ Status PgsqlReadOperation::Execute(const common::YQLStorageIf& ql_storage,
   if (FLAGS_trace_docdb_calls) {
     TRACE("Fetched $0 rows.", resultset->rsrow_count());
   }
+  if (memory_limited) {
+    TRACE("Paging early at $0 bytes of rows", result_size);
+  }
   *restart_read_ht = iter->RestartReadHt();
 
-  if (resultset->rsrow_count() >= row_count_limit && !request_.is_aggregate()) {
+  if ((resultset->rsrow_count() >= row_count_limit || memory_limited) &&
+      !request_.is_aggregate()) {
     RETURN_NOT_OK(iter->SetPagingStateIfNecessary(request_, &response_));
   }
 
@@ -31,6 +31,8 @@ class YQLStorageIf;
 
 namespace docdb {
 
+class QueryMemTracker;
+
 class PgsqlWriteOperation :
     public DocOperationBase<DocOperationType::PGSQL_WRITE_OPERATION, PgsqlWriteRequestPB>,
     public DocExprExecutor {
@@ -115,6 +117,9 @@ class PgsqlReadOperation : public DocExprExecutor {
   const PgsqlReadRequestPB& request() const { return request_; }
   PgsqlResponsePB& response() { return response_; }
 
+  // Tracker of the read request the result rows are charged to, if any.
+  void set_mem_tracker(QueryMemTracker* mem_tracker) { mem_tracker_ = mem_tracker; }
+
   CHECKED_STATUS Execute(const common::YQLStorageIf& ql_storage,
                          CoarseTimePoint deadline,
                          const ReadHybridTime& read_time,
@@ -139,6 +144,7 @@ class PgsqlReadOperation : public DocExprExecutor {
   //------------------------------------------------------------------------------------------------
   const PgsqlReadRequestPB& request_;
   const TransactionOperationContextOpt txn_op_context_;
+  QueryMemTracker* mem_tracker_ = nullptr;
   PgsqlResponsePB response_;
   common::YQLRowwiseIteratorIf::UniPtr table_iter_;
   common::YQLRowwiseIteratorIf::UniPtr index_iter_;
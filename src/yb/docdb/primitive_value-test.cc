@@ -377,6 +377,18 @@ TEST(PrimitiveValueTest, TestMove) {
   TestMove(PrimitiveValue(HybridTime(1000)), 1000, 1000);
 }
 
+TEST(PrimitiveValueTest, TestTtlSaturation) {
+  PrimitiveValue value(1000);
+  value.SetTtl(-1);
+  ASSERT_EQ(-1, value.GetTtl());
+  value.SetTtl(std::numeric_limits<int32_t>::max());
+  ASSERT_EQ(std::numeric_limits<int32_t>::max(), value.GetTtl());
+  value.SetTtl(std::numeric_limits<int64_t>::max());
+  ASSERT_EQ(std::numeric_limits<int32_t>::max(), value.GetTtl());
+  value.SetWriteTime(std::numeric_limits<int64_t>::max());
+  ASSERT_EQ(std::numeric_limits<int64_t>::max(), value.GetWriteTime());
+}
+
 // Ensures that the serialized version of a primitive value compares the same way as the primitive
 // value.
 void ComparePrimitiveValues(const PrimitiveValue& v1, const PrimitiveValue& v2) {
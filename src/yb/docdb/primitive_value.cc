@@ -557,15 +557,33 @@ Status PrimitiveValue::DecodeKey(rocksdb::Slice* slice, PrimitiveValue* out) {
         ToShortDebugStr(input_slice));
   }
   ValueType value_type = ConsumeValueType(slice);
-  ValueType dummy_type;
-  ValueType& type_ref = out ? out->type_ : dummy_type;
+
+  // Decoding a string into a value that already holds a string is the common case when the same
+  // DocKey is reused for every row of a scan. Decode into the existing buffer in that case, so we
+  // don't allocate for every string key component.
+  if (out && (value_type == ValueType::kString || value_type == ValueType::kStringDescending) &&
+      (out->type_ == ValueType::kString || out->type_ == ValueType::kStringDescending)) {
+    // str_val_ stays a valid string even if decoding fails, so the type can be set upfront.
+    out->type_ = value_type;
+    if (value_type == ValueType::kString) {
+      return DecodeZeroEncodedStr(slice, &out->str_val_);
+    }
+    return DecodeComplementZeroEncodedStr(slice, &out->str_val_);
+  }
+
+  // type_ is a bit field, so it is updated through this helper instead of a reference.
+  auto set_type = [out](ValueType type) {
+    if (out) {
+      out->type_ = type;
+    }
+  };
 
   if (out) {
     out->~PrimitiveValue();
     // Ensure we are not leaving the object in an invalid state in case e.g. an exception is thrown
     // due to inability to allocate memory.
   }
-  type_ref = ValueType::kNull;
+  set_type(ValueType::kNull);
 
   switch (value_type) {
     case ValueType::kNullDescending: FALLTHROUGH_INTENDED;
@@ -579,7 +597,7 @@ Status PrimitiveValue::DecodeKey(rocksdb::Slice* slice, PrimitiveValue* out) {
     case ValueType::kTrueDescending: FALLTHROUGH_INTENDED;
     case ValueType::kHighest: FALLTHROUGH_INTENDED;
     case ValueType::kLowest:
-      type_ref = value_type;
+      set_type(value_type);
       return Status::OK();
 
     case ValueType::kStringDescending: {
@@ -591,7 +609,7 @@ Status PrimitiveValue::DecodeKey(rocksdb::Slice* slice, PrimitiveValue* out) {
         RETURN_NOT_OK(DecodeComplementZeroEncodedStr(slice, nullptr));
       }
       // Only set type to string after string field initialization succeeds.
-      type_ref = value_type;
+      set_type(value_type);
       return Status::OK();
     }
 
@@ -604,7 +622,7 @@ Status PrimitiveValue::DecodeKey(rocksdb::Slice* slice, PrimitiveValue* out) {
         RETURN_NOT_OK(DecodeZeroEncodedStr(slice, nullptr));
       }
       // Only set type to string after string field initialization succeeds.
-      type_ref = value_type;
+      set_type(value_type);
       return Status::OK();
     }
 
@@ -621,7 +639,7 @@ Status PrimitiveValue::DecodeKey(rocksdb::Slice* slice, PrimitiveValue* out) {
           ValueType current_value_type = static_cast<ValueType>(*slice->data());
           if (current_value_type == end_marker_value_type) {
             slice->consume_byte();
-            type_ref = value_type;
+            set_type(value_type);
             return Status::OK();
           } else {
             PrimitiveValue pv;
@@ -660,7 +678,7 @@ Status PrimitiveValue::DecodeKey(rocksdb::Slice* slice, PrimitiveValue* out) {
         new(&out->decimal_val_) string(decimal.EncodeToComparable());
       }
       slice->remove_prefix(num_decoded_bytes);
-      type_ref = value_type;
+      set_type(value_type);
       return Status::OK();
     }
 
@@ -677,7 +695,7 @@ Status PrimitiveValue::DecodeKey(rocksdb::Slice* slice, PrimitiveValue* out) {
         new(&out->varint_val_) string(varint.EncodeToComparable());
       }
       slice->remove_prefix(num_decoded_bytes);
-      type_ref = value_type;
+      set_type(value_type);
       return Status::OK();
     }
 
@@ -696,7 +714,7 @@ Status PrimitiveValue::DecodeKey(rocksdb::Slice* slice, PrimitiveValue* out) {
         }
       }
       slice->remove_prefix(sizeof(int32_t));
-      type_ref = value_type;
+      set_type(value_type);
       return Status::OK();
 
     case ValueType::kUInt32Descending: FALLTHROUGH_INTENDED;
@@ -713,7 +731,7 @@ Status PrimitiveValue::DecodeKey(rocksdb::Slice* slice, PrimitiveValue* out) {
         }
       }
       slice->remove_prefix(sizeof(uint32_t));
-      type_ref = value_type;
+      set_type(value_type);
       return Status::OK();
 
     case ValueType::kInt64Descending: FALLTHROUGH_INTENDED;
@@ -731,7 +749,7 @@ Status PrimitiveValue::DecodeKey(rocksdb::Slice* slice, PrimitiveValue* out) {
         }
       }
       slice->remove_prefix(sizeof(int64_t));
-      type_ref = value_type;
+      set_type(value_type);
       return Status::OK();
 
     case ValueType::kUInt16Hash:
@@ -743,7 +761,7 @@ Status PrimitiveValue::DecodeKey(rocksdb::Slice* slice, PrimitiveValue* out) {
         out->uint16_val_ = BigEndian::Load16(slice->data());
       }
       slice->remove_prefix(sizeof(uint16_t));
-      type_ref = value_type;
+      set_type(value_type);
       return Status::OK();
 
     case ValueType::kTimestampDescending: FALLTHROUGH_INTENDED;
@@ -763,7 +781,7 @@ Status PrimitiveValue::DecodeKey(rocksdb::Slice* slice, PrimitiveValue* out) {
         }
       }
       slice->remove_prefix(sizeof(Timestamp));
-      type_ref = value_type;
+      set_type(value_type);
       return Status::OK();
     }
 
@@ -776,7 +794,7 @@ Status PrimitiveValue::DecodeKey(rocksdb::Slice* slice, PrimitiveValue* out) {
       } else {
         RETURN_NOT_OK(DecodeZeroEncodedStr(slice, nullptr));
       }
-      type_ref = value_type;
+      set_type(value_type);
       return Status::OK();
     }
 
@@ -789,7 +807,7 @@ Status PrimitiveValue::DecodeKey(rocksdb::Slice* slice, PrimitiveValue* out) {
       } else {
         RETURN_NOT_OK(DecodeComplementZeroEncodedStr(slice, nullptr));
       }
-      type_ref = value_type;
+      set_type(value_type);
       return Status::OK();
     }
 
@@ -804,7 +822,7 @@ Status PrimitiveValue::DecodeKey(rocksdb::Slice* slice, PrimitiveValue* out) {
       } else {
         RETURN_NOT_OK(DecodeZeroEncodedStr(slice, nullptr));
       }
-      type_ref = value_type;
+      set_type(value_type);
       return Status::OK();
     }
 
@@ -817,7 +835,7 @@ Status PrimitiveValue::DecodeKey(rocksdb::Slice* slice, PrimitiveValue* out) {
       } else {
         RETURN_NOT_OK(DecodeComplementZeroEncodedStr(slice, nullptr));
       }
-      type_ref = value_type;
+      set_type(value_type);
       return Status::OK();
     }
 
@@ -831,7 +849,7 @@ Status PrimitiveValue::DecodeKey(rocksdb::Slice* slice, PrimitiveValue* out) {
         RETURN_NOT_OK(ColumnId::FromInt64(column_id_as_int64, &column_id_ref));
       }
 
-      type_ref = value_type;
+      set_type(value_type);
       return Status::OK();
     }
 
@@ -844,7 +862,7 @@ Status PrimitiveValue::DecodeKey(rocksdb::Slice* slice, PrimitiveValue* out) {
         RETURN_NOT_OK(dummy_hybrid_time.DecodeFrom(slice));
       }
 
-      type_ref = ValueType::kHybridTime;
+      set_type(ValueType::kHybridTime);
       return Status::OK();
     }
 
@@ -854,7 +872,7 @@ Status PrimitiveValue::DecodeKey(rocksdb::Slice* slice, PrimitiveValue* out) {
       if (out) {
         out->uint16_val_ = static_cast<uint16_t>(*slice->data());
       }
-      type_ref = value_type;
+      set_type(value_type);
       slice->consume_byte();
       return Status::OK();
     }
@@ -872,7 +890,7 @@ Status PrimitiveValue::DecodeKey(rocksdb::Slice* slice, PrimitiveValue* out) {
         }
       }
       slice->remove_prefix(sizeof(float_t));
-      type_ref = value_type;
+      set_type(value_type);
       return Status::OK();
     }
     case ValueType::kDoubleDescending: FALLTHROUGH_INTENDED;
@@ -888,7 +906,7 @@ Status PrimitiveValue::DecodeKey(rocksdb::Slice* slice, PrimitiveValue* out) {
         }
       }
       slice->remove_prefix(sizeof(double_t));
-      type_ref = value_type;
+      set_type(value_type);
       return Status::OK();
     }
     case ValueType::kMaxByte:
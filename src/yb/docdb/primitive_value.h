@@ -16,6 +16,8 @@
 
 #include <memory.h>
 
+#include <algorithm>
+#include <limits>
 #include <string>
 #include <vector>
 #include <ostream>
@@ -46,7 +48,9 @@ namespace docdb {
 class SubDocument;
 
 enum class SystemColumnIds : ColumnIdRep {
-  kLivenessColumn = 0  // Stores the TTL for QL rows inserted using an INSERT statement.
+  kLivenessColumn = 0,  // Stores the TTL for QL rows inserted using an INSERT statement.
+  kPackedRow = 1,  // Stores the columns of a QL row inserted as a whole, see PackedRow.
+  kRangeTombstone = 2  // Deletes a range of rows of a partition, see RangeTombstone.
 };
 
 class PrimitiveValue {
@@ -386,7 +390,7 @@ class PrimitiveValue {
   bool operator!=(const PrimitiveValue& other) const { return !(*this == other); }
 
   ListExtendOrder GetExtendOrder() const {
-    return extend_order_;
+    return static_cast<ListExtendOrder>(extend_order_);
   }
 
   int64_t GetTtl() const {
@@ -402,12 +406,16 @@ class PrimitiveValue {
     return write_time_;
   }
 
+  // The TTL is kept in 32 bits to save space, values outside of that range are saturated. That is
+  // still about 68 years, much more than the maximum TTL allowed by CQL.
   void SetTtl(const int64_t ttl_seconds) {
-    ttl_seconds_ = ttl_seconds;
+    ttl_seconds_ = static_cast<int32_t>(std::max<int64_t>(
+        std::numeric_limits<int32_t>::min(),
+        std::min<int64_t>(std::numeric_limits<int32_t>::max(), ttl_seconds)));
   }
 
   void SetExtendOrder(const ListExtendOrder extend_order) const {
-    extend_order_ = extend_order;
+    extend_order_ = static_cast<uint8_t>(extend_order);
   }
 
   void SetWriteTime(const int64_t write_time) {
@@ -419,17 +427,22 @@ class PrimitiveValue {
 
   static constexpr int64_t kUninitializedWriteTime = std::numeric_limits<int64_t>::min();
 
+  // The fields below are ordered so that the TTL, the type and the extension order share a single
+  // 8-byte word. This keeps PrimitiveValue, and therefore every SubDocument node, at 48 bytes
+  // instead of 56 with a 32-byte std::string in the union.
+
   // Column attributes.
-  int64_t ttl_seconds_ = -1;
   int64_t write_time_ = kUninitializedWriteTime;
+  int32_t ttl_seconds_ = -1;
+
+  // All value types are single characters, so 16 bits are enough to hold any of them.
+  ValueType type_ : 16;
 
   // TODO: make PrimitiveValue extend SubDocument and put this field
   // in SubDocument.
   // This field gives the extension order of elements of a list and
-  // is applicable only to SubDocuments of type kArray.
-  mutable ListExtendOrder extend_order_ = ListExtendOrder::APPEND;
-
-  ValueType type_;
+  // is applicable only to SubDocuments of type kArray. Stored as a byte, see GetExtendOrder.
+  mutable uint8_t extend_order_ = static_cast<uint8_t>(ListExtendOrder::APPEND);
 
   // TODO: do we have to worry about alignment here?
   union {
@@ -505,6 +518,10 @@ class PrimitiveValue {
   }
 };
 
+// Every SubDocument node is a PrimitiveValue, so its size directly affects the memory used by
+// documents of wide rows.
+static_assert(sizeof(PrimitiveValue) <= 48, "PrimitiveValue is expected to fit into 48 bytes");
+
 inline std::ostream& operator<<(std::ostream& out, const PrimitiveValue& primitive_value) {
   out << primitive_value.ToString();
   return out;
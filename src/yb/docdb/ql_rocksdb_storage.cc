@@ -37,6 +37,7 @@ Status QLRocksDBStorage::GetIterator(const QLReadRequestPB& request,
 
   auto doc_iter = std::make_unique<DocRowwiseIterator>(
       projection, schema, txn_op_context, doc_db_, deadline, read_time);
+  doc_iter->set_row_limit(request.has_limit() ? request.limit() : DocRowwiseIterator::kNoRowLimit);
   RETURN_NOT_OK(doc_iter->Init(spec));
   *iter = std::move(doc_iter);
   return Status::OK();
@@ -164,6 +165,8 @@ Status QLRocksDBStorage::GetIterator(const PgsqlReadRequestPB& request,
     // Construct the scan spec basing on the WHERE condition.
     doc_iter = std::make_unique<DocRowwiseIterator>(
         projection, schema, txn_op_context, doc_db_, deadline, req_read_time);
+    doc_iter->set_row_limit(
+        request.has_limit() ? request.limit() : DocRowwiseIterator::kNoRowLimit);
     RETURN_NOT_OK(doc_iter->Init(DocPgsqlScanSpec(schema,
                                                   request.stmt_id(),
                                                   hashed_components,
@@ -0,0 +1,123 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/docdb/ql_scan_cursors.h"
+
+#include <gflags/gflags.h>
+
+#include "yb/util/test_macros.h"
+#include "yb/util/test_util.h"
+
+DECLARE_int32(ql_scan_cursors_per_tablet);
+DECLARE_int32(ql_scan_cursor_ttl_ms);
+
+namespace yb {
+namespace docdb {
+
+namespace {
+
+QLReadRequestPB MakeRequest(int hash_code) {
+  QLReadRequestPB request;
+  request.set_client(YQL_CLIENT_CQL);
+  request.set_hash_code(hash_code);
+  request.set_limit(10);
+  request.set_return_paging_state(true);
+  return request;
+}
+
+// Request of the page that continues the read of request at next_row_key using cursor id.
+QLReadRequestPB NextPage(QLReadRequestPB request, const std::string& next_row_key, uint64_t id) {
+  request.set_limit(5);
+  request.set_request_id(request.request_id() + 1);
+  request.mutable_paging_state()->set_next_row_key(next_row_key);
+  request.mutable_paging_state()->set_cursor_id(id);
+  return request;
+}
+
+class QLScanCursorsTest : public YBTest {
+ protected:
+  void SetUp() override {
+    YBTest::SetUp();
+    FLAGS_ql_scan_cursors_per_tablet = 2;
+    cursors_ = std::make_unique<QLScanCursors>();
+  }
+
+  uint64_t Put(const QLReadRequestPB& request, const std::string& next_row_key) {
+    return cursors_->Put(std::make_unique<QLScanCursor>(request, Schema()), next_row_key);
+  }
+
+  std::unique_ptr<QLScanCursors> cursors_;
+};
+
+} // namespace
+
+TEST_F(QLScanCursorsTest, Continue) {
+  auto request = MakeRequest(1);
+  auto id = Put(request, "b");
+  ASSERT_NE(0, id);
+  ASSERT_EQ(1, cursors_->size());
+
+  // Cursor of the read is not used without its id.
+  ASSERT_EQ(nullptr, cursors_->Take(request));
+
+  auto cursor = cursors_->Take(NextPage(request, "b", id));
+  ASSERT_NE(nullptr, cursor);
+  ASSERT_EQ(0, cursors_->size());
+
+  // Cursor is not used twice.
+  ASSERT_EQ(nullptr, cursors_->Take(NextPage(request, "b", id)));
+
+  auto next_id = cursors_->Put(std::move(cursor), "c");
+  ASSERT_NE(id, next_id);
+  ASSERT_NE(nullptr, cursors_->Take(NextPage(request, "c", next_id)));
+}
+
+TEST_F(QLScanCursorsTest, Mismatch) {
+  auto request = MakeRequest(1);
+
+  // The next page does not start where the cursor stopped, e.g. when the read was restarted.
+  auto id = Put(request, "b");
+  ASSERT_EQ(nullptr, cursors_->Take(NextPage(request, "a", id)));
+  ASSERT_EQ(0, cursors_->size());
+
+  // The page is requested by a different read.
+  id = Put(request, "b");
+  ASSERT_EQ(nullptr, cursors_->Take(NextPage(MakeRequest(2), "b", id)));
+  ASSERT_EQ(0, cursors_->size());
+}
+
+TEST_F(QLScanCursorsTest, Evict) {
+  auto request = MakeRequest(1);
+  auto first = Put(request, "a");
+  auto second = Put(request, "b");
+  auto third = Put(request, "c");
+  ASSERT_EQ(2, cursors_->size());
+
+  // The oldest cursor is evicted.
+  ASSERT_EQ(nullptr, cursors_->Take(NextPage(request, "a", first)));
+  ASSERT_NE(nullptr, cursors_->Take(NextPage(request, "b", second)));
+  ASSERT_NE(nullptr, cursors_->Take(NextPage(request, "c", third)));
+
+  // Expired cursors are not used.
+  FLAGS_ql_scan_cursor_ttl_ms = -1;
+  auto id = Put(request, "a");
+  ASSERT_EQ(nullptr, cursors_->Take(NextPage(request, "a", id)));
+
+  auto remaining = Put(request, "b");
+  cursors_->Clear();
+  ASSERT_EQ(0, cursors_->size());
+  ASSERT_EQ(nullptr, cursors_->Take(NextPage(request, "b", remaining)));
+}
+
+} // namespace docdb
+} // namespace yb
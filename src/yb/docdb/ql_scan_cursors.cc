@@ -0,0 +1,135 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/docdb/ql_scan_cursors.h"
+
+#include <vector>
+
+#include <gflags/gflags.h>
+
+#include "yb/util/flag_tags.h"
+#include "yb/util/random_util.h"
+
+using namespace std::literals;
+
+DEFINE_int32(ql_scan_cursors_per_tablet, 0,
+             "Maximum number of open scans of paged CQL reads kept by a tablet, so the next page "
+             "could be read without seeking to its start. 0 to disable.");
+TAG_FLAG(ql_scan_cursors_per_tablet, advanced);
+TAG_FLAG(ql_scan_cursors_per_tablet, runtime);
+
+DEFINE_int32(ql_scan_cursor_ttl_ms, 10000,
+             "Time in milliseconds an open scan of a paged CQL read is kept for the read of the "
+             "next page.");
+TAG_FLAG(ql_scan_cursor_ttl_ms, advanced);
+TAG_FLAG(ql_scan_cursor_ttl_ms, runtime);
+
+namespace yb {
+namespace docdb {
+
+QLScanCursor::QLScanCursor(const QLReadRequestPB& request_, const Schema& projection_)
+    : request(request_), projection(projection_), signature(QLScanCursors::Signature(request_)) {
+}
+
+QLScanCursors::QLScanCursors() : next_id_(RandomUniformInt<uint64_t>()) {
+}
+
+QLScanCursors::~QLScanCursors() {
+  Clear();
+}
+
+bool QLScanCursors::Enabled() {
+  return FLAGS_ql_scan_cursors_per_tablet > 0;
+}
+
+std::string QLScanCursors::Signature(const QLReadRequestPB& request) {
+  QLReadRequestPB copy(request);
+  copy.clear_paging_state();
+  copy.clear_limit();
+  copy.clear_request_id();
+  copy.clear_query_id();
+  std::string result;
+  copy.SerializeToString(&result);
+  return result;
+}
+
+std::unique_ptr<QLScanCursor> QLScanCursors::Take(const QLReadRequestPB& request) {
+  const auto& paging_state = request.paging_state();
+  if (!paging_state.has_cursor_id()) {
+    return nullptr;
+  }
+
+  const auto now = CoarseMonoClock::Now();
+  std::unique_ptr<QLScanCursor> result;
+  bool matches = false;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto it = entries_.begin(); it != entries_.end(); ++it) {
+      if (it->id != paging_state.cursor_id()) {
+        continue;
+      }
+      // The cursor is taken even if it does not match, since it could not be used by anyone else.
+      matches = it->expiration >= now && it->next_row_key == paging_state.next_row_key();
+      result = std::move(it->cursor);
+      entries_.erase(it);
+      break;
+    }
+  }
+
+  // Signature of the request is calculated out of the lock, since it serializes the request.
+  if (result && (!matches || result->signature != Signature(request))) {
+    result.reset();
+  }
+  return result;
+}
+
+uint64_t QLScanCursors::Put(std::unique_ptr<QLScanCursor> cursor,
+                            const std::string& next_row_key) {
+  const auto now = CoarseMonoClock::Now();
+  const size_t max_cursors = std::max(FLAGS_ql_scan_cursors_per_tablet, 1);
+  // Cursors are destroyed out of the lock, to not block other reads while iterators are released.
+  std::vector<std::unique_ptr<QLScanCursor>> evicted;
+  uint64_t id;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    while (!entries_.empty() &&
+           (entries_.front().expiration < now || entries_.size() >= max_cursors)) {
+      evicted.push_back(std::move(entries_.front().cursor));
+      entries_.pop_front();
+    }
+    // 0 is never used, so it could not be confused with a missing id.
+    id = ++next_id_;
+    if (id == 0) {
+      id = ++next_id_;
+    }
+    entries_.push_back(Entry{
+        id, next_row_key, now + FLAGS_ql_scan_cursor_ttl_ms * 1ms, std::move(cursor)});
+  }
+  return id;
+}
+
+void QLScanCursors::Clear() {
+  std::list<Entry> entries;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    entries.swap(entries_);
+  }
+}
+
+size_t QLScanCursors::size() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return entries_.size();
+}
+
+} // namespace docdb
+} // namespace yb
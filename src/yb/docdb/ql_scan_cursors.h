@@ -0,0 +1,101 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#ifndef YB_DOCDB_QL_SCAN_CURSORS_H
+#define YB_DOCDB_QL_SCAN_CURSORS_H
+
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include "yb/common/ql_protocol.pb.h"
+#include "yb/common/ql_rowwise_iterator_interface.h"
+#include "yb/common/ql_scanspec.h"
+#include "yb/common/read_hybrid_time.h"
+#include "yb/common/schema.h"
+
+#include "yb/util/monotime.h"
+
+namespace yb {
+namespace docdb {
+
+// Open scan of a paged CQL read, that could be continued by the read of the next page instead of
+// seeking to its start.
+struct QLScanCursor {
+  QLScanCursor(const QLReadRequestPB& request_, const Schema& projection_);
+
+  // Copy of the request that started the scan, the spec refers to it.
+  const QLReadRequestPB request;
+  // Projection the iterator was created with, the iterator refers to it.
+  const Schema projection;
+  // Request fields that should be the same for all pages of the scan.
+  const std::string signature;
+
+  std::unique_ptr<common::QLScanSpec> spec;
+  std::unique_ptr<common::YQLRowwiseIteratorIf> iter;
+  ReadHybridTime read_time;
+};
+
+// Per-tablet set of scan cursors of paged reads that are not finished yet.
+//
+// The id of a cursor is returned to the client in the paging state of a page, and the read of the
+// next page takes the cursor by this id. A cursor is used only when the next page starts at the
+// row the cursor stopped at, and the request is the same except for the paging state and limit.
+// Otherwise, or when the cursor expired or was evicted, the read seeks to the start of the page
+// as usual. Since a cursor keeps its read time, all pages continued on the cursor are read at the
+// read time of the page that opened it.
+//
+// Each open cursor pins RocksDB memtables and files, so the number of cursors is bounded by
+// FLAGS_ql_scan_cursors_per_tablet and they expire after FLAGS_ql_scan_cursor_ttl_ms.
+// Cursors are disabled when FLAGS_ql_scan_cursors_per_tablet is 0.
+class QLScanCursors {
+ public:
+  QLScanCursors();
+  ~QLScanCursors();
+
+  static bool Enabled();
+
+  // Returns the signature that should match for cursor of the request.
+  static std::string Signature(const QLReadRequestPB& request);
+
+  // Takes the cursor with id from the paging state of request, if the cursor could be used to
+  // read the page requested. Returns nullptr otherwise.
+  std::unique_ptr<QLScanCursor> Take(const QLReadRequestPB& request);
+
+  // Stores the cursor stopped at next_row_key, returns its id.
+  uint64_t Put(std::unique_ptr<QLScanCursor> cursor, const std::string& next_row_key);
+
+  // Drops all cursors, should be invoked before the RocksDB they read is closed.
+  void Clear();
+
+  size_t size();
+
+ private:
+  struct Entry {
+    uint64_t id;
+    std::string next_row_key;
+    CoarseTimePoint expiration;
+    std::unique_ptr<QLScanCursor> cursor;
+  };
+
+  std::mutex mutex_;
+  // Cursors in the order they were put, so the oldest are evicted first.
+  std::list<Entry> entries_;
+  uint64_t next_id_;
+};
+
+} // namespace docdb
+} // namespace yb
+
+#endif // YB_DOCDB_QL_SCAN_CURSORS_H
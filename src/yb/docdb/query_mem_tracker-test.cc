@@ -0,0 +1,88 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/docdb/query_mem_tracker.h"
+
+#include <gflags/gflags.h>
+
+#include "yb/util/test_macros.h"
+#include "yb/util/test_util.h"
+
+DECLARE_int64(query_memory_soft_limit_bytes);
+DECLARE_int64(query_memory_hard_limit_bytes);
+
+namespace yb {
+namespace docdb {
+
+class QueryMemTrackerTest : public YBTest {
+ protected:
+  void SetUp() override {
+    YBTest::SetUp();
+    server_tracker_ = MemTracker::CreateTracker("server");
+    queries_tracker_ = QueryMemTracker::GetQueriesTracker(server_tracker_);
+  }
+
+  MemTrackerPtr server_tracker_;
+  MemTrackerPtr queries_tracker_;
+};
+
+TEST_F(QueryMemTrackerTest, Consumption) {
+  ASSERT_EQ(queries_tracker_, QueryMemTracker::GetQueriesTracker(server_tracker_));
+  {
+    QueryMemTracker first(queries_tracker_, "read");
+    QueryMemTracker second(queries_tracker_, "read");
+    ASSERT_EQ(2, queries_tracker_->ListChildren().size());
+
+    first.SetCurrentResultSize(100);
+    first.SetCurrentResultSize(300);
+    first.FinishResult();
+    first.SetCurrentResultSize(50);
+    second.SetCurrentResultSize(1000);
+    ASSERT_EQ(350, first.consumption());
+    ASSERT_EQ(1350, queries_tracker_->consumption());
+    ASSERT_EQ(1350, server_tracker_->consumption());
+
+    first.Reset();
+    ASSERT_EQ(0, first.consumption());
+    ASSERT_EQ(350, first.peak_consumption());
+    ASSERT_EQ(1000, server_tracker_->consumption());
+  }
+  ASSERT_EQ(0, server_tracker_->consumption());
+  ASSERT_TRUE(queries_tracker_->ListChildren().empty());
+}
+
+TEST_F(QueryMemTrackerTest, Limits) {
+  FLAGS_query_memory_soft_limit_bytes = 100;
+  FLAGS_query_memory_hard_limit_bytes = 1000;
+  QueryMemTracker tracker(queries_tracker_, "read");
+
+  tracker.SetCurrentResultSize(100);
+  ASSERT_FALSE(tracker.SoftLimitExceeded());
+  ASSERT_OK(tracker.CheckHardLimit());
+
+  tracker.SetCurrentResultSize(101);
+  ASSERT_TRUE(tracker.SoftLimitExceeded());
+  ASSERT_OK(tracker.CheckHardLimit());
+
+  tracker.FinishResult();
+  tracker.SetCurrentResultSize(900);
+  ASSERT_NOK(tracker.CheckHardLimit());
+
+  FLAGS_query_memory_soft_limit_bytes = 0;
+  FLAGS_query_memory_hard_limit_bytes = 0;
+  ASSERT_FALSE(tracker.SoftLimitExceeded());
+  ASSERT_OK(tracker.CheckHardLimit());
+}
+
+} // namespace docdb
+} // namespace yb
@@ -0,0 +1,93 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/docdb/query_mem_tracker.h"
+
+#include <atomic>
+
+#include <gflags/gflags.h>
+
+#include "yb/util/flag_tags.h"
+#include "yb/util/format.h"
+#include "yb/util/size_literals.h"
+
+using namespace yb::size_literals;
+
+DEFINE_int64(query_memory_soft_limit_bytes, 64_MB,
+             "Paged reads return the rows read so far once the results of the read request take "
+             "more than this number of bytes, the client continues with the next page. "
+             "0 to disable.");
+TAG_FLAG(query_memory_soft_limit_bytes, advanced);
+TAG_FLAG(query_memory_soft_limit_bytes, runtime);
+
+DEFINE_int64(query_memory_hard_limit_bytes, 1_GB,
+             "Read requests fail once their results take more than this number of bytes. "
+             "0 to disable.");
+TAG_FLAG(query_memory_hard_limit_bytes, advanced);
+TAG_FLAG(query_memory_hard_limit_bytes, runtime);
+
+namespace yb {
+namespace docdb {
+
+namespace {
+
+std::atomic<uint64_t> next_query_id{0};
+
+} // namespace
+
+QueryMemTracker::QueryMemTracker(const MemTrackerPtr& parent, const std::string& label)
+    : tracker_(MemTracker::CreateTracker(
+          Format("$0-$1", label, next_query_id.fetch_add(1, std::memory_order_relaxed)), parent,
+          AddToParent::kTrue, CreateMetrics::kFalse)),
+      consumption_(tracker_, 0) {
+}
+
+QueryMemTracker::~QueryMemTracker() {
+  consumption_.Reset(0);
+  tracker_->UnregisterFromParent();
+}
+
+MemTrackerPtr QueryMemTracker::GetQueriesTracker(const MemTrackerPtr& server_tracker) {
+  return MemTracker::FindOrCreateTracker("queries", server_tracker);
+}
+
+void QueryMemTracker::SetCurrentResultSize(int64_t size) {
+  consumption_.Reset(finished_ + size);
+}
+
+void QueryMemTracker::FinishResult() {
+  finished_ = consumption_.consumption();
+}
+
+void QueryMemTracker::Reset() {
+  consumption_.Reset(0);
+  finished_ = 0;
+}
+
+bool QueryMemTracker::SoftLimitExceeded() const {
+  const auto limit = FLAGS_query_memory_soft_limit_bytes;
+  return limit > 0 && consumption() > limit;
+}
+
+Status QueryMemTracker::CheckHardLimit() const {
+  const auto limit = FLAGS_query_memory_hard_limit_bytes;
+  if (limit > 0 && consumption() > limit) {
+    return STATUS_FORMAT(
+        RuntimeError, "Read request memory limit exceeded: $0 bytes used, limit $1 bytes",
+        consumption(), limit);
+  }
+  return Status::OK();
+}
+
+} // namespace docdb
+} // namespace yb
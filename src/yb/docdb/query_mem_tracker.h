@@ -0,0 +1,75 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#ifndef YB_DOCDB_QUERY_MEM_TRACKER_H
+#define YB_DOCDB_QUERY_MEM_TRACKER_H
+
+#include <string>
+
+#include "yb/util/mem_tracker.h"
+#include "yb/util/status.h"
+
+namespace yb {
+namespace docdb {
+
+// Memory used by a single read request, i.e. its result row blocks and response buffers, charged
+// to a child of the "queries" tracker of the server, so a large scan is visible in /mem-trackers
+// while it runs.
+//
+// A read that could be continued by the next page stops early once the consumption of the request
+// exceeds FLAGS_query_memory_soft_limit_bytes, and a read fails once it exceeds
+// FLAGS_query_memory_hard_limit_bytes.
+//
+// Results of a request are read one after another, the buffers of finished results stay charged
+// until the tracker is destroyed or reset. Not thread safe.
+class QueryMemTracker {
+ public:
+  // The id of the tracker is the label followed by a sequence number, unique within the server.
+  QueryMemTracker(const MemTrackerPtr& parent, const std::string& label);
+  ~QueryMemTracker();
+
+  QueryMemTracker(const QueryMemTracker&) = delete;
+  void operator=(const QueryMemTracker&) = delete;
+
+  // Returns the "queries" tracker of the server with the specified tracker.
+  static MemTrackerPtr GetQueriesTracker(const MemTrackerPtr& server_tracker);
+
+  // Charges the result being read, that takes size bytes.
+  void SetCurrentResultSize(int64_t size);
+
+  // The current result is complete, the next result is charged in addition to it.
+  void FinishResult();
+
+  // Releases all consumption, e.g. when the read is restarted.
+  void Reset();
+
+  // Whether the read should stop and return the rows read so far with a paging state.
+  bool SoftLimitExceeded() const;
+
+  // Returns an error when the request should fail.
+  CHECKED_STATUS CheckHardLimit() const;
+
+  int64_t consumption() const { return consumption_.consumption(); }
+  int64_t peak_consumption() const { return tracker_->peak_consumption(); }
+
+ private:
+  MemTrackerPtr tracker_;
+  ScopedTrackedConsumption consumption_;
+  // Consumption of the finished results.
+  int64_t finished_ = 0;
+};
+
+} // namespace docdb
+} // namespace yb
+
+#endif // YB_DOCDB_QUERY_MEM_TRACKER_H
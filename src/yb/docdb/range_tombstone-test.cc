@@ -0,0 +1,97 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/docdb/range_tombstone.h"
+
+#include <limits>
+
+#include "yb/docdb/primitive_value.h"
+
+#include "yb/util/test_macros.h"
+#include "yb/util/test_util.h"
+
+namespace yb {
+namespace docdb {
+
+namespace {
+
+std::string EncodedComponent(int64_t value) {
+  KeyBytes key;
+  PrimitiveValue(value).AppendToKey(&key);
+  return key.data();
+}
+
+KeyBytes RowKey(const std::string& hashed, int64_t range) {
+  return DocKey(0x1234, {PrimitiveValue(hashed)}, {PrimitiveValue(range)}).Encode();
+}
+
+} // namespace
+
+TEST(RangeTombstoneTest, EncodeDecode) {
+  RangeTombstone tombstone;
+  tombstone.SetLowerBound(EncodedComponent(10), false /* inclusive */);
+  tombstone.SetUpperBound(EncodedComponent(20), true /* inclusive */);
+
+  RangeTombstone decoded;
+  const auto encoded = tombstone.Encode();
+  ASSERT_OK(decoded.Decode(encoded));
+  ASSERT_FALSE(decoded.Covers(EncodedComponent(5)));
+  ASSERT_FALSE(decoded.Covers(EncodedComponent(10)));
+  ASSERT_TRUE(decoded.Covers(EncodedComponent(11)));
+  ASSERT_TRUE(decoded.Covers(EncodedComponent(20)));
+  ASSERT_FALSE(decoded.Covers(EncodedComponent(21)));
+
+  ASSERT_NOK(decoded.Decode(Slice(encoded.data(), encoded.size() - 1)));
+  ASSERT_NOK(decoded.Decode(encoded + "x"));
+
+  // A tombstone without bounds covers the whole partition.
+  ASSERT_OK(decoded.Decode(RangeTombstone().Encode()));
+  ASSERT_TRUE(decoded.Covers(EncodedComponent(std::numeric_limits<int64_t>::min())));
+  ASSERT_TRUE(decoded.Covers(EncodedComponent(std::numeric_limits<int64_t>::max())));
+}
+
+TEST(RangeTombstoneTest, CoveringWriteTime) {
+  RangeTombstone below_20;
+  below_20.SetUpperBound(EncodedComponent(20), false /* inclusive */);
+  RangeTombstone above_10;
+  above_10.SetLowerBound(EncodedComponent(10), true /* inclusive */);
+
+  const DocHybridTime time1(HybridTime::FromMicros(1000), 0);
+  const DocHybridTime time2(HybridTime::FromMicros(2000), 0);
+  RangeTombstones tombstones;
+  const auto partition_key = DocKey(0x1234, {PrimitiveValue("h")}, {}).Encode();
+  ASSERT_OK(tombstones.Add(partition_key.AsSlice(), below_20, time2));
+  ASSERT_OK(tombstones.Add(partition_key.AsSlice(), above_10, time1));
+
+  ASSERT_TRUE(tombstones.IsLoadedFor(RowKey("h", 5).AsSlice()));
+  ASSERT_EQ(time2, ASSERT_RESULT(tombstones.CoveringWriteTime(RowKey("h", 5).AsSlice())));
+  ASSERT_EQ(time2, ASSERT_RESULT(tombstones.CoveringWriteTime(RowKey("h", 15).AsSlice())));
+  ASSERT_EQ(time1, ASSERT_RESULT(tombstones.CoveringWriteTime(RowKey("h", 20).AsSlice())));
+  ASSERT_EQ(DocHybridTime::kMin,
+            ASSERT_RESULT(tombstones.CoveringWriteTime(partition_key.AsSlice())));
+
+  // Rows of other partitions are not covered.
+  ASSERT_FALSE(tombstones.IsLoadedFor(RowKey("hh", 5).AsSlice()));
+  ASSERT_EQ(DocHybridTime::kMin,
+            ASSERT_RESULT(tombstones.CoveringWriteTime(RowKey("hh", 5).AsSlice())));
+
+  // Adding a tombstone of another partition drops the tombstones of the previous one.
+  const auto other_partition_key = DocKey(0x1234, {PrimitiveValue("hh")}, {}).Encode();
+  ASSERT_OK(tombstones.Add(other_partition_key.AsSlice(), above_10, time1));
+  ASSERT_EQ(DocHybridTime::kMin,
+            ASSERT_RESULT(tombstones.CoveringWriteTime(RowKey("h", 15).AsSlice())));
+  ASSERT_EQ(time1, ASSERT_RESULT(tombstones.CoveringWriteTime(RowKey("hh", 15).AsSlice())));
+}
+
+}  // namespace docdb
+}  // namespace yb
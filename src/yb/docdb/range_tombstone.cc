@@ -0,0 +1,210 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/docdb/range_tombstone.h"
+
+#include "yb/docdb/intent_aware_iterator.h"
+#include "yb/docdb/primitive_value.h"
+
+#include "yb/util/fast_varint.h"
+#include "yb/util/format.h"
+
+namespace yb {
+namespace docdb {
+
+namespace {
+
+const KeyBytes& RangeTombstoneSubKey() {
+  static const KeyBytes result = [] {
+    KeyBytes key;
+    PrimitiveValue::SystemColumnId(SystemColumnIds::kRangeTombstone).AppendToKey(&key);
+    return key;
+  }();
+  return result;
+}
+
+} // namespace
+
+void RangeTombstone::SetLowerBound(std::string component, bool inclusive) {
+  lower_.type = inclusive ? BoundType::kInclusive : BoundType::kExclusive;
+  lower_.component = std::move(component);
+}
+
+void RangeTombstone::SetUpperBound(std::string component, bool inclusive) {
+  upper_.type = inclusive ? BoundType::kInclusive : BoundType::kExclusive;
+  upper_.component = std::move(component);
+}
+
+bool RangeTombstone::Covers(const Slice& component) const {
+  if (lower_.type != BoundType::kUnbounded) {
+    const int compare = component.compare(lower_.component);
+    if (compare < 0 || (compare == 0 && lower_.type == BoundType::kExclusive)) {
+      return false;
+    }
+  }
+  if (upper_.type != BoundType::kUnbounded) {
+    const int compare = component.compare(upper_.component);
+    if (compare > 0 || (compare == 0 && upper_.type == BoundType::kExclusive)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Each bound is encoded as its type, followed by the size of the component and the component
+// itself for bounded ones, with the size as an unsigned varint.
+void RangeTombstone::EncodeBound(const Bound& bound, std::string* out) {
+  out->push_back(static_cast<char>(bound.type));
+  if (bound.type != BoundType::kUnbounded) {
+    util::FastAppendUnsignedVarIntToStr(bound.component.size(), out);
+    out->append(bound.component);
+  }
+}
+
+Status RangeTombstone::DecodeBound(Slice* encoded, Bound* bound) {
+  if (encoded->empty()) {
+    return STATUS(Corruption, "Range tombstone bound is missing");
+  }
+  const auto type = static_cast<BoundType>(encoded->consume_byte());
+  switch (type) {
+    case BoundType::kUnbounded:
+      bound->component.clear();
+      break;
+    case BoundType::kInclusive: FALLTHROUGH_INTENDED;
+    case BoundType::kExclusive: {
+      const auto size = VERIFY_RESULT(util::FastDecodeUnsignedVarInt(encoded));
+      if (size > encoded->size()) {
+        return STATUS_FORMAT(Corruption, "Range tombstone bound is truncated: $0 > $1",
+                             size, encoded->size());
+      }
+      bound->component.assign(encoded->cdata(), size);
+      encoded->remove_prefix(size);
+      break;
+    }
+    default:
+      return STATUS_FORMAT(Corruption, "Unknown range tombstone bound type: $0",
+                           static_cast<int>(type));
+  }
+  bound->type = type;
+  return Status::OK();
+}
+
+std::string RangeTombstone::Encode() const {
+  std::string result;
+  EncodeBound(lower_, &result);
+  EncodeBound(upper_, &result);
+  return result;
+}
+
+Status RangeTombstone::Decode(Slice encoded) {
+  RETURN_NOT_OK(DecodeBound(&encoded, &lower_));
+  RETURN_NOT_OK(DecodeBound(&encoded, &upper_));
+  if (!encoded.empty()) {
+    return STATUS_FORMAT(Corruption, "$0 extra bytes after range tombstone", encoded.size());
+  }
+  return Status::OK();
+}
+
+std::string RangeTombstone::ToString() const {
+  auto bound_to_string = [](const Bound& bound) {
+    return bound.type == BoundType::kUnbounded ? std::string("-")
+                                               : Slice(bound.component).ToDebugHexString();
+  };
+  return Format("$0$1, $2$3",
+                lower_.type == BoundType::kExclusive ? "(" : "[", bound_to_string(lower_),
+                bound_to_string(upper_), upper_.type == BoundType::kExclusive ? ")" : "]");
+}
+
+Result<bool> RangeTombstones::ResetPartition(const Slice& key) {
+  tombstones_.clear();
+  partition_.clear();
+  const auto hashed_part_size = VERIFY_RESULT(
+      DocKey::EncodedSize(key, DocKeyPart::HASHED_PART_ONLY));
+  if (hashed_part_size == 0) {
+    return false;
+  }
+  partition_.assign(key.cdata(), hashed_part_size);
+  return true;
+}
+
+Status RangeTombstones::Load(IntentAwareIterator* iter, const Slice& key) {
+  if (!VERIFY_RESULT(ResetPartition(key))) {
+    return Status::OK();
+  }
+  KeyBytes prefix(partition_);
+  prefix.AppendValueType(ValueType::kGroupEnd);
+  prefix.Append(RangeTombstoneSubKey());
+  IntentAwareIteratorPrefixScope prefix_scope(prefix.AsSlice(), iter);
+  iter->Seek(prefix.AsSlice());
+  while (iter->valid()) {
+    DocHybridTime write_time;
+    KeyBytes record_key(VERIFY_RESULT(iter->FetchKey(&write_time)));
+    Slice encoded_bounds = record_key.AsSlice();
+    encoded_bounds.remove_prefix(prefix.size());
+    PrimitiveValue bounds;
+    RETURN_NOT_OK(bounds.DecodeFromKey(&encoded_bounds));
+    if (!bounds.IsString()) {
+      return STATUS_FORMAT(Corruption, "Range tombstone bounds expected, found: $0", bounds);
+    }
+    RangeTombstone tombstone;
+    RETURN_NOT_OK(tombstone.Decode(bounds.GetString()));
+    tombstones_.emplace_back(std::move(tombstone), write_time);
+    iter->SeekPastSubKey(record_key.AsSlice());
+  }
+  return Status::OK();
+}
+
+Status RangeTombstones::Add(
+    const Slice& key, const RangeTombstone& tombstone, DocHybridTime write_time) {
+  if (!IsLoadedFor(key) && !VERIFY_RESULT(ResetPartition(key))) {
+    return STATUS_FORMAT(Corruption, "Range tombstone of a key without hash: $0",
+                         key.ToDebugHexString());
+  }
+  tombstones_.emplace_back(tombstone, write_time);
+  return Status::OK();
+}
+
+Result<DocHybridTime> RangeTombstones::CoveringWriteTime(const Slice& key) const {
+  DocHybridTime result = DocHybridTime::kMin;
+  if (tombstones_.empty() || !IsLoadedFor(key)) {
+    return result;
+  }
+  Slice component(key.data() + partition_.size(), key.end());
+  if (component.empty() || component[0] == ValueTypeAsChar::kGroupEnd) {
+    // The document of the partition itself.
+    return result;
+  }
+  const auto* begin = component.data();
+  RETURN_NOT_OK(PrimitiveValue::DecodeKey(&component, nullptr /* out */));
+  component = Slice(begin, component.data());
+  for (const auto& tombstone : tombstones_) {
+    if (tombstone.second > result && tombstone.first.Covers(component)) {
+      result = tombstone.second;
+    }
+  }
+  return result;
+}
+
+bool IsRangeTombstone(const SubDocKey& key) {
+  return key.num_subkeys() == 2 && key.doc_key().range_group().empty() &&
+         !key.doc_key().hashed_group().empty() &&
+         key.subkeys()[0] == PrimitiveValue::SystemColumnId(SystemColumnIds::kRangeTombstone) &&
+         key.subkeys()[1].IsString();
+}
+
+bool IsRangeTombstone(const Slice& key, size_t doc_key_size) {
+  return Slice(key.data() + doc_key_size, key.end()).starts_with(RangeTombstoneSubKey().AsSlice());
+}
+
+}  // namespace docdb
+}  // namespace yb
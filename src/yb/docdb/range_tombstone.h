@@ -0,0 +1,128 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#ifndef YB_DOCDB_RANGE_TOMBSTONE_H
+#define YB_DOCDB_RANGE_TOMBSTONE_H
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "yb/common/doc_hybrid_time.h"
+#include "yb/common/schema.h"
+
+#include "yb/docdb/doc_key.h"
+
+#include "yb/util/result.h"
+#include "yb/util/slice.h"
+
+namespace yb {
+namespace docdb {
+
+class IntentAwareIterator;
+
+// A deletion of the rows of a partition, i.e. of the documents with the same hash and hashed
+// components, whose first range component is within the given bounds. An unbounded tombstone
+// deletes the whole partition.
+//
+// A range tombstone is stored as a single tombstone record under the document of the partition
+// itself (the one with an empty range group, which also holds the static columns):
+//   <hash><hashed components><empty range group>
+//       <SystemColumnIds::kRangeTombstone><encoded bounds> HT -> DEL
+// The document sorts before all rows of the partition, and readers of a partition load its range
+// tombstones first, then treat every covered row as deleted at the latest write time of the
+// tombstones covering it. Compactions drop the covered records older than the tombstone, and drop
+// the tombstone itself on major compactions like other tombstones.
+//
+// Bounds are compared with the key encoding of the first range component, so for a descending
+// column a "less than" condition is a lower bound.
+class RangeTombstone {
+ public:
+  enum class BoundType : uint8_t {
+    kUnbounded = 0,
+    kInclusive = 1,
+    kExclusive = 2,
+  };
+
+  // component is the key encoding of the bound value of the first range column.
+  void SetLowerBound(std::string component, bool inclusive);
+  void SetUpperBound(std::string component, bool inclusive);
+
+  bool has_lower_bound() const { return lower_.type != BoundType::kUnbounded; }
+  bool has_upper_bound() const { return upper_.type != BoundType::kUnbounded; }
+
+  // Whether the row with the given key encoded first range component is covered.
+  bool Covers(const Slice& component) const;
+
+  std::string Encode() const;
+  CHECKED_STATUS Decode(Slice encoded);
+
+  std::string ToString() const;
+
+ private:
+  struct Bound {
+    BoundType type = BoundType::kUnbounded;
+    std::string component;
+  };
+
+  static void EncodeBound(const Bound& bound, std::string* out);
+  static CHECKED_STATUS DecodeBound(Slice* encoded, Bound* bound);
+
+  Bound lower_;
+  Bound upper_;
+};
+
+// The range tombstones of a single partition, with their write times.
+class RangeTombstones {
+ public:
+  // Replaces the tombstones by the ones of the partition of the document with the given encoded
+  // key that are visible at the read time of iter. The iterator is left at an arbitrary position,
+  // the caller should seek it back.
+  CHECKED_STATUS Load(IntentAwareIterator* iter, const Slice& key);
+
+  // Adds a tombstone of the partition of the document with the given encoded key, dropping the
+  // tombstones of other partitions.
+  CHECKED_STATUS Add(const Slice& key, const RangeTombstone& tombstone, DocHybridTime write_time);
+
+  // Whether the tombstones are the ones of the partition of the document with the given key.
+  bool IsLoadedFor(const Slice& key) const {
+    return !partition_.empty() && key.starts_with(partition_);
+  }
+
+  // Returns the latest write time of the tombstones covering the row with the given encoded key,
+  // or DocHybridTime::kMin if there are none, including when the key belongs to another partition.
+  Result<DocHybridTime> CoveringWriteTime(const Slice& key) const;
+
+ private:
+  // Resets the partition to the one of key, returns false if key does not belong to a partition.
+  Result<bool> ResetPartition(const Slice& key);
+
+  // The encoded hash and hashed components of the partition, including their group end.
+  std::string partition_;
+  std::vector<std::pair<RangeTombstone, DocHybridTime>> tombstones_;
+};
+
+// Range tombstones are only written to tables with both hash and range columns, whose rows have
+// a partition document that sorts before them.
+inline bool SupportsRangeTombstones(const Schema& schema) {
+  return schema.num_hash_key_columns() > 0 && schema.num_range_key_columns() > 0;
+}
+
+// Whether the key without hybrid time is the key of a range tombstone record.
+bool IsRangeTombstone(const SubDocKey& key);
+bool IsRangeTombstone(const Slice& key, size_t doc_key_size);
+
+}  // namespace docdb
+}  // namespace yb
+
+#endif  // YB_DOCDB_RANGE_TOMBSTONE_H
@@ -159,6 +159,47 @@ TEST_F(SharedLockManagerTest, QuickLockUnlock) {
   }
 }
 
+// Many writers of non-conflicting keys, like concurrent inserts into a single tablet. Reports
+// lock batch throughput, which is limited by lock table contention only.
+TEST_F(SharedLockManagerTest, NonConflictingWriters) {
+  const auto kThreads = 64;
+  const auto kKeysPerBatch = 4;
+
+  std::atomic<bool> stop_requested{false};
+  std::atomic<size_t> total_batches{0};
+  std::vector<std::thread> threads;
+  while (threads.size() != kThreads) {
+    size_t thread_idx = threads.size();
+    threads.emplace_back([this, &stop_requested, &total_batches, thread_idx] {
+      size_t batches = 0;
+      while (!stop_requested.load(std::memory_order_acquire)) {
+        LockBatchEntries entries;
+        for (int k = 0; k != kKeysPerBatch; ++k) {
+          entries.push_back(
+              {RefCntPrefix(Format("key_$0_$1_$2", thread_idx, batches, k)),
+               IntentTypeSet({IntentType::kStrongWrite, IntentType::kStrongRead})});
+        }
+        LockBatch lb(&lm_, std::move(entries), CoarseTimePoint::max());
+        ASSERT_OK(lb.status());
+        ++batches;
+      }
+      total_batches.fetch_add(batches, std::memory_order_acq_rel);
+    });
+  }
+
+  const auto kDuration = 5s;
+  std::this_thread::sleep_for(kDuration);
+  stop_requested.store(true, std::memory_order_release);
+
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  LOG(INFO) << "Lock batches per second: "
+            << total_batches.load(std::memory_order_acquire) /
+                   std::chrono::duration_cast<std::chrono::seconds>(kDuration).count();
+}
+
 TEST_F(SharedLockManagerTest, LockConflicts) {
   rpc::ThreadPool tp(rpc::ThreadPoolOptions{"test_pool"s, 10, 1});
 
@@ -36,7 +36,7 @@ class SubDocument : public PrimitiveValue {
   ~SubDocument();
 
   explicit SubDocument(ListExtendOrder extend_order) : SubDocument(ValueType::kArray) {
-    extend_order_ = extend_order;
+    SetExtendOrder(extend_order);
   }
 
   // Copy constructor. This is potentially very expensive!
@@ -45,7 +45,7 @@ class SubDocument : public PrimitiveValue {
   explicit SubDocument(const std::vector<PrimitiveValue> &elements,
                        ListExtendOrder extend_order = ListExtendOrder::APPEND) {
     type_ = ValueType::kArray;
-    extend_order_ = extend_order;
+    SetExtendOrder(extend_order);
     complex_data_structure_ = new ArrayContainer();
     array_container().reserve(elements.size());
     for (auto& elt : elements) {
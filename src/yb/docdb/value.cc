@@ -61,6 +61,15 @@ Status Value::DecodeTTL(rocksdb::Slice* slice, MonoDelta* ttl) {
   return Status::OK();
 }
 
+Status Value::DecodeTTL(const rocksdb::Slice& rocksdb_value, MonoDelta* ttl) {
+  rocksdb::Slice value_copy = rocksdb_value;
+  uint64_t merge_flags;
+  RETURN_NOT_OK(DecodeMergeFlags(&value_copy, &merge_flags));
+  DocHybridTime intent_doc_ht;
+  RETURN_NOT_OK(DecodeIntentDocHT(&value_copy, &intent_doc_ht));
+  return DecodeTTL(&value_copy, ttl);
+}
+
 Status Value::DecodeUserTimestamp(const rocksdb::Slice& rocksdb_value,
                                   UserTimeMicros* user_timestamp) {
   MonoDelta ttl;
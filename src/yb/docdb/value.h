@@ -44,6 +44,9 @@ class Value {
   }
 
   static const uint64_t kTtlFlag = 0x1;
+  // The int64 value is added to the value of the previous record of the same key, instead of
+  // overwriting it. Used for blind increments of CQL counters, which are not transactional.
+  static const uint64_t kIncrementFlag = 0x2;
 
   static const MonoDelta kMaxTtl;
   // kResetTtl is useful for CQL when zero TTL indicates no TTL.
@@ -81,13 +84,9 @@ class Value {
   // Consume the Ttl portion of the slice if it exists and return it.
   static CHECKED_STATUS DecodeTTL(rocksdb::Slice* rocksdb_value, MonoDelta* ttl);
 
-  // A version that doesn't mutate the slice.
-  static CHECKED_STATUS DecodeTTL(const rocksdb::Slice& rocksdb_value, MonoDelta* ttl) {
-    rocksdb::Slice value_copy = rocksdb_value;
-    uint64_t merge_flags;
-    RETURN_NOT_OK(DecodeMergeFlags(&value_copy, &merge_flags));
-    return DecodeTTL(&value_copy, ttl);
-  }
+  // A version that doesn't mutate the slice. Skips the merge flags and intent hybrid time that
+  // could precede the TTL.
+  static CHECKED_STATUS DecodeTTL(const rocksdb::Slice& rocksdb_value, MonoDelta* ttl);
 
   // Decode the entire value
   CHECKED_STATUS Decode(const rocksdb::Slice &rocksdb_value);
@@ -132,6 +131,7 @@ class Value {
 
   // A place to store various merge flags; in particular, the MERGE flag currently used for TTL.
   // 0x1 = TTL-only entry
+  // 0x2 = Increment of the previous value
   // 0x3 = Value-only entry (potentially)
   uint64_t merge_flags_;
 
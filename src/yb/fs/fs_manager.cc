@@ -33,8 +33,10 @@
 #include "yb/fs/fs_manager.h"
 
 #include <deque>
+#include <future>
 #include <iostream>
 #include <map>
+#include <memory>
 #include <unordered_set>
 
 #include <glog/logging.h>
@@ -57,6 +59,7 @@
 #include "yb/util/oid_generator.h"
 #include "yb/util/path_util.h"
 #include "yb/util/pb_util.h"
+#include "yb/util/result.h"
 
 DEFINE_bool(enable_data_block_fsync, true,
             "Whether to enable fsync() of data blocks, metadata, and their parent directories. "
@@ -217,9 +220,35 @@ Status FsManager::Init() {
 
 Status FsManager::Open() {
   RETURN_NOT_OK(Init());
+
+  // Roots are usually on different disks, so their instance files are read in parallel.
+  std::vector<std::future<Result<std::unique_ptr<InstanceMetadataPB>>>> readers;
   for (const string& root : canonicalized_all_fs_roots_) {
-    gscoped_ptr<InstanceMetadataPB> pb(new InstanceMetadataPB);
-    RETURN_NOT_OK(pb_util::ReadPBContainerFromPath(env_, GetInstanceMetadataPath(root), pb.get()));
+    readers.push_back(std::async(std::launch::async, [this, root]()
+        -> Result<std::unique_ptr<InstanceMetadataPB>> {
+      auto pb = std::make_unique<InstanceMetadataPB>();
+      RETURN_NOT_OK(pb_util::ReadPBContainerFromPath(
+          env_, GetInstanceMetadataPath(root), pb.get()));
+      return pb;
+    }));
+  }
+
+  // Wait for all the readers even if one failed, since they refer to this.
+  std::vector<std::unique_ptr<InstanceMetadataPB>> pbs;
+  Status status;
+  for (auto& reader : readers) {
+    auto pb = reader.get();
+    if (!pb.ok()) {
+      if (status.ok()) {
+        status = pb.status();
+      }
+      continue;
+    }
+    pbs.push_back(std::move(*pb));
+  }
+  RETURN_NOT_OK(status);
+
+  for (auto& pb : pbs) {
     if (!metadata_) {
       metadata_.reset(pb.release());
     } else if (pb->uuid() != metadata_->uuid()) {
@@ -30,6 +30,7 @@
 // under the License.
 //
 
+#include <atomic>
 #include <memory>
 #include <thread>
 #include <boost/bind.hpp>
@@ -342,6 +343,66 @@ TEST_F(CreateTableStressTest, TestGetTableLocationsOptions) {
   }
 }
 
+// Measures throughput of master lookups while tables are created concurrently, each creation also
+// granting permissions on the new table to its creator role.
+TEST_F(CreateTableStressTest, TestLookupsDuringConcurrentCreateTable) {
+  DontVerifyClusterBeforeNextTearDown();
+  if (!AllowSlowTests()) {
+    LOG(INFO) << "Skipping slow test";
+    return;
+  }
+
+  constexpr int kNumLookupThreads = 4;
+  constexpr int kNumTables = 50;
+
+  YBTableName table_name("my_keyspace", "test_table");
+  ASSERT_NO_FATALS(CreateBigTable(table_name, FLAGS_num_test_tablets));
+  master::GetTableLocationsResponsePB resp;
+  ASSERT_OK(WaitForRunningTabletCount(cluster_->mini_master(), table_name,
+                                      FLAGS_num_test_tablets, &resp));
+
+  auto* catalog_manager = cluster_->mini_master()->master()->catalog_manager();
+  AtomicBool stop(false);
+  std::atomic<int64_t> num_lookups(0);
+  vector<thread> lookup_threads;
+  for (int i = 0; i != kNumLookupThreads; ++i) {
+    lookup_threads.emplace_back([&]() {
+      master::GetTableLocationsRequestPB req;
+      table_name.SetIntoTableIdentifierPB(req.mutable_table());
+      req.set_max_returned_locations(1);
+      master::GetPermissionsRequestPB permissions_req;
+      while (!stop.Load()) {
+        master::GetTableLocationsResponsePB locations_resp;
+        CHECK_OK(catalog_manager->GetTableLocations(&req, &locations_resp));
+        master::GetPermissionsResponsePB permissions_resp;
+        CHECK_OK(catalog_manager->GetPermissions(&permissions_req, &permissions_resp, nullptr));
+        num_lookups.fetch_add(2, std::memory_order_relaxed);
+      }
+    });
+  }
+
+  Stopwatch sw;
+  sw.start();
+  for (int i = 0; i != kNumTables; ++i) {
+    unique_ptr<YBTableCreator> table_creator(client_->NewTableCreator());
+    ASSERT_OK(table_creator->table_name(YBTableName("my_keyspace", Substitute("ddl-$0", i)))
+        .schema(&schema_)
+        .creator_role_name("cassandra")
+        .num_tablets(1)
+        .wait(false)
+        .Create());
+  }
+  sw.stop();
+  stop.Store(true);
+  for (auto& lookup_thread : lookup_threads) {
+    lookup_thread.join();
+  }
+
+  const double seconds = sw.elapsed().wall_seconds();
+  LOG(INFO) << "Created " << kNumTables << " tables in " << seconds << "s, master lookups: "
+            << num_lookups.load() << " (" << num_lookups.load() / seconds << " per second)";
+}
+
 // Creates tables and reloads on-disk metadata concurrently to test for races
 // between the two operations.
 TEST_F(CreateTableStressTest, TestConcurrentCreateTableAndReloadMetadata) {
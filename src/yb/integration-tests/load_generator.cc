@@ -20,6 +20,7 @@
 
 #include <gflags/gflags_declare.h>
 
+#include "yb/client/bulk_writer.h"
 #include "yb/client/client.h"
 #include "yb/client/table_handle.h"
 #include "yb/client/yb_op.h"
@@ -42,6 +43,7 @@
 #include "yb/util/threadlocal.h"
 
 using namespace std::literals;
+using namespace std::placeholders;
 
 using std::atomic;
 using std::atomic_bool;
@@ -181,6 +183,10 @@ SingleThreadedReader* YBSessionFactory::GetReader(MultiThreadedReader* reader, i
   return new YBSingleThreadedReader(reader, client_, table_, idx);
 }
 
+SingleThreadedWriter* YBBulkSessionFactory::GetWriter(MultiThreadedWriter* writer, int idx) {
+  return new YBBulkSingleThreadedWriter(writer, client_, table_, idx, batch_size_);
+}
+
 SingleThreadedWriter* NoopSessionFactory::GetWriter(MultiThreadedWriter* writer, int idx) {
   return new NoopSingleThreadedWriter(writer, client_, table_, idx);
 }
@@ -312,7 +318,7 @@ void SingleThreadedWriter::Run() {
     string value_str(multi_threaded_writer_->GetValueByIndex(key_index));
 
     if (Write(key_index, key_str, value_str)) {
-      multi_threaded_writer_->inserted_keys_.Insert(key_index);
+      Inserted(key_index);
     } else {
       multi_threaded_writer_->failed_keys_.Insert(key_index);
       HandleInsertionFailure(key_index, key_str);
@@ -328,6 +334,10 @@ void SingleThreadedWriter::Run() {
   CloseSession();
 }
 
+void SingleThreadedWriter::Inserted(int64_t key_index) {
+  multi_threaded_writer_->inserted_keys_.Insert(key_index);
+}
+
 void ConfigureRedisSessions(
     const string& redis_server_addresses, vector<shared_ptr<RedisClient> >* clients) {
   std::vector<string> addresses;
@@ -452,6 +462,81 @@ void YBSingleThreadedWriter::HandleInsertionFailure(int64_t key_index, const str
 
 void YBSingleThreadedWriter::CloseSession() { CHECK_OK(session_->Close()); }
 
+YBBulkSingleThreadedWriter::YBBulkSingleThreadedWriter(
+    MultiThreadedWriter* writer, client::YBClient* client, client::TableHandle* table,
+    int writer_index, size_t batch_size)
+    : YBSingleThreadedWriter(writer, client, table, writer_index), batch_size_(batch_size) {}
+
+YBBulkSingleThreadedWriter::~YBBulkSingleThreadedWriter() {}
+
+void YBBulkSingleThreadedWriter::ConfigureSession() {
+  client::YBBulkWriter::Options options;
+  options.batch_size = batch_size_;
+  options.timeout = 60s;
+  bulk_writer_ = std::make_unique<client::YBBulkWriter>(
+      client_, table_->table(), options,
+      std::bind(&YBBulkSingleThreadedWriter::RowFailed, this, _1, _2));
+  // Give each tablet about one full batch per flush.
+  flush_interval_ = batch_size_ * std::max<size_t>(table_->get()->GetPartitions().size(), 1);
+  pending_keys_.reserve(flush_interval_);
+}
+
+bool YBBulkSingleThreadedWriter::Write(
+    int64_t key_index, const string& key_str, const string& value_str) {
+  auto insert = table_->NewInsertOp();
+  QLAddStringHashValue(insert->mutable_request(), key_str);
+  table_->AddStringColumnValue(insert->mutable_request(), "v", value_str);
+  auto status = bulk_writer_->Write(insert);
+  if (!status.ok()) {
+    LOG(WARNING) << "Error inserting key '" << key_str << "': " << status;
+    return false;
+  }
+  pending_keys_.emplace_back(std::move(insert), key_index);
+  if (pending_keys_.size() >= flush_interval_) {
+    FlushBulkWriter();
+  }
+  return true;
+}
+
+void YBBulkSingleThreadedWriter::FlushBulkWriter() {
+  auto status = bulk_writer_->Flush();
+  LOG_IF(WARNING, !status.ok()) << "Writer " << writer_index_ << " flush failed: " << status;
+
+  std::lock_guard<std::mutex> lock(failed_ops_mutex_);
+  for (const auto& p : pending_keys_) {
+    if (failed_ops_.count(p.first.get())) {
+      multi_threaded_writer_->failed_keys_.Insert(p.second);
+    } else {
+      multi_threaded_writer_->inserted_keys_.Insert(p.second);
+    }
+  }
+  pending_keys_.clear();
+  failed_ops_.clear();
+
+  if (multi_threaded_writer_->num_write_errors() >
+      multi_threaded_writer_->max_num_write_errors_) {
+    LOG(ERROR) << "Exceeded the maximum number of write errors "
+               << multi_threaded_writer_->max_num_write_errors_ << ", stopping the test.";
+    multi_threaded_writer_->Stop();
+  }
+}
+
+void YBBulkSingleThreadedWriter::RowFailed(const client::YBqlWriteOp& op, const Status& status) {
+  // It means that key was actually written successfully, but our retry failed because
+  // it was detected as duplicate request.
+  if (status.IsAlreadyPresent()) {
+    return;
+  }
+  LOG(WARNING) << "Error inserting " << op.ToString() << ": " << status;
+  std::lock_guard<std::mutex> lock(failed_ops_mutex_);
+  failed_ops_.insert(&op);
+}
+
+void YBBulkSingleThreadedWriter::CloseSession() {
+  FlushBulkWriter();
+  bulk_writer_.reset();
+}
+
 void MultiThreadedWriter::RunStatsThread() {
   MicrosecondsInt64 prev_time = GetMonoTimeMicros();
   int64_t prev_writes = 0;
@@ -21,6 +21,8 @@
 #include <random>
 #include <set>
 #include <string>
+#include <unordered_set>
+#include <vector>
 
 #include "yb/client/client_fwd.h"
 #include "yb/gutil/stl_util.h"
@@ -81,6 +83,19 @@ class YBSessionFactory : public SessionFactory {
   yb::client::TableHandle* table_;
 };
 
+// Writes keys through YBBulkWriter, reads are the same as for YBSessionFactory.
+class YBBulkSessionFactory : public YBSessionFactory {
+ public:
+  YBBulkSessionFactory(
+      yb::client::YBClient* client, yb::client::TableHandle* table, size_t batch_size)
+      : YBSessionFactory(client, table), batch_size_(batch_size) {}
+
+  SingleThreadedWriter* GetWriter(MultiThreadedWriter* writer, int idx) override;
+
+ private:
+  const size_t batch_size_;
+};
+
 class NoopSessionFactory : public YBSessionFactory {
  public:
   NoopSessionFactory(yb::client::YBClient* client, yb::client::TableHandle* table)
@@ -183,6 +198,7 @@ class MultiThreadedWriter : public MultiThreadedAction {
   friend class SingleThreadedWriter;
   friend class RedisSingleThreadedWriter;
   friend class YBSingleThreadedWriter;
+  friend class YBBulkSingleThreadedWriter;
 
   virtual void RunActionThread(int writerIndex) override;
   virtual void RunStatsThread() override;
@@ -218,6 +234,9 @@ class SingleThreadedWriter {
   virtual void ConfigureSession() = 0;
   virtual void CloseSession() = 0;
 
+  // Invoked when Write succeeded.
+  virtual void Inserted(int64_t key_index);
+
   // Returns true if the calling writer thread should stop.
   virtual void HandleInsertionFailure(int64_t key_index, const string& key_str) = 0;
 
@@ -243,6 +262,34 @@ class YBSingleThreadedWriter : public SingleThreadedWriter {
   virtual void HandleInsertionFailure(int64_t key_index, const string& key_str) override;
 };
 
+// Keys are sent in batches of rows of the same tablet and become known to readers only after the
+// flush of the bulk writer.
+class YBBulkSingleThreadedWriter : public YBSingleThreadedWriter {
+ public:
+  YBBulkSingleThreadedWriter(
+      MultiThreadedWriter* writer, client::YBClient* client, client::TableHandle* table,
+      int writer_index, size_t batch_size);
+  ~YBBulkSingleThreadedWriter();
+
+ private:
+  virtual bool Write(int64_t key_index, const string& key_str, const string& value_str) override;
+  virtual void ConfigureSession() override;
+  virtual void CloseSession() override;
+  virtual void Inserted(int64_t key_index) override {}
+  virtual void HandleInsertionFailure(int64_t key_index, const string& key_str) override {}
+
+  void FlushBulkWriter();
+  void RowFailed(const client::YBqlWriteOp& op, const Status& status);
+
+  const size_t batch_size_;
+  size_t flush_interval_ = 0;
+  std::unique_ptr<client::YBBulkWriter> bulk_writer_;
+  // Keys written since the last flush, accessed only by the writer thread.
+  std::vector<std::pair<client::YBqlWriteOpPtr, int64_t>> pending_keys_;
+  std::mutex failed_ops_mutex_;
+  std::unordered_set<const client::YBqlWriteOp*> failed_ops_;
+};
+
 class NoopSingleThreadedWriter : public YBSingleThreadedWriter {
  public:
   NoopSingleThreadedWriter(
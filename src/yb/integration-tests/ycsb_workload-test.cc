@@ -0,0 +1,101 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/integration-tests/ycsb_workload.h"
+
+#include <rapidjson/document.h>
+
+#include "yb/util/test_macros.h"
+#include "yb/util/test_util.h"
+
+using namespace std::literals;
+
+namespace yb {
+namespace load_generator {
+
+TEST(YcsbWorkloadTest, Presets) {
+  YcsbWorkloadOptions options;
+  ASSERT_OK(options.ApplyPreset("A"));
+  ASSERT_EQ(0.5, options.proportions[to_underlying(YcsbOperation::kUpdate)]);
+  ASSERT_OK(options.ApplyPreset("d"));
+  ASSERT_EQ(KeyDistribution::kLatest, options.distribution);
+  ASSERT_EQ(0, options.proportions[to_underlying(YcsbOperation::kUpdate)]);
+  ASSERT_EQ(0.05, options.proportions[to_underlying(YcsbOperation::kInsert)]);
+  ASSERT_NOK(options.ApplyPreset("g"));
+
+  ASSERT_EQ(KeyDistribution::kHotspot, ASSERT_RESULT(ParseKeyDistribution("hotspot")));
+  ASSERT_NOK(ParseKeyDistribution("normal"));
+}
+
+TEST(YcsbWorkloadTest, Zipfian) {
+  constexpr int64_t kNumItems = 1000;
+  constexpr int kNumSamples = 100000;
+  ZipfianGenerator generator(kNumItems);
+  std::mt19937_64 rng(123456);
+  std::vector<int> counts(kNumItems);
+  for (int i = 0; i != kNumSamples; ++i) {
+    auto rank = generator.Next(&rng);
+    ASSERT_GE(rank, 0);
+    ASSERT_LT(rank, kNumItems);
+    ++counts[rank];
+  }
+  // With the default constant, the most popular item gets more than 10% of requests for 1000
+  // items, and popularity decreases with rank.
+  ASSERT_GT(counts[0], kNumSamples / 10);
+  ASSERT_GT(counts[0], counts[1]);
+  ASSERT_GT(counts[1], counts[10]);
+  ASSERT_GT(counts[10], counts[kNumItems - 1]);
+}
+
+TEST(YcsbWorkloadTest, Hotspot) {
+  YcsbWorkloadOptions options;
+  options.distribution = KeyDistribution::kHotspot;
+  options.hotspot_data_fraction = 0.1;
+  options.hotspot_ops_fraction = 0.9;
+  auto chooser = KeyChooser::Create(options);
+  std::mt19937_64 rng(123456);
+  constexpr int kNumSamples = 10000;
+  int hot = 0;
+  for (int i = 0; i != kNumSamples; ++i) {
+    auto key_index = chooser->Next(999, &rng);
+    ASSERT_GE(key_index, 0);
+    ASSERT_LE(key_index, 999);
+    hot += key_index < 100;
+  }
+  ASSERT_GT(hot, kNumSamples * 0.85);
+  ASSERT_LT(hot, kNumSamples * 0.95);
+}
+
+TEST(YcsbWorkloadTest, StatsJson) {
+  YcsbStats stats;
+  for (int i = 1; i <= 100; ++i) {
+    stats.Record(YcsbOperation::kRead, MonoDelta::FromMicroseconds(i * 10));
+  }
+  stats.RecordError(YcsbOperation::kUpdate);
+  ASSERT_EQ(100, stats.TotalCount());
+
+  auto json = stats.ToJson(MonoDelta::FromSeconds(2));
+  rapidjson::Document document;
+  document.Parse<0>(json.c_str());
+  ASSERT_FALSE(document.HasParseError()) << json;
+  ASSERT_DOUBLE_EQ(50, document["throughput_ops_per_sec"].GetDouble());
+  const auto& operations = document["operations"];
+  ASSERT_FALSE(operations.HasMember("Scan"));
+  ASSERT_EQ(100, operations["Read"]["count"].GetUint64());
+  ASSERT_NEAR(500, operations["Read"]["p50_us"].GetUint64(), 1);
+  ASSERT_NEAR(1000, operations["Read"]["max_us"].GetUint64(), 1);
+  ASSERT_EQ(1, operations["Update"]["errors"].GetInt64());
+}
+
+} // namespace load_generator
+} // namespace yb
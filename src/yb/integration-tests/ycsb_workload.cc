@@ -0,0 +1,560 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/integration-tests/ycsb_workload.h"
+
+#include <cmath>
+#include <set>
+#include <sstream>
+#include <thread>
+
+#include <boost/algorithm/string/case_conv.hpp>
+#include <boost/algorithm/string/predicate.hpp>
+
+#include "yb/client/client.h"
+#include "yb/client/table_handle.h"
+#include "yb/client/transaction.h"
+#include "yb/client/yb_op.h"
+
+#include "yb/common/partition.h"
+#include "yb/common/ql_rowblock.h"
+
+#include "yb/util/format.h"
+#include "yb/util/jsonwriter.h"
+#include "yb/util/logging.h"
+#include "yb/util/random_util.h"
+
+using namespace std::literals;
+
+namespace yb {
+namespace load_generator {
+
+namespace {
+
+// Latencies above it are recorded as it.
+constexpr int64_t kMaxLatencyUs = 60 * 1000 * 1000;
+constexpr int kLatencySignificantDigits = 3;
+
+const std::pair<const char*, double> kPercentiles[] = {
+    {"p50_us", 50}, {"p90_us", 90}, {"p99_us", 99}, {"p999_us", 99.9}, {"p9999_us", 99.99}};
+
+uint64_t FnvHash64(uint64_t value) {
+  constexpr uint64_t kFnvOffsetBasis = 0xcbf29ce484222325ULL;
+  constexpr uint64_t kFnvPrime = 1099511628211ULL;
+  uint64_t result = kFnvOffsetBasis;
+  for (int i = 0; i != 8; ++i) {
+    result = (result ^ (value & 0xff)) * kFnvPrime;
+    value >>= 8;
+  }
+  return result;
+}
+
+class UniformKeyChooser : public KeyChooser {
+ public:
+  int64_t Next(int64_t max_key_index, std::mt19937_64* rng) const override {
+    return RandomUniformInt<int64_t>(0, max_key_index, rng);
+  }
+};
+
+// Popular keys are scattered over the key space, instead of being the first ones, as YCSB does.
+class ZipfianKeyChooser : public KeyChooser {
+ public:
+  explicit ZipfianKeyChooser(int64_t num_items) : generator_(num_items) {}
+
+  int64_t Next(int64_t max_key_index, std::mt19937_64* rng) const override {
+    return FnvHash64(generator_.Next(rng)) % (max_key_index + 1);
+  }
+
+ private:
+  ZipfianGenerator generator_;
+};
+
+// The most recently inserted keys are the most popular.
+class LatestKeyChooser : public KeyChooser {
+ public:
+  explicit LatestKeyChooser(int64_t num_items) : generator_(num_items) {}
+
+  int64_t Next(int64_t max_key_index, std::mt19937_64* rng) const override {
+    return std::max<int64_t>(max_key_index - generator_.Next(rng), 0);
+  }
+
+ private:
+  ZipfianGenerator generator_;
+};
+
+class HotspotKeyChooser : public KeyChooser {
+ public:
+  HotspotKeyChooser(double data_fraction, double ops_fraction)
+      : data_fraction_(data_fraction), ops_fraction_(ops_fraction) {}
+
+  int64_t Next(int64_t max_key_index, std::mt19937_64* rng) const override {
+    const int64_t num_hot_keys = std::max<int64_t>((max_key_index + 1) * data_fraction_, 1);
+    if (num_hot_keys > max_key_index || RandomActWithProbability(ops_fraction_, rng)) {
+      return RandomUniformInt<int64_t>(0, std::min(num_hot_keys - 1, max_key_index), rng);
+    }
+    return RandomUniformInt<int64_t>(num_hot_keys, max_key_index, rng);
+  }
+
+ private:
+  const double data_fraction_;
+  const double ops_fraction_;
+};
+
+Status CheckResponse(const client::YBqlOp& op) {
+  if (op.response().status() != QLResponsePB::YQL_STATUS_OK) {
+    return STATUS_FORMAT(RuntimeError, "Error for $0: $1", op, op.response().error_message());
+  }
+  return Status::OK();
+}
+
+} // namespace
+
+Result<KeyDistribution> ParseKeyDistribution(const std::string& name) {
+  for (auto distribution : {KeyDistribution::kUniform, KeyDistribution::kZipfian,
+                            KeyDistribution::kLatest, KeyDistribution::kHotspot}) {
+    // Names are accepted without the k prefix, in any case.
+    if (boost::iequals(name, ToCString(distribution) + 1)) {
+      return distribution;
+    }
+  }
+  return STATUS_FORMAT(InvalidArgument, "Unknown key distribution: $0", name);
+}
+
+Status YcsbWorkloadOptions::ApplyPreset(const std::string& workload) {
+  proportions.fill(0);
+  auto set = [this](YcsbOperation op, double proportion) {
+    proportions[to_underlying(op)] = proportion;
+  };
+  distribution = KeyDistribution::kZipfian;
+  const std::string name = boost::to_lower_copy(workload);
+  if (name == "a") {
+    // Update heavy.
+    set(YcsbOperation::kRead, 0.5);
+    set(YcsbOperation::kUpdate, 0.5);
+  } else if (name == "b") {
+    // Read mostly.
+    set(YcsbOperation::kRead, 0.95);
+    set(YcsbOperation::kUpdate, 0.05);
+  } else if (name == "c") {
+    // Read only.
+    set(YcsbOperation::kRead, 1);
+  } else if (name == "d") {
+    // Read latest.
+    set(YcsbOperation::kRead, 0.95);
+    set(YcsbOperation::kInsert, 0.05);
+    distribution = KeyDistribution::kLatest;
+  } else if (name == "e") {
+    // Short ranges.
+    set(YcsbOperation::kScan, 0.95);
+    set(YcsbOperation::kInsert, 0.05);
+  } else if (name == "f") {
+    // Read-modify-write.
+    set(YcsbOperation::kRead, 0.5);
+    set(YcsbOperation::kReadModifyWrite, 0.5);
+  } else {
+    return STATUS_FORMAT(InvalidArgument, "Unknown YCSB workload: $0", workload);
+  }
+  return Status::OK();
+}
+
+std::unique_ptr<KeyChooser> KeyChooser::Create(const YcsbWorkloadOptions& options) {
+  const int64_t num_items = std::max<int64_t>(options.record_count, 1);
+  switch (options.distribution) {
+    case KeyDistribution::kUniform:
+      return std::make_unique<UniformKeyChooser>();
+    case KeyDistribution::kZipfian:
+      return std::make_unique<ZipfianKeyChooser>(num_items);
+    case KeyDistribution::kLatest:
+      return std::make_unique<LatestKeyChooser>(num_items);
+    case KeyDistribution::kHotspot:
+      return std::make_unique<HotspotKeyChooser>(
+          options.hotspot_data_fraction, options.hotspot_ops_fraction);
+  }
+  FATAL_INVALID_ENUM_VALUE(KeyDistribution, options.distribution);
+}
+
+ZipfianGenerator::ZipfianGenerator(int64_t num_items, double theta)
+    : num_items_(num_items), theta_(theta), alpha_(1.0 / (1.0 - theta)) {
+  zetan_ = 0;
+  for (int64_t i = 1; i <= num_items_; ++i) {
+    zetan_ += 1.0 / std::pow(i, theta_);
+  }
+  const double zeta2 = 1.0 + 1.0 / std::pow(2, theta_);
+  eta_ = (1.0 - std::pow(2.0 / num_items_, 1.0 - theta_)) / (1.0 - zeta2 / zetan_);
+}
+
+int64_t ZipfianGenerator::Next(std::mt19937_64* rng) const {
+  const double u = RandomUniformReal<double>(rng);
+  const double uz = u * zetan_;
+  if (uz < 1.0) {
+    return 0;
+  }
+  if (uz < 1.0 + std::pow(0.5, theta_)) {
+    return std::min<int64_t>(1, num_items_ - 1);
+  }
+  return std::min<int64_t>(num_items_ * std::pow(eta_ * u - eta_ + 1, alpha_), num_items_ - 1);
+}
+
+YcsbStats::OperationStats::OperationStats()
+    : histogram(kMaxLatencyUs, kLatencySignificantDigits) {}
+
+YcsbStats::YcsbStats() {
+  for (auto& stats : stats_) {
+    stats = std::make_unique<OperationStats>();
+  }
+}
+
+void YcsbStats::Record(YcsbOperation op, MonoDelta latency) {
+  stats_[to_underlying(op)]->histogram.Increment(
+      std::min<int64_t>(std::max<int64_t>(latency.ToMicroseconds(), 0), kMaxLatencyUs));
+}
+
+void YcsbStats::RecordError(YcsbOperation op) {
+  stats_[to_underlying(op)]->errors.fetch_add(1, std::memory_order_relaxed);
+}
+
+int64_t YcsbStats::TotalCount() const {
+  int64_t result = 0;
+  for (const auto& stats : stats_) {
+    result += stats->histogram.TotalCount();
+  }
+  return result;
+}
+
+std::string YcsbStats::ToJson(MonoDelta elapsed) const {
+  std::stringstream out;
+  JsonWriter writer(&out, JsonWriter::PRETTY);
+  writer.StartObject();
+  writer.String("elapsed_ms");
+  writer.Int64(elapsed.ToMilliseconds());
+  writer.String("throughput_ops_per_sec");
+  writer.Double(elapsed.ToSeconds() > 0 ? TotalCount() / elapsed.ToSeconds() : 0);
+  writer.String("operations");
+  writer.StartObject();
+  for (size_t i = 0; i != stats_.size(); ++i) {
+    const auto& histogram = stats_[i]->histogram;
+    const auto errors = stats_[i]->errors.load(std::memory_order_relaxed);
+    if (histogram.TotalCount() == 0 && errors == 0) {
+      continue;
+    }
+    // Skip the k prefix of the enum value name.
+    writer.String(ToCString(static_cast<YcsbOperation>(i)) + 1);
+    writer.StartObject();
+    writer.String("count");
+    writer.Uint64(histogram.TotalCount());
+    writer.String("errors");
+    writer.Int64(errors);
+    writer.String("mean_us");
+    writer.Double(histogram.MeanValue());
+    writer.String("min_us");
+    writer.Uint64(histogram.MinValue());
+    for (const auto& percentile : kPercentiles) {
+      writer.String(percentile.first);
+      writer.Uint64(histogram.ValueAtPercentile(percentile.second));
+    }
+    writer.String("max_us");
+    writer.Uint64(histogram.MaxValue());
+    writer.EndObject();
+  }
+  writer.EndObject();
+  writer.EndObject();
+  return out.str();
+}
+
+class YcsbWorkload::Worker {
+ public:
+  explicit Worker(YcsbWorkload* workload)
+      : workload_(workload), options_(workload->options_), table_(*workload->table_),
+        session_((*workload->table_)->client()->NewSession()) {
+    Seed(&rng_);
+    session_->SetTimeout(60s);
+  }
+
+  // Issues operations until stop_flag is set, the deadline passes, or the workload issued enough
+  // of them.
+  void Run(std::atomic<bool>* stop_flag, MonoTime start, MonoTime deadline) {
+    const bool open_loop = options_.target_ops_per_second > 0;
+    const auto interval = open_loop
+        ? MonoDelta::FromSeconds(options_.num_threads / options_.target_ops_per_second)
+        : MonoDelta::kZero;
+    // Spread the first operations of the threads over the interval.
+    auto intended_start = start + MonoDelta::FromNanoseconds(
+        RandomUniformInt<int64_t>(0, interval.ToNanoseconds(), &rng_));
+    while (!stop_flag->load(std::memory_order_acquire) && !workload_->IssuedEnough()) {
+      auto now = MonoTime::Now();
+      if (open_loop) {
+        if (intended_start > now) {
+          SleepFor(intended_start - now);
+        }
+      } else {
+        intended_start = now;
+      }
+      if (intended_start >= deadline) {
+        break;
+      }
+
+      const auto op = workload_->NextOperation(&rng_);
+      auto status = Execute(op);
+      if (status.ok()) {
+        workload_->stats_.Record(op, MonoTime::Now() - intended_start);
+      } else {
+        workload_->stats_.RecordError(op);
+        YB_LOG_EVERY_N_SECS(WARNING, 10) << op << " failed: " << status;
+      }
+      intended_start += interval;
+    }
+  }
+
+  CHECKED_STATUS Write(int64_t key_index) {
+    auto op = NewWriteOp(key_index);
+    RETURN_NOT_OK(session_->ApplyAndFlush(op));
+    return CheckResponse(*op);
+  }
+
+ private:
+  CHECKED_STATUS Execute(YcsbOperation op) {
+    switch (op) {
+      case YcsbOperation::kRead:
+        return Read(ChooseKey());
+      case YcsbOperation::kUpdate:
+        return Write(ChooseKey());
+      case YcsbOperation::kInsert:
+        return Insert();
+      case YcsbOperation::kScan:
+        return Scan(ChooseKey(), RandomUniformInt<size_t>(1, options_.max_scan_length, &rng_));
+      case YcsbOperation::kReadModifyWrite: {
+        const auto key_index = ChooseKey();
+        RETURN_NOT_OK(Read(key_index));
+        return Write(key_index);
+      }
+      case YcsbOperation::kMultiKeyUpdate:
+        return MultiKeyUpdate();
+    }
+    FATAL_INVALID_ENUM_VALUE(YcsbOperation, op);
+  }
+
+  int64_t ChooseKey() {
+    return workload_->key_chooser_->Next(
+        workload_->max_key_index_.load(std::memory_order_acquire), &rng_);
+  }
+
+  client::YBqlWriteOpPtr NewWriteOp(int64_t key_index) {
+    auto op = table_.NewInsertOp();
+    QLAddStringHashValue(op->mutable_request(), KeyByIndex(key_index));
+    table_.AddStringColumnValue(
+        op->mutable_request(), "v", RandomHumanReadableString(options_.value_size, &rng_));
+    return op;
+  }
+
+  CHECKED_STATUS Read(int64_t key_index) {
+    auto op = table_.NewReadOp();
+    QLAddStringHashValue(op->mutable_request(), KeyByIndex(key_index));
+    table_.AddColumns({"v"}, op->mutable_request());
+    RETURN_NOT_OK(session_->ApplyAndFlush(op));
+    RETURN_NOT_OK(CheckResponse(*op));
+    auto rows = VERIFY_RESULT(op->MakeRowBlock());
+    if (rows.row_count() != 1) {
+      return STATUS_FORMAT(NotFound, "Read $0 rows for key #$1", rows.row_count(), key_index);
+    }
+    return Status::OK();
+  }
+
+  CHECKED_STATUS Insert() {
+    const auto key_index = workload_->next_key_index_.fetch_add(1, std::memory_order_acq_rel);
+    RETURN_NOT_OK(Write(key_index));
+    // Keys that are still being inserted by other threads could be chosen after that, and reading
+    // them fails, but it is rare enough to not track inserted keys precisely.
+    auto max_key_index = workload_->max_key_index_.load(std::memory_order_acquire);
+    while (max_key_index < key_index &&
+           !workload_->max_key_index_.compare_exchange_weak(max_key_index, key_index)) {}
+    return Status::OK();
+  }
+
+  // Keys are hash partitioned, so the scan reads the rows that follow the key in the hash order
+  // within its tablet. It is not a scan of adjacent keys, but it reads the same number of rows per
+  // operation.
+  CHECKED_STATUS Scan(int64_t key_index, size_t length) {
+    auto op = table_.NewReadOp();
+    auto* req = op->mutable_request();
+    QLAddStringHashValue(req, KeyByIndex(key_index));
+    std::string partition_key;
+    RETURN_NOT_OK(table_->partition_schema().EncodeKey(
+        req->hashed_column_values(), &partition_key));
+    req->clear_hashed_column_values();
+    req->set_hash_code(PartitionSchema::DecodeMultiColumnHashValue(partition_key));
+    req->set_limit(length);
+    table_.AddColumns({"k", "v"}, req);
+    RETURN_NOT_OK(session_->ApplyAndFlush(op));
+    RETURN_NOT_OK(CheckResponse(*op));
+    return op->MakeRowBlock().status();
+  }
+
+  CHECKED_STATUS MultiKeyUpdate() {
+    std::set<int64_t> key_indexes;
+    while (key_indexes.size() < options_.multi_key_update_size &&
+           static_cast<int64_t>(key_indexes.size()) <=
+               workload_->max_key_index_.load(std::memory_order_acquire)) {
+      key_indexes.insert(ChooseKey());
+    }
+
+    auto txn = std::make_shared<client::YBTransaction>(workload_->txn_manager_);
+    RETURN_NOT_OK(txn->Init(IsolationLevel::SNAPSHOT_ISOLATION));
+    session_->SetTransaction(txn);
+    std::vector<client::YBqlWriteOpPtr> ops;
+    Status status;
+    for (auto key_index : key_indexes) {
+      ops.push_back(NewWriteOp(key_index));
+      status = session_->Apply(ops.back());
+      if (!status.ok()) {
+        break;
+      }
+    }
+    if (status.ok()) {
+      status = session_->Flush();
+    }
+    session_->SetTransaction(nullptr);
+    for (auto it = ops.begin(); status.ok() && it != ops.end(); ++it) {
+      status = CheckResponse(**it);
+    }
+    if (!status.ok()) {
+      txn->Abort();
+      return status;
+    }
+    return txn->CommitFuture().get();
+  }
+
+  YcsbWorkload* const workload_;
+  const YcsbWorkloadOptions& options_;
+  const client::TableHandle& table_;
+  std::shared_ptr<client::YBSession> session_;
+  std::mt19937_64 rng_;
+};
+
+YcsbWorkload::YcsbWorkload(const YcsbWorkloadOptions& options, client::TableHandle* table,
+                           client::TransactionManager* txn_manager)
+    : options_(options), table_(table), txn_manager_(txn_manager),
+      next_key_index_(options.record_count), max_key_index_(options.record_count - 1),
+      key_chooser_(KeyChooser::Create(options)) {
+}
+
+YcsbWorkload::~YcsbWorkload() {
+}
+
+std::string YcsbWorkload::KeyByIndex(int64_t key_index) {
+  return Format("user$0", key_index);
+}
+
+Status YcsbWorkload::Validate() const {
+  if (options_.record_count <= 0) {
+    return STATUS(InvalidArgument, "YCSB workload requires a positive record count");
+  }
+  if (options_.num_threads <= 0) {
+    return STATUS(InvalidArgument, "YCSB workload requires a positive number of threads");
+  }
+  double total = 0;
+  for (auto proportion : options_.proportions) {
+    if (proportion < 0) {
+      return STATUS(InvalidArgument, "Negative proportion of an operation");
+    }
+    total += proportion;
+  }
+  if (total <= 0) {
+    return STATUS(InvalidArgument, "No operations in the YCSB workload");
+  }
+  if (options_.proportions[to_underlying(YcsbOperation::kMultiKeyUpdate)] > 0 &&
+      !txn_manager_) {
+    return STATUS(InvalidArgument, "Multi-key updates require a transactional table");
+  }
+  return Status::OK();
+}
+
+YcsbOperation YcsbWorkload::NextOperation(std::mt19937_64* rng) const {
+  double total = 0;
+  for (auto proportion : options_.proportions) {
+    total += proportion;
+  }
+  double value = RandomUniformReal<double>(0, total, rng);
+  for (size_t i = 0; i != options_.proportions.size(); ++i) {
+    value -= options_.proportions[i];
+    if (value < 0) {
+      return static_cast<YcsbOperation>(i);
+    }
+  }
+  // Could happen because of rounding errors.
+  for (size_t i = options_.proportions.size(); i-- > 0;) {
+    if (options_.proportions[i] > 0) {
+      return static_cast<YcsbOperation>(i);
+    }
+  }
+  return YcsbOperation::kRead;
+}
+
+bool YcsbWorkload::IssuedEnough() {
+  return options_.num_operations > 0 &&
+         num_issued_.fetch_add(1, std::memory_order_acq_rel) >= options_.num_operations;
+}
+
+Status YcsbWorkload::Load() {
+  RETURN_NOT_OK(Validate());
+  LOG(INFO) << "Loading " << options_.record_count << " keys";
+  std::atomic<int64_t> next_key_index(0);
+  std::atomic<int64_t> num_errors(0);
+  std::vector<std::thread> threads;
+  for (int i = 0; i != options_.num_threads; ++i) {
+    threads.emplace_back([this, &next_key_index, &num_errors] {
+      Worker worker(this);
+      for (;;) {
+        const auto key_index = next_key_index.fetch_add(1, std::memory_order_acq_rel);
+        if (key_index >= options_.record_count) {
+          break;
+        }
+        auto status = worker.Write(key_index);
+        if (!status.ok()) {
+          num_errors.fetch_add(1, std::memory_order_relaxed);
+          YB_LOG_EVERY_N_SECS(WARNING, 10) << "Failed to load key #" << key_index << ": "
+                                            << status;
+        }
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  if (num_errors.load() != 0) {
+    return STATUS_FORMAT(IOError, "Failed to load $0 keys", num_errors.load());
+  }
+  return Status::OK();
+}
+
+Status YcsbWorkload::Run(std::atomic<bool>* stop_flag) {
+  RETURN_NOT_OK(Validate());
+  LOG(INFO) << "Running YCSB workload with " << options_.num_threads << " threads"
+            << (options_.target_ops_per_second > 0
+                    ? Format(" at $0 ops/sec", options_.target_ops_per_second) : "");
+  const auto start = MonoTime::Now();
+  const auto deadline = start + options_.duration;
+  std::vector<std::thread> threads;
+  for (int i = 0; i != options_.num_threads; ++i) {
+    threads.emplace_back([this, stop_flag, start, deadline] {
+      Worker(this).Run(stop_flag, start, deadline);
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  elapsed_ = MonoTime::Now() - start;
+  return Status::OK();
+}
+
+}  // namespace load_generator
+}  // namespace yb
@@ -0,0 +1,174 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#ifndef YB_INTEGRATION_TESTS_YCSB_WORKLOAD_H
+#define YB_INTEGRATION_TESTS_YCSB_WORKLOAD_H
+
+#include <array>
+#include <atomic>
+#include <memory>
+#include <random>
+#include <string>
+
+#include "yb/client/client_fwd.h"
+#include "yb/util/enums.h"
+#include "yb/util/hdr_histogram.h"
+#include "yb/util/monotime.h"
+#include "yb/util/result.h"
+
+namespace yb {
+namespace load_generator {
+
+YB_DEFINE_ENUM(YcsbOperation, (kRead)(kUpdate)(kInsert)(kScan)(kReadModifyWrite)(kMultiKeyUpdate));
+YB_DEFINE_ENUM(KeyDistribution, (kUniform)(kZipfian)(kLatest)(kHotspot));
+
+Result<KeyDistribution> ParseKeyDistribution(const std::string& name);
+
+struct YcsbWorkloadOptions {
+  // Share of each operation in the mix, they do not have to add up to 1.
+  std::array<double, kElementsInYcsbOperation> proportions = {};
+  KeyDistribution distribution = KeyDistribution::kZipfian;
+
+  // Number of keys loaded before the workload starts, inserts add keys after them.
+  int64_t record_count = 0;
+  size_t value_size = 100;
+
+  // Scan lengths are uniformly distributed in [1, max_scan_length].
+  size_t max_scan_length = 100;
+  // Number of keys updated by a single transaction of a multi-key update.
+  size_t multi_key_update_size = 4;
+
+  // Share of keys that are hot and share of operations that go to them, for kHotspot.
+  double hotspot_data_fraction = 0.2;
+  double hotspot_ops_fraction = 0.8;
+
+  int num_threads = 16;
+  // When positive operations are issued open loop at this total rate, and their latency is counted
+  // from the time they were scheduled to start, so a stall is not hidden by operations that were
+  // not issued during it (coordinated omission). Otherwise each thread issues its next operation
+  // as soon as the previous one completes.
+  double target_ops_per_second = 0;
+
+  // The workload stops after this number of operations or this time, whichever comes first.
+  int64_t num_operations = 0;
+  MonoDelta duration = MonoDelta::FromSeconds(60);
+
+  // Fills the proportions and the distribution of one of the YCSB core workloads A-F.
+  CHECKED_STATUS ApplyPreset(const std::string& workload);
+};
+
+// Picks indexes of keys to operate on, thread safe.
+class KeyChooser {
+ public:
+  virtual ~KeyChooser() {}
+
+  // Returns an index in [0, max_key_index], where max_key_index is the largest inserted key.
+  virtual int64_t Next(int64_t max_key_index, std::mt19937_64* rng) const = 0;
+
+  static std::unique_ptr<KeyChooser> Create(const YcsbWorkloadOptions& options);
+};
+
+// Generates ranks in [0, num_items) with the zipfian distribution, where rank 0 is the most
+// popular, using the algorithm from "Quickly Generating Billion-Record Synthetic Databases" by
+// Gray et al., like YCSB.
+class ZipfianGenerator {
+ public:
+  static constexpr double kDefaultZipfianConstant = 0.99;
+
+  explicit ZipfianGenerator(int64_t num_items, double theta = kDefaultZipfianConstant);
+
+  int64_t Next(std::mt19937_64* rng) const;
+
+ private:
+  const int64_t num_items_;
+  const double theta_;
+  const double alpha_;
+  double zetan_;
+  double eta_;
+};
+
+// Latencies of the operations of a workload in microseconds.
+class YcsbStats {
+ public:
+  YcsbStats();
+
+  void Record(YcsbOperation op, MonoDelta latency);
+  void RecordError(YcsbOperation op);
+
+  int64_t TotalCount() const;
+
+  // Count, errors, mean and percentiles of each operation type that was issued.
+  std::string ToJson(MonoDelta elapsed) const;
+
+ private:
+  struct OperationStats {
+    OperationStats();
+
+    HdrHistogram histogram;
+    std::atomic<int64_t> errors{0};
+  };
+
+  std::array<std::unique_ptr<OperationStats>, kElementsInYcsbOperation> stats_;
+};
+
+// Runs a YCSB-style workload against a table with a binary hash key "k" and a binary value "v",
+// as created by yb_load_test_tool.
+class YcsbWorkload {
+ public:
+  // txn_manager is only required for multi-key updates, which are transactional.
+  YcsbWorkload(const YcsbWorkloadOptions& options, client::TableHandle* table,
+               client::TransactionManager* txn_manager);
+  ~YcsbWorkload();
+
+  // Inserts record_count keys, so the workload has data to operate on.
+  CHECKED_STATUS Load();
+
+  // Runs the workload until it completes or stop_flag is set.
+  CHECKED_STATUS Run(std::atomic<bool>* stop_flag);
+
+  const YcsbStats& stats() const { return stats_; }
+  MonoDelta elapsed() const { return elapsed_; }
+
+  static std::string KeyByIndex(int64_t key_index);
+
+ private:
+  class Worker;
+
+  CHECKED_STATUS Validate() const;
+
+  // Picks the next operation type according to the proportions.
+  YcsbOperation NextOperation(std::mt19937_64* rng) const;
+
+  // Returns true when num_operations operations were issued, counting this call as an operation.
+  bool IssuedEnough();
+
+  const YcsbWorkloadOptions options_;
+  client::TableHandle* const table_;
+  client::TransactionManager* const txn_manager_;
+
+  // Next key index to insert, keys below it are either inserted or being inserted.
+  std::atomic<int64_t> next_key_index_;
+  // Largest inserted key index, keys are chosen up to it.
+  std::atomic<int64_t> max_key_index_;
+  std::atomic<int64_t> num_issued_{0};
+
+  std::unique_ptr<KeyChooser> key_chooser_;
+
+  YcsbStats stats_;
+  MonoDelta elapsed_;
+};
+
+}  // namespace load_generator
+}  // namespace yb
+
+#endif  // YB_INTEGRATION_TESTS_YCSB_WORKLOAD_H
@@ -375,6 +375,30 @@ void RetryingTSRpcTask::TransitionToTerminalState(MonitoredTaskState expected,
 // ============================================================================
 //  Class AsyncCreateReplica.
 // ============================================================================
+namespace {
+
+void FillCreateTabletRequest(const string& permanent_uuid,
+                             const scoped_refptr<TabletInfo>& tablet,
+                             tserver::CreateTabletRequestPB* req) {
+  auto table_lock = tablet->table()->LockForRead();
+  const SysTabletsEntryPB& tablet_pb = tablet->metadata().dirty().pb;
+
+  req->set_dest_uuid(permanent_uuid);
+  req->set_table_id(tablet->table()->id());
+  req->set_tablet_id(tablet->tablet_id());
+  req->set_table_type(tablet->table()->metadata().state().pb.table_type());
+  req->mutable_partition()->CopyFrom(tablet_pb.partition());
+  req->set_table_name(table_lock->data().pb.name());
+  req->mutable_schema()->CopyFrom(table_lock->data().pb.schema());
+  req->mutable_partition_schema()->CopyFrom(table_lock->data().pb.partition_schema());
+  req->mutable_config()->CopyFrom(tablet_pb.committed_consensus_state().config());
+  if (table_lock->data().pb.has_index_info()) {
+    req->mutable_index_info()->CopyFrom(table_lock->data().pb.index_info());
+  }
+}
+
+} // namespace
+
 AsyncCreateReplica::AsyncCreateReplica(Master *master,
                                        ThreadPool *callback_pool,
                                        const string& permanent_uuid,
@@ -384,21 +408,7 @@ AsyncCreateReplica::AsyncCreateReplica(Master *master,
   deadline_ = start_ts_;
   deadline_.AddDelta(MonoDelta::FromMilliseconds(FLAGS_tablet_creation_timeout_ms));
 
-  auto table_lock = tablet->table()->LockForRead();
-  const SysTabletsEntryPB& tablet_pb = tablet->metadata().dirty().pb;
-
-  req_.set_dest_uuid(permanent_uuid);
-  req_.set_table_id(tablet->table()->id());
-  req_.set_tablet_id(tablet->tablet_id());
-  req_.set_table_type(tablet->table()->metadata().state().pb.table_type());
-  req_.mutable_partition()->CopyFrom(tablet_pb.partition());
-  req_.set_table_name(table_lock->data().pb.name());
-  req_.mutable_schema()->CopyFrom(table_lock->data().pb.schema());
-  req_.mutable_partition_schema()->CopyFrom(table_lock->data().pb.partition_schema());
-  req_.mutable_config()->CopyFrom(tablet_pb.committed_consensus_state().config());
-  if (table_lock->data().pb.has_index_info()) {
-    req_.mutable_index_info()->CopyFrom(table_lock->data().pb.index_info());
-  }
+  FillCreateTabletRequest(permanent_uuid, tablet, &req_);
 }
 
 void AsyncCreateReplica::HandleResponse(int attempt) {
@@ -426,6 +436,73 @@ bool AsyncCreateReplica::SendRequest(int attempt) {
   return true;
 }
 
+// ============================================================================
+//  Class AsyncCreateReplicas.
+// ============================================================================
+AsyncCreateReplicas::AsyncCreateReplicas(Master *master,
+                                         ThreadPool *callback_pool,
+                                         const string& permanent_uuid,
+                                         const scoped_refptr<TableInfo>& table,
+                                         const std::vector<scoped_refptr<TabletInfo>>& tablets)
+  : RetrySpecificTSRpcTask(master, callback_pool, permanent_uuid, table) {
+  deadline_ = start_ts_;
+  deadline_.AddDelta(MonoDelta::FromMilliseconds(FLAGS_tablet_creation_timeout_ms));
+
+  req_.set_dest_uuid(permanent_uuid);
+  for (const auto& tablet : tablets) {
+    FillCreateTabletRequest(permanent_uuid, tablet, req_.add_tablets());
+  }
+}
+
+string AsyncCreateReplicas::description() const {
+  return Format("CreateTablets RPC for $0 tablets of table $1 on TS $2",
+                req_.tablets_size(), table_->ToString(), permanent_uuid_);
+}
+
+void AsyncCreateReplicas::HandleResponse(int attempt) {
+  if (resp_.has_error()) {
+    LOG(WARNING) << description() << " failed: " << StatusFromPB(resp_.error().status());
+    return;
+  }
+
+  // Keep the requests of the tablets that failed, to retry them.
+  tserver::CreateTabletsRequestPB failed;
+  for (int i = 0; i < req_.tablets_size(); ++i) {
+    const auto& tablet_req = req_.tablets(i);
+    // A tablet without a result in the response is retried as well.
+    if (i < resp_.tablets_size()) {
+      if (!resp_.tablets(i).has_error()) {
+        continue;
+      }
+      Status s = StatusFromPB(resp_.tablets(i).error().status());
+      if (s.IsAlreadyPresent()) {
+        LOG(INFO) << "CreateTablet for tablet " << tablet_req.tablet_id()
+                  << " on TS " << permanent_uuid_ << " returned already present: " << s;
+        continue;
+      }
+      LOG(WARNING) << "CreateTablet for tablet " << tablet_req.tablet_id()
+                   << " on TS " << permanent_uuid_ << " failed: " << s;
+    }
+    *failed.add_tablets() = tablet_req;
+  }
+
+  if (failed.tablets_size() == 0) {
+    TransitionToTerminalState(MonitoredTaskState::kRunning, MonitoredTaskState::kComplete);
+    return;
+  }
+  failed.set_dest_uuid(req_.dest_uuid());
+  req_.Swap(&failed);
+}
+
+bool AsyncCreateReplicas::SendRequest(int attempt) {
+  resp_.Clear();
+  ts_admin_proxy_->CreateTabletsAsync(req_, &resp_, &rpc_, BindRpcCallback());
+  VLOG(1) << "Send create tablets request to " << permanent_uuid_ << ":\n"
+          << " (attempt " << attempt << "):\n"
+          << req_.DebugString();
+  return true;
+}
+
 // ============================================================================
 //  Class AsyncDeleteReplica.
 // ============================================================================
@@ -679,6 +756,82 @@ bool AsyncTruncate::SendRequest(int attempt) {
   return true;
 }
 
+// ============================================================================
+//  Class AsyncBackfillTabletIndex.
+// ============================================================================
+AsyncBackfillTabletIndex::AsyncBackfillTabletIndex(Master *master,
+                                                   ThreadPool* callback_pool,
+                                                   const scoped_refptr<TabletInfo>& tablet,
+                                                   const scoped_refptr<TableInfo>& index_table,
+                                                   HybridTime read_time)
+    : RetryingTSRpcTask(master,
+                        callback_pool,
+                        gscoped_ptr<TSPicker>(new PickLeaderReplica(tablet)),
+                        index_table),
+      tablet_(tablet),
+      read_time_(read_time) {
+  // The backfill of a large tablet takes many RPCs.
+  deadline_ = MonoTime::Max();
+}
+
+string AsyncBackfillTabletIndex::description() const {
+  return Format("$0 Backfill Index $1 RPC, $2 rows done",
+                tablet_->ToString(), table_->id(), num_rows_);
+}
+
+TabletId AsyncBackfillTabletIndex::tablet_id() const {
+  return tablet_->tablet_id();
+}
+
+TabletServerId AsyncBackfillTabletIndex::permanent_uuid() const {
+  return target_ts_desc_ != nullptr ? target_ts_desc_->permanent_uuid() : "";
+}
+
+void AsyncBackfillTabletIndex::HandleResponse(int attempt) {
+  server::UpdateClock(resp_, master_->clock());
+
+  num_rows_ += resp_.num_rows();
+  if (resp_.has_error()) {
+    const Status s = StatusFromPB(resp_.error().status());
+    const TabletServerErrorPB::Code code = resp_.error().code();
+    LOG(WARNING) << "TS " << permanent_uuid() << ": backfill of index " << table_->id()
+                 << " failed for tablet " << tablet_id() << " with error code "
+                 << TabletServerErrorPB::Code_Name(code) << ": " << s.ToString();
+    if (code == TabletServerErrorPB::TABLET_NOT_FOUND) {
+      TransitionToTerminalState(MonitoredTaskState::kRunning, MonitoredTaskState::kFailed);
+    }
+    return;
+  }
+
+  if (resp_.next_key().empty()) {
+    LOG(INFO) << "TS " << permanent_uuid() << ": backfill of index " << table_->id()
+              << " complete on tablet " << tablet_id() << ", " << num_rows_ << " rows";
+    TransitionToTerminalState(MonitoredTaskState::kRunning, MonitoredTaskState::kComplete);
+    return;
+  }
+
+  // Continues with the next chunk. The retry limit applies to the consecutive failures of a chunk,
+  // not to the number of chunks.
+  LOG(INFO) << "TS " << permanent_uuid() << ": backfill of index " << table_->id()
+            << " on tablet " << tablet_id() << " in progress, " << num_rows_ << " rows done";
+  start_key_ = resp_.next_key();
+  attempt_ = 0;
+}
+
+bool AsyncBackfillTabletIndex::SendRequest(int attempt) {
+  tserver::BackfillIndexRequestPB req;
+  req.set_tablet_id(tablet_id());
+  req.set_propagated_hybrid_time(master_->clock()->Now().ToUint64());
+  req.add_index_ids(table_->id());
+  req.set_read_ht(read_time_.ToUint64());
+  req.set_start_key(start_key_);
+  ts_proxy_->BackfillIndexAsync(req, &resp_, &rpc_, BindRpcCallback());
+  VLOG(1) << "Send backfill index request to " << permanent_uuid()
+          << " (attempt " << attempt << "):\n"
+          << req.DebugString();
+  return true;
+}
+
 // ============================================================================
 //  Class CommonInfoForRaftTask.
 // ============================================================================
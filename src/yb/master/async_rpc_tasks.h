@@ -28,6 +28,7 @@
 #include "yb/util/status.h"
 #include "yb/util/memory/memory.h"
 #include "yb/common/entity_ids.h"
+#include "yb/common/hybrid_time.h"
 
 #include "yb/server/monitored_task.h"
 #include "yb/rpc/rpc_controller.h"
@@ -265,6 +266,35 @@ class AsyncCreateReplica : public RetrySpecificTSRpcTask {
   tserver::CreateTabletResponsePB resp_;
 };
 
+// Fire off the async create of a batch of tablets of the table on a tablet server, with a single
+// CreateTablets RPC. The requirements are the same as for AsyncCreateReplica. On retry, only the
+// tablets that failed to be created are sent again.
+class AsyncCreateReplicas : public RetrySpecificTSRpcTask {
+ public:
+  AsyncCreateReplicas(Master *master,
+                      ThreadPool *callback_pool,
+                      const std::string& permanent_uuid,
+                      const scoped_refptr<TableInfo>& table,
+                      const std::vector<scoped_refptr<TabletInfo>>& tablets);
+
+  Type type() const override { return ASYNC_CREATE_REPLICA; }
+
+  std::string type_name() const override { return "Create Tablets"; }
+
+  std::string description() const override;
+
+ protected:
+  // The first of the tablets that are not created yet.
+  TabletId tablet_id() const override { return req_.tablets(0).tablet_id(); }
+
+  void HandleResponse(int attempt) override;
+  bool SendRequest(int attempt) override;
+
+ private:
+  tserver::CreateTabletsRequestPB req_;
+  tserver::CreateTabletsResponsePB resp_;
+};
+
 // Send a DeleteTablet() RPC request.
 class AsyncDeleteReplica : public RetrySpecificTSRpcTask {
  public:
@@ -385,6 +415,38 @@ class AsyncTruncate : public RetryingTSRpcTask {
   tserver::TruncateResponsePB resp_;
 };
 
+// Backfills new indexes of a table from one of its tablets, by sending the BackfillIndex() RPC to
+// the leader of the tablet until all rows of the tablet are done. The task is registered with the
+// index table. Each RPC continues from where the previous one stopped, at the same read time.
+class AsyncBackfillTabletIndex : public RetryingTSRpcTask {
+ public:
+  AsyncBackfillTabletIndex(Master* master,
+                           ThreadPool* callback_pool,
+                           const scoped_refptr<TabletInfo>& tablet,
+                           const scoped_refptr<TableInfo>& index_table,
+                           HybridTime read_time);
+
+  Type type() const override { return ASYNC_BACKFILL_TABLET_INDEX; }
+
+  std::string type_name() const override { return "Backfill Tablet Index"; }
+
+  std::string description() const override;
+
+ protected:
+  TabletId tablet_id() const override;
+
+  TabletServerId permanent_uuid() const;
+
+  void HandleResponse(int attempt) override;
+  bool SendRequest(int attempt) override;
+
+  const scoped_refptr<TabletInfo> tablet_;
+  const HybridTime read_time_;
+  std::string start_key_;
+  uint64_t num_rows_ = 0;
+  tserver::BackfillIndexResponsePB resp_;
+};
+
 class CommonInfoForRaftTask : public RetryingTSRpcTask {
  public:
   CommonInfoForRaftTask(
@@ -100,6 +100,41 @@ TEST(TableInfoTest, TestAssignmentRanges) {
   }
 }
 
+TEST(TabletInfoTest, TestCachedReplicas) {
+  std::shared_ptr<TSDescriptor> ts = SetupTS("0000", "a");
+  scoped_refptr<TableInfo> table(new TableInfo(CURRENT_TEST_NAME()));
+  scoped_refptr<TabletInfo> tablet(new TabletInfo(table, "tablet"));
+  TabletInfo::ReplicasPB replicas;
+  ASSERT_FALSE(tablet->GetCachedReplicas(&replicas));
+
+  ASSERT_TRUE(tablet->AddToReplicaLocations(TabletReplica{
+      ts.get(), tablet::RUNNING, consensus::RaftPeerPB::LEADER, consensus::RaftPeerPB::VOTER}));
+  TabletInfo::ReplicaMap locs;
+  uint64_t version = 0;
+  tablet->GetReplicaLocations(&locs, &version);
+  TabletInfo::ReplicasPB built;
+  built.Add()->set_role(consensus::RaftPeerPB::LEADER);
+  tablet->SetCachedReplicas(version, built, {{ts.get(), ts->latest_seqno()}});
+  ASSERT_TRUE(tablet->GetCachedReplicas(&replicas));
+  ASSERT_EQ(1, replicas.size());
+
+  // The cache is invalidated when the tablet server re-registers.
+  NodeInstancePB node;
+  node.set_permanent_uuid(ts->permanent_uuid());
+  node.set_instance_seqno(ts->latest_seqno() + 1);
+  ASSERT_OK(ts->Register(node, ts->GetRegistration(), CloudInfoPB(), nullptr));
+  ASSERT_FALSE(tablet->GetCachedReplicas(&replicas));
+  tablet->SetCachedReplicas(version, built, {{ts.get(), ts->latest_seqno()}});
+  ASSERT_TRUE(tablet->GetCachedReplicas(&replicas));
+
+  // The cache is invalidated when the replica locations change, and replicas built from the
+  // locations before the change are not cached.
+  tablet->SetReplicaLocations(locs);
+  ASSERT_FALSE(tablet->GetCachedReplicas(&replicas));
+  tablet->SetCachedReplicas(version, built, {{ts.get(), ts->latest_seqno()}});
+  ASSERT_FALSE(tablet->GetCachedReplicas(&replicas));
+}
+
 TEST(TestTSDescriptor, TestReplicaCreationsDecay) {
   TSDescriptor ts("test");
   ASSERT_EQ(0, ts.RecentReplicaCreations());
@@ -225,7 +260,7 @@ TEST(TestCatalogManager, TestLoadBalancedPerAZ) {
 }
 
 TEST(TestCatalogManager, TestLeaderLoadBalanced) {
-  // AreLeadersOnPreferredOnly should always return true.
+  // Without affinitized leaders, AreLeadersOnPreferredOnly should always return true.
   ReplicationInfoPB replication_info;
   SetupClusterConfig({"a", "b", "c"}, &replication_info);
 
@@ -258,6 +293,21 @@ TEST(TestCatalogManager, TestLeaderLoadBalanced) {
   ts1->set_leader_count(8);
   ts2->set_leader_count(8);
   ASSERT_OK(CatalogManagerUtil::AreLeadersOnPreferredOnly(ts_descs, replication_info));
+
+  // With affinitized leaders, only the tablet servers in the affinitized zones accept leaders.
+  auto* cloud_info = replication_info.add_affinitized_leaders();
+  cloud_info->set_placement_cloud(default_cloud);
+  cloud_info->set_placement_region(default_region);
+  cloud_info->set_placement_zone("a");
+  ASSERT_TRUE(ts0->IsAcceptingLeaderLoad(replication_info));
+  ASSERT_FALSE(ts1->IsAcceptingLeaderLoad(replication_info));
+  ASSERT_FALSE(ts2->IsAcceptingLeaderLoad(replication_info));
+  ASSERT_NOK(CatalogManagerUtil::AreLeadersOnPreferredOnly(ts_descs, replication_info));
+
+  ts0->set_leader_count(24);
+  ts1->set_leader_count(0);
+  ts2->set_leader_count(0);
+  ASSERT_OK(CatalogManagerUtil::AreLeadersOnPreferredOnly(ts_descs, replication_info));
 }
 
 
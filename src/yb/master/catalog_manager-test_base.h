@@ -83,7 +83,8 @@ void NewReplica(
   replica->role = role;
 }
 
-std::shared_ptr<TSDescriptor> SetupTS(const string& uuid, const string& az) {
+std::shared_ptr<TSDescriptor> SetupTS(const string& uuid, const string& az,
+                                      const string& placement_uuid = "") {
   NodeInstancePB node;
   node.set_permanent_uuid(uuid);
 
@@ -96,6 +97,9 @@ std::shared_ptr<TSDescriptor> SetupTS(const string& uuid, const string& az) {
   ci->set_placement_cloud(default_cloud);
   ci->set_placement_region(default_region);
   ci->set_placement_zone(az);
+  if (!placement_uuid.empty()) {
+    reg.mutable_common()->set_placement_uuid(placement_uuid);
+  }
 
   std::shared_ptr<TSDescriptor> ts(new YB_EDITION_NS_PREFIX TSDescriptor(node.permanent_uuid()));
   CHECK_OK(ts->Register(node, reg, CloudInfoPB(), nullptr));
@@ -170,6 +174,19 @@ class TestLoadBalancerBase {
     PrepareTestState(ts_descs_multi_az);
     TestBalancingLeaders();
 
+    gflags::SetCommandLineOption("load_balancer_leader_load_balancing", "true");
+    PrepareTestState(ts_descs_multi_az);
+    TestBalancingLeaderLoad();
+    gflags::SetCommandLineOption("load_balancer_leader_load_balancing", "false");
+
+    gflags::SetCommandLineOption("load_balancer_size_aware_moves", "true");
+    PrepareTestState(ts_descs_multi_az);
+    TestBalancingTabletSizes();
+    gflags::SetCommandLineOption("load_balancer_size_aware_moves", "false");
+
+    PrepareTestState(ts_descs_multi_az);
+    TestBalancingLeadersWithAffinity();
+
     PrepareTestState(ts_descs_single_az);
     TestMissingPlacementSingleAz();
 
@@ -179,6 +196,9 @@ class TestLoadBalancerBase {
 
     PrepareTestState(ts_descs_multi_az);
     TestLeaderOverReplication();
+
+    PrepareTestState(ts_descs_multi_az);
+    TestReadReplicas();
   }
 
  protected:
@@ -195,6 +215,11 @@ class TestLoadBalancerBase {
     return cb_->HandleLeaderMoves(out_tablet_id, out_from_ts, out_to_ts);
   }
 
+  Result<bool> HandleLeaderLoadMoves(
+      TabletId* out_tablet_id, TabletServerId* out_from_ts, TabletServerId* out_to_ts) {
+    return cb_->HandleLeaderLoadMoves(out_tablet_id, out_from_ts, out_to_ts);
+  }
+
   void TestWithBlacklist() {
     LOG(INFO) << "Testing with tablet servers with blacklist";
     // Setup cluster config.
@@ -375,6 +400,42 @@ class TestLoadBalancerBase {
     TestRemoveLoad(tablets_[0]->tablet_id(), "");
   }
 
+  void TestReadReplicas() {
+    LOG(INFO) << "Testing with observers in a read replica placement";
+    SetupClusterConfig({"a", "b", "c"}, &replication_info_);
+    auto* read_replicas = replication_info_.add_read_replicas();
+    read_replicas->set_placement_uuid("read");
+    read_replicas->set_num_replicas(1);
+    auto* pb = read_replicas->add_placement_blocks();
+    pb->mutable_cloud_info()->set_placement_cloud(default_cloud);
+    pb->mutable_cloud_info()->set_placement_region(default_region);
+    pb->mutable_cloud_info()->set_placement_zone("a");
+    pb->set_min_num_replicas(1);
+
+    // Every tablet but the first one has an observer on the first read replica tablet server,
+    // the second one is empty.
+    ts_descs_.push_back(SetupTS("3333", "a", "read"));
+    ts_descs_.push_back(SetupTS("4444", "a", "read"));
+    for (size_t i = 1; i < tablets_.size(); ++i) {
+      AddRunningReplica(tablets_[i].get(), ts_descs_[3]);
+    }
+
+    // The live placement is properly replicated and balanced: the observers are not counted
+    // as extra replicas, and the empty read replica tablet server does not receive voters.
+    ASSERT_OK(AnalyzeTablets());
+    string placeholder;
+    ASSERT_FALSE(ASSERT_RESULT(cb_->HandleRemoveReplicas(&placeholder, &placeholder)));
+    ASSERT_FALSE(ASSERT_RESULT(HandleAddReplicas(&placeholder, &placeholder, &placeholder)));
+
+    // The read replica placement gets the missing observer, on the least loaded tablet server.
+    ResetState();
+    cb_->state_->placement_uuid_ = "read";
+    cb_->state_->read_only_ = true;
+    ASSERT_OK(AnalyzeTablets());
+    ASSERT_EQ(consensus::RaftPeerPB::PRE_OBSERVER, cb_->GetDefaultMemberType());
+    TestAddLoad(tablets_[0]->tablet_id(), "", ts_descs_[4]->permanent_uuid());
+  }
+
   void TestWithMissingPlacement() {
     LOG(INFO) << "Testing with tablet servers missing placement information";
     // Setup cluster level placement to multiple AZs.
@@ -668,6 +729,139 @@ class TestLoadBalancerBase {
     ASSERT_FALSE(ASSERT_RESULT(HandleLeaderMoves(&placeholder, &placeholder, &placeholder)));
   }
 
+  void TestBalancingLeaderLoad() {
+    LOG(INFO) << "Testing moving leaders by their load";
+    // Idle leaders are balanced by their number.
+    for (const auto tablet : tablets_) {
+      MoveTabletLeader(tablet.get(), ts_descs_[0]);
+    }
+    LOG(INFO) << "Leader distribution: 4 0 0";
+
+    ASSERT_OK(AnalyzeTablets());
+    cb_->ComputeLeaderLoads();
+
+    string placeholder, tablet_id, from_ts, to_ts;
+    ASSERT_TRUE(ASSERT_RESULT(HandleLeaderLoadMoves(&tablet_id, &from_ts, &to_ts)));
+    ASSERT_EQ(ts_descs_[0]->permanent_uuid(), from_ts);
+    ASSERT_TRUE(ASSERT_RESULT(HandleLeaderLoadMoves(&tablet_id, &from_ts, &to_ts)));
+    ASSERT_EQ(ts_descs_[0]->permanent_uuid(), from_ts);
+    ASSERT_FALSE(ASSERT_RESULT(HandleLeaderLoadMoves(&placeholder, &placeholder, &placeholder)));
+
+    // Restore the leaders to ts0, ts1, ts2, ts0 and make the leaders on ts0 hot.
+    for (int i = 0; i < tablets_.size(); ++i) {
+      MoveTabletLeader(tablets_[i].get(), ts_descs_[i % ts_descs_.size()]);
+    }
+    ts_descs_[0]->set_tablet_leader_ops_per_sec(tablets_[0]->tablet_id(), 100);
+    ts_descs_[0]->set_tablet_leader_ops_per_sec(tablets_[3]->tablet_id(), 20);
+    ts_descs_[1]->set_tablet_leader_ops_per_sec(tablets_[1]->tablet_id(), 10);
+    ts_descs_[2]->set_tablet_leader_ops_per_sec(tablets_[2]->tablet_id(), 11);
+    LOG(INFO) << "Leader load: 122 11 12";
+
+    ResetState();
+    ASSERT_OK(AnalyzeTablets());
+    cb_->ComputeLeaderLoads();
+
+    // Moving the hottest leader would only move the hot spot, so the other leader on ts0 is moved
+    // to the least loaded server.
+    ASSERT_TRUE(ASSERT_RESULT(HandleLeaderLoadMoves(&tablet_id, &from_ts, &to_ts)));
+    ASSERT_EQ(tablets_[3]->tablet_id(), tablet_id);
+    ASSERT_EQ(ts_descs_[0]->permanent_uuid(), from_ts);
+    ASSERT_EQ(ts_descs_[1]->permanent_uuid(), to_ts);
+    ASSERT_FALSE(ASSERT_RESULT(HandleLeaderLoadMoves(&placeholder, &placeholder, &placeholder)));
+
+    for (const auto& ts_desc : ts_descs_) {
+      ts_desc->ClearMetrics();
+    }
+  }
+
+  void TestBalancingLeadersWithAffinity() {
+    LOG(INFO) << "Testing moving leaders into the affinitized zones";
+    for (const auto& zone : {"a", "b"}) {
+      auto* cloud_info = replication_info_.add_affinitized_leaders();
+      cloud_info->set_placement_cloud(default_cloud);
+      cloud_info->set_placement_region(default_region);
+      cloud_info->set_placement_zone(zone);
+    }
+    LOG(INFO) << "Leader distribution: 2 1 1. Affinitized zones: a b";
+
+    ASSERT_OK(AnalyzeTablets());
+
+    // The leader on ts2 is moved to the server of the affinitized zones with the fewest leaders,
+    // after which the leaders are balanced within these zones.
+    string placeholder;
+    TestMoveLeader(&placeholder, ts_descs_[2]->permanent_uuid(), ts_descs_[1]->permanent_uuid());
+    ASSERT_FALSE(ASSERT_RESULT(HandleLeaderMoves(&placeholder, &placeholder, &placeholder)));
+
+    // Leaders are balanced across the other servers if no server of the affinitized zones could
+    // lead.
+    MoveTabletLeader(tablets_[2].get(), ts_descs_[2]);
+    blacklist_.add_hosts()->set_host(ts_descs_[0]->permanent_uuid());
+    blacklist_.add_hosts()->set_host(ts_descs_[1]->permanent_uuid());
+    LOG(INFO) << "Leader distribution: 2 1 1. Blacklist: ts0 ts1";
+
+    ResetState();
+    ASSERT_OK(AnalyzeTablets());
+    ASSERT_FALSE(ASSERT_RESULT(HandleLeaderMoves(&placeholder, &placeholder, &placeholder)));
+
+    blacklist_.Clear();
+    replication_info_.clear_affinitized_leaders();
+  }
+
+  void TestBalancingTabletSizes() {
+    LOG(INFO) << "Testing moving replicas by their size";
+    replication_info_.mutable_live_replicas()->set_num_replicas(kNumReplicas);
+    ts_descs_.push_back(SetupTS("3333", "a"));
+    ts_descs_.push_back(SetupTS("4444", "b"));
+    MoveReplica(tablets_[0].get(), ts_descs_[0], ts_descs_[3]);
+    MoveReplica(tablets_[1].get(), ts_descs_[1], ts_descs_[3]);
+    MoveReplica(tablets_[2].get(), ts_descs_[2], ts_descs_[4]);
+    MoveReplica(tablets_[3].get(), ts_descs_[2], ts_descs_[4]);
+    LOG(INFO) << "Replica distribution: 3 3 2 2 2";
+
+    // The replicas are balanced by their number, but the large tablet makes ts0, ts1 and ts4
+    // store far more bytes than ts2 and ts3.
+    const std::vector<uint64_t> sizes = {10, 20, 30, 1000};
+    SetTabletSizes(sizes);
+    LOG(INFO) << "Bytes stored: 1050 1040 30 30 1030";
+
+    ResetState();
+    ASSERT_OK(AnalyzeTablets());
+    cb_->ComputeTabletSizes();
+
+    // The small tablet is moved off the server that stores the most bytes, to the server that
+    // stores the least and has fewer replicas. The large tablet is never moved, that would only
+    // move the imbalance.
+    TestAddLoad(tablets_[2]->tablet_id(), ts_descs_[0]->permanent_uuid(),
+                ts_descs_[2]->permanent_uuid());
+
+    MoveReplica(tablets_[2].get(), ts_descs_[0], ts_descs_[2]);
+    SetTabletSizes(sizes);
+    LOG(INFO) << "Replica distribution: 2 3 3 2 2. Bytes stored: 1020 1040 60 30 1030";
+
+    ResetState();
+    ASSERT_OK(AnalyzeTablets());
+    cb_->ComputeTabletSizes();
+
+    TestAddLoad(tablets_[2]->tablet_id(), ts_descs_[1]->permanent_uuid(),
+                ts_descs_[3]->permanent_uuid());
+
+    MoveReplica(tablets_[2].get(), ts_descs_[1], ts_descs_[3]);
+    SetTabletSizes(sizes);
+    LOG(INFO) << "Replica distribution: 2 2 3 3 2. Bytes stored: 1020 1010 60 60 1030";
+
+    ResetState();
+    ASSERT_OK(AnalyzeTablets());
+    cb_->ComputeTabletSizes();
+
+    // No server has fewer replicas than ts4, so nothing is moved off it.
+    string placeholder;
+    ASSERT_FALSE(ASSERT_RESULT(HandleAddReplicas(&placeholder, &placeholder, &placeholder)));
+
+    for (const auto& ts_desc : ts_descs_) {
+      ts_desc->ClearMetrics();
+    }
+  }
+
   void TestBalancingLeadersWithThreshold() {
     LOG(INFO) << "Testing moving overloaded leaders with threshold = 2";
     // Move all leaders to ts0.
@@ -873,6 +1067,26 @@ class TestLoadBalancerBase {
     tablet->SetReplicaLocations(replicas);
   }
 
+  void MoveReplica(TabletInfo* tablet, std::shared_ptr<TSDescriptor> from_ts,
+                   std::shared_ptr<TSDescriptor> to_ts) {
+    AddRunningReplica(tablet, to_ts);
+    RemoveReplica(tablet, from_ts);
+  }
+
+  // Reports the size of the i-th tablet on each tablet server that hosts it.
+  void SetTabletSizes(const std::vector<uint64_t>& sizes) {
+    for (const auto& ts_desc : ts_descs_) {
+      ts_desc->ClearMetrics();
+    }
+    for (int i = 0; i < tablets_.size(); ++i) {
+      TabletInfo::ReplicaMap replicas;
+      tablets_[i]->GetReplicaLocations(&replicas);
+      for (const auto& replica : replicas) {
+        replica.second.ts_desc->set_tablet_size(tablets_[i]->tablet_id(), sizes[i]);
+      }
+    }
+  }
+
   void MoveTabletLeader(TabletInfo* tablet, std::shared_ptr<TSDescriptor> ts_desc) {
     TabletInfo::ReplicaMap replicas;
     tablet->GetReplicaLocations(&replicas);
@@ -56,6 +56,8 @@
 #include <algorithm>
 #include <bitset>
 #include <functional>
+#include <future>
+#include <map>
 #include <mutex>
 #include <set>
 #include <unordered_map>
@@ -167,6 +169,13 @@ DEFINE_int32(max_create_tablets_per_ts, 50,
              "The number of tablets per TS that can be requested for a new table.");
 TAG_FLAG(max_create_tablets_per_ts, advanced);
 
+DEFINE_int32(create_tablets_rpc_batch_size, 0,
+             "Maximum number of replicas of new tablets of a table that are created on a tablet "
+             "server with a single CreateTablets RPC. 0 to send a CreateTablet RPC per replica, "
+             "which should be used while any tablet server does not support CreateTablets yet.");
+TAG_FLAG(create_tablets_rpc_batch_size, advanced);
+TAG_FLAG(create_tablets_rpc_batch_size, runtime);
+
 DEFINE_int32(master_failover_catchup_timeout_ms, 30 * 1000,  // 30 sec
              "Amount of time to give a newly-elected leader master to load"
              " the previous master's metadata and become active. If this time"
@@ -174,6 +183,11 @@ DEFINE_int32(master_failover_catchup_timeout_ms, 30 * 1000,  // 30 sec
 TAG_FLAG(master_failover_catchup_timeout_ms, advanced);
 TAG_FLAG(master_failover_catchup_timeout_ms, experimental);
 
+DEFINE_bool(master_parallel_sys_catalog_load, true,
+            "Whether a newly-elected leader master should load the entries of the sys catalog "
+            "that do not depend on each other, e.g. tables and namespaces, in parallel.");
+TAG_FLAG(master_parallel_sys_catalog_load, advanced);
+
 DEFINE_bool(master_tombstone_evicted_tablet_replicas, true,
             "Whether the Master should tombstone (delete) tablet replicas that "
             "are no longer part of the latest reported raft config.");
@@ -616,6 +630,20 @@ class SysConfigLoader : public Visitor<PersistentSysConfigInfo> {
   DISALLOW_COPY_AND_ASSIGN(SysConfigLoader);
 };
 
+namespace {
+
+template <class Loader>
+Status RunLoader(CatalogManager* catalog_manager, SysCatalogTable* sys_catalog,
+                 const std::string& entries) {
+  LOG(INFO) << "Loading " << entries << " into memory.";
+  Loader loader(catalog_manager);
+  RETURN_NOT_OK_PREPEND(
+      sys_catalog->Visit(&loader), Format("Failed while visiting $0 in sys catalog", entries));
+  return Status::OK();
+}
+
+} // namespace
+
 ////////////////////////////////////////////////////////////
 // Background Tasks
 ////////////////////////////////////////////////////////////
@@ -741,6 +769,7 @@ void CatalogManagerBgTasks::Run() {
     //  - HandleReportedTablet/ProcessPendingAssignments will call WakeIfHasPendingUpdates()
     //    to notify about tablets creation.
     l.Unlock();
+    catalog_manager_->metadata_change_log_.ExpireWaiters(CoarseMonoClock::Now());
     Wait(FLAGS_catalog_manager_bg_task_wait_ms);
   }
   VLOG(1) << "Catalog manager background task thread shutting down";
@@ -905,6 +934,12 @@ void CatalogManager::LoadSysCatalogDataTask() {
     }
   }
 
+  // Changes recorded in the previous terms could have been missed, so the watching clients are
+  // asked to start over.
+  metadata_change_log_.Reset(term);
+  // All the tables were reloaded.
+  TabletLocationsChanged(nullptr);
+
   std::lock_guard<simple_spinlock> l(state_lock_);
   leader_ready_term_ = term;
   LOG(INFO) << "Completed load of sys catalog in term " << term;
@@ -928,6 +963,7 @@ Status CatalogManager::VisitSysCatalog(int64_t term) {
   }
 
   LOG(INFO) << __func__ << ": Acquire catalog manager lock_ before loading sys catalog..";
+  boost::lock_guard<LockType> permissions_lock(permissions_lock_);
   boost::lock_guard<LockType> lock(lock_);
   VLOG(1) << __func__ << ": Acquired the catalog manager lock_";
 
@@ -991,54 +1027,39 @@ Status CatalogManager::RunLoaders() {
     ts_desc->set_has_tablet_report(false);
   }
 
-  // Visit tables and tablets, load them into memory.
-  // TODO(hector): Refactor this code.
-  LOG(INFO) << __func__ << ": Loading tables into memory.";
-  unique_ptr<TableLoader> table_loader(new TableLoader(this));
-  RETURN_NOT_OK_PREPEND(
-      sys_catalog_->Visit(table_loader.get()), "Failed while visiting tables in sys catalog");
-
-  LOG(INFO) << __func__ << ": Loading tablets into memory.";
-  unique_ptr<TabletLoader> tablet_loader(new TabletLoader(this));
-  RETURN_NOT_OK_PREPEND(
-      sys_catalog_->Visit(tablet_loader.get()), "Failed while visiting tablets in sys catalog");
-
-  LOG(INFO) << __func__ << ": Loading namespaces into memory.";
-  unique_ptr<NamespaceLoader> namespace_loader(new NamespaceLoader(this));
-  RETURN_NOT_OK_PREPEND(
-      sys_catalog_->Visit(namespace_loader.get()),
-      "Failed while visiting namespaces in sys catalog");
-
-  LOG(INFO) << __func__ << ": Loading user-defined types into memory.";
-  unique_ptr<UDTypeLoader> udtype_loader(new UDTypeLoader(this));
-  RETURN_NOT_OK_PREPEND(
-      sys_catalog_->Visit(udtype_loader.get()),
-      "Failed while visiting namespaces in sys catalog");
-
-  LOG(INFO) << __func__ << ": Loading cluster configuration into memory.";
-  unique_ptr<ClusterConfigLoader> config_loader(new ClusterConfigLoader(this));
-  RETURN_NOT_OK_PREPEND(
-      sys_catalog_->Visit(config_loader.get()), "Failed while visiting config in sys catalog");
-
-  LOG(INFO) << __func__ << ": Loading roles into memory.";
-  unique_ptr<RoleLoader> role_loader(new RoleLoader(this));
-  RETURN_NOT_OK_PREPEND(
-      sys_catalog_->Visit(role_loader.get()),
-      "Failed while visiting roles in sys catalog");
-
-  LOG(INFO) << __func__ << ": Loading Redis config into memory.";
-  unique_ptr<RedisConfigLoader> redis_config_loader(new RedisConfigLoader(this));
-  RETURN_NOT_OK_PREPEND(
-      sys_catalog_->Visit(redis_config_loader.get()),
-      "Failed while visiting redis config in sys catalog");
-
-  LOG(INFO) << __func__ << ": Loading sys config into memory.";
-  unique_ptr<SysConfigLoader> sys_config_loader(new SysConfigLoader(this));
-  RETURN_NOT_OK_PREPEND(
-      sys_catalog_->Visit(sys_config_loader.get()),
-      "Failed while visiting sys config in sys catalog");
+  // Each loader fills its own maps, so the loaders that do not depend on each other are run in
+  // parallel. Tablets refer to their tables, and the blacklist of the cluster config is logged
+  // with the number of tablets, so these are loaded in order on this thread.
+  const auto policy = FLAGS_master_parallel_sys_catalog_load ? std::launch::async
+                                                             : std::launch::deferred;
+  std::vector<std::future<Status>> loaders;
+  loaders.push_back(std::async(
+      policy, &RunLoader<NamespaceLoader>, this, sys_catalog_.get(), "namespaces"));
+  loaders.push_back(std::async(
+      policy, &RunLoader<UDTypeLoader>, this, sys_catalog_.get(), "user-defined types"));
+  loaders.push_back(std::async(
+      policy, &RunLoader<RoleLoader>, this, sys_catalog_.get(), "roles"));
+  loaders.push_back(std::async(
+      policy, &RunLoader<RedisConfigLoader>, this, sys_catalog_.get(), "redis config"));
+  loaders.push_back(std::async(
+      policy, &RunLoader<SysConfigLoader>, this, sys_catalog_.get(), "sys config"));
+
+  Status status = RunLoader<TableLoader>(this, sys_catalog_.get(), "tables");
+  if (status.ok()) {
+    status = RunLoader<TabletLoader>(this, sys_catalog_.get(), "tablets");
+  }
+  if (status.ok()) {
+    status = RunLoader<ClusterConfigLoader>(this, sys_catalog_.get(), "config");
+  }
 
-  return Status::OK();
+  // Wait for all the loaders even if one failed, since they refer to the catalog manager.
+  for (auto& loader : loaders) {
+    Status loader_status = loader.get();
+    if (status.ok()) {
+      status = loader_status;
+    }
+  }
+  return status;
 }
 
 Status CatalogManager::PrepareDefaultClusterConfig(int64_t term) {
@@ -1182,9 +1203,9 @@ Status CatalogManager::PrepareSystemTables(int64_t term) {
 }
 
 CHECKED_STATUS CatalogManager::PrepareDefaultRoles(int64_t term) {
-  // Verify we have the catalog manager lock.
-  if (!lock_.is_locked()) {
-    return STATUS(IllegalState, "We don't have the catalog manager lock!");
+  // Verify we have the permissions lock.
+  if (!permissions_lock_.is_locked()) {
+    return STATUS(IllegalState, "We don't have the permissions lock!");
   }
 
   if (FindPtrOrNull(roles_map_, kDefaultCassandraUsername) != nullptr) {
@@ -2243,6 +2264,7 @@ Status CatalogManager::CreateTable(const CreateTableRequestPB* orig_req,
   for (TabletInfo *tablet : tablets) {
     tablet->mutable_metadata()->CommitMutation();
   }
+  TabletLocationsChanged(table.get());
 
   if (req.has_creator_role_name()) {
     const NamespaceName& keyspace_name = req.namespace_().name();
@@ -2780,6 +2802,81 @@ Status CatalogManager::IsTruncateTableDone(const IsTruncateTableDoneRequestPB* r
   return Status::OK();
 }
 
+Status CatalogManager::BackfillIndex(const BackfillIndexRequestPB* req,
+                                     BackfillIndexResponsePB* resp,
+                                     rpc::RpcContext* rpc) {
+  LOG(INFO) << "Servicing BackfillIndex request from " << RequestorString(rpc)
+            << ": " << req->ShortDebugString();
+  RETURN_NOT_OK(CheckOnline());
+
+  scoped_refptr<TableInfo> index_table;
+  scoped_refptr<TableInfo> indexed_table;
+  {
+    std::lock_guard<LockType> l_map(lock_);
+    index_table = FindPtrOrNull(table_ids_map_, req->index_id());
+    if (index_table != nullptr) {
+      auto l = index_table->LockForRead();
+      indexed_table = FindPtrOrNull(table_ids_map_, l->data().pb.indexed_table_id());
+    }
+  }
+  if (indexed_table == nullptr) {
+    Status s = STATUS_SUBSTITUTE(NotFound, "The index with id $0 does not exist", req->index_id());
+    return SetupError(resp->mutable_error(), MasterErrorPB::OBJECT_NOT_FOUND, s);
+  }
+
+  {
+    auto l = indexed_table->LockForRead();
+    if (l->data().started_deleting() || l->data().is_deleted()) {
+      Status s = STATUS(NotFound, "The indexed table does not exist");
+      return SetupError(resp->mutable_error(), MasterErrorPB::OBJECT_NOT_FOUND, s);
+    }
+    // Writes to tablets that do not know the index yet would not maintain it.
+    if (l->data().pb.state() == SysTablesEntryPB::ALTERING) {
+      Status s = STATUS(TryAgain, "The index is not known to all tablets of the indexed table yet");
+      return SetupError(resp->mutable_error(), MasterErrorPB::IN_TRANSITION_CAN_RETRY, s);
+    }
+  }
+  if (index_table->HasTasks(MonitoredTask::Type::ASYNC_BACKFILL_TABLET_INDEX)) {
+    Status s = STATUS(AlreadyPresent, "The index is being backfilled already");
+    return SetupError(resp->mutable_error(), MasterErrorPB::UNKNOWN_ERROR, s);
+  }
+
+  // All rows written after the read time are written into the index by the index maintenance, and
+  // the tablets write the entries of the rows before it.
+  const HybridTime read_time = master_->clock()->Now();
+  TabletInfos tablets;
+  indexed_table->GetAllTablets(&tablets);
+  for (const auto& tablet : tablets) {
+    auto call = std::make_shared<AsyncBackfillTabletIndex>(
+        master_, worker_pool_.get(), tablet, index_table, read_time);
+    index_table->AddTask(call);
+    WARN_NOT_OK(call->Run(), Substitute("Failed to send backfill request for tablet $0",
+                                        tablet->id()));
+  }
+
+  LOG(INFO) << "Successfully initiated backfill of " << index_table->ToString() << " from "
+            << tablets.size() << " tablets at " << read_time;
+  return Status::OK();
+}
+
+Status CatalogManager::IsBackfillIndexDone(const IsBackfillIndexDoneRequestPB* req,
+                                           IsBackfillIndexDoneResponsePB* resp) {
+  RETURN_NOT_OK(CheckOnline());
+
+  scoped_refptr<TableInfo> index_table;
+  {
+    std::lock_guard<LockType> l_map(lock_);
+    index_table = FindPtrOrNull(table_ids_map_, req->index_id());
+  }
+  if (index_table == nullptr) {
+    Status s = STATUS(NotFound, "The index does not exist");
+    return SetupError(resp->mutable_error(), MasterErrorPB::OBJECT_NOT_FOUND, s);
+  }
+
+  resp->set_done(!index_table->HasTasks(MonitoredTask::Type::ASYNC_BACKFILL_TABLET_INDEX));
+  return Status::OK();
+}
+
 Status CatalogManager::DeleteIndexInfoFromTable(const TableId& indexed_table_id,
                                                 const TableId& index_table_id,
                                                 DeleteTableResponsePB* resp) {
@@ -2880,6 +2977,14 @@ Status CatalogManager::DeleteTable(const DeleteTableRequestPB* req,
     table_locks[i]->Commit();
   }
 
+  for (const auto& table : tables) {
+    MetadataChangePB change;
+    change.set_type(MetadataChangePB::TABLE_DELETED);
+    change.set_table_id(table->id());
+    metadata_change_log_.Record(std::move(change));
+    TabletLocationsChanged(table.get());
+  }
+
   // The table lock (l) and the global lock (lock_) must be released for the next call.
   for (int i = 0; i < deleted_tables.size(); i++) {
     MarkTableDeletedIfNoTablets(deleted_tables[i], tables[i].get());
@@ -3341,6 +3446,7 @@ Status CatalogManager::AlterTable(const AlterTableRequestPB* req,
   // Update the in-memory state.
   TRACE("Committing in-memory state");
   l->Commit();
+  TabletLocationsChanged(table.get());
 
   SendAlterTableRequest(table);
 
@@ -3582,7 +3688,7 @@ void CatalogManager::GetAllUDTypes(std::vector<scoped_refptr<UDTypeInfo>>* types
 
 void CatalogManager::GetAllRoles(std::vector<scoped_refptr<RoleInfo>>* roles) {
   roles->clear();
-  boost::shared_lock<LockType> l(lock_);
+  boost::shared_lock<LockType> l(permissions_lock_);
   for (const RoleInfoMap::value_type& e : roles_map_) {
     roles->push_back(e.second);
   }
@@ -3606,7 +3712,7 @@ vector<string> CatalogManager::DirectMemberOf(const RoleName& role) {
 
 void CatalogManager::BuildRecursiveRoles() {
   TRACE("Acquired catalog manager lock");
-  std::lock_guard<LockType> l_big(lock_);
+  std::lock_guard<LockType> l_big(permissions_lock_);
   BuildRecursiveRolesUnlocked();
 }
 
@@ -3729,7 +3835,13 @@ Status CatalogManager::GetPermissions(const GetPermissionsRequestPB* req,
                                       rpc::RpcContext* rpc) {
   std::shared_ptr<GetPermissionsResponsePB> permissions_cache;
   {
-    std::lock_guard<LockType> l_big(lock_);
+    // Every proxy polls the permissions, so the cache is read under the shared lock, and the
+    // exclusive one is only taken to build it.
+    boost::shared_lock<LockType> l(permissions_lock_);
+    permissions_cache = permissions_cache_;
+  }
+  if (!permissions_cache) {
+    std::lock_guard<LockType> l_big(permissions_lock_);
     if (!permissions_cache_) {
       BuildRecursiveRolesUnlocked();
       if (!permissions_cache_) {
@@ -3905,14 +4017,37 @@ Status CatalogManager::ProcessTabletReport(TSDescriptor* ts_desc,
     return Status::OK();
   }
 
+  if (!ts_desc->TrackTabletReportSeqNo(report.sequence_number(), report.is_incremental())) {
+    LOG(WARNING) << "Ignoring out of order tablet report " << report.sequence_number()
+                 << " from " << ts_desc->permanent_uuid() << ", requesting a full one";
+    ts_desc->set_has_tablet_report(false);
+    return Status::OK();
+  }
+
+  RETURN_NOT_OK_PREPEND(CheckIsLeaderAndReady(),
+      "This master is no longer the leader, unable to handle tablet report");
+
+  // Look up all reported tablets under a single acquisition of the catalog manager lock, so
+  // reports of many tablet servers are processed in parallel by the service threads without
+  // contending on it for each tablet.
+  std::vector<scoped_refptr<TabletInfo>> tablets;
+  tablets.reserve(report.updated_tablets_size());
+  {
+    boost::shared_lock<LockType> l(lock_);
+    for (const ReportedTabletPB& reported : report.updated_tablets()) {
+      tablets.push_back(FindPtrOrNull(tablet_map_, reported.tablet_id()));
+    }
+  }
+
   // TODO: on a full tablet report, we may want to iterate over the tablets we think
   // the server should have, compare vs the ones being reported, and somehow mark
   // any that have been "lost" (eg somehow the tablet metadata got corrupted or something).
 
-  for (const ReportedTabletPB& reported : report.updated_tablets()) {
+  for (int i = 0; i < report.updated_tablets_size(); ++i) {
+    const ReportedTabletPB& reported = report.updated_tablets(i);
     ReportedTabletUpdatesPB *tablet_report = report_update->add_tablets();
     tablet_report->set_tablet_id(reported.tablet_id());
-    RETURN_NOT_OK_PREPEND(HandleReportedTablet(ts_desc, reported, tablet_report),
+    RETURN_NOT_OK_PREPEND(HandleReportedTablet(ts_desc, reported, tablets[i], tablet_report),
                           Substitute("Error handling $0", reported.ShortDebugString()));
   }
 
@@ -3956,17 +4091,10 @@ bool ShouldTransitionTabletToRunning(const ReportedTabletPB& report) {
 
 Status CatalogManager::HandleReportedTablet(TSDescriptor* ts_desc,
                                             const ReportedTabletPB& report,
+                                            const scoped_refptr<TabletInfo>& tablet,
                                             ReportedTabletUpdatesPB *report_updates) {
   TRACE_EVENT1("master", "HandleReportedTablet",
                "tablet_id", report.tablet_id());
-  scoped_refptr<TabletInfo> tablet;
-  {
-    boost::shared_lock<LockType> l(lock_);
-    tablet = FindPtrOrNull(tablet_map_, report.tablet_id());
-  }
-  RETURN_NOT_OK_PREPEND(CheckIsLeaderAndReady(),
-      Substitute("This master is no longer the leader, unable to handle report for tablet $0",
-                 report.tablet_id()));
   if (!tablet) {
     LOG(INFO) << "Got report from unknown tablet " << report.tablet_id()
               << ": Sending delete request for this orphan tablet";
@@ -4014,6 +4142,9 @@ Status CatalogManager::HandleReportedTablet(TSDescriptor* ts_desc,
     return Status::OK();
   }
 
+  // Set when the report has changed the leader of the tablet.
+  std::string new_leader_uuid;
+
   // Check if the tablet requires an "alter table" call.
   bool tablet_needs_alter = false;
   if (report.has_schema_version() &&
@@ -4149,6 +4280,10 @@ Status CatalogManager::HandleReportedTablet(TSDescriptor* ts_desc,
 
       RETURN_NOT_OK(ResetTabletReplicasFromReportedConfig(*final_report, tablet,
                                                           tablet_lock.get(), table_lock.get()));
+      if (cstate.has_leader_uuid() &&
+          (!prev_cstate.has_leader_uuid() || prev_cstate.leader_uuid() != cstate.leader_uuid())) {
+        new_leader_uuid = cstate.leader_uuid();
+      }
 
       // Sanity check replicas for this tablet.
       TabletInfo::ReplicaMap replica_map;
@@ -4168,15 +4303,30 @@ Status CatalogManager::HandleReportedTablet(TSDescriptor* ts_desc,
   }
 
   table_lock->Unlock();
-  // We update the tablets each time that someone reports it.
-  // This shouldn't be very frequent and should only happen when something in fact changed.
-  Status s = sys_catalog_->UpdateItem(tablet.get(), leader_ready_term_);
-  if (!s.ok()) {
-    LOG(WARNING) << "Error updating tablets: " << s.ToString() << ". Tablet report was: "
-                 << report.ShortDebugString();
-    return s;
+  // Full reports carry every tablet of the server, most of them unchanged. Only the tablets whose
+  // persistent state was changed by the report are written to the sys catalog.
+  if (tablet_lock->data().pb.SerializeAsString() !=
+          tablet->metadata().state().pb.SerializeAsString()) {
+    Status s = sys_catalog_->UpdateItem(tablet.get(), leader_ready_term_);
+    if (!s.ok()) {
+      LOG(WARNING) << "Error updating tablets: " << s.ToString() << ". Tablet report was: "
+                   << report.ShortDebugString();
+      return s;
+    }
+    tablet_lock->Commit();
+    TabletLocationsChanged(tablet->table().get());
+  } else {
+    tablet_lock->Unlock();
+  }
+
+  if (!new_leader_uuid.empty()) {
+    MetadataChangePB change;
+    change.set_type(MetadataChangePB::TABLET_LEADER);
+    change.set_table_id(tablet->table()->id());
+    change.set_tablet_id(tablet->tablet_id());
+    change.set_leader_uuid(new_leader_uuid);
+    metadata_change_log_.Record(std::move(change));
   }
-  tablet_lock->Commit();
 
   // Need to defer the AlterTable command to after we've committed the new tablet data,
   // since the tablet report may also be updating the raft config, and the Alter Table
@@ -4197,8 +4347,8 @@ Status CatalogManager::GrantRevokePermission(const GrantRevokePermissionRequestP
             << RequestorString(rpc) << ": " << req->ShortDebugString();
   RETURN_NOT_OK(CheckOnline());
 
-  std::lock_guard<LockType> l_big(lock_);
-  TRACE("Acquired catalog manager lock");
+  std::lock_guard<LockType> l_big(permissions_lock_);
+  TRACE("Acquired permissions lock");
   Status s;
   scoped_refptr<NamespaceInfo> ns;
   scoped_refptr<TableInfo> table;
@@ -4206,6 +4356,7 @@ Status CatalogManager::GrantRevokePermission(const GrantRevokePermissionRequestP
   // Checking if resources exist.
   if (req->resource_type() == ResourceType::TABLE ||
       req->resource_type() == ResourceType::KEYSPACE) {
+    boost::shared_lock<LockType> l_maps(lock_);
     // We can't match Apache Cassandra's error because when a namespace is not provided, the error
     // is detected by the semantic analysis in PTQualifiedName::AnalyzeName.
     DCHECK(req->has_namespace_());
@@ -4352,7 +4503,7 @@ Status CatalogManager::GrantPermissions(const RoleName& role_name,
                                         const std::vector<PermissionType>& permissions,
                                         const ResourceType resource_type,
                                         RespClass* resp) {
-  std::lock_guard<LockType> l(lock_);
+  std::lock_guard<LockType> l(permissions_lock_);
 
   scoped_refptr<RoleInfo> rp;
   rp = FindPtrOrNull(roles_map_, role_name);
@@ -4637,7 +4788,7 @@ Status CatalogManager::ListNamespaces(const ListNamespacesRequestPB* req,
 
 // Create a SysVersionInfo object to track the roles versions.
 Status CatalogManager::IncrementRolesVersionUnlocked() {
-  DCHECK(lock_.is_locked()) << "We don't have the catalog manager lock!";
+  DCHECK(permissions_lock_.is_locked()) << "We don't have the permissions lock!";
 
   // Prepare write.
   auto l = CHECK_NOTNULL(security_config_.get())->LockForWrite();
@@ -4655,6 +4806,11 @@ Status CatalogManager::IncrementRolesVersionUnlocked() {
   RETURN_NOT_OK(sys_catalog_->UpdateItem(security_config_.get(), leader_ready_term_));
 
   l->Commit();
+
+  MetadataChangePB change;
+  change.set_type(MetadataChangePB::PERMISSIONS);
+  change.set_roles_version(roles_version + 1);
+  metadata_change_log_.Record(std::move(change));
   return Status::OK();
 }
 
@@ -4663,7 +4819,7 @@ Status CatalogManager::RemoveAllPermissionsForResourceUnlocked(
     const std::string& canonical_resource,
     RespClass* resp) {
 
-  DCHECK(lock_.is_locked()) << "We don't have the catalog manager lock!";
+  DCHECK(permissions_lock_.is_locked()) << "We don't have the permissions lock!";
 
   bool permissions_modified = false;
   for (const auto& e : roles_map_) {
@@ -4697,7 +4853,7 @@ Status CatalogManager::RemoveAllPermissionsForResourceUnlocked(
 template<class RespClass>
 Status CatalogManager::RemoveAllPermissionsForResource(const std::string& canonical_resource,
                                                        RespClass* resp) {
-  std::lock_guard<LockType> l_big(lock_);
+  std::lock_guard<LockType> l_big(permissions_lock_);
   return RemoveAllPermissionsForResourceUnlocked(canonical_resource, resp);
 }
 
@@ -4707,8 +4863,8 @@ Status CatalogManager::CreateRoleUnlocked(const std::string& role_name,
                                           int64_t term,
                                           const bool increment_roles_version) {
 
-  if (!lock_.is_locked()) {
-    return STATUS(IllegalState, "We don't have the catalog manager lock!");
+  if (!permissions_lock_.is_locked()) {
+    return STATUS(IllegalState, "We don't have the permissions lock!");
   }
   // Create Entry.
   SysRoleEntryPB role_entry;
@@ -4752,7 +4908,7 @@ Status CatalogManager::CreateRole(const CreateRoleRequestPB* req,
   Status s;
   {
     TRACE("Acquired catalog manager lock");
-    std::lock_guard<LockType> l_big(lock_);
+    std::lock_guard<LockType> l_big(permissions_lock_);
     // Only a SUPERUSER role can create another SUPERUSER role. In Apache Cassandra this gets
     // checked before the existence of the new role.
     if (req->superuser()) {
@@ -4800,7 +4956,7 @@ Status CatalogManager::AlterRole(const AlterRoleRequestPB* req,
   Status s;
 
   TRACE("Acquired catalog manager lock");
-  std::lock_guard<LockType> l_big(lock_);
+  std::lock_guard<LockType> l_big(permissions_lock_);
 
   auto role = FindPtrOrNull(roles_map_, req->name());
   if (role == nullptr) {
@@ -4869,7 +5025,7 @@ Status CatalogManager::DeleteRole(const DeleteRoleRequestPB* req,
   }
 
   TRACE("Acquired catalog manager lock");
-  std::lock_guard<LockType> l_big(lock_);
+  std::lock_guard<LockType> l_big(permissions_lock_);
 
   auto role = FindPtrOrNull(roles_map_, req->name());
   if (role == nullptr) {
@@ -4989,7 +5145,7 @@ Status CatalogManager::GrantRevokeRole(const GrantRevokeRoleRequestPB* req,
   {
     constexpr char role_not_found_msg_str[] = "$0 doesn't exist";
     TRACE("Acquired catalog manager lock");
-    std::lock_guard<LockType> l_big(lock_);
+    std::lock_guard<LockType> l_big(permissions_lock_);
 
     scoped_refptr<RoleInfo> granted_role;
     granted_role = FindPtrOrNull(roles_map_, req->granted_role());
@@ -5442,7 +5598,16 @@ void CatalogManager::AddReplicaToTabletIfNotFound(TSDescriptor* ts_desc,
   TabletReplica replica;
   NewReplica(ts_desc, report, &replica);
   // Only inserts if a replica with a matching UUID was not already present.
-  ignore_result(tablet->AddToReplicaLocations(replica));
+  if (tablet->AddToReplicaLocations(replica)) {
+    TabletLocationsChanged(tablet->table().get());
+  }
+}
+
+void CatalogManager::TabletLocationsChanged(TableInfo* table) {
+  if (table) {
+    table->TabletLocationsChanged();
+  }
+  tablet_locations_version_.fetch_add(1, std::memory_order_acq_rel);
 }
 
 void CatalogManager::NewReplica(TSDescriptor* ts_desc,
@@ -5943,6 +6108,13 @@ Status CatalogManager::HandleTabletSchemaVersionReport(TabletInfo *tablet, uint3
 
   l->Commit();
   LOG(INFO) << table->ToString() << " - Alter table completed version=" << current_version;
+  TabletLocationsChanged(table.get());
+
+  MetadataChangePB change;
+  change.set_type(MetadataChangePB::TABLE_SCHEMA);
+  change.set_table_id(table->id());
+  change.set_schema_version(current_version);
+  metadata_change_log_.Record(std::move(change));
   return Status::OK();
 }
 
@@ -6231,17 +6403,37 @@ Status CatalogManager::HandlePlacementUsingPlacementInfo(const PlacementInfoPB&
 }
 
 void CatalogManager::SendCreateTabletRequests(const vector<TabletInfo*>& tablets) {
+  const int batch_size = FLAGS_create_tablets_rpc_batch_size;
+  // Replicas to create with CreateTablets RPCs, by tablet server and table.
+  std::map<std::pair<TabletServerId, TableId>, std::vector<scoped_refptr<TabletInfo>>> batches;
   for (TabletInfo *tablet : tablets) {
     const consensus::RaftConfigPB& config =
         tablet->metadata().dirty().pb.committed_consensus_state().config();
     tablet->set_last_update_time(MonoTime::Now());
     for (const RaftPeerPB& peer : config.peers()) {
+      if (batch_size > 0) {
+        batches[{peer.permanent_uuid(), tablet->table()->id()}].emplace_back(tablet);
+        continue;
+      }
       auto task = std::make_shared<AsyncCreateReplica>(master_, worker_pool_.get(),
           peer.permanent_uuid(), tablet);
       tablet->table()->AddTask(task);
       WARN_NOT_OK(task->Run(), "Failed to send new tablet request");
     }
   }
+
+  for (const auto& batch : batches) {
+    const auto& replicas = batch.second;
+    const auto& table = replicas.front()->table();
+    for (size_t begin = 0; begin < replicas.size(); begin += batch_size) {
+      const size_t end = std::min(replicas.size(), begin + batch_size);
+      auto task = std::make_shared<AsyncCreateReplicas>(
+          master_, worker_pool_.get(), batch.first.first, table,
+          std::vector<scoped_refptr<TabletInfo>>(replicas.begin() + begin, replicas.begin() + end));
+      table->AddTask(task);
+      WARN_NOT_OK(task->Run(), "Failed to send new tablets request");
+    }
+  }
 }
 
 shared_ptr<TSDescriptor> CatalogManager::PickBetterReplicaLocation(
@@ -6395,6 +6587,8 @@ Status CatalogManager::BuildLocationsForTablet(const scoped_refptr<TabletInfo>&
   TSRegistrationPB reg;
 
   TabletInfo::ReplicaMap locs;
+  uint64_t locs_version = 0;
+  bool cached = false;
   consensus::ConsensusStatePB cstate;
   {
     auto l_tablet = tablet->LockForRead();
@@ -6406,15 +6600,22 @@ Status CatalogManager::BuildLocationsForTablet(const scoped_refptr<TabletInfo>&
       return STATUS(ServiceUnavailable, "Tablet not running");
     }
 
-    tablet->GetReplicaLocations(&locs);
-    if (locs.empty() && l_tablet->data().pb.has_committed_consensus_state()) {
-      cstate = l_tablet->data().pb.committed_consensus_state();
+    cached = tablet->GetCachedReplicas(locs_pb->mutable_replicas());
+    if (!cached) {
+      tablet->GetReplicaLocations(&locs, &locs_version);
+      if (locs.empty() && l_tablet->data().pb.has_committed_consensus_state()) {
+        cstate = l_tablet->data().pb.committed_consensus_state();
+      }
     }
 
     locs_pb->mutable_partition()->CopyFrom(tablet->metadata().state().pb.partition());
   }
 
   locs_pb->set_tablet_id(tablet->tablet_id());
+  if (cached) {
+    locs_pb->set_stale(false);
+    return Status::OK();
+  }
   locs_pb->set_stale(locs.empty());
 
   // If the locations are cached.
@@ -6424,11 +6625,14 @@ Status CatalogManager::BuildLocationsForTablet(const scoped_refptr<TabletInfo>&
                    << cstate.config().peers_size();
     }
 
+    std::vector<std::pair<TSDescriptor*, int64_t>> ts_seqnos;
+    ts_seqnos.reserve(locs.size());
     for (const TabletInfo::ReplicaMap::value_type& replica : locs) {
       TabletLocationsPB_ReplicaPB* replica_pb = locs_pb->add_replicas();
       replica_pb->set_role(replica.second.role);
       replica_pb->set_member_type(replica.second.member_type);
       TSInformationPB tsinfo_pb = replica.second.ts_desc->GetTSInformationPB();
+      ts_seqnos.emplace_back(replica.second.ts_desc, tsinfo_pb.tserver_instance().instance_seqno());
 
       TSInfoPB* out_ts_info = replica_pb->mutable_ts_info();
       out_ts_info->set_permanent_uuid(tsinfo_pb.tserver_instance().permanent_uuid());
@@ -6437,6 +6641,7 @@ Status CatalogManager::BuildLocationsForTablet(const scoped_refptr<TabletInfo>&
       *out_ts_info->mutable_capabilities() = std::move(
           *tsinfo_pb.mutable_registration()->mutable_capabilities());
     }
+    tablet->SetCachedReplicas(locs_version, locs_pb->replicas(), std::move(ts_seqnos));
     return Status::OK();
   }
 
@@ -7062,6 +7267,7 @@ void TabletInfo::SetReplicaLocations(ReplicaMap replica_locations) {
   std::lock_guard<simple_spinlock> l(lock_);
   last_update_time_ = MonoTime::Now();
   replica_locations_ = std::move(replica_locations);
+  ++replica_locations_version_;
 }
 
 void TabletInfo::GetReplicaLocations(ReplicaMap* replica_locations) const {
@@ -7069,9 +7275,44 @@ void TabletInfo::GetReplicaLocations(ReplicaMap* replica_locations) const {
   *replica_locations = replica_locations_;
 }
 
+void TabletInfo::GetReplicaLocations(ReplicaMap* replica_locations, uint64_t* version) const {
+  std::lock_guard<simple_spinlock> l(lock_);
+  *replica_locations = replica_locations_;
+  *version = replica_locations_version_;
+}
+
 bool TabletInfo::AddToReplicaLocations(const TabletReplica& replica) {
   std::lock_guard<simple_spinlock> l(lock_);
-  return InsertIfNotPresent(&replica_locations_, replica.ts_desc->permanent_uuid(), replica);
+  if (!InsertIfNotPresent(&replica_locations_, replica.ts_desc->permanent_uuid(), replica)) {
+    return false;
+  }
+  ++replica_locations_version_;
+  return true;
+}
+
+bool TabletInfo::GetCachedReplicas(ReplicasPB* replicas) const {
+  std::lock_guard<simple_spinlock> l(lock_);
+  if (cached_replicas_.empty() || cached_replicas_version_ != replica_locations_version_) {
+    return false;
+  }
+  for (const auto& ts_seqno : cached_replicas_ts_seqnos_) {
+    if (ts_seqno.first->latest_seqno() != ts_seqno.second) {
+      return false;
+    }
+  }
+  *replicas = cached_replicas_;
+  return true;
+}
+
+void TabletInfo::SetCachedReplicas(uint64_t version, const ReplicasPB& replicas,
+                                   std::vector<std::pair<TSDescriptor*, int64_t>> ts_seqnos) {
+  std::lock_guard<simple_spinlock> l(lock_);
+  if (version != replica_locations_version_) {
+    return;
+  }
+  cached_replicas_ = replicas;
+  cached_replicas_version_ = version;
+  cached_replicas_ts_seqnos_ = std::move(ts_seqnos);
 }
 
 void TabletInfo::set_last_update_time(const MonoTime& ts) {
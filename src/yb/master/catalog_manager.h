@@ -32,6 +32,7 @@
 #ifndef YB_MASTER_CATALOG_MANAGER_H
 #define YB_MASTER_CATALOG_MANAGER_H
 
+#include <atomic>
 #include <list>
 #include <map>
 #include <set>
@@ -52,6 +53,7 @@
 #include "yb/gutil/strings/substitute.h"
 #include "yb/master/master_defaults.h"
 #include "yb/master/master.pb.h"
+#include "yb/master/metadata_change_log.h"
 #include "yb/master/ts_descriptor.h"
 #include "yb/master/ts_manager.h"
 #include "yb/master/yql_virtual_table.h"
@@ -224,6 +226,7 @@ class TabletInfo : public RefCountedThreadSafe<TabletInfo>,
                    public MetadataCowWrapper<PersistentTabletInfo> {
  public:
   typedef std::unordered_map<std::string, TabletReplica> ReplicaMap;
+  typedef google::protobuf::RepeatedPtrField<TabletLocationsPB_ReplicaPB> ReplicasPB;
 
   TabletInfo(const scoped_refptr<TableInfo>& table, TabletId tablet_id);
   virtual const TabletId& id() const override { return tablet_id_; }
@@ -236,6 +239,19 @@ class TabletInfo : public RefCountedThreadSafe<TabletInfo>,
   // configuration whose tablet servers have ever heartbeated to this Master.
   void SetReplicaLocations(ReplicaMap replica_locations);
   void GetReplicaLocations(ReplicaMap* replica_locations) const;
+  // Also returns the version of the locations, that changes each time they are updated.
+  void GetReplicaLocations(ReplicaMap* replica_locations, uint64_t* version) const;
+
+  // Replicas of the tablet in the form returned by location lookups, so that lookups don't rebuild
+  // them from the registrations of the tablet servers each time. Returns false if they are not
+  // cached, or the replica locations changed or a tablet server re-registered since.
+  bool GetCachedReplicas(ReplicasPB* replicas) const;
+
+  // Caches replicas built from the replica locations of the given version, unless the locations
+  // changed since. ts_seqnos are the instance sequence numbers of the tablet servers of the
+  // replicas, whose registrations the replicas were built from.
+  void SetCachedReplicas(uint64_t version, const ReplicasPB& replicas,
+                         std::vector<std::pair<TSDescriptor*, int64_t>> ts_seqnos);
 
   // Adds the given replica to the replica_locations_ map.
   // Returns true iff the replica was inserted.
@@ -282,6 +298,15 @@ class TabletInfo : public RefCountedThreadSafe<TabletInfo>,
   // reported. The map is keyed by tablet server UUID.
   ReplicaMap replica_locations_;
 
+  // Incremented each time replica_locations_ change.
+  uint64_t replica_locations_version_ = 0;
+
+  // Replicas cached by SetCachedReplicas, valid while replica_locations_version_ is
+  // cached_replicas_version_ and the tablet servers have the same instance sequence numbers.
+  ReplicasPB cached_replicas_;
+  uint64_t cached_replicas_version_ = 0;
+  std::vector<std::pair<TSDescriptor*, int64_t>> cached_replicas_ts_seqnos_;
+
   // Reported schema version (in-memory only).
   uint32_t reported_schema_version_ = 0;
 
@@ -413,6 +438,16 @@ class TableInfo : public RefCountedThreadSafe<TableInfo>,
   // Allow for showing outstanding tasks in the master UI.
   std::unordered_set<std::shared_ptr<MonitoredTask>> GetTasks();
 
+  // Version of the locations of the tablets of this table, changed together with the tablet
+  // locations version of the catalog manager.
+  uint64_t tablet_locations_version() const {
+    return tablet_locations_version_.load(std::memory_order_acquire);
+  }
+
+  void TabletLocationsChanged() {
+    tablet_locations_version_.fetch_add(1, std::memory_order_acq_rel);
+  }
+
  private:
   friend class RefCountedThreadSafe<TableInfo>;
   ~TableInfo();
@@ -440,6 +475,8 @@ class TableInfo : public RefCountedThreadSafe<TableInfo>,
   // object, or if the CreateTable was successful.
   Status create_table_error_;
 
+  std::atomic<uint64_t> tablet_locations_version_{0};
+
   DISALLOW_COPY_AND_ASSIGN(TableInfo);
 };
 
@@ -841,6 +878,19 @@ class CatalogManager : public tserver::TabletPeerLookupIf {
   // Get the information about an in-progress truncate operation.
   CHECKED_STATUS IsTruncateTableDone(const IsTruncateTableDoneRequestPB* req,
                                      IsTruncateTableDoneResponsePB* resp);
+
+  // Backfill the specified index with the rows of its indexed table, by the leaders of all tablets
+  // of the indexed table in parallel.
+  //
+  // The RPC context is provided for logging/tracing purposes,
+  // but this function does not itself respond to the RPC.
+  CHECKED_STATUS BackfillIndex(const BackfillIndexRequestPB* req,
+                               BackfillIndexResponsePB* resp,
+                               rpc::RpcContext* rpc);
+
+  // Get the information about an in-progress index backfill.
+  CHECKED_STATUS IsBackfillIndexDone(const IsBackfillIndexDoneRequestPB* req,
+                                     IsBackfillIndexDoneResponsePB* resp);
   // Delete the specified table.
   //
   // The RPC context is provided for logging/tracing purposes,
@@ -965,6 +1015,16 @@ class CatalogManager : public tserver::TabletPeerLookupIf {
                                 GetPermissionsResponsePB* resp,
                                 rpc::RpcContext* rpc);
 
+  // Recent changes of the metadata cached by clients.
+  MetadataChangeLog* metadata_change_log() { return &metadata_change_log_; }
+
+  // Version of the running tables and the locations of their tablets, changed whenever a table is
+  // created, altered or deleted, or the replicas of its tablets change. Data derived from them,
+  // like system.partitions, could be cached until it changes.
+  uint64_t tablet_locations_version() const {
+    return tablet_locations_version_.load(std::memory_order_acquire);
+  }
+
   // Set Redis Config
   CHECKED_STATUS RedisConfigSet(const RedisConfigSetRequestPB* req,
                                 RedisConfigSetResponsePB* resp,
@@ -1362,10 +1422,11 @@ class CatalogManager : public tserver::TabletPeerLookupIf {
   CHECKED_STATUS BuildLocationsForTablet(const scoped_refptr<TabletInfo>& tablet,
                                          TabletLocationsPB* locs_pb);
 
-  // Handle one of the tablets in a tablet reported.
-  // Requires that the lock is already held.
+  // Handle one of the tablets in a tablet reported. tablet is the reported tablet looked up in
+  // tablet_map_, or nullptr if it is unknown.
   CHECKED_STATUS HandleReportedTablet(TSDescriptor* ts_desc,
                                       const ReportedTabletPB& report,
+                                      const scoped_refptr<TabletInfo>& tablet,
                                       ReportedTabletUpdatesPB *report_updates);
 
   CHECKED_STATUS ResetTabletReplicasFromReportedConfig(const ReportedTabletPB& report,
@@ -1613,6 +1674,12 @@ class CatalogManager : public tserver::TabletPeerLookupIf {
   typedef rw_spinlock LockType;
   mutable LockType lock_;
 
+  // Lock protecting the roles and permissions: roles_map_, recursive_granted_roles_,
+  // recursive_granted_permissions_, permissions_cache_ and the roles version of security_config_.
+  // Changes of roles and permissions write to the sys catalog while holding it, so they do not use
+  // lock_ to not stall table and tablet lookups. Acquired before lock_ when both are needed.
+  mutable LockType permissions_lock_;
+
   // Note: Namespaces and tables for YSQL databases are identified by their ids only and therefore
   // are not saved in the name maps below.
   TableInfoMap table_ids_map_;         // Table map: table-id -> TableInfo
@@ -1742,6 +1809,14 @@ class CatalogManager : public tserver::TabletPeerLookupIf {
   // Policy for load balancing tablets on tablet servers.
   std::unique_ptr<ClusterLoadBalancer> load_balance_policy_;
 
+  // Changes recorded by this master while it is the leader, watched by clients.
+  MetadataChangeLog metadata_change_log_;
+
+  // Bumps the tablet locations version of the catalog, and of the table if any.
+  void TabletLocationsChanged(TableInfo* table);
+
+  std::atomic<uint64_t> tablet_locations_version_{0};
+
   // Tablet peer for the sys catalog tablet's peer.
   const std::shared_ptr<tablet::TabletPeer> tablet_peer() const;
 
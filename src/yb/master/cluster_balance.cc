@@ -20,6 +20,7 @@
 
 #include "yb/consensus/quorum_util.h"
 #include "yb/master/master.h"
+#include "yb/util/flag_tags.h"
 #include "yb/util/random_util.h"
 
 DEFINE_bool(enable_load_balancing,
@@ -60,6 +61,51 @@ DEFINE_int32(load_balancer_max_concurrent_moves,
              "Maximum number of tablet leaders on tablet servers to move in any one run of the "
              "load balancer.");
 
+DEFINE_bool(load_balancer_leader_load_balancing,
+            false,
+            "Whether to balance tablet leaders across tablet servers by the read and write ops "
+            "per second they serve, instead of by the number of leaders of each table.");
+TAG_FLAG(load_balancer_leader_load_balancing, advanced);
+TAG_FLAG(load_balancer_leader_load_balancing, runtime);
+
+DEFINE_double(load_balancer_leader_load_imbalance_threshold,
+              0.2,
+              "Leaders are moved off the tablet server with the highest leader load only if its "
+              "load exceeds the mean over the tablet servers by more than this fraction.");
+TAG_FLAG(load_balancer_leader_load_imbalance_threshold, advanced);
+TAG_FLAG(load_balancer_leader_load_imbalance_threshold, runtime);
+
+DEFINE_double(load_balancer_leader_load_base_ops,
+              1.0,
+              "Ops per second added to the reported load of each tablet leader, so that idle "
+              "leaders are balanced by their number.");
+TAG_FLAG(load_balancer_leader_load_base_ops, advanced);
+TAG_FLAG(load_balancer_leader_load_base_ops, runtime);
+
+DEFINE_int32(load_balancer_leader_load_move_interval_ms,
+             30 * 1000,
+             "Minimum time between runs of the load balancer that move leaders by their load, so "
+             "that the reported load reflects the previous moves.");
+TAG_FLAG(load_balancer_leader_load_move_interval_ms, advanced);
+TAG_FLAG(load_balancer_leader_load_move_interval_ms, runtime);
+
+DEFINE_bool(load_balancer_size_aware_moves,
+            false,
+            "Whether to weigh tablets by the size of their SST files and WALs, as reported by the "
+            "tablet servers, when moving replicas. The smallest tablets are moved first, since "
+            "they are the cheapest to remote bootstrap, and once replicas are balanced by their "
+            "number, they are also moved to even out the bytes stored by the tablet servers.");
+TAG_FLAG(load_balancer_size_aware_moves, advanced);
+TAG_FLAG(load_balancer_size_aware_moves, runtime);
+
+DEFINE_double(load_balancer_size_imbalance_threshold,
+              0.2,
+              "Replicas are moved to even out the bytes stored by the tablet servers only off a "
+              "tablet server that stores more than the mean over the tablet servers by more than "
+              "this fraction.");
+TAG_FLAG(load_balancer_size_imbalance_threshold, advanced);
+TAG_FLAG(load_balancer_size_imbalance_threshold, runtime);
+
 DECLARE_int32(min_leader_stepdown_retry_interval_ms);
 
 namespace yb {
@@ -79,8 +125,11 @@ Status ClusterLoadBalancer::UpdateTabletInfo(TabletInfo* tablet) {
     PlacementInfoPB pb;
     {
       auto l = tablet->table()->LockForRead();
-      // If we have a custom per-table placement policy, use that.
-      if (l->data().pb.replication_info().has_live_replicas()) {
+      if (state_->read_only_) {
+        pb = GetReadReplicaPlacementInfo(
+            l->data().pb.replication_info(), state_->placement_uuid_);
+      } else if (l->data().pb.replication_info().has_live_replicas()) {
+        // If we have a custom per-table placement policy, use that.
         pb.CopyFrom(l->data().pb.replication_info().live_replicas());
       } else {
         // Otherwise, default to cluster policy.
@@ -93,6 +142,21 @@ Status ClusterLoadBalancer::UpdateTabletInfo(TabletInfo* tablet) {
   return state_->UpdateTablet(tablet);
 }
 
+PlacementInfoPB ClusterLoadBalancer::GetReadReplicaPlacementInfo(
+    const ReplicationInfoPB& table_replication_info, const std::string& placement_uuid) const {
+  for (const auto& read_replicas : table_replication_info.read_replicas()) {
+    if (read_replicas.placement_uuid() == placement_uuid) {
+      return read_replicas;
+    }
+  }
+  for (const auto& read_replicas : GetClusterReplicationInfo().read_replicas()) {
+    if (read_replicas.placement_uuid() == placement_uuid) {
+      return read_replicas;
+    }
+  }
+  return PlacementInfoPB();
+}
+
 const PlacementInfoPB& ClusterLoadBalancer::GetPlacementByTablet(const TabletId& tablet_id) const {
   const auto& table_id = GetTabletMap().at(tablet_id)->table()->id();
   return state_->placement_by_table_.at(table_id);
@@ -180,6 +244,33 @@ void ClusterLoadBalancer::RunLoadBalancer(Options* options) {
   set_remaining(pending_remove_replica_tasks, &remaining_removals);
   set_remaining(pending_stepdown_leader_tasks, &remaining_leader_moves);
 
+  // Leaders are moved by their load at most once per interval, since the load of a moved leader
+  // is only reported by its new tablet server with the next metrics.
+  const bool balance_leader_load = FLAGS_load_balancer_leader_load_balancing;
+  const int leader_moves_allowed = remaining_leader_moves;
+  if (balance_leader_load) {
+    if (last_leader_load_move_time_.Initialized() &&
+        MonoTime::Now() - last_leader_load_move_time_ <
+            MonoDelta::FromMilliseconds(FLAGS_load_balancer_leader_load_move_interval_ms)) {
+      remaining_leader_moves = 0;
+    } else {
+      ComputeLeaderLoads();
+    }
+  }
+
+  if (FLAGS_load_balancer_size_aware_moves) {
+    ComputeTabletSizes();
+  }
+
+  // The live placement is balanced first, then each read replica placement, whose tablet servers
+  // host observers: replicas that receive the log but never vote, so that reads could be scaled
+  // without slowing down commits.
+  const ReplicationInfoPB replication_info = GetClusterReplicationInfo();
+  std::vector<std::string> read_replica_placements;
+  for (const auto& read_replicas : replication_info.read_replicas()) {
+    read_replica_placements.push_back(read_replicas.placement_uuid());
+  }
+
   // Loop over all tables.
   for (const auto& table : GetTableMap()) {
 
@@ -187,62 +278,88 @@ void ClusterLoadBalancer::RunLoadBalancer(Options* options) {
       continue;
     }
 
-    ResetState();
-    state_->options_ = options;
+    for (size_t placement_idx = 0; placement_idx <= read_replica_placements.size();
+         ++placement_idx) {
+      ResetState();
+      state_->options_ = options;
+      if (placement_idx == 0) {
+        state_->placement_uuid_ = replication_info.live_replicas().placement_uuid();
+      } else {
+        state_->placement_uuid_ = read_replica_placements[placement_idx - 1];
+        state_->read_only_ = true;
+      }
+      BalanceTablePlacement(
+          table.first, &remaining_adds, &remaining_removals, &remaining_leader_moves);
+    }
 
-    // Prepare the in-memory structures.
-    YB_WARN_NOT_OK(AnalyzeTablets(table.first), "Skipping load balancing " + table.first);
+    if (remaining_adds == 0 && remaining_removals == 0 && remaining_leader_moves == 0) {
+      break;
+    }
+  }
 
-    // Output parameters are unused in the load balancer, but useful in testing.
-    TabletId out_tablet_id;
-    TabletServerId out_from_ts;
-    TabletServerId out_to_ts;
+  if (balance_leader_load && remaining_leader_moves < leader_moves_allowed) {
+    last_leader_load_move_time_ = MonoTime::Now();
+  }
+}
 
-    // Handle adding and moving replicas.
-    for (int i = 0; i < remaining_adds; ++i) {
-      auto handle_add = HandleAddReplicas(&out_tablet_id, &out_from_ts, &out_to_ts);
-      if (!handle_add.ok()) {
-        LOG(WARNING) << "Skipping add replicas for " << table.first << ": "
-                     << StatusToString(handle_add);
-        break;
-      }
-      if (!*handle_add) {
-        break;
-      }
-      --remaining_adds;
+void ClusterLoadBalancer::BalanceTablePlacement(
+    const TableId& table_id, int* remaining_adds, int* remaining_removals,
+    int* remaining_leader_moves) {
+  // Prepare the in-memory structures.
+  YB_WARN_NOT_OK(AnalyzeTablets(table_id), "Skipping load balancing " + table_id);
+
+  // Output parameters are unused in the load balancer, but useful in testing.
+  TabletId out_tablet_id;
+  TabletServerId out_from_ts;
+  TabletServerId out_to_ts;
+
+  // Handle adding and moving replicas.
+  for (int i = 0; i < *remaining_adds; ++i) {
+    auto handle_add = HandleAddReplicas(&out_tablet_id, &out_from_ts, &out_to_ts);
+    if (!handle_add.ok()) {
+      LOG(WARNING) << "Skipping add replicas for " << table_id << ": "
+                   << StatusToString(handle_add);
+      break;
     }
-
-    // Handle cleanup after over-replication.
-    for (int i = 0; i < remaining_removals; ++i) {
-      auto handle_remove = HandleRemoveReplicas(&out_tablet_id, &out_from_ts);
-      if (!handle_remove.ok()) {
-        LOG(WARNING) << "Skipping remove replicas for " << table.first << ": "
-                     << StatusToString(handle_remove);
-        break;
-      }
-      if (!*handle_remove) {
-        break;
-      }
-      --remaining_removals;
+    if (!*handle_add) {
+      break;
     }
+    --*remaining_adds;
+  }
 
-    // Handle tablet servers with too many leaders.
-    for (int i = 0; i < remaining_leader_moves; ++i) {
-      auto handle_leader = HandleLeaderMoves(&out_tablet_id, &out_from_ts, &out_to_ts);
-      if (!handle_leader.ok()) {
-        LOG(WARNING) << "Skipping leader moves for " << table.first << ": "
-                     << StatusToString(handle_leader);
-        break;
-      }
-      if (!*handle_leader) {
-        break;
-      }
-      --remaining_leader_moves;
+  // Handle cleanup after over-replication.
+  for (int i = 0; i < *remaining_removals; ++i) {
+    auto handle_remove = HandleRemoveReplicas(&out_tablet_id, &out_from_ts);
+    if (!handle_remove.ok()) {
+      LOG(WARNING) << "Skipping remove replicas for " << table_id << ": "
+                   << StatusToString(handle_remove);
+      break;
+    }
+    if (!*handle_remove) {
+      break;
     }
+    --*remaining_removals;
+  }
 
-    if (remaining_adds == 0 && remaining_removals == 0 && remaining_leader_moves == 0) {
+  // Observers never lead, so there are no leaders to balance in read replica placements.
+  if (state_->read_only_) {
+    return;
+  }
+
+  // Handle tablet servers with too many leaders, or too much leader load.
+  for (int i = 0; i < *remaining_leader_moves; ++i) {
+    auto handle_leader = FLAGS_load_balancer_leader_load_balancing
+        ? HandleLeaderLoadMoves(&out_tablet_id, &out_from_ts, &out_to_ts)
+        : HandleLeaderMoves(&out_tablet_id, &out_from_ts, &out_to_ts);
+    if (!handle_leader.ok()) {
+      LOG(WARNING) << "Skipping leader moves for " << table_id << ": "
+                   << StatusToString(handle_leader);
       break;
     }
+    if (!*handle_leader) {
+      break;
+    }
+    --*remaining_leader_moves;
   }
 }
 
@@ -253,6 +370,7 @@ void ClusterLoadBalancer::ResetState() {
 Status ClusterLoadBalancer::AnalyzeTablets(const TableId& table_uuid) {
   // Set the blacklist so we can also mark the tablet servers as we add them up.
   state_->SetBlacklist(GetServerBlacklist());
+  state_->SetReplicationInfo(GetClusterReplicationInfo());
 
   // Loop over live tablet servers to set empty defaults, so we can also have info on those
   // servers that have yet to receive load (have heartbeated to the master, but have not been
@@ -262,6 +380,7 @@ Status ClusterLoadBalancer::AnalyzeTablets(const TableId& table_uuid) {
   for (const auto ts_desc : ts_descs) {
     state_->UpdateTabletServer(ts_desc);
   }
+  state_->UseNonAffinitizedLeaderServersIfNeeded();
 
   vector<scoped_refptr<TabletInfo>> tablets;
   Status s = GetTabletsForTable(table_uuid, &tablets);
@@ -426,6 +545,11 @@ Result<bool> ClusterLoadBalancer::HandleAddReplicas(
 
   // Finally, handle normal load balancing.
   if (!VERIFY_RESULT(GetLoadToMove(out_tablet_id, out_from_ts, out_to_ts))) {
+    // Once the replicas are balanced by their number, even out the bytes stored.
+    if (FLAGS_load_balancer_size_aware_moves &&
+        VERIFY_RESULT(GetSizeToMove(out_tablet_id, out_from_ts, out_to_ts))) {
+      return true;
+    }
     VLOG(1) << "Cannot find any more tablets to move, under current constraints.";
     if (VLOG_IS_ON(1)) {
       DumpSortedLoad();
@@ -530,8 +654,61 @@ Result<bool> ClusterLoadBalancer::ShouldSkipLeaderAsVictim(const TabletId& table
   return false;
 }
 
+Result<bool> ClusterLoadBalancer::GetSizeToMove(
+    TabletId* moving_tablet_id, TabletServerId* from_ts, TabletServerId* to_ts) {
+  const auto& servers = state_->sorted_load_;
+  if (servers.size() < 2) {
+    return false;
+  }
+
+  // Replicas are only moved off the server that stores the most bytes, and only while it stores
+  // more than the mean by more than the threshold.
+  int64_t total_size = 0;
+  const TabletServerId* high_size_uuid = nullptr;
+  for (const auto& ts_uuid : servers) {
+    total_size += ServerSize(ts_uuid);
+    if (high_size_uuid == nullptr || ServerSize(ts_uuid) > ServerSize(*high_size_uuid)) {
+      high_size_uuid = &ts_uuid;
+    }
+  }
+  const int64_t high_size = ServerSize(*high_size_uuid);
+  const double mean_size = static_cast<double>(total_size) / servers.size();
+  if (high_size <= mean_size * (1 + FLAGS_load_balancer_size_imbalance_threshold)) {
+    return false;
+  }
+
+  // Replicas of the table are only moved to servers with fewer of them, so the move does not
+  // unbalance the table by count, and the servers storing the fewest bytes are tried first.
+  std::vector<const TabletServerId*> targets;
+  for (const auto& ts_uuid : servers) {
+    if (state_->GetLoad(ts_uuid) < state_->GetLoad(*high_size_uuid)) {
+      targets.push_back(&ts_uuid);
+    }
+  }
+  std::stable_sort(targets.begin(), targets.end(), [this](const auto* lhs, const auto* rhs) {
+    return ServerSize(*lhs) < ServerSize(*rhs);
+  });
+
+  for (const auto* target : targets) {
+    // The tablet has to be smaller than half of the difference, so that the target does not end up
+    // storing more than the source did. Otherwise a large tablet would keep being moved around.
+    const int64_t max_size = (high_size - ServerSize(*target) - 1) / 2;
+    if (max_size <= 0) {
+      break;
+    }
+    if (VERIFY_RESULT(GetTabletToMove(*high_size_uuid, *target, moving_tablet_id, 1, max_size))) {
+      *from_ts = *high_size_uuid;
+      *to_ts = *target;
+      RETURN_NOT_OK(MoveReplica(*moving_tablet_id, *from_ts, *to_ts));
+      return true;
+    }
+  }
+  return false;
+}
+
 Result<bool> ClusterLoadBalancer::GetTabletToMove(
-    const TabletServerId& from_ts, const TabletServerId& to_ts, TabletId* moving_tablet_id) {
+    const TabletServerId& from_ts, const TabletServerId& to_ts, TabletId* moving_tablet_id,
+    int64_t min_size, int64_t max_size) {
   const auto& from_ts_meta = state_->per_ts_meta_[from_ts];
   set<TabletId> non_over_replicated_tablets;
   set<TabletId> all_tablets;
@@ -556,6 +733,8 @@ Result<bool> ClusterLoadBalancer::GetTabletToMove(
 
   bool same_placement = state_->per_ts_meta_[from_ts].descriptor->placement_id() ==
                         state_->per_ts_meta_[to_ts].descriptor->placement_id();
+  bool found = false;
+  int64_t best_size = 0;
   for (const auto& tablet_id : non_over_replicated_tablets) {
     const auto& placement_info = GetPlacementByTablet(tablet_id);
     // TODO(bogdan): this should be augmented as well to allow dropping by one replica, if still
@@ -575,10 +754,43 @@ Result<bool> ClusterLoadBalancer::GetTabletToMove(
     // If we got here, it means we either have no placement, in which case we can pick any TS, or
     // we have placement and it's valid to move across these two tablet servers, so set the tablet
     // and leave.
+    if (!FLAGS_load_balancer_size_aware_moves) {
+      *moving_tablet_id = tablet_id;
+      return true;
+    }
+    // Otherwise the smallest tablet in the size range is picked, as it is the cheapest to remote
+    // bootstrap.
+    const int64_t size = TabletSize(tablet_id);
+    if (size < min_size || size > max_size || (found && size >= best_size)) {
+      continue;
+    }
     *moving_tablet_id = tablet_id;
-    return true;
+    best_size = size;
+    found = true;
   }
   // If we couldn't select a tablet above, we have to return failure.
+  return found;
+}
+
+bool ClusterLoadBalancer::GetLeaderToMoveToAffinitizedZones(
+    TabletId* moving_tablet_id, TabletServerId* from_ts, TabletServerId* to_ts) {
+  const auto current_time = MonoTime::Now();
+  for (const auto& high_load_uuid : state_->non_affinitized_leader_servers_) {
+    for (const auto& tablet_id : state_->per_ts_meta_[high_load_uuid].leaders) {
+      // The leader is moved to the replica with the least leaders among the servers of the
+      // affinitized zones. If the tablet has no running replica in these zones, its leader stays.
+      for (const auto& low_load_uuid : state_->sorted_leader_load_) {
+        if (!state_->per_ts_meta_[low_load_uuid].running_tablets.count(tablet_id) ||
+            LeaderStepDownFailed(tablet_id, high_load_uuid, low_load_uuid, current_time)) {
+          continue;
+        }
+        *moving_tablet_id = tablet_id;
+        *from_ts = high_load_uuid;
+        *to_ts = low_load_uuid;
+        return true;
+      }
+    }
+  }
   return false;
 }
 
@@ -643,25 +855,8 @@ Result<bool> ClusterLoadBalancer::GetLeaderToMove(
         *from_ts = high_load_uuid;
         *to_ts = low_load_uuid;
 
-        const auto& per_tablet_meta = state_->per_tablet_meta_;
-        const auto tablet_meta_iter = per_tablet_meta.find(tablet_id);
-        if (PREDICT_TRUE(tablet_meta_iter != per_tablet_meta.end())) {
-          const auto& tablet_meta = tablet_meta_iter->second;
-          const auto& stepdown_failures = tablet_meta.leader_stepdown_failures;
-          const auto stepdown_failure_iter = stepdown_failures.find(low_load_uuid);
-          if (stepdown_failure_iter != stepdown_failures.end()) {
-            const auto time_since_failure = current_time - stepdown_failure_iter->second;
-            if (time_since_failure.ToMilliseconds() < FLAGS_min_leader_stepdown_retry_interval_ms) {
-              LOG(INFO) << "Cannot move tablet " << tablet_id << " leader from TS "
-                        << *from_ts << " to TS " << *to_ts << " yet: previous attempt with the same"
-                        << " intended leader failed only " << ToString(time_since_failure)
-                        << " ago (less " << "than " << FLAGS_min_leader_stepdown_retry_interval_ms
-                        << "ms).";
-            }
-            continue;
-          }
-        } else {
-          LOG(WARNING) << "Did not find load balancer metadata for tablet " << *moving_tablet_id;
+        if (LeaderStepDownFailed(tablet_id, high_load_uuid, low_load_uuid, current_time)) {
+          continue;
         }
         return true;
       }
@@ -672,6 +867,158 @@ Result<bool> ClusterLoadBalancer::GetLeaderToMove(
   FATAL_ERROR("Load balancing algorithm reached invalid state!");
 }
 
+bool ClusterLoadBalancer::LeaderStepDownFailed(
+    const TabletId& tablet_id, const TabletServerId& from_ts, const TabletServerId& to_ts,
+    MonoTime current_time) const {
+  const auto& per_tablet_meta = state_->per_tablet_meta_;
+  const auto tablet_meta_iter = per_tablet_meta.find(tablet_id);
+  if (PREDICT_FALSE(tablet_meta_iter == per_tablet_meta.end())) {
+    LOG(WARNING) << "Did not find load balancer metadata for tablet " << tablet_id;
+    return false;
+  }
+  const auto& stepdown_failures = tablet_meta_iter->second.leader_stepdown_failures;
+  const auto stepdown_failure_iter = stepdown_failures.find(to_ts);
+  if (stepdown_failure_iter == stepdown_failures.end()) {
+    return false;
+  }
+  const auto time_since_failure = current_time - stepdown_failure_iter->second;
+  if (time_since_failure.ToMilliseconds() < FLAGS_min_leader_stepdown_retry_interval_ms) {
+    LOG(INFO) << "Cannot move tablet " << tablet_id << " leader from TS "
+              << from_ts << " to TS " << to_ts << " yet: previous attempt with the same"
+              << " intended leader failed only " << ToString(time_since_failure)
+              << " ago (less " << "than " << FLAGS_min_leader_stepdown_retry_interval_ms
+              << "ms).";
+  }
+  return true;
+}
+
+void ClusterLoadBalancer::ComputeLeaderLoads() {
+  tablet_leader_load_.clear();
+  ts_leader_load_.clear();
+
+  TSDescriptorVector ts_descs;
+  GetAllReportedDescriptors(&ts_descs);
+  std::unordered_map<TabletServerId, std::unordered_map<TabletId, double>> reported_loads;
+  for (const auto& ts_desc : ts_descs) {
+    reported_loads[ts_desc->permanent_uuid()] = ts_desc->tablet_leader_ops_per_sec();
+  }
+
+  for (const auto& entry : GetTabletMap()) {
+    TabletInfo::ReplicaMap replicas;
+    entry.second->GetReplicaLocations(&replicas);
+    for (const auto& replica : replicas) {
+      if (replica.second.role != consensus::RaftPeerPB::LEADER) {
+        continue;
+      }
+      double load = FLAGS_load_balancer_leader_load_base_ops;
+      const auto ts_loads = reported_loads.find(replica.first);
+      if (ts_loads != reported_loads.end()) {
+        const auto tablet_load = ts_loads->second.find(entry.first);
+        if (tablet_load != ts_loads->second.end()) {
+          load += tablet_load->second;
+        }
+      }
+      tablet_leader_load_[entry.first] = load;
+      ts_leader_load_[replica.first] += load;
+      break;
+    }
+  }
+}
+
+void ClusterLoadBalancer::ComputeTabletSizes() {
+  tablet_size_.clear();
+  ts_size_.clear();
+
+  TSDescriptorVector ts_descs;
+  GetAllReportedDescriptors(&ts_descs);
+  for (const auto& ts_desc : ts_descs) {
+    auto& ts_size = ts_size_[ts_desc->permanent_uuid()];
+    for (const auto& entry : ts_desc->tablet_sizes()) {
+      const int64_t size = entry.second;
+      ts_size += size;
+      // Replicas of a tablet could differ in size, e.g. until they compact, so the cost of moving
+      // it is estimated by the largest replica.
+      auto& tablet_size = tablet_size_[entry.first];
+      tablet_size = std::max(tablet_size, size);
+    }
+  }
+}
+
+int64_t ClusterLoadBalancer::TabletSize(const TabletId& tablet_id) const {
+  auto it = tablet_size_.find(tablet_id);
+  return it == tablet_size_.end() ? 0 : it->second;
+}
+
+int64_t ClusterLoadBalancer::ServerSize(const TabletServerId& ts_uuid) const {
+  auto it = ts_size_.find(ts_uuid);
+  return it == ts_size_.end() ? 0 : it->second;
+}
+
+Result<bool> ClusterLoadBalancer::GetLeaderLoadToMove(
+    TabletId* moving_tablet_id, TabletServerId* from_ts, TabletServerId* to_ts) {
+  const auto& servers = state_->sorted_leader_load_;
+  if (servers.size() < 2) {
+    return false;
+  }
+
+  auto server_load = [this](const TabletServerId& ts_uuid) {
+    auto it = ts_leader_load_.find(ts_uuid);
+    return it == ts_leader_load_.end() ? 0.0 : it->second;
+  };
+
+  // Leaders are only moved off the server with the highest load, and only while it is loaded
+  // above the mean by more than the threshold.
+  double total_load = 0;
+  const TabletServerId* high_load_uuid = nullptr;
+  for (const auto& ts_uuid : servers) {
+    total_load += server_load(ts_uuid);
+    if (high_load_uuid == nullptr || server_load(ts_uuid) > server_load(*high_load_uuid)) {
+      high_load_uuid = &ts_uuid;
+    }
+  }
+  const double high_load = server_load(*high_load_uuid);
+  const double mean_load = total_load / servers.size();
+  if (high_load <= mean_load * (1 + FLAGS_load_balancer_leader_load_imbalance_threshold)) {
+    return false;
+  }
+
+  // Pick the leader with the largest load that could be moved to a server without making that
+  // server more loaded than the high load server was, i.e. without reversing their order.
+  // Otherwise a single hot leader would keep being moved from server to server.
+  const auto current_time = MonoTime::Now();
+  double best_load = 0;
+  bool found = false;
+  for (const auto& tablet_id : state_->per_ts_meta_[*high_load_uuid].leaders) {
+    auto it = tablet_leader_load_.find(tablet_id);
+    const double load = it == tablet_leader_load_.end()
+        ? FLAGS_load_balancer_leader_load_base_ops : it->second;
+    if (found && load <= best_load) {
+      continue;
+    }
+    const TabletServerId* best_to = nullptr;
+    for (const auto& ts_uuid : servers) {
+      if (ts_uuid == *high_load_uuid ||
+          state_->per_ts_meta_[ts_uuid].running_tablets.count(tablet_id) == 0 ||
+          2 * load > high_load - server_load(ts_uuid) ||
+          (best_to != nullptr && server_load(ts_uuid) >= server_load(*best_to))) {
+        continue;
+      }
+      if (LeaderStepDownFailed(tablet_id, *high_load_uuid, ts_uuid, current_time)) {
+        continue;
+      }
+      best_to = &ts_uuid;
+    }
+    if (best_to != nullptr) {
+      *moving_tablet_id = tablet_id;
+      *from_ts = *high_load_uuid;
+      *to_ts = *best_to;
+      best_load = load;
+      found = true;
+    }
+  }
+  return found;
+}
+
 Result<bool> ClusterLoadBalancer::HandleRemoveReplicas(
     TabletId* out_tablet_id, TabletServerId* out_from_ts) {
   // Give high priority to removing tablets that are not respecting the placement policy.
@@ -751,8 +1098,24 @@ Result<bool> ClusterLoadBalancer::HandleRemoveIfWrongPlacement(
 
 Result<bool> ClusterLoadBalancer::HandleLeaderMoves(
     TabletId* out_tablet_id, TabletServerId* out_from_ts, TabletServerId* out_to_ts) {
-  if (VERIFY_RESULT(GetLeaderToMove(out_tablet_id, out_from_ts, out_to_ts))) {
+  if (GetLeaderToMoveToAffinitizedZones(out_tablet_id, out_from_ts, out_to_ts) ||
+      VERIFY_RESULT(GetLeaderToMove(out_tablet_id, out_from_ts, out_to_ts))) {
+    RETURN_NOT_OK(MoveLeader(*out_tablet_id, *out_from_ts, *out_to_ts));
+    return true;
+  }
+  return false;
+}
+
+Result<bool> ClusterLoadBalancer::HandleLeaderLoadMoves(
+    TabletId* out_tablet_id, TabletServerId* out_from_ts, TabletServerId* out_to_ts) {
+  if (GetLeaderToMoveToAffinitizedZones(out_tablet_id, out_from_ts, out_to_ts) ||
+      VERIFY_RESULT(GetLeaderLoadToMove(out_tablet_id, out_from_ts, out_to_ts))) {
     RETURN_NOT_OK(MoveLeader(*out_tablet_id, *out_from_ts, *out_to_ts));
+    auto it = tablet_leader_load_.find(*out_tablet_id);
+    const double load = it == tablet_leader_load_.end()
+        ? FLAGS_load_balancer_leader_load_base_ops : it->second;
+    ts_leader_load_[*out_from_ts] -= load;
+    ts_leader_load_[*out_to_ts] += load;
     return true;
   }
   return false;
@@ -763,6 +1126,11 @@ Status ClusterLoadBalancer::MoveReplica(
   LOG(INFO) << Substitute("Moving tablet $0 from $1 to $2", tablet_id, from_ts, to_ts);
   SendReplicaChanges(GetTabletMap().at(tablet_id), to_ts, true /* is_add */,
                      true /* should_remove_leader */);
+  if (FLAGS_load_balancer_size_aware_moves) {
+    const int64_t size = TabletSize(tablet_id);
+    ts_size_[from_ts] -= size;
+    ts_size_[to_ts] += size;
+  }
   RETURN_NOT_OK(state_->AddReplica(tablet_id, to_ts));
   return state_->RemoveReplica(tablet_id, from_ts);
 }
@@ -830,6 +1198,11 @@ const PlacementInfoPB& ClusterLoadBalancer::GetClusterPlacementInfo() const {
   return l->data().pb.replication_info().live_replicas();
 }
 
+const ReplicationInfoPB& ClusterLoadBalancer::GetClusterReplicationInfo() const {
+  auto l = catalog_manager_->cluster_config_->LockForRead();
+  return l->data().pb.replication_info();
+}
+
 const BlacklistPB& ClusterLoadBalancer::GetServerBlacklist() const {
   auto l = catalog_manager_->cluster_config_->LockForRead();
   return l->data().pb.server_blacklist();
@@ -896,7 +1269,8 @@ void ClusterLoadBalancer::SendReplicaChanges(
 }
 
 consensus::RaftPeerPB::MemberType ClusterLoadBalancer::GetDefaultMemberType() {
-  return consensus::RaftPeerPB::PRE_VOTER;
+  return state_->read_only_ ? consensus::RaftPeerPB::PRE_OBSERVER
+                            : consensus::RaftPeerPB::PRE_VOTER;
 }
 
 Result<bool> ClusterLoadBalancer::IsConfigMemberInTransitionMode(const TabletId &tablet_id) const {
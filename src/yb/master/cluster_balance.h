@@ -22,6 +22,7 @@
 #include <unordered_set>
 #include <vector>
 #include <atomic>
+#include <limits>
 #include <list>
 
 #include "yb/master/catalog_manager.h"
@@ -106,6 +107,10 @@ class ClusterLoadBalancer {
   // Get the placement information from the cluster configuration.
   virtual const PlacementInfoPB& GetClusterPlacementInfo() const;
 
+  // Get the replication information, i.e. the live and read replica placements, from the cluster
+  // configuration.
+  virtual const ReplicationInfoPB& GetClusterReplicationInfo() const;
+
   // Get the blacklist information.
   virtual const BlacklistPB& GetServerBlacklist() const;
 
@@ -134,7 +139,8 @@ class ClusterLoadBalancer {
       scoped_refptr<TabletInfo> tablet, const TabletServerId& ts_uuid, const bool is_add,
       const bool should_remove_leader, const TabletServerId& new_leader_ts_uuid = "");
 
-  // Returns default member type for newly created replicas (PRE_VOTER).
+  // Returns default member type for newly created replicas: PRE_VOTER, or PRE_OBSERVER when
+  // balancing a read replica placement.
   virtual consensus::RaftPeerPB::MemberType GetDefaultMemberType();
 
   //
@@ -144,6 +150,17 @@ class ClusterLoadBalancer {
   // Recreates the ClusterLoadState object.
   virtual void ResetState();
 
+  // Adds, removes and moves leaders of the replicas of the table in the placement of state_,
+  // within the remaining numbers of operations allowed in this run, which are decremented.
+  void BalanceTablePlacement(
+      const TableId& table_id, int* remaining_adds, int* remaining_removals,
+      int* remaining_leader_moves);
+
+  // Get the placement of the read replicas with the given placement uuid, from the table's
+  // replication info if it defines them, otherwise from the cluster configuration.
+  PlacementInfoPB GetReadReplicaPlacementInfo(
+      const ReplicationInfoPB& table_replication_info, const std::string& placement_uuid) const;
+
   // Goes over the tablet_map_ and the set of live TSDescriptors to compute the load distribution
   // across the tablets for the given table. Returns an OK status if the method succeeded or an
   // error if there are transient errors in updating the internal state.
@@ -198,6 +215,17 @@ class ClusterLoadBalancer {
   virtual Result<bool> HandleLeaderMoves(
       TabletId* out_tablet_id, TabletServerId* out_from_ts, TabletServerId* out_to_ts);
 
+  // Processes any tablet leaders that are on the tablet server with too much leader load, as
+  // computed by ComputeLeaderLoads, and need to be moved.
+  //
+  // Returns true if a move was actually made.
+  Result<bool> HandleLeaderLoadMoves(
+      TabletId* out_tablet_id, TabletServerId* out_from_ts, TabletServerId* out_to_ts);
+
+  // Computes the load of the leader of each tablet in the cluster, from the ops per second
+  // reported by the tablet servers, and the total leader load of each tablet server.
+  void ComputeLeaderLoads();
+
   // Go through sorted_load_ and figure out which tablet to rebalance and from which TS that is
   // serving it to which other TS.
   //
@@ -206,8 +234,35 @@ class ClusterLoadBalancer {
   Result<bool> GetLoadToMove(
       TabletId* moving_tablet_id, TabletServerId* from_ts, TabletServerId* to_ts);
 
+  // Picks a tablet to move from from_ts to to_ts. With FLAGS_load_balancer_size_aware_moves, the
+  // smallest tablet whose size is within [min_size, max_size] is picked.
   Result<bool> GetTabletToMove(
-      const TabletServerId& from_ts, const TabletServerId& to_ts, TabletId* moving_tablet_id);
+      const TabletServerId& from_ts, const TabletServerId& to_ts, TabletId* moving_tablet_id,
+      int64_t min_size = 0, int64_t max_size = std::numeric_limits<int64_t>::max());
+
+  // Go through the tablets of the table on the tablet server that stores the most bytes, and
+  // figure out which one to move to which other TS, to even out the bytes stored across the
+  // cluster.
+  //
+  // Returns true if we could find a tablet to rebalance and sets the three output parameters.
+  // Returns false otherwise.
+  Result<bool> GetSizeToMove(
+      TabletId* moving_tablet_id, TabletServerId* from_ts, TabletServerId* to_ts);
+
+  // Computes the size of each tablet in the cluster, and the bytes stored by each tablet server,
+  // from the sizes reported by the tablet servers.
+  void ComputeTabletSizes();
+
+  int64_t TabletSize(const TabletId& tablet_id) const;
+  int64_t ServerSize(const TabletServerId& ts_uuid) const;
+
+  // Go through the leaders on the tablet servers outside of the affinitized zones, and figure out
+  // which one to move to a TS in these zones that is serving it.
+  //
+  // Returns true if we could find a leader to move and sets the three output parameters.
+  // Returns false otherwise.
+  bool GetLeaderToMoveToAffinitizedZones(
+      TabletId* moving_tablet_id, TabletServerId* from_ts, TabletServerId* to_ts);
 
   // Go through sorted_leader_load_ and figure out which leader to rebalance and from which TS
   // that is serving it to which other TS.
@@ -217,6 +272,20 @@ class ClusterLoadBalancer {
   Result<bool> GetLeaderToMove(
       TabletId* moving_tablet_id, TabletServerId* from_ts, TabletServerId* to_ts);
 
+  // Go through the leaders of the table on the tablet server with the highest leader load and
+  // figure out which one to move to which other TS, to even out the load across the cluster.
+  //
+  // Returns true if we could find a leader to rebalance and sets the three output parameters.
+  // Returns false otherwise.
+  Result<bool> GetLeaderLoadToMove(
+      TabletId* moving_tablet_id, TabletServerId* from_ts, TabletServerId* to_ts);
+
+  // Returns true if moving the tablet leader to to_ts has failed before, so should not be retried
+  // yet.
+  bool LeaderStepDownFailed(
+      const TabletId& tablet_id, const TabletServerId& from_ts, const TabletServerId& to_ts,
+      MonoTime current_time) const;
+
   // Issue the change config and modify the in-memory state for moving a replica from one tablet
   // server to another.
   CHECKED_STATUS MoveReplica(
@@ -271,6 +340,19 @@ class ClusterLoadBalancer {
   // managed by this class, but by the Master's unique_ptr.
   CatalogManager* catalog_manager_;
 
+  // Leader load of each tablet and tablet server in ops per second, when balancing leaders by
+  // their load. Updated with the leader moves made in this run of the algorithm.
+  std::unordered_map<TabletId, double> tablet_leader_load_;
+  std::unordered_map<TabletServerId, double> ts_leader_load_;
+
+  // Time of the last run that moved leaders by their load.
+  MonoTime last_leader_load_move_time_;
+
+  // Size in bytes of each tablet and of the replicas on each tablet server, when moving replicas
+  // by their size. Updated with the replica moves made in this run of the algorithm.
+  std::unordered_map<TabletId, int64_t> tablet_size_;
+  std::unordered_map<TabletServerId, int64_t> ts_size_;
+
   template <class ClusterLoadBalancerClass> friend class TestLoadBalancerBase;
 
  private:
@@ -36,6 +36,10 @@ class ClusterLoadBalancerMocked : public ClusterLoadBalancer {
     return replication_info_.live_replicas();
   }
 
+  const ReplicationInfoPB& GetClusterReplicationInfo() const override {
+    return replication_info_;
+  }
+
   const BlacklistPB& GetServerBlacklist() const override { return blacklist_; }
 
   void SendReplicaChanges(scoped_refptr<TabletInfo> tablet, const TabletServerId& ts_uuid,
@@ -237,6 +237,10 @@ class ClusterLoadState {
 
   void SetBlacklist(const BlacklistPB& blacklist) { blacklist_ = blacklist; }
 
+  void SetReplicationInfo(const ReplicationInfoPB& replication_info) {
+    replication_info_ = replication_info;
+  }
+
   // Update the per-tablet information for this tablet.
   Status UpdateTablet(TabletInfo* tablet) {
     const auto& tablet_id = tablet->id();
@@ -246,9 +250,17 @@ class ClusterLoadState {
     // Get the placement for this tablet.
     const auto& placement = placement_by_table_[tablet->table()->id()];
 
-    // Get replicas for this tablet.
+    // Get replicas for this tablet in the placement being balanced, i.e. voters when balancing
+    // the live placement and observers when balancing a read replica placement.
     TabletInfo::ReplicaMap replica_map;
     GetReplicaLocations(tablet, &replica_map);
+    for (auto it = replica_map.begin(); it != replica_map.end();) {
+      if (it->second.ts_desc->placement_uuid() != placement_uuid_) {
+        it = replica_map.erase(it);
+      } else {
+        ++it;
+      }
+    }
     // Set state information for both the tablet and the tablet server replicas.
     for (const auto& replica : replica_map) {
       const auto& ts_uuid = replica.first;
@@ -371,6 +383,10 @@ class ClusterLoadState {
   }
 
   virtual void UpdateTabletServer(std::shared_ptr<TSDescriptor> ts_desc) {
+    if (ts_desc->placement_uuid() != placement_uuid_) {
+      // Tablet servers of other placements are balanced separately.
+      return;
+    }
     const auto& ts_uuid = ts_desc->permanent_uuid();
     // Set and get, so we can use this for both tablet servers we've added data to, as well as
     // tablet servers that happen to not be serving any tablets, so were not in the map yet.
@@ -394,7 +410,11 @@ class ClusterLoadState {
     if (!is_blacklisted &&
         ts_desc->TimeSinceHeartbeat().ToMilliseconds() <
         FLAGS_leader_balance_unresponsive_timeout_ms) {
-      sorted_leader_load_.push_back(ts_uuid);
+      if (ts_desc->IsAcceptingLeaderLoad(replication_info_)) {
+        sorted_leader_load_.push_back(ts_uuid);
+      } else {
+        non_affinitized_leader_servers_.push_back(ts_uuid);
+      }
     }
 
     if (ts_desc->HasTabletDeletePending()) {
@@ -571,6 +591,14 @@ class ClusterLoadState {
     return Status::OK();
   }
 
+  // Leaders are balanced across the tablet servers of the affinitized zones. If none of them could
+  // lead, e.g. when these zones are down, leaders are balanced across the other tablet servers.
+  void UseNonAffinitizedLeaderServersIfNeeded() {
+    if (sorted_leader_load_.empty()) {
+      sorted_leader_load_.swap(non_affinitized_leader_servers_);
+    }
+  }
+
   virtual void SortLeaderLoad() {
     auto leader_count_comparator = LeaderLoadComparator(this);
     sort(sorted_leader_load_.begin(), sorted_leader_load_.end(), leader_count_comparator);
@@ -657,6 +685,12 @@ class ClusterLoadState {
   // If affinitized leaders is enabled, stores leader load for affinitized nodes.
   vector<TabletServerId> sorted_leader_load_;
 
+  // Responsive tablet servers outside of the affinitized zones, that leaders are moved off.
+  vector<TabletServerId> non_affinitized_leader_servers_;
+
+  // The cached replication info of the cluster, to find the affinitized zones of leaders.
+  ReplicationInfoPB replication_info_;
+
   unordered_map<TableId, TabletToTabletServerMap> pending_add_replica_tasks_;
   unordered_map<TableId, TabletToTabletServerMap> pending_remove_replica_tasks_;
   unordered_map<TableId, TabletToTabletServerMap> pending_stepdown_leader_tasks_;
@@ -664,6 +698,15 @@ class ClusterLoadState {
   // Time at which we started the current round of load balancing.
   MonoTime current_time_;
 
+  // Only tablet servers of the placement with this uuid, and the replicas they host, are
+  // balanced. It is either the uuid of the live placement or of one of the read replica
+  // placements.
+  std::string placement_uuid_;
+
+  // Whether placement_uuid_ is a read replica placement, whose replicas are observers that never
+  // vote nor lead.
+  bool read_only_ = false;
+
   // The knobs we use for tweaking the flow of the algorithm.
   Options* options_;
 
@@ -269,6 +269,18 @@ void MasterServiceImpl::IsTruncateTableDone(const IsTruncateTableDoneRequestPB*
   HandleIn(req, resp, &rpc, &CatalogManager::IsTruncateTableDone);
 }
 
+void MasterServiceImpl::BackfillIndex(const BackfillIndexRequestPB* req,
+                                      BackfillIndexResponsePB* resp,
+                                      RpcContext rpc) {
+  HandleIn(req, resp, &rpc, &CatalogManager::BackfillIndex);
+}
+
+void MasterServiceImpl::IsBackfillIndexDone(const IsBackfillIndexDoneRequestPB* req,
+                                            IsBackfillIndexDoneResponsePB* resp,
+                                            RpcContext rpc) {
+  HandleIn(req, resp, &rpc, &CatalogManager::IsBackfillIndexDone);
+}
+
 void MasterServiceImpl::DeleteTable(const DeleteTableRequestPB* req,
                                     DeleteTableResponsePB* resp,
                                     RpcContext rpc) {
@@ -381,6 +393,24 @@ void MasterServiceImpl::GetPermissions(const GetPermissionsRequestPB* req,
   HandleIn(req, resp, &rpc, &CatalogManager::GetPermissions);
 }
 
+void MasterServiceImpl::WatchMetadataChanges(const WatchMetadataChangesRequestPB* req,
+                                             WatchMetadataChangesResponsePB* resp,
+                                             rpc::RpcContext rpc) {
+  {
+    CatalogManager::ScopedLeaderSharedLock l(server_->catalog_manager());
+    if (!l.CheckIsInitializedAndIsLeaderOrRespond(resp, &rpc)) {
+      return;
+    }
+  }
+
+  // The response is sent when there are changes to respond with, so the leader lock is not held
+  // while waiting for them.
+  auto context = std::make_shared<RpcContext>(std::move(rpc));
+  server_->catalog_manager()->metadata_change_log()->Watch(*req, resp, [context] {
+    context->RespondSuccess();
+  });
+}
+
 void MasterServiceImpl::RedisConfigSet(
     const RedisConfigSetRequestPB* req, RedisConfigSetResponsePB* resp, rpc::RpcContext rpc) {
   HandleIn(req, resp, &rpc, &CatalogManager::RedisConfigSet);
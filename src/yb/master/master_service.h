@@ -69,6 +69,12 @@ class MasterServiceImpl : public MasterServiceIf,
   virtual void IsTruncateTableDone(const IsTruncateTableDoneRequestPB* req,
                                    IsTruncateTableDoneResponsePB* resp,
                                    rpc::RpcContext rpc) override;
+  virtual void BackfillIndex(const BackfillIndexRequestPB* req,
+                             BackfillIndexResponsePB* resp,
+                             rpc::RpcContext rpc) override;
+  virtual void IsBackfillIndexDone(const IsBackfillIndexDoneRequestPB* req,
+                                   IsBackfillIndexDoneResponsePB* resp,
+                                   rpc::RpcContext rpc) override;
   virtual void DeleteTable(const DeleteTableRequestPB* req,
                            DeleteTableResponsePB* resp,
                            rpc::RpcContext rpc) override;
@@ -131,6 +137,10 @@ class MasterServiceImpl : public MasterServiceIf,
                               GetPermissionsResponsePB* resp,
                               rpc::RpcContext rpc) override;
 
+  virtual void WatchMetadataChanges(const WatchMetadataChangesRequestPB* req,
+                                    WatchMetadataChangesResponsePB* resp,
+                                    rpc::RpcContext rpc) override;
+
   virtual void RedisConfigSet(const RedisConfigSetRequestPB* req,
                               RedisConfigSetResponsePB* resp,
                               rpc::RpcContext rpc) override;
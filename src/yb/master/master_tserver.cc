@@ -42,6 +42,10 @@ const scoped_refptr<MetricEntity>& MasterTabletServer::MetricEnt() const {
   return metric_entity_;
 }
 
+const std::shared_ptr<MemTracker>& MasterTabletServer::mem_tracker() const {
+  return master_->mem_tracker();
+}
+
 Status MasterTabletServer::GetTabletPeer(const string& tablet_id,
                                          std::shared_ptr<tablet::TabletPeer>* tablet_peer) const {
   if (tablet_id == kSysCatalogTabletId) {
@@ -0,0 +1,137 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/master/metadata_change_log.h"
+
+#include <gflags/gflags.h>
+
+#include "yb/util/test_macros.h"
+#include "yb/util/test_util.h"
+
+using namespace std::literals;
+
+DECLARE_int32(master_metadata_change_log_size);
+
+namespace yb {
+namespace master {
+
+namespace {
+
+MetadataChangePB MakeChange(const std::string& table_id) {
+  MetadataChangePB change;
+  change.set_type(MetadataChangePB::TABLE_DELETED);
+  change.set_table_id(table_id);
+  return change;
+}
+
+WatchMetadataChangesRequestPB MakeRequest(int64_t epoch, uint64_t last_version,
+                                          uint32_t max_wait_ms = 0) {
+  WatchMetadataChangesRequestPB req;
+  req.set_epoch(epoch);
+  req.set_last_version(last_version);
+  req.set_max_wait_ms(max_wait_ms);
+  return req;
+}
+
+class MetadataChangeLogTest : public YBTest {
+ protected:
+  void SetUp() override {
+    YBTest::SetUp();
+    log_.Reset(1);
+  }
+
+  // Watches the log, returns true if the watch was responded immediately.
+  bool Watch(const WatchMetadataChangesRequestPB& req) {
+    resp_.Clear();
+    responded_ = false;
+    log_.Watch(req, &resp_, [this] { responded_ = true; });
+    return responded_;
+  }
+
+  MetadataChangeLog log_;
+  WatchMetadataChangesResponsePB resp_;
+  bool responded_ = false;
+};
+
+} // namespace
+
+TEST_F(MetadataChangeLogTest, Changes) {
+  log_.Record(MakeChange("a"));
+  log_.Record(MakeChange("b"));
+  log_.Record(MakeChange("c"));
+  ASSERT_EQ(3, log_.version());
+
+  ASSERT_TRUE(Watch(MakeRequest(1, 1)));
+  ASSERT_FALSE(resp_.truncated());
+  ASSERT_EQ(1, resp_.epoch());
+  ASSERT_EQ(3, resp_.version());
+  ASSERT_EQ(2, resp_.changes_size());
+  ASSERT_EQ("b", resp_.changes(0).table_id());
+  ASSERT_EQ(2, resp_.changes(0).version());
+  ASSERT_EQ("c", resp_.changes(1).table_id());
+
+  // Nothing new.
+  ASSERT_TRUE(Watch(MakeRequest(1, 3)));
+  ASSERT_FALSE(resp_.truncated());
+  ASSERT_EQ(0, resp_.changes_size());
+}
+
+TEST_F(MetadataChangeLogTest, Truncated) {
+  FLAGS_master_metadata_change_log_size = 2;
+  log_.Record(MakeChange("a"));
+  log_.Record(MakeChange("b"));
+  log_.Record(MakeChange("c"));
+
+  // The change right after the last version is not kept anymore.
+  ASSERT_TRUE(Watch(MakeRequest(1, 0)));
+  ASSERT_TRUE(resp_.truncated());
+  ASSERT_EQ(3, resp_.version());
+
+  ASSERT_TRUE(Watch(MakeRequest(1, 1)));
+  ASSERT_FALSE(resp_.truncated());
+  ASSERT_EQ(2, resp_.changes_size());
+
+  // Versions of the other epoch are not comparable.
+  log_.Reset(2);
+  ASSERT_TRUE(Watch(MakeRequest(1, 3, 1000)));
+  ASSERT_TRUE(resp_.truncated());
+  ASSERT_EQ(2, resp_.epoch());
+  ASSERT_EQ(0, resp_.version());
+}
+
+TEST_F(MetadataChangeLogTest, Wait) {
+  // The watch waits for the next change.
+  ASSERT_FALSE(Watch(MakeRequest(1, 0, 60000)));
+  log_.Record(MakeChange("a"));
+  ASSERT_TRUE(responded_);
+  ASSERT_EQ(1, resp_.changes_size());
+  ASSERT_EQ("a", resp_.changes(0).table_id());
+
+  // The watch is responded without changes when its wait expires.
+  ASSERT_FALSE(Watch(MakeRequest(1, 1, 60000)));
+  log_.ExpireWaiters(CoarseMonoClock::Now());
+  ASSERT_FALSE(responded_);
+  log_.ExpireWaiters(CoarseMonoClock::Now() + 60s);
+  ASSERT_TRUE(responded_);
+  ASSERT_FALSE(resp_.truncated());
+  ASSERT_EQ(0, resp_.changes_size());
+
+  // The watch of the previous leader is responded when the new epoch starts.
+  ASSERT_FALSE(Watch(MakeRequest(1, 1, 60000)));
+  log_.Reset(2);
+  ASSERT_TRUE(responded_);
+  ASSERT_TRUE(resp_.truncated());
+}
+
+} // namespace master
+} // namespace yb
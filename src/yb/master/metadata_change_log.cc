@@ -0,0 +1,130 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/master/metadata_change_log.h"
+
+#include <algorithm>
+
+#include <gflags/gflags.h>
+
+#include "yb/util/flag_tags.h"
+
+using namespace std::literals;
+
+DEFINE_int32(master_metadata_change_log_size, 10000,
+             "Number of latest metadata changes kept by the leader master for the clients that "
+             "watch them.");
+TAG_FLAG(master_metadata_change_log_size, advanced);
+TAG_FLAG(master_metadata_change_log_size, runtime);
+
+DEFINE_int32(master_metadata_watch_max_wait_ms, 30000,
+             "Maximum time in milliseconds the master holds a watch of metadata changes when "
+             "there are no changes to respond with.");
+TAG_FLAG(master_metadata_watch_max_wait_ms, advanced);
+TAG_FLAG(master_metadata_watch_max_wait_ms, runtime);
+
+namespace yb {
+namespace master {
+
+void MetadataChangeLog::Watch(const WatchMetadataChangesRequestPB& req,
+                              WatchMetadataChangesResponsePB* resp,
+                              WatchCallback callback) {
+  const auto wait_ms = std::min<int64_t>(
+      req.max_wait_ms(), FLAGS_master_metadata_watch_max_wait_ms);
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (wait_ms > 0 && !HasUpdatesUnlocked(req.epoch(), req.last_version())) {
+      waiters_.push_back(Waiter{
+          CoarseMonoClock::Now() + wait_ms * 1ms, req.epoch(), req.last_version(), resp,
+          std::move(callback)});
+      return;
+    }
+    FillResponseUnlocked(req.epoch(), req.last_version(), resp);
+  }
+  callback();
+}
+
+void MetadataChangeLog::Record(MetadataChangePB change) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    change.set_version(++version_);
+    changes_.push_back(std::move(change));
+    const size_t max_size = std::max(FLAGS_master_metadata_change_log_size, 1);
+    while (changes_.size() > max_size) {
+      changes_.pop_front();
+    }
+  }
+  RespondToWaiters([](const Waiter&) { return true; });
+}
+
+void MetadataChangeLog::Reset(int64_t epoch) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    epoch_ = epoch;
+    version_ = 0;
+    changes_.clear();
+  }
+  RespondToWaiters([](const Waiter&) { return true; });
+}
+
+void MetadataChangeLog::ExpireWaiters(CoarseTimePoint now) {
+  RespondToWaiters([now](const Waiter& waiter) { return waiter.deadline <= now; });
+}
+
+uint64_t MetadataChangeLog::version() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return version_;
+}
+
+bool MetadataChangeLog::HasUpdatesUnlocked(int64_t epoch, uint64_t last_version) const {
+  return epoch != epoch_ || last_version != version_;
+}
+
+void MetadataChangeLog::FillResponseUnlocked(
+    int64_t epoch, uint64_t last_version, WatchMetadataChangesResponsePB* resp) const {
+  resp->set_epoch(epoch_);
+  resp->set_version(version_);
+  // Changes are kept without gaps, so the client missed some of them if the change right after
+  // its last version is not kept anymore.
+  const uint64_t first_version = changes_.empty() ? version_ + 1 : changes_.front().version();
+  if (epoch != epoch_ || last_version > version_ || last_version + 1 < first_version) {
+    resp->set_truncated(true);
+    return;
+  }
+  for (auto it = changes_.begin() + (last_version + 1 - first_version); it != changes_.end();
+       ++it) {
+    *resp->add_changes() = *it;
+  }
+}
+
+void MetadataChangeLog::RespondToWaiters(const std::function<bool(const Waiter&)>& filter) {
+  // Callbacks are invoked out of the lock, since they send the responses.
+  std::vector<Waiter> ready;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = std::partition(waiters_.begin(), waiters_.end(), [&filter](const Waiter& waiter) {
+      return !filter(waiter);
+    });
+    for (auto i = it; i != waiters_.end(); ++i) {
+      FillResponseUnlocked(i->epoch, i->last_version, i->resp);
+      ready.push_back(std::move(*i));
+    }
+    waiters_.erase(it, waiters_.end());
+  }
+  for (auto& waiter : ready) {
+    waiter.callback();
+  }
+}
+
+} // namespace master
+} // namespace yb
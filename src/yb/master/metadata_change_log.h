@@ -0,0 +1,86 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#ifndef YB_MASTER_METADATA_CHANGE_LOG_H
+#define YB_MASTER_METADATA_CHANGE_LOG_H
+
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+#include "yb/master/master.pb.h"
+
+#include "yb/util/monotime.h"
+
+namespace yb {
+namespace master {
+
+// Recent changes of the metadata cached by clients, so clients could learn about them by long
+// polling the leader master instead of finding out on a failed request.
+//
+// Changes are assigned consecutive versions within an epoch, which is the term of the leader
+// master, so versions of different leaders are never confused. At most
+// FLAGS_master_metadata_change_log_size latest changes are kept, a client that is behind the
+// oldest of them is told to drop all of its cached metadata.
+class MetadataChangeLog {
+ public:
+  typedef std::function<void()> WatchCallback;
+
+  // Fills resp with the changes after the version of req and invokes callback. It happens
+  // immediately when there are such changes, otherwise when a change is recorded or when the wait
+  // requested by req expires. resp should stay valid until callback is invoked.
+  void Watch(const WatchMetadataChangesRequestPB& req,
+             WatchMetadataChangesResponsePB* resp,
+             WatchCallback callback);
+
+  // Records the change, assigning the next version to it.
+  void Record(MetadataChangePB change);
+
+  // Drops all changes and starts a new epoch, should be invoked when the master becomes leader.
+  void Reset(int64_t epoch);
+
+  // Responds to the watches whose wait has expired by now.
+  void ExpireWaiters(CoarseTimePoint now);
+
+  uint64_t version();
+
+ private:
+  struct Waiter {
+    CoarseTimePoint deadline;
+    int64_t epoch;
+    uint64_t last_version;
+    WatchMetadataChangesResponsePB* resp;
+    WatchCallback callback;
+  };
+
+  // Returns true if there is anything to respond to a watch after last_version of epoch.
+  bool HasUpdatesUnlocked(int64_t epoch, uint64_t last_version) const;
+
+  void FillResponseUnlocked(
+      int64_t epoch, uint64_t last_version, WatchMetadataChangesResponsePB* resp) const;
+
+  // Responds to the waiters selected by filter.
+  void RespondToWaiters(const std::function<bool(const Waiter&)>& filter);
+
+  std::mutex mutex_;
+  int64_t epoch_ = 0;
+  uint64_t version_ = 0;
+  std::deque<MetadataChangePB> changes_;
+  std::vector<Waiter> waiters_;
+};
+
+} // namespace master
+} // namespace yb
+
+#endif // YB_MASTER_METADATA_CHANGE_LOG_H
@@ -103,6 +103,7 @@ Status TSDescriptor::RegisterUnlocked(
   latest_seqno_ = instance.instance_seqno();
   // After re-registering, make the TS re-report its tablets.
   has_tablet_report_ = false;
+  last_tablet_report_seq_no_ = -1;
 
   registration_.reset(new TSRegistrationPB(registration));
   placement_id_ = generate_placement_id(registration.common().cloud_info());
@@ -160,6 +161,17 @@ void TSDescriptor::set_has_tablet_report(bool has_report) {
   has_tablet_report_ = has_report;
 }
 
+bool TSDescriptor::TrackTabletReportSeqNo(int32_t seq_no, bool is_incremental) {
+  std::lock_guard<simple_spinlock> l(lock_);
+  // A skipped sequence number is a report that was never processed. Its tablets stay dirty on the
+  // tablet server until a report is acknowledged, so they are reported again by the next one.
+  if (is_incremental && seq_no <= last_tablet_report_seq_no_) {
+    return false;
+  }
+  last_tablet_report_seq_no_ = seq_no;
+  return true;
+}
+
 void TSDescriptor::DecayRecentReplicaCreationsUnlocked() {
   // In most cases, we won't have any recent replica creations, so
   // we don't need to bother calling the clock, etc.
@@ -242,7 +254,16 @@ Result<HostPort> TSDescriptor::GetHostPortUnlocked() const {
 }
 
 bool TSDescriptor::IsAcceptingLeaderLoad(const ReplicationInfoPB& replication_info) const {
-  return true;
+  if (replication_info.affinitized_leaders().empty()) {
+    return true;
+  }
+  const auto id = placement_id();
+  for (const auto& cloud_info : replication_info.affinitized_leaders()) {
+    if (generate_placement_id(cloud_info) == id) {
+      return true;
+    }
+  }
+  return false;
 }
 
 void TSDescriptor::UpdateMetrics(const TServerMetricsPB& metrics) {
@@ -253,6 +274,20 @@ void TSDescriptor::UpdateMetrics(const TServerMetricsPB& metrics) {
   tsMetrics_.read_ops_per_sec = metrics.read_ops_per_sec();
   tsMetrics_.write_ops_per_sec = metrics.write_ops_per_sec();
   tsMetrics_.uptime_seconds = metrics.uptime_seconds();
+  tsMetrics_.tablet_leader_ops_per_sec.clear();
+  for (const auto& tablet_load : metrics.tablet_leader_loads()) {
+    tsMetrics_.tablet_leader_ops_per_sec[tablet_load.tablet_id()] =
+        tablet_load.read_ops_per_sec() + tablet_load.write_ops_per_sec();
+  }
+  tsMetrics_.tablet_sizes.clear();
+  tsMetrics_.tablet_data_sizes.clear();
+  for (const auto& tablet_size : metrics.tablet_sizes()) {
+    tsMetrics_.tablet_sizes[tablet_size.tablet_id()] =
+        tablet_size.sst_file_size() + tablet_size.wal_file_size();
+    auto& data_size = tsMetrics_.tablet_data_sizes[tablet_size.tablet_id()];
+    data_size.sst_file_size = tablet_size.sst_file_size();
+    data_size.estimated_num_keys = tablet_size.estimated_num_keys();
+  }
 }
 
 bool TSDescriptor::HasTabletDeletePending() const {
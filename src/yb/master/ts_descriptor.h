@@ -35,6 +35,7 @@
 #include <memory>
 #include <mutex>
 #include <string>
+#include <unordered_map>
 
 #include "yb/gutil/gscoped_ptr.h"
 
@@ -108,6 +109,11 @@ class TSDescriptor {
   bool has_tablet_report() const;
   void set_has_tablet_report(bool has_report);
 
+  // Records the sequence number of a tablet report before it is processed. Returns false if the
+  // report is an incremental one that is not newer than the last report processed, e.g. a
+  // delayed retry, so its changes could be older than those already applied.
+  bool TrackTabletReportSeqNo(int32_t seq_no, bool is_incremental);
+
   // Returns TSRegistrationPB for this TSDescriptor.
   TSRegistrationPB GetRegistration() const;
 
@@ -127,7 +133,8 @@ class TSDescriptor {
 
   bool IsRunningOn(const HostPortPB& hp) const;
 
-  // Should this ts have any leader load on it.
+  // Should this ts have any leader load on it. If the replication info has affinitized leaders,
+  // only the tablet servers in those zones should.
   virtual bool IsAcceptingLeaderLoad(const ReplicationInfoPB& replication_info) const;
 
   // Return an RPC proxy to a service.
@@ -226,6 +233,45 @@ class TSDescriptor {
     return tsMetrics_.uptime_seconds;
   }
 
+  // Read and write ops per second of each tablet led by this tablet server, as of its last report.
+  std::unordered_map<std::string, double> tablet_leader_ops_per_sec() {
+    std::lock_guard<simple_spinlock> l(lock_);
+    return tsMetrics_.tablet_leader_ops_per_sec;
+  }
+
+  void set_tablet_leader_ops_per_sec(const std::string& tablet_id, double ops_per_sec) {
+    std::lock_guard<simple_spinlock> l(lock_);
+    tsMetrics_.tablet_leader_ops_per_sec[tablet_id] = ops_per_sec;
+  }
+
+  // Size of the SST files and WAL of each tablet replica hosted by this tablet server, as of its
+  // last report.
+  std::unordered_map<std::string, uint64_t> tablet_sizes() {
+    std::lock_guard<simple_spinlock> l(lock_);
+    return tsMetrics_.tablet_sizes;
+  }
+
+  void set_tablet_size(const std::string& tablet_id, uint64_t size) {
+    std::lock_guard<simple_spinlock> l(lock_);
+    tsMetrics_.tablet_sizes[tablet_id] = size;
+  }
+
+  struct TabletDataSize {
+    uint64_t sst_file_size = 0;
+    uint64_t estimated_num_keys = 0;
+  };
+
+  // Returns false if the size of the data of the tablet was not reported by this tablet server.
+  bool GetTabletDataSize(const std::string& tablet_id, TabletDataSize* size) {
+    std::lock_guard<simple_spinlock> l(lock_);
+    auto it = tsMetrics_.tablet_data_sizes.find(tablet_id);
+    if (it == tsMetrics_.tablet_data_sizes.end()) {
+      return false;
+    }
+    *size = it->second;
+    return true;
+  }
+
   void UpdateMetrics(const TServerMetricsPB& metrics);
 
   void ClearMetrics() {
@@ -288,6 +334,12 @@ class TSDescriptor {
 
     uint64_t uptime_seconds = 0;
 
+    std::unordered_map<std::string, double> tablet_leader_ops_per_sec;
+
+    std::unordered_map<std::string, uint64_t> tablet_sizes;
+
+    std::unordered_map<std::string, TabletDataSize> tablet_data_sizes;
+
     void ClearMetrics() {
       total_memory_usage = 0;
       total_sst_file_size = 0;
@@ -295,6 +347,9 @@ class TSDescriptor {
       read_ops_per_sec = 0;
       write_ops_per_sec = 0;
       uptime_seconds = 0;
+      tablet_leader_ops_per_sec.clear();
+      tablet_sizes.clear();
+      tablet_data_sizes.clear();
     }
   };
 
@@ -311,6 +366,9 @@ class TSDescriptor {
   // Set to true once this instance has reported all of its tablets.
   bool has_tablet_report_;
 
+  // Sequence number of the last tablet report processed since the registration, -1 if none.
+  int32_t last_tablet_report_seq_no_ = -1;
+
   // The number of times this tablet server has recently been selected to create a
   // tablet replica. This value decays back to 0 over time.
   double recent_replica_creations_;
@@ -88,6 +88,22 @@ template<> struct GetValueHelper<int32_t> {
   }
 };
 
+template<> struct GetValueHelper<int64_t> {
+
+  static QLValuePB Apply(const int64_t intval, const DataType data_type) {
+    QLValuePB value_pb;
+    switch (data_type) {
+      case INT64:
+        value_pb.set_int64_value(intval);
+        break;
+      default:
+        LOG(ERROR) << "unexpected int64 type " << data_type;
+        break;
+    }
+    return value_pb;
+  }
+};
+
 template<> struct GetValueHelper<InetAddress> {
 
   static QLValuePB Apply(const InetAddress& inet_val, const DataType data_type) {
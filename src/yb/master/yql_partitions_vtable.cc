@@ -13,24 +13,106 @@
 
 #include "yb/master/yql_partitions_vtable.h"
 
+#include <unordered_map>
+
+#include <gflags/gflags.h>
+
 #include "yb/common/ql_value.h"
 #include "yb/master/catalog_manager.h"
 #include "yb/master/master_util.h"
+#include "yb/rpc/messenger.h"
+#include "yb/util/flag_tags.h"
+#include "yb/util/net/dns_resolver.h"
+
+DEFINE_int32(partitions_vtable_snapshot_refresh_secs, 60,
+             "Time in seconds the snapshot of system.partitions is served before it is rebuilt "
+             "even when no tablet locations changed, so changed addresses of tablet servers are "
+             "picked up. 0 disables the snapshot.");
+TAG_FLAG(partitions_vtable_snapshot_refresh_secs, advanced);
+TAG_FLAG(partitions_vtable_snapshot_refresh_secs, runtime);
 
 namespace yb {
 namespace master {
 
+namespace {
+
+// Replicas are advertised by the same address as their tablet servers in system.peers and
+// system.local, i.e. the broadcast address if any, so drivers could match them with the hosts
+// they are connected to.
+std::shared_future<Result<InetAddress>> PublicIpFuture(const TSInfoPB& ts_info,
+                                                       Resolver* resolver) {
+  const auto& addresses = ts_info.broadcast_addresses().empty()
+      ? ts_info.private_rpc_addresses() : ts_info.broadcast_addresses();
+  if (addresses.empty()) {
+    std::promise<Result<InetAddress>> promise;
+    promise.set_value(STATUS_FORMAT(
+        IllegalState, "Tablet server $0 doesn't have any rpc addresses registered",
+        ts_info.permanent_uuid()));
+    return promise.get_future();
+  }
+  return ResolveDnsFuture(addresses[0].host(), resolver);
+}
+
+} // namespace
+
 YQLPartitionsVTable::YQLPartitionsVTable(const Master* const master)
-    : YQLVirtualTable(master::kSystemPartitionsTableName, master, CreateSchema()) {
+    : YQLVirtualTable(master::kSystemPartitionsTableName, master, CreateSchema()),
+      resolver_(new Resolver(master->messenger()->io_service())) {
 }
 
+YQLPartitionsVTable::~YQLPartitionsVTable() = default;
+
 Status YQLPartitionsVTable::RetrieveData(const QLReadRequestPB& request,
                                          std::unique_ptr<QLRowBlock>* vtable) const {
-  vtable->reset(new QLRowBlock(schema_));
-  std::vector<scoped_refptr<TableInfo> > tables;
   CatalogManager* catalog_manager = master_->catalog_manager();
+  // Versions are read before the data they cover, so a change made while the rows are built
+  // leaves them stale rather than marking stale rows as up to date.
+  const uint64_t version = catalog_manager->tablet_locations_version();
+  const auto now = CoarseMonoClock::Now();
+  const bool use_snapshot = FLAGS_partitions_vtable_snapshot_refresh_secs > 0;
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  const bool expired = !use_snapshot || !snapshot_ || now >= snapshot_expiration_;
+  if (!expired && version == snapshot_version_) {
+    vtable->reset(new QLRowBlock(*snapshot_));
+    return Status::OK();
+  }
+
+  struct Entry {
+    TableRows* table_rows;
+    std::string keyspace_name;
+    std::string table_name;
+    std::string tablet_id;
+    TabletLocationsPB locations;
+  };
+
+  std::vector<Entry> entries;
+  // Addresses of tablet servers, each one is resolved once for all its replicas.
+  std::unordered_map<std::string, std::shared_future<Result<InetAddress>>> ts_ips;
+
+  std::vector<scoped_refptr<TableInfo> > tables;
   catalog_manager->GetAllTables(&tables, true /* includeOnlyRunningTables */);
+  std::vector<TableRows*> tables_rows;
+  std::unordered_map<TableId, TableRows> new_tables;
   for (const scoped_refptr<TableInfo>& table : tables) {
+    // Skip non-YQL tables.
+    if (!CatalogManager::IsYcqlTable(*table)) {
+      continue;
+    }
+
+    const uint64_t table_version = table->tablet_locations_version();
+    TableRows& table_rows = new_tables[table->id()];
+    tables_rows.push_back(&table_rows);
+    // Rows of the same table object at the same version are still valid. Tables are compared by
+    // object, since they are loaded again with their versions reset when the leader changes.
+    auto it = snapshot_tables_.find(table->id());
+    if (!expired && it != snapshot_tables_.end() && it->second.table == table &&
+        it->second.version == table_version) {
+      table_rows = std::move(it->second);
+      continue;
+    }
+    table_rows.table = table;
+    table_rows.version = table_version;
 
     // Get namespace for table.
     NamespaceIdentifierPB nsId;
@@ -38,11 +120,6 @@ Status YQLPartitionsVTable::RetrieveData(const QLReadRequestPB& request,
     scoped_refptr<NamespaceInfo> nsInfo;
     RETURN_NOT_OK(catalog_manager->FindNamespace(nsId, &nsInfo));
 
-    // Skip non-YQL tables.
-    if (!CatalogManager::IsYcqlTable(*table)) {
-      continue;
-    }
-
     // Get tablets for table.
     std::vector<scoped_refptr<TabletInfo> > tablets;
     table->GetAllTablets(&tablets);
@@ -54,36 +131,75 @@ Status YQLPartitionsVTable::RetrieveData(const QLReadRequestPB& request,
         continue;
       }
 
-      QLRow& row = (*vtable)->Extend();
-      RETURN_NOT_OK(SetColumnValue(kKeyspaceName, nsInfo->name(), &row));
-      RETURN_NOT_OK(SetColumnValue(kTableName, table->name(), &row));
-
-      const PartitionPB& partition = tabletLocationsPB.partition();
-      RETURN_NOT_OK(SetColumnValue(kStartKey, partition.partition_key_start(), &row));
-      RETURN_NOT_OK(SetColumnValue(kEndKey, partition.partition_key_end(), &row));
-
-      // Note: tablet id is in host byte order.
-      Uuid uuid;
-      RETURN_NOT_OK(uuid.FromHexString(tablet->id()));
-      RETURN_NOT_OK(SetColumnValue(kId, uuid, &row));
-
-      // Get replicas for tablet.
-      QLValuePB replica_addresses;
-      QLMapValuePB *map_value = replica_addresses.mutable_map_value();
-      for (const auto replica : tabletLocationsPB.replicas()) {
-        InetAddress addr;
-        RETURN_NOT_OK(addr.FromString(DesiredHostPort(replica.ts_info(), CloudInfoPB()).host()));
-        QLValue elem_key;
-        elem_key.set_inetaddress_value(addr);
-        *map_value->add_keys() = elem_key.value();
-
-        const string& role = consensus::RaftPeerPB::Role_Name(replica.role());
-        QLValue elem_value;
-        elem_value.set_string_value(role);
-        *map_value->add_values() = elem_value.value();
+      for (const auto& replica : tabletLocationsPB.replicas()) {
+        const auto& ts_info = replica.ts_info();
+        if (ts_ips.count(ts_info.permanent_uuid()) == 0) {
+          ts_ips.emplace(ts_info.permanent_uuid(), PublicIpFuture(ts_info, resolver_.get()));
+        }
       }
-      RETURN_NOT_OK(SetColumnValue(kReplicaAddresses, replica_addresses, &row));
+      entries.push_back({&table_rows, nsInfo->name(), table->name(), tablet->id(),
+                         std::move(tabletLocationsPB)});
+    }
+  }
+
+  const auto row_schema = std::make_shared<const Schema>(schema_);
+  for (const auto& entry : entries) {
+    QLRow row(row_schema);
+    RETURN_NOT_OK(SetColumnValue(kKeyspaceName, entry.keyspace_name, &row));
+    RETURN_NOT_OK(SetColumnValue(kTableName, entry.table_name, &row));
+
+    const PartitionPB& partition = entry.locations.partition();
+    RETURN_NOT_OK(SetColumnValue(kStartKey, partition.partition_key_start(), &row));
+    RETURN_NOT_OK(SetColumnValue(kEndKey, partition.partition_key_end(), &row));
+
+    // Note: tablet id is in host byte order.
+    Uuid uuid;
+    RETURN_NOT_OK(uuid.FromHexString(entry.tablet_id));
+    RETURN_NOT_OK(SetColumnValue(kId, uuid, &row));
+
+    // Get replicas for tablet.
+    QLValuePB replica_addresses;
+    QLMapValuePB *map_value = replica_addresses.mutable_map_value();
+    for (const auto& replica : entry.locations.replicas()) {
+      const auto& ts_info = replica.ts_info();
+      const auto& addr = ts_ips[ts_info.permanent_uuid()].get();
+      // Skip the replica rather than failing the whole query, as system.peers skips its server.
+      if (!addr.ok()) {
+        LOG(ERROR) << "Failed to get ip of " << ts_info.ShortDebugString() << ": "
+                   << addr.status();
+        continue;
+      }
+      QLValue elem_key;
+      elem_key.set_inetaddress_value(*addr);
+      *map_value->add_keys() = elem_key.value();
+
+      const string& role = consensus::RaftPeerPB::Role_Name(replica.role());
+      QLValue elem_value;
+      elem_value.set_string_value(role);
+      *map_value->add_values() = elem_value.value();
+    }
+    RETURN_NOT_OK(SetColumnValue(kReplicaAddresses, replica_addresses, &row));
+    entry.table_rows->rows.push_back(std::move(row));
+  }
+
+  vtable->reset(new QLRowBlock(schema_));
+  for (const TableRows* table_rows : tables_rows) {
+    for (const QLRow& row : table_rows->rows) {
+      (*vtable)->rows().push_back(row);
+    }
+  }
+
+  if (use_snapshot) {
+    snapshot_.reset(new QLRowBlock(**vtable));
+    snapshot_version_ = version;
+    if (expired) {
+      snapshot_expiration_ =
+          now + std::chrono::seconds(FLAGS_partitions_vtable_snapshot_refresh_secs);
     }
+    snapshot_tables_ = std::move(new_tables);
+  } else {
+    snapshot_.reset();
+    snapshot_tables_.clear();
   }
 
   return Status::OK();
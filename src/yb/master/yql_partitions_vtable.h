@@ -14,16 +14,30 @@
 #ifndef YB_MASTER_YQL_PARTITIONS_VTABLE_H
 #define YB_MASTER_YQL_PARTITIONS_VTABLE_H
 
+#include <mutex>
+#include <unordered_map>
+
 #include "yb/master/master.h"
 #include "yb/master/yql_virtual_table.h"
 
+#include "yb/util/monotime.h"
+#include "yb/util/net/net_fwd.h"
+
 namespace yb {
 namespace master {
 
+class TableInfo;
+
 // VTable implementation of system.partitions.
+//
+// Drivers read the table on every connect and topology refresh, so the rows are served from a
+// snapshot while the tablet locations version of the catalog manager stays the same. When it
+// changes, only the rows of the tables whose own version changed are rebuilt.
 class YQLPartitionsVTable : public YQLVirtualTable {
  public:
   explicit YQLPartitionsVTable(const Master* const master);
+  ~YQLPartitionsVTable();
+
   CHECKED_STATUS RetrieveData(const QLReadRequestPB& request,
                               std::unique_ptr<QLRowBlock>* vtable) const;
  protected:
@@ -35,6 +49,23 @@ class YQLPartitionsVTable : public YQLVirtualTable {
   static constexpr const char* const kEndKey = "end_key";
   static constexpr const char* const kId = "id";
   static constexpr const char* const kReplicaAddresses = "replica_addresses";
+
+  // Rows of a table in the snapshot, built at the version of the table.
+  struct TableRows {
+    scoped_refptr<TableInfo> table;
+    uint64_t version = 0;
+    std::vector<QLRow> rows;
+  };
+
+  std::unique_ptr<Resolver> resolver_;
+
+  // Serializes the rebuilds, so concurrent queries of a stale snapshot rebuild it once.
+  mutable std::mutex mutex_;
+  mutable std::unique_ptr<QLRowBlock> snapshot_;
+  mutable uint64_t snapshot_version_ = 0;
+  // Addresses of tablet servers are resolved again once the snapshot expires.
+  mutable CoarseTimePoint snapshot_expiration_;
+  mutable std::unordered_map<TableId, TableRows> snapshot_tables_;
 };
 
 }  // namespace master
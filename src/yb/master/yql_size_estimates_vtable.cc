@@ -17,6 +17,31 @@
 namespace yb {
 namespace master {
 
+namespace {
+
+// Returns the size of the data of the tablet, as reported by its leader or, when the leader did
+// not report it yet, by the replica with the largest SST files.
+TSDescriptor::TabletDataSize GetTabletDataSize(const TabletInfo& tablet) {
+  TabletInfo::ReplicaMap replicas;
+  tablet.GetReplicaLocations(&replicas);
+  TSDescriptor::TabletDataSize result;
+  for (const auto& replica : replicas) {
+    TSDescriptor::TabletDataSize size;
+    if (!replica.second.ts_desc->GetTabletDataSize(tablet.tablet_id(), &size)) {
+      continue;
+    }
+    if (replica.second.role == consensus::RaftPeerPB::LEADER) {
+      return size;
+    }
+    if (size.sst_file_size > result.sst_file_size) {
+      result = size;
+    }
+  }
+  return result;
+}
+
+} // namespace
+
 YQLSizeEstimatesVTable::YQLSizeEstimatesVTable(const Master* const master)
     : YQLVirtualTable(master::kSystemSizeEstimatesTableName, master, CreateSchema()) {
 }
@@ -72,14 +97,26 @@ Status YQLSizeEstimatesVTable::RetrieveData(const QLReadRequestPB& request,
       string cql_end_hash = std::to_string(YBPartition::YBToCqlHashCode(yb_end_hash));
       RETURN_NOT_OK(SetColumnValue(kRangeEnd, cql_end_hash, &row));
 
-      // TODO: These values should eventually be reasonable estimates.
-      // For now using 0 as defaults which should mean that clients will use their own defaults
-      // (i.e. minimums) for number of splits -- typically one split per YugaByte tablet.
+      // The estimates are based on the sizes reported by the tablet servers in their heartbeats.
+      // Until a tablet is reported, 0 is used, which means that clients will use their own
+      // defaults (i.e. minimums) for number of splits -- typically one split per tablet.
+      //
+      // Each non-key column of a row and its liveness column are stored as separate keys, so the
+      // number of rows is estimated from the number of keys. The number of partition (i.e. hash)
+      // keys is estimated by the number of rows, which overestimates it for tables with clustering
+      // columns, but the total size of the tablet, that clients split the work by, stays right.
+      const auto data_size = GetTabletDataSize(*tablet);
+      const uint64_t keys_per_row = schema.num_columns() - schema.num_key_columns() + 1;
+      const uint64_t partitions_count = data_size.estimated_num_keys / keys_per_row;
+      const uint64_t mean_partition_size =
+          partitions_count == 0 ? 0 : data_size.sst_file_size / partitions_count;
 
       // The estimated average size in bytes of all data for each partition (i.e. hash) key.
-      RETURN_NOT_OK(SetColumnValue(kMeanPartitionSize, 0, &row));
+      RETURN_NOT_OK(SetColumnValue(
+          kMeanPartitionSize, static_cast<int64_t>(mean_partition_size), &row));
       // The estimated number of partition (i.e. hash) keys in this tablet.
-      RETURN_NOT_OK(SetColumnValue(kPartitionsCount, 0, &row));
+      RETURN_NOT_OK(SetColumnValue(
+          kPartitionsCount, static_cast<int64_t>(partitions_count), &row));
     }
   }
 
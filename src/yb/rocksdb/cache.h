@@ -50,7 +50,10 @@ using std::shared_ptr;
 // Classifies the type of the subcache.
 enum SubCacheType {
   SINGLE_TOUCH,
-  MULTI_TOUCH
+  MULTI_TOUCH,
+  // Entries inserted with Cache::Priority::HIGH, e.g. index and filter blocks. This pool has its
+  // own capacity share and is never used by low priority entries.
+  HIGH_PRI
 };
 
 class Cache;
@@ -66,6 +69,13 @@ extern shared_ptr<Cache> NewLRUCache(size_t capacity, int num_shard_bits);
 extern shared_ptr<Cache> NewLRUCache(size_t capacity, int num_shard_bits,
                                      bool strict_capacity_limit);
 
+// Create a new cache with a fixed size capacity that uses the CLOCK eviction policy. Cache hits
+// only take the shard lock in shared mode, which makes this cache scale better than the LRU cache
+// with many concurrent readers. Sub caches and query ids are not supported, high priority entries
+// get a second chance before they are evicted.
+extern shared_ptr<Cache> NewClockCache(size_t capacity, int num_shard_bits,
+                                       bool strict_capacity_limit = false);
+
 using QueryId = int64_t;
 // Query ids to represent values for the default query id.
 constexpr QueryId kDefaultQueryId = 0;
@@ -78,6 +88,13 @@ class Cache {
  public:
   Cache() { }
 
+  // Priority of an entry. High priority entries are kept in a separate pool, so that scans over
+  // data blocks can not push them out of the cache.
+  enum class Priority {
+    HIGH,
+    LOW
+  };
+
   // Destroys all existing entries by calling the "deleter"
   // function that was passed via the Insert() function.
   //
@@ -105,11 +122,14 @@ class Cache {
   // The query ids will allow the cache values to be included in the
   // single touch or multi touch cache, which gives scan resistance to the
   // cache.
+  // High priority entries are inserted into the high priority pool if the cache has one,
+  // otherwise they are treated as low priority entries.
   virtual Status Insert(const Slice& key, const QueryId query_id,
                         void* value, size_t charge,
                         void (*deleter)(const Slice& key, void* value),
                         Handle** handle = nullptr,
-                        Statistics* statistics = nullptr) = 0;
+                        Statistics* statistics = nullptr,
+                        Priority priority = Priority::LOW) = 0;
 
   // If the cache has no mapping for "key", returns nullptr.
   //
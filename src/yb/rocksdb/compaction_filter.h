@@ -34,6 +34,7 @@
 namespace rocksdb {
 
 class SliceTransform;
+struct FileMetaData;
 
 // Context information of a compaction run
 struct CompactionFilterContext {
@@ -155,6 +156,34 @@ class CompactionFilterFactory {
 
   // Returns a name that identifies this compaction filter factory.
   virtual const char* Name() const = 0;
+
+  // Compactions could be split into subcompactions processing disjoint key ranges in parallel,
+  // each with its own compaction filter. Given a user key that was chosen as a boundary between
+  // two subcompactions, returns a prefix of it to be used as the boundary instead, so that all
+  // keys a single filter should see together end up in the same subcompaction.
+  virtual Slice SubcompactionBoundary(const Slice& user_key) const { return user_key; }
+};
+
+// Decides whether whole SST files could be dropped by compaction without reading them, e.g. because
+// all their records are known to be expired.
+class CompactionFileFilter {
+ public:
+  virtual ~CompactionFileFilter() {}
+
+  // Returns true if the file could be deleted without looking at its contents.
+  virtual bool ShouldDrop(const FileMetaData& file) const = 0;
+};
+
+class CompactionFileFilterFactory {
+ public:
+  virtual ~CompactionFileFilterFactory() {}
+
+  // Invoked once per compaction, so the created filter could capture point-in-time state, such as
+  // the history cutoff.
+  virtual std::unique_ptr<CompactionFileFilter> CreateCompactionFileFilter() = 0;
+
+  // Returns a name that identifies this compaction file filter factory.
+  virtual const char* Name() const = 0;
 };
 
 }  // namespace rocksdb
@@ -58,6 +58,11 @@ struct CompactionJobStats {
   // sums up all updated and deleted keys
   uint64_t num_records_replaced;
 
+  // number of records removed by the compaction filter.
+  uint64_t num_records_dropped_by_filter;
+  // the sum of the uncompressed keys and values removed by the compaction filter in bytes.
+  uint64_t total_bytes_dropped_by_filter;
+
   // the sum of the uncompressed input keys in bytes.
   uint64_t total_input_raw_key_bytes;
   // the sum of the uncompressed input values in bytes.
@@ -26,6 +26,7 @@
 
 #include <stdint.h>
 #include <stdio.h>
+#include <functional>
 #include <memory>
 #include <vector>
 #include <string>
@@ -289,6 +290,20 @@ class DB {
                     keys, values);
   }
 
+  // Loads to the block cache data blocks of SST files that point lookups of user_keys are going
+  // to read. Keys are grouped by SST file, checked against its bloom filter and missing blocks of
+  // each file are read in one batch, instead of waiting for each lookup's read separately.
+  // A user key could also be a prefix of the stored keys, in this case the block where a seek to
+  // user_key would land is loaded.
+  // Default implementation does nothing.
+  virtual Status PrefetchKeys(const ReadOptions& options, ColumnFamilyHandle* column_family,
+                              const std::vector<Slice>& user_keys) {
+    return Status::OK();
+  }
+  virtual Status PrefetchKeys(const ReadOptions& options, const std::vector<Slice>& user_keys) {
+    return PrefetchKeys(options, DefaultColumnFamily(), user_keys);
+  }
+
   // If the key definitely does not exist in the database, then this method
   // returns false, else true. If the caller wants to obtain value when the key
   // is found in memory, a bool for 'value_found' must be passed. 'value_found'
@@ -851,6 +866,17 @@ class DB {
     return AddFile(DefaultColumnFamily(), file_info, move_file);
   }
 
+  // Reads the table file located at "file_path" and fills "file_info" with the information needed
+  // to add it with AddFile. The caller may adjust the result (e.g. set a frontier) before adding.
+  virtual Status GetExternalSstFileInfo(ColumnFamilyHandle* column_family,
+                                        const std::string& file_path,
+                                        ExternalSstFileInfo* file_info) {
+    return STATUS(NotSupported, "Not implemented");
+  }
+  Status GetExternalSstFileInfo(const std::string& file_path, ExternalSstFileInfo* file_info) {
+    return GetExternalSstFileInfo(DefaultColumnFamily(), file_path, file_info);
+  }
+
 #endif  // ROCKSDB_LITE
 
   // Sets the globally unique ID created at database creation time by invoking
@@ -870,6 +896,19 @@ class DB {
   virtual Status GetPropertiesOfTablesInRange(
       ColumnFamilyHandle* column_family, const Range* range, std::size_t n,
       TablePropertiesCollection* props) = 0;
+
+  // Loads top-level index and filter blocks of all live table files of the column family to the
+  // block cache, so that first reads after the DB is opened don't have to. If rate_limiter is
+  // specified, loads are throttled by the index and filter sizes of the files. Returns Aborted if
+  // should_stop returned true before all files were processed.
+  virtual Status WarmUpBlockCache(ColumnFamilyHandle* column_family,
+                                  RateLimiter* rate_limiter,
+                                  const std::function<bool()>& should_stop) {
+    return STATUS(NotSupported, "Not implemented");
+  }
+  Status WarmUpBlockCache(RateLimiter* rate_limiter, const std::function<bool()>& should_stop) {
+    return WarmUpBlockCache(DefaultColumnFamily(), rate_limiter, should_stop);
+  }
 #endif  // ROCKSDB_LITE
 
   // Needed for StackableDB
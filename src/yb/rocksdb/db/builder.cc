@@ -163,6 +163,7 @@ Status BuildTable(const std::string& dbname,
         return std::move(boundaries.status());
       }
       auto& boundary_values = *boundaries;
+      builder->AddBoundaryValues(boundary_values.user_values);
       meta->UpdateBoundaries(std::move(boundary_values.key), boundary_values);
 
       // TODO(noetzli): Update stats after flush, too.
@@ -423,6 +423,21 @@ const char* Compaction::InputLevelSummary(
   return scratch->buffer;
 }
 
+void Compaction::SelectOutputPath(
+    const CompactionOutputPathSelector& selector, size_t num_db_paths) {
+  UserFrontierPtr largest;
+  for (auto& input_level : inputs_) {
+    for (auto f : input_level.files) {
+      UpdateUserFrontier(&largest, f->largest.user_frontier, UpdateUserValueType::kLargest);
+    }
+  }
+  auto path_id = selector(largest.get(), output_path_id_);
+  // Without db_paths, all files are placed into the DB directory, i.e. path 0.
+  if (path_id < std::max<size_t>(num_db_paths, 1)) {
+    output_path_id_ = path_id;
+  }
+}
+
 uint64_t Compaction::CalculateTotalInputSize() const {
   uint64_t size = 0;
   for (auto& input_level : inputs_) {
@@ -534,7 +549,9 @@ bool Compaction::ShouldFormSubcompactions() const {
   if (cfd_->ioptions()->compaction_style == kCompactionStyleLevel) {
     return start_level_ == 0 && !IsOutputLevelEmpty();
   } else if (IsCompactionStyleUniversal()) {
-    return number_levels_ > 1 && output_level_ > 0;
+    // With a single level all outputs go to level 0. Files produced by one compaction share
+    // the seqno range and are picked together as a single sorted run, so splitting is still safe.
+    return output_level_ > 0 || number_levels_ == 1;
   } else {
     return false;
   }
@@ -182,6 +182,10 @@ class Compaction {
   // Whether need to write output file to second DB path.
   uint32_t output_path_id() const { return output_path_id_; }
 
+  // Lets the selector override the output path, based on the largest frontier of input files.
+  // Should be called before the compaction is run.
+  void SelectOutputPath(const CompactionOutputPathSelector& selector, size_t num_db_paths);
+
   // Is this a trivial compaction that can be implemented by just
   // moving a single input file to the next level (no merging or splitting)
   bool IsTrivialMove() const;
@@ -323,7 +327,7 @@ class Compaction {
   ColumnFamilyData* cfd_;
   Arena arena_;          // Arena used to allocate space for file_levels_
 
-  const uint32_t output_path_id_;
+  uint32_t output_path_id_;
   CompressionType output_compression_;
   // If true, then the comaction can be done by simply deleting input files.
   const bool deletion_compaction_;
@@ -68,6 +68,7 @@ CompactionIterator::CompactionIterator(
 
 void CompactionIterator::ResetRecordCounts() {
   iter_stats_.num_record_drop_user = 0;
+  iter_stats_.total_drop_user_bytes = 0;
   iter_stats_.num_record_drop_hidden = 0;
   iter_stats_.num_record_drop_obsolete = 0;
 }
@@ -187,6 +188,7 @@ void CompactionIterator::NextFromInput() {
               env_ != nullptr ? timer.ElapsedNanos() : 0;
         }
         if (to_delete) {
+          iter_stats_.total_drop_user_bytes += key_.size() + value_.size();
           // convert the current key to a delete
           ikey_.type = kTypeDeletion;
           current_key_.UpdateInternalKey(ikey_.sequence, kTypeDeletion);
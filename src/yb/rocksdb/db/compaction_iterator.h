@@ -41,6 +41,8 @@ struct CompactionIteratorStats {
   int64_t num_record_drop_user = 0;
   int64_t num_record_drop_hidden = 0;
   int64_t num_record_drop_obsolete = 0;
+  // Raw key and value bytes of records dropped by the compaction filter.
+  uint64_t total_drop_user_bytes = 0;
   uint64_t total_filter_time = 0;
 
   // Input statistics
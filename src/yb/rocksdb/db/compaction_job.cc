@@ -76,6 +76,14 @@
 
 namespace rocksdb {
 
+namespace {
+
+// Number of keys sampled from each input file per possible subcompaction, more samples allow
+// splitting the compaction into parts of closer sizes.
+constexpr size_t kSampleKeysPerSubcompaction = 8;
+
+} // namespace
+
 // Maintains state for each sub-compaction
 struct CompactionJob::SubcompactionState {
   Compaction* compaction;
@@ -120,6 +128,11 @@ struct CompactionJob::SubcompactionState {
   uint64_t num_output_records;
   CompactionJobStats compaction_job_stats;
   uint64_t approx_size;
+  // Time spent processing this subcompaction.
+  uint64_t micros;
+
+  // Frontier reported by the compaction filter of this subcompaction.
+  UserFrontierPtr largest_user_frontier;
 
   SubcompactionState(Compaction* c, Slice* _start, Slice* _end,
                      uint64_t size = 0)
@@ -132,7 +145,8 @@ struct CompactionJob::SubcompactionState {
         total_bytes(0),
         num_input_records(0),
         num_output_records(0),
-        approx_size(size) {
+        approx_size(size),
+        micros(0) {
     assert(compaction != nullptr);
   }
 
@@ -152,6 +166,8 @@ struct CompactionJob::SubcompactionState {
     num_output_records = std::move(o.num_output_records);
     compaction_job_stats = std::move(o.compaction_job_stats);
     approx_size = std::move(o.approx_size);
+    micros = std::move(o.micros);
+    largest_user_frontier = std::move(o.largest_user_frontier);
     return *this;
   }
 
@@ -374,6 +390,16 @@ void CompactionJob::GenSubcompactionBoundaries() {
   int start_lvl = c->start_level();
   int out_lvl = c->output_level();
 
+  // Universal compaction inputs are whole sorted runs that usually cover the same key range, so
+  // their smallest/largest keys are useless as boundaries. Sample keys from the input files
+  // instead.
+  if (cfd->ioptions()->compaction_style == kCompactionStyleUniversal) {
+    AddInputSampleKeys();
+    for (const auto& key : sample_keys_) {
+      bounds.emplace_back(key);
+    }
+  }
+
   // Add the starting and/or ending key of certain input files as a potential
   // boundary
   for (size_t lvl_idx = 0; lvl_idx < c->num_input_levels(); lvl_idx++) {
@@ -442,9 +468,12 @@ void CompactionJob::GenSubcompactionBoundaries() {
 
   // Group the ranges into subcompactions
   const double min_file_fill_percent = 4.0 / 5;
-  uint64_t max_output_files = static_cast<uint64_t>(std::ceil(
-      sum / min_file_fill_percent /
-      cfd->GetCurrentMutableCFOptions()->MaxFileSizeForLevel(out_lvl)));
+  const uint64_t max_file_size = cfd->GetCurrentMutableCFOptions()->MaxFileSizeForLevel(out_lvl);
+  // Output file size is not limited for universal compaction to level 0, so the number of output
+  // files does not bound the number of subcompactions.
+  uint64_t max_output_files = max_file_size == ULLONG_MAX
+      ? std::numeric_limits<uint64_t>::max()
+      : static_cast<uint64_t>(std::ceil(sum / min_file_fill_percent / max_file_size));
   uint64_t subcompactions =
       std::min({static_cast<uint64_t>(ranges.size()),
                 static_cast<uint64_t>(db_options_.max_subcompactions),
@@ -454,6 +483,9 @@ void CompactionJob::GenSubcompactionBoundaries() {
                                     : std::numeric_limits<double>::max();
 
   if (subcompactions > 1) {
+    // Compaction filters could require some keys to be processed by the same subcompaction.
+    CompactionFilterFactory* filter_factory = cfd->ioptions()->compaction_filter == nullptr
+        ? cfd->ioptions()->compaction_filter_factory : nullptr;
     // Greedily add ranges to the subcompaction until the sum of the ranges'
     // sizes becomes >= the expected mean size of a subcompaction
     sum = 0;
@@ -465,7 +497,16 @@ void CompactionJob::GenSubcompactionBoundaries() {
         continue;
       }
       if (sum >= mean) {
-        boundaries_.emplace_back(ExtractUserKey(ranges[i].range.limit));
+        Slice boundary = ExtractUserKey(ranges[i].range.limit);
+        if (filter_factory != nullptr) {
+          boundary = filter_factory->SubcompactionBoundary(boundary);
+        }
+        // Adjusted boundary could fall into the previous subcompaction, merge them in this case.
+        if (!boundaries_.empty() &&
+            cfd_comparator->Compare(boundary, boundaries_.back()) <= 0) {
+          continue;
+        }
+        boundaries_.emplace_back(boundary);
         sizes_.emplace_back(sum);
         subcompactions--;
         sum = 0;
@@ -478,6 +519,34 @@ void CompactionJob::GenSubcompactionBoundaries() {
   }
 }
 
+void CompactionJob::AddInputSampleKeys() {
+  auto* c = compact_->compaction;
+  auto* cfd = c->column_family_data();
+  const size_t samples_per_file = kSampleKeysPerSubcompaction * db_options_.max_subcompactions;
+  std::vector<std::string> keys;
+  for (size_t lvl_idx = 0; lvl_idx < c->num_input_levels(); lvl_idx++) {
+    const LevelFilesBrief* flevel = c->input_levels(lvl_idx);
+    for (size_t i = 0; i < flevel->num_files; i++) {
+      const FileDescriptor& fd = flevel->files[i].fd;
+      Cache::Handle* handle = nullptr;
+      Status s = cfd->table_cache()->FindTable(
+          env_options_, cfd->internal_comparator(), fd, &handle, kDefaultQueryId);
+      if (s.ok()) {
+        s = cfd->table_cache()->GetTableReaderFromHandle(handle)->GetSampleKeys(
+            samples_per_file, &keys);
+        cfd->table_cache()->ReleaseHandle(handle);
+      }
+      if (!s.ok()) {
+        // Samples only affect how work is split between subcompactions.
+        RLOG(InfoLogLevel::WARN_LEVEL, db_options_.info_log,
+            "[%s] [JOB %d] Failed to sample keys of file %" PRIu64 ": %s",
+            cfd->GetName().c_str(), job_id_, fd.GetNumber(), s.ToString().c_str());
+      }
+    }
+  }
+  sample_keys_ = std::move(keys);
+}
+
 Result<FileNumbersHolder> CompactionJob::Run() {
   AutoThreadOperationStageUpdater stage_updater(
       ThreadStatus::STAGE_COMPACTION_RUN);
@@ -524,6 +593,18 @@ Result<FileNumbersHolder> CompactionJob::Run() {
     }
   }
 
+  for (const auto& state : compact_->sub_compact_states) {
+    if (state.largest_user_frontier) {
+      // Each subcompaction has its own compaction filter. Keep the most conservative frontier,
+      // i.e. the earliest history cutoff, since it is valid for all of them.
+      UpdateUserFrontier(
+          &largest_user_frontier_, state.largest_user_frontier, UpdateUserValueType::kSmallest);
+    }
+  }
+  if (compact_->compaction->output_level() == 0 && compact_->NumOutputFiles() > 1) {
+    UnifyOutputSeqNoRanges();
+  }
+
   TablePropertiesCollection tp;
   for (const auto& state : compact_->sub_compact_states) {
     for (const auto& output : state.outputs) {
@@ -545,6 +626,26 @@ Result<FileNumbersHolder> CompactionJob::Run() {
   return std::move(file_numbers_holder);
 }
 
+// Level 0 files are ordered by seqno, while outputs of subcompactions have interleaving seqno
+// ranges. Give them the seqno range of the whole compaction, so they are ordered exactly as a
+// single output file would be, and compaction picker treats them as a single sorted run.
+void CompactionJob::UnifyOutputSeqNoRanges() {
+  SequenceNumber smallest_seqno = kMaxSequenceNumber;
+  SequenceNumber largest_seqno = 0;
+  for (const auto& state : compact_->sub_compact_states) {
+    for (const auto& output : state.outputs) {
+      smallest_seqno = std::min(smallest_seqno, output.meta.smallest.seqno);
+      largest_seqno = std::max(largest_seqno, output.meta.largest.seqno);
+    }
+  }
+  for (auto& state : compact_->sub_compact_states) {
+    for (auto& output : state.outputs) {
+      output.meta.smallest.seqno = smallest_seqno;
+      output.meta.largest.seqno = largest_seqno;
+    }
+  }
+}
+
 Status CompactionJob::Install(const MutableCFOptions& mutable_cf_options) {
   AutoThreadOperationStageUpdater stage_updater(
       ThreadStatus::STAGE_COMPACTION_INSTALL);
@@ -615,6 +716,33 @@ Status CompactionJob::Install(const MutableCFOptions& mutable_cf_options) {
   }
   stream.EndArray();
 
+  if (compact_->sub_compact_states.size() > 1) {
+    stream << "subcompaction_time_micros";
+    stream.StartArray();
+    for (const auto& state : compact_->sub_compact_states) {
+      stream << state.micros;
+    }
+    stream.EndArray();
+    stream << "subcompaction_input_records";
+    stream.StartArray();
+    for (const auto& state : compact_->sub_compact_states) {
+      stream << state.num_input_records;
+    }
+    stream.EndArray();
+    stream << "subcompaction_output_records";
+    stream.StartArray();
+    for (const auto& state : compact_->sub_compact_states) {
+      stream << state.num_output_records;
+    }
+    stream.EndArray();
+    stream << "subcompaction_output_size";
+    stream.StartArray();
+    for (const auto& state : compact_->sub_compact_states) {
+      stream << state.total_bytes;
+    }
+    stream.EndArray();
+  }
+
   CleanupCompaction();
   return status;
 }
@@ -622,6 +750,7 @@ Status CompactionJob::Install(const MutableCFOptions& mutable_cf_options) {
 void CompactionJob::ProcessKeyValueCompaction(
     FileNumbersHolder* holder, SubcompactionState* sub_compact) {
   assert(sub_compact != nullptr);
+  const uint64_t start_micros = env_->NowMicros();
   std::unique_ptr<InternalIterator> input(
       versions_->MakeInputIterator(sub_compact->compaction));
 
@@ -656,7 +785,7 @@ void CompactionJob::ProcessKeyValueCompaction(
   if (compaction_filter) {
     // This is used to persist the history cutoff hybrid time chosen for the DocDB compaction
     // filter.
-    largest_user_frontier_ = compaction_filter->GetLargestUserFrontier();
+    sub_compact->largest_user_frontier = compaction_filter->GetLargestUserFrontier();
   }
 
   MergeHelper merge(
@@ -734,6 +863,7 @@ void CompactionJob::ProcessKeyValueCompaction(
       break;
     }
     auto& boundary_values = *boundaries;
+    sub_compact->builder->AddBoundaryValues(boundary_values.user_values);
     sub_compact->current_output()->meta.UpdateBoundaries(std::move(boundary_values.key),
                                                          boundary_values);
     sub_compact->num_output_records++;
@@ -795,6 +925,8 @@ void CompactionJob::ProcessKeyValueCompaction(
   sub_compact->c_iter.reset();
   input.reset();
   sub_compact->status = status;
+  sub_compact->micros = env_->NowMicros() - start_micros;
+  MeasureTime(stats_, SUBCOMPACTION_TIME, sub_compact->micros);
 }
 
 void CompactionJob::RecordDroppedKeys(
@@ -803,6 +935,11 @@ void CompactionJob::RecordDroppedKeys(
   if (c_iter_stats.num_record_drop_user > 0) {
     RecordTick(stats_, COMPACTION_KEY_DROP_USER,
                c_iter_stats.num_record_drop_user);
+    RecordTick(stats_, COMPACTION_KEY_DROP_USER_BYTES, c_iter_stats.total_drop_user_bytes);
+    if (compaction_job_stats) {
+      compaction_job_stats->num_records_dropped_by_filter += c_iter_stats.num_record_drop_user;
+      compaction_job_stats->total_bytes_dropped_by_filter += c_iter_stats.total_drop_user_bytes;
+    }
   }
   if (c_iter_stats.num_record_drop_hidden > 0) {
     RecordTick(stats_, COMPACTION_KEY_DROP_NEWER_ENTRY,
@@ -1039,9 +1176,15 @@ Status CompactionJob::OpenCompactionOutputFile(
   ColumnFamilyData* cfd = sub_compact->compaction->column_family_data();
 
   {
-    auto setup_outfile = [] (const EnvOptions& env_options, size_t preallocation_block_size,
+    // Small compactions get ahead of large ones in the rate limiter, so they could keep the number
+    // of files low while a large compaction is running.
+    const auto io_priority =
+        sub_compact->compaction->CalculateTotalInputSize() <
+            db_options_.compaction_size_threshold_bytes ? Env::IO_MID : Env::IO_LOW;
+    auto setup_outfile = [io_priority] (
+        const EnvOptions& env_options, size_t preallocation_block_size,
         std::unique_ptr<WritableFile>* writable_file, std::unique_ptr<WritableFileWriter>* writer) {
-      (*writable_file)->SetIOPriority(Env::IO_LOW);
+      (*writable_file)->SetIOPriority(io_priority);
       if (preallocation_block_size > 0) {
         (*writable_file)->SetPreallocationBlockSize(preallocation_block_size);
       }
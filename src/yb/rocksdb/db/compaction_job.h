@@ -110,6 +110,9 @@ class CompactionJob {
 
   void AggregateStatistics();
   void GenSubcompactionBoundaries();
+  // Fills sample_keys_ with keys sampled from the compaction input files.
+  void AddInputSampleKeys();
+  void UnifyOutputSeqNoRanges();
 
   // update the thread status for starting a compaction.
   void ReportStartedCompaction(Compaction* compaction);
@@ -181,6 +184,8 @@ class CompactionJob {
   bool bottommost_level_;
   bool paranoid_file_checks_;
   bool measure_io_stats_;
+  // Stores keys sampled from input files, that are used as potential subcompaction boundaries
+  std::vector<std::string> sample_keys_;
   // Stores the Slices that designate the boundaries for each subcompaction
   std::vector<Slice> boundaries_;
   // Stores the approx size of keys covered in the range of each subcompaction
@@ -37,6 +37,7 @@
 
 #include "yb/rocksdb/db/column_family.h"
 #include "yb/rocksdb/db/filename.h"
+#include "yb/rocksdb/compaction_filter.h"
 #include "yb/rocksdb/util/log_buffer.h"
 #include "yb/rocksdb/util/random.h"
 #include "yb/rocksdb/util/statistics.h"
@@ -1148,7 +1149,8 @@ bool LevelCompactionPicker::PickCompactionBySize(VersionStorageInfo* vstorage,
 bool UniversalCompactionPicker::NeedsCompaction(
     const VersionStorageInfo* vstorage) const {
   const int kLevel0 = 0;
-  return vstorage->CompactionScore(kLevel0) >= 1;
+  return vstorage->CompactionScore(kLevel0) >= 1 ||
+         !vstorage->FilesMarkedForCompaction().empty();
 }
 
 struct UniversalCompactionPicker::SortedRun {
@@ -1162,6 +1164,18 @@ struct UniversalCompactionPicker::SortedRun {
     assert(compensated_file_size > 0);
     // Allowed either one of level and file.
     assert((level != 0) != (file != nullptr));
+    if (file != nullptr) {
+      files.push_back(file);
+    }
+  }
+
+  // Adds another level 0 file produced by the same compaction as `file` to this sorted run.
+  void AddFile(FileMetaData* f) {
+    assert(level == 0);
+    files.push_back(f);
+    size += f->fd.GetTotalFileSize();
+    compensated_file_size += f->compensated_file_size;
+    being_compacted = being_compacted || f->being_compacted;
   }
 
   void Dump(char* out_buf, size_t out_buf_size,
@@ -1175,6 +1189,10 @@ struct UniversalCompactionPicker::SortedRun {
   // `file` Will be null for level > 0. For level = 0, the sorted run is
   // for this file.
   FileMetaData* file;
+  // For level = 0, all files of the sorted run starting with `file`. There is more than one file
+  // when a compaction was split into subcompactions: its outputs share the seqno range and cover
+  // disjoint key ranges, so they have to be compacted together.
+  std::vector<FileMetaData*> files;
   // For level > 0, `size` and `compensated_file_size` are sum of sizes all
   // files in the level. `being_compacted` should be the same for all files
   // in a non-zero level. Use the value here.
@@ -1188,13 +1206,18 @@ void UniversalCompactionPicker::SortedRun::Dump(char* out_buf,
                                                 bool print_path) const {
   if (level == 0) {
     assert(file != nullptr);
+    int written;
     if (file->fd.GetPathId() == 0 || !print_path) {
-      snprintf(out_buf, out_buf_size, "file %" PRIu64, file->fd.GetNumber());
+      written = snprintf(out_buf, out_buf_size, "file %" PRIu64, file->fd.GetNumber());
     } else {
-      snprintf(out_buf, out_buf_size, "file %" PRIu64
-                                      "(path "
-                                      "%" PRIu32 ")",
-               file->fd.GetNumber(), file->fd.GetPathId());
+      written = snprintf(out_buf, out_buf_size, "file %" PRIu64
+                                                "(path "
+                                                "%" PRIu32 ")",
+                         file->fd.GetNumber(), file->fd.GetPathId());
+    }
+    if (files.size() > 1 && written >= 0 && static_cast<size_t>(written) < out_buf_size) {
+      snprintf(out_buf + written, out_buf_size - written, " (+%" ROCKSDB_PRIszt " files)",
+               files.size() - 1);
     }
   } else {
     snprintf(out_buf, out_buf_size, "level %d", level);
@@ -1208,9 +1231,10 @@ void UniversalCompactionPicker::SortedRun::DumpSizeInfo(
     snprintf(out_buf, out_buf_size,
              "file %" PRIu64 "[%" ROCKSDB_PRIszt
              "] "
+             "(%" ROCKSDB_PRIszt " files) "
              "with size %" PRIu64 " (compensated size %" PRIu64 ")",
-             file->fd.GetNumber(), sorted_run_count, file->fd.GetTotalFileSize(),
-             file->compensated_file_size);
+             file->fd.GetNumber(), sorted_run_count, files.size(), size,
+             compensated_file_size);
   } else {
     snprintf(out_buf, out_buf_size,
              "level %d[%" ROCKSDB_PRIszt
@@ -1224,11 +1248,26 @@ std::vector<std::vector<UniversalCompactionPicker::SortedRun>>
     UniversalCompactionPicker::CalculateSortedRuns(const VersionStorageInfo& vstorage,
                                                    const ImmutableCFOptions& ioptions,
                                                    uint64_t max_file_size) {
-  std::vector<std::vector<SortedRun>> ret(1);
+  // Level 0 files produced by the same (split into subcompactions) compaction have identical
+  // seqno ranges and are adjacent in the newest first order. They form a single sorted run.
+  std::vector<SortedRun> level0_runs;
   for (FileMetaData* f : vstorage.LevelFiles(0)) {
-    if (f->fd.GetTotalFileSize() <= max_file_size) {
-      ret.back().emplace_back(0, f, f->fd.GetTotalFileSize(), f->compensated_file_size,
-          f->being_compacted);
+    if (!level0_runs.empty()) {
+      const FileMetaData* prev = level0_runs.back().file;
+      if (f->largest.seqno != 0 &&
+          f->smallest.seqno == prev->smallest.seqno && f->largest.seqno == prev->largest.seqno) {
+        level0_runs.back().AddFile(f);
+        continue;
+      }
+    }
+    level0_runs.emplace_back(0, f, f->fd.GetTotalFileSize(), f->compensated_file_size,
+        f->being_compacted);
+  }
+
+  std::vector<std::vector<SortedRun>> ret(1);
+  for (auto& sr : level0_runs) {
+    if (sr.size <= max_file_size) {
+      ret.back().push_back(std::move(sr));
     // If last sequence is empty it means that there are multiple too-large-to-compact files in
     // a row. So we just don't start new sequence in this case.
     } else if (!ret.back().empty()) {
@@ -1353,6 +1392,12 @@ Compaction* UniversalCompactionPicker::PickCompaction(
     const MutableCFOptions& mutable_cf_options,
     VersionStorageInfo* vstorage,
     LogBuffer* log_buffer) {
+  Compaction* expired_files_compaction = PickExpiredFilesCompaction(
+      cf_name, mutable_cf_options, vstorage, log_buffer);
+  if (expired_files_compaction != nullptr) {
+    return expired_files_compaction;
+  }
+
   std::vector<std::vector<SortedRun>> sorted_runs = CalculateSortedRuns(
       *vstorage,
       ioptions_,
@@ -1364,9 +1409,92 @@ Compaction* UniversalCompactionPicker::PickCompaction(
       return result;
     }
   }
+  return PickFilesMarkedForCompaction(
+      cf_name, mutable_cf_options, vstorage, sorted_runs, log_buffer);
+}
+
+Compaction* UniversalCompactionPicker::PickFilesMarkedForCompaction(
+    const std::string& cf_name, const MutableCFOptions& mutable_cf_options,
+    VersionStorageInfo* vstorage, const std::vector<std::vector<SortedRun>>& sorted_runs,
+    LogBuffer* log_buffer) {
+  const int kLevel0 = 0;
+  const auto& marked_files = vstorage->FilesMarkedForCompaction();
+  if (marked_files.empty()) {
+    return nullptr;
+  }
+
+  // Files of a level 0 sorted run share the seqno range, so the whole run is compacted to keep
+  // level 0 ordered. A single sorted run is always a continuous sequence.
+  for (const auto& block : sorted_runs) {
+    for (const auto& sr : block) {
+      if (sr.level != kLevel0 || sr.being_compacted) {
+        continue;
+      }
+      auto marked = std::find_if(
+          marked_files.begin(), marked_files.end(),
+          [&sr](const std::pair<int, FileMetaData*>& level_and_file) {
+            return std::find(sr.files.begin(), sr.files.end(), level_and_file.second) !=
+                   sr.files.end();
+          });
+      if (marked == marked_files.end()) {
+        continue;
+      }
+
+      std::vector<CompactionInputFiles> inputs(1);
+      inputs[0].level = kLevel0;
+      inputs[0].files = sr.files;
+      LOG_TO_BUFFER(log_buffer,
+                    "[%s] Universal: compacting %" ROCKSDB_PRIszt " file(s) starting with %" PRIu64
+                    " marked for compaction", cf_name.c_str(), sr.files.size(),
+                    sr.file->fd.GetNumber());
+
+      Compaction* c = new Compaction(
+          vstorage, mutable_cf_options, std::move(inputs), kLevel0,
+          mutable_cf_options.MaxFileSizeForLevel(kLevel0), LLONG_MAX,
+          GetPathId(ioptions_, sr.size),
+          GetCompressionType(ioptions_, kLevel0, 1),
+          /* grandparents */ {}, /* is manual */ false, vstorage->CompactionScore(kLevel0),
+          /* is deletion compaction */ false, CompactionReason::kFilesMarkedForCompaction);
+      level0_compactions_in_progress_.insert(c);
+      return c;
+    }
+  }
   return nullptr;
 }
 
+Compaction* UniversalCompactionPicker::PickExpiredFilesCompaction(
+    const std::string& cf_name, const MutableCFOptions& mutable_cf_options,
+    VersionStorageInfo* vstorage, LogBuffer* log_buffer) {
+  if (ioptions_.compaction_file_filter_factory == nullptr) {
+    return nullptr;
+  }
+  auto filter = ioptions_.compaction_file_filter_factory->CreateCompactionFileFilter();
+  if (!filter) {
+    return nullptr;
+  }
+
+  const int kLevel0 = 0;
+  std::vector<CompactionInputFiles> inputs(1);
+  inputs[0].level = kLevel0;
+  for (auto* f : vstorage->LevelFiles(kLevel0)) {
+    if (!f->being_compacted && filter->ShouldDrop(*f)) {
+      inputs[0].files.push_back(f);
+      LOG_TO_BUFFER(log_buffer, "[%s] Universal: picking expired file %" PRIu64 " for deletion",
+                    cf_name.c_str(), f->fd.GetNumber());
+    }
+  }
+  if (inputs[0].files.empty()) {
+    return nullptr;
+  }
+
+  Compaction* c = new Compaction(
+      vstorage, mutable_cf_options, std::move(inputs), kLevel0, 0, 0, 0,
+      kNoCompression, {}, /* is manual */ false, vstorage->CompactionScore(kLevel0),
+      /* is deletion compaction */ true, CompactionReason::kUniversalExpiredFiles);
+  level0_compactions_in_progress_.insert(c);
+  return c;
+}
+
 Compaction* UniversalCompactionPicker::DoPickCompaction(
     const std::string& cf_name,
     const MutableCFOptions& mutable_cf_options,
@@ -1449,6 +1577,7 @@ Compaction* UniversalCompactionPicker::DoPickCompaction(
 // validate that all the chosen files of L0 are non overlapping in time
 #ifndef NDEBUG
   SequenceNumber prev_smallest_seqno = 0U;
+  SequenceNumber prev_largest_seqno = 0U;
   bool is_first = true;
 
   size_t level_index = 0U;
@@ -1457,10 +1586,13 @@ Compaction* UniversalCompactionPicker::DoPickCompaction(
       DCHECK_LE(f->smallest.seqno, f->largest.seqno);
       if (is_first) {
         is_first = false;
-      } else {
+      } else if (prev_smallest_seqno != f->smallest.seqno ||
+                 prev_largest_seqno != f->largest.seqno) {
+        // Files of the same sorted run share the seqno range.
         DCHECK_GT(prev_smallest_seqno, f->largest.seqno);
       }
       prev_smallest_seqno = f->smallest.seqno;
+      prev_largest_seqno = f->largest.seqno;
     }
     level_index = 1U;
   }
@@ -1688,8 +1820,9 @@ Compaction* UniversalCompactionPicker::PickCompactionUniversalReadAmp(
   for (size_t i = start_index; i < first_index_after; i++) {
     auto& picking_sr = sorted_runs[i];
     if (picking_sr.level == 0) {
-      FileMetaData* picking_file = picking_sr.file;
-      inputs[0].files.push_back(picking_file);
+      for (auto* picking_file : picking_sr.files) {
+        inputs[0].files.push_back(picking_file);
+      }
     } else {
       auto& files = inputs[picking_sr.level - start_level].files;
       for (auto* f : vstorage->LevelFiles(picking_sr.level)) {
@@ -1814,8 +1947,9 @@ Compaction* UniversalCompactionPicker::PickCompactionUniversalSizeAmp(
   for (size_t loop = start_index; loop < sorted_runs.size(); loop++) {
     auto& picking_sr = sorted_runs[loop];
     if (picking_sr.level == 0) {
-      FileMetaData* f = picking_sr.file;
-      inputs[0].files.push_back(f);
+      for (auto* f : picking_sr.files) {
+        inputs[0].files.push_back(f);
+      }
     } else {
       auto& files = inputs[picking_sr.level - start_level].files;
       for (auto* f : vstorage->LevelFiles(picking_sr.level)) {
@@ -266,6 +266,19 @@ class UniversalCompactionPicker : public CompactionPicker {
       LogBuffer* log_buffer,
       const std::vector<SortedRun>& sorted_runs);
 
+  // Pick deletion compaction of files selected by compaction_file_filter_factory.
+  Compaction* PickExpiredFilesCompaction(
+      const std::string& cf_name, const MutableCFOptions& mutable_cf_options,
+      VersionStorageInfo* vstorage, LogBuffer* log_buffer);
+
+  // Pick compaction of a sorted run that contains a file marked for compaction by a table
+  // properties collector, e.g. because most of its records are garbage. Used when no other
+  // compaction is needed.
+  Compaction* PickFilesMarkedForCompaction(
+      const std::string& cf_name, const MutableCFOptions& mutable_cf_options,
+      VersionStorageInfo* vstorage, const std::vector<std::vector<SortedRun>>& sorted_runs,
+      LogBuffer* log_buffer);
+
   // Pick Universal compaction to limit read amplification
   Compaction* PickCompactionUniversalReadAmp(
       const std::string& cf_name, const MutableCFOptions& mutable_cf_options,
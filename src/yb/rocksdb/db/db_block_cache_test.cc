@@ -185,6 +185,81 @@ TEST_F(DBBlockCacheTest, TestWithoutCompressedBlockCache) {
   }
 }
 
+TEST_F(DBBlockCacheTest, PrefetchKeys) {
+  auto table_options = GetTableOptions();
+  table_options.block_cache = NewLRUCache(1 << 20);
+  auto options = GetOptions(table_options);
+  DestroyAndReopen(options);
+  InitTable(options);
+  ASSERT_OK(Flush());
+  RecordCacheCounters(options);
+
+  std::vector<std::string> even_keys;
+  for (size_t i = 0; i < kNumBlocks; i += 2) {
+    even_keys.push_back(ToString(i));
+  }
+  // Key greater than all keys of the table is ignored.
+  even_keys.push_back("x");
+  ASSERT_OK(db_->PrefetchKeys(ReadOptions(), std::vector<Slice>(even_keys.begin(),
+                                                                even_keys.end())));
+  CheckCacheCounters(options, kNumBlocks / 2, 0, kNumBlocks / 2, 0);
+
+  std::string value;
+  for (size_t i = 0; i < kNumBlocks; i += 2) {
+    ASSERT_OK(db_->Get(ReadOptions(), ToString(i), &value));
+  }
+  CheckCacheCounters(options, 0, kNumBlocks / 2, 0, 0);
+
+  // MultiGet prefetches blocks of odd keys, and then finds all keys in the cache.
+  std::vector<std::string> all_keys;
+  for (size_t i = 0; i < kNumBlocks; i++) {
+    all_keys.push_back(ToString(i));
+  }
+  std::vector<std::string> values;
+  auto statuses = db_->MultiGet(ReadOptions(), std::vector<Slice>(all_keys.begin(),
+                                                                  all_keys.end()), &values);
+  ASSERT_EQ(kNumBlocks, statuses.size());
+  for (size_t i = 0; i < kNumBlocks; i++) {
+    ASSERT_OK(statuses[i]);
+    ASSERT_EQ(std::string(kValueSize, 'a'), values[i]);
+  }
+  CheckCacheCounters(options, kNumBlocks / 2, kNumBlocks + kNumBlocks / 2, kNumBlocks / 2, 0);
+}
+
+TEST_F(DBBlockCacheTest, WarmUpBlockCache) {
+  auto table_options = GetTableOptions();
+  table_options.cache_index_and_filter_blocks = true;
+  table_options.filter_policy.reset(NewFixedSizeFilterPolicy(
+      FilterPolicy::kDefaultFixedSizeFilterBits, FilterPolicy::kDefaultFixedSizeFilterErrorRate,
+      nullptr));
+  table_options.block_cache = NewLRUCache(1 << 20);
+  auto options = GetOptions(table_options);
+  DestroyAndReopen(options);
+  InitTable(options);
+  ASSERT_OK(Flush());
+
+  // Reopen with an empty block cache.
+  table_options.block_cache = NewLRUCache(1 << 20);
+  options.table_factory.reset(new BlockBasedTableFactory(table_options));
+  Reopen(options);
+
+  ASSERT_OK(db_->WarmUpBlockCache(nullptr /* rate_limiter */, [] { return false; }));
+  const auto index_misses = TestGetTickerCount(options, BLOCK_CACHE_INDEX_MISS);
+  const auto filter_misses = TestGetTickerCount(options, BLOCK_CACHE_FILTER_MISS);
+  ASSERT_GT(index_misses, 0);
+  ASSERT_GT(filter_misses, 0);
+
+  // Reads only have to load data blocks.
+  std::string value;
+  for (size_t i = 0; i < kNumBlocks; i++) {
+    ASSERT_OK(db_->Get(ReadOptions(), ToString(i), &value));
+  }
+  ASSERT_EQ(index_misses, TestGetTickerCount(options, BLOCK_CACHE_INDEX_MISS));
+  ASSERT_EQ(filter_misses, TestGetTickerCount(options, BLOCK_CACHE_FILTER_MISS));
+
+  ASSERT_TRUE(db_->WarmUpBlockCache(nullptr /* rate_limiter */, [] { return true; }).IsAborted());
+}
+
 #ifdef SNAPPY
 TEST_F(DBBlockCacheTest, TestWithCompressedBlockCache) {
   ReadOptions read_options;
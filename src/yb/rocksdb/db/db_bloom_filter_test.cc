@@ -15,6 +15,7 @@
 #include "yb/rocksdb/db/db_test_util.h"
 #include "yb/rocksdb/port/stack_trace.h"
 #include "yb/rocksdb/perf_context.h"
+#include "yb/rocksdb/table/data_block_boundaries.h"
 
 namespace rocksdb {
 
@@ -516,6 +517,93 @@ TEST_F(DBBloomFilterTest, BloomFilterReverseCompatibility) {
   ASSERT_EQ(TestGetTickerCount(options, BLOOM_FILTER_USEFUL), 0);
 }
 
+namespace {
+
+// Accepts data blocks whose string boundary values, i.e. reversed user keys, could contain the
+// reversed key.
+class ReversedKeyBlockFilter : public ReadBlockFilter {
+ public:
+  explicit ReversedKeyBlockFilter(const std::string& key)
+      : reversed_key_(key.rbegin(), key.rend()) {}
+
+  bool Filter(const DataBlockBoundaries& block) const override {
+    const Slice* smallest = block.smallest.user_value_with_tag(test::TAG_STRING_VALUE);
+    const Slice* largest = block.largest.user_value_with_tag(test::TAG_STRING_VALUE);
+    EXPECT_NE(smallest, nullptr);
+    EXPECT_NE(largest, nullptr);
+    if (smallest == nullptr || largest == nullptr) {
+      return true;
+    }
+    EXPECT_LE(smallest->compare(*largest), 0);
+    return smallest->compare(reversed_key_) <= 0 && largest->compare(reversed_key_) >= 0;
+  }
+
+ private:
+  const std::string reversed_key_;
+};
+
+}  // namespace
+
+TEST_F(DBBloomFilterTest, DataBlockFilter) {
+  Options options = CurrentOptions();
+  options.statistics = rocksdb::CreateDBStatistics();
+  options.boundary_extractor = test::MakeBoundaryValuesExtractor();
+  options.disable_auto_compactions = true;
+  BlockBasedTableOptions table_options;
+  table_options.block_size = 256;
+  table_options.store_data_block_boundaries = true;
+  options.table_factory.reset(NewBlockBasedTableFactory(table_options));
+  DestroyAndReopen(options);
+
+  const int kNumKeys = 2000;
+  const int kTargetKey = 500;
+  for (int parity = 0; parity != 2; ++parity) {
+    for (int i = parity; i < kNumKeys; i += 2) {
+      ASSERT_OK(Put(Key(i), Key(i)));
+    }
+    ASSERT_OK(Flush());
+  }
+
+  auto check = [&] {
+    const auto checked_before = TestGetTickerCount(options, DATA_BLOCK_FILTER_CHECKED);
+    const auto useful_before = TestGetTickerCount(options, DATA_BLOCK_FILTER_USEFUL);
+    ReadOptions read_options;
+    read_options.block_filter = std::make_shared<ReversedKeyBlockFilter>(Key(kTargetKey));
+    std::unique_ptr<Iterator> iter(db_->NewIterator(read_options));
+    int num_keys = 0;
+    bool found_target = false;
+    for (iter->SeekToFirst(); iter->Valid(); iter->Next()) {
+      ++num_keys;
+      found_target = found_target || iter->key() == Key(kTargetKey);
+    }
+    ASSERT_OK(iter->status());
+    // The block with the key is always read, while most others are skipped.
+    ASSERT_TRUE(found_target);
+    ASSERT_LT(num_keys, kNumKeys / 2);
+    const auto checked = TestGetTickerCount(options, DATA_BLOCK_FILTER_CHECKED) - checked_before;
+    const auto useful = TestGetTickerCount(options, DATA_BLOCK_FILTER_USEFUL) - useful_before;
+    ASSERT_GT(useful, 0);
+    ASSERT_LT(useful, checked);
+
+    // Point reads and iterators without the filter see all keys.
+    ASSERT_EQ(Key(kTargetKey + 1), Get(Key(kTargetKey + 1)));
+    iter.reset(db_->NewIterator(ReadOptions()));
+    num_keys = 0;
+    for (iter->SeekToFirst(); iter->Valid(); iter->Next()) {
+      ++num_keys;
+    }
+    ASSERT_OK(iter->status());
+    ASSERT_EQ(kNumKeys, num_keys);
+  };
+
+  ASSERT_NO_FATAL_FAILURE(check());
+
+  // Compaction output has the boundaries as well.
+  ASSERT_OK(db_->CompactRange(CompactRangeOptions(), nullptr, nullptr));
+  ASSERT_EQ("0,1", FilesPerLevel());
+  ASSERT_NO_FATAL_FAILURE(check());
+}
+
 namespace {
 // A wrapped bloom over default FilterPolicy
 class WrappedBloom : public FilterPolicy {
@@ -380,6 +380,23 @@ TEST_F(DBTestCompactionFilter, CompactionFilter) {
   }
 }
 
+class CompactionStatsListener : public EventListener {
+ public:
+  void OnCompactionCompleted(DB* db, const CompactionJobInfo& ci) override {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stats_.Add(ci.stats);
+  }
+
+  CompactionJobStats stats() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+  }
+
+ private:
+  std::mutex mutex_;
+  CompactionJobStats stats_;
+};
+
 // Tests the edge case where compaction does not produce any output -- all
 // entries are deleted. The compaction should create bunch of 'DeleteFile'
 // entries in VersionEdit, but none of the 'AddFile's.
@@ -388,13 +405,20 @@ TEST_F(DBTestCompactionFilter, CompactionFilterDeletesAll) {
   options.compaction_filter_factory = std::make_shared<DeleteFilterFactory>();
   options.disable_auto_compactions = true;
   options.create_if_missing = true;
+  auto listener = std::make_shared<CompactionStatsListener>();
+  options.listeners.push_back(listener);
   options = CurrentOptions(options);
   DestroyAndReopen(options);
 
   // put some data
+  size_t num_keys = 0;
+  size_t raw_bytes = 0;
   for (int table = 0; table < 4; ++table) {
     for (int i = 0; i < 10 + table; ++i) {
-      Put(ToString(table * 100 + i), "val");
+      const auto key = ToString(table * 100 + i);
+      Put(key, "val");
+      ++num_keys;
+      raw_bytes += key.size() + kLastInternalComponentSize + 3;
     }
     Flush();
   }
@@ -402,6 +426,8 @@ TEST_F(DBTestCompactionFilter, CompactionFilterDeletesAll) {
   // this will produce empty file (delete compaction filter)
   ASSERT_OK(db_->CompactRange(CompactRangeOptions(), nullptr, nullptr));
   ASSERT_EQ(0U, CountLiveFiles());
+  ASSERT_EQ(num_keys, listener->stats().num_records_dropped_by_filter);
+  ASSERT_EQ(raw_bytes, listener->stats().total_bytes_dropped_by_filter);
 
   Reopen(options);
 
@@ -22,10 +22,12 @@
 // found in the LICENSE file. See the AUTHORS file for names of contributors.
 
 #include <atomic>
+#include <thread>
 
 #include "yb/rocksdb/db/db_test_util.h"
 #include "yb/rocksdb/port/stack_trace.h"
 #include "yb/rocksdb/experimental.h"
+#include "yb/rocksdb/utilities/checkpoint.h"
 #include "yb/rocksdb/utilities/convenience.h"
 #include "yb/rocksdb/util/sync_point.h"
 #include "yb/rocksdb/util/testutil.h"
@@ -268,6 +270,114 @@ TEST_F(DBCompactionTest, LastFlushedOpIdWithCompaction) {
   TestFlushedOpId(true /* compact */, this);
 }
 
+TEST_F(DBCompactionTest, ConcurrentWritesWithFrontiers) {
+  Options options = CurrentOptions(Options());
+
+  options.compaction_style = kCompactionStyleUniversal;
+  options.num_levels = 1;
+  options.boundary_extractor = test::MakeBoundaryValuesExtractor();
+  options.allow_concurrent_memtable_write = true;
+  options.enable_write_thread_adaptive_yield = true;
+
+  DestroyAndReopen(options);
+
+  const size_t kNumThreads = 8;
+  const size_t kBatchesPerThread = 100;
+  std::vector<std::thread> threads;
+  for (size_t t = 0; t != kNumThreads; ++t) {
+    threads.emplace_back([this, t] {
+      for (size_t i = 0; i != kBatchesPerThread; ++i) {
+        const auto value = 1 + t * kBatchesPerThread + i;
+        WriteBatch batch;
+        test::TestUserFrontiers frontiers(value, value);
+        batch.SetFrontiers(&frontiers);
+        batch.Put(std::to_string(value), std::to_string(t));
+        batch.Put(std::to_string(value) + "_second", std::to_string(i));
+
+        WriteOptions write_options;
+        write_options.disableWAL = true;
+        ASSERT_OK(dbfull()->Write(write_options, &batch));
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  ASSERT_OK(dbfull()->TEST_FlushMemTable(true));
+  ASSERT_EQ(kNumThreads * kBatchesPerThread,
+            down_cast<test::TestUserFrontier&>(*dbfull()->GetFlushedFrontier()).Value());
+
+  for (size_t t = 0; t != kNumThreads; ++t) {
+    for (size_t i = 0; i != kBatchesPerThread; ++i) {
+      const auto value = 1 + t * kBatchesPerThread + i;
+      ASSERT_EQ(std::to_string(t), Get(std::to_string(value)));
+      ASSERT_EQ(std::to_string(i), Get(std::to_string(value) + "_second"));
+    }
+  }
+}
+
+TEST_F(DBCompactionTest, OutputPathSelectorByFrontier) {
+  Options options = CurrentOptions(Options());
+  options.compaction_style = kCompactionStyleUniversal;
+  options.num_levels = 1;
+  options.boundary_extractor = test::MakeBoundaryValuesExtractor();
+  options.db_paths.emplace_back(dbname_, std::numeric_limits<uint64_t>::max());
+  options.db_paths.emplace_back(dbname_ + "_cold", std::numeric_limits<uint64_t>::max());
+  // Files with all frontier values below the threshold are treated as cold.
+  constexpr uint64_t kColdThreshold = 100;
+  options.compaction_output_path_selector = std::make_shared<CompactionOutputPathSelector>(
+      [](const UserFrontier* largest, uint32_t picked_path_id) {
+    if (largest && down_cast<const test::TestUserFrontier*>(largest)->Value() < kColdThreshold) {
+      return 1U;
+    }
+    return picked_path_id;
+  });
+
+  DestroyAndReopen(options);
+
+  auto write = [this](uint64_t value) {
+    WriteBatch batch;
+    test::TestUserFrontiers frontiers(value, value);
+    batch.SetFrontiers(&frontiers);
+    batch.Put(std::to_string(value), std::to_string(value));
+    ASSERT_OK(dbfull()->Write(WriteOptions(), &batch));
+    ASSERT_OK(Flush());
+  };
+
+  write(1);
+  write(2);
+  ASSERT_EQ(2, GetSstFileCount(options.db_paths[0].path));
+  ASSERT_OK(db_->CompactRange(CompactRangeOptions(), nullptr, nullptr));
+  ASSERT_EQ(0, GetSstFileCount(options.db_paths[0].path));
+  ASSERT_EQ(1, GetSstFileCount(options.db_paths[1].path));
+
+  // Checkpoint puts files from all paths into a single directory.
+  write(3);
+  const std::string checkpoint_dir = dbname_ + "_checkpoint";
+  ASSERT_OK(checkpoint::CreateCheckpoint(db_, checkpoint_dir));
+  ASSERT_EQ(2, GetSstFileCount(checkpoint_dir));
+
+  write(kColdThreshold + 1);
+  ASSERT_OK(db_->CompactRange(CompactRangeOptions(), nullptr, nullptr));
+  ASSERT_EQ(1, GetSstFileCount(options.db_paths[0].path));
+  ASSERT_EQ(0, GetSstFileCount(options.db_paths[1].path));
+  Close();
+
+  options.db_paths[0].path = checkpoint_dir;
+  options.db_paths[1].path = checkpoint_dir + "_cold";
+  DB* checkpoint_db = nullptr;
+  ASSERT_OK(DB::Open(options, checkpoint_dir, &checkpoint_db));
+  std::unique_ptr<DB> checkpoint_db_holder(checkpoint_db);
+  for (uint64_t value : {1, 2, 3}) {
+    std::string result;
+    ASSERT_OK(checkpoint_db->Get(ReadOptions(), std::to_string(value), &result));
+    ASSERT_EQ(std::to_string(value), result);
+  }
+  checkpoint_db_holder.reset();
+  ASSERT_OK(DestroyDB(checkpoint_dir, options));
+}
+
 TEST_F(DBCompactionTest, SkipStatsUpdateTest) {
   // This test verify UpdateAccumulatedStats is not on by observing
   // the compaction behavior when there are many of deletion entries.
@@ -209,6 +209,11 @@ DBOptions SanitizeOptions(const std::string& dbname, const DBOptions& src) {
     result.db_paths.emplace_back(dbname, std::numeric_limits<uint64_t>::max());
   }
 
+  if (result.use_direct_io_for_flush_and_compaction && result.compaction_readahead_size == 0) {
+    // Direct reads bypass OS readahead, so compaction inputs need their own.
+    result.compaction_readahead_size = 2 * 1024 * 1024;
+  }
+
   if (result.compaction_readahead_size > 0) {
     result.new_table_reader_for_compaction_inputs = true;
   }
@@ -308,6 +313,7 @@ DBImpl::DBImpl(const DBOptions& options, const std::string& dbname)
       next_job_id_(1),
       has_unpersisted_data_(false),
       env_options_(db_options_),
+      env_options_for_compaction_(env_->OptimizeForCompactionTableWrite(env_options_, db_options_)),
 #ifndef ROCKSDB_LITE
       wal_manager_(db_options_, env_options_),
 #endif  // ROCKSDB_LITE
@@ -1490,7 +1496,7 @@ Status DBImpl::WriteLevel0TableForRecovery(int job_id, ColumnFamilyData* cfd,
         s = BuildTable(dbname_,
                        env_,
                        *cfd->ioptions(),
-                       env_options_,
+                       env_options_for_compaction_,
                        cfd->table_cache(),
                        iter.get(),
                        &meta,
@@ -1565,7 +1571,7 @@ Result<FileNumbersHolder> DBImpl::FlushMemTableToOutputFile(
   }
 
   FlushJob flush_job(
-      dbname_, cfd, db_options_, mutable_cf_options, env_options_,
+      dbname_, cfd, db_options_, mutable_cf_options, env_options_for_compaction_,
       versions_.get(), &mutex_, &shutting_down_, snapshot_seqs,
       earliest_write_conflict_snapshot, mem_table_flush_filter, pending_outputs_.get(),
       job_context, log_buffer, directories_.GetDbDir(), directories_.GetDataDir(0U),
@@ -1693,6 +1699,7 @@ void DBImpl::NotifyOnFlushCompleted(ColumnFamilyData* cfd,
     info.triggered_writes_stop = triggered_writes_stop;
     info.smallest_seqno = file_meta->smallest.seqno;
     info.largest_seqno = file_meta->largest.seqno;
+    info.file_size = file_meta->fd.GetTotalFileSize();
     info.table_properties = prop;
     for (auto listener : db_options_.listeners) {
       listener->OnFlushCompleted(this, info);
@@ -1957,8 +1964,11 @@ Status DBImpl::CompactFilesImpl(
       snapshots_.GetAll(&earliest_write_conflict_snapshot);
 
   assert(is_snapshot_supported_ || snapshots_.empty());
+  if (db_options_.compaction_output_path_selector) {
+    c->SelectOutputPath(*db_options_.compaction_output_path_selector, db_options_.db_paths.size());
+  }
   CompactionJob compaction_job(
-      job_context->job_id, c.get(), db_options_, env_options_, versions_.get(),
+      job_context->job_id, c.get(), db_options_, env_options_for_compaction_, versions_.get(),
       &shutting_down_, log_buffer, directories_.GetDbDir(),
       directories_.GetDataDir(c->output_path_id()), stats_, &mutex_, &bg_error_,
       snapshot_seqs, earliest_write_conflict_snapshot, pending_outputs_.get(), table_cache_,
@@ -3109,7 +3119,8 @@ Result<FileNumbersHolder> DBImpl::BackgroundCompaction(
     assert(c->num_input_files(1) == 0);
     assert(c->level() == 0);
     assert(c->column_family_data()->ioptions()->compaction_style ==
-           kCompactionStyleFIFO);
+           kCompactionStyleFIFO ||
+           c->compaction_reason() == CompactionReason::kUniversalExpiredFiles);
 
     compaction_job_stats.num_input_files = c->num_input_files(0);
 
@@ -3194,8 +3205,12 @@ Result<FileNumbersHolder> DBImpl::BackgroundCompaction(
         snapshots_.GetAll(&earliest_write_conflict_snapshot);
 
     assert(is_snapshot_supported_ || snapshots_.empty());
+    if (db_options_.compaction_output_path_selector) {
+      c->SelectOutputPath(
+          *db_options_.compaction_output_path_selector, db_options_.db_paths.size());
+    }
     CompactionJob compaction_job(
-        job_context->job_id, c.get(), db_options_, env_options_,
+        job_context->job_id, c.get(), db_options_, env_options_for_compaction_,
         versions_.get(), &shutting_down_, log_buffer, directories_.GetDbDir(),
         directories_.GetDataDir(c->output_path_id()), stats_, &mutex_,
         &bg_error_, snapshot_seqs, earliest_write_conflict_snapshot,
@@ -3594,11 +3609,10 @@ std::vector<Status> DBImpl::MultiGet(
   }
   mutex_.Unlock();
 
-  // Contain a list of merge operations if merge occurs.
-  MergeContext merge_context;
-
+  // Contain a list of merge operations for each key if merge occurs.
   // Note: this always resizes the values array
   size_t num_keys = keys.size();
+  std::vector<MergeContext> merge_contexts(num_keys);
   std::vector<Status> stat_list(num_keys);
   values->resize(num_keys);
 
@@ -3606,42 +3620,69 @@ std::vector<Status> DBImpl::MultiGet(
   uint64_t bytes_read = 0;
   PERF_TIMER_STOP(get_snapshot_time);
 
-  // For each of the given keys, apply the entire "get" process as follows:
-  // First look in the memtable, then in the immutable memtable (if any).
-  // s is both in/out. When in, s could either be OK or MergeInProgress.
+  auto get_super_version = [&multiget_cf_data, &column_family](size_t i) {
+    auto cfh = down_cast<ColumnFamilyHandleImpl*>(column_family[i]);
+    auto mgd_iter = multiget_cf_data.find(cfh->cfd()->GetID());
+    assert(mgd_iter != multiget_cf_data.end());
+    return mgd_iter->second->super_version;
+  };
+
+  // For each of the given keys, first look in the memtable, then in the immutable memtable
+  // (if any). s is both in/out. When in, s could either be OK or MergeInProgress.
   // merge_operands will contain the sequence of merges in the latter case.
+  // Keys that are not found there are grouped by column family, so blocks of SST files that they
+  // need are read in one batch.
+  std::vector<bool> done(num_keys);
+  std::unordered_map<SuperVersion*, std::vector<Slice>> keys_to_prefetch;
+  bool skip_memtable =
+      (read_options.read_tier == kPersistedTier && has_unpersisted_data_);
   for (size_t i = 0; i < num_keys; ++i) {
-    merge_context.Clear();
     Status& s = stat_list[i];
     std::string* value = &(*values)[i];
 
     LookupKey lkey(keys[i], snapshot);
-    auto cfh = down_cast<ColumnFamilyHandleImpl*>(column_family[i]);
-    auto mgd_iter = multiget_cf_data.find(cfh->cfd()->GetID());
-    assert(mgd_iter != multiget_cf_data.end());
-    auto mgd = mgd_iter->second;
-    auto super_version = mgd->super_version;
-    bool skip_memtable =
-        (read_options.read_tier == kPersistedTier && has_unpersisted_data_);
-    bool done = false;
+    auto super_version = get_super_version(i);
     if (!skip_memtable) {
-      if (super_version->mem->Get(lkey, value, &s, &merge_context)) {
-        done = true;
+      if (super_version->mem->Get(lkey, value, &s, &merge_contexts[i])) {
+        done[i] = true;
         // TODO(?): RecordTick(stats_, MEMTABLE_HIT)?
-      } else if (super_version->imm->Get(lkey, value, &s, &merge_context)) {
-        done = true;
+      } else if (super_version->imm->Get(lkey, value, &s, &merge_contexts[i])) {
+        done[i] = true;
         // TODO(?): RecordTick(stats_, MEMTABLE_HIT)?
       }
     }
-    if (!done) {
-      PERF_TIMER_GUARD(get_from_output_files_time);
-      super_version->current->Get(read_options, lkey, value, &s,
-                                  &merge_context);
-      // TODO(?): RecordTick(stats_, MEMTABLE_MISS)?
+    if (!done[i]) {
+      keys_to_prefetch[super_version].push_back(keys[i]);
     }
+  }
 
-    if (s.ok()) {
-      bytes_read += value->size();
+  // Then apply the rest of the "get" process to keys which were not found in memtables.
+  {
+    PERF_TIMER_GUARD(get_from_output_files_time);
+    if (num_keys > 1) {
+      for (auto& super_version_and_keys : keys_to_prefetch) {
+        // Prefetching is an optimization, actual errors are reported by Get.
+        Status s = super_version_and_keys.first->current->PrefetchKeys(
+            read_options, std::move(super_version_and_keys.second));
+        if (!s.ok()) {
+          RLOG(InfoLogLevel::WARN_LEVEL, db_options_.info_log,
+               "MultiGet failed to prefetch keys: %s", s.ToString().c_str());
+        }
+      }
+    }
+    for (size_t i = 0; i < num_keys; ++i) {
+      if (!done[i]) {
+        LookupKey lkey(keys[i], snapshot);
+        get_super_version(i)->current->Get(
+            read_options, lkey, &(*values)[i], &stat_list[i], &merge_contexts[i]);
+        // TODO(?): RecordTick(stats_, MEMTABLE_MISS)?
+      }
+    }
+  }
+
+  for (size_t i = 0; i < num_keys; ++i) {
+    if (stat_list[i].ok()) {
+      bytes_read += (*values)[i].size();
     }
   }
 
@@ -3676,14 +3717,35 @@ std::vector<Status> DBImpl::MultiGet(
   return stat_list;
 }
 
+Status DBImpl::PrefetchKeys(const ReadOptions& read_options, ColumnFamilyHandle* column_family,
+                            const std::vector<Slice>& user_keys) {
+  auto cfh = down_cast<ColumnFamilyHandleImpl*>(column_family);
+  auto cfd = cfh->cfd();
+  SuperVersion* sv = GetAndRefSuperVersion(cfd);
+  Status s = sv->current->PrefetchKeys(read_options, user_keys);
+  ReturnAndCleanupSuperVersion(cfd, sv);
+  return s;
+}
+
 #ifndef ROCKSDB_LITE
 Status DBImpl::AddFile(ColumnFamilyHandle* column_family,
                        const std::string& file_path, bool move_file) {
+  ExternalSstFileInfo file_info;
+  Status status = GetExternalSstFileInfo(column_family, file_path, &file_info);
+  if (!status.ok()) {
+    return status;
+  }
+  return AddFile(column_family, &file_info, move_file);
+}
+
+Status DBImpl::GetExternalSstFileInfo(ColumnFamilyHandle* column_family,
+                                      const std::string& file_path,
+                                      ExternalSstFileInfo* file_info_out) {
   Status status;
   auto cfh = down_cast<ColumnFamilyHandleImpl*>(column_family);
   ColumnFamilyData* cfd = cfh->cfd();
 
-  ExternalSstFileInfo file_info;
+  ExternalSstFileInfo& file_info = *file_info_out;
   file_info.file_path = file_path;
   status = env_->GetFileSize(file_path, &file_info.base_file_size);
   if (!status.ok()) {
@@ -3771,7 +3833,7 @@ Status DBImpl::AddFile(ColumnFamilyHandle* column_family,
   }
   file_info.largest_key = key.user_key.ToString();
 
-  return AddFile(column_family, &file_info, move_file);
+  return Status::OK();
 }
 
 namespace {
@@ -3835,6 +3897,10 @@ Status DBImpl::AddFile(ColumnFamilyHandle* column_family,
     return STATUS(InvalidArgument,
         "Non zero sequence numbers are not supported");
   }
+  if (file_info->frontier) {
+    meta.smallest.user_frontier = file_info->frontier;
+    meta.largest.user_frontier = file_info->frontier;
+  }
 
   std::string db_base_fname;
   std::string db_data_fname;
@@ -3909,6 +3975,9 @@ Status DBImpl::AddFile(ColumnFamilyHandle* column_family,
         VersionEdit edit;
         edit.SetColumnFamily(cfd->GetID());
         edit.AddCleanedFile(0, meta);
+        if (file_info->frontier) {
+          edit.UpdateFlushedFrontier(file_info->frontier);
+        }
 
         status = versions_->LogAndApply(
             cfd, mutable_cf_options, &edit, &mutex_, directories_.GetDbDir());
@@ -4585,8 +4654,10 @@ Status DBImpl::WriteImpl(const WriteOptions& write_options,
     // 3. Deletes or SingleDeletes are not okay if filtering deletes
     //    (controlled by both batch and memtable setting)
     // 4. Merges are not okay
-    // 5. YugaByte-specific user-specified sequence numbers are currently not compatible with
-    //    parallel memtable writes.
+    //
+    // YugaByte frontiers attached to batches are fine: every writer gets its own sequence range
+    // assigned in write group order below, and MemTable::UpdateFrontiers is safe to call from
+    // concurrent writers.
     //
     // Rules 1..3 are enforced by checking the options
     // during startup (CheckConcurrentWritesSupported), so if
@@ -4996,6 +5067,30 @@ Status DBImpl::GetPropertiesOfTablesInRange(ColumnFamilyHandle* column_family,
   return s;
 }
 
+Status DBImpl::WarmUpBlockCache(ColumnFamilyHandle* column_family,
+                                RateLimiter* rate_limiter,
+                                const std::function<bool()>& should_stop) {
+  auto cfh = down_cast<ColumnFamilyHandleImpl*>(column_family);
+  auto cfd = cfh->cfd();
+
+  // Increment the ref count
+  mutex_.Lock();
+  auto version = cfd->current();
+  version->Ref();
+  mutex_.Unlock();
+
+  auto s = version->WarmUpBlockCache(rate_limiter, [this, &should_stop] {
+    return shutting_down_.load(std::memory_order_acquire) || (should_stop && should_stop());
+  });
+
+  // Decrement the ref count
+  mutex_.Lock();
+  version->Unref();
+  mutex_.Unlock();
+
+  return s;
+}
+
 #endif  // ROCKSDB_LITE
 
 const std::string& DBImpl::GetName() const {
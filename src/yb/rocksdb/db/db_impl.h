@@ -112,6 +112,10 @@ class DBImpl : public DB {
       const std::vector<Slice>& keys,
       std::vector<std::string>* values) override;
 
+  using DB::PrefetchKeys;
+  virtual Status PrefetchKeys(const ReadOptions& options, ColumnFamilyHandle* column_family,
+                              const std::vector<Slice>& user_keys) override;
+
   virtual Status CreateColumnFamily(const ColumnFamilyOptions& options,
                                     const std::string& column_family,
                                     ColumnFamilyHandle** handle) override;
@@ -287,6 +291,10 @@ class DBImpl : public DB {
                          bool move_file) override;
   virtual Status AddFile(ColumnFamilyHandle* column_family,
                          const std::string& file_path, bool move_file) override;
+  using DB::GetExternalSstFileInfo;
+  virtual Status GetExternalSstFileInfo(ColumnFamilyHandle* column_family,
+                                        const std::string& file_path,
+                                        ExternalSstFileInfo* file_info) override;
 
 #endif  // ROCKSDB_LITE
 
@@ -907,6 +915,9 @@ class DBImpl : public DB {
   // The options to access storage files
   const EnvOptions env_options_;
 
+  // The options to write table files by flushes and compactions
+  const EnvOptions env_options_for_compaction_;
+
 #ifndef ROCKSDB_LITE
   WalManager wal_manager_;
 #endif  // ROCKSDB_LITE
@@ -954,6 +965,11 @@ class DBImpl : public DB {
       ColumnFamilyHandle* column_family, const Range* range, std::size_t n,
       TablePropertiesCollection* props) override;
 
+  using DB::WarmUpBlockCache;
+  virtual Status WarmUpBlockCache(ColumnFamilyHandle* column_family,
+                                  RateLimiter* rate_limiter,
+                                  const std::function<bool()>& should_stop) override;
+
 #endif  // ROCKSDB_LITE
 
   // Function that Get and KeyMayExist call with no_io true or false
@@ -5321,6 +5321,62 @@ TEST_F(DBTest, ConcurrentMemtableNotSupported) {
   ASSERT_NOK(db_->CreateColumnFamily(cf_options, "name", &handle));
 }
 
+TEST_F(DBTest, HashIndexedSkipListMemtable) {
+  Options options = CurrentOptions();
+  options.create_if_missing = true;
+  options.prefix_extractor.reset();
+  options.memtable_factory.reset(NewHashIndexedSkipListRepFactory(
+      std::shared_ptr<const SliceTransform>(NewFixedPrefixTransform(2)), 16 /* bucket_count */));
+  DestroyAndReopen(options);
+
+  // The factory keeps its own transform, so it is not replaced during options sanitization.
+  ASSERT_STREQ("HashIndexedSkipListRepFactory",
+               dbfull()->GetOptions().memtable_factory->Name());
+
+  std::vector<std::string> keys;
+  for (char prefix = 'a'; prefix <= 'h'; ++prefix) {
+    for (int i = 0; i != 10; ++i) {
+      keys.push_back(std::string(2, prefix) + std::to_string(i));
+    }
+  }
+  std::random_shuffle(keys.begin(), keys.end());
+  for (const auto& key : keys) {
+    ASSERT_OK(Put(key, "v1_" + key));
+  }
+  for (size_t i = 0; i < keys.size(); i += 3) {
+    ASSERT_OK(Put(keys[i], "v2_" + keys[i]));
+  }
+  ASSERT_OK(Delete(keys[1]));
+
+  for (size_t i = 0; i != keys.size(); ++i) {
+    const std::string expected = i == 1 ? "NOT_FOUND" : (i % 3 == 0 ? "v2_" : "v1_") + keys[i];
+    ASSERT_EQ(expected, Get(keys[i]));
+  }
+  ASSERT_EQ("NOT_FOUND", Get("aa"));
+  ASSERT_EQ("NOT_FOUND", Get("zz0"));
+
+  // Iteration should see all the keys in order, across prefixes.
+  std::set<std::string> expected_keys(keys.begin(), keys.end());
+  expected_keys.erase(keys[1]);
+  std::unique_ptr<Iterator> iter(db_->NewIterator(ReadOptions()));
+  auto expected_it = expected_keys.begin();
+  for (iter->SeekToFirst(); iter->Valid(); iter->Next(), ++expected_it) {
+    ASSERT_NE(expected_it, expected_keys.end());
+    ASSERT_EQ(*expected_it, iter->key().ToString());
+  }
+  ASSERT_EQ(expected_it, expected_keys.end());
+
+  iter->Seek("cc5");
+  ASSERT_TRUE(iter->Valid());
+  ASSERT_EQ(*expected_keys.lower_bound("cc5"), iter->key().ToString());
+  iter->Seek("dd");
+  ASSERT_TRUE(iter->Valid());
+  ASSERT_EQ(*expected_keys.lower_bound("dd"), iter->key().ToString());
+  iter->SeekToLast();
+  ASSERT_TRUE(iter->Valid());
+  ASSERT_EQ(*expected_keys.rbegin(), iter->key().ToString());
+}
+
 #endif  // ROCKSDB_LITE
 
 TEST_F(DBTest, SanitizeNumThreads) {
@@ -8616,6 +8672,48 @@ TEST_F(DBTest, AddExternalSstFile) {
                          kSkipFIFOCompaction));
 }
 
+TEST_F(DBTest, AddExternalSstFileWithFrontier) {
+  std::string sst_files_folder = test::TmpDir(env_) + "/sst_files/";
+  env_->CreateDir(sst_files_folder);
+  Options options = CurrentOptions();
+  options.env = env_;
+  options.disable_auto_compactions = true;
+  DestroyAndReopen(options);
+  const ImmutableCFOptions ioptions(options);
+
+  SstFileWriter sst_file_writer(EnvOptions(), ioptions, options.comparator);
+  std::string sst_file_path = sst_files_folder + "file_with_frontier.sst";
+  ASSERT_OK(sst_file_writer.Open(sst_file_path));
+  for (int i = 0; i < 100; i++) {
+    ASSERT_OK(sst_file_writer.Add(Key(i), Key(i) + "_val"));
+  }
+  ASSERT_OK(sst_file_writer.Finish());
+
+  ExternalSstFileInfo file_info;
+  ASSERT_OK(db_->GetExternalSstFileInfo(sst_file_path, &file_info));
+  ASSERT_EQ(Key(0), file_info.smallest_key);
+  ASSERT_EQ(Key(99), file_info.largest_key);
+  ASSERT_EQ(100, file_info.num_entries);
+
+  file_info.frontier = test::TestUserFrontier(42).Clone();
+  ASSERT_OK(db_->AddFile(&file_info));
+
+  auto flushed_frontier = db_->GetFlushedFrontier();
+  ASSERT_TRUE(flushed_frontier);
+  ASSERT_EQ(42, down_cast<test::TestUserFrontier&>(*flushed_frontier).Value());
+
+  std::vector<LiveFileMetaData> live_files;
+  db_->GetLiveFilesMetaData(&live_files);
+  ASSERT_EQ(1, live_files.size());
+  const auto& largest_frontier = live_files[0].largest.user_frontier;
+  ASSERT_TRUE(largest_frontier);
+  ASSERT_EQ(42, down_cast<test::TestUserFrontier&>(*largest_frontier).Value());
+
+  for (int i = 0; i < 100; i++) {
+    ASSERT_EQ(Key(i) + "_val", Get(Key(i)));
+  }
+}
+
 // This test reporduce a bug that can happen in some cases if the DB started
 // purging obsolete files when we are adding an external sst file.
 // This situation may result in deleting the file while it's being added.
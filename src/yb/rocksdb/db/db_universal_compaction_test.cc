@@ -1350,6 +1350,207 @@ class DBTestUniversalCompaction : public DBTestBase {
   DBTestUniversalCompaction() : DBTestBase("/db_universal_compaction_test") {}
 };
 
+namespace {
+
+constexpr size_t kDocPrefixSize = 9;
+
+// Checks that all keys sharing a prefix are processed by the same compaction filter.
+class PrefixCheckingFilterFactory : public CompactionFilterFactory {
+ public:
+  class PrefixCheckingFilter : public CompactionFilter {
+   public:
+    PrefixCheckingFilter(PrefixCheckingFilterFactory* factory, int id)
+        : factory_(factory), id_(id) {}
+
+    bool Filter(int level, const Slice& key, const Slice& value,
+                std::string* new_value, bool* value_changed) const override {
+      factory_->KeySeen(key, id_);
+      return false;
+    }
+
+    const char* Name() const override { return "PrefixCheckingFilter"; }
+
+   private:
+    PrefixCheckingFilterFactory* factory_;
+    int id_;
+  };
+
+  std::unique_ptr<CompactionFilter> CreateCompactionFilter(
+      const CompactionFilter::Context& context) override {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return std::make_unique<PrefixCheckingFilter>(this, next_id_++);
+  }
+
+  const char* Name() const override { return "PrefixCheckingFilterFactory"; }
+
+  Slice SubcompactionBoundary(const Slice& user_key) const override {
+    return Slice(user_key.data(), std::min(user_key.size(), kDocPrefixSize));
+  }
+
+  void KeySeen(const Slice& key, int filter_id) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = prefix_filter_.emplace(SubcompactionBoundary(key).ToString(), filter_id).first;
+    ASSERT_EQ(filter_id, it->second) << "Prefix split between filters: " << it->first;
+  }
+
+  int num_filters() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return next_id_;
+  }
+
+ private:
+  std::mutex mutex_;
+  int next_id_ = 0;
+  std::unordered_map<std::string, int> prefix_filter_;
+};
+
+} // namespace
+
+TEST_F(DBTestUniversalCompaction, SubcompactionsSingleLevel) {
+  Options options = CurrentOptions();
+  options.compaction_style = kCompactionStyleUniversal;
+  options.num_levels = 1;
+  options.max_subcompactions = 4;
+  options.write_buffer_size = 1 << 20;
+  options.level0_file_num_compaction_trigger = 100;
+  auto* filter_factory = new PrefixCheckingFilterFactory();
+  options.compaction_filter_factory.reset(filter_factory);
+  DestroyAndReopen(options);
+
+  constexpr int kNumDocs = 200;
+  constexpr int kNumFiles = 4;
+  Random rnd(301);
+  std::map<std::string, std::string> expected;
+  auto write_file = [&](int file_idx) {
+    for (int doc = 0; doc < kNumDocs; ++doc) {
+      // Keys of a document share the kDocPrefixSize prefix produced by Key().
+      std::string key = Key(doc) + "/" + ToString(file_idx);
+      std::string value = RandomString(&rnd, 1000);
+      ASSERT_OK(Put(key, value));
+      expected[key] = value;
+    }
+    ASSERT_OK(Flush());
+  };
+  for (int i = 0; i < kNumFiles; ++i) {
+    write_file(i);
+  }
+  ASSERT_EQ(kNumFiles, NumTableFilesAtLevel(0));
+
+  ASSERT_OK(db_->CompactRange(CompactRangeOptions(), nullptr, nullptr));
+  ASSERT_GT(filter_factory->num_filters(), 1);
+  ASSERT_EQ(filter_factory->num_filters(), NumTableFilesAtLevel(0));
+  for (const auto& entry : expected) {
+    ASSERT_EQ(entry.second, Get(entry.first));
+  }
+
+  // Outputs of the split compaction are a single sorted run, so they are compacted together with
+  // new files.
+  write_file(kNumFiles);
+  const int num_filters_before = filter_factory->num_filters();
+  ASSERT_OK(db_->CompactRange(CompactRangeOptions(), nullptr, nullptr));
+  ASSERT_GT(filter_factory->num_filters() - num_filters_before, 1);
+  ASSERT_EQ(filter_factory->num_filters() - num_filters_before, NumTableFilesAtLevel(0));
+  for (const auto& entry : expected) {
+    ASSERT_EQ(entry.second, Get(entry.first));
+  }
+}
+
+namespace {
+
+// Marks the first files_to_mark tables that contain kMarkedKey as needing compaction.
+class MarkingPropertiesCollectorFactory : public TablePropertiesCollectorFactory {
+ public:
+  static constexpr const char* kMarkedKey = "marked";
+
+  explicit MarkingPropertiesCollectorFactory(int files_to_mark) : files_to_mark_(files_to_mark) {}
+
+  TablePropertiesCollector* CreateTablePropertiesCollector(
+      TablePropertiesCollectorFactory::Context context) override {
+    return new Collector(&files_to_mark_);
+  }
+
+  const char* Name() const override { return "MarkingPropertiesCollectorFactory"; }
+
+ private:
+  class Collector : public TablePropertiesCollector {
+   public:
+    explicit Collector(std::atomic<int>* files_to_mark) : files_to_mark_(files_to_mark) {}
+
+    Status AddUserKey(const Slice& key, const Slice& value, EntryType type, SequenceNumber seq,
+                      uint64_t file_size) override {
+      has_marked_key_ = has_marked_key_ || key == kMarkedKey;
+      return Status::OK();
+    }
+
+    Status Finish(UserCollectedProperties* properties) override {
+      need_compact_ = has_marked_key_ && files_to_mark_->fetch_sub(1) > 0;
+      return Status::OK();
+    }
+
+    UserCollectedProperties GetReadableProperties() const override { return {}; }
+
+    const char* Name() const override { return "MarkingPropertiesCollector"; }
+
+    bool NeedCompact() const override { return need_compact_; }
+
+   private:
+    std::atomic<int>* files_to_mark_;
+    bool has_marked_key_ = false;
+    bool need_compact_ = false;
+  };
+
+  std::atomic<int> files_to_mark_;
+};
+
+class CompactionReasonListener : public EventListener {
+ public:
+  void OnCompactionCompleted(DB* db, const CompactionJobInfo& info) override {
+    std::lock_guard<std::mutex> lock(mutex_);
+    reasons_.push_back(info.compaction_reason);
+  }
+
+  std::vector<CompactionReason> reasons() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return reasons_;
+  }
+
+ private:
+  std::mutex mutex_;
+  std::vector<CompactionReason> reasons_;
+};
+
+} // namespace
+
+TEST_F(DBTestUniversalCompaction, CompactFilesMarkedForCompaction) {
+  Options options = CurrentOptions();
+  options.compaction_style = kCompactionStyleUniversal;
+  options.num_levels = 1;
+  options.level0_file_num_compaction_trigger = 100;
+  options.table_properties_collector_factories.emplace_back(
+      std::make_shared<MarkingPropertiesCollectorFactory>(1));
+  auto listener = std::make_shared<CompactionReasonListener>();
+  options.listeners.push_back(listener);
+  DestroyAndReopen(options);
+
+  ASSERT_OK(Put("a", "1"));
+  ASSERT_OK(Flush());
+  ASSERT_OK(Put(MarkingPropertiesCollectorFactory::kMarkedKey, "2"));
+  ASSERT_OK(Put("b", "3"));
+  ASSERT_OK(Flush());
+  ASSERT_OK(Put("c", "4"));
+  ASSERT_OK(Flush());
+  dbfull()->TEST_WaitForCompact();
+
+  // Only the marked file is compacted, its output is not marked again.
+  ASSERT_EQ(std::vector<CompactionReason>{CompactionReason::kFilesMarkedForCompaction},
+            listener->reasons());
+  ASSERT_EQ(3, NumTableFilesAtLevel(0));
+  ASSERT_EQ("1", Get("a"));
+  ASSERT_EQ("2", Get(MarkingPropertiesCollectorFactory::kMarkedKey));
+  ASSERT_EQ("3", Get("b"));
+  ASSERT_EQ("4", Get("c"));
+}
+
 TEST_F(DBTestUniversalCompaction, DontDeleteOutput) {
   Options options;
   options.env = env_;
@@ -117,6 +117,9 @@ extern void AppendInternalKey(std::string* result,
 extern bool ParseInternalKey(const Slice& internal_key,
                              ParsedInternalKey* result);
 
+// Size of the sequence number and value type suffix of an internal key.
+constexpr size_t kLastInternalComponentSize = 8;
+
 // Returns the user key portion of an internal key.
 inline Slice ExtractUserKey(const Slice& internal_key) {
   assert(internal_key.size() >= 8);
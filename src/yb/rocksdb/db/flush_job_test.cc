@@ -175,6 +175,60 @@ TEST_F(FlushJobTest, NonEmpty) {
   job_context.Clean();
 }
 
+TEST_F(FlushJobTest, MultipleMemTables) {
+  JobContext job_context(0);
+  auto cfd = versions_->GetColumnFamilySet()->GetDefault();
+  auto inserted_keys = mock::MakeMockFile();
+  constexpr int kNumMemTables = 3;
+  constexpr int kKeysPerMemTable = 1000;
+
+  // All pending immutable memtables should be merged into a single output file.
+  SequenceNumber seqno = 1;
+  for (int m = 0; m < kNumMemTables; ++m) {
+    auto new_mem = cfd->ConstructNewMemtable(*cfd->GetLatestMutableCFOptions(),
+                                             kMaxSequenceNumber);
+    new_mem->Ref();
+    for (int i = 0; i < kKeysPerMemTable; ++i) {
+      std::string key(ToString(i * kNumMemTables + m));
+      std::string value("value" + key);
+      new_mem->Add(seqno, kTypeValue, key, value);
+      InternalKey internal_key(key, seqno, kTypeValue);
+      inserted_keys.emplace(internal_key.Encode().ToBuffer(), value);
+      ++seqno;
+    }
+    test::TestUserFrontiers frontiers(m * 10, m * 10 + 5);
+    new_mem->UpdateFrontiers(frontiers);
+
+    autovector<MemTable*> to_delete;
+    cfd->imm()->Add(new_mem, &to_delete);
+    for (auto& mem : to_delete) {
+      delete mem;
+    }
+  }
+  ASSERT_EQ(kNumMemTables, cfd->imm()->NumNotFlushed());
+
+  EventLogger event_logger(db_options_.info_log.get());
+  FileNumbersProvider file_numbers_provider(versions_.get());
+  FlushJob flush_job(dbname_, versions_->GetColumnFamilySet()->GetDefault(),
+                     db_options_, *cfd->GetLatestMutableCFOptions(),
+                     env_options_, versions_.get(), &mutex_, &shutting_down_,
+                     {}, kMaxSequenceNumber, MemTableFilter(), &file_numbers_provider,
+                     &job_context, nullptr, nullptr, nullptr, kNoCompression, nullptr,
+                     &event_logger);
+  FileMetaData fd;
+  mutex_.Lock();
+  ASSERT_OK(yb::ResultToStatus(flush_job.Run(&fd)));
+  mutex_.Unlock();
+  ASSERT_EQ(0, cfd->imm()->NumNotFlushed());
+  ASSERT_EQ(1, fd.smallest.seqno);
+  ASSERT_EQ(seqno - 1, fd.largest.seqno);
+  test::TestUserFrontiers expected_frontiers(0, (kNumMemTables - 1) * 10 + 5);
+  ASSERT_TRUE(expected_frontiers.Smallest().Equals(*fd.smallest.user_frontier));
+  ASSERT_TRUE(expected_frontiers.Largest().Equals(*fd.largest.user_frontier));
+  mock_table_factory_->AssertSingleFile(inserted_keys);
+  job_context.Clean();
+}
+
 TEST_F(FlushJobTest, Snapshots) {
   JobContext job_context(0);
   auto cfd = versions_->GetColumnFamilySet()->GetDefault();
@@ -52,6 +52,7 @@ int main() {
 #include "yb/rocksdb/options.h"
 #include "yb/rocksdb/slice_transform.h"
 #include "yb/rocksdb/util/arena.h"
+#include "yb/rocksdb/util/concurrent_arena.h"
 #include "yb/rocksdb/util/mutexlock.h"
 #include "yb/rocksdb/util/stop_watch.h"
 #include "yb/rocksdb/util/testutil.h"
@@ -64,6 +65,8 @@ DEFINE_string(benchmarks, "fillrandom",
               "Comma-separated list of benchmarks to run. Options:\n"
               "\tfillrandom             -- write N random values\n"
               "\tfillseq                -- write N values in sequential order\n"
+              "\tfillrandomconcurrent   -- N threads concurrently write random "
+              "values\n"
               "\treadrandom             -- read N values in random order\n"
               "\treadseq                -- scan the DB\n"
               "\treadwrite              -- 1 thread writes while N - 1 threads "
@@ -125,7 +128,8 @@ DEFINE_int64(
 DEFINE_int32(
     num_threads, 1,
     "Number of concurrent threads to run. If the benchmark includes writes,\n"
-    "then at most one thread will be a writer");
+    "then at most one thread will be a writer, except for\n"
+    "fillrandomconcurrent where all threads are writers");
 
 DEFINE_int32(num_operations, 1000000,
              "Number of operations to do for write and random read benchmarks");
@@ -262,26 +266,34 @@ class FillBenchmarkThread : public BenchmarkThread {
                         num_ops, read_hits) {}
 
   void FillOne() {
+    size_t encoded_len = 0;
+    KeyHandle handle = EncodeEntry(key_gen_->Next(), ++(*sequence_), &encoded_len);
+    table_->Insert(handle);
+    *bytes_written_ += encoded_len;
+  }
+
+ protected:
+  KeyHandle EncodeEntry(uint64_t key, uint64_t sequence, size_t* encoded_len) {
     char* buf = nullptr;
     auto internal_key_size = 16;
-    auto encoded_len =
+    *encoded_len =
         FLAGS_item_size + VarintLength(internal_key_size) + internal_key_size;
-    KeyHandle handle = table_->Allocate(encoded_len, &buf);
+    KeyHandle handle = table_->Allocate(*encoded_len, &buf);
     assert(buf != nullptr);
     char* p = EncodeVarint32(buf, internal_key_size);
-    auto key = key_gen_->Next();
     EncodeFixed64(p, key);
     p += 8;
-    EncodeFixed64(p, ++(*sequence_));
+    EncodeFixed64(p, sequence);
     p += 8;
     Slice bytes = generator_.Generate(FLAGS_item_size);
     memcpy(p, bytes.data(), FLAGS_item_size);
     p += FLAGS_item_size;
-    assert(p == buf + encoded_len);
-    table_->Insert(handle);
-    *bytes_written_ += encoded_len;
+    assert(p == buf + *encoded_len);
+    return handle;
   }
 
+ public:
+
   void operator()() override {
     for (unsigned int i = 0; i < num_ops_; ++i) {
       FillOne();
@@ -313,6 +325,34 @@ class ConcurrentFillBenchmarkThread : public FillBenchmarkThread {
   std::atomic_int* threads_done_;
 };
 
+// One of several writer threads inserting into the same memtable rep, the way concurrent
+// memtable writes of a parallel write group do. Every writer gets its own key generator, while
+// sequence numbers are handed out from a shared atomic counter so internal keys stay unique.
+class ParallelFillBenchmarkThread : public FillBenchmarkThread {
+ public:
+  ParallelFillBenchmarkThread(MemTableRep* table, KeyGenerator* key_gen,
+                              uint64_t* bytes_written, uint64_t* bytes_read,
+                              std::atomic<uint64_t>* sequence, uint64_t num_ops,
+                              uint64_t* read_hits)
+      : FillBenchmarkThread(table, key_gen, bytes_written, bytes_read, nullptr,
+                            num_ops, read_hits),
+        atomic_sequence_(sequence) {}
+
+  void operator()() override {
+    for (unsigned int i = 0; i < num_ops_; ++i) {
+      size_t encoded_len = 0;
+      KeyHandle handle = EncodeEntry(
+          key_gen_->Next(), atomic_sequence_->fetch_add(1, std::memory_order_relaxed) + 1,
+          &encoded_len);
+      table_->InsertConcurrently(handle);
+      *bytes_written_ += encoded_len;
+    }
+  }
+
+ private:
+  std::atomic<uint64_t>* atomic_sequence_;
+};
+
 class ReadBenchmarkThread : public BenchmarkThread {
  public:
   ReadBenchmarkThread(MemTableRep* table, KeyGenerator* key_gen,
@@ -502,6 +542,45 @@ class FillBenchmark : public Benchmark {
   }
 };
 
+class ParallelFillBenchmark : public Benchmark {
+ public:
+  explicit ParallelFillBenchmark(MemTableRep* table, Random64* rng,
+                                 uint64_t* sequence)
+      : Benchmark(table, nullptr, sequence, FLAGS_num_threads),
+        rng_(rng) {
+    num_write_ops_per_thread_ = FLAGS_num_operations / FLAGS_num_threads;
+  }
+
+  void RunThreads(std::vector<std::thread>* threads, uint64_t* bytes_written,
+                  uint64_t* bytes_read, bool write,
+                  uint64_t* read_hits) override {
+    std::atomic<uint64_t> sequence(*sequence_);
+    std::vector<std::unique_ptr<Random64>> rngs;
+    std::vector<std::unique_ptr<KeyGenerator>> key_gens;
+    std::vector<uint64_t> thread_bytes_written(FLAGS_num_threads, 0);
+    for (int i = 0; i < FLAGS_num_threads; ++i) {
+      rngs.emplace_back(new Random64(rng_->Next()));
+      key_gens.emplace_back(new KeyGenerator(
+          rngs.back().get(), RANDOM, FLAGS_num_operations));
+    }
+    for (int i = 0; i < FLAGS_num_threads; ++i) {
+      threads->emplace_back(ParallelFillBenchmarkThread(
+          table_, key_gens[i].get(), &thread_bytes_written[i], bytes_read,
+          &sequence, num_write_ops_per_thread_, read_hits));
+    }
+    for (auto& thread : *threads) {
+      thread.join();
+    }
+    for (auto thread_bytes : thread_bytes_written) {
+      *bytes_written += thread_bytes;
+    }
+    *sequence_ = sequence.load();
+  }
+
+ private:
+  Random64* rng_;
+};
+
 class ReadBenchmark : public Benchmark {
  public:
   explicit ReadBenchmark(MemTableRep* table, KeyGenerator* key_gen,
@@ -638,14 +717,16 @@ int main(int argc, char** argv) {
       rocksdb::BytewiseComparator());
   rocksdb::MemTable::KeyComparator key_comp(internal_key_comp);
   rocksdb::Arena arena;
+  rocksdb::ConcurrentArena concurrent_arena;
   rocksdb::WriteBuffer wb(FLAGS_write_buffer_size);
   rocksdb::MemTableAllocator memtable_allocator(&arena, &wb);
+  rocksdb::MemTableAllocator concurrent_memtable_allocator(&concurrent_arena, &wb);
   uint64_t sequence;
-  auto createMemtableRep = [&] {
+  auto createMemtableRep = [&](bool concurrent_inserts = false) {
     sequence = 0;
-    return factory->CreateMemTableRep(key_comp, &memtable_allocator,
-                                      options.prefix_extractor.get(),
-                                      options.info_log.get());
+    return factory->CreateMemTableRep(
+        key_comp, concurrent_inserts ? &concurrent_memtable_allocator : &memtable_allocator,
+        options.prefix_extractor.get(), options.info_log.get());
   };
   std::unique_ptr<rocksdb::MemTableRep> memtablerep;
   rocksdb::Random64 rng(FLAGS_seed);
@@ -674,6 +755,15 @@ int main(int argc, char** argv) {
                                               FLAGS_num_operations));
       benchmark.reset(new rocksdb::FillBenchmark(memtablerep.get(),
                                                  key_gen.get(), &sequence));
+    } else if (name == rocksdb::Slice("fillrandomconcurrent")) {
+      if (!factory->IsInsertConcurrentlySupported()) {
+        std::cout << "WARNING: skipping fillrandomconcurrent, " << factory->Name()
+                  << " does not support concurrent inserts" << std::endl;
+        continue;
+      }
+      memtablerep.reset(createMemtableRep(true /* concurrent_inserts */));
+      benchmark.reset(new rocksdb::ParallelFillBenchmark(memtablerep.get(),
+                                                         &rng, &sequence));
     } else if (name == rocksdb::Slice("readrandom")) {
       key_gen.reset(new rocksdb::KeyGenerator(&rng, rocksdb::RANDOM,
                                               FLAGS_num_operations));
@@ -137,7 +137,18 @@ Status TableCache::GetTableReader(
     const InternalKeyComparatorPtr& internal_comparator, const FileDescriptor& fd,
     bool sequential_mode, bool record_read_stats, HistogramImpl* file_read_hist,
     unique_ptr<TableReader>* table_reader, bool skip_filters) {
-  const std::string base_fname = TableFileName(ioptions_.db_paths, fd.GetNumber(), fd.GetPathId());
+  std::string base_fname = TableFileName(ioptions_.db_paths, fd.GetNumber(), fd.GetPathId());
+  if (ioptions_.db_paths.size() > 1 && !ioptions_.env->FileExists(base_fname).ok()) {
+    // A checkpoint or remote bootstrap of a DB with several db_paths puts all files into a single
+    // directory, so the file could be located in a path other than the recorded one.
+    for (uint32_t path_id = 0; path_id < ioptions_.db_paths.size(); ++path_id) {
+      auto fname = TableFileName(ioptions_.db_paths, fd.GetNumber(), path_id);
+      if (ioptions_.env->FileExists(fname).ok()) {
+        base_fname = std::move(fname);
+        break;
+      }
+    }
+  }
 
   Status s;
   {
@@ -412,6 +423,27 @@ Status TableCache::Get(const ReadOptions& options,
   return s;
 }
 
+Status TableCache::PrefetchKeys(const ReadOptions& options,
+    const InternalKeyComparatorPtr& internal_comparator,
+    const FileDescriptor& fd, const std::vector<Slice>& internal_keys,
+    HistogramImpl* file_read_hist) {
+  TableReader* t = fd.table_reader;
+  Cache::Handle* handle = nullptr;
+  if (!t) {
+    RETURN_NOT_OK(FindTable(env_options_, internal_comparator, fd, &handle, options.query_id,
+                            false /* no_io */, true /* record_read_stats */, file_read_hist));
+    t = GetTableReaderFromHandle(handle);
+  }
+  Status s;
+  if (!options.table_aware_file_filter || options.table_aware_file_filter->Filter(t)) {
+    s = t->PrefetchKeys(options, internal_keys);
+  }
+  if (handle != nullptr) {
+    ReleaseHandle(handle);
+  }
+  return s;
+}
+
 Status TableCache::GetTableProperties(
     const EnvOptions& env_options,
     const InternalKeyComparatorPtr& internal_comparator, const FileDescriptor& fd,
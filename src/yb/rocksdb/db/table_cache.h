@@ -104,6 +104,13 @@ class TableCache {
              GetContext* get_context, HistogramImpl* file_read_hist = nullptr,
              bool skip_filters = false);
 
+  // Loads data blocks of the specified file where seeks to internal_keys would start,
+  // see TableReader::PrefetchKeys.
+  Status PrefetchKeys(const ReadOptions& options,
+                      const InternalKeyComparatorPtr& internal_comparator,
+                      const FileDescriptor& file_fd, const std::vector<Slice>& internal_keys,
+                      HistogramImpl* file_read_hist = nullptr);
+
   // Evict any entry for the specified file number
   static void Evict(Cache* cache, uint64_t file_number);
 
@@ -147,7 +147,13 @@ class VersionBuilder::Rep {
           assert(f1->largest.seqno > f2->largest.seqno ||
                  // We can have multiple files with seqno = 0 as a result of
                  // using DB::AddFile()
-                 (f1->largest.seqno == 0 && f2->largest.seqno == 0));
+                 (f1->largest.seqno == 0 && f2->largest.seqno == 0) ||
+                 // Outputs of a single universal compaction split into
+                 // subcompactions share the seqno range but cover disjoint
+                 // key ranges.
+                 (f1->smallest.seqno == f2->smallest.seqno &&
+                  f1->largest.seqno == f2->largest.seqno &&
+                  !FileKeyRangesOverlap(vstorage, f1, f2)));
         } else {
           assert(level_nonzero_cmp_(f1, f2));
 
@@ -165,6 +171,15 @@ class VersionBuilder::Rep {
 #endif
   }
 
+#ifndef NDEBUG
+  static bool FileKeyRangesOverlap(VersionStorageInfo* vstorage, FileMetaData* f1,
+                                   FileMetaData* f2) {
+    const Comparator* ucmp = vstorage->InternalComparator()->user_comparator();
+    return ucmp->Compare(f1->largest.key.user_key(), f2->smallest.key.user_key()) >= 0 &&
+           ucmp->Compare(f2->largest.key.user_key(), f1->smallest.key.user_key()) >= 0;
+  }
+#endif
+
   void CheckConsistencyForDeletes(VersionEdit* edit, uint64_t number,
                                   int level) {
 #ifndef NDEBUG
@@ -54,8 +54,10 @@
 #include "yb/rocksdb/db/compaction.h"
 #include "yb/rocksdb/db/version_builder.h"
 #include "yb/rocksdb/db/writebuffer.h"
+#include "yb/rocksdb/compaction_filter.h"
 #include "yb/rocksdb/env.h"
 #include "yb/rocksdb/merge_operator.h"
+#include "yb/rocksdb/rate_limiter.h"
 #include "yb/rocksdb/table/internal_iterator.h"
 #include "yb/rocksdb/table/table_reader.h"
 #include "yb/rocksdb/table/merger.h"
@@ -649,6 +651,44 @@ Status Version::GetPropertiesOfAllTables(TablePropertiesCollection* props,
   return Status::OK();
 }
 
+Status Version::WarmUpBlockCache(
+    RateLimiter* rate_limiter, const std::function<bool()>& should_stop) {
+  auto table_cache = cfd_->table_cache();
+  for (int level = 0; level < storage_info_.num_non_empty_levels(); level++) {
+    for (const auto& file_meta : storage_info_.LevelFiles(level)) {
+      if (should_stop()) {
+        return STATUS(Aborted, "Block cache warm up stopped");
+      }
+
+      Cache::Handle* handle = nullptr;
+      RETURN_NOT_OK(table_cache->FindTable(
+          vset_->env_options_, cfd_->internal_comparator(), file_meta->fd, &handle,
+          kDefaultQueryId, false /* no_io */, true /* record_read_stats */,
+          cfd_->internal_stats()->GetFileReadHist(level)));
+      auto* table_reader = table_cache->GetTableReaderFromHandle(handle);
+
+      if (rate_limiter) {
+        const auto table_properties = table_reader->GetTableProperties();
+        if (table_properties) {
+          int64_t bytes_left = table_properties->data_index_size + table_properties->filter_size +
+                               table_properties->filter_index_size;
+          while (bytes_left > 0) {
+            const auto bytes = std::min(bytes_left, rate_limiter->GetSingleBurstBytes());
+            rate_limiter->Request(bytes, Env::IO_LOW);
+            bytes_left -= bytes;
+          }
+        }
+      }
+
+      const auto status = table_reader->WarmUpBlockCache();
+      table_cache->ReleaseHandle(handle);
+      RETURN_NOT_OK(status);
+    }
+  }
+
+  return Status::OK();
+}
+
 Status Version::GetPropertiesOfTablesInRange(
     const Range* range, std::size_t n, TablePropertiesCollection* props) const {
   for (int level = 0; level < storage_info_.num_non_empty_levels(); level++) {
@@ -999,6 +1039,54 @@ void Version::Get(const ReadOptions& read_options, const LookupKey& k,
   }
 }
 
+Status Version::PrefetchKeys(const ReadOptions& read_options, std::vector<Slice> user_keys) {
+  const Comparator* ucmp = user_comparator();
+  std::sort(user_keys.begin(), user_keys.end(), [ucmp](const Slice& lhs, const Slice& rhs) {
+    return ucmp->Compare(lhs, rhs) < 0;
+  });
+  user_keys.erase(std::unique(user_keys.begin(), user_keys.end(),
+                              [ucmp](const Slice& lhs, const Slice& rhs) {
+                                return ucmp->Compare(lhs, rhs) == 0;
+                              }),
+                  user_keys.end());
+  std::vector<InternalKey> seek_keys;
+  seek_keys.reserve(user_keys.size());
+  for (const auto& user_key : user_keys) {
+    seek_keys.emplace_back(user_key, kMaxSequenceNumber, kValueTypeForSeek);
+  }
+
+  std::vector<Slice> file_keys;
+  for (int level = 0; level < storage_info_.num_non_empty_levels(); level++) {
+    const auto& level_files = storage_info_.LevelFilesBrief(level);
+    for (size_t i = 0; i < level_files.num_files; i++) {
+      const auto& file = level_files.files[i];
+      if (read_options.file_filter && !read_options.file_filter->Filter(file)) {
+        continue;
+      }
+      const Slice smallest = file.smallest.user_key();
+      const Slice largest = file.largest.user_key();
+      file_keys.clear();
+      for (size_t idx = 0; idx != user_keys.size(); ++idx) {
+        const auto& user_key = user_keys[idx];
+        if (ucmp->Compare(user_key, largest) > 0) {
+          break;
+        }
+        // Keys of the file starting with user_key could be greater than user_key.
+        if (ucmp->Compare(smallest, user_key) <= 0 || smallest.starts_with(user_key)) {
+          file_keys.push_back(seek_keys[idx].Encode());
+        }
+      }
+      if (file_keys.empty()) {
+        continue;
+      }
+      RETURN_NOT_OK(table_cache_->PrefetchKeys(
+          read_options, internal_comparator(), file.fd, file_keys,
+          cfd_->internal_stats()->GetFileReadHist(level)));
+    }
+  }
+  return Status::OK();
+}
+
 bool Version::IsFilterSkipped(int level, bool is_file_last_in_level) {
   // Reaching the bottom level implies misses at all upper levels, so we'll
   // skip checking the filters when we predict a hit.
@@ -2080,7 +2168,7 @@ VersionSet::VersionSet(const std::string& dbname, const DBOptions* db_options,
       dbname_(dbname),
       db_options_(db_options),
       env_options_(storage_options),
-      env_options_compactions_(env_options_) {}
+      env_options_compactions_(env_->OptimizeForCompactionTableRead(env_options_, *db_options)) {}
 
 VersionSet::~VersionSet() {
   // we need to delete column_family_set_ because its destructor depends on
@@ -2869,7 +2957,8 @@ Status VersionSet::Import(const std::string& source_dir,
   auto prev = segments.front();
   for (size_t i = 1; i != segments.size(); ++i) {
     const auto& segment = segments[i];
-    if (segment.first <= prev.second) {
+    // Outputs of a compaction split into subcompactions share the same seqno range.
+    if (segment.first <= prev.second && segment != prev) {
       return STATUS_FORMAT(Corruption,
                            "Overlapping seqno ranges: [$0, $1] and [$2, $3]",
                            prev.first,
@@ -3527,11 +3616,22 @@ InternalIterator* VersionSet::MakeInputIterator(Compaction* c) {
                                         : c->num_input_levels());
   InternalIterator** list = new InternalIterator* [space];
   size_t num = 0;
+  // Files dropped by the filter are still deleted by this compaction, but are not read.
+  std::unique_ptr<CompactionFileFilter> file_filter;
+  if (cfd->ioptions()->compaction_file_filter_factory) {
+    file_filter = cfd->ioptions()->compaction_file_filter_factory->CreateCompactionFileFilter();
+  }
   for (size_t which = 0; which < c->num_input_levels(); which++) {
     if (c->input_levels(which)->num_files != 0) {
       if (c->level(which) == 0) {
         const LevelFilesBrief* flevel = c->input_levels(which);
         for (size_t i = 0; i < flevel->num_files; i++) {
+          if (file_filter && file_filter->ShouldDrop(*c->input(which, i))) {
+            RLOG(InfoLogLevel::INFO_LEVEL, db_options_->info_log,
+                 "[%s] Compaction drops expired file %" PRIu64 " without reading it",
+                 cfd->GetName().c_str(), flevel->files[i].fd.GetNumber());
+            continue;
+          }
           list[num++] = cfd->table_cache()->NewIterator(
               read_options, env_options_compactions_,
               cfd->internal_comparator(), flevel->files[i].fd, nullptr,
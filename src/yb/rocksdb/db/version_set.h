@@ -464,6 +464,12 @@ class Version {
            bool* value_found = nullptr, bool* key_exists = nullptr,
            SequenceNumber* seq = nullptr);
 
+  // Loads to the block cache data blocks of this version's files that lookups of user_keys are
+  // going to read, see DB::PrefetchKeys.
+  //
+  // REQUIRES: lock is not held
+  Status PrefetchKeys(const ReadOptions& read_options, std::vector<Slice> user_keys);
+
   // Loads some stats information from files. Call without mutex held. It needs
   // to be called before applying the version to the version set.
   void PrepareApply(const MutableCFOptions& mutable_cf_options,
@@ -503,6 +509,10 @@ class Version {
   Status GetPropertiesOfTablesInRange(const Range* range, std::size_t n,
                                       TablePropertiesCollection* props) const;
 
+  // Loads top-level index and filter blocks of all files in this version to the block cache, see
+  // DB::WarmUpBlockCache.
+  Status WarmUpBlockCache(RateLimiter* rate_limiter, const std::function<bool()>& should_stop);
+
   // REQUIRES: lock is held
   // On success, "tp" will contains the aggregated table property amoug
   // the table properties of all sst files in this version.
@@ -19,6 +19,36 @@
 //
 #pragma once
 
+#include <string>
+
+#include "yb/rocksdb/options.h"
+
 namespace rocksdb {
-int db_bench_tool(int argc, char** argv);
+
+// Lets a database built on top of RocksDB run the benchmarks with its own key and value encoding
+// and options, while RocksDB does not depend on it. Keys are made of a prefix identifying the key
+// and a suffix identifying the version, so one key can have multiple versions. Point reads and
+// seeks look for the first key starting with the prefix. The methods are called concurrently by
+// the benchmark threads.
+class DbBenchFormat {
+ public:
+  virtual ~DbBenchFormat() {}
+
+  // Called after options were initialized from the db_bench flags, before the DB is opened.
+  virtual void CustomizeOptions(Options* options) = 0;
+
+  // Appends the prefix shared by all versions of the key_index-th key to out.
+  virtual void AppendKeyPrefix(uint64_t key_index, std::string* out) = 0;
+
+  // Appends the suffix of a new version to out, it should sort before older versions.
+  virtual void AppendNewVersion(std::string* out) = 0;
+
+  // Appends the encoded value to out.
+  virtual void AppendValue(const Slice& value, std::string* out) = 0;
+};
+
+// When format is specified only fill, readrandom, seekrandom, compact and stats benchmarks are
+// supported.
+int db_bench_tool(int argc, char** argv, DbBenchFormat* format = nullptr);
+
 }  // namespace rocksdb
@@ -105,6 +105,12 @@ struct EnvOptions {
   // If true, then use mmap to write data
   bool use_mmap_writes = true;
 
+  // If true, then use O_DIRECT for reading data
+  bool use_direct_reads = false;
+
+  // If true, then use O_DIRECT for writing data
+  bool use_direct_writes = false;
+
   // If false, fallocate() calls are bypassed
   bool allow_fallocate = true;
 
@@ -287,9 +293,15 @@ class Env {
 
   // Priority for requesting bytes in rate limiter scheduler
   enum IOPriority {
-    IO_LOW = 0,
-    IO_HIGH = 1,
-    IO_TOTAL = 2
+    // Bulk data transfers, e.g. remote bootstrap.
+    IO_BACKGROUND = 0,
+    // Large compactions.
+    IO_LOW = 1,
+    // Small compactions.
+    IO_MID = 2,
+    // Flushes.
+    IO_HIGH = 3,
+    IO_TOTAL = 4
   };
 
   // Arrange to run "(*function)(arg)" once in a background thread, in
@@ -387,6 +399,16 @@ class Env {
   // files. Default implementation returns the copy of the same object.
   virtual EnvOptions OptimizeForManifestWrite(const EnvOptions& env_options)
       const;
+  // OptimizeForCompactionTableWrite will create a new EnvOptions object that is
+  // a copy of the EnvOptions in the parameters, but is optimized for writing
+  // table files by flushes and compactions.
+  virtual EnvOptions OptimizeForCompactionTableWrite(
+      const EnvOptions& env_options, const DBOptions& db_options) const;
+  // OptimizeForCompactionTableRead will create a new EnvOptions object that is
+  // a copy of the EnvOptions in the parameters, but is optimized for reading
+  // table files by compactions.
+  virtual EnvOptions OptimizeForCompactionTableRead(
+      const EnvOptions& env_options, const DBOptions& db_options) const;
 
   // Returns the status of all threads that belong to the current Env.
   virtual Status GetThreadList(std::vector<ThreadStatus>* thread_list) {
@@ -452,6 +474,18 @@ class SequentialFile {
   }
 };
 
+// A single read of RandomAccessFile::MultiRead.
+struct ReadRequest {
+  // Input: range of the file to read and buffer of at least len bytes.
+  uint64_t offset = 0;
+  size_t len = 0;
+  char* scratch = nullptr;
+
+  // Output: same as result and returned status of RandomAccessFile::Read.
+  Slice result;
+  Status status;
+};
+
 // A file abstraction for randomly reading the contents of a file.
 class RandomAccessFile : public File {
  public:
@@ -470,6 +504,17 @@ class RandomAccessFile : public File {
   virtual Status Read(uint64_t offset, size_t n, Slice* result,
                       char* scratch) const = 0;
 
+  // Performs all num_reqs reads, storing the outcome of each one in the request. Unlike a sequence
+  // of Read calls, implementations could submit all reads to the device at once, so they don't
+  // wait for each other.
+  //
+  // Safe for concurrent use by multiple threads.
+  virtual void MultiRead(ReadRequest* reqs, size_t num_reqs) const {
+    for (size_t i = 0; i != num_reqs; ++i) {
+      reqs[i].status = Read(reqs[i].offset, reqs[i].len, &reqs[i].result, reqs[i].scratch);
+    }
+  }
+
   // Used by the file_reader_writer to decide if the ReadAhead wrapper
   // should simply forward the call and do not enact buffering or locking.
   virtual bool ShouldForwardRawRequest() const {
@@ -490,6 +535,14 @@ class RandomAccessFile : public File {
 
   virtual void Hint(AccessPattern pattern) {}
 
+  // Asks the platform to start loading [offset, offset + n) into its cache
+  // without waiting for the data. Subsequent reads of this range are expected
+  // to be served without blocking on the device.
+  // If the platform has no such facility, then this is a noop.
+  virtual Status Prefetch(uint64_t offset, size_t n) {
+    return Status::OK();
+  }
+
   // Remove any kind of caching of data from the offset to offset+length
   // of this file. If the length is 0, then it refers to the end of file.
   // If the system is not caching the file contents, then this is a noop.
@@ -148,6 +148,10 @@ class FilterPolicy {
 
     // Transform a key.
     virtual Slice Transform(Slice key) const = 0;
+
+    // Returns false if the transformed key could differ from the transformed keys of the records
+    // that a read bounded by this key is looking for. Filters are not checked for such keys.
+    virtual bool InDomain(Slice key) const { return true; }
   };
 
   // Filter policy can optionally return key transformer to be used before writing key to filter or
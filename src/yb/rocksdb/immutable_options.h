@@ -59,6 +59,8 @@ struct ImmutableCFOptions {
 
   CompactionFilterFactory* compaction_filter_factory;
 
+  CompactionFileFilterFactory* compaction_file_filter_factory;
+
   bool inplace_update_support;
 
   UpdateStatus (*inplace_callback)(char* existing_value,
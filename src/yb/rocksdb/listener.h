@@ -74,6 +74,8 @@ enum class CompactionReason {
   kManualCompaction,
   // DB::SuggestCompactRange() marked files for compaction
   kFilesMarkedForCompaction,
+  // [Universal] compaction_file_filter_factory selected files for deletion
+  kUniversalExpiredFiles,
 };
 
 #ifndef ROCKSDB_LITE
@@ -112,6 +114,8 @@ struct FlushJobInfo {
   SequenceNumber smallest_seqno;
   // The largest sequence number in the newly created file
   SequenceNumber largest_seqno;
+  // Total size of the newly created file, including its data file for split SST.
+  uint64_t file_size = 0;
   // Table properties of the table being flushed
   TableProperties table_properties;
 };
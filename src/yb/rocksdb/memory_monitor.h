@@ -34,7 +34,10 @@ class MemoryMonitor {
     return memory_used_.load(std::memory_order_relaxed);
   }
 
-  size_t limit() const { return limit_; }
+  size_t limit() const { return limit_.load(std::memory_order_relaxed); }
+
+  // Changes the limit, the callback is notified on the next reservation if it is exceeded then.
+  void set_limit(size_t limit) { limit_.store(limit, std::memory_order_relaxed); }
 
   bool Exceeded() const {
     return Exceeded(memory_usage());
@@ -61,7 +64,7 @@ class MemoryMonitor {
     return limit() > 0 && size >= limit();
   }
 
-  const size_t limit_;
+  std::atomic<size_t> limit_;
   const std::function<void()> exceeded_callback_;
   std::atomic<size_t> memory_used_ {0};
 
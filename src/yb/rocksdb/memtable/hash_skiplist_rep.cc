@@ -40,7 +40,7 @@ class HashSkipListRep : public MemTableRep {
   HashSkipListRep(const MemTableRep::KeyComparator& compare,
                   MemTableAllocator* allocator, const SliceTransform* transform,
                   size_t bucket_size, int32_t skiplist_height,
-                  int32_t skiplist_branching_factor);
+                  int32_t skiplist_branching_factor, bool total_order_index);
 
   void Insert(KeyHandle handle) override;
 
@@ -79,6 +79,11 @@ class HashSkipListRep : public MemTableRep {
   // immutable after construction
   MemTableAllocator* const allocator_;
 
+  // When not null, contains every key of the memtable in order, sharing the key data with the
+  // buckets. Total order iterators then walk it directly instead of merging all the buckets into
+  // a temporary skiplist.
+  Bucket* total_order_list_ = nullptr;
+
   inline size_t GetHash(const Slice& slice) const {
     return MurmurHash(slice.data(), static_cast<int>(slice.size()), 0) %
            bucket_size_;
@@ -239,7 +244,8 @@ HashSkipListRep::HashSkipListRep(const MemTableRep::KeyComparator& compare,
                                  MemTableAllocator* allocator,
                                  const SliceTransform* transform,
                                  size_t bucket_size, int32_t skiplist_height,
-                                 int32_t skiplist_branching_factor)
+                                 int32_t skiplist_branching_factor,
+                                 bool total_order_index)
     : MemTableRep(allocator),
       bucket_size_(bucket_size),
       skiplist_height_(skiplist_height),
@@ -254,6 +260,12 @@ HashSkipListRep::HashSkipListRep(const MemTableRep::KeyComparator& compare,
   for (size_t i = 0; i < bucket_size_; ++i) {
     buckets_[i].store(nullptr, std::memory_order_relaxed);
   }
+
+  if (total_order_index) {
+    auto addr = allocator_->AllocateAligned(sizeof(Bucket));
+    total_order_list_ = new (addr) Bucket(compare_, allocator_, skiplist_height_,
+                                          skiplist_branching_factor_);
+  }
 }
 
 HashSkipListRep::~HashSkipListRep() {
@@ -278,6 +290,9 @@ void HashSkipListRep::Insert(KeyHandle handle) {
   auto transformed = transform_->Transform(UserKey(key));
   auto bucket = GetInitializedBucket(transformed);
   bucket->Insert(key);
+  if (total_order_list_ != nullptr) {
+    total_order_list_->Insert(key);
+  }
 }
 
 bool HashSkipListRep::Contains(const char* key) const {
@@ -307,6 +322,14 @@ void HashSkipListRep::Get(const LookupKey& k, void* callback_args,
 }
 
 MemTableRep::Iterator* HashSkipListRep::GetIterator(Arena* arena) {
+  if (total_order_list_ != nullptr) {
+    if (arena == nullptr) {
+      return new Iterator(total_order_list_, false /* own_list */);
+    } else {
+      auto mem = arena->AllocateAligned(sizeof(Iterator));
+      return new (mem) Iterator(total_order_list_, false /* own_list */);
+    }
+  }
   // allocate a new arena of similar size to the one currently in use
   Arena* new_arena = new Arena(allocator_->BlockSize());
   auto list = new Bucket(compare_, new_arena);
@@ -341,8 +364,9 @@ MemTableRep::Iterator* HashSkipListRep::GetDynamicPrefixIterator(Arena* arena) {
 MemTableRep* HashSkipListRepFactory::CreateMemTableRep(
     const MemTableRep::KeyComparator& compare, MemTableAllocator* allocator,
     const SliceTransform* transform, Logger* logger) {
-  return new HashSkipListRep(compare, allocator, transform, bucket_count_,
-                             skiplist_height_, skiplist_branching_factor_);
+  return new HashSkipListRep(compare, allocator, transform_ ? transform_.get() : transform,
+                             bucket_count_, skiplist_height_, skiplist_branching_factor_,
+                             total_order_index_);
 }
 
 MemTableRepFactory* NewHashSkipListRepFactory(
@@ -352,5 +376,12 @@ MemTableRepFactory* NewHashSkipListRepFactory(
       skiplist_branching_factor);
 }
 
+MemTableRepFactory* NewHashIndexedSkipListRepFactory(
+    std::shared_ptr<const SliceTransform> transform, size_t bucket_count,
+    int32_t skiplist_height, int32_t skiplist_branching_factor) {
+  return new HashSkipListRepFactory(bucket_count, skiplist_height,
+      skiplist_branching_factor, std::move(transform), true /* total_order_index */);
+}
+
 } // namespace rocksdb
 #endif  // ROCKSDB_LITE
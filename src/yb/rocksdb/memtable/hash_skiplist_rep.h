@@ -23,6 +23,8 @@
 
 #pragma once
 #ifndef ROCKSDB_LITE
+#include <memory>
+
 #include "yb/rocksdb/slice_transform.h"
 #include "yb/rocksdb/memtablerep.h"
 
@@ -33,10 +35,14 @@ class HashSkipListRepFactory : public MemTableRepFactory {
   explicit HashSkipListRepFactory(
     size_t bucket_count,
     int32_t skiplist_height,
-    int32_t skiplist_branching_factor)
+    int32_t skiplist_branching_factor,
+    std::shared_ptr<const SliceTransform> transform = nullptr,
+    bool total_order_index = false)
       : bucket_count_(bucket_count),
         skiplist_height_(skiplist_height),
-        skiplist_branching_factor_(skiplist_branching_factor) { }
+        skiplist_branching_factor_(skiplist_branching_factor),
+        transform_(std::move(transform)),
+        total_order_index_(total_order_index) { }
 
   virtual ~HashSkipListRepFactory() {}
 
@@ -45,13 +51,17 @@ class HashSkipListRepFactory : public MemTableRepFactory {
       const SliceTransform* transform, Logger* logger) override;
 
   virtual const char* Name() const override {
-    return "HashSkipListRepFactory";
+    return total_order_index_ ? "HashIndexedSkipListRepFactory" : "HashSkipListRepFactory";
   }
 
  private:
   const size_t bucket_count_;
   const int32_t skiplist_height_;
   const int32_t skiplist_branching_factor_;
+  // Overrides the prefix extractor passed to CreateMemTableRep when set.
+  const std::shared_ptr<const SliceTransform> transform_;
+  // Link every key into an additional skiplist holding all keys in order.
+  const bool total_order_index_;
 };
 
 }
@@ -287,6 +287,16 @@ extern MemTableRepFactory* NewHashSkipListRepFactory(
     int32_t skiplist_branching_factor = 4
 );
 
+// Same layout as NewHashSkipListRepFactory, but keys are bucketed by the given transform instead
+// of the column family prefix extractor, and every key is also linked into one ordered skiplist.
+// Point lookups only search the bucket of the key's prefix, while total order iterators (used
+// whenever prefix_extractor is not set) walk the ordered skiplist without merging the buckets.
+// transform: must map all keys that a Get could match to the same prefix
+extern MemTableRepFactory* NewHashIndexedSkipListRepFactory(
+    std::shared_ptr<const SliceTransform> transform,
+    size_t bucket_count = 1000000, int32_t skiplist_height = 4,
+    int32_t skiplist_branching_factor = 4);
+
 // The factory is to create memtables based on a hash table:
 // it contains a fixed array of buckets, each pointing to either a linked list
 // or a skip list if number of entries inside the bucket exceeds
@@ -54,6 +54,7 @@ class BoundaryValuesExtractor;
 class Cache;
 class CompactionFilter;
 class CompactionFilterFactory;
+class CompactionFileFilterFactory;
 class Comparator;
 class Env;
 enum InfoLogLevel : unsigned char;
@@ -67,6 +68,7 @@ class TableFactory;
 class MemTableRepFactory;
 class TablePropertiesCollectorFactory;
 class RateLimiter;
+class UserFrontier;
 class SliceTransform;
 class Statistics;
 class InternalKeyComparator;
@@ -88,7 +90,9 @@ enum CompressionType : char {
   kBZip2Compression = 0x3,
   kLZ4Compression = 0x4,
   kLZ4HCCompression = 0x5,
-  // zstd format is not finalized yet so it's subject to changes.
+  kZSTD = 0x7,
+  // Kept for files written before ZSTD support was finalized, new files should use kZSTD. Both
+  // use the same on-disk block format.
   kZSTDNotFinalCompression = 0x40,
 };
 
@@ -163,9 +167,19 @@ struct CompressionOptions {
   int window_bits;
   int level;
   int strategy;
-  CompressionOptions() : window_bits(-14), level(-1), strategy(0) {}
-  CompressionOptions(int wbits, int _lev, int _strategy)
-      : window_bits(wbits), level(_lev), strategy(_strategy) {}
+  // Maximum size of the dictionary used to prime ZSTD compression of data blocks. The dictionary
+  // is trained per SST file from its first data blocks and stored in a meta block of that file.
+  // 0 disables dictionary compression.
+  uint32_t max_dict_bytes;
+  // Amount of raw data block contents sampled for dictionary training. Data blocks written before
+  // enough samples are collected are compressed without dictionary. 0 means 100 * max_dict_bytes.
+  uint32_t zstd_max_train_bytes;
+  CompressionOptions()
+      : window_bits(-14), level(-1), strategy(0), max_dict_bytes(0), zstd_max_train_bytes(0) {}
+  CompressionOptions(int wbits, int _lev, int _strategy, uint32_t _max_dict_bytes = 0,
+                     uint32_t _zstd_max_train_bytes = 0)
+      : window_bits(wbits), level(_lev), strategy(_strategy), max_dict_bytes(_max_dict_bytes),
+        zstd_max_train_bytes(_zstd_max_train_bytes) {}
 };
 
 enum UpdateStatus {    // Return status For inplace update callback
@@ -265,6 +279,12 @@ struct ColumnFamilyOptions {
   // Default: nullptr
   std::shared_ptr<CompactionFilterFactory> compaction_filter_factory;
 
+  // A factory of filters which select input SST files that compactions delete without reading
+  // them. Universal compaction also picks such files into deletion-only compactions.
+  //
+  // Default: nullptr
+  std::shared_ptr<CompactionFileFilterFactory> compaction_file_filter_factory;
+
   // -------------------
   // Parameters that affect performance
 
@@ -759,6 +779,14 @@ struct ColumnFamilyOptions {
   // Dynamically changeable through SetOptions() API
   size_t memtable_prefix_bloom_huge_page_tlb_size;
 
+  // Page size for huge page backed memtable arena blocks. If <= 0, arena blocks are allocated from
+  // the heap. Otherwise blocks are rounded up to a multiple of this size and mapped from explicitly
+  // reserved huge pages if available, or from transparent huge pages otherwise, falling back to the
+  // heap if neither can be had. Should be the huge page size of the system (2MB on x86_64).
+  //
+  // Dynamically changeable through SetOptions() API
+  size_t memtable_huge_page_size;
+
   // Control locality of bloom filter probes to improve cache miss rate.
   // This option only applies to memtable prefix bloom and plaintable
   // prefix bloom. It essentially limits every bloom checking to one cache line.
@@ -823,6 +851,11 @@ struct ColumnFamilyOptions {
 
 typedef std::function<yb::Result<bool>(const MemTable&)> MemTableFilter;
 
+// Returns index in db_paths for output files of a compaction. Arguments are the largest user
+// frontier of compaction inputs (could be null) and the path picked by the compaction picker.
+typedef std::function<uint32_t(const UserFrontier* largest, uint32_t picked_path_id)>
+    CompactionOutputPathSelector;
+
 struct DBOptions {
   // Some functions that make it easier to optimize RocksDB
 
@@ -1082,6 +1115,17 @@ struct DBOptions {
   // Default: true
   bool allow_os_buffer;
 
+  // Use O_DIRECT for user reads of sst files, bypassing the OS page cache.
+  // Default: false
+  bool use_direct_reads;
+
+  // Use O_DIRECT for writing sst files during flushes and compactions and for
+  // reading compaction inputs, so background jobs do not evict pages that
+  // foreground reads rely on. Compaction inputs are read with
+  // compaction_readahead_size sized aligned requests (2MB if not set).
+  // Default: false
+  bool use_direct_io_for_flush_and_compaction;
+
   // Allow the OS to mmap file for reading sst tables. Default: false
   bool allow_mmap_reads;
 
@@ -1322,6 +1366,11 @@ struct DBOptions {
   // Invoked after memtable switched.
   std::shared_ptr<std::function<MemTableFilter()>> mem_table_flush_filter_factory;
 
+  // If set, selects which of db_paths the output files of a compaction are placed into, based on
+  // the frontiers of compaction inputs. This allows to keep files with old data on cheaper storage.
+  // Indexes outside of db_paths are ignored in favor of the picked path.
+  std::shared_ptr<CompactionOutputPathSelector> compaction_output_path_selector;
+
   // A prefix for log messages, usually containing the tablet id.
   std::string log_prefix;
 
@@ -1378,6 +1427,16 @@ class ReadFileFilter {
   virtual ~ReadFileFilter() {}
 };
 
+struct DataBlockBoundaries;
+class ReadBlockFilter {
+ public:
+  // Returns false if none of the keys of the data block with the given boundaries is needed.
+  virtual bool Filter(const DataBlockBoundaries&) const = 0;
+
+ protected:
+  virtual ~ReadBlockFilter() {}
+};
+
 class TableReader;
 class TableAwareReadFileFilter {
  public:
@@ -1483,6 +1542,12 @@ struct ReadOptions {
   // Default: false
   bool pin_data;
 
+  // Let iterators detect sequential reads of data blocks and prefetch upcoming blocks of the same
+  // SST file into a per-iterator buffer. The readahead window grows while the scan continues.
+  // Useful for long scans on devices with high latency of a single read.
+  // Default: false
+  bool adaptive_readahead;
+
   // Query id designated for the read.
   QueryId query_id = kDefaultQueryId;
 
@@ -1492,6 +1557,12 @@ struct ReadOptions {
 
   std::shared_ptr<ReadFileFilter> file_filter;
 
+  // Filter for skipping data blocks of SST files written with
+  // BlockBasedTableOptions::store_data_block_boundaries. Iterators see rejected data blocks as
+  // empty, so it should only reject blocks without keys the reader could need. Blocks without
+  // stored boundaries are always read.
+  std::shared_ptr<ReadBlockFilter> block_filter;
+
   static const ReadOptions kDefault;
 
   ReadOptions();
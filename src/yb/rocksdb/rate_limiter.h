@@ -23,10 +23,14 @@
 
 #pragma once
 
+#include <memory>
+
 #include "yb/rocksdb/env.h"
 
 namespace rocksdb {
 
+class Statistics;
+
 class RateLimiter {
  public:
   virtual ~RateLimiter() {}
@@ -50,6 +54,20 @@ class RateLimiter {
   // Total # of requests that go though rate limiter
   virtual int64_t GetTotalRequests(
       const Env::IOPriority pri = Env::IO_TOTAL) const = 0;
+
+  // Total time in microseconds requests spent waiting for tokens
+  virtual int64_t GetTotalWaitMicros(
+      const Env::IOPriority pri = Env::IO_TOTAL) const = 0;
+
+  // Creates a tenant of this rate limiter: a rate limiter that draws tokens from this one, but
+  // queues its requests separately. Pending requests of the same priority from different tenants
+  // are granted in proportion to tenant weights, so one busy tenant (e.g. one DB) cannot starve
+  // the others. Statistics of the tenant are reported through GetTotal* and, when statistics is
+  // not null, wait time is also recorded to RATE_LIMITER_*_WAIT_MICROS tickers.
+  // The tenant must be destroyed before this rate limiter.
+  // REQUIRED: weight > 0
+  virtual std::shared_ptr<RateLimiter> NewTenant(
+      int weight, std::shared_ptr<Statistics> statistics = nullptr) = 0;
 };
 
 // Create a RateLimiter object, which can be shared among RocksDB instances to
@@ -63,12 +81,13 @@ class RateLimiter {
 // 100ms, then 1MB is refilled every 100ms internally. Larger value can lead to
 // burstier writes while smaller value introduces more CPU overhead.
 // The default should work for most cases.
-// @fairness: RateLimiter accepts high-pri requests and low-pri requests.
-// A low-pri request is usually blocked in favor of hi-pri request. Currently,
-// RocksDB assigns low-pri to request from compaciton and high-pri to request
-// from flush. Low-pri requests can get blocked if flush requests come in
-// continuouly. This fairness parameter grants low-pri requests permission by
-// 1/fairness chance even though high-pri requests exist to avoid starvation.
+// @fairness: RateLimiter accepts requests of several priorities (see
+// Env::IOPriority). A request is usually blocked in favor of requests of higher
+// priority. Currently, RocksDB assigns high-pri to requests from flush, mid-pri
+// to small compactions and low-pri to large compactions. Lower priority requests
+// can get blocked if higher priority requests come in continuously. This
+// fairness parameter serves priorities from the lowest one by 1/fairness chance
+// even though higher priority requests exist to avoid starvation.
 // You should be good by leaving it at default 10.
 extern RateLimiter* NewGenericRateLimiter(
     int64_t rate_bytes_per_sec,
@@ -24,6 +24,7 @@
 #include <string>
 #include "yb/rocksdb/env.h"
 #include "yb/rocksdb/immutable_options.h"
+#include "yb/rocksdb/metadata.h"
 #include "yb/rocksdb/types.h"
 
 namespace rocksdb {
@@ -65,6 +66,9 @@ struct ExternalSstFileInfo {
   bool is_split_sst;               // is SST split into metadata and data file(s)
   uint64_t num_entries;            // number of entries in file
   int32_t version;                 // file version
+  // If set, used as both boundary frontiers of the added file and applied to the flushed frontier
+  // of the DB in the same version edit that adds the file.
+  UserFrontierPtr frontier;
 };
 
 // SstFileWriter is used to create sst files that can be added to database later
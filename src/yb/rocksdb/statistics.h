@@ -90,6 +90,8 @@ enum Tickers : uint32_t {
   COMPACTION_KEY_DROP_NEWER_ENTRY,  // key was written with a newer value.
   COMPACTION_KEY_DROP_OBSOLETE,     // The key is obsolete.
   COMPACTION_KEY_DROP_USER,  // user compaction function has dropped the key.
+  // Raw key and value bytes of keys dropped by the user compaction function.
+  COMPACTION_KEY_DROP_USER_BYTES,
 
   // Number of keys written to the database via the Put and Write call's
   NUMBER_KEYS_WRITTEN,
@@ -206,6 +208,31 @@ enum Tickers : uint32_t {
   BLOCK_CACHE_MULTI_TOUCH_BYTES_READ,
   BLOCK_CACHE_MULTI_TOUCH_BYTES_WRITE,
 
+  // High priority pool statistics.
+  BLOCK_CACHE_HIGH_PRI_HIT,
+  BLOCK_CACHE_HIGH_PRI_ADD,
+  BLOCK_CACHE_HIGH_PRI_BYTES_READ,
+  BLOCK_CACHE_HIGH_PRI_BYTES_WRITE,
+
+  // Adaptive readahead of sequential iterators.
+  // Number of block reads served from prefetched data.
+  READAHEAD_PREFETCH_HIT,
+  // Number of bytes read from files to prefetch buffers.
+  READAHEAD_BYTES_READ,
+  // Number of prefetched bytes discarded without being read.
+  READAHEAD_WASTED_BYTES,
+
+  // Time in microseconds spent waiting for the rate limiter, per I/O priority.
+  RATE_LIMITER_FLUSH_WAIT_MICROS,
+  RATE_LIMITER_SMALL_COMPACTION_WAIT_MICROS,
+  RATE_LIMITER_LARGE_COMPACTION_WAIT_MICROS,
+  RATE_LIMITER_BACKGROUND_WAIT_MICROS,
+
+  // Number of data blocks checked against ReadOptions::block_filter.
+  DATA_BLOCK_FILTER_CHECKED,
+  // Number of data blocks skipped because ReadOptions::block_filter rejected them.
+  DATA_BLOCK_FILTER_USEFUL,
+
   // End of ticker enum.
   TICKER_ENUM_MAX,
 };
@@ -235,6 +262,7 @@ const std::vector<std::pair<Tickers, std::string>> TickersNameMap = {
     {COMPACTION_KEY_DROP_NEWER_ENTRY, "rocksdb_compaction_key_drop_new"},
     {COMPACTION_KEY_DROP_OBSOLETE, "rocksdb_compaction_key_drop_obsolete"},
     {COMPACTION_KEY_DROP_USER, "rocksdb_compaction_key_drop_user"},
+    {COMPACTION_KEY_DROP_USER_BYTES, "rocksdb_compaction_key_drop_user_bytes"},
     {NUMBER_KEYS_WRITTEN, "rocksdb_number_keys_written"},
     {NUMBER_KEYS_READ, "rocksdb_number_keys_read"},
     {NUMBER_KEYS_UPDATED, "rocksdb_number_keys_updated"},
@@ -300,7 +328,22 @@ const std::vector<std::pair<Tickers, std::string>> TickersNameMap = {
     {BLOCK_CACHE_MULTI_TOUCH_HIT, "rocksdb_block_cache_multi_touch_hit"},
     {BLOCK_CACHE_MULTI_TOUCH_ADD, "rocksdb_block_cache_multi_touch_add"},
     {BLOCK_CACHE_MULTI_TOUCH_BYTES_READ, "rocksdb_block_cache_multi_touch_bytes_read"},
-    {BLOCK_CACHE_MULTI_TOUCH_BYTES_WRITE, "rocksdb_block_cache_multi_touch_bytes_write"}
+    {BLOCK_CACHE_MULTI_TOUCH_BYTES_WRITE, "rocksdb_block_cache_multi_touch_bytes_write"},
+    {BLOCK_CACHE_HIGH_PRI_HIT, "rocksdb_block_cache_high_pri_hit"},
+    {BLOCK_CACHE_HIGH_PRI_ADD, "rocksdb_block_cache_high_pri_add"},
+    {BLOCK_CACHE_HIGH_PRI_BYTES_READ, "rocksdb_block_cache_high_pri_bytes_read"},
+    {BLOCK_CACHE_HIGH_PRI_BYTES_WRITE, "rocksdb_block_cache_high_pri_bytes_write"},
+    {READAHEAD_PREFETCH_HIT, "rocksdb_readahead_prefetch_hit"},
+    {READAHEAD_BYTES_READ, "rocksdb_readahead_bytes_read"},
+    {READAHEAD_WASTED_BYTES, "rocksdb_readahead_wasted_bytes"},
+    {RATE_LIMITER_FLUSH_WAIT_MICROS, "rocksdb_rate_limiter_flush_wait_micros"},
+    {RATE_LIMITER_SMALL_COMPACTION_WAIT_MICROS,
+        "rocksdb_rate_limiter_small_compaction_wait_micros"},
+    {RATE_LIMITER_LARGE_COMPACTION_WAIT_MICROS,
+        "rocksdb_rate_limiter_large_compaction_wait_micros"},
+    {RATE_LIMITER_BACKGROUND_WAIT_MICROS, "rocksdb_rate_limiter_background_wait_micros"},
+    {DATA_BLOCK_FILTER_CHECKED, "rocksdb_data_block_filter_checked"},
+    {DATA_BLOCK_FILTER_USEFUL, "rocksdb_data_block_filter_useful"}
 };
 
 /**
@@ -340,6 +383,8 @@ enum Histograms : uint32_t {
   BYTES_PER_READ,
   BYTES_PER_WRITE,
   BYTES_PER_MULTIGET,
+  // Time spent by a single subcompaction
+  SUBCOMPACTION_TIME,
   HISTOGRAM_ENUM_MAX,  // TODO(ldemailly): enforce HistogramsNameMap match
 };
 
@@ -370,6 +415,7 @@ const std::vector<std::pair<Histograms, std::string>> HistogramsNameMap = {
     {BYTES_PER_READ, "rocksdb_bytes_per_read"},
     {BYTES_PER_WRITE, "rocksdb_bytes_per_write"},
     {BYTES_PER_MULTIGET, "rocksdb_bytes_per_multiget"},
+    {SUBCOMPACTION_TIME, "rocksdb_subcompaction_times_micros"},
 };
 
 struct HistogramData {
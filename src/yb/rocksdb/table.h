@@ -79,6 +79,19 @@ YB_DEFINE_ENUM(IndexType,
   (kMultiLevelBinarySearch)
 );
 
+YB_DEFINE_ENUM(KeyValueEncodingFormat,
+  // Each key is stored as the number of bytes shared with the previous key followed by the rest of
+  // the key.
+  (kKeyDeltaEncodingSharedPrefix)
+
+  // Each key is stored as a prefix shared with the previous key, a non-shared part, a shared
+  // middle part at the same offset as in the previous key, a second non-shared part and the
+  // 8-byte internal key suffix delta-encoded against the previous one. Tuned for DocDB keys,
+  // where subsequent keys usually differ in a subkey and in the write id of the hybrid time, while
+  // the rest of the hybrid time is the same. Data blocks only.
+  (kKeyDeltaEncodingThreeSharedParts)
+);
+
 // For advanced user only
 struct BlockBasedTableOptions {
   // @flush_block_policy_factory creates the instances of flush block policy.
@@ -163,6 +176,26 @@ struct BlockBasedTableOptions {
   // Default: true
   bool use_delta_encoding = true;
 
+  // Key encoding used for data blocks, has effect only when use_delta_encoding is true.
+  // Tables written with kKeyDeltaEncodingThreeSharedParts can't be read by older versions, the
+  // format is recorded in table properties, so readers pick it up per file.
+  KeyValueEncodingFormat data_block_key_value_encoding_format =
+      KeyValueEncodingFormat::kKeyDeltaEncodingSharedPrefix;
+
+  // If set, each data block gets a hash index of the prefixes of its user keys extracted by it,
+  // that seeks use instead of binary searching the restart points of the block, see
+  // DataBlockHashIndex. All keys between two keys with the same prefix should have that prefix,
+  // e.g. the prefix is the key without a version at its end. Tables written with the index can't
+  // be read by older versions. The name of the extractor is recorded in table properties, and
+  // readers only use the index when their extractor has the same name.
+  std::shared_ptr<const SliceTransform> data_block_hash_index_key_extractor;
+
+  // Store the smallest and largest user values of the keys of each data block, as extracted by the
+  // boundary_extractor of the DB, in a meta block of the table, see DataBlockBoundaries.
+  // Iterators with ReadOptions::block_filter skip data blocks rejected by it without reading them.
+  // Older versions ignore the meta block.
+  bool store_data_block_boundaries = false;
+
   // If non-nullptr, use the specified filter policy to reduce disk reads.
   // Many applications will benefit from passing the result of
   // NewBloomFilterPolicy() here.
@@ -213,6 +246,10 @@ struct BlockBasedTablePropertyNames {
   static const char kWholeKeyFiltering[];
   // value is "1" for true and "0" for false.
   static const char kPrefixFiltering[];
+  // value of this property is a fixed int32 number, KeyValueEncodingFormat of data blocks.
+  static const char kDataBlockKeyValueEncodingFormat[];
+  // name of the data block hash index key extractor, only present when data blocks have the index.
+  static const char kDataBlockHashIndexKeyExtractor[];
 };
 
 // Create default block based table factory.
@@ -31,6 +31,7 @@
 #include <vector>
 
 #include "yb/rocksdb/comparator.h"
+#include "yb/rocksdb/slice_transform.h"
 #include "yb/rocksdb/table/format.h"
 #include "yb/rocksdb/table/block_hash_index.h"
 #include "yb/rocksdb/table/block_prefix_index.h"
@@ -70,6 +71,53 @@ static inline const char* DecodeEntry(const char* p, const char* limit,
   return p;
 }
 
+static inline int64_t ZigZagDecode64(uint64_t value) {
+  return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+}
+
+// Same as DecodeEntry, but for entries encoded using kKeyDeltaEncodingThreeSharedParts, see
+// block_builder.cc. Sets *full_entry when non_shared_1 contains the whole key, otherwise also
+// decodes the internal key suffix delta.
+static inline const char* DecodeThreeSharedPartsEntry(const char* p, const char* limit,
+                                                      uint32_t* shared_prefix,
+                                                      uint32_t* non_shared_1,
+                                                      uint32_t* shared_middle,
+                                                      uint32_t* non_shared_2,
+                                                      uint32_t* value_length,
+                                                      bool* full_entry,
+                                                      int64_t* suffix_delta) {
+  if (limit - p < 5) return nullptr;
+  const auto* u = reinterpret_cast<const unsigned char*>(p);
+  if ((u[0] | u[1] | u[2] | u[3] | u[4]) < 128) {
+    // Fast path: all five values are encoded in one byte each
+    *shared_prefix = u[0];
+    *non_shared_1 = u[1];
+    *shared_middle = u[2];
+    *non_shared_2 = u[3];
+    *value_length = u[4];
+    p += 5;
+  } else {
+    if ((p = GetVarint32Ptr(p, limit, shared_prefix)) == nullptr) return nullptr;
+    if ((p = GetVarint32Ptr(p, limit, non_shared_1)) == nullptr) return nullptr;
+    if ((p = GetVarint32Ptr(p, limit, shared_middle)) == nullptr) return nullptr;
+    if ((p = GetVarint32Ptr(p, limit, non_shared_2)) == nullptr) return nullptr;
+    if ((p = GetVarint32Ptr(p, limit, value_length)) == nullptr) return nullptr;
+  }
+
+  *full_entry = (*shared_prefix | *shared_middle | *non_shared_2) == 0;
+  if (!*full_entry) {
+    uint64_t encoded_delta;
+    if ((p = GetVarint64Ptr(p, limit, &encoded_delta)) == nullptr) return nullptr;
+    *suffix_delta = ZigZagDecode64(encoded_delta);
+  }
+
+  if (static_cast<uint64_t>(limit - p) <
+          static_cast<uint64_t>(*non_shared_1) + *non_shared_2 + *value_length) {
+    return nullptr;
+  }
+  return p;
+}
+
 void BlockIter::Next() {
   assert(Valid());
   ParseNextKey();
@@ -98,7 +146,10 @@ void BlockIter::Prev() {
 
 void BlockIter::Initialize(const Comparator* comparator, const char* data,
                            uint32_t restarts, uint32_t num_restarts, BlockHashIndex* hash_index,
-                           BlockPrefixIndex* prefix_index) {
+                           BlockPrefixIndex* prefix_index,
+                           KeyValueEncodingFormat key_value_encoding_format,
+                           const DataBlockHashIndex* data_block_hash_index,
+                           const SliceTransform* data_block_hash_index_key_extractor) {
   DCHECK(data_ == nullptr); // Ensure it is called only once
   DCHECK_GT(num_restarts, 0); // Ensure the param is valid
 
@@ -110,6 +161,9 @@ void BlockIter::Initialize(const Comparator* comparator, const char* data,
   restart_index_ = num_restarts_;
   hash_index_ = hash_index;
   prefix_index_ = prefix_index;
+  key_value_encoding_format_ = key_value_encoding_format;
+  data_block_hash_index_ = data_block_hash_index;
+  data_block_hash_index_key_extractor_ = data_block_hash_index_key_extractor;
 }
 
 
@@ -122,6 +176,8 @@ void BlockIter::Seek(const Slice& target) {
   bool ok = false;
   if (prefix_index_) {
     ok = PrefixSeek(target, &index);
+  } else if (data_block_hash_index_ && DataBlockHashSeek(target)) {
+    return;
   } else {
     ok = hash_index_ ? HashSeek(target, &index)
       : BinarySeek(target, 0, num_restarts_ - 1, &index);
@@ -177,6 +233,21 @@ bool BlockIter::ParseNextKey() {
     return false;
   }
 
+  if (key_value_encoding_format_ == KeyValueEncodingFormat::kKeyDeltaEncodingThreeSharedParts) {
+    uint32_t value_length;
+    p = ParseThreeSharedPartsEntry(p, limit, &value_length);
+    if (p == nullptr) {
+      CorruptionError();
+      return false;
+    }
+    value_ = Slice(p, value_length);
+    while (restart_index_ + 1 < num_restarts_ &&
+           GetRestartPoint(restart_index_ + 1) < current_) {
+      ++restart_index_;
+    }
+    return true;
+  }
+
   // Decode next entry
   uint32_t shared, non_shared, value_length;
   p = DecodeEntry(p, limit, &shared, &non_shared, &value_length);
@@ -201,6 +272,67 @@ bool BlockIter::ParseNextKey() {
   }
 }
 
+const char* BlockIter::ParseThreeSharedPartsEntry(
+    const char* p, const char* limit, uint32_t* value_length) {
+  uint32_t shared_prefix, non_shared_1, shared_middle, non_shared_2;
+  bool full_entry;
+  int64_t suffix_delta;
+  p = DecodeThreeSharedPartsEntry(
+      p, limit, &shared_prefix, &non_shared_1, &shared_middle, &non_shared_2, value_length,
+      &full_entry, &suffix_delta);
+  if (p == nullptr) {
+    return nullptr;
+  }
+  if (full_entry) {
+    key_.SetKey(Slice(p, non_shared_1), false /* copy */);
+    return p + non_shared_1;
+  }
+
+  const Slice prev_key = key_.GetKey();
+  if (prev_key.size() < kLastInternalComponentSize) {
+    return nullptr;
+  }
+  const size_t prev_user_key_size = prev_key.size() - kLastInternalComponentSize;
+  const size_t middle_start = shared_prefix + non_shared_1;
+  if (shared_prefix > prev_user_key_size || middle_start + shared_middle > prev_user_key_size) {
+    return nullptr;
+  }
+  key_buffer_.clear();
+  key_buffer_.append(prev_key.cdata(), shared_prefix);
+  key_buffer_.append(p, non_shared_1);
+  key_buffer_.append(prev_key.cdata() + middle_start, shared_middle);
+  key_buffer_.append(p + non_shared_1, non_shared_2);
+  PutFixed64(&key_buffer_, DecodeFixed64(prev_key.cend() - kLastInternalComponentSize) +
+                           static_cast<uint64_t>(suffix_delta));
+  key_.SetKey(key_buffer_);
+  return p + non_shared_1 + non_shared_2;
+}
+
+bool BlockIter::DecodeRestartKey(uint32_t offset, Slice* key) {
+  const char* limit = data_ + restarts_;
+  if (key_value_encoding_format_ == KeyValueEncodingFormat::kKeyDeltaEncodingThreeSharedParts) {
+    uint32_t shared_prefix, non_shared_1, shared_middle, non_shared_2, value_length;
+    bool full_entry;
+    int64_t suffix_delta;
+    const char* key_ptr = DecodeThreeSharedPartsEntry(
+        data_ + offset, limit, &shared_prefix, &non_shared_1, &shared_middle, &non_shared_2,
+        &value_length, &full_entry, &suffix_delta);
+    if (key_ptr == nullptr || !full_entry) {
+      return false;
+    }
+    *key = Slice(key_ptr, non_shared_1);
+    return true;
+  }
+
+  uint32_t shared, non_shared, value_length;
+  const char* key_ptr = DecodeEntry(data_ + offset, limit, &shared, &non_shared, &value_length);
+  if (key_ptr == nullptr || (shared != 0)) {
+    return false;
+  }
+  *key = Slice(key_ptr, non_shared);
+  return true;
+}
+
 // Binary search in restart array to find the first restart point
 // with a key >= target (TODO: this comment is inaccurate)
 bool BlockIter::BinarySeek(const Slice& target, uint32_t left, uint32_t right,
@@ -210,15 +342,11 @@ bool BlockIter::BinarySeek(const Slice& target, uint32_t left, uint32_t right,
   while (left < right) {
     uint32_t mid = (left + right + 1) / 2;
     uint32_t region_offset = GetRestartPoint(mid);
-    uint32_t shared, non_shared, value_length;
-    const char* key_ptr =
-        DecodeEntry(data_ + region_offset, data_ + restarts_, &shared,
-                    &non_shared, &value_length);
-    if (key_ptr == nullptr || (shared != 0)) {
+    Slice mid_key;
+    if (!DecodeRestartKey(region_offset, &mid_key)) {
       CorruptionError();
       return false;
     }
-    Slice mid_key(key_ptr, non_shared);
     int cmp = Compare(mid_key, target);
     if (cmp < 0) {
       // Key at "mid" is smaller than "target". Therefore all
@@ -241,14 +369,11 @@ bool BlockIter::BinarySeek(const Slice& target, uint32_t left, uint32_t right,
 // Return -1 if error.
 int BlockIter::CompareBlockKey(uint32_t block_index, const Slice& target) {
   uint32_t region_offset = GetRestartPoint(block_index);
-  uint32_t shared, non_shared, value_length;
-  const char* key_ptr = DecodeEntry(data_ + region_offset, data_ + restarts_,
-                                    &shared, &non_shared, &value_length);
-  if (key_ptr == nullptr || (shared != 0)) {
+  Slice block_key;
+  if (!DecodeRestartKey(region_offset, &block_key)) {
     CorruptionError();
     return 1;  // Return target is smaller
   }
-  Slice block_key(key_ptr, non_shared);
   return Compare(block_key, target);
 }
 
@@ -332,9 +457,41 @@ bool BlockIter::PrefixSeek(const Slice& target, uint32_t* index) {
   }
 }
 
+bool BlockIter::DataBlockHashSeek(const Slice& target) {
+  const Slice target_user_key = ExtractUserKey(target);
+  const auto* extractor = data_block_hash_index_key_extractor_;
+  if (!extractor->InDomain(target_user_key)) {
+    return false;
+  }
+  const Slice prefix = extractor->Transform(target_user_key);
+  const uint8_t restart_index = data_block_hash_index_->Lookup(prefix);
+  if (restart_index == DataBlockHashIndex::kNoEntry ||
+      restart_index == DataBlockHashIndex::kCollision || restart_index >= num_restarts_) {
+    return false;
+  }
+
+  // The restart interval contains the first key with the prefix of target, or the bucket belongs
+  // to another prefix when the prefix is not in the block. Since keys with the same prefix are
+  // contiguous, the keys before that first key are less than target, so the linear search gives
+  // the right result once a key with the prefix is met.
+  SeekToRestartPoint(restart_index);
+  bool prefix_found = false;
+  while (ParseNextKey()) {
+    const Slice key = key_.GetKey();
+    if (!prefix_found) {
+      const Slice user_key = ExtractUserKey(key);
+      prefix_found = extractor->InDomain(user_key) && extractor->Transform(user_key) == prefix;
+    }
+    if (Compare(key, target) >= 0) {
+      break;
+    }
+  }
+  return prefix_found || !status_.ok();
+}
+
 uint32_t Block::NumRestarts() const {
   assert(size_ >= 2*sizeof(uint32_t));
-  return DecodeFixed32(data_ + size_ - sizeof(uint32_t));
+  return DecodeFixed32(data_ + size_ - sizeof(uint32_t)) & ~kDataBlockHashIndexFlag;
 }
 
 Block::Block(BlockContents&& contents)
@@ -344,18 +501,25 @@ Block::Block(BlockContents&& contents)
   if (size_ < sizeof(uint32_t)) {
     size_ = 0;  // Error marker
   } else {
-    restart_offset_ =
-        static_cast<uint32_t>(size_) - (1 + NumRestarts()) * sizeof(uint32_t);
-    if (restart_offset_ > size_ - sizeof(uint32_t)) {
-      // The size is too small for NumRestarts() and therefore
-      // restart_offset_ wrapped around.
+    size_t restarts_end = size_ - sizeof(uint32_t);
+    if ((DecodeFixed32(data_ + restarts_end) & kDataBlockHashIndexFlag) &&
+        !data_block_hash_index_.Initialize(data_, &restarts_end)) {
       size_ = 0;
+      return;
+    }
+    if (NumRestarts() > restarts_end / sizeof(uint32_t)) {
+      // The size is too small for NumRestarts().
+      size_ = 0;
+      return;
     }
+    restart_offset_ = static_cast<uint32_t>(restarts_end - NumRestarts() * sizeof(uint32_t));
   }
 }
 
 InternalIterator* Block::NewIterator(const Comparator* cmp, BlockIter* iter,
-                                     bool total_order_seek) {
+                                     bool total_order_seek,
+                                     KeyValueEncodingFormat key_value_encoding_format,
+                                     const SliceTransform* hash_index_key_extractor) {
   if (size_ < 2*sizeof(uint32_t)) {
     if (iter != nullptr) {
       iter->SetStatus(STATUS(Corruption, "bad block contents"));
@@ -377,13 +541,20 @@ InternalIterator* Block::NewIterator(const Comparator* cmp, BlockIter* iter,
         total_order_seek ? nullptr : hash_index_.get();
     BlockPrefixIndex* prefix_index_ptr =
         total_order_seek ? nullptr : prefix_index_.get();
+    // The data block hash index gives the same results as binary search, so it is also used by
+    // total order seeks.
+    const DataBlockHashIndex* data_block_hash_index_ptr =
+        hash_index_key_extractor && data_block_hash_index_.valid() ? &data_block_hash_index_
+                                                                   : nullptr;
 
     if (iter != nullptr) {
       iter->Initialize(cmp, data_, restart_offset_, num_restarts,
-                    hash_index_ptr, prefix_index_ptr);
+                    hash_index_ptr, prefix_index_ptr, key_value_encoding_format,
+                    data_block_hash_index_ptr, hash_index_key_extractor);
     } else {
       iter = new BlockIter(cmp, data_, restart_offset_, num_restarts,
-                           hash_index_ptr, prefix_index_ptr);
+                           hash_index_ptr, prefix_index_ptr, key_value_encoding_format,
+                           data_block_hash_index_ptr, hash_index_key_extractor);
     }
   }
 
@@ -35,6 +35,7 @@
 #include "yb/rocksdb/db/dbformat.h"
 #include "yb/rocksdb/table/block_prefix_index.h"
 #include "yb/rocksdb/table/block_hash_index.h"
+#include "yb/rocksdb/table/data_block_hash_index.h"
 #include "yb/rocksdb/table/format.h"
 #include "yb/rocksdb/table/internal_iterator.h"
 
@@ -82,9 +83,18 @@ class Block {
   // If total_order_seek is true, hash_index_ and prefix_index_ are ignored.
   // This option only applies for index block. For data block, hash_index_
   // and prefix_index_ are null, so this option does not matter.
+  //
+  // key_value_encoding_format should match the format the block was built with, see
+  // BlockBuilder.
+  //
+  // If hash_index_key_extractor is not null, it should be the extractor the block was built with,
+  // and the data block hash index of the block, if any, is used by seeks.
   InternalIterator* NewIterator(const Comparator* comparator,
                                 BlockIter* iter = nullptr,
-                                bool total_order_seek = true);
+                                bool total_order_seek = true,
+                                KeyValueEncodingFormat key_value_encoding_format =
+                                    KeyValueEncodingFormat::kKeyDeltaEncodingSharedPrefix,
+                                const SliceTransform* hash_index_key_extractor = nullptr);
   void SetBlockHashIndex(BlockHashIndex* hash_index);
   void SetBlockPrefixIndex(BlockPrefixIndex* prefix_index);
 
@@ -98,6 +108,7 @@ class Block {
   uint32_t restart_offset_;     // Offset in data_ of restart array
   std::unique_ptr<BlockHashIndex> hash_index_;
   std::unique_ptr<BlockPrefixIndex> prefix_index_;
+  DataBlockHashIndex data_block_hash_index_;
 
   // No copying allowed
   Block(const Block&);
@@ -115,19 +126,27 @@ class BlockIter : public InternalIterator {
         restart_index_(0),
         status_(Status::OK()),
         hash_index_(nullptr),
-        prefix_index_(nullptr) {}
+        prefix_index_(nullptr),
+        key_value_encoding_format_(KeyValueEncodingFormat::kKeyDeltaEncodingSharedPrefix),
+        data_block_hash_index_(nullptr),
+        data_block_hash_index_key_extractor_(nullptr) {}
 
   BlockIter(const Comparator* comparator, const char* data, uint32_t restarts,
        uint32_t num_restarts, BlockHashIndex* hash_index,
-       BlockPrefixIndex* prefix_index)
+       BlockPrefixIndex* prefix_index, KeyValueEncodingFormat key_value_encoding_format,
+       const DataBlockHashIndex* data_block_hash_index = nullptr,
+       const SliceTransform* data_block_hash_index_key_extractor = nullptr)
       : BlockIter() {
     Initialize(comparator, data, restarts, num_restarts,
-        hash_index, prefix_index);
+        hash_index, prefix_index, key_value_encoding_format,
+        data_block_hash_index, data_block_hash_index_key_extractor);
   }
 
   void Initialize(const Comparator* comparator, const char* data,
       uint32_t restarts, uint32_t num_restarts, BlockHashIndex* hash_index,
-      BlockPrefixIndex* prefix_index);
+      BlockPrefixIndex* prefix_index, KeyValueEncodingFormat key_value_encoding_format,
+      const DataBlockHashIndex* data_block_hash_index = nullptr,
+      const SliceTransform* data_block_hash_index_key_extractor = nullptr);
 
   void SetStatus(Status s) {
     status_ = s;
@@ -180,6 +199,11 @@ class BlockIter : public InternalIterator {
   Status status_;
   BlockHashIndex* hash_index_;
   BlockPrefixIndex* prefix_index_;
+  KeyValueEncodingFormat key_value_encoding_format_;
+  const DataBlockHashIndex* data_block_hash_index_;
+  const SliceTransform* data_block_hash_index_key_extractor_;
+  // Buffer to restore keys encoded with kKeyDeltaEncodingThreeSharedParts.
+  std::string key_buffer_;
 
   inline int Compare(const Slice& a, const Slice& b) const {
     return comparator_->Compare(a, b);
@@ -210,6 +234,13 @@ class BlockIter : public InternalIterator {
 
   bool ParseNextKey();
 
+  // Parses entry at p that is encoded with kKeyDeltaEncodingThreeSharedParts. Returns pointer
+  // to the value or nullptr if the entry is corrupted.
+  const char* ParseThreeSharedPartsEntry(const char* p, const char* limit, uint32_t* value_length);
+
+  // Decodes the key of the restart point entry at offset, which is always stored in full.
+  bool DecodeRestartKey(uint32_t offset, Slice* key);
+
   bool BinarySeek(const Slice& target, uint32_t left, uint32_t right,
                   uint32_t* index);
 
@@ -223,6 +254,10 @@ class BlockIter : public InternalIterator {
 
   bool PrefixSeek(const Slice& target, uint32_t* index);
 
+  // Seeks using the data block hash index. Returns false if the index could not be used, i.e. the
+  // prefix of target is not found in it, so the restart array should be searched instead.
+  bool DataBlockHashSeek(const Slice& target);
+
 };
 
 }  // namespace rocksdb
@@ -48,6 +48,7 @@
 #include "yb/rocksdb/table/filter_block.h"
 #include "yb/rocksdb/table/block_based_filter_block.h"
 #include "yb/rocksdb/table/block_based_table_factory.h"
+#include "yb/rocksdb/table/data_block_boundaries.h"
 #include "yb/rocksdb/table/fixed_size_filter_block.h"
 #include "yb/rocksdb/table/full_filter_block.h"
 #include "yb/rocksdb/table/format.h"
@@ -106,10 +107,16 @@ bool GoodCompressionRatio(size_t compressed_size, size_t raw_size) {
   return compressed_size < raw_size - (raw_size / 8u);
 }
 
+bool IsZSTDCompression(CompressionType type) {
+  return type == kZSTD || type == kZSTDNotFinalCompression;
+}
+
 // format_version is the block format as defined in include/rocksdb/table.h
+// compression_dict is only used by ZSTD compression.
 Slice CompressBlock(const Slice& raw,
                     const CompressionOptions& compression_options,
                     CompressionType* type, uint32_t format_version,
+                    const Slice& compression_dict,
                     std::string* compressed_output) {
   if (*type == kNoCompression) {
     return raw;
@@ -161,9 +168,10 @@ Slice CompressBlock(const Slice& raw,
         return *compressed_output;
       }
       break;     // fall back to no compression.
+    case kZSTD:
     case kZSTDNotFinalCompression:
       if (ZSTD_Compress(compression_options, raw.cdata(), raw.size(),
-                        compressed_output) &&
+                        compressed_output, compression_dict) &&
           GoodCompressionRatio(compressed_output->size(), raw.size())) {
         return *compressed_output;
       }
@@ -294,11 +302,21 @@ struct BlockBasedTableBuilder::Rep {
   bool closed = false;  // Either Finish() or Abandon() has been called.
 
   BlockHandle data_pending_handle;    // Handle to add to data index block
+  // Set when table_options.store_data_block_boundaries is true.
+  std::unique_ptr<DataBlockBoundariesBuilder> data_block_boundaries_builder;
   BlockHandle filter_pending_handle;  // Handle to add to filter index block
 
   std::string compressed_output;
   std::unique_ptr<FlushBlockPolicy> flush_block_policy;
 
+  // ZSTD dictionary compression state. Raw data blocks are sampled until dict_train_bytes are
+  // collected, then the dictionary is trained and used for all subsequent data blocks.
+  bool collect_dict_samples = false;
+  size_t dict_train_bytes = 0;
+  std::string dict_samples;
+  std::vector<size_t> dict_sample_sizes;
+  std::string compression_dict;
+
   std::vector<std::unique_ptr<IntTblPropCollector>> table_properties_collectors;
 
   yb::MemTrackerPtr mem_tracker;
@@ -331,6 +349,15 @@ Status BlockBasedTableBuilder::BlockBasedTablePropertiesCollector::Finish(
   val.clear();
   PutFixed32(&val, rep_->data_index_builder->NumLevels());
   properties->emplace(BlockBasedTablePropertyNames::kNumIndexLevels, val);
+  val.clear();
+  PutFixed32(&val, static_cast<uint32_t>(rep_->data_block_builder.key_value_encoding_format()));
+  properties->emplace(BlockBasedTablePropertyNames::kDataBlockKeyValueEncodingFormat, val);
+  const auto& hash_index_key_extractor = rep_->table_options.data_block_hash_index_key_extractor;
+  if (hash_index_key_extractor) {
+    properties->emplace(
+        BlockBasedTablePropertyNames::kDataBlockHashIndexKeyExtractor,
+        hash_index_key_extractor->Name());
+  }
   return Status::OK();
 }
 
@@ -352,7 +379,9 @@ BlockBasedTableBuilder::Rep::Rep(
       filter_block_builder(skip_filters ? nullptr : CreateFilterBlockBuilder(
           _ioptions, table_options, filter_type)),
       data_block_builder(table_options.block_restart_interval,
-                 table_options.use_delta_encoding),
+                 table_options.use_delta_encoding,
+                 table_options.data_block_key_value_encoding_format,
+                 table_options.data_block_hash_index_key_extractor.get()),
       internal_prefix_transform(_ioptions.prefix_extractor),
       filter_key_transformer(table_opt.filter_policy ?
           table_opt.filter_policy->GetKeyTransformer() : nullptr),
@@ -376,6 +405,18 @@ BlockBasedTableBuilder::Rep::Rep(
         "BlockBasedTableBuilder", _ioptions.mem_tracker);
   }
 
+  if (IsZSTDCompression(compression_type) && compression_opts.max_dict_bytes > 0 &&
+      ZSTD_DictSupported()) {
+    collect_dict_samples = true;
+    dict_train_bytes = compression_opts.zstd_max_train_bytes > 0
+        ? compression_opts.zstd_max_train_bytes
+        : 100 * static_cast<size_t>(compression_opts.max_dict_bytes);
+  }
+
+  if (table_options.store_data_block_boundaries) {
+    data_block_boundaries_builder = std::make_unique<DataBlockBoundariesBuilder>();
+  }
+
   metadata_writer = std::make_shared<FileWriterWithOffsetAndCachePrefix>();
   metadata_writer->writer = metadata_file;
   if (data_file != nullptr) {
@@ -482,6 +523,12 @@ void BlockBasedTableBuilder::Add(const Slice& key, const Slice& value) {
       r->ioptions.info_log);
 }
 
+void BlockBasedTableBuilder::AddBoundaryValues(const UserBoundaryValues& values) {
+  if (rep_->data_block_boundaries_builder && ok()) {
+    rep_->data_block_boundaries_builder->Add(values);
+  }
+}
+
 void BlockBasedTableBuilder::FlushDataBlock(const Slice& next_block_first_key) {
   Rep* const r = rep_;
   assert(!r->closed);
@@ -489,8 +536,14 @@ void BlockBasedTableBuilder::FlushDataBlock(const Slice& next_block_first_key) {
   size_t data_block_size = 0;
 
   if (!r->data_block_builder.empty()) {
-    data_block_size = WriteBlock(&r->data_block_builder, &r->data_pending_handle,
-        r->data_writer.get());
+    const Slice raw_block_contents = r->data_block_builder.Finish();
+    SampleForCompressionDict(raw_block_contents);
+    data_block_size = WriteBlock(raw_block_contents, &r->data_pending_handle,
+        r->data_writer.get(), r->compression_dict);
+    r->data_block_builder.Reset();
+    if (r->data_block_boundaries_builder) {
+      r->data_block_boundaries_builder->FinishBlock(r->data_pending_handle.offset());
+    }
   }
   if (!ok()) return;
 
@@ -561,17 +614,33 @@ void BlockBasedTableBuilder::FlushFilterBlock(const Slice& next_block_first_key)
       is_last_flush ? nullptr : &next_block_first_key,  r->filter_pending_handle);
 }
 
-size_t BlockBasedTableBuilder::WriteBlock(BlockBuilder* block,
-                                          BlockHandle* handle,
-                                          FileWriterWithOffsetAndCachePrefix* writer_info) {
-  size_t block_size = WriteBlock(block->Finish(), handle, writer_info);
-  block->Reset();
-  return block_size;
+void BlockBasedTableBuilder::SampleForCompressionDict(const Slice& raw_block_contents) {
+  Rep* r = rep_;
+  if (!r->collect_dict_samples) {
+    return;
+  }
+  r->dict_samples.append(raw_block_contents.cdata(), raw_block_contents.size());
+  r->dict_sample_sizes.push_back(raw_block_contents.size());
+  if (r->dict_samples.size() < r->dict_train_bytes) {
+    return;
+  }
+
+  r->collect_dict_samples = false;
+  r->compression_dict = ZSTD_TrainDictionary(
+      r->dict_samples, r->dict_sample_sizes, r->compression_opts.max_dict_bytes);
+  if (r->compression_dict.empty()) {
+    RLOG(InfoLogLevel::WARN_LEVEL, r->ioptions.info_log,
+        "Failed to train compression dictionary from %" ROCKSDB_PRIszt " samples",
+        r->dict_sample_sizes.size());
+  }
+  std::string().swap(r->dict_samples);
+  std::vector<size_t>().swap(r->dict_sample_sizes);
 }
 
 size_t BlockBasedTableBuilder::WriteBlock(const Slice& raw_block_contents,
                                           BlockHandle* handle,
-                                          FileWriterWithOffsetAndCachePrefix* writer_info) {
+                                          FileWriterWithOffsetAndCachePrefix* writer_info,
+                                          const Slice& compression_dict) {
   // File format contains a sequence of blocks where each block has:
   //    block_data: uint8[n]
   //    type: uint8
@@ -584,7 +653,7 @@ size_t BlockBasedTableBuilder::WriteBlock(const Slice& raw_block_contents,
   if (raw_block_contents.size() < kCompressionSizeLimit) {
     block_contents =
         CompressBlock(raw_block_contents, r->compression_opts, &type,
-                      r->table_options.format_version, &r->compressed_output);
+                      r->table_options.format_version, compression_dict, &r->compressed_output);
   } else {
     RecordTick(r->ioptions.statistics, NUMBER_BLOCK_NOT_COMPRESSED);
     type = kNoCompression;
@@ -717,8 +786,10 @@ Status BlockBasedTableBuilder::Finish() {
   // Write meta blocks and metaindex block with the following order.
   //    1. [meta block: filter]
   //    2. [other meta blocks]
-  //    3. [meta block: properties]
-  //    4. [metaindex block]
+  //    3. [meta block: compression dictionary]
+  //    4. [meta block: data block boundaries]
+  //    5. [meta block: properties]
+  //    6. [metaindex block]
   // write meta blocks
   MetaIndexBuilder meta_index_builder;
   for (const auto& item : r->data_index_blocks.meta_blocks) {
@@ -765,6 +836,22 @@ Status BlockBasedTableBuilder::Finish() {
       }
     }
 
+    // Write compression dictionary block.
+    if (!r->compression_dict.empty()) {
+      BlockHandle compression_dict_block_handle;
+      WriteRawBlock(r->compression_dict, kNoCompression, &compression_dict_block_handle,
+          r->metadata_writer.get());
+      meta_index_builder.Add(kCompressionDictBlock, compression_dict_block_handle);
+    }
+
+    // Write data block boundaries block.
+    if (r->data_block_boundaries_builder && !r->data_block_boundaries_builder->empty()) {
+      BlockHandle data_block_boundaries_handle;
+      WriteRawBlock(r->data_block_boundaries_builder->contents(), kNoCompression,
+          &data_block_boundaries_handle, r->metadata_writer.get());
+      meta_index_builder.Add(kDataBlockBoundariesBlock, data_block_boundaries_handle);
+    }
+
     // Write properties block.
     {
       PropertyBlockBuilder property_block_builder;
@@ -68,6 +68,9 @@ class BlockBasedTableBuilder : public TableBuilder {
   // REQUIRES: Finish(), Abandon() have not been called
   void Add(const Slice& key, const Slice& value) override;
 
+  // Updates the boundaries of the current data block when store_data_block_boundaries is set.
+  void AddBoundaryValues(const UserBoundaryValues& values) override;
+
   // Return non-ok iff some error has been detected.
   Status status() const override;
 
@@ -106,13 +109,14 @@ class BlockBasedTableBuilder : public TableBuilder {
   struct FileWriterWithOffsetAndCachePrefix;
 
   bool ok() const { return status().ok(); }
-  // Call block's Finish() method and then write the finalize block contents to
-  // file. Returns number of bytes written to file.
-  size_t WriteBlock(BlockBuilder* block, BlockHandle* handle,
-      FileWriterWithOffsetAndCachePrefix* writer_info);
   // Directly write block content to the file. Returns number of bytes written to file.
+  // compression_dict is used to prime ZSTD compression of the block if not empty.
   size_t WriteBlock(const Slice& block_contents, BlockHandle* handle,
-      FileWriterWithOffsetAndCachePrefix* writer_info);
+      FileWriterWithOffsetAndCachePrefix* writer_info,
+      const Slice& compression_dict = Slice());
+  // Collects raw data block contents until there are enough samples to train the compression
+  // dictionary, then trains it.
+  void SampleForCompressionDict(const Slice& raw_block_contents);
   size_t WriteRawBlock(const Slice& data, CompressionType, BlockHandle* handle,
       FileWriterWithOffsetAndCachePrefix* writer_info);
   Status InsertBlockInCache(const Slice& block_contents,
@@ -177,6 +177,16 @@ std::string BlockBasedTableFactory::GetPrintableTableOptions() const {
   snprintf(buffer, kBufferSize, "  index_block_restart_interval: %d\n",
            table_options_.index_block_restart_interval);
   ret.append(buffer);
+  snprintf(buffer, kBufferSize, "  data_block_key_value_encoding_format: %s\n",
+           ToString(table_options_.data_block_key_value_encoding_format).c_str());
+  ret.append(buffer);
+  snprintf(buffer, kBufferSize, "  data_block_hash_index_key_extractor: %s\n",
+           table_options_.data_block_hash_index_key_extractor == nullptr ?
+             "nullptr" : table_options_.data_block_hash_index_key_extractor->Name());
+  ret.append(buffer);
+  snprintf(buffer, kBufferSize, "  store_data_block_boundaries: %d\n",
+           table_options_.store_data_block_boundaries);
+  ret.append(buffer);
   snprintf(buffer, kBufferSize, "  filter_policy: %s\n",
            table_options_.filter_policy == nullptr ?
              "nullptr" : table_options_.filter_policy->Name());
@@ -214,6 +224,10 @@ const char BlockBasedTablePropertyNames::kWholeKeyFiltering[] =
     "rocksdb.block.based.table.whole.key.filtering";
 const char BlockBasedTablePropertyNames::kPrefixFiltering[] =
     "rocksdb.block.based.table.prefix.filtering";
+const char BlockBasedTablePropertyNames::kDataBlockKeyValueEncodingFormat[] =
+    "rocksdb.block.based.table.data.block.key.value.encoding.format";
+const char BlockBasedTablePropertyNames::kDataBlockHashIndexKeyExtractor[] =
+    "rocksdb.block.based.table.data.block.hash.index.key.extractor";
 const char kHashIndexPrefixesBlock[] = "rocksdb.hashindex.prefixes";
 const char kHashIndexPrefixesMetadataBlock[] =
     "rocksdb.hashindex.metadata";
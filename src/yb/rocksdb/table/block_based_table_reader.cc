@@ -44,6 +44,7 @@
 #include "yb/rocksdb/table/block_based_table_internal.h"
 #include "yb/rocksdb/table/block_hash_index.h"
 #include "yb/rocksdb/table/block_prefix_index.h"
+#include "yb/rocksdb/table/data_block_boundaries.h"
 #include "yb/rocksdb/table/filter_block.h"
 #include "yb/rocksdb/table/format.h"
 #include "yb/rocksdb/table/forwarding_iterator.h"
@@ -228,6 +229,12 @@ struct BlockBasedTable::Rep {
   bool hash_index_allow_collision;
   bool whole_key_filtering;
   bool prefix_filtering;
+  // Tables written before the encoding format was recorded always use shared prefix encoding.
+  KeyValueEncodingFormat data_block_key_value_encoding_format =
+      KeyValueEncodingFormat::kKeyDeltaEncodingSharedPrefix;
+  // Extractor of the data block hash index, when data blocks were written with the index by the
+  // same extractor.
+  const SliceTransform* data_block_hash_index_key_extractor = nullptr;
   // TODO(kailiu) It is very ugly to use internal key in table, since table
   // module should not be relying on db module. However to make things easier
   // and compatible with existing code, we introduce a wrapper that allows
@@ -235,11 +242,17 @@ struct BlockBasedTable::Rep {
   unique_ptr<SliceTransform> internal_prefix_transform;
   DataIndexLoadMode data_index_load_mode;
   yb::MemTrackerPtr mem_tracker;
+  // Dictionary used to compress data blocks of this table, empty if there is none.
+  BlockContents compression_dict_block;
+  // Boundaries of the data blocks, set when the table has them.
+  BlockContents data_block_boundaries_block;
+  std::unique_ptr<DataBlockBoundariesReader> data_block_boundaries;
 };
 
-// BlockEntryIteratorState doesn't actually store any iterator state and is only used as an adapter
-// to BlockBasedTable. It is used by TwoLevelIterator and MultiLevelIterator to call BlockBasedTable
-// functions in order to check if prefix may match or to create a secondary iterator.
+// BlockEntryIteratorState is mostly used as an adapter to BlockBasedTable. It is used by
+// TwoLevelIterator and MultiLevelIterator to call BlockBasedTable functions in order to check if
+// prefix may match or to create a secondary iterator. The only iterator state it stores is the
+// prefetch buffer used for ReadOptions::adaptive_readahead.
 class BlockBasedTable::BlockEntryIteratorState : public TwoLevelIteratorState {
  public:
   BlockEntryIteratorState(
@@ -249,10 +262,20 @@ class BlockBasedTable::BlockEntryIteratorState : public TwoLevelIteratorState {
         table_(table),
         read_options_(read_options),
         skip_filters_(skip_filters),
-        block_type_(block_type) {}
+        block_type_(block_type) {
+    if (read_options_.adaptive_readahead && block_type_ == BlockType::kData) {
+      prefetch_buffer_ = std::make_unique<FilePrefetchBuffer>(
+          table_->GetBlockReader(block_type_)->reader.get(), table_->rep_->ioptions.statistics);
+    }
+  }
 
   InternalIterator* NewSecondaryIterator(const Slice& index_value) override {
-    return table_->NewDataBlockIterator(read_options_, index_value, block_type_);
+    if (block_type_ == BlockType::kData && read_options_.block_filter &&
+        !table_->BlockMayMatch(*read_options_.block_filter, index_value)) {
+      return NewEmptyInternalIterator();
+    }
+    return table_->NewDataBlockIterator(
+        read_options_, index_value, block_type_, nullptr /* input_iter */, prefetch_buffer_.get());
   }
 
   bool PrefixMayMatch(const Slice& internal_key) override {
@@ -270,6 +293,7 @@ class BlockBasedTable::BlockEntryIteratorState : public TwoLevelIteratorState {
   const ReadOptions read_options_;
   const bool skip_filters_;
   const BlockType block_type_;
+  std::unique_ptr<FilePrefetchBuffer> prefetch_buffer_;
 };
 
 
@@ -324,6 +348,10 @@ BloomFilterAwareFileFilter::BloomFilterAwareFileFilter(
 bool BloomFilterAwareFileFilter::Filter(TableReader* reader) const {
   auto table = down_cast<BlockBasedTable*>(reader);
   if (table->rep_->filter_type == FilterType::kFixedSizeFilter) {
+    if (table->rep_->filter_key_transformer &&
+        !table->rep_->filter_key_transformer->InDomain(user_key_)) {
+      return true;
+    }
     const auto filter_key = table->GetFilterKeyFromUserKey(user_key_);
     auto filter_entry = table->GetFilter(read_options_.query_id,
         read_options_.read_tier == kBlockCacheTier /* no_io */, &filter_key);
@@ -465,6 +493,42 @@ Status BlockBasedTable::Open(const ImmutableCFOptions& ioptions,
         "Cannot find Properties block from file.");
   }
 
+  // Read the compression dictionary, it is kept in memory until the table is closed.
+  BlockHandle compression_dict_handle;
+  if (FindMetaBlock(meta_iter.get(), kCompressionDictBlock, &compression_dict_handle).ok()) {
+    s = ReadBlockContents(
+        rep->base_reader_with_cache_prefix->reader.get(), rep->footer, ReadOptions::kDefault,
+        compression_dict_handle, &rep->compression_dict_block, rep->ioptions.env,
+        rep->mem_tracker, false /* do_uncompress */);
+    if (!s.ok()) {
+      RLOG(InfoLogLevel::ERROR_LEVEL, rep->ioptions.info_log,
+          "Encountered error while reading compression dictionary block %s",
+          s.ToString().c_str());
+      return s;
+    }
+  }
+
+  BlockHandle data_block_boundaries_handle;
+  if (FindMetaBlock(meta_iter.get(), kDataBlockBoundariesBlock,
+                    &data_block_boundaries_handle).ok()) {
+    s = ReadBlockContents(
+        rep->base_reader_with_cache_prefix->reader.get(), rep->footer, ReadOptions::kDefault,
+        data_block_boundaries_handle, &rep->data_block_boundaries_block, rep->ioptions.env,
+        rep->mem_tracker, false /* do_uncompress */);
+    if (s.ok()) {
+      rep->data_block_boundaries = std::make_unique<DataBlockBoundariesReader>();
+      s = rep->data_block_boundaries->Init(rep->data_block_boundaries_block.data);
+    }
+    if (!s.ok()) {
+      // Data blocks are just not skipped without their boundaries.
+      RLOG(InfoLogLevel::ERROR_LEVEL, rep->ioptions.info_log,
+          "Encountered error while reading data block boundaries block %s",
+          s.ToString().c_str());
+      rep->data_block_boundaries.reset();
+      s = Status::OK();
+    }
+  }
+
   // Determine whether whole key filtering is supported.
   if (rep->table_properties) {
     rep->whole_key_filtering &=
@@ -474,6 +538,28 @@ Status BlockBasedTable::Open(const ImmutableCFOptions& ioptions,
     rep->prefix_filtering &= IsFeatureSupported(
         *(rep->table_properties),
         BlockBasedTablePropertyNames::kPrefixFiltering, rep->ioptions.info_log);
+
+    auto& props = rep->table_properties->user_collected_properties;
+    auto pos = props.find(BlockBasedTablePropertyNames::kDataBlockKeyValueEncodingFormat);
+    if (pos != props.end()) {
+      if (pos->second.size() != sizeof(uint32_t)) {
+        return STATUS_FORMAT(Corruption, "Invalid data block key value encoding format: $0",
+                             Slice(pos->second).ToDebugHexString());
+      }
+      const auto format = static_cast<KeyValueEncodingFormat>(DecodeFixed32(pos->second.c_str()));
+      if (ToCString(format) == nullptr) {
+        return STATUS_FORMAT(NotSupported, "Unknown data block key value encoding format: $0",
+                             static_cast<uint32_t>(format));
+      }
+      rep->data_block_key_value_encoding_format = format;
+    }
+
+    const auto& hash_index_key_extractor = table_options.data_block_hash_index_key_extractor;
+    pos = props.find(BlockBasedTablePropertyNames::kDataBlockHashIndexKeyExtractor);
+    if (pos != props.end() && hash_index_key_extractor &&
+        pos->second == hash_index_key_extractor->Name()) {
+      rep->data_block_hash_index_key_extractor = hash_index_key_extractor.get();
+    }
   }
 
   if (data_index_load_mode == DataIndexLoadMode::PRELOAD_ON_OPEN) {
@@ -623,6 +709,10 @@ size_t BlockBasedTable::ApproximateMemoryUsage() const {
   if (data_index_reader) {
     usage += data_index_reader->ApproximateMemoryUsage();
   }
+  if (rep_->data_block_boundaries) {
+    usage += rep_->data_block_boundaries->ApproximateMemoryUsage() +
+             rep_->data_block_boundaries_block.data.size();
+  }
   return usage;
 }
 
@@ -679,13 +769,25 @@ Tickers GetBlockCacheHitTicker(BlockType block_type) {
   FATAL_INVALID_ENUM_VALUE(BlockType, block_type);
 }
 
+// Index blocks are small and used by every read, so they are kept in the high priority pool of
+// the block cache, away from data blocks brought in by scans.
+Cache::Priority GetBlockCachePriority(BlockType block_type) {
+  switch (block_type) {
+    case BlockType::kData:
+      return Cache::Priority::LOW;
+    case BlockType::kIndex:
+      return Cache::Priority::HIGH;
+  }
+  FATAL_INVALID_ENUM_VALUE(BlockType, block_type);
+}
+
 } // namespace
 
 Status BlockBasedTable::GetDataBlockFromCache(
     const Slice& block_cache_key, const Slice& compressed_block_cache_key,
     Cache* block_cache, Cache* block_cache_compressed, Statistics* statistics,
     const ReadOptions& read_options, BlockBasedTable::CachableEntry<Block>* block,
-    uint32_t format_version, BlockType block_type,
+    uint32_t format_version, const Slice& compression_dict, BlockType block_type,
     const std::shared_ptr<yb::MemTracker>& mem_tracker) {
   Status s;
   Block* compressed_block = nullptr;
@@ -730,7 +832,7 @@ Status BlockBasedTable::GetDataBlockFromCache(
   // Retrieve the uncompressed contents into a new buffer
   BlockContents contents;
   s = UncompressBlockContents(compressed_block->data(), compressed_block->size(), &contents,
-                              format_version, mem_tracker);
+                              format_version, mem_tracker, compression_dict);
 
   // Insert uncompressed block into block cache
   if (s.ok()) {
@@ -740,7 +842,8 @@ Status BlockBasedTable::GetDataBlockFromCache(
         read_options.fill_cache) {
       s = block_cache->Insert(block_cache_key, read_options.query_id, block->value,
                               block->value->usable_size(), &DeleteCachedEntry<Block>,
-                              &block->cache_handle, statistics);
+                              &block->cache_handle, statistics,
+                              GetBlockCachePriority(block_type));
       if (!s.ok()) {
         delete block->value;
         block->value = nullptr;
@@ -758,6 +861,7 @@ Status BlockBasedTable::PutDataBlockToCache(
     Cache* block_cache, Cache* block_cache_compressed,
     const ReadOptions& read_options, Statistics* statistics,
     CachableEntry<Block>* block, Block* raw_block, uint32_t format_version,
+    const Slice& compression_dict, BlockType block_type,
     const std::shared_ptr<yb::MemTracker>& mem_tracker) {
   assert(raw_block->compression_type() == kNoCompression ||
          block_cache_compressed != nullptr);
@@ -767,7 +871,7 @@ Status BlockBasedTable::PutDataBlockToCache(
   BlockContents contents;
   if (raw_block->compression_type() != kNoCompression) {
     s = UncompressBlockContents(raw_block->data(), raw_block->size(), &contents,
-                                format_version, mem_tracker);
+                                format_version, mem_tracker, compression_dict);
   }
   if (!s.ok()) {
     delete raw_block;
@@ -802,7 +906,8 @@ Status BlockBasedTable::PutDataBlockToCache(
   if (block_cache != nullptr && block->value->cachable()) {
     s = block_cache->Insert(block_cache_key, read_options.query_id, block->value,
                             block->value->usable_size(),
-                            &DeleteCachedEntry<Block>, &block->cache_handle, statistics);
+                            &DeleteCachedEntry<Block>, &block->cache_handle, statistics,
+                            GetBlockCachePriority(block_type));
     if (!s.ok()) {
       delete block->value;
       block->value = nullptr;
@@ -954,10 +1059,19 @@ BlockBasedTable::CachableEntry<FilterBlockReader> BlockBasedTable::GetFilter(
     filter_block_handle = &rep_->filter_handle;
   }
 
+  // For fixed-size filter we don't prefetch all filter blocks, so we ignore no_io parameter and
+  // always load necessary filter block through block cache.
+  return GetFilterBlock(*filter_block_handle, query_id, no_io && !is_fixed_size_filter);
+}
+
+BlockBasedTable::CachableEntry<FilterBlockReader> BlockBasedTable::GetFilterBlock(
+    const BlockHandle& filter_block_handle, const QueryId query_id, bool no_io) const {
+  Cache* block_cache = rep_->table_options.block_cache.get();
+
   // Fetching from the cache
   char cache_key_buffer[block_based_table::kMaxCacheKeyPrefixSize + kMaxVarint64Length];
   auto filter_block_cache_key = GetCacheKey(rep_->base_reader_with_cache_prefix->cache_key_prefix,
-      *filter_block_handle, cache_key_buffer);
+      filter_block_handle, cache_key_buffer);
 
   Statistics* statistics = rep_->ioptions.statistics;
   auto cache_handle = GetEntryFromCache(block_cache, filter_block_cache_key,
@@ -966,20 +1080,18 @@ BlockBasedTable::CachableEntry<FilterBlockReader> BlockBasedTable::GetFilter(
   FilterBlockReader* filter = nullptr;
   if (cache_handle != nullptr) {
     filter = static_cast<FilterBlockReader*>(block_cache->Value(cache_handle));
-  } else if (no_io && rep_->filter_type != FilterType::kFixedSizeFilter) {
+  } else if (no_io) {
     // Do not invoke any io.
     return CachableEntry<FilterBlockReader>();
   } else {
-    // For fixed-size filter we don't prefetch all filter blocks and ignore no_io parameter always
-    // loading necessary filter block through block cache.
     size_t filter_size = 0;
-    filter = ReadFilterBlock(*filter_block_handle, rep_, &filter_size);
+    filter = ReadFilterBlock(filter_block_handle, rep_, &filter_size);
     if (filter != nullptr) {
       assert(filter_size > 0);
       Status s = block_cache->Insert(filter_block_cache_key, query_id,
                                      filter, filter_size,
                                      &DeleteCachedEntry<FilterBlockReader>, &cache_handle,
-                                     statistics);
+                                     statistics, Cache::Priority::HIGH);
       if (!s.ok()) {
         delete filter;
         return CachableEntry<FilterBlockReader>();
@@ -990,6 +1102,54 @@ BlockBasedTable::CachableEntry<FilterBlockReader> BlockBasedTable::GetFilter(
   return { filter, cache_handle };
 }
 
+Status BlockBasedTable::WarmUpBlockCache() {
+  {
+    // Loads the data index, or its top level in case of multi-level index, to the block cache or to
+    // the table reader itself depending on cache_index_and_filter_blocks.
+    unique_ptr<InternalIterator> index_iter(NewIndexIterator(ReadOptions::kDefault));
+    RETURN_NOT_OK(index_iter->status());
+  }
+
+  Cache* block_cache = rep_->table_options.block_cache.get();
+  if (rep_->filter_policy == nullptr || block_cache == nullptr) {
+    return Status::OK();
+  }
+
+  switch (rep_->filter_type) {
+    case FilterType::kFullFilter:
+      FALLTHROUGH_INTENDED;
+    case FilterType::kBlockBasedFilter: {
+      // Without cache_index_and_filter_blocks the filter is preloaded on open.
+      if (rep_->table_options.cache_index_and_filter_blocks) {
+        auto filter_entry = GetFilter(kDefaultQueryId);
+        filter_entry.Release(block_cache);
+      }
+      return Status::OK();
+    }
+    case FilterType::kFixedSizeFilter: {
+      if (!rep_->filter_index_reader) {
+        return Status::OK();
+      }
+      BlockIter fiter;
+      rep_->filter_index_reader->NewIterator(&fiter,
+          // Following parameters are ignored by BinarySearchIndexReader which we use as
+          // filter_index_reader.
+          nullptr /* index_iterator_state */, true /* total_order_seek */);
+      for (fiter.SeekToFirst(); fiter.Valid(); fiter.Next()) {
+        Slice filter_block_handle_encoded = fiter.value();
+        BlockHandle filter_block_handle;
+        RETURN_NOT_OK(filter_block_handle.DecodeFrom(&filter_block_handle_encoded));
+        auto filter_entry = GetFilterBlock(filter_block_handle, kDefaultQueryId, false /* no_io */);
+        filter_entry.Release(block_cache);
+      }
+      return fiter.status();
+    }
+    case FilterType::kNoFilter:
+      return Status::OK();
+  }
+  return STATUS_SUBSTITUTE(Corruption, "Corrupted bloom filter type: $0", rep_->filter_type);
+}
+
 namespace {
 
 InternalIterator* ReturnErrorIterator(const Status& status, BlockIter* input_iter) {
@@ -1044,7 +1204,8 @@ InternalIterator* BlockBasedTable::NewIndexIterator(
     if (s.ok()) {
       s = block_cache->Insert(key, read_options.query_id, index_reader_unique.get(),
                               index_reader_unique->usable_size(),
-                              &DeleteCachedEntry<IndexReader>, &cache_handle, statistics);
+                              &DeleteCachedEntry<IndexReader>, &cache_handle, statistics,
+                              Cache::Priority::HIGH);
     }
 
     if (s.ok()) {
@@ -1095,7 +1256,8 @@ InternalIterator* BlockBasedTable::NewIndexIterator(
 // If input_iter is null, new a iterator
 // If input_iter is not null, update this iter and return it
 InternalIterator* BlockBasedTable::NewDataBlockIterator(const ReadOptions& ro,
-    const Slice& index_value, BlockType block_type, BlockIter* input_iter) {
+    const Slice& index_value, BlockType block_type, BlockIter* input_iter,
+    FilePrefetchBuffer* prefetch_buffer) {
   PERF_TIMER_GUARD(new_table_block_iter_nanos);
 
   const bool no_io = (ro.read_tier == kBlockCacheTier);
@@ -1140,7 +1302,8 @@ InternalIterator* BlockBasedTable::NewDataBlockIterator(const ReadOptions& ro,
 
     s = GetDataBlockFromCache(
         key, ckey, block_cache, block_cache_compressed, statistics, ro, &block,
-        rep_->table_options.format_version, block_type, rep_->mem_tracker);
+        rep_->table_options.format_version, rep_->compression_dict_block.data, block_type,
+        rep_->mem_tracker);
 
     if (block.value == nullptr && !no_io && ro.fill_cache) {
       std::unique_ptr<Block> raw_block;
@@ -1148,13 +1311,15 @@ InternalIterator* BlockBasedTable::NewDataBlockIterator(const ReadOptions& ro,
         StopWatch sw(rep_->ioptions.env, statistics, READ_BLOCK_GET_MICROS);
         s = block_based_table::ReadBlockFromFile(
             reader->reader.get(), rep_->footer, ro, handle, &raw_block, rep_->ioptions.env,
-            rep_->mem_tracker, block_cache_compressed == nullptr);
+            rep_->mem_tracker, block_cache_compressed == nullptr,
+            rep_->compression_dict_block.data, prefetch_buffer);
       }
 
       if (s.ok()) {
         s = PutDataBlockToCache(key, ckey, block_cache, block_cache_compressed,
                                 ro, statistics, &block, raw_block.release(),
-                                rep_->table_options.format_version, rep_->mem_tracker);
+                                rep_->table_options.format_version,
+                                rep_->compression_dict_block.data, block_type, rep_->mem_tracker);
       }
     }
   }
@@ -1173,7 +1338,8 @@ InternalIterator* BlockBasedTable::NewDataBlockIterator(const ReadOptions& ro,
     std::unique_ptr<Block> block_value;
     s = block_based_table::ReadBlockFromFile(
         reader->reader.get(), rep_->footer, ro, handle, &block_value, rep_->ioptions.env,
-        rep_->mem_tracker);
+        rep_->mem_tracker, true /* do_uncompress */, rep_->compression_dict_block.data,
+        prefetch_buffer);
     if (s.ok()) {
       block.value = block_value.release();
     }
@@ -1181,7 +1347,11 @@ InternalIterator* BlockBasedTable::NewDataBlockIterator(const ReadOptions& ro,
 
   InternalIterator* iter;
   if (s.ok() && block.value != nullptr) {
-    iter = block.value->NewIterator(rep_->comparator.get(), input_iter);
+    iter = block.value->NewIterator(
+        rep_->comparator.get(), input_iter, true /* total_order_seek */,
+        block_type == BlockType::kData ? rep_->data_block_key_value_encoding_format
+                                       : KeyValueEncodingFormat::kKeyDeltaEncodingSharedPrefix,
+        block_type == BlockType::kData ? rep_->data_block_hash_index_key_extractor : nullptr);
     if (block.cache_handle != nullptr) {
       iter->RegisterCleanup(&ReleaseCachedEntry, block_cache,
           block.cache_handle);
@@ -1199,6 +1369,26 @@ InternalIterator* BlockBasedTable::NewDataBlockIterator(const ReadOptions& ro,
   return iter;
 }
 
+bool BlockBasedTable::BlockMayMatch(const ReadBlockFilter& filter, const Slice& index_value) {
+  if (!rep_->data_block_boundaries) {
+    return true;
+  }
+  BlockHandle handle;
+  Slice input = index_value;
+  DataBlockBoundaries boundaries;
+  if (!handle.DecodeFrom(&input).ok() ||
+      !rep_->data_block_boundaries->Find(handle.offset(), &boundaries)) {
+    // NewDataBlockIterator reports a bad handle.
+    return true;
+  }
+  RecordTick(rep_->ioptions.statistics, DATA_BLOCK_FILTER_CHECKED);
+  if (filter.Filter(boundaries)) {
+    return true;
+  }
+  RecordTick(rep_->ioptions.statistics, DATA_BLOCK_FILTER_USEFUL);
+  return false;
+}
+
 // This will be broken if the user specifies an unusual implementation
 // of Options.comparator, or if the user specifies an unusual
 // definition of prefixes in BlockBasedTableOptions.filter_policy.
@@ -1417,6 +1607,126 @@ Status BlockBasedTable::Get(const ReadOptions& read_options, const Slice& intern
   return s;
 }
 
+Status BlockBasedTable::PrefetchKeys(const ReadOptions& read_options,
+                                     const std::vector<Slice>& internal_keys) {
+  Cache* block_cache = rep_->table_options.block_cache.get();
+  Cache* block_cache_compressed = rep_->table_options.block_cache_compressed.get();
+  // Prefetched blocks are only kept in block caches.
+  if ((block_cache == nullptr && block_cache_compressed == nullptr) || !read_options.fill_cache ||
+      read_options.read_tier == kBlockCacheTier) {
+    return Status::OK();
+  }
+  Statistics* statistics = rep_->ioptions.statistics;
+
+  // Data blocks where seeks to internal_keys start, in file order.
+  std::vector<BlockHandle> handles;
+  {
+    const bool is_block_based_filter = rep_->filter_type == FilterType::kBlockBasedFilter;
+    IndexIteratorHolder iiter_holder(this, read_options);
+    InternalIterator& iiter = *iiter_holder.iter();
+    RETURN_NOT_OK(iiter.status());
+
+    for (const auto& internal_key : internal_keys) {
+      if (!is_block_based_filter) {
+        Slice filter_key = GetFilterKeyFromInternalKey(internal_key);
+        auto filter_entry = GetFilter(read_options.query_id, false /* no_io */, &filter_key);
+        const bool may_match = NonBlockBasedFilterKeyMayMatch(filter_entry.value, filter_key);
+        filter_entry.Release(block_cache);
+        if (!may_match) {
+          RecordTick(statistics, BLOOM_FILTER_USEFUL);
+          continue;
+        }
+      }
+      iiter.Seek(internal_key);
+      if (!iiter.Valid()) {
+        RETURN_NOT_OK(iiter.status());
+        // All following keys are beyond the last key of the table.
+        break;
+      }
+      Slice data_block_handle_encoded = iiter.value();
+      BlockHandle handle;
+      RETURN_NOT_OK(handle.DecodeFrom(&data_block_handle_encoded));
+      if (handles.empty() || handles.back().offset() != handle.offset()) {
+        handles.push_back(handle);
+      }
+    }
+  }
+
+  FileReaderWithCachePrefix* reader = GetBlockReader(BlockType::kData);
+  char cache_key[block_based_table::kMaxCacheKeyPrefixSize + kMaxVarint64Length];
+  char compressed_cache_key[block_based_table::kMaxCacheKeyPrefixSize + kMaxVarint64Length];
+  Slice key, ckey;
+  auto prepare_cache_keys = [&](const BlockHandle& handle) {
+    if (block_cache != nullptr) {
+      key = GetCacheKey(reader->cache_key_prefix, handle, cache_key);
+    }
+    if (block_cache_compressed != nullptr) {
+      ckey = GetCacheKey(reader->compressed_cache_key_prefix, handle, compressed_cache_key);
+    }
+  };
+  auto release_block = [block_cache](CachableEntry<Block>* block) {
+    if (block->cache_handle != nullptr) {
+      block_cache->Release(block->cache_handle);
+    } else {
+      delete block->value;
+    }
+  };
+
+  std::vector<BlockHandle> handles_to_read;
+  std::vector<std::unique_ptr<char[]>> buffers;
+  std::vector<ReadRequest> requests;
+  for (const auto& handle : handles) {
+    prepare_cache_keys(handle);
+    CachableEntry<Block> block;
+    RETURN_NOT_OK(GetDataBlockFromCache(
+        key, ckey, block_cache, block_cache_compressed, statistics, read_options, &block,
+        rep_->table_options.format_version, rep_->compression_dict_block.data, BlockType::kData,
+        rep_->mem_tracker));
+    if (block.value != nullptr) {
+      release_block(&block);
+      continue;
+    }
+    const size_t block_size = static_cast<size_t>(handle.size()) + kBlockTrailerSize;
+    handles_to_read.push_back(handle);
+    buffers.emplace_back(new char[block_size]);
+    requests.emplace_back();
+    requests.back().offset = handle.offset();
+    requests.back().len = block_size;
+    requests.back().scratch = buffers.back().get();
+    PERF_COUNTER_ADD(block_read_count, 1);
+    PERF_COUNTER_ADD(block_read_byte, block_size);
+  }
+  if (requests.empty()) {
+    return Status::OK();
+  }
+
+  {
+    StopWatch sw(rep_->ioptions.env, statistics, READ_BLOCK_GET_MICROS);
+    PERF_TIMER_GUARD(block_read_time);
+    reader->reader->MultiRead(requests.data(), requests.size());
+  }
+
+  for (size_t i = 0; i != requests.size(); ++i) {
+    const auto& handle = handles_to_read[i];
+    const auto& request = requests[i];
+    RETURN_NOT_OK(request.status);
+    RETURN_NOT_OK(CheckBlock(rep_->footer, read_options, handle, request.result));
+    BlockContents contents;
+    RETURN_NOT_OK(BlockContentsFromReadData(
+        rep_->footer, handle, request.result, std::move(buffers[i]), &contents, rep_->mem_tracker,
+        block_cache_compressed == nullptr /* do_uncompress */, rep_->compression_dict_block.data));
+
+    prepare_cache_keys(handle);
+    CachableEntry<Block> block;
+    RETURN_NOT_OK(PutDataBlockToCache(
+        key, ckey, block_cache, block_cache_compressed, read_options, statistics, &block,
+        new Block(std::move(contents)), rep_->table_options.format_version,
+        rep_->compression_dict_block.data, BlockType::kData, rep_->mem_tracker));
+    release_block(&block);
+  }
+  return Status::OK();
+}
+
 Status BlockBasedTable::Prefetch(const Slice* const begin,
                                  const Slice* const end) {
   auto& comparator = *rep_->comparator;
@@ -1480,7 +1790,8 @@ bool BlockBasedTable::TEST_KeyInCache(const ReadOptions& options,
   Slice ckey;
 
   s = GetDataBlockFromCache(cache_key, ckey, block_cache, nullptr, nullptr, options, &block,
-      rep_->table_options.format_version, BlockType::kData, rep_->mem_tracker);
+      rep_->table_options.format_version, rep_->compression_dict_block.data, BlockType::kData,
+      rep_->mem_tracker);
   assert(s.ok());
   bool in_cache = block.value != nullptr;
   if (in_cache) {
@@ -1611,6 +1922,37 @@ uint64_t BlockBasedTable::ApproximateOffsetOf(const Slice& key) {
   return result;
 }
 
+Status BlockBasedTable::GetSampleKeys(size_t max_keys, std::vector<std::string>* keys) {
+  const uint64_t num_data_blocks =
+      rep_->table_properties ? rep_->table_properties->num_data_blocks : 0;
+  if (max_keys == 0 || num_data_blocks <= 1) {
+    return Status::OK();
+  }
+  // Take every step-th block boundary, so samples split the table into max_keys + 1 parts.
+  const uint64_t step = std::max<uint64_t>(num_data_blocks / (max_keys + 1), 1);
+
+  ReadOptions read_options;
+  read_options.fill_cache = false;
+  unique_ptr<InternalIterator> index_iter(NewIndexIterator(read_options));
+  unique_ptr<InternalIterator> data_iter(NewIterator(read_options));
+  size_t added = 0;
+  uint64_t block_idx = 0;
+  for (index_iter->SeekToFirst(); index_iter->Valid() && added < max_keys; index_iter->Next()) {
+    if (++block_idx % step != 0 || block_idx == num_data_blocks) {
+      continue;
+    }
+    // Index keys are separators that could be absent in the table, seek to the real one.
+    data_iter->Seek(index_iter->key());
+    if (!data_iter->Valid()) {
+      break;
+    }
+    keys->push_back(data_iter->key().ToString());
+    ++added;
+  }
+  RETURN_NOT_OK(index_iter->status());
+  return data_iter->status();
+}
+
 bool BlockBasedTable::TEST_filter_block_preloaded() const {
   return rep_->filter != nullptr;
 }
@@ -45,6 +45,7 @@ class Block;
 class BlockIter;
 class BlockHandle;
 class Cache;
+class FilePrefetchBuffer;
 class FilterBlockReader;
 class BlockBasedFilterBlockReader;
 class FullFilterBlockReader;
@@ -139,6 +140,10 @@ class BlockBasedTable : public TableReader {
 
   bool PrefixMayMatch(const Slice& internal_key);
 
+  // Checks the boundaries of the data block referenced by index_value against the filter. Returns
+  // true when the table has no boundaries for the block.
+  bool BlockMayMatch(const ReadBlockFilter& filter, const Slice& index_value);
+
   // Returns a new iterator over the table contents.
   // The result of NewIterator() is initially invalid (caller must
   // call one of the Seek methods on the iterator before using it).
@@ -151,6 +156,9 @@ class BlockBasedTable : public TableReader {
   Status Get(const ReadOptions& readOptions, const Slice& key,
              GetContext* get_context, bool skip_filters = false) override;
 
+  Status PrefetchKeys(const ReadOptions& read_options,
+                      const std::vector<Slice>& internal_keys) override;
+
   // Pre-fetch the disk blocks that correspond to the key range specified by
   // (kbegin, kend). The call will return return error status in the event of
   // IO or iteration error.
@@ -164,6 +172,13 @@ class BlockBasedTable : public TableReader {
   // be close to the file length.
   uint64_t ApproximateOffsetOf(const Slice& key) override;
 
+  // Samples are taken at data block boundaries found in the index, each index separator is
+  // replaced with the first key following it, so only the sampled data blocks are read.
+  Status GetSampleKeys(size_t max_keys, std::vector<std::string>* keys) override;
+
+  // Loads the data index and all filter blocks, including every fixed-size filter block.
+  Status WarmUpBlockCache() override;
+
   // Returns true if the block for the specified key is in cache.
   // REQUIRES: key is in this table && block cache enabled
   bool TEST_KeyInCache(const ReadOptions& options, const Slice& key);
@@ -180,9 +195,10 @@ class BlockBasedTable : public TableReader {
   Status DumpTable(WritableFile* out_file) override;
 
   // input_iter: if it is not null, update this one and return it as Iterator
+  // prefetch_buffer: if it is not null, blocks missing in the block cache are read through it
   InternalIterator* NewDataBlockIterator(
       const ReadOptions& ro, const Slice& index_value, BlockType block_type,
-      BlockIter* input_iter = nullptr);
+      BlockIter* input_iter = nullptr, FilePrefetchBuffer* prefetch_buffer = nullptr);
 
   const ImmutableCFOptions& ioptions();
 
@@ -223,6 +239,13 @@ class BlockBasedTable : public TableReader {
                                              bool no_io = false,
                                              const Slice* filter_key = nullptr) const;
 
+  // Returns filter block with the specified handle from the block cache. If it is not present in
+  // the cache and `no_io == false`, reads it from the file and adds to the cache.
+  // REQUIRES: filter policy is set and block cache is enabled.
+  CachableEntry<FilterBlockReader> GetFilterBlock(const BlockHandle& filter_block_handle,
+                                                  const QueryId query_id,
+                                                  bool no_io) const;
+
   // Get the iterator from the index reader.
   // If input_iter is not set, return new Iterator
   // If input_iter is set, update it and return:
@@ -247,7 +270,7 @@ class BlockBasedTable : public TableReader {
       const Slice& block_cache_key, const Slice& compressed_block_cache_key,
       Cache* block_cache, Cache* block_cache_compressed, Statistics* statistics,
       const ReadOptions& read_options, BlockBasedTable::CachableEntry<Block>* block,
-      uint32_t format_version, BlockType block_type,
+      uint32_t format_version, const Slice& compression_dict, BlockType block_type,
       const std::shared_ptr<yb::MemTracker>& mem_tracker);
 
   // Put a raw block (maybe compressed) to the corresponding block caches.
@@ -263,6 +286,7 @@ class BlockBasedTable : public TableReader {
       Cache* block_cache, Cache* block_cache_compressed,
       const ReadOptions& read_options, Statistics* statistics,
       CachableEntry<Block>* block, Block* raw_block, uint32_t format_version,
+      const Slice& compression_dict, BlockType block_type,
       const std::shared_ptr<yb::MemTracker>& mem_tracker);
 
   // Calls (*handle_result)(arg, ...) repeatedly, starting with the entry found
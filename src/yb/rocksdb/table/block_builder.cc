@@ -44,6 +44,25 @@
 //     restarts: uint32[num_restarts]
 //     num_restarts: uint32
 // restarts[i] contains the offset within the block of the ith restart point.
+// A block with a hash index also stores it before num_restarts, see data_block_hash_index.h.
+//
+// With KeyValueEncodingFormat::kKeyDeltaEncodingThreeSharedParts an entry has the form:
+//     shared_prefix_bytes: varint32
+//     non_shared_1_bytes: varint32
+//     shared_middle_bytes: varint32
+//     non_shared_2_bytes: varint32
+//     value_length: varint32
+//     internal_suffix_delta: zigzag varint64, only present unless the entry is a full entry
+//     non_shared_1: char[non_shared_1_bytes]
+//     non_shared_2: char[non_shared_2_bytes]
+//     value: char[value_length]
+// The user key part (key without the 8-byte internal suffix) is restored as
+//     prev_user_key[0, shared_prefix_bytes) + non_shared_1 +
+//     prev_user_key[shared_prefix_bytes + non_shared_1_bytes, +shared_middle_bytes) + non_shared_2
+// and the internal suffix as the previous one plus internal_suffix_delta.
+// An entry with zero shared_prefix_bytes, shared_middle_bytes and non_shared_2_bytes is a full
+// entry: non_shared_1 holds the whole key as is. Restart points always use full entries, so binary
+// search could compare against restart keys in place.
 
 #include "yb/rocksdb/table/block_builder.h"
 
@@ -57,12 +76,27 @@
 
 namespace rocksdb {
 
-BlockBuilder::BlockBuilder(int block_restart_interval, bool use_delta_encoding)
+namespace {
+
+// Shared middle part is only used when it saves more than its header overhead.
+constexpr size_t kMinSharedMiddleSize = 3;
+
+inline uint64_t ZigZagEncode64(int64_t value) {
+  return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+}
+
+} // namespace
+
+BlockBuilder::BlockBuilder(int block_restart_interval, bool use_delta_encoding,
+                           KeyValueEncodingFormat key_value_encoding_format,
+                           const SliceTransform* hash_index_key_extractor)
     : block_restart_interval_(block_restart_interval),
       use_delta_encoding_(use_delta_encoding),
+      key_value_encoding_format_(key_value_encoding_format),
       restarts_(),
       counter_(0),
-      finished_(false) {
+      finished_(false),
+      hash_index_builder_(hash_index_key_extractor) {
   assert(block_restart_interval_ >= 1);
   restarts_.push_back(0);       // First restart point is at offset 0
 }
@@ -74,6 +108,7 @@ void BlockBuilder::Reset() {
   counter_ = 0;
   finished_ = false;
   last_key_.clear();
+  hash_index_builder_.Reset();
 }
 
 size_t BlockBuilder::CurrentSizeEstimate() const {
@@ -82,6 +117,7 @@ size_t BlockBuilder::CurrentSizeEstimate() const {
     // Restarts haven't been flushed to buffer yet.
     size += restarts_.size() * sizeof(uint32_t) +    // Restart array.
             sizeof(uint32_t);                        // Restart array length.
+    size += hash_index_builder_.EstimateSize();
   }
   return size;
 }
@@ -95,6 +131,9 @@ size_t BlockBuilder::EstimateSizeAfterKV(const Slice& key, const Slice& value)
   }
 
   estimate += sizeof(int32_t); // varint for shared prefix length.
+  if (key_value_encoding_format_ == KeyValueEncodingFormat::kKeyDeltaEncodingThreeSharedParts) {
+    estimate += 2 * sizeof(int32_t); // varints for shared middle and second non-shared lengths.
+  }
   estimate += VarintLength(key.size()); // varint for key length.
   estimate += VarintLength(value.size()); // varint for value length.
 
@@ -110,7 +149,12 @@ Slice BlockBuilder::Finish() {
   for (size_t i = 0; i < restarts_.size(); i++) {
     PutFixed32(&buffer_, restarts_[i]);
   }
-  PutFixed32(&buffer_, static_cast<uint32_t>(restarts_.size()));
+  uint32_t num_restarts = static_cast<uint32_t>(restarts_.size());
+  if (hash_index_builder_.enabled() && hash_index_builder_.Valid(restarts_.size())) {
+    hash_index_builder_.Finish(&buffer_);
+    num_restarts |= kDataBlockHashIndexFlag;
+  }
+  PutFixed32(&buffer_, num_restarts);
   finished_ = true;
   return Slice(buffer_);
 }
@@ -120,10 +164,16 @@ void BlockBuilder::Add(const Slice& key, const Slice& value) {
   assert(!finished_);
   assert(counter_ <= block_restart_interval_);
   size_t shared = 0;  // number of bytes shared with prev key
+  bool restart = false;
   if (counter_ >= block_restart_interval_) {
     // Restart compression
     restarts_.push_back(static_cast<uint32_t>(buffer_.size()));
     counter_ = 0;
+    restart = true;
+  } else if (use_delta_encoding_ &&
+             key_value_encoding_format_ ==
+                 KeyValueEncodingFormat::kKeyDeltaEncodingThreeSharedParts) {
+    // Handled below.
   } else if (use_delta_encoding_) {
     // See how much sharing to do with previous string
     const size_t min_length = std::min(last_key_piece.size(), key.size());
@@ -131,6 +181,14 @@ void BlockBuilder::Add(const Slice& key, const Slice& value) {
       shared++;
     }
   }
+  if (hash_index_builder_.enabled()) {
+    hash_index_builder_.Add(key, static_cast<uint32_t>(restarts_.size() - 1));
+  }
+  if (use_delta_encoding_ &&
+      key_value_encoding_format_ == KeyValueEncodingFormat::kKeyDeltaEncodingThreeSharedParts) {
+    AddWithThreeSharedParts(key, value, restart || buffer_.empty());
+    return;
+  }
   const size_t non_shared = key.size() - shared;
 
   // Add "<shared><non_shared><value_size>" to buffer_
@@ -149,4 +207,66 @@ void BlockBuilder::Add(const Slice& key, const Slice& value) {
   counter_++;
 }
 
+void BlockBuilder::AddWithThreeSharedParts(const Slice& key, const Slice& value, bool restart) {
+  const Slice prev_key(last_key_);
+  size_t shared_prefix = 0;
+  size_t non_shared_1 = key.size();
+  size_t shared_middle = 0;
+  size_t non_shared_2 = 0;
+  if (!restart && key.size() >= kLastInternalComponentSize &&
+      prev_key.size() >= kLastInternalComponentSize) {
+    const size_t user_key_size = key.size() - kLastInternalComponentSize;
+    const size_t prev_user_key_size = prev_key.size() - kLastInternalComponentSize;
+    const size_t min_length = std::min(user_key_size, prev_user_key_size);
+    while (shared_prefix < min_length && prev_key[shared_prefix] == key[shared_prefix]) {
+      ++shared_prefix;
+    }
+    non_shared_1 = user_key_size - shared_prefix;
+    // The middle part is only looked for when the rest of keys have the same size, which is the
+    // case for DocDB keys that differ in a column id and a write id of the same hybrid time.
+    if (user_key_size == prev_user_key_size) {
+      size_t best_start = 0;
+      size_t best_size = 0;
+      size_t run_start = shared_prefix;
+      for (size_t i = shared_prefix; i <= user_key_size; ++i) {
+        if (i == user_key_size || key[i] != prev_key[i]) {
+          if (i - run_start > best_size) {
+            best_start = run_start;
+            best_size = i - run_start;
+          }
+          run_start = i + 1;
+        }
+      }
+      if (best_size >= kMinSharedMiddleSize) {
+        non_shared_1 = best_start - shared_prefix;
+        shared_middle = best_size;
+        non_shared_2 = user_key_size - best_start - best_size;
+      }
+    }
+  }
+
+  const bool full_entry = shared_prefix == 0 && shared_middle == 0 && non_shared_2 == 0;
+  if (full_entry) {
+    non_shared_1 = key.size();
+  }
+
+  PutVarint32(&buffer_, static_cast<uint32_t>(shared_prefix));
+  PutVarint32(&buffer_, static_cast<uint32_t>(non_shared_1));
+  PutVarint32(&buffer_, static_cast<uint32_t>(shared_middle));
+  PutVarint32(&buffer_, static_cast<uint32_t>(non_shared_2));
+  PutVarint32(&buffer_, static_cast<uint32_t>(value.size()));
+  if (!full_entry) {
+    const uint64_t suffix = DecodeFixed64(key.cend() - kLastInternalComponentSize);
+    const uint64_t prev_suffix = DecodeFixed64(prev_key.cend() - kLastInternalComponentSize);
+    PutVarint64(&buffer_, ZigZagEncode64(static_cast<int64_t>(suffix - prev_suffix)));
+  }
+  const size_t non_shared_2_start = shared_prefix + non_shared_1 + shared_middle;
+  buffer_.append(key.cdata() + shared_prefix, non_shared_1);
+  buffer_.append(key.cdata() + non_shared_2_start, non_shared_2);
+  buffer_.append(value.cdata(), value.size());
+
+  last_key_.assign(key.cdata(), key.size());
+  counter_++;
+}
+
 }  // namespace rocksdb
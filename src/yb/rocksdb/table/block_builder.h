@@ -26,6 +26,9 @@
 
 #include <stdint.h>
 #include <vector>
+
+#include "yb/rocksdb/table.h"
+#include "yb/rocksdb/table/data_block_hash_index.h"
 #include "yb/util/slice.h"
 
 namespace rocksdb {
@@ -35,8 +38,13 @@ class BlockBuilder {
   BlockBuilder(const BlockBuilder&) = delete;
   void operator=(const BlockBuilder&) = delete;
 
+  // When hash_index_key_extractor is not null, the block gets a hash index of the prefixes of its
+  // user keys, see DataBlockHashIndex. Keys are internal keys then.
   explicit BlockBuilder(int block_restart_interval,
-                        bool use_delta_encoding = true);
+                        bool use_delta_encoding = true,
+                        KeyValueEncodingFormat key_value_encoding_format =
+                            KeyValueEncodingFormat::kKeyDeltaEncodingSharedPrefix,
+                        const SliceTransform* hash_index_key_extractor = nullptr);
 
   // Reset the contents as if the BlockBuilder was just constructed.
   void Reset();
@@ -59,20 +67,27 @@ class BlockBuilder {
 
   size_t NumKeys() const;
 
+  KeyValueEncodingFormat key_value_encoding_format() const { return key_value_encoding_format_; }
+
   // Return true iff no entries have been added since the last Reset()
   bool empty() const {
     return buffer_.empty();
   }
 
  private:
+  // Appends entry for key using kKeyDeltaEncodingThreeSharedParts.
+  void AddWithThreeSharedParts(const Slice& key, const Slice& value, bool restart);
+
   const int          block_restart_interval_;
   const bool         use_delta_encoding_;
+  const KeyValueEncodingFormat key_value_encoding_format_;
 
   std::string           buffer_;    // Destination buffer
   std::vector<uint32_t> restarts_;  // Restart points
   int                   counter_;   // Number of entries emitted since restart
   bool                  finished_;  // Has Finish() been called?
   std::string           last_key_;
+  DataBlockHashIndexBuilder hash_index_builder_;
 };
 
 }  // namespace rocksdb
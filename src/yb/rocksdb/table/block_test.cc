@@ -155,6 +155,165 @@ BlockContents GetBlockContents(std::unique_ptr<BlockBuilder> *builder,
   return contents;
 }
 
+// Generates sorted internal keys that look like DocDB keys: a row key, a column id, a hybrid time
+// shared by all columns of the row, a write id and the internal key suffix.
+void GenerateDocDBLikeKVs(std::vector<std::string> *keys, std::vector<std::string> *values,
+                          int num_rows, int num_columns) {
+  Random rnd(303);
+  for (int row = 0; row < num_rows; ++row) {
+    const std::string hybrid_time = RandomString(&rnd, 7);
+    for (int column = 0; column < num_columns; ++column) {
+      char buf[16];
+      snprintf(buf, sizeof(buf), "row%08d", row);
+      std::string key(buf);
+      key.push_back('S');
+      key.push_back(static_cast<char>(column + 10));
+      key.push_back('#');
+      key += hybrid_time;
+      key.push_back(static_cast<char>(0x80 - column));
+      PutFixed64(&key, PackSequenceAndType(1000 + rnd.Uniform(100), kTypeValue));
+      keys->push_back(std::move(key));
+      values->emplace_back(RandomString(&rnd, 10));
+    }
+  }
+}
+
+void CheckThreeSharedPartsEncoding(const std::vector<std::string>& keys,
+                                   const std::vector<std::string>& values) {
+  const auto format = KeyValueEncodingFormat::kKeyDeltaEncodingThreeSharedParts;
+  BlockBuilder builder(16, true /* use_delta_encoding */, format);
+  for (size_t i = 0; i < keys.size(); i++) {
+    builder.Add(keys[i], values[i]);
+  }
+  BlockContents contents;
+  contents.data = builder.Finish();
+  contents.cachable = false;
+  Block reader(std::move(contents));
+
+  std::unique_ptr<InternalIterator> iter(
+      reader.NewIterator(BytewiseComparator(), nullptr, true /* total_order_seek */, format));
+  size_t count = 0;
+  for (iter->SeekToFirst(); iter->Valid(); count++, iter->Next()) {
+    ASSERT_EQ(keys[count], iter->key().ToString());
+    ASSERT_EQ(values[count], iter->value().ToString());
+  }
+  ASSERT_OK(iter->status());
+  ASSERT_EQ(keys.size(), count);
+
+  for (iter->SeekToLast(); iter->Valid(); iter->Prev()) {
+    --count;
+    ASSERT_EQ(keys[count], iter->key().ToString());
+  }
+  ASSERT_EQ(0, count);
+
+  Random rnd(301);
+  for (size_t i = 0; i < keys.size(); i++) {
+    const size_t index = rnd.Uniform(static_cast<int>(keys.size()));
+    iter->Seek(keys[index]);
+    ASSERT_TRUE(iter->Valid());
+    ASSERT_EQ(keys[index], iter->key().ToString());
+    ASSERT_EQ(values[index], iter->value().ToString());
+  }
+}
+
+TEST_F(BlockTest, ThreeSharedPartsEncoding) {
+  {
+    std::vector<std::string> keys;
+    std::vector<std::string> values;
+    GenerateRandomKVs(&keys, &values, 0, 10000);
+    CheckThreeSharedPartsEncoding(keys, values);
+  }
+
+  std::vector<std::string> keys;
+  std::vector<std::string> values;
+  GenerateDocDBLikeKVs(&keys, &values, 2000, 5);
+  CheckThreeSharedPartsEncoding(keys, values);
+
+  BlockBuilder shared_prefix_builder(16);
+  BlockBuilder three_shared_parts_builder(
+      16, true /* use_delta_encoding */, KeyValueEncodingFormat::kKeyDeltaEncodingThreeSharedParts);
+  for (size_t i = 0; i < keys.size(); i++) {
+    shared_prefix_builder.Add(keys[i], values[i]);
+    three_shared_parts_builder.Add(keys[i], values[i]);
+  }
+  const size_t shared_prefix_size = shared_prefix_builder.Finish().size();
+  const size_t three_shared_parts_size = three_shared_parts_builder.Finish().size();
+  LOG(INFO) << "Shared prefix block size: " << shared_prefix_size
+            << ", three shared parts block size: " << three_shared_parts_size;
+  ASSERT_LT(three_shared_parts_size, shared_prefix_size * 8 / 10);
+}
+
+// Builds a data block of the keys with the given restart interval and hash index key extractor.
+std::string BuildDataBlock(const std::vector<std::string>& keys, int restart_interval,
+                           const SliceTransform* hash_index_key_extractor) {
+  BlockBuilder builder(
+      restart_interval, true /* use_delta_encoding */,
+      KeyValueEncodingFormat::kKeyDeltaEncodingSharedPrefix, hash_index_key_extractor);
+  for (const auto& key : keys) {
+    builder.Add(key, "value");
+  }
+  return builder.Finish().ToBuffer();
+}
+
+std::string DataBlockHashIndexKey(int row, char version) {
+  char buf[16];
+  snprintf(buf, sizeof(buf), "row%08d", row);
+  std::string key(buf);
+  key.push_back(version);
+  PutFixed64(&key, PackSequenceAndType(1, kTypeValue));
+  return key;
+}
+
+TEST_F(BlockTest, DataBlockHashIndex) {
+  // Rows have 3 versions at even positions and odd rows are missing, so seeks could target keys of
+  // missing rows and missing versions of existing rows.
+  constexpr int kNumRows = 500;
+  std::unique_ptr<const SliceTransform> extractor(NewFixedPrefixTransform(11));
+  std::vector<std::string> keys;
+  for (int row = 0; row < kNumRows; row += 2) {
+    for (char version : {'2', '4', '6'}) {
+      keys.push_back(DataBlockHashIndexKey(row, version));
+    }
+  }
+
+  const std::string plain_data = BuildDataBlock(keys, 16, nullptr);
+  const std::string indexed_data = BuildDataBlock(keys, 16, extractor.get());
+  ASSERT_GT(indexed_data.size(), plain_data.size());
+  // The index is not stored when there are more restarts than it supports.
+  ASSERT_EQ(BuildDataBlock(keys, 1, nullptr).size(),
+            BuildDataBlock(keys, 1, extractor.get()).size());
+
+  BlockContents contents;
+  contents.data = indexed_data;
+  contents.cachable = false;
+  Block block(std::move(contents));
+  // Readers without the extractor ignore the index.
+  std::unique_ptr<InternalIterator> expected_iter(block.NewIterator(BytewiseComparator()));
+  std::unique_ptr<InternalIterator> iter(block.NewIterator(
+      BytewiseComparator(), nullptr /* iter */, true /* total_order_seek */,
+      KeyValueEncodingFormat::kKeyDeltaEncodingSharedPrefix, extractor.get()));
+
+  size_t count = 0;
+  for (expected_iter->SeekToFirst(); expected_iter->Valid(); expected_iter->Next()) {
+    ASSERT_EQ(keys[count], expected_iter->key().ToString());
+    ++count;
+  }
+  ASSERT_EQ(keys.size(), count);
+
+  for (int row = 0; row <= kNumRows; ++row) {
+    for (char version = '1'; version <= '7'; ++version) {
+      const auto target = DataBlockHashIndexKey(row, version);
+      expected_iter->Seek(target);
+      iter->Seek(target);
+      ASSERT_OK(iter->status());
+      ASSERT_EQ(expected_iter->Valid(), iter->Valid()) << row << ", " << version;
+      if (expected_iter->Valid()) {
+        ASSERT_EQ(expected_iter->key().ToString(), iter->key().ToString());
+      }
+    }
+  }
+}
+
 void CheckBlockContents(BlockContents contents, const int max_key,
                         const std::vector<std::string> &keys,
                         const std::vector<std::string> &values) {
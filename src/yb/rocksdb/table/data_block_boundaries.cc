@@ -0,0 +1,121 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/rocksdb/table/data_block_boundaries.h"
+
+#include <algorithm>
+
+#include "yb/rocksdb/util/coding.h"
+
+namespace rocksdb {
+
+const char kDataBlockBoundariesBlock[] = "rocksdb.data_block_boundaries";
+
+void DataBlockBoundariesBuilder::Add(const UserBoundaryValues& values) {
+  if (current_empty_) {
+    current_empty_ = false;
+    for (const auto& value : values) {
+      current_.push_back(TagBoundaries{value->Tag(), value, value});
+    }
+    return;
+  }
+  // Drops tags missing from the key and widens the others.
+  auto it = current_.begin();
+  while (it != current_.end()) {
+    auto value = UserValueWithTag(values, it->tag);
+    if (!value) {
+      it = current_.erase(it);
+      continue;
+    }
+    if (it->smallest->CompareTo(*value) > 0) {
+      it->smallest = value;
+    } else if (it->largest->CompareTo(*value) < 0) {
+      it->largest = std::move(value);
+    }
+    ++it;
+  }
+}
+
+void DataBlockBoundariesBuilder::FinishBlock(uint64_t offset) {
+  if (!current_.empty()) {
+    PutVarint64(&buffer_, offset);
+    PutVarint32(&buffer_, static_cast<uint32_t>(current_.size()));
+    for (const auto& boundaries : current_) {
+      PutVarint32(&buffer_, boundaries.tag);
+      PutLengthPrefixedSlice(&buffer_, boundaries.smallest->Encode());
+      PutLengthPrefixedSlice(&buffer_, boundaries.largest->Encode());
+    }
+  }
+  current_.clear();
+  current_empty_ = true;
+}
+
+Status DataBlockBoundariesReader::Init(const Slice& contents) {
+  contents_ = contents;
+  entries_.clear();
+  Slice input = contents;
+  while (!input.empty()) {
+    uint64_t offset;
+    if (!GetVarint64(&input, &offset)) {
+      return STATUS(Corruption, "Bad data block offset in data block boundaries");
+    }
+    if (!entries_.empty() && entries_.back().first >= offset) {
+      return STATUS_FORMAT(Corruption, "Data block boundaries out of order: $0 after $1",
+                           offset, entries_.back().first);
+    }
+    entries_.emplace_back(offset, static_cast<uint32_t>(input.cdata() - contents.cdata()));
+    uint32_t num_values;
+    if (!GetVarint32(&input, &num_values)) {
+      return STATUS(Corruption, "Bad number of values in data block boundaries");
+    }
+    for (uint32_t i = 0; i != num_values; ++i) {
+      uint32_t tag;
+      Slice smallest, largest;
+      if (!GetVarint32(&input, &tag) || !GetLengthPrefixedSlice(&input, &smallest) ||
+          !GetLengthPrefixedSlice(&input, &largest)) {
+        return STATUS_FORMAT(Corruption, "Bad value in data block boundaries at $0", offset);
+      }
+    }
+  }
+  entries_.shrink_to_fit();
+  return Status::OK();
+}
+
+bool DataBlockBoundariesReader::Find(uint64_t offset, DataBlockBoundaries* boundaries) const {
+  auto it = std::lower_bound(
+      entries_.begin(), entries_.end(), offset,
+      [](const std::pair<uint64_t, uint32_t>& entry, uint64_t value) {
+        return entry.first < value;
+      });
+  if (it == entries_.end() || it->first != offset) {
+    return false;
+  }
+  boundaries->smallest.values_.clear();
+  boundaries->largest.values_.clear();
+  // Entries were validated by Init.
+  Slice input(contents_.cdata() + it->second, contents_.cend());
+  uint32_t num_values = 0;
+  GetVarint32(&input, &num_values);
+  for (uint32_t i = 0; i != num_values; ++i) {
+    uint32_t tag = 0;
+    Slice smallest, largest;
+    GetVarint32(&input, &tag);
+    GetLengthPrefixedSlice(&input, &smallest);
+    GetLengthPrefixedSlice(&input, &largest);
+    boundaries->smallest.values_.emplace_back(tag, smallest);
+    boundaries->largest.values_.emplace_back(tag, largest);
+  }
+  return true;
+}
+
+}  // namespace rocksdb
@@ -0,0 +1,118 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#ifndef YB_ROCKSDB_TABLE_DATA_BLOCK_BOUNDARIES_H
+#define YB_ROCKSDB_TABLE_DATA_BLOCK_BOUNDARIES_H
+
+#include <stdint.h>
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <boost/container/small_vector.hpp>
+
+#include "yb/rocksdb/metadata.h"
+
+#include "yb/util/slice.h"
+#include "yb/util/status.h"
+
+namespace rocksdb {
+
+// Name of the meta block with the boundaries of the data blocks, see
+// BlockBasedTableOptions::store_data_block_boundaries.
+extern const char kDataBlockBoundariesBlock[];
+
+// Smallest or largest encoded user values of the keys of a data block. Has the same interface to
+// user values as the boundaries of a file in FdWithBoundaries, so filters could check both.
+class DataBlockUserValues {
+ public:
+  const Slice* user_value_with_tag(UserBoundaryTag tag) const {
+    for (const auto& value : values_) {
+      if (value.first == tag) {
+        return &value.second;
+      }
+    }
+    return nullptr;
+  }
+
+ private:
+  friend class DataBlockBoundariesReader;
+
+  boost::container::small_vector<std::pair<UserBoundaryTag, Slice>, 10> values_;
+};
+
+struct DataBlockBoundaries {
+  DataBlockUserValues smallest;
+  DataBlockUserValues largest;
+};
+
+// Collects the smallest and largest user values of the keys of each data block, as extracted by
+// the BoundaryValuesExtractor of the DB. Only tags present in every key of a block are stored for
+// it, so a filter could rely on them for each key of the block.
+//
+// The meta block has an entry for each data block with boundaries:
+//     offset: varint64, offset of the data block in the data file
+//     num_values: varint32
+//     num_values times:
+//         tag: varint32
+//         smallest: varint32 length prefixed encoded value
+//         largest: varint32 length prefixed encoded value
+// Entries are in the order of the data blocks.
+class DataBlockBoundariesBuilder {
+ public:
+  // Updates the boundaries of the current data block with the user values of a key added to it.
+  void Add(const UserBoundaryValues& values);
+
+  // Appends the entry of the current data block, written at the given offset, and starts the next
+  // data block.
+  void FinishBlock(uint64_t offset);
+
+  bool empty() const { return buffer_.empty(); }
+
+  const std::string& contents() const { return buffer_; }
+
+ private:
+  struct TagBoundaries {
+    UserBoundaryTag tag;
+    UserBoundaryValuePtr smallest;
+    UserBoundaryValuePtr largest;
+  };
+
+  std::vector<TagBoundaries> current_;
+  bool current_empty_ = true;
+  std::string buffer_;
+};
+
+class DataBlockBoundariesReader {
+ public:
+  // Parses the meta block, contents should outlive the reader.
+  CHECKED_STATUS Init(const Slice& contents);
+
+  // Fills boundaries of the data block at the given offset. Returns false if nothing is stored for
+  // the block.
+  bool Find(uint64_t offset, DataBlockBoundaries* boundaries) const;
+
+  size_t ApproximateMemoryUsage() const {
+    return sizeof(*this) + entries_.capacity() * sizeof(entries_[0]);
+  }
+
+ private:
+  Slice contents_;
+  // Offset of each data block with the position of its values in contents_.
+  std::vector<std::pair<uint64_t, uint32_t>> entries_;
+};
+
+}  // namespace rocksdb
+
+#endif // YB_ROCKSDB_TABLE_DATA_BLOCK_BOUNDARIES_H
@@ -0,0 +1,103 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/rocksdb/table/data_block_hash_index.h"
+
+#include "yb/rocksdb/db/dbformat.h"
+#include "yb/rocksdb/slice_transform.h"
+#include "yb/rocksdb/util/coding.h"
+#include "yb/rocksdb/util/hash.h"
+
+namespace rocksdb {
+
+namespace {
+
+constexpr uint32_t kHashSeed = 0x6a1b3c2d;
+
+} // namespace
+
+constexpr uint8_t DataBlockHashIndex::kNoEntry;
+constexpr uint8_t DataBlockHashIndex::kCollision;
+constexpr uint8_t DataBlockHashIndex::kMaxRestartIndex;
+
+void DataBlockHashIndexBuilder::Add(const Slice& internal_key, uint32_t restart_index) {
+  const Slice user_key = ExtractUserKey(internal_key);
+  if (!key_extractor_->InDomain(user_key)) {
+    return;
+  }
+  const Slice prefix = key_extractor_->Transform(user_key);
+  if (!prefixes_.empty() && prefix == Slice(last_prefix_)) {
+    return;
+  }
+  prefixes_.emplace_back(DataBlockHashIndex::HashPrefix(prefix), restart_index);
+  last_prefix_.assign(prefix.cdata(), prefix.size());
+}
+
+bool DataBlockHashIndexBuilder::Valid(size_t num_restarts) const {
+  return !prefixes_.empty() && num_restarts <= DataBlockHashIndex::kMaxRestartIndex + 1u;
+}
+
+size_t DataBlockHashIndexBuilder::NumBuckets() const {
+  // Keeps the load factor at about 0.75.
+  return prefixes_.size() * 4 / 3 + 1;
+}
+
+void DataBlockHashIndexBuilder::Finish(std::string* buffer) const {
+  const size_t num_buckets = NumBuckets();
+  std::vector<uint8_t> buckets(num_buckets, DataBlockHashIndex::kNoEntry);
+  for (const auto& hash_and_restart : prefixes_) {
+    auto& bucket = buckets[hash_and_restart.first % num_buckets];
+    const auto restart_index = static_cast<uint8_t>(hash_and_restart.second);
+    if (bucket == DataBlockHashIndex::kNoEntry) {
+      bucket = restart_index;
+    } else if (bucket != restart_index) {
+      // A seek could start from the restart interval of either prefix only if it is the same.
+      bucket = DataBlockHashIndex::kCollision;
+    }
+  }
+  buffer->append(reinterpret_cast<const char*>(buckets.data()), buckets.size());
+  PutFixed32(buffer, static_cast<uint32_t>(num_buckets));
+}
+
+size_t DataBlockHashIndexBuilder::EstimateSize() const {
+  return prefixes_.empty() ? 0 : NumBuckets() + sizeof(uint32_t);
+}
+
+void DataBlockHashIndexBuilder::Reset() {
+  prefixes_.clear();
+  last_prefix_.clear();
+}
+
+uint32_t DataBlockHashIndex::HashPrefix(const Slice& prefix) {
+  return Hash(prefix.cdata(), prefix.size(), kHashSeed);
+}
+
+bool DataBlockHashIndex::Initialize(const char* data, size_t* restarts_end) {
+  if (*restarts_end < sizeof(uint32_t)) {
+    return false;
+  }
+  const uint32_t num_buckets = DecodeFixed32(data + *restarts_end - sizeof(uint32_t));
+  if (num_buckets == 0 || num_buckets > *restarts_end - sizeof(uint32_t)) {
+    return false;
+  }
+  *restarts_end -= sizeof(uint32_t) + num_buckets;
+  buckets_ = reinterpret_cast<const uint8_t*>(data + *restarts_end);
+  num_buckets_ = num_buckets;
+  return true;
+}
+
+uint8_t DataBlockHashIndex::Lookup(const Slice& prefix) const {
+  return buckets_[HashPrefix(prefix) % num_buckets_];
+}
+
+}  // namespace rocksdb
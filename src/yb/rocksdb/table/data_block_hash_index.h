@@ -0,0 +1,101 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#ifndef YB_ROCKSDB_TABLE_DATA_BLOCK_HASH_INDEX_H
+#define YB_ROCKSDB_TABLE_DATA_BLOCK_HASH_INDEX_H
+
+#include <stdint.h>
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "yb/util/slice.h"
+
+namespace rocksdb {
+
+class SliceTransform;
+
+// Optional hash index of a data block, see BlockBasedTableOptions::data_block_hash_index. It maps
+// the prefixes of the user keys of the block, as extracted by the key extractor, to the restart
+// interval that contains the first key with the prefix, so a seek to a key with a prefix present in
+// the block starts the linear search from that restart point instead of binary searching the
+// restart array.
+//
+// The index is stored between the restart array and the number of restarts:
+//     restarts: uint32[num_restarts]
+//     buckets: uint8[num_buckets]
+//     num_buckets: uint32
+//     num_restarts: uint32, with kDataBlockHashIndexFlag set
+// Each bucket holds a restart index, or kNoEntry, or kCollision when prefixes whose first keys are
+// in different restart intervals have the same bucket.
+constexpr uint32_t kDataBlockHashIndexFlag = 1u << 31;
+
+class DataBlockHashIndexBuilder {
+ public:
+  // The index is only built when key_extractor is not null.
+  explicit DataBlockHashIndexBuilder(const SliceTransform* key_extractor)
+      : key_extractor_(key_extractor) {}
+
+  bool enabled() const { return key_extractor_ != nullptr; }
+
+  // Adds an internal key of the block, that belongs to the restart interval with the given index.
+  void Add(const Slice& internal_key, uint32_t restart_index);
+
+  // Whether the index could be stored in the block, i.e. it is not empty and every restart index
+  // fits into a bucket.
+  bool Valid(size_t num_restarts) const;
+
+  // Appends the buckets and their number to buffer.
+  void Finish(std::string* buffer) const;
+
+  size_t EstimateSize() const;
+
+  void Reset();
+
+ private:
+  size_t NumBuckets() const;
+
+  const SliceTransform* const key_extractor_;
+  // Hash of each prefix of the block with the restart interval of its first key.
+  std::vector<std::pair<uint32_t, uint32_t>> prefixes_;
+  std::string last_prefix_;
+};
+
+class DataBlockHashIndex {
+ public:
+  static constexpr uint8_t kNoEntry = 255;
+  static constexpr uint8_t kCollision = 254;
+  static constexpr uint8_t kMaxRestartIndex = 253;
+
+  static uint32_t HashPrefix(const Slice& prefix);
+
+  // Reads the index stored before *restarts_end in the block data, and moves *restarts_end to the
+  // start of the index. Returns false if the index is corrupted.
+  bool Initialize(const char* data, size_t* restarts_end);
+
+  bool valid() const { return num_buckets_ != 0; }
+
+  // Returns the restart index of the prefix, kNoEntry or kCollision.
+  uint8_t Lookup(const Slice& prefix) const;
+
+  size_t ApproximateMemoryUsage() const { return sizeof(*this); }
+
+ private:
+  const uint8_t* buckets_ = nullptr;
+  uint32_t num_buckets_ = 0;
+};
+
+}  // namespace rocksdb
+
+#endif // YB_ROCKSDB_TABLE_DATA_BLOCK_HASH_INDEX_H
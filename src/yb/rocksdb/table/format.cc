@@ -275,13 +275,18 @@ namespace {
 // According to the implementation of file->Read, contents may not point to buf
 Status ReadBlock(RandomAccessFileReader* file, const Footer& footer,
                  const ReadOptions& options, const BlockHandle& handle,
-                 Slice* contents, /* result of reading */ char* buf) {
+                 Slice* contents, /* result of reading */ char* buf,
+                 FilePrefetchBuffer* prefetch_buffer) {
   size_t n = static_cast<size_t>(handle.size());
   Status s;
 
   {
     PERF_TIMER_GUARD(block_read_time);
-    s = file->Read(handle.offset(), n + kBlockTrailerSize, contents, buf);
+    if (prefetch_buffer != nullptr) {
+      s = prefetch_buffer->Read(handle.offset(), n + kBlockTrailerSize, contents, buf);
+    } else {
+      s = file->Read(handle.offset(), n + kBlockTrailerSize, contents, buf);
+    }
   }
 
   PERF_COUNTER_ADD(block_read_count, 1);
@@ -290,12 +295,21 @@ Status ReadBlock(RandomAccessFileReader* file, const Footer& footer,
   if (!s.ok()) {
     return s;
   }
-  if (contents->size() != n + kBlockTrailerSize) {
+  return CheckBlock(footer, options, handle, *contents);
+}
+
+}  // namespace
+
+Status CheckBlock(const Footer& footer, const ReadOptions& options, const BlockHandle& handle,
+                  const Slice& contents) {
+  size_t n = static_cast<size_t>(handle.size());
+  Status s;
+  if (contents.size() != n + kBlockTrailerSize) {
     return STATUS(Corruption, "truncated block read");
   }
 
   // Check the crc of the type and the block contents
-  const char* data = contents->cdata();  // Pointer to where Read put the data
+  const char* data = contents.cdata();  // Pointer to where Read put the data
   if (options.verify_checksums) {
     PERF_TIMER_GUARD(block_checksum_time);
     uint32_t value = DecodeFixed32(data + n + 1);
@@ -321,8 +335,6 @@ Status ReadBlock(RandomAccessFileReader* file, const Footer& footer,
   return s;
 }
 
-}  // namespace
-
 TrackedAllocation::TrackedAllocation()
     : size_(0) {
 }
@@ -365,14 +377,14 @@ BlockContents::BlockContents(
 Status ReadBlockContents(RandomAccessFileReader* file, const Footer& footer,
                          const ReadOptions& options, const BlockHandle& handle,
                          BlockContents* contents, Env* env,
-                         const yb::MemTrackerPtr& mem_tracker, bool decompression_requested) {
+                         const yb::MemTrackerPtr& mem_tracker, bool decompression_requested,
+                         const Slice& compression_dict, FilePrefetchBuffer* prefetch_buffer) {
   Status status;
   Slice slice;
   size_t n = static_cast<size_t>(handle.size());
   std::unique_ptr<char[]> heap_buf;
   char stack_buf[DefaultStackBufferSize];
   char* used_buf = nullptr;
-  rocksdb::CompressionType compression_type;
 
   if (decompression_requested &&
       n + kBlockTrailerSize < DefaultStackBufferSize) {
@@ -384,32 +396,51 @@ Status ReadBlockContents(RandomAccessFileReader* file, const Footer& footer,
     used_buf = heap_buf.get();
   }
 
-  status = ReadBlock(file, footer, options, handle, &slice, used_buf);
+  status = ReadBlock(file, footer, options, handle, &slice, used_buf, prefetch_buffer);
 
   if (!status.ok()) {
     return status;
   }
 
+  // Compressed block is uncompressed to a new buffer, otherwise stack buffer should be moved to
+  // the heap.
+  if (slice.cdata() == &stack_buf[0] &&
+      static_cast<rocksdb::CompressionType>(slice.data()[n]) == kNoCompression) {
+    heap_buf = std::unique_ptr<char[]>(new char[n]);
+    memcpy(heap_buf.get(), stack_buf, n);
+    slice = Slice(heap_buf.get(), slice.size());
+  }
+
+  return BlockContentsFromReadData(
+      footer, handle, slice, std::move(heap_buf), contents, mem_tracker, decompression_requested,
+      compression_dict);
+}
+
+Status BlockContentsFromReadData(const Footer& footer, const BlockHandle& handle,
+                                 const Slice& data, std::unique_ptr<char[]> buf,
+                                 BlockContents* contents,
+                                 const yb::MemTrackerPtr& mem_tracker,
+                                 bool decompression_requested,
+                                 const Slice& compression_dict) {
+  size_t n = static_cast<size_t>(handle.size());
+
   PERF_TIMER_GUARD(block_decompress_time);
 
-  compression_type = static_cast<rocksdb::CompressionType>(slice.data()[n]);
+  rocksdb::CompressionType compression_type =
+      static_cast<rocksdb::CompressionType>(data.data()[n]);
 
   if (decompression_requested && compression_type != kNoCompression) {
-    return UncompressBlockContents(slice.cdata(), n, contents, footer.version(), mem_tracker);
-  }
-
-  if (slice.cdata() != used_buf) {
-    *contents = BlockContents(Slice(slice.data(), n), false, compression_type);
-    return status;
+    return UncompressBlockContents(data.cdata(), n, contents, footer.version(), mem_tracker,
+                                   compression_dict);
   }
 
-  if (used_buf == &stack_buf[0]) {
-    heap_buf = std::unique_ptr<char[]>(new char[n]);
-    memcpy(heap_buf.get(), stack_buf, n);
+  if (data.cdata() != buf.get()) {
+    *contents = BlockContents(Slice(data.data(), n), false, compression_type);
+    return Status::OK();
   }
 
-  *contents = BlockContents(std::move(heap_buf), n, true, compression_type, mem_tracker);
-  return status;
+  *contents = BlockContents(std::move(buf), n, true, compression_type, mem_tracker);
+  return Status::OK();
 }
 
 //
@@ -422,7 +453,8 @@ Status ReadBlockContents(RandomAccessFileReader* file, const Footer& footer,
 Status UncompressBlockContents(const char* data, size_t n,
                                BlockContents* contents,
                                uint32_t format_version,
-                               const std::shared_ptr<yb::MemTracker>& mem_tracker) {
+                               const std::shared_ptr<yb::MemTracker>& mem_tracker,
+                               const Slice& compression_dict) {
   std::unique_ptr<char[]> ubuf;
   int decompress_size = 0;
   assert(data[n] != kNoCompression);
@@ -489,9 +521,10 @@ Status UncompressBlockContents(const char* data, size_t n,
       *contents =
           BlockContents(std::move(ubuf), decompress_size, true, kNoCompression, mem_tracker);
       break;
+    case kZSTD:
     case kZSTDNotFinalCompression:
-      ubuf =
-          std::unique_ptr<char[]>(ZSTD_Uncompress(data, n, &decompress_size));
+      ubuf = std::unique_ptr<char[]>(
+          ZSTD_Uncompress(data, n, &decompress_size, compression_dict));
       if (!ubuf) {
         static char zstd_corrupt_msg[] =
             "ZSTD not supported or corrupted ZSTD compressed block contents";
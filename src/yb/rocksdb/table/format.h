@@ -40,6 +40,7 @@ class MemTracker;
 namespace rocksdb {
 
 class Block;
+class FilePrefetchBuffer;
 class RandomAccessFile;
 struct ReadOptions;
 
@@ -251,7 +252,24 @@ extern Status ReadBlockContents(RandomAccessFileReader* file,
                                 const BlockHandle& handle,
                                 BlockContents* contents, Env* env,
                                 const std::shared_ptr<yb::MemTracker>& mem_tracker,
-                                bool do_uncompress);
+                                bool do_uncompress,
+                                const Slice& compression_dict = Slice(),
+                                FilePrefetchBuffer* prefetch_buffer = nullptr);
+
+// Checks size and, if requested by options, checksum of the block identified by "handle",
+// given data read from the file, including the block trailer.
+extern Status CheckBlock(const Footer& footer, const ReadOptions& options,
+                         const BlockHandle& handle, const Slice& data);
+
+// Fills *contents from data of the block identified by "handle", read from the file and checked
+// with CheckBlock. buf should be the buffer where the data was read to, its ownership is moved to
+// *contents if the block is not uncompressed.
+extern Status BlockContentsFromReadData(const Footer& footer, const BlockHandle& handle,
+                                        const Slice& data, std::unique_ptr<char[]> buf,
+                                        BlockContents* contents,
+                                        const std::shared_ptr<yb::MemTracker>& mem_tracker,
+                                        bool do_uncompress,
+                                        const Slice& compression_dict = Slice());
 
 // The 'data' points to the raw block contents read in from file.
 // This method allocates a new heap buffer and the raw block
@@ -260,10 +278,12 @@ extern Status ReadBlockContents(RandomAccessFileReader* file,
 // free this buffer.
 // For description of compress_format_version and possible values, see
 // util/compression.h
+// compression_dict is the dictionary of the file the block belongs to, if any.
 extern Status UncompressBlockContents(const char* data, size_t n,
                                       BlockContents* contents,
                                       uint32_t compress_format_version,
-                                      const std::shared_ptr<yb::MemTracker>& mem_tracker);
+                                      const std::shared_ptr<yb::MemTracker>& mem_tracker,
+                                      const Slice& compression_dict = Slice());
 
 // Implementation details follow.  Clients should ignore,
 
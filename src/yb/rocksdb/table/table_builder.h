@@ -33,6 +33,7 @@
 #include "yb/util/status.h"
 
 #include "yb/rocksdb/db/table_properties_collector.h"
+#include "yb/rocksdb/metadata.h"
 
 #include "yb/util/slice.h"
 #include "yb/rocksdb/options.h"
@@ -102,6 +103,10 @@ class TableBuilder {
   // REQUIRES: Finish(), Abandon() have not been called
   virtual void Add(const Slice& key, const Slice& value) = 0;
 
+  // Passes the user values extracted by the BoundaryValuesExtractor of the DB from the key that was
+  // just added.
+  virtual void AddBoundaryValues(const UserBoundaryValues& values) {}
+
   // Return non-ok iff some error has been detected.
   virtual Status status() const = 0;
 
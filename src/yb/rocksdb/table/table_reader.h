@@ -76,6 +76,13 @@ class TableReader {
   // posix_fadvise
   virtual void SetupForCompaction() = 0;
 
+  // Appends to keys up to max_keys internal keys present in the table, approximately evenly
+  // spaced by data size. Used to choose key range boundaries without reading the whole table.
+  // Default implementation provides no samples.
+  virtual Status GetSampleKeys(size_t max_keys, std::vector<std::string>* keys) {
+    return Status::OK();
+  }
+
   virtual std::shared_ptr<const TableProperties> GetTableProperties() const = 0;
 
   // Prepare work that can be done before the real Get()
@@ -110,6 +117,23 @@ class TableReader {
     return Status::OK();
   }
 
+  // Loads to the block cache the data blocks where seeks to internal_keys (sorted by the table
+  // comparator) would start, skipping keys rejected by the bloom filter. Blocks missing in the
+  // cache are read from the file together, so that following point lookups of the same keys don't
+  // wait for each read separately.
+  // Default implementation is NOOP.
+  virtual Status PrefetchKeys(const ReadOptions& read_options,
+                              const std::vector<Slice>& internal_keys) {
+    return Status::OK();
+  }
+
+  // Loads the top-level index and filter blocks of the table, so that first reads after the table
+  // is opened don't have to wait for them.
+  // Default implementation is NOOP.
+  virtual Status WarmUpBlockCache() {
+    return Status::OK();
+  }
+
   // convert db file to a human readable form
   virtual Status DumpTable(WritableFile* out_file) {
     return STATUS(NotSupported, "DumpTable() not supported");
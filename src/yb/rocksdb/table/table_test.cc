@@ -298,7 +298,7 @@ class TableConstructor: public Constructor {
                             internal_comparator,
                             int_tbl_prop_collector_factories,
                             options.compression,
-                            CompressionOptions(),
+                            options.compression_opts,
                             /* skip_filters */ false),
         TablePropertiesCollectorFactory::Context::kUnknownColumnFamily,
         file_writer_.get()));
@@ -570,6 +570,8 @@ static std::vector<TestArgs> GenerateArgList() {
   if (ZSTD_Supported()) {
     compression_types.emplace_back(kZSTDNotFinalCompression, false);
     compression_types.emplace_back(kZSTDNotFinalCompression, true);
+    compression_types.emplace_back(kZSTD, false);
+    compression_types.emplace_back(kZSTD, true);
   }
 
   for (auto test_type : test_types) {
@@ -1570,6 +1572,48 @@ TEST_F(BlockBasedTableTest, NumBlockStat) {
             c.GetTableReader()->GetTableProperties()->num_data_blocks);
 }
 
+TEST_F(BlockBasedTableTest, ZSTDDictionaryCompression) {
+  if (!ZSTD_DictSupported()) {
+    fprintf(stderr, "skipping zstd dictionary compression test\n");
+    return;
+  }
+  Random rnd(301);
+  TableConstructor c(BytewiseComparator(), true /* convert_to_internal_key */);
+  Options options;
+  options.compression = kZSTD;
+  options.compression_opts.max_dict_bytes = 4096;
+  options.compression_opts.zstd_max_train_bytes = 64 * 1024;
+  BlockBasedTableOptions table_options;
+  table_options.block_size = 1024;
+  options.table_factory.reset(NewBlockBasedTableFactory(table_options));
+
+  // Keys and values sharing structure across blocks, so the dictionary is worth training.
+  for (int i = 0; i < 5000; ++i) {
+    char key[32];
+    snprintf(key, sizeof(key), "table_key_%08d", i);
+    c.Add(key, "column_value_" + RandomString(&rnd, 8) + "_shared_suffix_of_the_value");
+  }
+
+  std::vector<std::string> keys;
+  stl_wrappers::KVMap kvmap;
+  const ImmutableCFOptions ioptions(options);
+  c.Finish(options, ioptions, table_options,
+           GetPlainInternalComparator(options.comparator), &keys, &kvmap);
+  ASSERT_GT(c.GetTableReader()->GetTableProperties()->num_data_blocks, 100U);
+
+  // Blocks written before and after the dictionary was trained should be readable.
+  std::unique_ptr<InternalIterator> iter(c.NewIterator());
+  iter->SeekToFirst();
+  for (const auto& kv : kvmap) {
+    ASSERT_TRUE(iter->Valid());
+    ASSERT_EQ(kv.first, iter->key().ToString());
+    ASSERT_EQ(kv.second, iter->value().ToString());
+    iter->Next();
+  }
+  ASSERT_FALSE(iter->Valid());
+  ASSERT_OK(iter->status());
+}
+
 // A simple tool that takes the snapshot of block cache statistics.
 class BlockCachePropertiesSnapshot {
  public:
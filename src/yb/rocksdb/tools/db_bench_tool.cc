@@ -49,6 +49,7 @@
 
 #include <gflags/gflags.h>
 
+#include "yb/rocksdb/db_bench_tool.h"
 #include "yb/rocksdb/db/db_impl.h"
 #include "yb/rocksdb/db/version_set.h"
 #include "yb/rocksdb/options.h"
@@ -84,6 +85,11 @@
 #include <io.h>  // open/close
 #endif
 
+#ifdef DB_BENCH_WITH_DOCDB
+// DocDB defines this flag as the size of a memtable, with -1 meaning the default one.
+DECLARE_int64(db_write_buffer_size);
+#endif
+
 namespace {
 using GFLAGS::ParseCommandLineFlags;
 using GFLAGS::RegisterFlagValidator;
@@ -266,8 +272,10 @@ DEFINE_bool(enable_numa, false,
             "CPU and memory of same node. Use \"$numactl --hardware\" command "
             "to see NUMA memory architecture.");
 
+#ifndef DB_BENCH_WITH_DOCDB
 DEFINE_int64(db_write_buffer_size, rocksdb::Options().db_write_buffer_size,
              "Number of bytes to buffer in all memtables before compacting");
+#endif
 
 DEFINE_int64(write_buffer_size, rocksdb::Options().write_buffer_size,
              "Number of bytes to buffer in memtable before compacting");
@@ -546,7 +554,7 @@ enum rocksdb::CompressionType StringToCompressionType(const char* ctype) {
   else if (!strcasecmp(ctype, "lz4hc"))
     return rocksdb::kLZ4HCCompression;
   else if (!strcasecmp(ctype, "zstd"))
-    return rocksdb::kZSTDNotFinalCompression;
+    return rocksdb::kZSTD;
 
   fprintf(stdout, "Cannot parse compression type '%s'\n", ctype);
   return rocksdb::kSnappyCompression;  // default value
@@ -1585,6 +1593,7 @@ class Benchmark {
   int64_t merge_keys_;
   bool report_file_operations_;
   int cachedev_fd_;
+  DbBenchFormat* const format_;
 
   bool SanityCheck() {
     if (FLAGS_compression_ratio > 1) {
@@ -1617,6 +1626,7 @@ class Benchmark {
         ok = LZ4HC_Compress(Options().compression_opts, 2, input.cdata(),
                             input.size(), compressed);
         break;
+      case rocksdb::kZSTD:
       case rocksdb::kZSTDNotFinalCompression:
         ok = ZSTD_Compress(Options().compression_opts, input.cdata(),
                            input.size(), compressed);
@@ -1763,7 +1773,7 @@ class Benchmark {
   }
 
  public:
-  Benchmark()
+  explicit Benchmark(DbBenchFormat* format)
       : cache_(
             FLAGS_cache_size >= 0
                 ? (FLAGS_cache_numshardbits >= 1
@@ -1796,7 +1806,8 @@ class Benchmark {
                 : ((FLAGS_writes > FLAGS_reads) ? FLAGS_writes : FLAGS_reads)),
         merge_keys_(FLAGS_merge_keys < 0 ? FLAGS_num : FLAGS_merge_keys),
         report_file_operations_(FLAGS_report_file_operations),
-        cachedev_fd_(-1) {
+        cachedev_fd_(-1),
+        format_(format) {
     if (report_file_operations_) {
       if (!FLAGS_hdfs.empty()) {
         fprintf(stderr,
@@ -1896,6 +1907,13 @@ class Benchmark {
     }
   }
 
+  // Methods that use format_ for keys and values when it is specified.
+  static bool SupportsFormat(void (Benchmark::*method)(ThreadState*)) {
+    return method == &Benchmark::WriteSeq || method == &Benchmark::WriteRandom ||
+           method == &Benchmark::WriteUniqueRandom || method == &Benchmark::ReadRandom ||
+           method == &Benchmark::SeekRandom || method == &Benchmark::Compact;
+  }
+
   std::string GetDbNameForMultiple(std::string base_name, size_t id) {
     return base_name + ToString(id);
   }
@@ -2060,6 +2078,12 @@ class Benchmark {
         exit(1);
       }
 
+      if (format_ != nullptr && method != nullptr && !SupportsFormat(method)) {
+        fprintf(stderr, "benchmark '%s' does not support custom key formats\n",
+                name.c_str());
+        exit(1);
+      }
+
       if (fresh_db) {
         if (FLAGS_use_existing_db) {
           fprintf(stdout, "%-12s : skipped (--use_existing_db is true)\n",
@@ -2329,6 +2353,7 @@ class Benchmark {
                                       &decompress_size, 2);
         ok = uncompressed != nullptr;
         break;
+      case rocksdb::kZSTD:
       case rocksdb::kZSTDNotFinalCompression:
         uncompressed = ZSTD_Uncompress(compressed.data(), compressed.size(),
                                        &decompress_size);
@@ -2356,7 +2381,9 @@ class Benchmark {
 
     options.create_if_missing = !FLAGS_use_existing_db;
     options.create_missing_column_families = FLAGS_num_column_families > 1;
+#ifndef DB_BENCH_WITH_DOCDB
     options.db_write_buffer_size = FLAGS_db_write_buffer_size;
+#endif
     options.write_buffer_size = FLAGS_write_buffer_size;
     options.max_write_buffer_number = FLAGS_max_write_buffer_number;
     options.min_write_buffer_number_to_merge =
@@ -2649,6 +2676,10 @@ class Benchmark {
     }
 #endif  // ROCKSDB_LITE
 
+    if (format_ != nullptr) {
+      format_->CustomizeOptions(&options);
+    }
+
     if (FLAGS_num_multi_db <= 1) {
       OpenDb(options, FLAGS_db, &db_);
     } else {
@@ -2844,6 +2875,8 @@ class Benchmark {
 
     std::unique_ptr<const char[]> key_guard;
     Slice key = AllocateKey(&key_guard);
+    std::string formatted_key;
+    std::string formatted_value;
     int64_t stage = 0;
     while (!duration.Done(entries_per_batch_)) {
       if (duration.GetStage() != stage) {
@@ -2873,17 +2906,28 @@ class Benchmark {
 
       for (int64_t j = 0; j < entries_per_batch_; j++) {
         int64_t rand_num = key_gens[id]->Next();
-        GenerateKeyFromInt(rand_num, FLAGS_num, &key);
+        Slice key_to_write = key;
+        Slice value = gen.Generate(value_size_);
+        if (format_ != nullptr) {
+          formatted_key.clear();
+          format_->AppendKeyPrefix(rand_num, &formatted_key);
+          format_->AppendNewVersion(&formatted_key);
+          formatted_value.clear();
+          format_->AppendValue(value, &formatted_value);
+          key_to_write = formatted_key;
+          value = formatted_value;
+        } else {
+          GenerateKeyFromInt(rand_num, FLAGS_num, &key);
+        }
         if (FLAGS_num_column_families <= 1) {
-          batch.Put(key, gen.Generate(value_size_));
+          batch.Put(key_to_write, value);
         } else {
           // We use same rand_num as seed for key and column family so that we
           // can deterministically find the cfh corresponding to a particular
           // key while reading the key.
-          batch.Put(db_with_cfh->GetCfh(rand_num), key,
-                    gen.Generate(value_size_));
+          batch.Put(db_with_cfh->GetCfh(rand_num), key_to_write, value);
         }
-        bytes += value_size_ + key_size_;
+        bytes += key_to_write.size() + value.size();
       }
       s = db_with_cfh->db->Write(write_options_, &batch);
       thread->stats.FinishedOps(db_with_cfh, db_with_cfh->db,
@@ -3014,6 +3058,25 @@ class Benchmark {
     return key_rand;
   }
 
+  // Reads the latest version of the key_index-th key of format_ the way a point read of the
+  // database on top of RocksDB does: seeks to the key prefix, skipping SST files which do not
+  // contain it according to their filters.
+  Status FormattedGet(const ReadOptions& options, DB* db, ColumnFamilyHandle* cfh,
+                      uint64_t key_index, std::string* prefix, std::string* value) {
+    prefix->clear();
+    format_->AppendKeyPrefix(key_index, prefix);
+    ReadOptions read_options = options;
+    read_options.table_aware_file_filter =
+        open_options_.table_factory->NewTableAwareReadFileFilter(read_options, *prefix);
+    std::unique_ptr<Iterator> iter(db->NewIterator(read_options, cfh));
+    iter->Seek(*prefix);
+    if (!iter->Valid() || !iter->key().starts_with(*prefix)) {
+      return iter->status().ok() ? STATUS(NotFound, "") : iter->status();
+    }
+    value->assign(iter->value().cdata(), iter->value().size());
+    return Status::OK();
+  }
+
   void ReadRandom(ThreadState* thread) {
     int64_t read = 0;
     int64_t found = 0;
@@ -3021,6 +3084,7 @@ class Benchmark {
     ReadOptions options(FLAGS_verify_checksum, true);
     std::unique_ptr<const char[]> key_guard;
     Slice key = AllocateKey(&key_guard);
+    std::string formatted_key;
     std::string value;
 
     Duration duration(FLAGS_duration, reads_);
@@ -3030,13 +3094,19 @@ class Benchmark {
       // deterministically find the cfh corresponding to a particular key, as it
       // is done in DoWrite method.
       int64_t key_rand = GetRandomKey(&thread->rand);
-      GenerateKeyFromInt(key_rand, FLAGS_num, &key);
       read++;
       Status s;
-      if (FLAGS_num_column_families > 1) {
+      if (format_ != nullptr) {
+        ColumnFamilyHandle* cfh = FLAGS_num_column_families > 1
+            ? db_with_cfh->GetCfh(key_rand) : db_with_cfh->db->DefaultColumnFamily();
+        s = FormattedGet(options, db_with_cfh->db, cfh, key_rand, &formatted_key, &value);
+        key = formatted_key;
+      } else if (FLAGS_num_column_families > 1) {
+        GenerateKeyFromInt(key_rand, FLAGS_num, &key);
         s = db_with_cfh->db->Get(options, db_with_cfh->GetCfh(key_rand), key,
                                  &value);
       } else {
+        GenerateKeyFromInt(key_rand, FLAGS_num, &key);
         s = db_with_cfh->db->Get(options, key, &value);
       }
       if (s.ok()) {
@@ -3141,6 +3211,7 @@ class Benchmark {
 
     std::unique_ptr<const char[]> key_guard;
     Slice key = AllocateKey(&key_guard);
+    std::string formatted_key;
 
     Duration duration(FLAGS_duration, reads_);
     char value_buffer[256];
@@ -3165,10 +3236,18 @@ class Benchmark {
         iter_to_use = multi_iters[thread->rand.Next() % multi_iters.size()];
       }
 
-      GenerateKeyFromInt(thread->rand.Next() % FLAGS_num, FLAGS_num, &key);
+      if (format_ != nullptr) {
+        formatted_key.clear();
+        format_->AppendKeyPrefix(thread->rand.Next() % FLAGS_num, &formatted_key);
+        key = formatted_key;
+      } else {
+        GenerateKeyFromInt(thread->rand.Next() % FLAGS_num, FLAGS_num, &key);
+      }
       iter_to_use->Seek(key);
       read++;
-      if (iter_to_use->Valid() && iter_to_use->key().compare(key) == 0) {
+      if (iter_to_use->Valid() &&
+          (format_ != nullptr ? iter_to_use->key().starts_with(key)
+                              : iter_to_use->key().compare(key) == 0)) {
         found++;
       }
 
@@ -4079,7 +4158,7 @@ class Benchmark {
   }
 };
 
-int db_bench_tool(int argc, char** argv) {
+int db_bench_tool(int argc, char** argv, DbBenchFormat* format) {
   rocksdb::port::InstallStackTraceHandler();
   SetUsageMessage(std::string("\nUSAGE:\n") + std::string(argv[0]) +
                   " [OPTIONS]...");
@@ -4144,7 +4223,7 @@ int db_bench_tool(int argc, char** argv) {
     FLAGS_stats_interval = 1000;
   }
 
-  rocksdb::Benchmark benchmark;
+  rocksdb::Benchmark benchmark(format);
   benchmark.Run();
   return 0;
 }
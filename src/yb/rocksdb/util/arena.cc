@@ -36,6 +36,7 @@
 #include "yb/rocksdb/env.h"
 
 #include "yb/util/mem_tracker.h"
+#include "yb/util/memory/memory.h"
 
 namespace rocksdb {
 
@@ -69,12 +70,10 @@ Arena::Arena(size_t block_size, size_t huge_page_size)
   blocks_memory_ += alloc_bytes_remaining_;
   aligned_alloc_ptr_ = inline_block_;
   unaligned_alloc_ptr_ = inline_block_ + alloc_bytes_remaining_;
-#ifdef MAP_HUGETLB
   hugetlb_size_ = huge_page_size;
   if (hugetlb_size_ && kBlockSize > hugetlb_size_) {
     hugetlb_size_ = ((kBlockSize - 1U) / hugetlb_size_ + 1U) * hugetlb_size_;
   }
-#endif
 }
 
 Arena::~Arena() {
@@ -82,14 +81,9 @@ Arena::~Arena() {
     delete[] block;
   }
 
-#ifdef MAP_HUGETLB
   for (const auto& mmap_info : huge_blocks_) {
-    auto ret = munmap(mmap_info.addr_, mmap_info.length_);
-    if (ret != 0) {
-      // TODO(sdong): Better handling
-    }
+    yb::FreeHugePages(mmap_info.addr_, mmap_info.length_);
   }
-#endif
 
   if (mem_tracker_) {
     mem_tracker_->Release(blocks_memory_);
@@ -107,12 +101,10 @@ char* Arena::AllocateFallback(size_t bytes, bool aligned) {
   // We waste the remaining space in the current block.
   size_t size = 0;
   char* block_head = nullptr;
-#ifdef MAP_HUGETLB
   if (hugetlb_size_) {
     size = hugetlb_size_;
     block_head = AllocateFromHugePage(size);
   }
-#endif
   if (!block_head) {
     size = kBlockSize;
     block_head = AllocateNewBlock(size);
@@ -131,7 +123,6 @@ char* Arena::AllocateFallback(size_t bytes, bool aligned) {
 }
 
 char* Arena::AllocateFromHugePage(size_t bytes) {
-#ifdef MAP_HUGETLB
   if (hugetlb_size_ == 0) {
     return nullptr;
   }
@@ -141,18 +132,15 @@ char* Arena::AllocateFromHugePage(size_t bytes) {
   // won't leak either
   huge_blocks_.reserve(huge_blocks_.size() + 1);
 
-  void* addr = mmap(nullptr, bytes, (PROT_READ | PROT_WRITE),
-                    (MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB), 0, 0);
-
-  if (addr == MAP_FAILED) {
+  void* addr = yb::AllocateHugePages(bytes);
+  if (addr == nullptr) {
     return nullptr;
   }
+  // Mapped pages are accounted the same way as heap blocks, so that MemTracker sees them.
+  Consumed(bytes);
   // the following shouldn't throw because of the above reserve()
   huge_blocks_.emplace_back(MmapInfo(addr, bytes));
   return reinterpret_cast<char*>(addr);
-#else
-  return nullptr;
-#endif
 }
 
 char* Arena::AllocateAligned(size_t bytes, size_t huge_page_size,
@@ -160,7 +148,6 @@ char* Arena::AllocateAligned(size_t bytes, size_t huge_page_size,
   assert((kAlignUnit & (kAlignUnit - 1)) ==
          0);  // Pointer size should be a power of 2
 
-#ifdef MAP_HUGETLB
   if (huge_page_size > 0 && bytes > 0) {
     // Allocate from a huge page TBL table.
     assert(logger != nullptr);  // logger need to be passed in.
@@ -177,7 +164,6 @@ char* Arena::AllocateAligned(size_t bytes, size_t huge_page_size,
       return addr;
     }
   }
-#endif
 
   size_t current_mod =
       reinterpret_cast<uintptr_t>(aligned_alloc_ptr_) & (kAlignUnit - 1);
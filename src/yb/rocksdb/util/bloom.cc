@@ -23,6 +23,11 @@
 
 #include <cstdlib>
 
+#if defined(__GNUC__) && defined(__x86_64__)
+#include <immintrin.h>
+#define ROCKSDB_BLOOM_AVX2_PROBE 1
+#endif
+
 #include "yb/rocksdb/filter_policy.h"
 
 #include "yb/rocksdb/table/block_based_filter_block.h"
@@ -43,6 +48,68 @@ typedef FilterPolicy::FilterType FilterType;
 namespace {
 static const double LOG2 = log(2);
 
+constexpr uint32_t kBitsPerCacheLine = CACHE_LINE_SIZE * 8;
+
+// Probes a single cache line of a full filter. All probes of a key fall into the same line, so
+// once the line is located the remaining work is pure bit testing within 512 bits.
+bool ScalarLineMayMatch(uint32_t h, const char* line, size_t num_probes) {
+  const uint32_t delta = (h >> 17) | (h << 15);  // Rotate right 17 bits
+  for (size_t i = 0; i < num_probes; ++i) {
+    const uint32_t bitpos = h % kBitsPerCacheLine;
+    if ((line[bitpos / 8] & (1 << (bitpos % 8))) == 0) {
+      return false;
+    }
+    h += delta;
+  }
+  return true;
+}
+
+#ifdef ROCKSDB_BLOOM_AVX2_PROBE
+// Same probe sequence as ScalarLineMayMatch, but tests 8 probes per iteration: lane i computes
+// h + i * delta, gathers the 32-bit word of the line containing that bit and checks it.
+// Relies on little-endian byte order, so that bit (pos % 32) of little-endian word (pos / 32) is
+// bit (pos % 8) of byte (pos / 8).
+__attribute__((target("avx2")))
+bool Avx2LineMayMatch(uint32_t h, const char* line, size_t num_probes) {
+  static_assert(CACHE_LINE_SIZE == 64, "AVX2 bloom probe assumes 64-byte cache lines");
+  const uint32_t delta = (h >> 17) | (h << 15);  // Rotate right 17 bits
+  const int* words = reinterpret_cast<const int*>(line);
+  const __m256i lane_steps = _mm256_mullo_epi32(
+      _mm256_set1_epi32(delta), _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7));
+  const __m256i bit_mask = _mm256_set1_epi32(kBitsPerCacheLine - 1);
+  const __m256i word_bit_mask = _mm256_set1_epi32(31);
+  const __m256i one = _mm256_set1_epi32(1);
+  const __m256i zero = _mm256_setzero_si256();
+  for (size_t done = 0; done < num_probes; done += 8) {
+    const __m256i hashes = _mm256_add_epi32(_mm256_set1_epi32(h), lane_steps);
+    const __m256i bitpos = _mm256_and_si256(hashes, bit_mask);
+    const __m256i word = _mm256_i32gather_epi32(words, _mm256_srli_epi32(bitpos, 5), 4);
+    const __m256i bit = _mm256_sllv_epi32(one, _mm256_and_si256(bitpos, word_bit_mask));
+    const __m256i missing = _mm256_cmpeq_epi32(_mm256_and_si256(word, bit), zero);
+    const size_t left = num_probes - done;
+    const int active = left >= 8 ? 0xff : (1 << left) - 1;
+    if (_mm256_movemask_ps(_mm256_castsi256_ps(missing)) & active) {
+      return false;
+    }
+    h += 8 * delta;
+  }
+  return true;
+}
+#endif
+
+typedef bool (*LineProbeFunction)(uint32_t h, const char* line, size_t num_probes);
+
+LineProbeFunction ChooseLineProbe() {
+#ifdef ROCKSDB_BLOOM_AVX2_PROBE
+  if (__builtin_cpu_supports("avx2")) {
+    return Avx2LineMayMatch;
+  }
+#endif
+  return ScalarLineMayMatch;
+}
+
+const LineProbeFunction kChosenLineProbe = ChooseLineProbe();
+
 inline void AddHash(uint32_t h, char* data, uint32_t num_lines, uint32_t total_bits,
     size_t num_probes) {
   DCHECK_GT(num_lines, 0);
@@ -270,6 +337,10 @@ inline bool FullFilterBitsReader::HashMayMatch(const uint32_t hash, const Slice&
   uint32_t cache_line_size = (len - FullFilterBitsBuilder::kMetaDataSize) / num_lines;
   const char* data = filter.cdata();
 
+  if (cache_line_size == CACHE_LINE_SIZE) {
+    return kChosenLineProbe(hash, data + (hash % num_lines) * CACHE_LINE_SIZE, num_probes);
+  }
+
   uint32_t h = hash;
   const uint32_t delta = (h >> 17) | (h << 15);  // Rotate right 17 bits
   uint32_t b = (h % num_lines) * (cache_line_size * 8);
@@ -548,4 +619,13 @@ const FilterPolicy* NewFixedSizeFilterPolicy(uint32_t total_bits,
   return new FixedSizeFilterPolicy(total_bits, error_rate, logger);
 }
 
+bool IsFastBloomProbeSupported() {
+  return kChosenLineProbe != ScalarLineMayMatch;
+}
+
+bool BloomLineMayMatch(uint32_t hash, const char* line, size_t num_probes, bool allow_simd) {
+  return allow_simd ? kChosenLineProbe(hash, line, num_probes)
+                    : ScalarLineMayMatch(hash, line, num_probes);
+}
+
 }  // namespace rocksdb
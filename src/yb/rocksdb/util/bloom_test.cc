@@ -370,6 +370,30 @@ TEST_P(BuilderReaderBloomTest, FullVaryingLengths) {
   ASSERT_LE(mediocre_filters, good_filters/5);
 }
 
+extern bool IsFastBloomProbeSupported();
+extern bool BloomLineMayMatch(uint32_t hash, const char* line, size_t num_probes, bool allow_simd);
+
+TEST_F(BloomTest, LineProbeMatchesScalar) {
+  if (!IsFastBloomProbeSupported()) {
+    LOG(INFO) << "Vectorized bloom probe is not supported on this CPU, skipping";
+    return;
+  }
+  Random rnd(301);
+  char line[CACHE_LINE_SIZE];
+  for (int iter = 0; iter < 10000; ++iter) {
+    // Dense lines give a mix of hits and misses across the probe counts we exercise.
+    for (auto& byte : line) {
+      byte = static_cast<char>(rnd.Next() | rnd.Next() | rnd.Next());
+    }
+    const uint32_t hash = rnd.Next();
+    for (size_t num_probes = 1; num_probes <= 20; ++num_probes) {
+      ASSERT_EQ(BloomLineMayMatch(hash, line, num_probes, /* allow_simd = */ false),
+                BloomLineMayMatch(hash, line, num_probes, /* allow_simd = */ true))
+          << "hash: " << hash << ", num_probes: " << num_probes;
+    }
+  }
+}
+
 INSTANTIATE_TEST_CASE_P(, BuilderReaderBloomTest, ::testing::Values(
     BuilderReaderBloomTestType::kFullFilter,
     BuilderReaderBloomTestType::kFixedSizeFilter));
@@ -40,6 +40,13 @@
 DEFINE_double(cache_single_touch_ratio, 0.2,
               "fraction of the cache dedicated to single-touch items");
 
+// Fraction of the cache reserved for high priority entries (index and filter blocks). The rest of
+// the cache is split between single-touch and multi-touch items. 0 disables the high priority pool
+// and high priority entries are handled as low priority ones.
+DEFINE_double(cache_high_pri_pool_ratio, 0.0,
+              "fraction of the cache dedicated to high priority items, such as index and filter "
+              "blocks");
+
 namespace rocksdb {
 
 Cache::~Cache() {
@@ -78,6 +85,9 @@ namespace {
 // that are accessed multiple times by different queries.
 // query_id == kNoCacheQueryId means that this Handle is not going to be added
 // into the cache.
+//
+// Entries inserted with Cache::Priority::HIGH live in a separate high priority sub cache, with its
+// own capacity, and are never moved between the single touch and multi touch sub caches.
 
 struct LRUHandle {
   void* value;
@@ -92,6 +102,7 @@ struct LRUHandle {
   bool in_cache;      // true, if this entry is referenced by the hash table
   uint32_t hash;      // Hash of key(); used for fast sharding and comparisons
   QueryId query_id;  // Query id that added the value to the cache.
+  Cache::Priority priority;
   char key_data[1];   // Beginning of key
 
   Slice key() const {
@@ -112,6 +123,8 @@ struct LRUHandle {
         metrics->multi_touch_cache_usage->DecrementBy(charge);
       } else if (GetSubCacheType() == SINGLE_TOUCH) {
         metrics->single_touch_cache_usage->DecrementBy(charge);
+      } else if (GetSubCacheType() == HIGH_PRI) {
+        metrics->high_pri_cache_usage->DecrementBy(charge);
       }
       metrics->cache_usage->DecrementBy(charge);
     }
@@ -119,6 +132,9 @@ struct LRUHandle {
   }
 
   SubCacheType GetSubCacheType() const {
+    if (priority == Cache::Priority::HIGH) {
+      return HIGH_PRI;
+    }
     return (query_id == kInMultiTouchId) ? MULTI_TOUCH : SINGLE_TOUCH;
   }
 };
@@ -165,8 +181,8 @@ class HandleTable {
   // It checks to see if the same value is in the multi touch cache, or if it is in the single
   // touch cache, checks to see if the query ids are different.
   SubCacheType GetSubCacheTypeCandidate(LRUHandle* h) {
-    if (h->GetSubCacheType() == MULTI_TOUCH) {
-      return MULTI_TOUCH;
+    if (h->GetSubCacheType() == MULTI_TOUCH || h->GetSubCacheType() == HIGH_PRI) {
+      return h->GetSubCacheType();
     }
 
     LRUHandle* val = Lookup(h->key(), h->hash);
@@ -375,7 +391,7 @@ class LRUCache {
   // Like Cache methods, but with an extra "hash" parameter.
   Status Insert(const Slice& key, uint32_t hash, const QueryId query_id,
                 void* value, size_t charge, void (*deleter)(const Slice& key, void* value),
-                Cache::Handle** handle, Statistics* statistics);
+                Cache::Handle** handle, Statistics* statistics, Cache::Priority priority);
   Cache::Handle* Lookup(const Slice& key, uint32_t hash, const QueryId query_id,
                         Statistics* statistics = nullptr);
   void Release(Cache::Handle* handle);
@@ -387,12 +403,14 @@ class LRUCache {
 
   size_t GetUsage() const {
     MutexLock l(&mutex_);
-    return single_touch_sub_cache_.Usage() + multi_touch_sub_cache_.Usage();
+    return single_touch_sub_cache_.Usage() + multi_touch_sub_cache_.Usage() +
+           high_pri_sub_cache_.Usage();
   }
 
   size_t GetPinnedUsage() const {
     MutexLock l(&mutex_);
-    return single_touch_sub_cache_.GetPinnedUsage() + multi_touch_sub_cache_.GetPinnedUsage();
+    return single_touch_sub_cache_.GetPinnedUsage() + multi_touch_sub_cache_.GetPinnedUsage() +
+           high_pri_sub_cache_.GetPinnedUsage();
   }
 
   void ApplyToAllCacheEntries(void (*callback)(void*, size_t),
@@ -407,6 +425,7 @@ class LRUCache {
   LRUSubCache* GetSubCache(const SubCacheType subcache_type);
   LRUSubCache single_touch_sub_cache_;
   LRUSubCache multi_touch_sub_cache_;
+  LRUSubCache high_pri_sub_cache_;
   // Just reduce the reference count by 1.
   // Return true if last reference
   bool Unref(LRUHandle* e);
@@ -444,6 +463,10 @@ bool LRUCache::Unref(LRUHandle* e) {
 }
 
 LRUSubCache* LRUCache::GetSubCache(const SubCacheType subcache_type) {
+  // Entries are only marked as high priority when the high priority pool exists.
+  if (subcache_type == SubCacheType::HIGH_PRI) {
+    return &high_pri_sub_cache_;
+  }
   if (FLAGS_cache_single_touch_ratio == 0) {
     return &multi_touch_sub_cache_;
   } else if (FLAGS_cache_single_touch_ratio == 1) {
@@ -502,11 +525,15 @@ void LRUCache::SetCapacity(size_t capacity) {
   autovector<LRUHandle*> last_reference_list;
   {
     MutexLock l(&mutex_);
+    high_pri_sub_cache_.SetCapacity(
+      static_cast<size_t>(round(FLAGS_cache_high_pri_pool_ratio * capacity)));
+    const size_t low_pri_capacity = capacity - high_pri_sub_cache_.Capacity();
     single_touch_sub_cache_.SetCapacity(
-      static_cast<size_t>(round(FLAGS_cache_single_touch_ratio * capacity)));
-    multi_touch_sub_cache_.SetCapacity(capacity - single_touch_sub_cache_.Capacity());
+      static_cast<size_t>(round(FLAGS_cache_single_touch_ratio * low_pri_capacity)));
+    multi_touch_sub_cache_.SetCapacity(low_pri_capacity - single_touch_sub_cache_.Capacity());
     EvictFromLRU(0, &last_reference_list, SINGLE_TOUCH);
     EvictFromLRU(0, &last_reference_list, MULTI_TOUCH);
+    EvictFromLRU(0, &last_reference_list, HIGH_PRI);
   }
   // we free the entries here outside of mutex for
   // performance reasons
@@ -534,7 +561,7 @@ Cache::Handle* LRUCache::Lookup(const Slice& key, uint32_t hash, const QueryId q
     e->refs++;
 
     // Now the handle will be added to the multi touch pool only if it exists.
-    if (FLAGS_cache_single_touch_ratio < 1 && e->GetSubCacheType() != MULTI_TOUCH &&
+    if (FLAGS_cache_single_touch_ratio < 1 && e->GetSubCacheType() == SINGLE_TOUCH &&
         e->query_id != query_id) {
       autovector<LRUHandle*> multi_touch_eviction_list;
       EvictFromLRU(e->charge, &multi_touch_eviction_list, MULTI_TOUCH);
@@ -566,6 +593,9 @@ Cache::Handle* LRUCache::Lookup(const Slice& key, uint32_t hash, const QueryId q
       } else if (e->GetSubCacheType() == SubCacheType::MULTI_TOUCH) {
         RecordTick(statistics, BLOCK_CACHE_MULTI_TOUCH_HIT);
         RecordTick(statistics, BLOCK_CACHE_MULTI_TOUCH_BYTES_READ, e->charge);
+      } else if (e->GetSubCacheType() == SubCacheType::HIGH_PRI) {
+        RecordTick(statistics, BLOCK_CACHE_HIGH_PRI_HIT);
+        RecordTick(statistics, BLOCK_CACHE_HIGH_PRI_BYTES_READ, e->charge);
       }
     }
   } else {
@@ -625,7 +655,8 @@ void LRUCache::Release(Cache::Handle* handle) {
 
 Status LRUCache::Insert(const Slice& key, uint32_t hash, const QueryId query_id,
                         void* value, size_t charge, void (*deleter)(const Slice& key, void* value),
-                        Cache::Handle** handle, Statistics* statistics) {
+                        Cache::Handle** handle, Statistics* statistics,
+                        Cache::Priority priority) {
   // Don't use the cache if disabled by the caller using the special query id.
   if (query_id == kNoCacheQueryId) {
     return Status::OK();
@@ -650,6 +681,8 @@ Status LRUCache::Insert(const Slice& key, uint32_t hash, const QueryId query_id,
   e->in_cache = true;
   // Adding query id to the handle.
   e->query_id = query_id;
+  // Without a high priority pool all entries are low priority.
+  e->priority = FLAGS_cache_high_pri_pool_ratio > 0 ? priority : Cache::Priority::LOW;
   memcpy(e->key_data, key.data(), key.size());
 
   {
@@ -658,7 +691,9 @@ Status LRUCache::Insert(const Slice& key, uint32_t hash, const QueryId query_id,
     // is freed or the lru list is empty.
     // Check if there is a single touch cache.
     SubCacheType subcache_type;
-    if (FLAGS_cache_single_touch_ratio == 0) {
+    if (e->priority == Cache::Priority::HIGH) {
+      subcache_type = HIGH_PRI;
+    } else if (FLAGS_cache_single_touch_ratio == 0) {
       e->query_id = kInMultiTouchId;
       subcache_type = MULTI_TOUCH;
     } else if (FLAGS_cache_single_touch_ratio == 1) {
@@ -713,6 +748,9 @@ Status LRUCache::Insert(const Slice& key, uint32_t hash, const QueryId query_id,
         } else if (subcache_type == SubCacheType::MULTI_TOUCH) {
           RecordTick(statistics, BLOCK_CACHE_MULTI_TOUCH_ADD);
           RecordTick(statistics, BLOCK_CACHE_MULTI_TOUCH_BYTES_WRITE, charge);
+        } else if (subcache_type == SubCacheType::HIGH_PRI) {
+          RecordTick(statistics, BLOCK_CACHE_HIGH_PRI_ADD);
+          RecordTick(statistics, BLOCK_CACHE_HIGH_PRI_BYTES_WRITE, charge);
         }
       } else {
         RecordTick(statistics, BLOCK_CACHE_ADD_FAILURES);
@@ -721,6 +759,8 @@ Status LRUCache::Insert(const Slice& key, uint32_t hash, const QueryId query_id,
     if (metrics_ != nullptr) {
       if (subcache_type == MULTI_TOUCH) {
         metrics_->multi_touch_cache_usage->IncrementBy(charge);
+      } else if (subcache_type == HIGH_PRI) {
+        metrics_->high_pri_cache_usage->IncrementBy(charge);
       } else {
         metrics_->single_touch_cache_usage->IncrementBy(charge);
       }
@@ -828,7 +868,8 @@ class ShardedLRUCache : public Cache {
   }
   virtual Status Insert(const Slice& key, const QueryId query_id, void* value, size_t charge,
                         void (*deleter)(const Slice& key, void* value),
-                        Handle** handle, Statistics* statistics) override {
+                        Handle** handle, Statistics* statistics,
+                        Priority priority) override {
     DCHECK(IsValidQueryId(query_id));
     // Queries with no cache query ids are not cached.
     if (query_id == kNoCacheQueryId) {
@@ -836,7 +877,7 @@ class ShardedLRUCache : public Cache {
     }
     const uint32_t hash = HashSlice(key);
     return shards_[Shard(hash)].Insert(key, hash, query_id, value, charge, deleter,
-                                       handle, statistics);
+                                       handle, statistics, priority);
   }
 
   Handle* Lookup(const Slice& key, const QueryId query_id, Statistics* statistics) override {
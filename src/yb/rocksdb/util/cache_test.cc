@@ -33,6 +33,7 @@
 #include "yb/rocksdb/util/testharness.h"
 
 DECLARE_double(cache_single_touch_ratio);
+DECLARE_double(cache_high_pri_pool_ratio);
 
 namespace rocksdb {
 
@@ -463,6 +464,52 @@ TEST_F(CacheTest, EvictionPolicyMultiTouch) {
   ASSERT_LT(kCacheSize * FLAGS_cache_single_touch_ratio, cache_->GetUsage());
 }
 
+TEST_F(CacheTest, HighPriorityPool) {
+  FLAGS_cache_high_pri_pool_ratio = 0.5;
+  const int kCapacity = 100;
+  auto cache = NewLRUCache(kCapacity, 0);
+  const int kNumHighPri = kCapacity / 2;
+  for (int i = 0; i < kNumHighPri; i++) {
+    ASSERT_OK(cache->Insert(EncodeKey(i), kTestQueryId, EncodeValue(i + 1), 1,
+                            &CacheTest::Deleter, nullptr, nullptr, Cache::Priority::HIGH));
+  }
+
+  // Scan through a lot of low priority entries, high priority entries should stay in the cache.
+  for (int i = 0; i < kCapacity * 10; i++) {
+    ASSERT_OK(Insert(cache, 1000 + i, 2000 + i));
+  }
+  for (int i = 0; i < kNumHighPri; i++) {
+    Cache::Handle* handle = cache->Lookup(EncodeKey(i), kTestQueryId);
+    ASSERT_NE(nullptr, handle);
+    ASSERT_EQ(HIGH_PRI, cache->GetSubCacheType(handle));
+    ASSERT_EQ(i + 1, DecodeValue(cache->Value(handle)));
+    cache->Release(handle);
+  }
+  // Low priority entries are all single touch, so the multi touch pool stays empty.
+  ASSERT_EQ(kNumHighPri + static_cast<size_t>(kNumHighPri * FLAGS_cache_single_touch_ratio),
+            cache->GetUsage());
+
+  // Extra high priority entries evict only the oldest high priority ones.
+  for (int i = 0; i < kNumHighPri; i++) {
+    ASSERT_OK(cache->Insert(EncodeKey(kNumHighPri + i), kTestQueryId, EncodeValue(i + 1), 1,
+                            &CacheTest::Deleter, nullptr, nullptr, Cache::Priority::HIGH));
+  }
+  ASSERT_EQ(-1, Lookup(cache, 0));
+  ASSERT_EQ(2000 + kCapacity * 10 - 1, Lookup(cache, 1000 + kCapacity * 10 - 1));
+
+  // Returning the flag back.
+  FLAGS_cache_high_pri_pool_ratio = 0;
+}
+
+TEST_F(CacheTest, HighPriorityWithoutPool) {
+  ASSERT_OK(cache_->Insert(EncodeKey(100), kTestQueryId, EncodeValue(101), 1,
+                           &CacheTest::Deleter, nullptr, nullptr, Cache::Priority::HIGH));
+  Cache::Handle* handle = cache_->Lookup(EncodeKey(100), kTestQueryId);
+  ASSERT_NE(nullptr, handle);
+  ASSERT_NE(HIGH_PRI, cache_->GetSubCacheType(handle));
+  cache_->Release(handle);
+}
+
 TEST_F(CacheTest, HeavyEntries) {
   // Add a bunch of light and heavy entries and then count the combined
   // size of items still in the cache, which must be approximately the
@@ -675,6 +722,116 @@ TEST_F(CacheTest, ApplyToAllCacheEntiresTest) {
   ASSERT_TRUE(inserted == callback_state);
 }
 
+TEST_F(CacheTest, ClockHitAndMiss) {
+  auto cache = NewClockCache(kCacheSize, 0 /* num_shard_bits */);
+  ASSERT_EQ(-1, Lookup(cache, 100));
+
+  ASSERT_OK(Insert(cache, 100, 101));
+  ASSERT_EQ(101, Lookup(cache, 100));
+  ASSERT_EQ(-1, Lookup(cache, 200));
+
+  ASSERT_OK(Insert(cache, 200, 201));
+  ASSERT_EQ(101, Lookup(cache, 100));
+  ASSERT_EQ(201, Lookup(cache, 200));
+
+  ASSERT_OK(Insert(cache, 100, 102));
+  ASSERT_EQ(102, Lookup(cache, 100));
+  ASSERT_EQ(201, Lookup(cache, 200));
+  ASSERT_EQ(1U, deleted_keys_.size());
+  ASSERT_EQ(100, deleted_keys_[0]);
+  ASSERT_EQ(101, deleted_values_[0]);
+
+  Erase(cache, 100);
+  ASSERT_EQ(-1, Lookup(cache, 100));
+  ASSERT_EQ(201, Lookup(cache, 200));
+  ASSERT_EQ(2U, deleted_keys_.size());
+  ASSERT_EQ(100, deleted_keys_[1]);
+  ASSERT_EQ(102, deleted_values_[1]);
+}
+
+TEST_F(CacheTest, ClockEntriesArePinned) {
+  auto cache = NewClockCache(kCacheSize, 0 /* num_shard_bits */);
+  ASSERT_OK(Insert(cache, 100, 101));
+  Cache::Handle* h1 = cache->Lookup(EncodeKey(100), kTestQueryId);
+  ASSERT_EQ(101, DecodeValue(cache->Value(h1)));
+  ASSERT_EQ(1U, cache->GetPinnedUsage());
+
+  ASSERT_OK(Insert(cache, 100, 102));
+  Cache::Handle* h2 = cache->Lookup(EncodeKey(100), kTestQueryId);
+  ASSERT_EQ(102, DecodeValue(cache->Value(h2)));
+  ASSERT_EQ(0U, deleted_keys_.size());
+
+  cache->Release(h1);
+  ASSERT_EQ(1U, deleted_keys_.size());
+  ASSERT_EQ(101, deleted_values_[0]);
+
+  Erase(cache, 100);
+  ASSERT_EQ(-1, Lookup(cache, 100));
+  ASSERT_EQ(1U, deleted_keys_.size());
+
+  cache->Release(h2);
+  ASSERT_EQ(2U, deleted_keys_.size());
+  ASSERT_EQ(102, deleted_values_[1]);
+  ASSERT_EQ(0U, cache->GetUsage());
+}
+
+TEST_F(CacheTest, ClockEvictsNotRecentlyUsed) {
+  const int kCapacity = 10;
+  auto cache = NewClockCache(kCapacity, 0 /* num_shard_bits */);
+  for (int i = 0; i < kCapacity; i++) {
+    ASSERT_OK(Insert(cache, i, i + 1000));
+  }
+  // Referenced entry gets a second chance, so the next one under the hand is evicted instead.
+  ASSERT_EQ(1000, Lookup(cache, 0));
+  ASSERT_OK(Insert(cache, kCapacity, kCapacity + 1000));
+  ASSERT_EQ(1000, Lookup(cache, 0));
+  ASSERT_EQ(-1, Lookup(cache, 1));
+  ASSERT_EQ(kCapacity + 1000, Lookup(cache, kCapacity));
+  ASSERT_EQ(static_cast<size_t>(kCapacity), cache->GetUsage());
+
+  // Pinned entries are never evicted.
+  Cache::Handle* h = cache->Lookup(EncodeKey(2), kTestQueryId);
+  ASSERT_NE(nullptr, h);
+  for (int i = kCapacity + 1; i < 3 * kCapacity; i++) {
+    ASSERT_OK(Insert(cache, i, i + 1000));
+  }
+  ASSERT_EQ(1002, DecodeValue(cache->Value(h)));
+  cache->Release(h);
+  ASSERT_EQ(1002, Lookup(cache, 2));
+  ASSERT_LE(cache->GetUsage(), static_cast<size_t>(kCapacity));
+}
+
+TEST_F(CacheTest, ClockStrictCapacityLimit) {
+  const int kCapacity = 10;
+  auto cache = NewClockCache(kCapacity, 0 /* num_shard_bits */, true /* strict_capacity_limit */);
+  Cache::Handle* handles[kCapacity];
+  for (int i = 0; i < kCapacity; i++) {
+    ASSERT_OK(cache->Insert(EncodeKey(i), kTestQueryId, EncodeValue(i), 1, &CacheTest::Deleter,
+                            &handles[i]));
+  }
+  ASSERT_EQ(static_cast<size_t>(kCapacity), cache->GetUsage());
+  ASSERT_EQ(static_cast<size_t>(kCapacity), cache->GetPinnedUsage());
+
+  Cache::Handle* extra_handle;
+  Status s = cache->Insert(EncodeKey(kCapacity), kTestQueryId, EncodeValue(kCapacity), 1,
+                           &CacheTest::Deleter, &extra_handle);
+  ASSERT_TRUE(s.IsIncomplete());
+  ASSERT_EQ(nullptr, extra_handle);
+
+  // Without a handle the value is cleaned up by the cache.
+  s = Insert(cache, kCapacity, kCapacity);
+  ASSERT_TRUE(s.IsIncomplete());
+  ASSERT_EQ(1U, deleted_keys_.size());
+  ASSERT_EQ(kCapacity, deleted_keys_[0]);
+
+  for (int i = 0; i < kCapacity; i++) {
+    cache->Release(handles[i]);
+  }
+  ASSERT_OK(Insert(cache, kCapacity, kCapacity));
+  ASSERT_EQ(kCapacity, Lookup(cache, kCapacity));
+  ASSERT_EQ(static_cast<size_t>(kCapacity), cache->GetUsage());
+}
+
 }  // namespace rocksdb
 
 int main(int argc, char** argv) {
@@ -0,0 +1,532 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include <atomic>
+#include <unordered_map>
+
+#include "yb/util/metrics.h"
+#include "yb/rocksdb/cache.h"
+#include "yb/rocksdb/statistics.h"
+#include "yb/rocksdb/port/port.h"
+#include "yb/rocksdb/util/autovector.h"
+#include "yb/rocksdb/util/hash.h"
+#include "yb/rocksdb/util/mutexlock.h"
+#include "yb/rocksdb/util/statistics.h"
+
+namespace rocksdb {
+
+namespace {
+
+// CLOCK cache implementation.
+//
+// Unlike the LRU cache, a cache hit does not modify any shared structure protected by an exclusive
+// lock. Lookups only take the shard lock in shared mode, pin the entry by atomically incrementing
+// its reference count and set its usage bit. Insert, Erase and eviction take the shard lock in
+// exclusive mode.
+//
+// Entries of a shard are kept in a circular list. On eviction, the clock hand walks the list,
+// clearing usage bits of recently used entries and evicting the first unpinned entry whose usage
+// bit is already clear.
+//
+// The reference count and the "in cache" flag of an entry are kept in the same atomic word, so that
+// exactly one of Release, Erase or eviction observes the transition to the unreferenced and not
+// in cache state and frees the entry.
+struct ClockHandle {
+  static constexpr uint32_t kInCacheBit = 1u << 31;
+
+  void* value;
+  void (*deleter)(const Slice&, void* value);
+  ClockHandle* next;
+  ClockHandle* prev;
+  size_t charge;
+  size_t key_length;
+  uint32_t hash;
+  // Number of external references and kInCacheBit.
+  std::atomic<uint32_t> state;
+  std::atomic<bool> usage;
+  char key_data[1];   // Beginning of key
+
+  Slice key() const {
+    return Slice(key_data, key_length);
+  }
+
+  uint32_t refs() const {
+    return state.load(std::memory_order_acquire) & ~kInCacheBit;
+  }
+
+  void Free() {
+    (*deleter)(key(), value);
+    this->~ClockHandle();
+    delete[] reinterpret_cast<char*>(this);
+  }
+};
+
+struct SliceHash {
+  size_t operator()(const Slice& key) const {
+    return Hash(key.data(), key.size(), 0);
+  }
+};
+
+// A single shard of sharded cache.
+class ClockCacheShard {
+ public:
+  ClockCacheShard() : capacity_(0), strict_capacity_limit_(false), usage_(0), hand_(nullptr) {}
+
+  ~ClockCacheShard() {
+    for (const auto& entry : table_) {
+      ClockHandle* h = entry.second;
+      // Entries that are still referenced are leaked, same as in the LRU cache.
+      if (h->state.fetch_and(~ClockHandle::kInCacheBit) == ClockHandle::kInCacheBit) {
+        h->Free();
+      }
+    }
+  }
+
+  void SetCapacity(size_t capacity) {
+    autovector<ClockHandle*> deleted;
+    {
+      WriteLock l(&mutex_);
+      capacity_ = capacity;
+      EvictFromClock(0, &deleted);
+    }
+    FreeAll(&deleted);
+  }
+
+  void SetStrictCapacityLimit(bool strict_capacity_limit) {
+    WriteLock l(&mutex_);
+    strict_capacity_limit_ = strict_capacity_limit;
+  }
+
+  void SetMetrics(std::shared_ptr<yb::CacheMetrics> metrics) {
+    metrics_ = std::move(metrics);
+  }
+
+  Status Insert(const Slice& key, uint32_t hash, void* value, size_t charge,
+                void (*deleter)(const Slice& key, void* value), Cache::Handle** handle,
+                Statistics* statistics, Cache::Priority priority);
+
+  Cache::Handle* Lookup(const Slice& key, uint32_t hash, Statistics* statistics);
+
+  void Release(Cache::Handle* handle);
+
+  void Erase(const Slice& key, uint32_t hash);
+
+  size_t GetUsage() const {
+    return usage_.load(std::memory_order_relaxed);
+  }
+
+  size_t GetPinnedUsage() const {
+    ReadLock l(&mutex_);
+    size_t result = 0;
+    for (const auto& entry : table_) {
+      if (entry.second->refs() != 0) {
+        result += entry.second->charge;
+      }
+    }
+    return result;
+  }
+
+  void ApplyToAllCacheEntries(void (*callback)(void*, size_t), bool thread_safe) {
+    if (thread_safe) {
+      mutex_.ReadLock();
+    }
+    for (const auto& entry : table_) {
+      callback(entry.second->value, entry.second->charge);
+    }
+    if (thread_safe) {
+      mutex_.ReadUnlock();
+    }
+  }
+
+ private:
+  // Removes the entry from the table and the clock list. Returns true if the caller is responsible
+  // for freeing the entry.
+  // REQUIRES: mutex_ is held in exclusive mode.
+  bool RemoveFromCache(ClockHandle* h);
+
+  // Walks the clock list until the usage allows an entry with the given charge to be added, or
+  // there is nothing to evict.
+  // REQUIRES: mutex_ is held in exclusive mode.
+  void EvictFromClock(size_t charge, autovector<ClockHandle*>* deleted);
+
+  void ClockAppend(ClockHandle* h);
+  void ClockRemove(ClockHandle* h);
+
+  void FreeAll(autovector<ClockHandle*>* deleted) {
+    for (auto* h : *deleted) {
+      h->Free();
+    }
+  }
+
+  // mutex_ protects the following state, except usage_, state and usage of the entries.
+  mutable port::RWMutex mutex_;
+  size_t capacity_;
+  bool strict_capacity_limit_;
+  // Total charge of the entries in the table.
+  std::atomic<size_t> usage_;
+  std::unordered_map<Slice, ClockHandle*, SliceHash> table_;
+  // Clock hand, points to the next entry to check for eviction, nullptr if the list is empty.
+  ClockHandle* hand_;
+
+  std::shared_ptr<yb::CacheMetrics> metrics_;
+};
+
+void ClockCacheShard::ClockAppend(ClockHandle* h) {
+  // Insert the new entry just behind the hand, so it is the last one to be checked.
+  if (hand_ == nullptr) {
+    h->next = h->prev = h;
+    hand_ = h;
+    return;
+  }
+  h->next = hand_;
+  h->prev = hand_->prev;
+  h->prev->next = h;
+  hand_->prev = h;
+}
+
+void ClockCacheShard::ClockRemove(ClockHandle* h) {
+  if (h->next == h) {
+    hand_ = nullptr;
+  } else {
+    if (hand_ == h) {
+      hand_ = h->next;
+    }
+    h->next->prev = h->prev;
+    h->prev->next = h->next;
+  }
+  h->next = h->prev = nullptr;
+}
+
+bool ClockCacheShard::RemoveFromCache(ClockHandle* h) {
+  table_.erase(h->key());
+  ClockRemove(h);
+  usage_.fetch_sub(h->charge, std::memory_order_relaxed);
+  if (metrics_) {
+    metrics_->cache_usage->DecrementBy(h->charge);
+  }
+  return h->state.fetch_and(~ClockHandle::kInCacheBit) == ClockHandle::kInCacheBit;
+}
+
+void ClockCacheShard::EvictFromClock(size_t charge, autovector<ClockHandle*>* deleted) {
+  // Each entry is visited at most twice: the first visit may only clear its usage bit.
+  size_t steps_left = 2 * table_.size();
+  while (hand_ != nullptr && steps_left > 0 &&
+         usage_.load(std::memory_order_relaxed) + charge > capacity_) {
+    --steps_left;
+    ClockHandle* h = hand_;
+    hand_ = h->next;
+    if (h->refs() != 0) {
+      // Pinned entries can not be evicted, new references can not appear while we hold the lock
+      // in exclusive mode.
+      continue;
+    }
+    if (h->usage.exchange(false, std::memory_order_relaxed)) {
+      continue;
+    }
+    if (metrics_) {
+      metrics_->evictions->Increment();
+    }
+    if (RemoveFromCache(h)) {
+      deleted->push_back(h);
+    }
+  }
+}
+
+Status ClockCacheShard::Insert(const Slice& key, uint32_t hash, void* value, size_t charge,
+                               void (*deleter)(const Slice& key, void* value),
+                               Cache::Handle** handle, Statistics* statistics,
+                               Cache::Priority priority) {
+  // Allocate the memory here outside of the mutex.
+  char* buffer = new char[sizeof(ClockHandle) - 1 + key.size()];
+  ClockHandle* e = new (buffer) ClockHandle;
+  e->value = value;
+  e->deleter = deleter;
+  e->next = e->prev = nullptr;
+  e->charge = charge;
+  e->key_length = key.size();
+  e->hash = hash;
+  e->state.store(ClockHandle::kInCacheBit | (handle == nullptr ? 0 : 1),
+                 std::memory_order_relaxed);
+  // High priority entries get a second chance before their first eviction.
+  e->usage.store(priority == Cache::Priority::HIGH, std::memory_order_relaxed);
+  memcpy(e->key_data, key.data(), key.size());
+
+  Status s;
+  autovector<ClockHandle*> deleted;
+  {
+    WriteLock l(&mutex_);
+    EvictFromClock(charge, &deleted);
+    if (strict_capacity_limit_ && usage_.load(std::memory_order_relaxed) + charge > capacity_) {
+      if (handle == nullptr) {
+        // Value should be cleaned up by us in this case, as if Release was called.
+        e->state.store(0, std::memory_order_relaxed);
+        deleted.push_back(e);
+      } else {
+        e->~ClockHandle();
+        delete[] buffer;
+        *handle = nullptr;
+      }
+      s = STATUS(Incomplete, "Insert failed due to CLOCK cache being full.");
+    } else {
+      auto it = table_.find(e->key());
+      if (it != table_.end()) {
+        ClockHandle* old = it->second;
+        if (RemoveFromCache(old)) {
+          deleted.push_back(old);
+        }
+      }
+      table_.emplace(e->key(), e);
+      ClockAppend(e);
+      usage_.fetch_add(charge, std::memory_order_relaxed);
+      if (handle != nullptr) {
+        *handle = reinterpret_cast<Cache::Handle*>(e);
+      }
+    }
+  }
+
+  if (statistics != nullptr) {
+    if (s.ok()) {
+      RecordTick(statistics, BLOCK_CACHE_ADD);
+      RecordTick(statistics, BLOCK_CACHE_BYTES_WRITE, charge);
+    } else {
+      RecordTick(statistics, BLOCK_CACHE_ADD_FAILURES);
+    }
+  }
+  if (metrics_ != nullptr && s.ok()) {
+    metrics_->inserts->Increment();
+    metrics_->cache_usage->IncrementBy(charge);
+  }
+
+  // Free the entries here outside of mutex for performance reasons.
+  FreeAll(&deleted);
+  return s;
+}
+
+Cache::Handle* ClockCacheShard::Lookup(const Slice& key, uint32_t hash, Statistics* statistics) {
+  ClockHandle* e = nullptr;
+  {
+    ReadLock l(&mutex_);
+    auto it = table_.find(key);
+    if (it != table_.end()) {
+      e = it->second;
+      // The entry could not be removed from the cache while we hold the lock, so it is safe to
+      // add a reference.
+      e->state.fetch_add(1, std::memory_order_acq_rel);
+      if (!e->usage.load(std::memory_order_relaxed)) {
+        e->usage.store(true, std::memory_order_relaxed);
+      }
+    }
+  }
+
+  if (statistics != nullptr) {
+    if (e != nullptr) {
+      RecordTick(statistics, BLOCK_CACHE_HIT);
+      RecordTick(statistics, BLOCK_CACHE_BYTES_READ, e->charge);
+    } else {
+      RecordTick(statistics, BLOCK_CACHE_MISS);
+    }
+  }
+  if (metrics_ != nullptr) {
+    metrics_->lookups->Increment();
+    if (e != nullptr) {
+      metrics_->cache_hits->Increment();
+    } else {
+      metrics_->cache_misses->Increment();
+    }
+  }
+  return reinterpret_cast<Cache::Handle*>(e);
+}
+
+void ClockCacheShard::Release(Cache::Handle* handle) {
+  if (handle == nullptr) {
+    return;
+  }
+  ClockHandle* e = reinterpret_cast<ClockHandle*>(handle);
+  // Last reference to an entry that is no longer in the cache.
+  if (e->state.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+    e->Free();
+  }
+}
+
+void ClockCacheShard::Erase(const Slice& key, uint32_t hash) {
+  ClockHandle* to_free = nullptr;
+  {
+    WriteLock l(&mutex_);
+    auto it = table_.find(key);
+    if (it != table_.end()) {
+      ClockHandle* e = it->second;
+      if (RemoveFromCache(e)) {
+        to_free = e;
+      }
+    }
+  }
+  if (to_free != nullptr) {
+    to_free->Free();
+  }
+}
+
+class ShardedClockCache : public Cache {
+ public:
+  ShardedClockCache(size_t capacity, int num_shard_bits, bool strict_capacity_limit)
+      : last_id_(0),
+        num_shard_bits_(num_shard_bits),
+        capacity_(capacity),
+        strict_capacity_limit_(strict_capacity_limit) {
+    int num_shards = 1 << num_shard_bits_;
+    shards_ = new ClockCacheShard[num_shards];
+    const size_t per_shard = (capacity + (num_shards - 1)) / num_shards;
+    for (int s = 0; s < num_shards; s++) {
+      shards_[s].SetCapacity(per_shard);
+      shards_[s].SetStrictCapacityLimit(strict_capacity_limit);
+    }
+  }
+
+  virtual ~ShardedClockCache() {
+    delete[] shards_;
+  }
+
+  void SetCapacity(size_t capacity) override {
+    int num_shards = 1 << num_shard_bits_;
+    const size_t per_shard = (capacity + (num_shards - 1)) / num_shards;
+    MutexLock l(&capacity_mutex_);
+    for (int s = 0; s < num_shards; s++) {
+      shards_[s].SetCapacity(per_shard);
+    }
+    capacity_ = capacity;
+  }
+
+  void SetStrictCapacityLimit(bool strict_capacity_limit) override {
+    int num_shards = 1 << num_shard_bits_;
+    for (int s = 0; s < num_shards; s++) {
+      shards_[s].SetStrictCapacityLimit(strict_capacity_limit);
+    }
+    strict_capacity_limit_ = strict_capacity_limit;
+  }
+
+  Status Insert(const Slice& key, const QueryId query_id, void* value, size_t charge,
+                void (*deleter)(const Slice& key, void* value),
+                Handle** handle, Statistics* statistics, Priority priority) override {
+    // Queries with no cache query ids are not cached.
+    if (query_id == kNoCacheQueryId) {
+      return Status::OK();
+    }
+    const uint32_t hash = HashSlice(key);
+    return shards_[Shard(hash)].Insert(key, hash, value, charge, deleter, handle, statistics,
+                                       priority);
+  }
+
+  Handle* Lookup(const Slice& key, const QueryId query_id, Statistics* statistics) override {
+    if (query_id == kNoCacheQueryId) {
+      return nullptr;
+    }
+    const uint32_t hash = HashSlice(key);
+    return shards_[Shard(hash)].Lookup(key, hash, statistics);
+  }
+
+  void Release(Handle* handle) override {
+    if (handle == nullptr) {
+      return;
+    }
+    ClockHandle* h = reinterpret_cast<ClockHandle*>(handle);
+    shards_[Shard(h->hash)].Release(handle);
+  }
+
+  void Erase(const Slice& key) override {
+    const uint32_t hash = HashSlice(key);
+    shards_[Shard(hash)].Erase(key, hash);
+  }
+
+  void* Value(Handle* handle) override {
+    return reinterpret_cast<ClockHandle*>(handle)->value;
+  }
+
+  uint64_t NewId() override {
+    return last_id_.fetch_add(1, std::memory_order_relaxed) + 1;
+  }
+
+  size_t GetCapacity() const override { return capacity_; }
+
+  bool HasStrictCapacityLimit() const override {
+    return strict_capacity_limit_;
+  }
+
+  size_t GetUsage() const override {
+    int num_shards = 1 << num_shard_bits_;
+    size_t usage = 0;
+    for (int s = 0; s < num_shards; s++) {
+      usage += shards_[s].GetUsage();
+    }
+    return usage;
+  }
+
+  size_t GetUsage(Handle* handle) const override {
+    return reinterpret_cast<ClockHandle*>(handle)->charge;
+  }
+
+  size_t GetPinnedUsage() const override {
+    int num_shards = 1 << num_shard_bits_;
+    size_t usage = 0;
+    for (int s = 0; s < num_shards; s++) {
+      usage += shards_[s].GetPinnedUsage();
+    }
+    return usage;
+  }
+
+  void DisownData() override {
+    shards_ = nullptr;
+  }
+
+  void ApplyToAllCacheEntries(void (*callback)(void*, size_t), bool thread_safe) override {
+    int num_shards = 1 << num_shard_bits_;
+    for (int s = 0; s < num_shards; s++) {
+      shards_[s].ApplyToAllCacheEntries(callback, thread_safe);
+    }
+  }
+
+  void SetMetrics(const scoped_refptr<yb::MetricEntity>& entity) override {
+    int num_shards = 1 << num_shard_bits_;
+    metrics_ = std::make_shared<yb::CacheMetrics>(entity);
+    for (int s = 0; s < num_shards; s++) {
+      shards_[s].SetMetrics(metrics_);
+    }
+  }
+
+ private:
+  static inline uint32_t HashSlice(const Slice& s) {
+    return Hash(s.data(), s.size(), 0);
+  }
+
+  uint32_t Shard(uint32_t hash) const {
+    // Note, hash >> 32 yields hash in gcc, not the zero we expect!
+    return (num_shard_bits_ > 0) ? (hash >> (32 - num_shard_bits_)) : 0;
+  }
+
+  ClockCacheShard* shards_;
+  port::Mutex capacity_mutex_;
+  std::atomic<uint64_t> last_id_;
+  int num_shard_bits_;
+  size_t capacity_;
+  bool strict_capacity_limit_;
+  std::shared_ptr<yb::CacheMetrics> metrics_;
+};
+
+}  // end anonymous namespace
+
+shared_ptr<Cache> NewClockCache(size_t capacity, int num_shard_bits, bool strict_capacity_limit) {
+  if (num_shard_bits >= 20) {
+    return nullptr;  // the cache cannot be sharded into too many fine pieces
+  }
+  return std::make_shared<ShardedClockCache>(capacity, num_shard_bits, strict_capacity_limit);
+}
+
+}  // namespace rocksdb
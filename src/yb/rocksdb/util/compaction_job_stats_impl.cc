@@ -40,6 +40,8 @@ void CompactionJobStats::Reset() {
   total_output_bytes = 0;
 
   num_records_replaced = 0;
+  num_records_dropped_by_filter = 0;
+  total_bytes_dropped_by_filter = 0;
 
   total_input_raw_key_bytes = 0;
   total_input_raw_value_bytes = 0;
@@ -69,6 +71,8 @@ void CompactionJobStats::Add(const CompactionJobStats& stats) {
   total_output_bytes += stats.total_output_bytes;
 
   num_records_replaced += stats.num_records_replaced;
+  num_records_dropped_by_filter += stats.num_records_dropped_by_filter;
+  total_bytes_dropped_by_filter += stats.total_bytes_dropped_by_filter;
 
   total_input_raw_key_bytes += stats.total_input_raw_key_bytes;
   total_input_raw_value_bytes += stats.total_input_raw_value_bytes;
@@ -25,7 +25,9 @@
 
 #include <algorithm>
 #include <limits>
+#include <memory>
 #include <string>
+#include <vector>
 
 #include "yb/rocksdb/options.h"
 #include "yb/rocksdb/util/coding.h"
@@ -49,6 +51,10 @@
 
 #if defined(ZSTD)
 #include <zstd.h>
+#if ZSTD_VERSION_NUMBER >= 10400
+#include <zdict.h>
+#define ROCKSDB_ZSTD_DICT_SUPPORTED
+#endif
 #endif
 
 namespace rocksdb {
@@ -102,6 +108,7 @@ inline bool CompressionTypeSupported(CompressionType compression_type) {
       return LZ4_Supported();
     case kLZ4HCCompression:
       return LZ4_Supported();
+    case kZSTD:
     case kZSTDNotFinalCompression:
       return ZSTD_Supported();
     default:
@@ -124,8 +131,10 @@ inline std::string CompressionTypeToString(CompressionType compression_type) {
       return "LZ4";
     case kLZ4HCCompression:
       return "LZ4HC";
-    case kZSTDNotFinalCompression:
+    case kZSTD:
       return "ZSTD";
+    case kZSTDNotFinalCompression:
+      return "ZSTDNotFinal";
     default:
       assert(false);
       return "";
@@ -620,8 +629,17 @@ inline bool LZ4HC_Compress(const CompressionOptions& opts,
   return false;
 }
 
+inline bool ZSTD_DictSupported() {
+#ifdef ROCKSDB_ZSTD_DICT_SUPPORTED
+  return true;
+#endif
+  return false;
+}
+
+// Compresses input with ZSTD, priming the compressor with compression_dict if it is not empty.
 inline bool ZSTD_Compress(const CompressionOptions& opts, const char* input,
-                          size_t length, ::std::string* output) {
+                          size_t length, ::std::string* output,
+                          const Slice& compression_dict = Slice()) {
 #ifdef ZSTD
   if (length > std::numeric_limits<uint32_t>::max()) {
     // Can't compress more than 4GB
@@ -633,9 +651,22 @@ inline bool ZSTD_Compress(const CompressionOptions& opts, const char* input,
 
   size_t compressBound = ZSTD_compressBound(length);
   output->resize(static_cast<size_t>(output_header_len + compressBound));
-  size_t outlen = ZSTD_compress(&(*output)[output_header_len], compressBound,
-                                input, length, opts.level);
-  if (outlen == 0) {
+  size_t outlen;
+#ifdef ROCKSDB_ZSTD_DICT_SUPPORTED
+  if (!compression_dict.empty()) {
+    ZSTD_CCtx* context = ZSTD_createCCtx();
+    outlen = ZSTD_compress_usingDict(
+        context, &(*output)[output_header_len], compressBound, input, length,
+        compression_dict.data(), compression_dict.size(), opts.level);
+    ZSTD_freeCCtx(context);
+  } else {
+    outlen = ZSTD_compress(&(*output)[output_header_len], compressBound, input, length,
+                           opts.level);
+  }
+#else
+  outlen = ZSTD_compress(&(*output)[output_header_len], compressBound, input, length, opts.level);
+#endif
+  if (outlen == 0 || ZSTD_isError(outlen)) {
     return false;
   }
   output->resize(output_header_len + outlen);
@@ -644,8 +675,11 @@ inline bool ZSTD_Compress(const CompressionOptions& opts, const char* input,
   return false;
 }
 
+// Blocks compressed without dictionary carry no dictionary id, so they are decompressed the same
+// way regardless of whether the file has a dictionary.
 inline char* ZSTD_Uncompress(const char* input_data, size_t input_length,
-                             int* decompress_size) {
+                             int* decompress_size,
+                             const Slice& compression_dict = Slice()) {
 #ifdef ZSTD
   uint32_t output_len = 0;
   if (!compression::GetDecompressedSizeInfo(&input_data, &input_length,
@@ -653,14 +687,54 @@ inline char* ZSTD_Uncompress(const char* input_data, size_t input_length,
     return nullptr;
   }
 
-  char* output = new char[output_len];
-  size_t actual_output_length =
-      ZSTD_decompress(output, output_len, input_data, input_length);
-  assert(actual_output_length == output_len);
+  std::unique_ptr<char[]> output(new char[output_len]);
+  size_t actual_output_length;
+#ifdef ROCKSDB_ZSTD_DICT_SUPPORTED
+  if (ZSTD_getDictID_fromFrame(input_data, input_length) != 0) {
+    if (compression_dict.empty()) {
+      return nullptr;
+    }
+    ZSTD_DCtx* context = ZSTD_createDCtx();
+    actual_output_length = ZSTD_decompress_usingDict(
+        context, output.get(), output_len, input_data, input_length, compression_dict.data(),
+        compression_dict.size());
+    ZSTD_freeDCtx(context);
+  } else {
+    actual_output_length = ZSTD_decompress(output.get(), output_len, input_data, input_length);
+  }
+#else
+  actual_output_length = ZSTD_decompress(output.get(), output_len, input_data, input_length);
+#endif
+  if (ZSTD_isError(actual_output_length) || actual_output_length != output_len) {
+    return nullptr;
+  }
   *decompress_size = static_cast<int>(actual_output_length);
-  return output;
+  return output.release();
 #endif
   return nullptr;
 }
 
+// Trains a ZSTD dictionary of at most max_dict_bytes from samples, which is the concatenation of
+// sample_sizes.size() samples. Returns an empty string if the dictionary could not be trained.
+inline std::string ZSTD_TrainDictionary(const std::string& samples,
+                                        const std::vector<size_t>& sample_sizes,
+                                        size_t max_dict_bytes) {
+#ifdef ROCKSDB_ZSTD_DICT_SUPPORTED
+  // ZSTD requires several samples to produce a meaningful dictionary.
+  if (sample_sizes.size() < 8) {
+    return std::string();
+  }
+  std::string dict_data(max_dict_bytes, '\0');
+  size_t dict_len = ZDICT_trainFromBuffer(
+      &dict_data[0], max_dict_bytes, samples.data(), sample_sizes.data(),
+      static_cast<unsigned>(sample_sizes.size()));
+  if (ZDICT_isError(dict_len)) {
+    return std::string();
+  }
+  dict_data.resize(dict_len);
+  return dict_data;
+#endif
+  return std::string();
+}
+
 }  // namespace rocksdb
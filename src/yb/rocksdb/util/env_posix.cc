@@ -182,14 +182,20 @@ class PosixEnv : public Env {
     result->reset();
     Status s;
     int fd;
+    int flags = O_RDONLY;
+#ifdef OS_LINUX
+    if (options.use_direct_reads) {
+      flags |= O_DIRECT;
+    }
+#endif
     {
       IOSTATS_TIMER_GUARD(open_nanos);
-      fd = open(fname.c_str(), O_RDONLY);
+      fd = open(fname.c_str(), flags);
     }
     SetFD_CLOEXEC(fd, &options);
     if (fd < 0) {
       s = STATUS_IO_ERROR(fname, errno);
-    } else if (options.use_mmap_reads && sizeof(void*) >= 8) {
+    } else if (options.use_mmap_reads && !options.use_direct_reads && sizeof(void*) >= 8) {
       // Use of mmap for random reads has been removed because it
       // kills performance when storage is fast.
       // Use mmap when virtual address-space is plentiful.
@@ -217,9 +223,15 @@ class PosixEnv : public Env {
     result->reset();
     Status s;
     int fd = -1;
+    int flags = O_CREAT | O_RDWR | O_TRUNC;
+#ifdef OS_LINUX
+    if (options.use_direct_writes && !options.use_mmap_writes) {
+      flags |= O_DIRECT;
+    }
+#endif
     do {
       IOSTATS_TIMER_GUARD(open_nanos);
-      fd = open(fname.c_str(), O_CREAT | O_RDWR | O_TRUNC, 0644);
+      fd = open(fname.c_str(), flags, 0644);
     } while (fd < 0 && errno == EINTR);
     if (fd < 0) {
       s = STATUS_IO_ERROR(fname, errno);
@@ -633,6 +645,7 @@ class PosixEnv : public Env {
                                  const DBOptions& db_options) const override {
     EnvOptions optimized = env_options;
     optimized.use_mmap_writes = false;
+    optimized.use_direct_writes = false;
     optimized.bytes_per_sync = db_options.wal_bytes_per_sync;
     // TODO(icanadi) it's faster if fallocate_with_keep_size is false, but it
     // breaks TransactionLogIteratorStallAtLastRecord unit test. Fix the unit
@@ -645,6 +658,7 @@ class PosixEnv : public Env {
       const EnvOptions& env_options) const override {
     EnvOptions optimized = env_options;
     optimized.use_mmap_writes = false;
+    optimized.use_direct_writes = false;
     optimized.fallocate_with_keep_size = true;
     return optimized;
   }
@@ -46,6 +46,7 @@
 #include "yb/rocksdb/env.h"
 #include "yb/rocksdb/port/port.h"
 #include "yb/rocksdb/util/coding.h"
+#include "yb/rocksdb/util/file_reader_writer.h"
 #include "yb/rocksdb/util/log_buffer.h"
 #include "yb/rocksdb/util/mutexlock.h"
 #include "yb/util/string_util.h"
@@ -808,6 +809,52 @@ TEST_F(EnvPosixTest, InvalidateCache) {
   // Delete the file
   ASSERT_OK(env_->DeleteFile(fname));
 }
+
+TEST_F(EnvPosixTest, DirectIO) {
+  EnvOptions soptions;
+  soptions.use_mmap_writes = false;
+  soptions.use_direct_writes = true;
+  soptions.use_direct_reads = true;
+  std::string fname = test::TmpDir() + "/" + "testfile_direct";
+
+  Random rnd(301);
+  // Sizes are not aligned, so writer has to pad and rewrite partial pages.
+  std::string data = RandomString(&rnd, 10000) + RandomString(&rnd, 7777);
+  {
+    unique_ptr<WritableFile> wfile;
+    Status s = env_->NewWritableFile(fname, &wfile, soptions);
+    if (s.IsIOError()) {
+      // File system does not support O_DIRECT, e.g. tmpfs.
+      LOG(INFO) << "Skipping direct I/O test: " << s.ToString();
+      return;
+    }
+    ASSERT_OK(s);
+    ASSERT_TRUE(wfile->UseDirectIO());
+    WritableFileWriter writer(std::move(wfile), soptions);
+    ASSERT_OK(writer.Append(Slice(data.data(), 10000)));
+    ASSERT_OK(writer.Flush());
+    ASSERT_OK(writer.Append(Slice(data.data() + 10000, data.size() - 10000)));
+    ASSERT_OK(writer.Sync(false));
+    ASSERT_OK(writer.Close());
+  }
+  uint64_t file_size = 0;
+  ASSERT_OK(env_->GetFileSize(fname, &file_size));
+  ASSERT_EQ(data.size(), file_size);
+
+  {
+    unique_ptr<RandomAccessFile> file;
+    ASSERT_OK(env_->NewRandomAccessFile(fname, &file, soptions));
+    std::string scratch(data.size(), 0);
+    Slice result;
+    for (auto range : std::vector<std::pair<size_t, size_t>>{
+        {0, data.size()}, {1, 100}, {4095, 2}, {9000, 5000}, {data.size() - 10, 100}}) {
+      ASSERT_OK(file->Read(range.first, range.second, &result, &scratch[0]));
+      const size_t expected_size = std::min(range.second, data.size() - range.first);
+      ASSERT_EQ(data.substr(range.first, expected_size), result.ToBuffer());
+    }
+  }
+  ASSERT_OK(env_->DeleteFile(fname));
+}
 #endif  // not TRAVIS
 #endif  // OS_LINUX
 
@@ -60,6 +60,99 @@ Status RandomAccessFileReader::Read(uint64_t offset, size_t n, Slice* result,
   return s;
 }
 
+void RandomAccessFileReader::MultiRead(ReadRequest* reqs, size_t num_reqs) const {
+  uint64_t elapsed = 0;
+  {
+    StopWatch sw(env_, stats_, hist_type_,
+                 (stats_ != nullptr) ? &elapsed : nullptr);
+    IOSTATS_TIMER_GUARD(read_nanos);
+    file_->MultiRead(reqs, num_reqs);
+    for (size_t i = 0; i != num_reqs; ++i) {
+      if (reqs[i].status.ok()) {
+        IOSTATS_ADD_IF_POSITIVE(bytes_read, reqs[i].result.size());
+      }
+    }
+  }
+  if (stats_ != nullptr && file_read_hist_ != nullptr) {
+    file_read_hist_->Add(elapsed);
+  }
+}
+
+FilePrefetchBuffer::FilePrefetchBuffer(
+    RandomAccessFileReader* file, Statistics* statistics, size_t max_readahead_size)
+    : file_(file),
+      statistics_(statistics),
+      max_readahead_size_(std::max(max_readahead_size, kInitialReadaheadSize)),
+      readahead_size_(kInitialReadaheadSize) {
+}
+
+FilePrefetchBuffer::~FilePrefetchBuffer() {
+  RecordWastedBytes();
+}
+
+void FilePrefetchBuffer::RecordWastedBytes() {
+  if (buffer_len_ > buffer_used_) {
+    RecordTick(statistics_, READAHEAD_WASTED_BYTES, buffer_len_ - buffer_used_);
+  }
+}
+
+Status FilePrefetchBuffer::Read(uint64_t offset, size_t n, Slice* result, char* scratch) {
+  if (offset >= buffer_offset_ && offset + n <= buffer_offset_ + buffer_len_) {
+    memcpy(scratch, buffer_.get() + (offset - buffer_offset_), n);
+    *result = Slice(scratch, n);
+    buffer_used_ += n;
+    prev_read_end_ = offset + n;
+    RecordTick(statistics_, READAHEAD_PREFETCH_HIT);
+    return Status::OK();
+  }
+
+  if (offset == prev_read_end_ && num_sequential_reads_ > 0) {
+    ++num_sequential_reads_;
+  } else {
+    num_sequential_reads_ = 1;
+    readahead_size_ = kInitialReadaheadSize;
+  }
+  prev_read_end_ = offset + n;
+
+  if (num_sequential_reads_ < kMinSequentialReads) {
+    return file_->Read(offset, n, result, scratch);
+  }
+
+  RecordWastedBytes();
+  buffer_len_ = 0;
+  buffer_used_ = 0;
+
+  const size_t read_size = std::max(n, readahead_size_);
+  if (buffer_capacity_ < read_size) {
+    buffer_.reset(new char[read_size]);
+    buffer_capacity_ = read_size;
+  }
+  Slice readahead_result;
+  RETURN_NOT_OK(file_->Read(offset, read_size, &readahead_result, buffer_.get()));
+
+  const size_t copied = std::min(n, readahead_result.size());
+  memcpy(scratch, readahead_result.data(), copied);
+  *result = Slice(scratch, copied);
+  RecordTick(statistics_, READAHEAD_BYTES_READ, readahead_result.size());
+
+  if (readahead_result.cdata() != buffer_.get()) {
+    // File returned a pointer to its own memory, e.g. mmap, so there is nothing to prefetch.
+    return Status::OK();
+  }
+  buffer_offset_ = offset;
+  buffer_len_ = readahead_result.size();
+  buffer_used_ = copied;
+
+  readahead_size_ = std::min(readahead_size_ * 2, max_readahead_size_);
+  if (buffer_len_ == read_size) {
+    // Start loading the next window while the current one is being consumed.
+    // Failure is not fatal, data would be read synchronously on the next refill.
+    WARN_NOT_OK(file_->file()->Prefetch(offset + buffer_len_, readahead_size_),
+                "Failed to prefetch file data");
+  }
+  return Status::OK();
+}
+
 Status WritableFileWriter::Append(const Slice& data) {
   const char* src = data.cdata();
   size_t left = data.size();
@@ -224,7 +317,9 @@ Status WritableFileWriter::Sync(bool use_fsync) {
     return s;
   }
   TEST_KILL_RANDOM("WritableFileWriter::Sync:0", rocksdb_kill_odds);
-  if (!direct_io_ && pending_sync_) {
+  // Direct I/O bypasses the OS cache, but file metadata and the device cache still have to be
+  // synced.
+  if (pending_sync_) {
     s = SyncInternal(use_fsync);
     if (!s.ok()) {
       return s;
@@ -464,6 +559,8 @@ class ReadaheadRandomAccessFile : public RandomAccessFile {
 
   void Hint(AccessPattern pattern) override { file_->Hint(pattern); }
 
+  Status Prefetch(uint64_t offset, size_t n) override { return file_->Prefetch(offset, n); }
+
   Status InvalidateCache(size_t offset, size_t length) override {
     return file_->InvalidateCache(offset, length);
   }
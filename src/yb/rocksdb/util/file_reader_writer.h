@@ -103,9 +103,59 @@ class RandomAccessFileReader {
 
   Status Read(uint64_t offset, size_t n, Slice* result, char* scratch) const;
 
+  void MultiRead(ReadRequest* reqs, size_t num_reqs) const;
+
   RandomAccessFile* file() { return file_.get(); }
 };
 
+// Per-iterator buffer used to prefetch data of a file which is read sequentially.
+// Once kMinSequentialReads reads in a row start where the previous one ended, the buffer begins to
+// read ahead. The readahead window starts at kInitialReadaheadSize and doubles on every refill up to
+// max_readahead_size, while the platform is asked to asynchronously load the following window,
+// so the next refill is normally served without waiting for the device.
+// Not thread safe.
+class FilePrefetchBuffer {
+ public:
+  static constexpr size_t kMinSequentialReads = 2;
+  static constexpr size_t kInitialReadaheadSize = 8 * 1024;
+  static constexpr size_t kDefaultMaxReadaheadSize = 256 * 1024;
+
+  FilePrefetchBuffer(RandomAccessFileReader* file, Statistics* statistics,
+                     size_t max_readahead_size = kDefaultMaxReadaheadSize);
+
+  FilePrefetchBuffer(const FilePrefetchBuffer&) = delete;
+  FilePrefetchBuffer& operator=(const FilePrefetchBuffer&) = delete;
+
+  // Records prefetched bytes that were never read as wasted.
+  ~FilePrefetchBuffer();
+
+  // Same contract as RandomAccessFileReader::Read. The data is copied to scratch when it is served
+  // from the prefetched buffer.
+  Status Read(uint64_t offset, size_t n, Slice* result, char* scratch);
+
+  size_t readahead_size() const { return readahead_size_; }
+
+ private:
+  void RecordWastedBytes();
+
+  RandomAccessFileReader* const file_;
+  Statistics* const statistics_;
+  const size_t max_readahead_size_;
+  size_t readahead_size_;
+
+  // Number of sequential reads in a row, including current one.
+  size_t num_sequential_reads_ = 0;
+  // End offset of the previous read.
+  uint64_t prev_read_end_ = 0;
+
+  std::unique_ptr<char[]> buffer_;
+  size_t buffer_capacity_ = 0;
+  uint64_t buffer_offset_ = 0;
+  size_t buffer_len_ = 0;
+  // Number of bytes of the buffer already returned to the caller.
+  size_t buffer_used_ = 0;
+};
+
 // Use posix write to write data to a file.
 class WritableFileWriter {
  private:
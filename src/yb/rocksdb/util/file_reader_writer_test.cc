@@ -21,6 +21,7 @@
 #include "yb/rocksdb/util/file_reader_writer.h"
 #include "yb/rocksdb/util/random.h"
 #include "yb/rocksdb/util/testharness.h"
+#include "yb/rocksdb/util/testutil.h"
 
 namespace rocksdb {
 
@@ -139,6 +140,47 @@ TEST_F(WritableFileWriterTest, AppendStatusReturn) {
   ASSERT_NOK(writer->Append(std::string(2 * kMb, 'b')));
 }
 
+class FilePrefetchBufferTest : public testing::Test {};
+
+TEST_F(FilePrefetchBufferTest, SequentialReads) {
+  constexpr size_t kBlockSize = 4 * 1024;
+  Random rnd(301);
+  const std::string data = RandomString(&rnd, kMb);
+  auto* source = new test::StringSource(data);
+  RandomAccessFileReader reader((std::unique_ptr<RandomAccessFile>(source)));
+  auto statistics = CreateDBStatistics();
+
+  {
+    FilePrefetchBuffer prefetch_buffer(&reader, statistics.get());
+    std::string scratch(kBlockSize, 0);
+    Slice result;
+    for (size_t offset = 0; offset < data.size(); offset += kBlockSize) {
+      ASSERT_OK(prefetch_buffer.Read(offset, kBlockSize, &result, &scratch[0]));
+      ASSERT_EQ(data.substr(offset, kBlockSize), result.ToBuffer());
+    }
+    ASSERT_EQ(FilePrefetchBuffer::kDefaultMaxReadaheadSize, prefetch_buffer.readahead_size());
+
+    // Window grows from 8KB to 256KB, so a scan of 1MB takes 10 reads instead of 256.
+    ASSERT_EQ(10, source->total_reads());
+    ASSERT_GT(statistics->getTickerCount(READAHEAD_PREFETCH_HIT), data.size() / kBlockSize / 2);
+    ASSERT_EQ(0, statistics->getTickerCount(READAHEAD_WASTED_BYTES));
+
+    // Random read resets the readahead window.
+    ASSERT_OK(prefetch_buffer.Read(kBlockSize, kBlockSize, &result, &scratch[0]));
+    ASSERT_EQ(data.substr(kBlockSize, kBlockSize), result.ToBuffer());
+    ASSERT_EQ(FilePrefetchBuffer::kInitialReadaheadSize, prefetch_buffer.readahead_size());
+
+    // Start a new sequential run that stops in the middle of the prefetched window.
+    ASSERT_OK(prefetch_buffer.Read(2 * kBlockSize, kBlockSize, &result, &scratch[0]));
+    ASSERT_EQ(data.substr(2 * kBlockSize, kBlockSize), result.ToBuffer());
+  }
+  ASSERT_EQ(FilePrefetchBuffer::kInitialReadaheadSize - kBlockSize,
+            statistics->getTickerCount(READAHEAD_WASTED_BYTES));
+  // Only the first read of each sequential run bypasses the buffer.
+  ASSERT_EQ(data.size() - kBlockSize + FilePrefetchBuffer::kInitialReadaheadSize,
+            statistics->getTickerCount(READAHEAD_BYTES_READ));
+}
+
 }  // namespace rocksdb
 
 int main(int argc, char** argv) {
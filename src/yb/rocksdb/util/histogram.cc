@@ -27,6 +27,8 @@
 #include <math.h>
 #include <stdio.h>
 
+#include <algorithm>
+
 #include "yb/rocksdb/port/port.h"
 #include "yb/gutil/port.h"
 
@@ -65,22 +67,17 @@ HistogramBucketMapper::HistogramBucketMapper()
       maxBucketValue_(bucketValues_.back()),
       minBucketValue_(bucketValues_.front()) {
   assert(kHistogramNumBuckets == BucketCount());
-  for (size_t i =0; i < bucketValues_.size(); ++i) {
-    valueIndexMap_[bucketValues_[i]] = i;
-  }
+  assert(std::is_sorted(bucketValues_.begin(), bucketValues_.end()));
 }
 
 size_t HistogramBucketMapper::IndexForValue(const uint64_t value) const {
   if (value >= maxBucketValue_) {
     return bucketValues_.size() - 1;
   } else if ( value >= minBucketValue_ ) {
-    std::map<uint64_t, uint64_t>::const_iterator lowerBound =
-      valueIndexMap_.lower_bound(value);
-    if (lowerBound != valueIndexMap_.end()) {
-      return static_cast<size_t>(lowerBound->second);
-    } else {
-      return 0;
-    }
+    // Binary search over the contiguous bucket limits is much cheaper than walking a tree, and
+    // this is done for every recorded value.
+    return std::lower_bound(bucketValues_.begin(), bucketValues_.end(), value) -
+           bucketValues_.begin();
   } else {
     return 0;
   }
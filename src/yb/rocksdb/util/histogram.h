@@ -66,7 +66,6 @@ class HistogramBucketMapper {
   const std::vector<uint64_t> bucketValues_;
   const uint64_t maxBucketValue_;
   const uint64_t minBucketValue_;
-  std::map<uint64_t, uint64_t> valueIndexMap_;
 
 };
 
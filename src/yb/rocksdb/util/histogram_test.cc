@@ -68,6 +68,18 @@ TEST_F(HistogramTest, ClearHistogram) {
   ASSERT_EQ(histogram.Average(), 0);
 }
 
+TEST_F(HistogramTest, BucketIndex) {
+  HistogramBucketMapper mapper;
+  ASSERT_EQ(0U, mapper.IndexForValue(0));
+  ASSERT_EQ(0U, mapper.IndexForValue(1));
+  for (size_t i = 1; i != mapper.BucketCount(); ++i) {
+    // Each bucket covers values above the limit of the previous one up to its own limit.
+    ASSERT_EQ(i, mapper.IndexForValue(mapper.BucketLimit(i - 1) + 1));
+    ASSERT_EQ(i, mapper.IndexForValue(mapper.BucketLimit(i)));
+  }
+  ASSERT_EQ(mapper.BucketCount() - 1, mapper.IndexForValue(mapper.LastValue() * 2));
+}
+
 TEST_F(HistogramTest, BigValues) {
   double values[] = {0, 0, 1e19, 1e19};
   HistogramImpl histogram;
@@ -42,6 +42,7 @@
 #endif
 #include "yb/rocksdb/port/port.h"
 #include "yb/util/slice.h"
+#include "yb/rocksdb/util/aligned_buffer.h"
 #include "yb/rocksdb/util/coding.h"
 #include "yb/rocksdb/util/iostats_context_imp.h"
 #include "yb/rocksdb/util/posix_logger.h"
@@ -50,6 +51,14 @@
 
 namespace rocksdb {
 
+namespace {
+
+// Alignment of offsets, sizes and memory buffers used for direct I/O. Logical block size of
+// devices does not exceed the page size in practice.
+constexpr size_t kDirectIOAlignment = 4 * 1024;
+
+} // namespace
+
 // A wrapper for fadvise, if the platform doesn't support fadvise,
 // it will simply return Status::NotSupport.
 int Fadvise(int fd, off_t offset, size_t len, int advice) {
@@ -155,14 +164,20 @@ static size_t GetUniqueIdFromFile(int fd, char* id, size_t max_size) {
  */
 PosixRandomAccessFile::PosixRandomAccessFile(const std::string& fname, int fd,
                                              const EnvOptions& options)
-    : filename_(fname), fd_(fd), use_os_buffer_(options.use_os_buffer) {
-  assert(!options.use_mmap_reads || sizeof(void*) < 8);
+    : filename_(fname),
+      fd_(fd),
+      use_os_buffer_(options.use_os_buffer),
+      use_direct_io_(options.use_direct_reads) {
+  assert(!options.use_mmap_reads || sizeof(void*) < 8 || options.use_direct_reads);
 }
 
 PosixRandomAccessFile::~PosixRandomAccessFile() { close(fd_); }
 
 Status PosixRandomAccessFile::Read(uint64_t offset, size_t n, Slice* result,
                                    char* scratch) const {
+  if (use_direct_io_) {
+    return DirectRead(offset, n, result, scratch);
+  }
   Status s;
   ssize_t r = -1;
   size_t left = n;
@@ -194,6 +209,66 @@ Status PosixRandomAccessFile::Read(uint64_t offset, size_t n, Slice* result,
   return s;
 }
 
+// Reads the aligned range covering the requested one into a temporary aligned buffer, since the
+// caller's scratch has no alignment guarantees.
+Status PosixRandomAccessFile::DirectRead(uint64_t offset, size_t n, Slice* result,
+                                         char* scratch) const {
+  const uint64_t aligned_offset = offset - offset % kDirectIOAlignment;
+  const size_t offset_in_buffer = static_cast<size_t>(offset - aligned_offset);
+  const size_t aligned_size = Roundup(offset_in_buffer + n, kDirectIOAlignment);
+
+  AlignedBuffer buffer;
+  buffer.Alignment(kDirectIOAlignment);
+  buffer.AllocateNewBuffer(aligned_size);
+
+  char* ptr = buffer.Destination();
+  uint64_t read_offset = aligned_offset;
+  size_t left = aligned_size;
+  ssize_t r = -1;
+  while (left > 0) {
+    r = pread(fd_, ptr, left, static_cast<off_t>(read_offset));
+    if (r <= 0) {
+      if (r < 0 && errno == EINTR) {
+        continue;
+      }
+      break;
+    }
+    ptr += r;
+    read_offset += r;
+    left -= r;
+    if (r % kDirectIOAlignment != 0) {
+      // Partial page could only be read at the end of file.
+      break;
+    }
+  }
+  if (r < 0) {
+    *result = Slice();
+    return STATUS_IO_ERROR(filename_, errno);
+  }
+
+  const size_t bytes_read = aligned_size - left;
+  const size_t copied = bytes_read > offset_in_buffer
+      ? std::min(n, bytes_read - offset_in_buffer) : 0;
+  memcpy(scratch, buffer.BufferStart() + offset_in_buffer, copied);
+  *result = Slice(scratch, copied);
+  return Status::OK();
+}
+
+void PosixRandomAccessFile::MultiRead(ReadRequest* reqs, size_t num_reqs) const {
+#ifdef OS_LINUX
+  // Queue all reads to the page cache first, so the device serves them in parallel, and the
+  // following preads mostly wait for the slowest read instead of the sum of them.
+  if (num_reqs > 1 && use_os_buffer_ && !use_direct_io_) {
+    for (size_t i = 0; i != num_reqs; ++i) {
+      Fadvise(fd_, reqs[i].offset, reqs[i].len, POSIX_FADV_WILLNEED);
+    }
+  }
+#endif
+  for (size_t i = 0; i != num_reqs; ++i) {
+    reqs[i].status = Read(reqs[i].offset, reqs[i].len, &reqs[i].result, reqs[i].scratch);
+  }
+}
+
 #ifdef OS_LINUX
 size_t PosixRandomAccessFile::GetUniqueId(char* id, size_t max_size) const {
   return GetUniqueIdFromFile(fd_, id, max_size);
@@ -223,6 +298,24 @@ void PosixRandomAccessFile::Hint(AccessPattern pattern) {
   }
 }
 
+Status PosixRandomAccessFile::Prefetch(uint64_t offset, size_t n) {
+#ifndef OS_LINUX
+  return Status::OK();
+#else
+  // Page cache is bypassed by direct reads, so there is nothing to load it with.
+  if (use_direct_io_ || !use_os_buffer_) {
+    return Status::OK();
+  }
+  // Only queues the read, the data is brought into the page cache in background.
+  int ret = Fadvise(fd_, offset, n, POSIX_FADV_WILLNEED);
+  if (ret == 0) {
+    return Status::OK();
+  }
+  // posix_fadvise returns the error number instead of setting errno.
+  return STATUS_IO_ERROR(filename_, ret);
+#endif
+}
+
 Status PosixRandomAccessFile::InvalidateCache(size_t offset, size_t length) {
 #ifndef OS_LINUX
   return Status::OK();
@@ -517,7 +610,7 @@ Status PosixMmapFile::Allocate(uint64_t offset, uint64_t len) {
  */
 PosixWritableFile::PosixWritableFile(const std::string& fname, int fd,
                                      const EnvOptions& options)
-    : filename_(fname), fd_(fd), filesize_(0) {
+    : filename_(fname), fd_(fd), filesize_(0), use_direct_io_(options.use_direct_writes) {
 #ifdef ROCKSDB_FALLOCATE_PRESENT
   allow_fallocate_ = options.allow_fallocate;
   fallocate_with_keep_size_ = options.fallocate_with_keep_size;
@@ -549,6 +642,40 @@ Status PosixWritableFile::Append(const Slice& data) {
   return Status::OK();
 }
 
+Status PosixWritableFile::PositionedAppend(const Slice& data, uint64_t offset) {
+  assert(!use_direct_io_ || (offset % kDirectIOAlignment == 0 &&
+                             data.size() % kDirectIOAlignment == 0 &&
+                             reinterpret_cast<uintptr_t>(data.data()) % kDirectIOAlignment == 0));
+  const char* src = data.cdata();
+  size_t left = data.size();
+  uint64_t write_offset = offset;
+  while (left != 0) {
+    ssize_t done = pwrite(fd_, src, left, static_cast<off_t>(write_offset));
+    if (done < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return STATUS_IO_ERROR(filename_, errno);
+    }
+    left -= done;
+    src += done;
+    write_offset += done;
+  }
+  filesize_ = std::max(filesize_, write_offset);
+  return Status::OK();
+}
+
+Status PosixWritableFile::Truncate(uint64_t size) {
+  if (!use_direct_io_) {
+    return Status::OK();
+  }
+  if (ftruncate(fd_, static_cast<off_t>(size)) < 0) {
+    return STATUS_IO_ERROR(filename_, errno);
+  }
+  filesize_ = size;
+  return Status::OK();
+}
+
 Status PosixWritableFile::Close() {
   Status s;
 
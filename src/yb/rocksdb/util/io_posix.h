@@ -63,6 +63,10 @@ class PosixRandomAccessFile : public RandomAccessFile {
   std::string filename_;
   int fd_;
   bool use_os_buffer_;
+  // File was opened with O_DIRECT, so reads have to be aligned.
+  bool use_direct_io_;
+
+  Status DirectRead(uint64_t offset, size_t n, Slice* result, char* scratch) const;
 
  public:
   PosixRandomAccessFile(const std::string& fname, int fd,
@@ -71,10 +75,12 @@ class PosixRandomAccessFile : public RandomAccessFile {
 
   virtual Status Read(uint64_t offset, size_t n, Slice* result,
                       char* scratch) const override;
+  virtual void MultiRead(ReadRequest* reqs, size_t num_reqs) const override;
 #ifdef OS_LINUX
   virtual size_t GetUniqueId(char* id, size_t max_size) const override;
 #endif
   virtual void Hint(AccessPattern pattern) override;
+  virtual Status Prefetch(uint64_t offset, size_t n) override;
   virtual Status InvalidateCache(size_t offset, size_t length) override;
 };
 
@@ -83,6 +89,8 @@ class PosixWritableFile : public WritableFile {
   const std::string filename_;
   int fd_;
   uint64_t filesize_;
+  // File was opened with O_DIRECT, only aligned positioned writes are used.
+  const bool use_direct_io_;
 #ifdef ROCKSDB_FALLOCATE_PRESENT
   bool allow_fallocate_;
   bool fallocate_with_keep_size_;
@@ -94,10 +102,14 @@ class PosixWritableFile : public WritableFile {
   ~PosixWritableFile();
 
   // Means Close() will properly take care of truncate
-  // and it does not need any additional information
-  virtual Status Truncate(uint64_t size) override { return Status::OK(); }
+  // and it does not need any additional information. With direct I/O the padding
+  // of the last written page is trimmed here.
+  virtual Status Truncate(uint64_t size) override;
   virtual Status Close() override;
   virtual Status Append(const Slice& data) override;
+  virtual Status PositionedAppend(const Slice& data, uint64_t offset) override;
+  virtual bool UseOSBuffer() const override { return !use_direct_io_; }
+  virtual bool UseDirectIO() const override { return use_direct_io_; }
   virtual Status Flush() override;
   virtual Status Sync() override;
   virtual Status Fsync() override;
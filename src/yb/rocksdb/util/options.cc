@@ -70,6 +70,7 @@ ImmutableCFOptions::ImmutableCFOptions(const Options& options)
       merge_operator(options.merge_operator.get()),
       compaction_filter(options.compaction_filter),
       compaction_filter_factory(options.compaction_filter_factory.get()),
+      compaction_file_filter_factory(options.compaction_file_filter_factory.get()),
       inplace_update_support(options.inplace_update_support),
       inplace_callback(options.inplace_callback),
       info_log(options.info_log.get()),
@@ -151,6 +152,7 @@ ColumnFamilyOptions::ColumnFamilyOptions()
       memtable_prefix_bloom_bits(0),
       memtable_prefix_bloom_probes(6),
       memtable_prefix_bloom_huge_page_tlb_size(0),
+      memtable_huge_page_size(0),
       bloom_locality(0),
       max_successive_merges(0),
       min_partial_merge_operands(2),
@@ -165,6 +167,7 @@ ColumnFamilyOptions::ColumnFamilyOptions(const Options& options)
       merge_operator(options.merge_operator),
       compaction_filter(options.compaction_filter),
       compaction_filter_factory(options.compaction_filter_factory),
+      compaction_file_filter_factory(options.compaction_file_filter_factory),
       write_buffer_size(options.write_buffer_size),
       max_write_buffer_number(options.max_write_buffer_number),
       min_write_buffer_number_to_merge(
@@ -220,6 +223,7 @@ ColumnFamilyOptions::ColumnFamilyOptions(const Options& options)
       memtable_prefix_bloom_probes(options.memtable_prefix_bloom_probes),
       memtable_prefix_bloom_huge_page_tlb_size(
           options.memtable_prefix_bloom_huge_page_tlb_size),
+      memtable_huge_page_size(options.memtable_huge_page_size),
       bloom_locality(options.bloom_locality),
       max_successive_merges(options.max_successive_merges),
       min_partial_merge_operands(options.min_partial_merge_operands),
@@ -272,6 +276,8 @@ DBOptions::DBOptions()
       WAL_size_limit_MB(0),
       manifest_preallocation_size(4 * 1024 * 1024),
       allow_os_buffer(true),
+      use_direct_reads(false),
+      use_direct_io_for_flush_and_compaction(false),
       allow_mmap_reads(false),
       allow_mmap_writes(false),
       allow_fallocate(true),
@@ -362,6 +368,10 @@ void DBOptions::Dump(Logger* log) const {
          manifest_preallocation_size);
   RHEADER(log, "                         Options.allow_os_buffer: %d",
       allow_os_buffer);
+  RHEADER(log, "                        Options.use_direct_reads: %d",
+      use_direct_reads);
+  RHEADER(log, "  Options.use_direct_io_for_flush_and_compaction: %d",
+      use_direct_io_for_flush_and_compaction);
   RHEADER(log, "                        Options.allow_mmap_reads: %d",
       allow_mmap_reads);
   RHEADER(log, "                       Options.allow_mmap_writes: %d",
@@ -437,6 +447,8 @@ void ColumnFamilyOptions::Dump(Logger* log) const {
       compaction_filter ? compaction_filter->Name() : "None");
   RHEADER(log, "       Options.compaction_filter_factory: %s",
       compaction_filter_factory ? compaction_filter_factory->Name() : "None");
+  RHEADER(log, "  Options.compaction_file_filter_factory: %s",
+      compaction_file_filter_factory ? compaction_file_filter_factory->Name() : "None");
   RHEADER(log, "        Options.memtable_factory: %s", memtable_factory->Name());
   RHEADER(log, "           Options.table_factory: %s", table_factory->Name());
   RHEADER(log, "           table_factory options: %s",
@@ -466,6 +478,10 @@ void ColumnFamilyOptions::Dump(Logger* log) const {
       compression_opts.level);
   RHEADER(log, "              Options.compression_opts.strategy: %d",
       compression_opts.strategy);
+  RHEADER(log, "        Options.compression_opts.max_dict_bytes: %" PRIu32,
+      compression_opts.max_dict_bytes);
+  RHEADER(log, "  Options.compression_opts.zstd_max_train_bytes: %" PRIu32,
+      compression_opts.zstd_max_train_bytes);
   RHEADER(log, "     Options.level0_file_num_compaction_trigger: %d",
       level0_file_num_compaction_trigger);
   RHEADER(log, "         Options.level0_slowdown_writes_trigger: %d",
@@ -555,6 +571,8 @@ void ColumnFamilyOptions::Dump(Logger* log) const {
   RHEADER(log,
       "  Options.memtable_prefix_bloom_huge_page_tlb_size: %" ROCKSDB_PRIszt,
          memtable_prefix_bloom_huge_page_tlb_size);
+  RHEADER(log, "                 Options.memtable_huge_page_size: %" ROCKSDB_PRIszt,
+      memtable_huge_page_size);
   RHEADER(log, "                          Options.bloom_locality: %d",
       bloom_locality);
 
@@ -707,6 +725,7 @@ ReadOptions::ReadOptions()
       total_order_seek(false),
       prefix_same_as_start(false),
       pin_data(false),
+      adaptive_readahead(false),
       query_id(rocksdb::kDefaultQueryId) {
   XFUNC_TEST("", "managed_options", managed_options, xf_manage_options,
              reinterpret_cast<ReadOptions*>(this));
@@ -723,6 +742,7 @@ ReadOptions::ReadOptions(bool cksum, bool cache)
       total_order_seek(false),
       prefix_same_as_start(false),
       pin_data(false),
+      adaptive_readahead(false),
       query_id(rocksdb::kDefaultQueryId) {
   XFUNC_TEST("", "managed_options", managed_options, xf_manage_options,
              reinterpret_cast<ReadOptions*>(this));
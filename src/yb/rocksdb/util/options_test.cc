@@ -1678,6 +1678,8 @@ Status GetFromString(DBOptions* source, DBOptions* destination) {
       "create_if_missing=true;"
       "error_if_exists=true;"
       "allow_os_buffer=true;"
+      "use_direct_reads=false;"
+      "use_direct_io_for_flush_and_compaction=false;"
       "delayed_write_rate=4294976214;"
       "manifest_preallocation_size=1222;"
       "allow_mmap_writes=true;"
@@ -1723,6 +1725,7 @@ Status GetFromString(ColumnFamilyOptions* source, ColumnFamilyOptions* destinati
       "bloom_locality=8016;"
       "target_file_size_base=4294976376;"
       "memtable_prefix_bloom_huge_page_tlb_size=2557;"
+      "memtable_huge_page_size=2097152;"
       "max_successive_merges=5497;"
       "max_sequential_skip_in_iterations=4294971408;"
       "arena_block_size=1893;"
@@ -22,20 +22,114 @@
 // found in the LICENSE file. See the AUTHORS file for names of contributors.
 
 #include "yb/rocksdb/util/rate_limiter.h"
+
+#include <algorithm>
+
 #include "yb/rocksdb/env.h"
+#include "yb/rocksdb/util/statistics.h"
 
 namespace rocksdb {
 
+namespace {
+
+const Tickers kWaitTickers[Env::IO_TOTAL] = {
+    RATE_LIMITER_BACKGROUND_WAIT_MICROS,
+    RATE_LIMITER_LARGE_COMPACTION_WAIT_MICROS,
+    RATE_LIMITER_SMALL_COMPACTION_WAIT_MICROS,
+    RATE_LIMITER_FLUSH_WAIT_MICROS,
+};
+
+} // namespace
 
 // Pending request
 struct GenericRateLimiter::Req {
-  explicit Req(int64_t _bytes, port::Mutex* _mu)
-      : bytes(_bytes), cv(_mu), granted(false) {}
+  explicit Req(int64_t _bytes, Env::IOPriority _pri, Tenant* _tenant, port::Mutex* _mu)
+      : bytes(_bytes), pri(_pri), tenant(_tenant), cv(_mu), granted(false) {}
   int64_t bytes;
+  Env::IOPriority pri;
+  Tenant* tenant;
   port::CondVar cv;
   bool granted;
 };
 
+// Requests of one tenant. Within a priority, the tenant with the smallest virtual time is served
+// first, and every granted request advances the virtual time of its tenant by bytes / weight.
+struct GenericRateLimiter::Tenant {
+  explicit Tenant(int _weight) : weight(_weight) {}
+
+  const int weight;
+  std::deque<Req*> queue[Env::IO_TOTAL];
+  double virtual_time[Env::IO_TOTAL] = {};
+  Counters counters;
+};
+
+class GenericRateLimiter::TenantRateLimiter : public RateLimiter {
+ public:
+  TenantRateLimiter(GenericRateLimiter* parent, int weight,
+                    std::shared_ptr<Statistics> statistics)
+      : parent_(parent), tenant_(weight), statistics_(std::move(statistics)) {
+    MutexLock g(&parent_->request_mutex_);
+    parent_->tenants_.push_back(&tenant_);
+  }
+
+  ~TenantRateLimiter() {
+    parent_->RemoveTenant(&tenant_);
+  }
+
+  // Changes the rate of the shared rate limiter.
+  void SetBytesPerSecond(int64_t bytes_per_second) override {
+    parent_->SetBytesPerSecond(bytes_per_second);
+  }
+
+  void Request(const int64_t bytes, const Env::IOPriority pri) override {
+    auto wait_micros = parent_->Request(bytes, pri, &tenant_);
+    if (wait_micros > 0) {
+      RecordTick(statistics_.get(), kWaitTickers[pri], wait_micros);
+    }
+  }
+
+  int64_t GetSingleBurstBytes() const override {
+    return parent_->GetSingleBurstBytes();
+  }
+
+  int64_t GetTotalBytesThrough(const Env::IOPriority pri = Env::IO_TOTAL) const override {
+    MutexLock g(&parent_->request_mutex_);
+    return tenant_.counters.Get(tenant_.counters.total_bytes_through, pri);
+  }
+
+  int64_t GetTotalRequests(const Env::IOPriority pri = Env::IO_TOTAL) const override {
+    MutexLock g(&parent_->request_mutex_);
+    return tenant_.counters.Get(tenant_.counters.total_requests, pri);
+  }
+
+  int64_t GetTotalWaitMicros(const Env::IOPriority pri = Env::IO_TOTAL) const override {
+    MutexLock g(&parent_->request_mutex_);
+    return tenant_.counters.Get(tenant_.counters.total_wait_micros, pri);
+  }
+
+  std::shared_ptr<RateLimiter> NewTenant(
+      int weight, std::shared_ptr<Statistics> statistics) override {
+    return parent_->NewTenant(weight, std::move(statistics));
+  }
+
+ private:
+  GenericRateLimiter* const parent_;
+  Tenant tenant_;
+  std::shared_ptr<Statistics> statistics_;
+};
+
+int64_t GenericRateLimiter::Counters::Get(
+    const int64_t (&values)[Env::IO_TOTAL], Env::IOPriority pri) const {
+  if (pri != Env::IO_TOTAL) {
+    return values[pri];
+  }
+  int64_t result = 0;
+  for (auto value : values) {
+    result += value;
+  }
+  return result;
+}
+
 GenericRateLimiter::GenericRateLimiter(int64_t rate_bytes_per_sec,
                                        int64_t refill_period_us,
                                        int32_t fairness)
@@ -50,23 +144,23 @@ GenericRateLimiter::GenericRateLimiter(int64_t rate_bytes_per_sec,
       next_refill_us_(env_->NowMicros()),
       fairness_(fairness > 100 ? 100 : fairness),
       rnd_((uint32_t)time(nullptr)),
-      leader_(nullptr) {
-  total_requests_[0] = 0;
-  total_requests_[1] = 0;
-  total_bytes_through_[0] = 0;
-  total_bytes_through_[1] = 0;
+      leader_(nullptr),
+      default_tenant_(new Tenant(1)) {
+  tenants_.push_back(default_tenant_.get());
 }
 
 GenericRateLimiter::~GenericRateLimiter() {
   MutexLock g(&request_mutex_);
+  assert(tenants_.size() == 1);
   stop_ = true;
-  requests_to_wait_ = static_cast<int32_t>(queue_[Env::IO_LOW].size() +
-                                           queue_[Env::IO_HIGH].size());
-  for (auto& r : queue_[Env::IO_HIGH]) {
-    r->cv.Signal();
-  }
-  for (auto& r : queue_[Env::IO_LOW]) {
-    r->cv.Signal();
+  requests_to_wait_ = 0;
+  for (auto* tenant : tenants_) {
+    for (auto& queue : tenant->queue) {
+      requests_to_wait_ += static_cast<int32_t>(queue.size());
+      for (auto& r : queue) {
+        r->cv.Signal();
+      }
+    }
   }
   while (requests_to_wait_ > 0) {
     exit_cv_.Wait();
@@ -81,46 +175,82 @@ void GenericRateLimiter::SetBytesPerSecond(int64_t bytes_per_second) {
       std::memory_order_relaxed);
 }
 
+int64_t GenericRateLimiter::GetTotalBytesThrough(const Env::IOPriority pri) const {
+  MutexLock g(&request_mutex_);
+  return counters_.Get(counters_.total_bytes_through, pri);
+}
+
+int64_t GenericRateLimiter::GetTotalRequests(const Env::IOPriority pri) const {
+  MutexLock g(&request_mutex_);
+  return counters_.Get(counters_.total_requests, pri);
+}
+
+int64_t GenericRateLimiter::GetTotalWaitMicros(const Env::IOPriority pri) const {
+  MutexLock g(&request_mutex_);
+  return counters_.Get(counters_.total_wait_micros, pri);
+}
+
+std::shared_ptr<RateLimiter> GenericRateLimiter::NewTenant(
+    int weight, std::shared_ptr<Statistics> statistics) {
+  assert(weight > 0);
+  return std::make_shared<TenantRateLimiter>(this, weight, std::move(statistics));
+}
+
+void GenericRateLimiter::RemoveTenant(Tenant* tenant) {
+  MutexLock g(&request_mutex_);
+#ifndef NDEBUG
+  for (const auto& queue : tenant->queue) {
+    assert(queue.empty());
+  }
+#endif
+  tenants_.erase(std::remove(tenants_.begin(), tenants_.end(), tenant), tenants_.end());
+}
+
 void GenericRateLimiter::Request(int64_t bytes, const Env::IOPriority pri) {
+  Request(bytes, pri, default_tenant_.get());
+}
+
+int64_t GenericRateLimiter::Request(int64_t bytes, Env::IOPriority pri, Tenant* tenant) {
   assert(bytes <= refill_bytes_per_period_.load(std::memory_order_relaxed));
+  assert(pri < Env::IO_TOTAL);
 
   MutexLock g(&request_mutex_);
   if (stop_) {
-    return;
+    return 0;
   }
 
-  ++total_requests_[pri];
+  ++counters_.total_requests[pri];
+  ++tenant->counters.total_requests[pri];
 
   if (available_bytes_ >= bytes) {
     // Refill thread assigns quota and notifies requests waiting on
     // the queue under mutex. So if we get here, that means nobody
     // is waiting?
     available_bytes_ -= bytes;
-    total_bytes_through_[pri] += bytes;
-    return;
+    counters_.total_bytes_through[pri] += bytes;
+    tenant->counters.total_bytes_through[pri] += bytes;
+    return 0;
   }
 
   // Request cannot be satisfied at this moment, enqueue
-  Req r(bytes, &request_mutex_);
-  queue_[pri].push_back(&r);
+  Req r(bytes, pri, tenant, &request_mutex_);
+  auto& queue = tenant->queue[pri];
+  if (queue.empty()) {
+    // Don't let a tenant that was idle at this priority bank the unused share.
+    tenant->virtual_time[pri] = std::max(tenant->virtual_time[pri], virtual_time_[pri]);
+  }
+  queue.push_back(&r);
+  const auto start_us = env_->NowMicros();
 
   do {
     bool timedout = false;
-    // Leader election, candidates can be:
-    // (1) a new incoming request,
-    // (2) a previous leader, whose quota has not been not assigned yet due
-    //     to lower priority
-    // (3) a previous waiter at the front of queue, who got notified by
-    //     previous leader
-    if (leader_ == nullptr &&
-        ((!queue_[Env::IO_HIGH].empty() &&
-            &r == queue_[Env::IO_HIGH].front()) ||
-         (!queue_[Env::IO_LOW].empty() &&
-            &r == queue_[Env::IO_LOW].front()))) {
+    // Leader election, any waiting request could become a leader when there is none. The leader
+    // waits till the next refill, while other requests wait to be granted or to be picked as a
+    // next leader candidate.
+    if (leader_ == nullptr) {
       leader_ = &r;
       timedout = r.cv.TimedWait(next_refill_us_);
     } else {
-      // Not at the front of queue or an leader has already been elected
       r.cv.Wait();
     }
 
@@ -128,63 +258,75 @@ void GenericRateLimiter::Request(int64_t bytes, const Env::IOPriority pri) {
     if (stop_) {
       --requests_to_wait_;
       exit_cv_.Signal();
-      return;
+      return 0;
     }
 
-    // Make sure the waken up request is always the header of its queue
-    assert(r.granted ||
-           (!queue_[Env::IO_HIGH].empty() &&
-            &r == queue_[Env::IO_HIGH].front()) ||
-           (!queue_[Env::IO_LOW].empty() &&
-            &r == queue_[Env::IO_LOW].front()));
-    assert(leader_ == nullptr ||
-           (!queue_[Env::IO_HIGH].empty() &&
-            leader_ == queue_[Env::IO_HIGH].front()) ||
-           (!queue_[Env::IO_LOW].empty() &&
-            leader_ == queue_[Env::IO_LOW].front()));
-
     if (leader_ == &r) {
-      // Waken up from TimedWait()
+      // Re-elect a new leader regardless. This is to simplify the
+      // election handling.
+      leader_ = nullptr;
+      // Waken up from TimedWait(), time to do refill! Otherwise it was a spontaneous wake up and
+      // we need to continue to wait.
       if (timedout) {
-        // Time to do refill!
         Refill();
 
-        // Re-elect a new leader regardless. This is to simplify the
-        // election handling.
-        leader_ = nullptr;
-
-        // Notify the header of queue if current leader is going away
         if (r.granted) {
-          // Current leader already got granted with quota. Notify header
-          // of waiting queue to participate next round of election.
-          assert((queue_[Env::IO_HIGH].empty() ||
-                    &r != queue_[Env::IO_HIGH].front()) &&
-                 (queue_[Env::IO_LOW].empty() ||
-                    &r != queue_[Env::IO_LOW].front()));
-          if (!queue_[Env::IO_HIGH].empty()) {
-            queue_[Env::IO_HIGH].front()->cv.Signal();
-          } else if (!queue_[Env::IO_LOW].empty()) {
-            queue_[Env::IO_LOW].front()->cv.Signal();
+          // Current leader already got granted with quota. Notify the next request to participate
+          // in the next round of election.
+          for (int p = Env::IO_TOTAL; p-- > 0;) {
+            auto* next = NextRequest(static_cast<Env::IOPriority>(p));
+            if (next != nullptr) {
+              next->cv.Signal();
+              break;
+            }
           }
-          // Done
-          break;
         }
-      } else {
-        // Spontaneous wake up, need to continue to wait
-        assert(!r.granted);
-        leader_ = nullptr;
       }
-    } else {
-      // Waken up by previous leader:
-      // (1) if requested quota is granted, it is done.
-      // (2) if requested quota is not granted, this means current thread
-      // was picked as a new leader candidate (previous leader got quota).
-      // It needs to participate leader election because a new request may
-      // come in before this thread gets waken up. So it may actually need
-      // to do Wait() again.
-      assert(!timedout);
     }
+    // Otherwise we were waken up by the leader:
+    // (1) if requested quota is granted, it is done.
+    // (2) if requested quota is not granted, this means current thread
+    // was picked as a new leader candidate (previous leader got quota).
+    // It needs to participate leader election because a new request may
+    // come in before this thread gets waken up. So it may actually need
+    // to do Wait() again.
   } while (!r.granted);
+
+  const auto wait_micros = static_cast<int64_t>(env_->NowMicros() - start_us);
+  counters_.total_wait_micros[pri] += wait_micros;
+  tenant->counters.total_wait_micros[pri] += wait_micros;
+  return wait_micros;
+}
+
+GenericRateLimiter::Req* GenericRateLimiter::NextRequest(Env::IOPriority pri) const {
+  Tenant* best = nullptr;
+  for (auto* tenant : tenants_) {
+    if (!tenant->queue[pri].empty() &&
+        (best == nullptr || tenant->virtual_time[pri] < best->virtual_time[pri])) {
+      best = tenant;
+    }
+  }
+  return best != nullptr ? best->queue[pri].front() : nullptr;
+}
+
+void GenericRateLimiter::GrantRequests(Env::IOPriority pri) {
+  for (;;) {
+    auto* next_req = NextRequest(pri);
+    if (next_req == nullptr || available_bytes_ < next_req->bytes) {
+      break;
+    }
+    auto* tenant = next_req->tenant;
+    available_bytes_ -= next_req->bytes;
+    counters_.total_bytes_through[pri] += next_req->bytes;
+    tenant->counters.total_bytes_through[pri] += next_req->bytes;
+    virtual_time_[pri] = tenant->virtual_time[pri];
+    tenant->virtual_time[pri] += static_cast<double>(next_req->bytes) / tenant->weight;
+    tenant->queue[pri].pop_front();
+
+    next_req->granted = true;
+    // Quota granted, signal the thread
+    next_req->cv.Signal();
+  }
 }
 
 void GenericRateLimiter::Refill() {
@@ -196,25 +338,11 @@ void GenericRateLimiter::Refill() {
     available_bytes_ += refill_bytes_per_period;
   }
 
-  int use_low_pri_first = rnd_.OneIn(fairness_) ? 0 : 1;
-  for (int q = 0; q < 2; ++q) {
-    auto use_pri = (use_low_pri_first == q) ? Env::IO_LOW : Env::IO_HIGH;
-    auto* queue = &queue_[use_pri];
-    while (!queue->empty()) {
-      auto* next_req = queue->front();
-      if (available_bytes_ < next_req->bytes) {
-        break;
-      }
-      available_bytes_ -= next_req->bytes;
-      total_bytes_through_[use_pri] += next_req->bytes;
-      queue->pop_front();
-
-      next_req->granted = true;
-      if (next_req != leader_) {
-        // Quota granted, signal the thread
-        next_req->cv.Signal();
-      }
-    }
+  // Serve priorities from the highest one, except for 1/fairness chance to start from the lowest.
+  const bool use_low_pri_first = rnd_.OneIn(fairness_);
+  for (int q = 0; q < Env::IO_TOTAL; ++q) {
+    auto pri = static_cast<Env::IOPriority>(use_low_pri_first ? q : Env::IO_TOTAL - 1 - q);
+    GrantRequests(pri);
   }
 }
 
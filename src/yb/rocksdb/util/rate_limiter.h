@@ -25,6 +25,9 @@
 
 #include <atomic>
 #include <deque>
+#include <memory>
+#include <vector>
+
 #include "yb/rocksdb/port/port.h"
 #include "yb/rocksdb/util/mutexlock.h"
 #include "yb/rocksdb/util/random.h"
@@ -53,26 +56,39 @@ class GenericRateLimiter : public RateLimiter {
   }
 
   virtual int64_t GetTotalBytesThrough(
-      const Env::IOPriority pri = Env::IO_TOTAL) const override {
-    MutexLock g(&request_mutex_);
-    if (pri == Env::IO_TOTAL) {
-      return total_bytes_through_[Env::IO_LOW] +
-             total_bytes_through_[Env::IO_HIGH];
-    }
-    return total_bytes_through_[pri];
-  }
+      const Env::IOPriority pri = Env::IO_TOTAL) const override;
 
   virtual int64_t GetTotalRequests(
-      const Env::IOPriority pri = Env::IO_TOTAL) const override {
-    MutexLock g(&request_mutex_);
-    if (pri == Env::IO_TOTAL) {
-      return total_requests_[Env::IO_LOW] + total_requests_[Env::IO_HIGH];
-    }
-    return total_requests_[pri];
-  }
+      const Env::IOPriority pri = Env::IO_TOTAL) const override;
+
+  virtual int64_t GetTotalWaitMicros(
+      const Env::IOPriority pri = Env::IO_TOTAL) const override;
+
+  virtual std::shared_ptr<RateLimiter> NewTenant(
+      int weight, std::shared_ptr<Statistics> statistics = nullptr) override;
 
  private:
+  struct Req;
+  struct Tenant;
+  class TenantRateLimiter;
+
+  struct Counters {
+    int64_t total_requests[Env::IO_TOTAL] = {};
+    int64_t total_bytes_through[Env::IO_TOTAL] = {};
+    int64_t total_wait_micros[Env::IO_TOTAL] = {};
+
+    int64_t Get(const int64_t (&values)[Env::IO_TOTAL], Env::IOPriority pri) const;
+  };
+
+  // Returns number of microseconds the request waited for tokens.
+  int64_t Request(int64_t bytes, Env::IOPriority pri, Tenant* tenant);
   void Refill();
+  // Grants pending requests of the given priority while there are enough available bytes.
+  void GrantRequests(Env::IOPriority pri);
+  // Returns the next request of the given priority to be granted, nullptr if there is none.
+  Req* NextRequest(Env::IOPriority pri) const;
+  void RemoveTenant(Tenant* tenant);
+
   int64_t CalculateRefillBytesPerPeriod(int64_t rate_bytes_per_sec) {
     return rate_bytes_per_sec * refill_period_us_ / 1000000;
   }
@@ -89,17 +105,20 @@ class GenericRateLimiter : public RateLimiter {
   port::CondVar exit_cv_;
   int32_t requests_to_wait_;
 
-  int64_t total_requests_[Env::IO_TOTAL];
-  int64_t total_bytes_through_[Env::IO_TOTAL];
+  Counters counters_;
   int64_t available_bytes_;
   int64_t next_refill_us_;
 
   int32_t fairness_;
   Random rnd_;
 
-  struct Req;
   Req* leader_;
-  std::deque<Req*> queue_[Env::IO_TOTAL];
+  // Tenant used for requests issued directly to this rate limiter.
+  std::unique_ptr<Tenant> default_tenant_;
+  std::vector<Tenant*> tenants_;
+  // Virtual time of the last granted request per priority, used as the starting point for tenants
+  // that had no pending requests of this priority.
+  double virtual_time_[Env::IO_TOTAL] = {};
 };
 
 }  // namespace rocksdb
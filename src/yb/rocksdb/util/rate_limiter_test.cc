@@ -26,7 +26,10 @@
 #endif
 
 #include <inttypes.h>
+#include <atomic>
 #include <limits>
+#include <thread>
+#include <vector>
 #include "yb/rocksdb/util/testharness.h"
 #include "yb/rocksdb/util/rate_limiter.h"
 #include "yb/rocksdb/util/random.h"
@@ -101,6 +104,54 @@ TEST_F(RateLimiterTest, Rate) {
     }
   }
 }
+
+TEST_F(RateLimiterTest, WeightedTenants) {
+  // 1MB/sec refilled every 10ms.
+  GenericRateLimiter limiter(1024 * 1024, 10 * 1000, 10);
+  const int kWeights[] = {1, 3};
+  const int kThreadsPerTenant = 2;
+  const int64_t kRequestSize = 1024;
+
+  std::vector<std::shared_ptr<RateLimiter>> tenants;
+  for (auto weight : kWeights) {
+    tenants.push_back(limiter.NewTenant(weight));
+  }
+
+  std::atomic<bool> stop(false);
+  std::vector<std::thread> threads;
+  for (auto& tenant : tenants) {
+    for (int i = 0; i != kThreadsPerTenant; ++i) {
+      threads.emplace_back([&stop, tenant, kRequestSize] {
+        while (!stop.load(std::memory_order_acquire)) {
+          tenant->Request(kRequestSize, Env::IO_LOW);
+        }
+      });
+    }
+  }
+  Env::Default()->SleepForMicroseconds(3 * 1000000);
+  stop.store(true, std::memory_order_release);
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  const auto light_bytes = tenants[0]->GetTotalBytesThrough();
+  const auto heavy_bytes = tenants[1]->GetTotalBytesThrough();
+  fprintf(stderr, "weight 1: %" PRIi64 " bytes, weight 3: %" PRIi64 " bytes\n",
+          light_bytes, heavy_bytes);
+  ASSERT_GT(light_bytes, 0);
+  ASSERT_GE(static_cast<double>(heavy_bytes) / light_bytes, 2.0);
+  ASSERT_LE(static_cast<double>(heavy_bytes) / light_bytes, 4.0);
+  ASSERT_EQ(light_bytes, tenants[0]->GetTotalBytesThrough(Env::IO_LOW));
+
+  // Counters of the shared rate limiter include requests of all its tenants.
+  ASSERT_EQ(light_bytes + heavy_bytes, limiter.GetTotalBytesThrough());
+  ASSERT_EQ(tenants[0]->GetTotalRequests() + tenants[1]->GetTotalRequests(),
+            limiter.GetTotalRequests(Env::IO_LOW));
+  ASSERT_GT(limiter.GetTotalWaitMicros(Env::IO_LOW), 0);
+  ASSERT_EQ(0, limiter.GetTotalWaitMicros(Env::IO_HIGH));
+  ASSERT_EQ(tenants[0]->GetTotalWaitMicros() + tenants[1]->GetTotalWaitMicros(),
+            limiter.GetTotalWaitMicros());
+}
 #endif
 
 }  // namespace rocksdb
@@ -24,10 +24,13 @@
 #endif
 
 #include <inttypes.h>
+#include <sched.h>
 #include "yb/rocksdb/statistics.h"
 #include "yb/rocksdb/port/likely.h"
 #include <algorithm>
 #include <cstdio>
+#include <functional>
+#include <thread>
 
 namespace rocksdb {
 
@@ -45,13 +48,27 @@ StatisticsImpl::StatisticsImpl(
 
 StatisticsImpl::~StatisticsImpl() {}
 
+size_t StatisticsImpl::CurrentTickerShard() {
+#if defined(__APPLE__)
+  // OSX doesn't have a way to get the CPU, so we'll pick a shard by thread.
+  return std::hash<std::thread::id>()(std::this_thread::get_id()) % kNumTickerShards;
+#else
+  // sched_getcpu returns -1 on failure, which still maps to a valid shard.
+  return static_cast<size_t>(sched_getcpu()) % kNumTickerShards;
+#endif // defined(__APPLE__)
+}
+
 uint64_t StatisticsImpl::getTickerCount(uint32_t tickerType) const {
   assert(
     enable_internal_stats_ ?
       tickerType < INTERNAL_TICKER_ENUM_MAX :
       tickerType < TICKER_ENUM_MAX);
   // Return its own ticker version
-  return tickers_[tickerType].value;
+  uint64_t result = 0;
+  for (const auto& shard : ticker_shards_) {
+    result += shard.values[tickerType].load(std::memory_order_relaxed);
+  }
+  return result;
 }
 
 void StatisticsImpl::histogramData(uint32_t histogramType,
@@ -76,7 +93,12 @@ void StatisticsImpl::setTickerCount(uint32_t tickerType, uint64_t count) {
       tickerType < INTERNAL_TICKER_ENUM_MAX :
       tickerType < TICKER_ENUM_MAX);
   if (tickerType < TICKER_ENUM_MAX || enable_internal_stats_) {
-    tickers_[tickerType].value.store(count, std::memory_order_relaxed);
+    // Concurrent recordTick calls for the same ticker could be partially lost, like they could be
+    // overwritten with a single counter.
+    ticker_shards_[0].values[tickerType].store(count, std::memory_order_relaxed);
+    for (size_t i = 1; i != kNumTickerShards; ++i) {
+      ticker_shards_[i].values[tickerType].store(0, std::memory_order_relaxed);
+    }
   }
   if (stats_ && tickerType < TICKER_ENUM_MAX) {
     stats_->setTickerCount(tickerType, count);
@@ -89,7 +111,8 @@ void StatisticsImpl::recordTick(uint32_t tickerType, uint64_t count) {
       tickerType < INTERNAL_TICKER_ENUM_MAX :
       tickerType < TICKER_ENUM_MAX);
   if (tickerType < TICKER_ENUM_MAX || enable_internal_stats_) {
-    tickers_[tickerType].value.fetch_add(count, std::memory_order_relaxed);
+    ticker_shards_[CurrentTickerShard()].values[tickerType].fetch_add(
+        count, std::memory_order_relaxed);
   }
   if (stats_ && tickerType < TICKER_ENUM_MAX) {
     stats_->recordTick(tickerType, count);
@@ -65,21 +65,27 @@ class StatisticsImpl : public Statistics {
   Statistics* stats_;
   bool enable_internal_stats_;
 
-  struct Ticker {
-    Ticker() : value(uint_fast64_t()) {}
-
-    std::atomic_uint_fast64_t value;
-    // Pad the structure to make it size of 64 bytes. A plain array of
-    // std::atomic_uint_fast64_t results in huge performance degradataion
-    // due to false sharing.
-    char padding[64 - sizeof(std::atomic_uint_fast64_t)];
+  // Tickers are updated on every block cache access, bloom filter check etc., often by many
+  // threads at once when the object is shared. So each CPU updates its own copy of all tickers,
+  // and a ticker value is the sum of its copies. Shards are cache line aligned, so only threads
+  // running on CPUs that map to the same shard share cache lines.
+  static constexpr size_t kNumTickerShards = 8;
+
+  struct alignas(64) TickerShard {
+    TickerShard() {
+      for (auto& value : values) {
+        value.store(0, std::memory_order_relaxed);
+      }
+    }
+
+    std::atomic<uint64_t> values[INTERNAL_TICKER_ENUM_MAX];
   };
 
-  static_assert(sizeof(Ticker) == 64, "Expecting to fit into 64 bytes");
+  static size_t CurrentTickerShard();
 
   // Attributes expand to nothing depending on the platform
   __declspec(align(64))
-  Ticker tickers_[INTERNAL_TICKER_ENUM_MAX]
+  TickerShard ticker_shards_[kNumTickerShards]
      __attribute__((aligned(64)));
   __declspec(align(64))
   HistogramImpl histograms_[INTERNAL_HISTOGRAM_ENUM_MAX]
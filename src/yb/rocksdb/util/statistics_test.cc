@@ -0,0 +1,68 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/rocksdb/util/statistics.h"
+
+#include <thread>
+#include <vector>
+
+#include "yb/rocksdb/util/testharness.h"
+
+namespace rocksdb {
+
+class StatisticsTest : public testing::Test {};
+
+TEST_F(StatisticsTest, ConcurrentTicks) {
+  constexpr int kNumThreads = 16;
+  constexpr uint64_t kTicksPerThread = 10000;
+
+  auto statistics = CreateDBStatistics();
+  std::vector<std::thread> threads;
+  for (int i = 0; i != kNumThreads; ++i) {
+    threads.emplace_back([&statistics] {
+      for (uint64_t j = 0; j != kTicksPerThread; ++j) {
+        RecordTick(statistics.get(), BLOCK_CACHE_HIT);
+        RecordTick(statistics.get(), BLOCK_CACHE_MISS, 2);
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  ASSERT_EQ(kNumThreads * kTicksPerThread, statistics->getTickerCount(BLOCK_CACHE_HIT));
+  ASSERT_EQ(2 * kNumThreads * kTicksPerThread, statistics->getTickerCount(BLOCK_CACHE_MISS));
+  ASSERT_EQ(0U, statistics->getTickerCount(BLOCK_CACHE_ADD));
+}
+
+TEST_F(StatisticsTest, SetTickerCount) {
+  auto statistics = CreateDBStatistics();
+  std::thread([&statistics] {
+    RecordTick(statistics.get(), NUMBER_KEYS_WRITTEN, 10);
+  }).join();
+  RecordTick(statistics.get(), NUMBER_KEYS_WRITTEN, 5);
+  ASSERT_EQ(15U, statistics->getTickerCount(NUMBER_KEYS_WRITTEN));
+
+  // Replaces the ticks recorded on all CPUs.
+  SetTickerCount(statistics.get(), NUMBER_KEYS_WRITTEN, 3);
+  ASSERT_EQ(3U, statistics->getTickerCount(NUMBER_KEYS_WRITTEN));
+  RecordTick(statistics.get(), NUMBER_KEYS_WRITTEN);
+  ASSERT_EQ(4U, statistics->getTickerCount(NUMBER_KEYS_WRITTEN));
+}
+
+}  // namespace rocksdb
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -277,6 +277,7 @@ void RandomInitCFOptions(ColumnFamilyOptions* cf_opt, Random* rnd) {
   cf_opt->inplace_update_num_locks = rnd->Uniform(10000);
   cf_opt->max_successive_merges = rnd->Uniform(10000);
   cf_opt->memtable_prefix_bloom_huge_page_tlb_size = rnd->Uniform(10000);
+  cf_opt->memtable_huge_page_size = rnd->Uniform(10000);
   cf_opt->write_buffer_size = rnd->Uniform(10000);
 
   // uint32_t options
@@ -312,11 +313,6 @@ void RandomInitCFOptions(ColumnFamilyOptions* cf_opt, Random* rnd) {
 
 namespace {
 
-enum TestBoundaryUserValueTag {
-  TAG_INT_VALUE,
-  TAG_STRING_VALUE,
-};
-
 Slice EncodeValue(const int64_t &value) {
   return Slice(reinterpret_cast<const char *>(&value), sizeof(value));
 }
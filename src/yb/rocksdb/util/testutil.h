@@ -652,6 +652,13 @@ TableFactory* RandomTableFactory(Random* rnd, int pre_defined = -1);
 
 std::string RandomName(Random* rnd, const size_t len);
 
+// Tags of the user values extracted by MakeBoundaryValuesExtractor, the string value is the
+// reversed user key.
+enum TestBoundaryUserValueTag {
+  TAG_INT_VALUE,
+  TAG_STRING_VALUE,
+};
+
 std::shared_ptr<BoundaryValuesExtractor> MakeBoundaryValuesExtractor();
 UserBoundaryValuePtr MakeIntBoundaryValue(int64_t value);
 UserBoundaryValuePtr MakeStringBoundaryValue(std::string value);
@@ -32,6 +32,7 @@
 #include <inttypes.h>
 #include <algorithm>
 #include <string>
+#include <unordered_map>
 #include "yb/rocksdb/db/filename.h"
 #include "yb/rocksdb/db/wal_manager.h"
 #include "yb/rocksdb/db.h"
@@ -74,6 +75,20 @@ Status CreateCheckpoint(DB* db, const std::string& checkpoint_dir) {
   if (s.ok()) {
     s = db->GetSortedWalFiles(&live_wal_files);
   }
+  // SST files could be spread across several db_paths, so remember where each of them lives.
+  // The checkpoint itself is flat, the table cache finds files outside of their recorded path.
+  std::unordered_map<uint64_t, std::string> table_file_dirs;
+  if (s.ok() && db->GetOptions().db_paths.size() > 1) {
+    std::vector<LiveFileMetaData> live_files_metadata;
+    db->GetLiveFilesMetaData(&live_files_metadata);
+    for (const auto& file : live_files_metadata) {
+      uint64_t number;
+      FileType type;
+      if (ParseFileName(file.name, &number, &type)) {
+        table_file_dirs.emplace(number, file.db_path);
+      }
+    }
+  }
   if (!s.ok()) {
     db->EnableFileDeletions(false);
     return s;
@@ -103,6 +118,13 @@ Status CreateCheckpoint(DB* db, const std::string& checkpoint_dir) {
            type == kCurrentFile);
     assert(live_files[i].size() > 0 && live_files[i][0] == '/');
     std::string src_fname = live_files[i];
+    std::string src_dir = db->GetName();
+    if (type == kTableFile || type == kTableSBlockFile) {
+      auto it = table_file_dirs.find(number);
+      if (it != table_file_dirs.end()) {
+        src_dir = it->second;
+      }
+    }
 
     // rules:
     // * if it's kTableFile or kTableSBlockFile, then it's shared
@@ -111,7 +133,7 @@ Status CreateCheckpoint(DB* db, const std::string& checkpoint_dir) {
     bool is_table_file = type == kTableFile || type == kTableSBlockFile;
     if (is_table_file && same_fs) {
       RLOG(db->GetOptions().info_log, "Hard Linking %s", src_fname.c_str());
-      s = db->GetEnv()->LinkFile(db->GetName() + src_fname,
+      s = db->GetEnv()->LinkFile(src_dir + src_fname,
                                  full_private_path + src_fname);
       if (s.IsNotSupported()) {
         same_fs = false;
@@ -121,7 +143,7 @@ Status CreateCheckpoint(DB* db, const std::string& checkpoint_dir) {
     if (!is_table_file || !same_fs) {
       RLOG(db->GetOptions().info_log, "Copying %s", src_fname.c_str());
       std::string dest_name = full_private_path + src_fname;
-      s = CopyFile(db->GetEnv(), db->GetName() + src_fname, dest_name,
+      s = CopyFile(db->GetEnv(), src_dir + src_fname, dest_name,
                    (type == kDescriptorFile) ? manifest_file_size : 0);
     }
   }
@@ -80,6 +80,12 @@ class StackableDB : public DB {
     return db_->MultiGet(options, column_family, keys, values);
   }
 
+  using DB::PrefetchKeys;
+  virtual Status PrefetchKeys(const ReadOptions& options, ColumnFamilyHandle* column_family,
+                              const std::vector<Slice>& user_keys) override {
+    return db_->PrefetchKeys(options, column_family, user_keys);
+  }
+
   using DB::AddFile;
   virtual Status AddFile(ColumnFamilyHandle* column_family,
                          const ExternalSstFileInfo* file_info,
@@ -92,6 +98,13 @@ class StackableDB : public DB {
     return db_->AddFile(column_family, file_path, move_file);
   }
 
+  using DB::GetExternalSstFileInfo;
+  virtual Status GetExternalSstFileInfo(ColumnFamilyHandle* column_family,
+                                        const std::string& file_path,
+                                        ExternalSstFileInfo* file_info) override {
+    return db_->GetExternalSstFileInfo(column_family, file_path, file_info);
+  }
+
   using DB::KeyMayExist;
   virtual bool KeyMayExist(const ReadOptions& options,
                            ColumnFamilyHandle* column_family, const Slice& key,
@@ -330,6 +343,13 @@ class StackableDB : public DB {
     return db_->GetPropertiesOfTablesInRange(column_family, range, n, props);
   }
 
+  using DB::WarmUpBlockCache;
+  virtual Status WarmUpBlockCache(ColumnFamilyHandle* column_family,
+                                  RateLimiter* rate_limiter,
+                                  const std::function<bool()>& should_stop) override {
+    return db_->WarmUpBlockCache(column_family, rate_limiter, should_stop);
+  }
+
   virtual Status GetUpdatesSince(
       SequenceNumber seq_number, unique_ptr<TransactionLogIterator>* iter,
       const TransactionLogIterator::ReadOptions& read_options) override {
@@ -68,6 +68,31 @@ TAG_FLAG(rpc_acceptor_listen_backlog, advanced);
 namespace yb {
 namespace rpc {
 
+void AcceptPendingConnections(
+    Socket* socket, Counter* connections_accepted, const NewSocketHandler& handler) {
+  for (;;) {
+    Socket new_sock;
+    Endpoint remote;
+    VLOG(2) << "calling accept() on socket " << socket->GetFd();
+    Status s = socket->Accept(&new_sock, &remote, Socket::FLAG_NONBLOCKING);
+    if (!s.ok()) {
+      if (!Socket::IsTemporarySocketError(s)) {
+        LOG(WARNING) << "Acceptor: accept failed: " << s.ToString();
+      }
+      return;
+    }
+    s = new_sock.SetNoDelay(true);
+    if (!s.ok()) {
+      LOG(WARNING) << "Acceptor with remote = " << remote
+                   << " failed to set TCP_NODELAY on a newly accepted socket: "
+                   << s.ToString();
+      continue;
+    }
+    connections_accepted->Increment();
+    handler(&new_sock, remote);
+  }
+}
+
 Acceptor::Acceptor(const scoped_refptr<MetricEntity>& metric_entity, NewSocketHandler handler)
     : handler_(std::move(handler)),
       rpc_connections_accepted_(METRIC_rpc_connections_accepted.Instantiate(metric_entity)),
@@ -148,27 +173,7 @@ void Acceptor::IoHandler(ev::io& io, int events) {
   }
 
   if (events & EV_READ) {
-    for (;;) {
-      Socket new_sock;
-      Endpoint remote;
-      VLOG(2) << "calling accept() on socket " << socket.GetFd();
-      Status s = socket.Accept(&new_sock, &remote, Socket::FLAG_NONBLOCKING);
-      if (!s.ok()) {
-        if (!Socket::IsTemporarySocketError(s)) {
-          LOG(WARNING) << "Acceptor: accept failed: " << s.ToString();
-        }
-        return;
-      }
-      s = new_sock.SetNoDelay(true);
-      if (!s.ok()) {
-        LOG(WARNING) << "Acceptor with remote = " << remote
-                     << " failed to set TCP_NODELAY on a newly accepted socket: "
-                     << s.ToString();
-        continue;
-      }
-      rpc_connections_accepted_->Increment();
-      handler_(&new_sock, remote);
-    }
+    AcceptPendingConnections(&socket, rpc_connections_accepted_.get(), handler_);
   }
 }
 
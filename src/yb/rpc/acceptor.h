@@ -55,6 +55,11 @@ namespace rpc {
 // Take ownership of the socket via Socket::Release
 typedef std::function<void(Socket *new_socket, const Endpoint& remote)> NewSocketHandler;
 
+// Accepts connections pending on the non-blocking listening socket and passes them to handler,
+// until there are no more of them.
+void AcceptPendingConnections(
+    Socket* socket, Counter* connections_accepted, const NewSocketHandler& handler);
+
 // A acceptor that calls accept() to create new connections.
 class Acceptor {
  public:
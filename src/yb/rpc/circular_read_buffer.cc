@@ -16,10 +16,8 @@
 namespace yb {
 namespace rpc {
 
-CircularReadBuffer::CircularReadBuffer(size_t capacity, const MemTrackerPtr& parent_tracker)
-    : consumption_(MemTracker::FindOrCreateTracker("Receive", parent_tracker, AddToParent::kFalse),
-                   capacity),
-      buffer_(static_cast<char*>(malloc(capacity))), capacity_(capacity) {
+CircularReadBuffer::CircularReadBuffer(GrowableBufferAllocator* allocator)
+    : allocator_(*allocator), capacity_(allocator->block_size()) {
 }
 
 bool CircularReadBuffer::Empty() {
@@ -28,10 +26,11 @@ bool CircularReadBuffer::Empty() {
 
 void CircularReadBuffer::Reset() {
   buffer_.reset();
+  reset_ = true;
 }
 
 Result<IoVecs> CircularReadBuffer::PrepareAppend() {
-  if (!buffer_) {
+  if (reset_) {
     return STATUS(IllegalState, "Read buffer was reset");
   }
 
@@ -39,6 +38,16 @@ Result<IoVecs> CircularReadBuffer::PrepareAppend() {
 
   if (!prepend_.empty()) {
     result.push_back(iovec{prepend_.mutable_data(), prepend_.size()});
+    if (!buffer_) {
+      // Remaining part of the big call is received directly into its own buffer.
+      return result;
+    }
+  }
+
+  if (!buffer_) {
+    // Connection should always be able to read, so the allocator limit is ignored.
+    buffer_ = decltype(buffer_)(
+        allocator_.Allocate(true /* forced */), GrowableBufferDeleter(&allocator_, true));
   }
 
   size_t end = pos_ + size_;
@@ -72,6 +81,9 @@ void CircularReadBuffer::DataAppended(size_t len) {
 
 IoVecs CircularReadBuffer::AppendedVecs() {
   IoVecs result;
+  if (!buffer_) {
+    return result;
+  }
 
   size_t end = pos_ + size_;
   if (end <= capacity_) {
@@ -96,6 +108,8 @@ void CircularReadBuffer::Consume(size_t count, const Slice& prepend) {
   size_ -= count;
   if (size_ == 0) {
     pos_ = 0;
+    // All received data was consumed, so the block could be used by other connections.
+    buffer_.reset();
   }
   DCHECK(prepend_.empty());
   prepend_ = prepend;
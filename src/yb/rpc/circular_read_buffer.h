@@ -14,23 +14,19 @@
 #ifndef YB_RPC_CIRCULAR_READ_BUFFER_H
 #define YB_RPC_CIRCULAR_READ_BUFFER_H
 
+#include "yb/rpc/growable_buffer.h"
 #include "yb/rpc/stream.h"
 
-#include "yb/util/mem_tracker.h"
-
 namespace yb {
 namespace rpc {
 
-struct FreeMemory {
-  void operator()(void* data) const {
-    free(data);
-  }
-};
-
 // StreamReadBuffer implementation that is based on circular buffer of fixed capacity.
+// The buffer is a block of the allocator, that is shared by connections. It is taken when data
+// is received and given back once all received data is consumed, so an idle connection does not
+// hold any memory for reading.
 class CircularReadBuffer : public StreamReadBuffer {
  public:
-  explicit CircularReadBuffer(size_t capacity, const MemTrackerPtr& parent_tracker);
+  explicit CircularReadBuffer(GrowableBufferAllocator* allocator);
 
   bool ReadyToRead() override;
   bool Empty() override;
@@ -42,10 +38,14 @@ class CircularReadBuffer : public StreamReadBuffer {
   bool Full() override;
   void Consume(size_t count, const Slice& prepend) override;
 
+  // Whether a block of the allocator is held by this buffer.
+  bool allocated() const { return buffer_ != nullptr; }
+
  private:
-  ScopedTrackedConsumption consumption_;
-  std::unique_ptr<char, FreeMemory> buffer_;
+  GrowableBufferAllocator& allocator_;
+  std::unique_ptr<uint8_t, GrowableBufferDeleter> buffer_;
   const size_t capacity_;
+  bool reset_ = false;
   size_t pos_ = 0;
   size_t size_ = 0;
   Slice prepend_;
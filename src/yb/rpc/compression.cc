@@ -0,0 +1,160 @@
+//
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+//
+
+#include "yb/rpc/compression.h"
+
+#include <algorithm>
+
+#include <gflags/gflags.h>
+#include <lz4.h>
+
+#include "yb/gutil/endian.h"
+
+#include "yb/rpc/constants.h"
+#include "yb/rpc/rpc_introspection.pb.h"
+
+#include "yb/util/faststring.h"
+#include "yb/util/flag_tags.h"
+
+DEFINE_int32(rpc_compression_min_message_size, 1024,
+             "Messages of compressed RPC connections that are smaller than this are sent "
+             "uncompressed.");
+TAG_FLAG(rpc_compression_min_message_size, advanced);
+TAG_FLAG(rpc_compression_min_message_size, runtime);
+
+DECLARE_int32(rpc_max_message_size);
+
+namespace yb {
+namespace rpc {
+
+namespace {
+
+const size_t kCodecSize = 1;
+const size_t kUncompressedSizeSize = 4;
+
+} // namespace
+
+void RpcCompressionStats::ToPB(RpcCompressionPB* pb) const {
+  pb->set_sent_bytes(sent_bytes);
+  pb->set_sent_uncompressed_bytes(sent_uncompressed_bytes);
+  pb->set_received_bytes(received_bytes);
+  pb->set_received_uncompressed_bytes(received_uncompressed_bytes);
+}
+
+void CompressedOutboundData::Serialize(boost::container::small_vector_base<RefCntBuffer>* output) {
+  boost::container::small_vector<RefCntBuffer, 4> buffers;
+  data_->Serialize(&buffers);
+
+  size_t total_size = 0;
+  for (const auto& buffer : buffers) {
+    total_size += buffer.size();
+  }
+  DCHECK_GE(total_size, kMsgLengthPrefixLength);
+  stats_->sent_uncompressed_bytes += total_size;
+  const size_t original_size = total_size - kMsgLengthPrefixLength;
+
+  // Appends the serialized message without its length prefix, that is written again for the new
+  // body.
+  auto append_original = [&buffers](faststring* out) {
+    size_t skip = kMsgLengthPrefixLength;
+    for (const auto& buffer : buffers) {
+      const size_t offset = std::min(skip, buffer.size());
+      out->append(buffer.data() + offset, buffer.size() - offset);
+      skip -= offset;
+    }
+  };
+
+  faststring message;
+  if (original_size >= static_cast<size_t>(FLAGS_rpc_compression_min_message_size)) {
+    // LZ4 block compression needs contiguous input.
+    faststring original;
+    original.reserve(original_size);
+    append_original(&original);
+
+    const size_t header_size = kMsgLengthPrefixLength + kCodecSize + kUncompressedSizeSize;
+    const int bound = LZ4_compressBound(original_size);
+    message.resize(header_size + bound);
+    char* out = reinterpret_cast<char*>(message.data());
+    const int compressed_size = LZ4_compress_default(
+        original.c_str(), out + header_size, original_size, bound);
+    if (compressed_size > 0 && compressed_size + kUncompressedSizeSize < original_size) {
+      NetworkByteOrder::Store32(out, kCodecSize + kUncompressedSizeSize + compressed_size);
+      out[kMsgLengthPrefixLength] = static_cast<char>(RpcCompressionCodec::kLz4);
+      NetworkByteOrder::Store32(out + kMsgLengthPrefixLength + kCodecSize, original_size);
+      message.resize(header_size + compressed_size);
+    } else {
+      message.clear();
+    }
+  }
+  if (message.size() == 0) {
+    message.resize(kMsgLengthPrefixLength + kCodecSize);
+    char* out = reinterpret_cast<char*>(message.data());
+    NetworkByteOrder::Store32(out, kCodecSize + original_size);
+    out[kMsgLengthPrefixLength] = static_cast<char>(RpcCompressionCodec::kNone);
+    append_original(&message);
+  }
+  buffers.clear();
+
+  stats_->sent_bytes += message.size();
+  output->push_back(RefCntBuffer(std::move(message)));
+}
+
+Status DecompressCallData(CallData* call_data, RpcCompressionStats* stats) {
+  const char* data = call_data->data();
+  const size_t size = call_data->size();
+  if (size < kCodecSize) {
+    return STATUS(Corruption, "Empty message on compressed connection");
+  }
+  stats->received_bytes += kMsgLengthPrefixLength + size;
+
+  CallData result;
+  const auto codec = static_cast<uint8_t>(data[0]);
+  switch (codec) {
+    case to_underlying(RpcCompressionCodec::kNone):
+      result = CallData(size - kCodecSize);
+      memcpy(result.data(), data + kCodecSize, result.size());
+      break;
+    case to_underlying(RpcCompressionCodec::kLz4): {
+      const size_t header_size = kCodecSize + kUncompressedSizeSize;
+      if (size < header_size) {
+        return STATUS_FORMAT(Corruption, "Compressed message is too short: $0", size);
+      }
+      const size_t original_size = NetworkByteOrder::Load32(data + kCodecSize);
+      if (original_size > static_cast<size_t>(FLAGS_rpc_max_message_size)) {
+        return STATUS_FORMAT(
+            Corruption, "Uncompressed size of message is too big: $0, max allowed: $1",
+            original_size, FLAGS_rpc_max_message_size);
+      }
+      result = CallData(original_size);
+      const int decompressed_size = LZ4_decompress_safe(
+          data + header_size, result.data(), size - header_size, original_size);
+      if (decompressed_size < 0 || static_cast<size_t>(decompressed_size) != original_size) {
+        return STATUS_FORMAT(
+            Corruption, "Failed to decompress message of $0 bytes, expected size: $1, result: $2",
+            size, original_size, decompressed_size);
+      }
+      break;
+    }
+    default:
+      return STATUS_FORMAT(Corruption, "Unknown compression codec: $0", static_cast<int>(codec));
+  }
+
+  stats->received_uncompressed_bytes += kMsgLengthPrefixLength + result.size();
+  *call_data = std::move(result);
+  return Status::OK();
+}
+
+} // namespace rpc
+} // namespace yb
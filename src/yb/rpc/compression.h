@@ -0,0 +1,88 @@
+//
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+//
+
+#ifndef YB_RPC_COMPRESSION_H
+#define YB_RPC_COMPRESSION_H
+
+#include <stdint.h>
+
+#include <string>
+
+#include "yb/rpc/call_data.h"
+#include "yb/rpc/rpc_fwd.h"
+#include "yb/rpc/outbound_data.h"
+
+#include "yb/util/enums.h"
+#include "yb/util/status.h"
+
+namespace yb {
+namespace rpc {
+
+class RpcCompressionPB;
+
+// Codecs of messages sent over compressed YB RPC connections. The length prefix of each message
+// is followed by one byte with the codec. Messages compressed with kLz4 then have the 4 byte size
+// of the original message, followed by the compressed data.
+YB_DEFINE_ENUM(RpcCompressionCodec, (kNone)(kLz4));
+
+// Byte counters of a compressed connection, including length prefixes. Accessed only from the
+// reactor thread of the connection.
+struct RpcCompressionStats {
+  uint64_t sent_bytes = 0;
+  uint64_t sent_uncompressed_bytes = 0;
+  uint64_t received_bytes = 0;
+  uint64_t received_uncompressed_bytes = 0;
+
+  void ToPB(RpcCompressionPB* pb) const;
+};
+
+// Sends the wrapped data as a message of a compressed connection. Messages smaller than
+// FLAGS_rpc_compression_min_message_size, or that do not get smaller, are sent uncompressed.
+class CompressedOutboundData : public OutboundData {
+ public:
+  // stats should be valid while the data is being serialized.
+  CompressedOutboundData(OutboundDataPtr data, RpcCompressionStats* stats)
+      : data_(std::move(data)), stats_(stats) {}
+
+  void Transferred(const Status& status, Connection* conn) override {
+    data_->Transferred(status, conn);
+  }
+
+  void Serialize(boost::container::small_vector_base<RefCntBuffer>* output) override;
+
+  std::string ToString() const override {
+    return data_->ToString();
+  }
+
+  bool DumpPB(const DumpRunningRpcsRequestPB& req, RpcCallInProgressPB* resp) override {
+    return data_->DumpPB(req, resp);
+  }
+
+  bool IsFinished() const override {
+    return data_->IsFinished();
+  }
+
+ private:
+  OutboundDataPtr data_;
+  RpcCompressionStats* stats_;
+};
+
+// Replaces the body of a message received over a compressed connection with the original message.
+CHECKED_STATUS DecompressCallData(CallData* call_data, RpcCompressionStats* stats);
+
+} // namespace rpc
+} // namespace yb
+
+#endif // YB_RPC_COMPRESSION_H
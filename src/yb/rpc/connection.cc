@@ -49,6 +49,7 @@
 #include "yb/rpc/rpc_controller.h"
 #include "yb/rpc/rpc_metrics.h"
 
+#include "yb/util/flag_tags.h"
 #include "yb/util/trace.h"
 #include "yb/util/string_util.h"
 
@@ -59,6 +60,11 @@ using std::vector;
 using strings::Substitute;
 
 DEFINE_uint64(rpc_connection_timeout_ms, 15000, "Timeout for RPC connection operations");
+DEFINE_bool(rpc_coalesce_writes, true,
+            "Write outbound data queued to a connection during a reactor loop iteration with "
+            "a single system call at the end of the iteration.");
+TAG_FLAG(rpc_coalesce_writes, advanced);
+TAG_FLAG(rpc_coalesce_writes, runtime);
 
 METRIC_DEFINE_histogram(
     server, handler_latency_outbound_transfer, "Time taken to transfer the response ",
@@ -151,6 +157,21 @@ void Connection::Shutdown(const Status& status) {
 void Connection::OutboundQueued() {
   DCHECK(reactor_->IsCurrentThread());
 
+  if (FLAGS_rpc_coalesce_writes) {
+    if (!write_scheduled_) {
+      write_scheduled_ = true;
+      reactor_->ScheduleWrite(shared_from_this());
+    }
+    return;
+  }
+
+  Write();
+}
+
+void Connection::Write() {
+  DCHECK(reactor_->IsCurrentThread());
+
+  write_scheduled_ = false;
   auto status = stream_->TryWrite();
   if (!status.ok()) {
     VLOG_WITH_PREFIX(1) << "Write failed: " << status;
@@ -256,7 +277,7 @@ size_t Connection::DoQueueOutboundData(OutboundDataPtr outbound_data, bool batch
     Shutdown(s);
     return std::numeric_limits<size_t>::max();
   }
-  auto result = stream_->Send(std::move(outbound_data));
+  auto result = stream_->Send(context_->WrapOutboundData(std::move(outbound_data)));
   s = context_->ReportPendingWriteBytes(stream_->GetPendingWriteBytes());
   if (!s.ok()) {
     Shutdown(s);
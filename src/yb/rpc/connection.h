@@ -164,6 +164,9 @@ class Connection final : public StreamContext, public std::enable_shared_from_th
   // Do appropriate actions after adding outbound call.
   void OutboundQueued();
 
+  // Writes queued outbound data to the stream.
+  void Write();
+
   // An incoming packet has completed on the client side. This parses the
   // call response, looks up the CallAwaitingResponse, and calls the
   // client callback.
@@ -208,6 +211,9 @@ class Connection final : public StreamContext, public std::enable_shared_from_th
 
   std::unique_ptr<Stream> stream_;
 
+  // Whether this connection is scheduled to be written by the reactor, see Reactor::ScheduleWrite.
+  bool write_scheduled_ = false;
+
   // whether we are client or server
   Direction direction_;
 
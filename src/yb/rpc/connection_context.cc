@@ -50,5 +50,14 @@ ConnectionContextFactory::ConnectionContextFactory(
 
 ConnectionContextFactory::~ConnectionContextFactory() = default;
 
+GrowableBufferAllocator* ConnectionContextFactory::ReadBufferAllocator(size_t block_size) {
+  std::lock_guard<std::mutex> lock(read_buffer_allocators_mutex_);
+  auto& allocator = read_buffer_allocators_[block_size];
+  if (!allocator) {
+    allocator = std::make_unique<GrowableBufferAllocator>(block_size, buffer_tracker_);
+  }
+  return allocator.get();
+}
+
 } // namespace rpc
 } // namespace yb
@@ -14,6 +14,9 @@
 #ifndef YB_RPC_CONNECTION_CONTEXT_H
 #define YB_RPC_CONNECTION_CONTEXT_H
 
+#include <mutex>
+#include <unordered_map>
+
 #include "yb/rpc/rpc_fwd.h"
 #include "yb/rpc/rpc_introspection.pb.h"
 
@@ -61,6 +64,12 @@ class ConnectionContext {
 
   virtual void AssignConnection(const ConnectionPtr& connection) {}
 
+  // Invoked in reactor thread for data that is about to be sent. Returns data that should be sent
+  // instead, e.g. one that compresses it.
+  virtual OutboundDataPtr WrapOutboundData(OutboundDataPtr data) {
+    return data;
+  }
+
   virtual void Connected(const ConnectionPtr& connection) = 0;
 
   virtual uint64_t ProcessedCallCount() = 0;
@@ -98,9 +107,18 @@ class ConnectionContextFactory {
  protected:
   ~ConnectionContextFactory();
 
+  // Returns allocator of read buffer blocks of block_size bytes, shared by all connections
+  // created by this factory.
+  GrowableBufferAllocator* ReadBufferAllocator(size_t block_size);
+
   std::shared_ptr<MemTracker> parent_tracker_;
   std::shared_ptr<MemTracker> call_tracker_;
   std::shared_ptr<MemTracker> buffer_tracker_;
+
+ private:
+  std::mutex read_buffer_allocators_mutex_;
+  // Usually all connections have the same receive buffer size, so there are few allocators.
+  std::unordered_map<size_t, std::unique_ptr<GrowableBufferAllocator>> read_buffer_allocators_;
 };
 
 template <class ContextType>
@@ -113,7 +131,8 @@ class ConnectionContextFactoryImpl : public ConnectionContextFactory {
           memory_limit, ContextType::Name(), parent_mem_tracker) {}
 
   std::unique_ptr<ConnectionContext> Create(size_t receive_buffer_size) override {
-    return std::make_unique<ContextType>(receive_buffer_size, buffer_tracker_, call_tracker_);
+    return std::make_unique<ContextType>(
+        ReadBufferAllocator(receive_buffer_size), buffer_tracker_, call_tracker_);
   }
 
   virtual ~ConnectionContextFactoryImpl() {}
@@ -15,6 +15,7 @@
 
 #include <gtest/gtest.h>
 
+#include "yb/rpc/circular_read_buffer.h"
 #include "yb/rpc/growable_buffer.h"
 
 #include "yb/util/test_util.h"
@@ -33,6 +34,9 @@ class GrowableBufferTest : public YBTest {
 TEST_F(GrowableBufferTest, TestLimit) {
   GrowableBuffer buffer(&allocator_, kSizeLimit);
 
+  // Blocks are not allocated until data is received.
+  ASSERT_EQ(buffer.capacity_left(), 0);
+  ASSERT_OK(buffer.PrepareAppend());
   ASSERT_EQ(buffer.capacity_left(), kBlockSize);
   for (;;) {
     auto result = buffer.PrepareAppend();
@@ -108,5 +112,52 @@ TEST_F(GrowableBufferTest, TestConsume) {
   }
 }
 
+TEST_F(GrowableBufferTest, TestReleaseWhenConsumed) {
+  GrowableBuffer buffer(&allocator_, kSizeLimit);
+  ASSERT_EQ(0, buffer.allocated_blocks());
+
+  for (int i = 0; i != 3; ++i) {
+    while (buffer.size() < kBlockSize * 2) {
+      auto iov = ASSERT_RESULT(buffer.PrepareAppend());
+      buffer.DataAppended(iov[0].iov_len);
+    }
+    ASSERT_GE(buffer.allocated_blocks(), 2);
+    buffer.Consume(buffer.size() - 1, Slice());
+    ASSERT_GE(buffer.allocated_blocks(), 1);
+    buffer.Consume(1, Slice());
+    ASSERT_EQ(0, buffer.allocated_blocks());
+    ASSERT_TRUE(buffer.valid());
+  }
+
+  buffer.Reset();
+  ASSERT_FALSE(buffer.valid());
+  ASSERT_NOK(buffer.PrepareAppend());
+}
+
+TEST_F(GrowableBufferTest, TestCircularReadBuffer) {
+  CircularReadBuffer buffer(&allocator_);
+  ASSERT_FALSE(buffer.allocated());
+
+  auto iov = ASSERT_RESULT(buffer.PrepareAppend());
+  ASSERT_TRUE(buffer.allocated());
+  ASSERT_EQ(1, iov.size());
+  ASSERT_EQ(kBlockSize, iov[0].iov_len);
+  buffer.DataAppended(10);
+  buffer.Consume(4, Slice());
+  ASSERT_TRUE(buffer.allocated());
+  ASSERT_EQ(6, IoVecsFullSize(buffer.AppendedVecs()));
+
+  // Rest of the big message is received directly into its buffer.
+  char big_call[kBlockSize * 2];
+  buffer.Consume(6, Slice(big_call, sizeof(big_call)));
+  ASSERT_FALSE(buffer.allocated());
+  iov = ASSERT_RESULT(buffer.PrepareAppend());
+  ASSERT_EQ(1, iov.size());
+  ASSERT_EQ(big_call, iov[0].iov_base);
+  buffer.DataAppended(sizeof(big_call));
+  ASSERT_TRUE(buffer.ReadyToRead());
+  ASSERT_FALSE(buffer.allocated());
+}
+
 } // namespace rpc
 } // namespace yb
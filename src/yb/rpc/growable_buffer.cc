@@ -147,8 +147,6 @@ GrowableBuffer::GrowableBuffer(GrowableBufferAllocator* allocator, size_t limit)
       block_size_(allocator->block_size()),
       limit_(limit),
       buffers_(kDefaultBuffersCapacity) {
-  buffers_.push_back(
-      BufferPtr(allocator_.Allocate(true), GrowableBufferDeleter(&allocator_, true)));
 }
 
 std::string GrowableBuffer::ToString() const {
@@ -176,6 +174,8 @@ void GrowableBuffer::Consume(size_t count, const Slice& prepend) {
     size_ -= count;
     if (size_ == 0) { // Buffer was fully read, so we could reset start position also.
       pos_ = 0;
+      // And give blocks back, they will be allocated again when next data is received.
+      buffers_.clear();
     }
   }
 }
@@ -189,6 +189,7 @@ void GrowableBuffer::Swap(GrowableBuffer* rhs) {
   consumption_.Swap(&rhs->consumption_);
   std::swap(size_, rhs->size_);
   std::swap(pos_, rhs->pos_);
+  std::swap(valid_, rhs->valid_);
 }
 
 IoVecs GrowableBuffer::IoVecsForRange(size_t begin, size_t end) {
@@ -223,6 +224,11 @@ Result<IoVecs> GrowableBuffer::PrepareAppend() {
 
   DCHECK_LT(pos_, block_size_);
 
+  if (buffers_.empty()) {
+    buffers_.push_back(
+        BufferPtr(allocator_.Allocate(true), GrowableBufferDeleter(&allocator_, true)));
+  }
+
   // Check if we have too small capacity left.
   if (pos_ + size_ * 2 >= block_size_ && capacity_left() * 2 < block_size_) {
     if (buffers_.size() == buffers_.capacity()) {
@@ -259,10 +265,11 @@ void GrowableBuffer::Reset() {
   Clear();
   buffers_.clear();
   buffers_.set_capacity(0);
+  valid_ = false;
 }
 
 bool GrowableBuffer::valid() const {
-  return !buffers_.empty();
+  return valid_;
 }
 
 std::ostream& operator<<(std::ostream& out, const GrowableBuffer& receiver) {
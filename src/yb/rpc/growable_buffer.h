@@ -75,6 +75,8 @@ class GrowableBufferDeleter {
 //   Limit allocated bytes.
 //   Resize depending on used size.
 //   Consume read data.
+//   Give all chunks back to allocator when all data is consumed, so idle buffer does not hold
+//   memory.
 class GrowableBuffer : public StreamReadBuffer {
  public:
   explicit GrowableBuffer(GrowableBufferAllocator* allocator, size_t limit);
@@ -91,6 +93,9 @@ class GrowableBuffer : public StreamReadBuffer {
 
   // Reset buffer size to zero. Like with std::vector Clean does not deallocate any memory.
   void Clear() { pos_ = 0; size_ = 0; }
+
+  // Number of chunks currently allocated by this buffer.
+  size_t allocated_blocks() const { return buffers_.size(); }
   std::string ToString() const override;
 
   // Removes first `count` bytes from buffer, moves remaining bytes to the beginning of the buffer.
@@ -138,6 +143,8 @@ class GrowableBuffer : public StreamReadBuffer {
 
   // Currently used bytes
   size_t size_ = 0;
+
+  bool valid_ = true;
 };
 
 std::ostream& operator<<(std::ostream& out, const GrowableBuffer& receiver);
@@ -43,11 +43,15 @@
 #include "yb/rpc/serialization.h"
 #include "yb/rpc/service_pool.h"
 
+#include "yb/util/atomic.h"
 #include "yb/util/debug/trace_event.h"
 #include "yb/util/flag_tags.h"
 #include "yb/util/logging.h"
 #include "yb/util/metrics.h"
+#include "yb/util/object_pool.h"
+#include "yb/util/size_literals.h"
 #include "yb/util/trace.h"
+#include "yb/util/memory/arena.h"
 #include "yb/util/memory/memory.h"
 
 using std::shared_ptr;
@@ -77,9 +81,101 @@ DEFINE_int32(rpc_slow_query_threshold_ms, 10000,
 TAG_FLAG(rpc_slow_query_threshold_ms, advanced);
 TAG_FLAG(rpc_slow_query_threshold_ms, runtime);
 
+DEFINE_bool(rpc_collect_call_stage_stats, true,
+            "Aggregate the time spent by inbound calls in each stage of processing per method, "
+            "to be shown in /rpcz.");
+TAG_FLAG(rpc_collect_call_stage_stats, advanced);
+TAG_FLAG(rpc_collect_call_stage_stats, runtime);
+
 namespace yb {
 namespace rpc {
 
+namespace {
+
+// Stage durations are tracked with microsecond precision, up to one hour.
+constexpr uint64_t kMaxStageMicros = 3600ULL * 1000 * 1000;
+constexpr int kStageHistogramSignificantDigits = 2;
+
+// Size of the first block of the protobuf arena of a call, enough for the messages of most calls.
+constexpr size_t kProtobufArenaInitialBlockSize = 4_KB;
+
+// Arenas of the finished calls are reset and reused, so they keep their memory between calls.
+ThreadSafeObjectPool<ThreadSafeArena>& CallArenaPool() {
+  static ThreadSafeObjectPool<ThreadSafeArena> result([] {
+    return new ThreadSafeArena(8_KB, 128_KB);
+  });
+  return result;
+}
+
+// Invokes f(stage, duration) for each reached stage, where duration is the time since the previous
+// reached stage.
+template <class F>
+void ForEachReachedStage(const InboundCallTiming& timing, const F& f) {
+  uint64_t previous = 0;
+  for (auto stage : kInboundCallStageList) {
+    auto time = timing.stages[to_underlying(stage)].load(std::memory_order_acquire);
+    if (time == 0) {
+      continue;
+    }
+    auto delta = previous == 0 || time < previous ? MonoDelta::kZero
+                                                  : MonoTime::FromUint64(time).GetDeltaSince(
+                                                        MonoTime::FromUint64(previous));
+    f(stage, delta);
+    previous = std::max(previous, time);
+  }
+}
+
+} // namespace
+
+InboundCallStageStats::StageHistograms& InboundCallStageStats::MethodHistograms(
+    const std::string& method) {
+  {
+    shared_lock<rw_spinlock> lock(mutex_);
+    auto it = methods_.find(method);
+    if (it != methods_.end()) {
+      return *it->second;
+    }
+  }
+  std::lock_guard<rw_spinlock> lock(mutex_);
+  auto& result = methods_[method];
+  if (!result) {
+    result = std::make_unique<StageHistograms>();
+    for (auto& histogram : *result) {
+      histogram = std::make_unique<HdrHistogram>(
+          kMaxStageMicros, kStageHistogramSignificantDigits);
+    }
+  }
+  return *result;
+}
+
+void InboundCallStageStats::Record(const std::string& method, const InboundCallTiming& timing) {
+  auto& histograms = MethodHistograms(method);
+  ForEachReachedStage(timing, [&histograms](InboundCallStage stage, MonoDelta delta) {
+    histograms[to_underlying(stage)]->Increment(
+        std::min<int64_t>(delta.ToMicroseconds(), kMaxStageMicros));
+  });
+}
+
+void InboundCallStageStats::ToPB(DumpRunningRpcsResponsePB* resp) const {
+  shared_lock<rw_spinlock> lock(mutex_);
+  for (const auto& method_and_histograms : methods_) {
+    auto* method_pb = resp->add_call_stages();
+    method_pb->set_method(method_and_histograms.first);
+    for (auto stage : kInboundCallStageList) {
+      const auto& histogram = *(*method_and_histograms.second)[to_underlying(stage)];
+      if (histogram.TotalCount() == 0) {
+        continue;
+      }
+      auto* stage_pb = method_pb->add_stages();
+      stage_pb->set_stage(ToString(stage).substr(1));
+      stage_pb->set_count(histogram.TotalCount());
+      stage_pb->set_p50_micros(histogram.ValueAtPercentile(50));
+      stage_pb->set_p99_micros(histogram.ValueAtPercentile(99));
+      stage_pb->set_max_micros(histogram.MaxValue());
+    }
+  }
+}
+
 InboundCall::InboundCall(ConnectionPtr conn, RpcMetrics* rpc_metrics,
                          CallProcessedListener call_processed_listener)
     : trace_(new Trace),
@@ -96,11 +192,21 @@ InboundCall::~InboundCall() {
   YB_LOG_IF_EVERY_N(INFO, FLAGS_print_trace_every > 0, FLAGS_print_trace_every)
       << "Tracing op: \n " << trace_->DumpToString(true);
   DecrementGauge(rpc_metrics_->inbound_calls_alive);
+  // Messages on the protobuf arena are destroyed before the memory of its first block is reset.
+  protobuf_arena_ = boost::none;
+  if (arena_) {
+    arena_->Reset();
+    CallArenaPool().Release(arena_);
+  }
 }
 
 void InboundCall::NotifyTransferred(const Status& status, Connection* conn) {
   if (status.ok()) {
     TRACE_TO(trace_, "Transfer finished");
+    RecordStage(InboundCallStage::kResponseSent);
+    if (rpc_metrics_->call_stages && GetAtomicFlag(&FLAGS_rpc_collect_call_stage_stats)) {
+      rpc_metrics_->call_stages->Record(service_name() + "." + method_name(), timing_);
+    }
   } else {
     YB_LOG_EVERY_N_SECS(WARNING, 10) << LogPrefix() << "Connection torn down before " << ToString()
                                      << " could send its response: " << status.ToString();
@@ -132,12 +238,48 @@ Trace* InboundCall::trace() {
   return trace_.get();
 }
 
+ThreadSafeArena* InboundCall::arena() {
+  if (!arena_) {
+    arena_ = CallArenaPool().Take();
+  }
+  return arena_;
+}
+
+google::protobuf::Arena* InboundCall::protobuf_arena() {
+  if (!protobuf_arena_) {
+    google::protobuf::ArenaOptions options;
+    options.initial_block = static_cast<char*>(
+        arena()->AllocateBytesAligned(kProtobufArenaInitialBlockSize, alignof(std::max_align_t)));
+    options.initial_block_size = options.initial_block ? kProtobufArenaInitialBlockSize : 0;
+    protobuf_arena_.emplace(options);
+  }
+  return protobuf_arena_.get_ptr();
+}
+
 void InboundCall::RecordCallReceived() {
   TRACE_EVENT_ASYNC_BEGIN0("rpc", "InboundCall", this);
   // Protect against multiple calls.
   LOG_IF_WITH_PREFIX(DFATAL, timing_.time_received.Initialized()) << "Already marked as received";
   VLOG_WITH_PREFIX(4) << "Received";
   timing_.time_received = MonoTime::Now();
+  timing_.stages[to_underlying(InboundCallStage::kReceived)].store(
+      timing_.time_received.ToUint64(), std::memory_order_release);
+}
+
+void InboundCall::RecordStage(InboundCallStage stage) {
+  timing_.stages[to_underlying(stage)].store(
+      MonoTime::Now().ToUint64(), std::memory_order_release);
+}
+
+std::string InboundCall::StagesToString() const {
+  std::string result;
+  ForEachReachedStage(timing_, [&result](InboundCallStage stage, MonoDelta delta) {
+    if (!result.empty()) {
+      result += ", ";
+    }
+    result += Format("$0: $1us", rpc::ToString(stage).substr(1), delta.ToMicroseconds());
+  });
+  return result;
 }
 
 void InboundCall::RecordHandlingStarted(scoped_refptr<Histogram> incoming_queue_time) {
@@ -145,6 +287,8 @@ void InboundCall::RecordHandlingStarted(scoped_refptr<Histogram> incoming_queue_
   // Protect against multiple calls.
   LOG_IF_WITH_PREFIX(DFATAL, timing_.time_handled.Initialized()) << "Already marked as started";
   timing_.time_handled = MonoTime::Now();
+  timing_.stages[to_underlying(InboundCallStage::kHandlerStarted)].store(
+      timing_.time_handled.ToUint64(), std::memory_order_release);
   VLOG_WITH_PREFIX(4) << "Handling";
   incoming_queue_time->Increment(
       timing_.time_handled.GetDeltaSince(timing_.time_received).ToMicroseconds());
@@ -175,7 +319,14 @@ bool InboundCall::ClientTimedOut() const {
 
 void InboundCall::QueueResponse(bool is_success) {
   TRACE_TO(trace_, is_success ? "Queueing success response" : "Queueing failure response");
+  RecordStage(InboundCallStage::kResponseQueued);
   LogTrace();
+  if (trace_->sampled()) {
+    RecordSampledTrace(
+        Format("$0 took $1ms", ToString(),
+               MonoTime::Now().GetDeltaSince(timing_.time_received).ToMilliseconds()),
+        *trace_);
+  }
   bool expected = false;
   if (responded_.compare_exchange_strong(expected, true, std::memory_order_acq_rel)) {
     connection()->context().QueueResponse(connection(), shared_from(this));
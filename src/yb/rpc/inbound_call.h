@@ -32,11 +32,18 @@
 #ifndef YB_RPC_INBOUND_CALL_H_
 #define YB_RPC_INBOUND_CALL_H_
 
+#include <array>
+#include <atomic>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
+#include <boost/optional.hpp>
+
 #include <glog/logging.h>
 
+#include <google/protobuf/arena.h>
+
 #include "yb/gutil/gscoped_ptr.h"
 #include "yb/gutil/stl_util.h"
 #include "yb/gutil/macros.h"
@@ -52,9 +59,14 @@
 
 #include "yb/yql/cql/ql/ql_session.h"
 
+#include "yb/util/enums.h"
 #include "yb/util/faststring.h"
+#include "yb/util/hdr_histogram.h"
+#include "yb/util/locks.h"
 #include "yb/util/monotime.h"
+#include "yb/util/object_pool.h"
 #include "yb/util/ref_cnt_buffer.h"
+#include "yb/util/memory/arena_fwd.h"
 #include "yb/util/slice.h"
 #include "yb/util/status.h"
 
@@ -72,14 +84,42 @@ class Trace;
 namespace rpc {
 
 class DumpRunningRpcsRequestPB;
+class DumpRunningRpcsResponsePB;
 class RpcCallInProgressPB;
 class RpcCallDetailsPB;
 class CQLCallDetailsPB;
 
+// Stages of inbound call processing, whose times are recorded for every call. Stages of tablet
+// operations are recorded only for calls that perform them.
+YB_DEFINE_ENUM(InboundCallStage,
+               (kReceived)(kParsed)(kQueued)(kHandlerStarted)(kPrepared)(kReplicated)(kApplied)
+               (kResponseQueued)(kResponseSent));
+
 struct InboundCallTiming {
   MonoTime time_received;   // Time the call was first accepted.
   MonoTime time_handled;    // Time the call handler was kicked off.
   MonoTime time_completed;  // Time the call handler completed.
+
+  // MonoTime::ToUint64 of the time each stage was reached, 0 if it was not reached. Stages could
+  // be reached in different threads.
+  std::array<std::atomic<uint64_t>, kInboundCallStageMapSize> stages{};
+};
+
+// Aggregates the time spent by inbound calls in each stage, i.e. since the previous reached stage,
+// per method.
+class InboundCallStageStats {
+ public:
+  void Record(const std::string& method, const InboundCallTiming& timing);
+
+  void ToPB(DumpRunningRpcsResponsePB* resp) const;
+
+ private:
+  typedef std::array<std::unique_ptr<HdrHistogram>, kInboundCallStageMapSize> StageHistograms;
+
+  StageHistograms& MethodHistograms(const std::string& method);
+
+  mutable rw_spinlock mutex_;
+  std::unordered_map<std::string, std::unique_ptr<StageHistograms>> methods_;
 };
 
 // Inbound call on server
@@ -104,6 +144,14 @@ class InboundCall : public RpcCall {
 
   Trace* trace();
 
+  // Arena for the data that lives no longer than the call. It is taken from a pool on first use,
+  // and reset in one step when the call is destroyed, i.e. after its response was sent.
+  // Should only be used by the thread that currently handles the call.
+  ThreadSafeArena* arena();
+
+  // Protobuf arena for the messages of the call, its first block is allocated from arena().
+  google::protobuf::Arena* protobuf_arena();
+
   // When this InboundCall was received (instantiated).
   // Should only be called once on a given instance.
   // Not thread-safe. Should only be called by the current "owner" thread.
@@ -121,6 +169,12 @@ class InboundCall : public RpcCall {
   // Not thread-safe. Should only be called by the current "owner" thread.
   void RecordHandlingCompleted(scoped_refptr<Histogram> handler_run_time);
 
+  // Records that this call reached the given stage. Thread-safe.
+  void RecordStage(InboundCallStage stage);
+
+  // Returns time spent in each reached stage, for logging.
+  std::string StagesToString() const;
+
   // Return true if the deadline set by the client has already elapsed.
   // In this case, the server may stop processing the call, since the
   // call response will be ignored anyway.
@@ -139,11 +193,18 @@ class InboundCall : public RpcCall {
   virtual const std::string& service_name() const = 0;
   virtual void RespondFailure(ErrorStatusPB::RpcErrorCodePB error_code, const Status& status) = 0;
 
+  // Same as RespondFailure, but asks the client to wait at least retry_after before retrying.
+  // Protocols that cannot pass the hint to the client ignore it.
+  virtual void RespondFailureWithRetryAfter(ErrorStatusPB::RpcErrorCodePB error_code,
+                                            const Status& status, MonoDelta retry_after) {
+    RespondFailure(error_code, status);
+  }
+
   std::string LogPrefix() const override;
 
   template <class T, class ...Args>
   static std::shared_ptr<T> Create(Args&&... args) {
-    auto result = std::make_shared<T>(std::forward<Args>(args)...);
+    auto result = std::allocate_shared<T>(PooledAllocator<T>(), std::forward<Args>(args)...);
     result->RecordCallReceived();
     return result;
   }
@@ -180,6 +241,9 @@ class InboundCall : public RpcCall {
   RpcMetrics* rpc_metrics_;
   const std::function<void(InboundCall*)> call_processed_listener_;
 
+  ThreadSafeArena* arena_ = nullptr;
+  boost::optional<google::protobuf::Arena> protobuf_arena_;
+
   DISALLOW_COPY_AND_ASSIGN(InboundCall);
 };
 
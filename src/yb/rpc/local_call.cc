@@ -34,6 +34,9 @@ LocalOutboundCall::LocalOutboundCall(
 
 Status LocalOutboundCall::SetRequestParam(
     const google::protobuf::Message& req, const MemTrackerPtr& mem_tracker) {
+  if (!controller()->request_tail().empty()) {
+    return STATUS(NotSupported, "Request tail is not supported by local calls");
+  }
   req_ = &req;
   return Status::OK();
 }
@@ -56,6 +56,7 @@
 #include "yb/rpc/acceptor.h"
 #include "yb/rpc/connection.h"
 #include "yb/rpc/constants.h"
+#include "yb/rpc/inbound_call.h"
 #include "yb/rpc/proxy.h"
 #include "yb/rpc/rpc_header.pb.h"
 #include "yb/rpc/rpc_metrics.h"
@@ -63,6 +64,7 @@
 #include "yb/rpc/tcp_stream.h"
 #include "yb/rpc/yb_rpc.h"
 
+#include "yb/util/env.h"
 #include "yb/util/errno.h"
 #include "yb/util/flag_tags.h"
 #include "yb/util/logging.h"
@@ -84,6 +86,8 @@ using std::shared_ptr;
 using strings::Substitute;
 
 DECLARE_int32(num_connections_to_server);
+DECLARE_int32(rpc_acceptor_listen_backlog);
+DECLARE_string(rpc_local_socket_dir);
 DEFINE_int32(rpc_default_keepalive_time_ms, 65000,
              "If an RPC connection from a client is idle for this amount of time, the server "
              "will disconnect the client. Setting flag to 0 disables this clean up.");
@@ -97,6 +101,13 @@ DEFINE_int32(rpc_workers_limit, 256, "Workers limit for rpc server");
 
 DEFINE_int32(socket_receive_buffer_size, 0, "Socket receive buffer size, 0 to use default");
 
+DEFINE_bool(rpc_accept_in_reactors, false,
+            "Listen on a separate SO_REUSEPORT socket in each reactor and accept connections "
+            "there, instead of accepting all of them in the acceptor thread and passing them to "
+            "reactors. The kernel spreads incoming connections across the sockets, which helps "
+            "with bursts of reconnecting clients.");
+TAG_FLAG(rpc_accept_in_reactors, advanced);
+
 namespace yb {
 namespace rpc {
 
@@ -116,6 +127,8 @@ MessengerBuilder::MessengerBuilder(std::string name)
       workers_limit_(FLAGS_rpc_workers_limit),
       num_connections_to_server_(GetAtomicFlag(&FLAGS_num_connections_to_server)) {
   AddStreamFactory(TcpStream::StaticProtocol(), TcpStream::Factory());
+  AddStreamFactory(
+      TcpStream::CompressedProtocol(), TcpStream::Factory(TcpStream::CompressedProtocol()));
 }
 
 MessengerBuilder& MessengerBuilder::set_connection_keepalive_time(
@@ -191,6 +204,7 @@ void Messenger::Shutdown() {
 
   decltype(reactors_) reactors;
   std::unique_ptr<Acceptor> acceptor;
+  std::vector<std::string> local_socket_paths;
   {
     std::lock_guard<percpu_rwlock> guard(lock_);
     if (closing_) {
@@ -203,6 +217,7 @@ void Messenger::Shutdown() {
     rpc_services_.clear();
 
     acceptor.swap(acceptor_);
+    local_socket_paths.swap(local_socket_paths_);
 
     reactors = reactors_;
   }
@@ -211,6 +226,10 @@ void Messenger::Shutdown() {
     acceptor->Shutdown();
   }
 
+  for (const auto& path : local_socket_paths) {
+    WARN_NOT_OK(Env::Default()->DeleteFile(path), "Failed to remove local socket: ");
+  }
+
   for (auto* reactor : reactors) {
     reactor->Shutdown();
   }
@@ -235,12 +254,15 @@ void Messenger::Shutdown() {
 Status Messenger::ListenAddress(
     ConnectionContextFactoryPtr factory, const Endpoint& accept_endpoint,
     Endpoint* bound_endpoint) {
-  Acceptor* acceptor;
+  Acceptor* acceptor = nullptr;
   {
     std::lock_guard<percpu_rwlock> guard(lock_);
-    if (!acceptor_) {
+    if (FLAGS_rpc_accept_in_reactors) {
+      accepting_in_reactors_ = true;
+    } else if (!acceptor_) {
       acceptor_.reset(new Acceptor(
-          metric_entity_, std::bind(&Messenger::RegisterInboundSocket, this, factory, _1, _2)));
+          metric_entity_,
+          std::bind(&Messenger::RegisterInboundSocket, this, factory, _1, _2, nullptr)));
     }
     auto accept_host = accept_endpoint.address();
     auto& outbound_address = accept_host.is_v6() ? outbound_address_v6_
@@ -250,13 +272,87 @@ Status Messenger::ListenAddress(
     }
     acceptor = acceptor_.get();
   }
-  return acceptor->Listen(accept_endpoint, bound_endpoint);
+  Endpoint bound;
+  if (!acceptor) {
+    RETURN_NOT_OK(ListenInReactors(factory, accept_endpoint, &bound));
+  } else {
+    RETURN_NOT_OK(acceptor->Listen(accept_endpoint, &bound));
+  }
+  if (bound_endpoint) {
+    *bound_endpoint = bound;
+  }
+  if (!FLAGS_rpc_local_socket_dir.empty()) {
+    return ListenLocalSocket(factory, bound);
+  }
+  return Status::OK();
+}
+
+Status Messenger::ListenLocalSocket(
+    const ConnectionContextFactoryPtr& factory, const Endpoint& endpoint) {
+  if (endpoint.address().is_unspecified()) {
+    // Clients look for socket by the address they connect to, so it could not be found.
+    LOG(INFO) << "Not listening on local socket for wildcard address " << endpoint;
+    return Status::OK();
+  }
+  auto path = LocalSocketPath(endpoint);
+  Socket socket;
+  RETURN_NOT_OK(socket.Init(Socket::FLAG_UNIX));
+  RETURN_NOT_OK(socket.BindUnix(path));
+  {
+    std::lock_guard<percpu_rwlock> guard(lock_);
+    local_socket_paths_.push_back(path);
+  }
+  RETURN_NOT_OK(socket.SetNonBlocking(true));
+  RETURN_NOT_OK(socket.Listen(FLAGS_rpc_acceptor_listen_backlog));
+  LOG(INFO) << "Listening on local socket " << path << " for " << endpoint;
+
+  // Accepted sockets have no remote address, so the connection is attributed to the host of the
+  // server.
+  Endpoint remote(endpoint.address(), 0);
+  return reactors_[0]->StartAccepting(
+      std::move(socket),
+      [this, factory, remote](Socket* new_socket, const Endpoint&) {
+        RegisterInboundSocket(factory, new_socket, remote, nullptr);
+      });
+}
+
+Status Messenger::ListenInReactors(
+    const ConnectionContextFactoryPtr& factory, const Endpoint& accept_endpoint,
+    Endpoint* bound_endpoint) {
+  Endpoint endpoint = accept_endpoint;
+  std::vector<Socket> sockets(reactors_.size());
+  for (auto& socket : sockets) {
+    RETURN_NOT_OK(socket.Init(endpoint.address().is_v6() ? Socket::FLAG_IPV6 : 0));
+    RETURN_NOT_OK(socket.SetReuseAddr(true));
+    RETURN_NOT_OK(socket.SetReusePort(true));
+    RETURN_NOT_OK(socket.Bind(endpoint));
+    if (&socket == &sockets.front()) {
+      // Other sockets should listen on the same port, even if any port was requested.
+      RETURN_NOT_OK(socket.GetSocketAddress(&endpoint));
+    }
+    RETURN_NOT_OK(socket.SetNonBlocking(true));
+    RETURN_NOT_OK(socket.Listen(FLAGS_rpc_acceptor_listen_backlog));
+  }
+  if (bound_endpoint) {
+    *bound_endpoint = endpoint;
+  }
+
+  for (size_t i = 0; i != reactors_.size(); ++i) {
+    auto* reactor = reactors_[i];
+    RETURN_NOT_OK(reactor->StartAccepting(
+        std::move(sockets[i]),
+        std::bind(&Messenger::RegisterInboundSocket, this, factory, _1, _2, reactor)));
+  }
+  return Status::OK();
 }
 
 Status Messenger::StartAcceptor() {
   std::lock_guard<percpu_rwlock> guard(lock_);
   if (acceptor_) {
     return acceptor_->Start();
+  } else if (accepting_in_reactors_) {
+    // Reactors accept connections as soon as they start listening.
+    return Status::OK();
   } else {
     return STATUS(IllegalState, "Trying to start acceptor w/o active addresses");
   }
@@ -363,13 +459,26 @@ bool Messenger::TEST_ShouldArtificiallyRejectOutgoingCallsTo(const IpAddress &re
 
 void Messenger::ShutdownAcceptor() {
   std::unique_ptr<Acceptor> acceptor;
+  bool accepting_in_reactors;
+  std::vector<std::string> local_socket_paths;
   {
     std::lock_guard<percpu_rwlock> guard(lock_);
     acceptor.swap(acceptor_);
+    accepting_in_reactors = accepting_in_reactors_;
+    accepting_in_reactors_ = false;
+    local_socket_paths.swap(local_socket_paths_);
   }
   if (acceptor) {
     acceptor->Shutdown();
   }
+  if (accepting_in_reactors || !local_socket_paths.empty()) {
+    for (auto* reactor : reactors_) {
+      reactor->StopAccepting();
+    }
+  }
+  for (const auto& path : local_socket_paths) {
+    WARN_NOT_OK(Env::Default()->DeleteFile(path), "Failed to remove local socket: ");
+  }
 }
 
 rpc::ThreadPool& Messenger::ThreadPool(ServicePriority priority) {
@@ -510,7 +619,8 @@ const std::shared_ptr<MemTracker>& Messenger::parent_mem_tracker() {
 }
 
 void Messenger::RegisterInboundSocket(
-    const ConnectionContextFactoryPtr& factory, Socket *new_socket, const Endpoint& remote) {
+    const ConnectionContextFactoryPtr& factory, Socket *new_socket, const Endpoint& remote,
+    Reactor* reactor) {
   if (TEST_ShouldArtificiallyRejectIncomingCallsFrom(remote.address())) {
     auto status = new_socket->Close();
     VLOG(1) << "TEST: Rejected connection from " << remote
@@ -529,8 +639,10 @@ void Messenger::RegisterInboundSocket(
     return;
   }
 
-  int idx = num_connections_accepted_.fetch_add(1) % num_connections_to_server_;
-  Reactor *reactor = RemoteToReactor(remote, idx);
+  if (!reactor) {
+    int idx = num_connections_accepted_.fetch_add(1) % num_connections_to_server_;
+    reactor = RemoteToReactor(remote, idx);
+  }
   reactor->RegisterInboundSocket(
       new_socket, remote, factory->Create(*receive_buffer_size), factory->buffer_tracker());
 }
@@ -599,6 +711,9 @@ Status Messenger::DumpRunningRpcs(const DumpRunningRpcsRequestPB& req,
   for (Reactor* reactor : reactors_) {
     RETURN_NOT_OK(reactor->DumpRunningRpcs(req, resp));
   }
+  if (req.include_call_stages() && rpc_metrics_->call_stages) {
+    rpc_metrics_->call_stages->ToPB(resp);
+  }
   return Status::OK();
 }
 
@@ -312,9 +312,21 @@ class Messenger : public ProxyContext {
   void BreakConnectivity(const IpAddress& address, bool incoming, bool outgoing);
   void RestoreConnectivity(const IpAddress& address, bool incoming, bool outgoing);
 
+  // Listens on accept_endpoint with a SO_REUSEPORT socket per reactor.
+  CHECKED_STATUS ListenInReactors(
+      const ConnectionContextFactoryPtr& factory, const Endpoint& accept_endpoint,
+      Endpoint* bound_endpoint);
+
+  // Listens on Unix domain socket for connections from the same host to endpoint, see
+  // FLAGS_rpc_local_socket_dir.
+  CHECKED_STATUS ListenLocalSocket(
+      const ConnectionContextFactoryPtr& factory, const Endpoint& endpoint);
+
   // Take ownership of the socket via Socket::Release
+  // reactor is the reactor that accepted the socket, nullptr to pick one by the remote endpoint.
   void RegisterInboundSocket(
-      const ConnectionContextFactoryPtr& factory, Socket *new_socket, const Endpoint& remote);
+      const ConnectionContextFactoryPtr& factory, Socket *new_socket, const Endpoint& remote,
+      Reactor* reactor);
 
   bool TEST_ShouldArtificiallyRejectOutgoingCallsTo(const IpAddress &remote);
 
@@ -342,6 +354,13 @@ class Messenger : public ProxyContext {
 
   // Acceptor which is listening on behalf of this messenger.
   std::unique_ptr<Acceptor> acceptor_;
+
+  // Whether reactors have listening sockets of this messenger, i.e. FLAGS_rpc_accept_in_reactors
+  // was set when ListenAddress was called.
+  bool accepting_in_reactors_ = false;
+
+  // Paths of Unix domain sockets that this messenger listens on, removed when it stops accepting.
+  std::vector<std::string> local_socket_paths_;
   IpAddress outbound_address_v4_;
   IpAddress outbound_address_v6_;
 
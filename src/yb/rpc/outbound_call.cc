@@ -183,13 +183,13 @@ OutboundCall::OutboundCall(
       outbound_call_metrics_(outbound_call_metrics),
       remote_method_pool_(RemoteMethodsCache::Instance().Find(*remote_method_)),
       rpc_metrics_(rpc_metrics) {
-  // Avoid expensive conn_id.ToString() in production.
-  TRACE_TO_WITH_TIME(trace_, start_, "Outbound Call initiated.");
-
   if (Trace::CurrentTrace()) {
     Trace::CurrentTrace()->AddChildTrace(trace_.get());
   }
 
+  // Avoid expensive conn_id.ToString() in production.
+  TRACE_TO_WITH_TIME(trace_, start_, "Outbound Call initiated.");
+
   DVLOG(4) << "OutboundCall " << this << " constructed with state_: " << StateName(state_)
            << " and RPC timeout: "
            << (controller_->timeout().Initialized() ? controller_->timeout().ToString() : "none");
@@ -233,6 +233,10 @@ void OutboundCall::NotifyTransferred(const Status& status, Connection* conn) {
 
 void OutboundCall::Serialize(boost::container::small_vector_base<RefCntBuffer>* output) {
   output->push_back(std::move(buffer_));
+  for (auto& buffer : request_tail_) {
+    output->push_back(std::move(buffer));
+  }
+  request_tail_.clear();
   buffer_consumption_ = ScopedTrackedConsumption();
 }
 
@@ -241,10 +245,16 @@ Status OutboundCall::SetRequestParam(
   using serialization::SerializeHeader;
   using serialization::SerializeMessage;
 
+  request_tail_ = controller_->request_tail();
+  size_t tail_size = 0;
+  for (const auto& buffer : request_tail_) {
+    tail_size += buffer.size();
+  }
+
   size_t message_size = 0;
   auto status = SerializeMessage(message,
                                  /* param_buf */ nullptr,
-                                 /* additional_size */ 0,
+                                 tail_size,
                                  /* use_cached_size */ false,
                                  /* offset */ 0,
                                  &message_size);
@@ -255,7 +265,8 @@ Status OutboundCall::SetRequestParam(
 
   RequestHeader header;
   InitHeader(&header);
-  status = SerializeHeader(header, message_size, &buffer_, message_size, &header_size);
+  status = SerializeHeader(
+      header, message_size + tail_size, &buffer_, message_size, &header_size);
   remote_method_pool_->Release(header.release_remote_method());
   if (!status.ok()) {
     return status;
@@ -267,7 +278,7 @@ Status OutboundCall::SetRequestParam(
 
   return SerializeMessage(message,
                           &buffer_,
-                          /* additional_size */ 0,
+                          tail_size,
                           /* use_cached_size */ true,
                           header_size);
 }
@@ -495,6 +506,9 @@ void OutboundCall::InitHeader(RequestHeader* header) {
     }
   }
   header->set_allocated_remote_method(remote_method_pool_->Take());
+  if (trace_->sampled()) {
+    header->set_sampled_trace(true);
+  }
 }
 
 ///
@@ -336,6 +336,9 @@ class OutboundCall : public RpcCall {
   // Buffers for storing segments of the wire-format request.
   RefCntBuffer buffer_;
 
+  // Pre-serialized fields sent after buffer_, see RpcController::set_request_tail.
+  std::vector<RefCntBuffer> request_tail_;
+
   // Consumption of buffer_.
   ScopedTrackedConsumption buffer_consumption_;
 
@@ -414,6 +414,12 @@ class CodeGenerator : public ::google::protobuf::compiler::CodeGenerator {
                 "  ::yb::rpc::RpcMethodMetrics GetMetric(RpcMetricIndexes index) {\n"
                 "    return metrics_[index];\n"
                 "  }\n"
+                "\n"
+                "  // Whether the request and response of the method are allocated on the\n"
+                "  // arena of the call, when the message types support arenas.\n"
+                "  virtual bool UsesCallArena(RpcMetricIndexes index) const {\n"
+                "    return false;\n"
+                "  }\n"
       );
 
       Print(printer, *subs,
@@ -515,8 +521,10 @@ class CodeGenerator : public ::google::protobuf::compiler::CodeGenerator {
         "            metrics_[$metric_enum_key$]) :\n"
         "        ::yb::rpc::RpcContext(\n"
         "            yb_call, \n"
-        "            std::make_shared<$request$>(),\n"
-        "            std::make_shared<$response$>(),\n"
+        "            ::yb::rpc::MakeCallMessage<$request$>(\n"
+        "                yb_call.get(), UsesCallArena($metric_enum_key$)),\n"
+        "            ::yb::rpc::MakeCallMessage<$response$>(\n"
+        "                yb_call.get(), UsesCallArena($metric_enum_key$)),\n"
         "            metrics_[$metric_enum_key$]);\n"
         "    if (!rpc_context.responded()) {\n"
         "      const auto* req = static_cast<const $request$*>(rpc_context.request_pb());\n"
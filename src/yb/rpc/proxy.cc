@@ -121,18 +121,20 @@ void Proxy::AsyncRequest(const RemoteMethod* method,
 
   controller->call_ =
       call_local_service_ ?
-      std::make_shared<LocalOutboundCall>(method,
-                                          outbound_call_metrics_,
-                                          resp,
-                                          controller,
-                                          &context_->rpc_metrics(),
-                                          std::move(callback)) :
-      std::make_shared<OutboundCall>(method,
-                                     outbound_call_metrics_,
-                                     resp,
-                                     controller,
-                                     &context_->rpc_metrics(),
-                                     std::move(callback));
+      std::allocate_shared<LocalOutboundCall>(PooledAllocator<LocalOutboundCall>(),
+                                              method,
+                                              outbound_call_metrics_,
+                                              resp,
+                                              controller,
+                                              &context_->rpc_metrics(),
+                                              std::move(callback)) :
+      std::allocate_shared<OutboundCall>(PooledAllocator<OutboundCall>(),
+                                         method,
+                                         outbound_call_metrics_,
+                                         resp,
+                                         controller,
+                                         &context_->rpc_metrics(),
+                                         std::move(callback));
   auto call = controller->call_.get();
   Status s = call->SetRequestParam(req, mem_tracker_);
   if (PREDICT_FALSE(!s.ok())) {
@@ -55,13 +55,17 @@
 #include "yb/rpc/messenger.h"
 #include "yb/rpc/rpc_controller.h"
 #include "yb/rpc/rpc_introspection.pb.h"
+#include "yb/rpc/tcp_stream.h"
 #include "yb/rpc/yb_rpc.h"
 
 #include "yb/util/countdown_latch.h"
+#include "yb/util/env.h"
 #include "yb/util/errno.h"
 #include "yb/util/flag_tags.h"
 #include "yb/util/memory/memory.h"
+#include "yb/util/metrics.h"
 #include "yb/util/monotime.h"
+#include "yb/util/numa.h"
 #include "yb/util/thread.h"
 #include "yb/util/threadpool.h"
 #include "yb/util/thread_restrictions.h"
@@ -75,6 +79,8 @@ DECLARE_string(local_ip_for_outbound_sockets);
 DECLARE_int32(num_connections_to_server);
 DECLARE_int32(socket_receive_buffer_size);
 
+METRIC_DECLARE_counter(rpc_connections_accepted);
+
 namespace yb {
 namespace rpc {
 
@@ -107,6 +113,9 @@ void DoInitLibEv() {
   ev::set_syserr_cb(LibevSysErr);
 }
 
+// Delayed tasks are run at most this time after they are due.
+constexpr auto kDelayedTasksResolution = 1ms;
+
 bool HasReactorStartedClosing(ReactorState state) {
   return state == ReactorState::kClosing || state == ReactorState::kClosed;
 }
@@ -122,7 +131,9 @@ Reactor::Reactor(const std::shared_ptr<Messenger>& messenger,
                  const MessengerBuilder &bld)
     : messenger_(messenger),
       name_(StringPrintf("%s_R%03d", messenger->name().c_str(), index)),
+      numa_domain_(index % NumNumaDomains()),
       loop_(kDefaultLibEvFlags),
+      delayed_tasks_(kDelayedTasksResolution),
       cur_time_(CoarseMonoClock::Now()),
       last_unused_tcp_scan_(cur_time_),
       connection_keepalive_time_(bld.connection_keepalive_time()),
@@ -159,6 +170,14 @@ Status Reactor::Init() {
   timer_.start(ToSeconds(coarse_timer_granularity_),
                ToSeconds(coarse_timer_granularity_));
 
+  prepare_.set(loop_);
+  prepare_.set<Reactor, &Reactor::PrepareHandler>(this);
+  prepare_.start();
+
+  // Started when delayed tasks are added.
+  delayed_tasks_timer_.set(loop_);
+  delayed_tasks_timer_.set<Reactor, &Reactor::DelayedTasksTimerHandler>(this);
+
   // Create Reactor thread.
   const std::string group_name = messenger_->name() + "_reactor";
   return yb::Thread::Create(group_name, group_name, &Reactor::RunThread, this, &thread_);
@@ -223,16 +242,22 @@ void Reactor::ShutdownInternal() {
   }
   server_conns_.clear();
 
+  listening_sockets_.clear();
+
   // Abort any scheduled tasks.
   //
   // These won't be found in the Reactor's list of pending tasks
   // because they've been "run" (that is, they've been scheduled).
   VLOG(1) << name() << ": aborting scheduled tasks";
   Status aborted = AbortedError();
-  for (const auto& task : scheduled_tasks_) {
+  delayed_tasks_timer_.stop();
+  auto delayed_tasks = delayed_tasks_.TakeAll();
+  for (const auto& task : delayed_tasks) {
+    task->scheduled_ = false;
+  }
+  for (const auto& task : delayed_tasks) {
     task->Abort(aborted);
   }
-  scheduled_tasks_.clear();
 
   // async_handler_tasks_ are the tasks added by ScheduleReactorTask.
   VLOG(1) << name() << ": aborting async handler tasks";
@@ -366,6 +391,67 @@ void Reactor::RegisterConnection(const ConnectionPtr& conn) {
   }
 }
 
+Status Reactor::StartAccepting(Socket socket, NewSocketHandler handler) {
+  return RunOnReactorThread([&socket, &handler](Reactor* reactor) {
+    if (!reactor->rpc_connections_accepted_) {
+      reactor->rpc_connections_accepted_ =
+          METRIC_rpc_connections_accepted.Instantiate(reactor->messenger()->metric_entity());
+    }
+    VLOG(1) << reactor->name() << ": accepting connections on socket fd " << socket.GetFd();
+    ListeningSocket listening{ std::make_unique<ev::io>(), std::move(socket), std::move(handler) };
+    listening.io->set(reactor->loop_);
+    listening.io->set<Reactor, &Reactor::AcceptHandler>(reactor);
+    listening.io->start(listening.socket.GetFd(), EV_READ);
+    auto* io = listening.io.get();
+    reactor->listening_sockets_.emplace(io, std::move(listening));
+    return Status::OK();
+  }, SOURCE_LOCATION());
+}
+
+void Reactor::StopAccepting() {
+  auto status = RunOnReactorThread([](Reactor* reactor) {
+    reactor->listening_sockets_.clear();
+    return Status::OK();
+  }, SOURCE_LOCATION());
+  LOG_IF(WARNING, !status.ok()) << name() << ": failed to stop accepting: " << status;
+}
+
+void Reactor::ScheduleWrite(ConnectionPtr connection) {
+  DCHECK(IsCurrentThread());
+  connections_to_write_.push_back(std::move(connection));
+}
+
+void Reactor::PrepareHandler(ev::prepare& watcher, int revents) { // NOLINT
+  DCHECK(IsCurrentThread());
+  if (connections_to_write_.empty()) {
+    return;
+  }
+  writing_connections_.swap(connections_to_write_);
+  for (auto& connection : writing_connections_) {
+    connection->Write();
+  }
+  writing_connections_.clear();
+}
+
+void Reactor::AcceptHandler(ev::io& io, int events) { // NOLINT
+  DCHECK(IsCurrentThread());
+
+  auto it = listening_sockets_.find(&io);
+  if (it == listening_sockets_.end()) {
+    LOG(DFATAL) << name() << ": accept handler for unknown socket: " << &io;
+    return;
+  }
+  if (events & EV_ERROR) {
+    LOG(INFO) << name() << ": listening socket failure: " << it->second.socket.GetFd();
+    listening_sockets_.erase(it);
+    return;
+  }
+  if (events & EV_READ) {
+    AcceptPendingConnections(
+        &it->second.socket, rpc_connections_accepted_.get(), it->second.handler);
+  }
+}
+
 ConnectionPtr Reactor::AssignOutboundCall(const OutboundCallPtr& call) {
   DCHECK(IsCurrentThread());
   ConnectionPtr conn;
@@ -475,10 +561,13 @@ bool Reactor::IsCurrentThreadOrStartedClosing() const {
 void Reactor::RunThread() {
   ThreadRestrictions::SetWaitAllowed(false);
   ThreadRestrictions::SetIOAllowed(false);
+  BindCurrentThreadToNumaDomain(numa_domain_);
   DVLOG(6) << "Calling Reactor::RunThread()...";
   loop_.run(/* flags */ 0);
   VLOG(1) << name() << " thread exiting.";
 
+  connections_to_write_.clear();
+
   // No longer need the messenger. This causes the messenger to
   // get deleted when all the reactors exit.
   messenger_.reset();
@@ -486,14 +575,16 @@ void Reactor::RunThread() {
 
 namespace {
 
-Result<Socket> CreateClientSocket(const Endpoint& remote) {
+Result<Socket> CreateClientSocket(const Endpoint& remote, bool unix_domain) {
   int flags = Socket::FLAG_NONBLOCKING;
-  if (remote.address().is_v6()) {
+  if (unix_domain) {
+    flags |= Socket::FLAG_UNIX;
+  } else if (remote.address().is_v6()) {
     flags |= Socket::FLAG_IPV6;
   }
   Socket socket;
   Status status = socket.Init(flags);
-  if (status.ok()) {
+  if (status.ok() && !unix_domain) {
     status = socket.SetNoDelay(true);
   }
   LOG_IF(WARNING, !status.ok()) << "failed to create an "
@@ -535,8 +626,14 @@ Status Reactor::FindOrStartConnection(const ConnectionId &conn_id,
   VLOG(2) << name() << " FindOrStartConnection: creating new connection for " << conn_id.ToString();
 
   // Create a new socket and start connecting to the remote.
-  auto sock = VERIFY_RESULT(CreateClientSocket(conn_id.remote()));
-  if (!messenger_->test_outbound_ip_base_.is_unspecified()) {
+  // Servers on the same host could be reached through their Unix domain sockets.
+  const auto local_socket_path = LocalSocketPath(conn_id.remote());
+  const bool unix_domain =
+      !local_socket_path.empty() && Env::Default()->FileExists(local_socket_path);
+  auto sock = VERIFY_RESULT(CreateClientSocket(conn_id.remote(), unix_domain));
+  if (unix_domain) {
+    VLOG(2) << name() << " FindOrStartConnection: connecting through " << local_socket_path;
+  } else if (!messenger_->test_outbound_ip_base_.is_unspecified()) {
     auto address_bytes(messenger_->test_outbound_ip_base_.to_v4().to_bytes());
     // Use different addresses for public/private endpoints.
     // Private addresses are even, and public are odd.
@@ -567,7 +664,7 @@ Status Reactor::FindOrStartConnection(const ConnectionId &conn_id,
   auto stream = VERIFY_RESULT(CreateStream(
       messenger_->stream_factories_, conn_id.protocol(),
       {conn_id.remote(), hostname, &sock,
-       messenger_->connection_context_factory_->buffer_tracker()}));
+       messenger_->connection_context_factory_->buffer_tracker(), &messenger_->rpc_metrics()}));
 
   // Register the new connection in our map.
   auto connection = std::make_shared<Connection>(
@@ -766,15 +863,8 @@ void DelayedTask::Run(Reactor* reactor) {
 
   // Schedule the task to run later.
   reactor_ = reactor;
-  timer_.set(reactor->loop_);
-
-  // timer_ is owned by this task and will be stopped through AbortTask/Abort before this task
-  // is removed from list of scheduled tasks, so it is safe for timer_ to remember pointer to task.
-  timer_.set<DelayedTask, &DelayedTask::TimerHandler>(this);
-
-  timer_.start(when_.ToSeconds(), // after
-               0);                // repeat
-  reactor_->scheduled_tasks_.insert(shared_from(this));
+  handle_ = reactor_->AddDelayedTask(shared_from(this), when_);
+  scheduled_ = true;
 }
 
 MarkAsDoneResult DelayedTask::MarkAsDone() {
@@ -799,15 +889,15 @@ std::string DelayedTask::ToString() const {
 void DelayedTask::AbortTask(const Status& abort_status) {
   auto mark_as_done_result = MarkAsDone();
   if (mark_as_done_result == MarkAsDoneResult::kSuccess) {
-    // Stop the libev timer. We don't need to do this in the kNotScheduled case, because the timer
-    // has not started in that case.
+    // Remove the task from the reactor. We don't need to do this in the kNotScheduled case,
+    // because the task was not added to the reactor in that case.
     if (reactor_->IsCurrentThread()) {
-      timer_.stop();
+      Unschedule();
     } else {
-      // Must call timer_.stop() on the reactor thread. Keep a refcount to prevent this DelayedTask
+      // Must call Unschedule() on the reactor thread. Keep a refcount to prevent this DelayedTask
       // from being deleted. If the reactor thread has already been shut down, this will be a no-op.
       reactor_->ScheduleReactorFunctor([this, holder = shared_from(this)](Reactor* reactor) {
-        timer_.stop();
+        Unschedule();
       }, SOURCE_LOCATION());
     }
   }
@@ -827,7 +917,17 @@ void DelayedTask::DoAbort(const Status& abort_status) {
   AbortTask(abort_status);
 }
 
-void DelayedTask::TimerHandler(ev::timer& watcher, int revents) {
+void DelayedTask::Unschedule() {
+  DCHECK(reactor_->IsCurrentThread());
+
+  if (scheduled_) {
+    scheduled_ = false;
+    // Hold shared_ptr, so this task wouldn't be destroyed while this method is running.
+    auto holder = reactor_->delayed_tasks_.Cancel(handle_);
+  }
+}
+
+void DelayedTask::TimerHandler() {
   DCHECK(reactor_->IsCurrentThread());
 
   auto mark_as_done_result = MarkAsDone();
@@ -837,21 +937,49 @@ void DelayedTask::TimerHandler(ev::timer& watcher, int revents) {
     return;
   }
 
-  // Hold shared_ptr, so this task wouldn't be destroyed upon removal below until func_ is called.
-  auto holder = shared_from_this();
-
-  reactor_->scheduled_tasks_.erase(shared_from(this));
   auto messenger = messenger_.lock();
   if (messenger != nullptr) {
     messenger->RemoveScheduledTask(id_);
   }
 
+  func_(Status::OK());
+}
+
+DelayedTasks::Handle Reactor::AddDelayedTask(std::shared_ptr<DelayedTask> task, MonoDelta delay) {
+  DCHECK(IsCurrentThread());
+
+  auto time = std::chrono::steady_clock::now() + delay.ToSteadyDuration();
+  auto result = delayed_tasks_.Insert(time, std::move(task));
+  if (time < delayed_tasks_timer_time_) {
+    StartDelayedTasksTimer();
+  }
+  return result;
+}
+
+void Reactor::StartDelayedTasksTimer() {
+  delayed_tasks_timer_time_ = delayed_tasks_.NextAdvanceTime();
+  auto delay = delayed_tasks_timer_time_ - std::chrono::steady_clock::now();
+  delayed_tasks_timer_.stop();
+  delayed_tasks_timer_.start(std::max<double>(ToSeconds(delay), 0), // after
+                             0);                                    // repeat
+}
+
+void Reactor::DelayedTasksTimerHandler(ev::timer& watcher, int revents) {
+  DCHECK(IsCurrentThread());
+
+  delayed_tasks_timer_time_ = SteadyTimePoint::max();
   if (EV_ERROR & revents) {
-    std::string msg = "Delayed task got an error in its timer handler";
-    LOG(WARNING) << msg;
-    func_(STATUS(Aborted, msg));
-  } else {
-    func_(Status::OK());
+    LOG(WARNING) << "Reactor " << name() << " got an error in the delayed tasks timer handler.";
+  }
+
+  auto now = std::chrono::steady_clock::now();
+  delayed_tasks_.Advance(now, [](std::shared_ptr<DelayedTask> task) {
+    task->scheduled_ = false;
+    task->TimerHandler();
+  });
+
+  if (!delayed_tasks_.empty()) {
+    StartDelayedTasksTimer();
   }
 }
 
@@ -866,7 +994,7 @@ void Reactor::RegisterInboundSocket(
 
   auto stream = CreateStream(
       messenger_->stream_factories_, messenger_->listen_protocol_,
-      {remote, std::string(), socket, mem_tracker});
+      {remote, std::string(), socket, mem_tracker, &messenger_->rpc_metrics()});
   if (!stream.ok()) {
     LOG(DFATAL) << "Failed to create stream for " << remote << ": " << stream.status();
     return;
@@ -876,6 +1004,11 @@ void Reactor::RegisterInboundSocket(
                                            ConnectionDirection::SERVER,
                                            &messenger()->rpc_metrics(),
                                            std::move(connection_context));
+  if (IsCurrentThread()) {
+    // Accepted by this reactor.
+    RegisterConnection(conn);
+    return;
+  }
   ScheduleReactorFunctor([conn = std::move(conn)](Reactor* reactor) {
     reactor->RegisterConnection(conn);
   }, SOURCE_LOCATION());
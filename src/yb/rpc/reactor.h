@@ -48,6 +48,7 @@
 
 #include "yb/gutil/ref_counted.h"
 
+#include "yb/rpc/acceptor.h"
 #include "yb/rpc/outbound_call.h"
 
 #include "yb/util/thread.h"
@@ -55,6 +56,7 @@
 #include "yb/util/monotime.h"
 #include "yb/util/net/socket.h"
 #include "yb/util/status.h"
+#include "yb/util/timer_wheel.h"
 
 namespace yb {
 namespace rpc {
@@ -215,6 +217,10 @@ YB_DEFINE_ENUM(MarkAsDoneResult,
     // reactor_ is nullptr. Next calls to MarkAsDone will return kAlreadyDone.
     (kNotScheduled))
 
+class DelayedTask;
+
+typedef TimerWheel<std::shared_ptr<DelayedTask>> DelayedTasks;
+
 // A ReactorTask that is scheduled to run at some point in the future.
 //
 // Semantically it works like RunFunctionTask with a few key differences:
@@ -237,13 +243,19 @@ class DelayedTask : public ReactorTask {
   std::string ToString() const override;
 
  private:
+  friend class Reactor;
+
   void DoAbort(const Status& abort_status) override;
 
   // Set done_ to true if not set and return true. If done_ is already set, return false.
   MarkAsDoneResult MarkAsDone();
 
-  // libev callback for when the registered timer fires.
-  void TimerHandler(ev::timer& rwatcher, int revents); // NOLINT
+  // Invoked by reactor when the task's timer fires.
+  void TimerHandler();
+
+  // Removes the task from the reactor's delayed tasks, if it is still there. Must be called from
+  // the reactor thread.
+  void Unschedule();
 
   // User function to invoke when timer fires or when task is aborted.
   StatusFunctor func_;
@@ -254,8 +266,11 @@ class DelayedTask : public ReactorTask {
   // Link back to registering reactor thread.
   Reactor* reactor_ = nullptr;
 
-  // libev timer. Set when Run() is invoked.
-  ev::timer timer_;
+  // Position of this task in reactor's delayed tasks. Set when Run() is invoked.
+  DelayedTasks::Handle handle_;
+
+  // Whether this task is in reactor's delayed tasks. Accessed only from the reactor thread.
+  bool scheduled_ = false;
 
   // This task's id.
   const int64_t id_;
@@ -310,6 +325,15 @@ class Reactor {
   // libev callback for handling timer events in our epoll thread.
   void TimerHandler(ev::timer &watcher, int revents); // NOLINT
 
+  // libev callback invoked before the loop waits for events. Writes outbound data queued to
+  // connections since the previous iteration.
+  void PrepareHandler(ev::prepare &watcher, int revents); // NOLINT
+
+  // Writes queued outbound data of connection at the end of the current loop iteration, so data
+  // queued by several events is sent with a single system call. Must be called from the reactor
+  // thread.
+  void ScheduleWrite(ConnectionPtr connection);
+
   // This may be called from another thread.
   const std::string &name() const { return name_; }
 
@@ -360,6 +384,15 @@ class Reactor {
       Socket *socket, const Endpoint& remote, std::unique_ptr<ConnectionContext> connection_context,
       const MemTrackerPtr& mem_tracker);
 
+  // Starts accepting connections on the listening socket directly on this reactor, bypassing the
+  // Acceptor. Used with SO_REUSEPORT sockets, one per reactor, so that the kernel distributes
+  // connections between reactors. handler is called on the reactor thread.
+  // Must not be called from the reactor thread.
+  CHECKED_STATUS StartAccepting(Socket socket, NewSocketHandler handler);
+
+  // Closes the sockets passed to StartAccepting. Must not be called from the reactor thread.
+  void StopAccepting();
+
   // Schedule the given task's Run() method to be called on the reactor thread. If the reactor shuts
   // down before it is run, the Abort method will be called.
   // Returns true if task was scheduled.
@@ -403,6 +436,9 @@ class Reactor {
   // Register a new connection.
   void RegisterConnection(const ConnectionPtr& conn);
 
+  // libev callback for listening sockets accepted on this reactor.
+  void AcceptHandler(ev::io& io, int events); // NOLINT
+
   // Actually perform shutdown of the thread, tearing down any connections,
   // etc. This is called from within the thread.
   void ShutdownInternal();
@@ -420,11 +456,23 @@ class Reactor {
 
   void ShutdownConnection(const ConnectionPtr& conn);
 
+  // Adds the task to delayed_tasks_, starting delayed_tasks_timer_ if the task should fire earlier
+  // than the timer.
+  DelayedTasks::Handle AddDelayedTask(std::shared_ptr<DelayedTask> task, MonoDelta delay);
+
+  void StartDelayedTasksTimer();
+
+  // libev callback for delayed_tasks_timer_, runs delayed tasks that are due.
+  void DelayedTasksTimerHandler(ev::timer &watcher, int revents); // NOLINT
+
   // parent messenger
   std::shared_ptr<Messenger> messenger_;
 
   const std::string name_;
 
+  // NUMA domain the reactor thread is bound to, reactors are spread over domains round robin.
+  const size_t numa_domain_;
+
   mutable simple_spinlock pending_tasks_mtx_;
 
   // Reactor status, mostly used when shutting down. Guarded by pending_tasks_mtx_, but also read
@@ -453,8 +501,22 @@ class Reactor {
   // Handles the periodic timer.
   ev::timer timer_;
 
-  // Scheduled (but not yet run) delayed tasks.
-  std::set<std::shared_ptr<DelayedTask>> scheduled_tasks_;
+  // Writes outbound data of connections_to_write_ before the loop waits for events.
+  ev::prepare prepare_;
+
+  // Connections that have outbound data queued in the current loop iteration.
+  std::vector<ConnectionPtr> connections_to_write_;
+  std::vector<ConnectionPtr> writing_connections_;
+
+  // Scheduled (but not yet run) delayed tasks. Most of them are aborted before they are due, so
+  // they are kept in timer wheel, that provides constant time insertion and removal.
+  DelayedTasks delayed_tasks_;
+
+  // Fires when the next delayed tasks could become due.
+  ev::timer delayed_tasks_timer_;
+
+  // Time when delayed_tasks_timer_ fires, max if it is not started.
+  SteadyTimePoint delayed_tasks_timer_time_ = SteadyTimePoint::max();
 
   ReactorTasks async_handler_tasks_;
 
@@ -499,6 +561,17 @@ class Reactor {
 
   // Number of outbound connections to create per each destination server address.
   int num_connections_to_server_;
+
+  struct ListeningSocket {
+    std::unique_ptr<ev::io> io;
+    Socket socket;
+    NewSocketHandler handler;
+  };
+
+  // Sockets this reactor accepts connections on. Only accessed on the reactor thread.
+  std::unordered_map<ev::io*, ListeningSocket> listening_sockets_;
+
+  scoped_refptr<Counter> rpc_connections_accepted_;
 };
 
 }  // namespace rpc
@@ -33,6 +33,7 @@
 #include <string>
 #include <thread>
 
+#include <gflags/gflags.h>
 #include <gtest/gtest.h>
 
 #include "yb/rpc/rpc-test-base.h"
@@ -40,6 +41,9 @@
 #include "yb/util/countdown_latch.h"
 #include "yb/util/test_util.h"
 
+DEFINE_int32(rpc_bench_client_threads, 0,
+             "Number of client threads making calls, 0 to use the default for the build type.");
+
 using namespace std::literals; // NOLINT
 
 using std::string;
@@ -115,6 +119,10 @@ TEST_F(RpcBench, BenchmarkCalls) {
   client_options.n_reactors = 2;
   client_messenger_ = CreateMessenger("Client", client_options);
 
+  // Client and server messengers share the metric entity of the test.
+  const auto& socket_writes = client_messenger_->rpc_metrics().socket_writes;
+  const auto socket_writes_before = socket_writes->value();
+
   Stopwatch sw(Stopwatch::ALL_THREADS);
   sw.start();
 
@@ -124,7 +132,9 @@ TEST_F(RpcBench, BenchmarkCalls) {
 #else
   constexpr int kNumThreads = 16;
 #endif
-  for (int i = 0; i < kNumThreads; i++) {
+  const int num_threads =
+      FLAGS_rpc_bench_client_threads > 0 ? FLAGS_rpc_bench_client_threads : kNumThreads;
+  for (int i = 0; i < num_threads; i++) {
     auto thr = std::make_unique<ClientThread>(this);
     thr->Start();
     threads.push_back(std::move(thr));
@@ -144,10 +154,13 @@ TEST_F(RpcBench, BenchmarkCalls) {
   float reqs_per_second = static_cast<float>(total_reqs / sw.elapsed().wall_seconds());
   float user_cpu_micros_per_req = static_cast<float>(sw.elapsed().user / 1000.0 / total_reqs);
   float sys_cpu_micros_per_req = static_cast<float>(sw.elapsed().system / 1000.0 / total_reqs);
+  float socket_writes_per_req =
+      static_cast<float>(socket_writes->value() - socket_writes_before) / total_reqs;
 
   LOG(INFO) << "Reqs/sec:         " << reqs_per_second;
   LOG(INFO) << "User CPU per req: " << user_cpu_micros_per_req << "us";
   LOG(INFO) << "Sys CPU per req:  " << sys_cpu_micros_per_req << "us";
+  LOG(INFO) << "Writes per req:   " << socket_writes_per_req;
 }
 
 } // namespace rpc
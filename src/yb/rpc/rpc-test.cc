@@ -45,6 +45,7 @@
 #include "yb/gutil/map-util.h"
 #include "yb/gutil/strings/join.h"
 #include "yb/rpc/serialization.h"
+#include "yb/rpc/tcp_stream.h"
 #include "yb/util/countdown_latch.h"
 #include "yb/util/env.h"
 #include "yb/util/test_util.h"
@@ -52,6 +53,9 @@
 METRIC_DECLARE_histogram(handler_latency_yb_rpc_test_CalculatorService_Sleep);
 METRIC_DECLARE_histogram(rpc_incoming_queue_time);
 
+DECLARE_bool(rpc_accept_in_reactors);
+DECLARE_string(rpc_local_socket_dir);
+
 DEFINE_int32(rpc_test_connection_keepalive_num_iterations, 1,
   "Number of iterations in TestRpc.TestConnectionKeepalive");
 
@@ -150,6 +154,122 @@ TEST_F(TestRpc, TestCall) {
   }
 }
 
+// Test making calls to a server that accepts connections in its reactors.
+TEST_F(TestRpc, TestCallAcceptInReactors) {
+  FLAGS_rpc_accept_in_reactors = true;
+  HostPort server_addr;
+  StartTestServer(&server_addr);
+
+  // Each client opens its own connection, so that they get spread across reactors.
+  std::vector<shared_ptr<Messenger>> client_messengers;
+  for (int i = 0; i < 8; i++) {
+    client_messengers.push_back(CreateMessenger("Client" + std::to_string(i)));
+    Proxy p(client_messengers.back(), server_addr);
+    ASSERT_OK(DoTestSyncCall(&p, CalculatorServiceMethods::AddMethod()));
+  }
+  for (const auto& messenger : client_messengers) {
+    messenger->Shutdown();
+  }
+}
+
+TEST_F(TestRpc, TestCompressedConnection) {
+  HostPort server_addr;
+  StartTestServer(&server_addr);
+
+  auto client_messenger = CreateMessenger("Client");
+  Proxy p(client_messenger, server_addr, TcpStream::CompressedProtocol());
+
+  // The small request is sent uncompressed, and the big one is compressed.
+  for (size_t size : std::vector<size_t>{10, 1_MB}) {
+    rpc_test::EchoRequestPB req;
+    req.set_data(std::string(size, 'X'));
+    rpc_test::EchoResponsePB resp;
+    RpcController controller;
+    controller.set_timeout(10s);
+    ASSERT_OK(p.SyncRequest(CalculatorServiceMethods::EchoMethod(), req, &resp, &controller));
+    ASSERT_EQ(req.data(), resp.data());
+  }
+  ASSERT_OK(DoTestSyncCall(&p, CalculatorServiceMethods::AddMethod()));
+
+  DumpRunningRpcsRequestPB dump_req;
+  DumpRunningRpcsResponsePB dump_resp;
+  ASSERT_OK(client_messenger->DumpRunningRpcs(dump_req, &dump_resp));
+  ASSERT_EQ(1, dump_resp.outbound_connections_size());
+  const auto& compression = dump_resp.outbound_connections(0).compression();
+  LOG(INFO) << "Compression: " << compression.ShortDebugString();
+  ASSERT_GT(compression.sent_uncompressed_bytes(), 1_MB);
+  ASSERT_LT(compression.sent_bytes(), compression.sent_uncompressed_bytes() / 10);
+  ASSERT_GT(compression.received_uncompressed_bytes(), 1_MB);
+  ASSERT_LT(compression.received_bytes(), compression.received_uncompressed_bytes() / 10);
+
+  client_messenger->Shutdown();
+}
+
+// Test making calls through the Unix domain socket of a server on the same host.
+TEST_F(TestRpc, TestLocalSocket) {
+  FLAGS_rpc_local_socket_dir = GetTestDataDirectory();
+  HostPort server_addr;
+  StartTestServer(&server_addr);
+
+  Endpoint server_endpoint(IpAddress::from_string(server_addr.host()), server_addr.port());
+  auto path = LocalSocketPath(server_endpoint);
+  ASSERT_TRUE(env_->FileExists(path)) << path;
+
+  auto client_messenger = CreateMessenger("Client");
+  Proxy p(client_messenger, server_addr);
+  for (int i = 0; i != 10; ++i) {
+    ASSERT_OK(DoTestSyncCall(&p, CalculatorServiceMethods::AddMethod()));
+  }
+
+  DumpRunningRpcsRequestPB dump_req;
+  DumpRunningRpcsResponsePB dump_resp;
+  ASSERT_OK(client_messenger->DumpRunningRpcs(dump_req, &dump_resp));
+  ASSERT_EQ(1, dump_resp.outbound_connections_size());
+
+  client_messenger->Shutdown();
+  server_messenger().ShutdownAcceptor();
+  ASSERT_FALSE(env_->FileExists(path)) << path;
+}
+
+TEST_F(TestRpc, TestCallStages) {
+  constexpr int kCalls = 10;
+
+  HostPort server_addr;
+  StartTestServer(&server_addr);
+
+  auto client_messenger = CreateMessenger("Client");
+  Proxy p(client_messenger, server_addr);
+  for (int i = 0; i != kCalls; ++i) {
+    ASSERT_OK(DoTestSyncCall(&p, CalculatorServiceMethods::AddMethod()));
+  }
+
+  DumpRunningRpcsRequestPB dump_req;
+  dump_req.set_include_call_stages(true);
+  DumpRunningRpcsResponsePB dump_resp;
+  // Stages of a call are aggregated after its response was sent, that could happen after the
+  // client received the response.
+  ASSERT_OK(WaitFor([this, &dump_req, &dump_resp]() -> Result<bool> {
+    dump_resp.Clear();
+    RETURN_NOT_OK(server_messenger().DumpRunningRpcs(dump_req, &dump_resp));
+    return dump_resp.call_stages_size() == 1 &&
+           dump_resp.call_stages(0).stages_size() > 0 &&
+           dump_resp.call_stages(0).stages(0).count() == kCalls;
+  }, 10s, "All calls aggregated"));
+
+  const auto& method = dump_resp.call_stages(0);
+  LOG(INFO) << "Call stages: " << method.ShortDebugString();
+  ASSERT_STR_CONTAINS(method.method(), CalculatorServiceMethods::AddMethod()->method_name());
+  std::vector<std::string> stages;
+  for (const auto& stage : method.stages()) {
+    ASSERT_EQ(kCalls, stage.count()) << stage.stage();
+    ASSERT_LE(stage.p50_micros(), stage.max_micros()) << stage.stage();
+    stages.push_back(stage.stage());
+  }
+  // Generic calculator service does not perform tablet operations.
+  ASSERT_EQ("Received, Parsed, Queued, HandlerStarted, ResponseQueued, ResponseSent",
+            JoinStrings(stages, ", "));
+}
+
 // Test that connecting to an invalid server properly throws an error.
 TEST_F(TestRpc, TestCallToBadServer) {
   shared_ptr<Messenger> client_messenger(CreateMessenger("Client"));
@@ -89,7 +89,12 @@ bool RpcRetrier::HandleResponse(
     if (err &&
         err->has_code() &&
         err->code() == ErrorStatusPB::ERROR_SERVER_TOO_BUSY) {
-      auto status = DelayedRetry(rpc, controller_status, BackoffStrategy::kExponential);
+      // Server could tell how long it expects to stay overloaded, in that case wait at least
+      // that long.
+      auto min_delay = err->has_retry_after_ms()
+          ? MonoDelta::FromMilliseconds(err->retry_after_ms()) : MonoDelta::kZero;
+      auto status = DelayedRetry(
+          rpc, controller_status, BackoffStrategy::kExponential, min_delay);
       if (!status.ok()) {
         *out_status = status;
         return false;
@@ -103,7 +108,7 @@ bool RpcRetrier::HandleResponse(
 }
 
 Status RpcRetrier::DelayedRetry(
-    RpcCommand* rpc, const Status& why_status, BackoffStrategy strategy) {
+    RpcCommand* rpc, const Status& why_status, BackoffStrategy strategy, MonoDelta min_delay) {
   if (!why_status.ok() && (last_error_.ok() || last_error_.IsTimedOut())) {
     last_error_ = why_status;
   }
@@ -118,6 +123,11 @@ Status RpcRetrier::DelayedRetry(
                  FLAGS_min_backoff_ms_exponent + attempt_num_, FLAGS_max_backoff_ms_exponent)
            : attempt_num_) +
       RandomUniformInt(0, 4);
+  if (min_delay.Initialized() && num_ms < min_delay.ToMilliseconds()) {
+    // Spread retries of clients that got the same hint, so they don't come back all at once.
+    int min_ms = min_delay.ToMilliseconds();
+    num_ms = min_ms + RandomUniformInt(0, min_ms / 4 + 4);
+  }
   attempt_num_++;
 
   RpcRetrierState expected_state = RpcRetrierState::kIdle;
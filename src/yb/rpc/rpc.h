@@ -117,9 +117,13 @@ class RpcRetrier {
   // deadline has already expired at the time that Retry() was called.
   //
   // Callers should ensure that 'rpc' remains alive.
+  //
+  // The RPC is not retried earlier than min_delay, e.g. when the server asked the client to back
+  // off for that long.
   CHECKED_STATUS DelayedRetry(
       RpcCommand* rpc, const Status& why_status,
-      BackoffStrategy strategy = BackoffStrategy::kLinear);
+      BackoffStrategy strategy = BackoffStrategy::kLinear,
+      MonoDelta min_delay = MonoDelta::kZero);
 
   RpcController* mutable_controller() { return &controller_; }
   const RpcController& controller() const { return controller_; }
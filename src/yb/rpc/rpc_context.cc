@@ -157,6 +157,16 @@ void RpcContext::RespondRpcFailure(ErrorStatusPB_RpcErrorCodePB err, const Statu
   responded_ = true;
 }
 
+void RpcContext::RespondRpcFailure(ErrorStatusPB_RpcErrorCodePB err, const Status& status,
+                                   MonoDelta retry_after) {
+  call_->RecordHandlingCompleted(metrics_.handler_latency);
+  TRACE_EVENT_ASYNC_END2("rpc_call", "RPC", this,
+                         "status", status.ToString(),
+                         "trace", trace()->DumpToString(true));
+  call_->RespondFailureWithRetryAfter(err, status, retry_after);
+  responded_ = true;
+}
+
 void RpcContext::RespondApplicationError(int error_ext_id, const std::string& message,
                                          const Message& app_error_pb) {
   call_->RecordHandlingCompleted(metrics_.handler_latency);
@@ -203,6 +213,14 @@ Trace* RpcContext::trace() {
   return call_->trace();
 }
 
+ThreadSafeArena* RpcContext::arena() {
+  return call_->arena();
+}
+
+void RpcContext::RecordCallStage(InboundCallStage stage) {
+  call_->RecordStage(stage);
+}
+
 void RpcContext::Panic(const char* filepath, int line_number, const string& message) {
   // Use the LogMessage class directly so that the log messages appear to come from
   // the line of code which caused the panic, not this code.
@@ -32,7 +32,11 @@
 #ifndef YB_RPC_RPC_CONTEXT_H
 #define YB_RPC_RPC_CONTEXT_H
 
+#include <memory>
 #include <string>
+#include <type_traits>
+
+#include <google/protobuf/arena.h>
 
 #include "yb/gutil/gscoped_ptr.h"
 #include "yb/rpc/local_call.h"
@@ -40,6 +44,7 @@
 #include "yb/rpc/service_if.h"
 #include "yb/util/ref_cnt_buffer.h"
 #include "yb/util/status.h"
+#include "yb/util/memory/arena_fwd.h"
 
 namespace google {
 namespace protobuf {
@@ -94,6 +99,10 @@ class RpcContext {
   // Return the trace buffer for this call.
   Trace* trace();
 
+  // Arena for the data that lives no longer than the call, it is freed in one step after the
+  // response was sent.
+  ThreadSafeArena* arena();
+
   // Send a response to the call. The service may call this method
   // before or after returning from the original handler method,
   // and it may call this method from a different thread.
@@ -127,6 +136,11 @@ class RpcContext {
   // and response protobufs are also destroyed.
   void RespondRpcFailure(ErrorStatusPB_RpcErrorCodePB err, const Status& status);
 
+  // Same as above, but also tells the client to wait at least retry_after before retrying.
+  // Used with ERROR_SERVER_TOO_BUSY when the server can estimate how long it will stay overloaded.
+  void RespondRpcFailure(ErrorStatusPB_RpcErrorCodePB err, const Status& status,
+                         MonoDelta retry_after);
+
   // Respond with an application-level error. This causes the caller to get a
   // RemoteError status with the provided string message. Additionally, a
   // service-specific error extension is passed back to the client. The
@@ -211,6 +225,9 @@ class RpcContext {
   // Closes connection that received this request.
   void CloseConnection();
 
+  // Records that the current RPC call reached the given processing stage.
+  void RecordCallStage(InboundCallStage stage);
+
   std::string ToString() const;
 
  private:
@@ -223,6 +240,35 @@ class RpcContext {
 
 void PanicRpc(RpcContext* context, const char* file, int line_number, const std::string& message);
 
+namespace internal {
+
+template <class Message>
+std::shared_ptr<Message> MakeCallMessage(InboundCall* call, std::true_type arena_constructable) {
+  // The arena owns the message, so the pointer does not share ownership of anything.
+  return std::shared_ptr<Message>(
+      std::shared_ptr<void>(), google::protobuf::Arena::CreateMessage<Message>(
+          call->protobuf_arena()));
+}
+
+template <class Message>
+std::shared_ptr<Message> MakeCallMessage(InboundCall* call, std::false_type arena_constructable) {
+  return std::make_shared<Message>();
+}
+
+} // namespace internal
+
+// Creates the request or response message of the call, used by the generated code. When
+// use_call_arena is true and arenas are enabled for the message type, the message and its
+// sub-messages are allocated on the protobuf arena of the call. Otherwise it is allocated on heap.
+template <class Message>
+std::shared_ptr<Message> MakeCallMessage(InboundCall* call, bool use_call_arena) {
+  if (use_call_arena) {
+    return internal::MakeCallMessage<Message>(
+        call, typename google::protobuf::Arena::is_arena_constructable<Message>::type());
+  }
+  return std::make_shared<Message>();
+}
+
 #define PANIC_RPC(rpc_context, message) \
   do { \
     yb::rpc::PanicRpc((rpc_context), __FILE__, __LINE__, (message)); \
@@ -69,6 +69,7 @@ void RpcController::Swap(RpcController* other) {
   std::swap(timeout_, other->timeout_);
   std::swap(allow_local_calls_in_curr_thread_, other->allow_local_calls_in_curr_thread_);
   std::swap(call_, other->call_);
+  std::swap(request_tail_, other->request_tail_);
 }
 
 void RpcController::Reset() {
@@ -77,6 +78,7 @@ void RpcController::Reset() {
     CHECK(finished());
   }
   call_.reset();
+  request_tail_.clear();
 }
 
 bool RpcController::finished() const {
@@ -33,6 +33,7 @@
 #define YB_RPC_RPC_CONTROLLER_H
 
 #include <memory>
+#include <vector>
 
 #include <glog/logging.h>
 
@@ -40,6 +41,7 @@
 #include "yb/rpc/rpc_fwd.h"
 #include "yb/util/locks.h"
 #include "yb/util/monotime.h"
+#include "yb/util/ref_cnt_buffer.h"
 #include "yb/util/status.h"
 
 namespace yb {
@@ -127,6 +129,15 @@ class RpcController {
   // Return the configured timeout.
   MonoDelta timeout() const;
 
+  // Buffers that are sent after the serialized request, as part of it. They must hold complete
+  // fields of the request message in wire format, e.g. elements of a repeated field that were
+  // serialized once and are shared by several calls. The request passed to the proxy should not
+  // contain those fields itself. Not supported for local calls.
+  void set_request_tail(std::vector<RefCntBuffer> request_tail) {
+    request_tail_ = std::move(request_tail);
+  }
+  const std::vector<RefCntBuffer>& request_tail() const { return request_tail_; }
+
   // Fills the 'sidecar' parameter with the slice pointing to the i-th
   // sidecar upon success.
   //
@@ -147,6 +158,7 @@ class RpcController {
   // Once the call is sent, it is tracked here.
   OutboundCallPtr call_;
   bool allow_local_calls_in_curr_thread_ = false;
+  std::vector<RefCntBuffer> request_tail_;
 
   DISALLOW_COPY_AND_ASSIGN(RpcController);
 };
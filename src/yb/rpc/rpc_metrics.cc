@@ -13,6 +13,8 @@
 
 #include "yb/rpc/rpc_metrics.h"
 
+#include "yb/rpc/inbound_call.h"
+
 METRIC_DEFINE_gauge_int64(server, rpc_connections_alive,
                           "Number of alive RPC connections.",
                           yb::MetricUnit::kConnections,
@@ -43,10 +45,16 @@ METRIC_DEFINE_counter(server, rpc_outbound_calls_created,
                       yb::MetricUnit::kRequests,
                       "Number of created RPC outbound calls.");
 
+METRIC_DEFINE_counter(server, rpc_socket_writes,
+                      "Number of write system calls on RPC connections.",
+                      yb::MetricUnit::kOperations,
+                      "Number of write system calls on RPC connections.");
+
 namespace yb {
 namespace rpc {
 
-RpcMetrics::RpcMetrics(const scoped_refptr<MetricEntity>& metric_entity) {
+RpcMetrics::RpcMetrics(const scoped_refptr<MetricEntity>& metric_entity)
+    : call_stages(new InboundCallStageStats) {
   if (metric_entity) {
     connections_alive = METRIC_rpc_connections_alive.Instantiate(metric_entity, 0);
     connections_created = METRIC_rpc_connections_created.Instantiate(metric_entity);
@@ -54,8 +62,11 @@ RpcMetrics::RpcMetrics(const scoped_refptr<MetricEntity>& metric_entity) {
     inbound_calls_created = METRIC_rpc_inbound_calls_created.Instantiate(metric_entity);
     outbound_calls_alive = METRIC_rpc_outbound_calls_alive.Instantiate(metric_entity, 0);
     outbound_calls_created = METRIC_rpc_outbound_calls_created.Instantiate(metric_entity);
+    socket_writes = METRIC_rpc_socket_writes.Instantiate(metric_entity);
   }
 }
 
+RpcMetrics::~RpcMetrics() = default;
+
 } // namespace rpc
 } // namespace yb
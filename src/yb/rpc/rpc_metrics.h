@@ -19,8 +19,11 @@
 namespace yb {
 namespace rpc {
 
+class InboundCallStageStats;
+
 struct RpcMetrics {
   explicit RpcMetrics(const scoped_refptr<MetricEntity>& metric_entity);
+  ~RpcMetrics();
 
   scoped_refptr<AtomicGauge<int64_t>> connections_alive;
   scoped_refptr<Counter> connections_created;
@@ -28,6 +31,8 @@ struct RpcMetrics {
   scoped_refptr<Counter> inbound_calls_created;
   scoped_refptr<AtomicGauge<int64_t>> outbound_calls_alive;
   scoped_refptr<Counter> outbound_calls_created;
+  scoped_refptr<Counter> socket_writes;
+  std::unique_ptr<InboundCallStageStats> call_stages;
 };
 
 } // namespace rpc
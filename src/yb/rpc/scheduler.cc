@@ -15,26 +15,29 @@
 
 #include "yb/rpc/scheduler.h"
 
+#include <unordered_map>
+
 #include <boost/asio/steady_timer.hpp>
 #include <boost/asio/strand.hpp>
 
-#include <boost/multi_index_container.hpp>
-#include <boost/multi_index/hashed_index.hpp>
-#include <boost/multi_index/mem_fun.hpp>
-#include <boost/multi_index/ordered_index.hpp>
-
 #include <glog/logging.h>
 
 #include "yb/util/status.h"
+#include "yb/util/timer_wheel.h"
 
+using namespace std::literals;
 using namespace std::placeholders;
-using boost::multi_index::const_mem_fun;
-using boost::multi_index::hashed_unique;
-using boost::multi_index::ordered_non_unique;
 
 namespace yb {
 namespace rpc {
 
+namespace {
+
+// Scheduled tasks are run at most this time after their scheduled time.
+constexpr auto kTimerWheelResolution = 1ms;
+
+} // namespace
+
 class Scheduler::Impl {
  public:
   explicit Impl(IoService* io_service)
@@ -48,11 +51,12 @@ class Scheduler::Impl {
 
   void Abort(ScheduledTaskId task_id) {
     strand_.dispatch([this, task_id] {
-      auto& index = tasks_.get<IdTag>();
-      auto it = index.find(task_id);
-      if (it != index.end()) {
-        io_service_.post([task = *it] { task->Run(STATUS(Aborted, "Task aborted")); });
-        index.erase(it);
+      auto it = handles_.find(task_id);
+      if (it != handles_.end()) {
+        io_service_.post([task = tasks_.Cancel(it->second)] {
+          task->Run(STATUS(Aborted, "Task aborted"));
+        });
+        handles_.erase(it);
       }
     });
   }
@@ -68,10 +72,10 @@ class Scheduler::Impl {
         auto status = STATUS(ServiceUnavailable, "Scheduler is shutting down", "", ESHUTDOWN);
         // Abort all scheduled tasks. It is ok to run task earlier than it was scheduled because
         // we pass error status to it.
-        for (auto task : tasks_) {
+        for (auto& task : tasks_.TakeAll()) {
           io_service_.post([task, status] { task->Run(status); });
         }
-        tasks_.clear();
+        handles_.clear();
       });
     }
   }
@@ -85,9 +89,11 @@ class Scheduler::Impl {
         return;
       }
 
-      auto pair = tasks_.insert(task);
+      auto time = task->time();
+      auto id = task->id();
+      auto pair = handles_.emplace(id, tasks_.Insert(time, std::move(task)));
       CHECK(pair.second);
-      if (pair.first == tasks_.begin()) {
+      if (time < timer_time_) {
         StartTimer();
       }
     });
@@ -102,8 +108,9 @@ class Scheduler::Impl {
     DCHECK(strand_.running_in_this_thread());
     DCHECK(!tasks_.empty());
 
+    timer_time_ = tasks_.NextAdvanceTime();
     boost::system::error_code ec;
-    timer_.expires_at((*tasks_.begin())->time(), ec);
+    timer_.expires_at(timer_time_, ec);
     LOG_IF(ERROR, ec) << "Reschedule timer failed: " << ec.message();
     ++timer_counter_;
     timer_.async_wait(strand_.wrap(std::bind(&Impl::HandleTimer, this, _1)));
@@ -117,42 +124,35 @@ class Scheduler::Impl {
       LOG_IF(ERROR, ec != boost::asio::error::operation_aborted) << "Wait failed: " << ec.message();
       return;
     }
+    timer_time_ = SteadyTimePoint::max();
     if (closing_.load(std::memory_order_acquire)) {
       return;
     }
 
     auto now = std::chrono::steady_clock::now();
-    while (!tasks_.empty() && (*tasks_.begin())->time() <= now) {
-      io_service_.post([task = *tasks_.begin()] { task->Run(Status::OK()); });
-      tasks_.erase(tasks_.begin());
-    }
+    tasks_.Advance(now, [this](std::shared_ptr<ScheduledTaskBase> task) {
+      handles_.erase(task->id());
+      io_service_.post([task = std::move(task)] { task->Run(Status::OK()); });
+    });
 
     if (!tasks_.empty()) {
       StartTimer();
     }
   }
 
-  class IdTag;
-
-  typedef boost::multi_index_container<
-      std::shared_ptr<ScheduledTaskBase>,
-      boost::multi_index::indexed_by<
-          ordered_non_unique<
-              const_mem_fun<ScheduledTaskBase, SteadyTimePoint, &ScheduledTaskBase::time>
-          >,
-          hashed_unique<
-              boost::multi_index::tag<IdTag>,
-              const_mem_fun<ScheduledTaskBase, ScheduledTaskId, &ScheduledTaskBase::id>
-          >
-      >
-  > Tasks;
+  typedef TimerWheel<std::shared_ptr<ScheduledTaskBase>> Tasks;
 
   IoService& io_service_;
   std::atomic<ScheduledTaskId> id_ = {0};
-  Tasks tasks_;
-  // Strand that protects tasks_ and timer_ fields.
+  // Most tasks are aborted before they are run, so they are kept in timer wheel, that provides
+  // constant time insertion and removal.
+  Tasks tasks_{kTimerWheelResolution};
+  std::unordered_map<ScheduledTaskId, Tasks::Handle> handles_;
+  // Strand that protects tasks_, handles_, timer_ and timer_time_ fields.
   boost::asio::io_service::strand strand_;
   boost::asio::steady_timer timer_;
+  // Time when timer_ expires, max if it is not started.
+  SteadyTimePoint timer_time_ = SteadyTimePoint::max();
   int timer_counter_ = 0;
   std::atomic<bool> closing_ = {false};
 };
@@ -59,5 +59,9 @@ ServiceIf::~ServiceIf() {
 void ServiceIf::Shutdown() {
 }
 
+RpcPriorityClass ServiceIf::PriorityClass(const std::string& method_name) const {
+  return RpcPriorityClass::kWrite;
+}
+
 } // namespace rpc
 } // namespace yb
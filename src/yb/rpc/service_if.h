@@ -37,6 +37,7 @@
 #include "yb/gutil/macros.h"
 #include "yb/gutil/ref_counted.h"
 #include "yb/rpc/rpc_fwd.h"
+#include "yb/rpc/thread_pool.h"
 #include "yb/util/metrics.h"
 #include "yb/util/net/sockaddr.h"
 
@@ -68,6 +69,9 @@ class ServiceIf {
 
   virtual void Shutdown();
   virtual std::string service_name() const = 0;
+
+  // Returns the priority class of thread pool tasks that handle calls of the method.
+  virtual RpcPriorityClass PriorityClass(const std::string& method_name) const;
 };
 
 }  // namespace rpc
@@ -32,10 +32,16 @@
 
 #include "yb/rpc/service_pool.h"
 
+#include <array>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
+#include <boost/optional.hpp>
+#include <boost/preprocessor/cat.hpp>
+
 #include <glog/logging.h>
 
 #include "yb/gutil/gscoped_ptr.h"
@@ -46,8 +52,12 @@
 #include "yb/rpc/service_if.h"
 #include "yb/rpc/tasks_pool.h"
 
+#include "yb/gutil/strings/numbers.h"
+#include "yb/gutil/strings/split.h"
 #include "yb/gutil/strings/substitute.h"
 #include "yb/util/flag_tags.h"
+#include "yb/util/kernel_stack_watchdog.h"
+#include "yb/util/locks.h"
 #include "yb/util/metrics.h"
 #include "yb/util/status.h"
 #include "yb/util/thread.h"
@@ -66,6 +76,21 @@ DEFINE_int64(backpressure_recovery_period_ms, 600000,
              "for this duration (in ms)");
 TAG_FLAG(backpressure_recovery_period_ms, advanced);
 TAG_FLAG(backpressure_recovery_period_ms, runtime);
+DEFINE_int32(rpc_min_remaining_time_to_handle_ms, 0,
+             "Fail calls that have less than this amount of time left before their client "
+             "deadline when taken from the queue, since they are unlikely to complete in time.");
+TAG_FLAG(rpc_min_remaining_time_to_handle_ms, advanced);
+TAG_FLAG(rpc_min_remaining_time_to_handle_ms, runtime);
+DEFINE_int32(rpc_stack_sampling_threshold_ms, -1,
+             "Stacks of threads handling an RPC call for longer than this number of milliseconds "
+             "are sampled while the handler runs, and aggregated per method at /stack-samples of "
+             "the web server. Negative to disable, except for methods listed in "
+             "--rpc_stack_sampling_method_thresholds_ms.");
+TAG_FLAG(rpc_stack_sampling_threshold_ms, advanced);
+DEFINE_string(rpc_stack_sampling_method_thresholds_ms, "",
+              "Comma separated list of method:threshold_ms pairs overriding "
+              "--rpc_stack_sampling_threshold_ms for these RPC methods, e.g. Write:50,Read:20.");
+TAG_FLAG(rpc_stack_sampling_method_thresholds_ms, advanced);
 DEFINE_test_flag(bool, enable_backpressure_mode_for_testing, false,
             "For testing purposes. Enables the rpc's to be considered timed out in the queue even "
             "when we have not had any backpressure in the recent past.");
@@ -76,6 +101,21 @@ METRIC_DEFINE_histogram(server, rpc_incoming_queue_time,
                         "Number of microseconds incoming RPC requests spend in the worker queue",
                         60000000LU, 3);
 
+#define YB_DEFINE_QUEUE_TIME_HISTOGRAM(priority_class, description) \
+  METRIC_DEFINE_histogram(server, BOOST_PP_CAT(rpc_incoming_queue_time_, priority_class), \
+                          "RPC Queue Time of " description " calls", \
+                          yb::MetricUnit::kMicroseconds, \
+                          "Number of microseconds incoming RPC requests of the " description \
+                          " priority class spend in the worker queue", \
+                          60000000LU, 3)
+
+YB_DEFINE_QUEUE_TIME_HISTOGRAM(consensus, "consensus");
+YB_DEFINE_QUEUE_TIME_HISTOGRAM(point_read, "point read");
+YB_DEFINE_QUEUE_TIME_HISTOGRAM(write, "write");
+YB_DEFINE_QUEUE_TIME_HISTOGRAM(bulk, "bulk");
+
+#undef YB_DEFINE_QUEUE_TIME_HISTOGRAM
+
 METRIC_DEFINE_counter(server, rpcs_timed_out_in_queue,
                       "RPC Queue Timeouts",
                       yb::MetricUnit::kRequests,
@@ -98,16 +138,21 @@ static constexpr CoarseMonoClock::Duration kNone{
 
 class InboundCallTask final {
  public:
-  InboundCallTask(ServicePoolImpl* pool, InboundCallPtr call)
-      : pool_(pool), call_(std::move(call)) {
+  InboundCallTask(ServicePoolImpl* pool, InboundCallPtr call, RpcPriorityClass priority_class)
+      : pool_(pool), call_(std::move(call)), priority_class_(priority_class) {
   }
 
   void Run();
   void Done(const Status& status);
 
+  RpcPriorityClass priority_class() const {
+    return priority_class_;
+  }
+
  private:
   ServicePoolImpl* pool_;
   InboundCallPtr call_;
+  RpcPriorityClass priority_class_;
 };
 
 } // namespace
@@ -123,7 +168,25 @@ class ServicePoolImpl {
         incoming_queue_time_(METRIC_rpc_incoming_queue_time.Instantiate(entity)),
         rpcs_timed_out_in_queue_(METRIC_rpcs_timed_out_in_queue.Instantiate(entity)),
         rpcs_queue_overflow_(METRIC_rpcs_queue_overflow.Instantiate(entity)),
+        queue_time_by_class_{
+            METRIC_rpc_incoming_queue_time_consensus.Instantiate(entity),
+            METRIC_rpc_incoming_queue_time_point_read.Instantiate(entity),
+            METRIC_rpc_incoming_queue_time_write.Instantiate(entity),
+            METRIC_rpc_incoming_queue_time_bulk.Instantiate(entity)},
         tasks_pool_(max_tasks) {
+    for (auto entry : strings::Split(
+             FLAGS_rpc_stack_sampling_method_thresholds_ms, ",", strings::SkipEmpty())) {
+      std::vector<std::string> method_and_threshold = strings::Split(entry, ":");
+      int32_t threshold_ms;
+      if (method_and_threshold.size() != 2 ||
+          !safe_strto32(method_and_threshold[1], &threshold_ms)) {
+        LOG(WARNING) << "Invalid entry in rpc_stack_sampling_method_thresholds_ms: " << entry;
+        continue;
+      }
+      stack_sampling_thresholds_ms_[method_and_threshold[0]] = threshold_ms;
+    }
+    stack_sampling_enabled_ =
+        FLAGS_rpc_stack_sampling_threshold_ms >= 0 || !stack_sampling_thresholds_ms_.empty();
   }
 
   ~ServicePoolImpl() {
@@ -139,8 +202,10 @@ class ServicePoolImpl {
 
   void Enqueue(InboundCallPtr call) {
     TRACE_TO(call->trace(), "Inserting onto call queue");
+    call->RecordStage(InboundCallStage::kQueued);
 
-    if (!tasks_pool_.Enqueue(thread_pool_, this, std::move(call))) {
+    auto priority_class = service_->PriorityClass(call->method_name());
+    if (!tasks_pool_.Enqueue(thread_pool_, this, std::move(call), priority_class)) {
       Overflow(call, "service", tasks_pool_.size());
     }
   }
@@ -191,11 +256,15 @@ class ServicePoolImpl {
 
   void Handle(InboundCallPtr incoming) {
     incoming->RecordHandlingStarted(incoming_queue_time_);
+    auto priority_class = service_->PriorityClass(incoming->method_name());
+    queue_time_by_class_[to_underlying(priority_class)]->Increment(
+        incoming->GetTimeInQueue().ToMicroseconds());
     ADOPT_TRACE(incoming->trace());
 
-    if (PREDICT_FALSE(incoming->ClientTimedOut() || ShouldDropRequestDuringHighLoad(incoming))) {
+    const bool cannot_meet_deadline = CannotMeetDeadline(incoming);
+    if (PREDICT_FALSE(cannot_meet_deadline || ShouldDropRequestDuringHighLoad(incoming))) {
       const char* message =
-          (incoming->ClientTimedOut()
+          (cannot_meet_deadline
                ? "Call waited in the queue past deadline"
                : "The server is overloaded. Call waited in the queue past max_time_in_queue.");
       TRACE_TO(incoming->trace(), message);
@@ -211,10 +280,56 @@ class ServicePoolImpl {
 
     TRACE_TO(incoming->trace(), "Handling call");
 
+    boost::optional<ScopedWatchKernelStack> stack_sampling;
+    if (stack_sampling_enabled_) {
+      auto sampled_method = GetSampledMethod(incoming->method_name());
+      if (sampled_method.label) {
+        stack_sampling.emplace(
+            sampled_method.label, sampled_method.threshold_ms, SampleStacks::kTrue);
+      }
+    }
     service_->Handle(std::move(incoming));
   }
 
  private:
+  struct SampledMethod {
+    // Label of the method for the KernelStackWatchdog, null if the method is not sampled.
+    const char* label = nullptr;
+    int threshold_ms = -1;
+  };
+
+  SampledMethod GetSampledMethod(const std::string& method_name) {
+    {
+      shared_lock<rw_spinlock> lock(sampled_methods_lock_);
+      auto it = sampled_methods_.find(method_name);
+      if (it != sampled_methods_.end()) {
+        return it->second;
+      }
+    }
+
+    SampledMethod result;
+    auto it = stack_sampling_thresholds_ms_.find(method_name);
+    result.threshold_ms = it != stack_sampling_thresholds_ms_.end()
+        ? it->second : FLAGS_rpc_stack_sampling_threshold_ms;
+    if (result.threshold_ms >= 0) {
+      result.label = KernelStackWatchdog::GetInstance()->InternLabel(
+          service_->service_name() + "." + method_name);
+    }
+    std::lock_guard<rw_spinlock> lock(sampled_methods_lock_);
+    sampled_methods_.emplace(method_name, result);
+    return result;
+  }
+
+  bool CannotMeetDeadline(const InboundCallPtr& incoming) {
+    auto min_remaining_time_ms = GetAtomicFlag(&FLAGS_rpc_min_remaining_time_to_handle_ms);
+    if (min_remaining_time_ms <= 0) {
+      return incoming->ClientTimedOut();
+    }
+    auto deadline = incoming->GetClientDeadline();
+    return deadline != CoarseTimePoint::max() &&
+           deadline < CoarseMonoClock::now() + std::chrono::milliseconds(min_remaining_time_ms);
+  }
+
   bool ShouldDropRequestDuringHighLoad(InboundCallPtr incoming) {
     auto last_backpressure_at = last_backpressure_at_.load(std::memory_order_acquire);
 
@@ -242,10 +357,16 @@ class ServicePoolImpl {
   scoped_refptr<Histogram> incoming_queue_time_;
   scoped_refptr<Counter> rpcs_timed_out_in_queue_;
   scoped_refptr<Counter> rpcs_queue_overflow_;
+  std::array<scoped_refptr<Histogram>, kRpcPriorityClassMapSize> queue_time_by_class_;
   std::atomic<CoarseMonoClock::Duration> last_backpressure_at_;
 
   std::atomic<bool> closing_ = {false};
   TasksPool<InboundCallTask> tasks_pool_;
+
+  std::unordered_map<std::string, int> stack_sampling_thresholds_ms_;
+  bool stack_sampling_enabled_;
+  rw_spinlock sampled_methods_lock_;
+  std::unordered_map<std::string, SampledMethod> sampled_methods_;
 };
 
 void InboundCallTask::Run() {
@@ -66,6 +66,14 @@ class TasksPool {
       return *reinterpret_cast<Task*>(&storage);;
     }
 
+    const Task& task() const {
+      return *reinterpret_cast<const Task*>(&storage);
+    }
+
+    RpcPriorityClass priority_class() const override {
+      return task().priority_class();
+    }
+
     void Run() override {
       task().Run();
     }
@@ -13,9 +13,13 @@
 
 #include "yb/rpc/tcp_stream.h"
 
+#include <limits.h>
+
 #include "yb/rpc/outbound_data.h"
+#include "yb/rpc/rpc_metrics.h"
 
 #include "yb/util/flag_tags.h"
+#include "yb/util/format.h"
 #include "yb/util/logging.h"
 #include "yb/util/string_util.h"
 
@@ -24,22 +28,40 @@ using namespace std::literals;
 DECLARE_uint64(rpc_connection_timeout_ms);
 DEFINE_test_flag(int32, TEST_delay_connect_ms, 0,
                  "Delay connect in tests for specified amount of milliseconds.");
+DEFINE_string(rpc_local_socket_dir, "",
+              "Directory of Unix domain sockets, that servers listen on in addition to their TCP "
+              "addresses. Clients on the same host connect to them, bypassing the TCP/IP stack. "
+              "Empty to disable.");
+TAG_FLAG(rpc_local_socket_dir, advanced);
 
 namespace yb {
 namespace rpc {
 
 namespace {
 
-const size_t kMaxIov = 16;
+// Outbound data queued to a connection is written with a single writev when possible.
+const size_t kMaxIov = IOV_MAX;
+
+}
 
+std::string LocalSocketPath(const Endpoint& endpoint) {
+  if (FLAGS_rpc_local_socket_dir.empty()) {
+    return std::string();
+  }
+  return Format("$0/.yb_rpc.$1:$2",
+                FLAGS_rpc_local_socket_dir, endpoint.address().to_string(), endpoint.port());
 }
 
-TcpStream::TcpStream(const StreamCreateData& data)
+TcpStream::TcpStream(const StreamCreateData& data, const Protocol* protocol)
     : socket_(std::move(*data.socket)),
-      remote_(data.remote) {
+      remote_(data.remote),
+      protocol_(protocol) {
   if (data.mem_tracker) {
     mem_tracker_ = MemTracker::FindOrCreateTracker("Sending", data.mem_tracker);
   }
+  if (data.rpc_metrics) {
+    socket_writes_ = data.rpc_metrics->socket_writes;
+  }
 }
 
 TcpStream::~TcpStream() {
@@ -57,7 +79,9 @@ Status TcpStream::Start(bool connect, ev::loop_ref* loop, StreamContext* context
   context_ = context;
   connected_ = !connect;
 
-  RETURN_NOT_OK(socket_.SetNoDelay(true));
+  if (!socket_.IsUnixDomain()) {
+    RETURN_NOT_OK(socket_.SetNoDelay(true));
+  }
   RETURN_NOT_OK(socket_.SetSendTimeout(FLAGS_rpc_connection_timeout_ms * 1ms));
   RETURN_NOT_OK(socket_.SetRecvTimeout(FLAGS_rpc_connection_timeout_ms * 1ms));
 
@@ -73,15 +97,22 @@ Status TcpStream::Start(bool connect, ev::loop_ref* loop, StreamContext* context
 }
 
 Status TcpStream::DoStart(ev::loop_ref* loop, bool connect) {
+  const bool unix_domain = socket_.IsUnixDomain();
   if (connect) {
-    auto status = socket_.Connect(remote_);
+    auto status = unix_domain ? socket_.ConnectUnix(LocalSocketPath(remote_))
+                              : socket_.Connect(remote_);
     if (!status.ok() && !Socket::IsTemporarySocketError(status)) {
       LOG_WITH_PREFIX(WARNING) << "Connect failed: " << status;
       return status;
     }
   }
 
-  RETURN_NOT_OK(socket_.GetSocketAddress(&local_));
+  if (unix_domain) {
+    // Both ends are on the same host, and the socket has no TCP port.
+    local_ = Endpoint(remote_.address(), 0);
+  } else {
+    RETURN_NOT_OK(socket_.GetSocketAddress(&local_));
+  }
   log_prefix_.clear();
 
   io_.set(*loop);
@@ -184,7 +215,11 @@ Status TcpStream::DoWrite() {
     context_->UpdateLastActivity();
 
     int32_t written = 0;
-    auto status = iov_len != 0 ? socket_.Writev(iov, iov_len, &written) : Status::OK();
+    auto status = Status::OK();
+    if (iov_len != 0) {
+      status = socket_.Writev(iov, iov_len, &written);
+      IncrementCounter(socket_writes_);
+    }
     DVLOG_WITH_PREFIX(4) << "Queued writes " << queued_bytes_to_send_ << " bytes. written "
                          << written << " . Status " << status << " sending_ .size() "
                          << sending_.size();
@@ -442,15 +477,25 @@ const Protocol* TcpStream::StaticProtocol() {
   return &result;
 }
 
-StreamFactoryPtr TcpStream::Factory() {
+const Protocol* TcpStream::CompressedProtocol() {
+  static Protocol result("tcp_compressed");
+  return &result;
+}
+
+StreamFactoryPtr TcpStream::Factory(const Protocol* protocol) {
   class TcpStreamFactory : public StreamFactory {
+   public:
+    explicit TcpStreamFactory(const Protocol* protocol) : protocol_(protocol) {}
+
    private:
     std::unique_ptr<Stream> Create(const StreamCreateData& data) override {
-      return std::make_unique<TcpStream>(data);
+      return std::make_unique<TcpStream>(data, protocol_);
     }
+
+    const Protocol* const protocol_;
   };
 
-  return std::make_shared<TcpStreamFactory>();
+  return std::make_shared<TcpStreamFactory>(protocol);
 }
 
 TcpStream::SendingData::SendingData(OutboundDataPtr data_, const MemTrackerPtr& mem_tracker)
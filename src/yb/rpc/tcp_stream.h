@@ -19,15 +19,20 @@
 #include "yb/rpc/growable_buffer.h"
 #include "yb/rpc/stream.h"
 
+#include "yb/util/metrics.h"
 #include "yb/util/net/socket.h"
 #include "yb/util/ref_cnt_buffer.h"
 
 namespace yb {
 namespace rpc {
 
+// Returns path of Unix domain socket that server listening on endpoint accepts connections from the
+// same host on, or empty string when FLAGS_rpc_local_socket_dir is not set.
+std::string LocalSocketPath(const Endpoint& endpoint);
+
 class TcpStream : public Stream {
  public:
-  explicit TcpStream(const StreamCreateData& data);
+  explicit TcpStream(const StreamCreateData& data, const Protocol* protocol = StaticProtocol());
   ~TcpStream();
 
   Socket* socket() { return &socket_; }
@@ -37,7 +42,9 @@ class TcpStream : public Stream {
   }
 
   static const rpc::Protocol* StaticProtocol();
-  static StreamFactoryPtr Factory();
+  // TCP streams of connections whose messages are compressed.
+  static const rpc::Protocol* CompressedProtocol();
+  static StreamFactoryPtr Factory(const Protocol* protocol = StaticProtocol());
 
  private:
   CHECKED_STATUS Start(bool connect, ev::loop_ref* loop, StreamContext* context) override;
@@ -55,7 +62,7 @@ class TcpStream : public Stream {
   const Endpoint& Local() override { return local_; }
 
   const Protocol* GetProtocol() override {
-    return StaticProtocol();
+    return protocol_;
   }
 
   void ParseReceived() override;
@@ -96,6 +103,8 @@ class TcpStream : public Stream {
   // The remote address we're talking to.
   const Endpoint remote_;
 
+  const Protocol* const protocol_;
+
   StreamContext* context_;
 
   // Notifies us when our socket is readable or writable.
@@ -142,6 +151,7 @@ class TcpStream : public Stream {
   size_t queued_bytes_to_send_ = 0;
   bool waiting_write_ready_ = false;
   MemTrackerPtr mem_tracker_;
+  scoped_refptr<Counter> socket_writes_;
 };
 
 } // namespace rpc
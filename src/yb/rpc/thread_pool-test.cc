@@ -14,8 +14,10 @@
 //
 
 #include <atomic>
+#include <deque>
 #include <thread>
 
+#include <gflags/gflags.h>
 #include <gtest/gtest.h>
 
 #include "yb/rpc/thread_pool.h"
@@ -24,6 +26,10 @@
 #include "yb/util/test_util.h"
 #include "yb/util/thread.h"
 
+DECLARE_double(rpc_bulk_queue_limit_fraction);
+DECLARE_int32(rpc_thread_pool_shards);
+DECLARE_int32(rpc_worker_spin_us);
+
 namespace yb {
 namespace rpc {
 
@@ -39,7 +45,8 @@ enum class TestTaskState {
 
 class TestTask final : public ThreadPoolTask {
  public:
-  TestTask() {}
+  explicit TestTask(RpcPriorityClass priority_class = RpcPriorityClass::kWrite)
+      : priority_class_(priority_class) {}
 
   ~TestTask() {}
 
@@ -59,6 +66,10 @@ class TestTask final : public ThreadPoolTask {
     latch_ = latch;
   }
 
+  RpcPriorityClass priority_class() const override {
+    return priority_class_;
+  }
+
  private:
   void Run() override {
     auto expected = TestTaskState::IDLE;
@@ -75,6 +86,7 @@ class TestTask final : public ThreadPoolTask {
     }
   }
 
+  const RpcPriorityClass priority_class_;
   CountDownLatch* latch_ = nullptr;
   std::atomic<TestTaskState> state_ = { TestTaskState::IDLE };
 };
@@ -142,6 +154,39 @@ TEST_F(ThreadPoolTest, TestMultiProducers) {
   }
 }
 
+TEST_F(ThreadPoolTest, TestShardsWithSpinning) {
+  constexpr size_t kTotalTasks = 10000;
+  constexpr size_t kTotalWorkers = 4;
+  constexpr size_t kProducers = 8;
+  FLAGS_rpc_thread_pool_shards = 4;
+  FLAGS_rpc_worker_spin_us = 50;
+  ThreadPool pool("test", kTotalTasks, kTotalWorkers);
+
+  CountDownLatch latch(kTotalTasks);
+  std::vector<TestTask> tasks(kTotalTasks);
+  std::vector<std::thread> threads;
+  size_t begin = 0;
+  for (size_t i = 0; i != kProducers; ++i) {
+    size_t end = kTotalTasks * (i + 1) / kProducers;
+    threads.emplace_back([&pool, &latch, &tasks, begin, end] {
+      for (size_t i = begin; i != end; ++i) {
+        tasks[i].SetLatch(&latch);
+        // Workers are created on demand, so some shards could have no workers for a while and
+        // their tasks are completed only by stealing.
+        ASSERT_TRUE(pool.Enqueue(&tasks[i]));
+      }
+    });
+    begin = end;
+  }
+  latch.Wait();
+  for (auto& task : tasks) {
+    ASSERT_TRUE(task.IsCompleted());
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+}
+
 TEST_F(ThreadPoolTest, TestQueueOverflow) {
   constexpr size_t kTotalTasks = 10000;
   constexpr size_t kTotalWorkers = 4;
@@ -179,6 +224,50 @@ TEST_F(ThreadPoolTest, TestQueueOverflow) {
   }
 }
 
+TEST_F(ThreadPoolTest, TestBulkQueueLimit) {
+  constexpr size_t kQueueLimit = 10;
+  FLAGS_rpc_bulk_queue_limit_fraction = 0.5;
+
+  class BlockingTask : public ThreadPoolTask {
+   public:
+    void Run() override {
+      started.CountDown();
+      release.Wait();
+    }
+
+    void Done(const Status& status) override {}
+
+    CountDownLatch started{1};
+    CountDownLatch release{1};
+  };
+
+  ThreadPool pool("test", kQueueLimit, 1 /* max_workers */);
+  BlockingTask blocking_task;
+  ASSERT_TRUE(pool.Enqueue(&blocking_task));
+  blocking_task.started.Wait();
+
+  // Bulk tasks get only half of the queue, while other tasks could use the rest of it.
+  std::deque<TestTask> bulk_tasks;
+  std::deque<TestTask> point_read_tasks;
+  for (size_t i = 0; i != kQueueLimit; ++i) {
+    bulk_tasks.emplace_back(RpcPriorityClass::kBulk);
+    point_read_tasks.emplace_back(RpcPriorityClass::kPointRead);
+  }
+  for (size_t i = 0; i != kQueueLimit; ++i) {
+    ASSERT_EQ(i < kQueueLimit / 2, pool.Enqueue(&bulk_tasks[i])) << i;
+  }
+  for (size_t i = 0; i != kQueueLimit; ++i) {
+    ASSERT_EQ(i < kQueueLimit / 2, pool.Enqueue(&point_read_tasks[i])) << i;
+  }
+
+  blocking_task.release.CountDown();
+  pool.Shutdown();
+  for (size_t i = 0; i != kQueueLimit; ++i) {
+    ASSERT_TRUE(bulk_tasks[i].IsDone());
+    ASSERT_TRUE(point_read_tasks[i].IsDone());
+  }
+}
+
 TEST_F(ThreadPoolTest, TestShutdown) {
   constexpr size_t kTotalTasks = 10000;
   constexpr size_t kTotalWorkers = 4;
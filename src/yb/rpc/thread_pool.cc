@@ -15,15 +15,42 @@
 
 #include "yb/rpc/thread_pool.h"
 
+#include <algorithm>
+#include <array>
+#include <chrono>
 #include <condition_variable>
 #include <mutex>
 #include <thread>
+#include <vector>
 
 #include <boost/lockfree/queue.hpp>
 #include <boost/scope_exit.hpp>
 
+#include "yb/gutil/atomicops.h"
+
+#include "yb/util/atomic.h"
+#include "yb/util/flag_tags.h"
+#include "yb/util/numa.h"
 #include "yb/util/thread.h"
 
+DEFINE_double(rpc_bulk_queue_limit_fraction, 0.5,
+              "Fraction of the RPC thread pool queue limit that tasks of the bulk priority class, "
+              "such as scans and data imports, could occupy. Bulk tasks are rejected when the "
+              "queue has more tasks, so they are the first to degrade under overload.");
+TAG_FLAG(rpc_bulk_queue_limit_fraction, advanced);
+TAG_FLAG(rpc_bulk_queue_limit_fraction, runtime);
+
+DEFINE_int32(rpc_thread_pool_shards, 1,
+             "Number of shards the queue and workers of an RPC thread pool are split into. Tasks "
+             "are queued to the shard of the thread that enqueues them, e.g. a reactor, and idle "
+             "workers steal tasks from other shards.");
+TAG_FLAG(rpc_thread_pool_shards, advanced);
+
+DEFINE_int32(rpc_worker_spin_us, 0,
+             "Time an idle RPC worker keeps polling task queues before it goes to sleep.");
+TAG_FLAG(rpc_worker_spin_us, advanced);
+TAG_FLAG(rpc_worker_spin_us, runtime);
+
 namespace yb {
 namespace rpc {
 
@@ -34,15 +61,181 @@ class Worker;
 typedef boost::lockfree::queue<ThreadPoolTask*> TaskQueue;
 typedef boost::lockfree::queue<Worker*> WaitingWorkers;
 
+// Relative shares of workers' picks that go to each priority class, while it has queued tasks.
+constexpr std::array<size_t, kRpcPriorityClassMapSize> kPriorityClassWeights = {8, 4, 2, 1};
+constexpr size_t kTotalPriorityClassWeight = 8 + 4 + 2 + 1;
+
+// Returns priority classes in the order picks cycle through them, e.g. the consensus class
+// gets 8 of each 15 picks.
+std::array<RpcPriorityClass, kTotalPriorityClassWeight> MakePickSchedule() {
+  std::array<RpcPriorityClass, kTotalPriorityClassWeight> result;
+  size_t index = 0;
+  for (auto priority_class : kRpcPriorityClassList) {
+    for (size_t i = 0; i != kPriorityClassWeights[to_underlying(priority_class)]; ++i) {
+      result[index++] = priority_class;
+    }
+  }
+  return result;
+}
+
+const std::array<RpcPriorityClass, kTotalPriorityClassWeight> kPickSchedule = MakePickSchedule();
+
+// Part of the thread pool queue, with the workers that sleep waiting for its tasks.
+struct ThreadPoolShard {
+  // Queues of tasks for each priority class. The total number of queued tasks is limited by
+  // queue_limit, so each of them could hold all of the tasks.
+  const size_t queue_limit;
+  std::array<std::unique_ptr<TaskQueue>, kRpcPriorityClassMapSize> task_queues;
+  std::atomic<size_t> queued_tasks{0};
+  std::atomic<size_t> next_pick{0};
+  WaitingWorkers waiting_workers;
+
+  ThreadPoolShard(size_t queue_limit_, size_t max_workers)
+      : queue_limit(queue_limit_), waiting_workers(max_workers) {
+    for (auto& queue : task_queues) {
+      queue.reset(new TaskQueue(queue_limit));
+    }
+  }
+
+  bool PushTask(ThreadPoolTask* task) {
+    auto priority_class = task->priority_class();
+    size_t limit = queue_limit;
+    if (priority_class == RpcPriorityClass::kBulk) {
+      limit = static_cast<size_t>(limit * FLAGS_rpc_bulk_queue_limit_fraction);
+    }
+    if (queued_tasks.fetch_add(1, std::memory_order_acq_rel) >= limit) {
+      queued_tasks.fetch_sub(1, std::memory_order_acq_rel);
+      return false;
+    }
+    if (!task_queues[to_underlying(priority_class)]->bounded_push(task)) {
+      queued_tasks.fetch_sub(1, std::memory_order_acq_rel);
+      return false;
+    }
+    return true;
+  }
+
+  bool PopTask(ThreadPoolTask** task) {
+    auto preferred = kPickSchedule[
+        next_pick.fetch_add(1, std::memory_order_relaxed) % kTotalPriorityClassWeight];
+    if (!task_queues[to_underlying(preferred)]->pop(*task)) {
+      // Fall back to other classes in priority order.
+      bool found = false;
+      for (auto& queue : task_queues) {
+        if (queue->pop(*task)) {
+          found = true;
+          break;
+        }
+      }
+      if (!found) {
+        return false;
+      }
+    }
+    queued_tasks.fetch_sub(1, std::memory_order_acq_rel);
+    return true;
+  }
+
+  bool Empty() const {
+    for (const auto& queue : task_queues) {
+      if (!queue->empty()) {
+        return false;
+      }
+    }
+    return true;
+  }
+};
+
+// Sequential number of the current thread, used to pick its home shard in the thread pools.
+size_t CurrentThreadSeqNo() {
+  static std::atomic<size_t> next_seq_no{0};
+  static thread_local size_t seq_no = next_seq_no.fetch_add(1, std::memory_order_relaxed);
+  return seq_no;
+}
+
 struct ThreadPoolShare {
   ThreadPoolOptions options;
-  TaskQueue task_queue;
-  WaitingWorkers waiting_workers;
+  std::vector<std::unique_ptr<ThreadPoolShard>> shards;
+
+  // Shards are split evenly between NUMA domains, shard i and its workers belong to domain
+  // i % numa_domains. It is 1 when the pool has too few workers to have a shard in each domain.
+  size_t numa_domains = 1;
 
   explicit ThreadPoolShare(ThreadPoolOptions o)
-      : options(std::move(o)),
-        task_queue(options.queue_limit),
-        waiting_workers(options.max_workers) {
+      : options(std::move(o)) {
+    size_t num_shards = std::max<size_t>(
+        1, std::min<size_t>(FLAGS_rpc_thread_pool_shards, options.max_workers));
+    const size_t domains = NumNumaDomains();
+    if (domains > 1 && options.max_workers >= domains) {
+      numa_domains = domains;
+      num_shards = std::min((num_shards + domains - 1) / domains * domains,
+                            options.max_workers / domains * domains);
+    }
+    // Queue limit is split between shards, rounding up, so they could hold at least queue_limit
+    // tasks in total.
+    size_t shard_queue_limit = (options.queue_limit + num_shards - 1) / num_shards;
+    shards.reserve(num_shards);
+    for (size_t i = 0; i != num_shards; ++i) {
+      shards.emplace_back(new ThreadPoolShard(shard_queue_limit, options.max_workers));
+    }
+  }
+
+  // Shard that tasks enqueued by the current thread go to, unless it is full. Threads bound to a
+  // NUMA domain use the shards of their domain.
+  size_t HomeShard() const {
+    const int domain = CurrentNumaDomain();
+    if (numa_domains > 1 && domain >= 0) {
+      return domain % numa_domains +
+             numa_domains * (CurrentThreadSeqNo() % (shards.size() / numa_domains));
+    }
+    return CurrentThreadSeqNo() % shards.size();
+  }
+
+  size_t ShardOfWorker(size_t worker_index) const {
+    return worker_index % shards.size();
+  }
+
+  // Returns the i-th shard to try, starting from home_shard. Shards of the same NUMA domain are
+  // tried before the others.
+  size_t ShardToTry(size_t home_shard, size_t i) const {
+    const size_t shards_per_domain = shards.size() / numa_domains;
+    return (home_shard + numa_domains * i + i / shards_per_domain) % shards.size();
+  }
+
+  bool PushTask(ThreadPoolTask* task, size_t home_shard) {
+    for (size_t i = 0; i != shards.size(); ++i) {
+      if (shards[ShardToTry(home_shard, i)]->PushTask(task)) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  // Pops a task from the home shard, or steals one from other shards when it is empty.
+  bool PopTask(ThreadPoolTask** task, size_t home_shard) {
+    for (size_t i = 0; i != shards.size(); ++i) {
+      if (shards[ShardToTry(home_shard, i)]->PopTask(task)) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  // Pops a sleeping worker, preferring the ones of the home shard.
+  bool PopWaitingWorker(Worker** worker, size_t home_shard) {
+    for (size_t i = 0; i != shards.size(); ++i) {
+      if (shards[ShardToTry(home_shard, i)]->waiting_workers.pop(*worker)) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  bool Empty() const {
+    for (const auto& shard : shards) {
+      if (!shard->Empty()) {
+        return false;
+      }
+    }
+    return true;
   }
 };
 
@@ -55,7 +248,7 @@ const std::string kRpcThreadCategory = "rpc_thread_pool";
 class Worker {
  public:
   explicit Worker(ThreadPoolShare* share, size_t index)
-      : share_(share) {
+      : share_(share), shard_index_(share->ShardOfWorker(index)) {
     auto name = strings::Substitute("rpc_tp_$0_$1", share_->options.name, index);
     CHECK_OK(yb::Thread::Create(kRpcThreadCategory, name, &Worker::Execute, this, &thread_));
   }
@@ -95,6 +288,9 @@ class Worker {
   // does not have free hands (worker queue empty)
   void Execute() {
     Thread::current_thread()->SetUserData(share_);
+    if (share_->numa_domains > 1) {
+      BindCurrentThreadToNumaDomain(shard_index_ % share_->numa_domains);
+    }
     while (!stop_requested_) {
       ThreadPoolTask* task = nullptr;
       if (PopTask(&task)) {
@@ -107,7 +303,10 @@ class Worker {
   bool PopTask(ThreadPoolTask** task) {
     // First of all we try to get already queued task, w/o locking.
     // If there is no task, so we could go to waiting state.
-    if (share_->task_queue.pop(*task)) {
+    if (share_->PopTask(task, shard_index_)) {
+      return true;
+    }
+    if (Spin(task)) {
       return true;
     }
     std::unique_lock<std::mutex> lock(mutex_);
@@ -123,7 +322,7 @@ class Worker {
       // the worker queue. So worker queue could be empty in this case, and nobody was notified
       // about new task. So we check there for this case. This technique is similar to
       // double check.
-      if (share_->task_queue.pop(*task)) {
+      if (share_->PopTask(task, shard_index_)) {
         return true;
       }
 
@@ -131,22 +330,47 @@ class Worker {
 
       // Sometimes another worker could steal task before we wake up. In this case we will
       // just enqueue ourselves back.
-      if (share_->task_queue.pop(*task)) {
+      if (share_->PopTask(task, shard_index_)) {
         return true;
       }
     }
     return false;
   }
 
+  // Polls task queues for FLAGS_rpc_worker_spin_us before going to sleep, since a task that arrives
+  // shortly is picked faster, and without waking the worker up through the condition variable.
+  bool Spin(ThreadPoolTask** task) {
+    auto spin_us = GetAtomicFlag(&FLAGS_rpc_worker_spin_us);
+    if (spin_us <= 0) {
+      return false;
+    }
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::microseconds(spin_us);
+    while (!stop_requested_.load(std::memory_order_relaxed)) {
+      for (int i = 0; i != kSpinIterationsPerClockCheck; ++i) {
+        base::subtle::PauseCPU();
+      }
+      if (share_->PopTask(task, shard_index_)) {
+        return true;
+      }
+      if (std::chrono::steady_clock::now() >= deadline) {
+        break;
+      }
+    }
+    return false;
+  }
+
   void AddToWaitingWorkers() {
     if (!added_to_waiting_workers_) {
-      auto pushed = share_->waiting_workers.bounded_push(this);
+      auto pushed = share_->shards[shard_index_]->waiting_workers.bounded_push(this);
       CHECK(pushed);
       added_to_waiting_workers_ = true;
     }
   }
 
+  static constexpr int kSpinIterationsPerClockCheck = 16;
+
   ThreadPoolShare* share_;
+  const size_t shard_index_;
   scoped_refptr<yb::Thread> thread_;
   std::mutex mutex_;
   std::condition_variable cond_;
@@ -181,14 +405,15 @@ class ThreadPool::Impl {
       task->Done(shutdown_status_);
       return false;
     }
-    bool added = share_.task_queue.bounded_push(task);
+    auto home_shard = share_.HomeShard();
+    bool added = share_.PushTask(task, home_shard);
     --adding_;
     if (!added) {
       task->Done(queue_full_status_);
       return false;
     }
     Worker* worker = nullptr;
-    while (share_.waiting_workers.pop(worker)) {
+    while (share_.PopWaitingWorker(&worker, home_shard)) {
       if (worker->Notify()) {
         return true;
       }
@@ -215,7 +440,7 @@ class ThreadPool::Impl {
     {
       std::lock_guard<std::mutex> lock(mutex_);
       if (closing_) {
-        CHECK(share_.task_queue.empty());
+        CHECK(share_.Empty());
         CHECK(workers_.empty());
         return;
       }
@@ -234,7 +459,7 @@ class ThreadPool::Impl {
       std::this_thread::sleep_for(std::chrono::milliseconds(10));
     }
     ThreadPoolTask* task = nullptr;
-    while (share_.task_queue.pop(task)) {
+    while (share_.PopTask(&task, 0 /* home_shard */)) {
       task->Done(shutdown_status_);
     }
   }
@@ -21,6 +21,8 @@
 
 #include "yb/gutil/port.h"
 
+#include "yb/util/enums.h"
+
 namespace yb {
 
 class Status;
@@ -28,6 +30,11 @@ class Thread;
 
 namespace rpc {
 
+// Classes of thread pool tasks, from the highest priority to the lowest. Idle workers pick queued
+// tasks of different classes in weighted round robin, giving higher classes larger shares, and
+// tasks of the lowest class are rejected first when the queue fills up.
+YB_DEFINE_ENUM(RpcPriorityClass, (kConsensus)(kPointRead)(kWrite)(kBulk));
+
 class ThreadPoolTask {
  public:
   // Invoked in thread pool
@@ -35,6 +42,10 @@ class ThreadPoolTask {
 
   // When thread pool done with task, i.e. it completed or failed, it invokes Done
   virtual void Done(const Status& status) = 0;
+
+  virtual RpcPriorityClass priority_class() const {
+    return RpcPriorityClass::kWrite;
+  }
  protected:
   ~ThreadPoolTask() {}
 };
@@ -24,6 +24,7 @@
 #include "yb/rpc/reactor.h"
 #include "yb/rpc/rpc_introspection.pb.h"
 #include "yb/rpc/serialization.h"
+#include "yb/rpc/tcp_stream.h"
 
 #include "yb/util/flag_tags.h"
 #include "yb/util/size_literals.h"
@@ -52,9 +53,13 @@ namespace rpc {
 
 namespace {
 
-// One byte after YugaByte is reserved for future use. It could control type of connection.
+// One byte after YugaByte controls type of connection. Messages of connections that start with
+// kCompressedConnectionHeaderBytes are compressed in both directions, see compression.h.
 const char kConnectionHeaderBytes[] = "YB\1";
+const char kCompressedConnectionHeaderBytes[] = "YB\2";
 const size_t kConnectionHeaderSize = sizeof(kConnectionHeaderBytes) - 1;
+static_assert(sizeof(kCompressedConnectionHeaderBytes) - 1 == kConnectionHeaderSize,
+              "Connection headers should have the same size");
 
 OutboundDataPtr ConnectionHeaderInstance() {
   static OutboundDataPtr result(
@@ -62,6 +67,12 @@ OutboundDataPtr ConnectionHeaderInstance() {
   return result;
 }
 
+OutboundDataPtr CompressedConnectionHeaderInstance() {
+  static OutboundDataPtr result(new StringOutboundData(
+      kCompressedConnectionHeaderBytes, kConnectionHeaderSize, "CompressedConnectionHeader"));
+  return result;
+}
+
 } // namespace
 
 using google::protobuf::FieldDescriptor;
@@ -70,15 +81,36 @@ using google::protobuf::MessageLite;
 using google::protobuf::io::CodedOutputStream;
 
 YBConnectionContext::YBConnectionContext(
-    size_t receive_buffer_size, const MemTrackerPtr& buffer_tracker,
+    GrowableBufferAllocator* read_buffer_allocator, const MemTrackerPtr& buffer_tracker,
     const MemTrackerPtr& call_tracker)
     : parser_(buffer_tracker, kMsgLengthPrefixLength, 0 /* size_offset */,
               FLAGS_rpc_max_message_size, IncludeHeader::kFalse, this),
-      read_buffer_(receive_buffer_size, buffer_tracker),
+      read_buffer_(read_buffer_allocator),
       call_tracker_(call_tracker) {}
 
 YBConnectionContext::~YBConnectionContext() {}
 
+Status YBConnectionContext::DecompressIfNeeded(CallData* call_data) {
+  if (!compressed_) {
+    return Status::OK();
+  }
+  return DecompressCallData(call_data, &compression_stats_);
+}
+
+OutboundDataPtr YBConnectionContext::WrapOutboundData(OutboundDataPtr data) {
+  if (!compressed_) {
+    return data;
+  }
+  return std::make_shared<CompressedOutboundData>(std::move(data), &compression_stats_);
+}
+
+void YBConnectionContext::DumpPB(const DumpRunningRpcsRequestPB& req, RpcConnectionPB* resp) {
+  ConnectionContextWithCallId::DumpPB(req, resp);
+  if (compressed_) {
+    compression_stats_.ToPB(resp->mutable_compression());
+  }
+}
+
 Result<ProcessDataResult> YBInboundConnectionContext::ProcessCalls(
     const ConnectionPtr& connection, const IoVecs& data, ReadBufferFull read_buffer_full) {
   if (state_ == RpcConnectionPB::NEGOTIATING) {
@@ -88,7 +120,9 @@ Result<ProcessDataResult> YBInboundConnectionContext::ProcessCalls(
     }
 
     Slice slice(static_cast<const char*>(data[0].iov_base), data[0].iov_len);
-    if (!slice.starts_with(kConnectionHeaderBytes, kConnectionHeaderSize)) {
+    if (slice.starts_with(kCompressedConnectionHeaderBytes, kConnectionHeaderSize)) {
+      EnableCompression();
+    } else if (!slice.starts_with(kConnectionHeaderBytes, kConnectionHeaderSize)) {
       return STATUS_FORMAT(NetworkError,
                            "Invalid connection header: $0",
                            slice.ToDebugHexString());
@@ -110,6 +144,8 @@ Status YBInboundConnectionContext::HandleCall(
   auto reactor = connection->reactor();
   DCHECK(reactor->IsCurrentThread());
 
+  RETURN_NOT_OK(DecompressIfNeeded(call_data));
+
   auto call = InboundCall::Create<YBInboundCall>(connection, call_processed_listener());
 
   Status s = call->ParseFrom(call_tracker(), call_data);
@@ -173,6 +209,10 @@ Status YBInboundCall::ParseFrom(const MemTrackerPtr& mem_tracker, CallData* call
         header_.remote_method().InitializationErrorString());
   }
   remote_method_.FromPB(header_.remote_method());
+  if (header_.sampled_trace()) {
+    trace_->set_sampled();
+  }
+  RecordStage(InboundCallStage::kParsed);
 
   return Status::OK();
 }
@@ -282,7 +322,7 @@ void YBInboundCall::LogTrace() const {
       // TODO: consider pushing this onto another thread since it may be slow.
       // The traces may also be too large to fit in a log message.
       LOG(WARNING) << ToString() << " took " << total_time << "ms (client timeout "
-                   << header_.timeout_millis() << "ms).";
+                   << header_.timeout_millis() << "ms). Stages: " << StagesToString();
       std::string s = trace_->DumpToString(true);
       if (!s.empty()) {
         LOG(WARNING) << "Trace:\n" << s;
@@ -294,7 +334,8 @@ void YBInboundCall::LogTrace() const {
   if (PREDICT_FALSE(
           FLAGS_rpc_dump_all_traces ||
           total_time > FLAGS_rpc_slow_query_threshold_ms)) {
-    LOG(INFO) << ToString() << " took " << total_time << "ms. Trace:";
+    LOG(INFO) << ToString() << " took " << total_time << "ms. Stages: " << StagesToString()
+              << ". Trace:";
     trace_->Dump(&LOG(INFO), true);
   }
 }
@@ -349,6 +390,19 @@ void YBInboundCall::RespondFailure(ErrorStatusPB::RpcErrorCodePB error_code,
   Respond(err, false);
 }
 
+void YBInboundCall::RespondFailureWithRetryAfter(ErrorStatusPB::RpcErrorCodePB error_code,
+                                                 const Status& status, MonoDelta retry_after) {
+  TRACE_EVENT0("rpc", "InboundCall::RespondFailure");
+  ErrorStatusPB err;
+  err.set_message(status.ToString());
+  err.set_code(error_code);
+  if (retry_after.Initialized() && retry_after.ToMilliseconds() > 0) {
+    err.set_retry_after_ms(retry_after.ToMilliseconds());
+  }
+
+  Respond(err, false);
+}
+
 void YBInboundCall::RespondApplicationError(int error_ext_id, const std::string& message,
                                             const MessageLite& app_error_pb) {
   ErrorStatusPB err;
@@ -385,6 +439,7 @@ void YBInboundCall::Respond(const MessageLite& response, bool is_success) {
 
 Status YBOutboundConnectionContext::HandleCall(
     const ConnectionPtr& connection, CallData* call_data) {
+  RETURN_NOT_OK(DecompressIfNeeded(call_data));
   return connection->HandleCallResponse(call_data);
 }
 
@@ -393,6 +448,12 @@ void YBOutboundConnectionContext::Connected(const ConnectionPtr& connection) {
 }
 
 void YBOutboundConnectionContext::AssignConnection(const ConnectionPtr& connection) {
+  if (connection->protocol() == TcpStream::CompressedProtocol()) {
+    // The header is queued synchronously, since we are in reactor thread, so it is not compressed.
+    connection->QueueOutboundData(CompressedConnectionHeaderInstance());
+    EnableCompression();
+    return;
+  }
   connection->QueueOutboundData(ConnectionHeaderInstance());
 }
 
@@ -18,6 +18,7 @@
 
 #include "yb/rpc/binary_call_parser.h"
 #include "yb/rpc/circular_read_buffer.h"
+#include "yb/rpc/compression.h"
 #include "yb/rpc/connection_context.h"
 #include "yb/rpc/rpc_with_call_id.h"
 
@@ -27,7 +28,7 @@ namespace rpc {
 class YBConnectionContext : public ConnectionContextWithCallId, public BinaryCallParserListener {
  public:
   YBConnectionContext(
-      size_t receive_buffer_size, const MemTrackerPtr& buffer_tracker,
+      GrowableBufferAllocator* read_buffer_allocator, const MemTrackerPtr& buffer_tracker,
       const MemTrackerPtr& call_tracker);
   ~YBConnectionContext();
 
@@ -36,9 +37,20 @@ class YBConnectionContext : public ConnectionContextWithCallId, public BinaryCal
  protected:
   BinaryCallParser& parser() { return parser_; }
 
+  // Starts compressing messages of this connection. Should be invoked in reactor thread after the
+  // connection header was sent or received.
+  void EnableCompression() { compressed_ = true; }
+
+  // Restores the original message of call_data, if messages of this connection are compressed.
+  CHECKED_STATUS DecompressIfNeeded(CallData* call_data);
+
  private:
   uint64_t ExtractCallId(InboundCall* call) override;
 
+  OutboundDataPtr WrapOutboundData(OutboundDataPtr data) override;
+
+  void DumpPB(const DumpRunningRpcsRequestPB& req, RpcConnectionPB* resp) override;
+
   StreamReadBuffer& ReadBuffer() override {
     return read_buffer_;
   }
@@ -48,14 +60,17 @@ class YBConnectionContext : public ConnectionContextWithCallId, public BinaryCal
   CircularReadBuffer read_buffer_;
 
   const MemTrackerPtr call_tracker_;
+
+  bool compressed_ = false;
+  RpcCompressionStats compression_stats_;
 };
 
 class YBInboundConnectionContext : public YBConnectionContext {
  public:
   YBInboundConnectionContext(
-      size_t receive_buffer_size, const MemTrackerPtr& buffer_tracker,
+      GrowableBufferAllocator* read_buffer_allocator, const MemTrackerPtr& buffer_tracker,
       const MemTrackerPtr& call_tracker)
-      : YBConnectionContext(receive_buffer_size, buffer_tracker, call_tracker) {}
+      : YBConnectionContext(read_buffer_allocator, buffer_tracker, call_tracker) {}
 
   static std::string Name() { return "Inbound RPC"; }
  private:
@@ -128,6 +143,9 @@ class YBInboundCall : public InboundCall {
   void RespondFailure(ErrorStatusPB::RpcErrorCodePB error_code,
                       const Status &status) override;
 
+  void RespondFailureWithRetryAfter(ErrorStatusPB::RpcErrorCodePB error_code,
+                                    const Status& status, MonoDelta retry_after) override;
+
   void RespondApplicationError(int error_ext_id, const std::string& message,
                                const google::protobuf::MessageLite& app_error_pb);
 
@@ -190,9 +208,9 @@ class YBInboundCall : public InboundCall {
 class YBOutboundConnectionContext : public YBConnectionContext {
  public:
   YBOutboundConnectionContext(
-      size_t receive_buffer_size, const MemTrackerPtr& buffer_tracker,
+      GrowableBufferAllocator* read_buffer_allocator, const MemTrackerPtr& buffer_tracker,
       const MemTrackerPtr& call_tracker)
-      : YBConnectionContext(receive_buffer_size, buffer_tracker, call_tracker) {}
+      : YBConnectionContext(read_buffer_allocator, buffer_tracker, call_tracker) {}
 
   static std::string Name() { return "Outbound RPC"; }
 
@@ -70,6 +70,8 @@
 #include "yb/util/mem_tracker.h"
 #include "yb/util/metrics.h"
 #include "yb/util/jsonwriter.h"
+#include "yb/util/kernel_stack_watchdog.h"
+#include "yb/util/url-coding.h"
 
 DEFINE_int64(web_log_bytes, 1024 * 1024,
     "The maximum number of bytes to display on the debug webserver's log page");
@@ -154,6 +156,17 @@ static void StatusHandler(const Webserver::WebRequest& req, std::stringstream* o
   (*output) << "{}";
 }
 
+// Registered to handle "/stack-samples", prints the stacks sampled in slow operations in the input
+// format of flamegraph.pl. The "label" argument selects the labels starting with it, for instance
+// the methods of a service, and "reset" clears the samples after printing them.
+static void StackSamplesHandler(const Webserver::WebRequest& req, std::stringstream* output) {
+  auto* watchdog = KernelStackWatchdog::GetInstance();
+  (*output) << watchdog->SampledStacks(FindWithDefault(req.parsed_args, "label", ""));
+  if (req.parsed_args.find("reset") != req.parsed_args.end()) {
+    watchdog->ResetSampledStacks();
+  }
+}
+
 // Registered to handle "/memz", and prints out memory allocation statistics.
 static void MemUsageHandler(const Webserver::WebRequest& req, std::stringstream* output) {
   bool as_text = (req.parsed_args.find("raw") != req.parsed_args.end());
@@ -235,6 +248,16 @@ static void MemTrackersHandler(const Webserver::WebRequest& req, std::stringstre
   *output << "</table>\n";
 }
 
+// Entity types requested with ?entity_types=server,tablet, all types if not specified.
+static vector<string> RequestedEntityTypes(const Webserver::WebRequest& req) {
+  vector<string> result;
+  const string* param = FindOrNull(req.parsed_args, "entity_types");
+  if (param != nullptr) {
+    SplitStringUsing(*param, ",", &result);
+  }
+  return result;
+}
+
 static void WriteMetricsAsJson(const MetricRegistry* const metrics,
                                const Webserver::WebRequest& req, std::stringstream* output) {
   const string* requested_metrics_param = FindOrNull(req.parsed_args, "metrics");
@@ -249,6 +272,7 @@ static void WriteMetricsAsJson(const MetricRegistry* const metrics,
     string arg = FindWithDefault(req.parsed_args, "include_schema", "false");
     opts.include_schema_info = ParseLeadingBoolValue(arg.c_str(), false);
   }
+  opts.entity_types = RequestedEntityTypes(req);
   JsonWriter::Mode json_mode;
   {
     string arg = FindWithDefault(req.parsed_args, "compact", "false");
@@ -271,8 +295,21 @@ static void WriteMetricsAsJson(const MetricRegistry* const metrics,
 
 static void WriteForPrometheus(const MetricRegistry* const metrics,
                                const Webserver::WebRequest& req, std::stringstream* output) {
-  PrometheusWriter writer(output);
-  WARN_NOT_OK(metrics->WriteForPrometheus(&writer), "Couldn't write text metrics for Prometheus");
+  // Tablet metrics are summed up per table unless another level is requested with
+  // ?level=server|table|tablet.
+  AggregationMetricLevel level = AggregationMetricLevel::kTable;
+  string arg = FindWithDefault(req.parsed_args, "level", "table");
+  if (arg == "server") {
+    level = AggregationMetricLevel::kServer;
+  } else if (arg == "tablet") {
+    level = AggregationMetricLevel::kTablet;
+  } else if (arg != "table") {
+    (*output) << "Unknown aggregation level: " << EscapeForHtmlToString(arg);
+    return;
+  }
+  PrometheusWriter writer(output, level);
+  WARN_NOT_OK(metrics->WriteForPrometheus(&writer, RequestedEntityTypes(req)),
+              "Couldn't write text metrics for Prometheus");
 }
 
 } // anonymous namespace
@@ -284,6 +321,7 @@ void AddDefaultPathHandlers(Webserver* webserver) {
   webserver->RegisterPathHandler("/memz", "Memory (total)", MemUsageHandler, true, false);
   webserver->RegisterPathHandler("/mem-trackers", "Memory (detail)",
                                  MemTrackersHandler, true, false);
+  webserver->RegisterPathHandler("/stack-samples", "", StackSamplesHandler, false, false);
 
   AddPprofPathHandlers(webserver);
 }
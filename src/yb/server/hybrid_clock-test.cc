@@ -31,11 +31,14 @@
 //
 
 #include <algorithm>
+#include <thread>
 #include <glog/logging.h>
 #include <gtest/gtest.h>
 
+#include "yb/gutil/walltime.h"
 #include "yb/server/hybrid_clock.h"
 #include "yb/server/mock_hybrid_clock.h"
+#include "yb/server/tsc_clock.h"
 #include "yb/util/monotime.h"
 #include "yb/util/random.h"
 #include "yb/util/random_util.h"
@@ -43,6 +46,7 @@
 
 DECLARE_uint64(max_clock_sync_error_usec);
 DECLARE_bool(disable_clock_sync_error);
+DECLARE_int32(tsc_clock_calibration_interval_ms);
 
 namespace yb {
 namespace server {
@@ -171,6 +175,88 @@ void HybridClockTest::RunMultiThreadedTest(int num_reads_per_update) {
   }
 }
 
+namespace {
+
+// Wall clock that reports no error, so that the error of TscClock is only what it adds.
+class ExactWallClock : public PhysicalClock {
+ public:
+  Result<PhysicalTime> Now() override {
+    return PhysicalTime{ static_cast<MicrosTime>(GetCurrentTimeMicros()), 0 };
+  }
+
+  MicrosTime MaxGlobalTime(PhysicalTime time) override {
+    return time.time_point;
+  }
+};
+
+// Returns the number of Now() calls per second made by num_threads threads.
+double MeasureNowThroughput(HybridClock* clock, int num_threads, MonoDelta duration) {
+  std::atomic<bool> stop{false};
+  std::atomic<uint64_t> total_calls{0};
+  std::vector<std::thread> threads;
+  for (int i = 0; i != num_threads; ++i) {
+    threads.emplace_back([clock, &stop, &total_calls] {
+      uint64_t calls = 0;
+      HybridTime prev = HybridTime::kMin;
+      while (!stop.load(std::memory_order_acquire)) {
+        for (int j = 0; j != 1000; ++j) {
+          auto now = clock->Now();
+          ASSERT_GT(now, prev);
+          prev = now;
+        }
+        calls += 1000;
+      }
+      total_calls += calls;
+    });
+  }
+  SleepFor(duration);
+  stop = true;
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  return total_calls.load() / duration.ToSeconds();
+}
+
+} // namespace
+
+TEST(TscClockTest, ErrorBounds) {
+  if (!TscClock::IsSupported()) {
+    LOG(INFO) << "Invariant TSC is not supported, skipping";
+    return;
+  }
+  FLAGS_tsc_clock_calibration_interval_ms = 50;
+  TscClock clock(std::make_shared<ExactWallClock>());
+  auto deadline = MonoTime::Now() + MonoDelta::FromSeconds(2);
+  while (MonoTime::Now() < deadline) {
+    auto before = static_cast<MicrosTime>(GetCurrentTimeMicros());
+    auto now = ASSERT_RESULT(clock.Now());
+    auto after = static_cast<MicrosTime>(GetCurrentTimeMicros());
+    // The true time of the read is within [before, after], so the returned interval should
+    // intersect it.
+    ASSERT_LE(now.time_point, after + now.max_error);
+    ASSERT_GE(now.time_point + now.max_error, before);
+  }
+}
+
+// Compares multi-threaded throughput of Now() with and without the timestamp counter.
+TEST(TscClockTest, NowThroughput) {
+  const int kNumThreads = std::max(4u, std::thread::hardware_concurrency());
+  const auto kDuration = MonoDelta::FromSeconds(2);
+
+  scoped_refptr<HybridClock> wall_clock(new HybridClock(WallClock()));
+  ASSERT_OK(wall_clock->Init());
+  LOG(INFO) << "Wall clock: " << MeasureNowThroughput(wall_clock.get(), kNumThreads, kDuration)
+            << " calls/s with " << kNumThreads << " threads";
+
+  if (!TscClock::IsSupported()) {
+    return;
+  }
+  scoped_refptr<HybridClock> tsc_clock(new HybridClock(TscClock::Wrap(WallClock())));
+  ASSERT_OK(tsc_clock->Init());
+  LOG(INFO) << "TSC clock: " << MeasureNowThroughput(tsc_clock.get(), kNumThreads, kDuration)
+            << " calls/s with " << kNumThreads << " threads";
+}
+
 TEST_F(HybridClockTest, CompareHybridClocksToDelta) {
   EXPECT_EQ(1, HybridClock::CompareHybridClocksToDelta(
       HybridClock::HybridTimeFromMicrosecondsAndLogicalValue(1000, 10),
@@ -39,6 +39,7 @@
 #include "yb/gutil/bind.h"
 #include "yb/gutil/strings/substitute.h"
 #include "yb/gutil/walltime.h"
+#include "yb/server/tsc_clock.h"
 #include "yb/util/debug/trace_event.h"
 #include "yb/util/errno.h"
 #include "yb/util/flag_tags.h"
@@ -67,6 +68,12 @@ DEFINE_string(time_source, "",
               "specific for appropriate tests, that adds them.");
 TAG_FLAG(time_source, hidden);
 
+DEFINE_bool(use_tsc_clock, false,
+            "Read the physical time through the CPU timestamp counter, calibrated periodically "
+            "against --time_source, instead of reading the time source for every hybrid time. "
+            "Ignored when the CPU does not have an invariant timestamp counter.");
+TAG_FLAG(use_tsc_clock, advanced);
+
 using yb::Status;
 using strings::Substitute;
 
@@ -102,7 +109,9 @@ HybridClock::HybridClock() : HybridClock(FLAGS_time_source) {}
 
 HybridClock::HybridClock(PhysicalClockPtr clock) : clock_(std::move(clock)) {}
 
-HybridClock::HybridClock(const std::string& time_source) : HybridClock(GetClock(time_source)) {}
+HybridClock::HybridClock(const std::string& time_source)
+    : HybridClock(FLAGS_use_tsc_clock ? TscClock::Wrap(GetClock(time_source))
+                                      : GetClock(time_source)) {}
 
 Status HybridClock::Init() {
 #if defined(__APPLE__)
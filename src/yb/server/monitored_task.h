@@ -73,6 +73,7 @@ class MonitoredTask : public std::enable_shared_from_this<MonitoredTask> {
     ASYNC_SNAPSHOT_OP,
     ASYNC_COPARTITION_TABLE,
     ASYNC_FLUSH_TABLETS,
+    ASYNC_BACKFILL_TABLET_INDEX,
   };
 
   virtual Type type() const = 0;
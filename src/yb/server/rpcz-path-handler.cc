@@ -62,6 +62,8 @@ void RpczPathHandler(const shared_ptr<Messenger>& messenger,
 
   string arg = FindWithDefault(req.parsed_args, "include_traces", "false");
   dump_req.set_include_traces(ParseLeadingBoolValue(arg.c_str(), false));
+  arg = FindWithDefault(req.parsed_args, "include_call_stages", "true");
+  dump_req.set_include_call_stages(ParseLeadingBoolValue(arg.c_str(), true));
 
   WARN_NOT_OK(messenger->DumpRunningRpcs(dump_req, &dump_resp),
              "DumpRunningRpcs failed");
@@ -45,6 +45,8 @@
 
 #include "yb/gutil/strings/escaping.h"
 #include "yb/util/jsonwriter.h"
+#include "yb/util/trace.h"
+#include "yb/util/url-coding.h"
 #include "yb/util/debug/trace_event_impl.h"
 
 namespace yb {
@@ -255,6 +257,22 @@ void HandleRequest(Handler handler,
     *output << "##ERROR##";
   }
 }
+void HandleSampledTracesPage(const Webserver::WebRequest& req, stringstream* output) {
+  const auto traces = RecentSampledTraces();
+  const auto now = MonoTime::Now();
+  *output << "<h1>Sampled Traces</h1>\n";
+  *output << "<p>One in " << FLAGS_trace_sampling_one_in << " requests is sampled, "
+          << traces.size() << " latest sampled traces are shown.</p>\n";
+  *output << "<table class='table table-striped'>\n";
+  *output << "<tr><th>Completed</th><th>Request</th><th>Trace</th></tr>\n";
+  for (const auto& trace : traces) {
+    *output << "<tr><td>" << now.GetDeltaSince(trace->time).ToSeconds() << "s ago</td><td>"
+            << EscapeForHtmlToString(trace->description) << "</td><td><pre>"
+            << EscapeForHtmlToString(trace->trace) << "</pre></td></tr>\n";
+  }
+  *output << "</table>\n";
+}
+
 } // anonymous namespace
 
 
@@ -277,6 +295,10 @@ void TracingPathHandlers::RegisterHandlers(Webserver* server) {
         e.first, "", std::bind(&HandleRequest, e.second, _1, _2), false /* styled */,
         false /* is_on_nav_bar */);
   }
+
+  server->RegisterPathHandler(
+      "/tracing/sampled", "Sampled Traces", HandleSampledTracesPage, true /* styled */,
+      false /* is_on_nav_bar */);
 }
 
 } // namespace server
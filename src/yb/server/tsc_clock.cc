@@ -0,0 +1,180 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/server/tsc_clock.h"
+
+#if defined(__x86_64__)
+#include <cpuid.h>
+#endif
+
+#include <cmath>
+
+#include "yb/gutil/sysinfo.h"
+#include "yb/gutil/walltime.h"
+
+#include "yb/server/hybrid_clock.h"
+
+#include "yb/util/flag_tags.h"
+
+DEFINE_int32(tsc_clock_calibration_interval_ms, 1000,
+             "How often the timestamp counter based physical clock is recalibrated against the "
+             "underlying time source.");
+TAG_FLAG(tsc_clock_calibration_interval_ms, advanced);
+TAG_FLAG(tsc_clock_calibration_interval_ms, runtime);
+
+DEFINE_int32(tsc_clock_max_drift_ppm, 1000,
+             "Maximum drift of the timestamp counter relative to the underlying time source, in "
+             "parts per million, added to the clock error for the time since the last "
+             "calibration.");
+TAG_FLAG(tsc_clock_max_drift_ppm, advanced);
+
+namespace yb {
+namespace server {
+
+namespace {
+
+// The rate of the counter is measured only over spans at least this long, so that the jitter of
+// the underlying clock reads does not dominate it.
+constexpr double kMinRateMeasurementMicros = 100000;
+
+} // namespace
+
+const std::string TscClock::kName = "tsc";
+
+TscClock::TscClock(PhysicalClockPtr impl)
+    : impl_(std::move(impl)), nominal_micros_per_cycle_(1e6 / base::CyclesPerSecond()) {}
+
+bool TscClock::IsSupported() {
+#if defined(__x86_64__)
+  unsigned int eax, ebx, ecx, edx;
+  // Invariant TSC is reported by bit 8 of EDX of the advanced power management leaf.
+  return __get_cpuid(0x80000007, &eax, &ebx, &ecx, &edx) && (edx & (1U << 8)) != 0;
+#else
+  return false;
+#endif
+}
+
+PhysicalClockPtr TscClock::Wrap(PhysicalClockPtr impl) {
+  if (!IsSupported()) {
+    LOG(WARNING) << "Invariant TSC is not supported, using the time source directly";
+    return impl;
+  }
+  return std::make_shared<TscClock>(std::move(impl));
+}
+
+void TscClock::Register() {
+  HybridClock::RegisterProvider(kName, [] {
+    return std::make_shared<TscClock>(WallClock());
+  });
+}
+
+TscClock::Calibration TscClock::LoadCalibration() const {
+  for (;;) {
+    auto version = calibration_version_.load(std::memory_order_acquire);
+    Calibration result = {
+      calibration_cycles_.load(std::memory_order_relaxed),
+      calibration_time_point_.load(std::memory_order_relaxed),
+      calibration_max_error_.load(std::memory_order_relaxed),
+      micros_per_cycle_.load(std::memory_order_relaxed),
+    };
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if ((version & 1) == 0 &&
+        calibration_version_.load(std::memory_order_relaxed) == version) {
+      return result;
+    }
+  }
+}
+
+void TscClock::StoreCalibration(const Calibration& calibration) {
+  auto version = calibration_version_.load(std::memory_order_relaxed);
+  calibration_version_.store(version + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  calibration_cycles_.store(calibration.cycles, std::memory_order_relaxed);
+  calibration_time_point_.store(calibration.time_point, std::memory_order_relaxed);
+  calibration_max_error_.store(calibration.max_error, std::memory_order_relaxed);
+  micros_per_cycle_.store(calibration.micros_per_cycle, std::memory_order_relaxed);
+  calibration_version_.store(version + 2, std::memory_order_release);
+}
+
+Result<PhysicalTime> TscClock::Now() {
+  const int64_t cycles = CycleClock::Now();
+  auto calibration = LoadCalibration();
+  if (calibration.cycles == 0) {
+    return Calibrate(calibration);
+  }
+  const int64_t elapsed_cycles = cycles - calibration.cycles;
+  if (elapsed_cycles < 0) {
+    // The calibration was stored after the counter was read.
+    return impl_->Now();
+  }
+  if (calibration.micros_per_cycle == 0) {
+    // The nominal frequency is not precise enough to extrapolate with it, so the underlying clock
+    // is used until the rate of the counter is measured.
+    if (elapsed_cycles * nominal_micros_per_cycle_ >= kMinRateMeasurementMicros) {
+      return Calibrate(calibration);
+    }
+    return impl_->Now();
+  }
+  const double elapsed_micros = elapsed_cycles * calibration.micros_per_cycle;
+  if (elapsed_micros >= GetAtomicFlag(&FLAGS_tsc_clock_calibration_interval_ms) * 1000.0) {
+    return Calibrate(calibration);
+  }
+  auto drift = elapsed_micros * GetAtomicFlag(&FLAGS_tsc_clock_max_drift_ppm) / 1e6;
+  // Add one to the error for rounding down of the extrapolated time.
+  return PhysicalTime {
+    calibration.time_point + static_cast<MicrosTime>(elapsed_micros),
+    calibration.max_error + static_cast<MicrosTime>(std::ceil(drift)) + 1
+  };
+}
+
+Result<PhysicalTime> TscClock::Calibrate(const Calibration& previous) {
+  std::unique_lock<std::mutex> lock(calibration_mutex_, std::try_to_lock);
+  if (!lock.owns_lock()) {
+    return impl_->Now();
+  }
+
+  // The underlying clock was read at some point between before and after.
+  const int64_t before = CycleClock::Now();
+  auto now = VERIFY_RESULT(impl_->Now());
+  const int64_t after = CycleClock::Now();
+
+  double micros_per_cycle = previous.micros_per_cycle;
+  const int64_t cycles = before + (after - before) / 2;
+  const int64_t elapsed_cycles = cycles - previous.cycles;
+  if (previous.cycles != 0 && elapsed_cycles > 0 && now.time_point > previous.time_point &&
+      elapsed_cycles * nominal_micros_per_cycle_ >= kMinRateMeasurementMicros) {
+    // Follow the rate of the underlying clock, e.g. when it is slewed by NTP. A step of the
+    // underlying clock should not change the rate by more than the drift we account for.
+    auto measured = static_cast<double>(now.time_point - previous.time_point) / elapsed_cycles;
+    if (micros_per_cycle == 0) {
+      micros_per_cycle = measured;
+    } else {
+      auto max_change = micros_per_cycle * GetAtomicFlag(&FLAGS_tsc_clock_max_drift_ppm) / 1e6;
+      micros_per_cycle = std::max(micros_per_cycle - max_change,
+                                  std::min(micros_per_cycle + max_change, measured));
+    }
+  }
+
+  // The counter value we associate with the time is off by at most half of the read duration.
+  const double rate = micros_per_cycle != 0 ? micros_per_cycle : nominal_micros_per_cycle_;
+  now.max_error += static_cast<MicrosTime>(std::ceil((after - before) / 2 * rate));
+  StoreCalibration({cycles, now.time_point, now.max_error, micros_per_cycle});
+  return now;
+}
+
+MicrosTime TscClock::MaxGlobalTime(PhysicalTime time) {
+  return impl_->MaxGlobalTime(time);
+}
+
+} // namespace server
+} // namespace yb
@@ -0,0 +1,87 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#ifndef YB_SERVER_TSC_CLOCK_H
+#define YB_SERVER_TSC_CLOCK_H
+
+#include <atomic>
+#include <mutex>
+
+#include "yb/util/physical_time.h"
+
+namespace yb {
+namespace server {
+
+// Physical clock that extrapolates the time of another clock using the CPU timestamp counter, so
+// that most reads of the time don't need a system call. The offset and the rate of the counter
+// are recalibrated against the underlying clock every FLAGS_tsc_clock_calibration_interval_ms.
+// The error of a returned time is the error of the last calibration plus the maximum drift of
+// the counter since then, so the returned interval still contains the true time.
+//
+// Requires an invariant TSC, i.e. one that ticks at a constant rate in all power states and is
+// synchronized between cores. Times returned to concurrent readers around a recalibration could
+// differ slightly, HybridClock keeps hybrid times monotonic regardless.
+class TscClock : public PhysicalClock {
+ public:
+  static const std::string kName;
+
+  explicit TscClock(PhysicalClockPtr impl);
+
+  // Whether the timestamp counter of this CPU can be used as a time source.
+  static bool IsSupported();
+
+  // Returns a TscClock on top of impl when the timestamp counter is supported, impl otherwise.
+  static PhysicalClockPtr Wrap(PhysicalClockPtr impl);
+
+  static void Register();
+
+  Result<PhysicalTime> Now() override;
+  MicrosTime MaxGlobalTime(PhysicalTime time) override;
+
+ private:
+  struct Calibration {
+    // Counter value at which the underlying clock was read, 0 before the first calibration.
+    int64_t cycles;
+    MicrosTime time_point;
+    MicrosTime max_error;
+    // Measured rate of the counter, 0 until it is measured.
+    double micros_per_cycle;
+  };
+
+  Calibration LoadCalibration() const;
+  void StoreCalibration(const Calibration& calibration);
+
+  // Reads the underlying clock and remembers the counter value it corresponds to.
+  Result<PhysicalTime> Calibrate(const Calibration& previous);
+
+  PhysicalClockPtr impl_;
+
+  // Rate of the counter according to the CPU frequency reported by the system, only used to
+  // estimate when its actual rate could be measured.
+  const double nominal_micros_per_cycle_;
+
+  // Serializes calibrations, readers that don't get it use the underlying clock meanwhile.
+  std::mutex calibration_mutex_;
+
+  // Sequence lock for the calibration fields below, odd while they are being stored.
+  std::atomic<uint64_t> calibration_version_{0};
+  std::atomic<int64_t> calibration_cycles_{0};
+  std::atomic<MicrosTime> calibration_time_point_{0};
+  std::atomic<MicrosTime> calibration_max_error_{0};
+  std::atomic<double> micros_per_cycle_{0.0};
+};
+
+} // namespace server
+} // namespace yb
+
+#endif // YB_SERVER_TSC_CLOCK_H
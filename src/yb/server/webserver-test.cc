@@ -47,6 +47,7 @@
 using std::string;
 
 DECLARE_int32(webserver_max_post_length_bytes);
+DECLARE_int32(webserver_response_chunk_size_bytes);
 
 namespace yb {
 
@@ -159,6 +160,28 @@ TEST_F(WebserverTest, TestPostTooBig) {
   ASSERT_EQ("Remote error: HTTP 413", s.ToString(/* no file/line */ false));
 }
 
+// Responses larger than a chunk are streamed with chunked transfer encoding, smaller ones are
+// sent with their length, the client gets the same body either way.
+TEST_F(WebserverTest, TestChunkedResponse) {
+  FLAGS_webserver_response_chunk_size_bytes = 1000;
+  server_->RegisterPathHandler(
+      "/big", "", [](const Webserver::WebRequest& req, std::stringstream* output) {
+        for (int i = 0; i != 10000; ++i) {
+          *output << i << "\n";
+        }
+      }, false /* is_styled */, false /* is_on_nav_bar */);
+  ASSERT_OK(curl_.FetchURL(strings::Substitute("http://$0/big", ToString(addr_)), &buf_));
+  std::string expected;
+  for (int i = 0; i != 10000; ++i) {
+    expected += std::to_string(i) + "\n";
+  }
+  ASSERT_EQ(expected, buf_.ToString());
+
+  FLAGS_webserver_response_chunk_size_bytes = 0;
+  ASSERT_OK(curl_.FetchURL(strings::Substitute("http://$0/big", ToString(addr_)), &buf_));
+  ASSERT_EQ(expected, buf_.ToString());
+}
+
 // Test that static files are served and that directory listings are
 // disabled.
 TEST_F(WebserverTest, TestStaticFiles) {
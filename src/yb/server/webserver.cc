@@ -50,6 +50,7 @@
 #include <functional>
 #include <map>
 #include <mutex>
+#include <streambuf>
 #include <string>
 #include <vector>
 
@@ -84,6 +85,13 @@ DEFINE_int32(webserver_max_post_length_bytes, 1024 * 1024,
 TAG_FLAG(webserver_max_post_length_bytes, advanced);
 TAG_FLAG(webserver_max_post_length_bytes, runtime);
 
+DEFINE_int32(webserver_response_chunk_size_bytes, 64 * 1024,
+             "Responses of the embedded web server that are larger than this are sent with chunked "
+             "transfer encoding while they are being rendered, in chunks of this size, instead of "
+             "being rendered into memory as a whole first. 0 to disable.");
+TAG_FLAG(webserver_response_chunk_size_bytes, advanced);
+TAG_FLAG(webserver_response_chunk_size_bytes, runtime);
+
 namespace yb {
 
 using std::string;
@@ -313,6 +321,82 @@ int Webserver::BeginRequestCallback(struct sq_connection* connection,
 }
 
 
+namespace {
+
+// Stream buffer that sends everything written to it over the connection. The response is buffered
+// up to chunk_size bytes, if it turns out to be larger it is sent with chunked transfer encoding as
+// the buffer fills up, so a large page never has to reside in memory as a whole.
+class ResponseStreamBuffer : public std::streambuf {
+ public:
+  ResponseStreamBuffer(sq_connection* connection, const char* content_type, size_t chunk_size)
+      : connection_(connection), content_type_(content_type), buffer_(chunk_size) {
+    ResetBuffer();
+  }
+
+  // Sends the rest of the response.
+  void Finish() {
+    if (!chunked_) {
+      sq_printf(connection_, "HTTP/1.1 200 OK\r\n"
+                "Content-Type: %s\r\n"
+                "Content-Length: %zd\r\n"
+                "\r\n", content_type_, pending());
+      Write(pbase(), pending());
+      return;
+    }
+    SendChunk();
+    Write("0\r\n\r\n", 5);
+  }
+
+ protected:
+  int_type overflow(int_type ch) override {
+    SendChunk();
+    if (!traits_type::eq_int_type(ch, traits_type::eof())) {
+      *pptr() = traits_type::to_char_type(ch);
+      pbump(1);
+    }
+    return traits_type::not_eof(ch);
+  }
+
+ private:
+  size_t pending() const { return pptr() - pbase(); }
+
+  void ResetBuffer() {
+    setp(buffer_.data(), buffer_.data() + buffer_.size());
+  }
+
+  void SendChunk() {
+    if (!chunked_) {
+      sq_printf(connection_, "HTTP/1.1 200 OK\r\n"
+                "Content-Type: %s\r\n"
+                "Transfer-Encoding: chunked\r\n"
+                "\r\n", content_type_);
+      chunked_ = true;
+    }
+    if (pending() != 0) {
+      sq_printf(connection_, "%zx\r\n", pending());
+      Write(pbase(), pending());
+      Write("\r\n", 2);
+    }
+    ResetBuffer();
+  }
+
+  void Write(const char* data, size_t size) {
+    // Once the client went away the rest of the response is dropped, the handler still runs to
+    // completion.
+    if (!failed_ && sq_write(connection_, data, size) <= 0 && size != 0) {
+      failed_ = true;
+    }
+  }
+
+  sq_connection* const connection_;
+  const char* const content_type_;
+  std::vector<char> buffer_;
+  bool chunked_ = false;
+  bool failed_ = false;
+};
+
+} // namespace
+
 int Webserver::RunPathHandler(const PathHandler& handler,
                               struct sq_connection* connection,
                               struct sq_request_info* request_info) {
@@ -363,12 +447,27 @@ int Webserver::RunPathHandler(const PathHandler& handler,
     use_style = false;
   }
 
-  stringstream output;
-  if (use_style) BootstrapPageHeader(&output);
-  for (const PathHandlerCallback& callback_ : handler.callbacks()) {
-    callback_(req, &output);
+  auto render = [this, &handler, &req, use_style](stringstream* output) {
+    if (use_style) BootstrapPageHeader(output);
+    for (const PathHandlerCallback& callback_ : handler.callbacks()) {
+      callback_(req, output);
+    }
+    if (use_style) BootstrapPageFooter(output);
+  };
+
+  const auto chunk_size = FLAGS_webserver_response_chunk_size_bytes;
+  if (chunk_size > 0) {
+    ResponseStreamBuffer buffer(connection, use_style ? "text/html" : "text/plain", chunk_size);
+    stringstream output;
+    // Handlers write to the stringstream they are given, redirect it to the connection.
+    static_cast<std::ios&>(output).rdbuf(&buffer);
+    render(&output);
+    buffer.Finish();
+    return 1;
   }
-  if (use_style) BootstrapPageFooter(&output);
+
+  stringstream output;
+  render(&output);
 
   string str = output.str();
   // Without styling, render the page as plain text
@@ -15,6 +15,7 @@
 
 #include "yb/docdb/cql_operation.h"
 #include "yb/docdb/pgsql_operation.h"
+#include "yb/docdb/query_mem_tracker.h"
 
 #include "yb/tablet/abstract_tablet.h"
 #include "yb/util/trace.h"
@@ -31,6 +32,8 @@ Status AbstractTablet::HandleQLReadRequest(CoarseTimePoint deadline,
 
   // TODO(Robert): verify that all key column values are provided
   docdb::QLReadOperation doc_op(ql_read_request, txn_op_context);
+  doc_op.set_scan_cursors(ScanCursors());
+  doc_op.set_mem_tracker(result->mem_tracker);
 
   // Form a schema of columns that are referenced by this query.
   const Schema &schema = SchemaRef();
@@ -76,6 +79,7 @@ Status AbstractTablet::HandlePgsqlReadRequest(CoarseTimePoint deadline,
                                               PgsqlReadRequestResult* result) {
 
   docdb::PgsqlReadOperation doc_op(pgsql_read_request, txn_op_context);
+  doc_op.set_mem_tracker(result->mem_tracker);
 
   // Form a schema of columns that are referenced by this query.
   const Schema &schema = SchemaRef(pgsql_read_request.table_id());
@@ -108,6 +112,9 @@ Status AbstractTablet::HandlePgsqlReadRequest(CoarseTimePoint deadline,
   TRACE("Start Serialize");
   RETURN_NOT_OK(pggate::PgDocData::WriteTuples(resultset, &result->rows_data));
   TRACE("Done Serialize");
+  if (result->mem_tracker != nullptr) {
+    result->mem_tracker->SetCurrentResultSize(result->rows_data.capacity());
+  }
 
   return Status::OK();
 }
@@ -23,18 +23,30 @@
 #include "yb/tablet/tablet_fwd.h"
 
 namespace yb {
+
+namespace docdb {
+
+class QLScanCursors;
+class QueryMemTracker;
+
+}
+
 namespace tablet {
 
 struct QLReadRequestResult {
   QLResponsePB response;
   faststring rows_data;
   HybridTime restart_read_ht;
+  // Tracker of the read request the rows are charged to, if any. Set by the caller.
+  docdb::QueryMemTracker* mem_tracker = nullptr;
 };
 
 struct PgsqlReadRequestResult {
   PgsqlResponsePB response;
   faststring rows_data;
   HybridTime restart_read_ht;
+  // Tracker of the read request the rows are charged to, if any. Set by the caller.
+  docdb::QueryMemTracker* mem_tracker = nullptr;
 };
 
 class AbstractTablet {
@@ -70,6 +82,9 @@ class AbstractTablet {
                                                   const size_t row_count,
                                                   QLResponsePB* response) const = 0;
 
+  // Open scans of paged reads that could be continued by the next page, if any.
+  virtual docdb::QLScanCursors* ScanCursors() const { return nullptr; }
+
   virtual CHECKED_STATUS RegisterReaderTimestamp(HybridTime read_point) = 0;
   virtual void UnregisterReader(HybridTime read_point) = 0;
 
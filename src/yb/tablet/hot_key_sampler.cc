@@ -0,0 +1,100 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/tablet/hot_key_sampler.h"
+
+#include <limits>
+
+#include <gflags/gflags.h>
+
+#include "yb/util/flag_tags.h"
+
+DEFINE_int32(hot_key_sample_interval, 100,
+             "Sample one in this many operations of each thread for hot key and hot tablet "
+             "detection. 0 to disable.");
+TAG_FLAG(hot_key_sample_interval, advanced);
+TAG_FLAG(hot_key_sample_interval, runtime);
+
+DEFINE_int32(hot_key_window_sec, 60,
+             "Length of the windows hot key and hot tablet samples are aggregated over.");
+TAG_FLAG(hot_key_window_sec, advanced);
+TAG_FLAG(hot_key_window_sec, runtime);
+
+DEFINE_int32(hot_key_sketch_capacity, 64,
+             "Number of keys tracked by the hot key sketch of each tablet.");
+TAG_FLAG(hot_key_sketch_capacity, advanced);
+
+namespace yb {
+namespace tablet {
+
+HotKeySampler::HotKeySampler()
+    : window_start_(CoarseMonoClock::Now()),
+      sketch_(FLAGS_hot_key_sketch_capacity) {
+}
+
+bool HotKeySampler::ShouldSample() {
+  const auto interval = FLAGS_hot_key_sample_interval;
+  if (interval <= 0) {
+    return false;
+  }
+  static thread_local uint32_t counter = 0;
+  return ++counter % interval == 0;
+}
+
+void HotKeySampler::Record(const Slice& encoded_doc_key) {
+  auto now = CoarseMonoClock::Now();
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (now - window_start_ >= std::chrono::seconds(FLAGS_hot_key_window_sec)) {
+      RollWindowUnlocked(now);
+    }
+    sampled_ops_.fetch_add(1, std::memory_order_relaxed);
+  }
+  if (!encoded_doc_key.empty()) {
+    sketch_.Add(encoded_doc_key.ToBuffer());
+  }
+}
+
+void HotKeySampler::RollWindowUnlocked(CoarseTimePoint now) {
+  last_window_.window_start = window_start_;
+  last_window_.window_length = now - window_start_;
+  last_window_.sampled_ops = sampled_ops_.exchange(0, std::memory_order_relaxed);
+  last_window_.top_keys = sketch_.TopK(std::numeric_limits<size_t>::max());
+  has_last_window_ = true;
+  sketch_.Clear();
+  window_start_ = now;
+}
+
+HotKeySampler::Report HotKeySampler::GetReport(size_t max_keys) const {
+  Report result;
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto now = CoarseMonoClock::Now();
+  if (has_last_window_ &&
+      now - window_start_ < std::chrono::seconds(FLAGS_hot_key_window_sec)) {
+    result = last_window_;
+    if (result.top_keys.size() > max_keys) {
+      result.top_keys.resize(max_keys);
+    }
+  } else {
+    // Either there is no complete window yet, or no operation was sampled to roll the windows
+    // since the current one expired.
+    result.window_start = window_start_;
+    result.window_length = now - window_start_;
+    result.sampled_ops = sampled_ops_.load(std::memory_order_relaxed);
+    result.top_keys = sketch_.TopK(max_keys);
+  }
+  return result;
+}
+
+} // namespace tablet
+} // namespace yb
@@ -0,0 +1,70 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#ifndef YB_TABLET_HOT_KEY_SAMPLER_H
+#define YB_TABLET_HOT_KEY_SAMPLER_H
+
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+#include "yb/util/monotime.h"
+#include "yb/util/slice.h"
+#include "yb/util/top_k_sketch.h"
+
+namespace yb {
+namespace tablet {
+
+// Samples the DocKeys of operations on a tablet, to find hot keys and hot tablets without
+// profiling. One in FLAGS_hot_key_sample_interval operations of each thread is sampled, and the
+// samples are aggregated over windows of FLAGS_hot_key_window_sec.
+class HotKeySampler {
+ public:
+  struct Report {
+    // Start and length of the window the report covers.
+    CoarseTimePoint window_start;
+    CoarseDuration window_length;
+    // Number of sampled operations, including the ones without a single key, e.g. scans.
+    uint64_t sampled_ops = 0;
+    // Sampled DocKeys with the largest counts, most frequent first.
+    std::vector<TopKSketch::Entry> top_keys;
+  };
+
+  HotKeySampler();
+
+  // Returns true if the current operation should be sampled. Cheap enough to be called for every
+  // operation, so that the key is only computed for sampled ones.
+  static bool ShouldSample();
+
+  // Records a sampled operation on encoded_doc_key. An empty key only counts the operation.
+  void Record(const Slice& encoded_doc_key);
+
+  // Returns the report of the last complete window, or of the current window if there is no
+  // complete window yet.
+  Report GetReport(size_t max_keys) const;
+
+ private:
+  void RollWindowUnlocked(CoarseTimePoint now);
+
+  mutable std::mutex mutex_;
+  CoarseTimePoint window_start_;
+  std::atomic<uint64_t> sampled_ops_{0};
+  TopKSketch sketch_;
+  Report last_window_;
+  bool has_last_window_ = false;
+};
+
+} // namespace tablet
+} // namespace yb
+
+#endif // YB_TABLET_HOT_KEY_SAMPLER_H
@@ -41,6 +41,7 @@
 #include "yb/tablet/tablet.pb.h"
 #include "yb/util/mem_tracker.h"
 #include "yb/util/metrics.h"
+#include "yb/util/size_literals.h"
 #include "yb/util/test_macros.h"
 #include "yb/util/test_util.h"
 #include "yb/util/thread.h"
@@ -50,6 +51,8 @@ using std::shared_ptr;
 using std::vector;
 using strings::Substitute;
 
+DECLARE_int32(maintenance_manager_disk_io_budget_mb_per_sec);
+
 METRIC_DEFINE_entity(test);
 METRIC_DEFINE_gauge_uint32(test, maintenance_ops_running,
                            "Number of Maintenance Operations Running",
@@ -101,8 +104,9 @@ class TestMaintenanceOp : public MaintenanceOp {
   TestMaintenanceOp(const std::string& name,
                     IOUsage io_usage,
                     TestMaintenanceOpState state,
-                    const shared_ptr<MemTracker>& tracker)
-    : MaintenanceOp(name, io_usage),
+                    const shared_ptr<MemTracker>& tracker,
+                    const std::string& disk = std::string())
+    : MaintenanceOp(name, io_usage, disk),
       state_change_cond_(&lock_),
       state_(state),
       consumption_(tracker, 500),
@@ -140,6 +144,7 @@ class TestMaintenanceOp : public MaintenanceOp {
     stats->set_ram_anchored(consumption_.consumption());
     stats->set_logs_retained_bytes(logs_retained_bytes_);
     stats->set_perf_improvement(perf_improvement_);
+    stats->set_io_bytes(io_bytes_);
   }
 
   void Enable() {
@@ -187,6 +192,11 @@ class TestMaintenanceOp : public MaintenanceOp {
     perf_improvement_ = perf_improvement;
   }
 
+  void set_io_bytes(int64_t io_bytes) {
+    std::lock_guard<Mutex> guard(lock_);
+    io_bytes_ = io_bytes;
+  }
+
   scoped_refptr<Histogram> DurationHistogram() const override {
     return maintenance_op_duration_;
   }
@@ -202,6 +212,7 @@ class TestMaintenanceOp : public MaintenanceOp {
   ScopedTrackedConsumption consumption_;
   uint64_t logs_retained_bytes_;
   uint64_t perf_improvement_;
+  int64_t io_bytes_ = 0;
   MetricRegistry metric_registry_;
   scoped_refptr<MetricEntity> metric_entity_;
   scoped_refptr<Histogram> maintenance_op_duration_;
@@ -279,6 +290,52 @@ TEST_F(MaintenanceManagerTest, TestLogRetentionPrioritization) {
   manager_->UnregisterOp(&op2);
 }
 
+// Test that high IO ops compete for their disks and I/O budgets, and that perf improvement is
+// weighed against the I/O cost.
+TEST_F(MaintenanceManagerTest, TestDiskScheduling) {
+  manager_->Shutdown();
+
+  TestMaintenanceOp op1("op1", MaintenanceOp::HIGH_IO_USAGE, OP_RUNNABLE, test_tracker_, "disk1");
+  op1.set_perf_improvement(10);
+  op1.set_io_bytes(1_MB);
+
+  TestMaintenanceOp op2("op2", MaintenanceOp::HIGH_IO_USAGE, OP_RUNNABLE, test_tracker_, "disk1");
+  op2.set_perf_improvement(20);
+  op2.set_io_bytes(100_MB);
+
+  TestMaintenanceOp op3("op3", MaintenanceOp::HIGH_IO_USAGE, OP_RUNNABLE, test_tracker_, "disk2");
+  op3.set_perf_improvement(1);
+
+  manager_->RegisterOp(&op1);
+  manager_->RegisterOp(&op2);
+  manager_->RegisterOp(&op3);
+
+  // op2 improves perf more, but costs much more I/O.
+  ASSERT_EQ(&op1, manager_->FindBestOp());
+
+  // While op1 is running, nothing else is started on its disk.
+  manager_->OpStartedUnlocked(&op1, manager_->ops_[&op1]);
+  ASSERT_EQ(&op3, manager_->FindBestOp());
+  manager_->OpFinishedUnlocked(&op1);
+  ASSERT_EQ(&op1, manager_->FindBestOp());
+
+  // Ops are not started on a disk that is out of its I/O budget.
+  FLAGS_maintenance_manager_disk_io_budget_mb_per_sec = 1;
+  manager_->disks_["disk1"].available_io_bytes = -10_MB;
+  ASSERT_EQ(&op3, manager_->FindBestOp());
+
+  MaintenanceManagerStatusPB status_pb;
+  manager_->GetMaintenanceManagerStatusDump(&status_pb);
+  ASSERT_EQ("op3", status_pb.best_op().name());
+  ASSERT_FALSE(status_pb.best_op_reason().empty());
+  ASSERT_EQ(1, status_pb.disks_size());
+  ASSERT_EQ("disk1", status_pb.disks(0).name());
+
+  manager_->UnregisterOp(&op1);
+  manager_->UnregisterOp(&op2);
+  manager_->UnregisterOp(&op3);
+}
+
 // Test adding operations and make sure that the history of recently completed operations
 // is correct in that it wraps around and doesn't grow.
 TEST_F(MaintenanceManagerTest, TestCompletedOpsHistory) {
@@ -34,6 +34,7 @@
 
 #include <stdint.h>
 
+#include <algorithm>
 #include <memory>
 #include <string>
 #include <utility>
@@ -47,6 +48,7 @@
 #include "yb/util/flag_tags.h"
 #include "yb/util/mem_tracker.h"
 #include "yb/util/metrics.h"
+#include "yb/util/size_literals.h"
 #include "yb/util/stopwatch.h"
 #include "yb/util/thread.h"
 
@@ -73,12 +75,31 @@ DEFINE_bool(enable_maintenance_manager, true,
        "Enable the maintenance manager, runs compaction and tablet cleaning tasks.");
 TAG_FLAG(enable_maintenance_manager, unsafe);
 
+DEFINE_int32(maintenance_manager_disk_io_budget_mb_per_sec, 0,
+       "I/O budget of high IO maintenance operations per disk. An operation is only started on "
+       "a disk that has some budget left, and its estimated I/O is charged to it. 0 for no "
+       "limit, in which case only one such operation runs per disk at a time.");
+TAG_FLAG(maintenance_manager_disk_io_budget_mb_per_sec, advanced);
+TAG_FLAG(maintenance_manager_disk_io_budget_mb_per_sec, runtime);
+
 namespace yb {
 
 using yb::tablet::MaintenanceManagerStatusPB;
 using yb::tablet::MaintenanceManagerStatusPB_CompletedOpPB;
 using yb::tablet::MaintenanceManagerStatusPB_MaintenanceOpPB;
 
+namespace {
+
+// Perf improvement of an op is divided by the number of these units of I/O it costs, plus one.
+constexpr double kIoCostUnitBytes = 1_MB;
+
+double DiskIoBudgetBytesPerSec() {
+  return std::max(FLAGS_maintenance_manager_disk_io_budget_mb_per_sec, 0) *
+         static_cast<double>(1_MB);
+}
+
+} // namespace
+
 MaintenanceOpStats::MaintenanceOpStats() {
   Clear();
 }
@@ -89,10 +110,11 @@ void MaintenanceOpStats::Clear() {
   ram_anchored_ = 0;
   logs_retained_bytes_ = 0;
   perf_improvement_ = 0;
+  io_bytes_ = 0;
 }
 
-MaintenanceOp::MaintenanceOp(std::string name, IOUsage io_usage)
-    : name_(std::move(name)), running_(0), io_usage_(io_usage) {}
+MaintenanceOp::MaintenanceOp(std::string name, IOUsage io_usage, std::string disk)
+    : name_(std::move(name)), running_(0), io_usage_(io_usage), disk_(std::move(disk)) {}
 
 MaintenanceOp::~MaintenanceOp() {
   CHECK(!manager_.get()) << "You must unregister the " << name_
@@ -204,9 +226,14 @@ void MaintenanceManager::RunSchedulerThread() {
   MonoDelta polling_interval = MonoDelta::FromMilliseconds(polling_interval_ms_);
 
   std::unique_lock<Mutex> guard(lock_);
+  bool wait = true;
   while (true) {
-    // Loop until we are shutting down or it is time to run another op.
-    cond_.TimedWait(polling_interval);
+    // Loop until we are shutting down or it is time to run another op. After an op was launched,
+    // look for another one right away, so that free threads run ops on other disks concurrently.
+    if (wait) {
+      cond_.TimedWait(polling_interval);
+    }
+    wait = true;
     if (shutdown_) {
       VLOG_AND_TRACE("maintenance", 1) << "Shutting down maintenance manager.";
       return;
@@ -220,22 +247,21 @@ void MaintenanceManager::RunSchedulerThread() {
     }
 
     // Prepare the maintenance operation.
-    op->running_++;
-    running_ops_++;
+    OpStartedUnlocked(op, ops_[op]);
     guard.unlock();
     bool ready = op->Prepare();
     guard.lock();
     if (!ready) {
       LOG(INFO) << "Prepare failed for " << op->name()
                 << ".  Re-running scheduler.";
-      op->running_--;
-      op->cond_->Signal();
+      OpFinishedUnlocked(op);
       continue;
     }
 
     // Run the maintenance operation.
     Status s = thread_pool_->SubmitFunc(std::bind(&MaintenanceManager::LaunchOp, this, op));
     CHECK(s.ok());
+    wait = false;
   }
 }
 
@@ -253,7 +279,10 @@ void MaintenanceManager::RunSchedulerThread() {
 // Reversing those can starve the low IO Ops when the system is under intense memory pressure.
 //
 // In the third priority we're at a point where nothing's urgent and there's nothing we can run
-// quickly.
+// quickly. Perf improvement is divided by the I/O cost of the op.
+//
+// High IO Ops are only considered when no other such Op is running on their disk and the disk has
+// I/O budget left, so maintenance keeps at most one stream of heavy I/O per disk.
 // TODO We currently optimize for freeing log retention but we could consider having some sort of
 // sliding priority between log retention and RAM usage. For example, is an Op that frees
 // 128MB of log retention and 12MB of RAM always better than an op that frees 12MB of log retention
@@ -261,14 +290,17 @@ void MaintenanceManager::RunSchedulerThread() {
 MaintenanceOp* MaintenanceManager::FindBestOp() {
   TRACE_EVENT0("maintenance", "MaintenanceManager::FindBestOp");
   if (!FLAGS_enable_maintenance_manager) {
+    best_op_reason_ = "Maintenance manager is disabled";
     VLOG_AND_TRACE("maintenance", 1) << "Maintenance manager is disabled. Doing nothing";
     return nullptr;
   }
   size_t free_threads = num_threads_ - running_ops_;
   if (free_threads == 0) {
+    best_op_reason_ = "No free threads";
     VLOG_AND_TRACE("maintenance", 1) << "there are no free threads, so we can't run anything.";
     return nullptr;
   }
+  RefillDiskBudgetsUnlocked();
 
   int64_t low_io_most_logs_retained_bytes = 0;
   MaintenanceOp* low_io_most_logs_retained_bytes_op = nullptr;
@@ -280,7 +312,7 @@ MaintenanceOp* MaintenanceManager::FindBestOp() {
   int64_t most_logs_retained_bytes_ram_anchored = 0;
   MaintenanceOp* most_logs_retained_bytes_op = nullptr;
 
-  double best_perf_improvement = 0;
+  double best_perf_score = 0;
   MaintenanceOp* best_perf_improvement_op = nullptr;
   for (OpMapTy::value_type &val : ops_) {
     MaintenanceOp* op(val.first);
@@ -291,6 +323,11 @@ MaintenanceOp* MaintenanceManager::FindBestOp() {
     if (!stats.valid() || !stats.runnable()) {
       continue;
     }
+    if (op->io_usage_ == MaintenanceOp::HIGH_IO_USAGE && !DiskAvailableUnlocked(*op)) {
+      // Already busy with another op or out of its I/O budget, so this one would compete with
+      // them and with foreground operations for the disk.
+      continue;
+    }
     if (stats.logs_retained_bytes() > low_io_most_logs_retained_bytes &&
         op->io_usage_ == MaintenanceOp::LOW_IO_USAGE) {
       low_io_most_logs_retained_bytes_op = op;
@@ -311,21 +348,22 @@ MaintenanceOp* MaintenanceManager::FindBestOp() {
       most_logs_retained_bytes = stats.logs_retained_bytes();
       most_logs_retained_bytes_ram_anchored = stats.ram_anchored();
     }
-    if ((!best_perf_improvement_op) ||
-        (stats.perf_improvement() > best_perf_improvement)) {
+    // Perf improvement is weighed against the I/O it costs.
+    const double perf_score =
+        stats.perf_improvement() / (1 + stats.io_bytes() / kIoCostUnitBytes);
+    if ((!best_perf_improvement_op) || (perf_score > best_perf_score)) {
       best_perf_improvement_op = op;
-      best_perf_improvement = stats.perf_improvement();
+      best_perf_score = perf_score;
     }
   }
 
   // Look at ops that we can run quickly that free up log retention.
   if (low_io_most_logs_retained_bytes_op) {
     if (low_io_most_logs_retained_bytes > 0) {
-      VLOG_AND_TRACE("maintenance", 1)
-                    << "Performing " << low_io_most_logs_retained_bytes_op->name() << ", "
-                    << "because it can free up more logs "
-                    << "at " << low_io_most_logs_retained_bytes
-                    << " bytes with a low IO cost";
+      best_op_reason_ = Substitute(
+          "Performing $0, because it can free up more logs at $1 bytes with a low IO cost",
+          low_io_most_logs_retained_bytes_op->name(), low_io_most_logs_retained_bytes);
+      VLOG_AND_TRACE("maintenance", 1) << best_op_reason_;
       return low_io_most_logs_retained_bytes_op;
     }
   }
@@ -335,37 +373,97 @@ MaintenanceOp* MaintenanceManager::FindBestOp() {
   double capacity_pct;
   if (parent_mem_tracker_->AnySoftLimitExceeded(&capacity_pct)) {
     if (!most_mem_anchored_op) {
-      string msg = StringPrintf("we have exceeded our soft memory limit "
+      best_op_reason_ = StringPrintf("we have exceeded our soft memory limit "
           "(current capacity is %.2f%%).  However, there are no ops currently "
           "runnable which would free memory.", capacity_pct);
-      LOG(INFO) << msg;
+      LOG(INFO) << best_op_reason_;
       return nullptr;
     }
-    VLOG_AND_TRACE("maintenance", 1) << "we have exceeded our soft memory limit "
-            << "(current capacity is " << capacity_pct << "%).  Running the op "
-            << "which anchors the most memory: " << most_mem_anchored_op->name();
+    best_op_reason_ = Substitute(
+        "we have exceeded our soft memory limit (current capacity is $0%).  Running the op "
+        "which anchors the most memory: $1", capacity_pct, most_mem_anchored_op->name());
+    VLOG_AND_TRACE("maintenance", 1) << best_op_reason_;
     return most_mem_anchored_op;
   }
 
   if (most_logs_retained_bytes_op) {
-    VLOG_AND_TRACE("maintenance", 1)
-            << "Performing " << most_logs_retained_bytes_op->name() << ", "
-            << "because it can free up more logs " << "at " << most_logs_retained_bytes
-            << " bytes";
+    best_op_reason_ = Substitute(
+        "Performing $0, because it can free up more logs at $1 bytes",
+        most_logs_retained_bytes_op->name(), most_logs_retained_bytes);
+    VLOG_AND_TRACE("maintenance", 1) << best_op_reason_;
     return most_logs_retained_bytes_op;
   }
 
   if (best_perf_improvement_op) {
-    if (best_perf_improvement > 0) {
-      VLOG_AND_TRACE("maintenance", 1) << "Performing " << best_perf_improvement_op->name() << ", "
-                 << "because it had the best perf_improvement score, "
-                 << "at " << best_perf_improvement;
+    if (best_perf_score > 0) {
+      best_op_reason_ = Substitute(
+          "Performing $0, because it had the best perf_improvement score per IO cost, at $1",
+          best_perf_improvement_op->name(), best_perf_score);
+      VLOG_AND_TRACE("maintenance", 1) << best_op_reason_;
       return best_perf_improvement_op;
     }
   }
+  best_op_reason_ = "No maintenance operations look worth doing";
   return nullptr;
 }
 
+void MaintenanceManager::RefillDiskBudgetsUnlocked() {
+  const auto now = MonoTime::Now();
+  const double budget_bytes_per_sec = DiskIoBudgetBytesPerSec();
+  for (auto& disk : disks_) {
+    auto& state = disk.second;
+    if (budget_bytes_per_sec > 0) {
+      // Unused budget is accumulated for at most one second, so a disk that was idle does not get
+      // a burst of maintenance I/O.
+      state.available_io_bytes = std::min(
+          state.available_io_bytes +
+              now.GetDeltaSince(state.last_refill).ToSeconds() * budget_bytes_per_sec,
+          budget_bytes_per_sec);
+    }
+    state.last_refill = now;
+  }
+}
+
+bool MaintenanceManager::DiskAvailableUnlocked(const MaintenanceOp& op) {
+  auto it = disks_.find(op.disk());
+  if (it == disks_.end()) {
+    return true;
+  }
+  return it->second.running_ops == 0 &&
+         (FLAGS_maintenance_manager_disk_io_budget_mb_per_sec <= 0 ||
+          it->second.available_io_bytes > 0);
+}
+
+void MaintenanceManager::OpStartedUnlocked(MaintenanceOp* op, const MaintenanceOpStats& stats) {
+  op->running_++;
+  running_ops_++;
+  if (op->io_usage_ != MaintenanceOp::HIGH_IO_USAGE) {
+    return;
+  }
+  auto it = disks_.find(op->disk());
+  if (it == disks_.end()) {
+    it = disks_.emplace(op->disk(), DiskState()).first;
+    it->second.available_io_bytes = DiskIoBudgetBytesPerSec();
+    it->second.last_refill = MonoTime::Now();
+  }
+  ++it->second.running_ops;
+  if (stats.valid()) {
+    it->second.available_io_bytes -= stats.io_bytes();
+  }
+}
+
+void MaintenanceManager::OpFinishedUnlocked(MaintenanceOp* op) {
+  running_ops_--;
+  op->running_--;
+  if (op->io_usage_ == MaintenanceOp::HIGH_IO_USAGE) {
+    auto it = disks_.find(op->disk());
+    if (it != disks_.end()) {
+      --it->second.running_ops;
+    }
+  }
+  op->cond_->Signal();
+}
+
 void MaintenanceManager::LaunchOp(MaintenanceOp* op) {
   MonoTime start_time(MonoTime::Now());
   op->RunningGauge()->Increment();
@@ -387,9 +485,7 @@ void MaintenanceManager::LaunchOp(MaintenanceOp* op) {
 
   op->DurationHistogram()->Increment(delta.ToMilliseconds());
 
-  running_ops_--;
-  op->running_--;
-  op->cond_->Signal();
+  OpFinishedUnlocked(op);
 }
 
 void MaintenanceManager::GetMaintenanceManagerStatusDump(MaintenanceManagerStatusPB* out_pb) {
@@ -407,6 +503,7 @@ void MaintenanceManager::GetMaintenanceManagerStatusDump(MaintenanceManagerStatu
       op_pb->set_ram_anchored_bytes(stat.ram_anchored());
       op_pb->set_logs_retained_bytes(stat.logs_retained_bytes());
       op_pb->set_perf_improvement(stat.perf_improvement());
+      op_pb->set_io_bytes(stat.io_bytes());
     } else {
       op_pb->set_runnable(false);
       op_pb->set_ram_anchored_bytes(0);
@@ -414,10 +511,22 @@ void MaintenanceManager::GetMaintenanceManagerStatusDump(MaintenanceManagerStatu
       op_pb->set_perf_improvement(0);
     }
 
+    if (!op->disk().empty()) {
+      op_pb->set_disk(op->disk());
+    }
+
     if (best_op == op) {
       out_pb->mutable_best_op()->CopyFrom(*op_pb);
     }
   }
+  out_pb->set_best_op_reason(best_op_reason_);
+
+  for (const auto& disk : disks_) {
+    auto* disk_pb = out_pb->add_disks();
+    disk_pb->set_name(disk.first);
+    disk_pb->set_running_ops(disk.second.running_ops);
+    disk_pb->set_available_io_bytes(static_cast<int64_t>(disk.second.available_io_bytes));
+  }
 
   for (const CompletedOp& completed_op : completed_ops_) {
     if (!completed_op.name.empty()) {
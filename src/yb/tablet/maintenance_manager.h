@@ -104,6 +104,16 @@ class MaintenanceOpStats {
     perf_improvement_ = perf_improvement;
   }
 
+  int64_t io_bytes() const {
+    DCHECK(valid_);
+    return io_bytes_;
+  }
+
+  void set_io_bytes(int64_t io_bytes) {
+    UpdateLastModified();
+    io_bytes_ = io_bytes;
+  }
+
   const MonoTime& last_modified() const {
     DCHECK(valid_);
     return last_modified_;
@@ -138,6 +148,11 @@ class MaintenanceOpStats {
   // absolute scale (yet TBD).
   double perf_improvement_;
 
+  // The approximate number of bytes this operation reads and writes. It is charged to the I/O
+  // budget of the disk of a HIGH_IO_USAGE op, and the perf improvement of such ops is weighed
+  // against it. May be 0.
+  int64_t io_bytes_;
+
   // The last time that the stats were modified.
   MonoTime last_modified_;
 };
@@ -157,7 +172,10 @@ class MaintenanceOp {
     HIGH_IO_USAGE // Everything else.
   };
 
-  explicit MaintenanceOp(std::string name, IOUsage io_usage);
+  // disk identifies the data directory or device the op does its I/O on. HIGH_IO_USAGE ops on the
+  // same disk do not run concurrently and share its I/O budget, see
+  // FLAGS_maintenance_manager_disk_io_budget_mb_per_sec. Ops with no disk specified share one.
+  MaintenanceOp(std::string name, IOUsage io_usage, std::string disk = std::string());
   virtual ~MaintenanceOp();
 
   // Unregister this op, if it is currently registered.
@@ -192,6 +210,8 @@ class MaintenanceOp {
 
   IOUsage io_usage() const { return io_usage_; }
 
+  const std::string& disk() const { return disk_; }
+
  private:
   // The name of the operation.  Op names must be unique.
   const std::string name_;
@@ -211,6 +231,8 @@ class MaintenanceOp {
 
   IOUsage io_usage_;
 
+  const std::string disk_;
+
   DISALLOW_COPY_AND_ASSIGN(MaintenanceOp);
 };
 
@@ -261,6 +283,18 @@ class MaintenanceManager : public std::enable_shared_from_this<MaintenanceManage
 
  private:
   FRIEND_TEST(MaintenanceManagerTest, TestLogRetentionPrioritization);
+  FRIEND_TEST(MaintenanceManagerTest, TestDiskScheduling);
+
+  // State of HIGH_IO_USAGE ops of a disk.
+  struct DiskState {
+    uint32_t running_ops = 0;
+    // Bytes of I/O that ops may still use now, replenished at the rate of the disk's budget. Could
+    // get negative, because an op is started while the budget is positive and charged all of its
+    // estimated I/O at once.
+    double available_io_bytes = 0;
+    MonoTime last_refill;
+  };
+
   typedef std::map<MaintenanceOp*, MaintenanceOpStats,
           MaintenanceOpComparator> OpMapTy;
 
@@ -269,6 +303,14 @@ class MaintenanceManager : public std::enable_shared_from_this<MaintenanceManage
   // find the best op, or null if there is nothing we want to run
   MaintenanceOp* FindBestOp();
 
+  void RefillDiskBudgetsUnlocked();
+
+  // Returns true if a HIGH_IO_USAGE op could be started on the disk of op.
+  bool DiskAvailableUnlocked(const MaintenanceOp& op);
+
+  void OpStartedUnlocked(MaintenanceOp* op, const MaintenanceOpStats& stats);
+  void OpFinishedUnlocked(MaintenanceOp* op);
+
   void LaunchOp(MaintenanceOp* op);
 
   const int32_t num_threads_;
@@ -285,6 +327,9 @@ class MaintenanceManager : public std::enable_shared_from_this<MaintenanceManage
   std::vector<CompletedOp> completed_ops_;
   int64_t completed_ops_count_;
   std::shared_ptr<MemTracker> parent_mem_tracker_;
+  std::map<std::string, DiskState> disks_;
+  // Why the last op returned by FindBestOp was picked, or why none was.
+  std::string best_op_reason_;
 
   DISALLOW_COPY_AND_ASSIGN(MaintenanceManager);
 };
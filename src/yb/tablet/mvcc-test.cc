@@ -320,5 +320,96 @@ TEST_F(MvccTest, WaitForSafeTime) {
   ASSERT_FALSE(manager_.SafeTime(ht3, CoarseMonoClock::now() + 100ms, HybridTime::kMax));
 }
 
+TEST_F(MvccTest, SafeTimeForFollowerAsync) {
+  HybridTime ht1(HybridTime::FromMicros(1000));
+  HybridTime ht2(HybridTime::FromMicros(2000));
+  manager_.SetPropagatedSafeTimeOnFollower(ht1);
+
+  std::vector<HybridTime> results;
+  auto callback = [&results](HybridTime safe_time) { results.push_back(safe_time); };
+
+  // Already reached.
+  manager_.SafeTimeForFollowerAsync(ht1, CoarseTimePoint::max(), callback);
+  ASSERT_EQ(std::vector<HybridTime>{ht1}, results);
+
+  results.clear();
+  manager_.SafeTimeForFollowerAsync(ht2, CoarseTimePoint::max(), callback);
+  manager_.SafeTimeForFollowerAsync(
+      AddLogical(ht2, 1), CoarseMonoClock::now() + 50ms, callback);
+  ASSERT_TRUE(results.empty());
+
+  manager_.SetPropagatedSafeTimeOnFollower(ht2);
+  ASSERT_EQ(std::vector<HybridTime>{ht2}, results);
+
+  // The deadline is checked on the next update of safe time.
+  std::this_thread::sleep_for(100ms);
+  manager_.SetPropagatedSafeTimeOnFollower(ht2);
+  ASSERT_EQ(2, results.size());
+  ASSERT_FALSE(results[1].is_valid());
+
+  results.clear();
+  manager_.SafeTimeForFollowerAsync(AddLogical(ht2, 1), CoarseTimePoint::max(), callback);
+  manager_.AbortSafeTimeWaiters();
+  manager_.SafeTimeForFollowerAsync(AddLogical(ht2, 1), CoarseTimePoint::max(), callback);
+  ASSERT_EQ(2, results.size());
+  ASSERT_FALSE(results[0].is_valid());
+  ASSERT_FALSE(results[1].is_valid());
+}
+
+// Measures throughput of safe time requests concurrent with a stream of operations, and checks
+// that safe time never goes backwards and never covers a pending operation.
+TEST_F(MvccTest, SafeTimeContention) {
+  constexpr int kNumReaders = 8;
+  const auto kTestDuration = 2s;
+
+  std::atomic<bool> stop(false);
+  // Time of the pending operation, kMax when there is none.
+  std::atomic<uint64_t> pending(HybridTime::kMax.ToUint64());
+  std::atomic<size_t> num_reads(0);
+  std::atomic<size_t> num_failures(0);
+  std::vector<std::thread> readers;
+  for (int i = 0; i != kNumReaders; ++i) {
+    readers.emplace_back([this, &stop, &pending, &num_reads, &num_failures] {
+      HybridTime last_safe_time = HybridTime::kMin;
+      size_t reads = 0;
+      while (!stop.load(std::memory_order_acquire)) {
+        auto pending_before = pending.load(std::memory_order_acquire);
+        auto safe_time = manager_.SafeTime(HybridTime::kMax);
+        if (safe_time < last_safe_time ||
+            (pending_before != HybridTime::kMax.ToUint64() &&
+             pending.load(std::memory_order_acquire) == pending_before &&
+             safe_time.ToUint64() >= pending_before)) {
+          ++num_failures;
+        }
+        last_safe_time = safe_time;
+        ++reads;
+      }
+      num_reads += reads;
+    });
+  }
+
+  size_t num_writes = 0;
+  auto deadline = std::chrono::steady_clock::now() + kTestDuration;
+  while (std::chrono::steady_clock::now() < deadline) {
+    HybridTime ht;
+    manager_.AddPending(&ht);
+    pending.store(ht.ToUint64(), std::memory_order_release);
+    ASSERT_LT(manager_.SafeTime(HybridTime::kMax), ht);
+    pending.store(HybridTime::kMax.ToUint64(), std::memory_order_release);
+    manager_.Replicated(ht);
+    ++num_writes;
+  }
+  stop = true;
+  for (auto& reader : readers) {
+    reader.join();
+  }
+
+  LOG(INFO) << "Writes: " << num_writes << ", reads: " << num_reads.load()
+            << ", reads per second: "
+            << num_reads.load() / std::chrono::duration_cast<std::chrono::seconds>(
+                   kTestDuration).count();
+  ASSERT_EQ(0, num_failures.load());
+}
+
 } // namespace tablet
 } // namespace yb
@@ -34,6 +34,8 @@
 
 #include <sstream>
 
+#include <boost/scope_exit.hpp>
+
 #include "yb/util/logging.h"
 
 namespace yb {
@@ -47,10 +49,42 @@ std::string SafeTimeWithSource::ToString() const {
   return Format("{ safe_time: $0 source: $1 }", safe_time, source);
 }
 
+// ------------------------------------------------------------------------------------------------
+// AtomicSafeTimeWithSource
+// ------------------------------------------------------------------------------------------------
+
+SafeTimeWithSource AtomicSafeTimeWithSource::Load() const {
+  return { HybridTime(safe_time_.load(std::memory_order_acquire)),
+           source_.load(std::memory_order_relaxed) };
+}
+
+void AtomicSafeTimeWithSource::UpdateMax(const SafeTimeWithSource& value) {
+  auto new_value = value.safe_time.ToUint64();
+  auto old_value = safe_time_.load(std::memory_order_acquire);
+  while (new_value > old_value) {
+    if (safe_time_.compare_exchange_weak(old_value, new_value, std::memory_order_acq_rel)) {
+      source_.store(value.source, std::memory_order_relaxed);
+      return;
+    }
+  }
+}
+
 // ------------------------------------------------------------------------------------------------
 // MvccManager
 // ------------------------------------------------------------------------------------------------
 
+namespace {
+
+HybridTime Load(const std::atomic<HybridTimeRepr>& value) {
+  return HybridTime(value.load(std::memory_order_acquire));
+}
+
+void Store(HybridTime ht, std::atomic<HybridTimeRepr>* value) {
+  value->store(ht.ToUint64(), std::memory_order_release);
+}
+
+} // namespace
+
 MvccManager::MvccManager(std::string prefix, server::ClockPtr clock)
     : prefix_(std::move(prefix)),
       clock_(std::move(clock)) {}
@@ -62,10 +96,12 @@ void MvccManager::Replicated(HybridTime ht) {
     std::lock_guard<std::mutex> lock(mutex_);
     CHECK(!queue_.empty()) << LogPrefix();
     CHECK_EQ(queue_.front(), ht) << LogPrefix();
+    // last_replicated_ is published before the queue front, so readers never see safe time going
+    // backwards.
+    Store(ht, &last_replicated_);
     PopFront(&lock);
-    last_replicated_ = ht;
   }
-  cond_.notify_all();
+  Notify();
 }
 
 void MvccManager::Aborted(HybridTime ht) {
@@ -81,7 +117,7 @@ void MvccManager::Aborted(HybridTime ht) {
       return;
     }
   }
-  cond_.notify_all();
+  Notify();
 }
 
 void MvccManager::PopFront(std::lock_guard<std::mutex>* lock) {
@@ -95,11 +131,87 @@ void MvccManager::PopFront(std::lock_guard<std::mutex>* lock) {
     queue_.pop_front();
     aborted_.pop();
   }
+  PublishQueueFront();
+}
+
+void MvccManager::PublishQueueFront() {
+  queue_front_.store(queue_.empty() ? kInvalidHybridTimeValue : queue_.front().ToUint64(),
+                     std::memory_order_release);
+}
+
+void MvccManager::Notify() {
+  // Waiters are counted with the locked mutex, so a waiter either sees the published values when
+  // checking its predicate, or is counted here.
+  if (num_waiters_.load(std::memory_order_acquire) != 0) {
+    cond_.notify_all();
+  }
+  if (num_follower_waiters_.load(std::memory_order_acquire) != 0) {
+    NotifyFollowerWaiters();
+  }
+}
+
+void MvccManager::NotifyFollowerWaiters() {
+  std::vector<std::pair<SafeTimeCallback, HybridTime>> ready;
+  SafeTimeWithSource result;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    result = ComputeSafeTimeForFollower();
+    const auto now = CoarseMonoClock::now();
+    auto keep = follower_waiters_.begin();
+    for (auto& waiter : follower_waiters_) {
+      if (result.safe_time >= waiter.min_allowed) {
+        ready.emplace_back(std::move(waiter.callback), result.safe_time);
+      } else if (now >= waiter.deadline) {
+        ready.emplace_back(std::move(waiter.callback), HybridTime::kInvalid);
+      } else {
+        if (&*keep != &waiter) {
+          *keep = std::move(waiter);
+        }
+        ++keep;
+      }
+    }
+    follower_waiters_.erase(keep, follower_waiters_.end());
+    num_follower_waiters_.store(follower_waiters_.size(), std::memory_order_release);
+  }
+  if (ready.empty()) {
+    return;
+  }
+  max_safe_time_returned_for_follower_.UpdateMax(result);
+  // Invoked without the mutex, so the callbacks could call back into MvccManager.
+  for (auto& callback_and_time : ready) {
+    callback_and_time.first(callback_and_time.second);
+  }
+}
+
+template <class Predicate>
+bool MvccManager::WaitUntil(std::unique_lock<std::mutex>* lock, CoarseTimePoint deadline,
+                            const Predicate& predicate) const {
+  num_waiters_.fetch_add(1, std::memory_order_acq_rel);
+  bool result = true;
+  if (deadline == CoarseTimePoint::max()) {
+    cond_.wait(*lock, predicate);
+  } else {
+    result = cond_.wait_until(*lock, deadline, predicate);
+  }
+  num_waiters_.fetch_sub(1, std::memory_order_acq_rel);
+  return result;
 }
 
 void MvccManager::AddPending(HybridTime* ht) {
   const bool is_follower_side = ht->is_valid();
   std::lock_guard<std::mutex> lock(mutex_);
+  // While the queue is empty, lock-free readers use the clock as safe time, so they should not
+  // rely on a clock value read after the time of this operation was assigned.
+  const bool was_empty = queue_.empty();
+  if (was_empty) {
+    add_pending_version_.fetch_add(1, std::memory_order_seq_cst);
+  }
+  BOOST_SCOPE_EXIT(this_, was_empty) {
+    if (was_empty) {
+      this_->add_pending_version_.fetch_add(1, std::memory_order_seq_cst);
+    }
+  } BOOST_SCOPE_EXIT_END;
+
   if (is_follower_side) {
     // This must be a follower-side transaction with already known hybrid time.
     VLOG_WITH_PREFIX(1) << "AddPending(" << *ht << ")";
@@ -130,12 +242,16 @@ void MvccManager::AddPending(HybridTime* ht) {
   }
   HybridTime last_ht_in_queue = queue_.empty() ? HybridTime::kMin : queue_.back();
 
+  const auto max_safe_time_returned_with_lease = max_safe_time_returned_with_lease_.Load();
+  const auto max_safe_time_returned_without_lease = max_safe_time_returned_without_lease_.Load();
+  const auto max_safe_time_returned_for_follower = max_safe_time_returned_for_follower_.Load();
+  const auto last_replicated = Load(last_replicated_);
   HybridTime sanity_check_lower_bound =
       std::max({
-          max_safe_time_returned_with_lease_.safe_time,
-          max_safe_time_returned_without_lease_.safe_time,
-          max_safe_time_returned_for_follower_.safe_time,
-          last_replicated_,
+          max_safe_time_returned_with_lease.safe_time,
+          max_safe_time_returned_without_lease.safe_time,
+          max_safe_time_returned_for_follower.safe_time,
+          last_replicated,
           last_ht_in_queue});
 
   if (!queue_.empty() && *ht <= sanity_check_lower_bound) {
@@ -150,11 +266,11 @@ void MvccManager::AddPending(HybridTime* ht) {
           << "\n  "
 
       ss << LogPrefix() << ": new operation's hybrid time too low: " << *ht
-         << LOG_INFO_FOR_HT_LOWER_BOUND(max_safe_time_returned_with_lease_)
-         << LOG_INFO_FOR_HT_LOWER_BOUND(max_safe_time_returned_without_lease_)
-         << LOG_INFO_FOR_HT_LOWER_BOUND(max_safe_time_returned_for_follower_)
+         << LOG_INFO_FOR_HT_LOWER_BOUND(max_safe_time_returned_with_lease)
+         << LOG_INFO_FOR_HT_LOWER_BOUND(max_safe_time_returned_without_lease)
+         << LOG_INFO_FOR_HT_LOWER_BOUND(max_safe_time_returned_for_follower)
          << LOG_INFO_FOR_HT_LOWER_BOUND(
-                (SafeTimeWithSource{last_replicated_, SafeTimeSource::kUnknown}))
+                (SafeTimeWithSource{last_replicated, SafeTimeSource::kUnknown}))
          << LOG_INFO_FOR_HT_LOWER_BOUND(
                 (SafeTimeWithSource{last_ht_in_queue, SafeTimeSource::kUnknown}))
          << "\n  " << EXPR_VALUE_FOR_LOG(is_follower_side)
@@ -191,6 +307,7 @@ void MvccManager::AddPending(HybridTime* ht) {
     }
   }
   queue_.push_back(*ht);
+  PublishQueueFront();
 }
 
 void MvccManager::SetLastReplicated(HybridTime ht) {
@@ -198,9 +315,9 @@ void MvccManager::SetLastReplicated(HybridTime ht) {
 
   {
     std::lock_guard<std::mutex> lock(mutex_);
-    last_replicated_ = ht;
+    Store(ht, &last_replicated_);
   }
-  cond_.notify_all();
+  Notify();
 }
 
 void MvccManager::SetPropagatedSafeTimeOnFollower(HybridTime ht) {
@@ -208,15 +325,16 @@ void MvccManager::SetPropagatedSafeTimeOnFollower(HybridTime ht) {
 
   {
     std::lock_guard<std::mutex> lock(mutex_);
-    if (ht >= propagated_safe_time_) {
-      propagated_safe_time_ = ht;
+    auto propagated_safe_time = Load(propagated_safe_time_);
+    if (ht >= propagated_safe_time) {
+      Store(ht, &propagated_safe_time_);
     } else {
       LOG(WARNING) << "Received propagated safe time " << ht << " less than the old value: "
-                   << propagated_safe_time_ << ". This could happen on followers when a new leader "
+                   << propagated_safe_time << ". This could happen on followers when a new leader "
                    << "is elected.";
     }
   }
-  cond_.notify_all();
+  Notify();
 }
 
 void MvccManager::UpdatePropagatedSafeTimeOnLeader(HybridTime ht_lease) {
@@ -228,63 +346,142 @@ void MvccManager::UpdatePropagatedSafeTimeOnLeader(HybridTime ht_lease) {
                             CoarseTimePoint::max(), // deadline
                             ht_lease,
                             &lock);
+    auto propagated_safe_time = Load(propagated_safe_time_);
 #ifndef NDEBUG
     // This should only be called from RaftConsensus::UpdateMajorityReplicated, and ht_lease passed
     // in here should keep increasing, so we should not see propagated_safe_time_ going backwards.
-    CHECK_GE(ht, propagated_safe_time_) << LogPrefix();
-    propagated_safe_time_ = ht;
+    CHECK_GE(ht, propagated_safe_time) << LogPrefix();
+    Store(ht, &propagated_safe_time_);
 #else
     // Do not crash in production.
-    if (ht < propagated_safe_time_) {
+    if (ht < propagated_safe_time) {
       YB_LOG_EVERY_N_SECS(ERROR, 5) << LogPrefix()
-          << "Previously saw " << EXPR_VALUE_FOR_LOG(propagated_safe_time_)
+          << "Previously saw " << EXPR_VALUE_FOR_LOG(propagated_safe_time)
           << ", but now safe time is " << ht;
     } else {
-      propagated_safe_time_ = ht;
+      Store(ht, &propagated_safe_time_);
     }
 #endif
   }
-  cond_.notify_all();
+  Notify();
+}
+
+SafeTimeWithSource MvccManager::ComputeSafeTimeForFollower() const {
+  SafeTimeWithSource result;
+  // last_replicated_ is updated earlier than propagated_safe_time_, so because of concurrency it
+  // could be greater than propagated_safe_time_.
+  auto propagated_safe_time = Load(propagated_safe_time_);
+  auto last_replicated = Load(last_replicated_);
+  if (propagated_safe_time > last_replicated) {
+    result.safe_time = propagated_safe_time;
+    result.source = SafeTimeSource::kPropagated;
+  } else {
+    result.safe_time = last_replicated;
+    result.source = SafeTimeSource::kLastReplicated;
+  }
+  return result;
 }
 
 HybridTime MvccManager::SafeTimeForFollower(
     HybridTime min_allowed, CoarseTimePoint deadline) const {
-  std::unique_lock<std::mutex> lock(mutex_);
+  // Loaded before computing the result, because both sources of it never go backwards.
+  const auto enforced_min_time = max_safe_time_returned_for_follower_.Load();
   SafeTimeWithSource result;
   auto predicate = [this, &result, min_allowed] {
-    // last_replicated_ is updated earlier than propagated_safe_time_, so because of concurrency it
-    // could be greater than propagated_safe_time_.
-    if (propagated_safe_time_ > last_replicated_) {
-      result.safe_time = propagated_safe_time_;
-      result.source = SafeTimeSource::kPropagated;
-    } else {
-      result.safe_time = last_replicated_;
-      result.source = SafeTimeSource::kLastReplicated;
-    }
+    result = ComputeSafeTimeForFollower();
     return result.safe_time >= min_allowed;
   };
-  if (deadline == CoarseTimePoint::max()) {
-    cond_.wait(lock, predicate);
-  } else if (!cond_.wait_until(lock, deadline, predicate)) {
-    return HybridTime::kInvalid;
+  if (!predicate()) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (!WaitUntil(&lock, deadline, predicate)) {
+      return HybridTime::kInvalid;
+    }
   }
   VLOG_WITH_PREFIX(1) << "SafeTimeForFollower(" << min_allowed
                       << "), result = " << result.ToString();
-  CHECK_GE(result.safe_time, max_safe_time_returned_for_follower_.safe_time)
+  CHECK_GE(result.safe_time, enforced_min_time.safe_time)
       << LogPrefix() << "result: " << result.ToString()
-      << ", max_safe_time_returned_for_follower_: "
-      << max_safe_time_returned_for_follower_.ToString();
-  max_safe_time_returned_for_follower_ = result;
+      << ", max_safe_time_returned_for_follower_: " << enforced_min_time.ToString();
+  max_safe_time_returned_for_follower_.UpdateMax(result);
   return result.safe_time;
 }
 
+void MvccManager::SafeTimeForFollowerAsync(
+    HybridTime min_allowed, CoarseTimePoint deadline, SafeTimeCallback callback) const {
+  auto result = ComputeSafeTimeForFollower();
+  if (result.safe_time < min_allowed) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    // Rechecked with the locked mutex, so that an update either is seen here, or sees the waiter.
+    result = ComputeSafeTimeForFollower();
+    if (result.safe_time < min_allowed) {
+      if (!follower_waiters_aborted_ && CoarseMonoClock::now() < deadline) {
+        follower_waiters_.push_back({min_allowed, deadline, std::move(callback)});
+        num_follower_waiters_.store(follower_waiters_.size(), std::memory_order_release);
+        return;
+      }
+      result.safe_time = HybridTime::kInvalid;
+    }
+  }
+  if (result.safe_time.is_valid()) {
+    max_safe_time_returned_for_follower_.UpdateMax(result);
+  }
+  callback(result.safe_time);
+}
+
+void MvccManager::AbortSafeTimeWaiters() {
+  std::vector<FollowerWaiter> waiters;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    follower_waiters_aborted_ = true;
+    waiters.swap(follower_waiters_);
+    num_follower_waiters_.store(0, std::memory_order_release);
+  }
+  for (auto& waiter : waiters) {
+    waiter.callback(HybridTime::kInvalid);
+  }
+}
+
 HybridTime MvccManager::SafeTime(HybridTime min_allowed,
                                  CoarseTimePoint deadline,
                                  HybridTime ht_lease) const {
-  std::unique_lock<std::mutex> lock(mutex_);
+  std::unique_lock<std::mutex> lock(mutex_, std::defer_lock);
   return DoGetSafeTime(min_allowed, deadline, ht_lease, &lock);
 }
 
+bool MvccManager::TryComputeSafeTime(bool has_lease, SafeTimeWithSource* result) const {
+  const auto version = add_pending_version_.load(std::memory_order_seq_cst);
+  if (version & 1) {
+    return false;
+  }
+
+  auto queue_front = Load(queue_front_);
+  if (!queue_front.is_valid()) {
+    result->safe_time = clock_->Now();
+    result->source = SafeTimeSource::kNow;
+    VLOG_WITH_PREFIX(2) << "DoGetSafeTime, Now: " << result->safe_time;
+  } else {
+    result->safe_time = queue_front.Decremented();
+    result->source = SafeTimeSource::kNextInQueue;
+    VLOG_WITH_PREFIX(2) << "DoGetSafeTime, Queue front (decremented): " << result->safe_time;
+  }
+
+  if (has_lease) {
+    auto max_ht_lease_seen = Load(max_ht_lease_seen_);
+    if (result->safe_time > max_ht_lease_seen) {
+      result->safe_time = max_ht_lease_seen;
+      result->source = SafeTimeSource::kHybridTimeLease;
+    }
+  }
+
+  // This function could be invoked at a follower, so it has a very old ht_lease. In this case it
+  // is safe to read at least at last_replicated_.
+  result->safe_time = std::max(result->safe_time, Load(last_replicated_));
+
+  // Checked after reading the clock, so that the result is not used if an operation could get
+  // a time from the clock before it.
+  return add_pending_version_.load(std::memory_order_seq_cst) == version;
+}
+
 HybridTime MvccManager::DoGetSafeTime(const HybridTime min_allowed,
                                       const CoarseTimePoint deadline,
                                       const HybridTime ht_lease,
@@ -295,70 +492,60 @@ HybridTime MvccManager::DoGetSafeTime(const HybridTime min_allowed,
 
   const bool has_lease = ht_lease.GetPhysicalValueMicros() < kMaxHybridTimePhysicalMicros;
   if (has_lease) {
-    max_ht_lease_seen_ = std::max(ht_lease, max_ht_lease_seen_);
+    auto new_value = ht_lease.ToUint64();
+    auto old_value = max_ht_lease_seen_.load(std::memory_order_acquire);
+    while (new_value > old_value &&
+           !max_ht_lease_seen_.compare_exchange_weak(old_value, new_value)) {}
   }
 
-  HybridTime result;
-  SafeTimeSource source = SafeTimeSource::kUnknown;
-  auto predicate = [this, &result, &source, min_allowed, has_lease] {
-    if (queue_.empty()) {
-      result = clock_->Now();
-      source = SafeTimeSource::kNow;
-      CHECK_GE(result, min_allowed) << LogPrefix();
-      VLOG_WITH_PREFIX(2) << "DoGetSafeTime, Now: " << result;
-    } else {
-      result = queue_.front().Decremented();
-      source = SafeTimeSource::kNextInQueue;
-      VLOG_WITH_PREFIX(2) << "DoGetSafeTime, Queue front (decremented): " << result;
-    }
+  auto& max_safe_time_returned = has_lease ? max_safe_time_returned_with_lease_
+                                           : max_safe_time_returned_without_lease_;
+  // Loaded before computing the result, because published values never make it go backwards.
+  const auto enforced_min_time = max_safe_time_returned.Load().safe_time;
 
-    if (has_lease && result > max_ht_lease_seen_) {
-      result = max_ht_lease_seen_;
-      source = SafeTimeSource::kHybridTimeLease;
+  SafeTimeWithSource result;
+  auto predicate = [this, &result, min_allowed, has_lease] {
+    if (!TryComputeSafeTime(has_lease, &result)) {
+      // Could only happen without the lock, since AddPending holds it.
+      return false;
     }
-
-    // This function could be invoked at a follower, so it has a very old ht_lease. In this case it
-    // is safe to read at least at last_replicated_.
-    result = std::max(result, last_replicated_);
-
-    return result >= min_allowed;
+    if (result.source == SafeTimeSource::kNow) {
+      CHECK_GE(result.safe_time, min_allowed) << LogPrefix();
+    }
+    return result.safe_time >= min_allowed;
   };
 
   // In the case of an empty queue, the safe hybrid time to read at is only limited by hybrid time
   // ht_lease, which is by definition higher than min_allowed, so we would not get blocked.
-  if (deadline == CoarseTimePoint::max()) {
-    cond_.wait(*lock, predicate);
-  } else if (!cond_.wait_until(*lock, deadline, predicate)) {
-    return HybridTime::kInvalid;
+  if (lock->owns_lock() || !predicate()) {
+    if (!lock->owns_lock()) {
+      lock->lock();
+    }
+    if (!WaitUntil(lock, deadline, predicate)) {
+      return HybridTime::kInvalid;
+    }
   }
   VLOG_WITH_PREFIX(1) << "DoGetSafeTime(" << min_allowed << ", "
-                      << ht_lease << "), result = " << result;
+                      << ht_lease << "), result = " << result.ToString();
 
-  auto enforced_min_time = has_lease ? max_safe_time_returned_with_lease_.safe_time
-                                     : max_safe_time_returned_without_lease_.safe_time;
-  CHECK_GE(result, enforced_min_time) << LogPrefix()
+  CHECK_GE(result.safe_time, enforced_min_time) << LogPrefix()
       << ": " << EXPR_VALUE_FOR_LOG(has_lease)
-      << ", " << EXPR_VALUE_FOR_LOG(enforced_min_time.ToUint64() - result.ToUint64())
+      << ", " << EXPR_VALUE_FOR_LOG(enforced_min_time.ToUint64() - result.safe_time.ToUint64())
       << ", " << EXPR_VALUE_FOR_LOG(ht_lease)
-      << ", " << EXPR_VALUE_FOR_LOG(max_ht_lease_seen_)
-      << ", " << EXPR_VALUE_FOR_LOG(last_replicated_)
+      << ", " << EXPR_VALUE_FOR_LOG(Load(max_ht_lease_seen_))
+      << ", " << EXPR_VALUE_FOR_LOG(Load(last_replicated_))
       << ", " << EXPR_VALUE_FOR_LOG(clock_->Now())
       << ", " << EXPR_VALUE_FOR_LOG(ToString(deadline))
-      << ", " << EXPR_VALUE_FOR_LOG(queue_.size())
-      << ", " << EXPR_VALUE_FOR_LOG(queue_);
+      << ", " << EXPR_VALUE_FOR_LOG(Load(queue_front_));
 
-  if (has_lease) {
-    max_safe_time_returned_with_lease_ = { result, source };
-  } else {
-    max_safe_time_returned_without_lease_ = { result, source };
-  }
-  return result;
+  max_safe_time_returned.UpdateMax(result);
+  return result.safe_time;
 }
 
 HybridTime MvccManager::LastReplicatedHybridTime() const {
-  std::lock_guard<std::mutex> lock(mutex_);
-  VLOG_WITH_PREFIX(1) << __func__ << "(), result = " << last_replicated_;
-  return last_replicated_;
+  auto result = Load(last_replicated_);
+  VLOG_WITH_PREFIX(1) << __func__ << "(), result = " << result;
+  return result;
 }
 
 }  // namespace tablet
@@ -32,9 +32,11 @@
 #ifndef YB_TABLET_MVCC_H_
 #define YB_TABLET_MVCC_H_
 
+#include <atomic>
 #include <condition_variable>
 #include <mutex>
 #include <deque>
+#include <functional>
 #include <queue>
 #include <vector>
 
@@ -58,12 +60,32 @@ struct SafeTimeWithSource {
   std::string ToString() const;
 };
 
+// Maximum of safe times, that could be updated and read without locking. The source is the one
+// of the latest update, so it is only informational.
+class AtomicSafeTimeWithSource {
+ public:
+  explicit AtomicSafeTimeWithSource(HybridTime safe_time = HybridTime::kMin)
+      : safe_time_(safe_time.ToUint64()) {}
+
+  SafeTimeWithSource Load() const;
+
+  void UpdateMax(const SafeTimeWithSource& value);
+
+ private:
+  std::atomic<HybridTimeRepr> safe_time_;
+  std::atomic<SafeTimeSource> source_{SafeTimeSource::kUnknown};
+};
+
 // MvccManager is used to track operations.
 // When new operation is initiated its time should be added using AddPending.
 // When operation is replicated or aborted, MvccManager is notified using Replicated or Aborted
 // methods.
 // Operations could be replicated only in the same order as they were added.
 // Time of newly added operation should be after time of all previously added operations.
+//
+// Safe time is usually computed without locking, from the values published by the modifying
+// methods. The mutex is only taken by readers that have to wait for safe time to reach the
+// requested value.
 class MvccManager {
  public:
   // `prefix` is used for logging.
@@ -123,22 +145,72 @@ class MvccManager {
 
   HybridTime SafeTimeForFollower(HybridTime min_allowed, CoarseTimePoint deadline) const;
 
+  typedef std::function<void(HybridTime)> SafeTimeCallback;
+
+  // Asynchronous version of SafeTimeForFollower, which does not block the calling thread.
+  // Invokes callback with the safe time once it reaches `min_allowed`, or with invalid hybrid time
+  // if `deadline` passes first or the waiters are aborted. The callback is invoked right away when
+  // safe time is already there, otherwise by the thread that advances safe time, so it should not
+  // block. Deadlines are only checked when safe time is updated, i.e. at least on each Raft
+  // heartbeat from the leader.
+  void SafeTimeForFollowerAsync(
+      HybridTime min_allowed, CoarseTimePoint deadline, SafeTimeCallback callback) const;
+
+  // Invokes the callbacks of all pending and future SafeTimeForFollowerAsync calls with invalid
+  // hybrid time, e.g. when the tablet is shut down.
+  void AbortSafeTimeWaiters();
+
   // Returns time of last replicated operation.
   HybridTime LastReplicatedHybridTime() const;
 
  private:
+  // Computes safe time, locking the mutex when it has to wait for safe time to reach min_allowed.
+  // `lock` could already own the mutex.
   HybridTime DoGetSafeTime(HybridTime min_allowed,
                            CoarseTimePoint deadline,
                            HybridTime ht_lease,
                            std::unique_lock<std::mutex>* lock) const;
 
+  // Computes safe time from published values. Returns false if the result could be affected by
+  // a concurrent AddPending.
+  bool TryComputeSafeTime(bool has_lease, SafeTimeWithSource* result) const;
+
+  // Waits on cond_ until predicate is satisfied or deadline happens.
+  template <class Predicate>
+  bool WaitUntil(std::unique_lock<std::mutex>* lock, CoarseTimePoint deadline,
+                 const Predicate& predicate) const;
+
+  // Computes safe time for follower reads from published values.
+  SafeTimeWithSource ComputeSafeTimeForFollower() const;
+
+  // Wakes up waiting readers, should be called after modifying published values.
+  void Notify();
+
+  // Invokes the callbacks of async waiters whose safe time was reached or deadline passed.
+  void NotifyFollowerWaiters();
+
   const std::string& LogPrefix() const { return prefix_; }
   void PopFront(std::lock_guard<std::mutex>* lock);
+  void PublishQueueFront();
 
   std::string prefix_;
   server::ClockPtr clock_;
   mutable std::mutex mutex_;
   mutable std::condition_variable cond_;
+  // Number of readers waiting on cond_, changed with the locked mutex.
+  mutable std::atomic<int> num_waiters_{0};
+
+  struct FollowerWaiter {
+    HybridTime min_allowed;
+    CoarseTimePoint deadline;
+    SafeTimeCallback callback;
+  };
+
+  // Pending SafeTimeForFollowerAsync calls, protected by mutex_.
+  mutable std::vector<FollowerWaiter> follower_waiters_;
+  // Size of follower_waiters_, changed with the locked mutex.
+  mutable std::atomic<size_t> num_follower_waiters_{0};
+  bool follower_waiters_aborted_ = false;
 
   // An ordered queue of times of tracked operations.
   std::deque<HybridTime> queue_;
@@ -147,21 +219,31 @@ class MvccManager {
   // Required because we could abort operations from the middle of the queue.
   std::priority_queue<HybridTime, std::vector<HybridTime>, std::greater<>> aborted_;
 
-  HybridTime last_replicated_ = HybridTime::kMin;
+  // Values below are published for lock-free readers. They are modified with the locked mutex,
+  // except for the values that readers update themselves.
+
+  // Front of queue_, or kInvalid when it is empty.
+  std::atomic<HybridTimeRepr> queue_front_{kInvalidHybridTimeValue};
+
+  // Odd while AddPending is assigning and adding the time of a new operation. Readers that
+  // observed a change of it could not rely on the time they read from the clock.
+  std::atomic<uint64_t> add_pending_version_{0};
+
+  std::atomic<HybridTimeRepr> last_replicated_{kMinHybridTimeValue};
 
   // If we are a follower, this is the latest safe time sent by the leader to us. If we are the
   // leader, this is a safe time that gets updated every time the majority-replicated watermarks
   // change.
-  HybridTime propagated_safe_time_ = HybridTime::kMin;
+  std::atomic<HybridTimeRepr> propagated_safe_time_{kMinHybridTimeValue};
 
   // Because different calls that have current hybrid time leader lease as an argument can come to
   // us out of order, we might see an older value of hybrid time leader lease expiration after a
   // newer value. We mitigate this by always using the highest value we've seen.
-  mutable HybridTime max_ht_lease_seen_ = HybridTime::kMin;
+  mutable std::atomic<HybridTimeRepr> max_ht_lease_seen_{kMinHybridTimeValue};
 
-  mutable SafeTimeWithSource max_safe_time_returned_with_lease_;
-  mutable SafeTimeWithSource max_safe_time_returned_without_lease_;
-  mutable SafeTimeWithSource max_safe_time_returned_for_follower_ { HybridTime::kMin };
+  mutable AtomicSafeTimeWithSource max_safe_time_returned_with_lease_;
+  mutable AtomicSafeTimeWithSource max_safe_time_returned_without_lease_;
+  mutable AtomicSafeTimeWithSource max_safe_time_returned_for_follower_;
 };
 
 }  // namespace tablet
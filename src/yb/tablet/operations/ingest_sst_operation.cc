@@ -0,0 +1,72 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/tablet/operations/ingest_sst_operation.h"
+
+#include <glog/logging.h>
+
+#include "yb/consensus/consensus.h"
+#include "yb/server/hybrid_clock.h"
+#include "yb/tablet/tablet.h"
+#include "yb/tserver/tserver.pb.h"
+#include "yb/util/trace.h"
+
+namespace yb {
+namespace tablet {
+
+using consensus::ReplicateMsg;
+using consensus::INGEST_SST_OP;
+using strings::Substitute;
+
+void IngestSstOperationState::UpdateRequestFromConsensusRound() {
+  request_ = consensus_round()->replicate_msg()->mutable_ingest_sst_request();
+}
+
+string IngestSstOperationState::ToString() const {
+  return Format("IngestSstOperationState [hybrid_time=$0, file_path=$1]",
+                hybrid_time_even_if_unset(), request_ ? request_->file_path() : "<none>");
+}
+
+IngestSstOperation::IngestSstOperation(std::unique_ptr<IngestSstOperationState> state)
+    : Operation(std::move(state), OperationType::kIngestSst) {
+}
+
+consensus::ReplicateMsgPtr IngestSstOperation::NewReplicateMsg() {
+  auto result = std::make_shared<ReplicateMsg>();
+  result->set_op_type(INGEST_SST_OP);
+  result->mutable_ingest_sst_request()->CopyFrom(*state()->request());
+  return result;
+}
+
+void IngestSstOperation::DoStart() {
+  state()->TrySetHybridTimeFromClock();
+
+  TRACE("START INGEST SST: hybrid time: $0",
+        server::HybridClock::GetPhysicalValueMicros(state()->hybrid_time()));
+}
+
+Status IngestSstOperation::Apply(int64_t leader_term) {
+  TRACE("APPLY INGEST SST: started");
+
+  RETURN_NOT_OK(state()->tablet()->IngestSstFile(state()));
+
+  TRACE("APPLY INGEST SST: finished");
+  return Status::OK();
+}
+
+string IngestSstOperation::ToString() const {
+  return Substitute("IngestSstOperation [state=$0]", state()->ToString());
+}
+
+}  // namespace tablet
+}  // namespace yb
@@ -0,0 +1,80 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#ifndef YB_TABLET_OPERATIONS_INGEST_SST_OPERATION_H
+#define YB_TABLET_OPERATIONS_INGEST_SST_OPERATION_H
+
+#include <string>
+
+#include "yb/gutil/macros.h"
+#include "yb/tablet/operations/operation.h"
+
+namespace yb {
+namespace tablet {
+
+// Operation Context for the IngestSst operation.
+// Keeps track of the Operation states (request, result, ...)
+class IngestSstOperationState : public OperationState {
+ public:
+  explicit IngestSstOperationState(Tablet* tablet,
+                                   const tserver::IngestSstFileRequestPB* request = nullptr)
+      : OperationState(tablet), request_(request) {}
+  ~IngestSstOperationState() {}
+
+  const tserver::IngestSstFileRequestPB* request() const override { return request_; }
+
+  void UpdateRequestFromConsensusRound() override;
+
+  virtual std::string ToString() const override;
+
+ private:
+  // The original RPC request.
+  const tserver::IngestSstFileRequestPB *request_;
+
+  DISALLOW_COPY_AND_ASSIGN(IngestSstOperationState);
+};
+
+// Adds an externally built SST file to the regular RocksDB of the tablet, replacing a replay of
+// the individual writes for large loads.
+class IngestSstOperation : public Operation {
+ public:
+  explicit IngestSstOperation(std::unique_ptr<IngestSstOperationState> operation_state);
+
+  IngestSstOperationState* state() override {
+    return down_cast<IngestSstOperationState*>(Operation::state());
+  }
+
+  const IngestSstOperationState* state() const override {
+    return down_cast<const IngestSstOperationState*>(Operation::state());
+  }
+
+  consensus::ReplicateMsgPtr NewReplicateMsg() override;
+
+  CHECKED_STATUS Prepare() override { return Status::OK(); }
+
+  // Executes an Apply for the ingest transaction.
+  CHECKED_STATUS Apply(int64_t leader_term) override;
+
+  std::string ToString() const override;
+
+ private:
+  // Starts the IngestSstOperation by assigning it a timestamp.
+  void DoStart() override;
+
+  DISALLOW_COPY_AND_ASSIGN(IngestSstOperation);
+};
+
+}  // namespace tablet
+}  // namespace yb
+
+#endif  // YB_TABLET_OPERATIONS_INGEST_SST_OPERATION_H
@@ -64,6 +64,12 @@ void OperationState::CompleteWithStatus(const Status& status) const {
   }
 }
 
+void OperationState::StageReached(OperationStage stage) const {
+  if (completion_clbk_) {
+    completion_clbk_->StageReached(stage);
+  }
+}
+
 void OperationState::SetError(const Status& status, tserver::TabletServerErrorPB::Code code) const {
   if (completion_clbk_) {
     completion_clbk_->set_error(status, code);
@@ -33,6 +33,7 @@
 #ifndef YB_TABLET_OPERATIONS_OPERATION_H
 #define YB_TABLET_OPERATIONS_OPERATION_H
 
+#include <functional>
 #include <mutex>
 #include <string>
 
@@ -57,7 +58,11 @@ class OperationCompletionCallback;
 class OperationState;
 
 YB_DEFINE_ENUM(OperationType,
-               (kWrite)(kChangeMetadata)(kUpdateTransaction)(kSnapshot)(kTruncate)(kEmpty));
+               (kWrite)(kChangeMetadata)(kUpdateTransaction)(kSnapshot)(kTruncate)(kIngestSst)
+               (kEmpty));
+
+// Stages of operation processing reported to OperationCompletionCallback.
+YB_DEFINE_ENUM(OperationStage, (kPrepared)(kReplicated)(kApplied));
 
 // Base class for transactions.  There are different implementations for different types (Write,
 // AlterSchema, etc.) OperationDriver implementations use Operations along with Consensus to execute
@@ -105,6 +110,14 @@ class Operation {
   // transaction type, but usually this is the method where data-structures are changed.
   virtual CHECKED_STATUS Apply(int64_t leader_term) = 0;
 
+  // Executes the Apply() phase and invokes applied once the changes of the transaction are made.
+  // Write operations could be applied together with the following ones, so applied could be
+  // invoked after this method returns, see Tablet::StartApplyGroup.
+  virtual void ApplyWithCallback(int64_t leader_term, std::function<void()> applied) {
+    CHECK_OK(Apply(leader_term));
+    applied();
+  }
+
   // Executed after the transaction has been applied and the commit message has been appended to the
   // log (though it might not be durable yet), or if the transaction was aborted.  Implementations
   // are expected to perform cleanup on this method, the driver will reply to the client after this
@@ -214,6 +227,7 @@ class OperationState {
   }
 
   void CompleteWithStatus(const Status& status) const;
+  void StageReached(OperationStage stage) const;
   void SetError(const Status& status, tserver::TabletServerErrorPB::Code code) const;
 
   virtual ~OperationState();
@@ -274,6 +288,9 @@ class OperationCompletionCallback {
   // Subclasses should override this.
   virtual void OperationCompleted() = 0;
 
+  // Invoked when the operation reaches the specified stage, could be used to track its latency.
+  virtual void StageReached(OperationStage stage) {}
+
   void CompleteWithStatus(const Status& status) {
     set_error(status);
     OperationCompleted();
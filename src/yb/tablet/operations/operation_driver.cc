@@ -220,6 +220,7 @@ Status OperationDriver::PrepareAndStart() {
   prepare_physical_hybrid_time_ = GetMonoTimeMicros();
   if (operation_) {
     RETURN_NOT_OK(operation_->Prepare());
+    operation_->state()->StageReached(OperationStage::kPrepared);
   }
 
   // Only take the lock long enough to take a local copy of the
@@ -373,6 +374,10 @@ void OperationDriver::ReplicationFinished(const Status& status, int64_t leader_t
     prepare_state_copy = prepare_state_;
   }
 
+  if (status.ok()) {
+    mutable_state()->StageReached(OperationStage::kReplicated);
+  }
+
   // If we have prepared and replicated, we're ready to move ahead and apply this operation.
   // Note that if we set the state to REPLICATION_FAILED above, ApplyOperation() will actually abort
   // the operation, i.e. ApplyTask() will never be called and the operation will never be applied to
@@ -445,16 +450,15 @@ void OperationDriver::ApplyTask(int64_t leader_term) {
   // and end up calling Finalize() while we're still in this code.
   scoped_refptr<OperationDriver> ref(this);
 
-  {
-    CHECK_OK(operation_->Apply(leader_term));
-
-    Finalize();
-  }
+  operation_->ApplyWithCallback(leader_term, [ref] {
+    ref->Finalize();
+  });
 }
 
 void OperationDriver::Finalize() {
   ADOPT_TRACE(trace());
 
+  mutable_state()->StageReached(OperationStage::kApplied);
   operation_->Finish(Operation::COMMITTED);
   mutable_state()->CompleteWithStatus(Status::OK());
   operation_tracker_->Release(this);
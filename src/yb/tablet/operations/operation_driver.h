@@ -90,7 +90,9 @@ class Preparer;
 //
 //      If Prepare() has already completed, then we trigger ApplyAsync().
 //
-//  5 - ApplyOperation() calls ApplyTask(), which then calls operation_->Apply().
+//  5 - ApplyOperation() calls ApplyTask(), which then calls operation_->ApplyWithCallback().
+//      Consecutive write operations could be applied together, in which case the next step is
+//      only executed once the whole group is written.
 //
 //      When operation_->Apply() is called, changes are made to the in-memory data structures. These
 //      changes are not visible to clients yet.
@@ -104,10 +104,7 @@ void WriteOperation::DoStart() {
   state()->tablet()->StartOperation(state());
 }
 
-// FIXME: Since this is called as a void in a thread-pool callback,
-// it seems pointless to return a Status!
-Status WriteOperation::Apply(int64_t leader_term) {
-  TRACE_EVENT0("txn", "WriteOperation::Apply");
+void WriteOperation::StartApply() {
   TRACE("APPLY: Starting");
 
   if (PREDICT_FALSE(
@@ -118,14 +115,26 @@ Status WriteOperation::Apply(int64_t leader_term) {
   } else {
     TEST_PAUSE_IF_FLAG(tablet_pause_apply_write_ops);
   }
+}
 
-  Tablet* tablet = state()->tablet();
+// FIXME: Since this is called as a void in a thread-pool callback,
+// it seems pointless to return a Status!
+Status WriteOperation::Apply(int64_t leader_term) {
+  TRACE_EVENT0("txn", "WriteOperation::Apply");
+  StartApply();
 
-  tablet->ApplyRowOperations(state());
+  state()->tablet()->ApplyRowOperations(state());
 
   return Status::OK();
 }
 
+void WriteOperation::ApplyWithCallback(int64_t leader_term, std::function<void()> applied) {
+  TRACE_EVENT0("txn", "WriteOperation::ApplyWithCallback");
+  StartApply();
+
+  state()->tablet()->ApplyRowOperations(state(), std::move(applied));
+}
+
 void WriteOperation::Finish(OperationResult result) {
   TRACE_EVENT0("txn", "WriteOperation::Finish");
   if (PREDICT_FALSE(result == Operation::ABORTED)) {
@@ -242,6 +242,10 @@ class WriteOperation : public Operation {
   // algorithm.
   CHECKED_STATUS Apply(int64_t leader_term) override;
 
+  // Same as Apply, but the write could be added to the apply group of the tablet, see
+  // Tablet::StartApplyGroup.
+  void ApplyWithCallback(int64_t leader_term, std::function<void()> applied) override;
+
   // If result == COMMITTED, commits the mvcc transaction and updates
   // the metrics, if result == ABORTED aborts the mvcc transaction.
   void Finish(OperationResult result) override;
@@ -287,6 +291,8 @@ class WriteOperation : public Operation {
   void DoStart() override;
   void DoStartSynchronization(const Status& status);
 
+  void StartApply();
+
   WriteOperationContext& context_;
   const int64_t term_;
   const CoarseTimePoint deadline_;
@@ -23,12 +23,33 @@
 #include "yb/consensus/consensus.h"
 #include "yb/tablet/preparer.h"
 #include "yb/tablet/operations/operation_driver.h"
+#include "yb/util/flag_tags.h"
 #include "yb/util/logging.h"
+#include "yb/util/metrics.h"
 #include "yb/util/threadpool.h"
 #include "yb/util/lockfree.h"
 
-DEFINE_int32(max_group_replicate_batch_size, 16,
+DEFINE_int32(max_group_replicate_batch_size, 64,
              "Maximum number of operations to submit to consensus for replication in a batch.");
+DEFINE_int64(max_group_replicate_batch_bytes, 1024 * 1024,
+             "Maximum total size of requests of operations to submit to consensus for replication "
+             "in a batch. An operation that is bigger than this is replicated in a batch of its "
+             "own.");
+TAG_FLAG(max_group_replicate_batch_bytes, advanced);
+TAG_FLAG(max_group_replicate_batch_bytes, runtime);
+
+METRIC_DEFINE_histogram(tablet, replicate_batch_num_ops,
+                        "Replicate Batch Number of Operations",
+                        yb::MetricUnit::kOperations,
+                        "Number of leader-side operations submitted to consensus for replication "
+                        "in a batch.",
+                        100000LU, 2);
+METRIC_DEFINE_histogram(tablet, replicate_batch_bytes,
+                        "Replicate Batch Size",
+                        yb::MetricUnit::kBytes,
+                        "Total size of requests of leader-side operations submitted to consensus "
+                        "for replication in a batch.",
+                        1024LU * 1024 * 1024, 2);
 
 using std::vector;
 
@@ -43,7 +64,8 @@ namespace tablet {
 
 class PreparerImpl {
  public:
-  explicit PreparerImpl(consensus::Consensus* consensus, ThreadPool* tablet_prepare_pool);
+  PreparerImpl(consensus::Consensus* consensus, ThreadPool* tablet_prepare_pool,
+               const scoped_refptr<MetricEntity>& metric_entity);
   ~PreparerImpl();
   CHECKED_STATUS Start();
   void Stop();
@@ -87,6 +109,11 @@ class PreparerImpl {
   std::condition_variable stop_cond_;
 
   OperationDrivers leader_side_batch_;
+  // Total size of requests of operations in leader_side_batch_.
+  int64_t leader_side_batch_bytes_ = 0;
+
+  scoped_refptr<Histogram> batch_num_ops_;
+  scoped_refptr<Histogram> batch_bytes_;
 
   std::unique_ptr<ThreadPoolToken> tablet_prepare_pool_token_;
 
@@ -106,10 +133,15 @@ class PreparerImpl {
 };
 
 PreparerImpl::PreparerImpl(consensus::Consensus* consensus,
-                                     ThreadPool* tablet_prepare_pool)
+                           ThreadPool* tablet_prepare_pool,
+                           const scoped_refptr<MetricEntity>& metric_entity)
     : consensus_(consensus),
       tablet_prepare_pool_token_(tablet_prepare_pool
                                      ->NewToken(ThreadPool::ExecutionMode::SERIAL)) {
+  if (metric_entity) {
+    batch_num_ops_ = METRIC_replicate_batch_num_ops.Instantiate(metric_entity);
+    batch_bytes_ = METRIC_replicate_batch_bytes.Instantiate(metric_entity);
+  }
 }
 
 PreparerImpl::~PreparerImpl() {
@@ -195,16 +227,21 @@ void PreparerImpl::ProcessItem(OperationDriver* item) {
     const bool apply_separately = operation_type == OperationType::kChangeMetadata ||
                                   operation_type == OperationType::kEmpty;
     const int64_t bound_term = apply_separately ? -1 : item->consensus_round()->bound_term();
+    const int64_t item_bytes = item->SpaceUsed();
 
-    // Don't add more than the max number of operations to a batch, and also don't add
+    // Don't add more than the max number of operations or bytes to a batch, and also don't add
     // operations bound to different terms, so as not to fail unrelated operations
     // unnecessarily in case of a bound term mismatch.
-    if (leader_side_batch_.size() >= FLAGS_max_group_replicate_batch_size ||
-        (!leader_side_batch_.empty() &&
-            bound_term != leader_side_batch_.back()->consensus_round()->bound_term())) {
+    // A batch is also replicated as soon as the queue is drained, see Run, so the batch size
+    // follows the depth of the queue and the limits only matter under high load.
+    if (!leader_side_batch_.empty() &&
+        (leader_side_batch_.size() >= FLAGS_max_group_replicate_batch_size ||
+         leader_side_batch_bytes_ + item_bytes > FLAGS_max_group_replicate_batch_bytes ||
+         bound_term != leader_side_batch_.back()->consensus_round()->bound_term())) {
       ProcessAndClearLeaderSideBatch();
     }
     leader_side_batch_.push_back(item);
+    leader_side_batch_bytes_ += item_bytes;
     if (apply_separately) {
       ProcessAndClearLeaderSideBatch();
     }
@@ -221,7 +258,12 @@ void PreparerImpl::ProcessAndClearLeaderSideBatch() {
     return;
   }
 
-  VLOG(2) << "Preparing a batch of " << leader_side_batch_.size() << " leader-side operations";
+  VLOG(2) << "Preparing a batch of " << leader_side_batch_.size() << " leader-side operations, "
+          << leader_side_batch_bytes_ << " bytes";
+  if (batch_num_ops_) {
+    batch_num_ops_->Increment(leader_side_batch_.size());
+    batch_bytes_->Increment(leader_side_batch_bytes_);
+  }
 
   auto iter = leader_side_batch_.begin();
   auto replication_subbatch_begin = iter;
@@ -253,6 +295,7 @@ void PreparerImpl::ProcessAndClearLeaderSideBatch() {
   ReplicateSubBatch(replication_subbatch_begin, replication_subbatch_end);
 
   leader_side_batch_.clear();
+  leader_side_batch_bytes_ = 0;
 }
 
 void PreparerImpl::ReplicateSubBatch(
@@ -295,8 +338,9 @@ void PreparerImpl::ReplicateSubBatch(
 // ------------------------------------------------------------------------------------------------
 // Preparer
 
-Preparer::Preparer(consensus::Consensus* consensus, ThreadPool* tablet_prepare_thread)
-    : impl_(std::make_unique<PreparerImpl>(consensus, tablet_prepare_thread)) {
+Preparer::Preparer(consensus::Consensus* consensus, ThreadPool* tablet_prepare_thread,
+                   const scoped_refptr<MetricEntity>& metric_entity)
+    : impl_(std::make_unique<PreparerImpl>(consensus, tablet_prepare_thread, metric_entity)) {
 }
 
 Preparer::~Preparer() = default;
@@ -16,13 +16,17 @@
 
 #include <gflags/gflags.h>
 
+#include "yb/gutil/ref_counted.h"
+
 #include "yb/util/status.h"
 #include "yb/util/threadpool.h"
 
 DECLARE_int32(max_group_replicate_batch_size);
+DECLARE_int64(max_group_replicate_batch_bytes);
 DECLARE_int32(prepare_queue_max_size);
 
 namespace yb {
+class MetricEntity;
 class ThreadPool;
 
 namespace consensus {
@@ -41,7 +45,9 @@ class PreparerImpl;
 // Preparer does not manage a thread but only submits to a token in a thread pool.
 class Preparer {
  public:
-  explicit Preparer(consensus::Consensus* consensus, ThreadPool* tablet_prepare_pool);
+  // metric_entity is used to export sizes of replicated batches, could be null.
+  Preparer(consensus::Consensus* consensus, ThreadPool* tablet_prepare_pool,
+           const scoped_refptr<MetricEntity>& metric_entity);
   ~Preparer();
 
   CHECKED_STATUS Start();
@@ -32,6 +32,8 @@
 
 #include <time.h>
 
+#include <set>
+
 #include <glog/logging.h>
 
 #include "yb/common/row.h"
@@ -42,6 +44,8 @@
 #include "yb/tablet/local_tablet_writer.h"
 #include "yb/tablet/tablet.h"
 #include "yb/tablet/tablet-test-base.h"
+#include "yb/util/path_util.h"
+#include "yb/util/pb_util.h"
 #include "yb/util/slice.h"
 #include "yb/util/test_macros.h"
 
@@ -212,5 +216,74 @@ TYPED_TEST(TestTablet, TestFlushedOpId) {
   ASSERT_EQ(id.index, start_index + 2*kCount);
 }
 
+TYPED_TEST(TestTablet, Hibernate) {
+  auto tablet = this->tablet().get();
+  LocalTabletWriter writer(tablet);
+  ASSERT_OK(this->InsertTestRow(&writer, 0, 0));
+  ASSERT_OK(this->InsertTestRow(&writer, 1, 0));
+
+  // Not idle for long enough.
+  ASSERT_FALSE(ASSERT_RESULT(tablet->Hibernate(std::chrono::hours(1))));
+  ASSERT_FALSE(tablet->hibernated());
+
+  ASSERT_TRUE(ASSERT_RESULT(tablet->Hibernate(CoarseDuration::zero())));
+  ASSERT_TRUE(tablet->hibernated());
+  // Unflushed rows were flushed before RocksDB was closed.
+  const auto op_ids = ASSERT_RESULT(tablet->MaxPersistentOpId());
+  ASSERT_GT(op_ids.regular.index, 0);
+  ASSERT_GT(tablet->GetTotalSSTFileSizes(), 0);
+
+  ASSERT_OK(tablet->WakeUpIfHibernated());
+  ASSERT_FALSE(tablet->hibernated());
+  ASSERT_EQ(op_ids.regular, ASSERT_RESULT(tablet->MaxPersistentOpId()).regular);
+
+  ASSERT_OK(this->UpdateTestRow(&writer, 1, 1));
+  vector<string> out_rows;
+  ASSERT_OK(this->IterateToStringList(&out_rows));
+  ASSERT_EQ(2, out_rows.size());
+  ASSERT_EQ(this->setup_.FormatDebugRow(0, 0, false), out_rows[0]);
+  ASSERT_EQ(this->setup_.FormatDebugRow(1, 1, false), out_rows[1]);
+}
+
+TYPED_TEST(TestTablet, CheckpointManifest) {
+  auto tablet = this->tablet().get();
+  this->InsertTestRows(0, 100, 0);
+  ASSERT_OK(tablet->Flush(FlushMode::kSync));
+
+  const auto first_dir = this->GetTestPath("checkpoint1");
+  ASSERT_OK(tablet->CreateCheckpoint(first_dir));
+  CheckpointManifestPB first_manifest;
+  ASSERT_OK(pb_util::ReadPBContainerFromPath(
+      Env::Default(), JoinPathSegments(first_dir, kCheckpointManifestFileName), &first_manifest));
+  std::set<std::string> first_ids;
+  for (const auto& file : first_manifest.files()) {
+    ASSERT_TRUE(Env::Default()->FileExists(JoinPathSegments(first_dir, file.name())));
+    if (file.has_file_id()) {
+      first_ids.insert(file.file_id());
+    }
+  }
+  ASSERT_FALSE(first_ids.empty());
+
+  this->InsertTestRows(100, 100, 0);
+  ASSERT_OK(tablet->Flush(FlushMode::kSync));
+
+  // The SST files of the first checkpoint have the same ids in the second one.
+  const auto second_dir = this->GetTestPath("checkpoint2");
+  ASSERT_OK(tablet->CreateCheckpoint(second_dir));
+  CheckpointManifestPB second_manifest;
+  ASSERT_OK(pb_util::ReadPBContainerFromPath(
+      Env::Default(), JoinPathSegments(second_dir, kCheckpointManifestFileName),
+      &second_manifest));
+  size_t num_unchanged = 0;
+  size_t num_new = 0;
+  for (const auto& file : second_manifest.files()) {
+    if (file.has_file_id()) {
+      ++(first_ids.count(file.file_id()) ? num_unchanged : num_new);
+    }
+  }
+  ASSERT_EQ(first_ids.size(), num_unchanged);
+  ASSERT_GT(num_new, 0);
+}
+
 } // namespace tablet
 } // namespace yb
@@ -38,6 +38,7 @@
 #include <memory>
 #include <mutex>
 #include <ostream>
+#include <thread>
 #include <unordered_set>
 #include <utility>
 #include <vector>
@@ -48,6 +49,7 @@
 #include "yb/rocksdb/db.h"
 #include "yb/rocksdb/db/memtable.h"
 #include "yb/rocksdb/options.h"
+#include "yb/rocksdb/sst_file_writer.h"
 #include "yb/rocksdb/statistics.h"
 #include "yb/rocksdb/utilities/checkpoint.h"
 #include "yb/rocksdb/write_batch.h"
@@ -58,6 +60,7 @@
 
 #include "yb/common/common.pb.h"
 #include "yb/common/hybrid_time.h"
+#include "yb/common/partition.h"
 #include "yb/common/schema.h"
 #include "yb/common/ql_protocol.pb.h"
 #include "yb/common/ql_rowblock.h"
@@ -74,6 +77,7 @@
 #include "yb/docdb/docdb.h"
 #include "yb/docdb/docdb.pb.h"
 #include "yb/docdb/docdb_compaction_filter.h"
+#include "yb/docdb/docdb_util.h"
 #include "yb/docdb/docdb_compaction_filter_intents.h"
 #include "yb/docdb/docdb_rocksdb_util.h"
 #include "yb/docdb/intent.h"
@@ -83,10 +87,12 @@
 #include "yb/docdb/redis_operation.h"
 
 #include "yb/gutil/atomicops.h"
+#include "yb/gutil/endian.h"
 #include "yb/gutil/map-util.h"
 #include "yb/gutil/stl_util.h"
 #include "yb/gutil/strings/numbers.h"
 #include "yb/gutil/strings/substitute.h"
+#include "yb/rocksdb/db/filename.h"
 #include "yb/rocksutil/yb_rocksdb.h"
 #include "yb/rocksutil/yb_rocksdb_logger.h"
 #include "yb/server/hybrid_clock.h"
@@ -97,6 +103,7 @@
 #include "yb/tablet/transaction_coordinator.h"
 #include "yb/tablet/transaction_participant.h"
 #include "yb/tablet/operations/change_metadata_operation.h"
+#include "yb/tablet/operations/ingest_sst_operation.h"
 #include "yb/tablet/operations/truncate_operation.h"
 #include "yb/tablet/operations/write_operation.h"
 #include "yb/tablet/tablet_options.h"
@@ -109,6 +116,8 @@
 #include "yb/util/locks.h"
 #include "yb/util/mem_tracker.h"
 #include "yb/util/metrics.h"
+#include "yb/util/path_util.h"
+#include "yb/util/pb_util.h"
 #include "yb/util/slice.h"
 #include "yb/util/stopwatch.h"
 #include "yb/util/trace.h"
@@ -146,6 +155,57 @@ DEFINE_int32(intents_flush_max_delay_ms, 2000,
              "Max time to wait for regular db to flush during flush of intents. "
              "After this time flush of regular db will be forced.");
 
+DEFINE_int64(rocksdb_cold_data_age_threshold_sec, 7 * 24 * 3600,
+             "Compaction outputs whose newest hybrid time is older than this are placed into "
+             "--rocksdb_cold_data_dir, when it is specified.");
+TAG_FLAG(rocksdb_cold_data_age_threshold_sec, advanced);
+TAG_FLAG(rocksdb_cold_data_age_threshold_sec, runtime);
+
+DEFINE_int32(tablet_compaction_history_size, 32,
+             "Number of recent flushes and compactions of each tablet to keep for the "
+             "/tablet-compactions page.");
+
+DEFINE_int32(max_group_apply_batch_size, 16,
+             "Maximum number of consecutive replicated write operations of a tablet that are "
+             "written to RocksDB with a single write. 1 to write each operation separately.");
+TAG_FLAG(max_group_apply_batch_size, advanced);
+TAG_FLAG(max_group_apply_batch_size, runtime);
+
+DEFINE_int32(txn_max_apply_batch_records, 100000,
+             "Maximum number of intents of a transaction applied or removed with a single "
+             "RocksDB write.");
+TAG_FLAG(txn_max_apply_batch_records, advanced);
+TAG_FLAG(txn_max_apply_batch_records, runtime);
+
+DEFINE_int32(write_throttle_l0_files_start, 20,
+             "Number of SST files in the regular RocksDB of a tablet at which writes to it start "
+             "being rejected with a retry-after hint. The share of rejected writes grows linearly "
+             "up to all of them at --rocksdb_level0_stop_writes_trigger, where RocksDB would stall "
+             "writes. 0 to disable.");
+TAG_FLAG(write_throttle_l0_files_start, advanced);
+TAG_FLAG(write_throttle_l0_files_start, runtime);
+
+DECLARE_int32(rocksdb_level0_stop_writes_trigger);
+
+DEFINE_int32(backfill_index_rows_per_chunk, 10000,
+             "Maximum number of rows of a tablet whose entries are written into new indexes by a "
+             "single backfill RPC. The master continues the backfill from where the RPC stopped, "
+             "and logs the progress after each of them.");
+TAG_FLAG(backfill_index_rows_per_chunk, advanced);
+TAG_FLAG(backfill_index_rows_per_chunk, runtime);
+
+DEFINE_int32(backfill_index_write_batch_size, 128,
+             "Number of rows whose index entries are written with a single flush of the session "
+             "during index backfill.");
+TAG_FLAG(backfill_index_write_batch_size, advanced);
+TAG_FLAG(backfill_index_write_batch_size, runtime);
+
+DEFINE_int32(backfill_index_rate_rows_per_sec, 10000,
+             "Maximum number of rows per second whose entries are written into new indexes by "
+             "the backfill of a tablet. 0 for no limit.");
+TAG_FLAG(backfill_index_rate_rows_per_sec, advanced);
+TAG_FLAG(backfill_index_rate_rows_per_sec, runtime);
+
 DEFINE_test_flag(
     bool, tablet_verify_flushed_frontier_after_modifying, false,
     "After modifying the flushed frontier in RocksDB, verify that the restored value of it "
@@ -174,6 +234,7 @@ using yb::docdb::RedisWriteOperation;
 using yb::docdb::QLWriteOperation;
 using yb::docdb::PgsqlWriteOperation;
 using yb::docdb::DocDBCompactionFilterFactory;
+using yb::docdb::DocDBCompactionFileFilterFactory;
 using yb::docdb::InitMarkerBehavior;
 
 namespace yb {
@@ -292,6 +353,36 @@ CHECKED_STATUS EmitRocksDbMetricsAsPrometheus(
   return Status::OK();
 }
 
+// Hash partition keys are the big endian hash codes that follow kUInt16Hash in encoded DocKeys.
+void AppendHashBound(const std::string& partition_key, docdb::KeyBytes* bound) {
+  if (!partition_key.empty()) {
+    bound->AppendValueType(docdb::ValueType::kUInt16Hash);
+    bound->AppendRawBytes(partition_key);
+  }
+}
+
+// Returns the bounds of the keys a tablet owns according to its partition. Only hash partitioned
+// user tables are bounded.
+docdb::KeyBounds TabletKeyBounds(const TabletMetadata& metadata) {
+  docdb::KeyBounds result;
+  if (metadata.table_type() == TableType::TRANSACTION_STATUS_TABLE_TYPE ||
+      !metadata.partition_schema().IsHashPartitioning()) {
+    return result;
+  }
+  AppendHashBound(metadata.partition().partition_key_start(), &result.lower);
+  AppendHashBound(metadata.partition().partition_key_end(), &result.upper);
+  return result;
+}
+
+Result<uint16_t> DecodeHashCode(const std::string& key) {
+  Slice slice(key);
+  if (slice.size() < 1 + sizeof(uint16_t) ||
+      docdb::DecodeValueType(slice) != docdb::ValueType::kUInt16Hash) {
+    return STATUS_FORMAT(Corruption, "Key without hash code: $0", slice.ToDebugHexString());
+  }
+  return BigEndian::Load16(slice.data() + 1);
+}
+
 } // namespace
 
 string DocDbOpIds::ToString() const {
@@ -322,7 +413,8 @@ Tablet::Tablet(
       tablet_options_(tablet_options),
       client_future_(client_future),
       local_tablet_filter_(std::move(local_tablet_filter)),
-      log_prefix_suffix_(std::move(log_prefix_suffix)) {
+      log_prefix_suffix_(std::move(log_prefix_suffix)),
+      key_bounds_(TabletKeyBounds(*metadata)) {
   CHECK(schema()->has_column_ids());
 
   if (metric_registry) {
@@ -342,7 +434,7 @@ Tablet::Tablet(
     });
 
     metric_entity_->AddExternalPrometheusMetricsCb(
-        [rocksdb_statistics, attrs](PrometheusWriter* pw) {
+        [rocksdb_statistics](PrometheusWriter* pw, const MetricEntity::AttributeMap& attrs) {
       auto s = EmitRocksDbMetricsAsPrometheus(rocksdb_statistics, pw, attrs);
       if (!s.ok()) {
         YB_LOG_EVERY_N(WARNING, 100) << "Failed to get Prometheus metrics: " << s.ToString();
@@ -356,7 +448,7 @@ Tablet::Tablet(
 
   if (transaction_participant_context && metadata->schema().table_properties().is_transactional()) {
     transaction_participant_ = std::make_unique<TransactionParticipant>(
-        transaction_participant_context, this);
+        transaction_participant_context, this, metric_entity_);
     // Create transaction manager for secondary index update.
     if (!metadata_->index_map().empty()) {
       transaction_manager_.emplace(client_future_.get(),
@@ -388,6 +480,12 @@ Tablet::Tablet(
 
   flush_stats_ = make_shared<TabletFlushStats>();
   tablet_options_.listeners.emplace_back(flush_stats_);
+  compaction_history_ = make_shared<TabletCompactionHistory>(
+      FLAGS_tablet_compaction_history_size,
+      metrics_ ? metrics_->rocksdb_write_amplification : nullptr,
+      metrics_ ? metrics_->rocksdb_reclaimable_entries : nullptr,
+      metrics_ ? metrics_->rocksdb_reclaimable_ratio : nullptr);
+  tablet_options_.listeners.emplace_back(compaction_history_);
 }
 
 Tablet::~Tablet() {
@@ -485,12 +583,26 @@ std::string Tablet::LogPrefix() const {
 Status Tablet::OpenKeyValueTablet() {
   rocksdb::Options rocksdb_options;
   docdb::InitRocksDBOptions(&rocksdb_options, LogPrefix(), rocksdb_statistics_, tablet_options_);
+  // Intent keys are not plain DocKeys, so only bloom filters of the regular DB use range
+  // components.
+  auto intents_table_factory = rocksdb_options.table_factory;
+  const size_t bloom_filter_range_components =
+      docdb::BloomFilterRangeComponents(metadata()->schema());
+  if (bloom_filter_range_components != 0) {
+    rocksdb_options.table_factory = docdb::NewDocDBTableFactory(
+        tablet_options_, rocksdb_options.info_log.get(), bloom_filter_range_components);
+  }
   rocksdb_options.mem_tracker = MemTracker::FindOrCreateTracker("RegularDB", mem_tracker_);
 
   // Install the history cleanup handler. Note that TabletRetentionPolicy is going to hold a raw ptr
   // to this tablet. So, we ensure that rocksdb_ is reset before this tablet gets destroyed.
+  auto retention_policy = make_shared<TabletRetentionPolicy>(this);
   rocksdb_options.compaction_filter_factory = make_shared<DocDBCompactionFilterFactory>(
-      make_shared<TabletRetentionPolicy>(this));
+      retention_policy, key_bounds_);
+  rocksdb_options.compaction_file_filter_factory =
+      make_shared<DocDBCompactionFileFilterFactory>(retention_policy);
+  rocksdb_options.table_properties_collector_factories.push_back(
+      make_shared<docdb::DocDBTablePropertiesCollectorFactory>(retention_policy));
 
   rocksdb_options.mem_table_flush_filter_factory = MakeMemTableFlushFilterFactory([this] {
     if (mem_table_flush_filter_factory_) {
@@ -504,6 +616,30 @@ Status Tablet::OpenKeyValueTablet() {
   const string db_dir = metadata()->rocksdb_dir();
   RETURN_NOT_OK(CreateTabletDirectories(db_dir, metadata()->fs_manager()));
 
+  const string cold_db_dir = metadata()->cold_rocksdb_dir();
+  if (!cold_db_dir.empty()) {
+    RETURN_NOT_OK_PREPEND(metadata()->fs_manager()->env()->CreateDirs(cold_db_dir),
+                          Format("Failed to create RocksDB cold data directory $0", cold_db_dir));
+    // Flushes always go to the first path, compactions move old enough data to the cold one.
+    rocksdb_options.db_paths = {
+        {db_dir, std::numeric_limits<uint64_t>::max()},
+        {cold_db_dir, std::numeric_limits<uint64_t>::max()}};
+    rocksdb_options.compaction_output_path_selector =
+        std::make_shared<rocksdb::CompactionOutputPathSelector>(
+            [clock = clock_](const rocksdb::UserFrontier* largest, uint32_t picked_path_id) {
+      if (!largest || !clock) {
+        return picked_path_id;
+      }
+      const auto hybrid_time = down_cast<const docdb::ConsensusFrontier*>(largest)->hybrid_time();
+      if (!hybrid_time.is_valid()) {
+        return picked_path_id;
+      }
+      const int64_t age_us = clock->Now().PhysicalDiff(hybrid_time);
+      return age_us >= FLAGS_rocksdb_cold_data_age_threshold_sec * MonoTime::kMicrosecondsPerSecond
+          ? 1U : picked_path_id;
+    });
+  }
+
   LOG(INFO) << "Opening RocksDB at: " << db_dir;
   rocksdb::DB* db = nullptr;
   rocksdb::Status rocksdb_open_status = rocksdb::DB::Open(rocksdb_options, db_dir, &db);
@@ -523,6 +659,12 @@ Status Tablet::OpenKeyValueTablet() {
       return std::bind(&Tablet::IntentsDbFlushFilter, this, _1);
     });
     rocksdb_options.listeners.clear();
+    // Intents are short-lived, so they are always kept in the tablet data directory.
+    rocksdb_options.db_paths.clear();
+    rocksdb_options.compaction_output_path_selector = nullptr;
+    rocksdb_options.compaction_file_filter_factory = nullptr;
+    rocksdb_options.table_properties_collector_factories.clear();
+    rocksdb_options.table_factory = intents_table_factory;
 
     rocksdb_options.compaction_filter_factory =
         FLAGS_tablet_do_compaction_cleanup_for_intents ?
@@ -535,13 +677,40 @@ Status Tablet::OpenKeyValueTablet() {
     intents_db_.reset(intents_db);
   }
 
-  ql_storage_.reset(new docdb::QLRocksDBStorage({regular_db_.get(), intents_db_.get()}));
+  auto regular_flushed_frontier = regular_db_->GetFlushedFrontier();
+
+  if (docdb::DocRowCache::Enabled()) {
+    // Rows are only cached by reads that are not earlier than the records already in RocksDB.
+    auto min_read_time = clock_ ? clock_->Now() : HybridTime::kMin;
+    if (regular_flushed_frontier) {
+      min_read_time.MakeAtLeast(
+          static_cast<const docdb::ConsensusFrontier&>(*regular_flushed_frontier).hybrid_time());
+    }
+    row_cache_ = std::make_unique<docdb::DocRowCache>(mem_tracker_, min_read_time);
+  } else {
+    row_cache_.reset();
+  }
+
+  intent_index_.reset();
+  if (intents_db_ && docdb::IntentIndex::Enabled()) {
+    auto intent_index = std::make_unique<docdb::IntentIndex>(mem_tracker_);
+    RETURN_NOT_OK_PREPEND(intent_index->Load(intents_db_.get()), "Failed to load intent index");
+    intent_index_ = std::move(intent_index);
+  }
+
+  if (docdb::QLScanCursors::Enabled()) {
+    scan_cursors_ = std::make_unique<docdb::QLScanCursors>();
+  } else {
+    scan_cursors_.reset();
+  }
+
+  ql_storage_.reset(new docdb::QLRocksDBStorage(
+      {regular_db_.get(), intents_db_.get(), row_cache_.get()}));
   if (transaction_participant_) {
     transaction_participant_->SetDB(intents_db_.get());
   }
 
   // Don't allow reads at timestamps lower than the highest history cutoff of a past compaction.
-  auto regular_flushed_frontier = regular_db_->GetFlushedFrontier();
   if (regular_flushed_frontier) {
     const auto& regular_flushed_largest =
         static_cast<const docdb::ConsensusFrontier&>(*regular_flushed_frontier);
@@ -590,6 +759,8 @@ void Tablet::SetShutdownRequestedFlag() {
 
 void Tablet::Shutdown() {
   SetShutdownRequestedFlag();
+  // Reads waiting for safe time hold the tablet, and would not be woken up anymore.
+  mvcc_.AbortSafeTimeWaiters();
 
   auto op_pause = PauseReadWriteOperations();
   if (!op_pause.ok()) {
@@ -605,6 +776,8 @@ void Tablet::Shutdown() {
   // Shutdown the RocksDB instance for this table, if present.
   // Destroy intents and regular DBs in reverse order to their creation.
   // Also it makes sure that regular DB is alive during flush filter of intents db.
+  // Open scans are closed first, since they read both DBs.
+  scan_cursors_.reset();
   intents_db_.reset();
   regular_db_.reset();
   state_ = kShutdown;
@@ -623,6 +796,10 @@ Result<std::unique_ptr<common::YQLRowwiseIteratorIf>> Tablet::NewRowIterator(
     return STATUS_FORMAT(IllegalState, "Tablet in wrong state: $0", state_);
   }
 
+  if (hibernated()) {
+    return STATUS(IllegalState, "Tablet is hibernated");
+  }
+
   if (table_type_ != TableType::YQL_TABLE_TYPE && table_type_ != TableType::PGSQL_TABLE_TYPE) {
     return STATUS_FORMAT(NotSupported, "Invalid table type: $0", table_type_);
   }
@@ -653,6 +830,117 @@ Result<std::unique_ptr<common::YQLRowwiseIteratorIf>> Tablet::NewRowIterator(
   return NewRowIterator(table_info->schema, boost::none, table_id);
 }
 
+namespace {
+
+// Flushes the session, returning the first error of its operations if any.
+Status FlushIndexSession(const client::YBSessionPtr& session) {
+  auto status = session->Flush();
+  if (status.IsIOError()) {
+    for (const auto& error : session->GetPendingErrors()) {
+      return error->status();
+    }
+  }
+  return status;
+}
+
+} // namespace
+
+Result<std::string> Tablet::BackfillIndexes(
+    const std::vector<TableId>& index_ids, HybridTime read_time, const std::string& start_key,
+    CoarseTimePoint deadline, size_t* num_rows) {
+  *num_rows = 0;
+  if (state_ != kOpen) {
+    return STATUS_FORMAT(IllegalState, "Tablet in wrong state: $0", state_);
+  }
+  if (table_type_ != TableType::YQL_TABLE_TYPE) {
+    return STATUS_FORMAT(NotSupported, "Index backfill is not supported for $0", table_type_);
+  }
+  if (!metadata_cache_) {
+    return STATUS(Corruption, "Table metadata cache is not present for index backfill");
+  }
+
+  // Rows written at or before read_time should be visible to the scan.
+  if (!SafeTime(RequireLease::kTrue, read_time, deadline).is_valid()) {
+    return STATUS_FORMAT(TimedOut, "Timed out waiting for safe time $0", read_time);
+  }
+
+  ScopedPendingOperation scoped_read_operation(&pending_op_counter_);
+  RETURN_NOT_OK(scoped_read_operation);
+  if (hibernated()) {
+    return STATUS(IllegalState, "Tablet is hibernated");
+  }
+
+  const IndexMap index_map = metadata_->index_map();
+  std::vector<std::pair<const IndexInfo*, YBTablePtr>> indexes;
+  for (const auto& index_id : index_ids) {
+    const IndexInfo* index = VERIFY_RESULT(index_map.FindIndex(index_id));
+    YBTablePtr index_table;
+    bool cache_used_ignored = false;
+    RETURN_NOT_OK(metadata_cache_->GetTable(index_id, &index_table, &cache_used_ignored));
+    indexes.emplace_back(index, std::move(index_table));
+  }
+
+  const Schema schema = metadata_->schema();
+  DocRowwiseIterator iter(
+      schema, schema, CreateTransactionOperationContext(boost::none),
+      docdb::DocDB{regular_db_.get(), intents_db_.get()}, deadline,
+      ReadHybridTime::SingleTime(read_time), &pending_op_counter_);
+  RETURN_NOT_OK(iter.Init());
+  if (!start_key.empty()) {
+    RETURN_NOT_OK(iter.Seek(start_key));
+  }
+
+  // The entries are older than any write of the index maintenance after read_time, so they do not
+  // overwrite index entries of rows that were updated or deleted meanwhile.
+  const UserTimeMicros user_timestamp = read_time.GetPhysicalValueMicros() - 1;
+  auto session = std::make_shared<YBSession>(client_future_.get());
+  session->SetTimeout(MonoDelta(std::max(
+      deadline - CoarseMonoClock::Now(), CoarseDuration::zero())));
+
+  const auto start = CoarseMonoClock::Now();
+  const size_t max_rows = std::max(FLAGS_backfill_index_rows_per_chunk, 1);
+  const size_t batch_size = std::max(FLAGS_backfill_index_write_batch_size, 1);
+  const int rate_rows_per_sec = FLAGS_backfill_index_rate_rows_per_sec;
+  std::string next_key;
+  size_t num_batch_rows = 0;
+  QLTableRow row;
+  while (iter.HasNext()) {
+    if (*num_rows >= max_rows || CoarseMonoClock::Now() >= deadline) {
+      next_key = VERIFY_RESULT(iter.GetRowKey());
+      break;
+    }
+    row.Clear();
+    RETURN_NOT_OK(iter.NextRow(&row));
+    for (const auto& index : indexes) {
+      shared_ptr<client::YBqlWriteOp> index_op(index.second->NewQLWrite());
+      docdb::PrepareIndexBackfillRequest(
+          *index.first, row, user_timestamp, index_op->mutable_request());
+      RETURN_NOT_OK(session->Apply(index_op));
+    }
+    ++*num_rows;
+    if (++num_batch_rows >= batch_size) {
+      RETURN_NOT_OK(FlushIndexSession(session));
+      num_batch_rows = 0;
+    }
+    if (rate_rows_per_sec > 0) {
+      // Rows are written evenly over time, at most rate_rows_per_sec of them each second.
+      const auto expected = start + std::chrono::microseconds(
+          *num_rows * 1000000 / rate_rows_per_sec);
+      const auto now = CoarseMonoClock::Now();
+      if (now < expected) {
+        SleepFor(MonoDelta(expected - now));
+      }
+    }
+  }
+  if (num_batch_rows != 0) {
+    RETURN_NOT_OK(FlushIndexSession(session));
+  }
+
+  VLOG_WITH_PREFIX(1) << "Backfilled " << *num_rows << " rows at " << read_time
+                      << ", next key: " << Slice(next_key).ToDebugHexString();
+  return next_key;
+}
+
 void Tablet::StartOperation(WriteOperationState* operation_state) {
   // If the state already has a hybrid_time then we're replaying a transaction that occurred
   // before a crash or at another node.
@@ -664,14 +952,150 @@ void Tablet::StartOperation(WriteOperationState* operation_state) {
   }
 }
 
+namespace {
+
+const KeyValueWriteBatchPB& PutBatch(WriteOperationState* operation_state) {
+  return operation_state->consensus_round() && operation_state->consensus_round()->replicate_msg()
+      // Online case.
+      ? operation_state->consensus_round()->replicate_msg()->write_request().write_batch()
+      // Bootstrap case.
+      : operation_state->request()->write_batch();
+}
+
+// Adds the files of the checkpoint of db in dir/subdir to the manifest. SST files are immutable and
+// a DB never reuses their numbers, so the DB identity with the file name identifies their content.
+Status AddCheckpointFiles(
+    rocksdb::DB* db, const std::string& dir, const std::string& subdir,
+    CheckpointManifestPB* manifest) {
+  std::string db_identity;
+  RETURN_NOT_OK(db->GetDbIdentity(&db_identity));
+  auto env = Env::Default();
+  const auto files_dir = subdir.empty() ? dir : JoinPathSegments(dir, subdir);
+  std::vector<std::string> files;
+  RETURN_NOT_OK(env->GetChildren(files_dir, ExcludeDots::kTrue, &files));
+  for (const auto& file : files) {
+    const auto full_path = JoinPathSegments(files_dir, file);
+    // The intents DB checkpoint is added separately.
+    if (VERIFY_RESULT(env->IsDirectory(full_path))) {
+      continue;
+    }
+    auto* file_pb = manifest->add_files();
+    file_pb->set_name(subdir.empty() ? file : JoinPathSegments(subdir, file));
+    file_pb->set_size_bytes(VERIFY_RESULT(env->GetFileSize(full_path)));
+    uint64_t number;
+    rocksdb::FileType type;
+    if (rocksdb::ParseFileName(file, &number, &type) &&
+        (type == rocksdb::kTableFile || type == rocksdb::kTableSBlockFile)) {
+      file_pb->set_file_id(Format("$0/$1", db_identity, file));
+    }
+  }
+  return Status::OK();
+}
+
+} // namespace
+
+struct Tablet::ApplyGroup {
+  // Thread that started the group, or default constructed id when there is no started group.
+  std::thread::id thread_id;
+  rocksdb::WriteBatch write_batch;
+  docdb::ConsensusFrontiers frontiers;
+  HybridTime min_hybrid_time;
+  HybridTime max_hybrid_time;
+  std::vector<std::function<void()>> applied;
+};
+
+void Tablet::StartApplyGroup() {
+  if (!regular_db_ || FLAGS_max_group_apply_batch_size <= 1) {
+    return;
+  }
+  std::lock_guard<std::mutex> lock(apply_group_mutex_);
+  if (!apply_group_) {
+    apply_group_ = std::make_unique<ApplyGroup>();
+  }
+  apply_group_->thread_id = std::this_thread::get_id();
+}
+
+void Tablet::FinishApplyGroup() {
+  std::lock_guard<std::mutex> lock(apply_group_mutex_);
+  if (!apply_group_) {
+    return;
+  }
+  FlushApplyGroupUnlocked();
+  apply_group_->thread_id = std::thread::id();
+}
+
 void Tablet::ApplyRowOperations(WriteOperationState* operation_state) {
+  std::lock_guard<std::mutex> lock(apply_group_mutex_);
+  // Operations of the group precede this one.
+  FlushApplyGroupUnlocked();
+  DoApplyRowOperations(operation_state);
+}
+
+void Tablet::ApplyRowOperations(
+    WriteOperationState* operation_state, std::function<void()> applied) {
+  std::lock_guard<std::mutex> lock(apply_group_mutex_);
+  if (apply_group_ && apply_group_->thread_id == std::this_thread::get_id() &&
+      !PutBatch(operation_state).has_transaction()) {
+    AddToApplyGroupUnlocked(operation_state, std::move(applied));
+    const auto max_batch_size = FLAGS_max_group_apply_batch_size;
+    if (apply_group_->applied.size() >= implicit_cast<size_t>(max_batch_size)) {
+      FlushApplyGroupUnlocked();
+    }
+    return;
+  }
+  FlushApplyGroupUnlocked();
+  DoApplyRowOperations(operation_state);
+  applied();
+}
+
+void Tablet::AddToApplyGroupUnlocked(
+    WriteOperationState* operation_state, std::function<void()> applied) {
   last_committed_write_index_.store(operation_state->op_id().index(), std::memory_order_release);
-  const KeyValueWriteBatchPB& put_batch =
-      operation_state->consensus_round() && operation_state->consensus_round()->replicate_msg()
-          // Online case.
-          ? operation_state->consensus_round()->replicate_msg()->write_request().write_batch()
-          // Bootstrap case.
-          : operation_state->request()->write_batch();
+  auto& group = *apply_group_;
+  const yb::OpId op_id(operation_state->op_id().term(), operation_state->op_id().index());
+  const auto hybrid_time = operation_state->hybrid_time();
+  if (group.applied.empty()) {
+    set_op_id(op_id, &group.frontiers);
+    set_hybrid_time(hybrid_time, &group.frontiers);
+    group.min_hybrid_time = hybrid_time;
+  } else {
+    group.frontiers.Largest().set_op_id(op_id);
+    group.frontiers.Largest().set_hybrid_time(hybrid_time);
+  }
+  group.max_hybrid_time = hybrid_time;
+
+  const auto& put_batch = PutBatch(operation_state);
+  if (!put_batch.write_pairs().empty() || !put_batch.read_pairs().empty()) {
+    PrepareNonTransactionWriteBatch(put_batch, hybrid_time, &group.write_batch);
+  }
+  group.applied.push_back(std::move(applied));
+}
+
+void Tablet::FlushApplyGroupUnlocked() {
+  if (!apply_group_ || apply_group_->applied.empty()) {
+    return;
+  }
+  auto& group = *apply_group_;
+  if (group.write_batch.Count() != 0) {
+    // Records of the group are written with the latest hybrid time of the group, while the
+    // memstore should account for the earliest one.
+    flush_stats_->AboutToWriteToDb(group.min_hybrid_time);
+  }
+  WriteBatch(&group.frontiers, group.max_hybrid_time, &group.write_batch, regular_db_.get());
+  group.write_batch.Clear();
+
+  auto applied = std::move(group.applied);
+  group.applied.clear();
+  // Invoked in order and under the lock, because operations have to be made visible in the order
+  // of their hybrid times.
+  for (const auto& callback : applied) {
+    callback();
+  }
+}
+
+void Tablet::DoApplyRowOperations(WriteOperationState* operation_state) {
+  last_committed_write_index_.store(operation_state->op_id().index(), std::memory_order_release);
+  const KeyValueWriteBatchPB& put_batch = PutBatch(operation_state);
 
   docdb::ConsensusFrontiers frontiers;
   set_op_id({operation_state->op_id().term(), operation_state->op_id().index()}, &frontiers);
@@ -680,6 +1104,7 @@ void Tablet::ApplyRowOperations(WriteOperationState* operation_state) {
 }
 
 Status Tablet::CreateCheckpoint(const std::string& dir) {
+  RETURN_NOT_OK(WakeUpIfHibernated());
   ScopedPendingOperation scoped_read_operation(&pending_op_counter_);
   RETURN_NOT_OK(scoped_read_operation);
 
@@ -709,6 +1134,18 @@ Status Tablet::CreateCheckpoint(const std::string& dir) {
   if (status.ok() && intents_db_) {
     status = Env::Default()->RenameFile(temp_intents_dir, final_intents_dir);
   }
+  if (status.ok()) {
+    CheckpointManifestPB manifest;
+    status = AddCheckpointFiles(regular_db_.get(), dir, "" /* subdir */, &manifest);
+    if (status.ok() && intents_db_) {
+      status = AddCheckpointFiles(intents_db_.get(), dir, kIntentsSubdir, &manifest);
+    }
+    if (status.ok()) {
+      status = pb_util::WritePBContainerToPath(
+          Env::Default(), JoinPathSegments(dir, kCheckpointManifestFileName), manifest,
+          pb_util::NO_OVERWRITE, pb_util::SYNC);
+    }
+  }
 
   if (!status.ok()) {
     LOG_WITH_PREFIX(WARNING) << "Create checkpoint status: " << status;
@@ -755,12 +1192,13 @@ void Tablet::ApplyKeyValueRowOperations(const KeyValueWriteBatchPB& put_batch,
     return;
   }
 
-  rocksdb::WriteBatch write_batch;
   if (put_batch.has_transaction()) {
+    rocksdb::WriteBatch write_batch;
     RequestScope request_scope(transaction_participant_.get());
     PrepareTransactionWriteBatch(put_batch, hybrid_time, &write_batch);
     WriteBatch(frontiers, hybrid_time, &write_batch, intents_db_.get());
   } else {
+    rocksdb::WriteBatch write_batch(docdb::NonTransactionWriteBatchSizeUpperBound(put_batch));
     PrepareNonTransactionWriteBatch(put_batch, hybrid_time, &write_batch);
     WriteBatch(frontiers, hybrid_time, &write_batch, regular_db_.get());
   }
@@ -776,6 +1214,16 @@ void Tablet::WriteBatch(const rocksdb::UserFrontiers* frontiers,
 
   write_batch->SetFrontiers(frontiers);
 
+  // Invalidated before the write, so that reads that do not see it could not cache their rows
+  // afterwards.
+  if (row_cache_ && dest_db == regular_db_.get()) {
+    row_cache_->Invalidate(*write_batch, hybrid_time);
+  }
+  // Indexed before the write, so that conflict resolution never misses the written intents.
+  if (intent_index_ && dest_db == intents_db_.get()) {
+    intent_index_->Add(*write_batch);
+  }
+
   // We are using Raft replication index for the RocksDB sequence number for
   // all members of this write batch.
   rocksdb::WriteOptions write_options;
@@ -849,11 +1297,19 @@ Status Tablet::HandleRedisReadRequest(CoarseTimePoint deadline,
                                       const RedisReadRequestPB& redis_read_request,
                                       RedisResponsePB* response) {
   // TODO: move this locking to the top-level read request handler in TabletService.
+  RETURN_NOT_OK(WakeUpIfHibernated());
   ScopedPendingOperation scoped_read_operation(&pending_op_counter_);
   RETURN_NOT_OK(scoped_read_operation);
 
   ScopedTabletMetricsTracker metrics_tracker(metrics_->redis_read_latency);
 
+  if (HotKeySampler::ShouldSample()) {
+    const auto& key_value = redis_read_request.key_value();
+    hot_keys_.Record(key_value.has_key()
+        ? DocKey::EncodedFromRedisKey(key_value.hash_code(), key_value.key()).AsSlice()
+        : Slice());
+  }
+
   docdb::RedisReadOperation doc_op(
       redis_read_request, {regular_db_.get(), intents_db_.get()}, deadline, read_time);
   RETURN_NOT_OK(doc_op.Execute());
@@ -869,6 +1325,7 @@ Status Tablet::HandleQLReadRequest(
     const QLReadRequestPB& ql_read_request,
     const TransactionMetadataPB& transaction_metadata,
     QLReadRequestResult* result) {
+  RETURN_NOT_OK(WakeUpIfHibernated());
   ScopedPendingOperation scoped_read_operation(&pending_op_counter_);
   RETURN_NOT_OK(scoped_read_operation);
   ScopedTabletMetricsTracker metrics_tracker(metrics_->ql_read_latency);
@@ -878,6 +1335,10 @@ Status Tablet::HandleQLReadRequest(
     return Status::OK();
   }
 
+  if (HotKeySampler::ShouldSample()) {
+    SampleQLReadKey(ql_read_request);
+  }
+
   Result<TransactionOperationContextOpt> txn_op_ctx =
       CreateTransactionOperationContext(transaction_metadata);
   RETURN_NOT_OK(txn_op_ctx);
@@ -885,6 +1346,22 @@ Status Tablet::HandleQLReadRequest(
       deadline, read_time, ql_read_request, *txn_op_ctx, result);
 }
 
+void Tablet::SampleQLReadKey(const QLReadRequestPB& ql_read_request) {
+  // Scans that are not restricted to a single hash key are only counted.
+  docdb::KeyBytes encoded_doc_key;
+  if (!ql_read_request.hashed_column_values().empty()) {
+    const auto& schema = metadata_->schema();
+    std::vector<PrimitiveValue> hashed_components;
+    auto status = docdb::QLKeyColumnValuesToPrimitiveValues(
+        ql_read_request.hashed_column_values(), schema, 0, schema.num_hash_key_columns(),
+        &hashed_components);
+    if (status.ok()) {
+      encoded_doc_key = DocKey(ql_read_request.hash_code(), std::move(hashed_components)).Encode();
+    }
+  }
+  hot_keys_.Record(encoded_doc_key.AsSlice());
+}
+
 CHECKED_STATUS Tablet::CreatePagingStateForRead(const QLReadRequestPB& ql_read_request,
                                                 const size_t row_count,
                                                 QLResponsePB* response) const {
@@ -1144,11 +1621,17 @@ Status Tablet::HandlePgsqlReadRequest(
     const PgsqlReadRequestPB& pgsql_read_request,
     const TransactionMetadataPB& transaction_metadata,
     PgsqlReadRequestResult* result) {
+  RETURN_NOT_OK(WakeUpIfHibernated());
   ScopedPendingOperation scoped_read_operation(&pending_op_counter_);
   RETURN_NOT_OK(scoped_read_operation);
   // TODO(neil) Work on metrics for PGSQL.
   // ScopedTabletMetricsTracker metrics_tracker(metrics_->pgsql_read_latency);
 
+  if (HotKeySampler::ShouldSample()) {
+    // ybctid is the encoded DocKey of the row read by primary key. Other reads are only counted.
+    hot_keys_.Record(pgsql_read_request.ybctid_column_value().value().binary_value());
+  }
+
   const tablet::TableInfo* table_info =
       VERIFY_RESULT(metadata_->GetTableInfo(pgsql_read_request.table_id()));
   // Assert the table is a Postgres table.
@@ -1314,9 +1797,108 @@ Status Tablet::CompactSync() {
   return regular_db_->CompactFiles(rocksdb::CompactionOptions(), file_names, 0);
 }
 
+Status Tablet::WarmUpBlockCache(rocksdb::RateLimiter* rate_limiter) {
+  TRACE_EVENT0("tablet", "Tablet::WarmUpBlockCache");
+
+  ScopedPendingOperation scoped_read_operation(&pending_op_counter_);
+  RETURN_NOT_OK(scoped_read_operation);
+
+  if (!regular_db_) {
+    return Status::OK();
+  }
+
+  // Warm up can take a while, so don't hold back shutdown or operations that wait for pending
+  // operations to finish.
+  const auto should_stop = [this] {
+    return IsShutdownRequested() || !pending_op_counter_.IsReady();
+  };
+  RETURN_NOT_OK(regular_db_->WarmUpBlockCache(rate_limiter, should_stop));
+  if (intents_db_) {
+    RETURN_NOT_OK(intents_db_->WarmUpBlockCache(rate_limiter, should_stop));
+  }
+
+  return Status::OK();
+}
+
+Result<bool> Tablet::Hibernate(CoarseDuration min_idle_time) {
+  const auto idle = [this, min_idle_time] {
+    return CoarseMonoClock::Now() - last_access_time_.load() >= min_idle_time &&
+           (!transaction_participant_ || !transaction_participant_->HasTransactions());
+  };
+  if (hibernated() || table_type_ == TableType::TRANSACTION_STATUS_TABLE_TYPE ||
+      IsShutdownRequested() || !idle()) {
+    return false;
+  }
+
+  // RocksDB does not keep a WAL, so everything has to be flushed before it is closed.
+  RETURN_NOT_OK(Flush(FlushMode::kSync));
+
+  std::lock_guard<std::mutex> hibernation_lock(hibernation_mutex_);
+  auto op_pause = PauseReadWriteOperations();
+  RETURN_NOT_OK(op_pause);
+
+  // Checked again while operations are paused, so that an access that has started meanwhile either
+  // has been recorded or fails to start its operation.
+  if (hibernated() || IsShutdownRequested() || !regular_db_ || !idle() ||
+      flush_stats_->oldest_write_in_memstore() != HybridTime::kMax ||
+      regular_db_->HasSomethingToFlush() || (intents_db_ && intents_db_->HasSomethingToFlush())) {
+    return false;
+  }
+
+  hibernated_max_persistent_op_id_ = DoGetMaxPersistentOpId();
+  hibernated_max_persistent_hybrid_time_ = DoGetMaxPersistentHybridTime();
+  hibernated_sst_file_sizes_ = regular_db_->GetTotalSSTFileSize();
+  hibernated_uncompressed_sst_file_sizes_ = regular_db_->GetUncompressedSSTFileSize();
+  hibernated_estimated_num_keys_ = DoGetEstimatedNumKeys();
+
+  {
+    std::lock_guard<rw_spinlock> lock(component_lock_);
+    if (transaction_participant_) {
+      transaction_participant_->SetDB(nullptr);
+    }
+    ql_storage_.reset();
+    row_cache_.reset();
+    intent_index_.reset();
+    scan_cursors_.reset();
+    // Destroy intents and regular DBs in reverse order to their creation, as in Shutdown.
+    intents_db_.reset();
+    regular_db_.reset();
+  }
+  hibernated_.store(true, std::memory_order_release);
+
+  LOG_WITH_PREFIX(INFO) << "Hibernated";
+  return true;
+}
+
+Status Tablet::WakeUpIfHibernated() {
+  last_access_time_.store(CoarseMonoClock::Now());
+  if (!hibernated()) {
+    return Status::OK();
+  }
+
+  std::lock_guard<std::mutex> hibernation_lock(hibernation_mutex_);
+  if (!hibernated()) {
+    return Status::OK();
+  }
+  auto op_pause = PauseReadWriteOperations();
+  RETURN_NOT_OK(op_pause);
+  if (IsShutdownRequested()) {
+    return STATUS(IllegalState, "Tablet was shut down");
+  }
+
+  LOG_WITH_PREFIX(INFO) << "Waking up";
+  RETURN_NOT_OK(OpenKeyValueTablet());
+  RETURN_NOT_OK(EnableCompactions());
+  hibernated_.store(false, std::memory_order_release);
+  return Status::OK();
+}
+
 Status Tablet::WaitForFlush() {
   TRACE_EVENT0("tablet", "Tablet::WaitForFlush");
 
+  if (!regular_db_) {
+    return Status::OK();
+  }
   RETURN_NOT_OK(regular_db_->WaitForFlush());
   if (intents_db_) {
     RETURN_NOT_OK(intents_db_->WaitForFlush());
@@ -1333,47 +1915,100 @@ Status Tablet::ImportData(const std::string& source_dir) {
 // We apply intents using by iterating over whole transaction reverse index.
 // Using value of reverse index record we find original intent record and apply it.
 // After that we delete both intent record and reverse index record.
+//
+// Big transactions are applied in chunks of at most FLAGS_txn_max_apply_batch_records intents.
+// Only the last chunk of regular records carries the frontiers of the apply operation, so the
+// operation is replayed after a restart unless all of them were flushed. Intents are removed only
+// after all of them were applied, and the intents DB is not flushed ahead of the regular DB, see
+// IntentsDbFlushFilter, so the replay would find all of them.
 // TODO(dtxn) use separate thread for applying intents.
-// TODO(dtxn) use multiple batches when applying really big transaction.
 Status Tablet::ApplyIntents(const TransactionApplyData& data) {
-  rocksdb::WriteBatch regular_write_batch;
-  rocksdb::WriteBatch intents_write_batch;
-  RETURN_NOT_OK(docdb::PrepareApplyIntentsBatch(
-      data.transaction_id, data.commit_ht,
-      &regular_write_batch, intents_db_.get(), &intents_write_batch));
-
   // data.hybrid_time contains transaction commit time.
   // We don't set transaction field of put_batch, otherwise we would write another bunch of intents.
   docdb::ConsensusFrontiers frontiers;
   set_op_id({data.op_id.term(), data.op_id.index()}, &frontiers);
   set_hybrid_time(data.log_ht, &frontiers);
-  WriteBatch(&frontiers, data.commit_ht, &regular_write_batch, regular_db_.get());
-  WriteBatch(&frontiers, data.commit_ht, &intents_write_batch, intents_db_.get());
+
+  const size_t max_records = std::max(FLAGS_txn_max_apply_batch_records, 1);
+  docdb::ApplyTransactionState apply_state;
+  rocksdb::WriteBatch regular_write_batch;
+  rocksdb::WriteBatch intents_write_batch;
+  RETURN_NOT_OK(docdb::PrepareApplyIntentsBatch(
+      data.transaction_id, data.commit_ht, &regular_write_batch, intents_db_.get(),
+      &intents_write_batch, &apply_state, max_records));
+  if (!apply_state.active()) {
+    // The whole transaction fits into a single chunk.
+    WriteBatch(&frontiers, data.commit_ht, &regular_write_batch, regular_db_.get());
+    WriteBatch(&frontiers, data.commit_ht, &intents_write_batch, intents_db_.get());
+    if (intent_index_) {
+      intent_index_->Remove(data.transaction_id);
+    }
+    return Status::OK();
+  }
+
+  for (;;) {
+    VLOG_WITH_PREFIX(2) << "Applying " << data.transaction_id << ", continue from "
+                        << apply_state.ToString();
+    WriteBatch(apply_state.active() ? nullptr : &frontiers, data.commit_ht, &regular_write_batch,
+               regular_db_.get());
+    if (!apply_state.active()) {
+      break;
+    }
+    regular_write_batch.Clear();
+    RETURN_NOT_OK(docdb::PrepareApplyIntentsBatch(
+        data.transaction_id, data.commit_ht, &regular_write_batch, intents_db_.get(),
+        nullptr /* intents_batch */, &apply_state, max_records));
+  }
+
+  do {
+    intents_write_batch.Clear();
+    RETURN_NOT_OK(docdb::PrepareApplyIntentsBatch(
+        data.transaction_id, HybridTime() /* commit_ht */, nullptr /* regular_batch */,
+        intents_db_.get(), &intents_write_batch, &apply_state, max_records));
+    WriteBatch(&frontiers, data.commit_ht, &intents_write_batch, intents_db_.get());
+  } while (apply_state.active());
+  if (intent_index_) {
+    intent_index_->Remove(data.transaction_id);
+  }
   return Status::OK();
 }
 
 CHECKED_STATUS Tablet::RemoveIntents(const TransactionId& id) {
-  rocksdb::WriteBatch intents_write_batch;
-  RETURN_NOT_OK(docdb::PrepareApplyIntentsBatch(
-      id, HybridTime() /* commit_ht */, nullptr /* regular_write_batch */,
-      intents_db_.get(), &intents_write_batch));
+  return RemoveIntents(TransactionIdSet{id});
+}
 
+// Removals of small transactions are combined into a single write, while big transactions are
+// removed in chunks of at most FLAGS_txn_max_apply_batch_records intents.
+CHECKED_STATUS Tablet::RemoveIntents(const TransactionIdSet& transactions) {
+  const size_t max_records = std::max(FLAGS_txn_max_apply_batch_records, 1);
   rocksdb::WriteOptions write_options;
   InitRocksDBWriteOptions(&write_options);
-  return intents_db_->Write(write_options, &intents_write_batch);
-}
 
-CHECKED_STATUS Tablet::RemoveIntents(const TransactionIdSet& transactions) {
   rocksdb::WriteBatch intents_write_batch;
   for (const TransactionId& id : transactions) {
-    RETURN_NOT_OK(docdb::PrepareApplyIntentsBatch(
-        id, HybridTime() /* commit_ht */, nullptr /* regular_write_batch */,
-        intents_db_.get(), &intents_write_batch));
+    docdb::ApplyTransactionState apply_state;
+    do {
+      RETURN_NOT_OK(docdb::PrepareApplyIntentsBatch(
+          id, HybridTime() /* commit_ht */, nullptr /* regular_write_batch */,
+          intents_db_.get(), &intents_write_batch, &apply_state, max_records));
+      if (apply_state.active() ||
+          implicit_cast<size_t>(intents_write_batch.Count()) >= max_records) {
+        RETURN_NOT_OK(intents_db_->Write(write_options, &intents_write_batch));
+        intents_write_batch.Clear();
+      }
+    } while (apply_state.active());
   }
 
-  rocksdb::WriteOptions write_options;
-  InitRocksDBWriteOptions(&write_options);
-  return intents_db_->Write(write_options, &intents_write_batch);
+  if (intents_write_batch.Count() != 0) {
+    RETURN_NOT_OK(intents_db_->Write(write_options, &intents_write_batch));
+  }
+  // Dropped only once the intents are removed from the intents DB.
+  if (intent_index_) {
+    for (const TransactionId& id : transactions) {
+      intent_index_->Remove(id);
+    }
+  }
+  return Status::OK();
 }
 
 HybridTime Tablet::ApplierSafeTime(HybridTime min_allowed, CoarseTimePoint deadline) {
@@ -1552,10 +2187,12 @@ Status Tablet::Truncate(TruncateOperationState *state) {
 
   const rocksdb::SequenceNumber sequence_number = regular_db_->GetLatestSequenceNumber();
   const string db_dir = regular_db_->GetName();
+  const auto db_paths = regular_db_->GetOptions().db_paths;
 
   rocksdb::Options rocksdb_options;
   docdb::InitRocksDBOptions(&rocksdb_options, LogPrefix(), rocksdb_statistics_, tablet_options_);
 
+  scan_cursors_.reset();
   Status intents_status;
   if (intents_db_) {
     auto intents_dir = intents_db_->GetName();
@@ -1563,6 +2200,7 @@ Status Tablet::Truncate(TruncateOperationState *state) {
     intents_status = rocksdb::DestroyDB(intents_dir, rocksdb_options);
   }
   regular_db_.reset();
+  rocksdb_options.db_paths = db_paths;
   auto s = rocksdb::DestroyDB(db_dir, rocksdb_options);
   if (s.ok() && !intents_status.ok()) {
     s = intents_status;
@@ -1594,6 +2232,58 @@ Status Tablet::Truncate(TruncateOperationState *state) {
   return Status::OK();
 }
 
+Status Tablet::IngestSstFile(IngestSstOperationState* state) {
+  ScopedPendingOperation scoped_operation(&pending_op_counter_);
+  RETURN_NOT_OK(scoped_operation);
+
+  const auto file_path = IngestSstFilePath(state->request()->file_path());
+
+  // The OpId of this operation becomes the flushed frontier, so everything applied before it has
+  // to be in SST files already. Otherwise those records would be skipped by log replay.
+  RETURN_NOT_OK(Flush(FlushMode::kSync, FlushFlags::kRegular));
+
+  rocksdb::ExternalSstFileInfo file_info;
+  auto s = regular_db_->GetExternalSstFileInfo(file_path, &file_info);
+  if (s.ok()) {
+    docdb::ConsensusFrontier frontier;
+    frontier.set_op_id({state->op_id().term(), state->op_id().index()});
+    frontier.set_hybrid_time(state->hybrid_time());
+    file_info.frontier = frontier.Clone();
+    s = regular_db_->AddFile(&file_info, state->request()->move_file());
+    if (row_cache_) {
+      // Records of the file bypass the write path, so none of the cached rows could be trusted.
+      // Rows read before the file was added are not stored afterwards either.
+      auto min_read_time = state->hybrid_time();
+      if (clock_) {
+        min_read_time.MakeAtLeast(clock_->Now());
+      }
+      row_cache_->Clear(min_read_time);
+    }
+  }
+
+  // A missing or unreadable file is specific to this replica, so fail the apply and let it be
+  // retried once the file is in place. Any other error depends only on the file contents and the
+  // replicated state, so every replica makes the same decision and the operation is skipped.
+  if (s.IsIOError()) {
+    return s.CloneAndPrepend(Format("Failed to read $0", file_path));
+  }
+  if (!s.ok()) {
+    LOG_WITH_PREFIX(WARNING) << "Skipping ingest of " << file_path << ": " << s;
+    return Status::OK();
+  }
+
+  LOG_WITH_PREFIX(INFO) << "Ingested " << file_path << " with " << file_info.num_entries
+                        << " entries, " << file_info.file_size << " bytes";
+  return Status::OK();
+}
+
+std::string Tablet::IngestSstFilePath(const std::string& file_path) const {
+  if (!file_path.empty() && file_path[0] == '/') {
+    return file_path;
+  }
+  return JoinPathSegments(DirName(metadata_->rocksdb_dir()), file_path);
+}
+
 void Tablet::UpdateMonotonicCounter(int64_t value) {
   int64_t counter = monotonic_counter_;
   while (true) {
@@ -1623,10 +2313,89 @@ Result<bool> Tablet::HasSSTables() const {
   return !live_files_metadata.empty();
 }
 
+double Tablet::WriteThrottlePressure() {
+  // Called for each write, so the number of files is refreshed only once in a while.
+  constexpr auto kRefreshInterval = 100ms;
+
+  const int start = FLAGS_write_throttle_l0_files_start;
+  const int stop = FLAGS_rocksdb_level0_stop_writes_trigger;
+  if (start <= 0 || stop <= start) {
+    return 0.0;
+  }
+  auto now = CoarseMonoClock::Now();
+  auto refresh_time = write_throttle_refresh_time_.load(std::memory_order_acquire);
+  if (now < refresh_time ||
+      !write_throttle_refresh_time_.compare_exchange_strong(refresh_time, now + kRefreshInterval)) {
+    return write_throttle_pressure_.load(std::memory_order_acquire);
+  }
+
+  double pressure = 0.0;
+  ScopedPendingOperation scoped_operation(&pending_op_counter_);
+  std::string num_files;
+  if (scoped_operation.ok() && regular_db_ &&
+      regular_db_->GetProperty(rocksdb::DB::Properties::kNumFilesAtLevelPrefix + "0",
+                               &num_files)) {
+    int l0_files = 0;
+    if (safe_strto32(num_files, &l0_files) && l0_files > start) {
+      pressure = std::min(1.0, static_cast<double>(l0_files - start) / (stop - start));
+    }
+  }
+  write_throttle_pressure_.store(pressure, std::memory_order_release);
+  return pressure;
+}
+
+Result<std::string> Tablet::GetEncodedMiddleSplitKey() const {
+  if (!metadata_->partition_schema().IsHashPartitioning() ||
+      table_type_ == TableType::TRANSACTION_STATUS_TABLE_TYPE) {
+    return STATUS(NotSupported, "Only hash partitioned tablets could be split");
+  }
+
+  ScopedPendingOperation scoped_read_operation(&pending_op_counter_);
+  RETURN_NOT_OK(scoped_read_operation);
+
+  if (!regular_db_) {
+    return STATUS(IllegalState, "Tablet has no open RocksDB");
+  }
+
+  // The key range of the largest SST file is where most of the data is, so splitting it in the
+  // middle gives children of comparable size without reading the data.
+  const rocksdb::LiveFileMetaData* largest_file = nullptr;
+  auto live_files = regular_db_->GetLiveFilesMetaData();
+  for (const auto& file : live_files) {
+    if (largest_file == nullptr || file.total_size > largest_file->total_size) {
+      largest_file = &file;
+    }
+  }
+  if (largest_file == nullptr) {
+    return STATUS(IllegalState, "Tablet has no SST files");
+  }
+
+  auto smallest_hash = VERIFY_RESULT(DecodeHashCode(largest_file->smallest.key));
+  auto largest_hash = VERIFY_RESULT(DecodeHashCode(largest_file->largest.key));
+  uint32_t middle_hash = (static_cast<uint32_t>(smallest_hash) + largest_hash + 1) / 2;
+  auto result = PartitionSchema::EncodeMultiColumnHashValue(middle_hash);
+
+  const auto& partition = metadata_->partition();
+  if (middle_hash <= smallest_hash ||
+      (!partition.partition_key_start().empty() && result <= partition.partition_key_start()) ||
+      (!partition.partition_key_end().empty() && result >= partition.partition_key_end())) {
+    return STATUS_FORMAT(IllegalState, "Hash range [$0, $1] of the largest SST file can't be split",
+                         smallest_hash, largest_hash);
+  }
+  return result;
+}
+
 Result<DocDbOpIds> Tablet::MaxPersistentOpId() const {
   ScopedPendingOperation scoped_read_operation(&pending_op_counter_);
   RETURN_NOT_OK(scoped_read_operation);
 
+  if (hibernated()) {
+    return hibernated_max_persistent_op_id_;
+  }
+  return DoGetMaxPersistentOpId();
+}
+
+DocDbOpIds Tablet::DoGetMaxPersistentOpId() const {
   if (!regular_db_) {
     return DocDbOpIds{yb::OpId(), yb::OpId()};
   }
@@ -1649,6 +2418,13 @@ Result<HybridTime> Tablet::MaxPersistentHybridTime() const {
   ScopedPendingOperation scoped_read_operation(&pending_op_counter_);
   RETURN_NOT_OK(scoped_read_operation);
 
+  if (hibernated()) {
+    return hibernated_max_persistent_hybrid_time_;
+  }
+  return DoGetMaxPersistentHybridTime();
+}
+
+HybridTime Tablet::DoGetMaxPersistentHybridTime() const {
   if (!regular_db_) {
     return HybridTime::kMin;
   }
@@ -1714,7 +2490,29 @@ Status Tablet::TEST_SwitchMemtable() {
   return Status::OK();
 }
 
+void Tablet::SampleWriteKey(const docdb::DocOperations& doc_ops) {
+  // Only the first operation of the batch is sampled, so that a batch counts as one operation.
+  Slice encoded_doc_key;
+  boost::container::small_vector<RefCntPrefix, 8> paths;
+  IsolationLevel ignored_isolation_level;
+  if (!doc_ops.empty() &&
+      doc_ops.front()->GetDocPaths(
+          docdb::GetDocPathsMode::kLock, &paths, &ignored_isolation_level).ok() &&
+      !paths.empty()) {
+    encoded_doc_key = paths.front().as_slice();
+    auto doc_key_size = DocKey::EncodedSize(encoded_doc_key, docdb::DocKeyPart::WHOLE_DOC_KEY);
+    if (doc_key_size.ok()) {
+      encoded_doc_key = Slice(encoded_doc_key.data(), *doc_key_size);
+    }
+  }
+  hot_keys_.Record(encoded_doc_key);
+}
+
 Status Tablet::StartDocWriteOperation(WriteOperation* operation) {
+  if (HotKeySampler::ShouldSample()) {
+    SampleWriteKey(operation->doc_ops());
+  }
+
   auto write_batch = operation->request()->mutable_write_batch();
   auto isolation_level = VERIFY_RESULT(GetIsolationLevel(
       *write_batch, transaction_participant_.get()));
@@ -1737,7 +2535,7 @@ Status Tablet::StartDocWriteOperation(WriteOperation* operation) {
     if (isolation_level == IsolationLevel::NON_TRANSACTIONAL) {
       auto now = clock_->Now();
       auto result = VERIFY_RESULT(docdb::ResolveOperationConflicts(
-          operation->doc_ops(), now, { regular_db_.get(), intents_db_.get() },
+          operation->doc_ops(), now, ConflictResolutionDocDB(),
           transaction_participant_.get()));
       if (now != result) {
         clock_->Update(result);
@@ -1765,7 +2563,7 @@ Status Tablet::StartDocWriteOperation(WriteOperation* operation) {
       RETURN_NOT_OK(docdb::ResolveTransactionConflicts(
           operation->doc_ops(), *write_batch, clock_->Now(),
           read_time ? read_time.read : HybridTime::kMax,
-          { regular_db_.get(), intents_db_.get() }, transaction_participant_.get(),
+          ConflictResolutionDocDB(), transaction_participant_.get(),
           metrics_->transaction_conflicts.get()));
 
       if (!read_time) {
@@ -1968,6 +2766,9 @@ uint64_t Tablet::GetTotalSSTFileSizes() const {
 
   // In order to get actual stats we would have to wait.
   // This would give us correct stats but would make this request slower.
+  if (hibernated()) {
+    return hibernated_sst_file_sizes_;
+  }
   if (!pending_op_counter_.IsReady() || !regular_db_) {
     return 0;
   }
@@ -1980,12 +2781,36 @@ uint64_t Tablet::GetUncompressedSSTFileSizes() const {
 
   // In order to get actual stats we would have to wait.
   // This would give us correct stats but would make this request slower.
+  if (hibernated()) {
+    return hibernated_uncompressed_sst_file_sizes_;
+  }
   if (!pending_op_counter_.IsReady() || !regular_db_) {
     return 0;
   }
   return regular_db_->GetUncompressedSSTFileSize();
 }
 
+uint64_t Tablet::GetEstimatedNumKeys() const {
+  ScopedPendingOperation scoped_operation(&pending_op_counter_);
+  std::lock_guard<rw_spinlock> lock(component_lock_);
+
+  if (hibernated()) {
+    return hibernated_estimated_num_keys_;
+  }
+  if (!pending_op_counter_.IsReady() || !regular_db_) {
+    return 0;
+  }
+  return DoGetEstimatedNumKeys();
+}
+
+uint64_t Tablet::DoGetEstimatedNumKeys() const {
+  uint64_t result = 0;
+  if (!regular_db_->GetIntProperty(rocksdb::DB::Properties::kEstimateNumKeys, &result)) {
+    return 0;
+  }
+  return result;
+}
+
 // ------------------------------------------------------------------------------------------------
 
 Result<TransactionOperationContextOpt> Tablet::CreateTransactionOperationContext(
@@ -32,6 +32,7 @@
 #ifndef YB_TABLET_TABLET_H_
 #define YB_TABLET_TABLET_H_
 
+#include <functional>
 #include <iosfwd>
 #include <map>
 #include <memory>
@@ -54,7 +55,10 @@
 #include "yb/docdb/docdb.pb.h"
 #include "yb/docdb/docdb_compaction_filter.h"
 #include "yb/docdb/doc_operation.h"
+#include "yb/docdb/doc_row_cache.h"
+#include "yb/docdb/intent_index.h"
 #include "yb/docdb/ql_rocksdb_storage.h"
+#include "yb/docdb/ql_scan_cursors.h"
 #include "yb/docdb/shared_lock_manager.h"
 
 #include "yb/gutil/atomicops.h"
@@ -64,7 +68,9 @@
 #include "yb/rpc/rpc_fwd.h"
 
 #include "yb/tablet/abstract_tablet.h"
+#include "yb/tablet/hot_key_sampler.h"
 #include "yb/tablet/lock_manager.h"
+#include "yb/tablet/tablet_compaction_history.h"
 #include "yb/tablet/tablet_options.h"
 #include "yb/tablet/mvcc.h"
 #include "yb/tablet/tablet_metadata.h"
@@ -83,6 +89,7 @@
 
 namespace rocksdb {
 class DB;
+class RateLimiter;
 }
 
 namespace yb {
@@ -110,6 +117,7 @@ class MaintenanceOpStats;
 namespace tablet {
 
 class ChangeMetadataOperationState;
+class IngestSstOperationState;
 class ScopedReadOperation;
 struct TabletMetrics;
 struct TransactionApplyData;
@@ -281,6 +289,19 @@ class Tablet : public AbstractTablet, public TransactionIntentApplier {
   // Apply all of the row operations associated with this transaction.
   void ApplyRowOperations(WriteOperationState* operation_state);
 
+  // Same as above, but when called by the thread that started the apply group, non-transactional
+  // writes are added to the group, and applied is invoked once the group is written to RocksDB.
+  // Otherwise the write is applied immediately, after the pending writes of the group.
+  void ApplyRowOperations(WriteOperationState* operation_state, std::function<void()> applied);
+
+  // Starts grouping of the write operations applied by the current thread, so that consecutive
+  // writes are written to RocksDB with a single write. Their changes should not be made visible
+  // until FinishApplyGroup is called.
+  void StartApplyGroup();
+
+  // Writes the pending operations of the apply group and invokes their callbacks.
+  void FinishApplyGroup();
+
   // Apply a set of RocksDB row operations.
   // If rocksdb_write_batch is specified it could contain preencoded RocksDB operations.
   void ApplyKeyValueRowOperations(
@@ -344,7 +365,7 @@ class Tablet : public AbstractTablet, public TransactionIntentApplier {
 
   //------------------------------------------------------------------------------------------------
   // Create a RocksDB checkpoint in the provided directory. Only used when table_type_ ==
-  // YQL_TABLE_TYPE.
+  // YQL_TABLE_TYPE. The files of the checkpoint are listed in its kCheckpointManifestFileName.
   CHECKED_STATUS CreateCheckpoint(const std::string& dir);
 
   // Create a new row iterator which yields the rows as of the current MVCC
@@ -356,6 +377,15 @@ class Tablet : public AbstractTablet, public TransactionIntentApplier {
   Result<std::unique_ptr<common::YQLRowwiseIteratorIf>> NewRowIterator(
       const TableId& table_id) const;
 
+  // Writes the entries of the rows of the tablet as of read_time into the given indexes of its
+  // table, which are maintained by writes after read_time already. Starts from the row with the
+  // encoded key start_key, or from the first row when it is empty. Stops after
+  // FLAGS_backfill_index_rows_per_chunk rows or at the deadline, and returns the key of the row to
+  // continue from, or an empty string when all rows are done.
+  Result<std::string> BackfillIndexes(
+      const std::vector<TableId>& index_ids, HybridTime read_time, const std::string& start_key,
+      CoarseTimePoint deadline, size_t* num_rows);
+
   //------------------------------------------------------------------------------------------------
   // Makes RocksDB Flush.
   CHECKED_STATUS Flush(FlushMode mode,
@@ -366,6 +396,25 @@ class Tablet : public AbstractTablet, public TransactionIntentApplier {
   // Synchronously perform a full compaction on both regular and intents RocksDBs.
   CHECKED_STATUS CompactSync();
 
+  // Loads top-level index and filter blocks of all SST files of both regular and intents RocksDBs
+  // to the block cache. Returns Aborted if the tablet is shutting down or read/write operations
+  // were paused meanwhile.
+  CHECKED_STATUS WarmUpBlockCache(rocksdb::RateLimiter* rate_limiter);
+
+  // Closes both RocksDBs to release their memory and file handles if the tablet was not accessed
+  // for at least min_idle_time, has no running transactions and nothing left in its memstores
+  // after a flush. Returns true if the tablet was hibernated. Raft is not affected, the RocksDBs
+  // are reopened by WakeUpIfHibernated on the next read, write or operation.
+  Result<bool> Hibernate(CoarseDuration min_idle_time);
+
+  // Records an access to the tablet and reopens RocksDBs closed by Hibernate. Must be called
+  // before starting a read/write operation, i.e. not while holding a ScopedPendingOperation.
+  CHECKED_STATUS WakeUpIfHibernated();
+
+  bool hibernated() const {
+    return hibernated_.load(std::memory_order_acquire);
+  }
+
   // Prepares the transaction context for the alter schema operation.
   // An error will be returned if the specified schema is invalid (e.g.
   // key mismatch, or missing IDs)
@@ -382,6 +431,14 @@ class Tablet : public AbstractTablet, public TransactionIntentApplier {
   // Truncate this tablet by resetting the content of RocksDB.
   CHECKED_STATUS Truncate(TruncateOperationState* state);
 
+  // Adds the SST file from the request to the regular RocksDB, setting the flushed frontier to the
+  // OpId and hybrid time of the operation in the same version edit.
+  CHECKED_STATUS IngestSstFile(IngestSstOperationState* state);
+
+  // Returns the path an ingested SST file is read from. Relative paths are resolved against the
+  // parent of the tablet's RocksDB directory, so replicas with different data dirs can share them.
+  std::string IngestSstFilePath(const std::string& file_path) const;
+
   // Verbosely dump this entire tablet to the logs. This is only
   // really useful when debugging unit tests failures where the tablet
   // has a very small number of rows.
@@ -425,6 +482,19 @@ class Tablet : public AbstractTablet, public TransactionIntentApplier {
   // Returns true if a RocksDB-backed tablet has any SSTables.
   Result<bool> HasSSTables() const;
 
+  // Returns the partition key to split this tablet at, chosen from SST file metadata. Only hash
+  // partitioned tablets are supported.
+  Result<std::string> GetEncodedMiddleSplitKey() const;
+
+  // Returns how close the regular RocksDB is to stalling writes because compactions fall behind,
+  // from 0 for no pressure to 1 when all writes should be rejected. Writes are rejected with this
+  // probability, so that clients back off before the hard stall is hit.
+  double WriteThrottlePressure();
+
+  // Bounds of the encoded DocKeys that belong to this tablet. Records outside of them, e.g. copied
+  // from the tablet this one was split from, are dropped by compactions.
+  const docdb::KeyBounds& key_bounds() const { return key_bounds_; }
+
   // Returns the maximum persistent op id from all SSTables in RocksDB.
   // First for regular records and second for intents.
   Result<DocDbOpIds> MaxPersistentOpId() const;
@@ -451,6 +521,11 @@ class Tablet : public AbstractTablet, public TransactionIntentApplier {
   // The HybridTime of the oldest write that is still not scheduled to be flushed in RocksDB.
   TabletFlushStats* flush_stats() const { return flush_stats_.get(); }
 
+  // Recent flushes and compactions of the regular RocksDB.
+  const TabletCompactionHistory* compaction_history() const { return compaction_history_.get(); }
+
+  const HotKeySampler& hot_keys() const { return hot_keys_; }
+
   const scoped_refptr<server::Clock> &clock() const {
     return clock_;
   }
@@ -463,6 +538,10 @@ class Tablet : public AbstractTablet, public TransactionIntentApplier {
     return *ql_storage_;
   }
 
+  docdb::QLScanCursors* ScanCursors() const override {
+    return scan_cursors_.get();
+  }
+
   // Used from tests
   const std::shared_ptr<rocksdb::Statistics>& rocksdb_statistics() const {
     return rocksdb_statistics_;
@@ -498,6 +577,9 @@ class Tablet : public AbstractTablet, public TransactionIntentApplier {
   uint64_t GetTotalSSTFileSizes() const;
   uint64_t GetUncompressedSSTFileSizes() const;
 
+  // Estimated number of keys in the regular RocksDB.
+  uint64_t GetEstimatedNumKeys() const;
+
   void SetHybridTimeLeaseProvider(HybridTimeLeaseProvider provider) {
     ht_lease_provider_ = std::move(provider);
   }
@@ -538,6 +620,15 @@ class Tablet : public AbstractTablet, public TransactionIntentApplier {
 
   CHECKED_STATUS StartDocWriteOperation(WriteOperation* operation);
 
+  // DBs read by conflict resolution of write operations.
+  docdb::DocDB ConflictResolutionDocDB() const {
+    return {regular_db_.get(), intents_db_.get(), nullptr /* row_cache */, intent_index_.get()};
+  }
+
+  // Record the key of a sampled operation in hot_keys_.
+  void SampleQLReadKey(const QLReadRequestPB& ql_read_request);
+  void SampleWriteKey(const docdb::DocOperations& doc_ops);
+
   CHECKED_STATUS OpenKeyValueTablet();
   virtual CHECKED_STATUS CreateTabletDirectories(const string& db_dir, FsManager* fs);
 
@@ -553,6 +644,11 @@ class Tablet : public AbstractTablet, public TransactionIntentApplier {
       HybridTime hybrid_time,
       rocksdb::WriteBatch* rocksdb_write_batch);
 
+  void DoApplyRowOperations(WriteOperationState* operation_state);
+  void AddToApplyGroupUnlocked(WriteOperationState* operation_state,
+                               std::function<void()> applied);
+  void FlushApplyGroupUnlocked();
+
   Result<TransactionOperationContextOpt> CreateTransactionOperationContext(
       const TransactionMetadataPB& transaction_metadata) const;
 
@@ -564,6 +660,10 @@ class Tablet : public AbstractTablet, public TransactionIntentApplier {
 
   std::string LogPrefix() const;
 
+  DocDbOpIds DoGetMaxPersistentOpId() const;
+  HybridTime DoGetMaxPersistentHybridTime() const;
+  uint64_t DoGetEstimatedNumKeys() const;
+
   // Lock protecting schema_ and key_schema_.
   //
   // Writers take this lock in shared mode before decoding and projecting
@@ -645,6 +745,15 @@ class Tablet : public AbstractTablet, public TransactionIntentApplier {
 
   std::unique_ptr<rocksdb::DB> intents_db_;
 
+  // Cache of rows read by primary key point reads of regular_db_, if enabled.
+  std::unique_ptr<docdb::DocRowCache> row_cache_;
+
+  // Index of intents_db_ used by conflict resolution, if enabled.
+  std::unique_ptr<docdb::IntentIndex> intent_index_;
+
+  // Open scans of paged CQL reads of regular_db_, if enabled.
+  std::unique_ptr<docdb::QLScanCursors> scan_cursors_;
+
   std::unique_ptr<common::YQLStorageIf> ql_storage_;
 
   // This is for docdb fine-grained locking.
@@ -672,6 +781,26 @@ class Tablet : public AbstractTablet, public TransactionIntentApplier {
   // This is marked mutable because read path member functions (which are const) are using this.
   mutable yb::util::PendingOperationCounter pending_op_counter_;
 
+  // Serializes Hibernate and WakeUpIfHibernated.
+  std::mutex hibernation_mutex_;
+
+  // Time of the last read, write or operation, used to detect idle tablets.
+  std::atomic<CoarseTimePoint> last_access_time_{CoarseMonoClock::Now()};
+
+  // Set while RocksDBs are closed by Hibernate.
+  std::atomic<bool> hibernated_{false};
+
+  // Last value computed by WriteThrottlePressure and the time it should be recomputed.
+  std::atomic<double> write_throttle_pressure_{0.0};
+  std::atomic<CoarseTimePoint> write_throttle_refresh_time_{CoarseTimePoint()};
+
+  // Values reporting the closed RocksDBs of a hibernated tablet. Set before hibernated_.
+  DocDbOpIds hibernated_max_persistent_op_id_;
+  HybridTime hibernated_max_persistent_hybrid_time_;
+  uint64_t hibernated_sst_file_sizes_ = 0;
+  uint64_t hibernated_uncompressed_sst_file_sizes_ = 0;
+  uint64_t hibernated_estimated_num_keys_ = 0;
+
   std::shared_ptr<yb::docdb::HistoryRetentionPolicy> retention_policy_;
 
   std::unique_ptr<TransactionCoordinator> transaction_coordinator_;
@@ -689,10 +818,19 @@ class Tablet : public AbstractTablet, public TransactionIntentApplier {
 
   std::atomic<int64_t> last_committed_write_index_{0};
 
+  // Write operations applied but not yet written to RocksDB, see StartApplyGroup.
+  struct ApplyGroup;
+  std::mutex apply_group_mutex_;
+  std::unique_ptr<ApplyGroup> apply_group_ GUARDED_BY(apply_group_mutex_);
+
   // Remembers he HybridTime of the oldest write that is still not scheduled to
   // be flushed in RocksDB.
   std::shared_ptr<TabletFlushStats> flush_stats_;
 
+  std::shared_ptr<TabletCompactionHistory> compaction_history_;
+
+  HotKeySampler hot_keys_;
+
   HybridTimeLeaseProvider ht_lease_provider_;
 
  private:
@@ -710,6 +848,8 @@ class Tablet : public AbstractTablet, public TransactionIntentApplier {
 
   std::string log_prefix_suffix_;
 
+  const docdb::KeyBounds key_bounds_;
+
   DISALLOW_COPY_AND_ASSIGN(Tablet);
 };
 
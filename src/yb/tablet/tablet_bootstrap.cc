@@ -31,6 +31,8 @@
 //
 #include "yb/tablet/tablet_bootstrap.h"
 
+#include <future>
+
 #include "yb/consensus/consensus.h"
 #include "yb/consensus/log_anchor_registry.h"
 #include "yb/consensus/log_reader.h"
@@ -40,11 +42,13 @@
 #include "yb/tablet/tablet.h"
 #include "yb/tablet/tablet_peer.h"
 #include "yb/tablet/operations/change_metadata_operation.h"
+#include "yb/tablet/operations/ingest_sst_operation.h"
 #include "yb/tablet/operations/truncate_operation.h"
 #include "yb/tablet/operations/update_txn_operation.h"
 #include "yb/tablet/operations/write_operation.h"
 #include "yb/util/fault_injection.h"
 #include "yb/util/flag_tags.h"
+#include "yb/util/metrics.h"
 #include "yb/util/opid.h"
 #include "yb/util/logging.h"
 #include "yb/util/stopwatch.h"
@@ -67,6 +71,24 @@ DEFINE_bool(force_recover_flushed_frontier, false,
 TAG_FLAG(force_recover_flushed_frontier, hidden);
 TAG_FLAG(force_recover_flushed_frontier, advanced);
 
+DEFINE_bool(tablet_bootstrap_prefetch_log_segments, true,
+            "Read and decode the next log segment in the background while entries of the current "
+            "one are replayed during tablet bootstrap.");
+TAG_FLAG(tablet_bootstrap_prefetch_log_segments, advanced);
+
+METRIC_DEFINE_gauge_uint64(tablet, log_segments_to_replay,
+                           "Log Segments To Replay",
+                           yb::MetricUnit::kUnits,
+                           "Number of log segments to be replayed by the tablet bootstrap.");
+METRIC_DEFINE_gauge_uint64(tablet, log_segments_replayed,
+                           "Log Segments Replayed",
+                           yb::MetricUnit::kUnits,
+                           "Number of log segments already replayed by the tablet bootstrap.");
+METRIC_DEFINE_gauge_uint64(tablet, log_entries_replayed,
+                           "Log Entries Replayed",
+                           yb::MetricUnit::kEntries,
+                           "Number of log entries already replayed by the tablet bootstrap.");
+
 namespace yb {
 namespace tablet {
 
@@ -90,6 +112,7 @@ using consensus::OpIdToString;
 using consensus::ReplicateMsg;
 using strings::Substitute;
 using tserver::ChangeMetadataRequestPB;
+using tserver::IngestSstFileRequestPB;
 using tserver::TruncateRequestPB;
 using tserver::WriteRequestPB;
 
@@ -664,6 +687,9 @@ Status TabletBootstrap::HandleOperation(consensus::OperationType op_type,
     case consensus::TRUNCATE_OP:
       return PlayTruncateRequest(replicate);
 
+    case consensus::INGEST_SST_OP:
+      return PlayIngestSstRequest(replicate);
+
     case consensus::NO_OP:
       return PlayNoOpRequest(replicate);
 
@@ -784,11 +810,38 @@ Status TabletBootstrap::PlaySegments(ConsensusBootstrapInfo* consensus_info) {
   // from the log we're reading into the log we're writing.
   RETURN_NOT_OK_PREPEND(OpenNewLog(), "Failed to open new log");
 
+  scoped_refptr<AtomicGauge<uint64_t>> segments_replayed_gauge;
+  scoped_refptr<AtomicGauge<uint64_t>> entries_replayed_gauge;
+  const auto& metric_entity = tablet_->GetMetricEntity();
+  if (metric_entity) {
+    METRIC_log_segments_to_replay.Instantiate(metric_entity, 0)->set_value(segments.size());
+    segments_replayed_gauge = METRIC_log_segments_replayed.Instantiate(metric_entity, 0);
+    entries_replayed_gauge = METRIC_log_entries_replayed.Instantiate(metric_entity, 0);
+  }
+
+  // Reading and decoding of a segment is pipelined with replaying entries of the previous one.
+  // Entries are still replayed one by one in log order, since each of them depends on the state
+  // left by the previous ones.
+  const bool prefetch = FLAGS_tablet_bootstrap_prefetch_log_segments;
+  std::future<log::ReadEntriesResult> next_read_result;
+  auto start_read = [&segments, prefetch](size_t idx) {
+    auto segment = segments[idx];
+    return std::async(prefetch ? std::launch::async : std::launch::deferred,
+                      [segment] { return segment->ReadEntries(); });
+  };
+  if (!segments.empty()) {
+    next_read_result = start_read(0);
+  }
+
   int segment_count = 0;
   yb::OpId last_committed_op_id;
   RestartSafeCoarseTimePoint last_entry_time;
-  for (const scoped_refptr<ReadableLogSegment>& segment : segments) {
-    auto read_result = segment->ReadEntries();
+  for (size_t segment_idx = 0; segment_idx != segments.size(); ++segment_idx) {
+    const auto& segment = segments[segment_idx];
+    auto read_result = next_read_result.get();
+    if (segment_idx + 1 != segments.size() && read_result.status.ok()) {
+      next_read_result = start_read(segment_idx + 1);
+    }
     last_committed_op_id = std::max(last_committed_op_id, read_result.committed_op_id);
     for (int entry_idx = 0; entry_idx < read_result.entries.size(); ++entry_idx) {
       Status s = HandleEntry(
@@ -829,6 +882,10 @@ Status TabletBootstrap::PlaySegments(ConsensusBootstrapInfo* consensus_info) {
                                         stats_.ToString(),
                                         state.pending_replicates.size()));
     segment_count++;
+    if (segments_replayed_gauge) {
+      segments_replayed_gauge->set_value(segment_count);
+      entries_replayed_gauge->IncrementBy(read_result.entries.size());
+    }
   }
 
   if (state.UpdateCommittedFromStored()) {
@@ -976,6 +1033,18 @@ Status TabletBootstrap::PlayTruncateRequest(ReplicateMsg* replicate_msg) {
   return Status::OK();
 }
 
+Status TabletBootstrap::PlayIngestSstRequest(ReplicateMsg* replicate_msg) {
+  IngestSstFileRequestPB* req = replicate_msg->mutable_ingest_sst_request();
+
+  IngestSstOperationState operation_state(nullptr, req);
+  operation_state.mutable_op_id()->CopyFrom(replicate_msg->id());
+  operation_state.set_hybrid_time(HybridTime(replicate_msg->hybrid_time()));
+
+  RETURN_NOT_OK_PREPEND(tablet_->IngestSstFile(&operation_state), "Failed to ingest SST file:");
+
+  return Status::OK();
+}
+
 Status TabletBootstrap::PlayUpdateTransactionRequest(
     ReplicateMsg* replicate_msg, AlreadyApplied already_applied) {
   DCHECK(replicate_msg->has_hybrid_time());
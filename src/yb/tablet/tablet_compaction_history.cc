@@ -0,0 +1,165 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/tablet/tablet_compaction_history.h"
+
+#include <algorithm>
+
+#include "yb/gutil/walltime.h"
+
+#include "yb/rocksdb/db.h"
+#include "yb/rocksdb/rate_limiter.h"
+
+#include "yb/docdb/docdb_compaction_filter.h"
+
+#include "yb/util/logging.h"
+#include "yb/util/metrics.h"
+
+namespace yb {
+namespace tablet {
+
+namespace {
+
+const char* CompactionReasonToString(rocksdb::CompactionReason reason) {
+  switch (reason) {
+    case rocksdb::CompactionReason::kUnknown: return "unknown";
+    case rocksdb::CompactionReason::kLevelL0FilesNum: return "level0 files num";
+    case rocksdb::CompactionReason::kLevelMaxLevelSize: return "level size";
+    case rocksdb::CompactionReason::kUniversalSizeAmplification: return "size amplification";
+    case rocksdb::CompactionReason::kUniversalSizeRatio: return "size ratio";
+    case rocksdb::CompactionReason::kUniversalSortedRunNum: return "sorted run num";
+    case rocksdb::CompactionReason::kFIFOMaxSize: return "fifo max size";
+    case rocksdb::CompactionReason::kManualCompaction: return "manual";
+    case rocksdb::CompactionReason::kFilesMarkedForCompaction: return "files marked";
+    case rocksdb::CompactionReason::kUniversalExpiredFiles: return "expired files";
+  }
+  return "unknown";
+}
+
+} // namespace
+
+double TabletCompactionEvent::WriteAmplification() const {
+  if (is_flush || input_bytes == 0) {
+    return 0;
+  }
+  return static_cast<double>(output_bytes) / input_bytes;
+}
+
+TabletCompactionHistory::TabletCompactionHistory(
+    size_t max_events, scoped_refptr<AtomicGauge<double>> write_amplification,
+    scoped_refptr<AtomicGauge<uint64_t>> reclaimable_entries,
+    scoped_refptr<AtomicGauge<double>> reclaimable_ratio)
+    : max_events_(max_events), write_amplification_(std::move(write_amplification)),
+      reclaimable_entries_(std::move(reclaimable_entries)),
+      reclaimable_ratio_(std::move(reclaimable_ratio)) {
+}
+
+void TabletCompactionHistory::OnFlushCompleted(
+    rocksdb::DB* db, const rocksdb::FlushJobInfo& info) {
+  TabletCompactionEvent event;
+  event.is_flush = true;
+  event.reason = "flush";
+  event.status = "OK";
+  event.num_output_files = 1;
+  event.output_bytes = info.file_size;
+  event.num_output_records = info.table_properties.num_entries;
+  AddEvent(db, std::move(event));
+}
+
+void TabletCompactionHistory::OnCompactionCompleted(
+    rocksdb::DB* db, const rocksdb::CompactionJobInfo& info) {
+  const auto& stats = info.stats;
+  TabletCompactionEvent event;
+  event.reason = CompactionReasonToString(info.compaction_reason);
+  event.status = info.status.ToString();
+  event.elapsed_micros = stats.elapsed_micros;
+  event.num_input_files = stats.num_input_files;
+  event.num_output_files = stats.num_output_files;
+  event.input_bytes = stats.total_input_bytes;
+  event.output_bytes = stats.total_output_bytes;
+  event.num_input_records = stats.num_input_records;
+  event.num_output_records = stats.num_output_records;
+  event.num_records_dropped_by_filter = stats.num_records_dropped_by_filter;
+  event.bytes_dropped_by_filter = stats.total_bytes_dropped_by_filter;
+  AddEvent(db, std::move(event));
+}
+
+void TabletCompactionHistory::AddEvent(rocksdb::DB* db, TabletCompactionEvent event) {
+  event.finish_time_micros = GetCurrentTimeMicros();
+  const auto& rate_limiter = db->GetDBOptions().rate_limiter;
+  const int64_t total_wait_micros = rate_limiter ? rate_limiter->GetTotalWaitMicros() : 0;
+
+  double write_amplification;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    event.rate_limiter_wait_micros =
+        std::max<int64_t>(total_wait_micros - last_rate_limiter_wait_micros_, 0);
+    last_rate_limiter_wait_micros_ = total_wait_micros;
+    if (event.is_flush) {
+      flushed_bytes_ += event.output_bytes;
+    } else {
+      compacted_bytes_ += event.output_bytes;
+    }
+    write_amplification = WriteAmplificationUnlocked();
+
+    events_.push_front(std::move(event));
+    while (events_.size() > max_events_) {
+      events_.pop_back();
+    }
+  }
+  if (write_amplification_) {
+    write_amplification_->set_value(write_amplification);
+  }
+
+  if (reclaimable_entries_ || reclaimable_ratio_) {
+    auto estimate = docdb::GetGarbageEstimate(db);
+    if (!estimate.ok()) {
+      YB_LOG_EVERY_N(WARNING, 100) << "Failed to get garbage estimate: " << estimate.status();
+      return;
+    }
+    if (reclaimable_entries_) {
+      reclaimable_entries_->set_value(estimate->reclaimable_entries());
+    }
+    if (reclaimable_ratio_) {
+      reclaimable_ratio_->set_value(estimate->ReclaimableRatio());
+    }
+  }
+}
+
+std::vector<TabletCompactionEvent> TabletCompactionHistory::Events() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return std::vector<TabletCompactionEvent>(events_.begin(), events_.end());
+}
+
+double TabletCompactionHistory::CumulativeWriteAmplification() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return WriteAmplificationUnlocked();
+}
+
+double TabletCompactionHistory::WriteAmplificationUnlocked() const {
+  return flushed_bytes_ == 0
+      ? 0 : static_cast<double>(flushed_bytes_ + compacted_bytes_) / flushed_bytes_;
+}
+
+uint64_t TabletCompactionHistory::flushed_bytes() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return flushed_bytes_;
+}
+
+uint64_t TabletCompactionHistory::compacted_bytes() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return compacted_bytes_;
+}
+
+} // namespace tablet
+} // namespace yb
@@ -0,0 +1,102 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#ifndef YB_TABLET_TABLET_COMPACTION_HISTORY_H_
+#define YB_TABLET_TABLET_COMPACTION_HISTORY_H_
+
+#include <deque>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "yb/gutil/ref_counted.h"
+#include "yb/gutil/thread_annotations.h"
+
+#include "yb/rocksdb/listener.h"
+
+namespace yb {
+
+template<class T>
+class AtomicGauge;
+
+namespace tablet {
+
+// A flush or a compaction of the regular RocksDB of a tablet.
+struct TabletCompactionEvent {
+  bool is_flush = false;
+  // Wall clock time when the job finished.
+  int64_t finish_time_micros = 0;
+  std::string reason;
+  std::string status;
+  uint64_t elapsed_micros = 0;
+  size_t num_input_files = 0;
+  size_t num_output_files = 0;
+  uint64_t input_bytes = 0;
+  uint64_t output_bytes = 0;
+  uint64_t num_input_records = 0;
+  uint64_t num_output_records = 0;
+  uint64_t num_records_dropped_by_filter = 0;
+  uint64_t bytes_dropped_by_filter = 0;
+  // Time flushes and compactions of this DB spent waiting on the rate limiter since the previous
+  // event. Jobs run concurrently, so it could not be attributed to a single job precisely.
+  uint64_t rate_limiter_wait_micros = 0;
+
+  // Returns output bytes per input byte, 0 for flushes and for compactions without input.
+  double WriteAmplification() const;
+};
+
+// Keeps a bounded history of flushes and compactions of a tablet, and maintains cumulative write
+// amplification of the tablet: bytes written by flushes and compactions per byte flushed.
+// After every job the garbage estimate of the live SST files is exported to the gauges, if set.
+class TabletCompactionHistory : public rocksdb::EventListener {
+ public:
+  TabletCompactionHistory(size_t max_events,
+                          scoped_refptr<AtomicGauge<double>> write_amplification,
+                          scoped_refptr<AtomicGauge<uint64_t>> reclaimable_entries = nullptr,
+                          scoped_refptr<AtomicGauge<double>> reclaimable_ratio = nullptr);
+
+  void OnFlushCompleted(rocksdb::DB* db, const rocksdb::FlushJobInfo& info) override;
+
+  void OnCompactionCompleted(rocksdb::DB* db, const rocksdb::CompactionJobInfo& info) override;
+
+  // Returns recorded events, most recent first.
+  std::vector<TabletCompactionEvent> Events() const;
+
+  // Bytes written by flushes and compactions per byte flushed since tablet start.
+  double CumulativeWriteAmplification() const;
+
+  uint64_t flushed_bytes() const;
+
+  uint64_t compacted_bytes() const;
+
+ private:
+  void AddEvent(rocksdb::DB* db, TabletCompactionEvent event);
+
+  double WriteAmplificationUnlocked() const EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
+  const size_t max_events_;
+  scoped_refptr<AtomicGauge<double>> write_amplification_;
+  scoped_refptr<AtomicGauge<uint64_t>> reclaimable_entries_;
+  scoped_refptr<AtomicGauge<double>> reclaimable_ratio_;
+
+  mutable std::mutex mutex_;
+  std::deque<TabletCompactionEvent> events_ GUARDED_BY(mutex_);
+  uint64_t flushed_bytes_ GUARDED_BY(mutex_) = 0;
+  uint64_t compacted_bytes_ GUARDED_BY(mutex_) = 0;
+  int64_t last_rate_limiter_wait_micros_ GUARDED_BY(mutex_) = 0;
+};
+
+} // namespace tablet
+} // namespace yb
+
+#endif // YB_TABLET_TABLET_COMPACTION_HISTORY_H_
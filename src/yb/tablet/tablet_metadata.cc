@@ -33,6 +33,7 @@
 #include "yb/tablet/tablet_metadata.h"
 
 #include <algorithm>
+#include <limits>
 #include <mutex>
 #include <string>
 
@@ -68,6 +69,12 @@ TAG_FLAG(enable_tablet_orphaned_block_deletion, advanced);
 TAG_FLAG(enable_tablet_orphaned_block_deletion, hidden);
 TAG_FLAG(enable_tablet_orphaned_block_deletion, runtime);
 
+DEFINE_string(rocksdb_cold_data_dir, "",
+              "Directory on a cheaper storage device where compactions place SST files whose "
+              "data is older than --rocksdb_cold_data_age_threshold_sec. Empty to keep all SST "
+              "files in the tablet data directory.");
+TAG_FLAG(rocksdb_cold_data_dir, advanced);
+
 using std::shared_ptr;
 
 using base::subtle::Barrier_AtomicIncrement;
@@ -82,6 +89,7 @@ namespace tablet {
 const int64 kNoDurableMemStore = -1;
 const std::string kIntentsSubdir = "intents";
 const std::string kIntentsDBSuffix = ".intents";
+const std::string kCheckpointManifestFileName = "checkpoint_manifest.pb";
 
 // ============================================================================
 //  Tablet Metadata
@@ -341,6 +349,16 @@ Result<TableInfo*> TabletMetadata::GetTableInfo(const std::string& table_id) {
   return iter->second.get();
 }
 
+std::string TabletMetadata::cold_rocksdb_dir() const {
+  if (FLAGS_rocksdb_cold_data_dir.empty() || rocksdb_dir_.empty()) {
+    return std::string();
+  }
+  // Mirror the table-<uuid>/tablet-<uuid> layout of the regular data directory.
+  return JoinPathSegments(
+      FLAGS_rocksdb_cold_data_dir, FsManager::kRocksDBDirName, BaseName(DirName(rocksdb_dir_)),
+      BaseName(rocksdb_dir_));
+}
+
 Status TabletMetadata::DeleteTabletData(TabletDataState delete_type,
                                         const yb::OpId& last_logged_opid) {
   CHECK(delete_type == TABLET_DATA_DELETED ||
@@ -368,8 +386,20 @@ Status TabletMetadata::DeleteTabletData(TabletDataState delete_type,
   docdb::InitRocksDBOptions(
       &rocksdb_options, log_prefix, nullptr /* statistics */, tablet_options);
 
+  const auto cold_dir = cold_rocksdb_dir();
+  if (!cold_dir.empty()) {
+    rocksdb_options.db_paths = {
+        {rocksdb_dir_, std::numeric_limits<uint64_t>::max()},
+        {cold_dir, std::numeric_limits<uint64_t>::max()}};
+  }
+
   LOG(INFO) << "Destroying regular db at: " << rocksdb_dir_;
   rocksdb::Status status = rocksdb::DestroyDB(rocksdb_dir_, rocksdb_options);
+  rocksdb_options.db_paths.clear();
+  if (!cold_dir.empty() && fs_manager_->env()->FileExists(cold_dir)) {
+    WARN_NOT_OK(fs_manager_->env()->DeleteRecursively(cold_dir),
+                Format("Failed to delete cold data dir $0", cold_dir));
+  }
 
   if (!status.ok()) {
     LOG(ERROR) << "Failed to destroy regular DB at: " << rocksdb_dir_ << ": " << status;
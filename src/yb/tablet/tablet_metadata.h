@@ -253,6 +253,10 @@ class TabletMetadata : public RefCountedThreadSafe<TabletMetadata> {
 
   std::string rocksdb_dir() const { return rocksdb_dir_; }
 
+  // The directory for the SST files of this tablet that are old enough to be moved to the cold
+  // storage. Empty if --rocksdb_cold_data_dir is not specified.
+  std::string cold_rocksdb_dir() const;
+
   std::string wal_dir() const { return wal_dir_; }
 
   // Given the data directory of a tablet, returns the data root dir for that tablet.
@@ -443,6 +447,7 @@ class TabletMetadata : public RefCountedThreadSafe<TabletMetadata> {
 
 extern const std::string kIntentsSubdir;
 extern const std::string kIntentsDBSuffix;
+extern const std::string kCheckpointManifestFileName;
 
 } // namespace tablet
 } // namespace yb
@@ -114,6 +114,12 @@ METRIC_DEFINE_counter(tablet, leader_memory_pressure_rejections,
   yb::MetricUnit::kRequests,
   "Number of RPC requests rejected due to memory pressure while LEADER.");
 
+METRIC_DEFINE_counter(tablet, write_throttle_rejections,
+  "Write Throttle Rejections",
+  yb::MetricUnit::kRequests,
+  "Number of write RPC requests rejected with a retry-after hint because the tablet's RocksDB "
+  "is close to stalling writes.");
+
 METRIC_DEFINE_counter(tablet, transaction_conflicts,
   "Distributed Transaction Conflicts",
   yb::MetricUnit::kRequests,
@@ -129,12 +135,70 @@ METRIC_DEFINE_counter(tablet, restart_read_requests,
   yb::MetricUnit::kRequests,
   "Number of read requests that require restart.");
 
+METRIC_DEFINE_counter(tablet, sampled_reads,
+  "Sampled Reads",
+  yb::MetricUnit::kRequests,
+  "Number of read requests whose RocksDB perf context was collected.");
+
+METRIC_DEFINE_counter(tablet, sampled_read_block_cache_hits,
+  "Sampled Read Block Cache Hits",
+  yb::MetricUnit::kCacheHits,
+  "Number of block cache hits of the sampled read requests.");
+
+METRIC_DEFINE_counter(tablet, sampled_read_block_reads,
+  "Sampled Read Block Reads",
+  yb::MetricUnit::kBlocks,
+  "Number of blocks read from SST files by the sampled read requests.");
+
+METRIC_DEFINE_counter(tablet, sampled_read_block_read_time,
+  "Sampled Read Block Read Time",
+  yb::MetricUnit::kMicroseconds,
+  "Time spent by the sampled read requests reading blocks from SST files.");
+
+METRIC_DEFINE_counter(tablet, sampled_read_block_decompress_time,
+  "Sampled Read Block Decompress Time",
+  yb::MetricUnit::kMicroseconds,
+  "Time spent by the sampled read requests decompressing blocks.");
+
+METRIC_DEFINE_counter(tablet, sampled_read_bloom_filtered_files,
+  "Sampled Read Bloom Filtered Files",
+  yb::MetricUnit::kProbes,
+  "Number of SST files skipped by the sampled read requests due to their bloom filters.");
+
+METRIC_DEFINE_counter(tablet, sampled_read_memtable_seek_time,
+  "Sampled Read Memtable Seek Time",
+  yb::MetricUnit::kMicroseconds,
+  "Time spent by the sampled read requests seeking in memtables.");
+
+METRIC_DEFINE_counter(tablet, sampled_read_internal_keys_skipped,
+  "Sampled Read Internal Keys Skipped",
+  yb::MetricUnit::kEntries,
+  "Number of overwritten or deleted RocksDB entries skipped by the sampled read requests.");
+
+METRIC_DEFINE_gauge_double(tablet, rocksdb_write_amplification,
+  "RocksDB Write Amplification",
+  yb::MetricUnit::kUnits,
+  "Bytes written by flushes and compactions of the regular RocksDB per byte flushed since "
+  "tablet start.");
+
+METRIC_DEFINE_gauge_uint64(tablet, rocksdb_reclaimable_entries,
+  "RocksDB Reclaimable Entries",
+  yb::MetricUnit::kEntries,
+  "Estimated number of overwritten, expired and deleted entries in the regular RocksDB that "
+  "compactions could remove.");
+
+METRIC_DEFINE_gauge_double(tablet, rocksdb_reclaimable_ratio,
+  "RocksDB Reclaimable Ratio",
+  yb::MetricUnit::kUnits,
+  "Estimated ratio of entries in the regular RocksDB that compactions could remove.");
+
 using strings::Substitute;
 
 namespace yb {
 namespace tablet {
 
 #define MINIT(x) x(METRIC_##x.Instantiate(entity))
+#define GINIT(x) x(METRIC_##x.Instantiate(entity, 0))
 TabletMetrics::TabletMetrics(const scoped_refptr<MetricEntity>& entity)
   : MINIT(snapshot_read_inflight_wait_duration),
     MINIT(redis_read_latency),
@@ -143,10 +207,23 @@ TabletMetrics::TabletMetrics(const scoped_refptr<MetricEntity>& entity)
     MINIT(write_op_duration_client_propagated_consistency),
     MINIT(not_leader_rejections),
     MINIT(leader_memory_pressure_rejections),
+    MINIT(write_throttle_rejections),
     MINIT(transaction_conflicts),
     MINIT(expired_transactions),
-    MINIT(restart_read_requests) {
+    MINIT(restart_read_requests),
+    MINIT(sampled_reads),
+    MINIT(sampled_read_block_cache_hits),
+    MINIT(sampled_read_block_reads),
+    MINIT(sampled_read_block_read_time),
+    MINIT(sampled_read_block_decompress_time),
+    MINIT(sampled_read_bloom_filtered_files),
+    MINIT(sampled_read_memtable_seek_time),
+    MINIT(sampled_read_internal_keys_skipped),
+    GINIT(rocksdb_write_amplification),
+    GINIT(rocksdb_reclaimable_entries),
+    GINIT(rocksdb_reclaimable_ratio) {
 }
+#undef GINIT
 #undef MINIT
 
 ScopedTabletMetricsTracker::ScopedTabletMetricsTracker(scoped_refptr<Histogram> latency)
@@ -62,9 +62,24 @@ struct TabletMetrics {
 
   scoped_refptr<Counter> not_leader_rejections;
   scoped_refptr<Counter> leader_memory_pressure_rejections;
+  scoped_refptr<Counter> write_throttle_rejections;
   scoped_refptr<Counter> transaction_conflicts;
   scoped_refptr<Counter> expired_transactions;
   scoped_refptr<Counter> restart_read_requests;
+
+  // RocksDB perf context counters of the reads sampled by FLAGS_read_perf_level.
+  scoped_refptr<Counter> sampled_reads;
+  scoped_refptr<Counter> sampled_read_block_cache_hits;
+  scoped_refptr<Counter> sampled_read_block_reads;
+  scoped_refptr<Counter> sampled_read_block_read_time;
+  scoped_refptr<Counter> sampled_read_block_decompress_time;
+  scoped_refptr<Counter> sampled_read_bloom_filtered_files;
+  scoped_refptr<Counter> sampled_read_memtable_seek_time;
+  scoped_refptr<Counter> sampled_read_internal_keys_skipped;
+
+  scoped_refptr<AtomicGauge<double>> rocksdb_write_amplification;
+  scoped_refptr<AtomicGauge<uint64_t>> rocksdb_reclaimable_entries;
+  scoped_refptr<AtomicGauge<double>> rocksdb_reclaimable_ratio;
 };
 
 class ScopedTabletMetricsTracker {
@@ -71,6 +71,7 @@
 #include "yb/tablet/tablet_peer_mm_ops.h"
 
 #include "yb/tablet/operations/change_metadata_operation.h"
+#include "yb/tablet/operations/ingest_sst_operation.h"
 #include "yb/tablet/operations/operation_driver.h"
 #include "yb/tablet/operations/truncate_operation.h"
 #include "yb/tablet/operations/write_operation.h"
@@ -230,6 +231,7 @@ Status TabletPeer::InitTabletPeer(const shared_ptr<TabletClass> &tablet,
 
     if (retryable_requests) {
       retryable_requests->SetMetricEntity(tablet->GetMetricEntity());
+      retryable_requests->SetMemTracker(tablet->mem_tracker());
     }
 
     consensus_ = RaftConsensus::Create(
@@ -272,7 +274,8 @@ Status TabletPeer::InitTabletPeer(const shared_ptr<TabletClass> &tablet,
       return mvcc_manager->SafeTime(ht_lease);
     });
 
-    prepare_thread_ = std::make_unique<Preparer>(consensus_.get(), tablet_prepare_pool);
+    prepare_thread_ = std::make_unique<Preparer>(
+        consensus_.get(), tablet_prepare_pool, tablet_->GetMetricEntity());
 
     consensus_->SetMajorityReplicatedListener([mvcc_manager, ht_lease_provider] {
       auto ht_lease = ht_lease_provider(/* min_allowed */ 0, /* deadline */ CoarseTimePoint::max());
@@ -488,6 +491,13 @@ void TabletPeer::WriteAsync(
     return;
   }
 
+  status = tablet_->WakeUpIfHibernated();
+  if (!status.ok()) {
+    preparing_operations_.fetch_sub(1, std::memory_order_acq_rel);
+    state->CompleteWithStatus(status);
+    return;
+  }
+
   auto operation = std::make_unique<WriteOperation>(std::move(state), term, deadline, this);
   tablet_->AcquireLocksAndPerformDocOperations(std::move(operation));
 }
@@ -604,6 +614,9 @@ consensus::OperationType MapOperationTypeToPB(OperationType operation_type) {
     case OperationType::kTruncate:
       return consensus::TRUNCATE_OP;
 
+    case OperationType::kIngestSst:
+      return consensus::INGEST_SST_OP;
+
     case OperationType::kEmpty:
       LOG(FATAL) << "OperationType::kEmpty cannot be converted to consensus::OperationType";
   }
@@ -726,6 +739,13 @@ Status TabletPeer::GetGCableDataSize(int64_t* retention_size) const {
   return Status::OK();
 }
 
+Status TabletPeer::GetRetainedLogDataSize(int64_t* retained_size) const {
+  int64_t gcable_size;
+  RETURN_NOT_OK(GetGCableDataSize(&gcable_size));
+  *retained_size = std::max<int64_t>(static_cast<int64_t>(log_->OnDiskSize()) - gcable_size, 0);
+  return Status::OK();
+}
+
 log::Log* TabletPeer::log() const {
   Log* log = log_atomic_.load(std::memory_order_acquire);
   LOG_IF_WITH_PREFIX(FATAL, !log) << "log() called before the log instance is initialized.";
@@ -767,6 +787,12 @@ std::unique_ptr<Operation> TabletPeer::CreateOperation(consensus::ReplicateMsg*
       return std::make_unique<TruncateOperation>(
           std::make_unique<TruncateOperationState>(tablet()));
 
+    case consensus::INGEST_SST_OP:
+      DCHECK(replicate_msg->has_ingest_sst_request()) << "INGEST_SST_OP replica"
+          " operation must receive an IngestSstFileRequestPB";
+      return std::make_unique<IngestSstOperation>(
+          std::make_unique<IngestSstOperationState>(tablet()));
+
     case consensus::SNAPSHOT_OP: FALLTHROUGH_INTENDED;
     case consensus::UNKNOWN_OP: FALLTHROUGH_INTENDED;
     case consensus::NO_OP: FALLTHROUGH_INTENDED;
@@ -822,6 +848,20 @@ void TabletPeer::SetPropagatedSafeTime(HybridTime ht) {
   (**driver).ExecuteAsync();
 }
 
+void TabletPeer::StartApplyGroup() {
+  auto tablet = shared_tablet();
+  if (tablet) {
+    tablet->StartApplyGroup();
+  }
+}
+
+void TabletPeer::FinishApplyGroup() {
+  auto tablet = shared_tablet();
+  if (tablet) {
+    tablet->FinishApplyGroup();
+  }
+}
+
 consensus::Consensus* TabletPeer::consensus() const {
   std::lock_guard<simple_spinlock> lock(lock_);
   return consensus_.get();
@@ -844,6 +884,9 @@ Result<OperationDriverPtr> TabletPeer::NewReplicaOperationDriver(
 
 Result<OperationDriverPtr> TabletPeer::NewOperationDriver(std::unique_ptr<Operation>* operation,
                                                           int64_t term) {
+  // Operations of both the leader and followers are started here, so this is where a hibernated
+  // tablet is woken up before they are prepared and applied.
+  RETURN_NOT_OK(tablet_->WakeUpIfHibernated());
   auto operation_driver = CreateOperationDriver();
   RETURN_NOT_OK(operation_driver->Init(operation, term));
   return operation_driver;
@@ -175,6 +175,9 @@ class TabletPeer : public consensus::ReplicaOperationFactory,
   // UpdateReplica -> EnqueuePreparesUnlocked on Raft heartbeats.
   void SetPropagatedSafeTime(HybridTime ht) override;
 
+  void StartApplyGroup() override;
+  void FinishApplyGroup() override;
+
   consensus::Consensus* consensus() const;
 
   std::shared_ptr<consensus::Consensus> shared_consensus() const;
@@ -248,6 +251,12 @@ class TabletPeer : public consensus::ReplicaOperationFactory,
   // Returns a non-ok status if the tablet isn't running.
   CHECKED_STATUS GetGCableDataSize(int64_t* retention_size) const;
 
+  // Returns the amount of bytes of log that cannot be GC'd yet, i.e. that would be replayed if the
+  // tablet was bootstrapped now.
+  //
+  // Returns a non-ok status if the tablet isn't running.
+  CHECKED_STATUS GetRetainedLogDataSize(int64_t* retained_size) const;
+
   // Returns true if it is safe to retrieve the log pointer using the log() function from this
   // tablet peer. Once the log pointer is initialized, it will stay valid for the lifetime of the
   // TabletPeer.
@@ -21,6 +21,8 @@
 #include <boost/multi_index_container.hpp>
 #include <boost/multi_index/hashed_index.hpp>
 #include <boost/multi_index/mem_fun.hpp>
+#include <boost/multi_index/member.hpp>
+#include <boost/multi_index/sequenced_index.hpp>
 
 #include <boost/optional/optional.hpp>
 
@@ -42,7 +44,9 @@
 
 #include "yb/tserver/tserver_service.pb.h"
 
+#include "yb/util/flag_tags.h"
 #include "yb/util/locks.h"
+#include "yb/util/metrics.h"
 #include "yb/util/monotime.h"
 #include "yb/util/random_util.h"
 
@@ -55,6 +59,27 @@ DEFINE_uint64(transaction_delay_status_reply_usec_in_tests, 0,
               "For tests only. Delay handling status reply by specified amount of usec.");
 DEFINE_double(transaction_ignore_applying_probability_in_tests, 0,
               "Probability to ignore APPLYING update in tests.");
+DEFINE_int32(transaction_resolved_status_cache_size, 10000,
+             "Max number of committed or aborted transactions, whose final status is cached by "
+             "the transaction participant of a tablet until their intents are applied or "
+             "removed. 0 disables the cache.");
+TAG_FLAG(transaction_resolved_status_cache_size, advanced);
+DEFINE_int32(transaction_status_max_batch_size, 1000,
+             "Max number of transactions, whose status is requested from the same status tablet "
+             "by a single GetTransactionStatus RPC.");
+TAG_FLAG(transaction_status_max_batch_size, advanced);
+TAG_FLAG(transaction_status_max_batch_size, runtime);
+
+METRIC_DEFINE_counter(tablet, transaction_status_cache_hits,
+                      "Transaction Status Cache Hits",
+                      yb::MetricUnit::kRequests,
+                      "Number of transaction status requests answered from the tablet cache of "
+                      "committed and aborted transactions.");
+METRIC_DEFINE_counter(tablet, transaction_status_cache_misses,
+                      "Transaction Status Cache Misses",
+                      yb::MetricUnit::kRequests,
+                      "Number of transaction status requests not found in the tablet cache of "
+                      "committed and aborted transactions.");
 
 namespace yb {
 namespace tablet {
@@ -130,69 +155,264 @@ class RunningTransaction;
 
 typedef std::shared_ptr<RunningTransaction> RunningTransactionPtr;
 
-class RunningTransactionContext {
- public:
-  RunningTransactionContext(TransactionParticipantContext* participant_context,
-                            TransactionIntentApplier* applier)
-      : participant_context_(*participant_context), applier_(*applier) {
+// Returns status of transaction at specified time, using its last known status.
+// Returns none if the status at this time cannot be determined.
+boost::optional<TransactionStatus> GetStatusAt(
+    HybridTime time,
+    HybridTime last_known_status_hybrid_time,
+    TransactionStatus last_known_status) {
+  switch (last_known_status) {
+    case TransactionStatus::ABORTED:
+      return TransactionStatus::ABORTED;
+    case TransactionStatus::COMMITTED:
+      return last_known_status_hybrid_time > time
+          ? TransactionStatus::PENDING
+          : TransactionStatus::COMMITTED;
+    case TransactionStatus::PENDING:
+      if (last_known_status_hybrid_time >= time) {
+        return TransactionStatus::PENDING;
+      }
+      return boost::none;
+    default:
+      FATAL_INVALID_ENUM_VALUE(TransactionStatus, last_known_status);
   }
+}
 
-  virtual ~RunningTransactionContext() {}
+// Removes intents of aborted transactions. Transactions that are added while the task is
+// queued or running are removed together, with a single RocksDB write when they are small.
+class RemoveIntentsTask : public rpc::ThreadPoolTask,
+                          public std::enable_shared_from_this<RemoveIntentsTask> {
+ public:
+  RemoveIntentsTask(TransactionIntentApplier* applier, TransactionParticipantContext* context)
+      : applier_(*applier), context_(*context) {}
 
-  virtual bool RemoveUnlocked(const TransactionId& id) = 0;
+  void Add(const TransactionId& id) {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      transactions_.insert(id);
+      if (retain_self_) {
+        // Already scheduled.
+        return;
+      }
+      retain_self_ = shared_from_this();
+    }
+    if (!context_.Enqueue(this)) {
+      std::shared_ptr<RemoveIntentsTask> self;
+      std::lock_guard<std::mutex> lock(mutex_);
+      transactions_.clear();
+      self = std::move(retain_self_);
+    }
+  }
 
-  int64_t NextRequestIdUnlocked() {
-    return ++request_serial_;
+  void Run() override {
+    TransactionIdSet transactions;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      transactions.swap(transactions_);
+    }
+    if (!transactions.empty() && context_.IsLeader()) {
+      auto status = applier_.RemoveIntents(transactions);
+      LOG_IF(WARNING, !status.ok()) << "Failed to remove intents of " << transactions.size()
+                                    << " aborted transactions: " << status;
+    }
   }
 
-  virtual const std::string& LogPrefix() const = 0;
+  void Done(const Status& status) override {
+    std::shared_ptr<RemoveIntentsTask> self;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (transactions_.empty()) {
+        self = std::move(retain_self_);
+        return;
+      }
+    }
+    // Transactions were added while running, so run again.
+    if (!context_.Enqueue(this)) {
+      std::lock_guard<std::mutex> lock(mutex_);
+      transactions_.clear();
+      self = std::move(retain_self_);
+    }
+  }
 
- protected:
-  friend class RunningTransaction;
+  virtual ~RemoveIntentsTask() {}
 
-  rpc::Rpcs rpcs_;
-  TransactionParticipantContext& participant_context_;
+ private:
   TransactionIntentApplier& applier_;
-  int64_t request_serial_ = 0;
+  TransactionParticipantContext& context_;
   std::mutex mutex_;
+  TransactionIdSet transactions_;
+  // Set while the task is scheduled.
+  std::shared_ptr<RemoveIntentsTask> retain_self_;
 };
 
-class RemoveIntentsTask : public rpc::ThreadPoolTask {
+// Requests statuses of transactions from their status tablets. At most one GetTransactionStatus
+// RPC is outstanding per status tablet, requests that are made while it is outstanding are sent
+// together by the next RPC. So the number of RPCs stays bounded under a high number of concurrent
+// transactions, while a lone request is sent without delay.
+class TransactionStatusBatcher {
  public:
-  RemoveIntentsTask(TransactionIntentApplier* applier, TransactionParticipantContext* context,
-                    const TransactionId& id)
-      : applier_(*applier), context_(*context), id_(id) {}
+  TransactionStatusBatcher(TransactionParticipantContext* participant_context, rpc::Rpcs* rpcs)
+      : participant_context_(*participant_context), rpcs_(*rpcs) {}
 
-  bool Prepare(RunningTransactionPtr transaction) {
-    bool expected = false;
-    if (!used_.compare_exchange_strong(expected, true, std::memory_order_acq_rel)) {
-      return false;
+  void Request(client::YBClient* client, const TabletId& status_tablet, const TransactionId& id,
+               TransactionStatusCallback callback) {
+    tserver::GetTransactionStatusRequestPB req;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      auto it = tablets_.find(status_tablet);
+      if (it == tablets_.end()) {
+        it = tablets_.emplace(status_tablet, TabletRequests(rpcs_.InvalidHandle())).first;
+      }
+      auto& tablet = it->second;
+      tablet.waiters.push_back(Waiter{id, std::move(callback)});
+      if (tablet.in_flight) {
+        return;
+      }
+      PrepareRequestUnlocked(status_tablet, &tablet, &req);
     }
+    Send(client, status_tablet, &req);
+  }
+
+ private:
+  struct Waiter {
+    TransactionId id;
+    TransactionStatusCallback callback;
+  };
+
+  struct TabletRequests {
+    explicit TabletRequests(rpc::Rpcs::Handle invalid_handle) : handle(invalid_handle) {}
 
-    transaction_ = std::move(transaction);
-    return true;
+    // Waiters that were not sent yet.
+    std::vector<Waiter> waiters;
+    // Waiters of the outstanding RPC.
+    std::vector<Waiter> sent;
+    bool in_flight = false;
+    rpc::Rpcs::Handle handle;
+  };
+
+  void PrepareRequestUnlocked(const TabletId& status_tablet, TabletRequests* tablet,
+                              tserver::GetTransactionStatusRequestPB* req) {
+    const size_t max_batch_size = std::max(FLAGS_transaction_status_max_batch_size, 1);
+    if (tablet->waiters.size() <= max_batch_size) {
+      tablet->sent.swap(tablet->waiters);
+    } else {
+      auto end = tablet->waiters.begin() + max_batch_size;
+      tablet->sent.assign(std::make_move_iterator(tablet->waiters.begin()),
+                          std::make_move_iterator(end));
+      tablet->waiters.erase(tablet->waiters.begin(), end);
+    }
+    tablet->in_flight = true;
+
+    req->set_tablet_id(status_tablet);
+    for (const auto& waiter : tablet->sent) {
+      req->add_transaction_id(waiter.id.begin(), waiter.id.size());
+    }
+    req->set_propagated_hybrid_time(participant_context_.Now().ToUint64());
   }
 
-  void Run() override {
-    if (context_.IsLeader()) {
-      auto status = applier_.RemoveIntents(id_);
-      LOG_IF(WARNING, !status.ok()) << "Failed to remove intents of aborted transaction " << id_
-                                    << ": " << status;
+  void Send(client::YBClient* client, const TabletId& status_tablet,
+            tserver::GetTransactionStatusRequestPB* req) {
+    rpc::Rpcs::Handle* handle;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      handle = &tablets_.find(status_tablet)->second.handle;
     }
+    rpcs_.RegisterAndStart(
+        client::GetTransactionStatus(
+            TransactionRpcDeadline(),
+            nullptr /* tablet */,
+            client,
+            req,
+            std::bind(&TransactionStatusBatcher::StatusReceived, this, client, status_tablet,
+                      _1, _2)),
+        handle);
   }
 
-  void Done(const Status& status) override {
-    transaction_.reset();
+  void StatusReceived(client::YBClient* client,
+                      const TabletId& status_tablet,
+                      Status status,
+                      const tserver::GetTransactionStatusResponsePB& response) {
+    if (response.has_propagated_hybrid_time()) {
+      participant_context_.UpdateClock(HybridTime(response.propagated_hybrid_time()));
+    }
+
+    std::vector<Waiter> waiters;
+    tserver::GetTransactionStatusRequestPB req;
+    bool send_next = false;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      auto& tablet = tablets_.find(status_tablet)->second;
+      rpcs_.Unregister(&tablet.handle);
+      waiters.swap(tablet.sent);
+      tablet.in_flight = false;
+      if (!tablet.waiters.empty()) {
+        PrepareRequestUnlocked(status_tablet, &tablet, &req);
+        send_next = true;
+      }
+    }
+    if (send_next) {
+      Send(client, status_tablet, &req);
+    }
+
+    if (status.ok() && implicit_cast<size_t>(response.status().size()) != waiters.size()) {
+      status = STATUS_FORMAT(
+          IllegalState, "Wrong number of statuses in response for $0 transactions: $1",
+          waiters.size(), response.ShortDebugString());
+    }
+    for (size_t i = 0; i != waiters.size(); ++i) {
+      if (!status.ok()) {
+        waiters[i].callback(status);
+        continue;
+      }
+      auto transaction_status = response.status(i);
+      DCHECK(implicit_cast<size_t>(response.status_hybrid_time().size()) > i ||
+             transaction_status == TransactionStatus::ABORTED);
+      auto status_time = implicit_cast<size_t>(response.status_hybrid_time().size()) > i
+          ? HybridTime(response.status_hybrid_time(i))
+          : HybridTime::kMax;
+      waiters[i].callback(TransactionStatusResult(transaction_status, status_time));
+    }
   }
 
-  virtual ~RemoveIntentsTask() {}
+  TransactionParticipantContext& participant_context_;
+  rpc::Rpcs& rpcs_;
+  std::mutex mutex_;
+  std::unordered_map<TabletId, TabletRequests> tablets_;
+};
 
- private:
+class RunningTransactionContext {
+ public:
+  RunningTransactionContext(TransactionParticipantContext* participant_context,
+                            TransactionIntentApplier* applier)
+      : participant_context_(*participant_context), applier_(*applier),
+        remove_intents_task_(std::make_shared<RemoveIntentsTask>(applier, participant_context)),
+        status_batcher_(participant_context, &rpcs_) {
+  }
+
+  virtual ~RunningTransactionContext() {}
+
+  virtual bool RemoveUnlocked(const TransactionId& id) = 0;
+
+  // Invoked when final status (committed or aborted) of transaction becomes known.
+  virtual void TransactionResolved(
+      const TransactionId& id, TransactionStatus status, HybridTime status_time) = 0;
+
+  int64_t NextRequestIdUnlocked() {
+    return ++request_serial_;
+  }
+
+  virtual const std::string& LogPrefix() const = 0;
+
+ protected:
+  friend class RunningTransaction;
+
+  rpc::Rpcs rpcs_;
+  TransactionParticipantContext& participant_context_;
   TransactionIntentApplier& applier_;
-  TransactionParticipantContext& context_;
-  TransactionId id_;
-  std::atomic<bool> used_{false};
-  RunningTransactionPtr transaction_;
+  std::shared_ptr<RemoveIntentsTask> remove_intents_task_;
+  TransactionStatusBatcher status_batcher_;
+  int64_t request_serial_ = 0;
+  std::mutex mutex_;
 };
 
 class CleanupAbortsTask : public rpc::ThreadPoolTask {
@@ -334,14 +554,11 @@ class RunningTransaction : public std::enable_shared_from_this<RunningTransactio
       : metadata_(std::move(metadata)),
         last_write_id_(last_write_id),
         context_(*context),
-        remove_intents_task_(&context->applier_, &context->participant_context_,
-                             metadata_.transaction_id),
-        get_status_handle_(context->rpcs_.InvalidHandle()),
         abort_handle_(context->rpcs_.InvalidHandle()) {
   }
 
   ~RunningTransaction() {
-    context_.rpcs_.Abort({&get_status_handle_, &abort_handle_});
+    context_.rpcs_.Abort({&abort_handle_});
   }
 
   const TransactionId& id() const {
@@ -425,97 +642,59 @@ class RunningTransaction : public std::enable_shared_from_this<RunningTransactio
   }
 
  private:
-  static boost::optional<TransactionStatus> GetStatusAt(
-      HybridTime time,
-      HybridTime last_known_status_hybrid_time,
-      TransactionStatus last_known_status) {
-    switch (last_known_status) {
-      case TransactionStatus::ABORTED:
-        return TransactionStatus::ABORTED;
-      case TransactionStatus::COMMITTED:
-        return last_known_status_hybrid_time > time
-            ? TransactionStatus::PENDING
-            : TransactionStatus::COMMITTED;
-      case TransactionStatus::PENDING:
-        if (last_known_status_hybrid_time >= time) {
-          return TransactionStatus::PENDING;
-        }
-        return boost::none;
-      default:
-        FATAL_INVALID_ENUM_VALUE(TransactionStatus, last_known_status);
-    }
-  }
-
   void SendStatusRequest(
       client::YBClient* client, int64_t serial_no, const RunningTransactionPtr& shared_self) {
-    tserver::GetTransactionStatusRequestPB req;
-    req.set_tablet_id(metadata_.status_tablet);
-    req.set_transaction_id(metadata_.transaction_id.begin(), metadata_.transaction_id.size());
-    req.set_propagated_hybrid_time(context_.participant_context_.Now().ToUint64());
-    context_.rpcs_.RegisterAndStart(
-        client::GetTransactionStatus(
-            TransactionRpcDeadline(),
-            nullptr /* tablet */,
-            client,
-            &req,
-            std::bind(&RunningTransaction::StatusReceived, this, client, _1, _2, serial_no,
-                      shared_self)),
-        &get_status_handle_);
+    context_.status_batcher_.Request(
+        client, metadata_.status_tablet, metadata_.transaction_id,
+        std::bind(&RunningTransaction::StatusReceived, this, client, _1, serial_no, shared_self));
   }
 
   void StatusReceived(client::YBClient* client,
-                      const Status& status,
-                      const tserver::GetTransactionStatusResponsePB& response,
+                      const Result<TransactionStatusResult>& result,
                       int64_t serial_no,
                       const RunningTransactionPtr& shared_self) {
     auto delay_usec = FLAGS_transaction_delay_status_reply_usec_in_tests;
     if (delay_usec > 0) {
       delayer_.Delay(
           MonoTime::Now() + MonoDelta::FromMicroseconds(delay_usec),
-          std::bind(&RunningTransaction::DoStatusReceived, this, client, status, response,
-                    serial_no, shared_self));
+          std::bind(&RunningTransaction::DoStatusReceived, this, client, result, serial_no,
+                    shared_self));
     } else {
-      DoStatusReceived(client, status, response, serial_no, shared_self);
+      DoStatusReceived(client, result, serial_no, shared_self);
     }
   }
 
   void DoStatusReceived(client::YBClient* client,
-                        const Status& status,
-                        const tserver::GetTransactionStatusResponsePB& response,
+                        const Result<TransactionStatusResult>& result,
                         int64_t serial_no,
                         const RunningTransactionPtr& shared_self) {
-    if (response.has_propagated_hybrid_time()) {
-      context_.participant_context_.UpdateClock(HybridTime(response.propagated_hybrid_time()));
-    }
-
-    context_.rpcs_.Unregister(&get_status_handle_);
     decltype(status_waiters_) status_waiters;
     HybridTime time_of_status;
     TransactionStatus transaction_status;
-    const bool ok = status.ok();
     int64_t new_request_id = -1;
     {
       std::unique_lock<std::mutex> lock(context_.mutex_);
-      if (!ok) {
+      if (!result.ok()) {
         status_waiters_.swap(status_waiters);
         lock.unlock();
         for (const auto& waiter : status_waiters) {
-          waiter.callback(status);
+          waiter.callback(result.status());
         }
         return;
       }
 
-      DCHECK(response.has_status_hybrid_time() ||
-             response.status() == TransactionStatus::ABORTED);
-      time_of_status = response.has_status_hybrid_time()
-          ? HybridTime(response.status_hybrid_time())
-          : HybridTime::kMax;
+      time_of_status = result->status_time;
       if (last_known_status_hybrid_time_ <= time_of_status) {
         last_known_status_hybrid_time_ = time_of_status;
-        last_known_status_ = response.status();
-        if (response.status() == TransactionStatus::ABORTED) {
-          if (!local_commit_time_ && remove_intents_task_.Prepare(shared_self)) {
-            context_.participant_context_.Enqueue(&remove_intents_task_);
+        last_known_status_ = result->status;
+        if (result->status == TransactionStatus::COMMITTED ||
+            result->status == TransactionStatus::ABORTED) {
+          context_.TransactionResolved(id(), result->status, time_of_status);
+        }
+        if (result->status == TransactionStatus::ABORTED) {
+          if (!local_commit_time_ &&
+              !removing_intents_.exchange(true, std::memory_order_acq_rel)) {
+            context_.remove_intents_task_->Add(id());
             VLOG_WITH_PREFIX(1) << "Transaction should be aborted: " << id();
           }
           context_.RemoveUnlocked(id());
@@ -629,13 +808,12 @@ class RunningTransaction : public std::enable_shared_from_this<RunningTransactio
   TransactionMetadata metadata_;
   IntraTxnWriteId last_write_id_ = 0;
   RunningTransactionContext& context_;
-  RemoveIntentsTask remove_intents_task_;
+  std::atomic<bool> removing_intents_{false};
   HybridTime local_commit_time_ = HybridTime::kInvalid;
 
   TransactionStatus last_known_status_;
   HybridTime last_known_status_hybrid_time_ = HybridTime::kMin;
   std::vector<StatusRequest> status_waiters_;
-  rpc::Rpcs::Handle get_status_handle_;
   rpc::Rpcs::Handle abort_handle_;
   std::vector<TransactionStatusCallback> abort_waiters_;
 
@@ -653,10 +831,15 @@ std::string TransactionApplyData::ToString() const {
 
 class TransactionParticipant::Impl : public RunningTransactionContext {
  public:
-  explicit Impl(TransactionParticipantContext* context, TransactionIntentApplier* applier)
+  Impl(TransactionParticipantContext* context, TransactionIntentApplier* applier,
+       const scoped_refptr<MetricEntity>& entity)
       : RunningTransactionContext(context, applier),
         log_prefix_(Format("T $0 P $1: ", context->tablet_id(), context->permanent_uuid())) {
     LOG_WITH_PREFIX(INFO) << "Start";
+    if (entity) {
+      status_cache_hits_ = METRIC_transaction_status_cache_hits.Instantiate(entity);
+      status_cache_misses_ = METRIC_transaction_status_cache_misses.Instantiate(entity);
+    }
   }
 
   ~Impl() {
@@ -758,6 +941,17 @@ class TransactionParticipant::Impl : public RunningTransactionContext {
   }
 
   void RequestStatusAt(const StatusRequest& request) {
+    if (FLAGS_transaction_resolved_status_cache_size > 0) {
+      auto resolved = FindResolved(*request.id);
+      if (resolved) {
+        IncrementCounter(status_cache_hits_);
+        auto status = GetStatusAt(request.global_limit_ht, resolved->status_time, resolved->status);
+        request.callback(TransactionStatusResult{*status, resolved->status_time});
+        return;
+      }
+      IncrementCounter(status_cache_misses_);
+    }
+
     auto lock_and_iterator = LockAndFindOrLoad(*request.id, *request.reason, request.must_exist);
     if (!lock_and_iterator.found()) {
       request.callback(
@@ -900,6 +1094,7 @@ class TransactionParticipant::Impl : public RunningTransactionContext {
     }
 
     CHECK_OK(applier_.ApplyIntents(data));
+    EraseResolved(data.transaction_id);
 
     {
       auto lock_and_iterator = LockAndFindOrLoad(data.transaction_id, "apply"s);
@@ -959,6 +1154,7 @@ class TransactionParticipant::Impl : public RunningTransactionContext {
     auto status = applier_.RemoveIntents(data.transaction_id);
     LOG_IF_WITH_PREFIX(DFATAL, !status.ok()) << "Failed to remove intents for "
                                              << data.transaction_id << ": " << status;
+    EraseResolved(data.transaction_id);
 
     return Status::OK();
   }
@@ -971,13 +1167,84 @@ class TransactionParticipant::Impl : public RunningTransactionContext {
     return &participant_context_;
   }
 
+  bool HasTransactions() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return !transactions_.empty();
+  }
+
   size_t TEST_GetNumRunningTransactions() {
     std::lock_guard<std::mutex> lock(mutex_);
     VLOG(4) << "Transactions: " << yb::ToString(transactions_);
     return transactions_.size();
   }
 
+  void TransactionResolved(
+      const TransactionId& id, TransactionStatus status, HybridTime status_time) override {
+    const size_t max_size = std::max(FLAGS_transaction_resolved_status_cache_size, 0);
+    if (max_size == 0) {
+      return;
+    }
+    std::lock_guard<simple_spinlock> lock(resolved_mutex_);
+    auto& by_id = resolved_.get<ResolvedByIdTag>();
+    auto it = by_id.find(id);
+    if (it != by_id.end()) {
+      by_id.replace(it, ResolvedTransaction{id, status, status_time});
+      return;
+    }
+    // Evict the oldest entries, a transaction that was resolved long ago most likely does not
+    // have intents anymore.
+    while (resolved_.size() >= max_size) {
+      resolved_.pop_front();
+    }
+    resolved_.push_back(ResolvedTransaction{id, status, status_time});
+  }
+
  private:
+  // Final status of a committed or aborted transaction. status_time is the commit time for
+  // committed transactions.
+  struct ResolvedTransaction {
+    TransactionId id;
+    TransactionStatus status;
+    HybridTime status_time;
+  };
+
+  class ResolvedByIdTag;
+
+  typedef boost::multi_index_container<ResolvedTransaction,
+      boost::multi_index::indexed_by <
+          boost::multi_index::sequenced<>,
+          boost::multi_index::hashed_unique <
+              boost::multi_index::tag<ResolvedByIdTag>,
+              boost::multi_index::member<
+                  ResolvedTransaction, TransactionId, &ResolvedTransaction::id>,
+              TransactionIdHash
+          >
+      >
+  > ResolvedTransactions;
+
+  boost::optional<ResolvedTransaction> FindResolved(const TransactionId& id) {
+    std::lock_guard<simple_spinlock> lock(resolved_mutex_);
+    auto& by_id = resolved_.get<ResolvedByIdTag>();
+    auto it = by_id.find(id);
+    if (it == by_id.end()) {
+      return boost::none;
+    }
+    return *it;
+  }
+
+  // Status of transaction is not requested after its intents were applied or removed, so there
+  // is no reason to keep it in cache.
+  void EraseResolved(const TransactionId& id) {
+    std::lock_guard<simple_spinlock> lock(resolved_mutex_);
+    resolved_.get<ResolvedByIdTag>().erase(id);
+  }
+
+  static void IncrementCounter(const scoped_refptr<Counter>& counter) {
+    if (counter) {
+      counter->Increment();
+    }
+  }
+
   typedef boost::multi_index_container<RunningTransactionPtr,
       boost::multi_index::indexed_by <
           boost::multi_index::hashed_unique <
@@ -1136,11 +1403,20 @@ class TransactionParticipant::Impl : public RunningTransactionContext {
   // Queue of transaction ids that should be cleaned, paired with request that should be completed
   // in order to be able to do clean.
   std::deque<CleanupQueueEntry> cleanup_queue_;
+
+  // Cache of committed and aborted transactions, that could still have intents in this tablet.
+  // Protected by its own lock, so status lookups don't contend with mutex_.
+  simple_spinlock resolved_mutex_;
+  ResolvedTransactions resolved_;
+
+  scoped_refptr<Counter> status_cache_hits_;
+  scoped_refptr<Counter> status_cache_misses_;
 };
 
 TransactionParticipant::TransactionParticipant(
-    TransactionParticipantContext* context, TransactionIntentApplier* applier)
-    : impl_(new Impl(context, applier)) {
+    TransactionParticipantContext* context, TransactionIntentApplier* applier,
+    const scoped_refptr<MetricEntity>& entity)
+    : impl_(new Impl(context, applier, entity)) {
 }
 
 TransactionParticipant::~TransactionParticipant() {
@@ -1215,6 +1491,10 @@ TransactionParticipantContext* TransactionParticipant::context() const {
   return impl_->participant_context();
 }
 
+bool TransactionParticipant::HasTransactions() const {
+  return impl_->HasTransactions();
+}
+
 size_t TransactionParticipant::TEST_GetNumRunningTransactions() const {
   return impl_->TEST_GetNumRunningTransactions();
 }
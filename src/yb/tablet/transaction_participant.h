@@ -30,6 +30,8 @@
 
 #include "yb/consensus/opid_util.h"
 
+#include "yb/gutil/ref_counted.h"
+
 #include "yb/rpc/rpc_fwd.h"
 
 #include "yb/server/server_fwd.h"
@@ -47,6 +49,7 @@ class WriteBatch;
 namespace yb {
 
 class HybridTime;
+class MetricEntity;
 class TransactionMetadataPB;
 
 namespace tserver {
@@ -105,7 +108,8 @@ class TransactionParticipantContext {
 // instance per tablet.
 class TransactionParticipant : public TransactionStatusManager {
  public:
-  TransactionParticipant(TransactionParticipantContext* context, TransactionIntentApplier* applier);
+  TransactionParticipant(TransactionParticipantContext* context, TransactionIntentApplier* applier,
+                         const scoped_refptr<MetricEntity>& entity);
   virtual ~TransactionParticipant();
 
   // Adds new running transaction.
@@ -146,6 +150,10 @@ class TransactionParticipant : public TransactionStatusManager {
 
   TransactionParticipantContext* context() const;
 
+  // Returns true if there are transactions with intents in this tablet that are not yet applied
+  // or removed.
+  bool HasTransactions() const;
+
   size_t TEST_GetNumRunningTransactions() const;
 
   size_t TEST_CountIntents() const;
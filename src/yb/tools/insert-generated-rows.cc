@@ -39,6 +39,7 @@
 #include <gflags/gflags.h>
 #include <glog/logging.h>
 
+#include "yb/client/bulk_writer.h"
 #include "yb/client/client.h"
 #include "yb/client/table_handle.h"
 #include "yb/client/yb_op.h"
@@ -57,17 +58,22 @@ using namespace std::literals;
 DEFINE_string(master_address, "localhost",
               "Comma separated list of master addresses to run against.");
 
+DEFINE_int32(rows_per_flush, 10000,
+             "Number of rows generated and written between flushes of the bulk writer.");
+
+DEFINE_int32(tablet_batch_size, 1000, "Max number of rows sent to a tablet in a single batch.");
+
 namespace yb {
 namespace tools {
 
 using std::string;
 using std::vector;
 
+using client::YBBulkWriter;
 using client::YBClient;
 using client::YBClientBuilder;
 using client::YBColumnSchema;
 using client::YBSchema;
-using client::YBSession;
 using client::YBTable;
 using client::YBTableName;
 using std::shared_ptr;
@@ -103,31 +109,35 @@ static int WriteRandomDataToTable(int argc, char** argv) {
   CHECK_OK(table.Open(table_name, client.get()));
   YBSchema schema = table->schema();
 
-  shared_ptr<YBSession> session = client->NewSession();
-  session->SetTimeout(5s); // Time out after 5 seconds.
+  YBBulkWriter::Options options;
+  options.batch_size = FLAGS_tablet_batch_size;
+  options.timeout = 5s; // Time out after 5 seconds.
+  YBBulkWriter writer(
+      client.get(), table.table(), options, [](const client::YBqlWriteOp& op, const Status& s) {
+        if (s.IsAlreadyPresent()) {
+          LOG(WARNING) << "Ignoring insert error: " << s.ToString();
+        } else {
+          LOG(FATAL) << "Unexpected insert error: " << s.ToString() << ", " << op.ToString();
+        }
+      });
 
   Random random(GetRandomSeed32());
 
   LOG(INFO) << "Inserting random rows...";
-  for (uint64_t record_id = 0; true; ++record_id) {
-    auto insert = table.NewInsertOp();
-    auto req = insert->mutable_request();
-    GenerateDataForRow(schema, record_id, &random, req);
-
-    LOG(INFO) << "Inserting record: " << req->ShortDebugString();
-    CHECK_OK(session->Apply(insert));
-    Status s = session->Flush();
-    if (PREDICT_FALSE(!s.ok())) {
-      for (const auto& e : session->GetPendingErrors()) {
-        if (e->status().IsAlreadyPresent()) {
-          LOG(WARNING) << "Ignoring insert error: " << e->status().ToString();
-        } else {
-          LOG(FATAL) << "Unexpected insert error: " << e->status().ToString();
-        }
-      }
-      continue;
+  std::vector<client::YBqlWriteOpPtr> ops;
+  ops.reserve(FLAGS_rows_per_flush);
+  for (uint64_t record_id = 0; true;) {
+    for (int i = 0; i != FLAGS_rows_per_flush; ++i, ++record_id) {
+      auto insert = table.NewInsertOp();
+      GenerateDataForRow(schema, record_id, &random, insert->mutable_request());
+      VLOG(1) << "Inserting record: " << insert->request().ShortDebugString();
+      ops.push_back(std::move(insert));
     }
-    LOG(INFO) << "OK";
+    CHECK_OK(writer.Write(ops));
+    ops.clear();
+    // Errors are reported to the callback above.
+    WARN_NOT_OK(writer.Flush(), "Flush failed");
+    LOG(INFO) << "Inserted " << writer.rows_written() << " rows";
   }
 
   return 0;
@@ -21,6 +21,7 @@
 
 #include "yb/rocksdb/db.h"
 #include "yb/rocksdb/options.h"
+#include "yb/rocksdb/sst_file_writer.h"
 #include "yb/client/client.h"
 #include "yb/common/entity_ids.h"
 #include "yb/common/hybrid_time.h"
@@ -83,12 +84,19 @@ DEFINE_int32(bulk_load_max_background_flushes, 2, "Number of flushes to perform
 DEFINE_uint64(bulk_load_num_files_per_tablet, 5,
               "Determines how to compact the data of a tablet to ensure we have only a certain "
               "number of sst files per tablet");
+DEFINE_bool(bulk_load_ingest_sst_files, false,
+            "Write a single sorted SST file per tablet with SstFileWriter and ingest it through a "
+            "replicated IngestSstFile operation on the tablet leader, instead of importing the "
+            "generated RocksDB on each replica. Requires --export_files.");
 
 namespace yb {
 namespace tools {
 
 namespace {
 
+const char* const kIngestDirSuffix = ".ingest";
+const char* const kIngestSstFileName = "bulk_load.sst";
+
 class BulkLoadTask : public Runnable {
  public:
   BulkLoadTask(vector<pair<TabletId, string>> rows, BulkLoadDocDBUtil *db_fixture,
@@ -130,6 +138,9 @@ class BulkLoad {
                                         vector<pair<TabletId, string>> rows);
   CHECKED_STATUS RetryableSubmit(vector<pair<TabletId, string>> rows);
   CHECKED_STATUS CompactFiles();
+  CHECKED_STATUS WriteIngestSstFile(const string& sst_dir);
+  CHECKED_STATUS IngestSstFile(const TabletId& tablet_id, const string& file_path,
+                               const vector<HostPort>& replicas, rpc::ProxyCache* proxy_cache);
 
   shared_ptr<YBClient> client_;
   shared_ptr<YBTable> table_;
@@ -377,8 +388,15 @@ Status BulkLoad::FinishTabletProcessing(const TabletId &tablet_id,
   // Now flush the DB.
   RETURN_NOT_OK(db_fixture_->FlushRocksDbAndWait());
 
-  // Perform the necessary compactions.
-  RETURN_NOT_OK(CompactFiles());
+  string tablet_data_dir = db_fixture_->rocksdb_dir();
+  if (FLAGS_bulk_load_ingest_sst_files) {
+    // The whole tablet goes into one file, so there is nothing to gain from compactions.
+    tablet_data_dir = JoinPathSegments(FLAGS_base_dir, tablet_id + kIngestDirSuffix);
+    RETURN_NOT_OK(WriteIngestSstFile(tablet_data_dir));
+  } else {
+    // Perform the necessary compactions.
+    RETURN_NOT_OK(CompactFiles());
+  }
 
   if (!FLAGS_export_files) {
     return Status::OK();
@@ -400,7 +418,7 @@ Status BulkLoad::FinishTabletProcessing(const TabletId &tablet_id,
 
   // Invoke the bulk_load_helper script.
   vector<string> argv = {FLAGS_bulk_load_helper_script, "-t", tablet_id, "-r", csv_replicas, "-i",
-      FLAGS_ssh_key_file, "-d", db_fixture_->rocksdb_dir()};
+      FLAGS_ssh_key_file, "-d", tablet_data_dir};
   string bulk_load_helper_stdout;
   RETURN_NOT_OK(Subprocess::Call(argv, &bulk_load_helper_stdout));
 
@@ -414,16 +432,42 @@ Status BulkLoad::FinishTabletProcessing(const TabletId &tablet_id,
   rpc::ProxyCache proxy_cache(client_messenger);
   vector<string> lines;
   boost::split(lines, bulk_load_helper_stdout, boost::is_any_of("\n"));
+  vector<pair<string, string>> staged_replicas;
   for (const string &line : lines) {
     vector<string> tokens;
     boost::split(tokens, line, boost::is_any_of(","));
     if (tokens.size() != 2) {
       return STATUS_SUBSTITUTE(InvalidArgument, "Invalid line $0", line);
     }
-    const string &replica_host = tokens[0];
-    const string &directory = tokens[1];
-    HostPort hostport(replica_host, host_to_rpcport[replica_host]);
+    staged_replicas.emplace_back(tokens[0], tokens[1]);
+  }
 
+  if (FLAGS_bulk_load_ingest_sst_files) {
+    // The helper script stages the file next to the tablet's RocksDB directory on each replica, so
+    // the same relative path works on all of them.
+    string relative_path;
+    vector<HostPort> replicas;
+    for (const auto& staged : staged_replicas) {
+      const string path = JoinPathSegments(BaseName(staged.second), kIngestSstFileName);
+      if (!relative_path.empty() && path != relative_path) {
+        return STATUS_FORMAT(IllegalState, "Replicas staged the file at different paths: $0, $1",
+                             relative_path, path);
+      }
+      relative_path = path;
+      replicas.emplace_back(staged.first, host_to_rpcport[staged.first]);
+    }
+    RETURN_NOT_OK(IngestSstFile(tablet_id, relative_path, replicas, &proxy_cache));
+
+    // Each replica moves its staged copy into RocksDB when it applies the operation. Followers may
+    // still be behind at this point, so the staging directories are not cleaned up here.
+    RETURN_NOT_OK(yb::Env::Default()->DeleteRecursively(tablet_data_dir));
+    return yb::Env::Default()->DeleteRecursively(db_fixture_->rocksdb_dir());
+  }
+
+  for (const auto& staged : staged_replicas) {
+    const string &replica_host = staged.first;
+    const string &directory = staged.second;
+    HostPort hostport(replica_host, host_to_rpcport[replica_host]);
     tserver::TabletServerServiceProxy proxy(&proxy_cache, hostport);
     tserver::ImportDataRequestPB req;
     req.set_tablet_id(tablet_id);
@@ -448,6 +492,61 @@ Status BulkLoad::FinishTabletProcessing(const TabletId &tablet_id,
   return yb::Env::Default()->DeleteRecursively(db_fixture_->rocksdb_dir());
 }
 
+Status BulkLoad::WriteIngestSstFile(const string& sst_dir) {
+  const rocksdb::Options& options = db_fixture_->options();
+  const rocksdb::ImmutableCFOptions ioptions(options);
+  rocksdb::SstFileWriter sst_file_writer(rocksdb::EnvOptions(), ioptions, options.comparator);
+
+  RETURN_NOT_OK(yb::Env::Default()->CreateDirs(sst_dir));
+  const string sst_file_path = JoinPathSegments(sst_dir, kIngestSstFileName);
+  RETURN_NOT_OK(sst_file_writer.Open(sst_file_path));
+
+  // RocksDB iterates in comparator order, which is exactly what SstFileWriter expects.
+  std::unique_ptr<rocksdb::Iterator> iter(
+      db_fixture_->rocksdb()->NewIterator(rocksdb::ReadOptions()));
+  for (iter->SeekToFirst(); iter->Valid(); iter->Next()) {
+    RETURN_NOT_OK(sst_file_writer.Add(iter->key(), iter->value()));
+  }
+  RETURN_NOT_OK(iter->status());
+
+  rocksdb::ExternalSstFileInfo file_info;
+  RETURN_NOT_OK(sst_file_writer.Finish(&file_info));
+  LOG(INFO) << "Wrote " << file_info.num_entries << " entries (" << file_info.file_size
+            << " bytes) to " << sst_file_path;
+  return Status::OK();
+}
+
+Status BulkLoad::IngestSstFile(const TabletId& tablet_id, const string& file_path,
+                               const vector<HostPort>& replicas, rpc::ProxyCache* proxy_cache) {
+  // Only the leader accepts the request, so try the replicas in turn.
+  Status status = STATUS_FORMAT(IllegalState, "No replicas for tablet $0", tablet_id);
+  for (const HostPort& hostport : replicas) {
+    tserver::TabletServerServiceProxy proxy(proxy_cache, hostport);
+    tserver::IngestSstFileRequestPB req;
+    req.set_tablet_id(tablet_id);
+    req.set_file_path(file_path);
+    req.set_move_file(true);
+
+    tserver::IngestSstFileResponsePB resp;
+    rpc::RpcController controller;
+    LOG(INFO) << "Ingesting " << file_path << " through " << hostport.ToString()
+              << " for tablet_id: " << tablet_id;
+    status = proxy.IngestSstFile(req, &resp, &controller);
+    if (status.ok() && resp.has_error()) {
+      status = StatusFromPB(resp.error().status());
+      if (resp.error().code() == tserver::TabletServerErrorPB::NOT_THE_LEADER) {
+        continue;
+      }
+      return status;
+    }
+    if (status.ok()) {
+      return Status::OK();
+    }
+    LOG(WARNING) << "Failed to ingest through " << hostport.ToString() << ": " << status;
+  }
+  return status;
+}
+
 
 CHECKED_STATUS BulkLoad::InitDBUtil(const TabletId &tablet_id) {
   db_fixture_.reset(new BulkLoadDocDBUtil(tablet_id, FLAGS_base_dir,
@@ -546,6 +645,10 @@ int main(int argc, char** argv) {
     LOG(FATAL) << "Bulk load directory doesn't exist: " << FLAGS_base_dir;
   }
 
+  if (FLAGS_bulk_load_ingest_sst_files && !FLAGS_export_files) {
+    LOG(FATAL) << "Need to specify --export_files with --bulk_load_ingest_sst_files";
+  }
+
   if (FLAGS_bulk_load_num_files_per_tablet <= 0) {
     LOG(FATAL) << "--bulk_load_num_files_per_tablet needs to be greater than 0";
   }
@@ -0,0 +1,157 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+// db_bench with DocDB keys, values and RocksDB options, so storage engine changes and tuning can be
+// evaluated without running a cluster. Keys are SubDocKeys of a table with one hash column and
+// --docdb_bench_range_components range columns, every write is a new version of a column with its
+// own DocHybridTime. Options are set up like for a tablet, from the DocDB flags such as
+// --rocksdb_compression_type or --db_block_size_bytes, with universal compaction, the DocDB aware
+// bloom filter and DocDBCompactionFilter. For instance:
+//
+//   yb-docdb_db_bench --benchmarks=fillrandom,readrandom,seekrandom,compact --num=1000000 \
+//       --writes=3000000
+//
+// writes about 3 versions of each of 1000000 columns, then point reads and seeks the latest
+// versions and compacts the DB, dropping the overwritten versions.
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <gflags/gflags.h>
+
+#include "yb/docdb/doc_key.h"
+#include "yb/docdb/docdb_compaction_filter.h"
+#include "yb/docdb/docdb_rocksdb_util.h"
+#include "yb/docdb/value.h"
+#include "yb/gutil/walltime.h"
+#include "yb/rocksdb/cache.h"
+#include "yb/rocksdb/db_bench_tool.h"
+#include "yb/tablet/tablet_options.h"
+#include "yb/util/format.h"
+#include "yb/util/logging.h"
+#include "yb/util/yb_partition.h"
+
+DEFINE_int32(docdb_bench_range_components, 1,
+             "Number of range components of the generated DocKeys, in addition to the hash one.");
+DEFINE_int32(docdb_bench_columns, 1,
+             "Number of columns of each generated row, consecutive key indexes belong to the same "
+             "row.");
+DEFINE_int64(docdb_bench_history_retention_writes, 0,
+             "Compactions keep all versions written by this number of the most recent writes, "
+             "older overwritten versions are dropped. Negative to keep the whole history.");
+
+DECLARE_int64(cache_size);
+
+namespace yb {
+namespace docdb {
+namespace {
+
+// Keys are versioned by hybrid times starting from this one, increased by one microsecond per
+// write.
+class DocDBBenchVersions {
+ public:
+  DocDBBenchVersions() : base_micros_(GetCurrentTimeMicros()) {}
+
+  HybridTime Next() {
+    return HybridTime::FromMicros(base_micros_ + next_.fetch_add(1, std::memory_order_acq_rel));
+  }
+
+  HybridTime HistoryCutoff() const {
+    if (FLAGS_docdb_bench_history_retention_writes < 0) {
+      return HybridTime::kMin;
+    }
+    auto next = static_cast<int64_t>(next_.load(std::memory_order_acquire));
+    return HybridTime::FromMicros(
+        base_micros_ + std::max<int64_t>(next - FLAGS_docdb_bench_history_retention_writes, 0));
+  }
+
+ private:
+  const MicrosTime base_micros_;
+  std::atomic<uint64_t> next_{0};
+};
+
+class DocDBBenchRetentionPolicy : public HistoryRetentionPolicy {
+ public:
+  explicit DocDBBenchRetentionPolicy(const DocDBBenchVersions* versions) : versions_(versions) {}
+
+  HistoryRetentionDirective GetRetentionDirective() override {
+    return {versions_->HistoryCutoff(), std::make_shared<ColumnIds>(), MonoDelta::kMax};
+  }
+
+ private:
+  const DocDBBenchVersions* const versions_;
+};
+
+class DocDBBenchFormat : public rocksdb::DbBenchFormat {
+ public:
+  DocDBBenchFormat() : retention_policy_(std::make_shared<DocDBBenchRetentionPolicy>(&versions_)) {}
+
+  void CustomizeOptions(rocksdb::Options* options) override {
+    tablet::TabletOptions tablet_options;
+    if (FLAGS_cache_size > 0) {
+      tablet_options.block_cache = rocksdb::NewLRUCache(FLAGS_cache_size);
+    }
+    const auto create_if_missing = options->create_if_missing;
+    const auto statistics = options->statistics;
+    InitRocksDBOptions(options, "" /* log_prefix */, statistics, tablet_options);
+    options->create_if_missing = create_if_missing;
+    options->compaction_filter_factory =
+        std::make_shared<DocDBCompactionFilterFactory>(retention_policy_);
+    options->compaction_file_filter_factory =
+        std::make_shared<DocDBCompactionFileFilterFactory>(retention_policy_);
+    options->table_properties_collector_factories.push_back(
+        std::make_shared<DocDBTablePropertiesCollectorFactory>(retention_policy_));
+  }
+
+  void AppendKeyPrefix(uint64_t key_index, std::string* out) override {
+    const auto row = static_cast<int64_t>(key_index / FLAGS_docdb_bench_columns);
+    std::vector<PrimitiveValue> range_components;
+    range_components.reserve(FLAGS_docdb_bench_range_components);
+    for (int i = 0; i != FLAGS_docdb_bench_range_components; ++i) {
+      range_components.emplace_back(Format("range$0_$1", i, row));
+    }
+    std::string hashed(reinterpret_cast<const char*>(&row), sizeof(row));
+    const SubDocKey key(
+        DocKey(YBPartition::HashColumnCompoundValue(hashed), {PrimitiveValue(row)},
+               std::move(range_components)),
+        PrimitiveValue(ColumnId(static_cast<ColumnIdRep>(
+            kFirstColumnId + key_index % FLAGS_docdb_bench_columns))));
+    out->append(key.EncodeWithoutHt().data());
+  }
+
+  void AppendNewVersion(std::string* out) override {
+    out->push_back(ValueTypeAsChar::kHybridTime);
+    DocHybridTime(versions_.Next()).AppendEncodedInDocDbFormat(out);
+  }
+
+  void AppendValue(const Slice& value, std::string* out) override {
+    Value(PrimitiveValue(value.ToBuffer())).EncodeAndAppend(out);
+  }
+
+ private:
+  DocDBBenchVersions versions_;
+  std::shared_ptr<DocDBBenchRetentionPolicy> retention_policy_;
+};
+
+} // namespace
+} // namespace docdb
+} // namespace yb
+
+int main(int argc, char** argv) {
+  yb::InitGoogleLoggingSafe(argv[0]);
+  yb::docdb::DocDBBenchFormat format;
+  return rocksdb::db_bench_tool(argc, argv, &format);
+}
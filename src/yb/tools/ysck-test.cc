@@ -66,6 +66,7 @@ class MockYsckTabletServer : public YsckTabletServer {
       const std::string& tablet_id,
       const Schema& schema,
       const ChecksumOptions& options,
+      const std::shared_ptr<ChunkedChecksumComparator>& comparator,
       const ReportResultCallback& callback) override {
     callback.Run(Status::OK(), 0);
   }
@@ -273,5 +274,24 @@ TEST_F(YsckTest, TestOneOneTabletBrokenTable) {
   ASSERT_TRUE(ysck_->CheckTablesConsistency().IsCorruption());
 }
 
+TEST(ChunkedChecksumComparatorTest, TestMismatch) {
+  ChunkedChecksumComparator comparator(3);
+  // Replicas scan at different paces.
+  ASSERT_TRUE(comparator.ReportChunk(0, 10, 1, "a"));
+  ASSERT_TRUE(comparator.ReportChunk(1, 10, 2, "b"));
+  ASSERT_TRUE(comparator.ReportChunk(0, 10, 1, "a"));
+  ASSERT_TRUE(comparator.ReportChunk(0, 10, 1, "a"));
+  ASSERT_TRUE(comparator.ReportChunk(1, 10, 2, "b"));
+  ASSERT_FALSE(comparator.mismatched_chunk());
+
+  // The third replica ends its chunk at another row.
+  ASSERT_FALSE(comparator.ReportChunk(1, 9, 2, "c"));
+  ASSERT_EQ(1, *comparator.mismatched_chunk());
+  // The other replicas are stopped at their next chunk.
+  ASSERT_FALSE(comparator.ReportChunk(2, 10, 3, ""));
+  ASSERT_EQ(1, *comparator.mismatched_chunk());
+  ASSERT_EQ(69, comparator.num_rows());
+}
+
 } // namespace tools
 } // namespace yb
@@ -32,6 +32,7 @@
 
 #include "yb/tools/ysck.h"
 
+#include <algorithm>
 #include <iostream>
 #include <mutex>
 #include <unordered_set>
@@ -59,14 +60,54 @@ DEFINE_int32(checksum_timeout_sec, 120,
              "before timing out.");
 DEFINE_int32(checksum_scan_concurrency, 4,
              "Number of concurrent checksum scans to execute per tablet server.");
+DEFINE_uint64(checksum_chunk_rows, 100000,
+              "Maximum number of rows checksummed by one request. Replicas of a tablet are "
+              "compared after each chunk, so a mismatch is found without scanning them fully. "
+              "0 checksums every replica with a single request.");
+DEFINE_int32(checksum_progress_interval_sec, 10,
+             "Interval in seconds between the progress reports of a checksum scan.");
 
 ChecksumOptions::ChecksumOptions()
     : timeout(MonoDelta::FromSeconds(FLAGS_checksum_timeout_sec)),
-      scan_concurrency(FLAGS_checksum_scan_concurrency) {}
+      scan_concurrency(FLAGS_checksum_scan_concurrency),
+      chunk_rows(FLAGS_checksum_chunk_rows) {}
 
 ChecksumOptions::ChecksumOptions(MonoDelta timeout, int scan_concurrency)
     : timeout(std::move(timeout)),
-      scan_concurrency(scan_concurrency) {}
+      scan_concurrency(scan_concurrency),
+      chunk_rows(FLAGS_checksum_chunk_rows) {}
+
+bool ChunkedChecksumComparator::ReportChunk(size_t chunk_index, uint64_t num_rows,
+                                            uint64_t checksum, const std::string& next_row_key) {
+  std::lock_guard<simple_spinlock> guard(lock_);
+  num_rows_ += num_rows;
+  if (mismatched_chunk_) {
+    return false;
+  }
+  auto it = chunks_.find(chunk_index);
+  if (it == chunks_.end()) {
+    it = chunks_.emplace(chunk_index, Chunk{checksum, next_row_key, 0}).first;
+  } else if (it->second.checksum != checksum || it->second.next_row_key != next_row_key) {
+    // Checksums are cumulative, so this is the first chunk the replicas differ in.
+    mismatched_chunk_ = chunk_index;
+    chunks_.clear();
+    return false;
+  }
+  if (++it->second.num_reported == num_replicas_) {
+    chunks_.erase(it);
+  }
+  return true;
+}
+
+boost::optional<size_t> ChunkedChecksumComparator::mismatched_chunk() const {
+  std::lock_guard<simple_spinlock> guard(lock_);
+  return mismatched_chunk_;
+}
+
+uint64_t ChunkedChecksumComparator::num_rows() const {
+  std::lock_guard<simple_spinlock> guard(lock_);
+  return num_rows_;
+}
 
 YsckCluster::~YsckCluster() {
 }
@@ -215,6 +256,9 @@ class ChecksumResultReporter : public RefCountedThreadSafe<ChecksumResultReporte
   // Returns true iff all replicas have reported in.
   bool AllReported() const { return responses_.count() == 0; }
 
+  // Returns the number of replicas that have not reported in yet.
+  uint64_t num_remaining() const { return responses_.count(); }
+
   // Get reported results.
   TabletResultMap checksums() const {
     std::lock_guard<simple_spinlock> guard(lock_);
@@ -235,8 +279,21 @@ class ChecksumResultReporter : public RefCountedThreadSafe<ChecksumResultReporte
   TabletResultMap checksums_;
 };
 
+// Checksum scan of a tablet replica.
+struct ReplicaChecksumScan {
+  Schema schema;
+  TabletId tablet_id;
+  shared_ptr<ChunkedChecksumComparator> comparator;
+};
+
 // Queue of tablet replicas for an individual tablet server.
-typedef shared_ptr<BlockingQueue<std::pair<Schema, std::string> > > TabletQueue;
+typedef shared_ptr<BlockingQueue<ReplicaChecksumScan>> TabletQueue;
+
+void StartChecksumScan(const scoped_refptr<ChecksumResultReporter>& reporter,
+                       const shared_ptr<YsckTabletServer>& tablet_server,
+                       const TabletQueue& queue,
+                       const ReplicaChecksumScan& scan,
+                       const ChecksumOptions& options);
 
 // A callback function which records the result of a tablet replica's checksum,
 // and then checks if the tablet server has any more tablets to checksum. If so,
@@ -251,20 +308,27 @@ void TabletServerChecksumCallback(
     uint64_t checksum) {
   reporter->ReportResult(tablet_id, tablet_server->uuid(), status, checksum);
 
-  std::pair<Schema, TabletId> table_tablet;
-  if (queue->BlockingGet(&table_tablet)) {
-    const Schema& table_schema = table_tablet.first;
-    const TabletId& tablet_id = table_tablet.second;
-    ReportResultCallback callback = Bind(&TabletServerChecksumCallback,
-                                         reporter,
-                                         tablet_server,
-                                         queue,
-                                         tablet_id,
-                                         options);
-    tablet_server->RunTabletChecksumScanAsync(tablet_id, table_schema, options, callback);
+  ReplicaChecksumScan scan;
+  if (queue->BlockingGet(&scan)) {
+    StartChecksumScan(reporter, tablet_server, queue, scan, options);
   }
 }
 
+void StartChecksumScan(const scoped_refptr<ChecksumResultReporter>& reporter,
+                       const shared_ptr<YsckTabletServer>& tablet_server,
+                       const TabletQueue& queue,
+                       const ReplicaChecksumScan& scan,
+                       const ChecksumOptions& options) {
+  ReportResultCallback callback = Bind(&TabletServerChecksumCallback,
+                                       reporter,
+                                       tablet_server,
+                                       queue,
+                                       scan.tablet_id,
+                                       options);
+  tablet_server->RunTabletChecksumScanAsync(
+      scan.tablet_id, scan.schema, options, scan.comparator, callback);
+}
+
 Status Ysck::ChecksumData(const vector<string>& tables,
                           const vector<string>& tablets,
                           const ChecksumOptions& opts) {
@@ -326,9 +390,17 @@ Status Ysck::ChecksumData(const vector<string>& tables,
   TabletServerQueueMap tablet_server_queues;
   scoped_refptr<ChecksumResultReporter> reporter(new ChecksumResultReporter(num_tablet_replicas));
 
+  // Comparators of the replicas of the tablets scanned in chunks.
+  unordered_map<TabletId, shared_ptr<ChunkedChecksumComparator>> comparators;
+
   // Create a queue of checksum callbacks grouped by the tablet server.
   for (const TabletTableMap::value_type& entry : tablet_table_map) {
     const shared_ptr<YsckTablet>& tablet = entry.first;
+    shared_ptr<ChunkedChecksumComparator> comparator;
+    if (options.chunk_rows != 0 && entry.second.size() == 1) {
+      comparator = std::make_shared<ChunkedChecksumComparator>(tablet->replicas().size());
+      comparators.emplace(tablet->id(), comparator);
+    }
     for (const shared_ptr<YsckTable>& table : entry.second) {
       for (const shared_ptr<YsckTabletReplica>& replica : tablet->replicas()) {
         const shared_ptr<YsckTabletServer>& ts =
@@ -336,7 +408,8 @@ Status Ysck::ChecksumData(const vector<string>& tables,
 
         const TabletQueue& queue =
             LookupOrInsertNewSharedPtr(&tablet_server_queues, ts, num_tablet_replicas);
-        CHECK_EQ(QUEUE_SUCCESS, queue->Put(make_pair(table->schema(), tablet->id())));
+        CHECK_EQ(QUEUE_SUCCESS, queue->Put(
+            ReplicaChecksumScan{table->schema(), tablet->id(), comparator}));
       }
     }
   }
@@ -349,24 +422,34 @@ Status Ysck::ChecksumData(const vector<string>& tables,
     const TabletQueue& queue = entry.second;
     queue->Shutdown(); // Ensures that BlockingGet() will not block.
     for (int i = 0; i < options.scan_concurrency; i++) {
-      std::pair<Schema, std::string> table_tablet;
-      if (queue->BlockingGet(&table_tablet)) {
-        const Schema& table_schema = table_tablet.first;
-        const std::string& tablet_id = table_tablet.second;
-        ReportResultCallback callback = Bind(&TabletServerChecksumCallback,
-                                             reporter,
-                                             tablet_server,
-                                             queue,
-                                             tablet_id,
-                                             options);
-        tablet_server->RunTabletChecksumScanAsync(tablet_id, table_schema, options, callback);
+      ReplicaChecksumScan scan;
+      if (queue->BlockingGet(&scan)) {
+        StartChecksumScan(reporter, tablet_server, queue, scan, options);
       }
     }
   }
 
+  // Wait for the results, reporting the progress in the meantime.
   bool timed_out = false;
-  if (!reporter->WaitFor(options.timeout)) {
-    timed_out = true;
+  const MonoTime deadline = MonoTime::Now() + options.timeout;
+  const MonoDelta progress_interval =
+      MonoDelta::FromSeconds(std::max(FLAGS_checksum_progress_interval_sec, 1));
+  for (;;) {
+    const MonoDelta remaining = deadline - MonoTime::Now();
+    if (reporter->WaitFor(std::min(remaining, progress_interval))) {
+      break;
+    }
+    if (remaining <= progress_interval) {
+      timed_out = true;
+      break;
+    }
+    uint64_t num_rows = 0;
+    for (const auto& comparator : comparators) {
+      num_rows += comparator.second->num_rows();
+    }
+    LOG(INFO) << Substitute("Checksummed $0 out of $1 replicas, $2 rows in chunked scans",
+                            num_tablet_replicas - reporter->num_remaining(),
+                            num_tablet_replicas, num_rows);
   }
   ChecksumResultReporter::TabletResultMap checksums = reporter->checksums();
 
@@ -385,6 +468,18 @@ Status Ysck::ChecksumData(const vector<string>& tables,
         }
         bool seen_first_replica = false;
         uint64_t first_checksum = 0;
+        // Replicas of a chunked scan that stopped early only report checksums of their prefixes.
+        boost::optional<size_t> mismatched_chunk;
+        auto comparator = comparators.find(tablet->id());
+        if (comparator != comparators.end()) {
+          mismatched_chunk = comparator->second->mismatched_chunk();
+        }
+        if (mismatched_chunk) {
+          num_mismatches++;
+          LOG(ERROR) << ">> Mismatch found in table " << table->name().ToString()
+                     << " tablet " << tablet->id() << " in chunk " << *mismatched_chunk
+                     << " of " << options.chunk_rows << " rows";
+        }
 
         for (const ChecksumResultReporter::ReplicaResultMap::value_type& r :
                       FindOrDie(checksums, tablet->id())) {
@@ -400,6 +495,8 @@ Status Ysck::ChecksumData(const vector<string>& tables,
                                     tablet->id(), ts->uuid(), ts->address(), status_str);
             if (!status.ok()) {
               num_errors++;
+            } else if (mismatched_chunk) {
+              // Already counted once for the whole tablet.
             } else if (!seen_first_replica) {
               seen_first_replica = true;
               first_checksum = checksum;
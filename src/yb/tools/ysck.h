@@ -34,12 +34,15 @@
 #ifndef YB_TOOLS_YSCK_H
 #define YB_TOOLS_YSCK_H
 
+#include <map>
 #include <memory>
 #include <string>
 #include <unordered_map>
 #include <utility>
 #include <vector>
 
+#include <boost/optional.hpp>
+
 #include "yb/common/schema.h"
 #include "yb/util/countdown_latch.h"
 #include "yb/util/locks.h"
@@ -63,6 +66,10 @@ struct ChecksumOptions {
 
   // The maximum number of concurrent checksum scans to run per tablet server.
   int scan_concurrency;
+
+  // The maximum number of rows checksummed by one request, replicas of a tablet are compared
+  // after each such chunk. 0 checksums every replica with a single request.
+  uint64_t chunk_rows;
 };
 
 // Representation of a tablet replica on a tablet server.
@@ -163,6 +170,37 @@ class YsckTable {
 
 typedef Callback<void(const Status& status, uint64_t checksum)> ReportResultCallback;
 
+// Compares the checksums of the replicas of a tablet chunk by chunk while they are scanned, so the
+// scans could stop as soon as the replicas are known to differ. Thread safe.
+class ChunkedChecksumComparator {
+ public:
+  explicit ChunkedChecksumComparator(size_t num_replicas) : num_replicas_(num_replicas) {}
+
+  // Records the checksum of a replica through the chunk with the given index, and the key its
+  // next chunk starts from. Returns false if the replicas differ, so the scan should stop.
+  bool ReportChunk(size_t chunk_index, uint64_t num_rows, uint64_t checksum,
+                   const std::string& next_row_key);
+
+  // Returns the index of the first chunk the replicas differ in, if any.
+  boost::optional<size_t> mismatched_chunk() const;
+
+  uint64_t num_rows() const;
+
+ private:
+  struct Chunk {
+    uint64_t checksum;
+    std::string next_row_key;
+    size_t num_reported;
+  };
+
+  const size_t num_replicas_;
+  mutable simple_spinlock lock_;
+  // Chunks not reported by all replicas yet.
+  std::map<size_t, Chunk> chunks_;
+  boost::optional<size_t> mismatched_chunk_;
+  uint64_t num_rows_ = 0;
+};
+
 // The following two classes must be extended in order to communicate with their respective
 // components. The two main use cases envisioned for this are:
 // - To be able to mock a cluster to more easily test the Ysck checks.
@@ -181,10 +219,12 @@ class YsckTabletServer {
 
   // Executes a checksum scan on the associated tablet, and runs the callback
   // with the result. The callback must be threadsafe and non-blocking.
+  // Chunked scans report every chunk to the comparator and stop once it finds a mismatch.
   virtual void RunTabletChecksumScanAsync(
                   const std::string& tablet_id,
                   const Schema& schema,
                   const ChecksumOptions& options,
+                  const std::shared_ptr<ChunkedChecksumComparator>& comparator,
                   const ReportResultCallback& callback) = 0;
 
   virtual const std::string& uuid() const {
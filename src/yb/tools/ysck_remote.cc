@@ -110,12 +110,15 @@ class ChecksumCallbackHandler {
 class ChecksumStepper {
  public:
   ChecksumStepper(string tablet_id, const Schema& schema, string server_uuid,
-                  ChecksumOptions options, ReportResultCallback callback,
+                  ChecksumOptions options,
+                  shared_ptr<ChunkedChecksumComparator> comparator,
+                  ReportResultCallback callback,
                   shared_ptr<tserver::TabletServerServiceProxy> proxy)
       : schema_(schema),
         tablet_id_(std::move(tablet_id)),
         server_uuid_(std::move(server_uuid)),
         options_(std::move(options)),
+        comparator_(std::move(comparator)),
         reporter_callback_(std::move(callback)),
         proxy_(std::move(proxy)) {
     DCHECK(proxy_);
@@ -139,6 +142,19 @@ class ChecksumStepper {
 
     DCHECK(resp_.has_checksum());
 
+    // A chunked scan continues until the last chunk, or until its replica is known to differ
+    // from the other ones.
+    if (comparator_ &&
+        comparator_->ReportChunk(chunk_index_++, resp_.num_rows(), resp_.checksum(),
+                                 resp_.next_row_key()) &&
+        resp_.has_next_row_key()) {
+      req_.set_start_row_key(resp_.next_row_key());
+      req_.set_start_checksum(resp_.checksum());
+      ignore_result(deleter.release());
+      SendRequest();
+      return;
+    }
+
     reporter_callback_.Run(s, resp_.checksum());
   }
 
@@ -146,6 +162,11 @@ class ChecksumStepper {
   void SendRequest() {
     req_.set_tablet_id(tablet_id_);
     req_.set_consistency_level(YBConsistencyLevel::CONSISTENT_PREFIX);
+    if (comparator_) {
+      req_.set_max_rows(options_.chunk_rows);
+    }
+    resp_.Clear();
+    rpc_.Reset();
     rpc_.set_timeout(GetDefaultTimeout());
     auto handler = std::make_unique<ChecksumCallbackHandler>(this);
     rpc::ResponseCallback cb = std::bind(&ChecksumCallbackHandler::Run, handler.get());
@@ -159,12 +180,14 @@ class ChecksumStepper {
   const string tablet_id_;
   const string server_uuid_;
   const ChecksumOptions options_;
+  const shared_ptr<ChunkedChecksumComparator> comparator_;
   const ReportResultCallback reporter_callback_;
   const shared_ptr<tserver::TabletServerServiceProxy> proxy_;
 
   tserver::ChecksumRequestPB req_;
   tserver::ChecksumResponsePB resp_;
   RpcController rpc_;
+  size_t chunk_index_ = 0;
 };
 
 void ChecksumCallbackHandler::Run() {
@@ -176,9 +199,10 @@ void RemoteYsckTabletServer::RunTabletChecksumScanAsync(
         const string& tablet_id,
         const Schema& schema,
         const ChecksumOptions& options,
+        const shared_ptr<ChunkedChecksumComparator>& comparator,
         const ReportResultCallback& callback) {
   gscoped_ptr<ChecksumStepper> stepper(
-      new ChecksumStepper(tablet_id, schema, uuid(), options, callback, ts_proxy_));
+      new ChecksumStepper(tablet_id, schema, uuid(), options, comparator, callback, ts_proxy_));
   stepper->Start();
   ignore_result(stepper.release()); // Deletes self on callback.
 }
@@ -73,6 +73,7 @@ class RemoteYsckTabletServer : public YsckTabletServer {
       const std::string& tablet_id,
       const Schema& schema,
       const ChecksumOptions& options,
+      const std::shared_ptr<ChunkedChecksumComparator>& comparator,
       const ReportResultCallback& callback) override;
 
 
@@ -35,11 +35,13 @@
 #include <memory>
 #include <vector>
 #include <mutex>
+#include <unordered_map>
 
 #include <gflags/gflags.h>
 #include <glog/logging.h>
 
 #include "yb/common/wire_protocol.h"
+#include "yb/consensus/log.h"
 #include "yb/gutil/ref_counted.h"
 #include "yb/gutil/strings/substitute.h"
 #include "yb/master/master.h"
@@ -48,6 +50,8 @@
 #include "yb/server/server_base.proxy.h"
 #include "yb/server/webserver.h"
 #include "yb/tablet/tablet.h"
+#include "yb/tablet/tablet_metrics.h"
+#include "yb/tablet/tablet_peer.h"
 #include "yb/tserver/tablet_server.h"
 #include "yb/tserver/tablet_server_options.h"
 #include "yb/tserver/ts_tablet_manager.h"
@@ -127,6 +131,13 @@ class Heartbeater::Thread {
   bool IsCurrentThread() const;
   uint64_t CalculateUptime();
 
+  // Adds the rates of ops served by a tablet led by this server since the previous submission,
+  // and stores its total ops for the next one into tablet_leader_ops.
+  void AddTabletLeaderLoad(
+      const std::string& tablet_id, const tablet::TabletMetrics& tablet_metrics, double seconds,
+      std::unordered_map<std::string, std::pair<uint64_t, uint64_t>>* tablet_leader_ops,
+      master::TServerMetricsPB* metrics);
+
   const std::string& LogPrefix() const {
     return log_prefix_;
   }
@@ -191,6 +202,9 @@ class Heartbeater::Thread {
   uint64_t prev_reads_ = 0;
   uint64_t prev_writes_ = 0;
 
+  // Total read and write ops of each tablet led by this server, as of the previous submission.
+  std::unordered_map<std::string, std::pair<uint64_t, uint64_t>> prev_tablet_leader_ops_;
+
   MonoTime start_time_;
 
   rpc::Rpcs rpcs_;
@@ -352,6 +366,29 @@ uint64_t Heartbeater::Thread::CalculateUptime() {
   return uptime_seconds;
 }
 
+void Heartbeater::Thread::AddTabletLeaderLoad(
+    const std::string& tablet_id, const tablet::TabletMetrics& tablet_metrics, double seconds,
+    std::unordered_map<std::string, std::pair<uint64_t, uint64_t>>* tablet_leader_ops,
+    master::TServerMetricsPB* metrics) {
+  uint64_t reads = tablet_metrics.ql_read_latency->TotalCount() +
+                   tablet_metrics.redis_read_latency->TotalCount();
+  uint64_t writes = tablet_metrics.write_op_duration_client_propagated_consistency->TotalCount() +
+                    tablet_metrics.write_op_duration_commit_wait_consistency->TotalCount();
+  (*tablet_leader_ops)[tablet_id] = std::make_pair(reads, writes);
+
+  // A tablet that was not led by this server at the previous submission has no base to compute
+  // its rates from yet.
+  auto it = prev_tablet_leader_ops_.find(tablet_id);
+  if (it == prev_tablet_leader_ops_.end() || seconds <= 0) {
+    return;
+  }
+  auto* load = metrics->add_tablet_leader_loads();
+  load->set_tablet_id(tablet_id);
+  load->set_read_ops_per_sec(reads >= it->second.first ? (reads - it->second.first) / seconds : 0);
+  load->set_write_ops_per_sec(
+      writes >= it->second.second ? (writes - it->second.second) / seconds : 0);
+}
+
 Status Heartbeater::Thread::TryHeartbeat() {
   master::TSHeartbeatRequestPB req;
 
@@ -391,10 +428,14 @@ Status Heartbeater::Thread::TryHeartbeat() {
     }
 #endif
 
+    MonoDelta diff = MonoTime::Now() - prev_tserver_metrics_submission_;
+    double_t div = diff.ToSeconds();
+
     // Get the Total SST file sizes and set it in the proto buf
     std::vector<shared_ptr<yb::tablet::TabletPeer> > tablet_peers;
     uint64_t total_file_sizes = 0;
     uint64_t uncompressed_file_sizes = 0;
+    std::unordered_map<std::string, std::pair<uint64_t, uint64_t>> tablet_leader_ops;
     server_->tablet_manager()->GetTabletPeers(&tablet_peers);
     for (auto it = tablet_peers.begin(); it != tablet_peers.end(); it++) {
       shared_ptr<yb::tablet::TabletPeer> tablet_peer = *it;
@@ -402,8 +443,21 @@ Status Heartbeater::Thread::TryHeartbeat() {
         shared_ptr<yb::tablet::TabletClass> tablet_class = tablet_peer->shared_tablet();
         total_file_sizes += (tablet_class) ? tablet_class->GetTotalSSTFileSizes() : 0;
         uncompressed_file_sizes += (tablet_class) ? tablet_class->GetUncompressedSSTFileSizes() : 0;
+        if (tablet_class) {
+          auto* tablet_size = req.mutable_metrics()->add_tablet_sizes();
+          tablet_size->set_tablet_id(tablet_peer->tablet_id());
+          tablet_size->set_sst_file_size(tablet_class->GetTotalSSTFileSizes());
+          tablet_size->set_estimated_num_keys(tablet_class->GetEstimatedNumKeys());
+          log::Log* log = tablet_peer->log();
+          tablet_size->set_wal_file_size(log ? log->OnDiskSize() : 0);
+        }
+        if (tablet_class && tablet_peer->LeaderStatus() != consensus::LeaderStatus::NOT_LEADER) {
+          AddTabletLeaderLoad(tablet_peer->tablet_id(), *tablet_class->metrics(), div,
+                              &tablet_leader_ops, req.mutable_metrics());
+        }
       }
     }
+    prev_tablet_leader_ops_ = std::move(tablet_leader_ops);
     req.mutable_metrics()->set_total_sst_file_size(total_file_sizes);
     req.mutable_metrics()->set_uncompressed_sst_file_size(uncompressed_file_sizes);
 
@@ -417,9 +471,6 @@ Status Heartbeater::Thread::TryHeartbeat() {
     uint64_t num_writes = (writes_hist != nullptr) ? writes_hist->TotalCount() : 0;
 
     // Calculate the read and write ops per second.
-    MonoDelta diff = MonoTime::Now() - prev_tserver_metrics_submission_;
-    double_t div = diff.ToSeconds();
-
     double rops_per_sec = (div > 0 && num_reads > 0) ?
         (static_cast<double>(num_reads - prev_reads_) / div) : 0;
 
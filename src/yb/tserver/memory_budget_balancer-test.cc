@@ -0,0 +1,87 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/tserver/memory_budget_balancer.h"
+
+#include "yb/util/test_util.h"
+
+namespace yb {
+namespace tserver {
+
+namespace {
+
+constexpr size_t kStepPercentage = 10;
+constexpr size_t kMinPercentage = 50;
+
+} // namespace
+
+TEST(MemoryBudgetBalancerTest, Rebalance) {
+  MemoryBudgetBalancer balancer({800, 200}, 0 /* max_memstore */);
+  MemoryBudgetSignals signals;
+
+  // Nothing is starved, the budgets stay.
+  auto budgets = balancer.Rebalance(signals, kStepPercentage, kMinPercentage);
+  ASSERT_EQ(800, budgets.block_cache);
+  ASSERT_EQ(200, budgets.memstore);
+
+  // Flushes because of memory pressure move a step of the total to the memstores.
+  signals.memstore_pressure_flushes = 3;
+  budgets = balancer.Rebalance(signals, kStepPercentage, kMinPercentage);
+  ASSERT_EQ(700, budgets.block_cache);
+  ASSERT_EQ(300, budgets.memstore);
+
+  // Down to half of the initial block cache.
+  for (int i = 0; i != 10; ++i) {
+    ++signals.memstore_pressure_flushes;
+    budgets = balancer.Rebalance(signals, kStepPercentage, kMinPercentage);
+  }
+  ASSERT_EQ(400, budgets.block_cache);
+  ASSERT_EQ(600, budgets.memstore);
+
+  // A full cache that evicts blocks which are then read again gets memory back, but not below
+  // twice the current memstore usage.
+  signals.block_cache_usage = 400;
+  signals.memstore_usage = 220;
+  signals.block_cache_misses = 10;
+  signals.block_cache_evictions = 10;
+  budgets = balancer.Rebalance(signals, kStepPercentage, kMinPercentage);
+  ASSERT_EQ(500, budgets.block_cache);
+  ASSERT_EQ(500, budgets.memstore);
+  signals.block_cache_usage = 500;
+  signals.block_cache_misses += 10;
+  signals.block_cache_evictions += 10;
+  budgets = balancer.Rebalance(signals, kStepPercentage, kMinPercentage);
+  ASSERT_EQ(560, budgets.block_cache);
+  ASSERT_EQ(440, budgets.memstore);
+
+  // Both starved, nothing to rebalance.
+  signals.block_cache_usage = 560;
+  signals.block_cache_misses += 10;
+  signals.block_cache_evictions += 10;
+  ++signals.memstore_pressure_flushes;
+  budgets = balancer.Rebalance(signals, kStepPercentage, kMinPercentage);
+  ASSERT_EQ(560, budgets.block_cache);
+  ASSERT_EQ(440, budgets.memstore);
+}
+
+TEST(MemoryBudgetBalancerTest, MaxMemstore) {
+  MemoryBudgetBalancer balancer({800, 200}, 250 /* max_memstore */);
+  MemoryBudgetSignals signals;
+  signals.memstore_pressure_flushes = 1;
+  auto budgets = balancer.Rebalance(signals, kStepPercentage, kMinPercentage);
+  ASSERT_EQ(750, budgets.block_cache);
+  ASSERT_EQ(250, budgets.memstore);
+}
+
+} // namespace tserver
+} // namespace yb
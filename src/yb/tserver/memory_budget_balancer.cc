@@ -0,0 +1,58 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/tserver/memory_budget_balancer.h"
+
+#include <algorithm>
+
+namespace yb {
+namespace tserver {
+
+MemoryBudgetBalancer::MemoryBudgetBalancer(const MemoryBudgets& initial, size_t max_memstore)
+    : initial_(initial), max_memstore_(max_memstore), budgets_(initial) {}
+
+MemoryBudgets MemoryBudgetBalancer::Rebalance(
+    const MemoryBudgetSignals& signals, size_t step_percentage, size_t min_percentage) {
+  const bool cache_starved =
+      signals.block_cache_misses > last_signals_.block_cache_misses &&
+      signals.block_cache_evictions > last_signals_.block_cache_evictions &&
+      signals.block_cache_usage >= budgets_.block_cache / 10 * 9;
+  const bool memstore_starved =
+      signals.memstore_pressure_flushes > last_signals_.memstore_pressure_flushes;
+  last_signals_ = signals;
+
+  const size_t step = (initial_.block_cache + initial_.memstore) / 100 * step_percentage;
+  const size_t min_block_cache = initial_.block_cache / 100 * min_percentage;
+  const size_t min_memstore = initial_.memstore / 100 * min_percentage;
+  if (memstore_starved && !cache_starved) {
+    size_t delta = std::min(step, budgets_.block_cache - std::min(budgets_.block_cache,
+                                                                  min_block_cache));
+    if (max_memstore_ != 0) {
+      delta = std::min(delta, max_memstore_ - std::min(max_memstore_, budgets_.memstore));
+    }
+    budgets_.block_cache -= delta;
+    budgets_.memstore += delta;
+  } else if (cache_starved && !memstore_starved &&
+             signals.memstore_usage < budgets_.memstore / 2) {
+    // Leave the memstores twice their current usage, so taking memory from them does not cause
+    // flushes right away.
+    const size_t floor = std::max(min_memstore, signals.memstore_usage * 2);
+    const size_t delta = std::min(step, budgets_.memstore - std::min(budgets_.memstore, floor));
+    budgets_.memstore -= delta;
+    budgets_.block_cache += delta;
+  }
+  return budgets_;
+}
+
+} // namespace tserver
+} // namespace yb
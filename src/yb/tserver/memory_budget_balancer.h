@@ -0,0 +1,72 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#ifndef YB_TSERVER_MEMORY_BUDGET_BALANCER_H
+#define YB_TSERVER_MEMORY_BUDGET_BALANCER_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace yb {
+namespace tserver {
+
+struct MemoryBudgets {
+  size_t block_cache = 0;
+  size_t memstore = 0;
+};
+
+// What the block cache and the memstores went through since startup, sampled by the flush
+// background task.
+struct MemoryBudgetSignals {
+  // Cumulative block cache counters.
+  uint64_t block_cache_misses = 0;
+  uint64_t block_cache_evictions = 0;
+  size_t block_cache_usage = 0;
+
+  // Cumulative number of flushes scheduled because the memstores exceeded their budget.
+  uint64_t memstore_pressure_flushes = 0;
+  size_t memstore_usage = 0;
+};
+
+// Moves memory between the block cache and the global memstore budget, keeping their sum, and so
+// the share of the process memory limit they were given at startup, constant.
+//
+// Each round, a step of the total is moved towards the side that is starved, provided the other
+// one is not:
+// - the block cache is starved when it is full and evicted blocks that were read again, i.e. a
+//   larger cache would have had a better hit rate;
+// - the memstores are starved when they had to be flushed because of memory pressure.
+// Memory is only taken from the memstores when they use less than half of their budget, and
+// neither budget goes below min_percentage of its initial size. Not thread safe.
+class MemoryBudgetBalancer {
+ public:
+  // max_memstore is the absolute limit of the memstore budget, 0 for no limit.
+  MemoryBudgetBalancer(const MemoryBudgets& initial, size_t max_memstore);
+
+  // Returns the budgets for the next round, given the signals sampled at the end of this one.
+  MemoryBudgets Rebalance(
+      const MemoryBudgetSignals& signals, size_t step_percentage, size_t min_percentage);
+
+  const MemoryBudgets& budgets() const { return budgets_; }
+
+ private:
+  const MemoryBudgets initial_;
+  const size_t max_memstore_;
+  MemoryBudgets budgets_;
+  MemoryBudgetSignals last_signals_;
+};
+
+} // namespace tserver
+} // namespace yb
+
+#endif // YB_TSERVER_MEMORY_BUDGET_BALANCER_H
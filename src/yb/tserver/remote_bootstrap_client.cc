@@ -32,6 +32,9 @@
 
 #include "yb/tserver/remote_bootstrap_client.h"
 
+#include <future>
+#include <unordered_set>
+
 #include <gflags/gflags.h>
 #include <glog/logging.h>
 
@@ -39,12 +42,14 @@
 #include "yb/consensus/consensus.h"
 #include "yb/consensus/consensus_meta.h"
 #include "yb/consensus/metadata.pb.h"
+#include "yb/docdb/docdb_rocksdb_util.h"
 #include "yb/fs/fs_manager.h"
 #include "yb/gutil/strings/substitute.h"
 #include "yb/gutil/strings/util.h"
 #include "yb/gutil/walltime.h"
 #include "yb/rpc/messenger.h"
 #include "yb/rpc/rpc_controller.h"
+#include "yb/rocksdb/rate_limiter.h"
 #include "yb/tablet/tablet.pb.h"
 #include "yb/tablet/tablet.h"
 #include "yb/tablet/tablet_bootstrap_if.h"
@@ -115,14 +120,24 @@ DEFINE_int64(remote_bootstrap_rate_limit_bytes_per_sec, 256_MB,
              "the total limit will be 2 * remote_bootstrap_rate_limit_bytes_per_sec because a "
              "tserver or master can act both as a sender and receiver at the same time.");
 
+DEFINE_bool(remote_bootstrap_use_disk_rate_limiter, true,
+            "Whether remote bootstrap writes of downloaded data should also go through the disk "
+            "rate limiter shared with flushes and compactions, at the lowest priority.");
+
+DEFINE_int32(remote_bootstrap_max_concurrent_file_downloads, 4,
+             "Maximum number of RocksDB files downloaded at once by a remote bootstrap session. "
+             "The transmission rate of the session is shared by all of them.");
+TAG_FLAG(remote_bootstrap_max_concurrent_file_downloads, advanced);
+
+DEFINE_int32(remote_bootstrap_fetch_data_max_retries, 3,
+             "Number of times a failed fetch of a data chunk is retried from the same offset "
+             "before the download of the file is failed.");
+TAG_FLAG(remote_bootstrap_fetch_data_max_retries, advanced);
+
 DEFINE_int32(bytes_remote_bootstrap_durable_write_mb, 8,
              "Explicitly call fsync after downloading the specified amount of data in MB "
              "during a remote bootstrap session. If 0 fsync() is not called.");
 
-// RETURN_NOT_OK_PREPEND() with a remote-error unwinding step.
-#define RETURN_NOT_OK_UNWIND_PREPEND(status, controller, msg) \
-  RETURN_NOT_OK_PREPEND(UnwindRemoteError(status, controller), msg)
-
 namespace yb {
 namespace tserver {
 
@@ -595,6 +610,7 @@ Status RemoteBootstrapClient::DownloadFile(
   RETURN_NOT_OK(fs_manager_->env()->CreateDirs(DirName(file_path)));
 
   if (file_pb.inode() != 0) {
+    std::lock_guard<std::mutex> lock(inode2file_mutex_);
     auto it = inode2file_.find(file_pb.inode());
     if (it != inode2file_.end()) {
       VLOG_WITH_PREFIX(2) << "File with the same inode already found: " << file_path
@@ -621,6 +637,7 @@ Status RemoteBootstrapClient::DownloadFile(
   VLOG_WITH_PREFIX(2) << "Downloaded file " << file_path;
 
   if (file_pb.inode() != 0) {
+    std::lock_guard<std::mutex> lock(inode2file_mutex_);
     inode2file_.emplace(file_pb.inode(), file_path);
   }
 
@@ -648,14 +665,64 @@ Status RemoteBootstrapClient::DownloadRocksDBFiles() {
 
   RETURN_NOT_OK(CreateTabletDirectories(rocksdb_dir, meta_->fs_manager()));
 
-  DataIdPB data_id;
-  data_id.set_type(DataIdPB::ROCKSDB_FILE);
-  for (auto const& file_pb : new_sb->rocksdb_files()) {
+  // Files that are hard links to an earlier file are linked after the earlier ones are
+  // downloaded, the others are downloaded concurrently.
+  std::vector<const tablet::FilePB*> files;
+  std::vector<const tablet::FilePB*> links;
+  std::unordered_set<uint64_t> inodes;
+  for (const auto& file_pb : new_sb->rocksdb_files()) {
+    if (file_pb.inode() != 0 && !inodes.insert(file_pb.inode()).second) {
+      links.push_back(&file_pb);
+    } else {
+      files.push_back(&file_pb);
+    }
+  }
+
+  auto download = [this, &rocksdb_dir](const tablet::FilePB& file_pb) -> Status {
+    DataIdPB data_id;
+    data_id.set_type(DataIdPB::ROCKSDB_FILE);
     auto start = MonoTime::Now();
     RETURN_NOT_OK(DownloadFile(file_pb, rocksdb_dir, &data_id));
     auto elapsed = MonoTime::Now().GetDeltaSince(start);
-    LOG(INFO) << "Downloaded file " << file_pb.name() << " of size " << file_pb.size_bytes()
-              << " in " << elapsed.ToSeconds() << " seconds";
+    LOG_WITH_PREFIX(INFO) << "Downloaded file " << file_pb.name() << " of size "
+                          << file_pb.size_bytes() << " in " << elapsed.ToSeconds() << " seconds";
+    return Status::OK();
+  };
+
+  const size_t num_workers = std::min<size_t>(
+      files.size(), std::max(FLAGS_remote_bootstrap_max_concurrent_file_downloads, 1));
+  concurrent_file_downloads_.store(std::max<size_t>(num_workers, 1), std::memory_order_release);
+  std::atomic<size_t> next_file(0);
+  std::atomic<bool> failed(false);
+  auto worker = [&files, &next_file, &failed, &download]() -> Status {
+    for (;;) {
+      auto idx = next_file.fetch_add(1, std::memory_order_acq_rel);
+      if (idx >= files.size() || failed.load(std::memory_order_acquire)) {
+        return Status::OK();
+      }
+      auto status = download(*files[idx]);
+      if (!status.ok()) {
+        failed.store(true, std::memory_order_release);
+        return status;
+      }
+    }
+  };
+  std::vector<std::future<Status>> workers;
+  for (size_t i = 1; i < num_workers; ++i) {
+    workers.push_back(std::async(std::launch::async, worker));
+  }
+  Status status = worker();
+  for (auto& future : workers) {
+    auto worker_status = future.get();
+    if (status.ok()) {
+      status = worker_status;
+    }
+  }
+  concurrent_file_downloads_.store(1, std::memory_order_release);
+  RETURN_NOT_OK(status);
+
+  for (const auto* file_pb : links) {
+    RETURN_NOT_OK(download(*file_pb));
   }
 
   // To avoid adding new file type to remote bootstrap we move intents as subdir of regular DB.
@@ -730,6 +797,7 @@ Status RemoteBootstrapClient::DownloadFile(const DataIdPB& data_id,
   // For periodic sync, indicates number of bytes which need to be sync'ed.
   size_t periodic_sync_unsynced_bytes = 0;
   uint64_t offset = 0;
+  int retries = 0;
   int32_t max_length = std::min(FLAGS_remote_bootstrap_max_chunk_size,
                                 FLAGS_rpc_max_message_size - kBytesReservedForMessageHeaders);
 
@@ -743,13 +811,22 @@ Status RemoteBootstrapClient::DownloadFile(const DataIdPB& data_id,
       }
       return static_cast<uint64_t>(FLAGS_remote_bootstrap_rate_limit_bytes_per_sec / n_started_);
     };
+    // Files downloaded concurrently by this session share its rate.
+    auto session_rate_updater = [this]() {
+      return rate_updater() / std::max(concurrent_file_downloads_.load(std::memory_order_acquire),
+                                       1);
+    };
 
-    rate_limiter = std::make_unique<RateLimiter>(rate_updater);
+    rate_limiter = std::make_unique<RateLimiter>(session_rate_updater);
   } else {
     // Inactive RateLimiter.
     rate_limiter = std::make_unique<RateLimiter>();
   }
 
+  rocksdb::RateLimiter* disk_rate_limiter =
+      FLAGS_remote_bootstrap_use_disk_rate_limiter ? docdb::SharedCompactFlushRateLimiter()
+                                                   : nullptr;
+
   rpc::RpcController controller;
   controller.set_timeout(MonoDelta::FromMilliseconds(session_idle_timeout_millis_));
   FetchDataRequestPB req;
@@ -773,14 +850,39 @@ Status RemoteBootstrapClient::DownloadFile(const DataIdPB& data_id,
     auto status = rate_limiter->SendOrReceiveData([this, &req, &resp, &controller]() {
       return proxy_->FetchData(req, &resp, &controller);
     }, [&resp]() { return resp.ByteSize(); });
-    RETURN_NOT_OK_UNWIND_PREPEND(status, controller, "Unable to fetch data from remote");
-    DCHECK_LE(resp.chunk().data().size(), max_length);
-
-    // Sanity-check for corruption.
-    RETURN_NOT_OK_PREPEND(VerifyData(offset, resp.chunk()),
-                          Substitute("Error validating data item $0", data_id.ShortDebugString()));
+    status = UnwindRemoteError(status, controller);
+    if (status.ok()) {
+      DCHECK_LE(resp.chunk().data().size(), max_length);
+      // Sanity-check for corruption.
+      status = VerifyData(offset, resp.chunk());
+      if (!status.ok()) {
+        status = status.CloneAndPrepend(
+            Substitute("Error validating data item $0", data_id.ShortDebugString()));
+      }
+    } else {
+      status = status.CloneAndPrepend("Unable to fetch data from remote");
+    }
+    if (!status.ok()) {
+      // Nothing from the failed chunk was written, so the download resumes at the same offset.
+      if (++retries > FLAGS_remote_bootstrap_fetch_data_max_retries) {
+        return status;
+      }
+      LOG_WITH_PREFIX(WARNING) << "Retrying fetch of " << data_id.ShortDebugString()
+                               << " at offset " << offset << ": " << status;
+      SleepFor(MonoDelta::FromMilliseconds(100 * retries));
+      continue;
+    }
+    retries = 0;
 
     // Write the data.
+    if (disk_rate_limiter) {
+      int64_t left = resp.chunk().data().size();
+      while (left > 0) {
+        auto bytes = std::min(left, disk_rate_limiter->GetSingleBurstBytes());
+        disk_rate_limiter->Request(bytes, rocksdb::Env::IO_BACKGROUND);
+        left -= bytes;
+      }
+    }
     RETURN_NOT_OK(appendable->Append(resp.chunk().data()));
     VLOG(3) << "resp size: " << resp.ByteSize()
             << ", chunk size: " << resp.chunk().data().size();
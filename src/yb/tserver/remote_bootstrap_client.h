@@ -35,6 +35,7 @@
 #include <atomic>
 #include <string>
 #include <memory>
+#include <mutex>
 #include <vector>
 #include <unordered_map>
 
@@ -133,7 +134,7 @@ class RemoteBootstrapClient {
 
  protected:
   FRIEND_TEST(RemoteBootstrapRocksDBClientTest, TestBeginEndSession);
-  FRIEND_TEST(RemoteBootstrapRocksDBClientTest, TestDownloadRocksDBFiles);
+  friend class RemoteBootstrapRocksDBClientTest;
 
   // Extract the embedded Status message from the given ErrorStatusPB.
   // The given ErrorStatusPB must extend RemoteBootstrapErrorPB.
@@ -162,7 +163,9 @@ class RemoteBootstrapClient {
   CHECKED_STATUS WriteConsensusMetadata();
 
   // Download a single remote file. The block and WAL implementations delegate
-  // to this method when downloading files.
+  // to this method when downloading files. A chunk that fails to be fetched or
+  // verified is fetched again from the same offset, up to
+  // FLAGS_remote_bootstrap_fetch_data_max_retries times.
   //
   // An Appendable is typically a WritableFile (WAL).
   //
@@ -173,6 +176,7 @@ class RemoteBootstrapClient {
 
   virtual CHECKED_STATUS CreateTabletDirectories(const string& db_dir, FsManager* fs);
 
+  // Downloads up to FLAGS_remote_bootstrap_max_concurrent_file_downloads files at once.
   CHECKED_STATUS DownloadRocksDBFiles();
 
   CHECKED_STATUS VerifyData(uint64_t offset, const DataChunkPB& resp);
@@ -223,8 +227,12 @@ class RemoteBootstrapClient {
   bool succeeded_;
 
  private:
+  std::mutex inode2file_mutex_;
   std::unordered_map<uint64_t, std::string> inode2file_;
 
+  // Number of files being downloaded at once, which share the transmission rate of the session.
+  std::atomic<int> concurrent_file_downloads_{1};
+
   DISALLOW_COPY_AND_ASSIGN(RemoteBootstrapClient);
 };
 
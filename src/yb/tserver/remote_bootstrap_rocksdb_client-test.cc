@@ -18,6 +18,8 @@
 
 using std::shared_ptr;
 
+DECLARE_int32(remote_bootstrap_max_concurrent_file_downloads);
+
 namespace yb {
 namespace tserver {
 
@@ -33,6 +35,9 @@ class RemoteBootstrapRocksDBClientTest : public RemoteBootstrapClientTest {
   void SetUp() override {
     RemoteBootstrapClientTest::SetUp();
   }
+
+ protected:
+  void TestDownloadRocksDBFiles();
 };
 
 // Basic begin / end remote bootstrap session.
@@ -42,8 +47,7 @@ TEST_F(RemoteBootstrapRocksDBClientTest, TestBeginEndSession) {
   ASSERT_OK(client_->Finish());
 }
 
-// Basic RocksDB files download unit test.
-TEST_F(RemoteBootstrapRocksDBClientTest, TestDownloadRocksDBFiles) {
+void RemoteBootstrapRocksDBClientTest::TestDownloadRocksDBFiles() {
   TabletStatusListener listener(meta_);
   ASSERT_OK(client_->DownloadRocksDBFiles());
   auto tablet_peer_checkpoint_dir = tablet_peer_->tablet()->GetLastRocksDBCheckpointDirForTest();
@@ -78,5 +82,15 @@ TEST_F(RemoteBootstrapRocksDBClientTest, TestDownloadRocksDBFiles) {
   }
 }
 
+// Basic RocksDB files download unit test.
+TEST_F(RemoteBootstrapRocksDBClientTest, TestDownloadRocksDBFiles) {
+  TestDownloadRocksDBFiles();
+}
+
+TEST_F(RemoteBootstrapRocksDBClientTest, TestDownloadRocksDBFilesOneAtATime) {
+  FLAGS_remote_bootstrap_max_concurrent_file_downloads = 1;
+  TestDownloadRocksDBFiles();
+}
+
 } // namespace tserver
 } // namespace yb
@@ -81,6 +81,10 @@ class RemoteBootstrapServiceImpl : public RemoteBootstrapServiceIf {
 
   virtual void Shutdown() override;
 
+  rpc::RpcPriorityClass PriorityClass(const std::string& method_name) const override {
+    return rpc::RpcPriorityClass::kBulk;
+  }
+
  protected:
   typedef YB_EDITION_NS_PREFIX RemoteBootstrapSession RemoteBootstrapSessionClass;
 
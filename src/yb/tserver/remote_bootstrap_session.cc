@@ -111,6 +111,14 @@ Status RemoteBootstrapSession::ChangeRole() {
                                            tablet::TabletStatePB_Name(tablet_state), tablet_state));
   }
 
+  // A follower could be the source of the bootstrap, see FLAGS_remote_bootstrap_from_followers.
+  // Only the leader could change the config, and it promotes the peer once it catches up.
+  if (consensus->role() != RaftPeerPB::LEADER) {
+    LOG(INFO) << "Not changing role of " << requestor_uuid_ << " after remote bootstrap from "
+              << "non leader, it is promoted by the leader";
+    return Status::OK();
+  }
+
   // If peer being bootstrapped is already a VOTER, don't send the ChangeConfig request. This could
   // happen when a tserver that is already a VOTER in the configuration tombstones its tablet, and
   // the leader starts bootstrapping it.
@@ -188,6 +196,10 @@ Result<google::protobuf::RepeatedPtrField<tablet::FilePB>> ListFiles(const std::
   google::protobuf::RepeatedPtrField<tablet::FilePB> result;
   result.Reserve(files.size());
   for (const auto& file : files) {
+    if (file == tablet::kCheckpointManifestFileName) {
+      // Only used by backups, RocksDB does not need it.
+      continue;
+    }
     auto full_path = JoinPathSegments(dir, file);
     if (VERIFY_RESULT(env->IsDirectory(full_path))) {
       auto sub_files = VERIFY_RESULT(ListFiles(full_path));
@@ -79,6 +79,14 @@ bool LeaderTabletPeer::FillTerm(TabletServerErrorPB* error, rpc::RpcContext* con
   auto leader_term = LeaderTerm(*peer);
   if (!leader_term.ok()) {
     peer->tablet()->metrics()->not_leader_rejections->Increment();
+    if (leader_term.status().error_code() == TabletServerErrorPB::NOT_THE_LEADER) {
+      auto consensus_state = peer->shared_consensus()->ConsensusState(
+          consensus::CONSENSUS_CONFIG_ACTIVE);
+      if (!consensus_state.leader_uuid().empty() &&
+          consensus_state.leader_uuid() != peer->permanent_uuid()) {
+        error->set_leader_uuid(consensus_state.leader_uuid());
+      }
+    }
     SetupErrorAndRespond(error, leader_term.status(), context);
     return false;
   }
@@ -51,7 +51,9 @@
 
 #include "yb/util/crc.h"
 #include "yb/util/curl_util.h"
+#include "yb/util/size_literals.h"
 #include "yb/util/url-coding.h"
+#include "yb/util/memory/arena.h"
 
 using yb::consensus::RaftConfigPB;
 using yb::consensus::RaftPeerPB;
@@ -563,6 +565,38 @@ TEST_F(TabletServerTest, TestCreateTablet_TabletExists) {
   }
 }
 
+TEST_F(TabletServerTest, TestCreateTablets) {
+  CreateTabletsRequestPB req;
+  CreateTabletsResponsePB resp;
+  RpcController rpc;
+
+  req.set_dest_uuid(mini_server_->server()->fs_manager()->uuid());
+  Schema schema = SchemaBuilder(schema_).Build();
+  for (const auto& tablet_id : {std::string(kTabletId), std::string("new_tablet")}) {
+    auto* tablet_req = req.add_tablets();
+    tablet_req->set_table_id("testtb");
+    tablet_req->set_tablet_id(tablet_id);
+    tablet_req->set_table_name("testtb");
+    tablet_req->mutable_config()->CopyFrom(mini_server_->CreateLocalConfig());
+    SchemaToPB(schema, tablet_req->mutable_schema());
+  }
+
+  // Send the call
+  {
+    SCOPED_TRACE(req.DebugString());
+    ASSERT_OK(admin_proxy_->CreateTablets(req, &resp, &rpc));
+    SCOPED_TRACE(resp.DebugString());
+    ASSERT_FALSE(resp.has_error());
+    ASSERT_EQ(2, resp.tablets_size());
+    // The failure of a tablet does not fail the others.
+    ASSERT_EQ(TabletServerErrorPB::TABLET_ALREADY_EXISTS, resp.tablets(0).error().code());
+    ASSERT_FALSE(resp.tablets(1).has_error());
+  }
+
+  std::shared_ptr<TabletPeer> tablet;
+  ASSERT_TRUE(mini_server_->server()->tablet_manager()->LookupTablet("new_tablet", &tablet));
+}
+
 TEST_F(TabletServerTest, TestDeleteTablet) {
   std::shared_ptr<TabletPeer> tablet;
 
@@ -889,5 +923,97 @@ TEST_F(TabletServerTest, TestChecksumScan) {
   ASSERT_EQ(first_crc, resp.checksum());
 }
 
+// Checksum scanned in chunks should be the same as the one scanned at once.
+TEST_F(TabletServerTest, TestChunkedChecksumScan) {
+  constexpr int kNumRows = 5;
+  InsertTestRowsRemote(0, 1, kNumRows);
+
+  ChecksumRequestPB req;
+  req.set_tablet_id(kTabletId);
+  ChecksumResponsePB resp;
+  RpcController controller;
+  ASSERT_OK(proxy_->Checksum(req, &resp, &controller));
+  ASSERT_FALSE(resp.has_error()) << resp.error().DebugString();
+  ASSERT_FALSE(resp.has_next_row_key());
+  ASSERT_EQ(kNumRows, resp.num_rows());
+  const uint64_t full_crc = resp.checksum();
+
+  req.set_max_rows(2);
+  int num_chunks = 0;
+  uint64_t num_rows = 0;
+  for (;;) {
+    controller.Reset();
+    ASSERT_OK(proxy_->Checksum(req, &resp, &controller));
+    ASSERT_FALSE(resp.has_error()) << resp.error().DebugString();
+    ++num_chunks;
+    num_rows += resp.num_rows();
+    if (!resp.has_next_row_key()) {
+      break;
+    }
+    req.set_start_row_key(resp.next_row_key());
+    req.set_start_checksum(resp.checksum());
+  }
+  ASSERT_EQ(3, num_chunks);
+  ASSERT_EQ(kNumRows, num_rows);
+  ASSERT_EQ(full_crc, resp.checksum());
+}
+
+// Compares parsing and building read messages on heap and on an arena reused between calls, like
+// the arena of an inbound call.
+TEST(TabletServerMessagesTest, CallArenaMicroBenchmark) {
+  ReadRequestPB request;
+  request.set_tablet_id("tablet");
+  request.set_proxy_uuid("proxy");
+  for (int i = 0; i != 8; ++i) {
+    auto* ql_read = request.add_ql_batch();
+    ql_read->set_client(YQL_CLIENT_CQL);
+    ql_read->set_schema_version(1);
+    ql_read->set_hash_code(i);
+    ql_read->add_hashed_column_values()->mutable_value()->set_int32_value(i);
+  }
+  const std::string serialized = request.SerializeAsString();
+  const int kIterations = AllowSlowTests() ? 1000000 : 10000;
+  const size_t kInitialBlockSize = 4_KB;
+
+  auto handle = [&serialized](ReadRequestPB* req, ReadResponsePB* resp) {
+    ASSERT_TRUE(req->ParseFromString(serialized));
+    for (int i = 0; i != req->ql_batch_size(); ++i) {
+      resp->add_ql_batch()->set_status(QLResponsePB::YQL_STATUS_OK);
+    }
+    resp->mutable_used_read_time()->set_read_ht(1);
+  };
+
+  MonoTime start = MonoTime::Now();
+  for (int i = 0; i != kIterations; ++i) {
+    auto req = std::make_shared<ReadRequestPB>();
+    auto resp = std::make_shared<ReadResponsePB>();
+    handle(req.get(), resp.get());
+  }
+  MonoDelta heap_time = MonoTime::Now().GetDeltaSince(start);
+
+  ThreadSafeArena arena(8_KB, 128_KB);
+  uint64_t extra_blocks_bytes = 0;
+  start = MonoTime::Now();
+  for (int i = 0; i != kIterations; ++i) {
+    google::protobuf::ArenaOptions options;
+    options.initial_block = static_cast<char*>(
+        arena.AllocateBytesAligned(kInitialBlockSize, alignof(std::max_align_t)));
+    options.initial_block_size = kInitialBlockSize;
+    {
+      google::protobuf::Arena protobuf_arena(options);
+      handle(google::protobuf::Arena::CreateMessage<ReadRequestPB>(&protobuf_arena),
+             google::protobuf::Arena::CreateMessage<ReadResponsePB>(&protobuf_arena));
+      extra_blocks_bytes += protobuf_arena.SpaceAllocated() - kInitialBlockSize;
+    }
+    arena.Reset();
+  }
+  MonoDelta arena_time = MonoTime::Now().GetDeltaSince(start);
+
+  LOG(INFO) << "Per request, heap: " << heap_time.ToMicroseconds() * 1000 / kIterations
+            << "ns, arena: " << arena_time.ToMicroseconds() * 1000 / kIterations
+            << "ns, arena bytes allocated beyond the initial block: "
+            << extra_blocks_bytes / kIterations;
+}
+
 } // namespace tserver
 } // namespace yb
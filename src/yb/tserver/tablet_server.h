@@ -125,6 +125,10 @@ class TabletServer : public server::RpcAndWebServerBase, public TabletServerIf {
 
   const scoped_refptr<MetricEntity>& MetricEnt() const override { return metric_entity(); }
 
+  const std::shared_ptr<MemTracker>& mem_tracker() const override {
+    return RpcAndWebServerBase::mem_tracker();
+  }
+
   CHECKED_STATUS PopulateLiveTServers(const master::TSHeartbeatResponsePB& heartbeat_resp);
 
   CHECKED_STATUS GetLiveTServers(std::vector<master::TSInformationPB> *live_tservers) const {
@@ -17,6 +17,7 @@
 #include "yb/client/meta_cache.h"
 #include "yb/server/clock.h"
 #include "yb/tserver/ts_tablet_manager.h"
+#include "yb/util/mem_tracker.h"
 #include "yb/util/metrics.h"
 
 namespace yb {
@@ -36,6 +37,8 @@ class TabletServerIf : public LocalTabletServer {
   virtual uint64_t ysql_catalog_version() const = 0;
 
   virtual const scoped_refptr<MetricEntity>& MetricEnt() const = 0;
+
+  virtual const std::shared_ptr<MemTracker>& mem_tracker() const = 0;
 };
 
 } // namespace tserver
@@ -47,12 +47,15 @@
 #include "yb/docdb/cql_operation.h"
 #include "yb/docdb/doc_rowwise_iterator.h"
 #include "yb/docdb/pgsql_operation.h"
+#include "yb/docdb/query_mem_tracker.h"
 
 #include "yb/gutil/bind.h"
 #include "yb/gutil/casts.h"
 #include "yb/gutil/stl_util.h"
 #include "yb/gutil/stringprintf.h"
 #include "yb/gutil/strings/escaping.h"
+#include "yb/rocksdb/iostats_context.h"
+#include "yb/rocksdb/perf_context.h"
 #include "yb/server/hybrid_clock.h"
 #include "yb/tablet/tablet_bootstrap_if.h"
 #include "yb/tserver/remote_bootstrap_service.h"
@@ -63,6 +66,7 @@
 #include "yb/tablet/tablet_metrics.h"
 
 #include "yb/tablet/operations/change_metadata_operation.h"
+#include "yb/tablet/operations/ingest_sst_operation.h"
 #include "yb/tablet/operations/truncate_operation.h"
 #include "yb/tablet/operations/update_txn_operation.h"
 #include "yb/tablet/operations/write_operation.h"
@@ -72,6 +76,7 @@
 #include "yb/tserver/tserver.pb.h"
 #include "yb/util/crc.h"
 #include "yb/util/debug/trace_event.h"
+#include "yb/util/env.h"
 #include "yb/util/faststring.h"
 #include "yb/util/flag_tags.h"
 #include "yb/util/mem_tracker.h"
@@ -117,11 +122,26 @@ DEFINE_test_flag(int32, scanner_inject_latency_on_each_batch_ms, 0,
                  "before reading each batch of data on the tablet server.");
 
 DECLARE_int32(memory_limit_warn_threshold_percentage);
+DECLARE_int32(memory_limit_soft_percentage);
+
+DEFINE_int32(write_throttle_max_retry_after_ms, 1000,
+             "Time a client is asked to wait before retrying a write rejected because the tablet "
+             "is overloaded, when the overload is at its maximum. Smaller overloads get "
+             "proportionally smaller delays.");
+TAG_FLAG(write_throttle_max_retry_after_ms, advanced);
+TAG_FLAG(write_throttle_max_retry_after_ms, runtime);
 
 DEFINE_int32(max_wait_for_safe_time_ms, 5000,
              "Maximum time in milliseconds to wait for the safe time to advance when trying to "
              "scan at the given hybrid_time.");
 
+DEFINE_bool(follower_reads_wait_for_safe_time_async, false,
+            "Reads that do not require a leader lease and have to wait for safe time to reach "
+            "their read time are parked until replication advances it, instead of blocking an "
+            "RPC thread while they wait.");
+TAG_FLAG(follower_reads_wait_for_safe_time_async, advanced);
+TAG_FLAG(follower_reads_wait_for_safe_time_async, runtime);
+
 DEFINE_test_flag(bool, tserver_noop_read_write, false, "Respond NOOP to read/write.");
 
 DEFINE_int32(max_stale_read_bound_time_ms, 0, "If we are allowed to read from followers, "
@@ -147,6 +167,20 @@ DEFINE_test_flag(bool, simulate_time_out_failures, false, "If true, we will rand
 DEFINE_test_flag(double, respond_write_failed_probability, 0.0,
                  "Probability to respond that write request is failed");
 
+DEFINE_int32(read_perf_level, 0,
+             "RocksDB perf level used to collect the perf context and IO stats of sampled reads, "
+             "see rocksdb::PerfLevel: 1 collects counts only, 2 also collects times except for "
+             "mutexes, 3 collects all times. The counters are added to the read trace, so they are "
+             "logged for slow reads, and to the tablet metrics. 0 to disable.");
+TAG_FLAG(read_perf_level, advanced);
+TAG_FLAG(read_perf_level, runtime);
+
+DEFINE_int32(read_perf_sampling_rate, 100,
+             "When read_perf_level is set, the perf context is collected for one of this many "
+             "reads, and for every read that asks for its trace.");
+TAG_FLAG(read_perf_sampling_rate, advanced);
+TAG_FLAG(read_perf_sampling_rate, runtime);
+
 DECLARE_uint64(max_clock_skew_usec);
 
 namespace yb {
@@ -187,6 +221,7 @@ using tablet::TabletPeer;
 using tablet::TabletPeerPtr;
 using tablet::TabletStatusPB;
 using tablet::TruncateOperationState;
+using tablet::IngestSstOperationState;
 using tablet::OperationCompletionCallback;
 using tablet::WriteOperationState;
 
@@ -220,9 +255,17 @@ Status GetTabletRef(const TabletPeerPtr& tablet_peer,
 
 } // namespace
 
-template<class Resp>
-bool TabletServiceImpl::CheckMemoryPressure(
-    tablet::Tablet* tablet, Resp* resp, rpc::RpcContext* context) {
+namespace {
+
+// Pressure from 0 to 1 is turned into the time the client is asked to wait before retrying.
+MonoDelta RetryAfter(double pressure) {
+  return MonoDelta::FromMilliseconds(
+      std::max(1.0, FLAGS_write_throttle_max_retry_after_ms * std::min(1.0, pressure)));
+}
+
+} // namespace
+
+bool TabletServiceImpl::CheckWriteThrottling(tablet::Tablet* tablet, rpc::RpcContext* context) {
   // Check for memory pressure; don't bother doing any additional work if we've
   // exceeded the limit.
   double capacity_pct;
@@ -236,9 +279,22 @@ bool TabletServiceImpl::CheckMemoryPressure(
     } else {
       YB_LOG_EVERY_N_SECS(INFO, 1) << "Rejecting Write request: " << msg << THROTTLE_MSG;
     }
-    SetupErrorAndRespond(resp->mutable_error(), STATUS(ServiceUnavailable, msg),
-                         TabletServerErrorPB::UNKNOWN_ERROR,
-                         context);
+    auto soft_pct = FLAGS_memory_limit_soft_percentage;
+    auto pressure = soft_pct < 100 ? (capacity_pct - soft_pct) / (100 - soft_pct) : 1.0;
+    context->RespondRpcFailure(rpc::ErrorStatusPB::ERROR_SERVER_TOO_BUSY,
+                               STATUS(ServiceUnavailable, msg), RetryAfter(pressure));
+    return false;
+  }
+
+  // Reject a growing share of writes while compactions fall behind, so that clients slow down
+  // before RocksDB stalls all writes to the tablet.
+  auto pressure = tablet->WriteThrottlePressure();
+  if (pressure > 0 && RandomActWithProbability(pressure)) {
+    tablet->metrics()->write_throttle_rejections->Increment();
+    auto msg = Format("Too many SST files, throttling writes (pressure $0)", pressure);
+    YB_LOG_EVERY_N_SECS(INFO, 1) << "Rejecting Write request: " << msg << THROTTLE_MSG;
+    context->RespondRpcFailure(rpc::ErrorStatusPB::ERROR_SERVER_TOO_BUSY,
+                               STATUS(ServiceUnavailable, msg), RetryAfter(pressure));
     return false;
   }
 
@@ -258,6 +314,21 @@ class WriteOperationCompletionCallback : public OperationCompletionCallback {
       : context_(std::move(context)), response_(response), state_(state), clock_(clock),
         include_trace_(trace) {}
 
+  void StageReached(tablet::OperationStage stage) override {
+    switch (stage) {
+      case tablet::OperationStage::kPrepared:
+        context_->RecordCallStage(rpc::InboundCallStage::kPrepared);
+        return;
+      case tablet::OperationStage::kReplicated:
+        context_->RecordCallStage(rpc::InboundCallStage::kReplicated);
+        return;
+      case tablet::OperationStage::kApplied:
+        context_->RecordCallStage(rpc::InboundCallStage::kApplied);
+        return;
+    }
+    FATAL_INVALID_ENUM_VALUE(tablet::OperationStage, stage);
+  }
+
   void OperationCompleted() override {
     // When we don't need to return any data, we could return success on duplicate request.
     if (status_.IsAlreadyPresent() &&
@@ -283,7 +354,7 @@ class WriteOperationCompletionCallback : public OperationCompletionCallback {
       rowblock->Serialize(ql_write_req.client(), &rows_data);
       int rows_data_sidecar_idx = 0;
       RETURN_UNKNOWN_ERROR_IF_NOT_OK(
-          context_->AddRpcSidecar(RefCntBuffer(rows_data), &rows_data_sidecar_idx),
+          context_->AddRpcSidecar(RefCntBuffer(std::move(rows_data)), &rows_data_sidecar_idx),
           response_, context_.get());
       ql_write_resp->set_rows_data_sidecar(rows_data_sidecar_idx);
     }
@@ -299,7 +370,7 @@ class WriteOperationCompletionCallback : public OperationCompletionCallback {
             pggate::PgDocData::WriteTuples(resultset, &rows_data), response_, context_.get());
         int rows_data_sidecar_idx = 0;
         RETURN_UNKNOWN_ERROR_IF_NOT_OK(
-            context_->AddRpcSidecar(RefCntBuffer(rows_data), &rows_data_sidecar_idx),
+            context_->AddRpcSidecar(RefCntBuffer(std::move(rows_data)), &rows_data_sidecar_idx),
             response_, context_.get());
         pgsql_write_resp->set_rows_data_sidecar(rows_data_sidecar_idx);
       }
@@ -328,7 +399,7 @@ class WriteOperationCompletionCallback : public OperationCompletionCallback {
 // Checksums the scan result.
 class ScanResultChecksummer {
  public:
-  ScanResultChecksummer() {}
+  explicit ScanResultChecksummer(uint64_t checksum = 0) : agg_checksum_(checksum) {}
 
   void HandleRow(const Schema& schema, const QLTableRow& row) {
     QLValue value;
@@ -357,13 +428,14 @@ class ScanResultChecksummer {
 
  private:
   crc::Crc* const crc_ = crc::GetCrc32cInstance();
-  uint64_t agg_checksum_ = 0;
+  uint64_t agg_checksum_;
   std::string buffer_;
 };
 
 TabletServiceImpl::TabletServiceImpl(TabletServerIf* server)
     : TabletServerServiceIf(server->MetricEnt()),
-      server_(server) {
+      server_(server),
+      queries_mem_tracker_(docdb::QueryMemTracker::GetQueriesTracker(server->mem_tracker())) {
 }
 
 TabletServiceAdminImpl::TabletServiceAdminImpl(TabletServer* server)
@@ -465,7 +537,7 @@ void TabletServiceImpl::UpdateTransaction(const UpdateTransactionRequestPB* req,
         server_->tablet_peer_lookup(), req->tablet_id(), resp, &context));
     tablet.leader_term = OpId::kUnknownTerm;
   }
-  if (!tablet || !CheckMemoryPressure(tablet.peer->tablet(), resp, &context)) {
+  if (!tablet || !CheckWriteThrottling(tablet.peer->tablet(), &context)) {
     return;
   }
 
@@ -500,6 +572,10 @@ void TabletServiceImpl::GetTransactionStatus(const GetTransactionStatusRequestPB
 
   status = tablet_peer->tablet()->transaction_coordinator()->GetStatus(
       req->transaction_id(), resp);
+  if (!status.ok()) {
+    resp->clear_status();
+    resp->clear_status_hybrid_time();
+  }
   resp->set_propagated_hybrid_time(server_->Clock()->Now().ToUint64());
   if (status.ok()) {
     context.RespondSuccess();
@@ -567,58 +643,159 @@ void TabletServiceImpl::Truncate(const TruncateRequestPB* req,
       std::make_unique<tablet::TruncateOperation>(std::move(tx_state)), tablet.leader_term);
 }
 
+void TabletServiceImpl::IngestSstFile(const IngestSstFileRequestPB* req,
+                                      IngestSstFileResponsePB* resp,
+                                      rpc::RpcContext context) {
+  TRACE("IngestSstFile");
+
+  UpdateClock(*req, server_->Clock());
+
+  auto tablet = LookupLeaderTabletOrRespond(
+      server_->tablet_peer_lookup(), req->tablet_id(), resp, &context);
+  if (!tablet) {
+    return;
+  }
+
+  // Applied intents are written to the regular DB with the OpId of their transaction's APPLYING
+  // record, which could be below the flushed frontier set by the ingest.
+  if (tablet.peer->tablet()->transaction_participant()) {
+    SetupErrorAndRespond(
+        resp->mutable_error(),
+        STATUS(NotSupported, "SST file ingestion is not supported for transactional tables"),
+        TabletServerErrorPB::UNKNOWN_ERROR, &context);
+    return;
+  }
+
+  // Catch the common mistake on the leader, before the operation is replicated.
+  const auto file_path = tablet.peer->tablet()->IngestSstFilePath(req->file_path());
+  if (!Env::Default()->FileExists(file_path)) {
+    SetupErrorAndRespond(
+        resp->mutable_error(),
+        STATUS_FORMAT(InvalidArgument, "SST file does not exist: $0", file_path),
+        TabletServerErrorPB::UNKNOWN_ERROR, &context);
+    return;
+  }
+
+  auto tx_state = std::make_unique<IngestSstOperationState>(tablet.peer->tablet(), req);
+
+  tx_state->set_completion_callback(
+      MakeRpcOperationCompletionCallback(std::move(context), resp, server_->Clock()));
+
+  // The RPC will be responded to asynchronously, once the file is added on the leader.
+  tablet.peer->Submit(
+      std::make_unique<tablet::IngestSstOperation>(std::move(tx_state)), tablet.leader_term);
+}
+
+void TabletServiceImpl::BackfillIndex(const BackfillIndexRequestPB* req,
+                                      BackfillIndexResponsePB* resp,
+                                      rpc::RpcContext context) {
+  TRACE("BackfillIndex");
+
+  UpdateClock(*req, server_->Clock());
+
+  auto tablet = LookupLeaderTabletOrRespond(
+      server_->tablet_peer_lookup(), req->tablet_id(), resp, &context);
+  if (!tablet) {
+    return;
+  }
+
+  std::vector<TableId> index_ids(req->index_ids().begin(), req->index_ids().end());
+  size_t num_rows = 0;
+  // Leaves some time to respond before the client gives up.
+  const auto deadline = context.GetClientDeadline() - 100ms;
+  auto next_key = tablet.peer->tablet()->BackfillIndexes(
+      index_ids, HybridTime(req->read_ht()), req->start_key(), deadline, &num_rows);
+  resp->set_num_rows(num_rows);
+  resp->set_propagated_hybrid_time(server_->Clock()->Now().ToUint64());
+  if (!next_key.ok()) {
+    SetupErrorAndRespond(
+        resp->mutable_error(), next_key.status(), TabletServerErrorPB::UNKNOWN_ERROR, &context);
+    return;
+  }
+  resp->set_next_key(*next_key);
+  context.RespondSuccess();
+}
+
 void TabletServiceAdminImpl::CreateTablet(const CreateTabletRequestPB* req,
                                           CreateTabletResponsePB* resp,
                                           rpc::RpcContext context) {
   if (!CheckUuidMatchOrRespond(server_->tablet_manager(), "CreateTablet", req, resp, &context)) {
     return;
   }
+
+  TabletServerErrorPB::Code code;
+  Status s = DoCreateTablet(*req, &code);
+  if (PREDICT_FALSE(!s.ok())) {
+    SetupErrorAndRespond(resp->mutable_error(), s, code, &context);
+    return;
+  }
+  context.RespondSuccess();
+}
+
+void TabletServiceAdminImpl::CreateTablets(const CreateTabletsRequestPB* req,
+                                           CreateTabletsResponsePB* resp,
+                                           rpc::RpcContext context) {
+  if (!CheckUuidMatchOrRespond(server_->tablet_manager(), "CreateTablets", req, resp, &context)) {
+    return;
+  }
+  TRACE_EVENT1("tserver", "CreateTablets",
+               "num_tablets", req->tablets_size());
+
+  // The tablets are opened by the open tablet pool of the tablet manager in parallel, so only
+  // their metadata is created here.
+  for (const auto& tablet_req : req->tablets()) {
+    auto* tablet_resp = resp->add_tablets();
+    TabletServerErrorPB::Code code;
+    Status s = DoCreateTablet(tablet_req, &code);
+    if (PREDICT_FALSE(!s.ok())) {
+      StatusToPB(s, tablet_resp->mutable_error()->mutable_status());
+      tablet_resp->mutable_error()->set_code(code);
+    }
+  }
+  context.RespondSuccess();
+}
+
+Status TabletServiceAdminImpl::DoCreateTablet(const CreateTabletRequestPB& req,
+                                              TabletServerErrorPB::Code* code) {
   TRACE_EVENT1("tserver", "CreateTablet",
-               "tablet_id", req->tablet_id());
+               "tablet_id", req.tablet_id());
 
   Schema schema;
-  Status s = SchemaFromPB(req->schema(), &schema);
+  Status s = SchemaFromPB(req.schema(), &schema);
   DCHECK(schema.has_column_ids());
   if (!s.ok()) {
-    SetupErrorAndRespond(resp->mutable_error(),
-                         STATUS(InvalidArgument, "Invalid Schema."),
-                         TabletServerErrorPB::INVALID_SCHEMA, &context);
-    return;
+    *code = TabletServerErrorPB::INVALID_SCHEMA;
+    return STATUS(InvalidArgument, "Invalid Schema.");
   }
 
   PartitionSchema partition_schema;
-  s = PartitionSchema::FromPB(req->partition_schema(), schema, &partition_schema);
+  s = PartitionSchema::FromPB(req.partition_schema(), schema, &partition_schema);
   if (!s.ok()) {
-    SetupErrorAndRespond(resp->mutable_error(),
-                         STATUS(InvalidArgument, "Invalid PartitionSchema."),
-                         TabletServerErrorPB::INVALID_SCHEMA, &context);
-    return;
+    *code = TabletServerErrorPB::INVALID_SCHEMA;
+    return STATUS(InvalidArgument, "Invalid PartitionSchema.");
   }
 
   Partition partition;
-  Partition::FromPB(req->partition(), &partition);
+  Partition::FromPB(req.partition(), &partition);
 
-  LOG(INFO) << "Processing CreateTablet for tablet " << req->tablet_id()
-            << " (table=" << req->table_name()
-            << " [id=" << req->table_id() << "]), partition="
+  LOG(INFO) << "Processing CreateTablet for tablet " << req.tablet_id()
+            << " (table=" << req.table_name()
+            << " [id=" << req.table_id() << "]), partition="
             << partition_schema.PartitionDebugString(partition, schema);
-  VLOG(1) << "Full request: " << req->DebugString();
+  VLOG(1) << "Full request: " << req.DebugString();
 
-  s = server_->tablet_manager()->CreateNewTablet(req->table_id(), req->tablet_id(), partition,
-      req->table_name(), req->table_type(), schema, partition_schema,
-      req->has_index_info() ? boost::optional<IndexInfo>(req->index_info()) : boost::none,
-      req->config(), /* tablet_peer */ nullptr);
+  s = server_->tablet_manager()->CreateNewTablet(req.table_id(), req.tablet_id(), partition,
+      req.table_name(), req.table_type(), schema, partition_schema,
+      req.has_index_info() ? boost::optional<IndexInfo>(req.index_info()) : boost::none,
+      req.config(), /* tablet_peer */ nullptr);
   if (PREDICT_FALSE(!s.ok())) {
-    TabletServerErrorPB::Code code;
     if (s.IsAlreadyPresent()) {
-      code = TabletServerErrorPB::TABLET_ALREADY_EXISTS;
+      *code = TabletServerErrorPB::TABLET_ALREADY_EXISTS;
     } else {
-      code = TabletServerErrorPB::UNKNOWN_ERROR;
+      *code = TabletServerErrorPB::UNKNOWN_ERROR;
     }
-    SetupErrorAndRespond(resp->mutable_error(), s, code, &context);
-    return;
   }
-  context.RespondSuccess();
+  return s;
 }
 
 void TabletServiceAdminImpl::DeleteTablet(const DeleteTabletRequestPB* req,
@@ -733,7 +910,7 @@ void TabletServiceImpl::Write(const WriteRequestPB* req,
 
   auto tablet = LookupLeaderTabletOrRespond(
       server_->tablet_peer_lookup(), req->tablet_id(), resp, &context);
-  if (!tablet || !CheckMemoryPressure(tablet.peer->tablet(), resp, &context)) {
+  if (!tablet || !CheckWriteThrottling(tablet.peer->tablet(), &context)) {
     return;
   }
 
@@ -935,8 +1112,64 @@ struct ReadContext {
   tablet::RequireLease require_lease = tablet::RequireLease::kFalse;
   HostPortPB* host_port_pb = nullptr;
   bool allow_retry = false;
+  docdb::QueryMemTracker* mem_tracker = nullptr;
 };
 
+namespace {
+
+// Collects the RocksDB perf context and IO stats of a sampled read, which are thread local, so it
+// covers both the regular and the intents DB as long as the read runs on the current thread.
+class ScopedReadPerfContext {
+ public:
+  explicit ScopedReadPerfContext(const ReadContext& read_context) {
+    const auto level = FLAGS_read_perf_level;
+    if (level <= rocksdb::PerfLevel::kDisable || level > rocksdb::PerfLevel::kEnableTime) {
+      return;
+    }
+    if (!read_context.req->include_trace() &&
+        !RandomWithChance(std::max(FLAGS_read_perf_sampling_rate, 1))) {
+      return;
+    }
+    previous_level_ = rocksdb::GetPerfLevel();
+    rocksdb::SetPerfLevel(static_cast<rocksdb::PerfLevel>(level));
+    rocksdb::perf_context.Reset();
+    rocksdb::iostats_context.Reset();
+    active_ = true;
+  }
+
+  ~ScopedReadPerfContext() {
+    if (active_) {
+      rocksdb::SetPerfLevel(previous_level_);
+    }
+  }
+
+  // Adds the collected counters to the trace and to the tablet metrics.
+  void Report(tablet::AbstractTablet* abstract_tablet) {
+    if (!active_) {
+      return;
+    }
+    const auto& perf = rocksdb::perf_context;
+    TRACE("RocksDB perf context: $0", perf.ToString(true /* exclude_zero_counters */));
+    TRACE("RocksDB IO stats: $0", rocksdb::iostats_context.ToString(true));
+    auto* metrics = down_cast<tablet::Tablet*>(abstract_tablet)->metrics();
+    metrics->sampled_reads->Increment();
+    metrics->sampled_read_block_cache_hits->IncrementBy(perf.block_cache_hit_count);
+    metrics->sampled_read_block_reads->IncrementBy(perf.block_read_count);
+    metrics->sampled_read_block_read_time->IncrementBy(perf.block_read_time / 1000);
+    metrics->sampled_read_block_decompress_time->IncrementBy(perf.block_decompress_time / 1000);
+    metrics->sampled_read_bloom_filtered_files->IncrementBy(perf.bloom_sst_miss_count);
+    metrics->sampled_read_memtable_seek_time->IncrementBy(perf.seek_on_memtable_time / 1000);
+    metrics->sampled_read_internal_keys_skipped->IncrementBy(
+        perf.internal_key_skipped_count + perf.internal_delete_skipped_count);
+  }
+
+ private:
+  bool active_ = false;
+  rocksdb::PerfLevel previous_level_ = rocksdb::PerfLevel::kDisable;
+};
+
+} // namespace
+
 // Used when we write intents during read, i.e. for serializable isolation.
 // We cannot proceed with read from ReadOperationCompletionCallback, to avoid holding
 // replica state lock for too long.
@@ -998,6 +1231,78 @@ class ReadOperationCompletionCallback : public OperationCompletionCallback {
   std::shared_ptr<rpc::RpcContext> context_;
 };
 
+// Continues a read that waited for safe time, on a service thread instead of the thread that
+// advanced safe time.
+class SafeTimeWaitCompletionTask : public rpc::ThreadPoolTask {
+ public:
+  SafeTimeWaitCompletionTask(
+      TabletServiceImpl* service,
+      const ReadContext& read_context,
+      std::shared_ptr<rpc::RpcContext> context,
+      HybridTime safe_time,
+      bool transactional)
+      : service_(service), read_context_(read_context), context_(std::move(context)),
+        safe_time_(safe_time), transactional_(transactional) {
+  }
+
+  virtual ~SafeTimeWaitCompletionTask() {}
+ private:
+  void Run() override {
+    if (!safe_time_.is_valid()) {
+      TRACE("Timed out waiting for read time");
+      SetupErrorAndRespond(read_context_.resp->mutable_error(), STATUS(TimedOut, ""),
+                           TabletServerErrorPB::UNKNOWN_ERROR, context_.get());
+      return;
+    }
+    read_context_.safe_ht_to_read = safe_time_;
+    LeaderTabletPeer leader_peer;
+    leader_peer.leader_term = yb::OpId::kUnknownTerm;
+    service_->ContinueRead(&read_context_, leader_peer, transactional_);
+  }
+
+  void Done(const Status& status) override {
+    if (!status.ok()) {
+      SetupErrorAndRespond(
+          read_context_.resp->mutable_error(), status, TabletServerErrorPB::UNKNOWN_ERROR,
+          context_.get());
+    }
+
+    delete this;
+  }
+
+  TabletServiceImpl* service_;
+  ReadContext read_context_;
+  std::shared_ptr<rpc::RpcContext> context_;
+  HybridTime safe_time_;
+  bool transactional_;
+};
+
+bool TabletServiceImpl::WaitForSafeTimeAsync(ReadContext* read_context, bool transactional) {
+  tablet::TabletPeerPtr tablet_peer;
+  if (!server_->tablet_peer_lookup()->GetTabletPeer(
+          read_context->req->tablet_id(), &tablet_peer).ok()) {
+    return false;
+  }
+  auto context_ptr = std::make_shared<RpcContext>(std::move(*read_context->context));
+  read_context->context = context_ptr.get();
+  auto deadline = context_ptr->GetClientDeadline();
+  TRACE("Waiting for read time asynchronously");
+  down_cast<Tablet*>(read_context->tablet.get())->mvcc_manager()->SafeTimeForFollowerAsync(
+      read_context->read_time.read, deadline,
+      [this, tablet_peer, read_context = *read_context, context_ptr, transactional](
+          HybridTime safe_time) {
+        tablet_peer->Enqueue(new SafeTimeWaitCompletionTask(
+            this, read_context, context_ptr, safe_time, transactional));
+      });
+  return true;
+}
+
+bool TabletServiceImpl::UsesCallArena(RpcMetricIndexes index) const {
+  // Read requests and responses never leave the call, while parts of write requests are moved
+  // into the replicated operation, which would copy them out of the arena.
+  return index == kMetricIndexRead;
+}
+
 void TabletServiceImpl::Read(const ReadRequestPB* req,
                              ReadResponsePB* resp,
                              rpc::RpcContext context) {
@@ -1024,7 +1329,7 @@ void TabletServiceImpl::Read(const ReadRequestPB* req,
         server_->tablet_peer_lookup(), req->tablet_id(), resp, &context);
     // Serialiable read adds intents, i.e. writes data.
     // We should check for memory pressure in this case.
-    if (!leader_peer || !CheckMemoryPressure(leader_peer.peer->tablet(), resp, &context)) {
+    if (!leader_peer || !CheckWriteThrottling(leader_peer.peer->tablet(), &context)) {
       return;
     }
     read_context.tablet = leader_peer.peer->shared_tablet();
@@ -1070,8 +1375,18 @@ void TabletServiceImpl::Read(const ReadRequestPB* req,
       read_time.global_limit = read_time.read;
     }
   } else {
-    read_context.safe_ht_to_read = read_context.tablet->SafeTime(
-        read_context.require_lease, read_time.read, context.GetClientDeadline());
+    if (!read_context.require_lease && FLAGS_follower_reads_wait_for_safe_time_async) {
+      read_context.safe_ht_to_read = read_context.tablet->SafeTime(
+          read_context.require_lease, read_time.read, CoarseTimePoint::min());
+      if (!read_context.safe_ht_to_read.is_valid() &&
+          WaitForSafeTimeAsync(&read_context, transactional)) {
+        return;
+      }
+    }
+    if (!read_context.safe_ht_to_read.is_valid()) {
+      read_context.safe_ht_to_read = read_context.tablet->SafeTime(
+          read_context.require_lease, read_time.read, context.GetClientDeadline());
+    }
     if (!read_context.safe_ht_to_read.is_valid()) { // Timed out
       TRACE("Timed out waiting for read time");
       SetupErrorAndRespond(resp->mutable_error(), STATUS(TimedOut, ""),
@@ -1080,6 +1395,19 @@ void TabletServiceImpl::Read(const ReadRequestPB* req,
     }
   }
 
+  ContinueRead(&read_context, leader_peer, transactional);
+}
+
+void TabletServiceImpl::ContinueRead(
+    ReadContext* read_context, const LeaderTabletPeer& leader_peer, bool transactional) {
+  const auto* req = read_context->req;
+  auto* resp = read_context->resp;
+  auto& context = *read_context->context;
+  ReadHybridTime& read_time = read_context->read_time;
+  const bool serializable_isolation =
+      req->has_transaction() &&
+          req->transaction().isolation() == IsolationLevel::SERIALIZABLE_ISOLATION;
+
   // For postgres requests check that the syscatalog version matches.
   if (!req->pgsql_batch().empty()) {
     for (const auto& pg_req : req->pgsql_batch()) {
@@ -1099,7 +1427,7 @@ void TabletServiceImpl::Read(const ReadRequestPB* req,
     // Serial number is used for check whether this operation was initiated before
     // transaction status request. So we should initialize it as soon as possible.
     request_scope = RequestScope(
-        down_cast<Tablet*>(read_context.tablet.get())->transaction_participant());
+        down_cast<Tablet*>(read_context->tablet.get())->transaction_participant());
     read_time.serial_no = request_scope.request_id();
   }
 
@@ -1107,7 +1435,7 @@ void TabletServiceImpl::Read(const ReadRequestPB* req,
   HostPortPB host_port_pb;
   host_port_pb.set_host(remote_address.address().to_string());
   host_port_pb.set_port(remote_address.port());
-  read_context.host_port_pb = &host_port_pb;
+  read_context->host_port_pb = &host_port_pb;
 
   if (serializable_isolation) {
     WriteRequestPB write_req;
@@ -1131,21 +1459,26 @@ void TabletServiceImpl::Read(const ReadRequestPB* req,
         docdb::OperationKind::kRead);
 
     auto context_ptr = std::make_shared<RpcContext>(std::move(context));
-    read_context.context = context_ptr.get();
+    read_context->context = context_ptr.get();
     operation_state->set_completion_callback(std::make_unique<ReadOperationCompletionCallback>(
-        this, leader_peer.peer, read_context, context_ptr));
+        this, leader_peer.peer, *read_context, context_ptr));
     leader_peer.peer->WriteAsync(
         std::move(operation_state), leader_peer.leader_term, context_ptr->GetClientDeadline());
     return;
   }
 
-  CompleteRead(&read_context);
+  CompleteRead(read_context);
 }
 
 void TabletServiceImpl::CompleteRead(ReadContext* read_context) {
+  docdb::QueryMemTracker mem_tracker(
+      queries_mem_tracker_, Format("read-$0", read_context->req->tablet_id()));
+  read_context->mem_tracker = &mem_tracker;
+  ScopedReadPerfContext perf_context(*read_context);
   for (;;) {
     read_context->resp->Clear();
     read_context->context->ResetRpcSidecars();
+    mem_tracker.Reset();
     VLOG(1) << "Read time: " << read_context->read_time
             << ", safe: " << read_context->safe_ht_to_read;
     auto result = DoRead(read_context);
@@ -1178,6 +1511,9 @@ void TabletServiceImpl::CompleteRead(ReadContext* read_context) {
       return;
     }
   }
+  // Reported in the trace, so slow reads are logged with the memory they used.
+  TRACE("Read memory peak: $0 bytes", mem_tracker.peak_consumption());
+  perf_context.Report(read_context->tablet.get());
   if (read_context->req->include_trace() && Trace::CurrentTrace() != nullptr) {
     read_context->resp->set_trace_buffer(Trace::CurrentTrace()->DumpToString(true));
   }
@@ -1185,7 +1521,9 @@ void TabletServiceImpl::CompleteRead(ReadContext* read_context) {
   // It was read as part of transaction, but read time was not specified.
   // I.e. allow_retry is true.
   // So we just picked a read time and we should tell it back to the caller.
-  if (read_context->req->has_transaction() && read_context->allow_retry) {
+  // Consistent prefix reads also get it, so the client could tell how stale the result is.
+  if ((read_context->req->has_transaction() && read_context->allow_retry) ||
+      read_context->req->consistency_level() == YBConsistencyLevel::CONSISTENT_PREFIX) {
     read_context->used_read_time.ToPB(read_context->resp->mutable_used_read_time());
   }
 
@@ -1275,6 +1613,7 @@ Result<ReadHybridTime> TabletServiceImpl::DoRead(ReadContext* read_context) {
       } BOOST_SCOPE_EXIT_END;
 
       tablet::QLReadRequestResult result;
+      result.mem_tracker = read_context->mem_tracker;
       TRACE("Start HandleQLReadRequest");
       RETURN_NOT_OK(read_context->tablet->HandleQLReadRequest(
           read_context->context->GetClientDeadline(), read_tx.read_time(), ql_read_req,
@@ -1290,9 +1629,12 @@ Result<ReadHybridTime> TabletServiceImpl::DoRead(ReadContext* read_context) {
       }
       int rows_data_sidecar_idx = 0;
       RETURN_NOT_OK(read_context->context->AddRpcSidecar(
-          RefCntBuffer(result.rows_data), &rows_data_sidecar_idx));
+          RefCntBuffer(std::move(result.rows_data)), &rows_data_sidecar_idx));
       result.response.set_rows_data_sidecar(rows_data_sidecar_idx);
       read_context->resp->add_ql_batch()->Swap(&result.response);
+      if (read_context->mem_tracker != nullptr) {
+        read_context->mem_tracker->FinishResult();
+      }
     }
     return ReadHybridTime();
   }
@@ -1301,6 +1643,7 @@ Result<ReadHybridTime> TabletServiceImpl::DoRead(ReadContext* read_context) {
     ReadRequestPB* mutable_req = const_cast<ReadRequestPB*>(read_context->req);
     for (PgsqlReadRequestPB& pgsql_read_req : *mutable_req->mutable_pgsql_batch()) {
       tablet::PgsqlReadRequestResult result;
+      result.mem_tracker = read_context->mem_tracker;
       TRACE("Start HandlePgsqlReadRequest");
       RETURN_NOT_OK(read_context->tablet->HandlePgsqlReadRequest(
           read_context->context->GetClientDeadline(), read_tx.read_time(), pgsql_read_req,
@@ -1314,9 +1657,12 @@ Result<ReadHybridTime> TabletServiceImpl::DoRead(ReadContext* read_context) {
       }
       int rows_data_sidecar_idx = 0;
       RETURN_NOT_OK(read_context->context->AddRpcSidecar(
-          RefCntBuffer(result.rows_data), &rows_data_sidecar_idx));
+          RefCntBuffer(std::move(result.rows_data)), &rows_data_sidecar_idx));
       result.response.set_rows_data_sidecar(rows_data_sidecar_idx);
       read_context->resp->add_pgsql_batch()->Swap(&result.response);
+      if (read_context->mem_tracker != nullptr) {
+        read_context->mem_tracker->FinishResult();
+      }
     }
     return ReadHybridTime();
   }
@@ -1370,6 +1716,64 @@ void ConsensusServiceImpl::UpdateConsensus(const ConsensusRequestPB* req,
   context.RespondSuccess();
 }
 
+void ConsensusServiceImpl::MultiRaftUpdateConsensus(
+    const consensus::MultiRaftConsensusRequestPB* req,
+    consensus::MultiRaftConsensusResponsePB* resp,
+    rpc::RpcContext context) {
+  DVLOG(3) << "Received Multi-Raft Consensus Update RPC with " << req->consensus_request_size()
+           << " requests";
+  const auto& local_uuid = tablet_manager_->NodeInstance().permanent_uuid();
+  const auto deadline = context.GetClientDeadline();
+  resp->mutable_consensus_response()->Reserve(req->consensus_request_size());
+  for (const auto& request : req->consensus_request()) {
+    auto* response = resp->add_consensus_response();
+    auto code = TabletServerErrorPB::UNKNOWN_ERROR;
+    // See UpdateConsensus about const_cast.
+    Status s = UpdateConsensusInBatch(
+        local_uuid, const_cast<ConsensusRequestPB*>(&request), response, deadline, &code);
+    if (PREDICT_FALSE(!s.ok())) {
+      // Errors are reported per request, so that one tablet does not fail the whole batch.
+      response->Clear();
+      StatusToPB(s, response->mutable_error()->mutable_status());
+      response->mutable_error()->set_code(code);
+    }
+  }
+  context.RespondSuccess();
+}
+
+Status ConsensusServiceImpl::UpdateConsensusInBatch(const std::string& local_uuid,
+                                                    ConsensusRequestPB* req,
+                                                    ConsensusResponsePB* resp,
+                                                    CoarseTimePoint deadline,
+                                                    TabletServerErrorPB::Code* code) {
+  if (PREDICT_FALSE(req->dest_uuid() != local_uuid)) {
+    *code = TabletServerErrorPB::WRONG_SERVER_UUID;
+    return STATUS_FORMAT(InvalidArgument,
+                         "Wrong destination UUID requested. Local UUID: $0. Requested UUID: $1",
+                         local_uuid, req->dest_uuid());
+  }
+
+  std::shared_ptr<TabletPeer> tablet_peer;
+  Status s = tablet_manager_->GetTabletPeer(req->tablet_id(), &tablet_peer);
+  if (PREDICT_FALSE(!s.ok())) {
+    *code = s.IsServiceUnavailable() ? TabletServerErrorPB::UNKNOWN_ERROR
+                                     : TabletServerErrorPB::TABLET_NOT_FOUND;
+    return s;
+  }
+  auto state = tablet_peer->state();
+  if (PREDICT_FALSE(state != tablet::RUNNING)) {
+    *code = TabletServerErrorPB::TABLET_NOT_RUNNING;
+    return STATUS(IllegalState, "Tablet not RUNNING", tablet::TabletStatePB_Name(state));
+  }
+  auto consensus = tablet_peer->shared_consensus();
+  if (!consensus) {
+    *code = TabletServerErrorPB::TABLET_NOT_RUNNING;
+    return STATUS(ServiceUnavailable, "Consensus unavailable. Tablet not running");
+  }
+
+  return consensus->Update(req, resp, deadline);
+}
+
 void ConsensusServiceImpl::RequestConsensusVote(const VoteRequestPB* req,
                                                 VoteResponsePB* resp,
                                                 rpc::RpcContext context) {
@@ -1613,7 +2017,19 @@ void TabletServiceImpl::NoOp(const NoOpRequestPB *req,
 void TabletServiceImpl::Publish(
     const PublishRequestPB* req, PublishResponsePB* resp, rpc::RpcContext context) {
   rpc::Publisher* publisher = server_->GetPublisher();
-  resp->set_num_clients_forwarded_to(publisher ? (*publisher)(req->channel(), req->message()) : 0);
+  if (req->messages().empty()) {
+    resp->set_num_clients_forwarded_to(
+        publisher ? (*publisher)(req->channel(), req->message()) : 0);
+    context.RespondSuccess();
+    return;
+  }
+  int total = 0;
+  for (const auto& message : req->messages()) {
+    const int num_clients = publisher ? (*publisher)(message.channel(), message.message()) : 0;
+    resp->add_num_clients_forwarded_to_per_message(num_clients);
+    total += num_clients;
+  }
+  resp->set_num_clients_forwarded_to(total);
   context.RespondSuccess();
 }
 
@@ -1672,21 +2088,38 @@ void TabletServiceImpl::ListTabletsForTabletServer(const ListTabletsForTabletSer
 
 namespace {
 
-Result<uint64_t> CalcChecksum(tablet::Tablet* tablet) {
+// The scan has no row limit, so it is a bulk scan that does not fill the block cache even when
+// the checksum is chunked.
+Status CalcChecksum(
+    tablet::Tablet* tablet, const ChecksumRequestPB& req, ChecksumResponsePB* resp) {
+  RETURN_NOT_OK(tablet->WakeUpIfHibernated());
   const Schema& schema = tablet->metadata()->schema();
   auto client_schema = schema.CopyWithoutColumnIds();
   auto iter = tablet->NewRowIterator(client_schema, boost::none);
   RETURN_NOT_OK(iter);
+  if (!req.start_row_key().empty()) {
+    RETURN_NOT_OK((**iter).Seek(req.start_row_key()));
+  }
 
   QLTableRow value_map;
-  ScanResultChecksummer collector;
+  ScanResultChecksummer collector(req.start_checksum());
+  const uint64_t max_rows = req.max_rows() != 0 ? req.max_rows()
+                                                : std::numeric_limits<uint64_t>::max();
+  uint64_t num_rows = 0;
 
   while ((**iter).HasNext()) {
+    if (num_rows == max_rows) {
+      resp->set_next_row_key(VERIFY_RESULT((**iter).GetRowKey()));
+      break;
+    }
     RETURN_NOT_OK((**iter).NextRow(&value_map));
     collector.HandleRow(schema, value_map);
+    ++num_rows;
   }
 
-  return collector.agg_checksum();
+  resp->set_checksum(collector.agg_checksum());
+  resp->set_num_rows(num_rows);
+  return Status::OK();
 }
 
 } // namespace
@@ -1700,15 +2133,13 @@ void TabletServiceImpl::Checksum(const ChecksumRequestPB* req,
   if (!DoGetTabletOrRespond(req, resp, &context, &abstract_tablet)) {
     return;
   }
-  auto checksum = CalcChecksum(down_cast<tablet::Tablet*>(abstract_tablet.get()));
-  if (!checksum.ok()) {
-    SetupErrorAndRespond(resp->mutable_error(), checksum.status(),
+  auto status = CalcChecksum(down_cast<tablet::Tablet*>(abstract_tablet.get()), *req, resp);
+  if (!status.ok()) {
+    SetupErrorAndRespond(resp->mutable_error(), status,
                          TabletServerErrorPB::UNKNOWN_ERROR, &context);
     return;
   }
 
-  resp->set_checksum(*checksum);
-
   context.RespondSuccess();
 }
 
@@ -1763,6 +2194,17 @@ void TabletServiceImpl::IsTabletServerReady(const IsTabletServerReadyRequestPB*
 void TabletServiceImpl::Shutdown() {
 }
 
+rpc::RpcPriorityClass TabletServiceImpl::PriorityClass(const std::string& method_name) const {
+  if (method_name == "Read") {
+    return rpc::RpcPriorityClass::kPointRead;
+  }
+  if (method_name == "Checksum" || method_name == "ImportData" ||
+      method_name == "IngestSstFile" || method_name == "Truncate") {
+    return rpc::RpcPriorityClass::kBulk;
+  }
+  return rpc::RpcPriorityClass::kWrite;
+}
+
 scoped_refptr<Histogram> TabletServer::GetMetricsHistogram(
     TabletServerServiceIf::RpcMetricIndexes metric) {
   // Returns the metric Histogram by holding a lock to make sure tablet_server_service_ remains
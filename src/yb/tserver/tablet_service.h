@@ -58,6 +58,7 @@ class ReadCompletionTask;
 class TabletPeerLookupIf;
 class TabletServer;
 
+struct LeaderTabletPeer;
 struct ReadContext;
 
 class TabletServiceImpl : public TabletServerServiceIf {
@@ -70,6 +71,8 @@ class TabletServiceImpl : public TabletServerServiceIf {
 
   void Read(const ReadRequestPB* req, ReadResponsePB* resp, rpc::RpcContext context) override;
 
+  bool UsesCallArena(RpcMetricIndexes index) const override;
+
   void NoOp(const NoOpRequestPB* req, NoOpResponsePB* resp, rpc::RpcContext context) override;
 
   void Publish(
@@ -116,6 +119,14 @@ class TabletServiceImpl : public TabletServerServiceIf {
                 TruncateResponsePB* resp,
                 rpc::RpcContext context) override;
 
+  void IngestSstFile(const IngestSstFileRequestPB* req,
+                     IngestSstFileResponsePB* resp,
+                     rpc::RpcContext context) override;
+
+  void BackfillIndex(const BackfillIndexRequestPB* req,
+                     BackfillIndexResponsePB* resp,
+                     rpc::RpcContext context) override;
+
   void GetTabletStatus(const GetTabletStatusRequestPB* req,
                        GetTabletStatusResponsePB* resp,
                        rpc::RpcContext context) override;
@@ -126,8 +137,11 @@ class TabletServiceImpl : public TabletServerServiceIf {
 
   void Shutdown() override;
 
+  rpc::RpcPriorityClass PriorityClass(const std::string& method_name) const override;
+
  private:
   friend class ReadCompletionTask;
+  friend class SafeTimeWaitCompletionTask;
 
   // Check if the tablet peer is the leader and is in ready state for servicing IOs.
   CHECKED_STATUS CheckPeerIsLeaderAndReady(const tablet::TabletPeer& tablet_peer);
@@ -146,9 +160,9 @@ class TabletServiceImpl : public TabletServerServiceIf {
       rpc::RpcContext* context,
       std::shared_ptr<tablet::AbstractTablet>* tablet);
 
-  template<class Resp>
-  bool CheckMemoryPressure(
-      tablet::Tablet* tablet, Resp* resp, rpc::RpcContext* context);
+  // Rejects the write with a retry-after hint when the tablet is overloaded, either by memory
+  // pressure or by compactions falling behind. Returns false when the call was responded to.
+  bool CheckWriteThrottling(tablet::Tablet* tablet, rpc::RpcContext* context);
 
   // Read implementation. If restart is required returns restart time, in case of success
   // returns invalid ReadHybridTime. Otherwise returns error status.
@@ -157,7 +171,18 @@ class TabletServiceImpl : public TabletServerServiceIf {
   // Sends response, etc.
   void CompleteRead(ReadContext* read_context);
 
+  // Continues read once safe time reached the read time: checks the catalog version, writes read
+  // intents of a serializable read, and completes the read.
+  void ContinueRead(
+      ReadContext* read_context, const LeaderTabletPeer& leader_peer, bool transactional);
+
+  // Parks a follower read until safe time reaches its read time, without holding the thread.
+  // Returns false if the read should wait synchronously instead.
+  bool WaitForSafeTimeAsync(ReadContext* read_context, bool transactional);
+
   TabletServerIf *const server_;
+  // Parent of the trackers of read requests.
+  const MemTrackerPtr queries_mem_tracker_;
 };
 
 class TabletServiceAdminImpl : public TabletServerAdminServiceIf {
@@ -169,6 +194,10 @@ class TabletServiceAdminImpl : public TabletServerAdminServiceIf {
                     CreateTabletResponsePB* resp,
                     rpc::RpcContext context) override;
 
+  void CreateTablets(const CreateTabletsRequestPB* req,
+                     CreateTabletsResponsePB* resp,
+                     rpc::RpcContext context) override;
+
   void DeleteTablet(const DeleteTabletRequestPB* req,
                     DeleteTabletResponsePB* resp,
                     rpc::RpcContext context) override;
@@ -186,6 +215,9 @@ class TabletServiceAdminImpl : public TabletServerAdminServiceIf {
                     rpc::RpcContext context) override;
 
  private:
+  // Creates the tablet of the request, sets code to the error code on failure.
+  CHECKED_STATUS DoCreateTablet(const CreateTabletRequestPB& req, TabletServerErrorPB::Code* code);
+
   TabletServer* server_;
 };
 
@@ -200,6 +232,10 @@ class ConsensusServiceImpl : public consensus::ConsensusServiceIf {
                                consensus::ConsensusResponsePB *resp,
                                rpc::RpcContext context) override;
 
+  virtual void MultiRaftUpdateConsensus(const consensus::MultiRaftConsensusRequestPB *req,
+                                        consensus::MultiRaftConsensusResponsePB *resp,
+                                        rpc::RpcContext context) override;
+
   virtual void RequestConsensusVote(const consensus::VoteRequestPB* req,
                                     consensus::VoteResponsePB* resp,
                                     rpc::RpcContext context) override;
@@ -236,7 +272,19 @@ class ConsensusServiceImpl : public consensus::ConsensusServiceIf {
                                     consensus::StartRemoteBootstrapResponsePB* resp,
                                     rpc::RpcContext context) override;
 
+  rpc::RpcPriorityClass PriorityClass(const std::string& method_name) const override {
+    return rpc::RpcPriorityClass::kConsensus;
+  }
+
  private:
+  // Applies a single request of a MultiRaftUpdateConsensus batch. On failure, sets code to the
+  // error code to report for this request.
+  CHECKED_STATUS UpdateConsensusInBatch(const std::string& local_uuid,
+                                        consensus::ConsensusRequestPB* req,
+                                        consensus::ConsensusResponsePB* resp,
+                                        CoarseTimePoint deadline,
+                                        TabletServerErrorPB::Code* code);
+
   TabletPeerLookupIf* tablet_manager_;
 };
 
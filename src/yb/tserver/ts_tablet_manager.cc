@@ -63,6 +63,7 @@
 #include "yb/master/sys_catalog.h"
 
 #include "yb/rocksdb/memory_monitor.h"
+#include "yb/rocksdb/rate_limiter.h"
 
 #include "yb/rpc/messenger.h"
 
@@ -75,6 +76,7 @@
 #include "yb/tablet/tablet_options.h"
 
 #include "yb/tserver/heartbeater.h"
+#include "yb/tserver/memory_budget_balancer.h"
 #include "yb/tserver/remote_bootstrap_client.h"
 #include "yb/tserver/tablet_server.h"
 
@@ -86,6 +88,7 @@
 #include "yb/util/flag_tags.h"
 #include "yb/util/mem_tracker.h"
 #include "yb/util/metrics.h"
+#include "yb/util/path_util.h"
 #include "yb/util/pb_util.h"
 #include "yb/util/stopwatch.h"
 #include "yb/util/trace.h"
@@ -112,6 +115,11 @@ DEFINE_int32(db_block_cache_num_shard_bits, 4,
              "Number of bits to use for sharding the block cache (defaults to 4 bits)");
 TAG_FLAG(db_block_cache_num_shard_bits, advanced);
 
+DEFINE_string(db_block_cache_type, "lru",
+              "Eviction policy of the block cache: lru (scan resistant LRU with single and multi "
+              "touch pools) or clock (CLOCK approximation of LRU, cheaper under concurrent reads).");
+TAG_FLAG(db_block_cache_type, advanced);
+
 DEFINE_test_flag(double, fault_crash_after_blocks_deleted, 0.0,
                  "Fraction of the time when the tablet will crash immediately "
                  "after deleting the data blocks during tablet deletion.");
@@ -132,10 +140,29 @@ DEFINE_test_flag(double, fault_crash_after_rb_files_fetched, 0.0,
 DEFINE_test_flag(bool, pretend_memory_exceeded_enforce_flush, false,
                  "Always pretend memory has been exceeded to enforce background flush.");
 
+DEFINE_bool(tablet_warm_up_block_cache, false,
+            "Load top-level index and filter blocks of all SST files of a tablet to the block "
+            "cache after the tablet is opened, so that first reads after a restart don't pay for "
+            "them.");
+TAG_FLAG(tablet_warm_up_block_cache, advanced);
+
+DEFINE_int32(tablet_warm_up_max_threads, 2,
+             "Number of threads loading index and filter blocks of opened tablets when "
+             "tablet_warm_up_block_cache is set.");
+TAG_FLAG(tablet_warm_up_max_threads, advanced);
+
+DEFINE_int64(tablet_warm_up_rate_limit_bytes_per_sec, 128 * 1024 * 1024,
+             "Limit on the rate of loading index and filter blocks of opened tablets, shared by "
+             "all warm up threads. 0 means no limit.");
+TAG_FLAG(tablet_warm_up_rate_limit_bytes_per_sec, advanced);
+
+DECLARE_int32(rocksdb_max_background_flushes);
+
 namespace {
 
 constexpr int kDbCacheSizeUsePercentage = -1;
 constexpr int kDbCacheSizeCacheDisabled = -2;
+constexpr std::chrono::milliseconds kDefaultFlushBackgroundTaskInterval = std::chrono::seconds(10);
 
 } // namespace
 
@@ -153,6 +180,30 @@ DEFINE_int64(global_memstore_size_mb_max, 2048,
              "memory. However, this flag limits it in absolute size. Value of 0 "
              "means no limit on the value obtained by the percentage. Default is 2048.");
 
+DEFINE_int64(retained_wal_budget_mb, 0,
+             "Maximum total size of WAL that tablets of this server may retain because of writes "
+             "that are not flushed yet, and that would be replayed on restart. When exceeded, "
+             "the flush background task flushes the tablets that release the most WAL per byte "
+             "of memstore flushed. Checked every flush_background_task_interval_msec, or every "
+             "10 seconds if that is 0 and the budget is set at startup. 0 to disable.");
+TAG_FLAG(retained_wal_budget_mb, advanced);
+TAG_FLAG(retained_wal_budget_mb, runtime);
+
+DEFINE_int64(retained_wal_min_flush_ratio, 4,
+             "A tablet is only flushed to keep retained WAL within retained_wal_budget_mb when it "
+             "retains at least this many bytes of WAL per byte of its memstore, so that rarely "
+             "written tablets are flushed rather than producing many small files from hot ones.");
+TAG_FLAG(retained_wal_min_flush_ratio, advanced);
+TAG_FLAG(retained_wal_min_flush_ratio, runtime);
+
+DEFINE_int32(tablet_hibernation_idle_sec, 0,
+             "Follower tablets that had no reads, writes or Raft operations for this many seconds "
+             "close their RocksDBs to release memory and file handles, and reopen them on the "
+             "next access. Checked by the flush background task like retained_wal_budget_mb. "
+             "0 to disable.");
+TAG_FLAG(tablet_hibernation_idle_sec, advanced);
+TAG_FLAG(tablet_hibernation_idle_sec, runtime);
+
 DEFINE_int64(db_block_cache_size_bytes, kDbCacheSizeUsePercentage,
              "Size of cross-tablet shared RocksDB block cache (in bytes). "
              "This defaults to -1 for system auto-generated default, which would use "
@@ -172,6 +223,30 @@ DEFINE_int32(read_pool_max_queue_size, 128,
              "is used to run multiple read operations, that are part of the same tablet rpc, "
              "in parallel.");
 
+DEFINE_int64(tablet_placement_min_free_space_mb, 1024,
+             "New tablets, including remote bootstrap targets, are placed on data and WAL "
+             "directories with less free space than this only when all the directories have "
+             "less.");
+TAG_FLAG(tablet_placement_min_free_space_mb, advanced);
+TAG_FLAG(tablet_placement_min_free_space_mb, runtime);
+
+DEFINE_int32(memory_budget_rebalance_step_percentage, 0,
+             "Every tick of the flush background task, up to this percentage of the combined "
+             "block cache and global memstore budget is moved from one of them to the other: "
+             "towards the memstores when they had to be flushed because of memory pressure, "
+             "towards the block cache when it evicted blocks that were read again while the "
+             "memstores use less than half of their budget. Their sum stays at the size they "
+             "were given at startup. The background task ticks every 10 seconds if "
+             "flush_background_task_interval_msec is 0 and this is set at startup. 0 to disable.");
+TAG_FLAG(memory_budget_rebalance_step_percentage, advanced);
+TAG_FLAG(memory_budget_rebalance_step_percentage, runtime);
+
+DEFINE_int32(memory_budget_min_percentage, 50,
+             "Rebalancing with memory_budget_rebalance_step_percentage never shrinks the block "
+             "cache or the global memstore budget below this percentage of their size at startup.");
+TAG_FLAG(memory_budget_min_percentage, advanced);
+TAG_FLAG(memory_budget_min_percentage, runtime);
+
 DEFINE_test_flag(int32, sleep_after_tombstoning_tablet_secs, 0,
                  "Whether we sleep in LogAndTombstone after calling DeleteTabletData.");
 
@@ -226,6 +301,28 @@ METRIC_DEFINE_histogram(server, op_read_run_time, "Operation Read op Run Time",
                             "that operations consist of very large batches.",
                         10000000, 2);
 
+METRIC_DEFINE_gauge_uint32(server, tablets_resident, "Resident Tablets",
+                           MetricUnit::kUnits,
+                           "Number of running tablets with open RocksDBs.");
+
+METRIC_DEFINE_gauge_uint32(server, tablets_hibernated, "Hibernated Tablets",
+                           MetricUnit::kUnits,
+                           "Number of running tablets whose RocksDBs are closed because they "
+                           "were idle, see tablet_hibernation_idle_sec.");
+
+METRIC_DEFINE_gauge_uint64(server, block_cache_budget, "Block Cache Budget",
+                           MetricUnit::kBytes,
+                           "Current capacity of the block cache, see "
+                           "memory_budget_rebalance_step_percentage.");
+
+METRIC_DEFINE_gauge_uint64(server, memstore_budget, "Global Memstore Budget",
+                           MetricUnit::kBytes,
+                           "Current total memstore size at which tablets are flushed, see "
+                           "memory_budget_rebalance_step_percentage.");
+
+METRIC_DECLARE_counter(block_cache_misses);
+METRIC_DECLARE_counter(block_cache_evictions);
+
 using consensus::ConsensusMetadata;
 using consensus::ConsensusStatePB;
 using consensus::OpId;
@@ -255,37 +352,210 @@ using tablet::TabletStatusPB;
 
 // Only called from the background task to ensure it's synchronized
 void TSTabletManager::MaybeFlushTablet() {
+  // Flushes of different tablets run in parallel on the shared RocksDB flush pool, so schedule as
+  // many of them as the pool can run at once instead of waiting for them one by one.
+  const size_t max_tablets_per_round = std::max(FLAGS_rocksdb_max_background_flushes, 1);
   int iteration = 0;
   while (memory_monitor()->Exceeded() ||
          (iteration++ == 0 && FLAGS_pretend_memory_exceeded_enforce_flush)) {
-    TabletPeerPtr tablet_to_flush = TabletToFlush();
+    auto tablets_to_flush = TabletsToFlush(max_tablets_per_round);
+    if (tablets_to_flush.empty()) {
+      // Every memstore is empty or already being flushed, memory will be released once those
+      // flushes complete.
+      break;
+    }
     // TODO(bojanserafimov): If tablet_to_flush flushes now because of other reasons,
     // we will schedule a second flush, which will unnecessarily stall writes for a short time. This
     // will not happen often, but should be fixed.
-    if (tablet_to_flush) {
+    for (const auto& tablet_to_flush : tablets_to_flush) {
       WARN_NOT_OK(tablet_to_flush->tablet()->Flush(tablet::FlushMode::kAsync),
           Substitute("Flush failed on $0", tablet_to_flush->tablet_id()));
     }
+    memory_pressure_flushes_ += tablets_to_flush.size();
   }
+
+  FlushTabletsRetainingWal(max_tablets_per_round);
+  HibernateIdleTablets();
+  RebalanceMemoryBudgets();
 }
 
-// Return the tablet with the oldest write in memstore, or nullptr if all
-// tablet memstores are empty or about to flush.
-TabletPeerPtr TSTabletManager::TabletToFlush() {
-  boost::shared_lock<RWMutex> lock(lock_); // For using the tablet map
-  HybridTime oldest_write_in_memstores = HybridTime::kMax;
-  TabletPeerPtr tablet_to_flush;
-  for (const TabletMap::value_type& entry : tablet_map_) {
-    const auto tablet = entry.second->shared_tablet();
-    if (tablet) {
-      const HybridTime oldest_write_in_memstore = tablet->flush_stats()->oldest_write_in_memstore();
-      if (oldest_write_in_memstore < oldest_write_in_memstores) {
-        oldest_write_in_memstores = oldest_write_in_memstore;
-        tablet_to_flush = entry.second;
+void TSTabletManager::RebalanceMemoryBudgets() {
+  const auto step_percentage = FLAGS_memory_budget_rebalance_step_percentage;
+  if (!memory_budget_balancer_ || step_percentage <= 0) {
+    return;
+  }
+  // The background task is also woken up on every memstore limit hit, rebalance at the pace of its
+  // regular ticks.
+  const auto now = MonoTime::Now();
+  if (last_memory_rebalance_.Initialized() &&
+      now - last_memory_rebalance_ < MonoDelta(kDefaultFlushBackgroundTaskInterval)) {
+    return;
+  }
+  last_memory_rebalance_ = now;
+  MemoryBudgetSignals signals;
+  signals.block_cache_misses = block_cache_misses_->value();
+  signals.block_cache_evictions = block_cache_evictions_->value();
+  signals.block_cache_usage = tablet_options_.block_cache->GetUsage();
+  signals.memstore_pressure_flushes = memory_pressure_flushes_;
+  signals.memstore_usage = memory_monitor()->memory_usage();
+
+  const auto old_budgets = memory_budget_balancer_->budgets();
+  const auto budgets = memory_budget_balancer_->Rebalance(
+      signals, step_percentage, std::max(FLAGS_memory_budget_min_percentage, 0));
+  if (budgets.block_cache == old_budgets.block_cache) {
+    return;
+  }
+  LOG(INFO) << "Rebalanced memory budgets, block cache: " << old_budgets.block_cache << " -> "
+            << budgets.block_cache << ", memstores: " << old_budgets.memstore << " -> "
+            << budgets.memstore;
+  // Shrink first, so the sum of the budgets never exceeds the initial one.
+  if (budgets.block_cache < old_budgets.block_cache) {
+    tablet_options_.block_cache->SetCapacity(budgets.block_cache);
+    memory_monitor()->set_limit(budgets.memstore);
+  } else {
+    memory_monitor()->set_limit(budgets.memstore);
+    tablet_options_.block_cache->SetCapacity(budgets.block_cache);
+  }
+  block_cache_budget_->set_value(budgets.block_cache);
+  memstore_budget_->set_value(budgets.memstore);
+}
+
+void TSTabletManager::HibernateIdleTablets() {
+  const auto idle_sec = FLAGS_tablet_hibernation_idle_sec;
+  std::vector<TabletPeerPtr> peers;
+  {
+    boost::shared_lock<RWMutex> lock(lock_); // For using the tablet map
+    peers.reserve(tablet_map_.size());
+    for (const TabletMap::value_type& entry : tablet_map_) {
+      peers.push_back(entry.second);
+    }
+  }
+
+  uint32_t num_resident = 0;
+  uint32_t num_hibernated = 0;
+  for (const auto& peer : peers) {
+    const auto tablet = peer->shared_tablet();
+    if (!tablet || peer->state() != tablet::RUNNING) {
+      continue;
+    }
+    if (!tablet->hibernated() && idle_sec > 0 &&
+        peer->LeaderStatus() == consensus::LeaderStatus::NOT_LEADER) {
+      auto hibernated = tablet->Hibernate(std::chrono::seconds(idle_sec));
+      if (!hibernated.ok()) {
+        LOG(WARNING) << "Failed to hibernate " << peer->tablet_id() << ": "
+                     << hibernated.status();
       }
     }
+    if (tablet->hibernated()) {
+      ++num_hibernated;
+    } else {
+      ++num_resident;
+    }
   }
-  return tablet_to_flush;
+  tablets_resident_->set_value(num_resident);
+  tablets_hibernated_->set_value(num_hibernated);
+}
+
+// Flushes up to max_tablets tablets if the WAL retained by unflushed writes exceeds the budget, to
+// bound the amount of WAL replayed on restart. Tablets that release the most WAL per byte of
+// memstore are picked first.
+void TSTabletManager::FlushTabletsRetainingWal(size_t max_tablets) {
+  const int64_t budget = FLAGS_retained_wal_budget_mb << 20;
+  if (budget <= 0) {
+    return;
+  }
+
+  std::vector<TabletPeerPtr> peers;
+  {
+    boost::shared_lock<RWMutex> lock(lock_); // For using the tablet map
+    peers.reserve(tablet_map_.size());
+    for (const TabletMap::value_type& entry : tablet_map_) {
+      peers.push_back(entry.second);
+    }
+  }
+
+  struct Candidate {
+    double wal_per_memstore_byte;
+    int64_t retained_bytes;
+    TabletPeerPtr peer;
+  };
+  std::vector<Candidate> candidates;
+  int64_t total_retained_bytes = 0;
+  for (auto& peer : peers) {
+    const auto tablet = peer->shared_tablet();
+    int64_t retained_bytes;
+    if (!tablet || !peer->GetRetainedLogDataSize(&retained_bytes).ok()) {
+      continue;
+    }
+    total_retained_bytes += retained_bytes;
+    if (tablet->flush_stats()->oldest_write_in_memstore() == HybridTime::kMax) {
+      // Nothing to flush, the WAL will be released by the next log GC.
+      continue;
+    }
+    const int64_t memstore_bytes = std::max<int64_t>(tablet->mem_tracker()->consumption(), 1);
+    if (retained_bytes < memstore_bytes * FLAGS_retained_wal_min_flush_ratio) {
+      continue;
+    }
+    candidates.push_back(Candidate{
+        static_cast<double>(retained_bytes) / memstore_bytes, retained_bytes, std::move(peer)});
+  }
+  if (total_retained_bytes <= budget) {
+    return;
+  }
+
+  std::sort(candidates.begin(), candidates.end(), [](const auto& lhs, const auto& rhs) {
+    return lhs.wal_per_memstore_byte > rhs.wal_per_memstore_byte;
+  });
+  size_t num_flushed = 0;
+  for (const auto& candidate : candidates) {
+    if (total_retained_bytes <= budget || num_flushed == max_tablets) {
+      break;
+    }
+    VLOG(1) << "Flushing tablet " << candidate.peer->tablet_id() << " retaining "
+            << candidate.retained_bytes << " bytes of WAL, total retained: "
+            << total_retained_bytes << ", budget: " << budget;
+    WARN_NOT_OK(candidate.peer->tablet()->Flush(tablet::FlushMode::kAsync),
+        Substitute("Flush failed on $0", candidate.peer->tablet_id()));
+    total_retained_bytes -= candidate.retained_bytes;
+    ++num_flushed;
+  }
+}
+
+// Return up to max_tablets tablets ordered by the oldest write in memstore. Tablets whose memstores
+// are empty or about to flush are skipped.
+std::vector<TabletPeerPtr> TSTabletManager::TabletsToFlush(size_t max_tablets) {
+  std::vector<std::pair<HybridTime, TabletPeerPtr>> candidates;
+  {
+    boost::shared_lock<RWMutex> lock(lock_); // For using the tablet map
+    for (const TabletMap::value_type& entry : tablet_map_) {
+      const auto tablet = entry.second->shared_tablet();
+      if (tablet) {
+        const HybridTime oldest_write_in_memstore =
+            tablet->flush_stats()->oldest_write_in_memstore();
+        if (oldest_write_in_memstore != HybridTime::kMax) {
+          candidates.emplace_back(oldest_write_in_memstore, entry.second);
+        }
+      }
+    }
+  }
+
+  const auto by_oldest_write = [](const auto& lhs, const auto& rhs) {
+    return lhs.first < rhs.first;
+  };
+  if (candidates.size() > max_tablets) {
+    std::partial_sort(candidates.begin(), candidates.begin() + max_tablets, candidates.end(),
+                      by_oldest_write);
+    candidates.resize(max_tablets);
+  } else {
+    std::sort(candidates.begin(), candidates.end(), by_oldest_write);
+  }
+
+  std::vector<TabletPeerPtr> result;
+  result.reserve(candidates.size());
+  for (auto& candidate : candidates) {
+    result.push_back(std::move(candidate.second));
+  }
+  return result;
 }
 
 TSTabletManager::TSTabletManager(FsManager* fs_manager,
@@ -295,7 +565,9 @@ TSTabletManager::TSTabletManager(FsManager* fs_manager,
     server_(server),
     next_report_seq_(0),
     metric_registry_(metric_registry),
-    state_(MANAGER_INITIALIZING) {
+    state_(MANAGER_INITIALIZING),
+    tablets_resident_(METRIC_tablets_resident.Instantiate(server_->metric_entity(), 0)),
+    tablets_hibernated_(METRIC_tablets_hibernated.Instantiate(server_->metric_entity(), 0)) {
 
   ThreadPoolMetrics metrics = {
       METRIC_op_apply_queue_length.Instantiate(server_->metric_entity()),
@@ -348,8 +620,15 @@ TSTabletManager::TSTabletManager(FsManager* fs_manager,
     block_cache_size_bytes = total_ram_avail * FLAGS_db_block_cache_size_percentage / 100;
   }
   if (FLAGS_db_block_cache_size_bytes != kDbCacheSizeCacheDisabled) {
-    tablet_options_.block_cache = rocksdb::NewLRUCache(block_cache_size_bytes,
-                                                       FLAGS_db_block_cache_num_shard_bits);
+    if (FLAGS_db_block_cache_type == "clock") {
+      tablet_options_.block_cache = rocksdb::NewClockCache(block_cache_size_bytes,
+                                                           FLAGS_db_block_cache_num_shard_bits);
+    } else {
+      LOG_IF(DFATAL, FLAGS_db_block_cache_type != "lru")
+          << "Unknown block cache type: " << FLAGS_db_block_cache_type << ", using lru";
+      tablet_options_.block_cache = rocksdb::NewLRUCache(block_cache_size_bytes,
+                                                         FLAGS_db_block_cache_num_shard_bits);
+    }
     tablet_options_.block_cache->SetMetrics(server_->metric_entity());
   }
 
@@ -373,17 +652,54 @@ TSTabletManager::TSTabletManager(FsManager* fs_manager,
       std::function<void()>([this](){ MaybeFlushTablet(); }),
       "tablet manager",
       "flush scheduler bgtask",
-      std::chrono::milliseconds(FLAGS_flush_background_task_interval_msec)));
+      FLAGS_flush_background_task_interval_msec == 0 &&
+          (FLAGS_retained_wal_budget_mb > 0 || FLAGS_tablet_hibernation_idle_sec > 0 ||
+           FLAGS_memory_budget_rebalance_step_percentage > 0)
+          ? kDefaultFlushBackgroundTaskInterval
+          : std::chrono::milliseconds(FLAGS_flush_background_task_interval_msec)));
     tablet_options_.memory_monitor = std::make_shared<rocksdb::MemoryMonitor>(
         memstore_size_bytes,
         std::function<void()>([this](){
                                 YB_WARN_NOT_OK(background_task_->Wake(), "Wakeup error"); }));
+
+    if (tablet_options_.block_cache) {
+      memory_budget_balancer_ = std::make_unique<MemoryBudgetBalancer>(
+          MemoryBudgets{tablet_options_.block_cache->GetCapacity(), memstore_size_bytes},
+          FLAGS_global_memstore_size_mb_max << 20);
+      block_cache_misses_ = METRIC_block_cache_misses.Instantiate(server_->metric_entity());
+      block_cache_evictions_ = METRIC_block_cache_evictions.Instantiate(server_->metric_entity());
+      block_cache_budget_ = METRIC_block_cache_budget.Instantiate(
+          server_->metric_entity(), tablet_options_.block_cache->GetCapacity());
+      memstore_budget_ = METRIC_memstore_budget.Instantiate(
+          server_->metric_entity(), memstore_size_bytes);
+    }
   }
 }
 
 TSTabletManager::~TSTabletManager() {
 }
 
+namespace {
+
+// Returns total size of files in the WAL dir of the tablet, used to estimate how long its
+// bootstrap would take.
+uint64_t WalDirSize(Env* env, const TabletMetadata& meta) {
+  auto children = env->GetChildren(meta.wal_dir(), ExcludeDots::kTrue);
+  if (!children.ok()) {
+    return 0;
+  }
+  uint64_t result = 0;
+  for (const auto& child : *children) {
+    auto size = env->GetFileSize(JoinPathSegments(meta.wal_dir(), child));
+    if (size.ok()) {
+      result += *size;
+    }
+  }
+  return result;
+}
+
+} // namespace
+
 Status TSTabletManager::Init() {
   CHECK_EQ(state(), MANAGER_INITIALIZING);
 
@@ -410,6 +726,16 @@ Status TSTabletManager::Init() {
                 .set_max_threads(max_bootstrap_threads)
                 .Build(&open_tablet_pool_));
 
+  if (FLAGS_tablet_warm_up_block_cache) {
+    RETURN_NOT_OK(ThreadPoolBuilder("tablet-warm-up")
+                  .set_max_threads(std::max(FLAGS_tablet_warm_up_max_threads, 1))
+                  .Build(&warm_up_pool_));
+    if (FLAGS_tablet_warm_up_rate_limit_bytes_per_sec > 0) {
+      warm_up_rate_limiter_.reset(
+          rocksdb::NewGenericRateLimiter(FLAGS_tablet_warm_up_rate_limit_bytes_per_sec));
+    }
+  }
+
   // Search for tablets in the metadata dir.
   vector<string> tablet_ids;
   RETURN_NOT_OK(fs_manager_->ListTabletIds(&tablet_ids));
@@ -421,10 +747,30 @@ Status TSTabletManager::Init() {
   // First, load all of the tablet metadata. We do this before we start
   // submitting the actual OpenTablet() tasks so that we don't have to compete
   // for disk resources, etc, with bootstrap processes and running tablets.
-  for (const string& tablet_id : tablet_ids) {
-    scoped_refptr<TabletMetadata> meta;
-    RETURN_NOT_OK_PREPEND(OpenTabletMeta(tablet_id, &meta),
+  // Superblocks and WAL dirs are read in parallel on the bootstrap pool, that is idle yet, since
+  // with thousands of tablets reading them one by one delays the startup for minutes.
+  std::vector<scoped_refptr<TabletMetadata>> loaded_metas(tablet_ids.size());
+  std::vector<Status> load_statuses(tablet_ids.size());
+  std::vector<uint64_t> wal_sizes(tablet_ids.size());
+  for (size_t i = 0; i != tablet_ids.size(); ++i) {
+    auto load = [this, i, &tablet_ids, &loaded_metas, &load_statuses, &wal_sizes] {
+      load_statuses[i] = OpenTabletMeta(tablet_ids[i], &loaded_metas[i]);
+      if (load_statuses[i].ok() && loaded_metas[i]->tablet_data_state() == TABLET_DATA_READY) {
+        wal_sizes[i] = WalDirSize(fs_manager_->env(), *loaded_metas[i]);
+      }
+    };
+    if (!open_tablet_pool_->SubmitFunc(load).ok()) {
+      load();
+    }
+  }
+  open_tablet_pool_->Wait();
+
+  std::vector<std::pair<uint64_t, scoped_refptr<TabletMetadata>>> metas_by_wal_size;
+  for (size_t i = 0; i != tablet_ids.size(); ++i) {
+    const string& tablet_id = tablet_ids[i];
+    RETURN_NOT_OK_PREPEND(load_statuses[i],
                           "Failed to open tablet metadata for tablet: " + tablet_id);
+    scoped_refptr<TabletMetadata> meta = std::move(loaded_metas[i]);
     if (PREDICT_FALSE(meta->tablet_data_state() != TABLET_DATA_READY)) {
       RETURN_NOT_OK(HandleNonReadyTabletOnStartup(meta));
       if (meta->tablet_data_state() == TABLET_DATA_TOMBSTONED) {
@@ -437,7 +783,16 @@ Status TSTabletManager::Init() {
     RegisterDataAndWalDir(fs_manager_, meta->table_id(), meta->tablet_id(),
                           meta->table_type(), meta->data_root_dir(),
                           meta->wal_root_dir());
-    metas.push_back(meta);
+    metas_by_wal_size.emplace_back(wal_sizes[i], std::move(meta));
+  }
+
+  // Tablets with the largest logs are opened first, so that their replay overlaps with opening
+  // of the smaller ones, instead of being left for the end of the startup.
+  std::stable_sort(metas_by_wal_size.begin(), metas_by_wal_size.end(),
+                   [](const auto& lhs, const auto& rhs) { return lhs.first > rhs.first; });
+  metas.reserve(metas_by_wal_size.size());
+  for (auto& entry : metas_by_wal_size) {
+    metas.push_back(std::move(entry.second));
   }
 
   // Now submit the "Open" task for each.
@@ -1010,6 +1365,48 @@ void TSTabletManager::OpenTablet(const scoped_refptr<TabletMetadata>& meta,
                    << Trace::CurrentTrace()->DumpToString(true);
     }
   }
+
+  if (warm_up_pool_) {
+    WarmUpBlockCacheAsync(tablet_peer);
+  }
+}
+
+void TSTabletManager::WarmUpBlockCacheAsync(const TabletPeerPtr& tablet_peer) {
+  warm_up_tablets_pending_.fetch_add(1, std::memory_order_acq_rel);
+  auto status = warm_up_pool_->SubmitFunc([this, tablet_peer] {
+    const string kLogPrefix = tserver::LogPrefix(tablet_peer->tablet_id(), fs_manager_->uuid());
+    auto tablet = tablet_peer->shared_tablet();
+    Status s;
+    if (tablet) {
+      MonoTime start(MonoTime::Now());
+      s = tablet->WarmUpBlockCache(warm_up_rate_limiter_.get());
+      if (s.ok()) {
+        VLOG(1) << kLogPrefix << "Block cache warm up took "
+                << MonoTime::Now().GetDeltaSince(start).ToMilliseconds() << "ms";
+      }
+    } else {
+      s = STATUS(IllegalState, "Tablet is not running");
+    }
+    if (s.ok()) {
+      warm_up_tablets_done_.fetch_add(1, std::memory_order_acq_rel);
+    } else {
+      LOG(WARNING) << kLogPrefix << "Block cache warm up failed: " << s;
+      warm_up_tablets_failed_.fetch_add(1, std::memory_order_acq_rel);
+    }
+    warm_up_tablets_pending_.fetch_sub(1, std::memory_order_acq_rel);
+  });
+  if (!status.ok()) {
+    // The pool is shut down.
+    warm_up_tablets_pending_.fetch_sub(1, std::memory_order_acq_rel);
+  }
+}
+
+BlockCacheWarmUpProgress TSTabletManager::block_cache_warm_up_progress() const {
+  BlockCacheWarmUpProgress result;
+  result.tablets_pending = warm_up_tablets_pending_.load(std::memory_order_acquire);
+  result.tablets_done = warm_up_tablets_done_.load(std::memory_order_acquire);
+  result.tablets_failed = warm_up_tablets_failed_.load(std::memory_order_acquire);
+  return result;
 }
 
 void TSTabletManager::StartShutdown() {
@@ -1056,6 +1453,11 @@ void TSTabletManager::StartShutdown() {
 }
 
 void TSTabletManager::CompleteShutdown() {
+  // Tablets stop warming up once their shutdown was requested, so this does not wait long.
+  if (warm_up_pool_) {
+    warm_up_pool_->Shutdown();
+  }
+
   for (const TabletPeerPtr& peer : shutting_down_peers_) {
     peer->CompleteShutdown();
   }
@@ -1433,25 +1835,12 @@ void TSTabletManager::GetAndRegisterDataAndWalDir(FsManager* fs_manager,
       table_data_assignment_map_[table_id][data_root_iter] = tablet_id_set;
     }
   }
-  // Find the data directory with the least count of tablets for this table.
-  table_data_assignment_iter = table_data_assignment_map_.find(table_id);
-  auto data_assignment_value_map = table_data_assignment_iter->second;
-  string min_dir;
-  uint64_t min_dir_count = kuint64max;
-  for (auto it = data_assignment_value_map.begin(); it != data_assignment_value_map.end(); ++it) {
-    if (min_dir_count > it->second.size()) {
-      min_dir = it->first;
-      min_dir_count = it->second.size();
-    }
-  }
+  string min_dir = LeastLoadedDirUnlocked(table_data_assignment_map_, table_id, fs_manager->env());
   *data_root_dir = min_dir;
   // Increment the count for min_dir.
   auto data_assignment_value_iter = table_data_assignment_map_[table_id].find(min_dir);
   data_assignment_value_iter->second.insert(tablet_id);
 
-  // Find the wal directory with the least count of tablets for this table.
-  min_dir = "";
-  min_dir_count = kuint64max;
   auto wal_root_dirs = fs_manager->GetWalRootDirs();
   CHECK(!wal_root_dirs.empty()) << "No wal root directories found";
   auto table_wal_assignment_iter = table_wal_assignment_map_.find(table_id);
@@ -1461,19 +1850,65 @@ void TSTabletManager::GetAndRegisterDataAndWalDir(FsManager* fs_manager,
       table_wal_assignment_map_[table_id][wal_root_iter] = tablet_id_set;
     }
   }
-  table_wal_assignment_iter = table_wal_assignment_map_.find(table_id);
-  auto wal_assignment_value_map = table_wal_assignment_iter->second;
-  for (auto it = wal_assignment_value_map.begin(); it != wal_assignment_value_map.end(); ++it) {
-    if (min_dir_count > it->second.size()) {
-      min_dir = it->first;
-      min_dir_count = it->second.size();
-    }
-  }
+  min_dir = LeastLoadedDirUnlocked(table_wal_assignment_map_, table_id, fs_manager->env());
   *wal_root_dir = min_dir;
   auto wal_assignment_value_iter = table_wal_assignment_map_[table_id].find(min_dir);
   wal_assignment_value_iter->second.insert(tablet_id);
 }
 
+string TSTabletManager::LeastLoadedDirUnlocked(
+    const TableDiskAssignmentMap& assignment_map, const string& table_id, Env* env) const {
+  struct DirLoad {
+    bool low_on_space;
+    size_t table_tablets;
+    size_t total_tablets;
+    uint64_t free_space;
+
+    bool operator<(const DirLoad& rhs) const {
+      if (low_on_space != rhs.low_on_space) {
+        return !low_on_space;
+      }
+      if (table_tablets != rhs.table_tablets) {
+        return table_tablets < rhs.table_tablets;
+      }
+      if (total_tablets != rhs.total_tablets) {
+        return total_tablets < rhs.total_tablets;
+      }
+      return free_space > rhs.free_space;
+    }
+  };
+
+  // All tablets on a disk share its I/O, so the tablets of other tables are counted as well.
+  std::unordered_map<string, size_t> total_tablets;
+  for (const auto& table_dirs : assignment_map) {
+    for (const auto& dir_tablets : table_dirs.second) {
+      total_tablets[dir_tablets.first] += dir_tablets.second.size();
+    }
+  }
+
+  const uint64_t min_free_space = std::max<int64_t>(FLAGS_tablet_placement_min_free_space_mb, 0)
+                                  * 1024 * 1024;
+  string result;
+  boost::optional<DirLoad> min_load;
+  for (const auto& dir_tablets : assignment_map.at(table_id)) {
+    const string& dir = dir_tablets.first;
+    auto free_space = env->GetFreeSpaceBytes(dir);
+    if (!free_space.ok()) {
+      LOG(WARNING) << "Failed to get free space of " << dir << ": " << free_space.status();
+    }
+    // A directory that could not be checked is not preferred, but is still used when it has the
+    // smallest number of tablets.
+    const DirLoad load = {
+        free_space.ok() && *free_space < min_free_space, dir_tablets.second.size(),
+        total_tablets[dir], free_space.ok() ? *free_space : 0 };
+    if (!min_load || load < *min_load) {
+      result = dir;
+      min_load = load;
+    }
+  }
+  return result;
+}
+
 void TSTabletManager::RegisterDataAndWalDir(FsManager* fs_manager,
                                             const string& table_id,
                                             const string& tablet_id,
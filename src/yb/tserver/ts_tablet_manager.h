@@ -32,6 +32,7 @@
 #ifndef YB_TSERVER_TS_TABLET_MANAGER_H
 #define YB_TSERVER_TS_TABLET_MANAGER_H
 
+#include <atomic>
 #include <memory>
 #include <string>
 #include <unordered_map>
@@ -58,6 +59,7 @@
 #include "yb/tserver/tserver_admin.pb.h"
 #include "yb/util/locks.h"
 #include "yb/util/metrics.h"
+#include "yb/util/monotime.h"
 #include "yb/util/rw_mutex.h"
 #include "yb/util/status.h"
 #include "yb/util/threadpool.h"
@@ -66,6 +68,7 @@
 namespace yb {
 
 class PartitionSchema;
+class Env;
 class FsManager;
 class HostPort;
 class Partition;
@@ -82,6 +85,7 @@ class TabletReportPB;
 } // namespace master
 
 namespace tserver {
+class MemoryBudgetBalancer;
 class TabletServer;
 class TSMemoryMonitorListener;
 
@@ -92,6 +96,13 @@ typedef std::unordered_map<std::string, std::string> TransitionInProgressMap;
 
 class TransitionInProgressDeleter;
 
+// Progress of loading index and filter blocks of opened tablets to the block cache.
+struct BlockCacheWarmUpProgress {
+  size_t tablets_pending = 0;
+  size_t tablets_done = 0;
+  size_t tablets_failed = 0;
+};
+
 // If 'expr' fails, log a message, tombstone the given tablet, and return the
 // error status.
 #define TOMBSTONE_NOT_OK(expr, meta, uuid, msg, ts_manager_ptr) \
@@ -293,9 +304,12 @@ class TSTabletManager : public tserver::TabletPeerLookupIf {
 
   MemoryMonitor* memory_monitor() { return tablet_options_.memory_monitor.get(); }
 
-  // Flush some tablet if the memstore memory limit is exceeded
+  // Flush some tablet if the memstore memory limit or the retained WAL budget is exceeded, and
+  // hibernate idle tablets
   void MaybeFlushTablet();
 
+  BlockCacheWarmUpProgress block_cache_warm_up_progress() const;
+
  private:
   FRIEND_TEST(TsTabletManagerTest, TestPersistBlocks);
 
@@ -385,8 +399,23 @@ class TSTabletManager : public tserver::TabletPeerLookupIf {
   // TABLET_DATA_READY state. Generally, we tombstone the replica.
   CHECKED_STATUS HandleNonReadyTabletOnStartup(const scoped_refptr<tablet::TabletMetadata>& meta);
 
-  // Return the tablet with oldest write still in its memstore
-  std::shared_ptr<tablet::TabletPeer> TabletToFlush();
+  // Schedules loading of index and filter blocks of the tablet to the block cache on
+  // warm_up_pool_.
+  void WarmUpBlockCacheAsync(const std::shared_ptr<tablet::TabletPeer>& tablet_peer);
+
+  // Return up to max_tablets tablets with the oldest writes still in their memstores, oldest first.
+  std::vector<std::shared_ptr<tablet::TabletPeer>> TabletsToFlush(size_t max_tablets);
+
+  // Flushes up to max_tablets tablets if unflushed writes retain more WAL than
+  // FLAGS_retained_wal_budget_mb.
+  void FlushTabletsRetainingWal(size_t max_tablets);
+
+  // Hibernates follower tablets idle for FLAGS_tablet_hibernation_idle_sec and updates the counts
+  // of resident and hibernated tablets.
+  void HibernateIdleTablets();
+
+  // Moves memory between the block cache and the memstores, see MemoryBudgetBalancer.
+  void RebalanceMemoryBudgets();
 
   TSTabletManagerStatePB state() const {
     boost::shared_lock<RWMutex> lock(lock_);
@@ -416,6 +445,13 @@ class TSTabletManager : public tserver::TabletPeerLookupIf {
                              std::unordered_map<std::string, std::unordered_set<std::string>>>
     TableDiskAssignmentMap;
 
+  // Returns the directory for a new tablet of the table, assignment_map should have its entry.
+  // Directories low on free space are avoided. Then the tablets of each table are spread evenly
+  // across the directories, ties are broken by the number of tablets of all tables and then by
+  // free space. Requires dir_assignment_lock_.
+  std::string LeastLoadedDirUnlocked(
+      const TableDiskAssignmentMap& assignment_map, const std::string& table_id, Env* env) const;
+
   // Lock protecting tablet_map_, dirty_tablets_, state_, and
   // transition_in_progress_.
   mutable RWMutex lock_;
@@ -462,9 +498,29 @@ class TSTabletManager : public tserver::TabletPeerLookupIf {
   // Thread pool for read ops, that are run in parallel, shared between all tablets.
   std::unique_ptr<ThreadPool> read_pool_;
 
+  // Thread pool for block cache warm up of opened tablets, created only when warm up is enabled.
+  std::unique_ptr<ThreadPool> warm_up_pool_;
+  std::unique_ptr<rocksdb::RateLimiter> warm_up_rate_limiter_;
+  std::atomic<size_t> warm_up_tablets_pending_{0};
+  std::atomic<size_t> warm_up_tablets_done_{0};
+  std::atomic<size_t> warm_up_tablets_failed_{0};
+
   // Used for scheduling flushes
   std::unique_ptr<BackgroundTask> background_task_;
 
+  scoped_refptr<AtomicGauge<uint32_t>> tablets_resident_;
+  scoped_refptr<AtomicGauge<uint32_t>> tablets_hibernated_;
+
+  // Created when both the block cache and the memory monitor are enabled, only used by the flush
+  // background task, as is the number of flushes it scheduled because of memory pressure.
+  std::unique_ptr<MemoryBudgetBalancer> memory_budget_balancer_;
+  uint64_t memory_pressure_flushes_ = 0;
+  MonoTime last_memory_rebalance_;
+  scoped_refptr<Counter> block_cache_misses_;
+  scoped_refptr<Counter> block_cache_evictions_;
+  scoped_refptr<AtomicGauge<uint64_t>> block_cache_budget_;
+  scoped_refptr<AtomicGauge<uint64_t>> memstore_budget_;
+
   // For block cache and memory monitor shared across tablets
   tablet::TabletOptions tablet_options_;
 
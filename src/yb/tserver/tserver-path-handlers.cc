@@ -42,11 +42,13 @@
 #include "yb/consensus/consensus.h"
 #include "yb/consensus/log_anchor_registry.h"
 #include "yb/consensus/quorum_util.h"
+#include "yb/docdb/doc_key.h"
 #include "yb/gutil/map-util.h"
 #include "yb/gutil/strings/human_readable.h"
 #include "yb/gutil/strings/join.h"
 #include "yb/gutil/strings/numbers.h"
 #include "yb/gutil/strings/substitute.h"
+#include "yb/gutil/stringprintf.h"
 #include "yb/server/webui_util.h"
 #include "yb/tablet/maintenance_manager.h"
 #include "yb/tablet/tablet.h"
@@ -56,8 +58,11 @@
 #include "yb/tablet/tablet_peer.h"
 #include "yb/tserver/tablet_server.h"
 #include "yb/tserver/ts_tablet_manager.h"
+#include "yb/util/timestamp.h"
 #include "yb/util/url-coding.h"
 
+DECLARE_int32(hot_key_sample_interval);
+
 namespace yb {
 namespace tserver {
 
@@ -102,6 +107,10 @@ Status TabletServerPathHandlers::Register(Webserver* server) {
       "/tablet-consensus-status", "",
       std::bind(&TabletServerPathHandlers::HandleConsensusStatusPage, this, _1, _2),
       true /* styled */, false /* is_on_nav_bar */);
+  server->RegisterPathHandler(
+      "/tablet-compactions", "",
+      std::bind(&TabletServerPathHandlers::HandleTabletCompactionsPage, this, _1, _2),
+      true /* styled */, false /* is_on_nav_bar */);
   server->RegisterPathHandler(
       "/log-anchors", "", std::bind(&TabletServerPathHandlers::HandleLogAnchorsPage, this, _1, _2),
       true /* styled */, false /* is_on_nav_bar */);
@@ -113,6 +122,9 @@ Status TabletServerPathHandlers::Register(Webserver* server) {
       "/maintenance-manager", "",
       std::bind(&TabletServerPathHandlers::HandleMaintenanceManagerPage, this, _1, _2),
       true /* styled */, false /* is_on_nav_bar */);
+  server->RegisterPathHandler(
+      "/hot-keys", "", std::bind(&TabletServerPathHandlers::HandleHotKeysPage, this, _1, _2),
+      true /* styled */, false /* is_on_nav_bar */);
 
   return Status::OK();
 }
@@ -199,6 +211,14 @@ void TabletServerPathHandlers::HandleTabletsPage(const Webserver::WebRequest& re
   std::sort(peers.begin(), peers.end(), &CompareByTabletId);
 
   *output << "<h1>Tablets</h1>\n";
+
+  const auto warm_up = tserver_->tablet_manager()->block_cache_warm_up_progress();
+  if (warm_up.tablets_pending + warm_up.tablets_done + warm_up.tablets_failed > 0) {
+    *output << Substitute(
+        "<p>Block cache warm up: $0 tablets pending, $1 done, $2 failed</p>\n",
+        warm_up.tablets_pending, warm_up.tablets_done, warm_up.tablets_failed);
+  }
+
   *output << "<table class='table table-striped'>\n";
   *output << "  <tr><th>Table name</th><th>Tablet ID</th>"
       "<th>Partition</th>"
@@ -351,6 +371,12 @@ void TabletServerPathHandlers::HandleTabletPage(const Webserver::WebRequest& req
                                   "Tablet Log Anchors")
           << "</li>" << endl;
 
+  // Flushes and compactions info page.
+  *output << "<li>" << Substitute("<a href=\"/tablet-compactions?id=$0\">$1</a>",
+                                  UrlEncodeToString(tablet_id),
+                                  "Flushes and Compactions")
+          << "</li>" << endl;
+
   // End list
   *output << "</ul>\n";
 }
@@ -383,6 +409,59 @@ void TabletServerPathHandlers::HandleLogAnchorsPage(const Webserver::WebRequest&
   *output << "<pre>" << EscapeForHtmlToString(dump) << "</pre>" << std::endl;
 }
 
+void TabletServerPathHandlers::HandleTabletCompactionsPage(const Webserver::WebRequest& req,
+                                                           std::stringstream* output) {
+  string id;
+  std::shared_ptr<TabletPeer> peer;
+  if (!LoadTablet(tserver_, req, &id, &peer, output)) return;
+  shared_ptr<Tablet> tablet = peer->shared_tablet();
+  if (!tablet) {
+    *output << "Tablet " << EscapeForHtmlToString(id) << " not running";
+    return;
+  }
+  const auto* history = tablet->compaction_history();
+
+  *output << "<h1>Flushes and Compactions for Tablet " << TabletLink(id) << "</h1>\n";
+  *output << "<table class='table table-striped'>\n";
+  *output << Substitute("<tr><td>Bytes flushed</td><td>$0</td></tr>\n",
+                        HumanReadableNumBytes::ToString(history->flushed_bytes()));
+  *output << Substitute("<tr><td>Bytes written by compactions</td><td>$0</td></tr>\n",
+                        HumanReadableNumBytes::ToString(history->compacted_bytes()));
+  *output << Substitute("<tr><td>Cumulative write amplification</td><td>$0</td></tr>\n",
+                        StringPrintf("%.2f", history->CumulativeWriteAmplification()));
+  *output << "</table>\n";
+
+  *output << "<h3>Recent operations</h3>\n";
+  *output << "<table class='table table-striped'>\n";
+  *output << "  <tr><th>Finished</th><th>Type</th><th>Status</th><th>Duration</th>"
+          << "<th>Input files</th><th>Output files</th><th>Bytes read</th><th>Bytes written</th>"
+          << "<th>Write amplification</th><th>Input records</th><th>Output records</th>"
+          << "<th>Records dropped by filter</th><th>Bytes dropped by filter</th>"
+          << "<th>Rate limiter wait</th></tr>\n";
+  for (const auto& event : history->Events()) {
+    *output << "<tr>"
+            << "<td>" << Timestamp(event.finish_time_micros).ToFormattedString() << "</td>"
+            << "<td>" << EscapeForHtmlToString(event.reason) << "</td>"
+            << "<td>" << EscapeForHtmlToString(event.status) << "</td>"
+            << "<td>" << HumanReadableElapsedTime::ToShortString(event.elapsed_micros / 1e6)
+            << "</td>"
+            << "<td>" << event.num_input_files << "</td>"
+            << "<td>" << event.num_output_files << "</td>"
+            << "<td>" << HumanReadableNumBytes::ToString(event.input_bytes) << "</td>"
+            << "<td>" << HumanReadableNumBytes::ToString(event.output_bytes) << "</td>"
+            << "<td>" << StringPrintf("%.2f", event.WriteAmplification()) << "</td>"
+            << "<td>" << event.num_input_records << "</td>"
+            << "<td>" << event.num_output_records << "</td>"
+            << "<td>" << event.num_records_dropped_by_filter << "</td>"
+            << "<td>" << HumanReadableNumBytes::ToString(event.bytes_dropped_by_filter) << "</td>"
+            << "<td>"
+            << HumanReadableElapsedTime::ToShortString(event.rate_limiter_wait_micros / 1e6)
+            << "</td>"
+            << "</tr>\n";
+  }
+  *output << "</table>\n";
+}
+
 void TabletServerPathHandlers::HandleConsensusStatusPage(const Webserver::WebRequest& req,
                                                          std::stringstream* output) {
   string id;
@@ -431,6 +510,25 @@ void TabletServerPathHandlers::HandleMaintenanceManagerPage(const Webserver::Web
   int ops_count = pb.registered_operations_size();
 
   *output << "<h1>Maintenance Manager state</h1>\n";
+  *output << Substitute("<p>Next operation: $0</p>\n",
+                        pb.has_best_op() ? EscapeForHtmlToString(pb.best_op().name()) : "none");
+  *output << Substitute("<p>Reason: $0</p>\n", EscapeForHtmlToString(pb.best_op_reason()));
+
+  *output << "<h3>Disks</h3>\n";
+  *output << "<table class='table table-striped'>\n";
+  *output << "  <tr><th>Disk</th><th>High IO operations running</th>"
+          << "<th>Available IO budget</th></tr>\n";
+  for (const auto& disk_pb : pb.disks()) {
+    *output << Substitute("<tr><td>$0</td><td>$1</td><td>$2</td></tr>\n",
+                          EscapeForHtmlToString(disk_pb.name()),
+                          disk_pb.running_ops(),
+                          disk_pb.available_io_bytes() >= 0
+                              ? HumanReadableNumBytes::ToString(disk_pb.available_io_bytes())
+                              : "-" + HumanReadableNumBytes::ToString(
+                                    -disk_pb.available_io_bytes()));
+  }
+  *output << "</table>\n";
+
   *output << "<h3>Running operations</h3>\n";
   *output << "<table class='table table-striped'>\n";
   *output << "  <tr><th>Name</th><th>Instances running</th></tr>\n";
@@ -461,17 +559,99 @@ void TabletServerPathHandlers::HandleMaintenanceManagerPage(const Webserver::Web
   *output << "<h3>Non-running operations</h3>\n";
   *output << "<table class='table table-striped'>\n";
   *output << "  <tr><th>Name</th><th>Runnable</th><th>RAM anchored</th>\n"
-          << "       <th>Logs retained</th><th>Perf</th></tr>\n";
+          << "       <th>Logs retained</th><th>Perf</th><th>IO cost</th><th>Disk</th></tr>\n";
   for (int i = 0; i < ops_count; i++) {
     MaintenanceManagerStatusPB_MaintenanceOpPB op_pb = pb.registered_operations(i);
     if (op_pb.running() == 0) {
-      *output << Substitute("<tr><td>$0</td><td>$1</td><td>$2</td><td>$3</td><td>$4</td></tr>\n",
+      *output << Substitute("<tr><td>$0</td><td>$1</td><td>$2</td><td>$3</td><td>$4</td>"
+                            "<td>$5</td><td>$6</td></tr>\n",
                             EscapeForHtmlToString(op_pb.name()),
                             op_pb.runnable(),
                             HumanReadableNumBytes::ToString(op_pb.ram_anchored_bytes()),
                             HumanReadableNumBytes::ToString(op_pb.logs_retained_bytes()),
-                            op_pb.perf_improvement());
+                            op_pb.perf_improvement(),
+                            HumanReadableNumBytes::ToString(op_pb.io_bytes()),
+                            EscapeForHtmlToString(op_pb.disk()));
+    }
+  }
+  *output << "</table>\n";
+}
+
+void TabletServerPathHandlers::HandleHotKeysPage(const Webserver::WebRequest& req,
+                                                 std::stringstream* output) {
+  constexpr size_t kMaxTablets = 20;
+  constexpr size_t kMaxKeys = 20;
+
+  struct HotTablet {
+    std::string tablet_id;
+    std::string table_name;
+    double ops_per_sec;
+  };
+  struct HotKey {
+    std::string tablet_id;
+    std::string key;
+    double ops_per_sec;
+  };
+
+  // Sampled counts are scaled by the sampling interval to estimate the actual rates.
+  const double sample_interval = std::max(FLAGS_hot_key_sample_interval, 1);
+  vector<HotTablet> tablets;
+  vector<HotKey> keys;
+  vector<std::shared_ptr<TabletPeer>> peers;
+  tserver_->tablet_manager()->GetTabletPeers(&peers);
+  for (const auto& peer : peers) {
+    auto tablet = peer->shared_tablet();
+    if (!tablet) {
+      continue;
     }
+    auto report = tablet->hot_keys().GetReport(kMaxKeys);
+    if (report.sampled_ops == 0) {
+      continue;
+    }
+    auto seconds = std::max(MonoDelta(report.window_length).ToSeconds(), 1.0);
+    tablets.push_back(HotTablet{
+        peer->tablet_id(), tablet->metadata()->table_name(),
+        report.sampled_ops * sample_interval / seconds});
+    for (const auto& entry : report.top_keys) {
+      keys.push_back(HotKey{peer->tablet_id(), entry.key, entry.count * sample_interval / seconds});
+    }
+  }
+
+  auto by_rate = [](const auto& lhs, const auto& rhs) {
+    return lhs.ops_per_sec > rhs.ops_per_sec;
+  };
+  std::sort(tablets.begin(), tablets.end(), by_rate);
+  std::sort(keys.begin(), keys.end(), by_rate);
+  tablets.resize(std::min(tablets.size(), kMaxTablets));
+  keys.resize(std::min(keys.size(), kMaxKeys));
+
+  *output << "<h1>Hot Tablets and Keys</h1>\n";
+  if (FLAGS_hot_key_sample_interval <= 0) {
+    *output << "<p>Sampling is disabled by --hot_key_sample_interval.</p>\n";
+    return;
+  }
+  *output << Substitute("<p>Estimated from one in $0 operations, over the last complete window "
+                        "of each tablet.</p>\n", FLAGS_hot_key_sample_interval);
+
+  *output << "<h3>Tablets</h3>\n";
+  *output << "<table class='table table-striped'>\n";
+  *output << "  <tr><th>Tablet id</th><th>Table name</th><th>Operations/sec</th></tr>\n";
+  for (const auto& tablet : tablets) {
+    *output << Substitute("<tr><td>$0</td><td>$1</td><td>$2</td></tr>\n",
+                          TabletLink(tablet.tablet_id),
+                          EscapeForHtmlToString(tablet.table_name),
+                          StringPrintf("%.1f", tablet.ops_per_sec));
+  }
+  *output << "</table>\n";
+
+  *output << "<h3>Keys</h3>\n";
+  *output << "<table class='table table-striped'>\n";
+  *output << "  <tr><th>Tablet id</th><th>Key</th><th>Operations/sec</th></tr>\n";
+  for (const auto& key : keys) {
+    *output << Substitute("<tr><td>$0</td><td>$1</td><td>$2</td></tr>\n",
+                          TabletLink(key.tablet_id),
+                          EscapeForHtmlToString(docdb::BestEffortDocDBKeyToStr(Slice(key.key))),
+                          StringPrintf("%.1f", key.ops_per_sec));
   }
   *output << "</table>\n";
 }
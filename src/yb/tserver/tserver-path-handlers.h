@@ -72,12 +72,15 @@ class TabletServerPathHandlers {
                            std::stringstream* output);
   void HandleLogAnchorsPage(const Webserver::WebRequest& req,
                             std::stringstream* output);
+  void HandleTabletCompactionsPage(const Webserver::WebRequest& req,
+                                   std::stringstream* output);
   void HandleConsensusStatusPage(const Webserver::WebRequest& req,
                                  std::stringstream* output);
   void HandleDashboardsPage(const Webserver::WebRequest& req,
                             std::stringstream* output);
   void HandleMaintenanceManagerPage(const Webserver::WebRequest& req,
                                     std::stringstream* output);
+  void HandleHotKeysPage(const Webserver::WebRequest& req, std::stringstream* output);
   std::string ConsensusStatePBToHtml(const consensus::ConsensusStatePB& cstate) const;
   std::string GetDashboardLine(const std::string& link,
                                const std::string& text, const std::string& desc);
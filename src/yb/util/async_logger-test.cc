@@ -0,0 +1,104 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/util/async_logger.h"
+
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "yb/util/test_macros.h"
+#include "yb/util/test_util.h"
+
+namespace yb {
+
+namespace {
+
+class TestLogger : public google::base::Logger {
+ public:
+  void Write(bool force_flush, time_t timestamp, const char* message, int message_len) override {
+    std::lock_guard<std::mutex> lock(mutex_);
+    messages_.emplace_back(message, message_len);
+  }
+
+  void Flush() override {}
+
+  uint32_t LogSize() override {
+    return 0;
+  }
+
+  std::vector<std::string> messages() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return messages_;
+  }
+
+ private:
+  std::mutex mutex_;
+  std::vector<std::string> messages_;
+};
+
+} // namespace
+
+class AsyncLoggerTest : public YBTest {
+};
+
+TEST_F(AsyncLoggerTest, WritesInOrder) {
+  TestLogger wrapped;
+  AsyncLogger logger(&wrapped, 1024 * 1024);
+  const size_t kNumMessages = 1000;
+  for (size_t i = 0; i != kNumMessages; ++i) {
+    const auto message = "I message " + std::to_string(i);
+    logger.Write(true /* force_flush */, 0, message.data(), message.size());
+  }
+  // A FATAL message flushes the queued ones before it.
+  const std::string fatal = "F fatal";
+  logger.Write(true /* force_flush */, 0, fatal.data(), fatal.size());
+
+  auto messages = wrapped.messages();
+  ASSERT_EQ(kNumMessages + 1, messages.size());
+  for (size_t i = 0; i != kNumMessages; ++i) {
+    ASSERT_EQ("I message " + std::to_string(i), messages[i]);
+  }
+  ASSERT_EQ(fatal, messages.back());
+  ASSERT_EQ(0, logger.num_dropped_messages());
+}
+
+TEST_F(AsyncLoggerTest, DropsWhenFull) {
+  TestLogger wrapped;
+  const std::string message(100, 'W');
+  const size_t kBufferedMessages = 10;
+  const size_t kNumMessages = 1000;
+  AsyncLogger logger(&wrapped, message.size() * kBufferedMessages);
+  // The background thread could drain the buffer concurrently, so only the totals are known.
+  for (size_t i = 0; i != kNumMessages; ++i) {
+    logger.Write(true /* force_flush */, 0, message.data(), message.size());
+  }
+  logger.Flush();
+
+  const auto num_dropped = logger.num_dropped_messages();
+  size_t num_written = 0;
+  size_t num_drop_reports = 0;
+  for (const auto& written : wrapped.messages()) {
+    if (written == message) {
+      ++num_written;
+    } else {
+      ASSERT_STR_CONTAINS(written, "Dropped");
+      ++num_drop_reports;
+    }
+  }
+  ASSERT_GE(num_written, kBufferedMessages);
+  ASSERT_EQ(kNumMessages, num_written + num_dropped);
+  ASSERT_EQ(num_dropped != 0, num_drop_reports != 0);
+}
+
+} // namespace yb
@@ -0,0 +1,106 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/util/async_logger.h"
+
+#include <chrono>
+#include <memory>
+
+#include "yb/gutil/strings/substitute.h"
+
+namespace yb {
+
+namespace {
+
+// How often the background thread writes the queued messages.
+constexpr auto kDrainInterval = std::chrono::milliseconds(10);
+
+} // namespace
+
+AsyncLogger::AsyncLogger(google::base::Logger* wrapped, size_t max_buffered_bytes)
+    : wrapped_(wrapped), max_buffered_bytes_(max_buffered_bytes),
+      thread_(&AsyncLogger::RunThread, this) {
+}
+
+AsyncLogger::~AsyncLogger() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+  }
+  cond_.notify_one();
+  thread_.join();
+  Drain();
+}
+
+void AsyncLogger::Write(
+    bool force_flush, time_t timestamp, const char* message, int message_len) {
+  if (message_len > 0 && message[0] == 'F') {
+    // Preserve the order of the messages, and do not lose the ones explaining the failure.
+    Flush();
+    wrapped_->Write(true /* force_flush */, timestamp, message, message_len);
+    wrapped_->Flush();
+    return;
+  }
+
+  const size_t size = message_len;
+  if (buffered_bytes_.fetch_add(size, std::memory_order_acq_rel) + size > max_buffered_bytes_) {
+    buffered_bytes_.fetch_sub(size, std::memory_order_acq_rel);
+    num_dropped_messages_.fetch_add(1, std::memory_order_relaxed);
+    num_unreported_dropped_messages_.fetch_add(1, std::memory_order_relaxed);
+    return;
+  }
+  queue_.push(new Message{timestamp, std::string(message, message_len)});
+}
+
+void AsyncLogger::Flush() {
+  Drain();
+}
+
+uint32_t AsyncLogger::LogSize() {
+  return wrapped_->LogSize();
+}
+
+void AsyncLogger::RunThread() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (!stop_) {
+    lock.unlock();
+    Drain();
+    lock.lock();
+    cond_.wait_for(lock, kDrainInterval);
+  }
+}
+
+void AsyncLogger::Drain() {
+  std::lock_guard<std::mutex> lock(drain_mutex_);
+  bool written = false;
+  Message* message = nullptr;
+  while (queue_.pop(message)) {
+    std::unique_ptr<Message> holder(message);
+    wrapped_->Write(false /* force_flush */, message->timestamp, message->text.data(),
+                    message->text.size());
+    buffered_bytes_.fetch_sub(message->text.size(), std::memory_order_acq_rel);
+    written = true;
+  }
+  const auto num_dropped = num_unreported_dropped_messages_.exchange(0, std::memory_order_relaxed);
+  if (num_dropped != 0) {
+    const auto text = strings::Substitute(
+        "Dropped $0 log messages because the async log buffer was full\n", num_dropped);
+    wrapped_->Write(false /* force_flush */, time(nullptr), text.data(), text.size());
+    written = true;
+  }
+  if (written) {
+    wrapped_->Flush();
+  }
+}
+
+} // namespace yb
@@ -0,0 +1,83 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#ifndef YB_UTIL_ASYNC_LOGGER_H
+#define YB_UTIL_ASYNC_LOGGER_H
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include <boost/lockfree/queue.hpp>
+
+#include <glog/logging.h>
+
+namespace yb {
+
+// glog logger that queues the messages of a log file and writes them from a background thread, so
+// a thread logging while the disk is slow does not wait for the write while holding the glog log
+// mutex. Messages that do not fit into the buffer are dropped and counted, the number of dropped
+// messages is written to the log once there is space again.
+//
+// FATAL messages, recognized by their glog prefix, and Flush() write everything queued so far
+// synchronously, so the log is complete when the process aborts.
+class AsyncLogger : public google::base::Logger {
+ public:
+  // wrapped is not owned and should outlive this logger.
+  AsyncLogger(google::base::Logger* wrapped, size_t max_buffered_bytes);
+  ~AsyncLogger();
+
+  void Write(bool force_flush, time_t timestamp, const char* message, int message_len) override;
+
+  void Flush() override;
+
+  uint32_t LogSize() override;
+
+  uint64_t num_dropped_messages() const {
+    return num_dropped_messages_.load(std::memory_order_relaxed);
+  }
+
+ private:
+  struct Message {
+    time_t timestamp;
+    std::string text;
+  };
+
+  void RunThread();
+
+  // Writes the queued messages to the wrapped logger.
+  void Drain();
+
+  google::base::Logger* const wrapped_;
+  const size_t max_buffered_bytes_;
+
+  boost::lockfree::queue<Message*> queue_{1024};
+  std::atomic<size_t> buffered_bytes_{0};
+  std::atomic<uint64_t> num_dropped_messages_{0};
+  // Dropped messages that were not reported to the log yet.
+  std::atomic<uint64_t> num_unreported_dropped_messages_{0};
+
+  // Serializes writes to the wrapped logger from the background thread and from Flush().
+  std::mutex drain_mutex_;
+
+  std::mutex mutex_;
+  std::condition_variable cond_;
+  bool stop_ = false;
+  std::thread thread_;
+};
+
+} // namespace yb
+
+#endif // YB_UTIL_ASYNC_LOGGER_H
@@ -83,7 +83,9 @@ class BackgroundTask {
 
       // Wait
       if (interval_ != std::chrono::milliseconds::zero()) {
-        cond_.wait_for(lock, interval_);
+        if (cond_.wait_for(lock, interval_) == std::cv_status::timeout && !closing_) {
+          return true;
+        }
       } else {
         cond_.wait(lock);
       }
@@ -71,6 +71,10 @@ METRIC_DEFINE_gauge_uint64(server, block_cache_multi_touch_usage,
                            "Multi Cache Block Cache Memory Usage",
                            yb::MetricUnit::kBytes,
                            "Memory consumed by the multi cache block cache");
+METRIC_DEFINE_gauge_uint64(server, block_cache_high_pri_usage,
+                           "High Priority Block Cache Memory Usage",
+                           yb::MetricUnit::kBytes,
+                           "Memory consumed by the high priority pool of the block cache");
 namespace yb {
 
 #define MINIT(member, x) member(METRIC_##x.Instantiate(entity))
@@ -85,7 +89,8 @@ CacheMetrics::CacheMetrics(const scoped_refptr<MetricEntity>& entity)
     MINIT(cache_misses_caching, block_cache_misses_caching),
     GINIT(cache_usage, block_cache_usage),
     GINIT(single_touch_cache_usage, block_cache_single_touch_usage),
-    GINIT(multi_touch_cache_usage, block_cache_multi_touch_usage) {
+    GINIT(multi_touch_cache_usage, block_cache_multi_touch_usage),
+    GINIT(high_pri_cache_usage, block_cache_high_pri_usage) {
 }
 #undef MINIT
 #undef GINIT
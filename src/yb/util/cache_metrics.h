@@ -58,6 +58,7 @@ struct CacheMetrics {
   scoped_refptr<AtomicGauge<uint64_t> > cache_usage;
   scoped_refptr<AtomicGauge<uint64_t> > single_touch_cache_usage;
   scoped_refptr<AtomicGauge<uint64_t> > multi_touch_cache_usage;
+  scoped_refptr<AtomicGauge<uint64_t> > high_pri_cache_usage;
 };
 
 } // namespace yb
@@ -164,6 +164,15 @@ class StackTrace {
 
   uint64_t HashCode() const;
 
+  int num_frames() const {
+    return num_frames_;
+  }
+
+  // Returns the i-th frame, the innermost one is 0.
+  void* frame(int i) const {
+    return frames_[i];
+  }
+
   explicit operator bool() const {
     return num_frames_ != 0;
   }
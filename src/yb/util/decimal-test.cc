@@ -13,6 +13,8 @@
 
 #include "yb/util/decimal.h"
 
+#include <random>
+
 #include "yb/util/test_macros.h"
 #include "yb/util/test_util.h"
 
@@ -262,6 +264,36 @@ TEST_F(DecimalTest, TestBigDecimalEncoding) {
   EXPECT_TRUE(is_out_of_range);
 }
 
+TEST_F(DecimalTest, TestAddition) {
+  EXPECT_EQ(Decimal("3.75"), Decimal("1.25") + Decimal("2.5"));
+  EXPECT_EQ(Decimal("-1.05"), Decimal("-1.3") + Decimal("0.25"));
+  EXPECT_EQ("0", (Decimal("-1.25") + Decimal("1.25")).ToString());
+  EXPECT_EQ(Decimal("120.5"), Decimal("0") + Decimal("120.5"));
+  const std::string kNines(Decimal::kMaxFixedDigits, '9');
+  EXPECT_EQ(Decimal("1e38"), Decimal(kNines) + Decimal("1"));
+  // The following sums don't fit 128 bit mantissas and are added digit by digit.
+  EXPECT_EQ(Decimal("1" + std::string(Decimal::kMaxFixedDigits - 1, '9') + "8"),
+            Decimal(kNines) + Decimal(kNines));
+  EXPECT_EQ(Decimal("1000000000000000000000000000000.000000000000000000000000000001"),
+            Decimal("1e30") + Decimal("1e-30"));
+  EXPECT_EQ(Decimal("2e+36546632732954564789"),
+            Decimal("1e+36546632732954564789") + Decimal("1e+36546632732954564789"));
+  // Exponents that don't fit int64 are encoded and decoded through VarInt.
+  const Decimal huge("-1.5e+36546632732954564789");
+  EXPECT_EQ(huge, DecimalFromComparable(huge.EncodeToComparable()));
+
+  std::mt19937_64 rng(123456);
+  for (int i = 0; i != 1000; ++i) {
+    int64_t lhs = static_cast<int64_t>(rng()) >> (rng() % 64);
+    int64_t rhs = static_cast<int64_t>(rng()) >> (rng() % 64);
+    SCOPED_TRACE(Format("lhs: $0, rhs: $1", lhs, rhs));
+    const Decimal expected((VarInt(lhs) + VarInt(rhs)).ToString() + "e-3");
+    EXPECT_EQ(expected,
+              Decimal(std::to_string(lhs) + "e-3") + Decimal(std::to_string(rhs) + "e-3"));
+    EXPECT_EQ(expected, DecimalFromComparable(expected.EncodeToComparable()));
+  }
+}
+
 TEST_F(DecimalTest, TestFloatDoubleCanonicalization) {
   const float float_nan_0 = CreateFloat(1, 0b11111111, (1 << 22));
   const float float_nan_1 = CreateFloat(0, 0b11111111, 1);
@@ -11,9 +11,12 @@
 // under the License.
 //
 
+#include <array>
+#include <cstring>
 #include <vector>
 #include <limits>
 #include <iomanip>
+#include <iterator>
 #include <glog/logging.h>
 
 #include "yb/gutil/strings/substitute.h"
@@ -238,63 +241,110 @@ int Decimal::CompareTo(const Decimal &other) const {
   if (comp != 0) {
     return is_positive_ ? comp : -comp;
   }
-  for (size_t i = 0; i < digits_.size() && i < other.digits_.size(); i++) {
-    comp = static_cast<int>(digits_[i]) - static_cast<int>(other.digits_[i]);
-    if (comp != 0) {
-      return is_positive_ ? comp : -comp;
-    }
+  comp = memcmp(digits_.data(), other.digits_.data(),
+                std::min(digits_.size(), other.digits_.size()));
+  if (comp == 0) {
+    comp = static_cast<int>(this->digits_.size()) - static_cast<int>(other.digits_.size());
   }
-  comp = static_cast<int>(this->digits_.size()) - static_cast<int>(other.digits_.size());
   return is_positive_ ? comp : -comp;
 }
 
-// Encodes pairs of digits into one byte each. The last bit in each byte is the
+namespace {
+
+// We reserve two bits of the exponent for sign: -, zero, and +. Their sign portions are resp.
+// '00', '10', '11'.
+constexpr size_t kExponentReservedBits = 2;
+
+// Appends the same bytes as VarInt(value).EncodeToComparable(num_reserved_bits), without going
+// through a BIGNUM. The encoding is a unary prefix of num_bytes ones, a zero and the absolute value
+// padded to num_bytes * 7 bits, all of that complemented for negative values, the first
+// num_reserved_bits bits are reset to zero.
+void AppendInt64ToComparable(int64_t value, size_t num_reserved_bits, std::string* out) {
+  if (value == 0) {
+    out->push_back(static_cast<char>(0x80 >> num_reserved_bits));
+    return;
+  }
+  const bool negative = value < 0;
+  const uint64_t magnitude = negative ? -static_cast<uint64_t>(value) : value;
+  const size_t num_bits = 64 - __builtin_clzll(magnitude);
+  const size_t num_bytes = (num_bits + 1 + num_reserved_bits + 6) / 7;
+  const size_t num_ones = num_bytes + num_reserved_bits;
+  // At most 10 bytes for int64 values, so the whole encoding fits one 128 bit word.
+  unsigned __int128 word = magnitude;
+  word |= ((static_cast<unsigned __int128>(1) << num_ones) - 1) << (num_bytes * 8 - num_ones);
+  if (negative) {
+    word = ~word;
+  }
+  const size_t start = out->size();
+  for (size_t i = num_bytes; i-- > 0;) {
+    out->push_back(static_cast<char>(word >> (i * 8)));
+  }
+  (*out)[start] &= (1 << (8 - num_reserved_bits)) - 1;
+}
+
+// Decodes the value encoded by AppendInt64ToComparable from data, every byte of which is xor-ed
+// with flip first. Returns false when the size prefix does not fit the first byte, the caller falls
+// back to VarInt::DecodeFromComparable then, which also reports corrupted encodings.
+bool DecodeInt64FromComparable(
+    const uint8_t* data, size_t size, uint8_t flip, size_t num_reserved_bits, int64_t* value,
+    size_t* num_decoded_bytes) {
+  if (size == 0) {
+    return false;
+  }
+  uint8_t first = data[0] ^ flip;
+  const bool negative = (first & (0x80 >> num_reserved_bits)) == 0;
+  if (negative) {
+    flip = ~flip;
+    first = ~first;
+  }
+  first |= ~((1 << (8 - num_reserved_bits)) - 1);
+  if (first == 0xff) {
+    return false;
+  }
+  size_t num_ones = 0;
+  for (uint8_t mask = 0x80; first & mask; mask >>= 1) {
+    ++num_ones;
+  }
+  if (num_ones <= num_reserved_bits || num_ones - num_reserved_bits > size) {
+    return false;
+  }
+  const size_t num_bytes = num_ones - num_reserved_bits;
+  uint64_t word = first;
+  for (size_t i = 1; i != num_bytes; ++i) {
+    word = (word << 8) | static_cast<uint8_t>(data[i] ^ flip);
+  }
+  const uint64_t magnitude = word & ((1ULL << (num_bytes * 8 - num_ones)) - 1);
+  *value = negative ? -static_cast<int64_t>(magnitude) : static_cast<int64_t>(magnitude);
+  *num_decoded_bytes = num_bytes;
+  return true;
+}
+
+// Appends pairs of digits encoded into one byte each. The last bit in each byte is the
 // "continuation bit" which is equal to 1 for all bytes except the last.
-std::string EncodeToDigitPairs(const std::vector<uint8_t>& digits) {
+void AppendDigitPairs(const std::vector<uint8_t>& digits, std::string* out) {
   if (digits.empty()) {
-    return std::string();
+    return;
   }
   size_t len = (digits.size() + 1) / 2;
-  std::string result(len, 0);
   for (size_t i = 0; i < len - 1; ++i) {
-    result[i] = (digits[i * 2] * 10 + digits[i * 2 + 1]) * 2 + 1;
+    out->push_back((digits[i * 2] * 10 + digits[i * 2 + 1]) * 2 + 1);
   }
   size_t i = len - 1;
   uint8_t last_byte = digits[i * 2] * 10;
   if (i * 2 + 1 < digits.size()) {
     last_byte += digits[i * 2 + 1];
   }
-  result[i] = last_byte * 2;
-  return result;
-}
-
-string Decimal::EncodeToComparable() const {
-  // Zero is encoded to the special value 128.
-  if (digits_.empty()) {
-    return string(1, 128);
-  }
-  // We reserve two bits for sign: -, zero, and +. Their sign portions are resp. '00', '10', '11'.
-  string exponent = exponent_.EncodeToComparable(/* num_reserved_bits */ 2);
-  const string mantissa = EncodeToDigitPairs(digits_);
-  string output = exponent + mantissa;
-  // The first two (reserved) bits are set to 1 here.
-  output[0] |= 0xc0;
-  // For negatives, everything is complemented (including the sign bits) which were set to 1 above.
-  if (!is_positive_) {
-    for (int i = 0; i < output.size(); i++) {
-      output[i] = ~output[i]; // Bitwise not.
-    }
-  }
-  return output;
+  out->push_back(last_byte * 2);
 }
 
+// Decodes digits appended by AppendDigitPairs, every byte of the slice is xor-ed with flip first.
 CHECKED_STATUS DecodeFromDigitPairs(
-    const Slice& slice, size_t *num_decoded_bytes, std::vector<uint8_t>* digits) {
+    const Slice& slice, uint8_t flip, size_t *num_decoded_bytes, std::vector<uint8_t>* digits) {
   digits->clear();
   digits->reserve(slice.size() * 2);
   *num_decoded_bytes = 0;
   for (size_t i = 0; i < slice.size(); i++) {
-    uint8_t byte = slice[i];
+    uint8_t byte = slice[i] ^ flip;
     if (!(byte & 1)) {
       *num_decoded_bytes = i + 1;
       i = slice.size();
@@ -312,6 +362,47 @@ CHECKED_STATUS DecodeFromDigitPairs(
   return Status::OK();
 }
 
+// 10^n for n in [0, Decimal::kMaxFixedDigits].
+const std::array<unsigned __int128, Decimal::kMaxFixedDigits + 1>& PowersOfTen() {
+  static const auto result = [] {
+    std::array<unsigned __int128, Decimal::kMaxFixedDigits + 1> powers;
+    powers[0] = 1;
+    for (size_t i = 1; i != powers.size(); ++i) {
+      powers[i] = powers[i - 1] * 10;
+    }
+    return powers;
+  }();
+  return result;
+}
+
+}  // namespace
+
+string Decimal::EncodeToComparable() const {
+  // Zero is encoded to the special value 128.
+  if (digits_.empty()) {
+    return string(1, 128);
+  }
+  string output;
+  // Exponents that fit int64 are encoded directly, up to 10 bytes.
+  output.reserve(10 + (digits_.size() + 1) / 2);
+  auto exponent = exponent_.ToInt64();
+  if (exponent.ok()) {
+    AppendInt64ToComparable(*exponent, kExponentReservedBits, &output);
+  } else {
+    output = exponent_.EncodeToComparable(kExponentReservedBits);
+  }
+  AppendDigitPairs(digits_, &output);
+  // The first two (reserved) bits are set to 1 here.
+  output[0] |= 0xc0;
+  // For negatives, everything is complemented (including the sign bits) which were set to 1 above.
+  if (!is_positive_) {
+    for (int i = 0; i < output.size(); i++) {
+      output[i] = ~output[i]; // Bitwise not.
+    }
+  }
+  return output;
+}
+
 Status Decimal::DecodeFromComparable(const Slice& slice, size_t *num_decoded_bytes) {
   if (slice.empty()) {
     return STATUS(Corruption, "Cannot decode Decimal from empty slice.");
@@ -324,6 +415,20 @@ Status Decimal::DecodeFromComparable(const Slice& slice, size_t *num_decoded_byt
   }
   // The first bit is enough to decode the sign.
   is_positive_ = slice[0] >= 128;
+  const uint8_t flip = is_positive_ ? 0 : 0xff;
+  int64_t exponent = 0;
+  size_t num_exponent_bytes = 0;
+  size_t num_mantissa_bytes = 0;
+  // Exponents with a one byte size prefix are decoded in place, without copying the slice.
+  if (DecodeInt64FromComparable(slice.data(), slice.size(), flip, kExponentReservedBits,
+                                &exponent, &num_exponent_bytes)) {
+    exponent_ = VarInt(exponent);
+    RETURN_NOT_OK(DecodeFromDigitPairs(
+        Slice(slice.data() + num_exponent_bytes, slice.size() - num_exponent_bytes), flip,
+        &num_mantissa_bytes, &digits_));
+    *num_decoded_bytes = num_exponent_bytes + num_mantissa_bytes;
+    return Status::OK();
+  }
   // We have to complement everything if negative, so we are making a copy.
   string encoded = slice.ToBuffer();
   if (!is_positive_) {
@@ -331,13 +436,11 @@ Status Decimal::DecodeFromComparable(const Slice& slice, size_t *num_decoded_byt
       encoded[i] = ~encoded[i];
     }
   }
-  size_t num_exponent_bytes = 0;
   RETURN_NOT_OK(exponent_.DecodeFromComparable(
-      encoded, &num_exponent_bytes, /* num_reserved_bits */ 2));
+      encoded, &num_exponent_bytes, kExponentReservedBits));
   Slice remaining_slice(encoded);
   remaining_slice.remove_prefix(num_exponent_bytes);
-  size_t num_mantissa_bytes = 0;
-  RETURN_NOT_OK(DecodeFromDigitPairs(remaining_slice, &num_mantissa_bytes, &digits_));
+  RETURN_NOT_OK(DecodeFromDigitPairs(remaining_slice, 0, &num_mantissa_bytes, &digits_));
   *num_decoded_bytes = num_exponent_bytes + num_mantissa_bytes;
   return Status::OK();
 }
@@ -453,11 +556,84 @@ Decimal DecimalFromComparable(const std::string& str) {
   return DecimalFromComparable(Slice(str));
 }
 
+bool Decimal::ToScaledInt128(__int128* mantissa, int64_t* scale) const {
+  if (digits_.size() > kMaxFixedDigits) {
+    return false;
+  }
+  auto exponent = exponent_.ToInt64();
+  // Keep scales far from the int64 bounds, so the difference of two of them does not overflow.
+  constexpr int64_t kMaxExponent = std::numeric_limits<int64_t>::max() / 4;
+  if (!exponent.ok() || *exponent > kMaxExponent || *exponent < -kMaxExponent) {
+    return false;
+  }
+  __int128 result = 0;
+  for (auto digit : digits_) {
+    result = result * 10 + digit;
+  }
+  *mantissa = is_positive_ ? result : -result;
+  *scale = *exponent - static_cast<int64_t>(digits_.size());
+  return true;
+}
+
+void Decimal::FromScaledInt128(__int128 mantissa, int64_t scale) {
+  if (mantissa == 0) {
+    clear();
+    return;
+  }
+  is_positive_ = mantissa > 0;
+  unsigned __int128 magnitude = is_positive_ ? mantissa : -static_cast<unsigned __int128>(mantissa);
+  while (magnitude % 10 == 0) {
+    magnitude /= 10;
+    ++scale;
+  }
+  // The magnitude is below 2^128 < 10^39.
+  uint8_t buffer[kMaxFixedDigits + 1];
+  size_t num_digits = 0;
+  for (; magnitude != 0; magnitude /= 10) {
+    buffer[num_digits++] = static_cast<uint8_t>(magnitude % 10);
+  }
+  digits_.assign(std::reverse_iterator<uint8_t*>(buffer + num_digits),
+                 std::reverse_iterator<uint8_t*>(buffer));
+  exponent_ = VarInt(scale + static_cast<int64_t>(num_digits));
+}
+
 // Normalize so that both Decimals have same exponent and same number of digits
 // Add digits considering sign
 // Canonicalize result
 
 Decimal Decimal::operator+(const Decimal& other) const {
+  // Fast path: both values fit 128 bit mantissas, and so does their sum at the smaller scale of the
+  // two, e.g. the sum of prices with a few digits after the point.
+  __int128 mantissa = 0, other_mantissa = 0;
+  int64_t scale = 0, other_scale = 0;
+  if (ToScaledInt128(&mantissa, &scale) && other.ToScaledInt128(&other_mantissa, &other_scale)) {
+    if (mantissa == 0) {
+      return other;
+    }
+    if (other_mantissa == 0) {
+      return *this;
+    }
+    bool fits = true;
+    if (scale > other_scale) {
+      fits = digits_.size() + (scale - other_scale) <= kMaxFixedDigits;
+      if (fits) {
+        mantissa *= static_cast<__int128>(PowersOfTen()[scale - other_scale]);
+        scale = other_scale;
+      }
+    } else if (other_scale > scale) {
+      fits = other.digits_.size() + (other_scale - scale) <= kMaxFixedDigits;
+      if (fits) {
+        other_mantissa *= static_cast<__int128>(PowersOfTen()[other_scale - scale]);
+      }
+    }
+    __int128 sum;
+    if (fits && !__builtin_add_overflow(mantissa, other_mantissa, &sum)) {
+      Decimal result;
+      result.FromScaledInt128(sum, scale);
+      return result;
+    }
+  }
+
   Decimal decimal(digits_, exponent_, is_positive_);
   Decimal other1(other.digits_, other.exponent_, other.is_positive_);
 
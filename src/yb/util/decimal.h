@@ -82,6 +82,9 @@ class Decimal {
  public:
   static constexpr int kDefaultMaxLength = 20; // Enough for MIN_BIGINT=-9223372036854775808.
   static constexpr int kUnlimitedMaxLength = std::numeric_limits<int>::max();
+  // Decimals with at most this number of digits fit a signed 128 bit mantissa, the arithmetic on
+  // them does not have to go digit by digit.
+  static constexpr size_t kMaxFixedDigits = 38;
 
   Decimal() {}
   Decimal(const std::vector<uint8_t>& digits,
@@ -165,6 +168,12 @@ class Decimal {
   bool is_canonical() const;
   void make_canonical();
 
+  // Returns the value as mantissa * 10^scale, or false if it has more than kMaxFixedDigits digits
+  // or its exponent does not fit int64.
+  bool ToScaledInt128(__int128* mantissa, int64_t* scale) const;
+  // Sets the value to mantissa * 10^scale, the result is canonical.
+  void FromScaledInt128(__int128 mantissa, int64_t scale);
+
   std::vector<uint8_t> digits_;
   VarInt exponent_;
   bool is_positive_;
@@ -728,6 +728,14 @@ TEST_F(TestEnv, TestGetBlockSize) {
   ASSERT_GT(block_size, 0);
 }
 
+TEST_F(TestEnv, TestGetFreeSpaceBytes) {
+  auto result = env_->GetFreeSpaceBytes("does_not_exist");
+  ASSERT_TRUE(!result.ok() && result.status().IsNotFound());
+
+  auto free_space = ASSERT_RESULT(env_->GetFreeSpaceBytes(test_dir_));
+  ASSERT_GT(free_space, 0);
+}
+
 TEST_F(TestEnv, TestRWFile) {
   // Create the file.
   gscoped_ptr<RWFile> file;
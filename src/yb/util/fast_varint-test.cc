@@ -456,5 +456,64 @@ TEST(FastVarIntTest, DecodeDescendingSignedCheck) {
   }
 }
 
+TEST(FastVarIntTest, DecodeSignedVarInts) {
+  auto values = GenerateRandomValues<int64_t>(20);
+
+  std::string ascending, descending;
+  for (auto value : values) {
+    FastAppendSignedVarIntToStr(value, &ascending);
+    FastEncodeDescendingSignedVarInt(value, &descending);
+  }
+
+  std::vector<int64_t> decoded(values.size());
+  Slice slice(ascending);
+  ASSERT_OK(FastDecodeSignedVarInts(&slice, decoded.data(), decoded.size()));
+  ASSERT_TRUE(slice.empty());
+  ASSERT_EQ(values, decoded);
+
+  std::fill(decoded.begin(), decoded.end(), 0);
+  slice = descending;
+  ASSERT_OK(FastDecodeDescendingSignedVarInts(&slice, decoded.data(), decoded.size()));
+  ASSERT_TRUE(slice.empty());
+  ASSERT_EQ(values, decoded);
+
+  // Slice is not changed when there are not enough encoded VarInts.
+  slice = Slice(descending.data(), descending.size() - 1);
+  ASSERT_NOK(FastDecodeDescendingSignedVarInts(&slice, decoded.data(), decoded.size()));
+  ASSERT_EQ(descending.size() - 1, slice.size());
+}
+
+TEST(FastVarIntTest, DecodeDescendingSignedVarIntsPerformance) {
+  // The same number of VarInts as in a DocHybridTime.
+  constexpr size_t kBatchSize = 4;
+  auto values = GenerateRandomValues<int64_t>();
+  values.resize(values.size() / kBatchSize * kBatchSize);
+
+  std::string buf;
+  for (auto value : values) {
+    FastEncodeDescendingSignedVarInt(value, &buf);
+  }
+  int64_t decoded[kBatchSize];
+  for (bool batch : {false, true}) {
+    std::clock_t start_time = std::clock();
+    for (int i = 0; i != 25; ++i) {
+      Slice slice(buf);
+      for (size_t j = 0; j != values.size(); j += kBatchSize) {
+        if (batch) {
+          ASSERT_OK_FAST(FastDecodeDescendingSignedVarInts(&slice, decoded, kBatchSize));
+        } else {
+          for (auto& value : decoded) {
+            ASSERT_OK_FAST(FastDecodeDescendingSignedVarInt(&slice, &value));
+          }
+        }
+      }
+      ASSERT_TRUE(slice.empty());
+    }
+    std::clock_t end_time = std::clock();
+    LOG(INFO) << std::fixed << std::setprecision(2) << "Batch: " << batch << ", CPU time used: "
+              << 1000.0 * (end_time - start_time) / CLOCKS_PER_SEC << " ms\n";
+  }
+}
+
 }  // namespace util
 }  // namespace yb
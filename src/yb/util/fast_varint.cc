@@ -165,16 +165,14 @@ const uint64_t kVarIntMasks[] = {
     0xffffffffffffffffULL,
 };
 
-Result<std::pair<int64_t, size_t>> FastDecodeSignedVarInt(const uint8_t* src, size_t src_size) {
-  typedef std::pair<int64_t, size_t> ResultType;
-  if (src_size == 0) {
-    return STATUS(Corruption, "Cannot decode a variable-length integer of zero size");
-  }
+namespace {
 
-  uint16_t header = src[0] << 8 | (src_size > 1 ? src[1] : 0);
+// Returns the size of the signed VarInt whose first two bytes are in header, sets negative to
+// 0xffffffffffffffff for negative numbers and to 0 otherwise.
+inline size_t SignedVarIntSize(uint16_t header, uint64_t* negative) {
   // When value is positive then negative = 0, otherwise it is 0xffffffffffffffff.
-  uint64_t negative = -static_cast<uint64_t>((header & 0x8000) == 0);
-  header ^= negative;
+  *negative = -static_cast<uint64_t>((header & 0x8000) == 0);
+  header ^= *negative;
   // We need to count ones, so invert the header. 0x7fff - mask when we count them.
   // 0x20 used to put one after end of range where we are interested in them.
   //
@@ -192,17 +190,18 @@ Result<std::pair<int64_t, size_t>> FastDecodeSignedVarInt(const uint8_t* src, si
   // n_bytes                   : 10
   //
   // Argument of __builtin_clz is always unsigned int.
-  size_t n_bytes = __builtin_clz((~header & 0x7fff) | 0x20) - 16;
-  if (src_size < n_bytes) {
-    return NotEnoughEncodedBytes(n_bytes, src_size);
-  }
+  return __builtin_clz((~header & 0x7fff) | 0x20) - 16;
+}
+
+// Decodes the value of the signed VarInt of n_bytes size that starts at src.
+inline int64_t DecodeSignedVarIntValue(const uint8_t* src, size_t n_bytes, uint64_t negative) {
   auto mask = kVarIntMasks[n_bytes];
 #if defined(THREAD_SANITIZER) || defined(ADDRESS_SANITIZER)
   uint64_t temp = 0;
   for (const uint8_t* i = std::max(src - 8 + n_bytes, src); i != src + n_bytes; ++i) {
     temp = (temp << 8) | *i;
   }
-  return ResultType(((temp & mask) | (~mask & negative)) - negative, n_bytes);
+  return ((temp & mask) | (~mask & negative)) - negative;
 #else
   // We are interested in range [src, src+n_bytes), so we use 64bit number that ends at src+n_bytes.
   // Then we use mask to drop header and bytes out of range.
@@ -211,13 +210,49 @@ Result<std::pair<int64_t, size_t>> FastDecodeSignedVarInt(const uint8_t* src, si
   // And add one: "- negative".
   // In case of non negative number, negative == 0.
   // So number will be unchanged by those manipulations.
-  return ResultType(
-        ((__builtin_bswap64(*reinterpret_cast<const uint64_t*>(src - 8 + n_bytes)) & mask) |
-            (~mask & negative)) - negative,
-        n_bytes);
+  return ((__builtin_bswap64(*reinterpret_cast<const uint64_t*>(src - 8 + n_bytes)) & mask) |
+             (~mask & negative)) - negative;
 #endif
 }
 
+template <bool kDescending>
+Status DoFastDecodeSignedVarInts(Slice* slice, int64_t* out, size_t count) {
+  const uint8_t* src = slice->data();
+  const uint8_t* end = slice->end();
+  int64_t* const out_end = out + count;
+  // While the longest VarInt fits into the rest of the slice, its size does not have to be checked.
+  while (out != out_end && static_cast<size_t>(end - src) >= kMaxVarIntBufferSize) {
+    uint64_t negative;
+    const size_t n_bytes = SignedVarIntSize(src[0] << 8 | src[1], &negative);
+    const int64_t value = DecodeSignedVarIntValue(src, n_bytes, negative);
+    *out++ = kDescending ? -value : value;
+    src += n_bytes;
+  }
+  for (; out != out_end; ++out) {
+    auto temp = VERIFY_RESULT(FastDecodeSignedVarInt(src, end - src));
+    *out = kDescending ? -temp.first : temp.first;
+    src += temp.second;
+  }
+  slice->remove_prefix(src - slice->data());
+  return Status::OK();
+}
+
+}  // anonymous namespace
+
+Result<std::pair<int64_t, size_t>> FastDecodeSignedVarInt(const uint8_t* src, size_t src_size) {
+  typedef std::pair<int64_t, size_t> ResultType;
+  if (src_size == 0) {
+    return STATUS(Corruption, "Cannot decode a variable-length integer of zero size");
+  }
+
+  uint64_t negative;
+  size_t n_bytes = SignedVarIntSize(src[0] << 8 | (src_size > 1 ? src[1] : 0), &negative);
+  if (src_size < n_bytes) {
+    return NotEnoughEncodedBytes(n_bytes, src_size);
+  }
+  return ResultType(DecodeSignedVarIntValue(src, n_bytes, negative), n_bytes);
+}
+
 Status FastDecodeSignedVarInt(
     const uint8_t* src, size_t src_size, int64_t* v, size_t* decoded_size) {
   auto temp = VERIFY_RESULT(FastDecodeSignedVarInt(src, src_size));
@@ -250,6 +285,14 @@ Result<int64_t> FastDecodeDescendingSignedVarInt(Slice* slice) {
   return -temp.first;
 }
 
+Status FastDecodeSignedVarInts(Slice* slice, int64_t* out, size_t count) {
+  return DoFastDecodeSignedVarInts<false>(slice, out, count);
+}
+
+Status FastDecodeDescendingSignedVarInts(Slice* slice, int64_t* out, size_t count) {
+  return DoFastDecodeSignedVarInts<true>(slice, out, count);
+}
+
 size_t UnsignedVarIntLength(uint64_t v) {
   size_t result = 1;
   v >>= 7;
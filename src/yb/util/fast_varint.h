@@ -65,6 +65,13 @@ inline void FastEncodeDescendingSignedVarInt(int64_t v, std::string *dest) {
 CHECKED_STATUS FastDecodeDescendingSignedVarInt(Slice *slice, int64_t *dest);
 Result<int64_t> FastDecodeDescendingSignedVarInt(Slice* slice);
 
+// Decode count consecutive (descending) VarInts from the beginning of the slice into out,
+// consuming the decoded part. Cheaper than decoding them one by one, since sizes are not checked
+// while kMaxVarIntBufferSize bytes are left, and no intermediate Results are created.
+// The slice is left unchanged on failure.
+CHECKED_STATUS FastDecodeSignedVarInts(Slice* slice, int64_t* out, size_t count);
+CHECKED_STATUS FastDecodeDescendingSignedVarInts(Slice* slice, int64_t* out, size_t count);
+
 size_t UnsignedVarIntLength(uint64_t v);
 void FastAppendUnsignedVarIntToStr(uint64_t v, std::string* dest);
 void FastEncodeUnsignedVarInt(uint64_t v, uint8_t *dest, size_t *size);
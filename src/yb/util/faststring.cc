@@ -34,7 +34,6 @@
 
 #include <glog/logging.h>
 
-#include "yb/gutil/gscoped_ptr.h"
 
 namespace yb {
 
@@ -51,20 +50,26 @@ void faststring::GrowByAtLeast(size_t count) {
   GrowArray(to_reserve);
 }
 
+uint8_t* faststring::AllocateHeap(size_t capacity) {
+  auto* block = static_cast<uint8_t*>(malloc(kHeapHeadroom + capacity));
+  CHECK(block != nullptr);
+  return block + kHeapHeadroom;
+}
+
 void faststring::GrowArray(size_t newcapacity) {
   DCHECK_GE(newcapacity, capacity_);
-  gscoped_array<uint8_t> newdata(new uint8_t[newcapacity]);
+  uint8_t* newdata = AllocateHeap(newcapacity);
   if (len_ > 0) {
-    memcpy(&newdata[0], &data_[0], len_);
+    memcpy(newdata, data_, len_);
   }
   capacity_ = newcapacity;
   if (data_ != initial_data_) {
-    delete[] data_;
+    FreeHeap(data_);
   } else {
     ASAN_POISON_MEMORY_REGION(initial_data_, arraysize(initial_data_));
   }
 
-  data_ = newdata.release();
+  data_ = newdata;
   ASAN_POISON_MEMORY_REGION(data_ + len_, capacity_ - len_);
 }
 
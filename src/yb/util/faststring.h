@@ -32,6 +32,8 @@
 #ifndef YB_UTIL_FASTSTRING_H_
 #define YB_UTIL_FASTSTRING_H_
 
+#include <stdlib.h>
+
 #include <string>
 
 #include "yb/gutil/dynamic_annotations.h"
@@ -43,6 +45,9 @@ namespace yb {
 // A faststring is similar to a std::string, except that it is faster for many
 // common use cases (in particular, resize() will fill with uninitialized data
 // instead of memsetting to \0)
+//
+// Heap storage leaves room for the header of a RefCntBuffer in front of the data, so that a
+// RefCntBuffer could be constructed from a faststring without copying the data.
 class faststring {
  public:
   faststring() :
@@ -57,7 +62,7 @@ class faststring {
       len_(0),
       capacity_(kInitialCapacity) {
     if (capacity > capacity_) {
-      data_ = new uint8_t[capacity];
+      data_ = AllocateHeap(capacity);
       capacity_ = capacity;
     }
     ASAN_POISON_MEMORY_REGION(data_, capacity_);
@@ -66,7 +71,7 @@ class faststring {
   ~faststring() {
     ASAN_UNPOISON_MEMORY_REGION(initial_data_, arraysize(initial_data_));
     if (data_ != initial_data_) {
-      delete[] data_;
+      FreeHeap(data_);
     }
   }
 
@@ -96,10 +101,11 @@ class faststring {
   //
   // NOTE: the data pointer returned by release() is not necessarily the pointer
   uint8_t *release() WARN_UNUSED_RESULT {
-    uint8_t *ret = data_;
-    if (ret == initial_data_) {
-      ret = new uint8_t[len_];
-      memcpy(ret, data_, len_);
+    // The heap storage is not allocated with new[], so the data is always copied.
+    uint8_t *ret = new uint8_t[len_];
+    memcpy(ret, data_, len_);
+    if (data_ != initial_data_) {
+      FreeHeap(data_);
     }
     len_ = 0;
     capacity_ = kInitialCapacity;
@@ -236,6 +242,16 @@ class faststring {
   }
 
  private:
+  friend class RefCntBuffer;
+
+  // The size of the RefCntBuffer header.
+  static constexpr size_t kHeapHeadroom = 2 * sizeof(size_t);
+
+  static uint8_t* AllocateHeap(size_t capacity);
+
+  static void FreeHeap(uint8_t* data) {
+    free(data - kHeapHeadroom);
+  }
 
   // If necessary, expand the buffer to fit at least 'count' more bytes.
   // If the array has to be grown, it is grown by at least 50%.
@@ -125,4 +125,23 @@ TEST_F(HdrHistogramTest, PercentileAndCopyTest) {
   ASSERT_EQ(hist.TotalSum(), copy.TotalSum());
 }
 
+TEST_F(HdrHistogramTest, MergeTest) {
+  HdrHistogram hist(10000LU, kSigDigits);
+  HdrHistogram other(10000LU, kSigDigits);
+  for (int i = 1; i <= 50; i++) {
+    hist.Increment(i);
+    other.Increment(i + 50);
+  }
+  ASSERT_OK(hist.MergeFrom(other));
+  ASSERT_EQ(100, hist.TotalCount());
+  ASSERT_EQ(5050, hist.TotalSum());
+  ASSERT_EQ(1, hist.MinValue());
+  ASSERT_EQ(100, hist.MaxValue());
+  ASSERT_EQ(50, hist.ValueAtPercentile(50));
+  ASSERT_EQ(99, hist.ValueAtPercentile(99));
+
+  HdrHistogram incompatible(1000LU, kSigDigits);
+  ASSERT_NOK(hist.MergeFrom(incompatible));
+}
+
 } // namespace yb
@@ -205,6 +205,42 @@ void HdrHistogram::IncrementWithExpectedInterval(int64_t value,
   }
 }
 
+Status HdrHistogram::MergeFrom(const HdrHistogram& other) {
+  if (highest_trackable_value_ != other.highest_trackable_value_ ||
+      num_significant_digits_ != other.num_significant_digits_) {
+    return STATUS_SUBSTITUTE(InvalidArgument,
+        "Can't merge histogram with highest trackable value $0 and $1 significant digits into "
+        "histogram with $2 and $3", other.highest_trackable_value_, other.num_significant_digits_,
+        highest_trackable_value_, num_significant_digits_);
+  }
+  if (other.TotalCount() == 0) {
+    return Status::OK();
+  }
+
+  uint64_t total_merged_count = 0;
+  for (int i = 0; i < counts_array_length_; i++) {
+    uint64_t count = NoBarrier_Load(&other.counts_[i]);
+    if (count != 0) {
+      NoBarrier_AtomicIncrement(&counts_[i], count);
+      total_merged_count += count;
+    }
+  }
+  NoBarrier_AtomicIncrement(&total_count_, total_merged_count);
+  NoBarrier_AtomicIncrement(&total_sum_, other.TotalSum());
+
+  Atomic64 other_min = other.MinValue();
+  Atomic64 min_val;
+  while (other_min < (min_val = NoBarrier_Load(&min_value_))) {
+    if (NoBarrier_CompareAndSwap(&min_value_, min_val, other_min) == min_val) break;
+  }
+  Atomic64 other_max = other.MaxValue();
+  Atomic64 max_val;
+  while (other_max > (max_val = NoBarrier_Load(&max_value_))) {
+    if (NoBarrier_CompareAndSwap(&max_value_, max_val, other_max) == max_val) break;
+  }
+  return Status::OK();
+}
+
 ////////////////////////////////////
 
 int HdrHistogram::BucketIndex(uint64_t value) const {
@@ -104,6 +104,11 @@ class HdrHistogram {
   void IncrementWithExpectedInterval(int64_t value,
                                      int64_t expected_interval_between_samples);
 
+  // Add all values recorded by other, e.g. to get percentiles over several histograms. Both
+  // histograms should have the same highest trackable value and number of significant digits.
+  // Not a consistent snapshot of other, like the copy constructor.
+  CHECKED_STATUS MergeFrom(const HdrHistogram& other);
+
   // Fetch configuration params.
   uint64_t highest_trackable_value() const { return highest_trackable_value_; }
   int num_significant_digits() const { return num_significant_digits_; }
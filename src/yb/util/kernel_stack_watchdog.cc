@@ -35,7 +35,9 @@
 #include <boost/bind.hpp>
 #include <glog/logging.h>
 #include <gflags/gflags.h>
+#include <algorithm>
 #include <string>
+#include <unordered_map>
 
 #include "yb/util/debug-util.h"
 #include "yb/util/env.h"
@@ -43,12 +45,28 @@
 #include "yb/util/thread.h"
 #include "yb/util/status.h"
 #include "yb/gutil/map-util.h"
+#include "yb/gutil/strings/join.h"
+#include "yb/gutil/strings/split.h"
+#include "yb/gutil/strings/strip.h"
 #include "yb/gutil/strings/substitute.h"
+#include "yb/gutil/strings/util.h"
 
 DEFINE_int32(hung_task_check_interval_ms, 200,
              "Number of milliseconds in between checks for hung threads");
 TAG_FLAG(hung_task_check_interval_ms, hidden);
 
+DEFINE_int32(stack_sampling_interval_ms, 10,
+             "Number of milliseconds in between samples of the stacks of threads in scopes with "
+             "sampled stacks, which are past their thresholds.");
+TAG_FLAG(stack_sampling_interval_ms, advanced);
+TAG_FLAG(stack_sampling_interval_ms, runtime);
+
+DEFINE_int32(max_sampled_stacks_per_label, 1000,
+             "Maximum number of distinct stacks kept for a label of scopes with sampled stacks, "
+             "samples of other stacks are only counted.");
+TAG_FLAG(max_sampled_stacks_per_label, advanced);
+TAG_FLAG(max_sampled_stacks_per_label, runtime);
+
 using strings::Substitute;
 
 namespace yb {
@@ -103,13 +121,47 @@ Status GetKernelStack(pid_t p, string* ret) {
   return Status::OK();
 }
 
+// Returns the kernel frames of the thread from the outermost to the innermost, separated by
+// semicolons. Falls back to the function the thread waits in, when the kernel stack is not
+// readable.
+string GetCollapsedKernelStack(pid_t p) {
+  string kernel_stack;
+  if (GetKernelStack(p, &kernel_stack).ok()) {
+    // Lines look like "[<ffffffff8112c5a8>] do_fsync+0x38/0x70".
+    vector<string> frames;
+    for (auto line : strings::Split(kernel_stack, "\n", strings::SkipEmpty())) {
+      auto begin = line.find("] ");
+      auto function = begin == StringPiece::npos ? line : line.substr(begin + 2);
+      function = function.substr(0, function.find('+'));
+      if (!function.empty()) {
+        frames.push_back(function.ToString() + "_[k]");
+      }
+    }
+    return JoinStrings(vector<string>(frames.rbegin(), frames.rend()), ";");
+  }
+
+  faststring wchan;
+  if (!ReadFileToString(Env::Default(), Substitute("/proc/$0/wchan", p), &wchan).ok()) {
+    return string();
+  }
+  auto function = wchan.ToString();
+  StripWhiteSpace(&function);
+  // The thread is running when it does not wait in the kernel.
+  return function.empty() || function == "0" ? string() : function + "_[k]";
+}
+
 void KernelStackWatchdog::RunThread() {
+  bool sampling = false;
   while (true) {
-    MonoDelta delta = MonoDelta::FromMilliseconds(FLAGS_hung_task_check_interval_ms);
-    if (finish_.WaitFor(delta)) {
+    int delay_ms = FLAGS_hung_task_check_interval_ms;
+    if (sampling) {
+      delay_ms = std::min(delay_ms, FLAGS_stack_sampling_interval_ms);
+    }
+    if (finish_.WaitFor(MonoDelta::FromMilliseconds(delay_ms))) {
       // Watchdog exiting.
       break;
     }
+    sampling = sampled_scope_entered_.exchange(false, std::memory_order_acq_rel);
 
     {
       MutexLock l(lock_);
@@ -126,6 +178,13 @@ void KernelStackWatchdog::RunThread() {
           TLS::Frame* frame = &tls_copy.frames_[i];
 
           int paused_ms = (now - frame->start_time_) / 1000;
+          if (frame->sample_) {
+            sampling = true;
+            if (paused_ms >= frame->threshold_ms_) {
+              SampleStack(p, frame->status_);
+            }
+            continue;
+          }
           if (paused_ms > frame->threshold_ms_) {
             string kernel_stack;
             Status s = GetKernelStack(p, &kernel_stack);
@@ -148,6 +207,81 @@ void KernelStackWatchdog::RunThread() {
   }
 }
 
+void KernelStackWatchdog::SampleStack(pid_t tid, const char* label) {
+  SampledStack stack;
+  auto user_stack = ThreadStack(tid);
+  if (!user_stack.ok()) {
+    // The thread could have exited.
+    return;
+  }
+  stack.user_stack = *user_stack;
+  stack.kernel_stack = GetCollapsedKernelStack(tid);
+
+  std::lock_guard<std::mutex> lock(samples_mutex_);
+  auto& label_samples = samples_[label];
+  auto it = label_samples.stacks.find(stack);
+  if (it != label_samples.stacks.end()) {
+    ++it->second;
+  } else if (label_samples.stacks.size() <
+                 static_cast<size_t>(FLAGS_max_sampled_stacks_per_label)) {
+    label_samples.stacks.emplace(std::move(stack), 1);
+  } else {
+    ++label_samples.dropped;
+  }
+}
+
+string KernelStackWatchdog::SampledStacks(const string& label_prefix) const {
+  std::map<string, LabelSamples> samples;
+  {
+    std::lock_guard<std::mutex> lock(samples_mutex_);
+    for (auto it = samples_.lower_bound(label_prefix);
+         it != samples_.end() && HasPrefixString(it->first, label_prefix); ++it) {
+      samples.insert(*it);
+    }
+  }
+
+  // Symbolization is slow, so it is done once per address and outside of the lock.
+  std::unordered_map<void*, string> symbols;
+  string result;
+  for (const auto& label_and_samples : samples) {
+    for (const auto& stack_and_count : label_and_samples.second.stacks) {
+      result += label_and_samples.first;
+      const auto& user_stack = stack_and_count.first.user_stack;
+      for (int i = user_stack.num_frames(); i-- > 0;) {
+        auto pc = user_stack.frame(i);
+        auto it = symbols.find(pc);
+        if (it == symbols.end()) {
+          auto symbol = SymbolizeAddress(pc, StackTraceLineFormat::SYMBOL_ONLY);
+          StripTrailingNewline(&symbol);
+          it = symbols.emplace(pc, std::move(symbol)).first;
+        }
+        result += ';';
+        result += it->second;
+      }
+      if (!stack_and_count.first.kernel_stack.empty()) {
+        result += ';';
+        result += stack_and_count.first.kernel_stack;
+      }
+      result += Substitute(" $0\n", stack_and_count.second);
+    }
+    if (label_and_samples.second.dropped) {
+      result += Substitute("$0;[dropped] $1\n",
+                           label_and_samples.first, label_and_samples.second.dropped);
+    }
+  }
+  return result;
+}
+
+void KernelStackWatchdog::ResetSampledStacks() {
+  std::lock_guard<std::mutex> lock(samples_mutex_);
+  samples_.clear();
+}
+
+const char* KernelStackWatchdog::InternLabel(const string& label) {
+  std::lock_guard<std::mutex> lock(labels_mutex_);
+  return labels_.insert(label).first->c_str();
+}
+
 KernelStackWatchdog::TLS* KernelStackWatchdog::GetTLS() {
   INIT_STATIC_THREAD_LOCAL(KernelStackWatchdog::TLS, tls_);
   return tls_;
@@ -64,11 +64,23 @@
 //
 // Scopes with SCOPED_WATCH_STACK may be nested, but only up to a hard-coded limited depth
 // (currently 8).
+//
+// Instead of logging, a scope may ask for its stacks to be sampled, by constructing
+// ScopedWatchKernelStack with SampleStacks::kTrue. Once it is active longer than the threshold, the
+// watchdog takes the user and kernel stacks of the thread every --stack_sampling_interval_ms until
+// the scope exits, and aggregates them per label. SampledStacks() returns the aggregated stacks in
+// the input format of flamegraph.pl, so the causes of slow operations, such as fsync, lock waits or
+// page faults, can be seen without perf. The kernel stack requires the permission to read
+// /proc/<tid>/stack, otherwise only the kernel function the thread waits in is sampled.
 #ifndef YB_UTIL_KERNEL_STACK_WATCHDOG_H
 #define YB_UTIL_KERNEL_STACK_WATCHDOG_H
 
+#include <atomic>
+#include <map>
+#include <mutex>
 #include <string>
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 #include "yb/gutil/gscoped_ptr.h"
@@ -77,8 +89,10 @@
 #include "yb/gutil/singleton.h"
 #include "yb/gutil/walltime.h"
 #include "yb/util/countdown_latch.h"
+#include "yb/util/debug-util.h"
 #include "yb/util/mutex.h"
 #include "yb/util/monotime.h"
+#include "yb/util/strongly_typed_bool.h"
 #include "yb/util/threadlocal.h"
 
 #define SCOPED_WATCH_STACK(threshold_ms) \
@@ -88,6 +102,8 @@ namespace yb {
 
 class Thread;
 
+YB_STRONGLY_TYPED_BOOL(SampleStacks);
+
 // Singleton thread which implements the watchdog.
 class KernelStackWatchdog {
  public:
@@ -105,6 +121,16 @@ class KernelStackWatchdog {
   // Return any log messages saved since the last call to SaveLogsForTests(true).
   std::vector<std::string> LoggedMessagesForTests() const;
 
+  // Returns the stacks sampled in scopes with labels starting with label_prefix, one line per
+  // distinct stack: the label and the frames from the outermost to the innermost separated by
+  // semicolons, followed by the number of samples. Kernel frames have the _[k] suffix.
+  std::string SampledStacks(const std::string& label_prefix = std::string()) const;
+
+  void ResetSampledStacks();
+
+  // Returns a copy of label that is never freed, for labels of scopes that are built at runtime.
+  const char* InternLabel(const std::string& label);
+
  private:
   friend class Singleton<KernelStackWatchdog>;
   friend class ScopedWatchKernelStack;
@@ -137,6 +163,9 @@ class KernelStackWatchdog {
       // A string explaining the state that the thread is in (typically a file:line string). This is
       // expected to be static storage and is not freed.
       const char* status_;
+
+      // Whether the stacks of the thread are sampled past the threshold, instead of logged.
+      bool sample_;
     };
 
     // The data within the TLS. This is a POD type so that the watchdog can easily copy data out of
@@ -186,6 +215,26 @@ class KernelStackWatchdog {
   // The actual watchdog loop that the watchdog thread runs.
   void RunThread();
 
+  // Adds a sample of the user and kernel stacks of the thread to the stacks of label.
+  void SampleStack(pid_t tid, const char* label);
+
+  struct SampledStack {
+    StackTrace user_stack;
+    // Kernel frames from the outermost to the innermost, separated by semicolons.
+    std::string kernel_stack;
+
+    bool operator<(const SampledStack& rhs) const {
+      return user_stack != rhs.user_stack ? user_stack < rhs.user_stack
+                                          : kernel_stack < rhs.kernel_stack;
+    }
+  };
+
+  struct LabelSamples {
+    std::map<SampledStack, int64_t> stacks;
+    // Samples that were not kept because the label has too many distinct stacks.
+    int64_t dropped = 0;
+  };
+
   DECLARE_STATIC_THREAD_LOCAL(TLS, tls_);
 
   typedef std::unordered_map<pid_t, TLS*> TLSMap;
@@ -197,6 +246,16 @@ class KernelStackWatchdog {
   // Lock protecting tls_by_tid_ and log_collector_.
   mutable Mutex lock_;
 
+  // Set when a scope with sampled stacks is entered, the watchdog keeps waking up every
+  // --stack_sampling_interval_ms while such scopes are entered or active.
+  std::atomic<bool> sampled_scope_entered_{false};
+
+  mutable std::mutex samples_mutex_;
+  std::map<std::string, LabelSamples> samples_;
+
+  std::mutex labels_mutex_;
+  std::unordered_set<std::string> labels_;
+
   // The watchdog thread itself.
   scoped_refptr<Thread> thread_;
 
@@ -210,8 +269,10 @@ class KernelStackWatchdog {
 class ScopedWatchKernelStack {
  public:
   // If the current scope is active more than 'threshold_ms' milliseconds, the watchdog thread will
-  // log a warning including the message 'label'. 'label' is not copied or freed.
-  ScopedWatchKernelStack(const char* label, int threshold_ms) {
+  // log a warning including the message 'label', or sample the stacks of the thread when
+  // sample_stacks is true. 'label' is not copied or freed.
+  ScopedWatchKernelStack(
+      const char* label, int threshold_ms, SampleStacks sample_stacks = SampleStacks::kFalse) {
     // Rather than just using the lazy GetTLS() method, we'll first try to load the TLS ourselves.
     // This is usually successful, and avoids us having to inline the TLS construction path at call
     // sites.
@@ -237,9 +298,18 @@ class ScopedWatchKernelStack {
 #endif
     frame->threshold_ms_ = threshold_ms;
     frame->status_ = label;
+    frame->sample_ = sample_stacks.get();
 
     // "Release" the sequence lock. This resets the lock value to be even, so readers will proceed.
     base::subtle::Release_Store(&tls_data->seq_lock_, tls_data->seq_lock_ + 1);
+
+    if (sample_stacks) {
+      // Check first, so threads do not keep writing to the same cache line.
+      auto& entered = KernelStackWatchdog::GetInstance()->sampled_scope_entered_;
+      if (!entered.load(std::memory_order_relaxed)) {
+        entered.store(true, std::memory_order_release);
+      }
+    }
   }
 
   ~ScopedWatchKernelStack() {
@@ -61,6 +61,7 @@
 #include "yb/gutil/spinlock.h"
 #include "yb/gutil/ref_counted.h"
 
+#include "yb/util/async_logger.h"
 #include "yb/util/debug-util.h"
 #include "yb/util/flag_tags.h"
 
@@ -75,6 +76,16 @@ DEFINE_string(fatal_details_path_prefix, "",
 DEFINE_string(minicluster_daemon_id, "",
               "A human-readable 'daemon id', e.g. 'm-1' or 'ts-2', used in tests.");
 
+DEFINE_bool(async_logging, false,
+            "Write the INFO, WARNING and ERROR log files from background threads, so logging "
+            "threads do not block on the disk. Messages that do not fit into the buffer of "
+            "--async_logging_buffer_size_bytes per log file are dropped, FATAL messages are "
+            "always written synchronously.");
+TAG_FLAG(async_logging, advanced);
+DEFINE_int32(async_logging_buffer_size_bytes, 4 * 1024 * 1024,
+             "Size of the buffer of each log file when --async_logging is set.");
+TAG_FLAG(async_logging_buffer_size_bytes, advanced);
+
 DEFINE_string(ref_counted_debug_type_name_regex, "",
               "Regex for type names for debugging RefCounted / scoped_refptr based classes. "
               "An empty string disables RefCounted debug logging.");
@@ -294,6 +305,14 @@ void InitGoogleLoggingSafe(const char* arg) {
   // Sink logging: off.
   initial_stderr_severity = FLAGS_stderrthreshold;
 
+  if (FLAGS_async_logging && !FLAGS_logtostderr) {
+    // glog deletes the loggers when it is shut down, the wrapped ones are its own.
+    for (int severity = google::INFO; severity < google::FATAL; ++severity) {
+      google::base::SetLogger(severity, new AsyncLogger(
+          google::base::GetLogger(severity), FLAGS_async_logging_buffer_size_bytes));
+    }
+  }
+
   ApplyFlagsInternal();
 
   logging_initialized = true;
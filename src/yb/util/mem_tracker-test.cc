@@ -33,6 +33,7 @@
 #include "yb/util/mem_tracker.h"
 
 #include <string>
+#include <thread>
 #include <unordered_map>
 #include <utility>
 #include <vector>
@@ -46,6 +47,7 @@
 
 DECLARE_int32(memory_limit_soft_percentage);
 DECLARE_int64(mem_tracker_update_consumption_interval_us);
+DECLARE_int64(mem_tracker_cached_consumption_bytes);
 
 namespace yb {
 
@@ -336,6 +338,40 @@ TEST(MemTrackerTest, TcMallocRootTracker) {
 }
 #endif
 
+TEST(MemTrackerTest, CachedConsumption) {
+  FLAGS_mem_tracker_cached_consumption_bytes = 1_KB;
+  // The parent has a child, so its consumption goes through the thread stripes.
+  shared_ptr<MemTracker> p = MemTracker::CreateTracker(256_KB, "p");
+  shared_ptr<MemTracker> c = MemTracker::CreateTracker("c", p);
+
+  constexpr int kNumThreads = 8;
+  constexpr int kNumIters = 10000;
+  std::vector<std::thread> threads;
+  for (int i = 0; i != kNumThreads; ++i) {
+    threads.emplace_back([c] {
+      for (int j = 0; j != kNumIters; ++j) {
+        c->Consume(10);
+        c->Release(3);
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  ASSERT_EQ(kNumThreads * kNumIters * 7, c->consumption());
+  ASSERT_EQ(kNumThreads * kNumIters * 7, p->consumption());
+  ASSERT_TRUE(p->LimitExceeded());
+
+  // Limits account for consumption in stripes.
+  c->Release(kNumThreads * kNumIters * 7 - 256_KB + 100);
+  ASSERT_EQ(256_KB - 100, p->consumption());
+  ASSERT_FALSE(c->TryConsume(200));
+  ASSERT_TRUE(c->TryConsume(100));
+  ASSERT_EQ(256_KB, p->consumption());
+  c->Release(256_KB);
+  ASSERT_EQ(0, p->consumption());
+}
+
 TEST(MemTrackerTest, UnregisterFromParent) {
   shared_ptr<MemTracker> p = MemTracker::CreateTracker("parent");
   shared_ptr<MemTracker> c = MemTracker::CreateTracker("child", p);
@@ -33,6 +33,7 @@
 #include "yb/util/mem_tracker.h"
 
 #include <algorithm>
+#include <cstdlib>
 #include <deque>
 #include <limits>
 #include <list>
@@ -45,6 +46,7 @@
 
 #include "yb/gutil/map-util.h"
 #include "yb/gutil/once.h"
+#include "yb/gutil/port.h"
 #include "yb/gutil/strings/join.h"
 #include "yb/gutil/strings/human_readable.h"
 #include "yb/gutil/strings/substitute.h"
@@ -102,6 +104,13 @@ DEFINE_int64(mem_tracker_update_consumption_interval_us, 2000000,
              "Interval that is used to update memory consumption from external source. "
              "For instance from tcmalloc statistics.");
 
+DEFINE_int64(mem_tracker_cached_consumption_bytes, 64 * 1024,
+             "Consumption changes of a memory tracker with children are accumulated per thread "
+             "stripe until they reach this many bytes, before being added to the counter shared "
+             "by all threads. Changes at least this big skip the stripes. 0 disables the stripes.");
+TAG_FLAG(mem_tracker_cached_consumption_bytes, advanced);
+TAG_FLAG(mem_tracker_cached_consumption_bytes, runtime);
+
 namespace yb {
 
 // NOTE: this class has been adapted from Impala, so the code style varies
@@ -126,6 +135,30 @@ GoogleOnceType root_tracker_once = GOOGLE_ONCE_INIT;
 // is greater than GC_RELEASE_SIZE, this will trigger a tcmalloc gc.
 Atomic64 released_memory_since_gc;
 
+// Number of consumption stripes of a memory tracker.
+constexpr size_t kNumConsumptionStripes = 16;
+
+size_t ThreadConsumptionStripe() {
+  static std::atomic<size_t> next_stripe{0};
+  static thread_local size_t stripe =
+      next_stripe.fetch_add(1, std::memory_order_relaxed) % kNumConsumptionStripes;
+  return stripe;
+}
+
+// Counts released memory, returns true once more than gc_release_size was released since the last
+// tcmalloc GC. Each thread adds to the shared count in batches.
+bool CountReleasedMemory(int64_t bytes, int64_t gc_release_size) {
+  static thread_local int64_t unflushed_bytes = 0;
+  unflushed_bytes += bytes;
+  if (unflushed_bytes < FLAGS_mem_tracker_cached_consumption_bytes) {
+    return false;
+  }
+  const int64_t total = base::subtle::Barrier_AtomicIncrement(
+      &released_memory_since_gc, unflushed_bytes);
+  unflushed_bytes = 0;
+  return total > gc_release_size;
+}
+
 // Validate that various flags are percentages.
 bool ValidatePercentage(const char* flagname, int value) {
   if (value >= 0 && value <= 100) {
@@ -193,6 +226,12 @@ std::string CreateMetricDescription(const MemTracker& mem_tracker) {
 
 } // namespace
 
+// Padded to the cache line size, so updates of different stripes rarely touch the same line.
+struct MemTracker::ConsumptionStripe {
+  std::atomic<int64_t> value{0};
+  char padding[CACHELINE_SIZE - sizeof(std::atomic<int64_t>)];
+};
+
 class MemTracker::TrackerMetrics {
  public:
   explicit TrackerMetrics(const MetricEntityPtr& metric_entity)
@@ -268,6 +307,15 @@ shared_ptr<MemTracker> MemTracker::CreateChild(int64_t byte_limit,
   }
   auto result = std::make_shared<MemTracker>(
       byte_limit, id, shared_from_this(), add_to_parent, create_metrics);
+  // Consumption of the root tracker is taken from tcmalloc when available.
+#if TCMALLOC_ENABLED
+  const bool use_stripes = parent_ != nullptr;
+#else
+  const bool use_stripes = true;
+#endif
+  if (use_stripes && !stripes_.load(std::memory_order_acquire)) {
+    stripes_.store(new ConsumptionStripe[kNumConsumptionStripes], std::memory_order_release);
+  }
   auto p = child_trackers_.emplace(id, result);
   if (!p.second) {
     auto existing = p.first->second.lock();
@@ -326,6 +374,7 @@ MemTracker::~MemTracker() {
       parent_->Release(consumption());
     }
   }
+  delete[] stripes_.load(std::memory_order_acquire);
 }
 
 void MemTracker::UnregisterFromParent() {
@@ -458,12 +507,39 @@ void MemTracker::Consume(int64_t bytes) {
   }
   for (auto& tracker : all_trackers_) {
     if (!tracker->UpdateConsumption()) {
-      IncrementBy(bytes, &tracker->consumption_, tracker->metrics_);
-      DCHECK_GE(tracker->consumption_.current_value(), 0);
+      tracker->AddConsumption(bytes);
     }
   }
 }
 
+void MemTracker::AddConsumption(int64_t bytes) {
+  auto* stripes = stripes_.load(std::memory_order_acquire);
+  const int64_t max_pending = FLAGS_mem_tracker_cached_consumption_bytes;
+  if (!stripes || max_pending <= 0 || std::abs(bytes) >= max_pending) {
+    IncrementBy(bytes, &consumption_, metrics_);
+    // The shared counter alone could be negative while a stripe holds consumption.
+    DCHECK(stripes || consumption_.current_value() >= 0) << "Tracker: " << ToString();
+    return;
+  }
+
+  auto& pending = stripes[ThreadConsumptionStripe()].value;
+  if (std::abs(pending.fetch_add(bytes, std::memory_order_acq_rel) + bytes) >= max_pending) {
+    IncrementBy(pending.exchange(0, std::memory_order_acq_rel), &consumption_, metrics_);
+  }
+}
+
+int64_t MemTracker::PendingConsumption() const {
+  auto* stripes = stripes_.load(std::memory_order_acquire);
+  if (!stripes) {
+    return 0;
+  }
+  int64_t result = 0;
+  for (size_t i = 0; i != kNumConsumptionStripes; ++i) {
+    result += stripes[i].value.load(std::memory_order_acquire);
+  }
+  return result;
+}
+
 bool MemTracker::TryConsume(int64_t bytes, MemTracker** blocking_mem_tracker) {
   UpdateConsumption();
   if (bytes <= 0) {
@@ -479,14 +555,17 @@ bool MemTracker::TryConsume(int64_t bytes, MemTracker** blocking_mem_tracker) {
   for (i = all_trackers_.size() - 1; i >= 0; --i) {
     MemTracker *tracker = all_trackers_[i];
     if (tracker->limit_ < 0) {
-      IncrementBy(bytes, &tracker->consumption_, tracker->metrics_);
+      tracker->AddConsumption(bytes);
     } else {
-      if (!TryIncrementBy(bytes, tracker->limit_, &tracker->consumption_, tracker->metrics_)) {
+      // Consumption in stripes counts against the limit of the shared counter.
+      if (!TryIncrementBy(bytes, tracker->limit_ - tracker->PendingConsumption(),
+                          &tracker->consumption_, tracker->metrics_)) {
         // One of the trackers failed, attempt to GC memory or expand our limit. If that
         // succeeds, TryUpdate() again. Bail if either fails.
         if (!tracker->GcMemory(tracker->limit_ - bytes) ||
             tracker->ExpandLimit(bytes)) {
-          if (!TryIncrementBy(bytes, tracker->limit_, &tracker->consumption_, tracker->metrics_)) {
+          if (!TryIncrementBy(bytes, tracker->limit_ - tracker->PendingConsumption(),
+                              &tracker->consumption_, tracker->metrics_)) {
             break;
           }
         } else {
@@ -510,7 +589,7 @@ bool MemTracker::TryConsume(int64_t bytes, MemTracker** blocking_mem_tracker) {
   // to adjust the consumption of the query tracker to stop the resource from never
   // getting used by a subsequent TryConsume()?
   for (int j = all_trackers_.size() - 1; j > i; --j) {
-    IncrementBy(-bytes, &all_trackers_[j]->consumption_, all_trackers_[j]->metrics_);
+    all_trackers_[j]->AddConsumption(-bytes);
   }
   if (blocking_mem_tracker) {
     *blocking_mem_tracker = all_trackers_[i];
@@ -525,8 +604,7 @@ void MemTracker::Release(int64_t bytes) {
     return;
   }
 
-  if (PREDICT_FALSE(base::subtle::Barrier_AtomicIncrement(&released_memory_since_gc, bytes) >
-                    GC_RELEASE_SIZE)) {
+  if (PREDICT_FALSE(CountReleasedMemory(bytes, GC_RELEASE_SIZE))) {
     GcTcmalloc();
   }
 
@@ -543,14 +621,7 @@ void MemTracker::Release(int64_t bytes) {
 
   for (auto& tracker : all_trackers_) {
     if (!tracker->UpdateConsumption()) {
-      IncrementBy(-bytes, &tracker->consumption_, tracker->metrics_);
-      // If a UDF calls FunctionContext::TrackAllocation() but allocates less than the
-      // reported amount, the subsequent call to FunctionContext::Free() may cause the
-      // process mem tracker to go negative until it is synced back to the tcmalloc
-      // metric. Don't blow up in this case. (Note that this doesn't affect non-process
-      // trackers since we can enforce that the reported memory usage is internally
-      // consistent.)
-      DCHECK_GE(tracker->consumption_.current_value(), 0) << "Tracker: " << tracker->ToString();
+      tracker->AddConsumption(-bytes);
     }
   }
 }
@@ -657,7 +728,7 @@ bool MemTracker::GcMemory(int64_t max_consumption) {
 
     // Try to free up some memory
     for (const auto& gc : collectors) {
-      gc->CollectGarbage(max_consumption - current_consumption);
+      gc->CollectGarbage(current_consumption - max_consumption);
       current_consumption = GetUpdatedConsumption();
       if (current_consumption <= max_consumption) {
         break;
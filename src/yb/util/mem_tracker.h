@@ -34,6 +34,7 @@
 
 #include <stdint.h>
 
+#include <atomic>
 #include <functional>
 #include <memory>
 #include <string>
@@ -108,6 +109,12 @@ YB_STRONGLY_TYPED_BOOL(OnlyChildren);
 // this will be called before the process limit is reported as exceeded. GcFunctions are
 // called in the order they are added, so expensive functions should be added last.
 //
+// Consume()/Release() on a tracker with children, which is usually updated by many threads, go
+// to a stripe of the current thread first. Stripes are added to the shared consumption once their
+// size reaches FLAGS_mem_tracker_cached_consumption_bytes, so the shared counter, its peak and
+// metric lag behind by at most that much per stripe. consumption() and the limit checks include
+// the stripes.
+//
 // This class is thread-safe.
 //
 // NOTE: this class has been partially ported over from Impala with
@@ -295,7 +302,7 @@ class MemTracker : public std::enable_shared_from_this<MemTracker> {
 
   // Returns the memory consumed in bytes.
   int64_t consumption() const {
-    return consumption_.current_value();
+    return consumption_.current_value() + PendingConsumption();
   }
 
   int64_t GetUpdatedConsumption() {
@@ -306,7 +313,7 @@ class MemTracker : public std::enable_shared_from_this<MemTracker> {
   // Note that if consumption_ is based on consumption_func_, this
   // will be the max value we've recorded in consumption(), not
   // necessarily the highest value consumption_func_ has ever
-  // reached.
+  // reached. Consumption still in stripes is not reflected here.
   int64_t peak_consumption() const { return consumption_.max_value(); }
 
   // Retrieve the parent tracker, or NULL If one is not set.
@@ -345,6 +352,15 @@ class MemTracker : public std::enable_shared_from_this<MemTracker> {
     return limit_ >= 0 && limit_ < consumption();
   }
 
+  struct ConsumptionStripe;
+
+  // Adds bytes to the consumption of this tracker only, going through the stripe of the current
+  // thread when the tracker has stripes.
+  void AddConsumption(int64_t bytes);
+
+  // Returns the consumption in stripes, not yet added to consumption_.
+  int64_t PendingConsumption() const;
+
   // If consumption is higher than max_consumption, attempts to free memory by calling any
   // added GC functions.  Returns true if max_consumption is still exceeded. Takes
   // gc_lock. Updates metrics if initialized.
@@ -396,6 +412,10 @@ class MemTracker : public std::enable_shared_from_this<MemTracker> {
 
   HighWaterMark consumption_{0};
 
+  // Allocated once the tracker gets its first child, trackers without children are not shared
+  // widely enough to pay for them.
+  std::atomic<ConsumptionStripe*> stripes_{nullptr};
+
   // this tracker plus all of its ancestors
   std::vector<MemTracker*> all_trackers_;
   // all_trackers_ with valid limits
@@ -21,6 +21,7 @@
 
 #include <string.h>
 
+#include <limits>
 #include <map>
 #include <string>
 #include <vector>
@@ -534,6 +535,10 @@ class InMemoryEnv : public EnvWrapper {
     return 4096;
   }
 
+  Result<uint64_t> GetFreeSpaceBytes(const string& path) override {
+    return std::numeric_limits<uint64_t>::max();
+  }
+
   virtual Status RenameFile(const std::string& src,
                             const std::string& target) override {
     MutexLock lock(mutex_);
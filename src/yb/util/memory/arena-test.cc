@@ -236,6 +236,30 @@ TEST(TestArena, TestMemoryTrackingEnforced) {
   ASSERT_EQ(256, mem_tracker->consumption());
 }
 
+TEST(TestArena, TestHugePageBufferAllocator) {
+  shared_ptr<MemTracker> mem_tracker = MemTracker::CreateTracker(-1, "arena-test-tracker");
+  {
+    shared_ptr<MemoryTrackingBufferAllocator> allocator(
+        new MemoryTrackingBufferAllocator(HugePageBufferAllocator::Get(), mem_tracker));
+    Arena arena(allocator.get(), kHugePageSize, 2 * kHugePageSize);
+    ASSERT_EQ(static_cast<int64_t>(kHugePageSize), mem_tracker->consumption());
+
+    // Huge pages might be unavailable, in which case the allocator falls back to the heap. Either
+    // way allocations must succeed and be accounted.
+    for (int i = 0; i < 3; ++i) {
+      char* allocated = static_cast<char*>(arena.AllocateBytes(kHugePageSize / 2));
+      ASSERT_TRUE(allocated);
+      memset(allocated, i, kHugePageSize / 2);
+    }
+    ASSERT_GE(mem_tracker->consumption(), static_cast<int64_t>(2 * kHugePageSize));
+
+    // Small requests are served from the heap.
+    Arena small_arena(allocator.get(), 256, 1024);
+    ASSERT_TRUE(small_arena.AllocateBytes(128));
+  }
+  ASSERT_EQ(0, mem_tracker->consumption());
+}
+
 TEST(TestArena, TestSTLAllocator) {
   Arena a(256, 256 * 1024);
   typedef vector<int, ArenaAllocator<int>> ArenaVector;
@@ -33,6 +33,7 @@
 //
 
 #include <string.h>
+#include <sys/mman.h>
 
 #include <algorithm>
 #include <cstdlib>
@@ -130,6 +131,94 @@ HeapBufferAllocator::HeapBufferAllocator()
   : aligned_mode_(FLAGS_allocator_aligned_mode) {
 }
 
+void* AllocateHugePages(size_t size) {
+  size = align_up(size, kHugePageSize);
+#ifdef MAP_HUGETLB
+  void* data = mmap(nullptr, size, PROT_READ | PROT_WRITE,
+                    MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+  if (data != MAP_FAILED) {
+    return data;
+  }
+#endif
+#ifdef MADV_HUGEPAGE
+  // Transparent huge pages are only used for huge page aligned ranges, so map one more page and
+  // trim the unaligned head and tail.
+  void* mapped = mmap(nullptr, size + kHugePageSize, PROT_READ | PROT_WRITE,
+                      MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (mapped == MAP_FAILED) {
+    return nullptr;
+  }
+  char* begin = static_cast<char*>(mapped);
+  char* aligned = align_up(begin, kHugePageSize);
+  char* end = begin + size + kHugePageSize;
+  if (aligned != begin) {
+    munmap(begin, aligned - begin);
+  }
+  if (aligned + size != end) {
+    munmap(aligned + size, end - (aligned + size));
+  }
+  if (madvise(aligned, size, MADV_HUGEPAGE) != 0) {
+    // Transparent huge pages are disabled, the heap would serve such a request just as well.
+    munmap(aligned, size);
+    return nullptr;
+  }
+  return aligned;
+#else
+  return nullptr;
+#endif
+}
+
+void FreeHugePages(void* data, size_t size) {
+  PCHECK(munmap(data, align_up(size, kHugePageSize)) == 0) << "Failed to unmap huge pages";
+}
+
+Buffer HugePageBufferAllocator::AllocateInternal(
+    const size_t requested,
+    const size_t minimal,
+    BufferAllocator* const originator) {
+  DCHECK_LE(minimal, requested);
+  const size_t size = requested / kHugePageSize * kHugePageSize;
+  if (size != 0 && size >= minimal) {
+    void* data = AllocateHugePages(size);
+    if (data) {
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        huge_page_buffers_.insert(data);
+      }
+      return CreateBuffer(data, size, originator);
+    }
+  }
+  return DelegateAllocate(HeapBufferAllocator::Get(), requested, minimal, originator);
+}
+
+bool HugePageBufferAllocator::ReallocateInternal(
+    const size_t requested,
+    const size_t minimal,
+    Buffer* const buffer,
+    BufferAllocator* const originator) {
+  if (buffer->size() > 0 && IsHugePageBuffer(buffer->data())) {
+    return false;
+  }
+  return DelegateReallocate(HeapBufferAllocator::Get(), requested, minimal, buffer, originator);
+}
+
+void HugePageBufferAllocator::FreeInternal(Buffer* buffer) {
+  if (buffer->size() > 0) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (huge_page_buffers_.erase(buffer->data())) {
+      lock.unlock();
+      FreeHugePages(buffer->data(), buffer->size());
+      return;
+    }
+  }
+  DelegateFree(HeapBufferAllocator::Get(), buffer);
+}
+
+bool HugePageBufferAllocator::IsHugePageBuffer(void* data) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return huge_page_buffers_.count(data) != 0;
+}
+
 Buffer HeapBufferAllocator::AllocateInternal(
     const size_t requested,
     const size_t minimal,
@@ -51,6 +51,8 @@
 #include <algorithm>
 #include <limits>
 #include <memory>
+#include <mutex>
+#include <unordered_set>
 #include <vector>
 
 #include <boost/mpl/if.hpp>
@@ -82,6 +84,18 @@ class MemTracker;
 
 void OverwriteWithPattern(char* p, size_t len, GStringPiece pattern);
 
+// Size of the pages mapped by AllocateHugePages.
+constexpr size_t kHugePageSize = 2 * 1024 * 1024;
+
+// Maps 'size' bytes of anonymous memory backed by huge pages, rounding the mapping up to a multiple
+// of kHugePageSize. Explicitly reserved huge pages (vm.nr_hugepages) are tried first, then a
+// kHugePageSize aligned mapping advised for transparent huge pages. Returns nullptr if neither is
+// available, so that the caller could fall back to the heap.
+void* AllocateHugePages(size_t size);
+
+// Unmaps memory returned by AllocateHugePages, 'size' should be the same as when allocating.
+void FreeHugePages(void* data, size_t size);
+
 // Wrapper for a block of data allocated by a BufferAllocator. Owns the block.
 // (To release the block, destroy the buffer - it will then return it via the
 // same allocator that has been used to create it).
@@ -292,6 +306,43 @@ class HeapBufferAllocator : public BufferAllocator {
   DISALLOW_COPY_AND_ASSIGN(HeapBufferAllocator);
 };
 
+// Serves requests of at least kHugePageSize from huge pages (see AllocateHugePages), to reduce TLB
+// misses on large arenas. Smaller requests, and requests that could not be served from huge pages,
+// are delegated to the heap allocator. Use MemoryTrackingBufferAllocator on top of it to account
+// for the memory, buffer sizes are the mapped sizes.
+class HugePageBufferAllocator : public BufferAllocator {
+ public:
+  virtual ~HugePageBufferAllocator() {}
+
+  static HugePageBufferAllocator* Get() {
+    return Singleton<HugePageBufferAllocator>::get();
+  }
+
+ private:
+  friend class Singleton<HugePageBufferAllocator>;
+
+  HugePageBufferAllocator() {}
+
+  virtual Buffer AllocateInternal(size_t requested,
+                                  size_t minimal,
+                                  BufferAllocator* originator) override;
+
+  // Huge page buffers are never reallocated in place, so this fails for them.
+  virtual bool ReallocateInternal(size_t requested,
+                                  size_t minimal,
+                                  Buffer* buffer,
+                                  BufferAllocator* originator) override;
+
+  virtual void FreeInternal(Buffer* buffer) override;
+
+  bool IsHugePageBuffer(void* data);
+
+  std::mutex mutex_;
+  std::unordered_set<void*> huge_page_buffers_;
+
+  DISALLOW_COPY_AND_ASSIGN(HugePageBufferAllocator);
+};
+
 // Wrapper around the delegate allocator, that clears all newly allocated
 // (and reallocated) memory.
 class ClearingBufferAllocator : public BufferAllocator {
@@ -217,6 +217,84 @@ TEST_F(MetricsTest, JsonPrintTest) {
   ASSERT_EQ("", out.str());
 }
 
+TEST_F(MetricsTest, JsonEntityTypesTest) {
+  METRIC_reqs_pending.Instantiate(entity_)->Increment();
+
+  MetricJsonOptions opts;
+  opts.entity_types = { "test_entity" };
+  std::stringstream out;
+  {
+    JsonWriter writer(&out, JsonWriter::COMPACT);
+    ASSERT_OK(registry_.WriteAsJson(&writer, { "*" }, opts));
+  }
+  ASSERT_STR_CONTAINS(out.str(), "reqs_pending");
+
+  // Entities of other types are skipped.
+  opts.entity_types = { "tablet" };
+  out.str("");
+  {
+    JsonWriter writer(&out, JsonWriter::COMPACT);
+    ASSERT_OK(registry_.WriteAsJson(&writer, { "*" }, opts));
+  }
+  ASSERT_EQ("[]", out.str());
+}
+
+namespace {
+
+size_t CountLinesWithPrefix(const string& text, const string& prefix) {
+  std::istringstream input(text);
+  size_t result = 0;
+  for (string line; std::getline(input, line);) {
+    if (line.compare(0, prefix.size(), prefix) == 0) {
+      ++result;
+    }
+  }
+  return result;
+}
+
+} // namespace
+
+TEST_F(MetricsTest, PrometheusAggregationLevels) {
+  const vector<MetricEntity::AttributeMap> tablet_attrs = {
+      {{"table_id", "t1"}, {"table_name", "n1"}, {"metric_id", "tablet-1"}},
+      {{"table_id", "t1"}, {"table_name", "n1"}, {"metric_id", "tablet-2"}},
+      {{"table_id", "t2"}, {"table_name", "n2"}, {"metric_id", "tablet-3"}},
+  };
+  vector<std::unique_ptr<HdrHistogram>> histograms;
+  for (size_t i = 0; i != tablet_attrs.size(); ++i) {
+    histograms.emplace_back(new HdrHistogram(1000, 2));
+  }
+  histograms[0]->IncrementBy(10, 100);
+  histograms[2]->Increment(900);
+
+  auto write = [&](AggregationMetricLevel level) {
+    std::stringstream output;
+    PrometheusWriter writer(&output, level);
+    for (size_t i = 0; i != tablet_attrs.size(); ++i) {
+      CHECK_OK(writer.WriteSingleEntry(tablet_attrs[i], "rows", i + 1));
+      CHECK_OK(writer.WriteHistogram(tablet_attrs[i], "latency", *histograms[i]));
+    }
+    CHECK_OK(writer.FlushAggregatedValues());
+    return output.str();
+  };
+
+  auto output = write(AggregationMetricLevel::kTablet);
+  ASSERT_EQ(3, CountLinesWithPrefix(output, "rows{"));
+  ASSERT_EQ(3, CountLinesWithPrefix(output, "latency_count{"));
+
+  output = write(AggregationMetricLevel::kTable);
+  ASSERT_EQ(2, CountLinesWithPrefix(output, "rows{"));
+  ASSERT_EQ(2, CountLinesWithPrefix(output, "latency_count{"));
+  ASSERT_EQ(string::npos, output.find("tablet-1"));
+
+  // All tablets are summed up to series without table labels, with quantiles of merged values.
+  output = write(AggregationMetricLevel::kServer);
+  ASSERT_EQ(1, CountLinesWithPrefix(output, "rows 6 "));
+  ASSERT_EQ(1, CountLinesWithPrefix(output, "latency_count 101 "));
+  ASSERT_EQ(1, CountLinesWithPrefix(output, "latency{quantile=\"0.5\"} 10 "));
+  ASSERT_EQ(string::npos, output.find("table_id"));
+}
+
 // Test that metrics are retired when they are no longer referenced.
 TEST_F(MetricsTest, RetirementTest) {
   FLAGS_metrics_retirement_age_ms = 100;
@@ -31,6 +31,7 @@
 //
 #include "yb/util/metrics.h"
 
+#include <algorithm>
 #include <iostream>
 #include <map>
 #include <regex>
@@ -305,10 +306,11 @@ CHECKED_STATUS MetricEntity::WriteForPrometheus(PrometheusWriter* writer) const
   }
   AttributeMap prometheus_attr;
   // Per tablet metrics come with tablet_id, as well as table_id and table_name attributes.
-  // We ignore the tablet part to squash at the table level.
+  // PrometheusWriter drops the tablet part when aggregating at the table level.
   if (strcmp(prototype_->name(), "tablet") == 0)  {
     prometheus_attr["table_id"] = attrs["table_id"];
     prometheus_attr["table_name"] = attrs["table_name"];
+    prometheus_attr["metric_id"] = id_;
   } else if (strcmp(prototype_->name(), "server") == 0 ||
       strcmp(prototype_->name(), "cluster") == 0) {
     prometheus_attr = attrs;
@@ -328,7 +330,7 @@ CHECKED_STATUS MetricEntity::WriteForPrometheus(PrometheusWriter* writer) const
   }
   // Run the external metrics collection callback if there is one set.
   for (const ExternalPrometheusMetricsCb& cb : external_metrics_cbs) {
-    cb(writer);
+    cb(writer, prometheus_attr);
   }
 
   return Status::OK();
@@ -339,6 +341,91 @@ void MetricEntity::Remove(const MetricPrototype* proto) {
   metric_map_.erase(proto);
 }
 
+//
+// PrometheusWriter
+//
+
+PrometheusWriter::PrometheusWriter(
+    std::stringstream* output, AggregationMetricLevel aggregation_level)
+    : aggregation_level_(aggregation_level),
+      output_(output),
+      timestamp_(std::chrono::duration_cast<std::chrono::milliseconds>(
+          std::chrono::system_clock::now().time_since_epoch()).count()) {}
+
+PrometheusWriter::~PrometheusWriter() {}
+
+PrometheusWriter::AggregatedGroup* PrometheusWriter::FindAggregatedGroup(
+    const MetricEntity::AttributeMap& attr) {
+  // Only tablet level metrics have table_id, metrics of other entities are exported directly.
+  auto it = attr.find("table_id");
+  if (it == attr.end() || aggregation_level_ == AggregationMetricLevel::kTablet) {
+    return nullptr;
+  }
+  const bool per_table = aggregation_level_ == AggregationMetricLevel::kTable;
+  auto group_it = aggregated_groups_.find(per_table ? it->second : std::string());
+  if (group_it != aggregated_groups_.end()) {
+    return &group_it->second;
+  }
+  // If it's the first time we see this group, create the aggregate structures.
+  auto& group = aggregated_groups_[per_table ? it->second : std::string()];
+  group.attributes = attr;
+  group.attributes.erase("metric_id");
+  if (!per_table) {
+    group.attributes.erase("table_id");
+    group.attributes.erase("table_name");
+  }
+  return &group;
+}
+
+Status PrometheusWriter::WriteHistogram(
+    const MetricEntity::AttributeMap& attr, const std::string& name,
+    const HdrHistogram& histogram) {
+  auto* group = FindAggregatedGroup(attr);
+  if (group == nullptr) {
+    return FlushHistogram(attr, name, histogram);
+  }
+  auto& merged = group->histograms[name];
+  if (!merged) {
+    merged.reset(new HdrHistogram(histogram));
+    return Status::OK();
+  }
+  return merged->MergeFrom(histogram);
+}
+
+Status PrometheusWriter::FlushHistogram(
+    const MetricEntity::AttributeMap& attr, const std::string& name,
+    const HdrHistogram& histogram) {
+  // Representing the sum and count require suffixed names.
+  RETURN_NOT_OK(FlushSingleEntry(attr, name + "_sum", histogram.TotalSum()));
+  RETURN_NOT_OK(FlushSingleEntry(attr, name + "_count", histogram.TotalCount()));
+
+  // Quantiles are written as a Prometheus summary, i.e. with the quantile label.
+  static const std::pair<const char*, double> kQuantiles[] = {
+      {"0.5", 50}, {"0.95", 95}, {"0.99", 99}, {"0.999", 99.9}};
+  auto copy_of_attr = attr;
+  for (const auto& quantile : kQuantiles) {
+    copy_of_attr["quantile"] = quantile.first;
+    RETURN_NOT_OK(FlushSingleEntry(
+        copy_of_attr, name, histogram.ValueAtPercentile(quantile.second)));
+  }
+  return Status::OK();
+}
+
+Status PrometheusWriter::FlushAggregatedValues() {
+  for (const auto& entry : aggregated_groups_) {
+    const auto& group = entry.second;
+    for (const auto& metric_entry : group.values) {
+      RETURN_NOT_OK(FlushSingleEntry(group.attributes, metric_entry.first, metric_entry.second));
+    }
+    for (const auto& histogram_entry : group.histograms) {
+      RETURN_NOT_OK(FlushHistogram(
+          group.attributes, histogram_entry.first, *histogram_entry.second));
+    }
+  }
+  aggregated_groups_.clear();
+  return Status::OK();
+}
+
 void MetricEntity::RetireOldMetrics() {
   MonoTime now = MonoTime::Now();
 
@@ -410,19 +497,30 @@ MetricRegistry::MetricRegistry() {
 MetricRegistry::~MetricRegistry() {
 }
 
+std::vector<scoped_refptr<MetricEntity>> MetricRegistry::EntitiesOfTypes(
+    const vector<string>& entity_types) const {
+  std::vector<scoped_refptr<MetricEntity>> result;
+  std::lock_guard<simple_spinlock> l(lock_);
+  result.reserve(entity_types.empty() ? entities_.size() : 0);
+  for (const auto& e : entities_) {
+    if (entity_types.empty() ||
+        std::find(entity_types.begin(), entity_types.end(), e.second->prototype().name()) !=
+            entity_types.end()) {
+      result.push_back(e.second);
+    }
+  }
+  return result;
+}
+
 Status MetricRegistry::WriteAsJson(JsonWriter* writer,
                                    const vector<string>& requested_metrics,
                                    const MetricJsonOptions& opts) const {
-  EntityMap entities;
-  {
-    std::lock_guard<simple_spinlock> l(lock_);
-    entities = entities_;
-  }
+  auto entities = EntitiesOfTypes(opts.entity_types);
 
   writer->StartArray();
-  for (const EntityMap::value_type e : entities) {
-    WARN_NOT_OK(e.second->WriteAsJson(writer, requested_metrics, opts),
-                Substitute("Failed to write entity $0 as JSON", e.second->id()));
+  for (const auto& entity : entities) {
+    WARN_NOT_OK(entity->WriteAsJson(writer, requested_metrics, opts),
+                Substitute("Failed to write entity $0 as JSON", entity->id()));
   }
   writer->EndArray();
 
@@ -436,16 +534,13 @@ Status MetricRegistry::WriteAsJson(JsonWriter* writer,
   return Status::OK();
 }
 
-CHECKED_STATUS MetricRegistry::WriteForPrometheus(PrometheusWriter* writer) const {
-  EntityMap entities;
-  {
-    std::lock_guard<simple_spinlock> l(lock_);
-    entities = entities_;
-  }
+CHECKED_STATUS MetricRegistry::WriteForPrometheus(
+    PrometheusWriter* writer, const vector<string>& entity_types) const {
+  auto entities = EntitiesOfTypes(entity_types);
 
-  for (const EntityMap::value_type e : entities) {
-    WARN_NOT_OK(e.second->WriteForPrometheus(writer),
-                Substitute("Failed to write entity $0 as Prometheus", e.second->id()));
+  for (const auto& entity : entities) {
+    WARN_NOT_OK(entity->WriteForPrometheus(writer),
+                Substitute("Failed to write entity $0 as Prometheus", entity->id()));
   }
   RETURN_NOT_OK(writer->FlushAggregatedValues());
 
@@ -748,34 +843,7 @@ Status Histogram::WriteAsJson(JsonWriter* writer,
 CHECKED_STATUS Histogram::WriteForPrometheus(
     PrometheusWriter* writer, const MetricEntity::AttributeMap& attr) const {
   HdrHistogram snapshot(*histogram_);
-
-  // Representing the sum and count require suffixed names.
-  std::string hist_name = prototype_->name();
-  auto copy_of_attr = attr;
-  RETURN_NOT_OK(writer->WriteSingleEntry(
-        copy_of_attr, hist_name + "_sum", snapshot.TotalSum()));
-  RETURN_NOT_OK(writer->WriteSingleEntry(
-        copy_of_attr, hist_name + "_count", snapshot.TotalCount()));
-  /*
-  // Copy the label map to add the quatiles.
-  copy_of_attr["quantile"] = "0.75";
-  RETURN_NOT_OK(writer->WriteSingleEntry(
-        copy_of_attr, hist_name, snapshot.ValueAtPercentile(75)));
-  copy_of_attr["quantile"] = "0.95";
-  RETURN_NOT_OK(writer->WriteSingleEntry(
-        copy_of_attr, hist_name, snapshot.ValueAtPercentile(95)));
-  copy_of_attr["quantile"] = "0.99";
-  RETURN_NOT_OK(writer->WriteSingleEntry(
-        copy_of_attr, hist_name, snapshot.ValueAtPercentile(99)));
-  copy_of_attr["quantile"] = "0.999";
-  RETURN_NOT_OK(writer->WriteSingleEntry(
-        copy_of_attr, hist_name, snapshot.ValueAtPercentile(99.9)));
-  copy_of_attr["quantile"] = "0.9999";
-  RETURN_NOT_OK(writer->WriteSingleEntry(
-        copy_of_attr, hist_name, snapshot.ValueAtPercentile(99.99)));
-  // TODO: add min/max/mean?
-  */
-  return Status::OK();
+  return writer->WriteHistogram(attr, prototype_->name(), snapshot);
 }
 
 Status Histogram::GetHistogramSnapshotPB(HistogramSnapshotPB* snapshot_pb,
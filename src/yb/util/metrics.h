@@ -239,6 +239,8 @@
 /////////////////////////////////////////////////////
 
 #include <algorithm>
+#include <map>
+#include <memory>
 #include <mutex>
 #include <string>
 #include <sstream>
@@ -439,6 +441,11 @@ struct MetricJsonOptions {
   // unit, etc).
   // Default: false
   bool include_schema_info;
+
+  // Only write entities of these types, e.g. "tablet" or "server". Other entities are skipped
+  // without looking at their metrics.
+  // Default: empty, all entities are written.
+  std::vector<std::string> entity_types;
 };
 
 class MetricEntityPrototype {
@@ -474,7 +481,8 @@ class MetricEntity : public RefCountedThreadSafe<MetricEntity> {
   typedef std::unordered_map<std::string, std::string> AttributeMap;
   typedef std::function<void (JsonWriter* writer, const MetricJsonOptions& opts)>
     ExternalJsonMetricsCb;
-  typedef std::function<void (PrometheusWriter* writer)>
+  // Called with the attributes the metrics of this entity are exported with.
+  typedef std::function<void (PrometheusWriter* writer, const AttributeMap& attr)>
     ExternalPrometheusMetricsCb;
 
   scoped_refptr<Counter> FindOrCreateCounter(const CounterPrototype* proto);
@@ -581,44 +589,62 @@ class MetricEntity : public RefCountedThreadSafe<MetricEntity> {
 
 typedef scoped_refptr<MetricEntity> MetricEntityPtr;
 
+// Level at which metrics of tablets are exported to Prometheus. Metrics of other entities, e.g.
+// servers, are always exported as is.
+enum class AggregationMetricLevel {
+  // Metrics of all tablets of the server are summed up to a single series.
+  kServer,
+  // Metrics of tablets are summed up per table.
+  kTable,
+  // Each tablet has its own series.
+  kTablet,
+};
+
+// Writes metrics in the Prometheus text format. Entries that don't need aggregation are written
+// to the output right away, aggregated ones once FlushAggregatedValues is called, so the memory
+// used while writing does not depend on the number of tablets.
 class PrometheusWriter {
  public:
-  explicit PrometheusWriter(std::stringstream* output)
-    : output_(output),
-      timestamp_(std::chrono::duration_cast<std::chrono::milliseconds>(
-          std::chrono::system_clock::now().time_since_epoch()).count()) {}
+  explicit PrometheusWriter(
+      std::stringstream* output,
+      AggregationMetricLevel aggregation_level = AggregationMetricLevel::kTable);
+  ~PrometheusWriter();
 
   template<typename T>
   CHECKED_STATUS WriteSingleEntry(
       const MetricEntity::AttributeMap& attr, const std::string& name, const T& value) {
-    auto it = attr.find("table_id");
-    if (it != attr.end()) {
-      // For tablet level metrics, we roll up on the table level.
-      if (per_table_attributes_.find(it->second) == per_table_attributes_.end()) {
-        // If it's the first time we see this table, create the aggregate structures.
-        per_table_attributes_[it->second] = attr;
-        per_table_values_[it->second];
-      } else {
-        per_table_values_[it->second][name] += value;
-      }
-    } else {
-      // For non-tablet level metrics, export them directly.
-      RETURN_NOT_OK(FlushSingleEntry(attr, name, value));
+    auto* group = FindAggregatedGroup(attr);
+    if (group != nullptr) {
+      group->values[name] += value;
+      return Status::OK();
     }
-    return Status::OK();
+    return FlushSingleEntry(attr, name, value);
   }
 
-  CHECKED_STATUS FlushAggregatedValues() {
-    for (const auto& entry : per_table_values_) {
-      const auto& attrs = per_table_attributes_[entry.first];
-      for (const auto& metric_entry : entry.second) {
-        RETURN_NOT_OK(FlushSingleEntry(attrs, metric_entry.first, metric_entry.second));
-      }
-    }
-    return Status::OK();
-  }
+  // Writes the sum, the count and the quantiles of histogram. Histograms of aggregated tablets are
+  // merged, so the quantiles are computed over all of their values.
+  CHECKED_STATUS WriteHistogram(
+      const MetricEntity::AttributeMap& attr, const std::string& name,
+      const HdrHistogram& histogram);
+
+  CHECKED_STATUS FlushAggregatedValues();
 
  private:
+  struct AggregatedGroup {
+    MetricEntity::AttributeMap attributes;
+    // Map from metric name to value.
+    std::map<std::string, double> values;
+    std::map<std::string, std::unique_ptr<HdrHistogram>> histograms;
+  };
+
+  // Returns the group the entry with attr should be added to, or nullptr if the entry should be
+  // written as is.
+  AggregatedGroup* FindAggregatedGroup(const MetricEntity::AttributeMap& attr);
+
+  CHECKED_STATUS FlushHistogram(
+      const MetricEntity::AttributeMap& attr, const std::string& name,
+      const HdrHistogram& histogram);
+
   template<typename T>
   CHECKED_STATUS FlushSingleEntry(
       const MetricEntity::AttributeMap& attr, const std::string& name, const T& value) {
@@ -640,18 +666,15 @@ class PrometheusWriter {
     return Status::OK();
   }
 
-  // Map from table_id to attributes
-  std::map<std::string, MetricEntity::AttributeMap> per_table_attributes_;
-  // Map from table_id to map of metric_name to value
-  std::map<std::string, std::map<std::string, double>> per_table_values_;
+  const AggregationMetricLevel aggregation_level_;
+  // Map from aggregation key, e.g. table_id, to the aggregated entries.
+  std::map<std::string, AggregatedGroup> aggregated_groups_;
   // Output stream
   std::stringstream* output_;
   // Timestamp for all metrics belonging to this writer instance.
   int64_t timestamp_;
 };
 
-
-
 // Base class to allow for putting all metrics into a single container.
 // See documentation at the top of this file for information on metrics ownership.
 class Metric : public RefCountedThreadSafe<Metric> {
@@ -711,7 +734,9 @@ class MetricRegistry {
                      const std::vector<std::string>& requested_metrics,
                      const MetricJsonOptions& opts) const;
 
-  CHECKED_STATUS WriteForPrometheus(PrometheusWriter* writer) const;
+  // Only entities of entity_types are written, all if it is empty.
+  CHECKED_STATUS WriteForPrometheus(PrometheusWriter* writer,
+                                    const std::vector<std::string>& entity_types = {}) const;
 
   // For each registered entity, retires orphaned metrics. If an entity has no more
   // metrics and there are no external references, entities are removed as well.
@@ -727,6 +752,12 @@ class MetricRegistry {
 
  private:
   typedef std::unordered_map<std::string, scoped_refptr<MetricEntity> > EntityMap;
+
+  // Snapshots the entities of entity_types, or all entities if it is empty, so they can be written
+  // without holding lock_.
+  std::vector<scoped_refptr<MetricEntity>> EntitiesOfTypes(
+      const std::vector<std::string>& entity_types) const;
+
   EntityMap entities_;
 
   mutable simple_spinlock lock_;
@@ -38,6 +38,7 @@
 #include <netinet/tcp.h>
 #include <sys/socket.h>
 #include <sys/types.h>
+#include <sys/un.h>
 #include <unistd.h>
 
 #include <limits>
@@ -188,7 +189,7 @@ bool Socket::IsTemporarySocketError(const Status& status) {
 #if defined(__linux__)
 
 Status Socket::Init(int flags) {
-  auto family = flags & FLAG_IPV6 ? AF_INET6 : AF_INET;
+  auto family = flags & FLAG_UNIX ? AF_UNIX : flags & FLAG_IPV6 ? AF_INET6 : AF_INET;
   int nonblocking_flag = (flags & FLAG_NONBLOCKING) ? SOCK_NONBLOCK : 0;
   Reset(::socket(family, SOCK_STREAM | SOCK_CLOEXEC | nonblocking_flag, 0));
   if (fd_ < 0) {
@@ -203,7 +204,8 @@ Status Socket::Init(int flags) {
 #else
 
 Status Socket::Init(int flags) {
-  Reset(::socket(flags & FLAG_IPV6 ? AF_INET6 : AF_INET, SOCK_STREAM, 0));
+  auto family = flags & FLAG_UNIX ? AF_UNIX : flags & FLAG_IPV6 ? AF_INET6 : AF_INET;
+  Reset(::socket(family, SOCK_STREAM, 0));
   if (fd_ < 0) {
     int err = errno;
     return STATUS(NetworkError, std::string("error opening socket: ") +
@@ -225,10 +227,22 @@ Status Socket::Init(int flags) {
 
 #endif // defined(__linux__)
 
+bool Socket::IsUnixDomain() const {
+  sockaddr_storage addr;
+  socklen_t addr_len = sizeof(addr);
+  if (::getsockname(fd_, reinterpret_cast<sockaddr*>(&addr), &addr_len) != 0) {
+    return false;
+  }
+  return addr.ss_family == AF_UNIX;
+}
+
 Status Socket::SetNoDelay(bool enabled) {
   int flag = enabled ? 1 : 0;
   if (setsockopt(fd_, IPPROTO_TCP, TCP_NODELAY, &flag, sizeof(flag)) == -1) {
     int err = errno;
+    if (err == EOPNOTSUPP && IsUnixDomain()) {
+      return Status::OK();
+    }
     return STATUS(NetworkError, std::string("failed to set TCP_NODELAY: ") +
                                 ErrnoToString(err), Slice(), err);
   }
@@ -307,6 +321,17 @@ Status Socket::SetReuseAddr(bool flag) {
   return Status::OK();
 }
 
+Status Socket::SetReusePort(bool flag) {
+  int err;
+  int int_flag = flag ? 1 : 0;
+  if (setsockopt(fd_, SOL_SOCKET, SO_REUSEPORT, &int_flag, sizeof(int_flag)) == -1) {
+    err = errno;
+    return STATUS(NetworkError, std::string("failed to set SO_REUSEPORT: ") +
+                                ErrnoToString(err), Slice(), err);
+  }
+  return Status::OK();
+}
+
 Status Socket::BindAndListen(const Endpoint& sockaddr,
                              int listenQueueSize) {
   RETURN_NOT_OK(SetReuseAddr(true));
@@ -378,6 +403,49 @@ Status Socket::Bind(const Endpoint& endpoint, bool explain_addr_in_use) {
   return Status::OK();
 }
 
+namespace {
+
+Result<sockaddr_un> UnixSocketAddress(const std::string& path) {
+  sockaddr_un addr;
+  memset(&addr, 0, sizeof(addr));
+  if (path.size() >= sizeof(addr.sun_path)) {
+    return STATUS_FORMAT(InvalidArgument, "Unix socket path is too long: $0", path);
+  }
+  addr.sun_family = AF_UNIX;
+  memcpy(addr.sun_path, path.c_str(), path.size());
+  return addr;
+}
+
+} // namespace
+
+Status Socket::BindUnix(const std::string& path) {
+  DCHECK_GE(fd_, 0);
+  auto addr = VERIFY_RESULT(UnixSocketAddress(path));
+  if (::unlink(path.c_str()) != 0 && errno != ENOENT) {
+    int err = errno;
+    return STATUS(NetworkError, Format("Failed to remove $0: $1", path, ErrnoToString(err)),
+                  Slice(), err);
+  }
+  if (::bind(fd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) {
+    int err = errno;
+    return STATUS(NetworkError, Format("Error binding socket to $0: $1", path, ErrnoToString(err)),
+                  Slice(), err);
+  }
+  return Status::OK();
+}
+
+Status Socket::ConnectUnix(const std::string& path) {
+  TRACE_EVENT1("net", "Socket::ConnectUnix", "path", path);
+  DCHECK_GE(fd_, 0);
+  auto addr = VERIFY_RESULT(UnixSocketAddress(path));
+  if (::connect(fd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0) {
+    int err = errno;
+    return STATUS(NetworkError, std::string("connect(2) error: ") +
+                                ErrnoToString(err), Slice(), err);
+  }
+  return Status::OK();
+}
+
 Status Socket::Accept(Socket *new_conn, Endpoint* remote, int flags) {
   TRACE_EVENT0("net", "Socket::Accept");
   Endpoint temp;
@@ -404,7 +472,12 @@ Status Socket::Accept(Socket *new_conn, Endpoint* remote, int flags) {
   RETURN_NOT_OK(new_conn->SetNonBlocking(flags & FLAG_NONBLOCKING));
   RETURN_NOT_OK(new_conn->SetCloseOnExec());
 #endif // defined(__linux__)
-  temp.resize(olen);
+  if (temp.data()->sa_family == AF_UNIX) {
+    // The address does not fit into endpoint, and could have been truncated.
+    temp = Endpoint();
+  } else {
+    temp.resize(olen);
+  }
 
   *remote = temp;
   TRACE_EVENT_INSTANT1("net", "Accepted", TRACE_EVENT_SCOPE_THREAD,
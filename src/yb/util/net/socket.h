@@ -60,6 +60,8 @@ class Socket {
  public:
   static const int FLAG_NONBLOCKING = 0x1;
   static const int FLAG_IPV6 = 0x02;
+  // Unix domain socket, for connections between processes of the same host.
+  static const int FLAG_UNIX = 0x04;
 
   // Create a new invalid Socket object.
   Socket();
@@ -94,7 +96,10 @@ class Socket {
 
   CHECKED_STATUS Init(int flags); // See FLAG_NONBLOCKING
 
-  // Set or clear TCP_NODELAY
+  // Returns true if this is a Unix domain socket.
+  bool IsUnixDomain() const;
+
+  // Set or clear TCP_NODELAY. Does nothing for Unix domain sockets, that do not delay small writes.
   CHECKED_STATUS SetNoDelay(bool enabled);
 
   // Set or clear O_NONBLOCK
@@ -110,6 +115,10 @@ class Socket {
   // Sets SO_REUSEADDR to 'flag'. Should be used prior to Bind().
   CHECKED_STATUS SetReuseAddr(bool flag);
 
+  // Sets SO_REUSEPORT to 'flag', so that several sockets could listen on the same port and the
+  // kernel would distribute incoming connections between them. Should be used prior to Bind().
+  CHECKED_STATUS SetReusePort(bool flag);
+
   // Convenience method to invoke the common sequence:
   // 1) SetReuseAddr(true)
   // 2) Bind()
@@ -132,12 +141,20 @@ class Socket {
   // 'lsof' if available.
   CHECKED_STATUS Bind(const Endpoint& bind_addr, bool explain_addr_in_use = true);
 
-  // Call accept(2) to get a new connection.
+  // Binds Unix domain socket to the given path, removing a file that was left there, e.g. by a
+  // process that did not shut down cleanly.
+  CHECKED_STATUS BindUnix(const std::string& path);
+
+  // Call accept(2) to get a new connection. remote is left unspecified for connections accepted
+  // by Unix domain sockets.
   CHECKED_STATUS Accept(Socket *new_conn, Endpoint* remote, int flags);
 
   // start connecting this socket to a remote address.
   CHECKED_STATUS Connect(const Endpoint& remote);
 
+  // Start connecting Unix domain socket to the socket bound to path.
+  CHECKED_STATUS ConnectUnix(const std::string& path);
+
   // get the error status using getsockopt(2)
   CHECKED_STATUS GetSockError() const;
 
@@ -0,0 +1,118 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/util/numa.h"
+
+#if defined(__linux__)
+#include <sched.h>
+#endif
+
+#include <fstream>
+
+#include <gflags/gflags.h>
+#include <glog/logging.h>
+
+#include "yb/gutil/strings/numbers.h"
+#include "yb/gutil/strings/split.h"
+#include "yb/gutil/strings/substitute.h"
+#include "yb/util/errno.h"
+#include "yb/util/flag_tags.h"
+
+DEFINE_bool(numa_aware_placement, false,
+            "Whether reactors and RPC workers are partitioned into NUMA domains, one per NUMA node "
+            "of the machine, and bound to the CPUs of their domain. RPC tasks queued by a thread "
+            "of a domain are preferably executed by the workers of the same domain.");
+TAG_FLAG(numa_aware_placement, advanced);
+
+namespace yb {
+
+namespace {
+
+// CPUs of each NUMA node of the machine.
+std::vector<std::vector<int>> ReadNumaNodes() {
+  std::vector<std::vector<int>> result;
+  for (;;) {
+    std::ifstream input(strings::Substitute(
+        "/sys/devices/system/node/node$0/cpulist", result.size()));
+    std::string line;
+    if (!input || !std::getline(input, line)) {
+      break;
+    }
+    auto cpus = ParseCpuList(line);
+    if (!cpus.ok()) {
+      LOG(WARNING) << "Failed to parse CPUs of NUMA node " << result.size() << ": "
+                   << cpus.status();
+      return {};
+    }
+    result.push_back(std::move(*cpus));
+  }
+  return result;
+}
+
+const std::vector<std::vector<int>>& NumaNodes() {
+  static const std::vector<std::vector<int>> result = FLAGS_numa_aware_placement
+      ? ReadNumaNodes() : std::vector<std::vector<int>>();
+  return result;
+}
+
+thread_local int current_numa_domain = -1;
+
+} // namespace
+
+size_t NumNumaDomains() {
+  return std::max<size_t>(NumaNodes().size(), 1);
+}
+
+void BindCurrentThreadToNumaDomain(size_t domain) {
+  const auto& nodes = NumaNodes();
+  if (nodes.size() <= 1) {
+    return;
+  }
+  DCHECK_LT(domain, nodes.size());
+#if defined(__linux__)
+  cpu_set_t cpu_set;
+  CPU_ZERO(&cpu_set);
+  for (int cpu : nodes[domain]) {
+    CPU_SET(cpu, &cpu_set);
+  }
+  if (sched_setaffinity(0 /* pid */, sizeof(cpu_set), &cpu_set) != 0) {
+    LOG(WARNING) << "Failed to bind thread to NUMA domain " << domain << ": "
+                 << ErrnoToString(errno);
+    return;
+  }
+#endif
+  current_numa_domain = domain;
+}
+
+int CurrentNumaDomain() {
+  return current_numa_domain;
+}
+
+Result<std::vector<int>> ParseCpuList(const std::string& input) {
+  std::vector<int> result;
+  std::vector<std::string> ranges = strings::Split(input, ",", strings::SkipWhitespace());
+  for (const auto& range : ranges) {
+    std::vector<std::string> bounds = strings::Split(range, "-");
+    int32 first = 0, last = 0;
+    if (bounds.size() > 2 || !safe_strto32(bounds[0], &first) ||
+        !safe_strto32(bounds.back(), &last) || first < 0 || first > last) {
+      return STATUS_FORMAT(InvalidArgument, "Bad CPU range '$0' in '$1'", range, input);
+    }
+    for (int cpu = first; cpu <= last; ++cpu) {
+      result.push_back(cpu);
+    }
+  }
+  return result;
+}
+
+} // namespace yb
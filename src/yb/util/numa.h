@@ -0,0 +1,44 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#ifndef YB_UTIL_NUMA_H
+#define YB_UTIL_NUMA_H
+
+#include <string>
+#include <vector>
+
+#include "yb/util/result.h"
+
+namespace yb {
+
+// When FLAGS_numa_aware_placement is set, threads of the server could be placed into NUMA domains,
+// so that threads that pass work to each other, e.g. reactors and RPC workers, run on the same
+// socket and keep their memory local.
+
+// Returns the number of NUMA domains threads are placed into, 1 when placement is disabled or the
+// machine has a single NUMA node.
+size_t NumNumaDomains();
+
+// Restricts the current thread to the CPUs of domain, which should be less than NumNumaDomains().
+// Does nothing when there is a single domain.
+void BindCurrentThreadToNumaDomain(size_t domain);
+
+// Returns the domain the current thread is bound to, or -1 if it is not bound.
+int CurrentNumaDomain();
+
+// Parses the list of CPUs in the format of /sys/devices/system/node/node*/cpulist, e.g. "0-3,8".
+Result<std::vector<int>> ParseCpuList(const std::string& input);
+
+} // namespace yb
+
+#endif // YB_UTIL_NUMA_H
@@ -30,6 +30,10 @@
 // under the License.
 //
 
+#include <memory>
+#include <thread>
+#include <vector>
+
 #include <gtest/gtest.h>
 #include "yb/util/object_pool.h"
 
@@ -96,4 +100,18 @@ TEST(TestObjectPool, TestScopedPtr) {
   ASSERT_EQ(0, MyClass::instance_count());
 }
 
+TEST(TestObjectPool, TestPooledAllocator) {
+  MyClass::ResetCount();
+  std::vector<std::shared_ptr<MyClass>> objects;
+  for (int round = 0; round != 10; ++round) {
+    for (int i = 0; i != 100; ++i) {
+      objects.push_back(std::allocate_shared<MyClass>(PooledAllocator<MyClass>()));
+    }
+    ASSERT_EQ(100, MyClass::instance_count());
+    // Freed from another thread than the allocating one, like RPC calls often are.
+    std::thread([&objects] { objects.clear(); }).join();
+    ASSERT_EQ(0, MyClass::instance_count());
+  }
+}
+
 } // namespace yb
@@ -36,8 +36,10 @@
 
 #include <stdint.h>
 
+#include <cstddef>
 #include <thread>
 #include <functional>
+#include <memory>
 
 #include <boost/container/stable_vector.hpp>
 #include <boost/lockfree/stack.hpp>
@@ -246,6 +248,58 @@ class ThreadSafeObjectPool {
   boost::container::stable_vector<Pool> pools_;
 };
 
+// Allocator that keeps the memory of deallocated objects in a ThreadSafeObjectPool, so the next
+// allocation of the same type reuses it instead of going through the memory allocator, including
+// when objects are freed by other threads than the ones that allocate them. Intended for
+// std::allocate_shared of objects created and destroyed at a high rate, like RPC calls. The pool
+// keeps at most a few dozens of blocks per CPU for each allocated type.
+template <class T>
+class PooledAllocator {
+ public:
+  typedef T value_type;
+
+  PooledAllocator() = default;
+
+  template <class U>
+  PooledAllocator(const PooledAllocator<U>& rhs) {} // NOLINT
+
+  T* allocate(size_t n) {
+#if !defined(ADDRESS_SANITIZER)
+    if (n == 1) {
+      return static_cast<T*>(static_cast<void*>(Pool().Take()));
+    }
+#endif
+    return std::allocator<T>().allocate(n);
+  }
+
+  void deallocate(T* p, size_t n) {
+#if !defined(ADDRESS_SANITIZER)
+    if (n == 1) {
+      Pool().Release(static_cast<char*>(static_cast<void*>(p)));
+      return;
+    }
+#endif
+    std::allocator<T>().deallocate(p, n);
+  }
+
+  template <class U>
+  bool operator==(const PooledAllocator<U>& rhs) const { return true; }
+
+  template <class U>
+  bool operator!=(const PooledAllocator<U>& rhs) const { return false; }
+
+ private:
+  static_assert(alignof(T) <= alignof(std::max_align_t), "Over-aligned types are not supported");
+
+  static ThreadSafeObjectPool<char>& Pool() {
+    // Never destroyed, since objects could be deallocated during static destruction.
+    static auto* pool = new ThreadSafeObjectPool<char>(
+        [] { return static_cast<char*>(::operator new(sizeof(T))); },
+        [](char* block) { ::operator delete(block); });
+    return *pool;
+  }
+};
+
 } // namespace yb
 
 #endif // YB_UTIL_OBJECT_POOL_H
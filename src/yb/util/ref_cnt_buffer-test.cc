@@ -21,6 +21,7 @@
 
 #include <gtest/gtest.h>
 
+#include "yb/util/faststring.h"
 #include "yb/util/ref_cnt_buffer.h"
 
 #include "yb/util/test_util.h"
@@ -71,6 +72,34 @@ TEST_F(RefCntBufferTest, TestFromData) {
   }
 }
 
+// Test taking over the storage of faststring.
+TEST_F(RefCntBufferTest, TestFromFastString) {
+  unsigned int seed = SeedRandom();
+  for (auto i = 1000; i--;) {
+    size_t size = rand_r(&seed) % (kSizeLimit + 1); // Zero size is also allowed
+    faststring string;
+    for (size_t index = 0; index != size; ++index) {
+      string.push_back(static_cast<char>(index));
+    }
+    const void* string_data = string.data();
+    const bool inline_data = string.capacity() == faststring().capacity();
+
+    RefCntBuffer buffer(std::move(string));
+    ASSERT_EQ(size, buffer.size());
+    ASSERT_TRUE(string.empty());
+    if (!inline_data) {
+      ASSERT_EQ(string_data, buffer.data());
+    }
+    for (size_t index = 0; index != size; ++index) {
+      ASSERT_EQ(static_cast<char>(index), buffer.begin()[index]);
+    }
+
+    // The string could still be used.
+    string.append("abc", 3);
+    ASSERT_EQ("abc", string.ToString());
+  }
+}
+
 // Test vector of buffers.
 TEST_F(RefCntBufferTest, TestVector) {
   std::vector<RefCntBuffer> v;
@@ -44,6 +44,28 @@ RefCntBuffer::RefCntBuffer(const faststring& string)
     : RefCntBuffer(string.data(), string.size()) {
 }
 
+RefCntBuffer::RefCntBuffer(faststring&& string) {
+  static_assert(faststring::kHeapHeadroom == sizeof(CounterType) + sizeof(size_t),
+                "faststring should leave room for the header");
+  const size_t size = string.size();
+  if (string.data_ == string.initial_data_) {
+    // Short strings are stored inline, so they are copied.
+    data_ = static_cast<char*>(malloc(size + sizeof(CounterType) + sizeof(size_t)));
+    CHECK(data_ != nullptr);
+    memcpy(data(), string.data(), size);
+    string.clear();
+  } else {
+    ASAN_UNPOISON_MEMORY_REGION(string.data_, string.capacity_);
+    data_ = static_cast<char*>(static_cast<void*>(string.data_ - faststring::kHeapHeadroom));
+    string.data_ = string.initial_data_;
+    string.len_ = 0;
+    string.capacity_ = faststring::kInitialCapacity;
+    ASAN_POISON_MEMORY_REGION(string.data_, string.capacity_);
+  }
+  size_reference() = size;
+  new (&counter_reference()) CounterType(1);
+}
+
 RefCntBuffer::~RefCntBuffer() {
   Reset();
 }
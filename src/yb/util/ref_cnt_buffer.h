@@ -46,6 +46,9 @@ class RefCntBuffer {
 
   explicit RefCntBuffer(const faststring& string);
 
+  // Takes over the heap storage of string without copying the data, leaving string empty.
+  explicit RefCntBuffer(faststring&& string);
+
   RefCntBuffer(const RefCntBuffer& rhs) noexcept;
   RefCntBuffer(RefCntBuffer&& rhs) noexcept;
 
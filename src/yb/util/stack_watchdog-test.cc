@@ -82,6 +82,28 @@ TEST_F(StackWatchdogTest, TestWatchdog) {
   ASSERT_STR_CONTAINS(s, "TestWatchdog_Test::TestBody()");
   ASSERT_STR_CONTAINS(s, "nanosleep");
 }
+
+TEST_F(StackWatchdogTest, TestSampledStacks) {
+  auto* watchdog = KernelStackWatchdog::GetInstance();
+  watchdog->ResetSampledStacks();
+  const char* label = watchdog->InternLabel(Substitute("sampled_$0", 1));
+  ASSERT_EQ(label, watchdog->InternLabel("sampled_1"));
+  {
+    ScopedWatchKernelStack watch(label, 20, SampleStacks::kTrue);
+    SleepFor(MonoDelta::FromMilliseconds(500));
+  }
+
+  // Sampled scopes are not logged.
+  ASSERT_TRUE(watchdog->LoggedMessagesForTests().empty());
+  auto stacks = watchdog->SampledStacks("sampled_");
+  LOG(INFO) << "Sampled stacks:\n" << stacks;
+  ASSERT_STR_CONTAINS(stacks, "sampled_1;");
+  ASSERT_STR_CONTAINS(stacks, "TestSampledStacks_Test::TestBody()");
+  ASSERT_TRUE(watchdog->SampledStacks("other_").empty());
+
+  watchdog->ResetSampledStacks();
+  ASSERT_TRUE(watchdog->SampledStacks().empty());
+}
 #endif
 
 // Test that SCOPED_WATCH_STACK scopes can be nested.
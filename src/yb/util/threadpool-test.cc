@@ -68,6 +68,7 @@ using std::vector;
 
 using strings::Substitute;
 DECLARE_bool(enable_tracing);
+DECLARE_int32(threadpool_worker_spin_us);
 
 using std::shared_ptr;
 
@@ -596,6 +597,49 @@ TEST_P(TestThreadPoolTokenTypes, TestTokenWaitForAll) {
   ASSERT_EQ(kNumSubmissions, v);
 }
 
+// Submits tasks one at a time like a client waiting for each of them, so the workers go idle
+// between the tasks, and checks that spinning workers neither lose nor reorder them.
+TEST_F(TestThreadPool, TestSpinningWorkers) {
+  google::FlagSaver flag_saver;
+  const size_t kNumTasks = 1000;
+
+  for (int spin_us : {0, 1000}) {
+    FLAGS_threadpool_worker_spin_us = spin_us;
+    gscoped_ptr<ThreadPool> thread_pool;
+    ASSERT_OK(BuildMinMaxTestPool(4, 4, &thread_pool));
+    unique_ptr<ThreadPoolToken> serial = thread_pool->NewToken(ThreadPool::ExecutionMode::SERIAL);
+
+    vector<size_t> order;
+    atomic<size_t> num_concurrent(0);
+    MonoDelta total_latency = MonoDelta::kZero;
+    for (size_t i = 0; i != kNumTasks; ++i) {
+      CountDownLatch latch(2);
+      const auto start = MonoTime::Now();
+      ASSERT_OK(serial->SubmitFunc([&order, &latch, i] {
+        order.push_back(i);
+        latch.CountDown();
+      }));
+      ASSERT_OK(thread_pool->SubmitFunc([&num_concurrent, &latch] {
+        ++num_concurrent;
+        latch.CountDown();
+      }));
+      latch.Wait();
+      total_latency += MonoTime::Now() - start;
+    }
+    thread_pool->Wait();
+
+    ASSERT_EQ(kNumTasks, num_concurrent.load());
+    ASSERT_EQ(kNumTasks, order.size());
+    for (size_t i = 0; i != kNumTasks; ++i) {
+      ASSERT_EQ(i, order[i]);
+    }
+    LOG(INFO) << "Spin " << spin_us << "us, average latency of a pair of tasks: "
+              << (total_latency.ToMicroseconds() / kNumTasks) << "us";
+    serial.reset();
+    thread_pool->Shutdown();
+  }
+}
+
 TEST_F(TestThreadPool, TestFuzz) {
   const int kNumOperations = 1000;
   Random r(SeedRandom());
@@ -31,6 +31,7 @@
 //
 
 #include <algorithm>
+#include <chrono>
 #include <functional>
 #include <iostream>
 #include <limits>
@@ -39,20 +40,35 @@
 #include <gflags/gflags.h>
 #include <glog/logging.h>
 
+#include "yb/gutil/atomicops.h"
 #include "yb/gutil/callback.h"
 #include "yb/gutil/macros.h"
 #include "yb/gutil/map-util.h"
 #include "yb/gutil/stl_util.h"
 #include "yb/gutil/strings/substitute.h"
 #include "yb/gutil/sysinfo.h"
+#include "yb/util/atomic.h"
+#include "yb/util/flag_tags.h"
 #include "yb/util/metrics.h"
 #include "yb/util/stopwatch.h"
 #include "yb/util/thread.h"
 #include "yb/util/threadpool.h"
 #include "yb/util/trace.h"
 
+DEFINE_int32(threadpool_worker_spin_us, 0,
+             "Time an idle thread pool worker keeps polling for new tasks, without holding the "
+             "pool lock, before it goes to sleep.");
+TAG_FLAG(threadpool_worker_spin_us, advanced);
+TAG_FLAG(threadpool_worker_spin_us, runtime);
+
 namespace yb {
 
+namespace {
+
+constexpr int kSpinIterationsPerClockCheck = 16;
+
+} // namespace
+
 using strings::Substitute;
 using std::unique_ptr;
 
@@ -507,9 +523,20 @@ Status ThreadPool::DoSubmit(const std::shared_ptr<Runnable> task, ThreadPoolToke
     }
   }
   int length_at_submit = total_queued_tasks_++;
+  num_submitted_tasks_.fetch_add(1, std::memory_order_release);
+
+  // A spinning worker checks the queue after it takes the lock back, so it will pick the task
+  // without being woken up.
+  bool signal = true;
+  if (spinning_threads_ > 0) {
+    --spinning_threads_;
+    signal = false;
+  }
 
   guard.Unlock();
-  not_empty_.Signal();
+  if (signal) {
+    not_empty_.Signal();
+  }
 
   if (metrics_.queue_length_histogram) {
     metrics_.queue_length_histogram->Increment(length_at_submit);
@@ -553,6 +580,10 @@ void ThreadPool::DispatchThread(bool permanent) {
     }
 
     if (queue_.empty()) {
+      SpinUnlocked(&unique_lock);
+      if (!queue_.empty() || !pool_status_.ok()) {
+        continue;
+      }
       if (permanent) {
         not_empty_.Wait();
       } else {
@@ -662,6 +693,31 @@ void ThreadPool::DispatchThread(bool permanent) {
   }
 }
 
+void ThreadPool::SpinUnlocked(MutexLock* lock) {
+  const auto spin_us = GetAtomicFlag(&FLAGS_threadpool_worker_spin_us);
+  if (spin_us <= 0) {
+    return;
+  }
+  const auto num_submitted_tasks = num_submitted_tasks_.load(std::memory_order_acquire);
+  ++spinning_threads_;
+  lock->Unlock();
+  const auto deadline = std::chrono::steady_clock::now() + std::chrono::microseconds(spin_us);
+  for (;;) {
+    for (int i = 0; i != kSpinIterationsPerClockCheck; ++i) {
+      base::subtle::PauseCPU();
+    }
+    if (num_submitted_tasks_.load(std::memory_order_acquire) != num_submitted_tasks ||
+        std::chrono::steady_clock::now() >= deadline) {
+      break;
+    }
+  }
+  lock->Lock();
+  // Could have been already consumed by a submit that skipped signaling.
+  if (spinning_threads_ > 0) {
+    --spinning_threads_;
+  }
+}
+
 Status ThreadPool::CreateThreadUnlocked() {
   // The first few threads are permanent, and do not time out.
   bool permanent = (num_threads_ < min_threads_);
@@ -32,6 +32,7 @@
 #ifndef YB_UTIL_THREADPOOL_H
 #define YB_UTIL_THREADPOOL_H
 
+#include <atomic>
 #include <deque>
 #include <functional>
 #include <memory>
@@ -298,6 +299,11 @@ class ThreadPool {
   // Releases token 't' and invalidates it.
   void ReleaseToken(ThreadPoolToken* t);
 
+  // Polls for new tasks for FLAGS_threadpool_worker_spin_us with the lock released, so a task
+  // submitted shortly is picked without waking the worker up through not_empty_. The caller
+  // should check the queue again after it returns.
+  void SpinUnlocked(MutexLock* lock);
+
   const std::string name_;
   const int min_threads_;
   const int max_threads_;
@@ -317,6 +323,13 @@ class ThreadPool {
   // Protected by lock_.
   int total_queued_tasks_;
 
+  // Number of workers spinning in SpinUnlocked() that were not accounted by a submit that skipped
+  // signaling not_empty_. Protected by lock_.
+  int spinning_threads_ = 0;
+
+  // Incremented by each submit, polled by spinning workers.
+  std::atomic<int64_t> num_submitted_tasks_{0};
+
   // All allocated tokens.
   // Tokens are owned by the clients.
   //
@@ -0,0 +1,137 @@
+//
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+//
+
+#include <map>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "yb/util/random_util.h"
+#include "yb/util/test_util.h"
+#include "yb/util/timer_wheel.h"
+
+using namespace std::literals;
+
+namespace yb {
+
+typedef std::chrono::steady_clock::time_point TimePoint;
+typedef TimerWheel<int> Wheel;
+
+class TimerWheelTest : public YBTest {
+ protected:
+  const TimePoint start_ = std::chrono::steady_clock::now();
+};
+
+TEST_F(TimerWheelTest, Simple) {
+  Wheel wheel(1ms, start_);
+  ASSERT_EQ(TimePoint::max(), wheel.NextAdvanceTime());
+
+  wheel.Insert(start_ + 5ms, 1);
+  wheel.Insert(start_ + 1500us, 2);
+  wheel.Insert(start_ + 10s, 3);
+  ASSERT_EQ(3, wheel.size());
+  ASSERT_EQ(start_ + 2ms, wheel.NextAdvanceTime());
+
+  std::vector<int> fired;
+  auto fire = [&fired](int value) { fired.push_back(value); };
+  wheel.Advance(start_ + 1999us, fire);
+  ASSERT_TRUE(fired.empty());
+  wheel.Advance(start_ + 2ms, fire);
+  ASSERT_EQ(std::vector<int>({2}), fired);
+  ASSERT_EQ(start_ + 5ms, wheel.NextAdvanceTime());
+
+  wheel.Advance(start_ + 5s, fire);
+  ASSERT_EQ(std::vector<int>({2, 1}), fired);
+  wheel.Advance(start_ + 10s, fire);
+  ASSERT_EQ(std::vector<int>({2, 1, 3}), fired);
+  ASSERT_TRUE(wheel.empty());
+}
+
+TEST_F(TimerWheelTest, Cancel) {
+  Wheel wheel(1ms, start_);
+  auto handle1 = wheel.Insert(start_ + 10ms, 1);
+  wheel.Insert(start_ + 10ms, 2);
+  auto handle3 = wheel.Insert(start_ + 1h, 3);
+  wheel.Cancel(handle1);
+  wheel.Cancel(handle3);
+  ASSERT_EQ(1, wheel.size());
+
+  std::vector<int> fired;
+  wheel.Advance(start_ + 2h, [&fired](int value) { fired.push_back(value); });
+  ASSERT_EQ(std::vector<int>({2}), fired);
+}
+
+TEST_F(TimerWheelTest, InsertFromCallback) {
+  Wheel wheel(1ms, start_);
+  wheel.Insert(start_ + 1ms, 0);
+  std::vector<int> fired;
+  wheel.Advance(start_ + 1s, [&wheel, &fired, this](int value) {
+    fired.push_back(value);
+    if (value < 10) {
+      // Timer in the past should fire in the next tick.
+      wheel.Insert(start_, value + 1);
+    }
+  });
+  ASSERT_EQ(11, fired.size());
+  ASSERT_TRUE(wheel.empty());
+}
+
+// Checks that each timer fires not earlier than its time and not later than the first Advance
+// that is at least one tick after it.
+TEST_F(TimerWheelTest, Random) {
+  constexpr int kIterations = 100000;
+  const auto kResolution = 1ms;
+  // Enough to have timers at the third level.
+  constexpr int64_t kMaxDelayUs = 1000LL << 20;
+
+  Wheel wheel(kResolution, start_);
+  std::map<int, std::pair<TimePoint, Wheel::Handle>> timers;
+  auto now = start_;
+  auto check_fired = [&timers, &now, kResolution](TimePoint prev_now, int value) {
+    auto it = timers.find(value);
+    ASSERT_TRUE(it != timers.end()) << value;
+    ASSERT_LE(it->second.first, now) << value;
+    ASSERT_GT(it->second.first + kResolution, prev_now) << value;
+    timers.erase(it);
+  };
+  for (int i = 0; i != kIterations; ++i) {
+    if (!timers.empty() && RandomWithChance(4)) {
+      auto it = timers.lower_bound(RandomUniformInt(0, i));
+      if (it == timers.end()) {
+        it = timers.begin();
+      }
+      wheel.Cancel(it->second.second);
+      timers.erase(it);
+    }
+    // Most timers are near, but some of them should reach the last levels.
+    auto max_delay_us = RandomWithChance(10) ? kMaxDelayUs : 100000;
+    auto time = now + std::chrono::microseconds(RandomUniformInt<int64_t>(0, max_delay_us));
+    timers.emplace(i, std::make_pair(time, wheel.Insert(time, i)));
+
+    auto prev_now = now;
+    now += std::chrono::microseconds(RandomUniformInt(0, 20000));
+    wheel.Advance(now, std::bind(check_fired, prev_now, std::placeholders::_1));
+    ASSERT_EQ(timers.size(), wheel.size());
+    ASSERT_GT(wheel.NextAdvanceTime(), now);
+  }
+
+  auto prev_now = now;
+  now += std::chrono::microseconds(kMaxDelayUs) + kResolution;
+  wheel.Advance(now, std::bind(check_fired, prev_now, std::placeholders::_1));
+  ASSERT_TRUE(timers.empty());
+  ASSERT_TRUE(wheel.empty());
+}
+
+} // namespace yb
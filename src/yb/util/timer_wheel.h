@@ -0,0 +1,204 @@
+//
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+//
+
+#ifndef YB_UTIL_TIMER_WHEEL_H
+#define YB_UTIL_TIMER_WHEEL_H
+
+#include <array>
+#include <chrono>
+#include <list>
+#include <vector>
+
+#include <glog/logging.h>
+
+namespace yb {
+
+// Hierarchical timing wheel. Insertion and cancellation of a timer take constant time, that is
+// important for timers that are usually cancelled before they fire, like RPC timeouts.
+//
+// Time is split into ticks of the specified resolution. Timers of the near ticks are kept in the
+// slots of the first level, one slot per tick. Each next level has slots that are kSlotsPerLevel
+// times longer, their timers are moved to the lower levels when the wheel reaches their slot.
+// A timer fires when Advance processes its tick, i.e. not earlier than its time and at most one
+// tick later.
+//
+// Not thread safe.
+template <class Value, class Clock = std::chrono::steady_clock>
+class TimerWheel {
+ private:
+  struct Entry;
+  typedef std::list<Entry> Slot;
+
+ public:
+  typedef typename Clock::time_point TimePoint;
+  typedef typename Clock::duration Duration;
+
+  // Identifies inserted timer. Valid until the timer is fired or cancelled.
+  typedef typename Slot::iterator Handle;
+
+  explicit TimerWheel(Duration resolution, TimePoint start = Clock::now())
+      : resolution_(resolution), start_(start) {
+    CHECK_GT(resolution_.count(), 0);
+  }
+
+  TimerWheel(const TimerWheel&) = delete;
+  void operator=(const TimerWheel&) = delete;
+
+  Handle Insert(TimePoint time, Value value) {
+    auto tick = std::max(TimeToTick(time), current_tick_ + 1);
+    auto* slot = &SlotForTick(tick);
+    slot->push_back(Entry{tick, slot, std::move(value)});
+    ++size_;
+    return std::prev(slot->end());
+  }
+
+  // Removes the timer, returning its value.
+  Value Cancel(Handle handle) {
+    Value result = std::move(handle->value);
+    handle->slot->erase(handle);
+    --size_;
+    return result;
+  }
+
+  // Fires all timers whose ticks ended not later than now, invoking f with their values.
+  // f could insert and cancel timers.
+  template <class F>
+  void Advance(TimePoint now, const F& f) {
+    auto now_tick = TimeToTickFloor(now);
+    while (current_tick_ < now_tick) {
+      if (size_ == 0) {
+        current_tick_ = now_tick;
+        break;
+      }
+      ++current_tick_;
+      Cascade();
+      auto& slot = slots_[0][current_tick_ & kSlotMask];
+      while (!slot.empty()) {
+        auto it = slot.begin();
+        DCHECK_EQ(it->tick, current_tick_);
+        Value value = std::move(it->value);
+        slot.erase(it);
+        --size_;
+        f(std::move(value));
+      }
+    }
+  }
+
+  // Returns time when Advance should be invoked next. It is the end of the nearest non empty tick
+  // of the first level, or the end of the first level when it is empty, since timers of the next
+  // levels could move to the first level at that time.
+  // Returns TimePoint::max() when there are no timers.
+  TimePoint NextAdvanceTime() const {
+    if (size_ == 0) {
+      return TimePoint::max();
+    }
+    auto tick = current_tick_ + 1;
+    while ((tick & kSlotMask) != 0 && slots_[0][tick & kSlotMask].empty()) {
+      ++tick;
+    }
+    return start_ + resolution_ * tick;
+  }
+
+  // Removes all timers, returning their values.
+  std::vector<Value> TakeAll() {
+    std::vector<Value> result;
+    result.reserve(size_);
+    for (auto& level : slots_) {
+      for (auto& slot : level) {
+        for (auto& entry : slot) {
+          result.push_back(std::move(entry.value));
+        }
+        slot.clear();
+      }
+    }
+    size_ = 0;
+    return result;
+  }
+
+  size_t size() const { return size_; }
+  bool empty() const { return size_ == 0; }
+
+ private:
+  static constexpr size_t kBitsPerLevel = 8;
+  static constexpr size_t kSlotsPerLevel = 1 << kBitsPerLevel;
+  static constexpr uint64_t kSlotMask = kSlotsPerLevel - 1;
+  static constexpr size_t kLevels = 4;
+
+  struct Entry {
+    uint64_t tick;
+    Slot* slot;
+    Value value;
+  };
+
+  // Returns the first tick whose end is not earlier than time.
+  uint64_t TimeToTick(TimePoint time) const {
+    if (time <= start_) {
+      return 0;
+    }
+    return ((time - start_).count() + resolution_.count() - 1) / resolution_.count();
+  }
+
+  // Returns the last tick whose end is not later than time.
+  uint64_t TimeToTickFloor(TimePoint time) const {
+    if (time <= start_) {
+      return 0;
+    }
+    return (time - start_).count() / resolution_.count();
+  }
+
+  Slot& SlotForTick(uint64_t tick) {
+    for (size_t level = 0; level != kLevels; ++level) {
+      auto shift = kBitsPerLevel * (level + 1);
+      if ((tick >> shift) == (current_tick_ >> shift)) {
+        return slots_[level][(tick >> (shift - kBitsPerLevel)) & kSlotMask];
+      }
+    }
+    // The tick does not fit the wheel, so use the last level slot that would be reached last.
+    // The timer will be relocated when this slot is reached.
+    constexpr auto kLastLevelShift = kBitsPerLevel * (kLevels - 1);
+    return slots_[kLevels - 1][((current_tick_ >> kLastLevelShift) - 1) & kSlotMask];
+  }
+
+  void Relocate(Handle handle) {
+    auto* slot = &SlotForTick(handle->tick);
+    slot->splice(slot->end(), *handle->slot, handle);
+    handle->slot = slot;
+  }
+
+  // Moves timers of the slots reached by current tick to the lower levels, starting from the
+  // highest level.
+  void Cascade() {
+    for (size_t level = kLevels; --level > 0;) {
+      auto shift = kBitsPerLevel * level;
+      if ((current_tick_ & ((1ULL << shift) - 1)) != 0) {
+        continue;
+      }
+      auto& slot = slots_[level][(current_tick_ >> shift) & kSlotMask];
+      while (!slot.empty()) {
+        Relocate(slot.begin());
+      }
+    }
+  }
+
+  const Duration resolution_;
+  const TimePoint start_;
+  uint64_t current_tick_ = 0;
+  size_t size_ = 0;
+  std::array<std::array<Slot, kSlotsPerLevel>, kLevels> slots_;
+};
+
+} // namespace yb
+
+#endif // YB_UTIL_TIMER_WHEEL_H
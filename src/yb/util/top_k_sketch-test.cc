@@ -0,0 +1,73 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/util/top_k_sketch.h"
+
+#include <gtest/gtest.h>
+
+#include "yb/util/test_util.h"
+
+namespace yb {
+
+class TopKSketchTest : public YBTest {
+};
+
+TEST_F(TopKSketchTest, Exact) {
+  TopKSketch sketch(4);
+  sketch.Add("a", 3);
+  sketch.Add("b");
+  sketch.Add("c", 2);
+  sketch.Add("a");
+
+  auto top = sketch.TopK(2);
+  ASSERT_EQ(2, top.size());
+  ASSERT_EQ("a", top[0].key);
+  ASSERT_EQ(4, top[0].count);
+  ASSERT_EQ(0, top[0].error);
+  ASSERT_EQ("c", top[1].key);
+  ASSERT_EQ(2, top[1].count);
+  ASSERT_EQ(7, sketch.total());
+
+  sketch.Clear();
+  ASSERT_TRUE(sketch.TopK(2).empty());
+  ASSERT_EQ(0, sketch.total());
+}
+
+TEST_F(TopKSketchTest, HeavyHittersSurvive) {
+  TopKSketch sketch(8);
+  // Two hot keys among many keys that are seen once each.
+  for (int i = 0; i < 1000; ++i) {
+    sketch.Add(Format("cold_$0", i));
+    if (i % 2 == 0) {
+      sketch.Add("hot1");
+    }
+    if (i % 3 == 0) {
+      sketch.Add("hot2");
+    }
+  }
+
+  auto top = sketch.TopK(2);
+  ASSERT_EQ(2, top.size());
+  ASSERT_EQ("hot1", top[0].key);
+  ASSERT_EQ("hot2", top[1].key);
+  for (const auto& entry : top) {
+    // The true frequency is within [count - error, count].
+    ASSERT_LE(entry.error, entry.count);
+  }
+  ASSERT_GE(top[0].count, 500);
+  ASSERT_LE(top[0].count - top[0].error, 500);
+  ASSERT_GE(top[1].count, 334);
+  ASSERT_LE(top[1].count - top[1].error, 334);
+}
+
+} // namespace yb
@@ -0,0 +1,75 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/util/top_k_sketch.h"
+
+#include <algorithm>
+
+namespace yb {
+
+TopKSketch::TopKSketch(size_t capacity) : capacity_(std::max<size_t>(capacity, 1)) {
+  entries_.reserve(capacity_);
+}
+
+void TopKSketch::Add(const std::string& key, uint64_t count) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  total_ += count;
+  auto it = index_.find(key);
+  if (it != index_.end()) {
+    entries_[it->second].count += count;
+    return;
+  }
+  if (entries_.size() < capacity_) {
+    index_.emplace(key, entries_.size());
+    entries_.push_back(Entry{key, count, 0});
+    return;
+  }
+  auto min_it = std::min_element(
+      entries_.begin(), entries_.end(),
+      [](const Entry& lhs, const Entry& rhs) { return lhs.count < rhs.count; });
+  index_.erase(min_it->key);
+  index_.emplace(key, min_it - entries_.begin());
+  min_it->key = key;
+  min_it->error = min_it->count;
+  min_it->count += count;
+}
+
+std::vector<TopKSketch::Entry> TopKSketch::TopK(size_t k) const {
+  std::vector<Entry> result;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    result = entries_;
+  }
+  auto by_count = [](const Entry& lhs, const Entry& rhs) { return lhs.count > rhs.count; };
+  if (result.size() > k) {
+    std::partial_sort(result.begin(), result.begin() + k, result.end(), by_count);
+    result.resize(k);
+  } else {
+    std::sort(result.begin(), result.end(), by_count);
+  }
+  return result;
+}
+
+uint64_t TopKSketch::total() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return total_;
+}
+
+void TopKSketch::Clear() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  entries_.clear();
+  index_.clear();
+  total_ = 0;
+}
+
+} // namespace yb
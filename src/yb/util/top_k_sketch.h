@@ -0,0 +1,65 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#ifndef YB_UTIL_TOP_K_SKETCH_H
+#define YB_UTIL_TOP_K_SKETCH_H
+
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace yb {
+
+// Space-saving sketch of the most frequent keys in a stream (Metwally et al., "Efficient
+// Computation of Frequent and Top-k Elements in Data Streams").
+//
+// At most capacity keys are tracked. A key that is not tracked when the sketch is full replaces
+// the key with the smallest count and inherits that count as its error, so the count of a tracked
+// key overestimates its true frequency by at most error. Any key whose frequency is higher than
+// total() / capacity is guaranteed to be tracked. Thread-safe.
+class TopKSketch {
+ public:
+  struct Entry {
+    std::string key;
+    uint64_t count = 0;
+    uint64_t error = 0;
+  };
+
+  explicit TopKSketch(size_t capacity);
+
+  void Add(const std::string& key, uint64_t count = 1);
+
+  // Returns up to k tracked keys with the largest counts, most frequent first.
+  std::vector<Entry> TopK(size_t k) const;
+
+  // Total count of all keys added since the sketch was created or cleared.
+  uint64_t total() const;
+
+  void Clear();
+
+ private:
+  const size_t capacity_;
+
+  mutable std::mutex mutex_;
+  // Entries are only replaced in place once the sketch is full, so indexes stored in index_ stay
+  // valid. The entry with the smallest count is found by a linear scan, which is cheap for the
+  // small capacities sketches are used with.
+  std::vector<Entry> entries_;
+  std::unordered_map<std::string, size_t> index_;
+  uint64_t total_ = 0;
+};
+
+} // namespace yb
+
+#endif // YB_UTIL_TOP_K_SKETCH_H
@@ -121,6 +121,58 @@ TEST_F(TraceTest, TestChildTrace) {
             XOutDigits(traceA->DumpToString(false)));
 }
 
+TEST_F(TraceTest, TestSampled) {
+  FLAGS_enable_tracing = false;
+  scoped_refptr<Trace> sampled(new Trace);
+  scoped_refptr<Trace> child(new Trace);
+  scoped_refptr<Trace> unsampled(new Trace);
+  sampled->set_sampled();
+  {
+    ADOPT_TRACE(unsampled.get());
+    EXPECT_TRUE(Trace::CurrentTrace() == nullptr);
+    TRACE("this goes nowhere");
+  }
+  {
+    ADOPT_TRACE(sampled.get());
+    EXPECT_EQ(sampled.get(), Trace::CurrentTrace());
+    sampled->AddChildTrace(child.get());
+    TRACE("hello from sampled");
+  }
+  EXPECT_TRUE(child->sampled());
+  TRACE_TO(child, "hello from child");
+  TRACE_TO(unsampled, "this goes nowhere");
+
+  EXPECT_EQ("", unsampled->DumpToString(false));
+  EXPECT_EQ("XXXX XX:XX:XX.XXXXXX trace-test.cc:XXX] hello from sampled\n"
+            "Related trace:\n"
+            "XXXX XX:XX:XX.XXXXXX trace-test.cc:XXX] hello from child\n",
+            XOutDigits(sampled->DumpToString(false)));
+
+  RecordSampledTrace("first", *sampled);
+  RecordSampledTrace("second", *sampled);
+  auto recent = RecentSampledTraces();
+  ASSERT_GE(recent.size(), 2);
+  EXPECT_EQ("second", recent[0]->description);
+  EXPECT_EQ("first", recent[1]->description);
+  EXPECT_EQ(sampled->DumpToString(true), recent[0]->trace);
+}
+
+TEST_F(TraceTest, TestShouldSample) {
+  FLAGS_trace_sampling_one_in = 0;
+  EXPECT_FALSE(Trace::ShouldSample());
+  FLAGS_trace_sampling_one_in = 1;
+  EXPECT_TRUE(Trace::ShouldSample());
+  EXPECT_TRUE(Trace::ShouldSample());
+
+  FLAGS_trace_sampling_one_in = 100;
+  int sampled = 0;
+  for (int i = 0; i != 100000; ++i) {
+    sampled += Trace::ShouldSample();
+  }
+  EXPECT_GT(sampled, 500);
+  EXPECT_LT(sampled, 2000);
+}
+
 static void GenerateTraceEvents(int thread_id,
                                 int num_events) {
   for (int i = 0; i < num_events; i++) {
@@ -32,6 +32,7 @@
 
 #include "yb/util/trace.h"
 
+#include <algorithm>
 #include <iomanip>
 #include <ios>
 #include <iostream>
@@ -45,13 +46,22 @@
 #include "yb/gutil/strings/substitute.h"
 #include "yb/gutil/walltime.h"
 
+#include "yb/util/flag_tags.h"
 #include "yb/util/memory/arena.h"
 #include "yb/util/memory/memory.h"
 #include "yb/util/object_pool.h"
+#include "yb/util/random_util.h"
 #include "yb/util/size_literals.h"
 
 DEFINE_bool(enable_tracing, false, "Flag to enable/disable tracing across the code.");
 
+DEFINE_int32(trace_sampling_one_in, 1000,
+             "Requests that enter the cluster are traced with probability of one in this number, "
+             "even if tracing is disabled. Latest sampled traces are shown at /tracing/sampled. "
+             "0 disables sampling.");
+TAG_FLAG(trace_sampling_one_in, advanced);
+TAG_FLAG(trace_sampling_one_in, runtime);
+
 namespace yb {
 
 using strings::internal::SubstituteArg;
@@ -60,6 +70,43 @@ __thread Trace* Trace::threadlocal_trace_;
 
 namespace {
 
+const size_t kSampledTracesCapacity = 128;
+
+// Ring buffer of the latest sampled traces. Writers only take the next slot with an atomic
+// increment, so they never wait for each other except for wrapping onto the same slot.
+class SampledTraces {
+ public:
+  void Record(std::shared_ptr<const SampledTrace> trace) {
+    auto idx = next_.fetch_add(1, std::memory_order_acq_rel) % kSampledTracesCapacity;
+    std::atomic_store(&slots_[idx], std::move(trace));
+  }
+
+  std::vector<std::shared_ptr<const SampledTrace>> Recent() {
+    std::vector<std::shared_ptr<const SampledTrace>> result;
+    const size_t next = next_.load(std::memory_order_acquire);
+    for (size_t i = 1; i <= std::min(next, kSampledTracesCapacity); ++i) {
+      auto trace = std::atomic_load(&slots_[(next - i) % kSampledTracesCapacity]);
+      if (trace) {
+        result.push_back(std::move(trace));
+      }
+    }
+    return result;
+  }
+
+ private:
+  std::atomic<size_t> next_{0};
+  std::shared_ptr<const SampledTrace> slots_[kSampledTracesCapacity];
+};
+
+SampledTraces& GetSampledTraces() {
+  static SampledTraces result;
+  return result;
+}
+
+// Number of requests left before the next sampled one on this thread. Randomized around the
+// sampling rate, so requests with a periodic pattern are not sampled at the same point.
+__thread int64_t requests_before_sample = 0;
+
 // Get the part of filepath after the last path separator.
 // (Doesn't modify filepath, contrary to basename() in libgen.h.)
 // Borrowed from glog.
@@ -159,7 +206,7 @@ int64_t GetCurrentMicrosFast(MonoTime now) {
 } // namespace
 
 ScopedAdoptTrace::ScopedAdoptTrace(Trace* t)
-    : old_trace_(Trace::threadlocal_trace_), is_enabled_(GetAtomicFlag(&FLAGS_enable_tracing)) {
+    : old_trace_(Trace::threadlocal_trace_), is_enabled_(TracingEnabled(t)) {
   if (is_enabled_) {
     trace_ = t;
     Trace::threadlocal_trace_ = t;
@@ -349,8 +396,22 @@ void Trace::DumpCurrentTrace() {
   t->Dump(&std::cerr, true);
 }
 
+bool Trace::ShouldSample() {
+  const auto one_in = GetAtomicFlag(&FLAGS_trace_sampling_one_in);
+  if (one_in <= 0) {
+    return false;
+  }
+  if (requests_before_sample <= 0) {
+    requests_before_sample = RandomUniformInt<int64_t>(1, 2 * static_cast<int64_t>(one_in) - 1);
+  }
+  return --requests_before_sample == 0;
+}
+
 void Trace::AddChildTrace(Trace* child_trace) {
   CHECK_NOTNULL(child_trace);
+  if (sampled()) {
+    child_trace->set_sampled();
+  }
   {
     std::lock_guard<simple_spinlock> l(lock_);
     scoped_refptr<Trace> ptr(child_trace);
@@ -359,6 +420,18 @@ void Trace::AddChildTrace(Trace* child_trace) {
   CHECK(!child_trace->HasOneRef());
 }
 
+void RecordSampledTrace(std::string description, const Trace& trace) {
+  auto sampled_trace = std::make_shared<SampledTrace>();
+  sampled_trace->time = MonoTime::Now();
+  sampled_trace->description = std::move(description);
+  sampled_trace->trace = trace.DumpToString(true);
+  GetSampledTraces().Record(std::move(sampled_trace));
+}
+
+std::vector<std::shared_ptr<const SampledTrace>> RecentSampledTraces() {
+  return GetSampledTraces().Recent();
+}
+
 PlainTrace::PlainTrace() {
 }
 
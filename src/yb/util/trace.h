@@ -34,6 +34,7 @@
 
 #include <atomic>
 #include <iosfwd>
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -49,8 +50,10 @@
 #include "yb/util/atomic.h"
 #include "yb/util/locks.h"
 #include "yb/util/memory/arena_fwd.h"
+#include "yb/util/monotime.h"
 
 DECLARE_bool(enable_tracing);
+DECLARE_int32(trace_sampling_one_in);
 
 // Adopt a Trace on the current thread for the duration of the current
 // scope. The old current Trace is restored when the scope is exited.
@@ -62,21 +65,22 @@ DECLARE_bool(enable_tracing);
 // See Trace::SubstituteAndTrace for arguments.
 // Example:
 //  TRACE("Acquired timestamp $0", timestamp);
+//
+// A trace is adopted by the thread only when tracing is enabled or the trace is sampled, so there
+// is nothing else to check.
 #define TRACE(format, substitutions...) \
   do { \
-    if (GetAtomicFlag(&FLAGS_enable_tracing)) { \
-      yb::Trace* _trace = Trace::CurrentTrace(); \
-      if (_trace) { \
-        _trace->SubstituteAndTrace(__FILE__, __LINE__, MonoTime::Now(), (format),  \
-          ##substitutions); \
-      } \
+    yb::Trace* _trace = Trace::CurrentTrace(); \
+    if (_trace) { \
+      _trace->SubstituteAndTrace(__FILE__, __LINE__, MonoTime::Now(), (format),  \
+        ##substitutions); \
     } \
   } while (0)
 
 // Like the above, but takes the trace pointer as an explicit argument.
 #define TRACE_TO(trace, format, substitutions...) \
   do { \
-    if (GetAtomicFlag(&FLAGS_enable_tracing)) { \
+    if (yb::TracingEnabled(trace)) { \
       (trace)->SubstituteAndTrace( \
           __FILE__, __LINE__, MonoTime::Now(), (format), ##substitutions); \
     } \
@@ -85,7 +89,7 @@ DECLARE_bool(enable_tracing);
 // Like the above, but takes the trace pointer as an explicit argument.
 #define TRACE_TO_WITH_TIME(trace, time, format, substitutions...) \
   do { \
-    if (GetAtomicFlag(&FLAGS_enable_tracing)) { \
+    if (yb::TracingEnabled(trace)) { \
       (trace)->SubstituteAndTrace( \
           __FILE__, __LINE__, (time), (format), ##substitutions); \
     } \
@@ -93,7 +97,7 @@ DECLARE_bool(enable_tracing);
 
 #define PLAIN_TRACE_TO(trace, message) \
   do { \
-    if (GetAtomicFlag(&FLAGS_enable_tracing)) { \
+    if (yb::TracingEnabled(trace)) { \
       (trace)->Trace(__FILE__, __LINE__, (message)); \
     } \
   } while (0)
@@ -154,8 +158,24 @@ class Trace : public RefCountedThreadSafe<Trace> {
   std::string DumpToString(bool include_time_deltas) const;
 
   // Attaches the given trace which will get appended at the end when Dumping.
+  // The child is sampled if this trace is sampled.
   void AddChildTrace(Trace* child_trace);
 
+  // A sampled trace collects its entries even when tracing is disabled, so a small share of the
+  // requests is always traced. Sampling is decided once at the head of the request, and passed to
+  // the related traces on this and the other servers.
+  bool sampled() const {
+    return sampled_.load(std::memory_order_relaxed);
+  }
+
+  void set_sampled() {
+    sampled_.store(true, std::memory_order_relaxed);
+  }
+
+  // Returns true for about one in FLAGS_trace_sampling_one_in invocations, should be used to decide
+  // whether a request that enters the cluster is sampled.
+  static bool ShouldSample();
+
   // Return the current trace attached to this thread, if there is one.
   static Trace* CurrentTrace() {
     return threadlocal_trace_;
@@ -198,13 +218,34 @@ class Trace : public RefCountedThreadSafe<Trace> {
 
   std::vector<scoped_refptr<Trace> > child_traces_;
 
+  std::atomic<bool> sampled_{false};
+
   DISALLOW_COPY_AND_ASSIGN(Trace);
 };
 
 typedef scoped_refptr<Trace> TracePtr;
 
+// Whether entries should be added to the trace, which could be a raw or a ref counted pointer.
+template <class TracePointer>
+bool TracingEnabled(const TracePointer& trace) {
+  return GetAtomicFlag(&FLAGS_enable_tracing) || (trace && trace->sampled());
+}
+
+struct SampledTrace {
+  MonoTime time;
+  std::string description;
+  std::string trace;
+};
+
+// Records the dump of the completed sampled trace of a request, so it could be shown in the web UI.
+// Only the latest sampled traces are kept.
+void RecordSampledTrace(std::string description, const Trace& trace);
+
+// Returns the recorded sampled traces, the latest first.
+std::vector<std::shared_ptr<const SampledTrace>> RecentSampledTraces();
+
 // Adopt a Trace object into the current thread for the duration
-// of this object.
+// of this object, when tracing is enabled or the trace is sampled.
 // This should only be used on the stack (and thus created and destroyed
 // on the same thread)
 class ScopedAdoptTrace {
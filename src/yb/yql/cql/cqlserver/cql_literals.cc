@@ -0,0 +1,289 @@
+//--------------------------------------------------------------------------------------------------
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+//--------------------------------------------------------------------------------------------------
+
+#include "yb/yql/cql/cqlserver/cql_literals.h"
+
+#include <cstring>
+#include <limits>
+
+#include "yb/gutil/strings/numbers.h"
+
+#include "yb/yql/cql/ql/ptree/pt_dml.h"
+
+namespace yb {
+namespace cqlserver {
+
+using std::string;
+
+namespace {
+
+bool IsIdentifierStart(char c) {
+  return isalpha(c) || c == '_';
+}
+
+bool IsIdentifierChar(char c) {
+  return isalnum(c) || c == '_';
+}
+
+// Checks whether the first word of the query is the keyword of a DML statement.
+bool IsDml(const string& query) {
+  size_t begin = 0;
+  while (begin < query.size() && isspace(query[begin])) {
+    ++begin;
+  }
+  size_t end = begin;
+  while (end < query.size() && IsIdentifierChar(query[end])) {
+    ++end;
+  }
+  const auto length = end - begin;
+  for (const char* keyword : {"select", "insert", "update", "delete"}) {
+    if (length == strlen(keyword) && strncasecmp(query.c_str() + begin, keyword, length) == 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
+template <class T>
+bool SetInteger(const string& text, QLValue* value, void (QLValue::*setter)(T)) {
+  int64 result;
+  if (!safe_strto64(text, &result) ||
+      result < std::numeric_limits<T>::min() || result > std::numeric_limits<T>::max()) {
+    return false;
+  }
+  (value->*setter)(static_cast<T>(result));
+  return true;
+}
+
+bool SetReal(const string& text, DataType type, QLValue* value) {
+  double result;
+  if (!safe_strtod(text, &result)) {
+    return false;
+  }
+  if (type == DataType::FLOAT) {
+    value->set_float_value(static_cast<float>(result));
+  } else {
+    value->set_double_value(result);
+  }
+  return true;
+}
+
+// Converts literal to the value of the specified type. Only conversions that are exactly the same
+// as the ones done for constants of the original query are supported.
+bool ConvertLiteral(const CQLLiteral& literal, DataType type, QLValue* value) {
+  switch (literal.kind) {
+    case CQLLiteral::Kind::kString:
+      if (type != DataType::STRING) {
+        return false;
+      }
+      value->set_string_value(literal.value);
+      return true;
+    case CQLLiteral::Kind::kInteger:
+      switch (type) {
+        case DataType::INT8:
+          return SetInteger<int8_t>(literal.value, value, &QLValue::set_int8_value);
+        case DataType::INT16:
+          return SetInteger<int16_t>(literal.value, value, &QLValue::set_int16_value);
+        case DataType::INT32:
+          return SetInteger<int32_t>(literal.value, value, &QLValue::set_int32_value);
+        case DataType::INT64:
+          return SetInteger<int64_t>(literal.value, value, &QLValue::set_int64_value);
+        case DataType::FLOAT: FALLTHROUGH_INTENDED;
+        case DataType::DOUBLE:
+          return SetReal(literal.value, type, value);
+        default:
+          return false;
+      }
+    case CQLLiteral::Kind::kReal:
+      if (type != DataType::FLOAT && type != DataType::DOUBLE) {
+        return false;
+      }
+      return SetReal(literal.value, type, value);
+  }
+  return false;
+}
+
+} // namespace
+
+bool NormalizeLiterals(const string& query, string* normalized, CQLLiterals* literals) {
+  if (!IsDml(query)) {
+    return false;
+  }
+
+  normalized->clear();
+  normalized->reserve(query.size());
+  literals->clear();
+
+  const size_t size = query.size();
+  // Last non space character of the normalized query, used to tell a sign of a number from a
+  // binary minus.
+  char prev = 0;
+  size_t i = 0;
+  while (i < size) {
+    const char c = query[i];
+    const char next = i + 1 < size ? query[i + 1] : 0;
+
+    // Keywords and identifiers are kept as is.
+    if (IsIdentifierStart(c)) {
+      const size_t begin = i;
+      while (i < size && IsIdentifierChar(query[i])) {
+        ++i;
+      }
+      normalized->append(query, begin, i - begin);
+      prev = query[i - 1];
+      continue;
+    }
+
+    // Quoted identifiers are kept as is, "" is an escaped quote.
+    if (c == '"') {
+      const size_t begin = i++;
+      for (;;) {
+        if (i >= size) {
+          return false;
+        }
+        if (query[i++] == '"') {
+          if (i < size && query[i] == '"') {
+            ++i;
+            continue;
+          }
+          break;
+        }
+      }
+      normalized->append(query, begin, i - begin);
+      prev = '"';
+      continue;
+    }
+
+    // String literal, '' is an escaped quote.
+    if (c == '\'') {
+      string value;
+      ++i;
+      for (;;) {
+        if (i >= size) {
+          return false;
+        }
+        if (query[i] == '\'') {
+          if (i + 1 < size && query[i + 1] == '\'') {
+            value.push_back('\'');
+            i += 2;
+            continue;
+          }
+          ++i;
+          break;
+        }
+        value.push_back(query[i++]);
+      }
+      literals->push_back(CQLLiteral{CQLLiteral::Kind::kString, std::move(value)});
+      normalized->push_back('?');
+      prev = '?';
+      continue;
+    }
+
+    // Number literal. Minus is a part of it when it could not be a binary operator.
+    const bool negative = c == '-' && isdigit(next) && prev != 0 && strchr("(,=<>[{", prev);
+    if (isdigit(c) || negative) {
+      const size_t begin = i;
+      auto kind = CQLLiteral::Kind::kInteger;
+      i += negative ? 1 : 0;
+      while (i < size && isdigit(query[i])) {
+        ++i;
+      }
+      if (i + 1 < size && query[i] == '.' && isdigit(query[i + 1])) {
+        kind = CQLLiteral::Kind::kReal;
+        for (++i; i < size && isdigit(query[i]); ++i) {}
+      }
+      if (i < size && (query[i] == 'e' || query[i] == 'E')) {
+        size_t exp = i + 1;
+        if (exp < size && (query[exp] == '+' || query[exp] == '-')) {
+          ++exp;
+        }
+        if (exp < size && isdigit(query[exp])) {
+          kind = CQLLiteral::Kind::kReal;
+          for (i = exp; i < size && isdigit(query[i]); ++i) {}
+        }
+      }
+      // Blobs, uuids, durations and other literals starting with a digit are not normalized.
+      if (i < size && (IsIdentifierChar(query[i]) || query[i] == '-' || query[i] == '.')) {
+        return false;
+      }
+      literals->push_back(CQLLiteral{kind, query.substr(begin, i - begin)});
+      normalized->push_back('?');
+      prev = '?';
+      continue;
+    }
+
+    // Bind markers, named bind markers or map literals, dollar quoted strings and comments.
+    if (c == '?' || c == ':' || c == '$' || (c == '-' && next == '-') ||
+        (c == '/' && (next == '/' || next == '*'))) {
+      return false;
+    }
+
+    normalized->push_back(c);
+    if (!isspace(c)) {
+      prev = c;
+    }
+    ++i;
+  }
+  return true;
+}
+
+CQLLiteralParameters::CQLLiteralParameters(const CQLMessage::QueryParameters& params)
+    : CQLMessage::QueryParameters(params) {
+}
+
+bool CQLLiteralParameters::Bind(const ql::ParseTree& parse_tree, const CQLLiterals& literals) {
+  const auto* root = parse_tree.root().get();
+  if (root == nullptr) {
+    return false;
+  }
+  switch (root->opcode()) {
+    case ql::TreeNodeOpcode::kPTSelectStmt: FALLTHROUGH_INTENDED;
+    case ql::TreeNodeOpcode::kPTInsertStmt: FALLTHROUGH_INTENDED;
+    case ql::TreeNodeOpcode::kPTUpdateStmt: FALLTHROUGH_INTENDED;
+    case ql::TreeNodeOpcode::kPTDeleteStmt:
+      break;
+    default:
+      return false;
+  }
+
+  const auto& bind_variables = static_cast<const ql::PTDmlStmt*>(root)->bind_variables();
+  if (bind_variables.size() != literals.size()) {
+    return false;
+  }
+  literal_values_.clear();
+  literal_values_.resize(literals.size());
+  for (const auto* var : bind_variables) {
+    const auto pos = var->pos();
+    if (pos < 0 || pos >= literals.size() ||
+        !ConvertLiteral(literals[pos], var->ql_type()->main(), &literal_values_[pos])) {
+      return false;
+    }
+  }
+  return true;
+}
+
+Status CQLLiteralParameters::GetBindVariable(const std::string& name,
+                                             int64_t pos,
+                                             const std::shared_ptr<QLType>& type,
+                                             QLValue* value) const {
+  if (pos < 0 || pos >= literal_values_.size()) {
+    return STATUS_SUBSTITUTE(RuntimeError, "Literal for bind variable $0 not found", pos);
+  }
+  *value = literal_values_[pos];
+  return Status::OK();
+}
+
+}  // namespace cqlserver
+}  // namespace yb
@@ -0,0 +1,75 @@
+//--------------------------------------------------------------------------------------------------
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+//
+// This module normalizes non-prepared CQL queries with literal values inlined, so the parse trees
+// of such queries could be cached like prepared statements. Literals are replaced by bind markers
+// and bound to the bind variables of the cached statement at execution time.
+//--------------------------------------------------------------------------------------------------
+
+#ifndef YB_YQL_CQL_CQLSERVER_CQL_LITERALS_H_
+#define YB_YQL_CQL_CQLSERVER_CQL_LITERALS_H_
+
+#include <string>
+#include <vector>
+
+#include "yb/yql/cql/cqlserver/cql_message.h"
+#include "yb/yql/cql/ql/ptree/parse_tree.h"
+
+namespace yb {
+namespace cqlserver {
+
+// Literal value extracted from the text of a query.
+struct CQLLiteral {
+  enum class Kind {
+    kString,   // Quoted string, value is unescaped.
+    kInteger,  // Integer number with optional sign.
+    kReal,     // Number with decimal point or exponent.
+  };
+
+  Kind kind;
+  std::string value;
+};
+
+typedef std::vector<CQLLiteral> CQLLiterals;
+
+// Replaces string and numeric literals of a SELECT, INSERT, UPDATE or DELETE query with "?" bind
+// markers, appending the literals to "literals" in the order of their appearance. Returns false
+// when the query has no such form, e.g. it is not a DML, already has bind markers, comments or
+// literals of other kinds, like blobs or uuids.
+bool NormalizeLiterals(const std::string& query, std::string* normalized, CQLLiterals* literals);
+
+// Parameters of a query with literals replaced by bind markers. The literals are bound by the
+// position of the bind markers, while the rest of parameters are copied from the original query.
+class CQLLiteralParameters : public CQLMessage::QueryParameters {
+ public:
+  explicit CQLLiteralParameters(const CQLMessage::QueryParameters& params);
+
+  // Converts literals to the types of the bind variables of the normalized statement. Returns
+  // false when the statement is not a DML or some literal does not map to its bind variable
+  // exactly, so the original query should be executed instead.
+  bool Bind(const ql::ParseTree& parse_tree, const CQLLiterals& literals);
+
+  CHECKED_STATUS GetBindVariable(const std::string& name,
+                                 int64_t pos,
+                                 const std::shared_ptr<QLType>& type,
+                                 QLValue* value) const override;
+
+ private:
+  std::vector<QLValue> literal_values_;
+};
+
+}  // namespace cqlserver
+}  // namespace yb
+
+#endif  // YB_YQL_CQL_CQLSERVER_CQL_LITERALS_H_
@@ -15,6 +15,8 @@
 
 #include "yb/yql/cql/cqlserver/cql_processor.h"
 
+#include "yb/common/ql_rowblock.h"
+
 #include "yb/gutil/strings/escaping.h"
 
 #include "yb/rpc/connection.h"
@@ -22,8 +24,10 @@
 #include "yb/rpc/rpc_context.h"
 
 #include "yb/util/crypt.h"
+#include "yb/util/flag_tags.h"
 
 #include "yb/yql/cql/cqlserver/cql_service.h"
+#include "yb/yql/cql/cqlserver/cql_statement_stats.h"
 
 METRIC_DEFINE_histogram(
     server, handler_latency_yb_cqlserver_CQLServerService_GetProcessor,
@@ -69,6 +73,13 @@ METRIC_DEFINE_counter(server, cql_processors_created,
                       yb::MetricUnit::kUnits,
                       "Number of created CQL Processors.");
 
+DEFINE_bool(cql_normalize_query_literals, true,
+            "Replace literals of non-prepared DML queries with bind markers, so their parse trees "
+            "are cached together with the prepared statements and reused by queries that differ "
+            "in literal values only.");
+TAG_FLAG(cql_normalize_query_literals, advanced);
+TAG_FLAG(cql_normalize_query_literals, runtime);
+
 DECLARE_bool(use_cassandra_authentication);
 
 namespace yb {
@@ -186,7 +197,7 @@ void CQLProcessor::SendResponse(const CQLResponse& response) {
   const auto compression_scheme = context.compression_scheme();
   faststring msg;
   response.Serialize(compression_scheme, &msg);
-  call_->RespondSuccess(RefCntBuffer(msg), cql_metrics_->rpc_method_metrics_);
+  call_->RespondSuccess(RefCntBuffer(std::move(msg)), cql_metrics_->rpc_method_metrics_);
 
   MonoTime response_done = MonoTime::Now();
   cql_metrics_->time_to_process_request_->Increment(
@@ -203,6 +214,9 @@ void CQLProcessor::SendResponse(const CQLResponse& response) {
   request_ = nullptr;
   stmts_.clear();
   parse_trees_.clear();
+  normalized_stmt_ = nullptr;
+  literal_params_ = nullptr;
+  sampled_query_ = nullptr;
   SetCurrentSession(nullptr);
   service_impl_->ReturnProcessor(pos_);
 }
@@ -304,27 +318,97 @@ CQLResponse* CQLProcessor::ProcessRequest(const ExecuteRequest& req) {
   if (stmt == nullptr) {
     return ProcessError(ErrorStatus(ErrorCode::UNPREPARED_STATEMENT), req.query_id());
   }
+  if (CQLStatementStats::ShouldSample()) {
+    sampled_query_ = &stmt->text();
+  }
   const Status s = stmt->ExecuteAsync(this, req.params(), statement_executed_cb_);
   return s.ok() ? nullptr : ProcessError(s, stmt->query_id());
 }
 
 CQLResponse* CQLProcessor::ProcessRequest(const QueryRequest& req) {
   VLOG(1) << "QUERY " << req.query();
+  const bool sampled = CQLStatementStats::ShouldSample();
+  if (FLAGS_cql_normalize_query_literals && req.params().values.empty() &&
+      ExecuteNormalizedQuery(req)) {
+    // Executions with different literals are tracked together by the normalized text.
+    if (sampled) {
+      sampled_query_ = &normalized_stmt_->text();
+    }
+    return nullptr;
+  }
+  if (sampled) {
+    sampled_query_ = &req.query();
+  }
   RunAsync(req.query(), req.params(), statement_executed_cb_);
   return nullptr;
 }
 
+bool CQLProcessor::ExecuteNormalizedQuery(const QueryRequest& req) {
+  string normalized;
+  CQLLiterals literals;
+  if (!NormalizeLiterals(req.query(), &normalized, &literals)) {
+    return false;
+  }
+
+  // The normalized statement is cached as a prepared statement, so it is shared with the clients
+  // that prepared the same text explicitly and is accounted in the same memory tracker.
+  const string& keyspace = ql_env_.CurrentKeyspace();
+  const CQLMessage::QueryId query_id = CQLStatement::GetQueryId(keyspace, normalized);
+  shared_ptr<const CQLStatement> stmt = service_impl_->GetPreparedStatement(query_id);
+  if (stmt == nullptr) {
+    shared_ptr<CQLStatement> new_stmt = service_impl_->AllocatePreparedStatement(
+        query_id, keyspace, normalized);
+    const Status s = new_stmt->Prepare(this, service_impl_->prepared_stmts_mem_tracker());
+    if (!s.ok()) {
+      // Literals could be at the places where bind markers are not allowed, so let the original
+      // query report its own error, if any.
+      VLOG(2) << "Failed to prepare normalized query " << normalized << ": " << s;
+      service_impl_->DeletePreparedStatement(new_stmt);
+      return false;
+    }
+    stmt = std::move(new_stmt);
+  }
+
+  const Result<const ParseTree&> parse_tree = stmt->GetParseTree();
+  if (!parse_tree) {
+    return false;
+  }
+  auto params = std::make_unique<CQLLiteralParameters>(req.params());
+  if (!params->Bind(*parse_tree, literals)) {
+    return false;
+  }
+
+  // The statement is not added to stmts_, since the client does not know its query id. When it
+  // turns out to be stale, the request is retried and the statement is prepared again.
+  stmt->clear_reparsed();
+  normalized_stmt_ = std::move(stmt);
+  literal_params_ = std::move(params);
+  ExecuteAsync(*parse_tree, *literal_params_, statement_executed_cb_);
+  return true;
+}
+
 CQLResponse* CQLProcessor::ProcessRequest(const BatchRequest& req) {
   VLOG(1) << "BATCH " << req.queries().size();
 
   StatementBatch batch;
   batch.reserve(req.queries().size());
 
+  // Batches usually repeat the same query with different parameters, so reuse the parse tree of
+  // the non-prepared query that was already prepared in this batch, and of the prepared statement
+  // that was already looked up. Bulk loads send thousands of rows of one prepared INSERT in a batch.
+  std::unordered_map<std::string, const ParseTree*> prepared_queries;
+  std::unordered_map<CQLMessage::QueryId, const ParseTree*> prepared_statements;
+
   // For each query in the batch, look up the query id if it is a prepared statement, or prepare the
   // query if it is not prepared. Then execute the parse trees with the parameters.
   for (const BatchRequest::Query& query : req.queries()) {
     if (query.is_prepared) {
       VLOG(1) << "BATCH EXECUTE " << b2a_hex(query.query_id);
+      const auto it = prepared_statements.find(query.query_id);
+      if (it != prepared_statements.end()) {
+        batch.emplace_back(*it->second, query.params);
+        continue;
+      }
       const shared_ptr<const CQLStatement> stmt = GetPreparedStatement(query.query_id);
       if (stmt == nullptr) {
         return ProcessError(ErrorStatus(ErrorCode::UNPREPARED_STATEMENT), query.query_id);
@@ -334,14 +418,21 @@ CQLResponse* CQLProcessor::ProcessRequest(const BatchRequest& req) {
         return ProcessError(parse_tree.status(), query.query_id);
       }
       batch.emplace_back(*parse_tree, query.params);
+      prepared_statements.emplace(query.query_id, &*parse_tree);
     } else {
       VLOG(1) << "BATCH QUERY " << query.query;
+      const auto it = prepared_queries.find(query.query);
+      if (it != prepared_queries.end()) {
+        batch.emplace_back(*it->second, query.params);
+        continue;
+      }
       ParseTree::UniPtr parse_tree;
       const Status s = Prepare(query.query, &parse_tree);
       if (PREDICT_FALSE(!s.ok())) {
         return ProcessError(s);
       }
       batch.emplace_back(*parse_tree, query.params);
+      prepared_queries.emplace(query.query, parse_tree.get());
       parse_trees_.insert(std::move(parse_tree));
     }
   }
@@ -382,6 +473,18 @@ shared_ptr<const CQLStatement> CQLProcessor::GetPreparedStatement(const CQLMessa
 }
 
 void CQLProcessor::StatementExecuted(const Status& s, const ExecutedResult::SharedPtr& result) {
+  if (sampled_query_ != nullptr) {
+    size_t rows = 0;
+    if (result != nullptr && result->type() == ExecutedResult::Type::ROWS) {
+      const auto& rows_result = std::static_pointer_cast<RowsResult>(result);
+      const auto row_count = QLRowBlock::GetRowCount(rows_result->client(),
+                                                     rows_result->rows_data());
+      rows = row_count.ok() ? *row_count : 0;
+    }
+    service_impl_->statement_stats()->Record(
+        *sampled_query_, MonoTime::Now().GetDeltaSince(execute_begin_), rows, !s.ok());
+    sampled_query_ = nullptr;
+  }
   unique_ptr<CQLResponse> response(s.ok() ? ProcessResult(result) : ProcessError(s));
   if (response) {
     SendResponse(*response);
@@ -412,9 +515,13 @@ CQLResponse* CQLProcessor::ProcessError(const Status& s,
       // (non-prepared statements). In that case, just retry the request (once only). The retry
       // needs to be rescheduled in because this callback may not be executed in the RPC worker
       // thread. Also, rescheduling gives other calls a chance to execute first before we do.
+      if (normalized_stmt_ != nullptr && normalized_stmt_->stale()) {
+        service_impl_->DeletePreparedStatement(normalized_stmt_);
+      }
       if (++retry_count_ == 1) {
         stmts_.clear();
         parse_trees_.clear();
+        normalized_stmt_ = nullptr;
         Reschedule(&process_request_task_.Bind(this));
         return nullptr;
       }
@@ -22,6 +22,7 @@
 
 #include "yb/rpc/service_if.h"
 
+#include "yb/yql/cql/cqlserver/cql_literals.h"
 #include "yb/yql/cql/cqlserver/cql_message.h"
 #include "yb/yql/cql/cqlserver/cql_rpc.h"
 #include "yb/yql/cql/cqlserver/cql_statement.h"
@@ -85,6 +86,10 @@ class CQLProcessor : public ql::QLProcessor {
   CQLResponse* ProcessRequest(const AuthResponseRequest& req);
   CQLResponse* ProcessRequest(const RegisterRequest& req);
 
+  // Executes a non-prepared query using the cached statement with its literals replaced by bind
+  // markers. Returns false when the query could not be executed this way.
+  bool ExecuteNormalizedQuery(const QueryRequest& req);
+
   // Get a prepared statement and adds it to the set of statements currently being executed.
   std::shared_ptr<const CQLStatement> GetPreparedStatement(const CQLMessage::QueryId& id);
 
@@ -116,6 +121,13 @@ class CQLProcessor : public ql::QLProcessor {
   std::unordered_set<std::shared_ptr<const CQLStatement>> stmts_;
   std::unordered_set<ql::ParseTree::UniPtr> parse_trees_;
 
+  // Cached statement and literals of the non-prepared query being executed, if it was normalized.
+  std::shared_ptr<const CQLStatement> normalized_stmt_;
+  std::unique_ptr<CQLLiteralParameters> literal_params_;
+
+  // Text of the statement being executed, if its execution is sampled for the statement stats.
+  const std::string* sampled_query_ = nullptr;
+
   // Current retry count.
   int retry_count_ = 0;
 
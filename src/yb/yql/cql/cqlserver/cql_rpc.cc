@@ -25,6 +25,7 @@
 
 #include "yb/util/debug/trace_event.h"
 #include "yb/util/size_literals.h"
+#include "yb/util/trace.h"
 
 using yb::cqlserver::CQLMessage;
 using namespace std::literals; // NOLINT
@@ -54,12 +55,12 @@ namespace yb {
 namespace cqlserver {
 
 CQLConnectionContext::CQLConnectionContext(
-    size_t receive_buffer_size, const MemTrackerPtr& buffer_tracker,
+    rpc::GrowableBufferAllocator* read_buffer_allocator, const MemTrackerPtr& buffer_tracker,
     const MemTrackerPtr& call_tracker)
     : ql_session_(new ql::QLSession()),
       parser_(buffer_tracker, CQLMessage::kMessageHeaderLength, CQLMessage::kHeaderPosLength,
               FLAGS_max_message_length, rpc::IncludeHeader::kTrue, this),
-      read_buffer_(receive_buffer_size, buffer_tracker),
+      read_buffer_(read_buffer_allocator),
       call_tracker_(call_tracker) {
 }
 
@@ -111,6 +112,9 @@ CQLInboundCall::CQLInboundCall(rpc::ConnectionPtr conn,
                                ql::QLSession::SharedPtr ql_session)
     : InboundCall(std::move(conn), nullptr /* rpc_metrics */, std::move(call_processed_listener)),
       ql_session_(std::move(ql_session)) {
+  if (Trace::ShouldSample()) {
+    trace_->set_sampled();
+  }
 }
 
 Status CQLInboundCall::ParseFrom(const MemTrackerPtr& call_tracker, rpc::CallData* call_data) {
@@ -175,7 +179,7 @@ void CQLInboundCall::RespondFailure(rpc::ErrorStatusPB::RpcErrorCodePB error_cod
       break;
     }
   }
-  response_msg_buf_ = RefCntBuffer(msg);
+  response_msg_buf_ = RefCntBuffer(std::move(msg));
 
   QueueResponse(/* is_success */ false);
 }
@@ -264,7 +268,8 @@ void CQLInboundCall::LogTrace() const {
   MonoTime now = MonoTime::Now();
   int total_time = now.GetDeltaSince(timing_.time_received).ToMilliseconds();
   if (PREDICT_FALSE(FLAGS_rpc_dump_all_traces || total_time > FLAGS_rpc_slow_query_threshold_ms)) {
-      LOG(WARNING) << ToString() << " took " << total_time << "ms. Details:";
+      LOG(WARNING) << ToString() << " took " << total_time << "ms. Stages: "
+                   << StagesToString() << ". Details:";
       rpc::RpcCallInProgressPB call_in_progress_pb;
       GetCallDetails(&call_in_progress_pb);
       LOG(WARNING) << call_in_progress_pb.DebugString() << "Trace: ";
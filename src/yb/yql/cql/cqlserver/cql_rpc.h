@@ -35,8 +35,8 @@ class CQLServiceImpl;
 class CQLConnectionContext : public rpc::ConnectionContextWithCallId,
                              public rpc::BinaryCallParserListener {
  public:
-  CQLConnectionContext(size_t receive_buffer_size, const MemTrackerPtr& buffer_tracker,
-                       const MemTrackerPtr& call_tracker);
+  CQLConnectionContext(rpc::GrowableBufferAllocator* read_buffer_allocator,
+                       const MemTrackerPtr& buffer_tracker, const MemTrackerPtr& call_tracker);
 
   void DumpPB(const rpc::DumpRunningRpcsRequestPB& req,
               rpc::RpcConnectionPB* resp) override;
@@ -16,6 +16,9 @@
 
 #include "yb/util/flag_tags.h"
 #include "yb/util/size_literals.h"
+#include "yb/util/url-coding.h"
+#include "yb/gutil/map-util.h"
+#include "yb/gutil/stringprintf.h"
 #include "yb/gutil/strings/substitute.h"
 #include "yb/yql/cql/cqlserver/cql_service.h"
 #include "yb/rpc/messenger.h"
@@ -33,6 +36,8 @@ TAG_FLAG(cql_nodelist_refresh_interval_secs, advanced);
 
 DEFINE_int64(cql_rpc_memory_limit, 0, "CQL RPC memory limit");
 
+DECLARE_int32(cql_statement_stats_sample_interval);
+
 using namespace std::placeholders;
 
 namespace yb {
@@ -66,6 +71,13 @@ CQLServer::CQLServer(const CQLServerOptions& opts,
 Status CQLServer::Start() {
   RETURN_NOT_OK(server::RpcAndWebServerBase::Init());
 
+  web_server_->RegisterPathHandler(
+      "/statements", "Statements",
+      [this](const Webserver::WebRequest& req, std::stringstream* output) {
+        HandleStatementsPage(req, output);
+      },
+      true /* styled */, false /* is_on_nav_bar */);
+
   auto cql_service = std::make_shared<CQLServiceImpl>(this, opts_, local_tablet_filter_);
   cql_service->CompleteInit();
 
@@ -79,6 +91,40 @@ Status CQLServer::Start() {
   return Status::OK();
 }
 
+void CQLServer::HandleStatementsPage(const Webserver::WebRequest& req,
+                                     std::stringstream* output) {
+  constexpr size_t kMaxStatements = 100;
+
+  *output << "<h1>Statements</h1>\n";
+  if (ContainsKey(req.parsed_args, "reset")) {
+    statement_stats_.Reset();
+    *output << "<p>Statistics were reset.</p>\n";
+    return;
+  }
+  if (FLAGS_cql_statement_stats_sample_interval <= 0) {
+    *output << "<p>Sampling is disabled by --cql_statement_stats_sample_interval.</p>\n";
+    return;
+  }
+  *output << strings::Substitute(
+      "<p>Estimated from one in $0 executions, statements that took the most time first. Latency "
+      "percentiles are upper bounds. <a href='?reset'>Reset</a></p>\n",
+      FLAGS_cql_statement_stats_sample_interval);
+
+  auto millis = [](uint64_t micros) { return StringPrintf("%.3f", micros / 1000.0); };
+  *output << "<table class='table table-striped'>\n";
+  *output << "  <tr><th>Statement</th><th>Calls</th><th>Errors</th><th>Rows</th>"
+             "<th>Total (ms)</th><th>Mean (ms)</th><th>p99 (ms)</th><th>Max (ms)</th></tr>\n";
+  for (const auto& entry : statement_stats_.GetTop(kMaxStatements)) {
+    *output << strings::Substitute(
+        "<tr><td>$0</td><td>$1</td><td>$2</td><td>$3</td><td>$4</td><td>$5</td><td>$6</td>"
+        "<td>$7</td></tr>\n",
+        EscapeForHtmlToString(entry.query), entry.calls, entry.errors, entry.rows,
+        millis(entry.total_micros), millis(entry.total_micros / std::max<uint64_t>(entry.calls, 1)),
+        millis(entry.LatencyPercentileMicros(0.99)), millis(entry.max_micros));
+  }
+  *output << "</table>\n";
+}
+
 void CQLServer::Shutdown() {
   boost::system::error_code ec;
   timer_.cancel(ec);
@@ -22,6 +22,7 @@
 
 #include "yb/yql/cql/cqlserver/cql_server_options.h"
 #include "yb/yql/cql/cqlserver/cql_message.h"
+#include "yb/yql/cql/cqlserver/cql_statement_stats.h"
 #include "yb/gutil/gscoped_ptr.h"
 #include "yb/gutil/macros.h"
 #include "yb/server/server_base.h"
@@ -55,13 +56,18 @@ class CQLServer : public server::RpcAndWebServerBase {
 
   const tserver::TabletServer* tserver() const { return tserver_; }
 
+  CQLStatementStats* statement_stats() { return &statement_stats_; }
+
  private:
+  void HandleStatementsPage(const Webserver::WebRequest& req, std::stringstream* output);
+
   CQLServerOptions opts_;
   void CQLNodeListRefresh(const boost::system::error_code &e);
   void RescheduleTimer();
   boost::asio::deadline_timer timer_;
   const tserver::TabletServer* const tserver_;
   client::LocalTabletFilter local_tablet_filter_;
+  CQLStatementStats statement_stats_;
 
   std::unique_ptr<CQLServerEvent> BuildTopologyChangeEvent(const std::string& event_type,
                                                            const Endpoint& addr);
@@ -16,6 +16,8 @@
 #include <mutex>
 #include <thread>
 
+#include <boost/thread/shared_mutex.hpp>
+
 #include "yb/client/transaction_pool.h"
 
 #include "yb/gutil/strings/join.h"
@@ -164,29 +166,37 @@ void CQLServiceImpl::ReturnProcessor(const CQLProcessorListPos& pos) {
   next_available_processor_ = pos;
 }
 
+CQLServiceImpl::PreparedStatementShard& CQLServiceImpl::PreparedStatementShardFor(
+    const CQLMessage::QueryId& query_id) {
+  return prepared_stmts_shards_[std::hash<CQLMessage::QueryId>()(query_id) %
+                                kPreparedStatementShards];
+}
+
 shared_ptr<CQLStatement> CQLServiceImpl::AllocatePreparedStatement(
     const CQLMessage::QueryId& query_id, const string& keyspace, const string& query) {
-  // Get exclusive lock before allocating a prepared statement and updating the LRU list.
-  std::lock_guard<std::mutex> guard(prepared_stmts_mutex_);
+  auto& shard = PreparedStatementShardFor(query_id);
+  // Get exclusive lock before allocating a prepared statement and updating the shard.
+  std::lock_guard<percpu_rwlock> guard(shard.lock);
 
   shared_ptr<CQLStatement> stmt;
-  const auto itr = prepared_stmts_map_.find(query_id);
-  if (itr == prepared_stmts_map_.end()) {
+  const auto itr = shard.map.find(query_id);
+  if (itr == shard.map.end()) {
     // Allocate the prepared statement placeholder that multiple clients trying to prepare the same
     // statement to contend on. The statement will then be prepared by one client while the rest
     // wait for the results.
-    stmt = prepared_stmts_map_.emplace(
+    stmt = shard.map.emplace(
         query_id, std::make_shared<CQLStatement>(
-            keyspace, query, prepared_stmts_list_.end())).first->second;
-    InsertLruPreparedStatementUnlocked(stmt);
+            keyspace, query, shard.list.end())).first->second;
+    // Insert the statement before the eviction hand, so it is scanned last.
+    stmt->set_pos(shard.list.insert(shard.hand, stmt));
   } else {
     // Return existing statement if found.
     stmt = itr->second;
-    MoveLruPreparedStatementUnlocked(stmt);
+    stmt->MarkReferenced();
   }
 
-  VLOG(1) << "InsertPreparedStatement: CQL prepared statement cache count = "
-          << prepared_stmts_map_.size() << "/" << prepared_stmts_list_.size()
+  VLOG(1) << "InsertPreparedStatement: CQL prepared statement shard count = "
+          << shard.map.size() << "/" << shard.list.size()
           << ", memory usage = " << prepared_stmts_mem_tracker_->consumption();
 
   return stmt;
@@ -194,80 +204,96 @@ shared_ptr<CQLStatement> CQLServiceImpl::AllocatePreparedStatement(
 
 shared_ptr<const CQLStatement> CQLServiceImpl::GetPreparedStatement(
     const CQLMessage::QueryId& query_id) {
-  // Get exclusive lock before looking up a prepared statement and updating the LRU list.
-  std::lock_guard<std::mutex> guard(prepared_stmts_mutex_);
-
-  const auto itr = prepared_stmts_map_.find(query_id);
-  if (itr == prepared_stmts_map_.end()) {
-    return nullptr;
+  auto& shard = PreparedStatementShardFor(query_id);
+  shared_ptr<CQLStatement> stmt;
+  {
+    // Shared lock is enough for a lookup, the recently used mark of the statement is atomic.
+    boost::shared_lock<rw_spinlock> guard(shard.lock.get_lock());
+    const auto itr = shard.map.find(query_id);
+    if (itr == shard.map.end()) {
+      return nullptr;
+    }
+    stmt = itr->second;
   }
 
-  shared_ptr<CQLStatement> stmt = itr->second;
-
   // If the statement has not finished preparing, do not return it.
   if (stmt->unprepared()) {
     return nullptr;
   }
   // If the statement is stale, delete it.
   if (stmt->stale()) {
-    DeletePreparedStatementUnlocked(stmt);
+    DeletePreparedStatement(stmt);
     return nullptr;
   }
 
-  MoveLruPreparedStatementUnlocked(stmt);
+  stmt->MarkReferenced();
   return stmt;
 }
 
 void CQLServiceImpl::DeletePreparedStatement(const shared_ptr<const CQLStatement>& stmt) {
+  auto& shard = PreparedStatementShardFor(stmt->query_id());
   // Get exclusive lock before deleting the prepared statement.
-  std::lock_guard<std::mutex> guard(prepared_stmts_mutex_);
+  std::lock_guard<percpu_rwlock> guard(shard.lock);
 
-  DeletePreparedStatementUnlocked(stmt);
+  DeletePreparedStatementUnlocked(&shard, stmt);
 
-  VLOG(1) << "DeletePreparedStatement: CQL prepared statement cache count = "
-          << prepared_stmts_map_.size() << "/" << prepared_stmts_list_.size()
+  VLOG(1) << "DeletePreparedStatement: CQL prepared statement shard count = "
+          << shard.map.size() << "/" << shard.list.size()
           << ", memory usage = " << prepared_stmts_mem_tracker_->consumption();
 }
 
-void CQLServiceImpl::InsertLruPreparedStatementUnlocked(const shared_ptr<CQLStatement>& stmt) {
-  // Insert the statement at the front of the LRU list.
-  stmt->set_pos(prepared_stmts_list_.insert(prepared_stmts_list_.begin(), stmt));
-}
-
-void CQLServiceImpl::MoveLruPreparedStatementUnlocked(const shared_ptr<CQLStatement>& stmt) {
-  // Move the statement to the front of the LRU list.
-  prepared_stmts_list_.splice(prepared_stmts_list_.begin(), prepared_stmts_list_, stmt->pos());
-}
-
 void CQLServiceImpl::DeletePreparedStatementUnlocked(
-    const std::shared_ptr<const CQLStatement> stmt) {
+    PreparedStatementShard* shard, const std::shared_ptr<const CQLStatement> stmt) {
   // Remove statement from cache by looking it up by query ID and only when it is same statement
   // object. Note that the "stmt" parameter above is not a ref ("&") intentionally so that we have
-  // a separate copy of the shared_ptr and not the very shared_ptr in prepared_stmts_map_ or
-  // prepared_stmt_list_ we are deleting.
-  const auto itr = prepared_stmts_map_.find(stmt->query_id());
-  if (itr != prepared_stmts_map_.end() && itr->second == stmt) {
-    prepared_stmts_map_.erase(itr);
+  // a separate copy of the shared_ptr and not the very shared_ptr in the shard map or list we are
+  // deleting.
+  const auto itr = shard->map.find(stmt->query_id());
+  if (itr != shard->map.end() && itr->second == stmt) {
+    shard->map.erase(itr);
   }
-  // Remove statement from LRU list only when it is in the list, i.e. pos() != end().
-  if (stmt->pos() != prepared_stmts_list_.end()) {
-    prepared_stmts_list_.erase(stmt->pos());
-    stmt->set_pos(prepared_stmts_list_.end());
+  // Remove statement from the list only when it is in the list, i.e. pos() != end().
+  if (stmt->pos() != shard->list.end()) {
+    if (shard->hand == stmt->pos()) {
+      ++shard->hand;
+    }
+    shard->list.erase(stmt->pos());
+    stmt->set_pos(shard->list.end());
   }
 }
 
 void CQLServiceImpl::CollectGarbage(size_t required) {
-  // Get exclusive lock before deleting the least recently used statement at the end of the LRU
-  // list from the cache.
-  std::lock_guard<std::mutex> guard(prepared_stmts_mutex_);
+  // Delete one statement from the next non empty shard using CLOCK algorithm, i.e. the first
+  // statement after the hand, that was not used since the hand passed it last time.
+  for (size_t i = 0; i != kPreparedStatementShards; ++i) {
+    auto& shard = prepared_stmts_shards_[
+        next_evicted_shard_.fetch_add(1, std::memory_order_relaxed) % kPreparedStatementShards];
+    // Get exclusive lock before deleting the statement from the shard.
+    std::lock_guard<percpu_rwlock> guard(shard.lock);
+    if (shard.list.empty()) {
+      continue;
+    }
 
-  if (!prepared_stmts_list_.empty()) {
-    DeletePreparedStatementUnlocked(prepared_stmts_list_.back());
-  }
+    // Statements could be marked concurrently, so limit the scan to two rounds.
+    for (size_t scanned = 0; scanned != 2 * shard.list.size(); ++scanned) {
+      if (shard.hand == shard.list.end()) {
+        shard.hand = shard.list.begin();
+      }
+      if (!(*shard.hand)->ResetReferenced()) {
+        break;
+      }
+      ++shard.hand;
+    }
+    if (shard.hand == shard.list.end()) {
+      shard.hand = shard.list.begin();
+    }
+    DeletePreparedStatementUnlocked(&shard, *shard.hand);
 
-  VLOG(1) << "DeleteLruPreparedStatement: CQL prepared statement cache count = "
-          << prepared_stmts_map_.size() << "/" << prepared_stmts_list_.size()
-          << ", memory usage = " << prepared_stmts_mem_tracker_->consumption();
+    VLOG(1) << "DeleteLruPreparedStatement: CQL prepared statement shard count = "
+            << shard.map.size() << "/" << shard.list.size()
+            << ", memory usage = " << prepared_stmts_mem_tracker_->consumption();
+    return;
+  }
 }
 
 client::TransactionPool* CQLServiceImpl::GetTransactionPool() {
@@ -291,6 +317,10 @@ server::Clock* CQLServiceImpl::clock() {
   return server_->clock();
 }
 
+CQLStatementStats* CQLServiceImpl::statement_stats() {
+  return server_->statement_stats();
+}
+
 
 }  // namespace cqlserver
 }  // namespace yb
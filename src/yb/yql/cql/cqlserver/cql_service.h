@@ -17,6 +17,8 @@
 #ifndef YB_YQL_CQL_CQLSERVER_CQL_SERVICE_H_
 #define YB_YQL_CQL_CQLSERVER_CQL_SERVICE_H_
 
+#include <array>
+#include <atomic>
 #include <vector>
 
 #include "yb/client/client_fwd.h"
@@ -28,6 +30,7 @@
 #include "yb/yql/cql/cqlserver/cql_server_options.h"
 #include "yb/yql/cql/ql/statement.h"
 
+#include "yb/util/locks.h"
 #include "yb/util/string_case.h"
 
 #include "yb/client/async_initializer.h"
@@ -42,6 +45,7 @@ extern const char* const kRoleColumnNameCanLogin;
 class CQLMetrics;
 class CQLProcessor;
 class CQLServer;
+class CQLStatementStats;
 
 class CQLServiceImpl : public CQLServerServiceIf,
                        public GarbageCollector,
@@ -95,25 +99,43 @@ class CQLServiceImpl : public CQLServerServiceIf,
 
   server::Clock* clock();
 
+  // Return the execution statistics of statements.
+  CQLStatementStats* statement_stats();
+
  private:
   constexpr static int kRpcTimeoutSec = 5;
 
   // Either gets an available processor or creates a new one.
   CQLProcessor *GetProcessor();
 
-  // Insert a prepared statement at the front of the LRU list. "prepared_stmts_mutex_" needs to be
-  // locked before this call.
-  void InsertLruPreparedStatementUnlocked(const std::shared_ptr<CQLStatement>& stmt);
+  // Number of shards of the prepared statements cache.
+  static constexpr size_t kPreparedStatementShards = 16;
+
+  // Prepared statements are distributed among shards by their query ids, so allocation and
+  // deletion of statements in different shards do not block each other.
+  struct PreparedStatementShard {
+    // Lookups lock only the lock of their CPU in shared mode, so concurrent lookups do not
+    // contend. Changes of the shard lock all of them.
+    percpu_rwlock lock;
+
+    // Statements of the shard by query id.
+    CQLStatementMap map;
 
-  // Move a prepared statement to the front of the LRU list. "prepared_stmts_mutex_" needs to be
-  // locked before this call.
-  void MoveLruPreparedStatementUnlocked(const std::shared_ptr<CQLStatement>& stmt);
+    // Statements of the shard in the order they are scanned by the CLOCK eviction.
+    CQLStatementList list;
 
-  // Delete a prepared statement from the cache and the LRU list. "prepared_stmts_mutex_" needs to
-  // be locked before this call.
-  void DeletePreparedStatementUnlocked(const std::shared_ptr<const CQLStatement> stmt);
+    // Next statement to be scanned by the eviction.
+    CQLStatementListPos hand = list.end();
+  };
 
-  // Delete the least recently used prepared statement from the cache to free up memory.
+  PreparedStatementShard& PreparedStatementShardFor(const CQLMessage::QueryId& query_id);
+
+  // Delete a prepared statement from the shard. Shard lock needs to be locked exclusively before
+  // this call.
+  void DeletePreparedStatementUnlocked(
+      PreparedStatementShard* shard, const std::shared_ptr<const CQLStatement> stmt);
+
+  // Delete a prepared statement that was not used recently from the cache to free up memory.
   void CollectGarbage(size_t required) override;
 
   // CQLServer of this service.
@@ -138,13 +160,10 @@ class CQLServiceImpl : public CQLServerServiceIf,
   std::mutex processors_mutex_;
 
   // Prepared statements cache.
-  CQLStatementMap prepared_stmts_map_;
-
-  // Prepared statements LRU list (least recently used one at the end).
-  CQLStatementList prepared_stmts_list_;
+  std::array<PreparedStatementShard, kPreparedStatementShards> prepared_stmts_shards_;
 
-  // Mutex that protects the prepared statements and the LRU list.
-  std::mutex prepared_stmts_mutex_;
+  // Shard to evict a statement from next time, so eviction is spread evenly among shards.
+  std::atomic<size_t> next_evicted_shard_{0};
 
   std::shared_ptr<ql::Statement> auth_prepared_stmt_;
 
@@ -19,6 +19,7 @@
 #ifndef YB_YQL_CQL_CQLSERVER_CQL_STATEMENT_H_
 #define YB_YQL_CQL_CQLSERVER_CQL_STATEMENT_H_
 
+#include <atomic>
 #include <list>
 
 #include "yb/yql/cql/cqlserver/cql_message.h"
@@ -34,7 +35,7 @@ class CQLStatement;
 // it when it is being executed by another client in another thread.
 using CQLStatementMap = std::unordered_map<CQLMessage::QueryId, std::shared_ptr<CQLStatement>>;
 
-// A LRU list of CQL statements and position in the list.
+// A list of cached CQL statements scanned by CLOCK eviction and position in the list.
 using CQLStatementList = std::list<std::shared_ptr<CQLStatement>>;
 using CQLStatementListPos = CQLStatementList::iterator;
 
@@ -47,16 +48,32 @@ class CQLStatement : public ql::Statement {
   // Return the query id.
   CQLMessage::QueryId query_id() const { return GetQueryId(keyspace_, text_); }
 
-  // Get/set position of the statement in the LRU.
+  // Get/set position of the statement in the cache list.
   CQLStatementListPos pos() const { return pos_; }
   void set_pos(CQLStatementListPos pos) const { pos_ = pos; }
 
+  // Marks the statement as recently used. Does not write to memory when the mark is already set,
+  // so threads executing the same statement do not invalidate the cache line of each other.
+  void MarkReferenced() const {
+    if (!referenced_.load(std::memory_order_relaxed)) {
+      referenced_.store(true, std::memory_order_relaxed);
+    }
+  }
+
+  // Clears the recently used mark, returning whether it was set.
+  bool ResetReferenced() const {
+    return referenced_.exchange(false, std::memory_order_relaxed);
+  }
+
   // Return the query id of a statement.
   static CQLMessage::QueryId GetQueryId(const std::string& keyspace, const std::string& query);
 
  private:
-  // Position of the statement in the LRU.
+  // Position of the statement in the cache list.
   mutable CQLStatementListPos pos_;
+
+  // Whether the statement was used since the eviction scanned it last time.
+  mutable std::atomic<bool> referenced_{true};
 };
 
 }  // namespace cqlserver
@@ -0,0 +1,116 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/yql/cql/cqlserver/cql_statement_stats.h"
+
+#include <algorithm>
+
+#include <gflags/gflags.h>
+
+#include "yb/gutil/bits.h"
+#include "yb/util/flag_tags.h"
+
+DEFINE_int32(cql_statement_stats_sample_interval, 10,
+             "Sample one in this many executions of CQL statements of each thread for the "
+             "statement statistics. 0 to disable.");
+TAG_FLAG(cql_statement_stats_sample_interval, advanced);
+TAG_FLAG(cql_statement_stats_sample_interval, runtime);
+
+DEFINE_int32(cql_statement_stats_max_statements, 1000,
+             "Maximum number of CQL statements tracked by the statement statistics.");
+TAG_FLAG(cql_statement_stats_max_statements, advanced);
+TAG_FLAG(cql_statement_stats_max_statements, runtime);
+
+namespace yb {
+namespace cqlserver {
+
+uint64_t CQLStatementStats::Entry::LatencyPercentileMicros(double fraction) const {
+  const uint64_t threshold = static_cast<uint64_t>(calls * fraction);
+  uint64_t count = 0;
+  for (size_t i = 0; i < latency_buckets.size(); ++i) {
+    count += latency_buckets[i];
+    if (count > threshold || count == calls) {
+      return std::min<uint64_t>(1ULL << i, max_micros);
+    }
+  }
+  return max_micros;
+}
+
+bool CQLStatementStats::ShouldSample() {
+  const auto interval = FLAGS_cql_statement_stats_sample_interval;
+  if (interval <= 0) {
+    return false;
+  }
+  static thread_local uint32_t counter = 0;
+  return ++counter % interval == 0;
+}
+
+void CQLStatementStats::Record(
+    const std::string& query, MonoDelta latency, size_t rows, bool error) {
+  // Each sample stands for the executions that were not sampled since the previous one.
+  const uint64_t weight = std::max(FLAGS_cql_statement_stats_sample_interval, 1);
+  const uint64_t micros = std::max<int64_t>(latency.ToMicroseconds(), 0);
+  const size_t bucket = std::min<size_t>(
+      micros == 0 ? 0 : Bits::Log2Floor64(micros) + 1, kNumLatencyBuckets - 1);
+  const size_t max_entries = std::max<size_t>(
+      FLAGS_cql_statement_stats_max_statements / kNumShards, 1);
+
+  auto& shard = shards_[std::hash<std::string>()(query) % kNumShards];
+  std::lock_guard<std::mutex> lock(shard.mutex);
+  auto it = shard.entries.find(query);
+  if (it == shard.entries.end()) {
+    while (shard.entries.size() >= max_entries) {
+      shard.entries.erase(std::min_element(
+          shard.entries.begin(), shard.entries.end(), [](const auto& lhs, const auto& rhs) {
+            return lhs.second.calls < rhs.second.calls;
+          }));
+    }
+    it = shard.entries.emplace(query, Entry()).first;
+    it->second.query = query;
+  }
+  auto& entry = it->second;
+  entry.calls += weight;
+  entry.errors += error ? weight : 0;
+  entry.rows += rows * weight;
+  entry.total_micros += micros * weight;
+  entry.max_micros = std::max(entry.max_micros, micros);
+  entry.latency_buckets[bucket] += weight;
+}
+
+std::vector<CQLStatementStats::Entry> CQLStatementStats::GetTop(size_t max_entries) const {
+  std::vector<Entry> result;
+  for (const auto& shard : shards_) {
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    for (const auto& entry : shard.entries) {
+      result.push_back(entry.second);
+    }
+  }
+  std::sort(result.begin(), result.end(), [](const Entry& lhs, const Entry& rhs) {
+    return lhs.total_micros > rhs.total_micros;
+  });
+  if (result.size() > max_entries) {
+    result.resize(max_entries);
+  }
+  return result;
+}
+
+void CQLStatementStats::Reset() {
+  for (auto& shard : shards_) {
+    std::unordered_map<std::string, Entry> entries;
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    entries.swap(shard.entries);
+  }
+}
+
+} // namespace cqlserver
+} // namespace yb
@@ -0,0 +1,81 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#ifndef YB_YQL_CQL_CQLSERVER_CQL_STATEMENT_STATS_H
+#define YB_YQL_CQL_CQLSERVER_CQL_STATEMENT_STATS_H
+
+#include <array>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "yb/util/monotime.h"
+
+namespace yb {
+namespace cqlserver {
+
+// Execution statistics of CQL statements by their text, to find the statements that load the
+// server. Prepared statements and non-prepared queries with literals normalized are tracked by
+// the text of the statement, so executions with different values are aggregated together.
+//
+// One in FLAGS_cql_statement_stats_sample_interval executions of each thread is sampled, and the
+// statistics are estimated from the sampled executions. At most
+// FLAGS_cql_statement_stats_max_statements statements are tracked, the statement that was executed
+// the least times is replaced when a new statement is sampled.
+class CQLStatementStats {
+ public:
+  // Latency of an execution is counted in bucket i when it is less than 2^i microseconds.
+  static constexpr size_t kNumLatencyBuckets = 32;
+
+  struct Entry {
+    std::string query;
+    uint64_t calls = 0;
+    uint64_t errors = 0;
+    uint64_t rows = 0;
+    uint64_t total_micros = 0;
+    uint64_t max_micros = 0;
+    std::array<uint64_t, kNumLatencyBuckets> latency_buckets{};
+
+    // Returns the upper bound of the latency the given fraction of executions completed within.
+    uint64_t LatencyPercentileMicros(double fraction) const;
+  };
+
+  // Returns true if the current execution should be sampled.
+  static bool ShouldSample();
+
+  // Records a sampled execution of the query, that returned the given number of rows.
+  void Record(const std::string& query, MonoDelta latency, size_t rows, bool error);
+
+  // Returns the statistics of at most max_entries statements that took the most execution time,
+  // estimated from the samples.
+  std::vector<Entry> GetTop(size_t max_entries) const;
+
+  void Reset();
+
+ private:
+  // Number of shards, statements are distributed among them by the hash of their text.
+  static constexpr size_t kNumShards = 16;
+
+  struct Shard {
+    mutable std::mutex mutex;
+    std::unordered_map<std::string, Entry> entries;
+  };
+
+  std::array<Shard, kNumShards> shards_;
+};
+
+} // namespace cqlserver
+} // namespace yb
+
+#endif // YB_YQL_CQL_CQLSERVER_CQL_STATEMENT_STATS_H
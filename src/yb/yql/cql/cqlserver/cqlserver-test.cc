@@ -18,6 +18,7 @@
 #include "yb/gutil/strings/substitute.h"
 #include "yb/integration-tests/yb_table_test_base.h"
 
+#include "yb/yql/cql/cqlserver/cql_literals.h"
 #include "yb/yql/cql/cqlserver/cql_message.h"
 #include "yb/yql/cql/cqlserver/cql_server.h"
 
@@ -251,5 +252,40 @@ TEST_F(TestCQLService, TestCQLServerEventConst) {
   ASSERT_EQ(0, memcmp(buffer, ptr, kSize));
 }
 
+TEST(CQLLiteralsTest, Normalize) {
+  std::string normalized;
+  CQLLiterals literals;
+  ASSERT_TRUE(NormalizeLiterals(
+      "INSERT INTO t (h, r, \"v 1\") VALUES (-1, 2.5e3, 'it''s') USING TTL 10;",
+      &normalized, &literals));
+  ASSERT_EQ("INSERT INTO t (h, r, \"v 1\") VALUES (?, ?, ?) USING TTL ?;", normalized);
+  ASSERT_EQ(4, literals.size());
+  ASSERT_EQ(CQLLiteral::Kind::kInteger, literals[0].kind);
+  ASSERT_EQ("-1", literals[0].value);
+  ASSERT_EQ(CQLLiteral::Kind::kReal, literals[1].kind);
+  ASSERT_EQ("2.5e3", literals[1].value);
+  ASSERT_EQ(CQLLiteral::Kind::kString, literals[2].kind);
+  ASSERT_EQ("it's", literals[2].value);
+  ASSERT_EQ("10", literals[3].value);
+
+  ASSERT_TRUE(NormalizeLiterals("select v1 from t where h = 1 and r > v - 2", &normalized,
+                                &literals));
+  ASSERT_EQ("select v1 from t where h = ? and r > v - ?", normalized);
+  ASSERT_EQ(2, literals.size());
+
+  // Not a DML.
+  ASSERT_FALSE(NormalizeLiterals("CREATE TABLE t (h int PRIMARY KEY)", &normalized, &literals));
+  // Bind markers.
+  ASSERT_FALSE(NormalizeLiterals("SELECT * FROM t WHERE h = ?", &normalized, &literals));
+  ASSERT_FALSE(NormalizeLiterals("SELECT * FROM t WHERE h = :h", &normalized, &literals));
+  // Literals that are not normalized.
+  ASSERT_FALSE(NormalizeLiterals("SELECT * FROM t WHERE b = 0xff", &normalized, &literals));
+  ASSERT_FALSE(NormalizeLiterals(
+      "SELECT * FROM t WHERE u = 123e4567-e89b-12d3-a456-426655440000", &normalized, &literals));
+  // Comments and unterminated strings.
+  ASSERT_FALSE(NormalizeLiterals("SELECT * FROM t -- comment", &normalized, &literals));
+  ASSERT_FALSE(NormalizeLiterals("SELECT * FROM t WHERE s = 'abc", &normalized, &literals));
+}
+
 }  // namespace cqlserver
 }  // namespace yb
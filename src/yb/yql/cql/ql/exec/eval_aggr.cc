@@ -33,15 +33,41 @@ Status Executor::AggregateResultSets(const PTSelectStmt* pt_select, TnodeContext
   shared_ptr<RowsResult> rows_result = tnode_context->rows_result();
   DCHECK(rows_result->client() == QLClient::YQL_CLIENT_CQL);
   shared_ptr<QLRowBlock> row_block = rows_result->GetRowBlock();
-  int column_index = 0;
   faststring buffer;
 
-  CQLEncodeLength(1, &buffer);
+  if (!pt_select->group_by_hash_key()) {
+    CQLEncodeLength(1, &buffer);
+    RETURN_NOT_OK(AggregateRows(pt_select, row_block, rows_result.get(), &buffer));
+  } else {
+    // All rows of a group are aggregated by the same tablet, so each returned row holds the
+    // partial aggregates of a different group.
+    CQLEncodeLength(row_block->row_count(), &buffer);
+    for (const auto& row : row_block->rows()) {
+      auto group_block = std::make_shared<QLRowBlock>(row_block->schema());
+      group_block->Extend() = row;
+      RETURN_NOT_OK(AggregateRows(pt_select, group_block, rows_result.get(), &buffer));
+    }
+  }
+
+  // Change the result set to the aggregate result.
+  rows_result->set_rows_data(buffer.c_str(), buffer.size());
+  return Status::OK();
+}
+
+Status Executor::AggregateRows(const PTSelectStmt* pt_select,
+                               const shared_ptr<QLRowBlock>& row_block,
+                               RowsResult* rows_result,
+                               faststring* buffer) {
+  int column_index = 0;
   for (auto expr_node : pt_select->selected_exprs()) {
     QLValue ql_value;
 
     switch (expr_node->aggregate_opcode()) {
       case TSOpcode::kNoOp:
+        // Partition key column of a group.
+        if (row_block->row_count() > 0) {
+          ql_value = row_block->rows()[0].column(column_index);
+        }
         break;
       case TSOpcode::kAvg:
         RETURN_NOT_OK(EvalAvg(row_block, column_index, expr_node->ql_type()->main(),
@@ -66,12 +92,9 @@ Status Executor::AggregateResultSets(const PTSelectStmt* pt_select, TnodeContext
     }
 
     // Serialize the return value.
-    ql_value.Serialize(expr_node->ql_type(), rows_result->client(), &buffer);
+    ql_value.Serialize(expr_node->ql_type(), rows_result->client(), buffer);
     column_index++;
   }
-
-  // Change the result set to the aggregate result.
-  rows_result->set_rows_data(buffer.c_str(), buffer.size());
   return Status::OK();
 }
 
@@ -72,6 +72,10 @@ Status ExecContext::StartTransaction(const IsolationLevel isolation_level, QLEnv
   return Status::OK();
 }
 
+void ExecContext::EnableSingleShardCommit() {
+  DCHECK_NOTNULL(transaction_.get())->EnableSingleShardCommit();
+}
+
 Status ExecContext::PrepareChildTransaction(ChildTransactionDataPB* data) {
   ChildTransactionDataPB result =
       VERIFY_RESULT(DCHECK_NOTNULL(transaction_.get())->PrepareChildFuture(
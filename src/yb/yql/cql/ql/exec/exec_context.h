@@ -115,6 +115,51 @@ class TnodeContext {
     return current_partition_index_;
   }
 
+  // Used for multi-partition selects and table scans that read several consecutive partitions or
+  // token ranges in parallel, starting from the current one. Called from Executor::ExecPTNode for
+  // PTSelectStmt before the reads are added in order. For a table scan, scan_max_hash_code is the
+  // upper bound of the whole scan, if any.
+  void StartParallelReads(uint64_t count, bool is_scan = false,
+                          boost::optional<uint32_t> scan_max_hash_code = boost::none) {
+    parallel_reads_ = count;
+    next_parallel_partition_index_ = current_partition_index_;
+    drop_parallel_reads_ = false;
+    parallel_scan_ = is_scan;
+    scan_max_hash_code_ = scan_max_hash_code;
+  }
+
+  // Number of parallel reads whose results are not processed yet.
+  uint64_t parallel_reads() const {
+    return parallel_reads_;
+  }
+
+  // Called for the result of each parallel read, in order. For a multi-partition select, makes its
+  // partition the current one. Returns false if the read is dropped.
+  bool NextParallelRead() {
+    parallel_reads_--;
+    if (drop_parallel_reads_) {
+      return false;
+    }
+    if (!parallel_scan_) {
+      current_partition_index_ = next_parallel_partition_index_++;
+    }
+    return true;
+  }
+
+  // Drops the results of the remaining parallel reads, so that the current partition or token
+  // range is read to its end before the following ones. The read of a token range continues to
+  // the end of the scan.
+  void DropParallelReads(QLReadRequestPB *req) {
+    drop_parallel_reads_ = true;
+    if (parallel_scan_) {
+      if (scan_max_hash_code_) {
+        req->set_max_hash_code(*scan_max_hash_code_);
+      } else {
+        req->clear_max_hash_code();
+      }
+    }
+  }
+
   void set_partitions_count(const uint64_t count) {
     partitions_count_ = count;
   }
@@ -163,6 +208,13 @@ class TnodeContext {
   uint64_t partitions_count_ = 0;
   uint64_t current_partition_index_ = 0;
 
+  // State of the partitions or token ranges read in parallel.
+  uint64_t parallel_reads_ = 0;
+  uint64_t next_parallel_partition_index_ = 0;
+  bool drop_parallel_reads_ = false;
+  bool parallel_scan_ = false;
+  boost::optional<uint32_t> scan_max_hash_code_;
+
   // Rows result of this statement tnode for DML statements.
   RowsResult::SharedPtr rows_result_;
 
@@ -236,6 +288,10 @@ class ExecContext : public ProcessContextBase {
     return transaction_start_time_;
   }
 
+  // Allow the current distributed transaction to be committed by a single write request when
+  // all of its writes go to one tablet. See client::YBTransaction::EnableSingleShardCommit.
+  void EnableSingleShardCommit();
+
   // Prepare a child distributed transaction.
   CHECKED_STATUS PrepareChildTransaction(ChildTransactionDataPB* data);
 
@@ -20,14 +20,37 @@
 #include "yb/client/callbacks.h"
 #include "yb/client/yb_op.h"
 #include "yb/common/common.pb.h"
+#include "yb/common/partition.h"
 #include "yb/common/ql_protocol_util.h"
 #include "yb/common/wire_protocol.h"
 #include "yb/rpc/thread_pool.h"
 #include "yb/util/decimal.h"
+#include "yb/util/flag_tags.h"
 #include "yb/util/logging.h"
 #include "yb/util/thread_restrictions.h"
 #include "yb/util/trace.h"
 
+DEFINE_int32(cql_max_parallel_partition_reads, 16,
+             "Maximum number of partitions read in parallel by a SELECT with an IN condition on "
+             "the hash columns, when the number of rows in each partition is not bounded, and of "
+             "tablets read in parallel by a full-table or token-range scan. Use 1 to read them "
+             "one at a time.");
+TAG_FLAG(cql_max_parallel_partition_reads, advanced);
+TAG_FLAG(cql_max_parallel_partition_reads, runtime);
+
+DEFINE_int32(cql_parallel_read_min_rows, 10,
+             "Minimum share of the limit of a SELECT for each of the partitions or tablets read in "
+             "parallel. Reads after one that does not finish its partition within its share are "
+             "dropped and read again, so small limits are read from fewer partitions at a time.");
+TAG_FLAG(cql_parallel_read_min_rows, advanced);
+TAG_FLAG(cql_parallel_read_min_rows, runtime);
+
+DEFINE_bool(cql_commit_transaction_with_flush, true,
+            "Request commit of a transaction block together with the flush of its last writes, "
+            "when their results are not needed to decide whether to commit.");
+TAG_FLAG(cql_commit_transaction_with_flush, advanced);
+TAG_FLAG(cql_commit_transaction_with_flush, runtime);
+
 namespace yb {
 namespace ql {
 
@@ -53,6 +76,17 @@ using client::YBqlReadOpPtr;
 using client::YBqlWriteOpPtr;
 using strings::Substitute;
 
+namespace {
+
+// Returns the maximum number of partitions or tablets read in parallel for the given limit.
+uint64_t MaxParallelReads(uint64_t limit) {
+  return std::min<uint64_t>(
+      static_cast<uint64_t>(std::max(FLAGS_cql_max_parallel_partition_reads, 1)),
+      limit / std::max(FLAGS_cql_parallel_read_min_rows, 1));
+}
+
+} // namespace
+
 #define RETURN_STMT_NOT_OK(s) do {                                         \
     auto&& _s = (s);                                                       \
     if (PREDICT_FALSE(!_s.ok())) return StatementExecuted(MoveStatus(_s)); \
@@ -676,6 +710,9 @@ Status Executor::ExecPTNode(const PTSelectStmt *tnode, TnodeContext* tnode_conte
   // Where clause - Hash, range, and regular columns.
 
   req->set_is_aggregate(tnode->is_aggregate());
+  if (tnode->group_by_hash_key()) {
+    req->set_group_by_hash_key(true);
+  }
 
   Result<uint64_t> max_rows_estimate = WhereClauseToPB(req, tnode->key_where_ops(),
                                                        tnode->where_ops(),
@@ -690,10 +727,7 @@ Status Executor::ExecPTNode(const PTSelectStmt *tnode, TnodeContext* tnode_conte
 
   // If where clause restrictions guarantee no rows could match, return empty result immediately.
   if (*max_rows_estimate == 0 && !tnode->is_aggregate()) {
-    QLRowBlock empty_row_block(tnode->table()->InternalSchema(), {});
-    faststring buffer;
-    empty_row_block.Serialize(select_op->request().client(), &buffer);
-    *select_op->mutable_rows_data() = buffer.ToString();
+    *select_op->mutable_rows_data() = QLRowBlock::ZeroRowsData(select_op->request().client());
     result_ = std::make_shared<RowsResult>(select_op.get());
     return Status::OK();
   }
@@ -778,6 +812,9 @@ Status Executor::ExecPTNode(const PTSelectStmt *tnode, TnodeContext* tnode_conte
     paging_state->set_next_row_key(params.next_row_key());
     paging_state->set_total_num_rows_read(params.total_num_rows_read());
     paging_state->set_total_rows_skipped(params.total_rows_skipped());
+    if (params.cursor_id() != 0) {
+      paging_state->set_cursor_id(params.cursor_id());
+    }
   }
 
   // Set the consistency level for the operation. Always use strong consistency for system tables.
@@ -806,6 +843,41 @@ Status Executor::ExecPTNode(const PTSelectStmt *tnode, TnodeContext* tnode_conte
       }
       return Status::OK();
     }
+
+    // Otherwise, read a bounded window of partitions in parallel, each with an equal share of the
+    // limit so that they cannot return more rows than the limit together. Their results are
+    // processed in partition order, and the reads after the first partition that is not finished
+    // are dropped to be read again after it (see ProcessTnodeResults). So a small limit is read
+    // from fewer partitions at a time, for most of the partitions in the window to finish.
+    const uint64_t parallel_reads = std::min<uint64_t>(
+        MaxParallelReads(req->limit()), tnode_context->UnreadPartitionsRemaining());
+    if (parallel_reads > 1 && !req->has_offset() &&
+        !(tnode->child_select() && !tnode->child_select()->covers_fully())) {
+      req->set_limit(req->limit() / parallel_reads);
+      // The paging state is needed to know whether each partition is finished.
+      req->set_return_paging_state(true);
+      tnode_context->StartParallelReads(parallel_reads);
+      RETURN_NOT_OK(AddOperation(select_op, tnode_context));
+      for (uint64_t i = 1; i < parallel_reads; i++) {
+        YBqlReadOpPtr op(table->NewQLSelect());
+        op->mutable_request()->CopyFrom(select_op->request());
+        op->set_yb_consistency_level(select_op->yb_consistency_level());
+        // Only the first partition resumes from where the previous fetch stopped.
+        op->mutable_request()->mutable_paging_state()->clear_next_partition_key();
+        op->mutable_request()->mutable_paging_state()->clear_next_row_key();
+        op->mutable_request()->mutable_paging_state()->clear_cursor_id();
+        tnode_context->AdvanceToNextPartition(op->mutable_request());
+        RETURN_NOT_OK(AddOperation(op, tnode_context));
+        select_op = op;
+      }
+      return Status::OK();
+    }
+  }
+
+  // Full-table and token-range scans read a bounded window of consecutive tablets in parallel,
+  // in the same way as the partitions above.
+  if (VERIFY_RESULT(AddParallelScanOperations(tnode, select_op, tnode_context))) {
+    return Status::OK();
   }
 
   // If this select statement uses an uncovered index underneath, save this op as a template to
@@ -823,6 +895,76 @@ Status Executor::ExecPTNode(const PTSelectStmt *tnode, TnodeContext* tnode_conte
   return AddOperation(select_op, tnode_context);
 }
 
+Result<bool> Executor::AddParallelScanOperations(const PTSelectStmt* tnode,
+                                                 const YBqlReadOpPtr& select_op,
+                                                 TnodeContext* tnode_context) {
+  QLReadRequestPB *req = select_op->mutable_request();
+  if (!req->hashed_column_values().empty() || tnode->is_system() || tnode->is_aggregate() ||
+      !req->is_forward_scan() || req->has_offset() ||
+      (tnode->child_select() && !tnode->child_select()->covers_fully())) {
+    return false;
+  }
+  // A scan resuming in the middle of a tablet is reading a tablet larger than its share of a page,
+  // so it keeps reading that tablet with the whole page limit.
+  if (!req->paging_state().next_row_key().empty()) {
+    return false;
+  }
+
+  // Find the tablet where the scan starts or continues. Each read covers the token range of one
+  // tablet, so the results stay correct when the partitions of the table are stale.
+  const std::vector<std::string>& partitions = tnode->table()->GetPartitions();
+  std::string start_key;
+  if (!req->paging_state().next_partition_key().empty()) {
+    start_key = req->paging_state().next_partition_key();
+  } else if (req->has_hash_code()) {
+    start_key = PartitionSchema::EncodeMultiColumnHashValue(req->hash_code());
+  }
+  auto next = std::upper_bound(partitions.begin(), partitions.end(), start_key);
+  const auto scan_max_hash_code = req->has_max_hash_code()
+      ? boost::make_optional<uint32_t>(req->max_hash_code()) : boost::none;
+  const auto in_scan = [&scan_max_hash_code](const std::string& partition_start) {
+    return !scan_max_hash_code ||
+           PartitionSchema::DecodeMultiColumnHashValue(partition_start) <= *scan_max_hash_code;
+  };
+  uint64_t parallel_reads = 1;
+  const uint64_t max_parallel_reads = MaxParallelReads(req->limit());
+  for (auto it = next; parallel_reads < max_parallel_reads && it != partitions.end() && in_scan(*it);
+       ++it) {
+    parallel_reads++;
+  }
+  if (parallel_reads <= 1) {
+    return false;
+  }
+
+  // All but the last read stop at the end of their tablet. The last one continues the scan.
+  req->set_limit(req->limit() / parallel_reads);
+  req->set_return_paging_state(true);
+  tnode_context->StartParallelReads(parallel_reads, true /* is_scan */, scan_max_hash_code);
+  YBqlReadOpPtr op = select_op;
+  for (uint64_t i = 0; i < parallel_reads; i++) {
+    if (i > 0) {
+      op.reset(tnode->table()->NewQLSelect());
+      op->mutable_request()->CopyFrom(*req);
+      op->set_yb_consistency_level(select_op->yb_consistency_level());
+      op->mutable_request()->mutable_paging_state()->clear_next_partition_key();
+      op->mutable_request()->mutable_paging_state()->clear_next_row_key();
+      op->mutable_request()->mutable_paging_state()->clear_cursor_id();
+      op->mutable_request()->set_hash_code(
+          PartitionSchema::DecodeMultiColumnHashValue(*(next + i - 1)));
+    }
+    if (i + 1 < parallel_reads) {
+      op->mutable_request()->set_max_hash_code(
+          PartitionSchema::DecodeMultiColumnHashValue(*(next + i)) - 1);
+    } else if (scan_max_hash_code) {
+      op->mutable_request()->set_max_hash_code(*scan_max_hash_code);
+    } else {
+      op->mutable_request()->clear_max_hash_code();
+    }
+    RETURN_NOT_OK(AddOperation(op, tnode_context));
+  }
+  return true;
+}
+
 Result<bool> Executor::FetchMoreRows(const PTSelectStmt* tnode,
                                      const YBqlReadOpPtr& op,
                                      TnodeContext* tnode_context,
@@ -844,8 +986,10 @@ Result<bool> Executor::FetchMoreRows(const PTSelectStmt* tnode,
   const size_t total_rows_skipped = exec_context->params().total_rows_skipped() +
                                     current_params.total_rows_skipped();
 
-  // The limit for this select: min of page size and result limit (if set).
-  uint64_t fetch_limit = exec_context->params().page_size(); // default;
+  // The limit for this select: min of page size and result limit (if set). Groups of aggregates
+  // are all returned in one page, since the page could not be continued after aggregation.
+  uint64_t fetch_limit = tnode->group_by_hash_key() ? std::numeric_limits<uint64_t>::max()
+                                                    : exec_context->params().page_size();
   if (tnode->limit()) {
     QLExpressionPB limit_pb;
     RETURN_NOT_OK(PTExprToPB(tnode->limit(), &limit_pb));
@@ -908,6 +1052,9 @@ Result<bool> Executor::FetchMoreRows(const PTSelectStmt* tnode,
       // Within a partition, set the exact primary key to resume from (if any).
       paging_state.set_next_partition_key(current_params.next_partition_key());
       paging_state.set_next_row_key(current_params.next_row_key());
+      if (current_params.cursor_id() != 0) {
+        paging_state.set_cursor_id(current_params.cursor_id());
+      }
 
       current_result->SetPagingState(paging_state);
     }
@@ -934,6 +1081,11 @@ Result<bool> Executor::FetchMoreRows(const PTSelectStmt* tnode,
   paging_state->set_next_row_key(current_params.next_row_key());
   paging_state->set_total_num_rows_read(total_row_count);
   paging_state->set_total_rows_skipped(total_rows_skipped);
+  if (current_params.cursor_id() != 0) {
+    paging_state->set_cursor_id(current_params.cursor_id());
+  } else {
+    paging_state->clear_cursor_id();
+  }
   return true;
 }
 
@@ -1127,7 +1279,11 @@ Status Executor::ExecPTNode(const PTUpdateStmt *tnode, TnodeContext* tnode_conte
 //--------------------------------------------------------------------------------------------------
 
 Status Executor::ExecPTNode(const PTStartTransaction *tnode) {
-  return exec_context_->StartTransaction(tnode->isolation_level(), ql_env_);
+  RETURN_NOT_OK(exec_context_->StartTransaction(tnode->isolation_level(), ql_env_));
+  // All writes of a transaction block are flushed together and the transaction is committed
+  // right after that.
+  exec_context_->EnableSingleShardCommit();
+  return Status::OK();
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -1226,6 +1382,41 @@ Status ProcessTnodeContexts(ExecContext* exec_context,
   return Status::OK();
 }
 
+// Checks whether the transaction of exec_context could be committed right after the flush of its
+// buffered ops, without waiting for their results. So all ops of the transaction that are not done
+// yet should be buffered. Also none of them should be a read, have an IF condition, return status
+// or update secondary indexes, since the results of such ops are processed before the commit.
+bool CanCommitWithFlush(ExecContext* exec_context) {
+  if (!FLAGS_cql_commit_transaction_with_flush) {
+    return false;
+  }
+  int pending_ops = 0;
+  bool can_commit = true;
+  auto status = ProcessTnodeContexts(
+      exec_context,
+      [&pending_ops, &can_commit](TnodeContext* tnode_context) -> Result<bool> {
+        for (const auto& op : tnode_context->ops()) {
+          if (op->response().has_status()) {
+            continue;
+          }
+          if (op->type() != YBOperation::Type::QL_WRITE) {
+            can_commit = false;
+            return true; // done
+          }
+          const auto& request = static_cast<const YBqlWriteOp&>(*op).request();
+          if (request.has_if_expr() || request.returns_status() ||
+              !op->table()->index_map().empty()) {
+            can_commit = false;
+            return true; // done
+          }
+          ++pending_ops;
+        }
+        return false; // not done
+      });
+  return status.ok() && can_commit &&
+         pending_ops == exec_context->transactional_session()->CountBufferedOperations();
+}
+
 } // namespace
 
 void Executor::FlushAsync() {
@@ -1243,6 +1434,9 @@ void Executor::FlushAsync() {
   write_batch_.Clear();
   std::vector<std::pair<YBSessionPtr, ExecContext*>> flush_sessions;
   std::vector<ExecContext*> commit_contexts;
+  // Transactions committed together with the flush of their last writes. The commit is sent by
+  // the transaction as soon as the writes are done, saving a round of FlushAsync.
+  std::vector<ExecContext*> commit_with_flush_contexts;
   if (session_->CountBufferedOperations() > 0) {
     flush_sessions.push_back({session_, nullptr});
   }
@@ -1250,6 +1444,9 @@ void Executor::FlushAsync() {
     if (exec_context.HasTransaction()) {
       if (exec_context.transactional_session()->CountBufferedOperations() > 0) {
         flush_sessions.push_back({exec_context.transactional_session(), &exec_context});
+        if (CanCommitWithFlush(&exec_context)) {
+          commit_with_flush_contexts.push_back(&exec_context);
+        }
       } else if (!exec_context.HasPendingOperations()) {
         commit_contexts.push_back(&exec_context);
       }
@@ -1261,7 +1458,8 @@ void Executor::FlushAsync() {
   // and CommitTransaction() are called to avoid race condition of recursive FlushAsync() called
   // from FlushAsyncDone() and CommitDone().
   DCHECK_EQ(num_async_calls_, 0);
-  num_async_calls_ = flush_sessions.size() + commit_contexts.size();
+  num_async_calls_ =
+      flush_sessions.size() + commit_contexts.size() + commit_with_flush_contexts.size();
   num_flushes_ += flush_sessions.size();
   async_status_ = Status::OK();
   for (auto* exec_context : commit_contexts) {
@@ -1273,8 +1471,13 @@ void Executor::FlushAsync() {
     auto session = pair.first;
     auto exec_context = pair.second;
     TRACE("Flush Async");
-    session->FlushAsync([this, exec_context](const Status& s) {
-        FlushAsyncDone(s, exec_context);
+    session->FlushAsync([this, session, exec_context](const Status& s) {
+        FlushAsyncDone(session, s, exec_context);
+      });
+  }
+  for (auto* exec_context : commit_with_flush_contexts) {
+    exec_context->CommitTransaction([this, exec_context](const Status& s) {
+        CommitDone(s, exec_context);
       });
   }
 
@@ -1306,11 +1509,12 @@ void Executor::FlushAsync() {
 // ExecContexts, care must be taken so that the callbacks only update the individual ExecContexts.
 // Any update on data structures shared in Executor should either be protected by a mutex or
 // deferred to ProcessAsyncResults() that will be invoked exclusively.
-void Executor::FlushAsyncDone(Status s, ExecContext* exec_context) {
+void Executor::FlushAsyncDone(const YBSessionPtr& session, Status s, ExecContext* exec_context) {
   TRACE("Flush Async Done");
   // Process FlushAsync status for either transactional session in an ExecContext, or the
   // non-transactional session in the Executor for other ExecContexts with no transactional session.
-  const YBSessionPtr& session = exec_context != nullptr ? GetSession(exec_context) : session_;
+  // The transactional session is passed explicitly, since it could be already detached from
+  // exec_context by the commit issued together with this flush.
 
   // When any error occurs during the dispatching of YBOperation, YBSession saves the error and
   // returns IOError. When it happens, retrieves the errors and discard the IOError.
@@ -1579,6 +1783,17 @@ Result<bool> Executor::ProcessTnodeResults(TnodeContext* tnode_context) {
       continue;
     }
 
+    // Partitions or token ranges read in parallel are processed in order. The reads after one that
+    // is not finished are dropped, since their rows must come after the rest of it.
+    bool more_parallel_reads = false;
+    if (tnode_context->parallel_reads() > 0) {
+      if (!tnode_context->NextParallelRead()) {
+        op_itr = ops.erase(op_itr);
+        continue;
+      }
+      more_parallel_reads = tnode_context->parallel_reads() > 0;
+    }
+
     // Append the rows if present.
     if (!op->rows_data().empty()) {
       RETURN_NOT_OK(tnode_context->AppendRowsResult(std::make_shared<RowsResult>(op.get())));
@@ -1593,6 +1808,19 @@ Result<bool> Executor::ProcessTnodeResults(TnodeContext* tnode_context) {
       if (!select_stmt->child_select()) {
         DCHECK_EQ(op->type(), YBOperation::Type::QL_READ);
         const auto& read_op = std::static_pointer_cast<YBqlReadOp>(op);
+        if (more_parallel_reads) {
+          const QLResponsePB& response = read_op->response();
+          if (!response.has_paging_state() ||
+              (response.paging_state().next_partition_key().empty() &&
+               response.paging_state().next_row_key().empty())) {
+            // The next partition or token range is already read.
+            op_itr = ops.erase(op_itr);
+            continue;
+          }
+          // Continue reading this partition or token range, and read the following ones again
+          // after it.
+          tnode_context->DropParallelReads(read_op->mutable_request());
+        }
         if (VERIFY_RESULT(FetchMoreRows(select_stmt, read_op, tnode_context, exec_context_))) {
           op->mutable_response()->Clear();
           TRACE("Apply");
@@ -162,8 +162,9 @@ class Executor : public QLExprExecutor {
   // execution.
   void FlushAsync();
 
-  // Callback for FlushAsync.
-  void FlushAsyncDone(Status s, ExecContext* exec_context = nullptr);
+  // Callback for FlushAsync of session.
+  void FlushAsyncDone(const client::YBSessionPtr& session, Status s,
+                      ExecContext* exec_context = nullptr);
 
   // Callback for Commit.
   void CommitDone(Status s, ExecContext* exec_context);
@@ -190,6 +191,12 @@ class Executor : public QLExprExecutor {
   // Append rows result.
   CHECKED_STATUS AppendRowsResult(RowsResult::SharedPtr&& rows_result);
 
+  // Add the reads of a full-table or token-range scan, for a window of tablets read in parallel.
+  // Returns false if the scan is not read in parallel.
+  Result<bool> AddParallelScanOperations(const PTSelectStmt* tnode,
+                                         const client::YBqlReadOpPtr& select_op,
+                                         TnodeContext* tnode_context);
+
   // Continue a multi-partition select (e.g. table scan or query with 'IN' condition on hash cols).
   Result<bool> FetchMoreRows(const PTSelectStmt* tnode,
                              const client::YBqlReadOpPtr& op,
@@ -204,6 +211,11 @@ class Executor : public QLExprExecutor {
 
   // Aggregate all result sets from all tablet servers to form the requested resultset.
   CHECKED_STATUS AggregateResultSets(const PTSelectStmt* pt_select, TnodeContext* tnode_context);
+  // Aggregates rows into one result row appended to buffer.
+  CHECKED_STATUS AggregateRows(const PTSelectStmt* pt_select,
+                               const std::shared_ptr<QLRowBlock>& row_block,
+                               RowsResult* rows_result,
+                               faststring* buffer);
   CHECKED_STATUS EvalCount(const std::shared_ptr<QLRowBlock>& row_block,
                            int column_index,
                            QLValue *ql_value);
@@ -18,6 +18,7 @@
 #include "yb/yql/cql/ql/ptree/pt_select.h"
 
 #include <functional>
+#include <set>
 
 #include "yb/client/client.h"
 #include "yb/common/index.h"
@@ -319,7 +320,7 @@ CHECKED_STATUS PTSelectStmt::Analyze(SemContext *sem_context) {
       has_singular_expr = true;
     }
   }
-  if (has_aggregate_expr && has_singular_expr) {
+  if (has_aggregate_expr && has_singular_expr && group_by_clause_ == nullptr) {
     return sem_context->Error(
         selected_exprs_,
         "Selecting aggregate together with rows of non-aggregate values is not allowed",
@@ -327,14 +328,17 @@ CHECKED_STATUS PTSelectStmt::Analyze(SemContext *sem_context) {
   }
   is_aggregate_ = has_aggregate_expr;
 
+  RETURN_NOT_OK(AnalyzeGroupByClause(sem_context));
+
   // Run error checking on the WHERE conditions.
   RETURN_NOT_OK(AnalyzeWhereClause(sem_context));
 
   RETURN_NOT_OK(AnalyzeOrderByClause(sem_context));
 
   // Check if there is an index to use. If there is and it covers the query fully, we will query
-  // just the index and that is it.
-  if (index_id_.empty()) {
+  // just the index and that is it. Groups are formed by the partition key of the table, so an
+  // index is not used for a GROUP BY.
+  if (index_id_.empty() && !group_by_hash_key_) {
     RETURN_NOT_OK(AnalyzeIndexes(sem_context));
     if (child_select_ && child_select_->covers_fully_) {
       return Status::OK();
@@ -438,6 +442,62 @@ CHECKED_STATUS PTSelectStmt::AnalyzeIndexes(SemContext *sem_context) {
 
 // -------------------------------------------------------------------------------------------------
 
+CHECKED_STATUS PTSelectStmt::AnalyzeGroupByClause(SemContext *sem_context) {
+  if (group_by_clause_ == nullptr) {
+    return Status::OK();
+  }
+
+  if (!is_aggregate_) {
+    return sem_context->Error(group_by_clause_,
+                              "GROUP BY is only supported with aggregate functions",
+                              ErrorCode::FEATURE_NOT_SUPPORTED);
+  }
+  if (distinct_ || limit_clause_ != nullptr || offset_clause_ != nullptr) {
+    return sem_context->Error(group_by_clause_,
+                              "GROUP BY is not supported with DISTINCT, LIMIT or OFFSET",
+                              ErrorCode::FEATURE_NOT_SUPPORTED);
+  }
+
+  // Only grouping by the whole partition key is supported. All rows of such a group are in the
+  // same tablet, which evaluates the aggregates of the group while scanning.
+  std::set<int32_t> group_column_ids;
+  SemState sem_state(sem_context);
+  sem_state.set_allowing_column_refs(true);
+  for (const auto& node : group_by_clause_->node_list()) {
+    if (node->opcode() != TreeNodeOpcode::kPTRef) {
+      return sem_context->Error(node, "GROUP BY is only supported on partition key columns",
+                                ErrorCode::FEATURE_NOT_SUPPORTED);
+    }
+    RETURN_NOT_OK(node->Analyze(sem_context));
+    const ColumnDesc* desc = static_cast<const PTRef*>(node.get())->desc();
+    if (!desc->is_hash()) {
+      return sem_context->Error(node, "GROUP BY is only supported on partition key columns",
+                                ErrorCode::FEATURE_NOT_SUPPORTED);
+    }
+    group_column_ids.insert(desc->id());
+  }
+  if (group_column_ids.size() != static_cast<size_t>(num_hash_key_columns())) {
+    return sem_context->Error(group_by_clause_, "GROUP BY must list all partition key columns",
+                              ErrorCode::FEATURE_NOT_SUPPORTED);
+  }
+
+  for (const auto& expr_node : selected_exprs_->node_list()) {
+    if (expr_node->IsAggregateCall()) {
+      continue;
+    }
+    if (expr_node->opcode() != TreeNodeOpcode::kPTRef ||
+        !static_cast<const PTRef*>(expr_node.get())->desc()->is_hash()) {
+      return sem_context->Error(
+          expr_node,
+          "Only aggregates and partition key columns could be selected with GROUP BY",
+          ErrorCode::CQL_STATEMENT_INVALID);
+    }
+  }
+
+  group_by_hash_key_ = true;
+  return Status::OK();
+}
+
 CHECKED_STATUS PTSelectStmt::AnalyzeDistinctClause(SemContext *sem_context) {
   // Only partition and static columns are allowed to be used with distinct clause.
   int key_count = 0;
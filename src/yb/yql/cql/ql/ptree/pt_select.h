@@ -217,6 +217,11 @@ class PTSelectStmt : public PTDmlStmt {
     return is_aggregate_;
   }
 
+  // Whether aggregates are grouped by the partition key.
+  bool group_by_hash_key() const {
+    return group_by_hash_key_;
+  }
+
   const PTSelectStmt::SharedPtr& child_select() const {
     return child_select_;
   }
@@ -256,6 +261,7 @@ class PTSelectStmt : public PTDmlStmt {
  private:
   CHECKED_STATUS LookupIndex(SemContext *sem_context);
   CHECKED_STATUS AnalyzeIndexes(SemContext *sem_context);
+  CHECKED_STATUS AnalyzeGroupByClause(SemContext *sem_context);
   CHECKED_STATUS AnalyzeDistinctClause(SemContext *sem_context);
   CHECKED_STATUS AnalyzeOrderByClause(SemContext *sem_context);
   CHECKED_STATUS AnalyzeLimitClause(SemContext *sem_context);
@@ -287,6 +293,7 @@ class PTSelectStmt : public PTDmlStmt {
 
   bool is_forward_scan_ = true;
   bool is_aggregate_ = false;
+  bool group_by_hash_key_ = false;
 
   // Child select statement. Currently only a select statement using an index (covered or uncovered)
   // has a child select statement to query an index.
@@ -29,6 +29,9 @@ using std::unique_ptr;
 using std::shared_ptr;
 using strings::Substitute;
 
+DECLARE_int32(cql_max_parallel_partition_reads);
+DECLARE_int32(cql_parallel_read_min_rows);
+
 namespace yb {
 namespace ql {
 
@@ -46,6 +49,31 @@ class TestQLQuery : public QLTestBase {
     return row_block;
   }
 
+  // Reads all pages of select_stmt and returns the first two columns of the rows, in the order they
+  // are returned. The third column must be the product of the first two.
+  std::vector<std::pair<int, int>> ReadAllPages(TestQLProcessor *processor,
+                                                const string& select_stmt, int page_size) {
+    std::vector<std::pair<int, int>> rows;
+    StatementParameters params;
+    params.set_page_size(page_size);
+    do {
+      CHECK_OK(processor->Run(select_stmt, params));
+      std::shared_ptr<QLRowBlock> row_block = processor->row_block();
+      CHECK_LE(row_block->row_count(), page_size);
+      for (int j = 0; j < row_block->row_count(); j++) {
+        const QLRow& row = row_block->row(j);
+        CHECK_EQ(row.column(0).int32_value() * row.column(1).int32_value(),
+                 row.column(2).int32_value());
+        rows.emplace_back(row.column(0).int32_value(), row.column(1).int32_value());
+      }
+      if (processor->rows_result()->paging_state().empty()) {
+        break;
+      }
+      CHECK_OK(params.set_paging_state(processor->rows_result()->paging_state()));
+    } while (true);
+    return rows;
+  }
+
   void VerifyExpiry(TestQLProcessor *processor) {
     ExecSelect(processor, 0);
   }
@@ -840,6 +868,90 @@ TEST_F(TestQLQuery, TestPagingState) {
   }
 }
 
+TEST_F(TestQLQuery, TestParallelPartitionReads) {
+  // Init the simulated cluster.
+  ASSERT_NO_FATALS(CreateSimulatedCluster());
+
+  // Get a processor.
+  TestQLProcessor *processor = GetQLProcessor();
+
+  CHECK_VALID_STMT("CREATE TABLE t (h int, r int, v int, primary key((h), r));");
+
+  // Insert partitions of different sizes, so that some do not fit in their share of a page.
+  static constexpr int kNumPartitions = 20;
+  string in_list;
+  for (int h = 1; h <= kNumPartitions; h++) {
+    for (int r = 1; r <= h % 4; r++) {
+      CHECK_VALID_STMT(Substitute("INSERT INTO t (h, r, v) VALUES ($0, $1, $2);", h, r, h * r));
+    }
+    in_list += Substitute("$0$1", h == 1 ? "" : ", ", kNumPartitions + 1 - h);
+  }
+
+  // Pages of any size are split between the partitions read in parallel.
+  FLAGS_cql_parallel_read_min_rows = 1;
+
+  // Partitions read in parallel must return the same rows in the same order as when they are read
+  // one at a time.
+  for (const string& limit : {"", " LIMIT 17"}) {
+    const string select_stmt = Substitute("SELECT h, r, v FROM t WHERE h IN ($0) AND r > 0$1;",
+                                          in_list, limit);
+    for (int page_size : {1, 3, 8, 100}) {
+      FLAGS_cql_max_parallel_partition_reads = 1;
+      const auto expected_rows = ReadAllPages(processor, select_stmt, page_size);
+      CHECK_EQ(expected_rows.size(), limit.empty() ? 30 : 17);
+      for (int parallel_reads : {2, 4, 16}) {
+        FLAGS_cql_max_parallel_partition_reads = parallel_reads;
+        CHECK(ReadAllPages(processor, select_stmt, page_size) == expected_rows)
+            << "Rows differ with " << parallel_reads << " parallel reads and page size "
+            << page_size << limit;
+      }
+    }
+  }
+}
+
+TEST_F(TestQLQuery, TestParallelScan) {
+  // Init the simulated cluster.
+  ASSERT_NO_FATALS(CreateSimulatedCluster());
+
+  // Get a processor.
+  TestQLProcessor *processor = GetQLProcessor();
+
+  CHECK_VALID_STMT("CREATE TABLE t (h int, r int, v int, primary key((h), r));");
+
+  // Insert partitions of different sizes, so that tablets hold different numbers of rows.
+  static constexpr int kNumPartitions = 50;
+  int num_rows = 0;
+  for (int h = 1; h <= kNumPartitions; h++) {
+    for (int r = 1; r <= h % 5; r++) {
+      CHECK_VALID_STMT(Substitute("INSERT INTO t (h, r, v) VALUES ($0, $1, $2);", h, r, h * r));
+      num_rows++;
+    }
+  }
+
+  // Pages of any size are split between the tablets read in parallel.
+  FLAGS_cql_parallel_read_min_rows = 1;
+
+  // Tablets read in parallel must return the same rows in the same order as when they are read
+  // one at a time.
+  for (const string& where : {"", " WHERE token(h) > 0", " WHERE token(h) <= 0",
+                              " LIMIT 23"}) {
+    const string select_stmt = "SELECT h, r, v FROM t" + where + ";";
+    for (int page_size : {1, 4, 10, 1000}) {
+      FLAGS_cql_max_parallel_partition_reads = 1;
+      const auto expected_rows = ReadAllPages(processor, select_stmt, page_size);
+      if (where.empty()) {
+        CHECK_EQ(expected_rows.size(), num_rows);
+      }
+      for (int parallel_reads : {2, 3, 16}) {
+        FLAGS_cql_max_parallel_partition_reads = parallel_reads;
+        CHECK(ReadAllPages(processor, select_stmt, page_size) == expected_rows)
+            << "Rows differ with " << parallel_reads << " parallel reads and page size "
+            << page_size << " for " << select_stmt;
+      }
+    }
+  }
+}
+
 #define RUN_PAGINATION_WITH_DESC_TEST(processor, type, values, rows)                               \
 do {                                                                                               \
   /* Creating the table. */                                                                        \
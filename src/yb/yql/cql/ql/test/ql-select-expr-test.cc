@@ -2,6 +2,7 @@
 // Copyright (c) YugaByte, Inc.
 //--------------------------------------------------------------------------------------------------
 
+#include <set>
 #include <thread>
 #include <cmath>
 #include <limits>
@@ -313,6 +314,50 @@ TEST_F(QLTestSelectedExpr, TestAggregateExpr) {
   }
 }
 
+TEST_F(QLTestSelectedExpr, TestAggregateGroupByPartitionKey) {
+  // Init the simulated cluster.
+  ASSERT_NO_FATALS(CreateSimulatedCluster());
+
+  // Get a processor.
+  TestQLProcessor *processor = GetQLProcessor();
+
+  CHECK_VALID_STMT("CREATE TABLE test_aggr_group(h int, r int, v int, primary key(h, r));");
+  for (int h = 1; h <= 4; h++) {
+    for (int r = 1; r <= 3; r++) {
+      CHECK_VALID_STMT(strings::Substitute(
+          "INSERT INTO test_aggr_group(h, r, v) VALUES($0, $1, $2);", h, r, h * 10 + r));
+    }
+  }
+
+  CHECK_VALID_STMT("SELECT h, count(*), sum(v), avg(v), max(v) FROM test_aggr_group GROUP BY h;");
+  std::shared_ptr<QLRowBlock> row_block = processor->row_block();
+  CHECK_EQ(row_block->row_count(), 4);
+  std::set<int32_t> groups;
+  for (const auto& row : row_block->rows()) {
+    const int32_t h = row.column(0).int32_value();
+    groups.insert(h);
+    CHECK_EQ(row.column(1).int64_value(), 3);
+    CHECK_EQ(row.column(2).int32_value(), h * 30 + 6);
+    CHECK_EQ(row.column(3).int32_value(), h * 10 + 2);
+    CHECK_EQ(row.column(4).int32_value(), h * 10 + 3);
+  }
+  CHECK_EQ(groups.size(), 4);
+
+  // A group of a single partition.
+  CHECK_VALID_STMT("SELECT h, min(v) FROM test_aggr_group WHERE h = 2 GROUP BY h;");
+  row_block = processor->row_block();
+  CHECK_EQ(row_block->row_count(), 1);
+  CHECK_EQ(row_block->row(0).column(0).int32_value(), 2);
+  CHECK_EQ(row_block->row(0).column(1).int32_value(), 21);
+
+  // Only grouping of aggregates by the partition key is supported.
+  CHECK_INVALID_STMT("SELECT r, count(*) FROM test_aggr_group GROUP BY r;");
+  CHECK_INVALID_STMT("SELECT h, count(*) FROM test_aggr_group GROUP BY h, r;");
+  CHECK_INVALID_STMT("SELECT h, r FROM test_aggr_group GROUP BY h;");
+  CHECK_INVALID_STMT("SELECT r, count(*) FROM test_aggr_group GROUP BY h;");
+  CHECK_INVALID_STMT("SELECT h, count(*) FROM test_aggr_group GROUP BY h LIMIT 1;");
+}
+
 TEST_F(QLTestSelectedExpr, TestAggregateExprWithNull) {
   // Init the simulated cluster.
   ASSERT_NO_FATALS(CreateSimulatedCluster());
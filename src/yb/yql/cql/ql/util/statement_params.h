@@ -66,6 +66,8 @@ class StatementParameters {
 
   int64_t next_partition_index() const { return paging_state().next_partition_index(); }
 
+  uint64_t cursor_id() const { return paging_state().cursor_id(); }
+
   // Retrieve a bind variable for the execution of the statement. To be overridden by subclasses
   // to return actual bind variables.
   virtual CHECKED_STATUS GetBindVariable(const std::string& name,
@@ -186,7 +186,11 @@ RowsResult::~RowsResult() {
 
 Status RowsResult::Append(RowsResult&& other) {
   column_schemas_ = std::move(other.column_schemas_);
-  if (rows_data_.empty()) {
+  // Rows are kept in the CQL wire format, so they are only spliced here. Take over the rows of
+  // the other result when there are no rows yet to avoid copying them.
+  if (rows_data_.empty() ||
+      (!other.rows_data_.empty() &&
+       VERIFY_RESULT(QLRowBlock::GetRowCount(client_, rows_data_)) == 0)) {
     rows_data_ = std::move(other.rows_data_);
   } else {
     RETURN_NOT_OK(QLRowBlock::AppendRowsData(other.client_, other.rows_data_, &rows_data_));
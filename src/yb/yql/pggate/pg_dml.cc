@@ -69,6 +69,9 @@ Status PgDml::AppendTarget(PgExpr *target) {
   // Prepare expression. Except for constants and place_holders, all other expressions can be
   // evaluate just one time during prepare.
   RETURN_NOT_OK(target->PrepareForRead(this, expr_pb));
+  if (target->is_aggregate()) {
+    RETURN_NOT_OK(AppendAggregateTarget(target));
+  }
 
   // Link the given expression "attr_value" with the allocated protobuf. Note that except for
   // constants and place_holders, all other expressions can be setup just one time during prepare.
@@ -79,6 +82,34 @@ Status PgDml::AppendTarget(PgExpr *target) {
   return Status::OK();
 }
 
+Status PgDml::AppendQual(PgExpr *qual) {
+  if (!qual->is_condition()) {
+    return STATUS(InvalidArgument, "Only conditions can be used to filter rows");
+  }
+  if (stmt_op() != StmtOp::STMT_SELECT) {
+    return STATUS(NotSupported, "Filtering rows in DocDB is only supported in SELECT");
+  }
+
+  // Prepare the condition aside, so that a condition DocDB cannot evaluate is not sent partially.
+  PgsqlExpressionPB prepared_pb;
+  RETURN_NOT_OK(qual->PrepareForRead(this, &prepared_pb));
+  PgsqlExpressionPB *qual_pb = AllocQualPB();
+  qual_pb->Swap(&prepared_pb);
+
+  // Constants in the condition are updated before each execution, like those of targets.
+  expr_binds_[qual_pb] = qual;
+  return Status::OK();
+}
+
+PgsqlExpressionPB *PgDml::AllocQualPB() {
+  LOG(FATAL) << "Pure virtual function is being call";
+  return nullptr;
+}
+
+Status PgDml::AppendAggregateTarget(PgExpr *target) {
+  return STATUS(NotSupported, "Aggregates are only supported in SELECT");
+}
+
 Status PgDml::PrepareColumnForRead(int attr_num, PgsqlExpressionPB *target_pb,
                                    const PgColumn **col) {
   *col = nullptr;
@@ -273,7 +304,14 @@ Status PgDml::Fetch(int32_t natts,
 
 
 Status PgDml::WritePgTuple(PgTuple *pg_tuple) {
-  for (const PgExpr *target : targets_) {
+  for (size_t index = 0; index < targets_.size(); index++) {
+    const PgExpr *target = targets_[index];
+    if (target->is_aggregate()) {
+      // Aggregates have no attribute, so they are written at their position in the target list.
+      PgWireDataHeader header = PgDocData::ReadDataHeader(&cursor_);
+      target->TranslateData(&cursor_, header, index, pg_tuple);
+      continue;
+    }
     if (target->opcode() != PgColumnRef::Opcode::PG_EXPR_COLREF) {
       return STATUS(InternalError, "Unexpected expression, only column refs supported here");
     }
@@ -33,6 +33,9 @@ class PgDml : public PgStatement {
   // Append a target in SELECT or RETURNING.
   CHECKED_STATUS AppendTarget(PgExpr *target);
 
+  // Append a condition of the WHERE clause, to filter rows in DocDB. Conditions are ANDed.
+  CHECKED_STATUS AppendQual(PgExpr *qual);
+
   // Find the column associated with the given "attr_num".
   CHECKED_STATUS FindColumn(int attr_num, PgColumn **col);
 
@@ -73,6 +76,12 @@ class PgDml : public PgStatement {
   // Allocate protobuf for a SELECTed expression.
   virtual PgsqlExpressionPB *AllocTargetPB() = 0;
 
+  // Register an aggregate target that has been prepared for DocDB.
+  virtual CHECKED_STATUS AppendAggregateTarget(PgExpr *target);
+
+  // Allocate protobuf for a condition of the WHERE clause. Only SELECT filters rows in DocDB.
+  virtual PgsqlExpressionPB *AllocQualPB();
+
   // Allocate protobuf for expression whose value is bounded to a column.
   virtual PgsqlExpressionPB *AllocColumnBindPB(PgColumn *col) = 0;
 
@@ -14,6 +14,30 @@
 
 #include "yb/yql/pggate/pg_doc_op.h"
 
+#include "yb/client/client.h"
+
+#include "yb/common/partition.h"
+#include "yb/common/pgsql_resultset.h"
+
+#include "yb/util/faststring.h"
+#include "yb/util/flag_tags.h"
+
+#include "yb/yql/pggate/pg_expr.h"
+#include "yb/yql/pggate/util/pg_doc_data.h"
+
+DEFINE_int32(ysql_prefetch_pages, 2,
+             "Maximum number of pages of a YSQL read that are fetched ahead of the pages consumed "
+             "by PostgreSQL. The next page is requested as soon as a page arrives while fewer "
+             "pages are cached. 1 to request the next page only after the cache is consumed.");
+TAG_FLAG(ysql_prefetch_pages, advanced);
+TAG_FLAG(ysql_prefetch_pages, runtime);
+
+DEFINE_int32(ysql_max_parallel_tablet_reads, 4,
+             "Maximum number of tablets read in parallel by a YSQL full-table scan of a "
+             "hash-partitioned table. 1 to read tablets one after another.");
+TAG_FLAG(ysql_max_parallel_tablet_reads, advanced);
+TAG_FLAG(ysql_max_parallel_tablet_reads, runtime);
+
 using std::shared_ptr;
 
 namespace yb {
@@ -99,8 +123,8 @@ Status PgDocOp::GetResult(string *result_set) {
   // Read from cache.
   ReadFromCacheUnlocked(result_set);
 
-  // This will pre-fetch the next chunk of data if we've consumed all cached
-  // rows.
+  // This will pre-fetch the next chunk of data if fewer pages than the prefetch depth are left
+  // in the cache.
   RETURN_NOT_OK(SendRequestIfNeededUnlocked());
 
   return Status::OK();
@@ -115,15 +139,21 @@ void PgDocOp::WriteToCacheUnlocked(std::shared_ptr<client::YBPgsqlOp> yb_op) {
 
 void PgDocOp::ReadFromCacheUnlocked(string *result) {
   if (!result_cache_.empty()) {
-    *result = result_cache_.front();
+    // The page is moved out rather than copied, the reader decodes rows in place from it.
+    *result = std::move(result_cache_.front());
     result_cache_.pop_front();
     has_cached_data_ = !result_cache_.empty();
   }
 }
 
+bool PgDocOp::ShouldPrefetchUnlocked() const {
+  return result_cache_.size() < std::max(FLAGS_ysql_prefetch_pages, 1);
+}
+
 Status PgDocOp::SendRequestIfNeededUnlocked() {
-  // Request more data if more execution is needed and cache is empty.
-  if (!has_cached_data_ && !end_of_data_ && !waiting_for_response_) {
+  // Request more data if more execution is needed and fewer pages than the prefetch depth are
+  // cached.
+  if (ShouldPrefetchUnlocked() && !end_of_data_ && !waiting_for_response_) {
     return SendRequestUnlocked();
   }
   return Status::OK();
@@ -153,26 +183,115 @@ bool PgDocOp::CheckRestartUnlocked(client::YBPgsqlOp* op) {
 //--------------------------------------------------------------------------------------------------
 
 PgDocReadOp::PgDocReadOp(
-    PgSession::ScopedRefPtr pg_session, uint64_t* read_time, client::YBPgsqlReadOp *read_op)
-    : PgDocOp(pg_session, read_time), read_op_(read_op) {
+    PgSession::ScopedRefPtr pg_session, uint64_t* read_time,
+    const std::shared_ptr<client::YBTable>& table)
+    : PgDocOp(pg_session, read_time), table_(table), read_op_(table->NewPgsqlSelect()) {
 }
 
 PgDocReadOp::~PgDocReadOp() {
 }
 
+void PgDocReadOp::AddAggregate(bfpg::TSOpcode opcode, InternalType type) {
+  aggregates_.push_back(Aggregate{opcode, type});
+}
+
+Status PgDocReadOp::SetYBCtidBatch(const std::vector<std::string>& ybctids) {
+  std::vector<YBCtidRead> batch;
+  batch.reserve(ybctids.size());
+  for (const auto& ybctid : ybctids) {
+    uint16_t hash_code;
+    RETURN_NOT_OK(PgExpr::ReadHashValue(ybctid.data(), ybctid.size(), &hash_code));
+    batch.push_back(YBCtidRead{ybctid, hash_code});
+  }
+
+  std::lock_guard<std::mutex> lock(mtx_);
+  ybctid_batch_.swap(batch);
+  return Status::OK();
+}
+
 void PgDocReadOp::InitUnlocked(std::unique_lock<std::mutex>* lock) {
+  // A prefetched page could still be in flight when the statement is executed again.
+  while (waiting_for_response_) {
+    cv_.wait(*lock);
+  }
   PgDocOp::InitUnlocked(lock);
+  aggregate_results_.clear();
+  aggregate_results_.resize(aggregates_.size());
 
   PgsqlReadRequestPB *req = read_op_->mutable_request();
   req->set_limit(kPrefetchLimit);
   req->set_return_paging_state(true);
+  // The paging state left by the previous execution, or by a page prefetched for it.
+  req->clear_paging_state();
+
+  active_ops_.clear();
+  if (!ybctid_batch_.empty()) {
+    InitYBCtidBatchUnlocked();
+  } else if (FLAGS_ysql_max_parallel_tablet_reads > 1 && CanScanInParallel()) {
+    InitParallelScanUnlocked();
+  } else {
+    active_ops_.push_back(read_op_);
+  }
+}
+
+bool PgDocReadOp::CanScanInParallel() const {
+  // Only full-table scans are split. Reads by key go to their tablets, and index scans return
+  // rows in the order of the index.
+  const PgsqlReadRequestPB& req = read_op_->request();
+  return table_->partition_schema().IsHashPartitioning() &&
+         table_->GetPartitions().size() > 1 &&
+         req.partition_column_values().empty() &&
+         req.range_column_values().empty() &&
+         !req.has_ybctid_column_value() &&
+         !req.has_index_request() &&
+         !req.has_hash_code() &&
+         !req.has_max_hash_code() &&
+         req.is_forward_scan();
+}
+
+void PgDocReadOp::InitParallelScanUnlocked() {
+  const std::vector<std::string>& partitions = table_->GetPartitions();
+  const size_t num_reads = std::min<size_t>(FLAGS_ysql_max_parallel_tablet_reads,
+                                            partitions.size());
+  // Each read covers the hash range of consecutive tablets, so the results stay correct when the
+  // partitions of the table are stale.
+  for (size_t i = 0; i < num_reads; i++) {
+    const size_t begin = partitions.size() * i / num_reads;
+    const size_t end = partitions.size() * (i + 1) / num_reads;
+    std::shared_ptr<client::YBPgsqlReadOp> op(table_->NewPgsqlSelect());
+    PgsqlReadRequestPB* req = op->mutable_request();
+    req->CopyFrom(read_op_->request());
+    if (begin > 0) {
+      req->set_hash_code(PartitionSchema::DecodeMultiColumnHashValue(partitions[begin]));
+    }
+    if (end < partitions.size()) {
+      req->set_max_hash_code(PartitionSchema::DecodeMultiColumnHashValue(partitions[end]) - 1);
+    }
+    active_ops_.push_back(std::move(op));
+  }
+}
+
+void PgDocReadOp::InitYBCtidBatchUnlocked() {
+  for (const auto& read : ybctid_batch_) {
+    std::shared_ptr<client::YBPgsqlReadOp> op(table_->NewPgsqlSelect());
+    PgsqlReadRequestPB* req = op->mutable_request();
+    req->CopyFrom(read_op_->request());
+    req->mutable_ybctid_column_value()->mutable_value()->set_binary_value(read.ybctid);
+    req->set_hash_code(read.hash_code);
+    req->clear_partition_column_values();
+    req->clear_range_column_values();
+    active_ops_.push_back(std::move(op));
+  }
 }
 
 Status PgDocReadOp::SendRequestUnlocked() {
   CHECK(!waiting_for_response_);
 
-  SCHECK_EQ(VERIFY_RESULT(pg_session_->PgApplyAsync(read_op_, read_time_)), OpBuffered::kFalse,
-            IllegalState, "YSQL read operation should not be buffered");
+  // The reads of all tablet ranges that have more pages are flushed together.
+  for (const auto& op : active_ops_) {
+    SCHECK_EQ(VERIFY_RESULT(pg_session_->PgApplyAsync(op, read_time_)), OpBuffered::kFalse,
+              IllegalState, "YSQL read operation should not be buffered");
+  }
 
   waiting_for_response_ = true;
   Status s = pg_session_->PgFlushAsync([this](const Status& s) {
@@ -192,37 +311,161 @@ void PgDocReadOp::ReceiveResponse(Status exec_status) {
   waiting_for_response_ = false;
   exec_status_ = exec_status;
 
-  if (exec_status.ok() && CheckRestartUnlocked(read_op_.get())) {
-    return;
+  // When a read requires a restart, the reads of all tablet ranges are sent again at the new read
+  // time and the results of the others are dropped.
+  for (const auto& op : active_ops_) {
+    if (!exec_status_.ok()) {
+      break;
+    }
+    if (CheckRestartUnlocked(op.get())) {
+      return;
+    }
   }
 
   // exec_status_ could be changed by CheckRestartUnlocked
-  if (!exec_status_.ok()) {
+  if (!exec_status_.ok() || is_canceled_) {
     end_of_data_ = true;
     return;
   }
 
-  if (!is_canceled_) {
-    // Save it to cache.
-    WriteToCacheUnlocked(read_op_);
-
-    // Setup request for the next batch of data.
-    const PgsqlResponsePB& res = read_op_->response();
-     if (res.has_paging_state()) {
-       PgsqlReadRequestPB *req = read_op_->mutable_request();
-       // Set up paging state for next request.
-       *req->mutable_paging_state() = res.paging_state();
-       // Parse/Analysis/Rewrite catalog version has already been checked on the first request.
-       // The docdb layer will check the target table's schema version is compatible.
-       // This allows long-running queries to continue in the presence of other DDL statements
-       // as long as they do not affect the table(s) being queried.
-       req->clear_ysql_catalog_version();
-     } else {
-      end_of_data_ = true;
+  size_t num_active_ops = 0;
+  for (auto& op : active_ops_) {
+    // Save it to cache. Partial aggregates are held back until all tablets are read.
+    if (aggregates_.empty()) {
+      WriteToCacheUnlocked(op);
+    } else {
+      exec_status_ = MergeAggregatesUnlocked(op->rows_data());
+      if (!exec_status_.ok()) {
+        end_of_data_ = true;
+        return;
+      }
+    }
+
+    // Keep the reads that have more pages.
+    if (SetupNextPageUnlocked(op.get())) {
+      active_ops_[num_active_ops++].swap(op);
+    }
+  }
+  active_ops_.resize(num_active_ops);
+
+  if (active_ops_.empty()) {
+    if (!aggregates_.empty()) {
+      exec_status_ = WriteAggregatesToCacheUnlocked();
     }
-  } else {
     end_of_data_ = true;
+    return;
   }
+
+  // Request the next page right away without waiting for the reader to consume this one, unless
+  // enough pages are cached already. There is no data for the reader to consume until all tablets
+  // are read for aggregates, so they always go on to the next tablet.
+  if (!aggregates_.empty() || ShouldPrefetchUnlocked()) {
+    exec_status_ = SendRequestUnlocked();
+    if (!exec_status_.ok()) {
+      end_of_data_ = true;
+    }
+  }
+}
+
+bool PgDocReadOp::SetupNextPageUnlocked(client::YBPgsqlReadOp* op) {
+  const PgsqlResponsePB& res = op->response();
+  if (!res.has_paging_state()) {
+    return false;
+  }
+
+  PgsqlReadRequestPB *req = op->mutable_request();
+  // The read of a range of tablets in a parallel scan is done when it reaches the next range.
+  const string& next_partition_key = res.paging_state().next_partition_key();
+  if (req->has_max_hash_code() && !next_partition_key.empty() &&
+      PartitionSchema::DecodeMultiColumnHashValue(next_partition_key) > req->max_hash_code()) {
+    return false;
+  }
+
+  // Set up paging state for next request.
+  *req->mutable_paging_state() = res.paging_state();
+  // Parse/Analysis/Rewrite catalog version has already been checked on the first request.
+  // The docdb layer will check the target table's schema version is compatible.
+  // This allows long-running queries to continue in the presence of other DDL statements
+  // as long as they do not affect the table(s) being queried.
+  req->clear_ysql_catalog_version();
+  return true;
+}
+
+Status PgDocReadOp::MergeAggregatesUnlocked(const string& rows_data) {
+  if (rows_data.empty()) {
+    return Status::OK();
+  }
+
+  Slice cursor;
+  int64_t row_count = 0;
+  RETURN_NOT_OK(PgDocData::LoadCache(rows_data, &row_count, &cursor));
+  for (int64_t row = 0; row < row_count; row++) {
+    for (size_t i = 0; i < aggregates_.size(); i++) {
+      QLValue value;
+      RETURN_NOT_OK(PgDocData::ReadColumn(aggregates_[i].type, &cursor, &value));
+      if (value.IsNull()) {
+        continue;
+      }
+
+      QLValue* result = &aggregate_results_[i];
+      if (result->IsNull()) {
+        *result = std::move(value);
+        continue;
+      }
+      switch (aggregates_[i].opcode) {
+        case bfpg::TSOpcode::kCount:
+          result->set_int64_value(result->int64_value() + value.int64_value());
+          break;
+        case bfpg::TSOpcode::kSum:
+          switch (result->type()) {
+            case InternalType::kInt64Value:
+              result->set_int64_value(result->int64_value() + value.int64_value());
+              break;
+            case InternalType::kFloatValue:
+              result->set_float_value(result->float_value() + value.float_value());
+              break;
+            case InternalType::kDoubleValue:
+              result->set_double_value(result->double_value() + value.double_value());
+              break;
+            default:
+              return STATUS_FORMAT(NotSupported, "Cannot combine SUM of type $0", result->type());
+          }
+          break;
+        case bfpg::TSOpcode::kMin:
+          if (value < *result) {
+            *result = std::move(value);
+          }
+          break;
+        case bfpg::TSOpcode::kMax:
+          if (value > *result) {
+            *result = std::move(value);
+          }
+          break;
+        default:
+          return STATUS_FORMAT(NotSupported, "Cannot combine aggregate $0",
+                               static_cast<int>(aggregates_[i].opcode));
+      }
+    }
+  }
+  return Status::OK();
+}
+
+Status PgDocReadOp::WriteAggregatesToCacheUnlocked() {
+  PgsqlResultSet result_set;
+  PgsqlRSRow* row = result_set.AllocateRSRow(aggregates_.size());
+  for (size_t i = 0; i < aggregates_.size(); i++) {
+    if (aggregates_[i].opcode == bfpg::TSOpcode::kCount && aggregate_results_[i].IsNull()) {
+      // Tablets without matching rows return nothing, but COUNT of no rows is 0 rather than NULL.
+      aggregate_results_[i].set_int64_value(0);
+    }
+    *row->rscol(i) = std::move(aggregate_results_[i]);
+  }
+
+  faststring buffer;
+  RETURN_NOT_OK(PgDocData::WriteTuples(result_set, &buffer));
+  result_cache_.push_back(buffer.ToString());
+  has_cached_data_ = true;
+  return Status::OK();
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -19,6 +19,7 @@
 #include <condition_variable>
 
 #include "yb/util/locks.h"
+#include "yb/util/bfpg/tserver_opcodes.h"
 #include "yb/client/yb_op.h"
 #include "yb/yql/pggate/pg_session.h"
 
@@ -67,8 +68,12 @@ class PgDocOp {
   void WriteToCacheUnlocked(std::shared_ptr<client::YBPgsqlOp> yb_op);
   void ReadFromCacheUnlocked(string* result);
 
-  // Send another request if no request is pending and we've already consumed
-  // all data in the cache.
+  // Whether the next page should be requested, i.e. fewer than FLAGS_ysql_prefetch_pages pages
+  // are cached.
+  bool ShouldPrefetchUnlocked() const;
+
+  // Send another request if no request is pending and fewer pages than the prefetch depth are
+  // cached.
   CHECKED_STATUS SendRequestIfNeededUnlocked();
 
   // Checks whether op causes restart. Could set exec_status_.
@@ -121,7 +126,8 @@ class PgDocReadOp : public PgDocOp {
 
   // Constructors & Destructors.
   PgDocReadOp(
-      PgSession::ScopedRefPtr pg_session, uint64_t* read_time, client::YBPgsqlReadOp *read_op);
+      PgSession::ScopedRefPtr pg_session, uint64_t* read_time,
+      const std::shared_ptr<client::YBTable>& table);
   virtual ~PgDocReadOp();
 
   // Access function.
@@ -129,14 +135,68 @@ class PgDocReadOp : public PgDocOp {
     return read_op_;
   }
 
+  // Adds an aggregate target, computed by each tablet over its rows. The partial results of all
+  // tablets are combined here and returned as a single row after the last tablet is read.
+  void AddAggregate(bfpg::TSOpcode opcode, InternalType type);
+
+  size_t num_aggregates() const {
+    return aggregates_.size();
+  }
+
+  // Reads the rows with the given ybctids instead of the single bound ybctid. The reads of all
+  // rows are sent together, and the batcher groups them into one RPC per tablet.
+  CHECKED_STATUS SetYBCtidBatch(const std::vector<std::string>& ybctids);
+
  private:
+  struct Aggregate {
+    bfpg::TSOpcode opcode;
+    InternalType type;
+  };
+
+  struct YBCtidRead {
+    std::string ybctid;
+    uint16_t hash_code;
+  };
+
   // Process response from DocDB.
   void InitUnlocked(std::unique_lock<std::mutex>* lock) override;
   CHECKED_STATUS SendRequestUnlocked() override;
   virtual void ReceiveResponse(Status exec_status);
 
-  // Operator.
+  // Whether the read is a full-table scan of a hash-partitioned table, that could be split into
+  // reads of ranges of tablets.
+  bool CanScanInParallel() const;
+
+  // Splits the scan into at most FLAGS_ysql_max_parallel_tablet_reads reads of consecutive
+  // tablets, that are sent together.
+  void InitParallelScanUnlocked();
+
+  // Sets up a read of each row of ybctid_batch_, that are sent together.
+  void InitYBCtidBatchUnlocked();
+
+  // Sets up op to read its next page. Returns false when op has no more pages to read.
+  bool SetupNextPageUnlocked(client::YBPgsqlReadOp* op);
+
+  // Combines the partial aggregate row returned by a tablet with the results collected so far.
+  CHECKED_STATUS MergeAggregatesUnlocked(const string& rows_data);
+
+  // Writes the combined aggregate row to the result cache.
+  CHECKED_STATUS WriteAggregatesToCacheUnlocked();
+
+  std::shared_ptr<client::YBTable> table_;
+
+  // Operator. Its request is also the template of the reads of a parallel scan.
   std::shared_ptr<client::YBPgsqlReadOp> read_op_;
+
+  // Reads of the current execution that have more pages, read_op_ itself unless the scan is split
+  // into reads of ranges of tablets.
+  std::vector<std::shared_ptr<client::YBPgsqlReadOp>> active_ops_;
+
+  // Rows to read by ybctid, empty unless the statement reads a batch of rows by their ybctids.
+  std::vector<YBCtidRead> ybctid_batch_;
+
+  std::vector<Aggregate> aggregates_;
+  std::vector<QLValue> aggregate_results_;
 };
 
 class PgDocWriteOp : public PgDocOp {
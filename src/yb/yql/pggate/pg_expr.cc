@@ -42,6 +42,11 @@ const std::unordered_map<string, PgExpr::Opcode> kOperatorNames = {
   { ">=", PgExpr::Opcode::PG_EXPR_GE },
   { "<", PgExpr::Opcode::PG_EXPR_LT },
   { "<=", PgExpr::Opcode::PG_EXPR_LE },
+  { "and", PgExpr::Opcode::PG_EXPR_AND },
+  { "or", PgExpr::Opcode::PG_EXPR_OR },
+  { "is_null", PgExpr::Opcode::PG_EXPR_IS_NULL },
+  { "is_not_null", PgExpr::Opcode::PG_EXPR_IS_NOT_NULL },
+  { "in", PgExpr::Opcode::PG_EXPR_IN },
 
   { "avg", PgExpr::Opcode::PG_EXPR_AVG },
   { "sum", PgExpr::Opcode::PG_EXPR_SUM },
@@ -146,7 +151,8 @@ void PgExpr::TranslateDecimal(Slice *yb_cursor, const PgWireDataHeader& header,
   size_t read_size = PgDocData::ReadNumber(yb_cursor, &data_size);
   yb_cursor->remove_prefix(read_size);
 
-  std::string serialized_decimal = yb_cursor->ToBuffer();
+  // Only the value itself is copied, the cursor points to the rest of the rows as well.
+  std::string serialized_decimal(yb_cursor->cdata(), data_size);
   yb_cursor->remove_prefix(data_size);
 
   util::Decimal yb_decimal;
@@ -581,6 +587,197 @@ void PgOperator::AppendArg(PgExpr *arg) {
   args_.push_back(arg);
 }
 
+Result<bfpg::TSOpcode> PgOperator::AggregateOpcode() const {
+  switch (opcode_) {
+    case Opcode::PG_EXPR_COUNT:
+      return bfpg::TSOpcode::kCount;
+    case Opcode::PG_EXPR_SUM:
+      return bfpg::TSOpcode::kSum;
+    case Opcode::PG_EXPR_MAX:
+      return bfpg::TSOpcode::kMax;
+    case Opcode::PG_EXPR_MIN:
+      return bfpg::TSOpcode::kMin;
+    default:
+      // AVG cannot be combined from partial results without keeping both sum and count.
+      return STATUS_FORMAT(NotSupported, "Operator $0 cannot be pushed down to DocDB", opname_);
+  }
+}
+
+Result<QLOperator> PgOperator::ConditionOperator() const {
+  switch (opcode_) {
+    case Opcode::PG_EXPR_NOT:
+      return QL_OP_NOT;
+    case Opcode::PG_EXPR_EQ:
+      return QL_OP_EQUAL;
+    case Opcode::PG_EXPR_NE:
+      return QL_OP_NOT_EQUAL;
+    case Opcode::PG_EXPR_GE:
+      return QL_OP_GREATER_THAN_EQUAL;
+    case Opcode::PG_EXPR_GT:
+      return QL_OP_GREATER_THAN;
+    case Opcode::PG_EXPR_LE:
+      return QL_OP_LESS_THAN_EQUAL;
+    case Opcode::PG_EXPR_LT:
+      return QL_OP_LESS_THAN;
+    case Opcode::PG_EXPR_AND:
+      return QL_OP_AND;
+    case Opcode::PG_EXPR_OR:
+      return QL_OP_OR;
+    case Opcode::PG_EXPR_IS_NULL:
+      return QL_OP_IS_NULL;
+    case Opcode::PG_EXPR_IS_NOT_NULL:
+      return QL_OP_IS_NOT_NULL;
+    case Opcode::PG_EXPR_IN:
+      return QL_OP_IN;
+    default:
+      return STATUS_FORMAT(NotSupported, "Operator $0 is not a condition", opname_);
+  }
+}
+
+Status PgOperator::PrepareForRead(PgDml *pg_stmt, PgsqlExpressionPB *expr_pb) {
+  if (is_condition()) {
+    return PrepareConditionForRead(pg_stmt, expr_pb);
+  }
+  return PrepareAggregateForRead(pg_stmt, expr_pb);
+}
+
+Status PgOperator::PrepareConditionForRead(PgDml *pg_stmt, PgsqlExpressionPB *expr_pb) {
+  const QLOperator op = VERIFY_RESULT(ConditionOperator());
+  const auto is_operand = [](PgExpr *arg) {
+    return arg->opcode() == Opcode::PG_EXPR_COLREF || arg->is_constant();
+  };
+
+  switch (opcode_) {
+    case Opcode::PG_EXPR_NOT: FALLTHROUGH_INTENDED;
+    case Opcode::PG_EXPR_AND: FALLTHROUGH_INTENDED;
+    case Opcode::PG_EXPR_OR:
+      if (args_.empty() || (opcode_ == Opcode::PG_EXPR_NOT && args_.size() != 1)) {
+        return STATUS_FORMAT(InvalidArgument, "Wrong number of arguments for $0", opname_);
+      }
+      for (PgExpr *arg : args_) {
+        if (!arg->is_condition()) {
+          return STATUS_FORMAT(NotSupported, "Arguments of $0 must be conditions", opname_);
+        }
+      }
+      break;
+
+    case Opcode::PG_EXPR_IS_NULL: FALLTHROUGH_INTENDED;
+    case Opcode::PG_EXPR_IS_NOT_NULL:
+      if (args_.size() != 1 || args_[0]->opcode() != Opcode::PG_EXPR_COLREF) {
+        return STATUS_FORMAT(NotSupported, "Argument of $0 must be a column", opname_);
+      }
+      break;
+
+    case Opcode::PG_EXPR_IN:
+      if (args_.size() < 2 || args_[0]->opcode() != Opcode::PG_EXPR_COLREF) {
+        return STATUS_FORMAT(NotSupported, "$0 must compare a column with a list", opname_);
+      }
+      for (size_t i = 1; i < args_.size(); i++) {
+        if (!args_[i]->is_constant() || args_[i]->internal_type() != args_[0]->internal_type()) {
+          return STATUS_FORMAT(NotSupported, "$0 list must hold constants of the column type",
+                               opname_);
+        }
+      }
+      break;
+
+    default:
+      if (args_.size() != 2) {
+        return STATUS_FORMAT(InvalidArgument, "Wrong number of arguments for $0", opname_);
+      }
+      if (!is_operand(args_[0]) || !is_operand(args_[1]) ||
+          args_[0]->internal_type() != args_[1]->internal_type()) {
+        return STATUS_FORMAT(NotSupported, "Cannot push down $0 of different types", opname_);
+      }
+      // DocDB orders strings by their bytes, which does not follow the collation of Postgres.
+      if (args_[0]->internal_type() == InternalType::kStringValue &&
+          opcode_ != Opcode::PG_EXPR_EQ && opcode_ != Opcode::PG_EXPR_NE) {
+        return STATUS_FORMAT(NotSupported, "Cannot push down $0 of strings", opname_);
+      }
+      break;
+  }
+
+  auto* condition = expr_pb->mutable_condition();
+  condition->set_op(op);
+  if (opcode_ == Opcode::PG_EXPR_IN) {
+    RETURN_NOT_OK(args_[0]->PrepareForRead(pg_stmt, condition->add_operands()));
+    condition->add_operands()->mutable_value()->mutable_list_value();
+  } else {
+    for (PgExpr *arg : args_) {
+      RETURN_NOT_OK(arg->PrepareForRead(pg_stmt, condition->add_operands()));
+    }
+  }
+  return Eval(pg_stmt, expr_pb);
+}
+
+Status PgOperator::Eval(PgDml *pg_stmt, PgsqlExpressionPB *expr_pb) {
+  if (!is_condition()) {
+    return Status::OK();
+  }
+
+  auto* condition = expr_pb->mutable_condition();
+  if (opcode_ == Opcode::PG_EXPR_IN) {
+    auto* list = condition->mutable_operands(1)->mutable_value()->mutable_list_value();
+    list->clear_elems();
+    for (size_t i = 1; i < args_.size(); i++) {
+      PgsqlExpressionPB elem;
+      RETURN_NOT_OK(args_[i]->Eval(pg_stmt, &elem));
+      list->add_elems()->Swap(elem.mutable_value());
+    }
+    return Status::OK();
+  }
+
+  for (size_t i = 0; i < args_.size(); i++) {
+    RETURN_NOT_OK(args_[i]->Eval(pg_stmt, condition->mutable_operands(i)));
+  }
+  return Status::OK();
+}
+
+Status PgOperator::PrepareAggregateForRead(PgDml *pg_stmt, PgsqlExpressionPB *expr_pb) {
+  const auto tsopcode = VERIFY_RESULT(AggregateOpcode());
+
+  // DocDB returns COUNT and integer SUM as bigint, and MIN and MAX in the type of the argument.
+  switch (type_entity_->yb_type) {
+    case YB_YQL_DATA_TYPE_INT8:
+      translate_data_ = TranslateNumber<int8_t>;
+      break;
+    case YB_YQL_DATA_TYPE_INT16:
+      translate_data_ = TranslateNumber<int16_t>;
+      break;
+    case YB_YQL_DATA_TYPE_INT32:
+      translate_data_ = TranslateNumber<int32_t>;
+      break;
+    case YB_YQL_DATA_TYPE_INT64:
+      translate_data_ = TranslateNumber<int64_t>;
+      break;
+    case YB_YQL_DATA_TYPE_FLOAT:
+      translate_data_ = TranslateNumber<float>;
+      break;
+    case YB_YQL_DATA_TYPE_DOUBLE:
+      translate_data_ = TranslateNumber<double>;
+      break;
+    default:
+      return STATUS_FORMAT(NotSupported, "Cannot push down $0 returning type $1", opname_,
+                           type_entity_->yb_type);
+  }
+  if ((tsopcode == bfpg::TSOpcode::kCount && internal_type() != InternalType::kInt64Value) ||
+      (tsopcode == bfpg::TSOpcode::kSum && internal_type() != InternalType::kInt64Value &&
+       internal_type() != InternalType::kFloatValue &&
+       internal_type() != InternalType::kDoubleValue)) {
+    return STATUS_FORMAT(NotSupported, "Cannot push down $0 returning type $1", opname_,
+                         type_entity_->yb_type);
+  }
+
+  auto* tscall = expr_pb->mutable_tscall();
+  tscall->set_opcode(static_cast<int32_t>(tsopcode));
+  for (PgExpr *arg : args_) {
+    PgsqlExpressionPB *arg_pb = tscall->add_operands();
+    RETURN_NOT_OK(arg->PrepareForRead(pg_stmt, arg_pb));
+    // Constants are not bound to their protobuf like top level targets, so set them right away.
+    RETURN_NOT_OK(arg->Eval(pg_stmt, arg_pb));
+  }
+  return Status::OK();
+}
+
 //--------------------------------------------------------------------------------------------------
 namespace {
 #define POSTGRESQL_BYTEAOID 17
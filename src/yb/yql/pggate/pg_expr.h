@@ -16,6 +16,7 @@
 #define YB_YQL_PGGATE_PG_EXPR_H_
 
 #include "yb/client/client.h"
+#include "yb/util/bfpg/tserver_opcodes.h"
 #include "yb/yql/pggate/util/pg_doc_data.h"
 #include "yb/yql/pggate/util/pg_tuple.h"
 
@@ -38,6 +39,11 @@ class PgExpr {
     PG_EXPR_GT,
     PG_EXPR_LE,
     PG_EXPR_LT,
+    PG_EXPR_AND,
+    PG_EXPR_OR,
+    PG_EXPR_IS_NULL,
+    PG_EXPR_IS_NOT_NULL,
+    PG_EXPR_IN,
 
     // Aggregate functions.
     PG_EXPR_AVG,
@@ -75,6 +81,12 @@ class PgExpr {
   bool is_constant() {
     return opcode_ == Opcode::PG_EXPR_CONSTANT;
   }
+  bool is_aggregate() const {
+    return opcode_ >= Opcode::PG_EXPR_AVG && opcode_ <= Opcode::PG_EXPR_MIN;
+  }
+  bool is_condition() const {
+    return opcode_ >= Opcode::PG_EXPR_NOT && opcode_ <= Opcode::PG_EXPR_IN;
+  }
 
   // Read the result from input buffer (yb_cursor) that was computed by and sent from DocDB.
   // Write the result to output buffer (pg_cursor) in Postgres format.
@@ -267,7 +279,25 @@ class PgOperator : public PgExpr {
   // Append arguments.
   void AppendArg(PgExpr *arg);
 
+  // Prepare aggregate functions and conditions to be computed by DocDB. Other operators are not
+  // yet supported.
+  CHECKED_STATUS PrepareForRead(PgDml *pg_stmt, PgsqlExpressionPB *expr_pb) override;
+
+  // Update the constants of a condition in its protobuf.
+  CHECKED_STATUS Eval(PgDml *pg_stmt, PgsqlExpressionPB *expr_pb) override;
+
+  // The tablet-server operator computing this aggregate.
+  Result<bfpg::TSOpcode> AggregateOpcode() const;
+
+  // The DocDB operator evaluating this condition.
+  Result<QLOperator> ConditionOperator() const;
+
  private:
+  CHECKED_STATUS PrepareAggregateForRead(PgDml *pg_stmt, PgsqlExpressionPB *expr_pb);
+
+  // Only conditions on columns and constants of the same type are pushed down, so that DocDB
+  // evaluates them the same way as Postgres does.
+  CHECKED_STATUS PrepareConditionForRead(PgDml *pg_stmt, PgsqlExpressionPB *expr_pb);
   const string opname_;
   std::vector<PgExpr*> args_;
 };
@@ -49,7 +49,7 @@ Status PgSelect::Prepare(uint64_t* read_time) {
   }
 
   // Allocate READ/SELECT operation.
-  auto doc_op = make_shared<PgDocReadOp>(pg_session_, read_time, table_desc_->NewPgsqlSelect());
+  auto doc_op = make_shared<PgDocReadOp>(pg_session_, read_time, table_desc_->table());
   read_req_ = doc_op->read_op()->mutable_request();
   if (index_id_.IsValid()) {
     index_req_ = read_req_->mutable_index_request();
@@ -107,6 +107,24 @@ PgsqlExpressionPB *PgSelect::AllocTargetPB() {
   return read_req_->add_targets();
 }
 
+Status PgSelect::AppendAggregateTarget(PgExpr *target) {
+  if (index_id_.IsValid()) {
+    return STATUS(NotSupported, "Aggregates are not supported in index scans");
+  }
+  read_req_->set_is_aggregate(true);
+  const auto opcode = VERIFY_RESULT(static_cast<PgOperator *>(target)->AggregateOpcode());
+  down_cast<PgDocReadOp *>(doc_op_.get())->AddAggregate(opcode, target->internal_type());
+  return Status::OK();
+}
+
+PgsqlExpressionPB *PgSelect::AllocQualPB() {
+  // The WHERE clause is a single AND condition, so that each appended condition keeps its own
+  // protobuf for binding.
+  PgsqlConditionPB *where = read_req_->mutable_where_expr()->mutable_condition();
+  where->set_op(QL_OP_AND);
+  return where->add_operands();
+}
+
 PgsqlExpressionPB *PgSelect::AllocIndexTargetPB() {
   return index_req_->add_targets();
 }
@@ -220,6 +238,19 @@ Status PgSelect::BindIndexColumn(int attr_num, PgExpr *attr_value) {
   return Status::OK();
 }
 
+Status PgSelect::BindYBCtids(int n, PgExpr **ybctids) {
+  SCHECK_GT(n, 0, InvalidArgument, "No ybctids to bind");
+  ybctid_batch_.clear();
+  ybctid_batch_.reserve(n);
+  for (int i = 0; i < n; i++) {
+    SCHECK(ybctids[i]->is_constant(), InvalidArgument, "Column ybctid must be bound to constant");
+    ybctid_batch_.push_back(static_cast<PgConstant*>(ybctids[i])->binary_value());
+  }
+  // The first ybctid is bound as a single one would be, the reads of the others are set up from
+  // the same request.
+  return BindColumn(static_cast<int>(PgSystemAttrNum::kYBTupleId), ybctids[0]);
+}
+
 Status PgSelect::Exec() {
   // Delete key columns that are not bound to any values.
   RETURN_NOT_OK(DeleteEmptyPrimaryBinds());
@@ -227,12 +258,21 @@ Status PgSelect::Exec() {
   // Update bind values for constants and placeholders.
   RETURN_NOT_OK(UpdateBindPBs());
 
+  if (read_req_->is_aggregate() &&
+      down_cast<PgDocReadOp *>(doc_op_.get())->num_aggregates() != targets_.size()) {
+    return STATUS(InvalidArgument, "Cannot mix aggregate and non-aggregate targets");
+  }
+
   // Set column references in protobuf.
   SetColumnRefIds(table_desc_, read_req_->mutable_column_refs());
   if (index_id_.IsValid()) {
     SetColumnRefIds(index_desc_, index_req_->mutable_column_refs());
   }
 
+  if (ybctid_batch_.size() > 1) {
+    RETURN_NOT_OK(down_cast<PgDocReadOp *>(doc_op_.get())->SetYBCtidBatch(ybctid_batch_));
+  }
+
   // Execute select statement asynchronously.
   SCHECK_EQ(VERIFY_RESULT(doc_op_->Execute()), RequestSent::kTrue, IllegalState,
             "YSQL read operation was not sent");
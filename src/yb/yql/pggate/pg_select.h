@@ -55,6 +55,9 @@ class PgSelect : public PgDml {
   // Bind an index column with an expression.
   CHECKED_STATUS BindIndexColumn(int attnum, PgExpr *attr_value);
 
+  // Bind the ybctid column with a batch of constants, to read all rows with these ybctids.
+  CHECKED_STATUS BindYBCtids(int n, PgExpr **ybctids);
+
   // Execute.
   CHECKED_STATUS Exec();
 
@@ -69,6 +72,12 @@ class PgSelect : public PgDml {
 
   // Allocate protobuf for target.
   PgsqlExpressionPB *AllocTargetPB() override;
+
+  // Have the aggregate computed by the tablets, and combined by the read operation.
+  CHECKED_STATUS AppendAggregateTarget(PgExpr *target) override;
+
+  // Allocate protobuf for a condition of the WHERE clause.
+  PgsqlExpressionPB *AllocQualPB() override;
   PgsqlExpressionPB *AllocIndexTargetPB();
 
   // Allocate column expression.
@@ -87,6 +96,9 @@ class PgSelect : public PgDml {
   std::shared_ptr<client::YBPgsqlReadOp> read_op_;
   PgsqlReadRequestPB *read_req_ = nullptr;
   PgsqlReadRequestPB *index_req_ = nullptr;
+
+  // The ybctids bound by BindYBCtids().
+  std::vector<std::string> ybctid_batch_;
 };
 
 }  // namespace pggate
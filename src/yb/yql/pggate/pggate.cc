@@ -564,6 +564,10 @@ Status PgApiImpl::DmlAppendTarget(PgStatement *handle, PgExpr *target) {
   return down_cast<PgDml*>(handle)->AppendTarget(target);
 }
 
+Status PgApiImpl::DmlAppendQual(PgStatement *handle, PgExpr *qual) {
+  return down_cast<PgDml*>(handle)->AppendQual(qual);
+}
+
 Status PgApiImpl::DmlBindColumn(PgStatement *handle, int attr_num, PgExpr *attr_value) {
   return down_cast<PgDml*>(handle)->BindColumn(attr_num, attr_value);
 }
@@ -576,6 +580,14 @@ Status PgApiImpl::DmlBindIndexColumn(PgStatement *handle, int attr_num, PgExpr *
   return down_cast<PgSelect*>(handle)->BindIndexColumn(attr_num, attr_value);
 }
 
+Status PgApiImpl::DmlBindYBCtids(PgStatement *handle, int n, PgExpr **ybctids) {
+  if (!PgStatement::IsValidStmt(handle, StmtOp::STMT_SELECT)) {
+    // Invalid handle.
+    return STATUS(InvalidArgument, "Invalid statement handle");
+  }
+  return down_cast<PgSelect*>(handle)->BindYBCtids(n, ybctids);
+}
+
 CHECKED_STATUS PgApiImpl::DmlAssignColumn(PgStatement *handle, int attr_num, PgExpr *attr_value) {
   return down_cast<PgDml*>(handle)->AssignColumn(attr_num, attr_value);
 }
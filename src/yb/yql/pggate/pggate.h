@@ -263,6 +263,9 @@ class PgApiImpl {
   // All DML statements
   CHECKED_STATUS DmlAppendTarget(PgStatement *handle, PgExpr *expr);
 
+  // Append a condition to filter the rows in DocDB.
+  CHECKED_STATUS DmlAppendQual(PgStatement *handle, PgExpr *qual);
+
   // Binding Columns: Bind column with a value (expression) in a statement.
   // + This API is used to identify the rows you want to operate on. If binding columns are not
   //   there, that means you want to operate on all rows (full scan). You can view this as a
@@ -283,6 +286,9 @@ class PgApiImpl {
   CHECKED_STATUS DmlBindColumn(YBCPgStatement handle, int attr_num, YBCPgExpr attr_value);
   CHECKED_STATUS DmlBindIndexColumn(YBCPgStatement handle, int attr_num, YBCPgExpr attr_value);
 
+  // Bind the ybctid column of a SELECT with n constants, to read the rows with all these ybctids.
+  CHECKED_STATUS DmlBindYBCtids(YBCPgStatement handle, int n, YBCPgExpr *ybctids);
+
   // API for SET clause.
   CHECKED_STATUS DmlAssignColumn(YBCPgStatement handle, int attr_num, YBCPgExpr attr_value);
 
@@ -297,10 +303,10 @@ class PgApiImpl {
   // DB Operations: SET, WHERE, ORDER_BY, GROUP_BY, etc.
   // + The following operations are run by DocDB.
   //   - API for "set_clause" (not yet implemented).
+  //   - API for "where_expr" (DmlAppendQual, for the conditions that can be pushed down).
   //
   // + The following operations are run by Postgres layer. An API might be added to move these
   //   operations to DocDB.
-  //   - API for "where_expr"
   //   - API for "order_by_expr"
   //   - API for "group_by_expr"
 
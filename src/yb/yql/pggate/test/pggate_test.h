@@ -102,6 +102,10 @@ YBCStatus YBCTestCreateTableAddColumn(YBCPgStatement handle, const char *attr_na
 YBCStatus YBCTestNewColumnRef(YBCPgStatement stmt, int attr_num, DataType yb_type,
                               YBCPgExpr *expr_handle);
 
+// Operator expression, such as an aggregate, returning yb_type.
+YBCStatus YBCTestNewOperator(YBCPgStatement stmt, const char *opname, DataType yb_type,
+                             YBCPgExpr *op_handle);
+
 // Constant expressions.
 YBCStatus YBCTestNewConstantBool(YBCPgStatement stmt, bool value, bool is_null,
                                  YBCPgExpr *expr_handle);
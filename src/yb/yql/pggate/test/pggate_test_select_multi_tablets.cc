@@ -13,9 +13,13 @@
 //
 //--------------------------------------------------------------------------------------------------
 
+#include <set>
+
 #include "yb/yql/pggate/test/pggate_test.h"
 #include "yb/util/ybc-internal.h"
 
+DECLARE_int32(ysql_max_parallel_tablet_reads);
+
 namespace yb {
 namespace pggate {
 
@@ -214,7 +218,10 @@ TEST_F(PggateTestSelectMultiTablets, TestSelectMultiTablets) {
   pg_stmt = nullptr;
 
   // SELECT ----------------------------------------------------------------------------------------
+  // The tablets are read one after another here, and in parallel by the scans below.
   LOG(INFO) << "Test SELECTing from partitioned table WITHOUT specifying RANGE column";
+  const int max_parallel_tablet_reads = FLAGS_ysql_max_parallel_tablet_reads;
+  FLAGS_ysql_max_parallel_tablet_reads = 1;
   CHECK_YBC_STATUS(YBCPgNewSelect(pg_session_, kDefaultDatabaseOid, tab_oid, kInvalidOid, &pg_stmt,
                                   nullptr /* read_time */));
 
@@ -268,6 +275,92 @@ TEST_F(PggateTestSelectMultiTablets, TestSelectMultiTablets) {
     CHECK_EQ(selected_job_name, expected_job_name);
   }
 
+  CHECK_YBC_STATUS(YBCPgDeleteStatement(pg_stmt));
+  pg_stmt = nullptr;
+  FLAGS_ysql_max_parallel_tablet_reads = max_parallel_tablet_reads;
+
+  // SELECT count(id), sum(project_count), max(id) - computed by the tablets and combined here.
+  LOG(INFO) << "Test SELECTing aggregates from partitioned table";
+  CHECK_YBC_STATUS(YBCPgNewSelect(pg_session_, kDefaultDatabaseOid, tab_oid, kInvalidOid, &pg_stmt,
+                                  nullptr /* read_time */));
+
+  YBCPgExpr aggref;
+  CHECK_YBC_STATUS(YBCTestNewOperator(pg_stmt, "count", DataType::INT64, &aggref));
+  YBCTestNewColumnRef(pg_stmt, 2, DataType::INT32, &colref);
+  CHECK_YBC_STATUS(YBCPgOperatorAppendArg(aggref, colref));
+  CHECK_YBC_STATUS(YBCPgDmlAppendTarget(pg_stmt, aggref));
+  CHECK_YBC_STATUS(YBCTestNewOperator(pg_stmt, "sum", DataType::INT64, &aggref));
+  YBCTestNewColumnRef(pg_stmt, 4, DataType::INT32, &colref);
+  CHECK_YBC_STATUS(YBCPgOperatorAppendArg(aggref, colref));
+  CHECK_YBC_STATUS(YBCPgDmlAppendTarget(pg_stmt, aggref));
+  CHECK_YBC_STATUS(YBCTestNewOperator(pg_stmt, "max", DataType::INT32, &aggref));
+  YBCTestNewColumnRef(pg_stmt, 2, DataType::INT32, &colref);
+  CHECK_YBC_STATUS(YBCPgOperatorAppendArg(aggref, colref));
+  CHECK_YBC_STATUS(YBCPgDmlAppendTarget(pg_stmt, aggref));
+
+  CHECK_YBC_STATUS(YBCPgExecSelect(pg_stmt));
+
+  // All tablets are combined into a single row.
+  bool has_data = false;
+  YBCPgDmlFetch(pg_stmt, col_count, values, isnulls, nullptr, &has_data);
+  CHECK(has_data) << "Aggregate row is not fetched";
+  CHECK_EQ(values[0], insert_row_count);  // count(id)
+  CHECK_EQ(values[1], 100 * insert_row_count + 28);  // sum(project_count) for ids 1..7
+  CHECK_EQ(values[2], insert_row_count);  // max(id)
+
+  YBCPgDmlFetch(pg_stmt, col_count, values, isnulls, nullptr, &has_data);
+  CHECK(!has_data) << "Aggregates must return a single row";
+
+  CHECK_YBC_STATUS(YBCPgDeleteStatement(pg_stmt));
+  pg_stmt = nullptr;
+
+  // SELECT id WHERE id >= 3 AND project_count IN (104, 105, 106, 200) - filtered by the tablets.
+  LOG(INFO) << "Test SELECTing from partitioned table with a WHERE clause";
+  CHECK_YBC_STATUS(YBCPgNewSelect(pg_session_, kDefaultDatabaseOid, tab_oid, kInvalidOid, &pg_stmt,
+                                  nullptr /* read_time */));
+  YBCTestNewColumnRef(pg_stmt, 2, DataType::INT32, &colref);
+  CHECK_YBC_STATUS(YBCPgDmlAppendTarget(pg_stmt, colref));
+
+  YBCPgExpr qual;
+  YBCPgExpr constant;
+  CHECK_YBC_STATUS(YBCTestNewOperator(pg_stmt, ">=", DataType::BOOL, &qual));
+  YBCTestNewColumnRef(pg_stmt, 2, DataType::INT32, &colref);
+  CHECK_YBC_STATUS(YBCPgOperatorAppendArg(qual, colref));
+  CHECK_YBC_STATUS(YBCTestNewConstantInt4(pg_stmt, 3, false, &constant));
+  CHECK_YBC_STATUS(YBCPgOperatorAppendArg(qual, constant));
+  CHECK_YBC_STATUS(YBCPgDmlAppendQual(pg_stmt, qual));
+
+  CHECK_YBC_STATUS(YBCTestNewOperator(pg_stmt, "in", DataType::BOOL, &qual));
+  YBCTestNewColumnRef(pg_stmt, 4, DataType::INT32, &colref);
+  CHECK_YBC_STATUS(YBCPgOperatorAppendArg(qual, colref));
+  for (int32_t project_count : {104, 105, 106, 200}) {
+    CHECK_YBC_STATUS(YBCTestNewConstantInt4(pg_stmt, project_count, false, &constant));
+    CHECK_YBC_STATUS(YBCPgOperatorAppendArg(qual, constant));
+  }
+  CHECK_YBC_STATUS(YBCPgDmlAppendQual(pg_stmt, qual));
+
+  // Comparing columns of different types is left to Postgres.
+  CHECK_YBC_STATUS(YBCTestNewOperator(pg_stmt, "=", DataType::BOOL, &qual));
+  YBCTestNewColumnRef(pg_stmt, 1, DataType::INT64, &colref);
+  CHECK_YBC_STATUS(YBCPgOperatorAppendArg(qual, colref));
+  YBCTestNewColumnRef(pg_stmt, 2, DataType::INT32, &colref);
+  CHECK_YBC_STATUS(YBCPgOperatorAppendArg(qual, colref));
+  YBCStatus status = YBCPgDmlAppendQual(pg_stmt, qual);
+  CHECK(status != nullptr) << "Condition must not be pushed down";
+  FreeYBCStatus(status);
+
+  CHECK_YBC_STATUS(YBCPgExecSelect(pg_stmt));
+
+  std::set<int> selected_ids;
+  while (true) {
+    YBCPgDmlFetch(pg_stmt, col_count, values, isnulls, nullptr, &has_data);
+    if (!has_data) {
+      break;
+    }
+    selected_ids.insert(values[1]);
+  }
+  CHECK(selected_ids == std::set<int>({4, 5, 6}));
+
   CHECK_YBC_STATUS(YBCPgDeleteStatement(pg_stmt));
   pg_stmt = nullptr;
 }
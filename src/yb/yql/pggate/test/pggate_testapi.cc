@@ -57,8 +57,9 @@ YBCStatus YBCTestCreateTableAddColumn(YBCPgStatement handle, const char *attr_na
 
 //--------------------------------------------------------------------------------------------------
 
-YBCStatus YBCTestNewColumnRef(YBCPgStatement stmt, int attr_num, DataType yb_type,
-                              YBCPgExpr *expr_handle) {
+namespace {
+
+int DataTypeToPgType(DataType yb_type) {
   int pg_type = 0;
   switch (yb_type) {
   case DataType::BOOL:
@@ -88,8 +89,21 @@ YBCStatus YBCTestNewColumnRef(YBCPgStatement stmt, int attr_num, DataType yb_typ
   default:
     break;
   }
-  return YBCPgNewColumnRef(stmt, attr_num, YBCPgFindTypeEntity(pg_type), &kYBCTestTypeAttrs,
-                           expr_handle);
+  return pg_type;
+}
+
+} // namespace
+
+YBCStatus YBCTestNewColumnRef(YBCPgStatement stmt, int attr_num, DataType yb_type,
+                              YBCPgExpr *expr_handle) {
+  return YBCPgNewColumnRef(stmt, attr_num, YBCPgFindTypeEntity(DataTypeToPgType(yb_type)),
+                           &kYBCTestTypeAttrs, expr_handle);
+}
+
+YBCStatus YBCTestNewOperator(YBCPgStatement stmt, const char *opname, DataType yb_type,
+                             YBCPgExpr *op_handle) {
+  return YBCPgNewOperator(stmt, opname, YBCPgFindTypeEntity(DataTypeToPgType(yb_type)),
+                          op_handle);
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -143,5 +143,52 @@ PgWireDataHeader PgDocData::ReadDataHeader(Slice *cursor) {
   return PgWireDataHeader(header_data);
 }
 
+namespace {
+
+template <class Value>
+Value ReadValue(Slice *cursor) {
+  Value value;
+  size_t read_size = PgDocData::ReadNumber(cursor, &value);
+  cursor->remove_prefix(read_size);
+  return value;
+}
+
+} // namespace
+
+Status PgDocData::ReadColumn(InternalType type, Slice *cursor, QLValue *col_value) {
+  PgWireDataHeader header = ReadDataHeader(cursor);
+  if (header.is_null()) {
+    col_value->SetNull();
+    return Status::OK();
+  }
+
+  switch (type) {
+    case InternalType::kBoolValue:
+      col_value->set_bool_value(ReadValue<bool>(cursor));
+      break;
+    case InternalType::kInt8Value:
+      col_value->set_int8_value(ReadValue<int8_t>(cursor));
+      break;
+    case InternalType::kInt16Value:
+      col_value->set_int16_value(ReadValue<int16_t>(cursor));
+      break;
+    case InternalType::kInt32Value:
+      col_value->set_int32_value(ReadValue<int32_t>(cursor));
+      break;
+    case InternalType::kInt64Value:
+      col_value->set_int64_value(ReadValue<int64_t>(cursor));
+      break;
+    case InternalType::kFloatValue:
+      col_value->set_float_value(ReadValue<float>(cursor));
+      break;
+    case InternalType::kDoubleValue:
+      col_value->set_double_value(ReadValue<double>(cursor));
+      break;
+    default:
+      return STATUS_FORMAT(NotSupported, "Cannot read column of type $0", type);
+  }
+  return Status::OK();
+}
+
 }  // namespace pggate
 }  // namespace yb
@@ -32,6 +32,9 @@ class PgDocData : public PgWire {
   static CHECKED_STATUS LoadCache(const string& data, int64_t *total_row_count, Slice *cursor);
 
   static PgWireDataHeader ReadDataHeader(Slice *cursor);
+
+  // Reads a column of the given numeric type, including its header, into col_value.
+  static CHECKED_STATUS ReadColumn(InternalType type, Slice *cursor, QLValue *col_value);
 };
 
 }  // namespace pggate
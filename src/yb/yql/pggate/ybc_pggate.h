@@ -234,6 +234,12 @@ YBCStatus YBCPgExecDropIndex(YBCPgStatement handle);
 // - INSERT / UPDATE / DELETE ... RETURNING target_expr1, target_expr2, ...
 YBCStatus YBCPgDmlAppendTarget(YBCPgStatement handle, YBCPgExpr target);
 
+// This function is for filtering rows in DocDB with a condition of the WHERE clause.
+// - SELECT ... WHERE qual1 AND qual2 ...
+// Conditions are built with YBCPgNewOperator() on columns and constants of the same type. When it
+// returns an error, the condition is not supported by DocDB and must be evaluated by Postgres.
+YBCStatus YBCPgDmlAppendQual(YBCPgStatement handle, YBCPgExpr qual);
+
 // Binding Columns: Bind column with a value (expression) in a statement.
 // + This API is used to identify the rows you want to operate on. If binding columns are not
 //   there, that means you want to operate on all rows (full scan). You can view this as a
@@ -254,6 +260,10 @@ YBCStatus YBCPgDmlAppendTarget(YBCPgStatement handle, YBCPgExpr target);
 YBCStatus YBCPgDmlBindColumn(YBCPgStatement handle, int attr_num, YBCPgExpr attr_value);
 YBCStatus YBCPgDmlBindIndexColumn(YBCPgStatement handle, int attr_num, YBCPgExpr attr_value);
 
+// Bind the ybctid column of a SELECT with n constants, to fetch the rows with these ybctids in one
+// execution instead of a statement per row.
+YBCStatus YBCPgDmlBindYBCtids(YBCPgStatement handle, int n, YBCPgExpr *ybctids);
+
 // API for SET clause.
 YBCStatus YBCPgDmlAssignColumn(YBCPgStatement handle,
                                int attr_num,
@@ -269,11 +279,10 @@ YBCStatus YBCPgDmlExecWriteOp(YBCPgStatement handle);
 
 // DB Operations: WHERE, ORDER_BY, GROUP_BY, etc.
 // + The following operations are run by DocDB.
-//   - Not yet
+//   - API for "where_expr" (YBCPgDmlAppendQual)
 //
 // + The following operations are run by Postgres layer. An API might be added to move these
 //   operations to DocDB.
-//   - API for "where_expr"
 //   - API for "order_by_expr"
 //   - API for "group_by_expr"
 
@@ -38,6 +38,7 @@
 #include "yb/yql/redis/redisserver/redis_constants.h"
 #include "yb/yql/redis/redisserver/redis_encoding.h"
 #include "yb/yql/redis/redisserver/redis_rpc.h"
+#include "yb/yql/redis/redisserver/redis_server.h"
 
 using namespace std::literals;
 using namespace std::placeholders;
@@ -269,6 +270,12 @@ class LocalCommandData {
     return context_;
   }
 
+  // Drops all responses cached by the proxy, used by commands that modify keys without a
+  // regular write operation.
+  void ClearReadCache() const {
+    context_->server()->read_cache()->Clear();
+  }
+
   template<class Functor>
   void Apply(const Functor& functor, const std::string& partition_key,
              ManualResponse manual_response) {
@@ -683,6 +690,7 @@ class RenameData : public std::enable_shared_from_this<RenameData> {
   }
 
   void Respond(RedisResponsePB* response) {
+    data_.ClearReadCache();
     data_.Respond(response);
     if (src_functor_) {
       src_functor_(Status::OK());
@@ -870,6 +878,7 @@ class RenameData : public std::enable_shared_from_this<RenameData> {
 
 void HandleRename(LocalCommandData data) {
   VLOG(1) << "0. HandleRename";
+  data.ClearReadCache();
   std::shared_ptr<RenameData> rename_data = std::make_shared<RenameData>(std::move(data));
   rename_data->Execute();
 }
@@ -1076,6 +1085,7 @@ void FlushDBs(LocalCommandData data, const vector<string> ids) {
   const Status s = FLAGS_yedis_enable_flush
                        ? data.client()->TruncateTables(ids)
                        : STATUS(InvalidArgument, "FLUSHDB and FLUSHALL are not enabled.");
+  data.ClearReadCache();
 
   if (s.ok()) {
     resp.set_code(RedisResponsePB_RedisStatusCode_OK);
@@ -1198,6 +1208,7 @@ void HandleDeleteDB(LocalCommandData data) {
   const auto table_name = RedisServiceData::GetYBTableNameForRedisDatabase(db_name);
 
   Status s = data.client()->DeleteTable(table_name, /* wait */ true);
+  data.ClearReadCache();
   if (s.ok()) {
     resp.set_code(RedisResponsePB_RedisStatusCode_OK);
   } else if (s.IsNotFound()) {
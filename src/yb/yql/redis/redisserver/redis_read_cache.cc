@@ -0,0 +1,178 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/yql/redis/redisserver/redis_read_cache.h"
+
+#include <algorithm>
+
+#include <gflags/gflags.h>
+
+#include "yb/util/flag_tags.h"
+
+DEFINE_int32(redis_read_cache_size, 0,
+             "Maximum number of GET responses cached by the Redis proxy. 0 to disable.");
+TAG_FLAG(redis_read_cache_size, advanced);
+TAG_FLAG(redis_read_cache_size, runtime);
+
+DEFINE_int32(redis_read_cache_staleness_ms, 100,
+             "Maximum time in milliseconds since the start of the read that produced a cached "
+             "Redis response, for which that response can be served from the proxy cache.");
+TAG_FLAG(redis_read_cache_staleness_ms, advanced);
+TAG_FLAG(redis_read_cache_staleness_ms, runtime);
+
+METRIC_DEFINE_counter(server, redis_read_cache_hits,
+                      "Redis Read Cache Hits", yb::MetricUnit::kRequests,
+                      "Number of Redis GET requests served from the proxy read cache.");
+
+METRIC_DEFINE_counter(server, redis_read_cache_misses,
+                      "Redis Read Cache Misses", yb::MetricUnit::kRequests,
+                      "Number of Redis GET requests not found in the proxy read cache.");
+
+METRIC_DEFINE_gauge_uint64(server, redis_read_cache_entries,
+                           "Redis Read Cache Entries", yb::MetricUnit::kEntries,
+                           "Number of responses held by the Redis proxy read cache.");
+
+namespace yb {
+namespace redisserver {
+
+RedisReadCache::RedisReadCache(const scoped_refptr<MetricEntity>& metric_entity) {
+  if (metric_entity) {
+    hits_ = METRIC_redis_read_cache_hits.Instantiate(metric_entity);
+    misses_ = METRIC_redis_read_cache_misses.Instantiate(metric_entity);
+    entries_ = METRIC_redis_read_cache_entries.Instantiate(metric_entity, 0);
+  }
+}
+
+bool RedisReadCache::Enabled() {
+  return FLAGS_redis_read_cache_size > 0;
+}
+
+uint64_t RedisReadCache::StartRead() const {
+  return generation_.load(std::memory_order_acquire);
+}
+
+bool RedisReadCache::Get(const std::string& key, RedisResponsePB* response) {
+  const auto now = MonoTime::Now();
+  const auto staleness = MonoDelta::FromMilliseconds(FLAGS_redis_read_cache_staleness_ms);
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = index_.find(key);
+    if (it != index_.end()) {
+      auto entry = it->second;
+      if (now - entry->read_start <= staleness) {
+        ++entry->hits;
+        *response = entry->response;
+        lru_.splice(lru_.begin(), lru_, entry);
+        if (hits_) {
+          hits_->Increment();
+        }
+        return true;
+      }
+      EraseUnlocked(entry);
+    }
+  }
+  if (misses_) {
+    misses_->Increment();
+  }
+  return false;
+}
+
+void RedisReadCache::Put(const std::string& key, const RedisResponsePB& response,
+                         MonoTime read_start, uint64_t generation) {
+  const auto capacity = FLAGS_redis_read_cache_size;
+  if (capacity <= 0) {
+    return;
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  // Checked under the lock, so that an invalidation either precedes this check or removes the
+  // entry stored here.
+  if (generation_.load(std::memory_order_acquire) != generation) {
+    return;
+  }
+  auto it = index_.find(key);
+  if (it != index_.end()) {
+    auto entry = it->second;
+    if (entry->read_start >= read_start) {
+      return;
+    }
+    entry->response = response;
+    entry->read_start = read_start;
+    lru_.splice(lru_.begin(), lru_, entry);
+    return;
+  }
+  while (!lru_.empty() && lru_.size() >= static_cast<size_t>(capacity)) {
+    EraseUnlocked(std::prev(lru_.end()));
+  }
+  lru_.push_front(Entry{key, response, read_start, 0});
+  index_.emplace(key, lru_.begin());
+  if (entries_) {
+    entries_->set_value(lru_.size());
+  }
+}
+
+void RedisReadCache::Invalidate(const std::string& key) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  generation_.fetch_add(1, std::memory_order_acq_rel);
+  auto it = index_.find(key);
+  if (it != index_.end()) {
+    EraseUnlocked(it->second);
+  }
+}
+
+void RedisReadCache::Clear() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  generation_.fetch_add(1, std::memory_order_acq_rel);
+  index_.clear();
+  lru_.clear();
+  if (entries_) {
+    entries_->set_value(0);
+  }
+}
+
+std::vector<std::pair<std::string, uint64_t>> RedisReadCache::HotKeys(size_t k) {
+  std::vector<std::pair<std::string, uint64_t>> result;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    result.reserve(lru_.size());
+    for (const auto& entry : lru_) {
+      result.emplace_back(entry.key, entry.hits);
+    }
+  }
+  auto cmp = [](const std::pair<std::string, uint64_t>& lhs,
+                const std::pair<std::string, uint64_t>& rhs) {
+    return lhs.second > rhs.second;
+  };
+  if (result.size() > k) {
+    std::partial_sort(result.begin(), result.begin() + k, result.end(), cmp);
+    result.resize(k);
+  } else {
+    std::sort(result.begin(), result.end(), cmp);
+  }
+  return result;
+}
+
+size_t RedisReadCache::size() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return lru_.size();
+}
+
+void RedisReadCache::EraseUnlocked(EntryList::iterator it) {
+  index_.erase(it->key);
+  lru_.erase(it);
+  if (entries_) {
+    entries_->set_value(lru_.size());
+  }
+}
+
+} // namespace redisserver
+} // namespace yb
@@ -0,0 +1,88 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+#ifndef YB_YQL_REDIS_REDISSERVER_REDIS_READ_CACHE_H
+#define YB_YQL_REDIS_REDISSERVER_REDIS_READ_CACHE_H
+
+#include <atomic>
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "yb/common/redis_protocol.pb.h"
+
+#include "yb/util/metrics.h"
+#include "yb/util/monotime.h"
+
+namespace yb {
+namespace redisserver {
+
+// Bounded-staleness cache of GET responses for hot keys, kept by the Redis proxy.
+//
+// Entries are stamped with the time the read that produced them was started, and are served
+// only until FLAGS_redis_read_cache_staleness_ms has passed since then. Writes that go through
+// this proxy invalidate the key they touch; writes through other proxies are only bounded by the
+// staleness limit. The cache is disabled when FLAGS_redis_read_cache_size is 0.
+class RedisReadCache {
+ public:
+  explicit RedisReadCache(const scoped_refptr<MetricEntity>& metric_entity);
+
+  static bool Enabled();
+
+  // Returns the generation to pass to Put for a read that is about to be started.
+  uint64_t StartRead() const;
+
+  // Fills response for key if it has a fresh entry. Returns true in that case.
+  bool Get(const std::string& key, RedisResponsePB* response);
+
+  // Stores the response of a read started at read_start. The response is dropped if any key was
+  // invalidated since the read was started, since it could miss that write.
+  void Put(const std::string& key, const RedisResponsePB& response, MonoTime read_start,
+           uint64_t generation);
+
+  void Invalidate(const std::string& key);
+  void Clear();
+
+  // Returns up to k cached keys with the largest number of hits, hottest first.
+  std::vector<std::pair<std::string, uint64_t>> HotKeys(size_t k);
+
+  size_t size();
+
+ private:
+  struct Entry {
+    std::string key;
+    RedisResponsePB response;
+    MonoTime read_start;
+    uint64_t hits = 0;
+  };
+
+  typedef std::list<Entry> EntryList;
+
+  void EraseUnlocked(EntryList::iterator it);
+
+  std::mutex mutex_;
+  EntryList lru_;
+  std::unordered_map<std::string, EntryList::iterator> index_;
+  std::atomic<uint64_t> generation_{0};
+
+  scoped_refptr<Counter> hits_;
+  scoped_refptr<Counter> misses_;
+  scoped_refptr<AtomicGauge<uint64_t>> entries_;
+};
+
+} // namespace redisserver
+} // namespace yb
+
+#endif // YB_YQL_REDIS_REDISSERVER_REDIS_READ_CACHE_H
@@ -29,6 +29,7 @@
 
 #include "yb/util/logging.h"
 #include "yb/util/size_literals.h"
+#include "yb/util/trace.h"
 
 #include "yb/util/debug/trace_event.h"
 
@@ -189,7 +190,11 @@ void RedisConnectionContext::Shutdown(const Status& status) {
 RedisInboundCall::RedisInboundCall(rpc::ConnectionPtr conn,
                                    size_t weight_in_bytes,
                                    CallProcessedListener call_processed_listener)
-    : QueueableInboundCall(std::move(conn), weight_in_bytes, std::move(call_processed_listener)) {}
+    : QueueableInboundCall(std::move(conn), weight_in_bytes, std::move(call_processed_listener)) {
+  if (Trace::ShouldSample()) {
+    trace_->set_sampled();
+  }
+}
 
 RedisInboundCall::~RedisInboundCall() {
   Status status;
@@ -275,7 +280,8 @@ void RedisInboundCall::LogTrace() const {
   auto total_time = now.GetDeltaSince(timing_.time_received).ToMilliseconds();
 
   if (PREDICT_FALSE(FLAGS_rpc_dump_all_traces || total_time > FLAGS_rpc_slow_query_threshold_ms)) {
-    LOG(WARNING) << ToString() << " took " << total_time << "ms. Details:";
+    LOG(WARNING) << ToString() << " took " << total_time << "ms. Stages: " << StagesToString()
+                 << ". Details:";
     rpc::RpcCallInProgressPB call_in_progress_pb;
     GetCallDetails(&call_in_progress_pb);
     LOG(WARNING) << call_in_progress_pb.DebugString() << "Trace: ";
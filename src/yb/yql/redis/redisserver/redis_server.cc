@@ -19,9 +19,11 @@
 
 #include "yb/util/flag_tags.h"
 #include "yb/util/size_literals.h"
+#include "yb/util/url-coding.h"
 
 using yb::rpc::ServiceIf;
 using namespace yb::size_literals;
+using namespace std::placeholders;
 
 DEFINE_int32(redis_svc_queue_length, 5000,
              "RPC queue length for redis service");
@@ -30,6 +32,11 @@ TAG_FLAG(redis_svc_queue_length, advanced);
 DEFINE_int64(redis_rpc_block_size, 1_MB, "Redis RPC block size");
 DEFINE_int64(redis_rpc_memory_limit, 0, "Redis RPC memory limit");
 
+DEFINE_int32(redis_read_cache_hot_keys_to_report, 20,
+             "Number of the most frequently hit keys of the Redis read cache to show on the "
+             "/redis-hot-keys page");
+TAG_FLAG(redis_read_cache_hot_keys_to_report, advanced);
+
 namespace yb {
 namespace redisserver {
 
@@ -59,6 +66,7 @@ RedisServer::RedisServer(const RedisServerOptions& opts, tserver::TabletServer*
               "Redis", tserver ? tserver->mem_tracker() : MemTracker::GetRootTracker(),
               AddToParent::kTrue, CreateMetrics::kFalse)),
       opts_(opts),
+      read_cache_(new RedisReadCache(metric_entity())),
       tserver_(tserver) {
   SetConnectionContextFactory(std::make_shared<RedisConnnectionContextFactory>(
       mem_tracker()->parent()));
@@ -67,6 +75,10 @@ RedisServer::RedisServer(const RedisServerOptions& opts, tserver::TabletServer*
 Status RedisServer::Start() {
   RETURN_NOT_OK(server::RpcAndWebServerBase::Init());
 
+  web_server_->RegisterPathHandler(
+      "/redis-hot-keys", "", std::bind(&RedisServer::HandleHotKeysPage, this, _1, _2),
+      true /* styled */, false /* is_on_nav_bar */);
+
   std::unique_ptr<ServiceIf> redis_service(new RedisServiceImpl(this, opts_.master_addresses_flag));
   RETURN_NOT_OK(RegisterService(FLAGS_redis_svc_queue_length, std::move(redis_service)));
 
@@ -75,5 +87,23 @@ Status RedisServer::Start() {
   return Status::OK();
 }
 
+void RedisServer::HandleHotKeysPage(
+    const Webserver::WebRequest& req, std::stringstream* output) {
+  *output << "<h1>Redis Read Cache Hot Keys</h1>\n";
+  if (!RedisReadCache::Enabled()) {
+    *output << "<p>Read cache is disabled. Set --redis_read_cache_size to enable it.</p>\n";
+    return;
+  }
+  *output << "<p>Cached entries: " << read_cache_->size() << "</p>\n";
+  *output << "<table class='table table-striped'>\n";
+  *output << "  <tr><th>Key</th><th>Hits</th></tr>\n";
+  for (const auto& key_and_hits : read_cache_->HotKeys(FLAGS_redis_read_cache_hot_keys_to_report)) {
+    *output << strings::Substitute("  <tr><td>$0</td><td>$1</td></tr>\n",
+                                   EscapeForHtmlToString(key_and_hits.first),
+                                   key_and_hits.second);
+  }
+  *output << "</table>\n";
+}
+
 }  // namespace redisserver
 }  // namespace yb
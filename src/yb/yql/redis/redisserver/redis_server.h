@@ -18,6 +18,7 @@
 
 #include "yb/gutil/gscoped_ptr.h"
 #include "yb/gutil/macros.h"
+#include "yb/yql/redis/redisserver/redis_read_cache.h"
 #include "yb/yql/redis/redisserver/redis_server_options.h"
 #include "yb/server/server_base.h"
 #include "yb/tserver/tablet_server.h"
@@ -44,8 +45,13 @@ class RedisServer : public server::RpcAndWebServerBase {
 
   const RedisServerOptions& opts() const { return opts_; }
 
+  RedisReadCache* read_cache() const { return read_cache_.get(); }
+
  private:
+  void HandleHotKeysPage(const Webserver::WebRequest& req, std::stringstream* output);
+
   RedisServerOptions opts_;
+  std::unique_ptr<RedisReadCache> read_cache_;
   tserver::TabletServer* const tserver_;
 
   DISALLOW_COPY_AND_ASSIGN(RedisServer);
@@ -41,7 +41,9 @@
 #include "yb/yql/redis/redisserver/redis_constants.h"
 #include "yb/yql/redis/redisserver/redis_encoding.h"
 #include "yb/yql/redis/redisserver/redis_parser.h"
+#include "yb/yql/redis/redisserver/redis_read_cache.h"
 #include "yb/yql/redis/redisserver/redis_rpc.h"
+#include "yb/yql/redis/redisserver/redis_server.h"
 
 #include "yb/rpc/connection.h"
 #include "yb/rpc/rpc_context.h"
@@ -51,6 +53,7 @@
 #include "yb/tserver/tserver_service.proxy.h"
 
 #include "yb/util/bytes_formatter.h"
+#include "yb/util/flag_tags.h"
 #include "yb/util/locks.h"
 #include "yb/util/logging.h"
 #include "yb/util/memory/mc_types.h"
@@ -116,6 +119,16 @@ DEFINE_int32(redis_password_caching_duration_ms, 5000,
              "The duration for which we will cache the redis passwords. 0 to disable.");
 
 DEFINE_bool(redis_safe_batch, true, "Use safe batching with Redis service");
+DEFINE_bool(redis_forward_publish_in_batches, false,
+            "Forward the PUBLISH commands to each server in batches, with at most one publish RPC "
+            "in flight per server. Should only be enabled when all the servers understand batched "
+            "publish requests.");
+TAG_FLAG(redis_forward_publish_in_batches, advanced);
+TAG_FLAG(redis_forward_publish_in_batches, runtime);
+DEFINE_int32(redis_forward_publish_max_batch_size, 1000,
+             "Maximum number of messages in a batched publish RPC.");
+TAG_FLAG(redis_forward_publish_max_batch_size, advanced);
+TAG_FLAG(redis_forward_publish_max_batch_size, runtime);
 DEFINE_bool(enable_redis_auth, true, "Enable AUTH for the Redis service");
 
 DECLARE_string(placement_cloud);
@@ -267,6 +280,20 @@ class Operation {
     }
   }
 
+  // Stores the response of this read in cache once it succeeds.
+  void CacheResponse(RedisReadCache* cache, std::string cache_key) {
+    read_cache_ = cache;
+    cache_key_ = std::move(cache_key);
+    read_start_ = MonoTime::Now();
+    read_cache_generation_ = cache->StartRead();
+  }
+
+  // Invalidates the cached response for the key of this write once it is done.
+  void InvalidateCachedResponse(RedisReadCache* cache, std::string cache_key) {
+    read_cache_ = cache;
+    cache_key_ = std::move(cache_key);
+  }
+
   bool Apply(client::YBSession* session, const StatusFunctor& callback, bool* applied_operations) {
     // We should destroy functor after this call.
     // Because it could hold references to other objects.
@@ -294,6 +321,9 @@ class Operation {
 
   void Respond(const Status& status) {
     responded_.store(true, std::memory_order_release);
+    if (read_cache_) {
+      UpdateReadCache(status);
+    }
     if (manual_response_) {
       return;
     }
@@ -318,6 +348,19 @@ class Operation {
   }
 
  private:
+  void UpdateReadCache(const Status& status) {
+    if (type_ == OperationType::kWrite) {
+      // Invalidate even if the write failed, since it could still have been applied.
+      read_cache_->Invalidate(cache_key_);
+    } else if (status.ok()) {
+      const auto code = response().code();
+      if (code == RedisResponsePB_RedisStatusCode_OK ||
+          code == RedisResponsePB_RedisStatusCode_NIL) {
+        read_cache_->Put(cache_key_, response(), read_start_, read_cache_generation_);
+      }
+    }
+  }
+
   OperationType type_;
   std::shared_ptr<RedisInboundCall> call_;
   size_t index_;
@@ -328,8 +371,17 @@ class Operation {
   ManualResponse manual_response_;
   client::internal::RemoteTabletPtr tablet_;
   std::atomic<bool> responded_{false};
+  RedisReadCache* read_cache_ = nullptr;
+  std::string cache_key_;
+  MonoTime read_start_;
+  uint64_t read_cache_generation_ = 0;
 };
 
+bool IsCacheableRead(const YBRedisReadOp& op) {
+  return op.request().has_get_request() &&
+         op.request().get_request().request_type() == RedisGetRequestPB_GetRequestType_GET;
+}
+
 class SessionPool {
  public:
   void Init(const std::shared_ptr<client::YBClient>& client,
@@ -742,6 +794,8 @@ class TabletOperations {
 
 YB_STRONGLY_TYPED_BOOL(IsMonitorMessage);
 
+class PublishForwarder;
+
 struct RedisServiceImplData : public RedisServiceData {
   RedisServiceImplData(RedisServer* server, string&& yb_tier_master_addresses);
 
@@ -769,6 +823,7 @@ struct RedisServiceImplData : public RedisServiceData {
       const string& channel, const string& message, const IntFunctor& f) override;
   int PublishToLocalClients(IsMonitorMessage mode, const string& channel, const string& message);
   Result<vector<HostPortPB>> GetServerAddrsForChannel(const string& channel);
+  std::shared_ptr<PublishForwarder> GetPublishForwarder(const HostPort& host_port);
   int NumSubscriptionsUnlocked(Connection* conn);
 
   CHECKED_STATUS GetRedisPasswords(vector<string>* passwords) override;
@@ -800,6 +855,10 @@ struct RedisServiceImplData : public RedisServiceData {
   std::unordered_map<Connection*, ClientSubscription> clients_to_subscriptions_;
 
   std::unordered_set<Connection*> monitoring_clients_;
+
+  std::mutex publish_forwarders_mutex_;
+  std::unordered_map<HostPort, std::shared_ptr<PublishForwarder>, HostPortHash>
+      publish_forwarders_;
   scoped_refptr<AtomicGauge<uint64_t>> num_clients_monitoring_;
 
   std::mutex redis_password_mutex_;
@@ -871,6 +930,7 @@ class BatchContextImpl : public BatchContext {
       for (auto& operation : operations_) {
         operation.Respond(table.status());
       }
+      return;
     }
     MonoTime deadline = MonoTime::Now() +
                         MonoDelta::FromMilliseconds(FLAGS_redis_service_yb_client_timeout_millis);
@@ -889,14 +949,38 @@ class BatchContextImpl : public BatchContext {
       size_t index,
       std::shared_ptr<client::YBRedisReadOp> operation,
       const rpc::RpcMethodMetrics& metrics) override {
-    DoApply(index, std::move(operation), metrics);
+    if (!RedisReadCache::Enabled() || !IsCacheableRead(*operation)) {
+      DoApply(index, std::move(operation), metrics);
+      return;
+    }
+    auto* cache = impl_data_->server_->read_cache();
+    auto cache_key = ReadCacheKey(operation->GetKey());
+    RedisResponsePB response;
+    if (cache->Get(cache_key, &response)) {
+      call_->RespondSuccess(index, metrics, &response);
+      return;
+    }
+    if (DoApply(index, std::move(operation), metrics)) {
+      operations_.back().CacheResponse(cache, std::move(cache_key));
+    }
   }
 
   void Apply(
       size_t index,
       std::shared_ptr<client::YBRedisWriteOp> operation,
       const rpc::RpcMethodMetrics& metrics) override {
-    DoApply(index, std::move(operation), metrics);
+    if (!RedisReadCache::Enabled()) {
+      DoApply(index, std::move(operation), metrics);
+      return;
+    }
+    // Invalidate both before and after the write, so that a read that was started before the write
+    // completes could not be cached after it.
+    auto* cache = impl_data_->server_->read_cache();
+    auto cache_key = ReadCacheKey(operation->GetKey());
+    cache->Invalidate(cache_key);
+    if (DoApply(index, std::move(operation), metrics)) {
+      operations_.back().InvalidateCachedResponse(cache, std::move(cache_key));
+    }
   }
 
   void Apply(
@@ -913,14 +997,21 @@ class BatchContextImpl : public BatchContext {
   }
 
  private:
+  // Returns true if operation was queued, i.e. it was not responded during creation.
   template <class... Args>
-  void DoApply(Args&&... args) {
+  bool DoApply(Args&&... args) {
     operations_.emplace_back(call_, std::forward<Args>(args)...);
     if (PREDICT_FALSE(operations_.back().responded())) {
       operations_.pop_back();
-    } else {
-      consumption_.Add(operations_.back().space_used_by_request());
+      return false;
     }
+    consumption_.Add(operations_.back().space_used_by_request());
+    return true;
+  }
+
+  // Redis key qualified with the database name, prefixed by its length to keep it unambiguous.
+  std::string ReadCacheKey(const std::string& key) const {
+    return Format("$0:$1:$2", db_name_.size(), db_name_, key);
   }
 
   void LookupDone(
@@ -929,7 +1020,7 @@ class BatchContextImpl : public BatchContext {
     if (!result.ok()) {
       auto status = result.status();
       if (status.IsNotFound() && retries < kMaxRetries) {
-        retry_lookups_.store(false, std::memory_order_release);
+        retry_lookups_.store(true, std::memory_order_release);
       } else {
         operation->Respond(status);
       }
@@ -1209,7 +1300,11 @@ class PublishResponseHandler {
       : num_replies_pending(n), done_functor(std::move(f)) {}
 
   void HandleResponse(const tserver::PublishResponsePB* resp) {
-    num_clients_forwarded_to.IncrementBy(resp->num_clients_forwarded_to());
+    HandleResponse(resp->num_clients_forwarded_to());
+  }
+
+  void HandleResponse(int32_t num_clients) {
+    num_clients_forwarded_to.IncrementBy(num_clients);
 
     if (0 == num_replies_pending.IncrementBy(-1)) {
       done_functor(num_clients_forwarded_to.Load());
@@ -1222,6 +1317,101 @@ class PublishResponseHandler {
   IntFunctor done_functor;
 };
 
+// Forwards the publishes to one server. While a publish RPC to the server is in flight, the next
+// publishes accumulate and are sent in one RPC when it completes, so the number of RPCs follows
+// what the server could handle instead of the number of messages.
+class PublishForwarder : public std::enable_shared_from_this<PublishForwarder> {
+ public:
+  PublishForwarder(rpc::ProxyCache* proxy_cache, const HostPort& host_port)
+      : host_port_(host_port), proxy_(proxy_cache, host_port) {}
+
+  void Forward(const string& channel, const string& message,
+               std::shared_ptr<PublishResponseHandler> handler) {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      pending_.push_back(PendingPublish{channel, message, std::move(handler)});
+      if (in_flight_) {
+        return;
+      }
+      in_flight_ = true;
+    }
+    SendNextBatch();
+  }
+
+ private:
+  struct PendingPublish {
+    string channel;
+    string message;
+    std::shared_ptr<PublishResponseHandler> handler;
+  };
+
+  struct Batch {
+    std::vector<PendingPublish> publishes;
+    tserver::PublishRequestPB request;
+    tserver::PublishResponsePB response;
+    rpc::RpcController controller;
+  };
+
+  void SendNextBatch() {
+    auto batch = std::make_shared<Batch>();
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (pending_.empty()) {
+        in_flight_ = false;
+        return;
+      }
+      const size_t max_batch_size = std::max(FLAGS_redis_forward_publish_max_batch_size, 1);
+      if (pending_.size() <= max_batch_size) {
+        batch->publishes.swap(pending_);
+      } else {
+        auto end = pending_.begin() + max_batch_size;
+        batch->publishes.assign(
+            std::make_move_iterator(pending_.begin()), std::make_move_iterator(end));
+        pending_.erase(pending_.begin(), end);
+      }
+    }
+    for (const auto& publish : batch->publishes) {
+      auto* message = batch->request.add_messages();
+      message->set_channel(publish.channel);
+      message->set_message(publish.message);
+    }
+    proxy_.PublishAsync(
+        batch->request, &batch->response, &batch->controller,
+        [self = shared_from_this(), batch] {
+          self->BatchDone(*batch);
+        });
+  }
+
+  void BatchDone(const Batch& batch) {
+    const auto& counts = batch.response.num_clients_forwarded_to_per_message();
+    if (!batch.controller.status().ok()) {
+      LOG(WARNING) << "Failed to forward " << batch.publishes.size() << " publishes to "
+                   << host_port_ << ": " << batch.controller.status();
+    }
+    for (size_t i = 0; i != batch.publishes.size(); ++i) {
+      batch.publishes[i].handler->HandleResponse(
+          i < static_cast<size_t>(counts.size()) ? counts.Get(i) : 0);
+    }
+    SendNextBatch();
+  }
+
+  const HostPort host_port_;
+  tserver::TabletServerServiceProxy proxy_;
+  std::mutex mutex_;
+  std::vector<PendingPublish> pending_;
+  bool in_flight_ = false;
+};
+
+std::shared_ptr<PublishForwarder> RedisServiceImplData::GetPublishForwarder(
+    const HostPort& host_port) {
+  std::lock_guard<std::mutex> lock(publish_forwarders_mutex_);
+  auto& forwarder = publish_forwarders_[host_port];
+  if (!forwarder) {
+    forwarder = std::make_shared<PublishForwarder>(&client_->proxy_cache(), host_port);
+  }
+  return forwarder;
+}
+
 void RedisServiceImplData::ForwardToInterestedProxies(
     const string& channel, const string& message, const IntFunctor& f) {
   auto interested_servers = GetServerAddrsForChannel(channel);
@@ -1231,6 +1421,12 @@ void RedisServiceImplData::ForwardToInterestedProxies(
   }
   std::shared_ptr<PublishResponseHandler> resp_handler =
       std::make_shared<PublishResponseHandler>(interested_servers->size(), f);
+  if (FLAGS_redis_forward_publish_in_batches) {
+    for (auto& hostport_pb : *interested_servers) {
+      GetPublishForwarder(HostPortFromPB(hostport_pb))->Forward(channel, message, resp_handler);
+    }
+    return;
+  }
   for (auto& hostport_pb : *interested_servers) {
     tserver::PublishRequestPB requestPB;
     requestPB.set_channel(channel);
@@ -1277,18 +1473,24 @@ string PMessageFor(const string& pattern, const string& channel, const string& m
 
 int RedisServiceImplData::PublishToLocalClients(
     IsMonitorMessage mode, const string& channel, const string& message) {
+  // Encode the message before taking the lock, so that subscribing is blocked only while the
+  // message is queued to the connections.
+  OutboundDataPtr out;
+  if (mode == IsMonitorMessage::kTrue) {
+    out = std::make_shared<yb::rpc::StringOutboundData>(message, "Monitor redis commands");
+  } else {
+    out = std::make_shared<yb::rpc::StringOutboundData>(
+        MessageFor(channel, message), "Publishing to Channel");
+  }
+
   boost::shared_lock<decltype(pubsub_mutex_)> rlock(pubsub_mutex_);
 
   int num_pushed_to = 0;
   // Send the message to all the monitoring clients.
-  OutboundDataPtr out;
   const std::unordered_set<Connection*>* clients = nullptr;
   if (mode == IsMonitorMessage::kTrue) {
-    out = std::make_shared<yb::rpc::StringOutboundData>(message, "Monitor redis commands");
     clients = &monitoring_clients_;
   } else {
-    out = std::make_shared<yb::rpc::StringOutboundData>(
-        MessageFor(channel, message), "Publishing to Channel");
     clients =
         (channels_to_clients_.find(channel) == channels_to_clients_.end()
              ? nullptr
@@ -1490,10 +1692,12 @@ void RedisServiceImpl::Impl::Handle(rpc::InboundCallPtr call_ptr) {
     }
   }
 
-  // Call could contain several commands, i.e. batch.
+  // Call could contain several commands, i.e. batch: all commands pipelined by the client that were
+  // parsed from one read, up to --redis_max_batch.
   // We process them as follows:
-  // Each read commands are processed individually.
-  // Sequential write commands use single session and the same batcher.
+  // Commands are grouped by tablet. Sequential reads and sequential writes of one tablet are sent
+  // in a single RPC, a new RPC is started only when a command conflicts with a key used by the
+  // previous commands of the opposite type. Responses are sent in the order of commands.
   const auto& batch = call->client_batch();
   auto conn = call->connection();
   const string remote = yb::ToString(conn->remote());
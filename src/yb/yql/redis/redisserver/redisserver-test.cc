@@ -56,6 +56,8 @@ DECLARE_int32(redis_service_yb_client_timeout_millis);
 DECLARE_int32(redis_max_value_size);
 DECLARE_int32(redis_max_command_size);
 DECLARE_int32(redis_password_caching_duration_ms);
+DECLARE_int32(redis_read_cache_size);
+DECLARE_int32(redis_read_cache_staleness_ms);
 DECLARE_int32(rpc_max_message_size);
 DECLARE_int32(consensus_max_batch_size_bytes);
 DECLARE_int32(consensus_rpc_timeout_ms);
@@ -69,6 +71,7 @@ DEFINE_uint64(test_redis_max_batch, 250,
 METRIC_DECLARE_gauge_uint64(redis_available_sessions);
 METRIC_DECLARE_gauge_uint64(redis_allocated_sessions);
 METRIC_DECLARE_gauge_uint64(redis_monitoring_clients);
+METRIC_DECLARE_counter(redis_read_cache_hits);
 
 using namespace std::literals;
 using namespace std::placeholders;
@@ -1489,6 +1492,40 @@ TEST_F(TestRedisService, TestUsingOpenSourceClient) {
   VerifyCallbacks();
 }
 
+TEST_F(TestRedisService, TestReadCache) {
+  FLAGS_redis_read_cache_size = 100;
+  FLAGS_redis_read_cache_staleness_ms = 60000;
+  auto hits = server_->metric_entity()->FindOrCreateCounter(&METRIC_redis_read_cache_hits);
+  const auto initial_hits = hits->value();
+
+  DoRedisTestOk(__LINE__, {"SET", "hot", "v1"});
+  SyncClient();
+  DoRedisTestBulkString(__LINE__, {"GET", "hot"}, "v1");
+  SyncClient();
+  DoRedisTestBulkString(__LINE__, {"GET", "hot"}, "v1");
+  SyncClient();
+  ASSERT_EQ(initial_hits + 1, hits->value());
+
+  // A write through the proxy invalidates the cached response.
+  DoRedisTestOk(__LINE__, {"SET", "hot", "v2"});
+  SyncClient();
+  DoRedisTestBulkString(__LINE__, {"GET", "hot"}, "v2");
+  SyncClient();
+  DoRedisTestBulkString(__LINE__, {"GET", "hot"}, "v2");
+  SyncClient();
+  ASSERT_EQ(initial_hits + 2, hits->value());
+
+  // So does a rename of another key onto it.
+  DoRedisTestOk(__LINE__, {"SET", "cold", "v3"});
+  DoRedisTestOk(__LINE__, {"RENAME", "cold", "hot"});
+  SyncClient();
+  DoRedisTestBulkString(__LINE__, {"GET", "hot"}, "v3");
+  SyncClient();
+
+  FLAGS_redis_read_cache_size = 0;
+  VerifyCallbacks();
+}
+
 TEST_F(TestRedisService, TestBinaryUsingOpenSourceClient) {
   const std::string kFooValue = "\001\002\r\n\003\004"s;
   const std::string kBarValue = "\013\010\000"s;
@@ -2582,6 +2619,24 @@ TEST_F(TestRedisServiceExternal, TestPUnsubscribeCluster) {
   TestPubSub(LocalOrCluster::kCluster, SubOrUnsub::kUnsubscribe, PatternOrChannel::kPattern);
 }
 
+class TestRedisServiceExternalBatchedPublish : public TestRedisServiceExternal {
+ protected:
+  void CustomizeExternalMiniCluster(ExternalMiniClusterOptions* opts) override {
+    TestRedisServiceExternal::CustomizeExternalMiniCluster(opts);
+    opts->extra_tserver_flags.push_back("--redis_forward_publish_in_batches=true");
+  }
+};
+
+TEST_F(TestRedisServiceExternalBatchedPublish, TestSubscribeCluster) {
+  expected_no_sessions_ = true;
+  TestPubSub(LocalOrCluster::kCluster, SubOrUnsub::kSubscribe, PatternOrChannel::kChannel);
+}
+
+TEST_F(TestRedisServiceExternalBatchedPublish, TestPSubscribeCluster) {
+  expected_no_sessions_ = true;
+  TestPubSub(LocalOrCluster::kCluster, SubOrUnsub::kSubscribe, PatternOrChannel::kPattern);
+}
+
 TEST_F(TestRedisServiceExternal, TestSlowSubscribersCatchingUp) {
   expected_no_sessions_ = true;
 